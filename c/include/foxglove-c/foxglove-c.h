@@ -119,6 +119,71 @@
 #define FOXGLOVE_SERVER_CAPABILITY_PLAYBACK_CONTROL (1 << 6)
 #endif
 
+#if !defined(__wasm__)
+/**
+ * Allow clients to receive several messages in each binary frame. The limits on each batch are
+ * set by `message_batch_linger_us` and `message_batch_bytes` in `foxglove_server_options`.
+ */
+#define FOXGLOVE_SERVER_CAPABILITY_MESSAGE_BATCHES (1 << 7)
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Allow clients to subscribe to only some fields of each message on a channel. Supported for
+ * channels with `json` messages, and `protobuf` messages with a protobuf schema.
+ */
+#define FOXGLOVE_SERVER_CAPABILITY_FIELD_PROJECTION (1 << 8)
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Memory and CPU usage of the SDK process: the `process_*` fields.
+ */
+#define FOXGLOVE_SYSINFO_METRIC_PROCESS (1 << 0)
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Total CPU usage of the system: `total_cpu_percent` and `total_cpu_cores`.
+ */
+#define FOXGLOVE_SYSINFO_METRIC_CPU (1 << 1)
+#endif
+
+#if !defined(__wasm__)
+/**
+ * CPU usage of each logical CPU: `cpu_percent_per_core`.
+ */
+#define FOXGLOVE_SYSINFO_METRIC_CPU_PER_CORE (1 << 2)
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Physical memory and swap usage of the system.
+ */
+#define FOXGLOVE_SYSINFO_METRIC_MEMORY (1 << 3)
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Network throughput, summed over all interfaces: the `network_*` fields.
+ */
+#define FOXGLOVE_SYSINFO_METRIC_NETWORK (1 << 4)
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Disk I/O throughput, summed over all disks: the `disk_*` fields.
+ */
+#define FOXGLOVE_SYSINFO_METRIC_DISK (1 << 5)
+#endif
+
+#if !defined(__wasm__)
+/**
+ * The SDK's own delivery queues and threads: the `sdk_*` fields.
+ */
+#define FOXGLOVE_SYSINFO_METRIC_SDK (1 << 6)
+#endif
+
 enum foxglove_error
 #if defined(__cplusplus) || __STDC_VERSION__ >= 202311L
   : uint8_t
@@ -265,6 +330,41 @@ typedef int32_t foxglove_scene_entity_deletion_type;
 #endif // __STDC_VERSION__ >= 202311L
 #endif // __cplusplus
 
+#if !defined(__wasm__)
+/**
+ * A stage of a message's delivery by a sink.
+ */
+enum foxglove_latency_stage
+#if defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+  : uint8_t
+#endif // defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+ {
+  /**
+   * From the call to log to the message being queued by the sink.
+   */
+  FOXGLOVE_LATENCY_STAGE_SERIALIZE,
+  /**
+   * Time spent waiting in the sink's queue.
+   */
+  FOXGLOVE_LATENCY_STAGE_QUEUE,
+  /**
+   * From the message being taken from the queue to it being sent or written.
+   */
+  FOXGLOVE_LATENCY_STAGE_IO,
+  /**
+   * From the call to log to the message being sent or written.
+   */
+  FOXGLOVE_LATENCY_STAGE_TOTAL,
+};
+#ifndef __cplusplus
+#if __STDC_VERSION__ >= 202311L
+typedef enum foxglove_latency_stage foxglove_latency_stage;
+#else
+typedef uint8_t foxglove_latency_stage;
+#endif // __STDC_VERSION__ >= 202311L
+#endif // __cplusplus
+#endif
+
 #if !defined(__wasm__)
 enum foxglove_mcap_compression
 #if defined(__cplusplus) || __STDC_VERSION__ >= 202311L
@@ -290,6 +390,74 @@ typedef uint8_t foxglove_mcap_compression;
 #endif // __cplusplus
 #endif
 
+#if !defined(__wasm__)
+/**
+ * What an asynchronous MCAP writer does when its queue is full.
+ */
+enum foxglove_mcap_overflow_policy
+#if defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+  : uint8_t
+#endif // defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+ {
+#if !defined(__wasm__)
+  /**
+   * Block the logging thread until the writer thread makes room in the queue.
+   */
+  FOXGLOVE_MCAP_OVERFLOW_POLICY_BLOCK,
+#endif
+#if !defined(__wasm__)
+  /**
+   * Drop the message being logged.
+   */
+  FOXGLOVE_MCAP_OVERFLOW_POLICY_DROP_NEWEST,
+#endif
+#if !defined(__wasm__)
+  /**
+   * Drop the oldest queued message to make room for the message being logged.
+   */
+  FOXGLOVE_MCAP_OVERFLOW_POLICY_DROP_OLDEST,
+#endif
+};
+#ifndef __cplusplus
+#if __STDC_VERSION__ >= 202311L
+typedef enum foxglove_mcap_overflow_policy foxglove_mcap_overflow_policy;
+#else
+typedef uint8_t foxglove_mcap_overflow_policy;
+#endif // __STDC_VERSION__ >= 202311L
+#endif // __cplusplus
+#endif
+
+#if !defined(__wasm__)
+/**
+ * The order in which messages are read from an MCAP file.
+ */
+enum foxglove_mcap_read_order
+#if defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+  : uint8_t
+#endif // defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+ {
+#if !defined(__wasm__)
+  /**
+   * Messages are read in order of log time.
+   */
+  FOXGLOVE_MCAP_READ_ORDER_LOG_TIME,
+#endif
+#if !defined(__wasm__)
+  /**
+   * Messages are read in the order they appear in the file.
+   */
+  FOXGLOVE_MCAP_READ_ORDER_FILE,
+#endif
+};
+#ifndef __cplusplus
+#if __STDC_VERSION__ >= 202311L
+typedef enum foxglove_mcap_read_order foxglove_mcap_read_order;
+#else
+typedef uint8_t foxglove_mcap_read_order;
+#endif // __STDC_VERSION__ >= 202311L
+#endif // __cplusplus
+#endif
+
 #if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
  * The status of the remote access gateway connection.
@@ -416,6 +584,43 @@ typedef uint8_t foxglove_parameter_value_tag;
 #endif // __cplusplus
 #endif
 
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+/**
+ * The priority of a channel's data, relative to other channels.
+ */
+enum foxglove_priority
+#if defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+  : uint8_t
+#endif // defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+ {
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+  /**
+   * The default priority.
+   */
+  FOXGLOVE_PRIORITY_NORMAL = 0,
+#endif
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+  /**
+   * Best-effort data, such as debug visualizations.
+   */
+  FOXGLOVE_PRIORITY_LOW = 1,
+#endif
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+  /**
+   * Latency-sensitive data, such as teleoperation commands and transforms.
+   */
+  FOXGLOVE_PRIORITY_HIGH = 2,
+#endif
+};
+#ifndef __cplusplus
+#if __STDC_VERSION__ >= 202311L
+typedef enum foxglove_priority foxglove_priority;
+#else
+typedef uint8_t foxglove_priority;
+#endif // __STDC_VERSION__ >= 202311L
+#endif // __cplusplus
+#endif
+
 #if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
  * The reliability policy for a channel's data delivery.
@@ -447,6 +652,44 @@ typedef uint8_t foxglove_reliability;
 #endif // __cplusplus
 #endif
 
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+/**
+ * How a participant's message backlog handles messages for reliable channels when it fills up.
+ */
+enum foxglove_message_backlog_policy
+#if defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+  : uint8_t
+#endif // defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+ {
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+  /**
+   * Queue channel messages with control plane messages, and disconnect the participant when
+   * the queue is full.
+   */
+  FOXGLOVE_MESSAGE_BACKLOG_POLICY_DISCONNECT = 0,
+#endif
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+  /**
+   * Drop the oldest queued channel message, whichever channel it was logged to.
+   */
+  FOXGLOVE_MESSAGE_BACKLOG_POLICY_DROP_OLDEST = 1,
+#endif
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+  /**
+   * Drop stale messages from the busiest channels, keeping the latest message of each channel.
+   */
+  FOXGLOVE_MESSAGE_BACKLOG_POLICY_KEEP_LATEST_PER_CHANNEL = 2,
+#endif
+};
+#ifndef __cplusplus
+#if __STDC_VERSION__ >= 202311L
+typedef enum foxglove_message_backlog_policy foxglove_message_backlog_policy;
+#else
+typedef uint8_t foxglove_message_backlog_policy;
+#endif // __STDC_VERSION__ >= 202311L
+#endif // __cplusplus
+#endif
+
 #if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
  * The preferred backend for encoding published video tracks.
@@ -506,6 +749,37 @@ typedef uint8_t foxglove_video_encoder_backend;
 #endif // __cplusplus
 #endif
 
+#if !defined(__wasm__)
+/**
+ * How a client's message backlog makes room when it exceeds its limits.
+ */
+enum foxglove_backlog_drop_policy
+#if defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+  : uint8_t
+#endif // defined(__cplusplus) || __STDC_VERSION__ >= 202311L
+ {
+#if !defined(__wasm__)
+  /**
+   * Drop the oldest queued messages, whichever channel they were logged to.
+   */
+  FOXGLOVE_BACKLOG_DROP_POLICY_DROP_OLDEST,
+#endif
+#if !defined(__wasm__)
+  /**
+   * Drop stale messages from the busiest channels, keeping the latest message of each channel.
+   */
+  FOXGLOVE_BACKLOG_DROP_POLICY_KEEP_LATEST_PER_CHANNEL,
+#endif
+};
+#ifndef __cplusplus
+#if __STDC_VERSION__ >= 202311L
+typedef enum foxglove_backlog_drop_policy foxglove_backlog_drop_policy;
+#else
+typedef uint8_t foxglove_backlog_drop_policy;
+#endif // __STDC_VERSION__ >= 202311L
+#endif // __cplusplus
+#endif
+
 #if !defined(__wasm__)
 /**
  * Level indicator for a server status message.
@@ -582,6 +856,10 @@ typedef struct foxglove_channel_descriptor foxglove_channel_descriptor;
 typedef struct foxglove_connection_graph foxglove_connection_graph;
 #endif
 
+#if !defined(__wasm__)
+typedef struct foxglove_connection_graph_patch foxglove_connection_graph_patch;
+#endif
+
 #if !defined(__wasm__)
 typedef struct foxglove_context foxglove_context;
 #endif
@@ -590,6 +868,13 @@ typedef struct foxglove_context foxglove_context;
 typedef struct foxglove_fetch_asset_responder foxglove_fetch_asset_responder;
 #endif
 
+#if !defined(__wasm__)
+/**
+ * A built-in fetch asset handler, which serves files from a set of directories.
+ */
+typedef struct foxglove_file_asset_handler foxglove_file_asset_handler;
+#endif
+
 #if defined(FOXGLOVE_REMOTE_ACCESS)
 typedef struct foxglove_gateway foxglove_gateway;
 #endif
@@ -607,10 +892,82 @@ typedef struct foxglove_gateway foxglove_gateway;
 typedef struct foxglove_get_parameters_responder foxglove_get_parameters_responder;
 #endif
 
+#if !defined(__wasm__)
+/**
+ * A snapshot of the latency percentiles recorded by a tracer.
+ *
+ * The snapshot is created by [`foxglove_latency_tracer_get_stats`], and freed by
+ * [`foxglove_latency_stats_free`].
+ */
+typedef struct foxglove_latency_stats_snapshot foxglove_latency_stats_snapshot;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Opaque handle to an installed latency tracer.
+ *
+ * The handle is created by [`foxglove_latency_tracer_install`], and freed by
+ * [`foxglove_latency_tracer_free`], which uninstalls the tracer.
+ */
+typedef struct foxglove_latency_tracer foxglove_latency_tracer;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * An iterator over the messages in one or more MCAP files.
+ *
+ * The iterator is created by [`foxglove_mcap_reader_messages`] or
+ * [`foxglove_mcap_reader_merge`], and freed by [`foxglove_mcap_message_iter_free`]. It may
+ * outlive the readers it was created from.
+ */
+typedef struct foxglove_mcap_message_iterator foxglove_mcap_message_iterator;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A reader for a finished MCAP file.
+ *
+ * The reader is created by [`foxglove_mcap_reader_open`], and freed by
+ * [`foxglove_mcap_reader_free`].
+ */
+typedef struct foxglove_mcap_reader foxglove_mcap_reader;
+#endif
+
 #if !defined(__wasm__)
 typedef struct foxglove_mcap_writer foxglove_mcap_writer;
 #endif
 
+#if !defined(__wasm__)
+/**
+ * The output of a `message_filter` callback, which may replace the filtered message.
+ *
+ * The output is only valid for the duration of the callback.
+ */
+typedef struct foxglove_message_filter_output foxglove_message_filter_output;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Opaque handle to a running SDK stats publisher.
+ *
+ * The handle is created by [`foxglove_sdk_stats_publisher_start`]. It is freed by
+ * [`foxglove_sdk_stats_publisher_stop`] (which aborts the background task) or by
+ * [`foxglove_sdk_stats_publisher_detach`] (which leaves the background task running until the
+ * process exits).
+ */
+typedef struct foxglove_sdk_stats_publisher foxglove_sdk_stats_publisher;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A snapshot of the delivery counters of a server's clients.
+ *
+ * The snapshot is created by `foxglove_server_get_stats`, and freed by
+ * `foxglove_server_stats_free`.
+ */
+typedef struct foxglove_server_stats foxglove_server_stats;
+#endif
+
 #if !defined(__wasm__)
 typedef struct foxglove_service foxglove_service;
 #endif
@@ -640,18 +997,73 @@ typedef struct foxglove_set_parameters_responder foxglove_set_parameters_respond
 
 #if !defined(__wasm__)
 /**
- * Opaque handle to a running system info publisher.
+ * A sink which keeps the most recent messages of every channel in memory, so that they can be
+ * written to an MCAP file after an incident.
  *
- * The handle is created by [`foxglove_system_info_publisher_start`]. It is freed by
- * [`foxglove_system_info_publisher_stop`] (which aborts the background task) or by
- * [`foxglove_system_info_publisher_detach`] (which leaves the background task
- * running until the process exits).
+ * The sink is created by `foxglove_ring_buffer_sink_create`, and closed and freed by
+ * `foxglove_ring_buffer_sink_close`.
  */
-typedef struct foxglove_system_info_publisher foxglove_system_info_publisher;
+typedef struct foxglove_ring_buffer_sink foxglove_ring_buffer_sink;
 #endif
 
 #if !defined(__wasm__)
-typedef struct foxglove_websocket_server foxglove_websocket_server;
+/**
+ * A snapshot of a ring buffer sink which is being written to an MCAP file on a background
+ * thread.
+ *
+ * The snapshot is created by `foxglove_ring_buffer_sink_snapshot`, and freed by
+ * `foxglove_ring_buffer_snapshot_wait` or `foxglove_ring_buffer_snapshot_detach`.
+ */
+typedef struct foxglove_ring_buffer_snapshot foxglove_ring_buffer_snapshot;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A sink which writes logged messages to a shared-memory ring buffer, for viewers on the same
+ * host.
+ *
+ * The sink is created by `foxglove_shared_memory_sink_create`, and closed and freed by
+ * `foxglove_shared_memory_sink_close`.
+ */
+typedef struct foxglove_shared_memory_sink foxglove_shared_memory_sink;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A clock which is set by the application, for example from simulation time.
+ *
+ * The clock is created by `foxglove_sim_clock_new`, and freed by `foxglove_sim_clock_free`.
+ * Contexts using the clock hold their own reference to it.
+ */
+typedef struct foxglove_sim_clock foxglove_sim_clock;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Opaque handle to a running system info publisher.
+ *
+ * The handle is created by [`foxglove_system_info_publisher_start`]. It is freed by
+ * [`foxglove_system_info_publisher_stop`] (which aborts the background task) or by
+ * [`foxglove_system_info_publisher_detach`] (which leaves the background task
+ * running until the process exits).
+ */
+typedef struct foxglove_system_info_publisher foxglove_system_info_publisher;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A compiled set of topic globs and regular expressions, which can be used as a sink channel
+ * filter without calling back into C for each channel.
+ *
+ * The filter is created by `foxglove_topic_filter_create`, and freed by
+ * `foxglove_topic_filter_free`. Sinks which use the filter hold their own reference to it, so it
+ * may be freed as soon as the sink has been created.
+ */
+typedef struct foxglove_topic_filter foxglove_topic_filter;
+#endif
+
+#if !defined(__wasm__)
+typedef struct foxglove_websocket_server foxglove_websocket_server;
 #endif
 
 /**
@@ -2204,10 +2616,55 @@ typedef struct foxglove_raw_image {
   size_t data_len;
 } foxglove_raw_image;
 
+#if !defined(__wasm__)
+/**
+ * A byte array with associated length.
+ */
+typedef struct foxglove_bytes {
+  /**
+   * Pointer to data
+   */
+  const uint8_t *data;
+  /**
+   * Number of bytes
+   */
+  size_t len;
+} foxglove_bytes;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A buffer of MCAP output whose ownership is passed to a custom writer's `write_owned_fn`.
+ *
+ * The receiver must call `release(release_context)` exactly once when it no longer needs `data`.
+ * The buffer may be released from any thread.
+ */
+typedef struct foxglove_mcap_buffer {
+  /**
+   * Pointer to the data
+   */
+  const uint8_t *data;
+  /**
+   * Number of bytes
+   */
+  size_t len;
+  /**
+   * Context to pass to `release`
+   */
+  void *release_context;
+  /**
+   * Release function: free the buffer
+   */
+  void (*release)(void *release_context);
+} foxglove_mcap_buffer;
+#endif
+
 #if !defined(__wasm__)
 /**
  * Custom writer function pointers for MCAP writing.
- * write_fn and flush_fn must be non-null. Seek_fn may be null iff `disable_seeking` is set to true.
+ * flush_fn and at least one of write_fn, writev_fn, and write_owned_fn must be non-null. If more
+ * than one write function is provided, write_owned_fn is preferred, then writev_fn.
+ * Seek_fn may be null iff `disable_seeking` is set to true.
  * These function pointers may be called from multiple threads.
  * These functions are called synchronously with respect to each other within the SDK, but these
  * calls are not synchronized with other SDK function calls.
@@ -2231,9 +2688,44 @@ typedef struct foxglove_custom_writer {
    * whence: 0=SEEK_SET, 1=SEEK_CUR, 2=SEEK_END
    */
   int32_t (*seek_fn)(void *context, int64_t pos, int whence, uint64_t *new_pos);
+  /**
+   * Vectored write function: write `iovcnt` buffers, in order, to the custom destination
+   * Returns the total number of bytes written, or sets error on failure
+   *
+   * Small writes, such as record headers, are held back and passed alongside the next large
+   * write, instead of being concatenated with it or written with separate calls.
+   */
+  size_t (*writev_fn)(void *context,
+                      const struct foxglove_bytes *iov,
+                      size_t iovcnt,
+                      int32_t *error);
+  /**
+   * Owned write function: take ownership of a buffer and write all of it to the custom
+   * destination
+   * Returns 0 on success, or an error number defined in errno.h on failure
+   *
+   * Output is handed over in blocks, each containing at least one whole record, so that
+   * compressed chunks arrive in a single buffer. The callee owns the buffer even if it returns
+   * an error, and must release it as described by `FoxgloveMcapBuffer`.
+   */
+  int32_t (*write_owned_fn)(void *context, struct foxglove_mcap_buffer buffer);
 } foxglove_custom_writer;
 #endif
 
+#if !defined(__wasm__)
+/**
+ * The compression of the chunks holding a channel's messages, chosen by the
+ * `compression_policy` callback of `FoxgloveMcapOptions`.
+ */
+typedef struct foxglove_mcap_chunk_compression {
+  foxglove_mcap_compression compression;
+  /**
+   * Compression level passed to the compressor. 0 uses the compressor's default level.
+   */
+  uint32_t level;
+} foxglove_mcap_chunk_compression;
+#endif
+
 #if !defined(__wasm__)
 typedef struct foxglove_mcap_options {
   /**
@@ -2297,9 +2789,182 @@ typedef struct foxglove_mcap_options {
    *   and must remain valid until the MCAP sink is dropped.
    */
   bool (*sink_channel_filter)(const void *context, const struct foxglove_channel_descriptor *channel);
+  /**
+   * Optional topic filter, created via `foxglove_topic_filter_create`.
+   *
+   * The filter is evaluated without calling into C, and its result is cached per channel. If
+   * `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+   * filter. The sink holds its own reference to the filter.
+   */
+  const struct foxglove_topic_filter *topic_filter;
+  /**
+   * Context provided to the `message_filter` callback.
+   */
+  const void *message_filter_context;
+  /**
+   * A filter which runs on each message before it is written, so that the file can record
+   * channels with a different policy than other sinks in the same context.
+   *
+   * Return false to drop the message, or true to write it. To write a different message
+   * instead, for example a cropped or downsampled copy, pass it to
+   * `foxglove_message_filter_output_replace` and return true. The message data is only valid
+   * for the duration of the callback.
+   *
+   * The callback is invoked on the thread which logs the message, and must not block.
+   *
+   * # Safety
+   * - If provided, the callback must remain valid until the MCAP writer is closed, and may be
+   *   called from any thread.
+   */
+  bool (*message_filter)(const void *context,
+                         const struct foxglove_channel_descriptor *channel,
+                         const uint8_t *data,
+                         size_t data_len,
+                         uint64_t log_time,
+                         struct foxglove_message_filter_output *output);
+  /**
+   * If true, messages are queued and written on a dedicated background thread, so that
+   * compression and I/O do not block the logging thread.
+   */
+  bool async_writes;
+  /**
+   * Maximum number of messages waiting to be written when `async_writes` is true.
+   */
+  size_t async_queue_capacity;
+  /**
+   * What to do when a message is logged while the queue is full, if `async_writes` is true.
+   */
+  foxglove_mcap_overflow_policy async_overflow_policy;
+  /**
+   * If non-zero, completed chunks are written by a dedicated I/O thread, so that the next
+   * chunk can be compressed while earlier ones are written. This is the maximum number of
+   * blocks of output queued for the I/O thread before writes block.
+   */
+  size_t pipeline_depth;
+  /**
+   * If non-zero, the recording is split into segments, and a new segment is started once
+   * this many bytes have been written to the current one.
+   *
+   * When rotation is enabled, `path` is a template which must contain `{index}`, which is
+   * replaced by the segment number starting from 0. Rotation is not supported with
+   * `custom_writer`.
+   */
+  uint64_t rotation_max_bytes;
+  /**
+   * If non-zero, the recording is split into segments, and a new segment is started once the
+   * current one has been open for this many milliseconds. See `rotation_max_bytes`.
+   */
+  uint64_t rotation_max_duration_ms;
+  /**
+   * If true, the file at `path` is opened with `O_DIRECT` and written in large aligned blocks,
+   * bypassing the page cache. This requires `disable_seeking`, and is only supported on Linux.
+   */
+  bool direct_io;
+  /**
+   * If non-zero, the current chunk is finished and flushed at least this often, so that if the
+   * process exits without closing the writer, `foxglove_mcap_recover` can make the file
+   * readable with at most this many milliseconds of messages lost.
+   *
+   * When writing to `path` without rotation, schemas and channels are also recorded in a
+   * journal at `path` with `.checkpoint` appended, which is removed when the writer is closed.
+   */
+  uint64_t checkpoint_interval_ms;
+  /**
+   * Context provided to the `compression_policy` callback.
+   */
+  const void *compression_policy_context;
+  /**
+   * Chooses the compression of the chunks holding each channel's messages, so that, for
+   * example, already-compressed video is not compressed again. Channels with different
+   * compression are written to separately compressed streams of chunks in the same file.
+   *
+   * Return true after setting `*compression` to choose the channel's compression, or false
+   * to use `compression` and `compression_level`. The callback is invoked once per channel,
+   * when the first message is logged to it, and must not block.
+   *
+   * # Safety
+   * - If provided, the callback must remain valid until the MCAP writer is closed, and may be
+   *   called from any thread.
+   */
+  bool (*compression_policy)(const void *context,
+                             const struct foxglove_channel_descriptor *channel,
+                             struct foxglove_mcap_chunk_compression *compression);
+  /**
+   * If non-zero, a zstd dictionary is trained for each schema from this many of its first
+   * messages, stored in an attachment, and used to compress later chunks holding the
+   * schema's messages. This keeps compression ratios high with a small `chunk_size`.
+   *
+   * Only readers which load the dictionaries from the file's attachments can decompress the
+   * dictionary-compressed chunks.
+   */
+  size_t zstd_dictionary_training_messages;
+  /**
+   * Maximum size of each zstd dictionary, in bytes. 0 uses the default size.
+   */
+  size_t zstd_dictionary_max_size;
+  /**
+   * Compression level for chunks compressed with a zstd dictionary. 0 uses zstd's default
+   * level.
+   */
+  uint32_t zstd_dictionary_level;
+  /**
+   * If non-zero, disk space for the file at `path` is reserved in extents of this many bytes
+   * with `fallocate` as the file grows, and unused space is released when the writer is
+   * closed. This avoids fragmenting long recordings and stalling writes on block allocation.
+   *
+   * Not supported with `direct_io`, and only supported on Linux.
+   */
+  uint64_t preallocate_bytes;
+  /**
+   * If non-zero, message indexes are sparse: each channel's index for a chunk keeps its first
+   * message, and then one message at least every this many messages.
+   *
+   * Readers which only read the messages listed in message indexes miss the others. Readers
+   * which read whole chunks, or scan forward from an indexed message, are unaffected.
+   */
+  uint64_t sparse_index_every_messages;
+  /**
+   * If non-zero, message indexes are sparse, and keep one message at least every this many
+   * nanoseconds of log time. See `sparse_index_every_messages`.
+   */
+  uint64_t sparse_index_every_ns;
+  /**
+   * Context provided to the `channel_group` callback.
+   */
+  const void *channel_group_context;
+  /**
+   * Chooses the group of chunks holding each channel's messages. Each group is written to a
+   * separate stream of chunks in the same file, so each chunk only holds messages from one
+   * group, and readers which select a few topics only decompress the chunks of their groups.
+   *
+   * Channels in group 0 share the writer's default chunks. The callback is invoked once per
+   * channel, when the first message is logged to it, and must not block.
+   *
+   * # Safety
+   * - If provided, the callback must remain valid until the MCAP writer is closed, and may be
+   *   called from any thread.
+   */
+  uint32_t (*channel_group)(const void *context,
+                            const struct foxglove_channel_descriptor *channel);
 } foxglove_mcap_options;
 #endif
 
+#if !defined(__wasm__)
+/**
+ * Statistics for an MCAP writer.
+ */
+typedef struct foxglove_mcap_writer_stats {
+  /**
+   * Number of logged messages which have not been written yet.
+   */
+  size_t queue_depth;
+  /**
+   * Number of messages dropped because the queue was full.
+   */
+  uint64_t dropped_messages;
+} foxglove_mcap_writer_stats;
+#endif
+
 /**
  * A key-value pair of strings.
  */
@@ -2365,6 +3030,127 @@ typedef struct foxglove_channel_metadata {
   size_t count;
 } foxglove_channel_metadata;
 
+#if !defined(__wasm__)
+/**
+ * A channel in an MCAP file.
+ *
+ * Its fields are valid until the reader is freed.
+ */
+typedef struct foxglove_mcap_reader_channel {
+  /**
+   * The channel id, unique within the file.
+   */
+  uint16_t id;
+  /**
+   * The channel topic.
+   */
+  struct foxglove_string topic;
+  /**
+   * The encoding of the channel's messages.
+   */
+  struct foxglove_string message_encoding;
+  /**
+   * The channel metadata.
+   */
+  struct foxglove_channel_metadata metadata;
+  /**
+   * The channel's schema, or null if it has none.
+   */
+  const struct foxglove_schema *schema;
+} foxglove_mcap_reader_channel;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Options for [`foxglove_mcap_reader_messages`] and [`foxglove_mcap_reader_merge`].
+ *
+ * To use the default for any field, leave the field zero-initialized.
+ */
+typedef struct foxglove_mcap_read_options {
+  /**
+   * Only read messages logged at or after this time, in nanoseconds. Ignored if null.
+   */
+  const uint64_t *start_time;
+  /**
+   * Only read messages logged before this time, in nanoseconds. Ignored if null.
+   */
+  const uint64_t *end_time;
+  /**
+   * Only read messages on these topics. If null, messages on all topics are read.
+   */
+  const struct foxglove_string *topics;
+  /**
+   * The number of topics in `topics`.
+   */
+  size_t topics_count;
+  /**
+   * The order in which messages are read.
+   */
+  foxglove_mcap_read_order order;
+  /**
+   * Number of chunks to decompress in parallel. Values less than 2 decompress chunks on the
+   * thread which calls [`foxglove_mcap_message_iter_next`].
+   */
+  size_t decompression_threads;
+} foxglove_mcap_read_options;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A message read from an MCAP file.
+ */
+typedef struct foxglove_mcap_message {
+  /**
+   * The id of the channel the message was logged to.
+   */
+  uint16_t channel_id;
+  /**
+   * The message sequence number.
+   */
+  uint32_t sequence;
+  /**
+   * The time the message was logged, in nanoseconds.
+   */
+  uint64_t log_time;
+  /**
+   * The time the message was published, in nanoseconds.
+   */
+  uint64_t publish_time;
+  /**
+   * The message data. Valid until the next call to [`foxglove_mcap_message_iter_next`] or
+   * [`foxglove_mcap_message_iter_free`].
+   */
+  const uint8_t *data;
+  /**
+   * The length of the message data.
+   */
+  size_t data_len;
+  /**
+   * The index of the reader the message was read from, for iterators created with
+   * [`foxglove_mcap_reader_merge`]. Zero for other iterators.
+   */
+  size_t reader_index;
+} foxglove_mcap_message;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * The demand for the messages of a channel, combined across its sinks.
+ */
+typedef struct foxglove_channel_demand {
+  /**
+   * The number of consumers of the channel's messages. Sinks which fan out to several
+   * clients, such as a WebSocket server, count each subscribed client.
+   */
+  size_t consumers;
+  /**
+   * The highest rate at which any consumer receives messages, in messages per second. This is
+   * infinity if some consumer receives every message, and 0 if there are no consumers.
+   */
+  double max_rate;
+} foxglove_channel_demand;
+#endif
+
 #if !defined(__wasm__)
 /**
  * An iterator over channel metadata key-value pairs.
@@ -2381,6 +3167,39 @@ typedef struct foxglove_channel_metadata_iterator {
 } foxglove_channel_metadata_iterator;
 #endif
 
+#if !defined(__wasm__)
+/**
+ * The parameters of a channel created with [`foxglove_raw_channels_create`].
+ */
+typedef struct foxglove_channel_spec {
+  /**
+   * The topic of the channel.
+   */
+  struct foxglove_string topic;
+  /**
+   * The message encoding of the channel.
+   */
+  struct foxglove_string message_encoding;
+  /**
+   * An optional pointer to the schema of the channel.
+   */
+  const struct foxglove_schema *schema;
+  /**
+   * An optional pointer to the metadata of the channel.
+   */
+  const struct foxglove_channel_metadata *metadata;
+  /**
+   * The number of most recent messages which the channel retains and delivers to sinks that
+   * subscribe later, such as WebSocket clients that connect after the messages were logged.
+   * Zero retains no messages.
+   *
+   * To create a latched channel of a well-known type, use the type's schema function, such as
+   * `foxglove_frame_transforms_schema`, with the "protobuf" message encoding.
+   */
+  size_t keep_last;
+} foxglove_channel_spec;
+#endif
+
 #if !defined(__wasm__)
 /**
  * An iterator over a channel descriptor's metadata key-value pairs.
@@ -2393,18 +3212,23 @@ typedef struct foxglove_channel_descriptor_metadata_iterator {
 
 #if !defined(__wasm__)
 /**
- * A byte array with associated length.
+ * A single message in a batch passed to `foxglove_channel_log_batch`.
  */
-typedef struct foxglove_bytes {
+typedef struct foxglove_log_item {
   /**
-   * Pointer to data
+   * Pointer to the message data. May be null if `data_len` is 0.
    */
   const uint8_t *data;
   /**
-   * Number of bytes
+   * Length of the message data in bytes.
    */
-  size_t len;
-} foxglove_bytes;
+  size_t data_len;
+  /**
+   * Optional pointer to a log time in nanoseconds since epoch. If null, the current time is
+   * used.
+   */
+  const uint64_t *log_time;
+} foxglove_log_item;
 #endif
 
 #if !defined(__wasm__)
@@ -2545,21 +3369,123 @@ typedef struct foxglove_parameter_array {
 } foxglove_parameter_array;
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Callbacks for the remote access gateway.
- *
- * These methods are invoked from time-sensitive contexts and must not block.
+ * A borrowed array of parameter value descriptions.
  */
-typedef struct foxglove_gateway_callbacks {
+typedef struct foxglove_parameter_value_desc_array {
   /**
-   * A user-defined value that will be passed to callback functions.
+   * A pointer to the array of value descriptions.
    */
-  const void *context;
+  const struct foxglove_parameter_value_desc *values;
   /**
-   * Callback invoked when the gateway connection status changes.
+   * Number of elements in the array.
    */
-  void (*on_connection_status_changed)(const void *context, foxglove_connection_status status);
+  size_t len;
+} foxglove_parameter_value_desc_array;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A borrowed dictionary entry of a parameter value description.
+ */
+typedef struct foxglove_parameter_value_desc_entry {
+  /**
+   * The dictionary entry's key.
+   */
+  struct foxglove_string key;
+  /**
+   * The dictionary entry's value.
+   */
+  const struct foxglove_parameter_value_desc *value;
+} foxglove_parameter_value_desc_entry;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A borrowed dictionary of parameter value descriptions.
+ */
+typedef struct foxglove_parameter_value_desc_dict {
+  /**
+   * A pointer to the array of dictionary entries.
+   */
+  const struct foxglove_parameter_value_desc_entry *entries;
+  /**
+   * Number of elements in the dictionary.
+   */
+  size_t len;
+} foxglove_parameter_value_desc_dict;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Storage for `FoxgloveParameterValueDesc`.
+ */
+typedef union foxglove_parameter_value_desc_data {
+  double float64;
+  int64_t integer;
+  bool boolean;
+  struct foxglove_string string;
+  struct foxglove_parameter_value_desc_array array;
+  struct foxglove_parameter_value_desc_dict dict;
+} foxglove_parameter_value_desc_data;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A borrowed description of a WebSocket parameter value.
+ */
+typedef struct foxglove_parameter_value_desc {
+  /**
+   * A variant discriminator for the `data` union.
+   */
+  foxglove_parameter_value_tag tag;
+  /**
+   * Storage for the value's data.
+   */
+  union foxglove_parameter_value_desc_data data;
+} foxglove_parameter_value_desc;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A borrowed description of a WebSocket parameter, for
+ * `foxglove_parameter_array_create_from_descs`.
+ *
+ * Unlike `foxglove_parameter`, a description does not own its name or value, so a tree of
+ * descriptions can be allocated by the caller in bulk, and converted in a single call.
+ */
+typedef struct foxglove_parameter_desc {
+  /**
+   * Parameter name.
+   */
+  struct foxglove_string name;
+  /**
+   * Parameter type.
+   */
+  foxglove_parameter_type type;
+  /**
+   * Parameter value, or NULL if the parameter has no value.
+   */
+  const struct foxglove_parameter_value_desc *value;
+} foxglove_parameter_desc;
+#endif
+
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+/**
+ * Callbacks for the remote access gateway.
+ *
+ * These methods are invoked from time-sensitive contexts and must not block.
+ */
+typedef struct foxglove_gateway_callbacks {
+  /**
+   * A user-defined value that will be passed to callback functions.
+   */
+  const void *context;
+  /**
+   * Callback invoked when the gateway connection status changes.
+   */
+  void (*on_connection_status_changed)(const void *context, foxglove_connection_status status);
   /**
    * Callback invoked when a client subscribes to a channel.
    */
@@ -2684,9 +3610,51 @@ typedef uint8_t foxglove_gateway_capability;
  */
 typedef struct foxglove_qos_profile {
   foxglove_reliability reliability;
+  /**
+   * The priority of the channel's data. Priority takes effect for reliable channels when the
+   * gateway is configured with a dropping `message_backlog_policy`.
+   */
+  foxglove_priority priority;
+  /**
+   * How long a message may wait in a participant's message backlog before it is dropped, in
+   * milliseconds. 0 means messages never expire.
+   */
+  uint64_t lifespan_ms;
+  /**
+   * Maximum rate of messages sent for the channel, in messages per second. Messages logged
+   * faster than this are dropped. 0 means no limit.
+   */
+  double max_rate;
 } foxglove_qos_profile;
 #endif
 
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+/**
+ * Limits for published video tracks, which are also adapted to the available bandwidth.
+ *
+ * A field set to 0 uses its default.
+ */
+typedef struct foxglove_video_limits {
+  /**
+   * Maximum bitrate of each video track, in bits per second. Defaults to 4 Mbps.
+   */
+  uint64_t max_bitrate;
+  /**
+   * Maximum frame rate of each video track. Defaults to 30.
+   */
+  double max_framerate;
+  /**
+   * Lowest frame rate a track is reduced to when bandwidth is scarce. Defaults to 5.
+   */
+  double min_framerate;
+  /**
+   * Largest factor by which the width and height of frames are divided when bandwidth is
+   * scarce. Defaults to 4.
+   */
+  uint32_t max_downscale;
+} foxglove_video_limits;
+#endif
+
 #if !defined(__wasm__)
 /**
  * Handler for client-initiated parameter operations.
@@ -2800,6 +3768,14 @@ typedef struct foxglove_gateway_options {
    * This method is invoked from the client's main poll loop and must not block.
    */
   bool (*sink_channel_filter)(const void *context, const struct foxglove_channel_descriptor *channel);
+  /**
+   * Optional topic filter, created via `foxglove_topic_filter_create`.
+   *
+   * The filter is evaluated without calling into C, and its result is cached per channel. If
+   * `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+   * filter. The sink holds its own reference to the filter.
+   */
+  const struct foxglove_topic_filter *topic_filter;
   /**
    * Context provided to the `qos_classifier` callback.
    */
@@ -2890,6 +3866,67 @@ typedef struct foxglove_gateway_options {
    * (102400). Must be at least 1200.
    */
   size_t max_data_track_message_size;
+  /**
+   * Maximum number of bytes in each participant's backlog of messages for reliable channels.
+   * A value of 0 means the backlog is only limited by its number of messages. Has no effect
+   * with `FOXGLOVE_MESSAGE_BACKLOG_POLICY_DISCONNECT`.
+   */
+  size_t message_backlog_bytes;
+  /**
+   * How a participant's backlog handles messages for reliable channels when it fills up.
+   *
+   * Defaults to `FOXGLOVE_MESSAGE_BACKLOG_POLICY_DISCONNECT` (0), which disconnects the
+   * participant when its queue is full.
+   */
+  foxglove_message_backlog_policy message_backlog_policy;
+  /**
+   * Optional limits for published video tracks.
+   *
+   * If set, the bitrate and frame rate of each video track are limited, and its resolution and
+   * frame rate are adapted to the bandwidth estimated by the WebRTC congestion controller.
+   */
+  const struct foxglove_video_limits *video_limits;
+  /**
+   * Maximum size in bytes of a lossy message which is split into fragments rather than dropped
+   * when it exceeds `max_data_track_message_size`. A value of 0 disables fragmentation.
+   */
+  size_t max_fragmented_message_size;
+  /**
+   * Context provided to the `keyframe_request` callback.
+   */
+  const void *keyframe_request_context;
+  /**
+   * Asks the producer of a pre-encoded video channel for a keyframe.
+   *
+   * Channels carrying `foxglove.CompressedVideo` are forwarded to participants without
+   * transcoding. This callback is invoked when a participant subscribes to such a channel, or
+   * when the gateway drops one of its frames, so that viewers can resume decoding promptly. The
+   * producer should force its encoder to emit a keyframe. Requests are throttled per channel.
+   *
+   * This method is invoked from a time-sensitive context and must not block.
+   */
+  void (*keyframe_request)(const void *context,
+                           const struct foxglove_channel_descriptor *channel);
+  /**
+   * Whether published video tracks are sent as simulcast layers, at full, half and a quarter
+   * of their resolution, from which the server picks one for each participant.
+   *
+   * Each video channel is encoded once and shared by all participants either way. Defaults to
+   * false, since simulcast adds to the encoding cost of each track.
+   */
+  bool video_simulcast;
+  /**
+   * If nonzero, small messages published to a lossy channel's data track are packed into
+   * shared frames of one data-channel packet, each held for at most this many microseconds.
+   * A value of 0 disables packing. Viewers must support packed data-track frames.
+   */
+  uint64_t pack_linger_us;
+  /**
+   * Optional path of a file in which to cache the device info fetched from the Foxglove
+   * platform, so that a restarted gateway doesn't wait on the API to name itself. Empty string
+   * disables the cache.
+   */
+  struct foxglove_string device_info_cache_path;
 } foxglove_gateway_options;
 #endif
 
@@ -2900,6 +3937,101 @@ typedef struct foxglove_client_metadata {
 } foxglove_client_metadata;
 #endif
 
+#if !defined(__wasm__)
+/**
+ * Delivery counters for the messages logged to one of a client's subscribed channels.
+ */
+typedef struct foxglove_channel_stats {
+  /**
+   * The channel ID.
+   */
+  uint64_t channel_id;
+  /**
+   * The number of messages logged to the channel for the client, which is the sequence number
+   * of the latest message.
+   */
+  uint64_t sequence;
+  /**
+   * The number of messages sent to the client.
+   */
+  uint64_t sent;
+  /**
+   * The number of messages dropped to keep the client's backlog within its limits.
+   */
+  uint64_t dropped;
+  /**
+   * The number of queued messages which were replaced by a newer message of the channel,
+   * because the subscription is conflated.
+   */
+  uint64_t conflated;
+  /**
+   * The number of messages currently queued.
+   */
+  size_t queued_messages;
+  /**
+   * The number of bytes currently queued.
+   */
+  size_t queued_bytes;
+  /**
+   * The largest number of messages queued at once.
+   */
+  size_t max_queued_messages;
+  /**
+   * The largest number of bytes queued at once.
+   */
+  size_t max_queued_bytes;
+} foxglove_channel_stats;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Delivery counters for the data plane messages queued for a client.
+ */
+typedef struct foxglove_client_stats {
+  /**
+   * The client ID.
+   */
+  uint32_t client_id;
+  /**
+   * The number of messages sent to the client, including messages which were not logged to a
+   * channel.
+   */
+  uint64_t sent;
+  /**
+   * The number of bytes sent to the client.
+   */
+  uint64_t sent_bytes;
+  /**
+   * The number of messages dropped to keep the client's backlog within its limits.
+   */
+  uint64_t dropped;
+  /**
+   * The number of messages currently queued.
+   */
+  size_t queued_messages;
+  /**
+   * The number of bytes currently queued.
+   */
+  size_t queued_bytes;
+  /**
+   * The largest number of messages queued at once.
+   */
+  size_t max_queued_messages;
+  /**
+   * The largest number of bytes queued at once.
+   */
+  size_t max_queued_bytes;
+  /**
+   * Counters for each subscribed channel, ordered by channel ID.
+   */
+  const struct foxglove_channel_stats *channels;
+  /**
+   * The number of elements in `channels`.
+   */
+  size_t channels_count;
+} foxglove_client_stats;
+#endif
+
 #if !defined(__wasm__)
 typedef struct foxglove_client_channel {
   uint32_t id;
@@ -2961,6 +4093,34 @@ typedef struct foxglove_playback_state {
 } foxglove_playback_state;
 #endif
 
+#if !defined(__wasm__)
+/**
+ * A message received from a client, whose ownership is passed to `on_message_data_owned`.
+ *
+ * The data shares the buffer the message was received into. The receiver must call
+ * `release(release_context)` exactly once when it no longer needs `data`. The buffer may be
+ * released from any thread.
+ */
+typedef struct foxglove_client_message_buffer {
+  /**
+   * Pointer to the data
+   */
+  const uint8_t *data;
+  /**
+   * Number of bytes
+   */
+  size_t len;
+  /**
+   * Context to pass to `release`
+   */
+  void *release_context;
+  /**
+   * Release function: free the buffer
+   */
+  void (*release)(void *release_context);
+} foxglove_client_message_buffer;
+#endif
+
 #if !defined(__wasm__)
 typedef struct foxglove_server_callbacks {
   /**
@@ -2981,6 +4141,17 @@ typedef struct foxglove_server_callbacks {
                           uint32_t client_channel_id,
                           const uint8_t *payload,
                           size_t payload_len);
+  /**
+   * Callback invoked when a client message is received, with ownership of the payload.
+   *
+   * The payload shares the buffer the message was received into, so it can be kept without
+   * copying. The callee owns the buffer, and must release it as described by
+   * `FoxgloveClientMessageBuffer`. If set, `on_message_data` is not invoked.
+   */
+  void (*on_message_data_owned)(const void *context,
+                                uint32_t client_id,
+                                uint32_t client_channel_id,
+                                struct foxglove_client_message_buffer payload);
   void (*on_client_unadvertise)(uint32_t client_id, uint32_t client_channel_id, const void *context);
   /**
    * Callback invoked when a client requests parameters.
@@ -3061,6 +4232,19 @@ typedef struct foxglove_server_callbacks {
   void (*on_connection_graph_unsubscribe)(const void *context);
   void (*on_client_connect)(const void *context);
   void (*on_client_disconnect)(const void *context);
+  /**
+   * Callback invoked when messages are dropped from a client's backlog because the client
+   * can't keep up with the rate at which messages are logged.
+   *
+   * The callback is invoked at most once every 100 milliseconds for each client, so the
+   * counters may include drops since the previous call. Unlike the other callbacks, it is
+   * invoked from the thread which logged the message that overflowed the backlog, and must not
+   * block.
+   *
+   * The `stats` argument is guaranteed to be non-NULL, and is valid for the duration of the
+   * call.
+   */
+  void (*on_backpressure)(const void *context, const struct foxglove_client_stats *stats);
   /**
    * Callback invoked when a client sends a playback control request message.
    *
@@ -3078,7 +4262,27 @@ typedef struct foxglove_server_callbacks {
 #endif
 
 #if !defined(__wasm__)
-typedef uint8_t foxglove_server_capability;
+typedef uint16_t foxglove_server_capability;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Options for delivering the messages of each client subscription.
+ *
+ * To use the default for any field, leave the field zero-initialized.
+ */
+typedef struct foxglove_subscription_options {
+  /**
+   * The maximum rate at which messages are sent for each subscription, in messages per second.
+   * Rate-limited subscriptions are conflated. A value of 0 means unlimited.
+   */
+  double max_rate;
+  /**
+   * Whether to conflate the messages of each subscription, keeping only the latest message of
+   * each subscription queued for the client.
+   */
+  bool conflate;
+} foxglove_subscription_options;
 #endif
 
 #if !defined(__wasm__)
@@ -3164,6 +4368,41 @@ typedef struct foxglove_server_options {
    *   and must remain valid until the server is stopped.
    */
   bool (*sink_channel_filter)(const void *context, const struct foxglove_channel_descriptor *channel);
+  /**
+   * Optional topic filter, created via `foxglove_topic_filter_create`.
+   *
+   * The filter is evaluated without calling into C, and its result is cached per channel. If
+   * `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+   * filter. The sink holds its own reference to the filter.
+   */
+  const struct foxglove_topic_filter *topic_filter;
+  /**
+   * Context provided to the `message_filter` callback.
+   */
+  const void *message_filter_context;
+  /**
+   * A filter which runs on each message before it is sent to clients, so that clients can
+   * receive channels with a different policy than other sinks in the same context.
+   *
+   * Return false to drop the message, or true to send it. To send a different message
+   * instead, for example a cropped or downsampled copy, pass it to
+   * `foxglove_message_filter_output_replace` and return true. The message data is only valid
+   * for the duration of the callback.
+   *
+   * The callback is invoked once for each logged message, however many clients are
+   * connected, and its result is shared by all of them. It is invoked on the thread which logs
+   * the message, and must not block.
+   *
+   * # Safety
+   * - If provided, the callback must remain valid until the server is stopped, and may be
+   *   called from any thread.
+   */
+  bool (*message_filter)(const void *context,
+                         const struct foxglove_channel_descriptor *channel,
+                         const uint8_t *data,
+                         size_t data_len,
+                         uint64_t log_time,
+                         struct foxglove_message_filter_output *output);
   /**
    * If the server is sending data from a fixed time range, and has the PlaybackControl capability,
    * the start time of the data range.
@@ -3201,62 +4440,168 @@ typedef struct foxglove_server_options {
    * `foxglove_server_start` returns `FOXGLOVE_ERROR_VALUE_ERROR`.
    */
   const struct foxglove_parameter_handler *parameter_handler;
-} foxglove_server_options;
-#endif
-
-#if !defined(__wasm__)
-/**
- * A schema describing either a WebSocket service request or response.
- */
-typedef struct foxglove_service_message_schema {
   /**
-   * The message encoding.
+   * Number of threads used to send messages to clients. A value of 0 means client connections
+   * run on the SDK's shared runtime; otherwise the server creates a dedicated runtime with this
+   * many threads.
    */
-  struct foxglove_string encoding;
+  size_t writer_threads;
   /**
-   * The message schema.
+   * Maximum number of bytes queued for each client. A value of 0 means the backlog is only
+   * limited by its number of messages.
    */
-  struct foxglove_schema schema;
-} foxglove_service_message_schema;
-#endif
-
-#if !defined(__wasm__)
-/**
- * A WebSocket service schema.
- */
-typedef struct foxglove_service_schema {
+  size_t message_backlog_bytes;
   /**
-   * Service schema name.
+   * Maximum number of bytes queued for each channel of each client. A value of 0 means
+   * channels are not limited individually.
    */
-  struct foxglove_string name;
+  size_t channel_backlog_bytes;
   /**
-   * Optional request message schema.
+   * How messages are dropped when a client's backlog exceeds its limits.
    */
-  const struct foxglove_service_message_schema *request;
+  foxglove_backlog_drop_policy backlog_drop_policy;
   /**
-   * Optional response message schema.
+   * How the messages of each client subscription are delivered.
    */
-  const struct foxglove_service_message_schema *response;
-} foxglove_service_schema;
-#endif
-
-#if !defined(__wasm__)
-/**
- * A WebSocket service request message.
- */
-typedef struct foxglove_service_request {
+  struct foxglove_subscription_options subscription_options;
   /**
-   * The service name.
+   * Enable the permessage-deflate WebSocket extension for clients which offer it.
    */
-  struct foxglove_string service_name;
+  bool compression;
   /**
-   * The client ID.
+   * Context provided to the `compression_filter` callback.
    */
-  uint32_t client_id;
+  const void *compression_filter_context;
   /**
-   * The call ID that uniquely identifies this request for this client.
-   */
-  uint32_t call_id;
+   * A filter which selects the channels whose messages are compressed, when `compression` is
+   * enabled. Return false to send the channel's messages uncompressed.
+   *
+   * If not provided, all channels are compressed except those with schemas for data which is
+   * already compressed, such as `foxglove.CompressedImage` and `foxglove.CompressedVideo`.
+   *
+   * This method is invoked from the client's main poll loop and must not block.
+   *
+   * # Safety
+   * - If provided, the handler callback must be a pointer to the filter callback function,
+   *   and must remain valid until the server is stopped.
+   */
+  bool (*compression_filter)(const void *context, const struct foxglove_channel_descriptor *channel);
+  /**
+   * A shared-memory sink to advertise to clients, so that viewers on the same host can read
+   * messages from its ring buffer instead of the WebSocket connection.
+   *
+   * # Safety
+   * - If provided, the sink must have been created by `foxglove_shared_memory_sink_create`,
+   *   and must remain valid until this function returns.
+   */
+  const struct foxglove_shared_memory_sink *shared_memory_sink;
+  /**
+   * Maximum total size, in bytes, of the successful fetch asset responses to cache in memory.
+   * Requests for a cached URI are answered without invoking the `fetch_asset` callback, and
+   * the least recently used assets are evicted when the cache is full. A value of 0 disables
+   * the cache.
+   */
+  size_t fetch_asset_cache_bytes;
+  /**
+   * How long to collect values passed to `foxglove_server_publish_parameter_values` before
+   * sending them, in milliseconds, so that a burst of updates results in one message to each
+   * client with the latest value of each parameter. If 0, values are sent immediately. In
+   * either case, each client is only sent the values it has not already been sent.
+   */
+  uint64_t parameter_coalesce_window_ms;
+  /**
+   * How long to collect changes passed to `foxglove_server_update_connection_graph` and
+   * `foxglove_server_publish_connection_graph` before sending them, in milliseconds, so that a
+   * burst of changes results in one connection graph update to each subscribed client. If 0,
+   * changes are sent immediately.
+   */
+  uint64_t connection_graph_coalesce_window_ms;
+  /**
+   * Send broadcasts from `foxglove_server_broadcast_time` and
+   * `foxglove_server_broadcast_playback_state` at most once per this many milliseconds. The
+   * first broadcast after a quiet window is sent immediately, and the latest broadcast within
+   * the window is sent at its end, from the server's runtime. If 0, every broadcast is sent
+   * immediately.
+   */
+  uint64_t broadcast_coalesce_window_ms;
+  /**
+   * Bind the server's listener with `SO_REUSEPORT`, so that several servers sharing a context
+   * can listen on the same port, and the kernel distributes incoming connections across them.
+   * Every server sharing the port must set this. Only supported on Unix platforms.
+   */
+  bool reuse_port;
+  /**
+   * How long to wait for more messages to batch with a client's next message, in microseconds,
+   * for clients which enable message batches. If 0, a batch only gathers the messages already
+   * queued for the client. Requires `FOXGLOVE_SERVER_CAPABILITY_MESSAGE_BATCHES`.
+   */
+  uint64_t message_batch_linger_us;
+  /**
+   * Maximum size of a message batch, in bytes. A value of 0 means the default of 64 KiB.
+   */
+  size_t message_batch_bytes;
+  /**
+   * Hand TLS sessions to the kernel once their handshake is complete, so that messages are
+   * encrypted as they are written to the socket. Requires `tls_cert` and `tls_key`, and the
+   * Linux `tls` kernel module; otherwise the server encrypts in userspace.
+   */
+  bool kernel_tls;
+} foxglove_server_options;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A schema describing either a WebSocket service request or response.
+ */
+typedef struct foxglove_service_message_schema {
+  /**
+   * The message encoding.
+   */
+  struct foxglove_string encoding;
+  /**
+   * The message schema.
+   */
+  struct foxglove_schema schema;
+} foxglove_service_message_schema;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A WebSocket service schema.
+ */
+typedef struct foxglove_service_schema {
+  /**
+   * Service schema name.
+   */
+  struct foxglove_string name;
+  /**
+   * Optional request message schema.
+   */
+  const struct foxglove_service_message_schema *request;
+  /**
+   * Optional response message schema.
+   */
+  const struct foxglove_service_message_schema *response;
+} foxglove_service_schema;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A WebSocket service request message.
+ */
+typedef struct foxglove_service_request {
+  /**
+   * The service name.
+   */
+  struct foxglove_string service_name;
+  /**
+   * The client ID.
+   */
+  uint32_t client_id;
+  /**
+   * The call ID that uniquely identifies this request for this client.
+   */
+  uint32_t call_id;
   /**
    * The request encoding.
    */
@@ -3268,58 +4613,1295 @@ typedef struct foxglove_service_request {
 } foxglove_service_request;
 #endif
 
-#if !defined(__wasm__)
+#if !defined(__wasm__)
+/**
+ * Options for dispatching calls to a WebSocket service.
+ */
+typedef struct foxglove_service_options {
+  /**
+   * The number of worker threads dedicated to invoking the service's callback. If zero, the
+   * callback is invoked from the client's main poll loop.
+   */
+  size_t worker_threads;
+  /**
+   * The maximum number of calls to the service which may be in flight at once, across all
+   * clients. Further calls are queued until an in-flight call completes. If zero, the number of
+   * calls is unlimited.
+   */
+  size_t max_in_flight;
+  /**
+   * How long a call may wait in the queue before it fails, in milliseconds. If zero, queued
+   * calls wait indefinitely.
+   */
+  uint64_t queue_timeout_ms;
+  /**
+   * How long to cache successful responses, in milliseconds, for services whose calls are
+   * idempotent. If nonzero, calls with the same request encoding and payload are answered from
+   * the cache without invoking the callback, and identical calls which arrive while one is in
+   * flight wait for its response. If zero, responses are not cached.
+   */
+  uint64_t response_cache_ttl_ms;
+} foxglove_service_options;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A directory served by a file asset handler.
+ */
+typedef struct foxglove_file_asset_root {
+  /**
+   * The prefix of the URIs served from the directory, such as `package://my_robot/`.
+   */
+  struct foxglove_string uri_prefix;
+  /**
+   * The directory which the rest of the URI is resolved against.
+   */
+  struct foxglove_string directory;
+} foxglove_file_asset_root;
+#endif
+
+#if !defined(__wasm__)
+typedef struct foxglove_ring_buffer_sink_options {
+  /**
+   * `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+   * If it's null, the sink will be attached to the default context.
+   */
+  const struct foxglove_context *context;
+  /**
+   * How far back from the newest message to keep messages, in nanoseconds. A value of 0 means
+   * the default of 60 seconds.
+   */
+  uint64_t window_ns;
+  /**
+   * Maximum total size of the buffered message data, in bytes. A value of 0 means the default
+   * of 256 MiB. Messages larger than this are not buffered.
+   */
+  size_t max_bytes;
+  /**
+   * Options used to write snapshots, or null for the defaults. Only the options which control
+   * the MCAP format are used; the path, custom writer and sink options are ignored.
+   */
+  const struct foxglove_mcap_options *mcap_options;
+  /**
+   * Context provided to the `sink_channel_filter` callback.
+   */
+  const void *sink_channel_filter_context;
+  /**
+   * A filter for channels that can be used to subscribe to or unsubscribe from channels.
+   *
+   * This can be used to omit one or more channels from a sink, but still log all channels to
+   * another sink in the same context. Return false to disable logging of this channel.
+   *
+   * This method is invoked from the logging thread and must not block.
+   *
+   * # Safety
+   * - If provided, the handler callback must be a pointer to the filter callback function,
+   *   and must remain valid until the sink is closed.
+   */
+  bool (*sink_channel_filter)(const void *context, const struct foxglove_channel_descriptor *channel);
+  /**
+   * Optional topic filter, created via `foxglove_topic_filter_create`.
+   *
+   * The filter is evaluated without calling into C, and its result is cached per channel. If
+   * `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+   * filter. The sink holds its own reference to the filter.
+   */
+  const struct foxglove_topic_filter *topic_filter;
+} foxglove_ring_buffer_sink_options;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Options for the internal runtime which the SDK creates for its servers and publishers.
+ *
+ * Zero-initialize the struct to use the defaults.
+ */
+typedef struct foxglove_runtime_options {
+  /**
+   * Number of worker threads. A value of 0 means one per CPU.
+   */
+  size_t worker_threads;
+  /**
+   * Name of the runtime's threads, or null for the default.
+   */
+  const struct foxglove_string *thread_name;
+  /**
+   * Indices of the CPUs to run the runtime's threads on. If `cpu_affinity_count` is 0, threads
+   * may run on any CPU. Only supported on Linux.
+   *
+   * # Safety
+   * - If `cpu_affinity_count` is nonzero, `cpu_affinity` must be a valid pointer to an array
+   *   of that many indices.
+   */
+  const size_t *cpu_affinity;
+  size_t cpu_affinity_count;
+  /**
+   * Whether to set the nice value of the runtime's threads. Only supported on Linux.
+   */
+  bool set_nice;
+  /**
+   * Nice value of the runtime's threads, from -20 (highest priority) to 19 (lowest), if
+   * `set_nice` is true. Raising the priority requires privileges.
+   */
+  int32_t nice;
+} foxglove_runtime_options;
+#endif
+
+#if !defined(__wasm__)
+typedef struct foxglove_shared_memory_sink_options {
+  /**
+   * `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+   * If it's null, the sink will be attached to the default context.
+   */
+  const struct foxglove_context *context;
+  /**
+   * Path of the file backing the shared-memory ring. If empty, a file is created under
+   * `/dev/shm` (or the temporary directory) with a name unique to the process.
+   */
+  struct foxglove_string path;
+  /**
+   * Size of the ring buffer in bytes. A value of 0 means the default of 64 MiB.
+   */
+  size_t capacity;
+  /**
+   * Context provided to the `sink_channel_filter` callback.
+   */
+  const void *sink_channel_filter_context;
+  /**
+   * A filter for channels that can be used to subscribe to or unsubscribe from channels.
+   *
+   * This can be used to omit one or more channels from a sink, but still log all channels to
+   * another sink in the same context. Return false to disable logging of this channel.
+   *
+   * This method is invoked from the logging thread and must not block.
+   *
+   * # Safety
+   * - If provided, the handler callback must be a pointer to the filter callback function,
+   *   and must remain valid until the sink is closed.
+   */
+  bool (*sink_channel_filter)(const void *context, const struct foxglove_channel_descriptor *channel);
+  /**
+   * Optional topic filter, created via `foxglove_topic_filter_create`.
+   *
+   * The filter is evaluated without calling into C, and its result is cached per channel. If
+   * `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+   * filter. The sink holds its own reference to the filter.
+   */
+  const struct foxglove_topic_filter *topic_filter;
+} foxglove_shared_memory_sink_options;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Options for `foxglove_topic_filter_create`.
+ *
+ * A channel passes the filter if its topic matches any of the include patterns (or there are
+ * none), and none of the exclude patterns. In globs, `*` matches any sequence of characters other
+ * than `/`, `**` matches any sequence of characters, and `?` matches any single character other
+ * than `/`. Globs match the whole topic, while regular expressions match anywhere in the topic
+ * unless anchored with `^` and `$`.
+ */
+typedef struct foxglove_topic_filter_options {
+  /**
+   * Globs of the topics to include.
+   */
+  const struct foxglove_string *include_globs;
+  /**
+   * The number of elements in `include_globs`.
+   */
+  size_t include_globs_count;
+  /**
+   * Regular expressions of the topics to include.
+   */
+  const struct foxglove_string *include_regexes;
+  /**
+   * The number of elements in `include_regexes`.
+   */
+  size_t include_regexes_count;
+  /**
+   * Globs of the topics to exclude.
+   */
+  const struct foxglove_string *exclude_globs;
+  /**
+   * The number of elements in `exclude_globs`.
+   */
+  size_t exclude_globs_count;
+  /**
+   * Regular expressions of the topics to exclude.
+   */
+  const struct foxglove_string *exclude_regexes;
+  /**
+   * The number of elements in `exclude_regexes`.
+   */
+  size_t exclude_regexes_count;
+} foxglove_topic_filter_options;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Latency percentiles for one stage of the messages logged to a channel and delivered by a sink.
+ */
+typedef struct foxglove_latency_stats {
+  /**
+   * The sink which delivered the messages.
+   */
+  FoxgloveSinkId sink_id;
+  /**
+   * The channel the messages were logged to.
+   */
+  uint64_t channel_id;
+  /**
+   * The stage of delivery.
+   */
+  foxglove_latency_stage stage;
+  /**
+   * The number of sampled messages.
+   */
+  uint64_t count;
+  /**
+   * The median latency, in nanoseconds.
+   */
+  uint64_t p50_ns;
+  /**
+   * The 99th percentile latency, in nanoseconds.
+   */
+  uint64_t p99_ns;
+  /**
+   * The 99.9th percentile latency, in nanoseconds.
+   */
+  uint64_t p999_ns;
+  /**
+   * The largest latency, in nanoseconds.
+   */
+  uint64_t max_ns;
+} foxglove_latency_stats;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Options for [`foxglove_latency_tracer_install`].
+ *
+ * All fields are optional. To use the default for any field, leave the field zero-initialized.
+ */
+typedef struct foxglove_latency_tracer_options {
+  /**
+   * Sample one in every `sample_every` logged messages. When zero, defaults to 100.
+   */
+  uint32_t sample_every;
+  /**
+   * The number of recent samples retained for the Chrome trace export. When zero, defaults to
+   * 10000.
+   */
+  size_t trace_capacity;
+} foxglove_latency_tracer_options;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * A limit on the bytes buffered by the sinks of a context.
+ *
+ * The budget applies to the messages which WebSocket clients, remote access participants, and
+ * MCAP writers hold until they can be sent or written. When a sink would exceed the budget, or
+ * its pool's share of it, it drops messages or blocks according to its own overflow policy.
+ *
+ * Each share is the fraction of the budget, between 0 and 1, which the sinks of a pool may use.
+ * A share of zero leaves the pool limited only by the total budget.
+ */
+typedef struct foxglove_memory_budget {
+  /**
+   * The total number of bytes in the budget.
+   */
+  size_t bytes;
+  /**
+   * The share of the budget for the backlogs of WebSocket server clients.
+   */
+  double websocket_share;
+  /**
+   * The share of the budget for the backlogs of remote access participants.
+   */
+  double remote_access_share;
+  /**
+   * The share of the budget for the queues, open chunks, and pending output of MCAP writers.
+   */
+  double mcap_share;
+} foxglove_memory_budget;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * The bytes buffered by the sinks of a pool. See [`FoxgloveMemoryUsage`].
+ */
+typedef struct foxglove_memory_pool_usage {
+  /**
+   * The number of bytes currently buffered.
+   */
+  size_t bytes;
+  /**
+   * The highest number of bytes buffered at once.
+   */
+  size_t peak_bytes;
+  /**
+   * The number of bytes the pool may use, or zero if the context has no budget.
+   */
+  size_t limit;
+  /**
+   * The number of messages dropped because the budget or the pool's share was exhausted.
+   */
+  uint64_t dropped;
+} foxglove_memory_pool_usage;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * The bytes buffered by the sinks of a context.
+ */
+typedef struct foxglove_memory_usage {
+  /**
+   * The number of bytes currently buffered.
+   */
+  size_t bytes;
+  /**
+   * The highest number of bytes buffered at once.
+   */
+  size_t peak_bytes;
+  /**
+   * The budget, or zero if the context has none.
+   */
+  size_t limit;
+  /**
+   * The usage of WebSocket server clients.
+   */
+  struct foxglove_memory_pool_usage websocket;
+  /**
+   * The usage of remote access participants.
+   */
+  struct foxglove_memory_pool_usage remote_access;
+  /**
+   * The usage of MCAP writers.
+   */
+  struct foxglove_memory_pool_usage mcap;
+} foxglove_memory_usage;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Options for [`foxglove_sdk_stats_publisher_start`].
+ *
+ * All fields are optional. To use the default for any field, leave the field
+ * zero-initialized (e.g. by setting it via `memset` or `= {0}`).
+ *
+ * # Safety
+ * - `context`, when non-null, must be a valid pointer to a context created via
+ *   `foxglove_context_new`.
+ * - `topic`, when non-empty, must be a valid UTF-8 string.
+ */
+typedef struct foxglove_sdk_stats_publisher_options {
+  /**
+   * Optional context whose channels and sinks are reported, and on which the publisher
+   * creates its channel. When null, the default global context is used.
+   */
+  const struct foxglove_context *context;
+  /**
+   * Optional channel topic name. If `data` is null or `len` is 0, defaults to
+   * `/foxglove/sdk_stats`.
+   */
+  struct foxglove_string topic;
+  /**
+   * Optional refresh interval, in milliseconds.
+   *
+   * When null or zero, defaults to 1000 ms. Clamped to a minimum of 100 ms.
+   */
+  const uint64_t *refresh_interval_ms;
+} foxglove_sdk_stats_publisher_options;
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Options for [`foxglove_system_info_publisher_start`].
+ *
+ * All fields are optional. To use the default for any field, leave the field
+ * zero-initialized (e.g. by setting it via `memset` or `= {0}`).
+ *
+ * # Safety
+ * - `context`, when non-null, must be a valid pointer to a context created via
+ *   `foxglove_context_new`.
+ * - `topic`, when non-empty, must be a valid UTF-8 string.
+ */
+typedef struct foxglove_system_info_publisher_options {
+  /**
+   * Optional context to publish on. When null, the default global context is used.
+   */
+  const struct foxglove_context *context;
+  /**
+   * Optional channel topic name. If `data` is null or `len` is 0, defaults to `/sysinfo`.
+   */
+  struct foxglove_string topic;
+  /**
+   * Optional refresh interval, in milliseconds.
+   *
+   * When null or zero, defaults to 500 ms. Clamped to a minimum of 200 ms.
+   */
+  const uint64_t *refresh_interval_ms;
+  /**
+   * Optional bitmask of `FOXGLOVE_SYSINFO_METRIC_*` flags selecting the metrics to collect.
+   *
+   * When zero, defaults to process, CPU and memory metrics. Only the selected metrics are
+   * refreshed, and the fields of unselected metrics are omitted from each message.
+   */
+  uint32_t metrics;
+} foxglove_system_info_publisher_options;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#if !defined(__wasm__)
+/**
+ * For use by the C++ SDK. Identifies that wrapper as the source of logs.
+ */
+void foxglove_internal_register_cpp_wrapper(void);
+#endif
+
+#if !defined(__wasm__)
+/**
+ * For use by wrappers built on top of the SDK. Prepends a product token to library identifiers.
+ */
+void foxglove_internal_set_library_identifier_prefix(struct foxglove_string prefix);
+#endif
+
+/**
+ * Convert a `FoxgloveError` code to a C string.
+ */
+const char *foxglove_error_to_cstr(foxglove_error error);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_arrow_primitive(struct foxglove_string topic,
+                                                       const struct foxglove_context *context,
+                                                       const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a ArrowPrimitive message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_arrow_primitive.
+ */
+foxglove_error foxglove_channel_log_arrow_primitive(const struct foxglove_channel *channel,
+                                                    const struct foxglove_arrow_primitive *msg,
+                                                    const uint64_t *log_time,
+                                                    FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the ArrowPrimitive schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_arrow_primitive_schema(void);
+
+/**
+ * Encode a ArrowPrimitive message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_arrow_primitive_encode(const struct foxglove_arrow_primitive *msg,
+                                               uint8_t *ptr,
+                                               size_t len,
+                                               size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_camera_calibration(struct foxglove_string topic,
+                                                          const struct foxglove_context *context,
+                                                          const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a CameraCalibration message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_camera_calibration.
+ */
+foxglove_error foxglove_channel_log_camera_calibration(const struct foxglove_channel *channel,
+                                                       const struct foxglove_camera_calibration *msg,
+                                                       const uint64_t *log_time,
+                                                       FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the CameraCalibration schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_camera_calibration_schema(void);
+
+/**
+ * Encode a CameraCalibration message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_camera_calibration_encode(const struct foxglove_camera_calibration *msg,
+                                                  uint8_t *ptr,
+                                                  size_t len,
+                                                  size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_circle_annotation(struct foxglove_string topic,
+                                                         const struct foxglove_context *context,
+                                                         const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a CircleAnnotation message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_circle_annotation.
+ */
+foxglove_error foxglove_channel_log_circle_annotation(const struct foxglove_channel *channel,
+                                                      const struct foxglove_circle_annotation *msg,
+                                                      const uint64_t *log_time,
+                                                      FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the CircleAnnotation schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_circle_annotation_schema(void);
+
+/**
+ * Encode a CircleAnnotation message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_circle_annotation_encode(const struct foxglove_circle_annotation *msg,
+                                                 uint8_t *ptr,
+                                                 size_t len,
+                                                 size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_color(struct foxglove_string topic,
+                                             const struct foxglove_context *context,
+                                             const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a Color message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_color.
+ */
+foxglove_error foxglove_channel_log_color(const struct foxglove_channel *channel,
+                                          const struct foxglove_color *msg,
+                                          const uint64_t *log_time,
+                                          FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the Color schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_color_schema(void);
+
+/**
+ * Encode a Color message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_color_encode(const struct foxglove_color *msg,
+                                     uint8_t *ptr,
+                                     size_t len,
+                                     size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_compressed_audio(struct foxglove_string topic,
+                                                        const struct foxglove_context *context,
+                                                        const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a CompressedAudio message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_compressed_audio.
+ */
+foxglove_error foxglove_channel_log_compressed_audio(const struct foxglove_channel *channel,
+                                                     const struct foxglove_compressed_audio *msg,
+                                                     const uint64_t *log_time,
+                                                     FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the CompressedAudio schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_compressed_audio_schema(void);
+
+/**
+ * Encode a CompressedAudio message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_compressed_audio_encode(const struct foxglove_compressed_audio *msg,
+                                                uint8_t *ptr,
+                                                size_t len,
+                                                size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_compressed_image(struct foxglove_string topic,
+                                                        const struct foxglove_context *context,
+                                                        const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a CompressedImage message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_compressed_image.
+ */
+foxglove_error foxglove_channel_log_compressed_image(const struct foxglove_channel *channel,
+                                                     const struct foxglove_compressed_image *msg,
+                                                     const uint64_t *log_time,
+                                                     FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the CompressedImage schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_compressed_image_schema(void);
+
+/**
+ * Encode a CompressedImage message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_compressed_image_encode(const struct foxglove_compressed_image *msg,
+                                                uint8_t *ptr,
+                                                size_t len,
+                                                size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_compressed_point_cloud(struct foxglove_string topic,
+                                                              const struct foxglove_context *context,
+                                                              const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a CompressedPointCloud message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_compressed_point_cloud.
+ */
+foxglove_error foxglove_channel_log_compressed_point_cloud(const struct foxglove_channel *channel,
+                                                           const struct foxglove_compressed_point_cloud *msg,
+                                                           const uint64_t *log_time,
+                                                           FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the CompressedPointCloud schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_compressed_point_cloud_schema(void);
+
+/**
+ * Encode a CompressedPointCloud message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_compressed_point_cloud_encode(const struct foxglove_compressed_point_cloud *msg,
+                                                      uint8_t *ptr,
+                                                      size_t len,
+                                                      size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_compressed_video(struct foxglove_string topic,
+                                                        const struct foxglove_context *context,
+                                                        const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a CompressedVideo message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_compressed_video.
+ */
+foxglove_error foxglove_channel_log_compressed_video(const struct foxglove_channel *channel,
+                                                     const struct foxglove_compressed_video *msg,
+                                                     const uint64_t *log_time,
+                                                     FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the CompressedVideo schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_compressed_video_schema(void);
+
+/**
+ * Encode a CompressedVideo message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_compressed_video_encode(const struct foxglove_compressed_video *msg,
+                                                uint8_t *ptr,
+                                                size_t len,
+                                                size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_cylinder_primitive(struct foxglove_string topic,
+                                                          const struct foxglove_context *context,
+                                                          const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a CylinderPrimitive message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_cylinder_primitive.
+ */
+foxglove_error foxglove_channel_log_cylinder_primitive(const struct foxglove_channel *channel,
+                                                       const struct foxglove_cylinder_primitive *msg,
+                                                       const uint64_t *log_time,
+                                                       FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the CylinderPrimitive schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_cylinder_primitive_schema(void);
+
+/**
+ * Encode a CylinderPrimitive message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_cylinder_primitive_encode(const struct foxglove_cylinder_primitive *msg,
+                                                  uint8_t *ptr,
+                                                  size_t len,
+                                                  size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_cube_primitive(struct foxglove_string topic,
+                                                      const struct foxglove_context *context,
+                                                      const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a CubePrimitive message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_cube_primitive.
+ */
+foxglove_error foxglove_channel_log_cube_primitive(const struct foxglove_channel *channel,
+                                                   const struct foxglove_cube_primitive *msg,
+                                                   const uint64_t *log_time,
+                                                   FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the CubePrimitive schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_cube_primitive_schema(void);
+
+/**
+ * Encode a CubePrimitive message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_cube_primitive_encode(const struct foxglove_cube_primitive *msg,
+                                              uint8_t *ptr,
+                                              size_t len,
+                                              size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_event(struct foxglove_string topic,
+                                             const struct foxglove_context *context,
+                                             const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a Event message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_event.
+ */
+foxglove_error foxglove_channel_log_event(const struct foxglove_channel *channel,
+                                          const struct foxglove_event *msg,
+                                          const uint64_t *log_time,
+                                          FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the Event schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_event_schema(void);
+
+/**
+ * Encode a Event message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_event_encode(const struct foxglove_event *msg,
+                                     uint8_t *ptr,
+                                     size_t len,
+                                     size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_frame_transform(struct foxglove_string topic,
+                                                       const struct foxglove_context *context,
+                                                       const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a FrameTransform message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_frame_transform.
+ */
+foxglove_error foxglove_channel_log_frame_transform(const struct foxglove_channel *channel,
+                                                    const struct foxglove_frame_transform *msg,
+                                                    const uint64_t *log_time,
+                                                    FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the FrameTransform schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_frame_transform_schema(void);
+
+/**
+ * Encode a FrameTransform message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_frame_transform_encode(const struct foxglove_frame_transform *msg,
+                                               uint8_t *ptr,
+                                               size_t len,
+                                               size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_frame_transforms(struct foxglove_string topic,
+                                                        const struct foxglove_context *context,
+                                                        const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a FrameTransforms message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_frame_transforms.
+ */
+foxglove_error foxglove_channel_log_frame_transforms(const struct foxglove_channel *channel,
+                                                     const struct foxglove_frame_transforms *msg,
+                                                     const uint64_t *log_time,
+                                                     FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the FrameTransforms schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_frame_transforms_schema(void);
+
+/**
+ * Encode a FrameTransforms message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_frame_transforms_encode(const struct foxglove_frame_transforms *msg,
+                                                uint8_t *ptr,
+                                                size_t len,
+                                                size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_geo_json(struct foxglove_string topic,
+                                                const struct foxglove_context *context,
+                                                const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a GeoJson message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_geo_json.
+ */
+foxglove_error foxglove_channel_log_geo_json(const struct foxglove_channel *channel,
+                                             const struct foxglove_geo_json *msg,
+                                             const uint64_t *log_time,
+                                             FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the GeoJson schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_geo_json_schema(void);
+
+/**
+ * Encode a GeoJson message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_geo_json_encode(const struct foxglove_geo_json *msg,
+                                        uint8_t *ptr,
+                                        size_t len,
+                                        size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_grid(struct foxglove_string topic,
+                                            const struct foxglove_context *context,
+                                            const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a Grid message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_grid.
+ */
+foxglove_error foxglove_channel_log_grid(const struct foxglove_channel *channel,
+                                         const struct foxglove_grid *msg,
+                                         const uint64_t *log_time,
+                                         FoxgloveSinkId sink_id);
+#endif
+
+/**
+ * Get the Grid schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_grid_schema(void);
+
+/**
+ * Encode a Grid message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_grid_encode(const struct foxglove_grid *msg,
+                                    uint8_t *ptr,
+                                    size_t len,
+                                    size_t *encoded_len);
+
 /**
- * Options for [`foxglove_system_info_publisher_start`].
+ * Create a new typed channel, and return an owned raw channel pointer to it.
  *
- * All fields are optional. To use the default for any field, leave the field
- * zero-initialized (e.g. by setting it via `memset` or `= {0}`).
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_voxel_grid(struct foxglove_string topic,
+                                                  const struct foxglove_context *context,
+                                                  const struct foxglove_channel **channel);
+
+#if !defined(__wasm__)
+/**
+ * Log a VoxelGrid message to a channel.
  *
  * # Safety
- * - `context`, when non-null, must be a valid pointer to a context created via
- *   `foxglove_context_new`.
- * - `topic`, when non-empty, must be a valid UTF-8 string.
+ * The channel must have been created for this type with foxglove_channel_create_voxel_grid.
  */
-typedef struct foxglove_system_info_publisher_options {
-  /**
-   * Optional context to publish on. When null, the default global context is used.
-   */
-  const struct foxglove_context *context;
-  /**
-   * Optional channel topic name. If `data` is null or `len` is 0, defaults to `/sysinfo`.
-   */
-  struct foxglove_string topic;
-  /**
-   * Optional refresh interval, in milliseconds.
-   *
-   * When null or zero, defaults to 500 ms. Clamped to a minimum of 200 ms.
-   */
-  const uint64_t *refresh_interval_ms;
-} foxglove_system_info_publisher_options;
+foxglove_error foxglove_channel_log_voxel_grid(const struct foxglove_channel *channel,
+                                               const struct foxglove_voxel_grid *msg,
+                                               const uint64_t *log_time,
+                                               FoxgloveSinkId sink_id);
 #endif
 
-#ifdef __cplusplus
-extern "C" {
-#endif // __cplusplus
+/**
+ * Get the VoxelGrid schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_voxel_grid_schema(void);
+
+/**
+ * Encode a VoxelGrid message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_voxel_grid_encode(const struct foxglove_voxel_grid *msg,
+                                          uint8_t *ptr,
+                                          size_t len,
+                                          size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_image_annotations(struct foxglove_string topic,
+                                                         const struct foxglove_context *context,
+                                                         const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * For use by the C++ SDK. Identifies that wrapper as the source of logs.
+ * Log a ImageAnnotations message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_image_annotations.
  */
-void foxglove_internal_register_cpp_wrapper(void);
+foxglove_error foxglove_channel_log_image_annotations(const struct foxglove_channel *channel,
+                                                      const struct foxglove_image_annotations *msg,
+                                                      const uint64_t *log_time,
+                                                      FoxgloveSinkId sink_id);
 #endif
 
+/**
+ * Get the ImageAnnotations schema.
+ *
+ * All buffers in the returned schema are statically allocated.
+ */
+struct foxglove_schema foxglove_image_annotations_schema(void);
+
+/**
+ * Encode a ImageAnnotations message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_image_annotations_encode(const struct foxglove_image_annotations *msg,
+                                                 uint8_t *ptr,
+                                                 size_t len,
+                                                 size_t *encoded_len);
+
+/**
+ * Create a new typed channel, and return an owned raw channel pointer to it.
+ *
+ * # Safety
+ * We're trusting the caller that the channel will only be used with this type T.
+ */
+foxglove_error foxglove_channel_create_joint_state(struct foxglove_string topic,
+                                                   const struct foxglove_context *context,
+                                                   const struct foxglove_channel **channel);
+
 #if !defined(__wasm__)
 /**
- * For use by wrappers built on top of the SDK. Prepends a product token to library identifiers.
+ * Log a JointState message to a channel.
+ *
+ * # Safety
+ * The channel must have been created for this type with foxglove_channel_create_joint_state.
  */
-void foxglove_internal_set_library_identifier_prefix(struct foxglove_string prefix);
+foxglove_error foxglove_channel_log_joint_state(const struct foxglove_channel *channel,
+                                                const struct foxglove_joint_state *msg,
+                                                const uint64_t *log_time,
+                                                FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Convert a `FoxgloveError` code to a C string.
+ * Get the JointState schema.
+ *
+ * All buffers in the returned schema are statically allocated.
  */
-const char *foxglove_error_to_cstr(foxglove_error error);
+struct foxglove_schema foxglove_joint_state_schema(void);
+
+/**
+ * Encode a JointState message as protobuf to the buffer provided.
+ *
+ * On success, writes the encoded length to *encoded_len.
+ * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
+ * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
+ * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ *
+ * # Safety
+ * ptr must be a valid pointer to a memory region at least len bytes long.
+ */
+foxglove_error foxglove_joint_state_encode(const struct foxglove_joint_state *msg,
+                                           uint8_t *ptr,
+                                           size_t len,
+                                           size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3327,32 +5909,32 @@ const char *foxglove_error_to_cstr(foxglove_error error);
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_arrow_primitive(struct foxglove_string topic,
-                                                       const struct foxglove_context *context,
-                                                       const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_joint_states(struct foxglove_string topic,
+                                                    const struct foxglove_context *context,
+                                                    const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a ArrowPrimitive message to a channel.
+ * Log a JointStates message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_arrow_primitive.
+ * The channel must have been created for this type with foxglove_channel_create_joint_states.
  */
-foxglove_error foxglove_channel_log_arrow_primitive(const struct foxglove_channel *channel,
-                                                    const struct foxglove_arrow_primitive *msg,
-                                                    const uint64_t *log_time,
-                                                    FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_joint_states(const struct foxglove_channel *channel,
+                                                 const struct foxglove_joint_states *msg,
+                                                 const uint64_t *log_time,
+                                                 FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the ArrowPrimitive schema.
+ * Get the JointStates schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_arrow_primitive_schema(void);
+struct foxglove_schema foxglove_joint_states_schema(void);
 
 /**
- * Encode a ArrowPrimitive message as protobuf to the buffer provided.
+ * Encode a JointStates message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3362,10 +5944,10 @@ struct foxglove_schema foxglove_arrow_primitive_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_arrow_primitive_encode(const struct foxglove_arrow_primitive *msg,
-                                               uint8_t *ptr,
-                                               size_t len,
-                                               size_t *encoded_len);
+foxglove_error foxglove_joint_states_encode(const struct foxglove_joint_states *msg,
+                                            uint8_t *ptr,
+                                            size_t len,
+                                            size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3373,32 +5955,32 @@ foxglove_error foxglove_arrow_primitive_encode(const struct foxglove_arrow_primi
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_camera_calibration(struct foxglove_string topic,
-                                                          const struct foxglove_context *context,
-                                                          const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_key_value_pair(struct foxglove_string topic,
+                                                      const struct foxglove_context *context,
+                                                      const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a CameraCalibration message to a channel.
+ * Log a KeyValuePair message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_camera_calibration.
+ * The channel must have been created for this type with foxglove_channel_create_key_value_pair.
  */
-foxglove_error foxglove_channel_log_camera_calibration(const struct foxglove_channel *channel,
-                                                       const struct foxglove_camera_calibration *msg,
-                                                       const uint64_t *log_time,
-                                                       FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_key_value_pair(const struct foxglove_channel *channel,
+                                                   const struct foxglove_key_value_pair *msg,
+                                                   const uint64_t *log_time,
+                                                   FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the CameraCalibration schema.
+ * Get the KeyValuePair schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_camera_calibration_schema(void);
+struct foxglove_schema foxglove_key_value_pair_schema(void);
 
 /**
- * Encode a CameraCalibration message as protobuf to the buffer provided.
+ * Encode a KeyValuePair message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3408,10 +5990,10 @@ struct foxglove_schema foxglove_camera_calibration_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_camera_calibration_encode(const struct foxglove_camera_calibration *msg,
-                                                  uint8_t *ptr,
-                                                  size_t len,
-                                                  size_t *encoded_len);
+foxglove_error foxglove_key_value_pair_encode(const struct foxglove_key_value_pair *msg,
+                                              uint8_t *ptr,
+                                              size_t len,
+                                              size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3419,32 +6001,32 @@ foxglove_error foxglove_camera_calibration_encode(const struct foxglove_camera_c
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_circle_annotation(struct foxglove_string topic,
-                                                         const struct foxglove_context *context,
-                                                         const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_laser_scan(struct foxglove_string topic,
+                                                  const struct foxglove_context *context,
+                                                  const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a CircleAnnotation message to a channel.
+ * Log a LaserScan message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_circle_annotation.
+ * The channel must have been created for this type with foxglove_channel_create_laser_scan.
  */
-foxglove_error foxglove_channel_log_circle_annotation(const struct foxglove_channel *channel,
-                                                      const struct foxglove_circle_annotation *msg,
-                                                      const uint64_t *log_time,
-                                                      FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_laser_scan(const struct foxglove_channel *channel,
+                                               const struct foxglove_laser_scan *msg,
+                                               const uint64_t *log_time,
+                                               FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the CircleAnnotation schema.
+ * Get the LaserScan schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_circle_annotation_schema(void);
+struct foxglove_schema foxglove_laser_scan_schema(void);
 
 /**
- * Encode a CircleAnnotation message as protobuf to the buffer provided.
+ * Encode a LaserScan message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3454,10 +6036,10 @@ struct foxglove_schema foxglove_circle_annotation_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_circle_annotation_encode(const struct foxglove_circle_annotation *msg,
-                                                 uint8_t *ptr,
-                                                 size_t len,
-                                                 size_t *encoded_len);
+foxglove_error foxglove_laser_scan_encode(const struct foxglove_laser_scan *msg,
+                                          uint8_t *ptr,
+                                          size_t len,
+                                          size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3465,32 +6047,32 @@ foxglove_error foxglove_circle_annotation_encode(const struct foxglove_circle_an
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_color(struct foxglove_string topic,
-                                             const struct foxglove_context *context,
-                                             const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_line_primitive(struct foxglove_string topic,
+                                                      const struct foxglove_context *context,
+                                                      const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a Color message to a channel.
+ * Log a LinePrimitive message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_color.
+ * The channel must have been created for this type with foxglove_channel_create_line_primitive.
  */
-foxglove_error foxglove_channel_log_color(const struct foxglove_channel *channel,
-                                          const struct foxglove_color *msg,
-                                          const uint64_t *log_time,
-                                          FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_line_primitive(const struct foxglove_channel *channel,
+                                                   const struct foxglove_line_primitive *msg,
+                                                   const uint64_t *log_time,
+                                                   FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the Color schema.
+ * Get the LinePrimitive schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_color_schema(void);
+struct foxglove_schema foxglove_line_primitive_schema(void);
 
 /**
- * Encode a Color message as protobuf to the buffer provided.
+ * Encode a LinePrimitive message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3500,10 +6082,10 @@ struct foxglove_schema foxglove_color_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_color_encode(const struct foxglove_color *msg,
-                                     uint8_t *ptr,
-                                     size_t len,
-                                     size_t *encoded_len);
+foxglove_error foxglove_line_primitive_encode(const struct foxglove_line_primitive *msg,
+                                              uint8_t *ptr,
+                                              size_t len,
+                                              size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3511,32 +6093,32 @@ foxglove_error foxglove_color_encode(const struct foxglove_color *msg,
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_compressed_audio(struct foxglove_string topic,
-                                                        const struct foxglove_context *context,
-                                                        const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_location_fix(struct foxglove_string topic,
+                                                    const struct foxglove_context *context,
+                                                    const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a CompressedAudio message to a channel.
+ * Log a LocationFix message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_compressed_audio.
+ * The channel must have been created for this type with foxglove_channel_create_location_fix.
  */
-foxglove_error foxglove_channel_log_compressed_audio(const struct foxglove_channel *channel,
-                                                     const struct foxglove_compressed_audio *msg,
-                                                     const uint64_t *log_time,
-                                                     FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_location_fix(const struct foxglove_channel *channel,
+                                                 const struct foxglove_location_fix *msg,
+                                                 const uint64_t *log_time,
+                                                 FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the CompressedAudio schema.
+ * Get the LocationFix schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_compressed_audio_schema(void);
+struct foxglove_schema foxglove_location_fix_schema(void);
 
 /**
- * Encode a CompressedAudio message as protobuf to the buffer provided.
+ * Encode a LocationFix message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3546,10 +6128,10 @@ struct foxglove_schema foxglove_compressed_audio_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_compressed_audio_encode(const struct foxglove_compressed_audio *msg,
-                                                uint8_t *ptr,
-                                                size_t len,
-                                                size_t *encoded_len);
+foxglove_error foxglove_location_fix_encode(const struct foxglove_location_fix *msg,
+                                            uint8_t *ptr,
+                                            size_t len,
+                                            size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3557,32 +6139,32 @@ foxglove_error foxglove_compressed_audio_encode(const struct foxglove_compressed
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_compressed_image(struct foxglove_string topic,
-                                                        const struct foxglove_context *context,
-                                                        const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_location_fixes(struct foxglove_string topic,
+                                                      const struct foxglove_context *context,
+                                                      const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a CompressedImage message to a channel.
+ * Log a LocationFixes message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_compressed_image.
+ * The channel must have been created for this type with foxglove_channel_create_location_fixes.
  */
-foxglove_error foxglove_channel_log_compressed_image(const struct foxglove_channel *channel,
-                                                     const struct foxglove_compressed_image *msg,
-                                                     const uint64_t *log_time,
-                                                     FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_location_fixes(const struct foxglove_channel *channel,
+                                                   const struct foxglove_location_fixes *msg,
+                                                   const uint64_t *log_time,
+                                                   FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the CompressedImage schema.
+ * Get the LocationFixes schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_compressed_image_schema(void);
+struct foxglove_schema foxglove_location_fixes_schema(void);
 
 /**
- * Encode a CompressedImage message as protobuf to the buffer provided.
+ * Encode a LocationFixes message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3592,10 +6174,10 @@ struct foxglove_schema foxglove_compressed_image_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_compressed_image_encode(const struct foxglove_compressed_image *msg,
-                                                uint8_t *ptr,
-                                                size_t len,
-                                                size_t *encoded_len);
+foxglove_error foxglove_location_fixes_encode(const struct foxglove_location_fixes *msg,
+                                              uint8_t *ptr,
+                                              size_t len,
+                                              size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3603,32 +6185,32 @@ foxglove_error foxglove_compressed_image_encode(const struct foxglove_compressed
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_compressed_point_cloud(struct foxglove_string topic,
-                                                              const struct foxglove_context *context,
-                                                              const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_log(struct foxglove_string topic,
+                                           const struct foxglove_context *context,
+                                           const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a CompressedPointCloud message to a channel.
+ * Log a Log message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_compressed_point_cloud.
+ * The channel must have been created for this type with foxglove_channel_create_log.
  */
-foxglove_error foxglove_channel_log_compressed_point_cloud(const struct foxglove_channel *channel,
-                                                           const struct foxglove_compressed_point_cloud *msg,
-                                                           const uint64_t *log_time,
-                                                           FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_log(const struct foxglove_channel *channel,
+                                        const struct foxglove_log *msg,
+                                        const uint64_t *log_time,
+                                        FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the CompressedPointCloud schema.
+ * Get the Log schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_compressed_point_cloud_schema(void);
+struct foxglove_schema foxglove_log_schema(void);
 
 /**
- * Encode a CompressedPointCloud message as protobuf to the buffer provided.
+ * Encode a Log message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3638,10 +6220,10 @@ struct foxglove_schema foxglove_compressed_point_cloud_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_compressed_point_cloud_encode(const struct foxglove_compressed_point_cloud *msg,
-                                                      uint8_t *ptr,
-                                                      size_t len,
-                                                      size_t *encoded_len);
+foxglove_error foxglove_log_encode(const struct foxglove_log *msg,
+                                   uint8_t *ptr,
+                                   size_t len,
+                                   size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3649,32 +6231,32 @@ foxglove_error foxglove_compressed_point_cloud_encode(const struct foxglove_comp
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_compressed_video(struct foxglove_string topic,
-                                                        const struct foxglove_context *context,
-                                                        const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_scene_entity_deletion(struct foxglove_string topic,
+                                                             const struct foxglove_context *context,
+                                                             const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a CompressedVideo message to a channel.
+ * Log a SceneEntityDeletion message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_compressed_video.
+ * The channel must have been created for this type with foxglove_channel_create_scene_entity_deletion.
  */
-foxglove_error foxglove_channel_log_compressed_video(const struct foxglove_channel *channel,
-                                                     const struct foxglove_compressed_video *msg,
-                                                     const uint64_t *log_time,
-                                                     FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_scene_entity_deletion(const struct foxglove_channel *channel,
+                                                          const struct foxglove_scene_entity_deletion *msg,
+                                                          const uint64_t *log_time,
+                                                          FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the CompressedVideo schema.
+ * Get the SceneEntityDeletion schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_compressed_video_schema(void);
+struct foxglove_schema foxglove_scene_entity_deletion_schema(void);
 
 /**
- * Encode a CompressedVideo message as protobuf to the buffer provided.
+ * Encode a SceneEntityDeletion message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3684,10 +6266,10 @@ struct foxglove_schema foxglove_compressed_video_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_compressed_video_encode(const struct foxglove_compressed_video *msg,
-                                                uint8_t *ptr,
-                                                size_t len,
-                                                size_t *encoded_len);
+foxglove_error foxglove_scene_entity_deletion_encode(const struct foxglove_scene_entity_deletion *msg,
+                                                     uint8_t *ptr,
+                                                     size_t len,
+                                                     size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3695,32 +6277,32 @@ foxglove_error foxglove_compressed_video_encode(const struct foxglove_compressed
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_cylinder_primitive(struct foxglove_string topic,
-                                                          const struct foxglove_context *context,
-                                                          const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_scene_entity(struct foxglove_string topic,
+                                                    const struct foxglove_context *context,
+                                                    const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a CylinderPrimitive message to a channel.
+ * Log a SceneEntity message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_cylinder_primitive.
+ * The channel must have been created for this type with foxglove_channel_create_scene_entity.
  */
-foxglove_error foxglove_channel_log_cylinder_primitive(const struct foxglove_channel *channel,
-                                                       const struct foxglove_cylinder_primitive *msg,
-                                                       const uint64_t *log_time,
-                                                       FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_scene_entity(const struct foxglove_channel *channel,
+                                                 const struct foxglove_scene_entity *msg,
+                                                 const uint64_t *log_time,
+                                                 FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the CylinderPrimitive schema.
+ * Get the SceneEntity schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_cylinder_primitive_schema(void);
+struct foxglove_schema foxglove_scene_entity_schema(void);
 
 /**
- * Encode a CylinderPrimitive message as protobuf to the buffer provided.
+ * Encode a SceneEntity message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3730,10 +6312,10 @@ struct foxglove_schema foxglove_cylinder_primitive_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_cylinder_primitive_encode(const struct foxglove_cylinder_primitive *msg,
-                                                  uint8_t *ptr,
-                                                  size_t len,
-                                                  size_t *encoded_len);
+foxglove_error foxglove_scene_entity_encode(const struct foxglove_scene_entity *msg,
+                                            uint8_t *ptr,
+                                            size_t len,
+                                            size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3741,32 +6323,32 @@ foxglove_error foxglove_cylinder_primitive_encode(const struct foxglove_cylinder
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_cube_primitive(struct foxglove_string topic,
-                                                      const struct foxglove_context *context,
-                                                      const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_scene_update(struct foxglove_string topic,
+                                                    const struct foxglove_context *context,
+                                                    const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a CubePrimitive message to a channel.
+ * Log a SceneUpdate message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_cube_primitive.
+ * The channel must have been created for this type with foxglove_channel_create_scene_update.
  */
-foxglove_error foxglove_channel_log_cube_primitive(const struct foxglove_channel *channel,
-                                                   const struct foxglove_cube_primitive *msg,
-                                                   const uint64_t *log_time,
-                                                   FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_scene_update(const struct foxglove_channel *channel,
+                                                 const struct foxglove_scene_update *msg,
+                                                 const uint64_t *log_time,
+                                                 FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the CubePrimitive schema.
+ * Get the SceneUpdate schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_cube_primitive_schema(void);
+struct foxglove_schema foxglove_scene_update_schema(void);
 
 /**
- * Encode a CubePrimitive message as protobuf to the buffer provided.
+ * Encode a SceneUpdate message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3776,10 +6358,10 @@ struct foxglove_schema foxglove_cube_primitive_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_cube_primitive_encode(const struct foxglove_cube_primitive *msg,
-                                              uint8_t *ptr,
-                                              size_t len,
-                                              size_t *encoded_len);
+foxglove_error foxglove_scene_update_encode(const struct foxglove_scene_update *msg,
+                                            uint8_t *ptr,
+                                            size_t len,
+                                            size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3787,32 +6369,32 @@ foxglove_error foxglove_cube_primitive_encode(const struct foxglove_cube_primiti
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_event(struct foxglove_string topic,
-                                             const struct foxglove_context *context,
-                                             const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_model_primitive(struct foxglove_string topic,
+                                                       const struct foxglove_context *context,
+                                                       const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a Event message to a channel.
+ * Log a ModelPrimitive message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_event.
+ * The channel must have been created for this type with foxglove_channel_create_model_primitive.
  */
-foxglove_error foxglove_channel_log_event(const struct foxglove_channel *channel,
-                                          const struct foxglove_event *msg,
-                                          const uint64_t *log_time,
-                                          FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_model_primitive(const struct foxglove_channel *channel,
+                                                    const struct foxglove_model_primitive *msg,
+                                                    const uint64_t *log_time,
+                                                    FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the Event schema.
+ * Get the ModelPrimitive schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_event_schema(void);
+struct foxglove_schema foxglove_model_primitive_schema(void);
 
 /**
- * Encode a Event message as protobuf to the buffer provided.
+ * Encode a ModelPrimitive message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3822,10 +6404,10 @@ struct foxglove_schema foxglove_event_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_event_encode(const struct foxglove_event *msg,
-                                     uint8_t *ptr,
-                                     size_t len,
-                                     size_t *encoded_len);
+foxglove_error foxglove_model_primitive_encode(const struct foxglove_model_primitive *msg,
+                                               uint8_t *ptr,
+                                               size_t len,
+                                               size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3833,32 +6415,32 @@ foxglove_error foxglove_event_encode(const struct foxglove_event *msg,
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_frame_transform(struct foxglove_string topic,
-                                                       const struct foxglove_context *context,
-                                                       const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_odometry(struct foxglove_string topic,
+                                                const struct foxglove_context *context,
+                                                const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a FrameTransform message to a channel.
+ * Log a Odometry message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_frame_transform.
+ * The channel must have been created for this type with foxglove_channel_create_odometry.
  */
-foxglove_error foxglove_channel_log_frame_transform(const struct foxglove_channel *channel,
-                                                    const struct foxglove_frame_transform *msg,
-                                                    const uint64_t *log_time,
-                                                    FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_odometry(const struct foxglove_channel *channel,
+                                             const struct foxglove_odometry *msg,
+                                             const uint64_t *log_time,
+                                             FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the FrameTransform schema.
+ * Get the Odometry schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_frame_transform_schema(void);
+struct foxglove_schema foxglove_odometry_schema(void);
 
 /**
- * Encode a FrameTransform message as protobuf to the buffer provided.
+ * Encode a Odometry message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3868,10 +6450,10 @@ struct foxglove_schema foxglove_frame_transform_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_frame_transform_encode(const struct foxglove_frame_transform *msg,
-                                               uint8_t *ptr,
-                                               size_t len,
-                                               size_t *encoded_len);
+foxglove_error foxglove_odometry_encode(const struct foxglove_odometry *msg,
+                                        uint8_t *ptr,
+                                        size_t len,
+                                        size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3879,32 +6461,32 @@ foxglove_error foxglove_frame_transform_encode(const struct foxglove_frame_trans
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_frame_transforms(struct foxglove_string topic,
-                                                        const struct foxglove_context *context,
-                                                        const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_packed_element_field(struct foxglove_string topic,
+                                                            const struct foxglove_context *context,
+                                                            const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a FrameTransforms message to a channel.
+ * Log a PackedElementField message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_frame_transforms.
+ * The channel must have been created for this type with foxglove_channel_create_packed_element_field.
  */
-foxglove_error foxglove_channel_log_frame_transforms(const struct foxglove_channel *channel,
-                                                     const struct foxglove_frame_transforms *msg,
-                                                     const uint64_t *log_time,
-                                                     FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_packed_element_field(const struct foxglove_channel *channel,
+                                                         const struct foxglove_packed_element_field *msg,
+                                                         const uint64_t *log_time,
+                                                         FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the FrameTransforms schema.
+ * Get the PackedElementField schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_frame_transforms_schema(void);
+struct foxglove_schema foxglove_packed_element_field_schema(void);
 
 /**
- * Encode a FrameTransforms message as protobuf to the buffer provided.
+ * Encode a PackedElementField message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3914,10 +6496,10 @@ struct foxglove_schema foxglove_frame_transforms_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_frame_transforms_encode(const struct foxglove_frame_transforms *msg,
-                                                uint8_t *ptr,
-                                                size_t len,
-                                                size_t *encoded_len);
+foxglove_error foxglove_packed_element_field_encode(const struct foxglove_packed_element_field *msg,
+                                                    uint8_t *ptr,
+                                                    size_t len,
+                                                    size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3925,32 +6507,32 @@ foxglove_error foxglove_frame_transforms_encode(const struct foxglove_frame_tran
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_geo_json(struct foxglove_string topic,
-                                                const struct foxglove_context *context,
-                                                const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_point2(struct foxglove_string topic,
+                                              const struct foxglove_context *context,
+                                              const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a GeoJson message to a channel.
+ * Log a Point2 message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_geo_json.
+ * The channel must have been created for this type with foxglove_channel_create_point2.
  */
-foxglove_error foxglove_channel_log_geo_json(const struct foxglove_channel *channel,
-                                             const struct foxglove_geo_json *msg,
-                                             const uint64_t *log_time,
-                                             FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_point2(const struct foxglove_channel *channel,
+                                           const struct foxglove_point2 *msg,
+                                           const uint64_t *log_time,
+                                           FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the GeoJson schema.
+ * Get the Point2 schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_geo_json_schema(void);
+struct foxglove_schema foxglove_point2_schema(void);
 
 /**
- * Encode a GeoJson message as protobuf to the buffer provided.
+ * Encode a Point2 message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -3960,10 +6542,10 @@ struct foxglove_schema foxglove_geo_json_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_geo_json_encode(const struct foxglove_geo_json *msg,
-                                        uint8_t *ptr,
-                                        size_t len,
-                                        size_t *encoded_len);
+foxglove_error foxglove_point2_encode(const struct foxglove_point2 *msg,
+                                      uint8_t *ptr,
+                                      size_t len,
+                                      size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -3971,32 +6553,32 @@ foxglove_error foxglove_geo_json_encode(const struct foxglove_geo_json *msg,
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_grid(struct foxglove_string topic,
-                                            const struct foxglove_context *context,
-                                            const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_point3(struct foxglove_string topic,
+                                              const struct foxglove_context *context,
+                                              const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a Grid message to a channel.
+ * Log a Point3 message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_grid.
+ * The channel must have been created for this type with foxglove_channel_create_point3.
  */
-foxglove_error foxglove_channel_log_grid(const struct foxglove_channel *channel,
-                                         const struct foxglove_grid *msg,
-                                         const uint64_t *log_time,
-                                         FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_point3(const struct foxglove_channel *channel,
+                                           const struct foxglove_point3 *msg,
+                                           const uint64_t *log_time,
+                                           FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the Grid schema.
+ * Get the Point3 schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_grid_schema(void);
+struct foxglove_schema foxglove_point3_schema(void);
 
 /**
- * Encode a Grid message as protobuf to the buffer provided.
+ * Encode a Point3 message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4006,10 +6588,10 @@ struct foxglove_schema foxglove_grid_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_grid_encode(const struct foxglove_grid *msg,
-                                    uint8_t *ptr,
-                                    size_t len,
-                                    size_t *encoded_len);
+foxglove_error foxglove_point3_encode(const struct foxglove_point3 *msg,
+                                      uint8_t *ptr,
+                                      size_t len,
+                                      size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4017,32 +6599,32 @@ foxglove_error foxglove_grid_encode(const struct foxglove_grid *msg,
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_voxel_grid(struct foxglove_string topic,
-                                                  const struct foxglove_context *context,
-                                                  const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_point3_in_frame(struct foxglove_string topic,
+                                                       const struct foxglove_context *context,
+                                                       const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a VoxelGrid message to a channel.
+ * Log a Point3InFrame message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_voxel_grid.
+ * The channel must have been created for this type with foxglove_channel_create_point3_in_frame.
  */
-foxglove_error foxglove_channel_log_voxel_grid(const struct foxglove_channel *channel,
-                                               const struct foxglove_voxel_grid *msg,
-                                               const uint64_t *log_time,
-                                               FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_point3_in_frame(const struct foxglove_channel *channel,
+                                                    const struct foxglove_point3_in_frame *msg,
+                                                    const uint64_t *log_time,
+                                                    FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the VoxelGrid schema.
+ * Get the Point3InFrame schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_voxel_grid_schema(void);
+struct foxglove_schema foxglove_point3_in_frame_schema(void);
 
 /**
- * Encode a VoxelGrid message as protobuf to the buffer provided.
+ * Encode a Point3InFrame message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4052,10 +6634,10 @@ struct foxglove_schema foxglove_voxel_grid_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_voxel_grid_encode(const struct foxglove_voxel_grid *msg,
-                                          uint8_t *ptr,
-                                          size_t len,
-                                          size_t *encoded_len);
+foxglove_error foxglove_point3_in_frame_encode(const struct foxglove_point3_in_frame *msg,
+                                               uint8_t *ptr,
+                                               size_t len,
+                                               size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4063,32 +6645,32 @@ foxglove_error foxglove_voxel_grid_encode(const struct foxglove_voxel_grid *msg,
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_image_annotations(struct foxglove_string topic,
-                                                         const struct foxglove_context *context,
-                                                         const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_point_cloud(struct foxglove_string topic,
+                                                   const struct foxglove_context *context,
+                                                   const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a ImageAnnotations message to a channel.
+ * Log a PointCloud message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_image_annotations.
+ * The channel must have been created for this type with foxglove_channel_create_point_cloud.
  */
-foxglove_error foxglove_channel_log_image_annotations(const struct foxglove_channel *channel,
-                                                      const struct foxglove_image_annotations *msg,
-                                                      const uint64_t *log_time,
-                                                      FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_point_cloud(const struct foxglove_channel *channel,
+                                                const struct foxglove_point_cloud *msg,
+                                                const uint64_t *log_time,
+                                                FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the ImageAnnotations schema.
+ * Get the PointCloud schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_image_annotations_schema(void);
+struct foxglove_schema foxglove_point_cloud_schema(void);
 
 /**
- * Encode a ImageAnnotations message as protobuf to the buffer provided.
+ * Encode a PointCloud message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4098,10 +6680,10 @@ struct foxglove_schema foxglove_image_annotations_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_image_annotations_encode(const struct foxglove_image_annotations *msg,
-                                                 uint8_t *ptr,
-                                                 size_t len,
-                                                 size_t *encoded_len);
+foxglove_error foxglove_point_cloud_encode(const struct foxglove_point_cloud *msg,
+                                           uint8_t *ptr,
+                                           size_t len,
+                                           size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4109,32 +6691,32 @@ foxglove_error foxglove_image_annotations_encode(const struct foxglove_image_ann
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_joint_state(struct foxglove_string topic,
-                                                   const struct foxglove_context *context,
-                                                   const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_points_annotation(struct foxglove_string topic,
+                                                         const struct foxglove_context *context,
+                                                         const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a JointState message to a channel.
+ * Log a PointsAnnotation message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_joint_state.
+ * The channel must have been created for this type with foxglove_channel_create_points_annotation.
  */
-foxglove_error foxglove_channel_log_joint_state(const struct foxglove_channel *channel,
-                                                const struct foxglove_joint_state *msg,
-                                                const uint64_t *log_time,
-                                                FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_points_annotation(const struct foxglove_channel *channel,
+                                                      const struct foxglove_points_annotation *msg,
+                                                      const uint64_t *log_time,
+                                                      FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the JointState schema.
+ * Get the PointsAnnotation schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_joint_state_schema(void);
+struct foxglove_schema foxglove_points_annotation_schema(void);
 
 /**
- * Encode a JointState message as protobuf to the buffer provided.
+ * Encode a PointsAnnotation message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4144,10 +6726,10 @@ struct foxglove_schema foxglove_joint_state_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_joint_state_encode(const struct foxglove_joint_state *msg,
-                                           uint8_t *ptr,
-                                           size_t len,
-                                           size_t *encoded_len);
+foxglove_error foxglove_points_annotation_encode(const struct foxglove_points_annotation *msg,
+                                                 uint8_t *ptr,
+                                                 size_t len,
+                                                 size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4155,32 +6737,32 @@ foxglove_error foxglove_joint_state_encode(const struct foxglove_joint_state *ms
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_joint_states(struct foxglove_string topic,
-                                                    const struct foxglove_context *context,
-                                                    const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_pose(struct foxglove_string topic,
+                                            const struct foxglove_context *context,
+                                            const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a JointStates message to a channel.
+ * Log a Pose message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_joint_states.
+ * The channel must have been created for this type with foxglove_channel_create_pose.
  */
-foxglove_error foxglove_channel_log_joint_states(const struct foxglove_channel *channel,
-                                                 const struct foxglove_joint_states *msg,
-                                                 const uint64_t *log_time,
-                                                 FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_pose(const struct foxglove_channel *channel,
+                                         const struct foxglove_pose *msg,
+                                         const uint64_t *log_time,
+                                         FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the JointStates schema.
+ * Get the Pose schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_joint_states_schema(void);
+struct foxglove_schema foxglove_pose_schema(void);
 
 /**
- * Encode a JointStates message as protobuf to the buffer provided.
+ * Encode a Pose message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4190,10 +6772,10 @@ struct foxglove_schema foxglove_joint_states_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_joint_states_encode(const struct foxglove_joint_states *msg,
-                                            uint8_t *ptr,
-                                            size_t len,
-                                            size_t *encoded_len);
+foxglove_error foxglove_pose_encode(const struct foxglove_pose *msg,
+                                    uint8_t *ptr,
+                                    size_t len,
+                                    size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4201,32 +6783,32 @@ foxglove_error foxglove_joint_states_encode(const struct foxglove_joint_states *
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_key_value_pair(struct foxglove_string topic,
-                                                      const struct foxglove_context *context,
-                                                      const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_pose_in_frame(struct foxglove_string topic,
+                                                     const struct foxglove_context *context,
+                                                     const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a KeyValuePair message to a channel.
+ * Log a PoseInFrame message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_key_value_pair.
+ * The channel must have been created for this type with foxglove_channel_create_pose_in_frame.
  */
-foxglove_error foxglove_channel_log_key_value_pair(const struct foxglove_channel *channel,
-                                                   const struct foxglove_key_value_pair *msg,
-                                                   const uint64_t *log_time,
-                                                   FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_pose_in_frame(const struct foxglove_channel *channel,
+                                                  const struct foxglove_pose_in_frame *msg,
+                                                  const uint64_t *log_time,
+                                                  FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the KeyValuePair schema.
+ * Get the PoseInFrame schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_key_value_pair_schema(void);
+struct foxglove_schema foxglove_pose_in_frame_schema(void);
 
 /**
- * Encode a KeyValuePair message as protobuf to the buffer provided.
+ * Encode a PoseInFrame message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4236,10 +6818,10 @@ struct foxglove_schema foxglove_key_value_pair_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_key_value_pair_encode(const struct foxglove_key_value_pair *msg,
-                                              uint8_t *ptr,
-                                              size_t len,
-                                              size_t *encoded_len);
+foxglove_error foxglove_pose_in_frame_encode(const struct foxglove_pose_in_frame *msg,
+                                             uint8_t *ptr,
+                                             size_t len,
+                                             size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4247,32 +6829,32 @@ foxglove_error foxglove_key_value_pair_encode(const struct foxglove_key_value_pa
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_laser_scan(struct foxglove_string topic,
-                                                  const struct foxglove_context *context,
-                                                  const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_poses_in_frame(struct foxglove_string topic,
+                                                      const struct foxglove_context *context,
+                                                      const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a LaserScan message to a channel.
+ * Log a PosesInFrame message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_laser_scan.
+ * The channel must have been created for this type with foxglove_channel_create_poses_in_frame.
  */
-foxglove_error foxglove_channel_log_laser_scan(const struct foxglove_channel *channel,
-                                               const struct foxglove_laser_scan *msg,
-                                               const uint64_t *log_time,
-                                               FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_poses_in_frame(const struct foxglove_channel *channel,
+                                                   const struct foxglove_poses_in_frame *msg,
+                                                   const uint64_t *log_time,
+                                                   FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the LaserScan schema.
+ * Get the PosesInFrame schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_laser_scan_schema(void);
+struct foxglove_schema foxglove_poses_in_frame_schema(void);
 
 /**
- * Encode a LaserScan message as protobuf to the buffer provided.
+ * Encode a PosesInFrame message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4282,10 +6864,10 @@ struct foxglove_schema foxglove_laser_scan_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_laser_scan_encode(const struct foxglove_laser_scan *msg,
-                                          uint8_t *ptr,
-                                          size_t len,
-                                          size_t *encoded_len);
+foxglove_error foxglove_poses_in_frame_encode(const struct foxglove_poses_in_frame *msg,
+                                              uint8_t *ptr,
+                                              size_t len,
+                                              size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4293,32 +6875,32 @@ foxglove_error foxglove_laser_scan_encode(const struct foxglove_laser_scan *msg,
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_line_primitive(struct foxglove_string topic,
-                                                      const struct foxglove_context *context,
-                                                      const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_quaternion(struct foxglove_string topic,
+                                                  const struct foxglove_context *context,
+                                                  const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a LinePrimitive message to a channel.
+ * Log a Quaternion message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_line_primitive.
+ * The channel must have been created for this type with foxglove_channel_create_quaternion.
  */
-foxglove_error foxglove_channel_log_line_primitive(const struct foxglove_channel *channel,
-                                                   const struct foxglove_line_primitive *msg,
-                                                   const uint64_t *log_time,
-                                                   FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_quaternion(const struct foxglove_channel *channel,
+                                               const struct foxglove_quaternion *msg,
+                                               const uint64_t *log_time,
+                                               FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the LinePrimitive schema.
+ * Get the Quaternion schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_line_primitive_schema(void);
+struct foxglove_schema foxglove_quaternion_schema(void);
 
 /**
- * Encode a LinePrimitive message as protobuf to the buffer provided.
+ * Encode a Quaternion message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4328,10 +6910,10 @@ struct foxglove_schema foxglove_line_primitive_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_line_primitive_encode(const struct foxglove_line_primitive *msg,
-                                              uint8_t *ptr,
-                                              size_t len,
-                                              size_t *encoded_len);
+foxglove_error foxglove_quaternion_encode(const struct foxglove_quaternion *msg,
+                                          uint8_t *ptr,
+                                          size_t len,
+                                          size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4339,32 +6921,32 @@ foxglove_error foxglove_line_primitive_encode(const struct foxglove_line_primiti
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_location_fix(struct foxglove_string topic,
-                                                    const struct foxglove_context *context,
-                                                    const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_raw_audio(struct foxglove_string topic,
+                                                 const struct foxglove_context *context,
+                                                 const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a LocationFix message to a channel.
+ * Log a RawAudio message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_location_fix.
+ * The channel must have been created for this type with foxglove_channel_create_raw_audio.
  */
-foxglove_error foxglove_channel_log_location_fix(const struct foxglove_channel *channel,
-                                                 const struct foxglove_location_fix *msg,
-                                                 const uint64_t *log_time,
-                                                 FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_raw_audio(const struct foxglove_channel *channel,
+                                              const struct foxglove_raw_audio *msg,
+                                              const uint64_t *log_time,
+                                              FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the LocationFix schema.
+ * Get the RawAudio schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_location_fix_schema(void);
+struct foxglove_schema foxglove_raw_audio_schema(void);
 
 /**
- * Encode a LocationFix message as protobuf to the buffer provided.
+ * Encode a RawAudio message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4374,10 +6956,10 @@ struct foxglove_schema foxglove_location_fix_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_location_fix_encode(const struct foxglove_location_fix *msg,
-                                            uint8_t *ptr,
-                                            size_t len,
-                                            size_t *encoded_len);
+foxglove_error foxglove_raw_audio_encode(const struct foxglove_raw_audio *msg,
+                                         uint8_t *ptr,
+                                         size_t len,
+                                         size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4385,32 +6967,32 @@ foxglove_error foxglove_location_fix_encode(const struct foxglove_location_fix *
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_location_fixes(struct foxglove_string topic,
-                                                      const struct foxglove_context *context,
-                                                      const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_raw_image(struct foxglove_string topic,
+                                                 const struct foxglove_context *context,
+                                                 const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a LocationFixes message to a channel.
+ * Log a RawImage message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_location_fixes.
+ * The channel must have been created for this type with foxglove_channel_create_raw_image.
  */
-foxglove_error foxglove_channel_log_location_fixes(const struct foxglove_channel *channel,
-                                                   const struct foxglove_location_fixes *msg,
-                                                   const uint64_t *log_time,
-                                                   FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_raw_image(const struct foxglove_channel *channel,
+                                              const struct foxglove_raw_image *msg,
+                                              const uint64_t *log_time,
+                                              FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the LocationFixes schema.
+ * Get the RawImage schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_location_fixes_schema(void);
+struct foxglove_schema foxglove_raw_image_schema(void);
 
 /**
- * Encode a LocationFixes message as protobuf to the buffer provided.
+ * Encode a RawImage message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4420,10 +7002,10 @@ struct foxglove_schema foxglove_location_fixes_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_location_fixes_encode(const struct foxglove_location_fixes *msg,
-                                              uint8_t *ptr,
-                                              size_t len,
-                                              size_t *encoded_len);
+foxglove_error foxglove_raw_image_encode(const struct foxglove_raw_image *msg,
+                                         uint8_t *ptr,
+                                         size_t len,
+                                         size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4431,32 +7013,32 @@ foxglove_error foxglove_location_fixes_encode(const struct foxglove_location_fix
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_log(struct foxglove_string topic,
-                                           const struct foxglove_context *context,
-                                           const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_sphere_primitive(struct foxglove_string topic,
+                                                        const struct foxglove_context *context,
+                                                        const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a Log message to a channel.
+ * Log a SpherePrimitive message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_log.
+ * The channel must have been created for this type with foxglove_channel_create_sphere_primitive.
  */
-foxglove_error foxglove_channel_log_log(const struct foxglove_channel *channel,
-                                        const struct foxglove_log *msg,
-                                        const uint64_t *log_time,
-                                        FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_sphere_primitive(const struct foxglove_channel *channel,
+                                                     const struct foxglove_sphere_primitive *msg,
+                                                     const uint64_t *log_time,
+                                                     FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the Log schema.
+ * Get the SpherePrimitive schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_log_schema(void);
+struct foxglove_schema foxglove_sphere_primitive_schema(void);
 
 /**
- * Encode a Log message as protobuf to the buffer provided.
+ * Encode a SpherePrimitive message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4466,10 +7048,10 @@ struct foxglove_schema foxglove_log_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_log_encode(const struct foxglove_log *msg,
-                                   uint8_t *ptr,
-                                   size_t len,
-                                   size_t *encoded_len);
+foxglove_error foxglove_sphere_primitive_encode(const struct foxglove_sphere_primitive *msg,
+                                                uint8_t *ptr,
+                                                size_t len,
+                                                size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4477,32 +7059,32 @@ foxglove_error foxglove_log_encode(const struct foxglove_log *msg,
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_scene_entity_deletion(struct foxglove_string topic,
-                                                             const struct foxglove_context *context,
-                                                             const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_text_annotation(struct foxglove_string topic,
+                                                       const struct foxglove_context *context,
+                                                       const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a SceneEntityDeletion message to a channel.
+ * Log a TextAnnotation message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_scene_entity_deletion.
+ * The channel must have been created for this type with foxglove_channel_create_text_annotation.
  */
-foxglove_error foxglove_channel_log_scene_entity_deletion(const struct foxglove_channel *channel,
-                                                          const struct foxglove_scene_entity_deletion *msg,
-                                                          const uint64_t *log_time,
-                                                          FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_text_annotation(const struct foxglove_channel *channel,
+                                                    const struct foxglove_text_annotation *msg,
+                                                    const uint64_t *log_time,
+                                                    FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the SceneEntityDeletion schema.
+ * Get the TextAnnotation schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_scene_entity_deletion_schema(void);
+struct foxglove_schema foxglove_text_annotation_schema(void);
 
 /**
- * Encode a SceneEntityDeletion message as protobuf to the buffer provided.
+ * Encode a TextAnnotation message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4512,10 +7094,10 @@ struct foxglove_schema foxglove_scene_entity_deletion_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_scene_entity_deletion_encode(const struct foxglove_scene_entity_deletion *msg,
-                                                     uint8_t *ptr,
-                                                     size_t len,
-                                                     size_t *encoded_len);
+foxglove_error foxglove_text_annotation_encode(const struct foxglove_text_annotation *msg,
+                                               uint8_t *ptr,
+                                               size_t len,
+                                               size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4523,32 +7105,32 @@ foxglove_error foxglove_scene_entity_deletion_encode(const struct foxglove_scene
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_scene_entity(struct foxglove_string topic,
-                                                    const struct foxglove_context *context,
-                                                    const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_text_primitive(struct foxglove_string topic,
+                                                      const struct foxglove_context *context,
+                                                      const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a SceneEntity message to a channel.
+ * Log a TextPrimitive message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_scene_entity.
+ * The channel must have been created for this type with foxglove_channel_create_text_primitive.
  */
-foxglove_error foxglove_channel_log_scene_entity(const struct foxglove_channel *channel,
-                                                 const struct foxglove_scene_entity *msg,
-                                                 const uint64_t *log_time,
-                                                 FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_text_primitive(const struct foxglove_channel *channel,
+                                                   const struct foxglove_text_primitive *msg,
+                                                   const uint64_t *log_time,
+                                                   FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the SceneEntity schema.
+ * Get the TextPrimitive schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_scene_entity_schema(void);
+struct foxglove_schema foxglove_text_primitive_schema(void);
 
 /**
- * Encode a SceneEntity message as protobuf to the buffer provided.
+ * Encode a TextPrimitive message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4558,10 +7140,10 @@ struct foxglove_schema foxglove_scene_entity_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_scene_entity_encode(const struct foxglove_scene_entity *msg,
-                                            uint8_t *ptr,
-                                            size_t len,
-                                            size_t *encoded_len);
+foxglove_error foxglove_text_primitive_encode(const struct foxglove_text_primitive *msg,
+                                              uint8_t *ptr,
+                                              size_t len,
+                                              size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4569,32 +7151,32 @@ foxglove_error foxglove_scene_entity_encode(const struct foxglove_scene_entity *
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_scene_update(struct foxglove_string topic,
-                                                    const struct foxglove_context *context,
-                                                    const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_triangle_list_primitive(struct foxglove_string topic,
+                                                               const struct foxglove_context *context,
+                                                               const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a SceneUpdate message to a channel.
+ * Log a TriangleListPrimitive message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_scene_update.
+ * The channel must have been created for this type with foxglove_channel_create_triangle_list_primitive.
  */
-foxglove_error foxglove_channel_log_scene_update(const struct foxglove_channel *channel,
-                                                 const struct foxglove_scene_update *msg,
-                                                 const uint64_t *log_time,
-                                                 FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_triangle_list_primitive(const struct foxglove_channel *channel,
+                                                            const struct foxglove_triangle_list_primitive *msg,
+                                                            const uint64_t *log_time,
+                                                            FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the SceneUpdate schema.
+ * Get the TriangleListPrimitive schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_scene_update_schema(void);
+struct foxglove_schema foxglove_triangle_list_primitive_schema(void);
 
 /**
- * Encode a SceneUpdate message as protobuf to the buffer provided.
+ * Encode a TriangleListPrimitive message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4604,10 +7186,10 @@ struct foxglove_schema foxglove_scene_update_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_scene_update_encode(const struct foxglove_scene_update *msg,
-                                            uint8_t *ptr,
-                                            size_t len,
-                                            size_t *encoded_len);
+foxglove_error foxglove_triangle_list_primitive_encode(const struct foxglove_triangle_list_primitive *msg,
+                                                       uint8_t *ptr,
+                                                       size_t len,
+                                                       size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4615,32 +7197,32 @@ foxglove_error foxglove_scene_update_encode(const struct foxglove_scene_update *
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_model_primitive(struct foxglove_string topic,
-                                                       const struct foxglove_context *context,
-                                                       const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_vector2(struct foxglove_string topic,
+                                               const struct foxglove_context *context,
+                                               const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a ModelPrimitive message to a channel.
+ * Log a Vector2 message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_model_primitive.
+ * The channel must have been created for this type with foxglove_channel_create_vector2.
  */
-foxglove_error foxglove_channel_log_model_primitive(const struct foxglove_channel *channel,
-                                                    const struct foxglove_model_primitive *msg,
-                                                    const uint64_t *log_time,
-                                                    FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_vector2(const struct foxglove_channel *channel,
+                                            const struct foxglove_vector2 *msg,
+                                            const uint64_t *log_time,
+                                            FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the ModelPrimitive schema.
+ * Get the Vector2 schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_model_primitive_schema(void);
+struct foxglove_schema foxglove_vector2_schema(void);
 
 /**
- * Encode a ModelPrimitive message as protobuf to the buffer provided.
+ * Encode a Vector2 message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4650,10 +7232,10 @@ struct foxglove_schema foxglove_model_primitive_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_model_primitive_encode(const struct foxglove_model_primitive *msg,
-                                               uint8_t *ptr,
-                                               size_t len,
-                                               size_t *encoded_len);
+foxglove_error foxglove_vector2_encode(const struct foxglove_vector2 *msg,
+                                       uint8_t *ptr,
+                                       size_t len,
+                                       size_t *encoded_len);
 
 /**
  * Create a new typed channel, and return an owned raw channel pointer to it.
@@ -4661,32 +7243,32 @@ foxglove_error foxglove_model_primitive_encode(const struct foxglove_model_primi
  * # Safety
  * We're trusting the caller that the channel will only be used with this type T.
  */
-foxglove_error foxglove_channel_create_odometry(struct foxglove_string topic,
-                                                const struct foxglove_context *context,
-                                                const struct foxglove_channel **channel);
+foxglove_error foxglove_channel_create_vector3(struct foxglove_string topic,
+                                               const struct foxglove_context *context,
+                                               const struct foxglove_channel **channel);
 
 #if !defined(__wasm__)
 /**
- * Log a Odometry message to a channel.
+ * Log a Vector3 message to a channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_odometry.
+ * The channel must have been created for this type with foxglove_channel_create_vector3.
  */
-foxglove_error foxglove_channel_log_odometry(const struct foxglove_channel *channel,
-                                             const struct foxglove_odometry *msg,
-                                             const uint64_t *log_time,
-                                             FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log_vector3(const struct foxglove_channel *channel,
+                                            const struct foxglove_vector3 *msg,
+                                            const uint64_t *log_time,
+                                            FoxgloveSinkId sink_id);
 #endif
 
 /**
- * Get the Odometry schema.
+ * Get the Vector3 schema.
  *
  * All buffers in the returned schema are statically allocated.
  */
-struct foxglove_schema foxglove_odometry_schema(void);
+struct foxglove_schema foxglove_vector3_schema(void);
 
 /**
- * Encode a Odometry message as protobuf to the buffer provided.
+ * Encode a Vector3 message as protobuf to the buffer provided.
  *
  * On success, writes the encoded length to *encoded_len.
  * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
@@ -4696,2228 +7278,2625 @@ struct foxglove_schema foxglove_odometry_schema(void);
  * # Safety
  * ptr must be a valid pointer to a memory region at least len bytes long.
  */
-foxglove_error foxglove_odometry_encode(const struct foxglove_odometry *msg,
-                                        uint8_t *ptr,
-                                        size_t len,
-                                        size_t *encoded_len);
+foxglove_error foxglove_vector3_encode(const struct foxglove_vector3 *msg,
+                                       uint8_t *ptr,
+                                       size_t len,
+                                       size_t *encoded_len);
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Returns a `FoxgloveMcapOptions` with defaults matching `mcap::WriteOptions::default()`.
+ *
+ * The test `test_mcap_options_default_matches_write_options` verifies these stay in sync.
+ */
+struct foxglove_mcap_options foxglove_mcap_options_default(void);
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Create or open an MCAP writer for writing to a file or custom destination.
+ * Resources must later be freed with `foxglove_mcap_close`.
+ *
+ * If `custom_writer` is provided, the MCAP data will be written using the provided
+ * function pointers instead of to a file.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `path` and `profile` must contain valid UTF8. If `context` is non-null,
+ * it must have been created by `foxglove_context_new`.
+ * If `custom_writer` is non-null, its function pointers must be valid and
+ * all `context` pointers must remain valid for the lifetime of the writer.
  */
-foxglove_error foxglove_channel_create_packed_element_field(struct foxglove_string topic,
-                                                            const struct foxglove_context *context,
-                                                            const struct foxglove_channel **channel);
+foxglove_error foxglove_mcap_open(const struct foxglove_mcap_options *FOXGLOVE_NONNULL options,
+                                  struct foxglove_mcap_writer **writer);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a PackedElementField message to a channel.
+ * Close an MCAP file writer created via `foxglove_mcap_open`.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_packed_element_field.
+ * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
  */
-foxglove_error foxglove_channel_log_packed_element_field(const struct foxglove_channel *channel,
-                                                         const struct foxglove_packed_element_field *msg,
-                                                         const uint64_t *log_time,
-                                                         FoxgloveSinkId sink_id);
+foxglove_error foxglove_mcap_close(struct foxglove_mcap_writer *writer);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the PackedElementField schema.
+ * Finishes the current chunk (if any) and flushes the underlying writer.
  *
- * All buffers in the returned schema are statically allocated.
+ * Note that compression ratios tend to improve over the lifetime of a chunk, so flushing
+ * frequently with chunked output may reduce overall compression.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
+ *
+ * # Safety
+ * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
  */
-struct foxglove_schema foxglove_packed_element_field_schema(void);
+foxglove_error foxglove_mcap_flush(struct foxglove_mcap_writer *writer);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a PackedElementField message as protobuf to the buffer provided.
+ * Get the queue depth and number of dropped messages of an MCAP writer.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Both are always zero unless the writer was opened with `async_writes` set.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
+ * `stats` must be a valid pointer to a `FoxgloveMcapWriterStats`.
  */
-foxglove_error foxglove_packed_element_field_encode(const struct foxglove_packed_element_field *msg,
-                                                    uint8_t *ptr,
-                                                    size_t len,
-                                                    size_t *encoded_len);
+foxglove_error foxglove_mcap_get_stats(const struct foxglove_mcap_writer *writer,
+                                       struct foxglove_mcap_writer_stats *stats);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Get the sink ID of an MCAP writer.
+ *
+ * Messages logged with this sink ID are written only to this writer's file.
+ *
+ * Returns 0 if the writer pointer is null or the writer has been closed.
+ */
+FoxgloveSinkId foxglove_mcap_sink_id(const struct foxglove_mcap_writer *writer);
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Write metadata to an MCAP file.
+ *
+ * Metadata consists of key-value string pairs associated with a name.
+ * If the metadata has no key-value pairs, this method does nothing.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
+ * `name` must be a valid UTF-8 string.
+ * `metadata` must be a valid pointer to an array of `foxglove_key_value` with length `metadata_len`.
  */
-foxglove_error foxglove_channel_create_point2(struct foxglove_string topic,
-                                              const struct foxglove_context *context,
-                                              const struct foxglove_channel **channel);
+foxglove_error foxglove_mcap_write_metadata(struct foxglove_mcap_writer *writer,
+                                            const struct foxglove_string *FOXGLOVE_NONNULL name,
+                                            const struct foxglove_key_value *metadata,
+                                            size_t metadata_len);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a Point2 message to a channel.
+ * Write an attachment to an MCAP file.
+ *
+ * Attachments are arbitrary binary data that can be stored alongside messages.
+ * Common uses include storing configuration files, calibration data, or other
+ * reference material related to the recording.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_point2.
+ * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
+ * `attachment` must be a valid pointer to a `FoxgloveMcapAttachment`.
+ * The `name` and `media_type` fields of the attachment must be valid UTF-8 strings.
+ * The `data` field must be a valid pointer to an array of bytes with length `data_len`,
+ * or null if `data_len` is 0.
  */
-foxglove_error foxglove_channel_log_point2(const struct foxglove_channel *channel,
-                                           const struct foxglove_point2 *msg,
-                                           const uint64_t *log_time,
-                                           FoxgloveSinkId sink_id);
+foxglove_error foxglove_mcap_attach(struct foxglove_mcap_writer *writer,
+                                    const struct foxglove_mcap_attachment *FOXGLOVE_NONNULL attachment);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the Point2 schema.
+ * Write an attachment to an MCAP file, reading its data with a callback.
  *
- * All buffers in the returned schema are statically allocated.
+ * The data is copied to the file in blocks as it is read, so large attachments never need to
+ * be held in memory. `attachment.data` must be null, and `attachment.data_len` is the number of
+ * bytes to read. Messages logged while the data is copied wait until the attachment has been
+ * written.
+ *
+ * `read` is called repeatedly with a buffer of `len` bytes, and returns the number of bytes it
+ * stored in the buffer, or 0 at the end of the data. On failure, it sets `error` to a non-zero
+ * errno value. If `read` fails or the data ends early, the rest of the attachment is filled
+ * with zeros so that the file remains valid, and an error is returned.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
+ *
+ * # Safety
+ * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
+ * `attachment` must be a valid pointer to a `FoxgloveMcapAttachment`.
+ * The `name` and `media_type` fields of the attachment must be valid UTF-8 strings.
+ * `read` is only called before this function returns, on the calling thread, with `context`.
  */
-struct foxglove_schema foxglove_point2_schema(void);
+foxglove_error foxglove_mcap_attach_stream(struct foxglove_mcap_writer *writer,
+                                           const struct foxglove_mcap_attachment *FOXGLOVE_NONNULL attachment,
+                                           size_t (*read)(void *context,
+                                                          uint8_t *buffer,
+                                                          size_t len,
+                                                          int32_t *error),
+                                           void *context);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a Point2 message as protobuf to the buffer provided.
+ * Rebuild the summary of an MCAP file whose writer was not closed, for example because the
+ * process exited while recording.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * The file is truncated after its last complete record, and a summary is appended, so it can be
+ * read without scanning. This reads only record headers, and not the contents of chunks, if the
+ * file was written with `checkpoint_interval_ms` set. Files which were closed normally are left
+ * unchanged.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `path` must be a valid UTF-8 string.
  */
-foxglove_error foxglove_point2_encode(const struct foxglove_point2 *msg,
-                                      uint8_t *ptr,
-                                      size_t len,
-                                      size_t *encoded_len);
+foxglove_error foxglove_mcap_recover(const struct foxglove_string *FOXGLOVE_NONNULL path);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Open a finished MCAP file for reading.
+ *
+ * The file is memory-mapped, so it must not be truncated while it is being read. Unfinished
+ * files must be repaired with `foxglove_mcap_recover` first.
+ *
+ * On success, writes the reader to `reader`. The reader must be freed with
+ * [`foxglove_mcap_reader_free`].
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * - `path` must be a valid pointer to a UTF-8 string.
+ * - `reader` must be a valid pointer to a `foxglove_mcap_reader*`.
  */
-foxglove_error foxglove_channel_create_point3(struct foxglove_string topic,
-                                              const struct foxglove_context *context,
-                                              const struct foxglove_channel **channel);
+foxglove_error foxglove_mcap_reader_open(const struct foxglove_string *FOXGLOVE_NONNULL path,
+                                         struct foxglove_mcap_reader **reader);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a Point3 message to a channel.
+ * Free a reader created with [`foxglove_mcap_reader_open`].
+ *
+ * Message iterators created from the reader remain valid.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_point3.
+ * `reader` must be a pointer returned by [`foxglove_mcap_reader_open`], or null.
  */
-foxglove_error foxglove_channel_log_point3(const struct foxglove_channel *channel,
-                                           const struct foxglove_point3 *msg,
-                                           const uint64_t *log_time,
-                                           FoxgloveSinkId sink_id);
+void foxglove_mcap_reader_free(struct foxglove_mcap_reader *reader);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the Point3 schema.
+ * Get the channels of an MCAP file, in order of id.
  *
- * All buffers in the returned schema are statically allocated.
+ * Writes the number of channels to `count`, and returns a pointer to the first, which is valid
+ * until the reader is freed.
+ *
+ * # Safety
+ * - `reader` must be a valid pointer to a reader created with [`foxglove_mcap_reader_open`].
+ * - `count` must be a valid pointer to a `size_t`.
  */
-struct foxglove_schema foxglove_point3_schema(void);
+const struct foxglove_mcap_reader_channel *foxglove_mcap_reader_channels(const struct foxglove_mcap_reader *reader,
+                                                                         size_t *FOXGLOVE_NONNULL count);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a Point3 message as protobuf to the buffer provided.
+ * Get the earliest and latest message log times in an MCAP file, from its chunk indexes.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Returns true and writes the times to `start_time` and `end_time` if they are known. Returns
+ * false if the file has no chunk indexes or no messages.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * - `reader` must be a valid pointer to a reader created with [`foxglove_mcap_reader_open`].
+ * - `start_time` and `end_time` must be valid pointers to `uint64_t`.
  */
-foxglove_error foxglove_point3_encode(const struct foxglove_point3 *msg,
-                                      uint8_t *ptr,
-                                      size_t len,
-                                      size_t *encoded_len);
+bool foxglove_mcap_reader_time_range(const struct foxglove_mcap_reader *reader,
+                                     uint64_t *FOXGLOVE_NONNULL start_time,
+                                     uint64_t *FOXGLOVE_NONNULL end_time);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Create an iterator over the messages of an MCAP file which match the options.
+ *
+ * On success, writes the iterator to `iter`. The iterator must be freed with
+ * [`foxglove_mcap_message_iter_free`].
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * - `reader` must be a valid pointer to a reader created with [`foxglove_mcap_reader_open`].
+ * - `options` must be a valid pointer to a `foxglove_mcap_read_options`, or null to use the
+ *   default options.
+ * - If `options->topics` is not null, it must point to `options->topics_count` valid UTF-8
+ *   strings.
+ * - `iter` must be a valid pointer to a `foxglove_mcap_message_iterator*`.
  */
-foxglove_error foxglove_channel_create_point3_in_frame(struct foxglove_string topic,
-                                                       const struct foxglove_context *context,
-                                                       const struct foxglove_channel **channel);
+foxglove_error foxglove_mcap_reader_messages(const struct foxglove_mcap_reader *reader,
+                                             const struct foxglove_mcap_read_options *options,
+                                             struct foxglove_mcap_message_iterator **iter);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a Point3InFrame message to a channel.
+ * Create an iterator over the latest message logged before `time` on each channel of an MCAP
+ * file, in order of log time.
+ *
+ * Only the `topics` option is used. Chunks are read from the latest to the earliest, and the
+ * chunk indexes are used to skip chunks which cannot hold a later message on a channel still
+ * missing one. The messages are read before this function returns.
+ *
+ * On success, writes the iterator to `iter`. The iterator must be freed with
+ * [`foxglove_mcap_message_iter_free`].
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_point3_in_frame.
+ * - `reader` must be a valid pointer to a reader created with [`foxglove_mcap_reader_open`].
+ * - `options` must be a valid pointer to a `foxglove_mcap_read_options`, or null to use the
+ *   default options.
+ * - If `options->topics` is not null, it must point to `options->topics_count` valid UTF-8
+ *   strings.
+ * - `iter` must be a valid pointer to a `foxglove_mcap_message_iterator*`.
  */
-foxglove_error foxglove_channel_log_point3_in_frame(const struct foxglove_channel *channel,
-                                                    const struct foxglove_point3_in_frame *msg,
-                                                    const uint64_t *log_time,
-                                                    FoxgloveSinkId sink_id);
+foxglove_error foxglove_mcap_reader_latest_messages(const struct foxglove_mcap_reader *reader,
+                                                    uint64_t time,
+                                                    const struct foxglove_mcap_read_options *options,
+                                                    struct foxglove_mcap_message_iterator **iter);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the Point3InFrame schema.
+ * Create an iterator over the messages of several MCAP files which match the options, merged
+ * in order of log time.
  *
- * All buffers in the returned schema are statically allocated.
+ * The `order` option is ignored. Each file's chunks are read as the merge reaches them, so only
+ * the chunks which overlap the current log time are held in memory. Messages with the same log
+ * time are returned in the order of their readers, and each message's `reader_index` is the
+ * index of its reader in `readers`.
+ *
+ * On success, writes the iterator to `iter`. The iterator must be freed with
+ * [`foxglove_mcap_message_iter_free`].
+ *
+ * # Safety
+ * - `readers` must point to `readers_count` valid pointers to readers created with
+ *   [`foxglove_mcap_reader_open`].
+ * - `options` must be a valid pointer to a `foxglove_mcap_read_options`, or null to use the
+ *   default options.
+ * - If `options->topics` is not null, it must point to `options->topics_count` valid UTF-8
+ *   strings.
+ * - `iter` must be a valid pointer to a `foxglove_mcap_message_iterator*`.
  */
-struct foxglove_schema foxglove_point3_in_frame_schema(void);
+foxglove_error foxglove_mcap_reader_merge(const struct foxglove_mcap_reader *const *readers,
+                                          size_t readers_count,
+                                          const struct foxglove_mcap_read_options *options,
+                                          struct foxglove_mcap_message_iterator **iter);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a Point3InFrame message as protobuf to the buffer provided.
+ * Read the next message from an iterator.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Writes true to `has_message` and the message to `message` if there is a next message, or
+ * false to `has_message` once all messages have been read. If an error is returned, the
+ * iterator is exhausted.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * - `iter` must be a valid pointer to an iterator created with
+ *   [`foxglove_mcap_reader_messages`] or [`foxglove_mcap_reader_merge`].
+ * - `message` must be a valid pointer to a `foxglove_mcap_message`.
+ * - `has_message` must be a valid pointer to a `bool`.
  */
-foxglove_error foxglove_point3_in_frame_encode(const struct foxglove_point3_in_frame *msg,
-                                               uint8_t *ptr,
-                                               size_t len,
-                                               size_t *encoded_len);
+foxglove_error foxglove_mcap_message_iter_next(struct foxglove_mcap_message_iterator *iter,
+                                               struct foxglove_mcap_message *FOXGLOVE_NONNULL message,
+                                               bool *FOXGLOVE_NONNULL has_message);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Free an iterator created with [`foxglove_mcap_reader_messages`] or
+ * [`foxglove_mcap_reader_merge`].
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `iter` must be a pointer returned by [`foxglove_mcap_reader_messages`] or
+ * [`foxglove_mcap_reader_merge`], or null.
  */
-foxglove_error foxglove_channel_create_point_cloud(struct foxglove_string topic,
-                                                   const struct foxglove_context *context,
-                                                   const struct foxglove_channel **channel);
+void foxglove_mcap_message_iter_free(struct foxglove_mcap_message_iterator *iter);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a PointCloud message to a channel.
+ * Replaces the message passed to a `message_filter` callback, for example with a cropped or
+ * downsampled copy of it.
+ *
+ * The callback must return true for the replacement to be logged. The replacement is logged to
+ * every sink which shares the filter, without calling the filter again.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_point_cloud.
+ * - `output` must be the pointer passed to a `message_filter` callback, and this function must be
+ *   called from the context of that callback.
+ * - `data` must be a pointer to the replacement message. This value is copied by this function.
  */
-foxglove_error foxglove_channel_log_point_cloud(const struct foxglove_channel *channel,
-                                                const struct foxglove_point_cloud *msg,
-                                                const uint64_t *log_time,
-                                                FoxgloveSinkId sink_id);
+foxglove_error foxglove_message_filter_output_replace(struct foxglove_message_filter_output *output,
+                                                      struct foxglove_bytes data);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the PointCloud schema.
+ * Create a new channel. The channel must later be freed with `foxglove_channel_free`.
  *
- * All buffers in the returned schema are statically allocated.
+ * Returns 0 on success, or returns a FoxgloveError code on error.
+ *
+ * # Safety
+ * `topic` and `message_encoding` must contain valid UTF8.
+ * `schema` is an optional pointer to a schema. The schema and the data it points to
+ * need only remain alive for the duration of this function call (they will be copied).
+ * `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+ * `metadata` can be null, or a valid pointer to a collection of key/value pairs. If keys are
+ *     duplicated in the collection, the last value for each key will be used.
+ * `channel` is an out **FoxgloveChannel pointer, which will be set to the created channel
+ * if the function returns success.
  */
-struct foxglove_schema foxglove_point_cloud_schema(void);
+foxglove_error foxglove_raw_channel_create(struct foxglove_string topic,
+                                           struct foxglove_string message_encoding,
+                                           const struct foxglove_schema *schema,
+                                           const struct foxglove_context *context,
+                                           const struct foxglove_channel_metadata *metadata,
+                                           const struct foxglove_channel **channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a PointCloud message as protobuf to the buffer provided.
+ * Create a batch of channels.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * The channels are registered atomically, and each sink is notified of them together; for
+ * example, a WebSocket server advertises them to each client in a single message. This is
+ * preferable to calling `foxglove_raw_channel_create` for each channel when creating many
+ * channels at once. Each created channel must later be freed with `foxglove_channel_free`.
+ *
+ * If any spec is invalid, no channels are created.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `specs` must be a valid pointer to an array of `count` specs, each of which meets the
+ * requirements of the corresponding arguments to `foxglove_raw_channel_create`. The specs and
+ * the data they point to need only remain alive for the duration of this function call.
+ * `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+ * `channels` must be a valid pointer to an array of `count` channel pointers, which will be set
+ * to the created channels, in order, if the function returns success.
  */
-foxglove_error foxglove_point_cloud_encode(const struct foxglove_point_cloud *msg,
-                                           uint8_t *ptr,
-                                           size_t len,
-                                           size_t *encoded_len);
+foxglove_error foxglove_raw_channels_create(const struct foxglove_channel_spec *specs,
+                                            size_t count,
+                                            const struct foxglove_context *context,
+                                            const struct foxglove_channel **channels);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Close a channel.
+ *
+ * You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
+ * dynamically, such as the WebSocketServer.
+ *
+ * Attempts to log on a closed channel will elicit a throttled warning message.
+ *
+ * Note this *does not* free the channel.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ * If channel is null, this does nothing.
  */
-foxglove_error foxglove_channel_create_points_annotation(struct foxglove_string topic,
-                                                         const struct foxglove_context *context,
-                                                         const struct foxglove_channel **channel);
+void foxglove_channel_close(const struct foxglove_channel *channel);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a PointsAnnotation message to a channel.
+ * Free a channel created via `foxglove_channel_create`.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_points_annotation.
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ * If channel is null, this does nothing.
  */
-foxglove_error foxglove_channel_log_points_annotation(const struct foxglove_channel *channel,
-                                                      const struct foxglove_points_annotation *msg,
-                                                      const uint64_t *log_time,
-                                                      FoxgloveSinkId sink_id);
+void foxglove_channel_free(const struct foxglove_channel *channel);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the PointsAnnotation schema.
+ * Get the ID of a channel.
  *
- * All buffers in the returned schema are statically allocated.
+ * # Safety
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ *
+ * If the passed channel is null, an invalid ID of 0 is returned.
  */
-struct foxglove_schema foxglove_points_annotation_schema(void);
+uint64_t foxglove_channel_get_id(const struct foxglove_channel *channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a PointsAnnotation message as protobuf to the buffer provided.
- *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Get the topic of a channel.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ *
+ * If the passed channel is null, an empty value is returned.
+ *
+ * The returned value is valid only for the lifetime of the channel.
  */
-foxglove_error foxglove_points_annotation_encode(const struct foxglove_points_annotation *msg,
-                                                 uint8_t *ptr,
-                                                 size_t len,
-                                                 size_t *encoded_len);
+struct foxglove_string foxglove_channel_get_topic(const struct foxglove_channel *channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Get the message_encoding of a channel.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ *
+ * If the passed channel is null, an empty value is returned.
+ *
+ * The returned value is valid only for the lifetime of the channel.
  */
-foxglove_error foxglove_channel_create_pose(struct foxglove_string topic,
-                                            const struct foxglove_context *context,
-                                            const struct foxglove_channel **channel);
+struct foxglove_string foxglove_channel_get_message_encoding(const struct foxglove_channel *channel);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a Pose message to a channel.
+ * Get the schema of a channel.
+ *
+ * If the passed channel is null or has no schema, returns `FoxgloveError::ValueError`.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_pose.
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ * `schema` must be a valid pointer to a `FoxgloveSchema` struct that will be filled in.
+ *
+ * The returned value is valid only for the lifetime of the channel.
  */
-foxglove_error foxglove_channel_log_pose(const struct foxglove_channel *channel,
-                                         const struct foxglove_pose *msg,
-                                         const uint64_t *log_time,
-                                         FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_get_schema(const struct foxglove_channel *channel,
+                                           struct foxglove_schema *schema);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the Pose schema.
+ * Find out if any sinks have been added to a channel.
  *
- * All buffers in the returned schema are statically allocated.
+ * # Safety
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ *
+ * If the passed channel is null, false is returned.
  */
-struct foxglove_schema foxglove_pose_schema(void);
+bool foxglove_channel_has_sinks(const struct foxglove_channel *channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a Pose message as protobuf to the buffer provided.
+ * Find out if a message logged on a channel now would be delivered to at least one sink.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * This is the same as `foxglove_channel_has_sinks`, except that it also issues the throttled
+ * warning that logging would if the channel has been closed. Use it to skip building and encoding
+ * messages that no sink would receive.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ *
+ * If the passed channel is null, true is returned, so that the subsequent log call reports the
+ * error.
  */
-foxglove_error foxglove_pose_encode(const struct foxglove_pose *msg,
-                                    uint8_t *ptr,
-                                    size_t len,
-                                    size_t *encoded_len);
+bool foxglove_channel_should_log(const struct foxglove_channel *channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Get the demand for a channel's messages, combined across its sinks.
+ *
+ * Producers of expensive messages can use this to scale their work to what is consumed, for
+ * example by producing messages no faster than `max_rate`. Demand changes as sinks subscribe and
+ * unsubscribe, so query it when deciding what to produce.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ *
+ * If the passed channel is null, no demand is returned.
  */
-foxglove_error foxglove_channel_create_pose_in_frame(struct foxglove_string topic,
-                                                     const struct foxglove_context *context,
-                                                     const struct foxglove_channel **channel);
+struct foxglove_channel_demand foxglove_channel_get_demand(const struct foxglove_channel *channel);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a PoseInFrame message to a channel.
+ * Bind a channel to another context, so that the sinks of that context also receive the
+ * channel's messages.
+ *
+ * Each message is encoded and logged once, and dispatched to the sinks of every bound context.
+ * The channel still belongs to the context it was created in: closing the channel, or freeing
+ * that context, removes it from every bound context, while freeing a bound context only unbinds
+ * it. Binding a channel to its own context, or to a context it is already bound to, has no
+ * effect.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error, such as if the channel is
+ * closed or `context` already has a substantially identical channel.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_pose_in_frame.
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ * `context` must be a valid pointer to a context created via `foxglove_context_new`.
  */
-foxglove_error foxglove_channel_log_pose_in_frame(const struct foxglove_channel *channel,
-                                                  const struct foxglove_pose_in_frame *msg,
-                                                  const uint64_t *log_time,
-                                                  FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_bind_context(const struct foxglove_channel *channel,
+                                             const struct foxglove_context *context);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the PoseInFrame schema.
+ * Create an iterator over a channel's metadata.
  *
- * All buffers in the returned schema are statically allocated.
+ * You must later free the iterator using foxglove_channel_metadata_iter_free.
+ *
+ * Iterate items using foxglove_channel_metadata_iter_next.
+ *
+ * # Safety
+ * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ * The channel must remain valid for the lifetime of the iterator.
  */
-struct foxglove_schema foxglove_pose_in_frame_schema(void);
+struct foxglove_channel_metadata_iterator *foxglove_channel_metadata_iter_create(const struct foxglove_channel *channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a PoseInFrame message as protobuf to the buffer provided.
+ * Get the next key-value pair from the metadata iterator.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Returns true if a pair was found and stored in `key_value`, false if the iterator is exhausted.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `iter` must be a valid pointer to a `FoxgloveChannelMetadataIterator` created via
+ * `foxglove_channel_metadata_iter_create`.
+ * `key_value` must be a valid pointer to a `FoxgloveKeyValue` that will be filled in.
+ * The channel itself must still be valid.
  */
-foxglove_error foxglove_pose_in_frame_encode(const struct foxglove_pose_in_frame *msg,
-                                             uint8_t *ptr,
-                                             size_t len,
-                                             size_t *encoded_len);
+bool foxglove_channel_metadata_iter_next(struct foxglove_channel_metadata_iterator *iter,
+                                         struct foxglove_key_value *key_value);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Free a metadata iterator created via `foxglove_channel_metadata_iter_create`.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `iter` must be a valid pointer to a `FoxgloveChannelMetadataIterator` created via
+ * `foxglove_channel_metadata_iter_create`.
  */
-foxglove_error foxglove_channel_create_poses_in_frame(struct foxglove_string topic,
-                                                      const struct foxglove_context *context,
-                                                      const struct foxglove_channel **channel);
+void foxglove_channel_metadata_iter_free(struct foxglove_channel_metadata_iterator *iter);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a PosesInFrame message to a channel.
+ * Log a message on a channel.
+ *
+ * Zero-length messages are supported: pass `data_len == 0` with either a null `data` pointer
+ * or any non-null pointer. The contents of `data` are not read when `data_len == 0`.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_poses_in_frame.
+ * If `data_len > 0`, `data` must be non-null and the range `[data, data + data_len)` must
+ * contain initialized data contained within a single allocated object.
+ *
+ * `log_time` Some(nanoseconds since epoch timestamp) or None to use the current time.
  */
-foxglove_error foxglove_channel_log_poses_in_frame(const struct foxglove_channel *channel,
-                                                   const struct foxglove_poses_in_frame *msg,
-                                                   const uint64_t *log_time,
-                                                   FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_log(const struct foxglove_channel *channel,
+                                    const uint8_t *data,
+                                    size_t data_len,
+                                    const uint64_t *log_time,
+                                    FoxgloveSinkId sink_id);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the PosesInFrame schema.
+ * Log a message held in a buffer owned by the caller, without copying it.
  *
- * All buffers in the returned schema are statically allocated.
+ * Sinks that queue messages, such as the remote access gateway's video tracks and MCAP writers
+ * with async writes, may keep a reference to the buffer after this call returns rather than
+ * copying it. Once every sink has released the buffer, `release` is called exactly once with
+ * `release_context`, possibly from another thread. If the message is not logged to any sink,
+ * `release` is called before this function returns.
+ *
+ * If an error is returned, `release` is not called and the caller retains ownership of the buffer.
+ *
+ * # Safety
+ * If `data_len > 0`, `data` must be non-null and the range `[data, data + data_len)` must contain
+ * initialized data contained within a single allocated object, which must not be modified or
+ * freed until `release` is called. `release` and `release_context` must be safe to use from any
+ * thread. `log_time` may be null, or must be a valid pointer to a `uint64_t`.
  */
-struct foxglove_schema foxglove_poses_in_frame_schema(void);
+foxglove_error foxglove_channel_log_shared(const struct foxglove_channel *channel,
+                                           const uint8_t *data,
+                                           size_t data_len,
+                                           void *release_context,
+                                           void (*release)(void *release_context),
+                                           const uint64_t *log_time,
+                                           FoxgloveSinkId sink_id);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a PosesInFrame message as protobuf to the buffer provided.
+ * Log a batch of messages on a channel.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * All messages are handed to each subscribed sink in a single call, which avoids per-message
+ * overhead when logging many small messages. Items without a log time share a single reading
+ * of the current time.
+ *
+ * If any item is invalid, no messages are logged and an error is returned.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * If `count > 0`, `items` must point to `count` valid `FoxgloveLogItem`s. For each item with
+ * `data_len > 0`, `data` must be non-null and the range `[data, data + data_len)` must contain
+ * initialized data contained within a single allocated object. Each non-null `log_time` must
+ * point to a valid `uint64_t`.
  */
-foxglove_error foxglove_poses_in_frame_encode(const struct foxglove_poses_in_frame *msg,
-                                              uint8_t *ptr,
-                                              size_t len,
-                                              size_t *encoded_len);
+foxglove_error foxglove_channel_log_batch(const struct foxglove_channel *channel,
+                                          const struct foxglove_log_item *items,
+                                          size_t count,
+                                          FoxgloveSinkId sink_id);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
- *
- * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * Create a new context. This never fails.
+ * You must pass this to `foxglove_context_free` when done with it.
  */
-foxglove_error foxglove_channel_create_quaternion(struct foxglove_string topic,
-                                                  const struct foxglove_context *context,
-                                                  const struct foxglove_channel **channel);
+const struct foxglove_context *foxglove_context_new(void);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a Quaternion message to a channel.
+ * Free a context created via `foxglove_context_new` or `foxglove_context_free`.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_quaternion.
+ * `context` must be a valid pointer to a context created via `foxglove_context_new`.
  */
-foxglove_error foxglove_channel_log_quaternion(const struct foxglove_channel *channel,
-                                               const struct foxglove_quaternion *msg,
-                                               const uint64_t *log_time,
-                                               FoxgloveSinkId sink_id);
+void foxglove_context_free(const struct foxglove_context *context);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the Quaternion schema.
- *
- * All buffers in the returned schema are statically allocated.
+ * Create a clock which starts at `start_ns` nanoseconds since the Unix epoch. This never fails.
+ * You must pass this to `foxglove_sim_clock_free` when done with it.
  */
-struct foxglove_schema foxglove_quaternion_schema(void);
+struct foxglove_sim_clock *foxglove_sim_clock_new(uint64_t start_ns);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a Quaternion message as protobuf to the buffer provided.
- *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Set the current time of a clock, in nanoseconds since the Unix epoch.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `clock` must be null, or a valid pointer to a clock created via `foxglove_sim_clock_new`.
  */
-foxglove_error foxglove_quaternion_encode(const struct foxglove_quaternion *msg,
-                                          uint8_t *ptr,
-                                          size_t len,
-                                          size_t *encoded_len);
+void foxglove_sim_clock_set_time(const struct foxglove_sim_clock *clock, uint64_t time_ns);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Advance the current time of a clock by `duration_ns` nanoseconds.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `clock` must be null, or a valid pointer to a clock created via `foxglove_sim_clock_new`.
  */
-foxglove_error foxglove_channel_create_raw_audio(struct foxglove_string topic,
-                                                 const struct foxglove_context *context,
-                                                 const struct foxglove_channel **channel);
+void foxglove_sim_clock_advance(const struct foxglove_sim_clock *clock, uint64_t duration_ns);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a RawAudio message to a channel.
+ * Free a clock created via `foxglove_sim_clock_new`.
+ *
+ * Contexts which use the clock keep using it.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_raw_audio.
+ * `clock` must be null, or a valid pointer to a clock created via `foxglove_sim_clock_new`.
  */
-foxglove_error foxglove_channel_log_raw_audio(const struct foxglove_channel *channel,
-                                              const struct foxglove_raw_audio *msg,
-                                              const uint64_t *log_time,
-                                              FoxgloveSinkId sink_id);
+void foxglove_sim_clock_free(struct foxglove_sim_clock *clock);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the RawAudio schema.
+ * Set the clock which provides the log time of messages logged without one.
  *
- * All buffers in the returned schema are statically allocated.
+ * If `clock` is null, the context's default clock is restored. The default clock never goes
+ * backwards, and is anchored to the system wall clock.
+ *
+ * # Safety
+ * `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+ * If it's null, the clock of the default context is set. `clock` must be null, or a valid
+ * pointer to a clock created via `foxglove_sim_clock_new`.
  */
-struct foxglove_schema foxglove_raw_audio_schema(void);
+void foxglove_context_set_sim_clock(const struct foxglove_context *context,
+                                    const struct foxglove_sim_clock *clock);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a RawAudio message as protobuf to the buffer provided.
+ * Returns the current time of a context's clock, in nanoseconds since the Unix epoch.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * This is the log time given to a message logged without one.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+ * If it's null, the clock of the default context is read.
  */
-foxglove_error foxglove_raw_audio_encode(const struct foxglove_raw_audio *msg,
-                                         uint8_t *ptr,
-                                         size_t len,
-                                         size_t *encoded_len);
+uint64_t foxglove_context_now(const struct foxglove_context *context);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Set the budget for the bytes buffered by the sinks of a context.
+ *
+ * If `budget` is null, the budget is removed. Sinks apply the budget to the messages they
+ * buffer from then on.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+ * If it's null, the budget of the default context is set. `budget` must be null, or a valid
+ * pointer to a `foxglove_memory_budget`.
  */
-foxglove_error foxglove_channel_create_raw_image(struct foxglove_string topic,
-                                                 const struct foxglove_context *context,
-                                                 const struct foxglove_channel **channel);
+void foxglove_context_set_memory_budget(const struct foxglove_context *context,
+                                        const struct foxglove_memory_budget *budget);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a RawImage message to a channel.
+ * Get the bytes buffered by the sinks of a context, and the budget they're held to.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_raw_image.
+ * `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+ * If it's null, the usage of the default context is read. `usage` must be a valid pointer to a
+ * `foxglove_memory_usage`, which is overwritten.
  */
-foxglove_error foxglove_channel_log_raw_image(const struct foxglove_channel *channel,
-                                              const struct foxglove_raw_image *msg,
-                                              const uint64_t *log_time,
-                                              FoxgloveSinkId sink_id);
+foxglove_error foxglove_context_memory_usage(const struct foxglove_context *context,
+                                             struct foxglove_memory_usage *usage);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the RawImage schema.
+ * Get the ID of a channel descriptor.
  *
- * All buffers in the returned schema are statically allocated.
+ * # Safety
+ * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ *
+ * If the passed channel is null, 0 is returned.
  */
-struct foxglove_schema foxglove_raw_image_schema(void);
+uint64_t foxglove_channel_descriptor_get_id(const struct foxglove_channel_descriptor *channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a RawImage message as protobuf to the buffer provided.
- *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Get the topic of a channel descriptor.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ *
+ * If the passed channel is null, an empty value is returned.
+ *
+ * The returned value is valid only for the lifetime of the channel, which is typically the
+ * duration of a callback where a descriptor is passed.
  */
-foxglove_error foxglove_raw_image_encode(const struct foxglove_raw_image *msg,
-                                         uint8_t *ptr,
-                                         size_t len,
-                                         size_t *encoded_len);
+struct foxglove_string foxglove_channel_descriptor_get_topic(const struct foxglove_channel_descriptor *channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Get the message_encoding of a channel descriptor.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ *
+ * If the passed channel is null, an empty value is returned.
+ *
+ * The returned value is valid only for the lifetime of the channel, which is typically the
+ * duration of a callback where a descriptor is passed.
  */
-foxglove_error foxglove_channel_create_sphere_primitive(struct foxglove_string topic,
-                                                        const struct foxglove_context *context,
-                                                        const struct foxglove_channel **channel);
+struct foxglove_string foxglove_channel_descriptor_get_message_encoding(const struct foxglove_channel_descriptor *channel);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a SpherePrimitive message to a channel.
+ * Get the schema of a channel.
+ *
+ * If the passed channel is null or has no schema, returns `FoxgloveError::ValueError`.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_sphere_primitive.
+ * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ * `schema` must be a valid pointer to a `FoxgloveSchema` struct that will be filled in.
+ *
+ * The returned value is valid only for the lifetime of the channel, which is typically the
+ * duration of a callback where a descriptor is passed.
  */
-foxglove_error foxglove_channel_log_sphere_primitive(const struct foxglove_channel *channel,
-                                                     const struct foxglove_sphere_primitive *msg,
-                                                     const uint64_t *log_time,
-                                                     FoxgloveSinkId sink_id);
+foxglove_error foxglove_channel_descriptor_get_schema(const struct foxglove_channel_descriptor *channel,
+                                                      struct foxglove_schema *schema);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the SpherePrimitive schema.
+ * Create an iterator over a channel descriptor's metadata.
  *
- * All buffers in the returned schema are statically allocated.
+ * You must later free the iterator using foxglove_channel_descriptor_metadata_iter_free.
+ *
+ * Iterate items using foxglove_channel_descriptor_metadata_iter_next.
+ *
+ * # Safety
+ * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ * The channel descriptor must remain valid for the lifetime of the iterator.
  */
-struct foxglove_schema foxglove_sphere_primitive_schema(void);
+struct foxglove_channel_descriptor_metadata_iterator *foxglove_channel_descriptor_metadata_iter_create(const struct foxglove_channel_descriptor *channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a SpherePrimitive message as protobuf to the buffer provided.
+ * Get the next key-value pair from the metadata iterator.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Returns true if a pair was found and stored in `key_value`, false if the iterator is exhausted.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `iter` must be a valid pointer to a `foxglove_channel_descriptor_metadata_iterator` created via
+ * `foxglove_channel_descriptor_metadata_iter_create`.
+ * `key_value` must be a valid pointer to a `FoxgloveKeyValue` that will be filled in.
+ * The channel descriptor itself must still be valid.
  */
-foxglove_error foxglove_sphere_primitive_encode(const struct foxglove_sphere_primitive *msg,
-                                                uint8_t *ptr,
-                                                size_t len,
-                                                size_t *encoded_len);
+bool foxglove_channel_descriptor_metadata_iter_next(struct foxglove_channel_descriptor_metadata_iterator *iter,
+                                                    struct foxglove_key_value *key_value);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Free a metadata iterator created via `foxglove_channel_descriptor_metadata_iter_create`.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `iter` must be a valid pointer to a `foxglove_channel_descriptor_metadata_iterator` created via
+ * `foxglove_channel_descriptor_metadata_iter_create`.
  */
-foxglove_error foxglove_channel_create_text_annotation(struct foxglove_string topic,
-                                                       const struct foxglove_context *context,
-                                                       const struct foxglove_channel **channel);
+void foxglove_channel_descriptor_metadata_iter_free(struct foxglove_channel_descriptor_metadata_iterator *iter);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a TextAnnotation message to a channel.
+ * Get the metadata entry which follows `prev_key`, in key order, without allocating.
+ *
+ * If `prev_key.data` is null, the first entry is returned. Returns true if an entry was found
+ * and stored in `key_value`, false if there are no more entries.
+ *
+ * Unlike the metadata iterator, this does not allocate, and each step is O(log n).
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_text_annotation.
+ * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ * `prev_key`, if `data` is non-null, must be a valid UTF-8 string.
+ * `key_value` must be a valid pointer to a `FoxgloveKeyValue` that will be filled in.
+ *
+ * The returned value is valid only for the lifetime of the channel, which is typically the
+ * duration of a callback where a descriptor is passed.
  */
-foxglove_error foxglove_channel_log_text_annotation(const struct foxglove_channel *channel,
-                                                    const struct foxglove_text_annotation *msg,
-                                                    const uint64_t *log_time,
-                                                    FoxgloveSinkId sink_id);
+bool foxglove_channel_descriptor_metadata_next(const struct foxglove_channel_descriptor *channel,
+                                               struct foxglove_string prev_key,
+                                               struct foxglove_key_value *key_value);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the TextAnnotation schema.
+ * Look up the value of a channel descriptor's metadata key, without allocating.
  *
- * All buffers in the returned schema are statically allocated.
+ * Returns true if the key was found and its value stored in `value`, false otherwise.
+ *
+ * # Safety
+ * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ * `key` must be a valid UTF-8 string.
+ * `value` must be a valid pointer to a `FoxgloveString` that will be filled in.
+ *
+ * The returned value is valid only for the lifetime of the channel, which is typically the
+ * duration of a callback where a descriptor is passed.
  */
-struct foxglove_schema foxglove_text_annotation_schema(void);
+bool foxglove_channel_descriptor_get_metadata_value(const struct foxglove_channel_descriptor *channel,
+                                                    struct foxglove_string key,
+                                                    struct foxglove_string *value);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a TextAnnotation message as protobuf to the buffer provided.
+ * Clone a channel descriptor, so that it can be kept beyond the callback it was passed to.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * The clone shares the descriptor's data, and must be freed with
+ * `foxglove_channel_descriptor_free`.
+ *
+ * If the passed channel is null, null is returned.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
  */
-foxglove_error foxglove_text_annotation_encode(const struct foxglove_text_annotation *msg,
-                                               uint8_t *ptr,
-                                               size_t len,
-                                               size_t *encoded_len);
+struct foxglove_channel_descriptor *foxglove_channel_descriptor_clone(const struct foxglove_channel_descriptor *channel);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Free a channel descriptor created via `foxglove_channel_descriptor_clone`.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `channel` must be null, or a valid pointer to a `foxglove_channel_descriptor` created via
+ * `foxglove_channel_descriptor_clone`.
  */
-foxglove_error foxglove_channel_create_text_primitive(struct foxglove_string topic,
-                                                      const struct foxglove_context *context,
-                                                      const struct foxglove_channel **channel);
+void foxglove_channel_descriptor_free(struct foxglove_channel_descriptor *channel);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a TextPrimitive message to a channel.
+ * Create a new connection graph.
+ *
+ * The graph must later be freed with `foxglove_connection_graph_free`.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_text_primitive.
+ * `graph` must be a valid pointer to a pointer to a `foxglove_connection_graph`.
  */
-foxglove_error foxglove_channel_log_text_primitive(const struct foxglove_channel *channel,
-                                                   const struct foxglove_text_primitive *msg,
-                                                   const uint64_t *log_time,
-                                                   FoxgloveSinkId sink_id);
+foxglove_error foxglove_connection_graph_create(struct foxglove_connection_graph **graph);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the TextPrimitive schema.
+ * Free the connection graph.
  *
- * All buffers in the returned schema are statically allocated.
+ * # Safety
+ * `graph` must be a valid pointer to a `foxglove_connection_graph` created by
+ * `foxglove_connection_graph_create`.
  */
-struct foxglove_schema foxglove_text_primitive_schema(void);
+void foxglove_connection_graph_free(struct foxglove_connection_graph *graph);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a TextPrimitive message as protobuf to the buffer provided.
- *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Set a published topic and its associated publisher ids. Overwrites any existing topic with the
+ * same name.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `topic`, and each ID in `publisher_ids` must adhere to the safety rules of `foxglove_string`.
+ * `publisher_ids_count` must be the number of elements in the `publisher_ids` array.
+ *
+ * These strings are copied from the pointers, and need only be valid for the duration of this
+ * function call.
  */
-foxglove_error foxglove_text_primitive_encode(const struct foxglove_text_primitive *msg,
-                                              uint8_t *ptr,
-                                              size_t len,
-                                              size_t *encoded_len);
+foxglove_error foxglove_connection_graph_set_published_topic(struct foxglove_connection_graph *FOXGLOVE_NONNULL graph,
+                                                             struct foxglove_string topic,
+                                                             const struct foxglove_string *publisher_ids,
+                                                             size_t publisher_ids_count);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Set a subscribed topic and its associated subscriber ids. Overwrites any existing topic with the
+ * same name.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `topic`, and each ID in `subscriber_ids` must adhere to the safety rules of `foxglove_string`.
+ * `subscriber_ids_count` must be the number of elements in the `subscriber_ids` array.
  */
-foxglove_error foxglove_channel_create_triangle_list_primitive(struct foxglove_string topic,
-                                                               const struct foxglove_context *context,
-                                                               const struct foxglove_channel **channel);
+foxglove_error foxglove_connection_graph_set_subscribed_topic(struct foxglove_connection_graph *FOXGLOVE_NONNULL graph,
+                                                              struct foxglove_string topic,
+                                                              const struct foxglove_string *subscriber_ids,
+                                                              size_t subscriber_ids_count);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a TriangleListPrimitive message to a channel.
+ * Set an advertised service and its associated provider ids. Overwrites any existing service with
+ * the same name.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_triangle_list_primitive.
+ * `graph` must be a valid pointer to a `foxglove_connection_graph` created by
+ * `foxglove_connection_graph_create`. `service`, and each ID in `provider_ids` must adhere to the
+ * safety rules of `FoxgloveString`. `provider_ids_count` must be the number of elements in the
+ * `provider_ids` array.
  */
-foxglove_error foxglove_channel_log_triangle_list_primitive(const struct foxglove_channel *channel,
-                                                            const struct foxglove_triangle_list_primitive *msg,
-                                                            const uint64_t *log_time,
-                                                            FoxgloveSinkId sink_id);
+foxglove_error foxglove_connection_graph_set_advertised_service(struct foxglove_connection_graph *FOXGLOVE_NONNULL graph,
+                                                                struct foxglove_string service,
+                                                                const struct foxglove_string *provider_ids,
+                                                                size_t provider_ids_count);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the TriangleListPrimitive schema.
+ * Create a new, empty connection graph patch.
  *
- * All buffers in the returned schema are statically allocated.
- */
-struct foxglove_schema foxglove_triangle_list_primitive_schema(void);
-
-/**
- * Encode a TriangleListPrimitive message as protobuf to the buffer provided.
+ * A patch describes changes to a published connection graph, and is applied with
+ * `foxglove_server_update_connection_graph` or `foxglove_gateway_update_connection_graph`.
+ * Unlike publishing a connection graph, only the topics and services named in the patch are
+ * compared with the published graph.
  *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * The patch must later be freed with `foxglove_connection_graph_patch_free`.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `patch` must be a valid pointer to a pointer to a `foxglove_connection_graph_patch`.
  */
-foxglove_error foxglove_triangle_list_primitive_encode(const struct foxglove_triangle_list_primitive *msg,
-                                                       uint8_t *ptr,
-                                                       size_t len,
-                                                       size_t *encoded_len);
+foxglove_error foxglove_connection_graph_patch_create(struct foxglove_connection_graph_patch **patch);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Free the connection graph patch.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `patch` must be a valid pointer to a `foxglove_connection_graph_patch` created by
+ * `foxglove_connection_graph_patch_create`, or null.
  */
-foxglove_error foxglove_channel_create_vector2(struct foxglove_string topic,
-                                               const struct foxglove_context *context,
-                                               const struct foxglove_channel **channel);
+void foxglove_connection_graph_patch_free(struct foxglove_connection_graph_patch *patch);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a Vector2 message to a channel.
+ * Set a published topic and its associated publisher ids in the patch. Overwrites any existing
+ * publisher ids for the topic.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_vector2.
+ * `topic`, and each ID in `publisher_ids` must adhere to the safety rules of `foxglove_string`.
+ * `publisher_ids_count` must be the number of elements in the `publisher_ids` array.
  */
-foxglove_error foxglove_channel_log_vector2(const struct foxglove_channel *channel,
-                                            const struct foxglove_vector2 *msg,
-                                            const uint64_t *log_time,
-                                            FoxgloveSinkId sink_id);
+foxglove_error foxglove_connection_graph_patch_set_published_topic(struct foxglove_connection_graph_patch *FOXGLOVE_NONNULL patch,
+                                                                   struct foxglove_string topic,
+                                                                   const struct foxglove_string *publisher_ids,
+                                                                   size_t publisher_ids_count);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the Vector2 schema.
+ * Set a subscribed topic and its associated subscriber ids in the patch. Overwrites any existing
+ * subscriber ids for the topic.
  *
- * All buffers in the returned schema are statically allocated.
+ * # Safety
+ * `topic`, and each ID in `subscriber_ids` must adhere to the safety rules of `foxglove_string`.
+ * `subscriber_ids_count` must be the number of elements in the `subscriber_ids` array.
  */
-struct foxglove_schema foxglove_vector2_schema(void);
+foxglove_error foxglove_connection_graph_patch_set_subscribed_topic(struct foxglove_connection_graph_patch *FOXGLOVE_NONNULL patch,
+                                                                    struct foxglove_string topic,
+                                                                    const struct foxglove_string *subscriber_ids,
+                                                                    size_t subscriber_ids_count);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a Vector2 message as protobuf to the buffer provided.
- *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Set an advertised service and its associated provider ids in the patch. Overwrites any
+ * existing provider ids for the service.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * `service`, and each ID in `provider_ids` must adhere to the safety rules of `foxglove_string`.
+ * `provider_ids_count` must be the number of elements in the `provider_ids` array.
  */
-foxglove_error foxglove_vector2_encode(const struct foxglove_vector2 *msg,
-                                       uint8_t *ptr,
-                                       size_t len,
-                                       size_t *encoded_len);
+foxglove_error foxglove_connection_graph_patch_set_advertised_service(struct foxglove_connection_graph_patch *FOXGLOVE_NONNULL patch,
+                                                                      struct foxglove_string service,
+                                                                      const struct foxglove_string *provider_ids,
+                                                                      size_t provider_ids_count);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Create a new typed channel, and return an owned raw channel pointer to it.
+ * Remove a topic, along with its publishers and subscribers, in the patch.
  *
  * # Safety
- * We're trusting the caller that the channel will only be used with this type T.
+ * `topic` must adhere to the safety rules of `foxglove_string`.
  */
-foxglove_error foxglove_channel_create_vector3(struct foxglove_string topic,
-                                               const struct foxglove_context *context,
-                                               const struct foxglove_channel **channel);
+foxglove_error foxglove_connection_graph_patch_remove_topic(struct foxglove_connection_graph_patch *FOXGLOVE_NONNULL patch,
+                                                            struct foxglove_string topic);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Log a Vector3 message to a channel.
+ * Remove a service, along with its providers, in the patch.
  *
  * # Safety
- * The channel must have been created for this type with foxglove_channel_create_vector3.
+ * `service` must adhere to the safety rules of `foxglove_string`.
  */
-foxglove_error foxglove_channel_log_vector3(const struct foxglove_channel *channel,
-                                            const struct foxglove_vector3 *msg,
-                                            const uint64_t *log_time,
-                                            FoxgloveSinkId sink_id);
+foxglove_error foxglove_connection_graph_patch_remove_service(struct foxglove_connection_graph_patch *FOXGLOVE_NONNULL patch,
+                                                              struct foxglove_string service);
 #endif
 
+#if !defined(__wasm__)
 /**
- * Get the Vector3 schema.
+ * Appends a chunk of asset data to a fetch asset response, without completing the request.
  *
- * All buffers in the returned schema are statically allocated.
+ * This allows an asset to be read and passed to the SDK piece by piece. The protocol delivers
+ * each asset to the client in a single message, so the chunks are assembled by the SDK, and sent
+ * when the request is completed with `foxglove_fetch_asset_respond_finish` or
+ * `foxglove_fetch_asset_respond_ok`. `foxglove_fetch_asset_respond_error` discards them.
+ *
+ * # Safety
+ * - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via a
+ *   `fetch_asset` callback, which has not yet been completed.
+ * - `data` must be a pointer to the chunk. This value is copied by this function.
  */
-struct foxglove_schema foxglove_vector3_schema(void);
+foxglove_error foxglove_fetch_asset_append(struct foxglove_fetch_asset_responder *responder,
+                                           struct foxglove_bytes data);
+#endif
 
+#if !defined(__wasm__)
 /**
- * Encode a Vector3 message as protobuf to the buffer provided.
- *
- * On success, writes the encoded length to *encoded_len.
- * If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len and
- * returns FOXGLOVE_ERROR_BUFFER_TOO_SHORT.
- * If the message cannot be encoded, logs the reason to stderr and returns FOXGLOVE_ERROR_ENCODE.
+ * Completes a fetch asset request by sending the chunks appended with
+ * `foxglove_fetch_asset_append` to the client.
  *
  * # Safety
- * ptr must be a valid pointer to a memory region at least len bytes long.
+ * - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via a
+ *   `fetch_asset` callback. This value is moved into this function, and must not be accessed
+ *   afterwards.
  */
-foxglove_error foxglove_vector3_encode(const struct foxglove_vector3 *msg,
-                                       uint8_t *ptr,
-                                       size_t len,
-                                       size_t *encoded_len);
+void foxglove_fetch_asset_respond_finish(struct foxglove_fetch_asset_responder *responder);
+#endif
 
 #if !defined(__wasm__)
 /**
- * Returns a `FoxgloveMcapOptions` with defaults matching `mcap::WriteOptions::default()`.
+ * Completes a fetch asset request by sending asset data to the client.
  *
- * The test `test_mcap_options_default_matches_write_options` verifies these stay in sync.
+ * If chunks were appended with `foxglove_fetch_asset_append`, `data` is sent after them.
+ *
+ * # Safety
+ * - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via a
+ *   `fetch_asset` callback. This value is moved into this function, and must not be accessed
+ *   afterwards.
+ * - `data` must be a pointer to the response data. This value is copied by this function.
  */
-struct foxglove_mcap_options foxglove_mcap_options_default(void);
+void foxglove_fetch_asset_respond_ok(struct foxglove_fetch_asset_responder *responder,
+                                     struct foxglove_bytes data);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Create or open an MCAP writer for writing to a file or custom destination.
- * Resources must later be freed with `foxglove_mcap_close`.
- *
- * If `custom_writer` is provided, the MCAP data will be written using the provided
- * function pointers instead of to a file.
- *
- * Returns 0 on success, or returns a FoxgloveError code on error.
+ * Completes a request by sending an error message to the client.
  *
  * # Safety
- * `path` and `profile` must contain valid UTF8. If `context` is non-null,
- * it must have been created by `foxglove_context_new`.
- * If `custom_writer` is non-null, its function pointers must be valid and
- * all `context` pointers must remain valid for the lifetime of the writer.
+ * - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via the
+ *   `foxglove_server_options.fetch_asset` callback. This value is moved into this
+ *   function, and must not accessed afterwards.
+ * - `message` must be a valid UTF-8 string. This value is copied by this function.
  */
-foxglove_error foxglove_mcap_open(const struct foxglove_mcap_options *FOXGLOVE_NONNULL options,
-                                  struct foxglove_mcap_writer **writer);
+void foxglove_fetch_asset_respond_error(struct foxglove_fetch_asset_responder *responder,
+                                        struct foxglove_string message);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Close an MCAP file writer created via `foxglove_mcap_open`.
+ * Creates a fetch asset handler which serves files from a set of allowed directories.
  *
- * Returns 0 on success, or returns a FoxgloveError code on error.
+ * A URI is resolved by replacing the longest matching `uri_prefix` with its `directory`.
+ * Requests for URIs which match no root, or which resolve to a path outside of the root's
+ * directory, fail. Files larger than 256 MiB are not served. Each file is read into memory, and
+ * concurrent requests for the same unchanged file share a single copy.
+ *
+ * The handler is used by passing each request to `foxglove_file_asset_handler_fetch` from a
+ * `fetch_asset` callback. It must be freed with `foxglove_file_asset_handler_free`.
  *
  * # Safety
- * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
+ * - `roots` must be a valid pointer to an array of `roots_count` roots, or NULL if
+ *   `roots_count` is zero. The strings must be valid UTF-8, and are copied by this function.
+ * - `handler` must be a valid pointer.
  */
-foxglove_error foxglove_mcap_close(struct foxglove_mcap_writer *writer);
+foxglove_error foxglove_file_asset_handler_create(const struct foxglove_file_asset_root *roots,
+                                                  size_t roots_count,
+                                                  struct foxglove_file_asset_handler **handler);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Finishes the current chunk (if any) and flushes the underlying writer.
- *
- * Note that compression ratios tend to improve over the lifetime of a chunk, so flushing
- * frequently with chunked output may reduce overall compression.
+ * Completes a fetch asset request by serving the requested file.
  *
- * Returns 0 on success, or returns a FoxgloveError code on error.
+ * The file is resolved and read on a background thread, so this function may be called from
+ * a `fetch_asset` callback without blocking.
  *
  * # Safety
- * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
+ * - `handler` must be a valid pointer to a handler created by
+ *   `foxglove_file_asset_handler_create`.
+ * - `uri` must be a valid UTF-8 string. This value is copied by this function.
+ * - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via a
+ *   `fetch_asset` callback, to which no chunks have been appended. This value is moved into this
+ *   function, and must not be accessed afterwards.
  */
-foxglove_error foxglove_mcap_flush(struct foxglove_mcap_writer *writer);
+void foxglove_file_asset_handler_fetch(const struct foxglove_file_asset_handler *handler,
+                                       struct foxglove_string uri,
+                                       struct foxglove_fetch_asset_responder *responder);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Write metadata to an MCAP file.
- *
- * Metadata consists of key-value string pairs associated with a name.
- * If the metadata has no key-value pairs, this method does nothing.
- *
- * Returns 0 on success, or returns a FoxgloveError code on error.
+ * Frees a file asset handler.
  *
  * # Safety
- * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
- * `name` must be a valid UTF-8 string.
- * `metadata` must be a valid pointer to an array of `foxglove_key_value` with length `metadata_len`.
+ * - `handler` must be NULL, or a valid pointer to a handler created by
+ *   `foxglove_file_asset_handler_create`, which must not be used afterwards.
  */
-foxglove_error foxglove_mcap_write_metadata(struct foxglove_mcap_writer *writer,
-                                            const struct foxglove_string *FOXGLOVE_NONNULL name,
-                                            const struct foxglove_key_value *metadata,
-                                            size_t metadata_len);
+void foxglove_file_asset_handler_free(struct foxglove_file_asset_handler *handler);
 #endif
 
-#if !defined(__wasm__)
+#if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
- * Write an attachment to an MCAP file.
- *
- * Attachments are arbitrary binary data that can be stored alongside messages.
- * Common uses include storing configuration files, calibration data, or other
- * reference material related to the recording.
+ * Start a remote access gateway with the given options.
  *
- * Returns 0 on success, or returns a FoxgloveError code on error.
+ * On success, the `gateway` output parameter will be set to a valid pointer.
+ * On failure, an error code is returned.
  *
  * # Safety
- * `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
- * `attachment` must be a valid pointer to a `FoxgloveMcapAttachment`.
- * The `name` and `media_type` fields of the attachment must be valid UTF-8 strings.
- * The `data` field must be a valid pointer to an array of bytes with length `data_len`,
- * or null if `data_len` is 0.
+ * - `options` must be a valid pointer to a `FoxgloveGatewayOptions` struct with all fields
+ *   satisfying the documented safety requirements.
+ * - If `server_info` is supplied in options, all `server_info` must contain valid UTF8, and
+ *   `server_info` must have length equal to `server_info_count`.
+ * - `gateway` must be a valid pointer to a `*mut FoxgloveGateway`.
  */
-foxglove_error foxglove_mcap_attach(struct foxglove_mcap_writer *writer,
-                                    const struct foxglove_mcap_attachment *FOXGLOVE_NONNULL attachment);
+foxglove_error foxglove_gateway_start(const struct foxglove_gateway_options *FOXGLOVE_NONNULL options,
+                                      struct foxglove_gateway **gateway);
 #endif
 
-#if !defined(__wasm__)
+#if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
- * Create a new channel. The channel must later be freed with `foxglove_channel_free`.
- *
- * Returns 0 on success, or returns a FoxgloveError code on error.
- *
- * # Safety
- * `topic` and `message_encoding` must contain valid UTF8.
- * `schema` is an optional pointer to a schema. The schema and the data it points to
- * need only remain alive for the duration of this function call (they will be copied).
- * `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
- * `metadata` can be null, or a valid pointer to a collection of key/value pairs. If keys are
- *     duplicated in the collection, the last value for each key will be used.
- * `channel` is an out **FoxgloveChannel pointer, which will be set to the created channel
- * if the function returns success.
+ * Stop and shut down the gateway and free the resources associated with it.
  */
-foxglove_error foxglove_raw_channel_create(struct foxglove_string topic,
-                                           struct foxglove_string message_encoding,
-                                           const struct foxglove_schema *schema,
-                                           const struct foxglove_context *context,
-                                           const struct foxglove_channel_metadata *metadata,
-                                           const struct foxglove_channel **channel);
+foxglove_error foxglove_gateway_stop(struct foxglove_gateway *gateway);
 #endif
 
-#if !defined(__wasm__)
+#if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
- * Close a channel.
- *
- * You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
- * dynamically, such as the WebSocketServer.
- *
- * Attempts to log on a closed channel will elicit a throttled warning message.
- *
- * Note this *does not* free the channel.
+ * Get the current connection status of the gateway.
  *
- * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
- * If channel is null, this does nothing.
+ * Returns `Shutdown` if the gateway pointer is null or the gateway has been stopped.
  */
-void foxglove_channel_close(const struct foxglove_channel *channel);
+foxglove_connection_status foxglove_gateway_connection_status(const struct foxglove_gateway *gateway);
 #endif
 
-#if !defined(__wasm__)
+#if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
- * Free a channel created via `foxglove_channel_create`.
+ * Get the sink ID of the gateway's current session.
  *
- * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
- * If channel is null, this does nothing.
+ * Returns 0 if the gateway pointer is null, the gateway has been stopped,
+ * or no session is currently active.
  */
-void foxglove_channel_free(const struct foxglove_channel *channel);
+FoxgloveSinkId foxglove_gateway_sink_id(const struct foxglove_gateway *gateway);
 #endif
 
-#if !defined(__wasm__)
+#if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
- * Get the ID of a channel.
+ * Adds a service to the gateway and advertises it to connected clients.
  *
  * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
- *
- * If the passed channel is null, an invalid ID of 0 is returned.
+ * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
+ * - `service` must be a valid pointer to a service allocated by `foxglove_service_create`. This
+ *   value is moved into this function, and must not be accessed afterwards.
  */
-uint64_t foxglove_channel_get_id(const struct foxglove_channel *channel);
+foxglove_error foxglove_gateway_add_service(const struct foxglove_gateway *gateway,
+                                            struct foxglove_service *service);
 #endif
 
-#if !defined(__wasm__)
+#if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
- * Get the topic of a channel.
+ * Removes a service from the gateway.
  *
  * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
- *
- * If the passed channel is null, an empty value is returned.
- *
- * The returned value is valid only for the lifetime of the channel.
+ * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
+ * - `service_name` must be a valid UTF-8 string.
  */
-struct foxglove_string foxglove_channel_get_topic(const struct foxglove_channel *channel);
+foxglove_error foxglove_gateway_remove_service(const struct foxglove_gateway *gateway,
+                                               struct foxglove_string service_name);
 #endif
 
-#if !defined(__wasm__)
+#if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
- * Get the message_encoding of a channel.
+ * Publish parameter values to all subscribed clients.
  *
  * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
+ * - `params` must be a valid pointer to a value allocated by `foxglove_parameter_array_create`.
+ *   This value is moved into this function, and must not be accessed afterwards.
+ */
+foxglove_error foxglove_gateway_publish_parameter_values(const struct foxglove_gateway *gateway,
+                                                         struct foxglove_parameter_array *params);
+#endif
+
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+/**
+ * Publishes a status message to all connected participants.
  *
- * If the passed channel is null, an empty value is returned.
+ * The caller may optionally provide a message ID, which can be used in a subsequent call to
+ * `foxglove_gateway_remove_status`.
  *
- * The returned value is valid only for the lifetime of the channel.
+ * # Safety
+ * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
+ * - `message` must be a valid UTF-8 string, which must remain valid for the duration of this
+ *   call.
+ * - `id` must either be NULL, or a pointer to a valid UTF-8 string, which must remain valid for
+ *   the duration of this call.
  */
-struct foxglove_string foxglove_channel_get_message_encoding(const struct foxglove_channel *channel);
+foxglove_error foxglove_gateway_publish_status(const struct foxglove_gateway *gateway,
+                                               foxglove_server_status_level level,
+                                               struct foxglove_string message,
+                                               const struct foxglove_string *id);
 #endif
 
-#if !defined(__wasm__)
+#if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
- * Get the schema of a channel.
+ * Removes status messages from all connected participants.
  *
- * If the passed channel is null or has no schema, returns `FoxgloveError::ValueError`.
+ * Previously published status messages are referenced by ID.
  *
  * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
- * `schema` must be a valid pointer to a `FoxgloveSchema` struct that will be filled in.
+ * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
+ * - `ids` must be a pointer to an array of valid UTF-8 strings, all of which must remain valid
+ *   for the duration of this call.
+ */
+foxglove_error foxglove_gateway_remove_status(const struct foxglove_gateway *gateway,
+                                              const struct foxglove_string *ids,
+                                              size_t ids_count);
+#endif
+
+#if defined(FOXGLOVE_REMOTE_ACCESS)
+/**
+ * Publish a connection graph to the gateway.
  *
- * The returned value is valid only for the lifetime of the channel.
+ * Requires `FOXGLOVE_GATEWAY_CAPABILITY_CONNECTION_GRAPH`.
  */
-foxglove_error foxglove_channel_get_schema(const struct foxglove_channel *channel,
-                                           struct foxglove_schema *schema);
+foxglove_error foxglove_gateway_publish_connection_graph(const struct foxglove_gateway *gateway,
+                                                         const struct foxglove_connection_graph *graph);
 #endif
 
-#if !defined(__wasm__)
+#if defined(FOXGLOVE_REMOTE_ACCESS)
 /**
- * Find out if any sinks have been added to a channel.
+ * Apply a connection graph patch to the connection graph published by the gateway, and send the
+ * changes to subscribed clients.
  *
- * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+ * Requires `FOXGLOVE_GATEWAY_CAPABILITY_CONNECTION_GRAPH`.
  *
- * If the passed channel is null, false is returned.
+ * The patch is consumed by this call, even if it fails, and must not be used or freed
+ * afterwards.
+ *
+ * # Safety
+ * `patch` must be a valid pointer to a `foxglove_connection_graph_patch` created by
+ * `foxglove_connection_graph_patch_create`.
  */
-bool foxglove_channel_has_sinks(const struct foxglove_channel *channel);
+foxglove_error foxglove_gateway_update_connection_graph(const struct foxglove_gateway *gateway,
+                                                        struct foxglove_connection_graph_patch *patch);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Create an iterator over a channel's metadata.
+ * Initialize SDK logging with the given severity level.
  *
- * You must later free the iterator using foxglove_channel_metadata_iter_free.
+ * The SDK logs informational messages to stderr. Any messages below the given level are not
+ * logged.
  *
- * Iterate items using foxglove_channel_metadata_iter_next.
+ * This function should be called before other Foxglove initialization to capture output from all
+ * components. Subsequent calls will have no effect.
  *
- * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
- * The channel must remain valid for the lifetime of the iterator.
+ * Log level may be overridden with the FOXGLOVE_LOG_LEVEL environment variable: "debug", "info",
+ * "warn", "error", or "off". The default level is "info".
+ *
+ * Log styles (colors) may be configured with the FOXGLOVE_LOG_STYLE environment variable "never",
+ * "always", or "auto" (default).
+ *
+ * This is thread-safe, but only the first call to this function will have an effect.
  */
-struct foxglove_channel_metadata_iterator *foxglove_channel_metadata_iter_create(const struct foxglove_channel *channel);
+void foxglove_set_log_level(foxglove_logging_level level);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Get the next key-value pair from the metadata iterator.
- *
- * Returns true if a pair was found and stored in `key_value`, false if the iterator is exhausted.
+ * Creates a new parameter array with the specified capacity.
  *
- * # Safety
- * `iter` must be a valid pointer to a `FoxgloveChannelMetadataIterator` created via
- * `foxglove_channel_metadata_iter_create`.
- * `key_value` must be a valid pointer to a `FoxgloveKeyValue` that will be filled in.
- * The channel itself must still be valid.
+ * The array must be freed with `foxglove_parameter_array_free`.
  */
-bool foxglove_channel_metadata_iter_next(struct foxglove_channel_metadata_iterator *iter,
-                                         struct foxglove_key_value *key_value);
+struct foxglove_parameter_array *foxglove_parameter_array_create(size_t capacity);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Free a metadata iterator created via `foxglove_channel_metadata_iter_create`.
+ * Pushes a parameter into the array.
  *
  * # Safety
- * `iter` must be a valid pointer to a `FoxgloveChannelMetadataIterator` created via
- * `foxglove_channel_metadata_iter_create`.
+ * - `array` must be a valid pointer to an array allocated by `foxglove_parameter_array_create`.
+ * - `param` must be a valid parameter to a value allocated by `foxglove_parameter_create` or
+ *   `foxglove_parameter_clone`. This value is moved into this function, and must not be accessed
+ *   afterwards.
  */
-void foxglove_channel_metadata_iter_free(struct foxglove_channel_metadata_iterator *iter);
+foxglove_error foxglove_parameter_array_push(struct foxglove_parameter_array *array,
+                                             struct foxglove_parameter *param);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Log a message on a channel.
- *
- * Zero-length messages are supported: pass `data_len == 0` with either a null `data` pointer
- * or any non-null pointer. The contents of `data` are not read when `data_len == 0`.
+ * Frees the parameter array and its contained parameters.
  *
  * # Safety
- * If `data_len > 0`, `data` must be non-null and the range `[data, data + data_len)` must
- * contain initialized data contained within a single allocated object.
- *
- * `log_time` Some(nanoseconds since epoch timestamp) or None to use the current time.
+ * - `array` must be a valid pointer to a value allocated by `foxglove_parameter_array_create`.
  */
-foxglove_error foxglove_channel_log(const struct foxglove_channel *channel,
-                                    const uint8_t *data,
-                                    size_t data_len,
-                                    const uint64_t *log_time,
-                                    FoxgloveSinkId sink_id);
+void foxglove_parameter_array_free(struct foxglove_parameter_array *array);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Create a new context. This never fails.
- * You must pass this to `foxglove_context_free` when done with it.
+ * Creates a new parameter array from an array of borrowed parameter descriptions.
+ *
+ * This converts a whole tree of parameters in a single call, rather than allocating each
+ * parameter and value separately. Names, keys and strings are copied, so the descriptions may be
+ * freed as soon as this function returns.
+ *
+ * On success, the array must be freed with `foxglove_parameter_array_free`. On failure, nothing
+ * is allocated.
+ *
+ * # Safety
+ * - `array` must be a valid pointer.
+ * - `params` must point to `params_count` valid descriptions, or may be NULL if `params_count`
+ *   is zero.
+ * - Each name, key and string must be a valid `foxglove_string`.
+ * - Each value pointer must be NULL or point to a valid description, whose `tag` matches the
+ *   variant of `data` which was initialized. Dictionary entry values must not be NULL.
  */
-const struct foxglove_context *foxglove_context_new(void);
+foxglove_error foxglove_parameter_array_create_from_descs(const struct foxglove_parameter_desc *params,
+                                                          size_t params_count,
+                                                          struct foxglove_parameter_array **array);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Free a context created via `foxglove_context_new` or `foxglove_context_free`.
+ * Creates a new parameter.
+ *
+ * The parameter must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
  * # Safety
- * `context` must be a valid pointer to a context created via `foxglove_context_new`.
+ * - `param` must be a valid pointer.
+ * - `name` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `value` must either be a valid pointer to a value allocated by
+ *   `foxglove_parameter_value_create`, or NULL. This value is moved into this function, and must
+ *   not be accessed afterwards.
  */
-void foxglove_context_free(const struct foxglove_context *context);
+foxglove_error foxglove_parameter_create(struct foxglove_parameter **param,
+                                         struct foxglove_string name,
+                                         foxglove_parameter_type type,
+                                         struct foxglove_parameter_value *value);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Get the ID of a channel descriptor.
+ * Creates a new empty parameter.
  *
- * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
- * If the passed channel is null, 0 is returned.
+ * # Safety
+ * - `param` must be a valid pointer.
+ * - `name` must be a valid `foxglove_string`. This value is copied by this function.
  */
-uint64_t foxglove_channel_descriptor_get_id(const struct foxglove_channel_descriptor *channel);
+foxglove_error foxglove_parameter_create_empty(struct foxglove_parameter **param,
+                                               struct foxglove_string name);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Get the topic of a channel descriptor.
- *
- * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ * Creates a new number parameter.
  *
- * If the passed channel is null, an empty value is returned.
+ * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
- * The returned value is valid only for the lifetime of the channel, which is typically the
- * duration of a callback where a descriptor is passed.
+ * # Safety
+ * - `param` must be a valid pointer.
+ * - `name` must be a valid `foxglove_string`. This value is copied by this function.
  */
-struct foxglove_string foxglove_channel_descriptor_get_topic(const struct foxglove_channel_descriptor *channel);
+foxglove_error foxglove_parameter_create_float64(struct foxglove_parameter **param,
+                                                 struct foxglove_string name,
+                                                 double value);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Get the message_encoding of a channel descriptor.
- *
- * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+ * Creates a new integer parameter.
  *
- * If the passed channel is null, an empty value is returned.
+ * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
- * The returned value is valid only for the lifetime of the channel, which is typically the
- * duration of a callback where a descriptor is passed.
+ * # Safety
+ * - `param` must be a valid pointer.
+ * - `name` must be a valid `foxglove_string`. This value is copied by this function.
  */
-struct foxglove_string foxglove_channel_descriptor_get_message_encoding(const struct foxglove_channel_descriptor *channel);
+foxglove_error foxglove_parameter_create_integer(struct foxglove_parameter **param,
+                                                 struct foxglove_string name,
+                                                 int64_t value);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Get the schema of a channel.
+ * Creates a new boolean parameter.
  *
- * If the passed channel is null or has no schema, returns `FoxgloveError::ValueError`.
+ * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
  * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
- * `schema` must be a valid pointer to a `FoxgloveSchema` struct that will be filled in.
- *
- * The returned value is valid only for the lifetime of the channel, which is typically the
- * duration of a callback where a descriptor is passed.
+ * - `param` must be a valid pointer.
+ * - `name` must be a valid `foxglove_string`. This value is copied by this function.
  */
-foxglove_error foxglove_channel_descriptor_get_schema(const struct foxglove_channel_descriptor *channel,
-                                                      struct foxglove_schema *schema);
+foxglove_error foxglove_parameter_create_boolean(struct foxglove_parameter **param,
+                                                 struct foxglove_string name,
+                                                 bool value);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Create an iterator over a channel descriptor's metadata.
- *
- * You must later free the iterator using foxglove_channel_descriptor_metadata_iter_free.
+ * Creates a new string parameter.
  *
- * Iterate items using foxglove_channel_descriptor_metadata_iter_next.
+ * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
  * # Safety
- * `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
- * The channel descriptor must remain valid for the lifetime of the iterator.
+ * - `param` must be a valid pointer.
+ * - `name` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `value` must be a valid `foxglove_string`. This value is copied by this function.
  */
-struct foxglove_channel_descriptor_metadata_iterator *foxglove_channel_descriptor_metadata_iter_create(const struct foxglove_channel_descriptor *channel);
+foxglove_error foxglove_parameter_create_string(struct foxglove_parameter **param,
+                                                struct foxglove_string name,
+                                                struct foxglove_string value);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Get the next key-value pair from the metadata iterator.
+ * Creates a new byte array parameter.
  *
- * Returns true if a pair was found and stored in `key_value`, false if the iterator is exhausted.
+ * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
  * # Safety
- * `iter` must be a valid pointer to a `foxglove_channel_descriptor_metadata_iterator` created via
- * `foxglove_channel_descriptor_metadata_iter_create`.
- * `key_value` must be a valid pointer to a `FoxgloveKeyValue` that will be filled in.
- * The channel descriptor itself must still be valid.
+ * - `param` must be a valid pointer.
+ * - `name` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `value` must be a valid `foxglove_bytes`. This value is copied by this function.
  */
-bool foxglove_channel_descriptor_metadata_iter_next(struct foxglove_channel_descriptor_metadata_iterator *iter,
-                                                    struct foxglove_key_value *key_value);
+foxglove_error foxglove_parameter_create_byte_array(struct foxglove_parameter **param,
+                                                    struct foxglove_string name,
+                                                    struct foxglove_bytes value);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Free a metadata iterator created via `foxglove_channel_descriptor_metadata_iter_create`.
+ * Creates a new parameter which is an array of float64 values.
+ *
+ * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
  * # Safety
- * `iter` must be a valid pointer to a `foxglove_channel_descriptor_metadata_iterator` created via
- * `foxglove_channel_descriptor_metadata_iter_create`.
+ * - `param` must be a valid pointer.
+ * - `name` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `values` must be a valid pointer to an array of float64 values of `values_len` elements. This
+ *   value is copied by this function.
  */
-void foxglove_channel_descriptor_metadata_iter_free(struct foxglove_channel_descriptor_metadata_iterator *iter);
+foxglove_error foxglove_parameter_create_float64_array(struct foxglove_parameter **param,
+                                                       struct foxglove_string name,
+                                                       const double *values,
+                                                       size_t values_len);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Create a new connection graph.
+ * Creates a new parameter which is an array of integer values.
+ */
+foxglove_error foxglove_parameter_create_integer_array(struct foxglove_parameter **param,
+                                                       struct foxglove_string name,
+                                                       const int64_t *values,
+                                                       size_t values_len);
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Creates a new parameter which is a dictionary of parameter values.
  *
- * The graph must later be freed with `foxglove_connection_graph_free`.
+ * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
  * # Safety
- * `graph` must be a valid pointer to a pointer to a `foxglove_connection_graph`.
+ * - `param` must be a valid pointer.
+ * - `name` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `dict` must be a valid pointer to a value allocated by
+ *   `foxglove_parameter_value_dict_create`. This value is moved into this function, and must not
+ *   be accessed afterwards.
  */
-foxglove_error foxglove_connection_graph_create(struct foxglove_connection_graph **graph);
+foxglove_error foxglove_parameter_create_dict(struct foxglove_parameter **param,
+                                              struct foxglove_string name,
+                                              struct foxglove_parameter_value_dict *dict);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Free the connection graph.
+ * Returns an estimate of the decoded length for the byte array in bytes.
  *
  * # Safety
- * `graph` must be a valid pointer to a `foxglove_connection_graph` created by
- * `foxglove_connection_graph_create`.
+ * - `param` must be a valid pointer to a value allocated by `foxglove_parameter_create` or
+ *   `foxglove_parameter_clone`.
+ * - `size` must be a valid pointer.
  */
-void foxglove_connection_graph_free(struct foxglove_connection_graph *graph);
+foxglove_error foxglove_parameter_get_byte_array_decoded_size(const struct foxglove_parameter *param,
+                                                              size_t *len);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Set a published topic and its associated publisher ids. Overwrites any existing topic with the
- * same name.
+ * Decodes a byte array into the provided buffer.
  *
- * # Safety
- * `topic`, and each ID in `publisher_ids` must adhere to the safety rules of `foxglove_string`.
- * `publisher_ids_count` must be the number of elements in the `publisher_ids` array.
+ * The buffer should be at least the size returned by
+ * `foxglove_parameter_get_byte_array_decoded_size`.
  *
- * These strings are copied from the pointers, and need only be valid for the duration of this
- * function call.
+ * On success, updates `len` with the number of bytes written to the provided buffer.
+ *
+ * # Safety
+ * - `param` must be a valid pointer to a value allocated by `foxglove_parameter_create` or
+ *   `foxglove_parameter_clone`.
+ * - `data` must be a valid pointer to a writable buffer of size `len`.
+ * - `len` must be a valid pointer.
  */
-foxglove_error foxglove_connection_graph_set_published_topic(struct foxglove_connection_graph *FOXGLOVE_NONNULL graph,
-                                                             struct foxglove_string topic,
-                                                             const struct foxglove_string *publisher_ids,
-                                                             size_t publisher_ids_count);
+foxglove_error foxglove_parameter_decode_byte_array(const struct foxglove_parameter *param,
+                                                    uint8_t *data,
+                                                    size_t *len);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Set a subscribed topic and its associated subscriber ids. Overwrites any existing topic with the
- * same name.
+ * Clones a parameter.
+ *
+ * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_array_push`.
  *
  * # Safety
- * `topic`, and each ID in `subscriber_ids` must adhere to the safety rules of `foxglove_string`.
- * `subscriber_ids_count` must be the number of elements in the `subscriber_ids` array.
+ * - `param` must be a valid pointer to a value allocated by `foxglove_parameter_create` or
+ *   `foxglove_parameter_clone`.
  */
-foxglove_error foxglove_connection_graph_set_subscribed_topic(struct foxglove_connection_graph *FOXGLOVE_NONNULL graph,
-                                                              struct foxglove_string topic,
-                                                              const struct foxglove_string *subscriber_ids,
-                                                              size_t subscriber_ids_count);
+struct foxglove_parameter *foxglove_parameter_clone(const struct foxglove_parameter *param);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Set an advertised service and its associated provider ids. Overwrites any existing service with
- * the same name.
+ * Frees a parameter.
  *
  * # Safety
- * `graph` must be a valid pointer to a `foxglove_connection_graph` created by
- * `foxglove_connection_graph_create`. `service`, and each ID in `provider_ids` must adhere to the
- * safety rules of `FoxgloveString`. `provider_ids_count` must be the number of elements in the
- * `provider_ids` array.
+ * - `param` must be a valid pointer to a value allocated by `foxglove_parameter_create` or
+ *   `foxglove_parameter_clone`.
  */
-foxglove_error foxglove_connection_graph_set_advertised_service(struct foxglove_connection_graph *FOXGLOVE_NONNULL graph,
-                                                                struct foxglove_string service,
-                                                                const struct foxglove_string *provider_ids,
-                                                                size_t provider_ids_count);
+void foxglove_parameter_free(struct foxglove_parameter *param);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Completes a fetch asset request by sending asset data to the client.
+ * Creates a new float64 parameter value.
  *
- * # Safety
- * - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via a
- *   `fetch_asset` callback. This value is moved into this function, and must not be accessed
- *   afterwards.
- * - `data` must be a pointer to the response data. This value is copied by this function.
+ * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_create`.
  */
-void foxglove_fetch_asset_respond_ok(struct foxglove_fetch_asset_responder *responder,
-                                     struct foxglove_bytes data);
+struct foxglove_parameter_value *foxglove_parameter_value_create_float64(double number);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Completes a request by sending an error message to the client.
+ * Creates a new integer parameter value.
  *
- * # Safety
- * - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via the
- *   `foxglove_server_options.fetch_asset` callback. This value is moved into this
- *   function, and must not accessed afterwards.
- * - `message` must be a valid UTF-8 string. This value is copied by this function.
+ * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_create`.
  */
-void foxglove_fetch_asset_respond_error(struct foxglove_fetch_asset_responder *responder,
-                                        struct foxglove_string message);
+struct foxglove_parameter_value *foxglove_parameter_value_create_integer(int64_t integer);
+#endif
+
+#if !defined(__wasm__)
+/**
+ * Creates a new boolean parameter value.
+ *
+ * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_create`.
+ */
+struct foxglove_parameter_value *foxglove_parameter_value_create_boolean(bool boolean);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Start a remote access gateway with the given options.
+ * Creates a new string parameter value.
  *
- * On success, the `gateway` output parameter will be set to a valid pointer.
- * On failure, an error code is returned.
+ * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_create`.
  *
  * # Safety
- * - `options` must be a valid pointer to a `FoxgloveGatewayOptions` struct with all fields
- *   satisfying the documented safety requirements.
- * - If `server_info` is supplied in options, all `server_info` must contain valid UTF8, and
- *   `server_info` must have length equal to `server_info_count`.
- * - `gateway` must be a valid pointer to a `*mut FoxgloveGateway`.
+ * - `string` must be a valid `foxglove_string`. This value is copied by this function.
  */
-foxglove_error foxglove_gateway_start(const struct foxglove_gateway_options *FOXGLOVE_NONNULL options,
-                                      struct foxglove_gateway **gateway);
+foxglove_error foxglove_parameter_value_create_string(struct foxglove_parameter_value **value,
+                                                      struct foxglove_string string);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Stop and shut down the gateway and free the resources associated with it.
+ * Creates a new array parameter value.
+ *
+ * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_create`.
+ *
+ * # Safety
+ * - `array` must be a valid pointer to a value allocated by
+ *   `foxglove_parameter_value_array_create`. This value is moved into this function, and must not
+ *   be accessed afterwards.
  */
-foxglove_error foxglove_gateway_stop(struct foxglove_gateway *gateway);
+struct foxglove_parameter_value *foxglove_parameter_value_create_array(struct foxglove_parameter_value_array *array);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Get the current connection status of the gateway.
+ * Creates a new dict parameter value.
  *
- * Returns `Shutdown` if the gateway pointer is null or the gateway has been stopped.
+ * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_create`.
+ *
+ * # Safety
+ * - `dict` must be a valid pointer to a value allocated by
+ *   `foxglove_parameter_value_dict_create`. This value is moved into this function, and must not be
+ *   accessed afterwards.
  */
-foxglove_connection_status foxglove_gateway_connection_status(const struct foxglove_gateway *gateway);
+struct foxglove_parameter_value *foxglove_parameter_value_create_dict(struct foxglove_parameter_value_dict *dict);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Get the sink ID of the gateway's current session.
+ * Clones a parameter value.
  *
- * Returns 0 if the gateway pointer is null, the gateway has been stopped,
- * or no session is currently active.
+ * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
+ * function such as `foxglove_parameter_create`.
+ *
+ * # Safety
+ * - `value` must be a valid pointer to a value allocated by `foxglove_parameter_value_create` or
+ *   `foxglove_parameter_value_clone`.
  */
-FoxgloveSinkId foxglove_gateway_sink_id(const struct foxglove_gateway *gateway);
+struct foxglove_parameter_value *foxglove_parameter_value_clone(const struct foxglove_parameter_value *value);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Adds a service to the gateway and advertises it to connected clients.
+ * Frees a parameter value.
  *
  * # Safety
- * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
- * - `service` must be a valid pointer to a service allocated by `foxglove_service_create`. This
- *   value is moved into this function, and must not be accessed afterwards.
+ * - `value` must be a valid pointer to a value allocated by `foxglove_parameter_value_create_*`.
  */
-foxglove_error foxglove_gateway_add_service(const struct foxglove_gateway *gateway,
-                                            struct foxglove_service *service);
+void foxglove_parameter_value_free(struct foxglove_parameter_value *value);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Removes a service from the gateway.
+ * Creates a new value array with the specified capacity.
  *
- * # Safety
- * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
- * - `service_name` must be a valid UTF-8 string.
+ * The parameter must be freed with `foxglove_parameter_value_array_free`, or by passing it to a
+ * consuming function such as `foxglove_parameter_value_create_array`.
  */
-foxglove_error foxglove_gateway_remove_service(const struct foxglove_gateway *gateway,
-                                               struct foxglove_string service_name);
+struct foxglove_parameter_value_array *foxglove_parameter_value_array_create(size_t capacity);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Publish parameter values to all subscribed clients.
+ * Pushes a parameter value into the array.
  *
  * # Safety
- * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
- * - `params` must be a valid pointer to a value allocated by `foxglove_parameter_array_create`.
+ * - `array` must be a valid pointer to an array allocated by
+ *   `foxglove_parameter_value_array_create`.
+ * - `value` must be a valid pointer to a value allocated by `foxglove_parameter_value_create_*`.
  *   This value is moved into this function, and must not be accessed afterwards.
  */
-foxglove_error foxglove_gateway_publish_parameter_values(const struct foxglove_gateway *gateway,
-                                                         struct foxglove_parameter_array *params);
+foxglove_error foxglove_parameter_value_array_push(struct foxglove_parameter_value_array *array,
+                                                   struct foxglove_parameter_value *value);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Publishes a status message to all connected participants.
- *
- * The caller may optionally provide a message ID, which can be used in a subsequent call to
- * `foxglove_gateway_remove_status`.
+ * Frees a parameter value array.
  *
  * # Safety
- * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
- * - `message` must be a valid UTF-8 string, which must remain valid for the duration of this
- *   call.
- * - `id` must either be NULL, or a pointer to a valid UTF-8 string, which must remain valid for
- *   the duration of this call.
+ * - `array` is a valid pointer to a value allocated by `foxglove_parameter_value_array_create`.
  */
-foxglove_error foxglove_gateway_publish_status(const struct foxglove_gateway *gateway,
-                                               foxglove_server_status_level level,
-                                               struct foxglove_string message,
-                                               const struct foxglove_string *id);
+void foxglove_parameter_value_array_free(struct foxglove_parameter_value_array *array);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Removes status messages from all connected participants.
- *
- * Previously published status messages are referenced by ID.
+ * Creates a new value dict with the specified capacity.
  *
- * # Safety
- * - `gateway` must be a valid pointer to a gateway started with `foxglove_gateway_start`.
- * - `ids` must be a pointer to an array of valid UTF-8 strings, all of which must remain valid
- *   for the duration of this call.
+ * The parameter must be freed with `foxglove_parameter_value_dict_free`, or by passing it to a
+ * consuming function such as `foxglove_parameter_value_create_dict`.
  */
-foxglove_error foxglove_gateway_remove_status(const struct foxglove_gateway *gateway,
-                                              const struct foxglove_string *ids,
-                                              size_t ids_count);
+struct foxglove_parameter_value_dict *foxglove_parameter_value_dict_create(size_t capacity);
 #endif
 
-#if defined(FOXGLOVE_REMOTE_ACCESS)
+#if !defined(__wasm__)
 /**
- * Publish a connection graph to the gateway.
+ * Inserts an entry into the parameter value dict.
  *
- * Requires `FOXGLOVE_GATEWAY_CAPABILITY_CONNECTION_GRAPH`.
+ * # Safety
+ * - `key` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `value` must be a valid pointer to a value allocated by `foxglove_parameter_value_create_*`.
+ *   This value is moved into this function, and must not be accessed afterwards.
  */
-foxglove_error foxglove_gateway_publish_connection_graph(const struct foxglove_gateway *gateway,
-                                                         const struct foxglove_connection_graph *graph);
+foxglove_error foxglove_parameter_value_dict_insert(struct foxglove_parameter_value_dict *dict,
+                                                    struct foxglove_string key,
+                                                    struct foxglove_parameter_value *value);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Initialize SDK logging with the given severity level.
- *
- * The SDK logs informational messages to stderr. Any messages below the given level are not
- * logged.
- *
- * This function should be called before other Foxglove initialization to capture output from all
- * components. Subsequent calls will have no effect.
- *
- * Log level may be overridden with the FOXGLOVE_LOG_LEVEL environment variable: "debug", "info",
- * "warn", "error", or "off". The default level is "info".
- *
- * Log styles (colors) may be configured with the FOXGLOVE_LOG_STYLE environment variable "never",
- * "always", or "auto" (default).
+ * Frees a parameter value dict.
  *
- * This is thread-safe, but only the first call to this function will have an effect.
+ * # Safety
+ * - `dict` is a valid pointer to a value allocated by `foxglove_parameter_value_dict_create`.
  */
-void foxglove_set_log_level(foxglove_logging_level level);
+void foxglove_parameter_value_dict_free(struct foxglove_parameter_value_dict *dict);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new parameter array with the specified capacity.
+ * Completes a `getParameters` request by sending parameter values to the client.
  *
- * The array must be freed with `foxglove_parameter_array_free`.
+ * # Safety
+ * - `responder` must be a pointer to a `foxglove_get_parameters_responder` obtained via a `get`
+ *   callback. This value is moved into this function, and must not be accessed afterwards.
+ * - `params` must be a valid pointer to a value allocated by `foxglove_parameter_array_create`.
+ *   This value is moved into this function, and must not be accessed afterwards. A NULL value is
+ *   treated as an empty array.
  */
-struct foxglove_parameter_array *foxglove_parameter_array_create(size_t capacity);
+void foxglove_get_parameters_responder_respond(struct foxglove_get_parameters_responder *responder,
+                                               struct foxglove_parameter_array *params);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Pushes a parameter into the array.
+ * Drops a `getParameters` responder without responding.
+ *
+ * Reserved for unrecoverable internal errors; sends a generic error status to the requesting
+ * client. In all other cases, complete the request with
+ * `foxglove_get_parameters_responder_respond` (passing an empty array if no values are available).
  *
  * # Safety
- * - `array` must be a valid pointer to an array allocated by `foxglove_parameter_array_create`.
- * - `param` must be a valid parameter to a value allocated by `foxglove_parameter_create` or
- *   `foxglove_parameter_clone`. This value is moved into this function, and must not be accessed
- *   afterwards.
+ * - `responder` must be a pointer to a `foxglove_get_parameters_responder` obtained via a `get`
+ *   callback. This value is moved into this function, and must not be accessed afterwards.
  */
-foxglove_error foxglove_parameter_array_push(struct foxglove_parameter_array *array,
-                                             struct foxglove_parameter *param);
+void foxglove_get_parameters_responder_drop(struct foxglove_get_parameters_responder *responder);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Frees the parameter array and its contained parameters.
+ * Completes a `setParameters` request with the values that were actually applied.
+ *
+ * Echoes those values back to the requesting client when the request carried a `request_id`;
+ * otherwise does nothing on the wire. Does not notify other parameter subscribers; the caller is
+ * responsible for broadcasting applied updates to subscribers on each sink (for example, via
+ * `foxglove_server_publish_parameter_values` and `foxglove_gateway_publish_parameter_values`).
  *
  * # Safety
- * - `array` must be a valid pointer to a value allocated by `foxglove_parameter_array_create`.
+ * - `responder` must be a pointer to a `foxglove_set_parameters_responder` obtained via a `set`
+ *   callback. This value is moved into this function, and must not be accessed afterwards.
+ * - `params` must be a valid pointer to a value allocated by `foxglove_parameter_array_create`.
+ *   This value is moved into this function, and must not be accessed afterwards. A NULL value is
+ *   treated as an empty array.
  */
-void foxglove_parameter_array_free(struct foxglove_parameter_array *array);
+void foxglove_set_parameters_responder_respond(struct foxglove_set_parameters_responder *responder,
+                                               struct foxglove_parameter_array *params);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new parameter.
+ * Drops a `setParameters` responder without responding.
  *
- * The parameter must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
+ * Reserved for unrecoverable internal errors; sends a generic error status to the requesting
+ * client. In all other cases, complete the request with
+ * `foxglove_set_parameters_responder_respond` (passing an empty array if the request could not
+ * be handled).
  *
  * # Safety
- * - `param` must be a valid pointer.
- * - `name` must be a valid `foxglove_string`. This value is copied by this function.
- * - `value` must either be a valid pointer to a value allocated by
- *   `foxglove_parameter_value_create`, or NULL. This value is moved into this function, and must
- *   not be accessed afterwards.
+ * - `responder` must be a pointer to a `foxglove_set_parameters_responder` obtained via a `set`
+ *   callback. This value is moved into this function, and must not be accessed afterwards.
  */
-foxglove_error foxglove_parameter_create(struct foxglove_parameter **param,
-                                         struct foxglove_string name,
-                                         foxglove_parameter_type type,
-                                         struct foxglove_parameter_value *value);
+void foxglove_set_parameters_responder_drop(struct foxglove_set_parameters_responder *responder);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new empty parameter.
+ * Create and start a server.
  *
- * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
+ * Resources must later be freed by calling `foxglove_server_stop`.
+ *
+ * `port` may be 0, in which case an available port will be automatically selected.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * - `param` must be a valid pointer.
- * - `name` must be a valid `foxglove_string`. This value is copied by this function.
+ *
+ * - If `name` is supplied in options, it must contain valid UTF8.
+ * - If `host` is supplied in options, it must contain valid UTF8.
+ * - If `supported_encodings` is supplied in options, all `supported_encodings` must contain valid
+ *   UTF8, and `supported_encodings` must have length equal to `supported_encodings_count`.
+ * - If `server_info` is supplied in options, all `server_info` must contain valid UTF8, and
+ *   `server_info` must have length equal to `server_info_count`.
  */
-foxglove_error foxglove_parameter_create_empty(struct foxglove_parameter **param,
-                                               struct foxglove_string name);
+foxglove_error foxglove_server_start(const struct foxglove_server_options *FOXGLOVE_NONNULL options,
+                                     struct foxglove_websocket_server **server);
 #endif
 
-#if !defined(__wasm__)
-/**
- * Creates a new number parameter.
- *
- * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
+#if !defined(__wasm__)
+/**
+ * Publishes the current server timestamp to all clients.
  *
- * # Safety
- * - `param` must be a valid pointer.
- * - `name` must be a valid `foxglove_string`. This value is copied by this function.
+ * Requires the `FOXGLOVE_CAPABILITY_TIME` capability.
  */
-foxglove_error foxglove_parameter_create_float64(struct foxglove_parameter **param,
-                                                 struct foxglove_string name,
-                                                 double value);
+foxglove_error foxglove_server_broadcast_time(const struct foxglove_websocket_server *server,
+                                              uint64_t timestamp_nanos);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new integer parameter.
+ * Publishes the current playback state to all clients.
  *
- * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
+ * Requires the `FOXGLOVE_CAPABILITY_PLAYBACK_CONTROL` capability.
  *
  * # Safety
- * - `param` must be a valid pointer.
- * - `name` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `playback_state` must be a valid pointer to a playback state that lives for the duration of the call.
  */
-foxglove_error foxglove_parameter_create_integer(struct foxglove_parameter **param,
-                                                 struct foxglove_string name,
-                                                 int64_t value);
+foxglove_error foxglove_server_broadcast_playback_state(const struct foxglove_websocket_server *server,
+                                                        const struct foxglove_playback_state *playback_state);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new boolean parameter.
+ * Sets a new session ID and notifies all clients, causing them to reset their state.
  *
- * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
+ * If `session_id` is not provided, generates a new one based on the current timestamp.
  *
  * # Safety
- * - `param` must be a valid pointer.
- * - `name` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `session_id` must either be NULL, or a pointer to a valid UTF-8 string.
  */
-foxglove_error foxglove_parameter_create_boolean(struct foxglove_parameter **param,
-                                                 struct foxglove_string name,
-                                                 bool value);
+foxglove_error foxglove_server_clear_session(const struct foxglove_websocket_server *server,
+                                             const struct foxglove_string *session_id);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new string parameter.
+ * Adds a service to the server.
  *
- * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
+ * This function will fail if the server was not configured with the `services` capability,
+ * if a service with the same name is already registered, or if the service has no request
+ * encoding and the server has no supported encodings.
  *
  * # Safety
- * - `param` must be a valid pointer.
- * - `name` must be a valid `foxglove_string`. This value is copied by this function.
- * - `value` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `server` must be a valid pointer to a server started with `foxglove_server_start`.
+ * - `service` must be a valid pointer to a service allocated by `foxglove_service_create`. This
+ *   value is moved into this function, and must not be accessed afterwards.
  */
-foxglove_error foxglove_parameter_create_string(struct foxglove_parameter **param,
-                                                struct foxglove_string name,
-                                                struct foxglove_string value);
+foxglove_error foxglove_server_add_service(const struct foxglove_websocket_server *server,
+                                           struct foxglove_service *service);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new byte array parameter.
- *
- * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
+ * Removes a service from the server.
  *
  * # Safety
- * - `param` must be a valid pointer.
- * - `name` must be a valid `foxglove_string`. This value is copied by this function.
- * - `value` must be a valid `foxglove_bytes`. This value is copied by this function.
+ * - `server` must be a valid pointer to a server started with `foxglove_server_start`.
+ * - `service_name` must be a valid UTF-8 string.
  */
-foxglove_error foxglove_parameter_create_byte_array(struct foxglove_parameter **param,
-                                                    struct foxglove_string name,
-                                                    struct foxglove_bytes value);
+foxglove_error foxglove_server_remove_service(const struct foxglove_websocket_server *server,
+                                              struct foxglove_string service_name);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new parameter which is an array of float64 values.
- *
- * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
- *
- * # Safety
- * - `param` must be a valid pointer.
- * - `name` must be a valid `foxglove_string`. This value is copied by this function.
- * - `values` must be a valid pointer to an array of float64 values of `values_len` elements. This
- *   value is copied by this function.
+ * Get the port on which the server is listening.
  */
-foxglove_error foxglove_parameter_create_float64_array(struct foxglove_parameter **param,
-                                                       struct foxglove_string name,
-                                                       const double *values,
-                                                       size_t values_len);
+uint16_t foxglove_server_get_port(struct foxglove_websocket_server *server);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new parameter which is an array of integer values.
+ * Get the number of currently connected clients.
  */
-foxglove_error foxglove_parameter_create_integer_array(struct foxglove_parameter **param,
-                                                       struct foxglove_string name,
-                                                       const int64_t *values,
-                                                       size_t values_len);
+size_t foxglove_server_get_client_count(struct foxglove_websocket_server *server);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new parameter which is a dictionary of parameter values.
+ * Get a snapshot of the delivery counters of each connected client.
  *
- * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
+ * On success, writes a non-null snapshot to `stats`, which must be freed with
+ * `foxglove_server_stats_free`.
  *
  * # Safety
- * - `param` must be a valid pointer.
- * - `name` must be a valid `foxglove_string`. This value is copied by this function.
- * - `dict` must be a valid pointer to a value allocated by
- *   `foxglove_parameter_value_dict_create`. This value is moved into this function, and must not
- *   be accessed afterwards.
+ * `stats` must be a valid, writable pointer.
  */
-foxglove_error foxglove_parameter_create_dict(struct foxglove_parameter **param,
-                                              struct foxglove_string name,
-                                              struct foxglove_parameter_value_dict *dict);
+foxglove_error foxglove_server_get_stats(const struct foxglove_websocket_server *server,
+                                         struct foxglove_server_stats **stats);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Returns an estimate of the decoded length for the byte array in bytes.
+ * Get the counters of each client in a snapshot, in order of connection.
+ *
+ * Writes the number of clients to `count`, and returns a pointer to the first, which is valid
+ * until the snapshot is freed.
  *
  * # Safety
- * - `param` must be a valid pointer to a value allocated by `foxglove_parameter_create` or
- *   `foxglove_parameter_clone`.
- * - `size` must be a valid pointer.
+ * - `stats` must be a valid pointer to a snapshot created with `foxglove_server_get_stats`.
+ * - `count` must be a valid pointer to a `size_t`.
  */
-foxglove_error foxglove_parameter_get_byte_array_decoded_size(const struct foxglove_parameter *param,
-                                                              size_t *len);
+const struct foxglove_client_stats *foxglove_server_stats_clients(const struct foxglove_server_stats *stats,
+                                                                  size_t *FOXGLOVE_NONNULL count);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Decodes a byte array into the provided buffer.
- *
- * The buffer should be at least the size returned by
- * `foxglove_parameter_get_byte_array_decoded_size`.
- *
- * On success, updates `len` with the number of bytes written to the provided buffer.
+ * Free a snapshot created with `foxglove_server_get_stats`.
  *
  * # Safety
- * - `param` must be a valid pointer to a value allocated by `foxglove_parameter_create` or
- *   `foxglove_parameter_clone`.
- * - `data` must be a valid pointer to a writable buffer of size `len`.
- * - `len` must be a valid pointer.
+ * `stats` must be a pointer returned by `foxglove_server_get_stats`, or null.
  */
-foxglove_error foxglove_parameter_decode_byte_array(const struct foxglove_parameter *param,
-                                                    uint8_t *data,
-                                                    size_t *len);
+void foxglove_server_stats_free(struct foxglove_server_stats *stats);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Clones a parameter.
- *
- * The value must be freed with `foxglove_parameter_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_array_push`.
- *
- * # Safety
- * - `param` must be a valid pointer to a value allocated by `foxglove_parameter_create` or
- *   `foxglove_parameter_clone`.
+ * Stop and shut down `server` and free the resources associated with it.
  */
-struct foxglove_parameter *foxglove_parameter_clone(const struct foxglove_parameter *param);
+foxglove_error foxglove_server_stop(struct foxglove_websocket_server *server);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Frees a parameter.
+ * Publish parameter values to all subscribed clients.
  *
  * # Safety
- * - `param` must be a valid pointer to a value allocated by `foxglove_parameter_create` or
- *   `foxglove_parameter_clone`.
+ * - `params` must be a valid parameter to a value allocated by `foxglove_parameter_array_create`.
+ *   This value is moved into this function, and must not be accessed afterwards.
  */
-void foxglove_parameter_free(struct foxglove_parameter *param);
+foxglove_error foxglove_server_publish_parameter_values(struct foxglove_websocket_server *server,
+                                                        struct foxglove_parameter_array *params);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new float64 parameter value.
- *
- * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_create`.
+ * Publish a connection graph to the server.
  */
-struct foxglove_parameter_value *foxglove_parameter_value_create_float64(double number);
+foxglove_error foxglove_server_publish_connection_graph(struct foxglove_websocket_server *server,
+                                                        struct foxglove_connection_graph *graph);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new integer parameter value.
+ * Apply a connection graph patch to the connection graph published by the server, and send the
+ * changes to subscribed clients.
  *
- * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_create`.
+ * The patch is consumed by this call, even if it fails, and must not be used or freed
+ * afterwards.
+ *
+ * # Safety
+ * `patch` must be a valid pointer to a `foxglove_connection_graph_patch` created by
+ * `foxglove_connection_graph_patch_create`.
  */
-struct foxglove_parameter_value *foxglove_parameter_value_create_integer(int64_t integer);
+foxglove_error foxglove_server_update_connection_graph(struct foxglove_websocket_server *server,
+                                                       struct foxglove_connection_graph_patch *patch);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new boolean parameter value.
+ * Publishes a status message to all clients.
  *
- * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_create`.
+ * The server may send this message at any time. Client developers may use it for debugging
+ * purposes, display it to the end user, or ignore it.
+ *
+ * The caller may optionally provide a message ID, which can be used in a subsequent call to
+ * `foxglove_server_remove_status`.
+ *
+ * # Safety
+ * - `message` must be a valid UTF-8 string, which must remain valid for the duration of this
+ *   call.
+ * - `id` must either be NULL, or a pointer to a valid UTF-8 string, which must remain valid for
+ *   the duration of this call.
  */
-struct foxglove_parameter_value *foxglove_parameter_value_create_boolean(bool boolean);
+foxglove_error foxglove_server_publish_status(struct foxglove_websocket_server *server,
+                                              foxglove_server_status_level level,
+                                              struct foxglove_string message,
+                                              const struct foxglove_string *id);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new string parameter value.
+ * Removes status messages from all clients.
  *
- * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_create`.
+ * Previously published status messages are referenced by ID.
  *
  * # Safety
- * - `string` must be a valid `foxglove_string`. This value is copied by this function.
+ * - `ids` must be a pointer to an array of valid UTF-8 strings, all of which must remain valid
+ *   for the duration of this call.
  */
-foxglove_error foxglove_parameter_value_create_string(struct foxglove_parameter_value **value,
-                                                      struct foxglove_string string);
+foxglove_error foxglove_server_remove_status(struct foxglove_websocket_server *server,
+                                             const struct foxglove_string *ids,
+                                             size_t ids_count);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new array parameter value.
+ * Creates a new WebSocket service.
  *
- * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_create`.
+ * The service must be registered with a WebSocket server using `foxglove_server_add_service`, or
+ * freed with `foxglove_service_free`.
+ *
+ * The callback is invoked from the client's main poll loop and must not block. If blocking or
+ * long-running behavior is required, the implementation should return immediately and handle the
+ * request asynchronously.
+ *
+ * The `request` structure provided to the callback is only valid for the duration of the
+ * callback. If the implementation wishes to retain its data for a longer lifetime, it must copy
+ * data out of it.
+ *
+ * The `responder` provided to the callback represents an unfulfilled response. The implementation
+ * must eventually call either `foxglove_service_respond_ok` or `foxglove_service_respond_error`,
+ * exactly once, in order to complete the request. It is safe to invoke these completion functions
+ * synchronously from the context of the callback.
  *
  * # Safety
- * - `array` must be a valid pointer to a value allocated by
- *   `foxglove_parameter_value_array_create`. This value is moved into this function, and must not
- *   be accessed afterwards.
+ * - `service` must be a valid pointer.
+ * - `name` must be a valid UTF-8 string.
+ * - `schema` must be NULL, or a valid pointer to a service schema.
+ * - `callback` must be a valid pointer to a service callback function, which must remain valid
+ *   until the service is either unregistered or freed.
  */
-struct foxglove_parameter_value *foxglove_parameter_value_create_array(struct foxglove_parameter_value_array *array);
+foxglove_error foxglove_service_create(struct foxglove_service **service,
+                                       struct foxglove_string name,
+                                       const struct foxglove_service_schema *schema,
+                                       const void *context,
+                                       void (*callback)(const void *context,
+                                                        const struct foxglove_service_request *request,
+                                                        struct foxglove_service_responder *responder));
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new dict parameter value.
+ * Creates a new WebSocket service, with options for dispatching calls to it.
  *
- * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_create`.
+ * This behaves like `foxglove_service_create`, except that if `options` sets `worker_threads`,
+ * the callback is invoked on a pool of worker threads dedicated to the service, and may block.
+ * If `options` sets `max_in_flight`, calls beyond the limit are queued until an earlier call
+ * completes, and queued calls are invoked on the worker threads, or on an internal blocking
+ * thread if there are none. Queued calls whose client disconnects, or which wait for longer than
+ * `queue_timeout_ms`, are failed without invoking the callback. If `options` sets
+ * `response_cache_ttl_ms`, identical calls are coalesced, and their successful responses are
+ * cached for that long.
+ *
+ * A callback may use `foxglove_service_responder_is_cancelled` to check whether its client has
+ * disconnected.
  *
  * # Safety
- * - `dict` must be a valid pointer to a value allocated by
- *   `foxglove_parameter_value_dict_create`. This value is moved into this function, and must not be
- *   accessed afterwards.
+ * - `service` must be a valid pointer.
+ * - `name` must be a valid UTF-8 string.
+ * - `schema` must be NULL, or a valid pointer to a service schema.
+ * - `options` must be NULL, or a valid pointer to service options.
+ * - `callback` must be a valid pointer to a service callback function, which must remain valid
+ *   until the service is either unregistered or freed. If `worker_threads` or `max_in_flight`
+ *   is set, the callback and `context` must be safe to use from other threads.
  */
-struct foxglove_parameter_value *foxglove_parameter_value_create_dict(struct foxglove_parameter_value_dict *dict);
+foxglove_error foxglove_service_create_with_options(struct foxglove_service **service,
+                                                    struct foxglove_string name,
+                                                    const struct foxglove_service_schema *schema,
+                                                    const struct foxglove_service_options *options,
+                                                    const void *context,
+                                                    void (*callback)(const void *context,
+                                                                     const struct foxglove_service_request *request,
+                                                                     struct foxglove_service_responder *responder));
 #endif
 
 #if !defined(__wasm__)
 /**
- * Clones a parameter value.
- *
- * The value must be freed with `foxglove_parameter_value_free`, or by passing it to a consuming
- * function such as `foxglove_parameter_create`.
+ * Frees a service that was never registered to a WebSocket server.
  *
  * # Safety
- * - `value` must be a valid pointer to a value allocated by `foxglove_parameter_value_create` or
- *   `foxglove_parameter_value_clone`.
+ * - `service` must be a valid pointer to a service allocated by `foxglove_service_create`. The
+ *   service MUST NOT have been previously registered with a WebSocket server.
  */
-struct foxglove_parameter_value *foxglove_parameter_value_clone(const struct foxglove_parameter_value *value);
+void foxglove_service_free(struct foxglove_service *service);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Frees a parameter value.
+ * Overrides the default response encoding.
  *
  * # Safety
- * - `value` must be a valid pointer to a value allocated by `foxglove_parameter_value_create_*`.
+ * - `responder` must be a pointer to a `foxglove_service_responder` obtained via the
+ *   `foxglove_service.handler` callback.
+ * - `encoding` must be a valid UTF-8 string. This value is copied by this function.
  */
-void foxglove_parameter_value_free(struct foxglove_parameter_value *value);
+foxglove_error foxglove_service_set_response_encoding(struct foxglove_service_responder *responder,
+                                                      struct foxglove_string encoding);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new value array with the specified capacity.
+ * Returns true if the client which made a request has disconnected.
  *
- * The parameter must be freed with `foxglove_parameter_value_array_free`, or by passing it to a
- * consuming function such as `foxglove_parameter_value_create_array`.
+ * A long-running callback may use this to abandon work whose response would never be delivered.
+ * It must still complete the request, with `foxglove_service_respond_ok` or
+ * `foxglove_service_respond_error`.
+ *
+ * # Safety
+ * - `responder` must be NULL, or a pointer to a `foxglove_service_responder` obtained via the
+ *   `foxglove_service.handler` callback, which has not yet been completed.
  */
-struct foxglove_parameter_value_array *foxglove_parameter_value_array_create(size_t capacity);
+bool foxglove_service_responder_is_cancelled(const struct foxglove_service_responder *responder);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Pushes a parameter value into the array.
+ * Completes a request by sending response data to the client.
  *
  * # Safety
- * - `array` must be a valid pointer to an array allocated by
- *   `foxglove_parameter_value_array_create`.
- * - `value` must be a valid pointer to a value allocated by `foxglove_parameter_value_create_*`.
- *   This value is moved into this function, and must not be accessed afterwards.
+ * - `responder` must be a pointer to a `foxglove_service_responder` obtained via the
+ *   `foxglove_service.handler` callback. This value is moved into this function, and must not
+ *   accessed afterwards.
+ * - `data` must be a pointer to the response data. This value is copied by this function.
  */
-foxglove_error foxglove_parameter_value_array_push(struct foxglove_parameter_value_array *array,
-                                                   struct foxglove_parameter_value *value);
+void foxglove_service_respond_ok(struct foxglove_service_responder *responder,
+                                 struct foxglove_bytes data);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Frees a parameter value array.
+ * Completes a request by sending an error message to the client.
  *
  * # Safety
- * - `array` is a valid pointer to a value allocated by `foxglove_parameter_value_array_create`.
+ * - `responder` must be a pointer to a `foxglove_service_responder` obtained via the
+ *   `foxglove_service.handler` callback. This value is moved into this function, and must not
+ *   accessed afterwards.
+ * - `message` must be a valid UTF-8 string. This value is copied by this function.
  */
-void foxglove_parameter_value_array_free(struct foxglove_parameter_value_array *array);
+void foxglove_service_respond_error(struct foxglove_service_responder *responder,
+                                    struct foxglove_string message);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new value dict with the specified capacity.
+ * Create a ring buffer sink. Resources must later be freed with
+ * `foxglove_ring_buffer_sink_close`.
  *
- * The parameter must be freed with `foxglove_parameter_value_dict_free`, or by passing it to a
- * consuming function such as `foxglove_parameter_value_create_dict`.
+ * Returns 0 on success, or returns a FoxgloveError code on error.
+ *
+ * # Safety
+ * `mcap_options` must be null or a valid pointer to MCAP options. If `context` is non-null, it
+ * must have been created by `foxglove_context_new`.
  */
-struct foxglove_parameter_value_dict *foxglove_parameter_value_dict_create(size_t capacity);
+foxglove_error foxglove_ring_buffer_sink_create(const struct foxglove_ring_buffer_sink_options *FOXGLOVE_NONNULL options,
+                                                struct foxglove_ring_buffer_sink **sink);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Inserts an entry into the parameter value dict.
+ * Start writing the buffered messages logged within `window_ns` nanoseconds of the newest
+ * message to a new MCAP file at `path`.
+ *
+ * The messages are copied out of the ring buffer before this function returns, and written on
+ * a background thread. The file must not already exist. Resources must later be freed with
+ * `foxglove_ring_buffer_snapshot_wait` or `foxglove_ring_buffer_snapshot_detach`.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * - `key` must be a valid `foxglove_string`. This value is copied by this function.
- * - `value` must be a valid pointer to a value allocated by `foxglove_parameter_value_create_*`.
- *   This value is moved into this function, and must not be accessed afterwards.
+ * `sink` must be a valid pointer to a sink created via `foxglove_ring_buffer_sink_create`.
+ * `path` must contain valid UTF8.
  */
-foxglove_error foxglove_parameter_value_dict_insert(struct foxglove_parameter_value_dict *dict,
-                                                    struct foxglove_string key,
-                                                    struct foxglove_parameter_value *value);
+foxglove_error foxglove_ring_buffer_sink_snapshot(const struct foxglove_ring_buffer_sink *sink,
+                                                  struct foxglove_string path,
+                                                  uint64_t window_ns,
+                                                  struct foxglove_ring_buffer_snapshot **snapshot);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Frees a parameter value dict.
+ * Returns the number of messages currently buffered by the sink, or 0 if `sink` is null.
  *
  * # Safety
- * - `dict` is a valid pointer to a value allocated by `foxglove_parameter_value_dict_create`.
+ * `sink` must be null, or a valid pointer to a sink created via
+ * `foxglove_ring_buffer_sink_create`.
  */
-void foxglove_parameter_value_dict_free(struct foxglove_parameter_value_dict *dict);
+size_t foxglove_ring_buffer_sink_buffered_messages(const struct foxglove_ring_buffer_sink *sink);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Completes a `getParameters` request by sending parameter values to the client.
+ * Returns the total size of the message data currently buffered by the sink, in bytes, or 0 if
+ * `sink` is null.
  *
  * # Safety
- * - `responder` must be a pointer to a `foxglove_get_parameters_responder` obtained via a `get`
- *   callback. This value is moved into this function, and must not be accessed afterwards.
- * - `params` must be a valid pointer to a value allocated by `foxglove_parameter_array_create`.
- *   This value is moved into this function, and must not be accessed afterwards. A NULL value is
- *   treated as an empty array.
+ * `sink` must be null, or a valid pointer to a sink created via
+ * `foxglove_ring_buffer_sink_create`.
  */
-void foxglove_get_parameters_responder_respond(struct foxglove_get_parameters_responder *responder,
-                                               struct foxglove_parameter_array *params);
+size_t foxglove_ring_buffer_sink_buffered_bytes(const struct foxglove_ring_buffer_sink *sink);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Drops a `getParameters` responder without responding.
+ * Close and free a ring buffer sink created via `foxglove_ring_buffer_sink_create`.
  *
- * Reserved for unrecoverable internal errors; sends a generic error status to the requesting
- * client. In all other cases, complete the request with
- * `foxglove_get_parameters_responder_respond` (passing an empty array if no values are available).
+ * Closing releases the buffered messages. Snapshots which are being written are not affected.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * - `responder` must be a pointer to a `foxglove_get_parameters_responder` obtained via a `get`
- *   callback. This value is moved into this function, and must not be accessed afterwards.
+ * `sink` must be a valid pointer to a sink created via `foxglove_ring_buffer_sink_create`.
  */
-void foxglove_get_parameters_responder_drop(struct foxglove_get_parameters_responder *responder);
+foxglove_error foxglove_ring_buffer_sink_close(struct foxglove_ring_buffer_sink *sink);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Completes a `setParameters` request with the values that were actually applied.
+ * Wait for a snapshot to be written, and free it.
  *
- * Echoes those values back to the requesting client when the request carried a `request_id`;
- * otherwise does nothing on the wire. Does not notify other parameter subscribers; the caller is
- * responsible for broadcasting applied updates to subscribers on each sink (for example, via
- * `foxglove_server_publish_parameter_values` and `foxglove_gateway_publish_parameter_values`).
+ * Returns 0 if the snapshot was written, or returns a FoxgloveError code on error.
  *
  * # Safety
- * - `responder` must be a pointer to a `foxglove_set_parameters_responder` obtained via a `set`
- *   callback. This value is moved into this function, and must not be accessed afterwards.
- * - `params` must be a valid pointer to a value allocated by `foxglove_parameter_array_create`.
- *   This value is moved into this function, and must not be accessed afterwards. A NULL value is
- *   treated as an empty array.
+ * `snapshot` must be a valid pointer to a snapshot created via
+ * `foxglove_ring_buffer_sink_snapshot`.
  */
-void foxglove_set_parameters_responder_respond(struct foxglove_set_parameters_responder *responder,
-                                               struct foxglove_parameter_array *params);
+foxglove_error foxglove_ring_buffer_snapshot_wait(struct foxglove_ring_buffer_snapshot *snapshot);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Drops a `setParameters` responder without responding.
- *
- * Reserved for unrecoverable internal errors; sends a generic error status to the requesting
- * client. In all other cases, complete the request with
- * `foxglove_set_parameters_responder_respond` (passing an empty array if the request could not
- * be handled).
+ * Free a snapshot without waiting for it to be written. The snapshot continues to be written
+ * in the background, and errors are logged.
  *
  * # Safety
- * - `responder` must be a pointer to a `foxglove_set_parameters_responder` obtained via a `set`
- *   callback. This value is moved into this function, and must not be accessed afterwards.
+ * `snapshot` must be null, or a valid pointer to a snapshot created via
+ * `foxglove_ring_buffer_sink_snapshot`.
  */
-void foxglove_set_parameters_responder_drop(struct foxglove_set_parameters_responder *responder);
+void foxglove_ring_buffer_snapshot_detach(struct foxglove_ring_buffer_snapshot *snapshot);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Create and start a server.
- *
- * Resources must later be freed by calling `foxglove_server_stop`.
+ * Set the options of the SDK's internal runtime.
  *
- * `port` may be 0, in which case an available port will be automatically selected.
+ * This must be called before starting anything which creates the runtime, such as a WebSocket
+ * server or system info publisher. The CPU affinity and nice value also apply to the dedicated
+ * threads of servers started with `writer_threads`.
  *
- * Returns 0 on success, or returns a FoxgloveError code on error.
+ * Returns `FOXGLOVE_ERROR_CONFIGURATION_ERROR` if the runtime was already created, or
+ * `FOXGLOVE_ERROR_VALUE_ERROR` if the options are invalid.
  *
  * # Safety
- *
- * - If `name` is supplied in options, it must contain valid UTF8.
- * - If `host` is supplied in options, it must contain valid UTF8.
- * - If `supported_encodings` is supplied in options, all `supported_encodings` must contain valid
- *   UTF8, and `supported_encodings` must have length equal to `supported_encodings_count`.
- * - If `server_info` is supplied in options, all `server_info` must contain valid UTF8, and
- *   `server_info` must have length equal to `server_info_count`.
+ * `options` must be a valid pointer to options, whose pointers are valid as documented on
+ * `foxglove_runtime_options`.
  */
-foxglove_error foxglove_server_start(const struct foxglove_server_options *FOXGLOVE_NONNULL options,
-                                     struct foxglove_websocket_server **server);
+foxglove_error foxglove_set_runtime_options(const struct foxglove_runtime_options *options);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Publishes the current server timestamp to all clients.
+ * Create a shared-memory sink. Resources must later be freed with
+ * `foxglove_shared_memory_sink_close`.
  *
- * Requires the `FOXGLOVE_CAPABILITY_TIME` capability.
- */
-foxglove_error foxglove_server_broadcast_time(const struct foxglove_websocket_server *server,
-                                              uint64_t timestamp_nanos);
-#endif
-
-#if !defined(__wasm__)
-/**
- * Publishes the current playback state to all clients.
+ * Shared-memory sinks are only supported on Unix platforms; elsewhere this returns
+ * `FOXGLOVE_ERROR_VALUE_ERROR`.
  *
- * Requires the `FOXGLOVE_CAPABILITY_PLAYBACK_CONTROL` capability.
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * - `playback_state` must be a valid pointer to a playback state that lives for the duration of the call.
+ * `path` must contain valid UTF8. If `context` is non-null, it must have been created by
+ * `foxglove_context_new`.
  */
-foxglove_error foxglove_server_broadcast_playback_state(const struct foxglove_websocket_server *server,
-                                                        const struct foxglove_playback_state *playback_state);
+foxglove_error foxglove_shared_memory_sink_create(const struct foxglove_shared_memory_sink_options *FOXGLOVE_NONNULL options,
+                                                  struct foxglove_shared_memory_sink **sink);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Sets a new session ID and notifies all clients, causing them to reset their state.
+ * Returns the token which viewers use to open the sink's ring buffer.
  *
- * If `session_id` is not provided, generates a new one based on the current timestamp.
+ * The returned string is valid until the sink is closed. It is empty if `sink` is null.
  *
  * # Safety
- * - `session_id` must either be NULL, or a pointer to a valid UTF-8 string.
+ * `sink` must be null, or a valid pointer to a sink created via
+ * `foxglove_shared_memory_sink_create`.
  */
-foxglove_error foxglove_server_clear_session(const struct foxglove_websocket_server *server,
-                                             const struct foxglove_string *session_id);
+struct foxglove_string foxglove_shared_memory_sink_token(const struct foxglove_shared_memory_sink *sink);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Adds a service to the server.
+ * Close and free a shared-memory sink created via `foxglove_shared_memory_sink_create`.
  *
- * This function will fail if the server was not configured with the `services` capability,
- * if a service with the same name is already registered, or if the service has no request
- * encoding and the server has no supported encodings.
+ * Closing marks the ring as closed for its readers and removes its backing file.
+ *
+ * Returns 0 on success, or returns a FoxgloveError code on error.
  *
  * # Safety
- * - `server` must be a valid pointer to a server started with `foxglove_server_start`.
- * - `service` must be a valid pointer to a service allocated by `foxglove_service_create`. This
- *   value is moved into this function, and must not be accessed afterwards.
+ * `sink` must be a valid pointer to a sink created via `foxglove_shared_memory_sink_create`.
  */
-foxglove_error foxglove_server_add_service(const struct foxglove_websocket_server *server,
-                                           struct foxglove_service *service);
+foxglove_error foxglove_shared_memory_sink_close(struct foxglove_shared_memory_sink *sink);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Removes a service from the server.
+ * Compile a topic filter.
+ *
+ * On success, writes a non-null filter to `filter`, which must be freed with
+ * `foxglove_topic_filter_free`. Returns `FOXGLOVE_ERROR_VALUE_ERROR` if a regular expression is
+ * invalid.
  *
  * # Safety
- * - `server` must be a valid pointer to a server started with `foxglove_server_start`.
- * - `service_name` must be a valid UTF-8 string.
+ * - Each pattern array must be null, or a valid pointer to the given number of valid UTF-8
+ *   strings.
+ * - `filter` must be a valid, writable pointer.
  */
-foxglove_error foxglove_server_remove_service(const struct foxglove_websocket_server *server,
-                                              struct foxglove_string service_name);
+foxglove_error foxglove_topic_filter_create(const struct foxglove_topic_filter_options *options,
+                                            struct foxglove_topic_filter **filter);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Get the port on which the server is listening.
+ * Returns true if a channel with the given topic passes the filter.
+ *
+ * # Safety
+ * `topic` must be a valid UTF-8 string.
  */
-uint16_t foxglove_server_get_port(struct foxglove_websocket_server *server);
+bool foxglove_topic_filter_matches(const struct foxglove_topic_filter *filter,
+                                   struct foxglove_string topic);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Get the number of currently connected clients.
+ * Free a topic filter created via `foxglove_topic_filter_create`.
+ *
+ * Sinks which were created with the filter keep using it.
+ *
+ * # Safety
+ * `filter` must be a pointer returned by `foxglove_topic_filter_create`, or null.
  */
-size_t foxglove_server_get_client_count(struct foxglove_websocket_server *server);
+void foxglove_topic_filter_free(struct foxglove_topic_filter *filter);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Stop and shut down `server` and free the resources associated with it.
+ * Install a latency tracer, replacing any previously installed tracer.
+ *
+ * On success, writes a non-null handle to `out_tracer`, which must be freed with
+ * [`foxglove_latency_tracer_free`].
+ *
+ * # Safety
+ * - `options`, when non-null, must be a valid pointer to a [`FoxgloveLatencyTracerOptions`].
+ * - `out_tracer` must be a valid, writable pointer to a `*mut FoxgloveLatencyTracer`.
  */
-foxglove_error foxglove_server_stop(struct foxglove_websocket_server *server);
+foxglove_error foxglove_latency_tracer_install(const struct foxglove_latency_tracer_options *options,
+                                               struct foxglove_latency_tracer **out_tracer);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Publish parameter values to all subscribed clients.
+ * Uninstall a latency tracer and free its resources.
+ *
+ * If another tracer has since been installed, that tracer remains installed. Passing a null
+ * pointer is a no-op.
  *
  * # Safety
- * - `params` must be a valid parameter to a value allocated by `foxglove_parameter_array_create`.
- *   This value is moved into this function, and must not be accessed afterwards.
+ * `tracer` must be a handle returned by [`foxglove_latency_tracer_install`], or null.
  */
-foxglove_error foxglove_server_publish_parameter_values(struct foxglove_websocket_server *server,
-                                                        struct foxglove_parameter_array *params);
+void foxglove_latency_tracer_free(struct foxglove_latency_tracer *tracer);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Publish a connection graph to the server.
+ * Discard the samples recorded so far.
  */
-foxglove_error foxglove_server_publish_connection_graph(struct foxglove_websocket_server *server,
-                                                        struct foxglove_connection_graph *graph);
+void foxglove_latency_tracer_clear(const struct foxglove_latency_tracer *tracer);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Publishes a status message to all clients.
- *
- * The server may send this message at any time. Client developers may use it for debugging
- * purposes, display it to the end user, or ignore it.
+ * Get a snapshot of the latency percentiles for each sink, channel and stage.
  *
- * The caller may optionally provide a message ID, which can be used in a subsequent call to
- * `foxglove_server_remove_status`.
+ * On success, writes a non-null snapshot to `stats`, which must be freed with
+ * [`foxglove_latency_stats_free`].
  *
  * # Safety
- * - `message` must be a valid UTF-8 string, which must remain valid for the duration of this
- *   call.
- * - `id` must either be NULL, or a pointer to a valid UTF-8 string, which must remain valid for
- *   the duration of this call.
+ * `stats` must be a valid, writable pointer.
  */
-foxglove_error foxglove_server_publish_status(struct foxglove_websocket_server *server,
-                                              foxglove_server_status_level level,
-                                              struct foxglove_string message,
-                                              const struct foxglove_string *id);
+foxglove_error foxglove_latency_tracer_get_stats(const struct foxglove_latency_tracer *tracer,
+                                                 struct foxglove_latency_stats_snapshot **stats);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Removes status messages from all clients.
+ * Get the entries of a snapshot, ordered by sink, channel and stage.
  *
- * Previously published status messages are referenced by ID.
+ * Writes the number of entries to `count`, and returns a pointer to the first, which is valid
+ * until the snapshot is freed.
  *
  * # Safety
- * - `ids` must be a pointer to an array of valid UTF-8 strings, all of which must remain valid
- *   for the duration of this call.
+ * - `stats` must be a valid pointer to a snapshot created with
+ *   [`foxglove_latency_tracer_get_stats`].
+ * - `count` must be a valid pointer to a `size_t`.
  */
-foxglove_error foxglove_server_remove_status(struct foxglove_websocket_server *server,
-                                             const struct foxglove_string *ids,
-                                             size_t ids_count);
+const struct foxglove_latency_stats *foxglove_latency_stats_entries(const struct foxglove_latency_stats_snapshot *stats,
+                                                                    size_t *count);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Creates a new WebSocket service.
- *
- * The service must be registered with a WebSocket server using `foxglove_server_add_service`, or
- * freed with `foxglove_service_free`.
- *
- * The callback is invoked from the client's main poll loop and must not block. If blocking or
- * long-running behavior is required, the implementation should return immediately and handle the
- * request asynchronously.
- *
- * The `request` structure provided to the callback is only valid for the duration of the
- * callback. If the implementation wishes to retain its data for a longer lifetime, it must copy
- * data out of it.
- *
- * The `responder` provided to the callback represents an unfulfilled response. The implementation
- * must eventually call either `foxglove_service_respond_ok` or `foxglove_service_respond_error`,
- * exactly once, in order to complete the request. It is safe to invoke these completion functions
- * synchronously from the context of the callback.
+ * Free a snapshot created with [`foxglove_latency_tracer_get_stats`].
  *
  * # Safety
- * - `service` must be a valid pointer.
- * - `name` must be a valid UTF-8 string.
- * - `schema` must be NULL, or a valid pointer to a service schema.
- * - `callback` must be a valid pointer to a service callback function, which must remain valid
- *   until the service is either unregistered or freed.
+ * `stats` must be a pointer returned by [`foxglove_latency_tracer_get_stats`], or null.
  */
-foxglove_error foxglove_service_create(struct foxglove_service **service,
-                                       struct foxglove_string name,
-                                       const struct foxglove_service_schema *schema,
-                                       const void *context,
-                                       void (*callback)(const void *context,
-                                                        const struct foxglove_service_request *request,
-                                                        struct foxglove_service_responder *responder));
+void foxglove_latency_stats_free(struct foxglove_latency_stats_snapshot *stats);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Frees a service that was never registered to a WebSocket server.
+ * Write the most recent samples to a file, in the Chrome trace event format.
+ *
+ * The file can be opened in Perfetto or `chrome://tracing`.
  *
  * # Safety
- * - `service` must be a valid pointer to a service allocated by `foxglove_service_create`. The
- *   service MUST NOT have been previously registered with a WebSocket server.
+ * `path` must be a valid UTF-8 string.
  */
-void foxglove_service_free(struct foxglove_service *service);
+foxglove_error foxglove_latency_tracer_write_chrome_trace(const struct foxglove_latency_tracer *tracer,
+                                                          struct foxglove_string path);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Overrides the default response encoding.
+ * Start the SDK stats publisher.
+ *
+ * On success, writes a non-null handle to `out_publisher`. On failure, returns an error
+ * code and `out_publisher` is left untouched.
+ *
+ * The returned handle must be freed by calling either
+ * [`foxglove_sdk_stats_publisher_stop`] (to abort the background task) or
+ * [`foxglove_sdk_stats_publisher_detach`] (to leave the background task running).
  *
  * # Safety
- * - `responder` must be a pointer to a `foxglove_service_responder` obtained via the
- *   `foxglove_service.handler` callback.
- * - `encoding` must be a valid UTF-8 string. This value is copied by this function.
+ * - `options` must be a valid pointer to a [`FoxgloveSdkStatsPublisherOptions`] struct.
+ * - `out_publisher` must be a valid, writable pointer to a `*mut FoxgloveSdkStatsPublisher`.
+ * - See the safety notes on [`FoxgloveSdkStatsPublisherOptions`].
  */
-foxglove_error foxglove_service_set_response_encoding(struct foxglove_service_responder *responder,
-                                                      struct foxglove_string encoding);
+foxglove_error foxglove_sdk_stats_publisher_start(const struct foxglove_sdk_stats_publisher_options *options,
+                                                  struct foxglove_sdk_stats_publisher **out_publisher);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Completes a request by sending response data to the client.
+ * Stop the SDK stats publisher and free its resources.
+ *
+ * This aborts the background task. After calling this function, the handle is invalid
+ * and must not be used again. Passing a null pointer is a no-op.
  *
  * # Safety
- * - `responder` must be a pointer to a `foxglove_service_responder` obtained via the
- *   `foxglove_service.handler` callback. This value is moved into this function, and must not
- *   accessed afterwards.
- * - `data` must be a pointer to the response data. This value is copied by this function.
+ * - `publisher`, when non-null, must be a handle returned by
+ *   [`foxglove_sdk_stats_publisher_start`] that has not already been passed to this
+ *   function.
  */
-void foxglove_service_respond_ok(struct foxglove_service_responder *responder,
-                                 struct foxglove_bytes data);
+foxglove_error foxglove_sdk_stats_publisher_stop(struct foxglove_sdk_stats_publisher *publisher);
 #endif
 
 #if !defined(__wasm__)
 /**
- * Completes a request by sending an error message to the client.
+ * Free the SDK stats publisher handle without stopping its background task.
+ *
+ * The background task continues to run until the process exits. After calling this
+ * function, the handle is invalid and must not be used again. Passing a null pointer
+ * is a no-op.
  *
  * # Safety
- * - `responder` must be a pointer to a `foxglove_service_responder` obtained via the
- *   `foxglove_service.handler` callback. This value is moved into this function, and must not
- *   accessed afterwards.
- * - `message` must be a valid UTF-8 string. This value is copied by this function.
+ * - `publisher`, when non-null, must be a handle returned by
+ *   [`foxglove_sdk_stats_publisher_start`] that has not already been passed to
+ *   either this function or [`foxglove_sdk_stats_publisher_stop`].
  */
-void foxglove_service_respond_error(struct foxglove_service_responder *responder,
-                                    struct foxglove_string message);
+foxglove_error foxglove_sdk_stats_publisher_detach(struct foxglove_sdk_stats_publisher *publisher);
 #endif
 
 #if !defined(__wasm__)
@@ -1,22 +1,177 @@
-use std::{ffi::c_void, fs::File, io::BufWriter, mem::ManuallyDrop, sync::Arc};
+use std::{ffi::c_void, fs::File, io::BufWriter, mem::ManuallyDrop, sync::Arc, time::Duration};
 
 use crate::{
     FoxgloveChannelMetadata, FoxgloveError, FoxgloveKeyValue, FoxgloveSchema, FoxgloveSinkId,
-    FoxgloveString, channel_descriptor::FoxgloveChannelDescriptor, result_to_c,
-    sink_channel_filter::ChannelFilter,
+    FoxgloveString,
+    bytes::FoxgloveBytes,
+    channel_descriptor::FoxgloveChannelDescriptor,
+    message_filter::{FoxgloveMessageFilterOutput, message_filter},
+    result_to_c,
+    sink_channel_filter::{FoxgloveTopicFilter, sink_channel_filter},
 };
 use mcap::{Compression, WriteOptions};
-use std::io::{Seek, SeekFrom, Write};
+use std::io::{Read, Seek, SeekFrom, Write};
 
 #[repr(u8)]
+#[derive(Clone, Copy)]
 pub enum FoxgloveMcapCompression {
     None,
     Zstd,
     Lz4,
 }
 
+impl From<FoxgloveMcapCompression> for Option<Compression> {
+    fn from(value: FoxgloveMcapCompression) -> Self {
+        match value {
+            FoxgloveMcapCompression::Zstd => Some(Compression::Zstd),
+            FoxgloveMcapCompression::Lz4 => Some(Compression::Lz4),
+            FoxgloveMcapCompression::None => None,
+        }
+    }
+}
+
+/// The compression of the chunks holding a channel's messages, chosen by the
+/// `compression_policy` callback of `FoxgloveMcapOptions`.
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub struct FoxgloveMcapChunkCompression {
+    pub compression: FoxgloveMcapCompression,
+    /// Compression level passed to the compressor. 0 uses the compressor's default level.
+    pub level: u32,
+}
+
+type CompressionPolicyCallback = unsafe extern "C" fn(
+    context: *const c_void,
+    channel: *const FoxgloveChannelDescriptor,
+    compression: *mut FoxgloveMcapChunkCompression,
+) -> bool;
+
+/// Adapts a C `compression_policy` callback to a [`foxglove::McapCompressionPolicy`].
+struct CompressionPolicy {
+    callback_context: *const c_void,
+    callback: CompressionPolicyCallback,
+}
+
+// Safety: the caller of `foxglove_mcap_open` guarantees that the callback and its context can be
+// used from any thread.
+unsafe impl Send for CompressionPolicy {}
+unsafe impl Sync for CompressionPolicy {}
+
+impl foxglove::McapCompressionPolicy for CompressionPolicy {
+    fn compression(
+        &self,
+        channel: &foxglove::ChannelDescriptor,
+    ) -> Option<foxglove::McapChunkCompression> {
+        let c_channel_descriptor = FoxgloveChannelDescriptor(channel.clone());
+        let mut compression = FoxgloveMcapChunkCompression {
+            compression: FoxgloveMcapCompression::None,
+            level: 0,
+        };
+        // Safety: the channel descriptor and compression are valid for the duration of the call.
+        let chosen = unsafe {
+            (self.callback)(
+                self.callback_context,
+                &raw const c_channel_descriptor,
+                &raw mut compression,
+            )
+        };
+        chosen.then(|| foxglove::McapChunkCompression {
+            compression: compression.compression.into(),
+            level: compression.level,
+        })
+    }
+}
+
+type ChannelGroupCallback =
+    unsafe extern "C" fn(context: *const c_void, channel: *const FoxgloveChannelDescriptor) -> u32;
+
+/// Adapts a C `channel_group` callback to a [`foxglove::McapChannelGrouping`].
+struct ChannelGrouping {
+    callback_context: *const c_void,
+    callback: ChannelGroupCallback,
+}
+
+// Safety: the caller of `foxglove_mcap_open` guarantees that the callback and its context can be
+// used from any thread.
+unsafe impl Send for ChannelGrouping {}
+unsafe impl Sync for ChannelGrouping {}
+
+impl foxglove::McapChannelGrouping for ChannelGrouping {
+    fn group(&self, channel: &foxglove::ChannelDescriptor) -> u32 {
+        let c_channel_descriptor = FoxgloveChannelDescriptor(channel.clone());
+        // Safety: the channel descriptor is valid for the duration of the call.
+        unsafe { (self.callback)(self.callback_context, &raw const c_channel_descriptor) }
+    }
+}
+
+/// What an asynchronous MCAP writer does when its queue is full.
+#[repr(u8)]
+#[derive(Clone, Copy)]
+pub enum FoxgloveMcapOverflowPolicy {
+    /// Block the logging thread until the writer thread makes room in the queue.
+    Block,
+    /// Drop the message being logged.
+    DropNewest,
+    /// Drop the oldest queued message to make room for the message being logged.
+    DropOldest,
+}
+
+impl From<FoxgloveMcapOverflowPolicy> for foxglove::McapOverflowPolicy {
+    fn from(value: FoxgloveMcapOverflowPolicy) -> Self {
+        match value {
+            FoxgloveMcapOverflowPolicy::Block => Self::Block,
+            FoxgloveMcapOverflowPolicy::DropNewest => Self::DropNewest,
+            FoxgloveMcapOverflowPolicy::DropOldest => Self::DropOldest,
+        }
+    }
+}
+
+/// Statistics for an MCAP writer.
+#[repr(C)]
+#[derive(Default)]
+pub struct FoxgloveMcapWriterStats {
+    /// Number of logged messages which have not been written yet.
+    pub queue_depth: usize,
+    /// Number of messages dropped because the queue was full.
+    pub dropped_messages: u64,
+}
+
+/// A buffer of MCAP output whose ownership is passed to a custom writer's `write_owned_fn`.
+///
+/// The receiver must call `release(release_context)` exactly once when it no longer needs `data`.
+/// The buffer may be released from any thread.
+#[repr(C)]
+pub struct FoxgloveMcapBuffer {
+    /// Pointer to the data
+    pub data: *const u8,
+    /// Number of bytes
+    pub len: usize,
+    /// Context to pass to `release`
+    pub release_context: *mut std::ffi::c_void,
+    /// Release function: free the buffer
+    pub release: unsafe extern "C" fn(release_context: *mut std::ffi::c_void),
+}
+
+impl FoxgloveMcapBuffer {
+    fn new(data: Vec<u8>) -> Self {
+        let data = Box::new(data);
+        Self {
+            data: data.as_ptr(),
+            len: data.len(),
+            release_context: Box::into_raw(data).cast(),
+            release: release_mcap_buffer,
+        }
+    }
+}
+
+unsafe extern "C" fn release_mcap_buffer(release_context: *mut std::ffi::c_void) {
+    drop(unsafe { Box::from_raw(release_context.cast::<Vec<u8>>()) });
+}
+
 /// Custom writer function pointers for MCAP writing.
-/// write_fn and flush_fn must be non-null. Seek_fn may be null iff `disable_seeking` is set to true.
+/// flush_fn and at least one of write_fn, writev_fn, and write_owned_fn must be non-null. If more
+/// than one write function is provided, write_owned_fn is preferred, then writev_fn.
+/// Seek_fn may be null iff `disable_seeking` is set to true.
 /// These function pointers may be called from multiple threads.
 /// These functions are called synchronously with respect to each other within the SDK, but these
 /// calls are not synchronized with other SDK function calls.
@@ -48,14 +203,130 @@ pub struct FoxgloveCustomWriter {
             new_pos: *mut u64,
         ) -> i32,
     >,
+    /// Vectored write function: write `iovcnt` buffers, in order, to the custom destination
+    /// Returns the total number of bytes written, or sets error on failure
+    ///
+    /// Small writes, such as record headers, are held back and passed alongside the next large
+    /// write, instead of being concatenated with it or written with separate calls.
+    pub writev_fn: Option<
+        unsafe extern "C" fn(
+            context: *mut std::ffi::c_void,
+            iov: *const FoxgloveBytes,
+            iovcnt: usize,
+            error: *mut i32,
+        ) -> usize,
+    >,
+    /// Owned write function: take ownership of a buffer and write all of it to the custom
+    /// destination
+    /// Returns 0 on success, or an error number defined in errno.h on failure
+    ///
+    /// Output is handed over in blocks, each containing at least one whole record, so that
+    /// compressed chunks arrive in a single buffer. The callee owns the buffer even if it returns
+    /// an error, and must release it as described by `FoxgloveMcapBuffer`.
+    pub write_owned_fn: Option<
+        unsafe extern "C" fn(context: *mut std::ffi::c_void, buffer: FoxgloveMcapBuffer) -> i32,
+    >,
 }
 
+/// Writes smaller than this are held back in vectored and owned modes.
+const CUSTOM_WRITER_STAGING_SIZE: usize = 16 * 1024;
+
 struct CustomWriter {
     callbacks: FoxgloveCustomWriter,
+    // Data held back to be passed alongside later writes, in vectored and owned modes.
+    pending: Vec<u8>,
+}
+
+impl CustomWriter {
+    fn new(callbacks: FoxgloveCustomWriter) -> Self {
+        Self {
+            callbacks,
+            pending: Vec::new(),
+        }
+    }
+
+    fn writev(&self, iov: &[FoxgloveBytes]) -> std::io::Result<usize> {
+        let writev_fn = self
+            .callbacks
+            .writev_fn
+            .expect("writev_fn checked by caller");
+        let mut error = 0;
+        let written = unsafe {
+            writev_fn(
+                self.callbacks.context,
+                iov.as_ptr(),
+                iov.len(),
+                &raw mut error,
+            )
+        };
+        if error != 0 {
+            return Err(std::io::Error::from_raw_os_error(error));
+        }
+        Ok(written)
+    }
+
+    fn write_owned(&mut self) -> std::io::Result<()> {
+        let write_owned_fn = self
+            .callbacks
+            .write_owned_fn
+            .expect("write_owned_fn checked by caller");
+        let buffer = FoxgloveMcapBuffer::new(std::mem::take(&mut self.pending));
+        let error = unsafe { write_owned_fn(self.callbacks.context, buffer) };
+        if error != 0 {
+            return Err(std::io::Error::from_raw_os_error(error));
+        }
+        Ok(())
+    }
+
+    /// Writes any data held back by previous writes.
+    fn write_pending(&mut self) -> std::io::Result<()> {
+        if self.pending.is_empty() {
+            return Ok(());
+        }
+        if self.callbacks.write_owned_fn.is_some() {
+            return self.write_owned();
+        }
+        while !self.pending.is_empty() {
+            let written = self.writev(&[FoxgloveBytes::from(self.pending.as_slice())])?;
+            if written == 0 {
+                return Err(std::io::ErrorKind::WriteZero.into());
+            }
+            self.pending.drain(..written.min(self.pending.len()));
+        }
+        Ok(())
+    }
 }
 
 impl Write for CustomWriter {
     fn write(&mut self, buf: &[u8]) -> std::io::Result<usize> {
+        if self.callbacks.write_owned_fn.is_some() {
+            self.pending.reserve_exact(buf.len());
+            self.pending.extend_from_slice(buf);
+            if self.pending.len() >= CUSTOM_WRITER_STAGING_SIZE {
+                self.write_owned()?;
+            }
+            return Ok(buf.len());
+        }
+
+        if self.callbacks.writev_fn.is_some() {
+            if buf.len() < CUSTOM_WRITER_STAGING_SIZE {
+                self.pending.extend_from_slice(buf);
+                return Ok(buf.len());
+            }
+            let staged = self.pending.len();
+            let written = self.writev(&[
+                FoxgloveBytes::from(self.pending.as_slice()),
+                FoxgloveBytes::from(buf),
+            ])?;
+            if written > staged {
+                self.pending.clear();
+                return Ok(written - staged);
+            }
+            self.pending.drain(..written);
+            self.write_pending()?;
+            return self.writev(&[FoxgloveBytes::from(buf)]);
+        }
+
         let write_fn = self
             .callbacks
             .write_fn
@@ -79,6 +350,8 @@ impl Write for CustomWriter {
     }
 
     fn flush(&mut self) -> std::io::Result<()> {
+        self.write_pending()?;
+
         let flush_fn = self
             .callbacks
             .flush_fn
@@ -95,6 +368,8 @@ impl Write for CustomWriter {
 
 impl Seek for CustomWriter {
     fn seek(&mut self, pos: SeekFrom) -> std::io::Result<u64> {
+        self.write_pending()?;
+
         let seek_fn = self
             .callbacks
             .seek_fn
@@ -117,6 +392,20 @@ impl Seek for CustomWriter {
     }
 }
 
+impl Drop for CustomWriter {
+    fn drop(&mut self) {
+        if let Err(e) = self.write_pending() {
+            tracing::warn!("Failed to write buffered MCAP data: {e}");
+        }
+    }
+}
+
+/// Placeholder in the path template of a rotating MCAP writer, replaced by the segment number.
+const SEGMENT_INDEX_PLACEHOLDER: &str = "{index}";
+
+/// Suffix appended to an MCAP file's path to name its checkpoint journal.
+const CHECKPOINT_JOURNAL_SUFFIX: &str = ".checkpoint";
+
 /// Sentinel value for `compression_threads` indicating the default behavior
 /// of using the number of physical CPUs.
 pub const FOXGLOVE_MCAP_COMPRESSION_THREADS_DEFAULT: u32 = u32::MAX;
@@ -174,6 +463,133 @@ pub struct FoxgloveMcapOptions {
             channel: *const FoxgloveChannelDescriptor,
         ) -> bool,
     >,
+    /// Optional topic filter, created via `foxglove_topic_filter_create`.
+    ///
+    /// The filter is evaluated without calling into C, and its result is cached per channel. If
+    /// `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+    /// filter. The sink holds its own reference to the filter.
+    pub topic_filter: *const FoxgloveTopicFilter,
+    /// Context provided to the `message_filter` callback.
+    pub message_filter_context: *const c_void,
+    /// A filter which runs on each message before it is written, so that the file can record
+    /// channels with a different policy than other sinks in the same context.
+    ///
+    /// Return false to drop the message, or true to write it. To write a different message
+    /// instead, for example a cropped or downsampled copy, pass it to
+    /// `foxglove_message_filter_output_replace` and return true. The message data is only valid
+    /// for the duration of the callback.
+    ///
+    /// The callback is invoked on the thread which logs the message, and must not block.
+    ///
+    /// # Safety
+    /// - If provided, the callback must remain valid until the MCAP writer is closed, and may be
+    ///   called from any thread.
+    pub message_filter: Option<
+        unsafe extern "C" fn(
+            context: *const c_void,
+            channel: *const FoxgloveChannelDescriptor,
+            data: *const u8,
+            data_len: usize,
+            log_time: u64,
+            output: *mut FoxgloveMessageFilterOutput,
+        ) -> bool,
+    >,
+    /// If true, messages are queued and written on a dedicated background thread, so that
+    /// compression and I/O do not block the logging thread.
+    pub async_writes: bool,
+    /// Maximum number of messages waiting to be written when `async_writes` is true.
+    pub async_queue_capacity: usize,
+    /// What to do when a message is logged while the queue is full, if `async_writes` is true.
+    pub async_overflow_policy: FoxgloveMcapOverflowPolicy,
+    /// If non-zero, completed chunks are written by a dedicated I/O thread, so that the next
+    /// chunk can be compressed while earlier ones are written. This is the maximum number of
+    /// blocks of output queued for the I/O thread before writes block.
+    pub pipeline_depth: usize,
+    /// If non-zero, the recording is split into segments, and a new segment is started once
+    /// this many bytes have been written to the current one.
+    ///
+    /// When rotation is enabled, `path` is a template which must contain `{index}`, which is
+    /// replaced by the segment number starting from 0. Rotation is not supported with
+    /// `custom_writer`.
+    pub rotation_max_bytes: u64,
+    /// If non-zero, the recording is split into segments, and a new segment is started once the
+    /// current one has been open for this many milliseconds. See `rotation_max_bytes`.
+    pub rotation_max_duration_ms: u64,
+    /// If true, the file at `path` is opened with `O_DIRECT` and written in large aligned blocks,
+    /// bypassing the page cache. This requires `disable_seeking`, and is only supported on Linux.
+    pub direct_io: bool,
+    /// If non-zero, the current chunk is finished and flushed at least this often, so that if the
+    /// process exits without closing the writer, `foxglove_mcap_recover` can make the file
+    /// readable with at most this many milliseconds of messages lost.
+    ///
+    /// When writing to `path` without rotation, schemas and channels are also recorded in a
+    /// journal at `path` with `.checkpoint` appended, which is removed when the writer is closed.
+    pub checkpoint_interval_ms: u64,
+    /// Context provided to the `compression_policy` callback.
+    pub compression_policy_context: *const c_void,
+    /// Chooses the compression of the chunks holding each channel's messages, so that, for
+    /// example, already-compressed video is not compressed again. Channels with different
+    /// compression are written to separately compressed streams of chunks in the same file.
+    ///
+    /// Return true after setting `*compression` to choose the channel's compression, or false
+    /// to use `compression` and `compression_level`. The callback is invoked once per channel,
+    /// when the first message is logged to it, and must not block.
+    ///
+    /// # Safety
+    /// - If provided, the callback must remain valid until the MCAP writer is closed, and may be
+    ///   called from any thread.
+    pub compression_policy: Option<
+        unsafe extern "C" fn(
+            context: *const c_void,
+            channel: *const FoxgloveChannelDescriptor,
+            compression: *mut FoxgloveMcapChunkCompression,
+        ) -> bool,
+    >,
+    /// If non-zero, a zstd dictionary is trained for each schema from this many of its first
+    /// messages, stored in an attachment, and used to compress later chunks holding the
+    /// schema's messages. This keeps compression ratios high with a small `chunk_size`.
+    ///
+    /// Only readers which load the dictionaries from the file's attachments can decompress the
+    /// dictionary-compressed chunks.
+    pub zstd_dictionary_training_messages: usize,
+    /// Maximum size of each zstd dictionary, in bytes. 0 uses the default size.
+    pub zstd_dictionary_max_size: usize,
+    /// Compression level for chunks compressed with a zstd dictionary. 0 uses zstd's default
+    /// level.
+    pub zstd_dictionary_level: u32,
+    /// If non-zero, disk space for the file at `path` is reserved in extents of this many bytes
+    /// with `fallocate` as the file grows, and unused space is released when the writer is
+    /// closed. This avoids fragmenting long recordings and stalling writes on block allocation.
+    ///
+    /// Not supported with `direct_io`, and only supported on Linux.
+    pub preallocate_bytes: u64,
+    /// If non-zero, message indexes are sparse: each channel's index for a chunk keeps its first
+    /// message, and then one message at least every this many messages.
+    ///
+    /// Readers which only read the messages listed in message indexes miss the others. Readers
+    /// which read whole chunks, or scan forward from an indexed message, are unaffected.
+    pub sparse_index_every_messages: u64,
+    /// If non-zero, message indexes are sparse, and keep one message at least every this many
+    /// nanoseconds of log time. See `sparse_index_every_messages`.
+    pub sparse_index_every_ns: u64,
+    /// Context provided to the `channel_group` callback.
+    pub channel_group_context: *const c_void,
+    /// Chooses the group of chunks holding each channel's messages. Each group is written to a
+    /// separate stream of chunks in the same file, so each chunk only holds messages from one
+    /// group, and readers which select a few topics only decompress the chunks of their groups.
+    ///
+    /// Channels in group 0 share the writer's default chunks. The callback is invoked once per
+    /// channel, when the first message is logged to it, and must not block.
+    ///
+    /// # Safety
+    /// - If provided, the callback must remain valid until the MCAP writer is closed, and may be
+    ///   called from any thread.
+    pub channel_group: Option<
+        unsafe extern "C" fn(
+            context: *const c_void,
+            channel: *const FoxgloveChannelDescriptor,
+        ) -> u32,
+    >,
 }
 
 impl FoxgloveMcapOptions {
@@ -181,15 +597,9 @@ impl FoxgloveMcapOptions {
         let profile = unsafe { self.profile.as_utf8_str() }
             .map_err(|e| foxglove::FoxgloveError::ValueError(format!("profile is invalid: {e}")))?;
 
-        let compression = match self.compression {
-            FoxgloveMcapCompression::Zstd => Some(Compression::Zstd),
-            FoxgloveMcapCompression::Lz4 => Some(Compression::Lz4),
-            _ => None,
-        };
-
         let mut opts = WriteOptions::default()
             .profile(profile)
-            .compression(compression)
+            .compression(self.compression.into())
             .chunk_size(if self.chunk_size > 0 {
                 Some(self.chunk_size)
             } else {
@@ -215,6 +625,17 @@ impl FoxgloveMcapOptions {
         }
         Ok(opts)
     }
+
+    fn rotation(&self) -> Option<foxglove::McapRotation> {
+        if self.rotation_max_bytes == 0 && self.rotation_max_duration_ms == 0 {
+            return None;
+        }
+        Some(foxglove::McapRotation {
+            max_bytes: (self.rotation_max_bytes > 0).then_some(self.rotation_max_bytes),
+            max_duration: (self.rotation_max_duration_ms > 0)
+                .then(|| Duration::from_millis(self.rotation_max_duration_ms)),
+        })
+    }
 }
 
 /// Returns a `FoxgloveMcapOptions` with defaults matching `mcap::WriteOptions::default()`.
@@ -248,6 +669,27 @@ pub extern "C" fn foxglove_mcap_options_default() -> FoxgloveMcapOptions {
         compression_threads: FOXGLOVE_MCAP_COMPRESSION_THREADS_DEFAULT,
         sink_channel_filter_context: std::ptr::null(),
         sink_channel_filter: None,
+        topic_filter: std::ptr::null(),
+        message_filter_context: std::ptr::null(),
+        message_filter: None,
+        async_writes: false,
+        async_queue_capacity: foxglove::McapAsyncOptions::default().queue_capacity,
+        async_overflow_policy: FoxgloveMcapOverflowPolicy::Block,
+        pipeline_depth: 0,
+        rotation_max_bytes: 0,
+        rotation_max_duration_ms: 0,
+        direct_io: false,
+        checkpoint_interval_ms: 0,
+        compression_policy_context: std::ptr::null(),
+        compression_policy: None,
+        zstd_dictionary_training_messages: 0,
+        zstd_dictionary_max_size: 0,
+        zstd_dictionary_level: 0,
+        preallocate_bytes: 0,
+        sparse_index_every_messages: 0,
+        sparse_index_every_ns: 0,
+        channel_group_context: std::ptr::null(),
+        channel_group: None,
     }
 }
 
@@ -257,6 +699,10 @@ unsafe impl Send for CustomWriter {}
 
 enum McapWriterVariant {
     File(foxglove::McapWriterHandle<BufWriter<File>>),
+    #[cfg(target_os = "linux")]
+    Direct(foxglove::McapWriterHandle<foxglove::McapDirectFile>),
+    #[cfg(target_os = "linux")]
+    Preallocated(foxglove::McapWriterHandle<BufWriter<foxglove::McapPreallocatedFile>>),
     Custom(foxglove::McapWriterHandle<CustomWriter>),
 }
 
@@ -276,6 +722,10 @@ impl McapWriterVariant {
     ) -> Result<(), foxglove::FoxgloveError> {
         match self {
             McapWriterVariant::File(writer) => writer.write_metadata(name, metadata),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Direct(writer) => writer.write_metadata(name, metadata),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Preallocated(writer) => writer.write_metadata(name, metadata),
             McapWriterVariant::Custom(writer) => writer.write_metadata(name, metadata),
         }
     }
@@ -283,16 +733,62 @@ impl McapWriterVariant {
     fn attach(&self, attachment: &mcap::Attachment<'_>) -> Result<(), foxglove::FoxgloveError> {
         match self {
             McapWriterVariant::File(writer) => writer.attach(attachment),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Direct(writer) => writer.attach(attachment),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Preallocated(writer) => writer.attach(attachment),
             McapWriterVariant::Custom(writer) => writer.attach(attachment),
         }
     }
 
+    fn attach_reader(
+        &self,
+        header: &foxglove::McapAttachmentHeader,
+        length: u64,
+        data: impl Read,
+    ) -> Result<(), foxglove::FoxgloveError> {
+        match self {
+            McapWriterVariant::File(writer) => writer.attach_reader(header, length, data),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Direct(writer) => writer.attach_reader(header, length, data),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Preallocated(writer) => writer.attach_reader(header, length, data),
+            McapWriterVariant::Custom(writer) => writer.attach_reader(header, length, data),
+        }
+    }
+
     fn flush(&self) -> Result<(), foxglove::FoxgloveError> {
         match self {
             McapWriterVariant::File(writer) => writer.flush(),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Direct(writer) => writer.flush(),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Preallocated(writer) => writer.flush(),
             McapWriterVariant::Custom(writer) => writer.flush(),
         }
     }
+
+    fn stats(&self) -> foxglove::McapWriterStats {
+        match self {
+            McapWriterVariant::File(writer) => writer.stats(),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Direct(writer) => writer.stats(),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Preallocated(writer) => writer.stats(),
+            McapWriterVariant::Custom(writer) => writer.stats(),
+        }
+    }
+
+    fn sink_id(&self) -> foxglove::SinkId {
+        match self {
+            McapWriterVariant::File(writer) => writer.sink_id(),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Direct(writer) => writer.sink_id(),
+            #[cfg(target_os = "linux")]
+            McapWriterVariant::Preallocated(writer) => writer.sink_id(),
+            McapWriterVariant::Custom(writer) => writer.sink_id(),
+        }
+    }
 }
 
 /// An MCAP attachment to store in an MCAP file.
@@ -317,6 +813,50 @@ pub struct FoxgloveMcapAttachment {
     pub data_len: usize,
 }
 
+impl FoxgloveMcapAttachment {
+    /// Returns the attachment's fields other than its data.
+    ///
+    /// # Safety
+    /// The `name` and `media_type` fields must be valid UTF-8 strings.
+    unsafe fn header(&self) -> Result<foxglove::McapAttachmentHeader, foxglove::FoxgloveError> {
+        let name = unsafe { self.name.as_utf8_str() }.map_err(|e| {
+            foxglove::FoxgloveError::Utf8Error(format!("attachment name is invalid: {e}"))
+        })?;
+        let media_type = unsafe { self.media_type.as_utf8_str() }.map_err(|e| {
+            foxglove::FoxgloveError::Utf8Error(format!("attachment media_type is invalid: {e}"))
+        })?;
+        Ok(foxglove::McapAttachmentHeader {
+            log_time: self.log_time,
+            create_time: self.create_time,
+            name: name.to_string(),
+            media_type: media_type.to_string(),
+        })
+    }
+}
+
+/// Reads streamed attachment data with the callback passed to `foxglove_mcap_attach_stream`.
+struct AttachmentReader {
+    read: unsafe extern "C" fn(
+        context: *mut c_void,
+        buffer: *mut u8,
+        len: usize,
+        error: *mut i32,
+    ) -> usize,
+    context: *mut c_void,
+}
+
+impl Read for AttachmentReader {
+    fn read(&mut self, buf: &mut [u8]) -> std::io::Result<usize> {
+        let mut error = 0;
+        let read =
+            unsafe { (self.read)(self.context, buf.as_mut_ptr(), buf.len(), &raw mut error) };
+        if error != 0 {
+            return Err(std::io::Error::from_raw_os_error(error));
+        }
+        Ok(read.min(buf.len()))
+    }
+}
+
 /// Create or open an MCAP writer for writing to a file or custom destination.
 /// Resources must later be freed with `foxglove_mcap_close`.
 ///
@@ -351,6 +891,51 @@ unsafe fn do_foxglove_mcap_open(
     let mcap_options = unsafe { options.to_write_options() }?;
 
     let mut builder = foxglove::McapWriter::with_options(mcap_options);
+    if options.pipeline_depth > 0 {
+        builder = builder.pipeline_depth(options.pipeline_depth);
+    }
+    if options.async_writes {
+        builder = builder.async_writes(foxglove::McapAsyncOptions {
+            queue_capacity: options.async_queue_capacity,
+            overflow_policy: options.async_overflow_policy.into(),
+        });
+    }
+    if options.checkpoint_interval_ms > 0 {
+        builder =
+            builder.checkpoint_interval(Duration::from_millis(options.checkpoint_interval_ms));
+    }
+    if let Some(callback) = options.compression_policy {
+        builder = builder.compression_policy(Arc::new(CompressionPolicy {
+            callback_context: options.compression_policy_context,
+            callback,
+        }));
+    }
+    if let Some(callback) = options.channel_group {
+        builder = builder.channel_grouping(Arc::new(ChannelGrouping {
+            callback_context: options.channel_group_context,
+            callback,
+        }));
+    }
+    if options.zstd_dictionary_training_messages > 0 {
+        let mut dictionary = foxglove::McapZstdDictionary {
+            training_messages: options.zstd_dictionary_training_messages,
+            level: options.zstd_dictionary_level,
+            ..Default::default()
+        };
+        if options.zstd_dictionary_max_size > 0 {
+            dictionary.max_size = options.zstd_dictionary_max_size;
+        }
+        builder = builder.zstd_dictionary(dictionary);
+    }
+    if options.sparse_index_every_messages > 0 || options.sparse_index_every_ns > 0 {
+        builder = builder.sparse_message_index(foxglove::McapSparseIndex {
+            every_messages: options.sparse_index_every_messages,
+            every_nanos: options.sparse_index_every_ns,
+        });
+    }
+    if let Some(filter) = message_filter(options.message_filter_context, options.message_filter) {
+        builder = builder.message_filter(filter);
+    }
     if !context.is_null() {
         let context = ManuallyDrop::new(unsafe { Arc::from_raw(context) });
         builder = builder.context(&context);
@@ -364,15 +949,25 @@ unsafe fn do_foxglove_mcap_open(
                 "seek_fn is null but disable_seeking is false".to_string(),
             ));
         }
-        if custom_writer_callbacks.write_fn.is_none() || custom_writer_callbacks.flush_fn.is_none()
+        if custom_writer_callbacks.write_fn.is_none()
+            && custom_writer_callbacks.writev_fn.is_none()
+            && custom_writer_callbacks.write_owned_fn.is_none()
         {
             return Err(foxglove::FoxgloveError::ValueError(
-                "write_fn and flush_fn must be provided".to_string(),
+                "one of write_fn, writev_fn, or write_owned_fn must be provided".to_string(),
             ));
         }
-        let custom_writer = CustomWriter {
-            callbacks: custom_writer_callbacks,
-        };
+        if custom_writer_callbacks.flush_fn.is_none() {
+            return Err(foxglove::FoxgloveError::ValueError(
+                "flush_fn must be provided".to_string(),
+            ));
+        }
+        if options.rotation().is_some() {
+            return Err(foxglove::FoxgloveError::ValueError(
+                "rotation is not supported with custom_writer".to_string(),
+            ));
+        }
+        let custom_writer = CustomWriter::new(custom_writer_callbacks);
 
         let writer = builder.create(custom_writer)?;
 
@@ -388,24 +983,48 @@ unsafe fn do_foxglove_mcap_open(
             ));
         }
 
-        let mut file_options = File::options();
-        if options.truncate {
-            file_options.create(true).truncate(true);
-        } else {
-            file_options.create_new(true);
-        }
-        let file = file_options
-            .write(true)
-            .open(path)
-            .map_err(foxglove::FoxgloveError::IoError)?;
-        if let Some(sink_channel_filter) = options.sink_channel_filter {
-            builder = builder.channel_filter(Arc::new(ChannelFilter::new(
+        if let Some(filter) = unsafe {
+            sink_channel_filter(
                 options.sink_channel_filter_context,
-                sink_channel_filter,
-            )));
+                options.sink_channel_filter,
+                options.topic_filter,
+            )
+        } {
+            builder = builder.channel_filter(filter);
+        }
+        let rotation = options.rotation();
+        let truncate = options.truncate;
+        if options.checkpoint_interval_ms > 0 && rotation.is_none() {
+            builder = builder.checkpoint_journal(format!("{path}{CHECKPOINT_JOURNAL_SUFFIX}"));
+        }
+        if options.direct_io {
+            if options.preallocate_bytes > 0 {
+                return Err(foxglove::FoxgloveError::ValueError(
+                    "preallocate_bytes is not supported with direct_io".to_string(),
+                ));
+            }
+            open_direct_file_writer(builder, path, rotation, truncate, options.disable_seeking)?
+        } else if options.preallocate_bytes > 0 {
+            open_preallocated_file_writer(
+                builder,
+                path,
+                rotation,
+                truncate,
+                options.preallocate_bytes,
+            )?
+        } else {
+            let mut file_options = File::options();
+            if truncate {
+                file_options.create(true).truncate(true);
+            } else {
+                file_options.create_new(true);
+            }
+            file_options.write(true);
+            let writer = create_file_writer(builder, path, rotation, move |path| {
+                Ok(BufWriter::new(file_options.open(path)?))
+            })?;
+            McapWriterVariant::File(writer)
         }
-        let writer = builder.create(BufWriter::new(file))?;
-        McapWriterVariant::File(writer)
     };
 
     // We can avoid this double indirection if we refactor McapWriterHandle to move the context into the Arc
@@ -416,6 +1035,101 @@ unsafe fn do_foxglove_mcap_open(
     )))))
 }
 
+/// Creates a writer for `path`, or for segments named by the template `path` if rotation is
+/// enabled.
+fn create_file_writer<W>(
+    builder: foxglove::McapWriter,
+    path: &str,
+    rotation: Option<foxglove::McapRotation>,
+    mut open: impl FnMut(&str) -> std::io::Result<W> + Send + 'static,
+) -> Result<foxglove::McapWriterHandle<W>, foxglove::FoxgloveError>
+where
+    W: Write + Seek + Send + 'static,
+{
+    let Some(rotation) = rotation else {
+        let writer = open(path).map_err(foxglove::FoxgloveError::IoError)?;
+        return builder.create(writer);
+    };
+    if !path.contains(SEGMENT_INDEX_PLACEHOLDER) {
+        return Err(foxglove::FoxgloveError::ValueError(format!(
+            "path must contain {SEGMENT_INDEX_PLACEHOLDER} when rotation is enabled"
+        )));
+    }
+    let template = path.to_string();
+    builder.rotation(rotation).create_rotating(move |index| {
+        let path = template.replace(SEGMENT_INDEX_PLACEHOLDER, &index.to_string());
+        Ok(open(&path)?)
+    })
+}
+
+#[cfg(target_os = "linux")]
+fn open_direct_file_writer(
+    builder: foxglove::McapWriter,
+    path: &str,
+    rotation: Option<foxglove::McapRotation>,
+    truncate: bool,
+    disable_seeking: bool,
+) -> Result<McapWriterVariant, foxglove::FoxgloveError> {
+    if !disable_seeking {
+        return Err(foxglove::FoxgloveError::ValueError(
+            "direct_io requires disable_seeking".to_string(),
+        ));
+    }
+    let writer = create_file_writer(builder, path, rotation, move |path| {
+        if truncate {
+            foxglove::McapDirectFile::create(path)
+        } else {
+            foxglove::McapDirectFile::create_new(path)
+        }
+    })?;
+    Ok(McapWriterVariant::Direct(writer))
+}
+
+#[cfg(not(target_os = "linux"))]
+fn open_direct_file_writer(
+    _builder: foxglove::McapWriter,
+    _path: &str,
+    _rotation: Option<foxglove::McapRotation>,
+    _truncate: bool,
+    _disable_seeking: bool,
+) -> Result<McapWriterVariant, foxglove::FoxgloveError> {
+    Err(foxglove::FoxgloveError::ValueError(
+        "direct_io is only supported on Linux".to_string(),
+    ))
+}
+
+#[cfg(target_os = "linux")]
+fn open_preallocated_file_writer(
+    builder: foxglove::McapWriter,
+    path: &str,
+    rotation: Option<foxglove::McapRotation>,
+    truncate: bool,
+    extent_size: u64,
+) -> Result<McapWriterVariant, foxglove::FoxgloveError> {
+    let writer = create_file_writer(builder, path, rotation, move |path| {
+        let file = if truncate {
+            foxglove::McapPreallocatedFile::create(path, extent_size)?
+        } else {
+            foxglove::McapPreallocatedFile::create_new(path, extent_size)?
+        };
+        Ok(BufWriter::new(file))
+    })?;
+    Ok(McapWriterVariant::Preallocated(writer))
+}
+
+#[cfg(not(target_os = "linux"))]
+fn open_preallocated_file_writer(
+    _builder: foxglove::McapWriter,
+    _path: &str,
+    _rotation: Option<foxglove::McapRotation>,
+    _truncate: bool,
+    _extent_size: u64,
+) -> Result<McapWriterVariant, foxglove::FoxgloveError> {
+    Err(foxglove::FoxgloveError::ValueError(
+        "preallocate_bytes is only supported on Linux".to_string(),
+    ))
+}
+
 /// Close an MCAP file writer created via `foxglove_mcap_open`.
 ///
 /// Returns 0 on success, or returns a FoxgloveError code on error.
@@ -439,6 +1153,10 @@ pub unsafe extern "C" fn foxglove_mcap_close(
 
     let result = match writer_variant {
         McapWriterVariant::File(writer) => writer.close().map(|_| ()),
+        #[cfg(target_os = "linux")]
+        McapWriterVariant::Direct(writer) => writer.close().map(|_| ()),
+        #[cfg(target_os = "linux")]
+        McapWriterVariant::Preallocated(writer) => writer.close().map(|_| ()),
         McapWriterVariant::Custom(writer) => writer.close().map(|_| ()),
     };
 
@@ -475,6 +1193,47 @@ pub unsafe extern "C" fn foxglove_mcap_flush(
     }
 }
 
+/// Get the queue depth and number of dropped messages of an MCAP writer.
+///
+/// Both are always zero unless the writer was opened with `async_writes` set.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
+/// `stats` must be a valid pointer to a `FoxgloveMcapWriterStats`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_get_stats(
+    writer: Option<&FoxgloveMcapWriter>,
+    stats: Option<&mut FoxgloveMcapWriterStats>,
+) -> FoxgloveError {
+    let (Some(writer), Some(stats)) = (writer, stats) else {
+        tracing::error!("foxglove_mcap_get_stats called with null writer or stats");
+        return FoxgloveError::ValueError;
+    };
+    let Some(writer_handle) = writer.0.as_ref() else {
+        return FoxgloveError::SinkClosed;
+    };
+    let writer_stats = writer_handle.stats();
+    *stats = FoxgloveMcapWriterStats {
+        queue_depth: writer_stats.queue_depth,
+        dropped_messages: writer_stats.dropped_messages,
+    };
+    FoxgloveError::Ok
+}
+
+/// Get the sink ID of an MCAP writer.
+///
+/// Messages logged with this sink ID are written only to this writer's file.
+///
+/// Returns 0 if the writer pointer is null or the writer has been closed.
+#[unsafe(no_mangle)]
+pub extern "C" fn foxglove_mcap_sink_id(writer: Option<&FoxgloveMcapWriter>) -> FoxgloveSinkId {
+    writer
+        .and_then(|writer| writer.0.as_ref())
+        .map_or(0, |writer| writer.sink_id().into())
+}
+
 /// Write metadata to an MCAP file.
 ///
 /// Metadata consists of key-value string pairs associated with a name.
@@ -570,13 +1329,7 @@ unsafe fn do_foxglove_mcap_attach(
     writer: &mut FoxgloveMcapWriter,
     attachment: &FoxgloveMcapAttachment,
 ) -> Result<(), foxglove::FoxgloveError> {
-    let name = unsafe { attachment.name.as_utf8_str() }.map_err(|e| {
-        foxglove::FoxgloveError::Utf8Error(format!("attachment name is invalid: {e}"))
-    })?;
-
-    let media_type = unsafe { attachment.media_type.as_utf8_str() }.map_err(|e| {
-        foxglove::FoxgloveError::Utf8Error(format!("attachment media_type is invalid: {e}"))
-    })?;
+    let header = unsafe { attachment.header() }?;
 
     let Some(writer_handle) = writer.0.as_ref() else {
         return Err(foxglove::FoxgloveError::SinkClosed);
@@ -595,16 +1348,102 @@ unsafe fn do_foxglove_mcap_attach(
     };
 
     let mcap_attachment = mcap::Attachment {
-        log_time: attachment.log_time,
-        create_time: attachment.create_time,
-        name: name.to_string(),
-        media_type: media_type.to_string(),
+        log_time: header.log_time,
+        create_time: header.create_time,
+        name: header.name,
+        media_type: header.media_type,
         data: std::borrow::Cow::Borrowed(data),
     };
 
     writer_handle.attach(&mcap_attachment)
 }
 
+/// Write an attachment to an MCAP file, reading its data with a callback.
+///
+/// The data is copied to the file in blocks as it is read, so large attachments never need to
+/// be held in memory. `attachment.data` must be null, and `attachment.data_len` is the number of
+/// bytes to read. Messages logged while the data is copied wait until the attachment has been
+/// written.
+///
+/// `read` is called repeatedly with a buffer of `len` bytes, and returns the number of bytes it
+/// stored in the buffer, or 0 at the end of the data. On failure, it sets `error` to a non-zero
+/// errno value. If `read` fails or the data ends early, the rest of the attachment is filled
+/// with zeros so that the file remains valid, and an error is returned.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `writer` must be a valid pointer to a `FoxgloveMcapWriter` created via `foxglove_mcap_open`.
+/// `attachment` must be a valid pointer to a `FoxgloveMcapAttachment`.
+/// The `name` and `media_type` fields of the attachment must be valid UTF-8 strings.
+/// `read` is only called before this function returns, on the calling thread, with `context`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_attach_stream(
+    writer: Option<&mut FoxgloveMcapWriter>,
+    attachment: &FoxgloveMcapAttachment,
+    read: Option<
+        unsafe extern "C" fn(
+            context: *mut c_void,
+            buffer: *mut u8,
+            len: usize,
+            error: *mut i32,
+        ) -> usize,
+    >,
+    context: *mut c_void,
+) -> FoxgloveError {
+    let Some(writer) = writer else {
+        tracing::error!("foxglove_mcap_attach_stream called with null writer");
+        return FoxgloveError::ValueError;
+    };
+    let Some(read) = read else {
+        tracing::error!("foxglove_mcap_attach_stream called with null read callback");
+        return FoxgloveError::ValueError;
+    };
+
+    let result = unsafe { attachment.header() }.and_then(|header| {
+        if !attachment.data.is_null() {
+            return Err(foxglove::FoxgloveError::ValueError(
+                "attachment data must be null when streaming".to_string(),
+            ));
+        }
+        let Some(writer_handle) = writer.0.as_ref() else {
+            return Err(foxglove::FoxgloveError::SinkClosed);
+        };
+        let reader = AttachmentReader { read, context };
+        writer_handle.attach_reader(&header, attachment.data_len as u64, reader)
+    });
+    match result {
+        Ok(()) => FoxgloveError::Ok,
+        Err(e) => {
+            tracing::error!("foxglove_mcap_attach_stream failed: {e}");
+            e.into()
+        }
+    }
+}
+
+/// Rebuild the summary of an MCAP file whose writer was not closed, for example because the
+/// process exited while recording.
+///
+/// The file is truncated after its last complete record, and a summary is appended, so it can be
+/// read without scanning. This reads only record headers, and not the contents of chunks, if the
+/// file was written with `checkpoint_interval_ms` set. Files which were closed normally are left
+/// unchanged.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `path` must be a valid UTF-8 string.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_recover(path: &FoxgloveString) -> FoxgloveError {
+    let result = unsafe { path.as_utf8_str() }
+        .map_err(|e| foxglove::FoxgloveError::Utf8Error(format!("path is invalid: {e}")))
+        .and_then(foxglove::recover_mcap);
+    match result {
+        Ok(()) => FoxgloveError::Ok,
+        Err(e) => e.into(),
+    }
+}
+
 pub struct FoxgloveChannel(foxglove::RawChannel);
 
 /// Create a new channel. The channel must later be freed with `foxglove_channel_free`.
@@ -647,6 +1486,104 @@ unsafe fn do_foxglove_raw_channel_create(
     context: *const FoxgloveContext,
     metadata: *const FoxgloveChannelMetadata,
 ) -> Result<*const FoxgloveChannel, foxglove::FoxgloveError> {
+    unsafe { raw_channel_builder(topic, message_encoding, schema, context, metadata) }?
+        .build_raw()
+        .map(|raw_channel| Arc::into_raw(raw_channel) as *const FoxgloveChannel)
+}
+
+/// The parameters of a channel created with [`foxglove_raw_channels_create`].
+#[repr(C)]
+pub struct FoxgloveChannelSpec {
+    /// The topic of the channel.
+    pub topic: FoxgloveString,
+    /// The message encoding of the channel.
+    pub message_encoding: FoxgloveString,
+    /// An optional pointer to the schema of the channel.
+    pub schema: *const FoxgloveSchema,
+    /// An optional pointer to the metadata of the channel.
+    pub metadata: *const FoxgloveChannelMetadata,
+    /// The number of most recent messages which the channel retains and delivers to sinks that
+    /// subscribe later, such as WebSocket clients that connect after the messages were logged.
+    /// Zero retains no messages.
+    ///
+    /// To create a latched channel of a well-known type, use the type's schema function, such as
+    /// `foxglove_frame_transforms_schema`, with the "protobuf" message encoding.
+    pub keep_last: usize,
+}
+
+/// Create a batch of channels.
+///
+/// The channels are registered atomically, and each sink is notified of them together; for
+/// example, a WebSocket server advertises them to each client in a single message. This is
+/// preferable to calling `foxglove_raw_channel_create` for each channel when creating many
+/// channels at once. Each created channel must later be freed with `foxglove_channel_free`.
+///
+/// If any spec is invalid, no channels are created.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `specs` must be a valid pointer to an array of `count` specs, each of which meets the
+/// requirements of the corresponding arguments to `foxglove_raw_channel_create`. The specs and
+/// the data they point to need only remain alive for the duration of this function call.
+/// `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+/// `channels` must be a valid pointer to an array of `count` channel pointers, which will be set
+/// to the created channels, in order, if the function returns success.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_raw_channels_create(
+    specs: *const FoxgloveChannelSpec,
+    count: usize,
+    context: *const FoxgloveContext,
+    channels: *mut *const FoxgloveChannel,
+) -> FoxgloveError {
+    if count == 0 {
+        return FoxgloveError::Ok;
+    }
+    if specs.is_null() || channels.is_null() {
+        tracing::error!("specs and channels cannot be null");
+        return FoxgloveError::ValueError;
+    }
+    let specs = unsafe { std::slice::from_raw_parts(specs, count) };
+    let context = if context.is_null() {
+        foxglove::Context::get_default()
+    } else {
+        Arc::clone(&ManuallyDrop::new(unsafe { Arc::from_raw(context) }))
+    };
+    let result = specs
+        .iter()
+        .map(|spec| {
+            unsafe {
+                raw_channel_builder(
+                    spec.topic,
+                    spec.message_encoding,
+                    spec.schema,
+                    std::ptr::null(),
+                    spec.metadata,
+                )
+            }
+            .map(|builder| builder.keep_last(spec.keep_last))
+        })
+        .collect::<Result<Vec<_>, _>>()
+        .and_then(|builders| context.create_channels(builders));
+    match result {
+        Ok(created) => {
+            let out = unsafe { std::slice::from_raw_parts_mut(channels, count) };
+            for (out, channel) in out.iter_mut().zip(created) {
+                *out = Arc::into_raw(channel) as *const FoxgloveChannel;
+            }
+            FoxgloveError::Ok
+        }
+        Err(e) => e.into(),
+    }
+}
+
+unsafe fn raw_channel_builder(
+    topic: FoxgloveString,
+    message_encoding: FoxgloveString,
+    schema: *const FoxgloveSchema,
+    context: *const FoxgloveContext,
+    metadata: *const FoxgloveChannelMetadata,
+) -> Result<foxglove::ChannelBuilder, foxglove::FoxgloveError> {
     let topic = unsafe { topic.as_utf8_str() }
         .map_err(|e| foxglove::FoxgloveError::Utf8Error(format!("topic invalid: {e}")))?;
     let message_encoding = unsafe { message_encoding.as_utf8_str() }.map_err(|e| {
@@ -679,9 +1616,7 @@ unsafe fn do_foxglove_raw_channel_create(
             builder = builder.add_metadata(key, value);
         }
     }
-    builder
-        .build_raw()
-        .map(|raw_channel| Arc::into_raw(raw_channel) as *const FoxgloveChannel)
+    Ok(builder)
 }
 
 pub(crate) unsafe fn do_foxglove_channel_create<T: foxglove::Encode>(
@@ -843,6 +1778,97 @@ pub extern "C" fn foxglove_channel_has_sinks(channel: Option<&FoxgloveChannel>)
     channel.0.has_sinks()
 }
 
+/// Find out if a message logged on a channel now would be delivered to at least one sink.
+///
+/// This is the same as `foxglove_channel_has_sinks`, except that it also issues the throttled
+/// warning that logging would if the channel has been closed. Use it to skip building and encoding
+/// messages that no sink would receive.
+///
+/// # Safety
+/// `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+///
+/// If the passed channel is null, true is returned, so that the subsequent log call reports the
+/// error.
+#[unsafe(no_mangle)]
+pub extern "C" fn foxglove_channel_should_log(channel: Option<&FoxgloveChannel>) -> bool {
+    let Some(channel) = channel else {
+        return true;
+    };
+    channel.0.should_log()
+}
+
+/// The demand for the messages of a channel, combined across its sinks.
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub struct FoxgloveChannelDemand {
+    /// The number of consumers of the channel's messages. Sinks which fan out to several
+    /// clients, such as a WebSocket server, count each subscribed client.
+    pub consumers: usize,
+    /// The highest rate at which any consumer receives messages, in messages per second. This is
+    /// infinity if some consumer receives every message, and 0 if there are no consumers.
+    pub max_rate: f64,
+}
+
+/// Get the demand for a channel's messages, combined across its sinks.
+///
+/// Producers of expensive messages can use this to scale their work to what is consumed, for
+/// example by producing messages no faster than `max_rate`. Demand changes as sinks subscribe and
+/// unsubscribe, so query it when deciding what to produce.
+///
+/// # Safety
+/// `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+///
+/// If the passed channel is null, no demand is returned.
+#[unsafe(no_mangle)]
+pub extern "C" fn foxglove_channel_get_demand(
+    channel: Option<&FoxgloveChannel>,
+) -> FoxgloveChannelDemand {
+    let demand = channel.map_or(foxglove::ChannelDemand::NONE, |channel| channel.0.demand());
+    FoxgloveChannelDemand {
+        consumers: demand.consumers(),
+        max_rate: demand.max_rate().unwrap_or(f64::INFINITY),
+    }
+}
+
+/// Bind a channel to another context, so that the sinks of that context also receive the
+/// channel's messages.
+///
+/// Each message is encoded and logged once, and dispatched to the sinks of every bound context.
+/// The channel still belongs to the context it was created in: closing the channel, or freeing
+/// that context, removes it from every bound context, while freeing a bound context only unbinds
+/// it. Binding a channel to its own context, or to a context it is already bound to, has no
+/// effect.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error, such as if the channel is
+/// closed or `context` already has a substantially identical channel.
+///
+/// # Safety
+/// `channel` must be a valid pointer to a `foxglove_channel` created via `foxglove_channel_create`.
+/// `context` must be a valid pointer to a context created via `foxglove_context_new`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_channel_bind_context(
+    channel: Option<&FoxgloveChannel>,
+    context: *const FoxgloveContext,
+) -> FoxgloveError {
+    let Some(channel) = channel else {
+        tracing::error!("foxglove_channel_bind_context called with null channel");
+        return FoxgloveError::ValueError;
+    };
+    if context.is_null() {
+        tracing::error!("foxglove_channel_bind_context called with null context");
+        return FoxgloveError::ValueError;
+    }
+    // avoid decrementing ref counts
+    let channel = ManuallyDrop::new(unsafe {
+        Arc::from_raw(channel as *const _ as *const foxglove::RawChannel)
+    });
+    let context = ManuallyDrop::new(unsafe { Arc::from_raw(context) });
+    match channel.bind_context(&context) {
+        Ok(()) => FoxgloveError::Ok,
+        Err(e) => e.into(),
+    }
+}
+
 /// An iterator over channel metadata key-value pairs.
 #[repr(C)]
 pub struct FoxgloveChannelMetadataIterator {
@@ -983,6 +2009,170 @@ pub unsafe extern "C" fn foxglove_channel_log(
     FoxgloveError::Ok
 }
 
+/// A message buffer owned by the caller of `foxglove_channel_log_shared`, released through its
+/// callback once the last sink drops its reference.
+struct ExternalBuffer {
+    data: *const u8,
+    len: usize,
+    release_context: *mut c_void,
+    release: unsafe extern "C" fn(release_context: *mut c_void),
+}
+
+// Safety: the caller of `foxglove_channel_log_shared` guarantees that the buffer is immutable
+// until released, and that the release callback and its context can be used from any thread.
+unsafe impl Send for ExternalBuffer {}
+unsafe impl Sync for ExternalBuffer {}
+
+impl AsRef<[u8]> for ExternalBuffer {
+    fn as_ref(&self) -> &[u8] {
+        if self.len == 0 {
+            return &[];
+        }
+        // Safety: data is non-null and valid for len bytes until the buffer is released.
+        unsafe { std::slice::from_raw_parts(self.data, self.len) }
+    }
+}
+
+impl Drop for ExternalBuffer {
+    fn drop(&mut self) {
+        // Safety: the caller provided a valid release callback.
+        unsafe { (self.release)(self.release_context) }
+    }
+}
+
+/// Log a message held in a buffer owned by the caller, without copying it.
+///
+/// Sinks that queue messages, such as the remote access gateway's video tracks and MCAP writers
+/// with async writes, may keep a reference to the buffer after this call returns rather than
+/// copying it. Once every sink has released the buffer, `release` is called exactly once with
+/// `release_context`, possibly from another thread. If the message is not logged to any sink,
+/// `release` is called before this function returns.
+///
+/// If an error is returned, `release` is not called and the caller retains ownership of the buffer.
+///
+/// # Safety
+/// If `data_len > 0`, `data` must be non-null and the range `[data, data + data_len)` must contain
+/// initialized data contained within a single allocated object, which must not be modified or
+/// freed until `release` is called. `release` and `release_context` must be safe to use from any
+/// thread. `log_time` may be null, or must be a valid pointer to a `uint64_t`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_channel_log_shared(
+    channel: Option<&FoxgloveChannel>,
+    data: *const u8,
+    data_len: usize,
+    release_context: *mut c_void,
+    release: Option<unsafe extern "C" fn(release_context: *mut c_void)>,
+    log_time: Option<&u64>,
+    sink_id: FoxgloveSinkId,
+) -> FoxgloveError {
+    let Some(channel) = channel else {
+        tracing::error!("foxglove_channel_log_shared called with null channel");
+        return FoxgloveError::ValueError;
+    };
+    let Some(release) = release else {
+        tracing::error!("foxglove_channel_log_shared called with null release callback");
+        return FoxgloveError::ValueError;
+    };
+    if data_len > 0 && data.is_null() {
+        tracing::error!("foxglove_channel_log_shared called with null data but data_len > 0");
+        return FoxgloveError::ValueError;
+    }
+    // avoid decrementing ref count
+    let channel = ManuallyDrop::new(unsafe {
+        Arc::from_raw(channel as *const _ as *const foxglove::RawChannel)
+    });
+
+    let msg = foxglove::bytes::Bytes::from_owner(ExternalBuffer {
+        data,
+        len: data_len,
+        release_context,
+        release,
+    });
+    let sink_id = std::num::NonZeroU64::new(sink_id).map(foxglove::SinkId::new);
+
+    channel.log_shared_with_meta_to_sink(
+        msg,
+        foxglove::PartialMetadata {
+            log_time: log_time.copied(),
+        },
+        sink_id,
+    );
+    FoxgloveError::Ok
+}
+
+/// A single message in a batch passed to `foxglove_channel_log_batch`.
+#[repr(C)]
+pub struct FoxgloveLogItem {
+    /// Pointer to the message data. May be null if `data_len` is 0.
+    pub data: *const u8,
+    /// Length of the message data in bytes.
+    pub data_len: usize,
+    /// Optional pointer to a log time in nanoseconds since epoch. If null, the current time is
+    /// used.
+    pub log_time: *const u64,
+}
+
+/// Log a batch of messages on a channel.
+///
+/// All messages are handed to each subscribed sink in a single call, which avoids per-message
+/// overhead when logging many small messages. Items without a log time share a single reading
+/// of the current time.
+///
+/// If any item is invalid, no messages are logged and an error is returned.
+///
+/// # Safety
+/// If `count > 0`, `items` must point to `count` valid `FoxgloveLogItem`s. For each item with
+/// `data_len > 0`, `data` must be non-null and the range `[data, data + data_len)` must contain
+/// initialized data contained within a single allocated object. Each non-null `log_time` must
+/// point to a valid `uint64_t`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_channel_log_batch(
+    channel: Option<&FoxgloveChannel>,
+    items: *const FoxgloveLogItem,
+    count: usize,
+    sink_id: FoxgloveSinkId,
+) -> FoxgloveError {
+    let Some(channel) = channel else {
+        tracing::error!("foxglove_channel_log_batch called with null channel");
+        return FoxgloveError::ValueError;
+    };
+    if count == 0 {
+        return FoxgloveError::Ok;
+    }
+    if items.is_null() {
+        tracing::error!("foxglove_channel_log_batch called with null items but count > 0");
+        return FoxgloveError::ValueError;
+    }
+    // Safety: items is non-null and points to count items
+    let items = unsafe { std::slice::from_raw_parts(items, count) };
+
+    let mut msgs = Vec::with_capacity(count);
+    for item in items {
+        let msg: &[u8] = if item.data_len == 0 {
+            &[]
+        } else if item.data.is_null() {
+            tracing::error!("foxglove_channel_log_batch called with null data but data_len > 0");
+            return FoxgloveError::ValueError;
+        } else {
+            // Safety: data is non-null and data_len > 0
+            unsafe { std::slice::from_raw_parts(item.data, item.data_len) }
+        };
+        // Safety: log_time is either null or points to a valid u64
+        let log_time = unsafe { item.log_time.as_ref() }.copied();
+        msgs.push((msg, foxglove::PartialMetadata { log_time }));
+    }
+
+    // avoid decrementing ref count
+    let channel = ManuallyDrop::new(unsafe {
+        Arc::from_raw(channel as *const _ as *const foxglove::RawChannel)
+    });
+
+    let sink_id = std::num::NonZeroU64::new(sink_id).map(foxglove::SinkId::new);
+
+    channel.log_batch_to_sink(&msgs, sink_id);
+    FoxgloveError::Ok
+}
+
 // This generates a `typedef struct foxglove_context foxglove_context`
 // for the opaque type that we want to expose to C, but does so under
 // a module to avoid collision with the actual type.
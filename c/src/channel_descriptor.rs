@@ -1,3 +1,5 @@
+use std::ops::Bound;
+
 use crate::{FoxgloveError, FoxgloveKeyValue, FoxgloveSchema, FoxgloveString};
 
 pub struct FoxgloveChannelDescriptor(pub(crate) foxglove::ChannelDescriptor);
@@ -187,3 +189,116 @@ pub unsafe extern "C" fn foxglove_channel_descriptor_metadata_iter_free(
         drop(unsafe { Box::from_raw(iter) });
     }
 }
+
+/// Get the metadata entry which follows `prev_key`, in key order, without allocating.
+///
+/// If `prev_key.data` is null, the first entry is returned. Returns true if an entry was found
+/// and stored in `key_value`, false if there are no more entries.
+///
+/// Unlike the metadata iterator, this does not allocate, and each step is O(log n).
+///
+/// # Safety
+/// `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+/// `prev_key`, if `data` is non-null, must be a valid UTF-8 string.
+/// `key_value` must be a valid pointer to a `FoxgloveKeyValue` that will be filled in.
+///
+/// The returned value is valid only for the lifetime of the channel, which is typically the
+/// duration of a callback where a descriptor is passed.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_channel_descriptor_metadata_next(
+    channel: Option<&FoxgloveChannelDescriptor>,
+    prev_key: FoxgloveString,
+    key_value: *mut FoxgloveKeyValue,
+) -> bool {
+    let Some(channel) = channel else {
+        return false;
+    };
+    if key_value.is_null() {
+        return false;
+    }
+    let metadata = channel.0.metadata();
+    let entry = if prev_key.data.is_null() {
+        metadata.iter().next()
+    } else {
+        let Ok(prev_key) = (unsafe { prev_key.as_utf8_str() }) else {
+            return false;
+        };
+        metadata
+            .range::<str, _>((Bound::Excluded(prev_key), Bound::Unbounded))
+            .next()
+    };
+    let Some((key, value)) = entry else {
+        return false;
+    };
+    unsafe {
+        *key_value = FoxgloveKeyValue {
+            key: FoxgloveString::from(key),
+            value: FoxgloveString::from(value),
+        };
+    }
+    true
+}
+
+/// Look up the value of a channel descriptor's metadata key, without allocating.
+///
+/// Returns true if the key was found and its value stored in `value`, false otherwise.
+///
+/// # Safety
+/// `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+/// `key` must be a valid UTF-8 string.
+/// `value` must be a valid pointer to a `FoxgloveString` that will be filled in.
+///
+/// The returned value is valid only for the lifetime of the channel, which is typically the
+/// duration of a callback where a descriptor is passed.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_channel_descriptor_get_metadata_value(
+    channel: Option<&FoxgloveChannelDescriptor>,
+    key: FoxgloveString,
+    value: *mut FoxgloveString,
+) -> bool {
+    let Some(channel) = channel else {
+        return false;
+    };
+    if value.is_null() {
+        return false;
+    }
+    let Ok(key) = (unsafe { key.as_utf8_str() }) else {
+        return false;
+    };
+    let Some(found) = channel.0.metadata().get(key) else {
+        return false;
+    };
+    unsafe { *value = FoxgloveString::from(found) };
+    true
+}
+
+/// Clone a channel descriptor, so that it can be kept beyond the callback it was passed to.
+///
+/// The clone shares the descriptor's data, and must be freed with
+/// `foxglove_channel_descriptor_free`.
+///
+/// If the passed channel is null, null is returned.
+///
+/// # Safety
+/// `channel` must be a valid pointer to a `foxglove_channel_descriptor`.
+#[unsafe(no_mangle)]
+pub extern "C" fn foxglove_channel_descriptor_clone(
+    channel: Option<&FoxgloveChannelDescriptor>,
+) -> *mut FoxgloveChannelDescriptor {
+    let Some(channel) = channel else {
+        return std::ptr::null_mut();
+    };
+    Box::into_raw(Box::new(FoxgloveChannelDescriptor(channel.0.clone())))
+}
+
+/// Free a channel descriptor created via `foxglove_channel_descriptor_clone`.
+///
+/// # Safety
+/// `channel` must be null, or a valid pointer to a `foxglove_channel_descriptor` created via
+/// `foxglove_channel_descriptor_clone`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_channel_descriptor_free(channel: *mut FoxgloveChannelDescriptor) {
+    if !channel.is_null() {
+        drop(unsafe { Box::from_raw(channel) });
+    }
+}
@@ -0,0 +1,112 @@
+//! C FFI bindings for context clocks.
+
+use std::mem::ManuallyDrop;
+use std::sync::Arc;
+use std::time::Duration;
+
+use crate::FoxgloveContext;
+
+/// A clock which is set by the application, for example from simulation time.
+///
+/// The clock is created by `foxglove_sim_clock_new`, and freed by `foxglove_sim_clock_free`.
+/// Contexts using the clock hold their own reference to it.
+pub struct FoxgloveSimClock(Arc<foxglove::SimClock>);
+
+/// Create a clock which starts at `start_ns` nanoseconds since the Unix epoch. This never fails.
+/// You must pass this to `foxglove_sim_clock_free` when done with it.
+#[unsafe(no_mangle)]
+pub extern "C" fn foxglove_sim_clock_new(start_ns: u64) -> *mut FoxgloveSimClock {
+    Box::into_raw(Box::new(FoxgloveSimClock(Arc::new(
+        foxglove::SimClock::new(start_ns),
+    ))))
+}
+
+/// Set the current time of a clock, in nanoseconds since the Unix epoch.
+///
+/// # Safety
+/// `clock` must be null, or a valid pointer to a clock created via `foxglove_sim_clock_new`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_sim_clock_set_time(
+    clock: Option<&FoxgloveSimClock>,
+    time_ns: u64,
+) {
+    if let Some(clock) = clock {
+        clock.0.set_time(time_ns);
+    }
+}
+
+/// Advance the current time of a clock by `duration_ns` nanoseconds.
+///
+/// # Safety
+/// `clock` must be null, or a valid pointer to a clock created via `foxglove_sim_clock_new`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_sim_clock_advance(
+    clock: Option<&FoxgloveSimClock>,
+    duration_ns: u64,
+) {
+    if let Some(clock) = clock {
+        clock.0.advance(Duration::from_nanos(duration_ns));
+    }
+}
+
+/// Free a clock created via `foxglove_sim_clock_new`.
+///
+/// Contexts which use the clock keep using it.
+///
+/// # Safety
+/// `clock` must be null, or a valid pointer to a clock created via `foxglove_sim_clock_new`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_sim_clock_free(clock: *mut FoxgloveSimClock) {
+    if clock.is_null() {
+        return;
+    }
+    // Safety: undo the Box::into_raw in foxglove_sim_clock_new
+    drop(unsafe { Box::from_raw(clock) });
+}
+
+/// Set the clock which provides the log time of messages logged without one.
+///
+/// If `clock` is null, the context's default clock is restored. The default clock never goes
+/// backwards, and is anchored to the system wall clock.
+///
+/// # Safety
+/// `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+/// If it's null, the clock of the default context is set. `clock` must be null, or a valid
+/// pointer to a clock created via `foxglove_sim_clock_new`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_context_set_sim_clock(
+    context: *const FoxgloveContext,
+    clock: Option<&FoxgloveSimClock>,
+) {
+    unsafe {
+        with_context(context, |context| match clock {
+            Some(clock) => context.set_clock(clock.0.clone()),
+            None => context.reset_clock(),
+        })
+    }
+}
+
+/// Returns the current time of a context's clock, in nanoseconds since the Unix epoch.
+///
+/// This is the log time given to a message logged without one.
+///
+/// # Safety
+/// `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+/// If it's null, the clock of the default context is read.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_context_now(context: *const FoxgloveContext) -> u64 {
+    unsafe { with_context(context, |context| context.now()) }
+}
+
+/// Calls `f` with the given context, or the default context if `context` is null.
+pub(crate) unsafe fn with_context<R>(
+    context: *const FoxgloveContext,
+    f: impl FnOnce(&FoxgloveContext) -> R,
+) -> R {
+    if context.is_null() {
+        f(&foxglove::Context::get_default())
+    } else {
+        let context = ManuallyDrop::new(unsafe { Arc::from_raw(context) });
+        f(&context)
+    }
+}
@@ -224,6 +224,188 @@ unsafe fn do_foxglove_connection_graph_set_advertised_service(
     Ok(())
 }
 
+pub struct FoxgloveConnectionGraphPatch(pub(crate) foxglove::websocket::ConnectionGraphPatch);
+
+/// Create a new, empty connection graph patch.
+///
+/// A patch describes changes to a published connection graph, and is applied with
+/// `foxglove_server_update_connection_graph` or `foxglove_gateway_update_connection_graph`.
+/// Unlike publishing a connection graph, only the topics and services named in the patch are
+/// compared with the published graph.
+///
+/// The patch must later be freed with `foxglove_connection_graph_patch_free`.
+///
+/// # Safety
+/// `patch` must be a valid pointer to a pointer to a `foxglove_connection_graph_patch`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_connection_graph_patch_create(
+    patch: *mut *mut FoxgloveConnectionGraphPatch,
+) -> FoxgloveError {
+    if patch.is_null() {
+        return FoxgloveError::ValueError;
+    }
+    let patch_box = Box::new(FoxgloveConnectionGraphPatch(
+        foxglove::websocket::ConnectionGraphPatch::new(),
+    ));
+    unsafe { *patch = Box::into_raw(patch_box) };
+    FoxgloveError::Ok
+}
+
+/// Free the connection graph patch.
+///
+/// # Safety
+/// `patch` must be a valid pointer to a `foxglove_connection_graph_patch` created by
+/// `foxglove_connection_graph_patch_create`, or null.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_connection_graph_patch_free(
+    patch: *mut FoxgloveConnectionGraphPatch,
+) {
+    if !patch.is_null() {
+        drop(unsafe { Box::from_raw(patch) });
+    }
+}
+
+/// Set a published topic and its associated publisher ids in the patch. Overwrites any existing
+/// publisher ids for the topic.
+///
+/// # Safety
+/// `topic`, and each ID in `publisher_ids` must adhere to the safety rules of `foxglove_string`.
+/// `publisher_ids_count` must be the number of elements in the `publisher_ids` array.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_connection_graph_patch_set_published_topic(
+    patch: &mut FoxgloveConnectionGraphPatch,
+    topic: FoxgloveString,
+    publisher_ids: *const FoxgloveString,
+    publisher_ids_count: usize,
+) -> FoxgloveError {
+    let result = unsafe {
+        patch_args(
+            topic,
+            "topic",
+            publisher_ids,
+            publisher_ids_count,
+            "publisher_id",
+        )
+    }
+    .map(|(topic, ids)| patch.0.set_published_topic(topic, ids));
+    unsafe { result_to_c(result, std::ptr::null_mut()) }
+}
+
+/// Set a subscribed topic and its associated subscriber ids in the patch. Overwrites any existing
+/// subscriber ids for the topic.
+///
+/// # Safety
+/// `topic`, and each ID in `subscriber_ids` must adhere to the safety rules of `foxglove_string`.
+/// `subscriber_ids_count` must be the number of elements in the `subscriber_ids` array.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_connection_graph_patch_set_subscribed_topic(
+    patch: &mut FoxgloveConnectionGraphPatch,
+    topic: FoxgloveString,
+    subscriber_ids: *const FoxgloveString,
+    subscriber_ids_count: usize,
+) -> FoxgloveError {
+    let result = unsafe {
+        patch_args(
+            topic,
+            "topic",
+            subscriber_ids,
+            subscriber_ids_count,
+            "subscriber_id",
+        )
+    }
+    .map(|(topic, ids)| patch.0.set_subscribed_topic(topic, ids));
+    unsafe { result_to_c(result, std::ptr::null_mut()) }
+}
+
+/// Set an advertised service and its associated provider ids in the patch. Overwrites any
+/// existing provider ids for the service.
+///
+/// # Safety
+/// `service`, and each ID in `provider_ids` must adhere to the safety rules of `foxglove_string`.
+/// `provider_ids_count` must be the number of elements in the `provider_ids` array.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_connection_graph_patch_set_advertised_service(
+    patch: &mut FoxgloveConnectionGraphPatch,
+    service: FoxgloveString,
+    provider_ids: *const FoxgloveString,
+    provider_ids_count: usize,
+) -> FoxgloveError {
+    let result = unsafe {
+        patch_args(
+            service,
+            "service",
+            provider_ids,
+            provider_ids_count,
+            "provider_id",
+        )
+    }
+    .map(|(service, ids)| patch.0.set_advertised_service(service, ids));
+    unsafe { result_to_c(result, std::ptr::null_mut()) }
+}
+
+/// Remove a topic, along with its publishers and subscribers, in the patch.
+///
+/// # Safety
+/// `topic` must adhere to the safety rules of `foxglove_string`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_connection_graph_patch_remove_topic(
+    patch: &mut FoxgloveConnectionGraphPatch,
+    topic: FoxgloveString,
+) -> FoxgloveError {
+    let result = unsafe { patch_args(topic, "topic", std::ptr::null(), 0, "") }
+        .map(|(topic, _)| patch.0.remove_topic(topic));
+    unsafe { result_to_c(result, std::ptr::null_mut()) }
+}
+
+/// Remove a service, along with its providers, in the patch.
+///
+/// # Safety
+/// `service` must adhere to the safety rules of `foxglove_string`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_connection_graph_patch_remove_service(
+    patch: &mut FoxgloveConnectionGraphPatch,
+    service: FoxgloveString,
+) -> FoxgloveError {
+    let result = unsafe { patch_args(service, "service", std::ptr::null(), 0, "") }
+        .map(|(service, _)| patch.0.remove_service(service));
+    unsafe { result_to_c(result, std::ptr::null_mut()) }
+}
+
+/// Validates the arguments of a patch function. Unlike the graph setters, an empty list of ids
+/// is allowed, and clears the ids of the topic or service.
+unsafe fn patch_args<'a>(
+    name: FoxgloveString,
+    name_kind: &str,
+    ids: *const FoxgloveString,
+    ids_count: usize,
+    id_kind: &str,
+) -> Result<(&'a str, Vec<&'a str>), foxglove::FoxgloveError> {
+    let name = unsafe { name.as_utf8_str() }
+        .map_err(|e| foxglove::FoxgloveError::Utf8Error(format!("{name_kind} is invalid: {e}")))?;
+    if ids_count == 0 {
+        return Ok((name, Vec::new()));
+    }
+    if ids.is_null() {
+        return Err(foxglove::FoxgloveError::ValueError(format!(
+            "{id_kind}s is null"
+        )));
+    }
+    let ids = unsafe { std::slice::from_raw_parts(ids, ids_count) }
+        .iter()
+        .map(|id| {
+            if id.data.is_null() {
+                return Err(foxglove::FoxgloveError::ValueError(format!(
+                    "encountered a null {id_kind}"
+                )));
+            }
+            unsafe { id.as_utf8_str() }.map_err(|e| {
+                foxglove::FoxgloveError::Utf8Error(format!("{id_kind} is invalid: {e}"))
+            })
+        })
+        .collect::<Result<_, _>>()?;
+    Ok((name, ids))
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -275,4 +457,47 @@ mod tests {
         };
         assert_eq!(result, FoxgloveError::Ok);
     }
+
+    #[test]
+    fn test_patch() {
+        let mut patch = std::ptr::null_mut();
+        assert_eq!(
+            unsafe { foxglove_connection_graph_patch_create(&raw mut patch) },
+            FoxgloveError::Ok
+        );
+        let patch_ref = unsafe { &mut *patch };
+        let ids = ["publisher_id_1".into(), "publisher_id_2".into()];
+        let result = unsafe {
+            foxglove_connection_graph_patch_set_published_topic(
+                patch_ref,
+                "topic".into(),
+                ids.as_ptr(),
+                ids.len(),
+            )
+        };
+        assert_eq!(result, FoxgloveError::Ok);
+        let result = unsafe {
+            foxglove_connection_graph_patch_set_subscribed_topic(
+                patch_ref,
+                "topic".into(),
+                std::ptr::null(),
+                0,
+            )
+        };
+        assert_eq!(result, FoxgloveError::Ok);
+        let result = unsafe {
+            foxglove_connection_graph_patch_set_advertised_service(
+                patch_ref,
+                "service".into(),
+                std::ptr::null(),
+                1,
+            )
+        };
+        assert_eq!(result, FoxgloveError::ValueError);
+        let result =
+            unsafe { foxglove_connection_graph_patch_remove_service(patch_ref, "service".into()) };
+        assert_eq!(result, FoxgloveError::Ok);
+        assert!(!patch_ref.0.is_empty());
+        unsafe { foxglove_connection_graph_patch_free(patch) };
+    }
 }
@@ -1,11 +1,32 @@
 use std::ffi::c_void;
 
-use foxglove::websocket::{AssetHandler, AssetResponder};
+use foxglove::websocket::{AssetHandler, AssetResponder, AssetWriter, FileAssetHandler};
 
-use crate::{FoxgloveString, bytes::FoxgloveBytes};
+use crate::{FoxgloveError, FoxgloveString, bytes::FoxgloveBytes};
 
-pub struct FoxgloveFetchAssetResponder(AssetResponder);
+/// A fetch asset responder, which becomes a writer once the first chunk is appended to it.
+pub struct FoxgloveFetchAssetResponder {
+    responder: Option<AssetResponder>,
+    writer: Option<AssetWriter>,
+}
 impl FoxgloveFetchAssetResponder {
+    fn new(responder: AssetResponder) -> Self {
+        Self {
+            responder: Some(responder),
+            writer: None,
+        }
+    }
+
+    /// Returns the writer, converting the responder into one if necessary.
+    fn writer(&mut self) -> &mut AssetWriter {
+        self.writer.get_or_insert_with(|| {
+            self.responder
+                .take()
+                .expect("responder is present until a writer is created")
+                .writer()
+        })
+    }
+
     /// Moves the responder to the heap and returns a raw pointer.
     ///
     /// After calling this function, the caller is responsible for eventually calling
@@ -53,7 +74,7 @@ unsafe impl Sync for FetchAssetHandler {}
 impl AssetHandler for FetchAssetHandler {
     fn fetch(&self, uri: String, responder: AssetResponder) {
         let c_uri = FoxgloveString::from(&uri);
-        let c_responder = FoxgloveFetchAssetResponder(responder).into_raw();
+        let c_responder = FoxgloveFetchAssetResponder::new(responder).into_raw();
         // SAFETY: It's the callback implementation's responsibility to ensure that this callback
         // function pointer remains valid for the lifetime of the server / gateway, as described
         // in the safety requirements of `foxglove_server_options.fetch_asset` /
@@ -62,8 +83,52 @@ impl AssetHandler for FetchAssetHandler {
     }
 }
 
+/// Appends a chunk of asset data to a fetch asset response, without completing the request.
+///
+/// This allows an asset to be read and passed to the SDK piece by piece. The protocol delivers
+/// each asset to the client in a single message, so the chunks are assembled by the SDK, and sent
+/// when the request is completed with `foxglove_fetch_asset_respond_finish` or
+/// `foxglove_fetch_asset_respond_ok`. `foxglove_fetch_asset_respond_error` discards them.
+///
+/// # Safety
+/// - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via a
+///   `fetch_asset` callback, which has not yet been completed.
+/// - `data` must be a pointer to the chunk. This value is copied by this function.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_fetch_asset_append(
+    responder: Option<&mut FoxgloveFetchAssetResponder>,
+    data: FoxgloveBytes,
+) -> FoxgloveError {
+    let Some(responder) = responder else {
+        return FoxgloveError::ValueError;
+    };
+    let data = unsafe { data.as_slice() };
+    responder.writer().append(data);
+    FoxgloveError::Ok
+}
+
+/// Completes a fetch asset request by sending the chunks appended with
+/// `foxglove_fetch_asset_append` to the client.
+///
+/// # Safety
+/// - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via a
+///   `fetch_asset` callback. This value is moved into this function, and must not be accessed
+///   afterwards.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_fetch_asset_respond_finish(
+    responder: *mut FoxgloveFetchAssetResponder,
+) {
+    let mut responder = unsafe { FoxgloveFetchAssetResponder::from_raw(responder) };
+    responder.writer();
+    if let Some(writer) = responder.writer.take() {
+        writer.finish();
+    }
+}
+
 /// Completes a fetch asset request by sending asset data to the client.
 ///
+/// If chunks were appended with `foxglove_fetch_asset_append`, `data` is sent after them.
+///
 /// # Safety
 /// - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via a
 ///   `fetch_asset` callback. This value is moved into this function, and must not be accessed
@@ -76,7 +141,12 @@ pub unsafe extern "C" fn foxglove_fetch_asset_respond_ok(
 ) {
     let responder = unsafe { FoxgloveFetchAssetResponder::from_raw(responder) };
     let data = unsafe { data.as_slice() };
-    responder.0.respond_ok(data);
+    if let Some(mut writer) = responder.writer {
+        writer.append(data);
+        writer.finish();
+    } else if let Some(responder) = responder.responder {
+        responder.respond_ok(data);
+    }
 }
 
 /// Completes a request by sending an error message to the client.
@@ -97,5 +167,103 @@ pub unsafe extern "C" fn foxglove_fetch_asset_respond_error(
         Ok(s) => s.to_string(),
         Err(e) => format!("Server produced an invalid error message: {e}"),
     };
-    responder.0.respond_err(message);
+    if let Some(writer) = responder.writer {
+        writer.respond_err(message);
+    } else if let Some(responder) = responder.responder {
+        responder.respond_err(message);
+    }
+}
+
+/// A directory served by a file asset handler.
+#[repr(C)]
+pub struct FoxgloveFileAssetRoot {
+    /// The prefix of the URIs served from the directory, such as `package://my_robot/`.
+    pub uri_prefix: FoxgloveString,
+    /// The directory which the rest of the URI is resolved against.
+    pub directory: FoxgloveString,
+}
+
+/// A built-in fetch asset handler, which serves files from a set of directories.
+pub struct FoxgloveFileAssetHandler(FileAssetHandler);
+
+/// Creates a fetch asset handler which serves files from a set of allowed directories.
+///
+/// A URI is resolved by replacing the longest matching `uri_prefix` with its `directory`.
+/// Requests for URIs which match no root, or which resolve to a path outside of the root's
+/// directory, fail. Files larger than 256 MiB are not served. Each file is read into memory, and
+/// concurrent requests for the same unchanged file share a single copy.
+///
+/// The handler is used by passing each request to `foxglove_file_asset_handler_fetch` from a
+/// `fetch_asset` callback. It must be freed with `foxglove_file_asset_handler_free`.
+///
+/// # Safety
+/// - `roots` must be a valid pointer to an array of `roots_count` roots, or NULL if
+///   `roots_count` is zero. The strings must be valid UTF-8, and are copied by this function.
+/// - `handler` must be a valid pointer.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_file_asset_handler_create(
+    roots: *const FoxgloveFileAssetRoot,
+    roots_count: usize,
+    handler: *mut *mut FoxgloveFileAssetHandler,
+) -> FoxgloveError {
+    if handler.is_null() || (roots.is_null() && roots_count > 0) {
+        return FoxgloveError::ValueError;
+    }
+    let roots = if roots_count > 0 {
+        unsafe { std::slice::from_raw_parts(roots, roots_count) }
+    } else {
+        &[]
+    };
+    let mut inner = FileAssetHandler::new();
+    for root in roots {
+        let uri_prefix = unsafe { root.uri_prefix.as_utf8_str() };
+        let directory = unsafe { root.directory.as_utf8_str() };
+        let (Ok(uri_prefix), Ok(directory)) = (uri_prefix, directory) else {
+            return FoxgloveError::Utf8Error;
+        };
+        inner = inner.root(uri_prefix, directory);
+    }
+    unsafe { *handler = Box::into_raw(Box::new(FoxgloveFileAssetHandler(inner))) };
+    FoxgloveError::Ok
+}
+
+/// Completes a fetch asset request by serving the requested file.
+///
+/// The file is resolved and read on a background thread, so this function may be called from
+/// a `fetch_asset` callback without blocking.
+///
+/// # Safety
+/// - `handler` must be a valid pointer to a handler created by
+///   `foxglove_file_asset_handler_create`.
+/// - `uri` must be a valid UTF-8 string. This value is copied by this function.
+/// - `responder` must be a pointer to a `foxglove_fetch_asset_responder` obtained via a
+///   `fetch_asset` callback, to which no chunks have been appended. This value is moved into this
+///   function, and must not be accessed afterwards.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_file_asset_handler_fetch(
+    handler: Option<&FoxgloveFileAssetHandler>,
+    uri: FoxgloveString,
+    responder: *mut FoxgloveFetchAssetResponder,
+) {
+    let responder = unsafe { FoxgloveFetchAssetResponder::from_raw(responder) };
+    let (Some(handler), Some(responder)) = (handler, responder.responder) else {
+        // Dropping the responder or writer sends an error response.
+        return;
+    };
+    match unsafe { uri.as_utf8_str() } {
+        Ok(uri) => handler.0.fetch(uri.to_string(), responder),
+        Err(e) => responder.respond_err(format!("Invalid asset URI: {e}")),
+    }
+}
+
+/// Frees a file asset handler.
+///
+/// # Safety
+/// - `handler` must be NULL, or a valid pointer to a handler created by
+///   `foxglove_file_asset_handler_create`, which must not be used afterwards.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_file_asset_handler_free(handler: *mut FoxgloveFileAssetHandler) {
+    if !handler.is_null() {
+        drop(unsafe { Box::from_raw(handler) });
+    }
 }
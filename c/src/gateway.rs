@@ -6,13 +6,13 @@ use std::time::Duration;
 use bitflags::bitflags;
 
 use crate::channel_descriptor::FoxgloveChannelDescriptor;
-use crate::connection_graph::FoxgloveConnectionGraph;
+use crate::connection_graph::{FoxgloveConnectionGraph, FoxgloveConnectionGraphPatch};
 use crate::fetch_asset::{FetchAssetHandler, FoxgloveFetchAssetResponder};
 use crate::parameter::FoxgloveParameterArray;
 use crate::parameter_handler::FoxgloveParameterHandler;
 use crate::server::FoxgloveServerStatusLevel;
 use crate::service::FoxgloveService;
-use crate::sink_channel_filter::ChannelFilter;
+use crate::sink_channel_filter::{FoxgloveTopicFilter, sink_channel_filter};
 use crate::util::parse_key_value_array;
 use crate::{
     FoxgloveContext, FoxgloveError, FoxgloveKeyValue, FoxgloveSinkId, FoxgloveString, result_to_c,
@@ -27,10 +27,30 @@ pub enum FoxgloveReliability {
     Reliable = 1,
 }
 
+/// The priority of a channel's data, relative to other channels.
+#[repr(u8)]
+pub enum FoxglovePriority {
+    /// The default priority.
+    Normal = 0,
+    /// Best-effort data, such as debug visualizations.
+    Low = 1,
+    /// Latency-sensitive data, such as teleoperation commands and transforms.
+    High = 2,
+}
+
 /// Quality-of-service profile for a channel.
 #[repr(C)]
 pub struct FoxgloveQosProfile {
     pub reliability: FoxgloveReliability,
+    /// The priority of the channel's data. Priority takes effect for reliable channels when the
+    /// gateway is configured with a dropping `message_backlog_policy`.
+    pub priority: FoxglovePriority,
+    /// How long a message may wait in a participant's message backlog before it is dropped, in
+    /// milliseconds. 0 means messages never expire.
+    pub lifespan_ms: u64,
+    /// Maximum rate of messages sent for the channel, in messages per second. Messages logged
+    /// faster than this are dropped. 0 means no limit.
+    pub max_rate: f64,
 }
 
 impl From<FoxgloveQosProfile> for foxglove::remote_access::QosProfile {
@@ -39,8 +59,16 @@ impl From<FoxgloveQosProfile> for foxglove::remote_access::QosProfile {
             FoxgloveReliability::Lossy => foxglove::remote_access::Reliability::Lossy,
             FoxgloveReliability::Reliable => foxglove::remote_access::Reliability::Reliable,
         };
+        let priority = match profile.priority {
+            FoxglovePriority::Normal => foxglove::remote_access::Priority::Normal,
+            FoxglovePriority::Low => foxglove::remote_access::Priority::Low,
+            FoxglovePriority::High => foxglove::remote_access::Priority::High,
+        };
         foxglove::remote_access::QosProfile::builder()
             .reliability(reliability)
+            .priority(priority)
+            .lifespan(Duration::from_millis(profile.lifespan_ms))
+            .max_rate(profile.max_rate)
             .build()
     }
 }
@@ -112,6 +140,35 @@ impl foxglove::remote_access::SuppressVideoTranscode for SuppressVideoTranscode
     }
 }
 
+/// A keyframe request handler that wraps a C callback.
+#[derive(Clone)]
+struct KeyframeRequestHandler {
+    callback_context: *const c_void,
+    callback: unsafe extern "C" fn(*const c_void, *const FoxgloveChannelDescriptor),
+}
+
+impl KeyframeRequestHandler {
+    fn new(
+        callback_context: *const c_void,
+        callback: unsafe extern "C" fn(*const c_void, *const FoxgloveChannelDescriptor),
+    ) -> Self {
+        Self {
+            callback_context,
+            callback,
+        }
+    }
+}
+
+unsafe impl Send for KeyframeRequestHandler {}
+unsafe impl Sync for KeyframeRequestHandler {}
+
+impl foxglove::remote_access::KeyframeRequestHandler for KeyframeRequestHandler {
+    fn request_keyframe(&self, channel: &foxglove::ChannelDescriptor) {
+        let c_channel_descriptor = FoxgloveChannelDescriptor(channel.clone());
+        unsafe { (self.callback)(self.callback_context, &raw const c_channel_descriptor) }
+    }
+}
+
 /// The status of the remote access gateway connection.
 #[repr(u8)]
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -172,6 +229,64 @@ impl From<FoxgloveVideoEncoderBackend> for foxglove::remote_access::VideoEncoder
     }
 }
 
+/// How a participant's message backlog handles messages for reliable channels when it fills up.
+#[repr(u8)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum FoxgloveMessageBacklogPolicy {
+    /// Queue channel messages with control plane messages, and disconnect the participant when
+    /// the queue is full.
+    Disconnect = 0,
+    /// Drop the oldest queued channel message, whichever channel it was logged to.
+    DropOldest = 1,
+    /// Drop stale messages from the busiest channels, keeping the latest message of each channel.
+    KeepLatestPerChannel = 2,
+}
+
+impl From<FoxgloveMessageBacklogPolicy> for foxglove::remote_access::MessageBacklogPolicy {
+    fn from(policy: FoxgloveMessageBacklogPolicy) -> Self {
+        match policy {
+            FoxgloveMessageBacklogPolicy::Disconnect => Self::Disconnect,
+            FoxgloveMessageBacklogPolicy::DropOldest => Self::DropOldest,
+            FoxgloveMessageBacklogPolicy::KeepLatestPerChannel => Self::KeepLatestPerChannel,
+        }
+    }
+}
+
+/// Limits for published video tracks, which are also adapted to the available bandwidth.
+///
+/// A field set to 0 uses its default.
+#[repr(C)]
+pub struct FoxgloveVideoLimits {
+    /// Maximum bitrate of each video track, in bits per second. Defaults to 4 Mbps.
+    pub max_bitrate: u64,
+    /// Maximum frame rate of each video track. Defaults to 30.
+    pub max_framerate: f64,
+    /// Lowest frame rate a track is reduced to when bandwidth is scarce. Defaults to 5.
+    pub min_framerate: f64,
+    /// Largest factor by which the width and height of frames are divided when bandwidth is
+    /// scarce. Defaults to 4.
+    pub max_downscale: u32,
+}
+
+impl From<&FoxgloveVideoLimits> for foxglove::remote_access::VideoLimits {
+    fn from(limits: &FoxgloveVideoLimits) -> Self {
+        let default = Self::default();
+        let or_default = |value: f64, default: f64| if value == 0.0 { default } else { value };
+        Self {
+            max_bitrate: match limits.max_bitrate {
+                0 => default.max_bitrate,
+                bitrate => bitrate,
+            },
+            max_framerate: or_default(limits.max_framerate, default.max_framerate),
+            min_framerate: or_default(limits.min_framerate, default.min_framerate),
+            max_downscale: match limits.max_downscale {
+                0 => default.max_downscale,
+                downscale => downscale,
+            },
+        }
+    }
+}
+
 // Capabilities
 // ============
 
@@ -610,6 +725,13 @@ pub struct FoxgloveGatewayOptions<'a> {
         ) -> bool,
     >,
 
+    /// Optional topic filter, created via `foxglove_topic_filter_create`.
+    ///
+    /// The filter is evaluated without calling into C, and its result is cached per channel. If
+    /// `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+    /// filter. The sink holds its own reference to the filter.
+    pub topic_filter: *const FoxgloveTopicFilter,
+
     /// Context provided to the `qos_classifier` callback.
     pub qos_classifier_context: *const c_void,
 
@@ -699,6 +821,59 @@ pub struct FoxgloveGatewayOptions<'a> {
     /// Maximum lossy data-track message size in bytes. A value of 0 means use the default
     /// (102400). Must be at least 1200.
     pub max_data_track_message_size: usize,
+
+    /// Maximum number of bytes in each participant's backlog of messages for reliable channels.
+    /// A value of 0 means the backlog is only limited by its number of messages. Has no effect
+    /// with `FOXGLOVE_MESSAGE_BACKLOG_POLICY_DISCONNECT`.
+    pub message_backlog_bytes: usize,
+
+    /// How a participant's backlog handles messages for reliable channels when it fills up.
+    ///
+    /// Defaults to `FOXGLOVE_MESSAGE_BACKLOG_POLICY_DISCONNECT` (0), which disconnects the
+    /// participant when its queue is full.
+    pub message_backlog_policy: FoxgloveMessageBacklogPolicy,
+
+    /// Optional limits for published video tracks.
+    ///
+    /// If set, the bitrate and frame rate of each video track are limited, and its resolution and
+    /// frame rate are adapted to the bandwidth estimated by the WebRTC congestion controller.
+    pub video_limits: Option<&'a FoxgloveVideoLimits>,
+
+    /// Maximum size in bytes of a lossy message which is split into fragments rather than dropped
+    /// when it exceeds `max_data_track_message_size`. A value of 0 disables fragmentation.
+    pub max_fragmented_message_size: usize,
+
+    /// Context provided to the `keyframe_request` callback.
+    pub keyframe_request_context: *const c_void,
+
+    /// Asks the producer of a pre-encoded video channel for a keyframe.
+    ///
+    /// Channels carrying `foxglove.CompressedVideo` are forwarded to participants without
+    /// transcoding. This callback is invoked when a participant subscribes to such a channel, or
+    /// when the gateway drops one of its frames, so that viewers can resume decoding promptly. The
+    /// producer should force its encoder to emit a keyframe. Requests are throttled per channel.
+    ///
+    /// This method is invoked from a time-sensitive context and must not block.
+    pub keyframe_request: Option<
+        unsafe extern "C" fn(context: *const c_void, channel: *const FoxgloveChannelDescriptor),
+    >,
+
+    /// Whether published video tracks are sent as simulcast layers, at full, half and a quarter
+    /// of their resolution, from which the server picks one for each participant.
+    ///
+    /// Each video channel is encoded once and shared by all participants either way. Defaults to
+    /// false, since simulcast adds to the encoding cost of each track.
+    pub video_simulcast: bool,
+
+    /// If nonzero, small messages published to a lossy channel's data track are packed into
+    /// shared frames of one data-channel packet, each held for at most this many microseconds.
+    /// A value of 0 disables packing. Viewers must support packed data-track frames.
+    pub pack_linger_us: u64,
+
+    /// Optional path of a file in which to cache the device info fetched from the Foxglove
+    /// platform, so that a restarted gateway doesn't wait on the API to name itself. Empty string
+    /// disables the cache.
+    pub device_info_cache_path: FoxgloveString,
     // New fields are appended last so that adding them preserves the memory offsets of all
     // pre-existing fields.
 }
@@ -819,11 +994,14 @@ unsafe fn do_foxglove_gateway_start(
     }
 
     // Channel filter
-    if let Some(sink_channel_filter) = options.sink_channel_filter {
-        gateway = gateway.channel_filter(Arc::new(ChannelFilter::new(
+    if let Some(filter) = unsafe {
+        sink_channel_filter(
             options.sink_channel_filter_context,
-            sink_channel_filter,
-        )));
+            options.sink_channel_filter,
+            options.topic_filter,
+        )
+    } {
+        gateway = gateway.channel_filter(filter);
     }
 
     // QoS classifier
@@ -842,6 +1020,14 @@ unsafe fn do_foxglove_gateway_start(
         )));
     }
 
+    // Keyframe request handler
+    if let Some(keyframe_request) = options.keyframe_request {
+        gateway = gateway.keyframe_request_handler(Arc::new(KeyframeRequestHandler::new(
+            options.keyframe_request_context,
+            keyframe_request,
+        )));
+    }
+
     // Fetch asset handler
     if let Some(fetch_asset) = options.fetch_asset {
         gateway = gateway.fetch_asset_handler(Arc::new(FetchAssetHandler::new(
@@ -873,6 +1059,18 @@ unsafe fn do_foxglove_gateway_start(
     if options.message_backlog_size != 0 {
         gateway = gateway.message_backlog_size(options.message_backlog_size);
     }
+    if options.message_backlog_bytes != 0 {
+        gateway = gateway.message_backlog_bytes(options.message_backlog_bytes);
+    }
+    gateway = gateway.message_backlog_policy(options.message_backlog_policy.into());
+
+    if options.max_fragmented_message_size != 0 {
+        gateway = gateway.max_fragmented_message_size(options.max_fragmented_message_size);
+    }
+
+    if let Some(limits) = options.video_limits {
+        gateway = gateway.video_limits(limits.into());
+    }
 
     // A value of 0 means "unset" — leave it off so the SDK applies its default.
     if options.max_data_track_message_size != 0 {
@@ -885,6 +1083,21 @@ unsafe fn do_foxglove_gateway_start(
         gateway = gateway.video_encoder(options.video_encoder.into());
     }
 
+    if options.video_simulcast {
+        gateway = gateway.video_simulcast(true);
+    }
+
+    if options.pack_linger_us != 0 {
+        gateway = gateway.pack_small_messages(Duration::from_micros(options.pack_linger_us));
+    }
+
+    let cache_path = unsafe { options.device_info_cache_path.as_utf8_str() }.map_err(|e| {
+        foxglove::FoxgloveError::Utf8Error(format!("device_info_cache_path is invalid: {e}"))
+    })?;
+    if !cache_path.is_empty() {
+        gateway = gateway.device_info_cache(cache_path);
+    }
+
     let handle = gateway.start()?;
     Ok(Box::into_raw(Box::new(FoxgloveGateway(Some(handle)))))
 }
@@ -1120,3 +1333,38 @@ pub extern "C" fn foxglove_gateway_publish_connection_graph(
         Err(e) => FoxgloveError::from(e),
     }
 }
+
+/// Apply a connection graph patch to the connection graph published by the gateway, and send the
+/// changes to subscribed clients.
+///
+/// Requires `FOXGLOVE_GATEWAY_CAPABILITY_CONNECTION_GRAPH`.
+///
+/// The patch is consumed by this call, even if it fails, and must not be used or freed
+/// afterwards.
+///
+/// # Safety
+/// `patch` must be a valid pointer to a `foxglove_connection_graph_patch` created by
+/// `foxglove_connection_graph_patch_create`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_gateway_update_connection_graph(
+    gateway: Option<&FoxgloveGateway>,
+    patch: *mut FoxgloveConnectionGraphPatch,
+) -> FoxgloveError {
+    if patch.is_null() {
+        tracing::error!("foxglove_gateway_update_connection_graph called with null patch");
+        return FoxgloveError::ValueError;
+    }
+    let patch = unsafe { Box::from_raw(patch) };
+    let Some(gateway) = gateway else {
+        tracing::error!("foxglove_gateway_update_connection_graph called with null gateway");
+        return FoxgloveError::ValueError;
+    };
+    let Some(handle) = gateway.as_ref() else {
+        tracing::error!("foxglove_gateway_update_connection_graph called with closed gateway");
+        return FoxgloveError::SinkClosed;
+    };
+    match handle.update_connection_graph(patch.0) {
+        Ok(_) => FoxgloveError::Ok,
+        Err(e) => FoxgloveError::from(e),
+    }
+}
@@ -11,7 +11,7 @@ use crate::util::{bytes_from_raw, string_from_raw, vec_from_raw};
 #[cfg(not(target_family = "wasm"))]
 use crate::{
     FoxgloveChannel, FoxgloveContext, FoxgloveSinkId, do_foxglove_channel_create,
-    log_msg_to_channel, result_to_c,
+    foxglove_channel_should_log, log_msg_to_channel, result_to_c,
 };
 use crate::{FoxgloveDuration, FoxgloveError, FoxgloveSchema, FoxgloveString, FoxgloveTimestamp};
 
@@ -163,6 +163,10 @@ pub extern "C" fn foxglove_channel_log_arrow_primitive(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -404,6 +408,10 @@ pub extern "C" fn foxglove_channel_log_camera_calibration(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -595,6 +603,10 @@ pub extern "C" fn foxglove_channel_log_circle_annotation(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -751,6 +763,10 @@ pub extern "C" fn foxglove_channel_log_color(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -920,6 +936,10 @@ pub extern "C" fn foxglove_channel_log_compressed_audio(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -1095,6 +1115,10 @@ pub extern "C" fn foxglove_channel_log_compressed_image(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -1283,6 +1307,10 @@ pub extern "C" fn foxglove_channel_log_compressed_point_cloud(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -1484,6 +1512,10 @@ pub extern "C" fn foxglove_channel_log_compressed_video(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -1664,6 +1696,10 @@ pub extern "C" fn foxglove_channel_log_cylinder_primitive(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -1836,6 +1872,10 @@ pub extern "C" fn foxglove_channel_log_cube_primitive(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -1991,6 +2031,10 @@ pub extern "C" fn foxglove_channel_log_event(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -2184,6 +2228,10 @@ pub extern "C" fn foxglove_channel_log_frame_transform(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -2332,6 +2380,10 @@ pub extern "C" fn foxglove_channel_log_frame_transforms(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -2484,6 +2536,10 @@ pub extern "C" fn foxglove_channel_log_geo_json(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -2723,6 +2779,10 @@ pub extern "C" fn foxglove_channel_log_grid(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -2935,6 +2995,10 @@ pub extern "C" fn foxglove_channel_log_voxel_grid(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -3104,6 +3168,10 @@ pub extern "C" fn foxglove_channel_log_image_annotations(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -3268,6 +3336,10 @@ pub extern "C" fn foxglove_channel_log_joint_state(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -3419,6 +3491,10 @@ pub extern "C" fn foxglove_channel_log_joint_states(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -3571,6 +3647,10 @@ pub extern "C" fn foxglove_channel_log_key_value_pair(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -3760,6 +3840,10 @@ pub extern "C" fn foxglove_channel_log_laser_scan(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -3954,6 +4038,10 @@ pub extern "C" fn foxglove_channel_log_line_primitive(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -4166,6 +4254,10 @@ pub extern "C" fn foxglove_channel_log_location_fix(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -4313,6 +4405,10 @@ pub extern "C" fn foxglove_channel_log_location_fixes(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -4489,6 +4585,10 @@ pub extern "C" fn foxglove_channel_log_log(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -4644,6 +4744,10 @@ pub extern "C" fn foxglove_channel_log_scene_entity_deletion(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -4868,6 +4972,10 @@ pub extern "C" fn foxglove_channel_log_scene_entity(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -5021,6 +5129,10 @@ pub extern "C" fn foxglove_channel_log_scene_update(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -5217,6 +5329,10 @@ pub extern "C" fn foxglove_channel_log_model_primitive(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -5438,6 +5554,10 @@ pub extern "C" fn foxglove_channel_log_odometry(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -5594,6 +5714,10 @@ pub extern "C" fn foxglove_channel_log_packed_element_field(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -5742,6 +5866,10 @@ pub extern "C" fn foxglove_channel_log_point2(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -5893,6 +6021,10 @@ pub extern "C" fn foxglove_channel_log_point3(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -6059,6 +6191,10 @@ pub extern "C" fn foxglove_channel_log_point3_in_frame(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -6241,6 +6377,10 @@ pub extern "C" fn foxglove_channel_log_point_cloud(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -6437,6 +6577,10 @@ pub extern "C" fn foxglove_channel_log_points_annotation(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -6598,6 +6742,10 @@ pub extern "C" fn foxglove_channel_log_pose(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -6764,6 +6912,10 @@ pub extern "C" fn foxglove_channel_log_pose_in_frame(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -6926,6 +7078,10 @@ pub extern "C" fn foxglove_channel_log_poses_in_frame(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -7083,6 +7239,10 @@ pub extern "C" fn foxglove_channel_log_quaternion(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -7251,6 +7411,10 @@ pub extern "C" fn foxglove_channel_log_raw_audio(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -7496,6 +7660,10 @@ pub extern "C" fn foxglove_channel_log_raw_image(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -7667,6 +7835,10 @@ pub extern "C" fn foxglove_channel_log_sphere_primitive(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -7860,6 +8032,10 @@ pub extern "C" fn foxglove_channel_log_text_annotation(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -8040,6 +8216,10 @@ pub extern "C" fn foxglove_channel_log_text_primitive(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -8226,6 +8406,10 @@ pub extern "C" fn foxglove_channel_log_triangle_list_primitive(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -8374,6 +8558,10 @@ pub extern "C" fn foxglove_channel_log_vector2(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -8525,6 +8713,10 @@ pub extern "C" fn foxglove_channel_log_vector3(
     log_time: Option<&u64>,
     sink_id: FoxgloveSinkId,
 ) -> FoxgloveError {
+    // Skip converting the message if no sink would receive it.
+    if !foxglove_channel_should_log(channel) {
+        return FoxgloveError::Ok;
+    }
     let mut arena = pin!(Arena::new());
     let arena_pin = arena.as_mut();
     // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -0,0 +1,222 @@
+//! C FFI bindings for [`foxglove::latency::LatencyTracer`].
+
+use foxglove::latency::{LatencyStage, LatencyStats, LatencyTracer, LatencyTracerHandle};
+
+use crate::{FoxgloveError, FoxgloveSinkId, FoxgloveString, result_to_c};
+
+/// Opaque handle to an installed latency tracer.
+///
+/// The handle is created by [`foxglove_latency_tracer_install`], and freed by
+/// [`foxglove_latency_tracer_free`], which uninstalls the tracer.
+pub struct FoxgloveLatencyTracer(LatencyTracerHandle);
+
+/// A snapshot of the latency percentiles recorded by a tracer.
+///
+/// The snapshot is created by [`foxglove_latency_tracer_get_stats`], and freed by
+/// [`foxglove_latency_stats_free`].
+pub struct FoxgloveLatencyStatsSnapshot(Vec<FoxgloveLatencyStats>);
+
+/// A stage of a message's delivery by a sink.
+#[repr(u8)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum FoxgloveLatencyStage {
+    /// From the call to log to the message being queued by the sink.
+    Serialize,
+    /// Time spent waiting in the sink's queue.
+    Queue,
+    /// From the message being taken from the queue to it being sent or written.
+    Io,
+    /// From the call to log to the message being sent or written.
+    Total,
+}
+
+impl From<LatencyStage> for FoxgloveLatencyStage {
+    fn from(stage: LatencyStage) -> Self {
+        match stage {
+            LatencyStage::Serialize => Self::Serialize,
+            LatencyStage::Queue => Self::Queue,
+            LatencyStage::Io => Self::Io,
+            LatencyStage::Total => Self::Total,
+        }
+    }
+}
+
+/// Latency percentiles for one stage of the messages logged to a channel and delivered by a sink.
+#[repr(C)]
+pub struct FoxgloveLatencyStats {
+    /// The sink which delivered the messages.
+    pub sink_id: FoxgloveSinkId,
+    /// The channel the messages were logged to.
+    pub channel_id: u64,
+    /// The stage of delivery.
+    pub stage: FoxgloveLatencyStage,
+    /// The number of sampled messages.
+    pub count: u64,
+    /// The median latency, in nanoseconds.
+    pub p50_ns: u64,
+    /// The 99th percentile latency, in nanoseconds.
+    pub p99_ns: u64,
+    /// The 99.9th percentile latency, in nanoseconds.
+    pub p999_ns: u64,
+    /// The largest latency, in nanoseconds.
+    pub max_ns: u64,
+}
+
+impl From<&LatencyStats> for FoxgloveLatencyStats {
+    fn from(stats: &LatencyStats) -> Self {
+        let nanos = |d: std::time::Duration| u64::try_from(d.as_nanos()).unwrap_or(u64::MAX);
+        Self {
+            sink_id: stats.sink_id.into(),
+            channel_id: stats.channel_id.into(),
+            stage: stats.stage.into(),
+            count: stats.count,
+            p50_ns: nanos(stats.p50),
+            p99_ns: nanos(stats.p99),
+            p999_ns: nanos(stats.p999),
+            max_ns: nanos(stats.max),
+        }
+    }
+}
+
+/// Options for [`foxglove_latency_tracer_install`].
+///
+/// All fields are optional. To use the default for any field, leave the field zero-initialized.
+#[repr(C)]
+pub struct FoxgloveLatencyTracerOptions {
+    /// Sample one in every `sample_every` logged messages. When zero, defaults to 100.
+    pub sample_every: u32,
+    /// The number of recent samples retained for the Chrome trace export. When zero, defaults to
+    /// 10000.
+    pub trace_capacity: usize,
+}
+
+/// Install a latency tracer, replacing any previously installed tracer.
+///
+/// On success, writes a non-null handle to `out_tracer`, which must be freed with
+/// [`foxglove_latency_tracer_free`].
+///
+/// # Safety
+/// - `options`, when non-null, must be a valid pointer to a [`FoxgloveLatencyTracerOptions`].
+/// - `out_tracer` must be a valid, writable pointer to a `*mut FoxgloveLatencyTracer`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_latency_tracer_install(
+    options: Option<&FoxgloveLatencyTracerOptions>,
+    out_tracer: *mut *mut FoxgloveLatencyTracer,
+) -> FoxgloveError {
+    let mut builder = LatencyTracer::new();
+    if let Some(options) = options {
+        if options.sample_every > 0 {
+            builder = builder.sample_every(options.sample_every);
+        }
+        if options.trace_capacity > 0 {
+            builder = builder.trace_capacity(options.trace_capacity);
+        }
+    }
+    let result = Ok(Box::into_raw(Box::new(FoxgloveLatencyTracer(
+        builder.install(),
+    ))));
+    unsafe { result_to_c(result, out_tracer) }
+}
+
+/// Uninstall a latency tracer and free its resources.
+///
+/// If another tracer has since been installed, that tracer remains installed. Passing a null
+/// pointer is a no-op.
+///
+/// # Safety
+/// `tracer` must be a handle returned by [`foxglove_latency_tracer_install`], or null.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_latency_tracer_free(tracer: *mut FoxgloveLatencyTracer) {
+    if !tracer.is_null() {
+        drop(unsafe { Box::from_raw(tracer) });
+    }
+}
+
+/// Discard the samples recorded so far.
+#[unsafe(no_mangle)]
+pub extern "C" fn foxglove_latency_tracer_clear(tracer: Option<&FoxgloveLatencyTracer>) {
+    if let Some(tracer) = tracer {
+        tracer.0.clear();
+    }
+}
+
+/// Get a snapshot of the latency percentiles for each sink, channel and stage.
+///
+/// On success, writes a non-null snapshot to `stats`, which must be freed with
+/// [`foxglove_latency_stats_free`].
+///
+/// # Safety
+/// `stats` must be a valid, writable pointer.
+#[unsafe(no_mangle)]
+#[must_use]
+pub unsafe extern "C" fn foxglove_latency_tracer_get_stats(
+    tracer: Option<&FoxgloveLatencyTracer>,
+    stats: *mut *mut FoxgloveLatencyStatsSnapshot,
+) -> FoxgloveError {
+    let Some(tracer) = tracer else {
+        tracing::error!("foxglove_latency_tracer_get_stats called with null tracer");
+        return FoxgloveError::ValueError;
+    };
+    let entries = tracer.0.stats().iter().map(Into::into).collect();
+    let result = Ok(Box::into_raw(Box::new(FoxgloveLatencyStatsSnapshot(
+        entries,
+    ))));
+    unsafe { result_to_c(result, stats) }
+}
+
+/// Get the entries of a snapshot, ordered by sink, channel and stage.
+///
+/// Writes the number of entries to `count`, and returns a pointer to the first, which is valid
+/// until the snapshot is freed.
+///
+/// # Safety
+/// - `stats` must be a valid pointer to a snapshot created with
+///   [`foxglove_latency_tracer_get_stats`].
+/// - `count` must be a valid pointer to a `size_t`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_latency_stats_entries(
+    stats: Option<&FoxgloveLatencyStatsSnapshot>,
+    count: &mut usize,
+) -> *const FoxgloveLatencyStats {
+    let Some(stats) = stats else {
+        *count = 0;
+        return std::ptr::null();
+    };
+    *count = stats.0.len();
+    stats.0.as_ptr()
+}
+
+/// Free a snapshot created with [`foxglove_latency_tracer_get_stats`].
+///
+/// # Safety
+/// `stats` must be a pointer returned by [`foxglove_latency_tracer_get_stats`], or null.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_latency_stats_free(stats: *mut FoxgloveLatencyStatsSnapshot) {
+    if !stats.is_null() {
+        drop(unsafe { Box::from_raw(stats) });
+    }
+}
+
+/// Write the most recent samples to a file, in the Chrome trace event format.
+///
+/// The file can be opened in Perfetto or `chrome://tracing`.
+///
+/// # Safety
+/// `path` must be a valid UTF-8 string.
+#[unsafe(no_mangle)]
+#[must_use]
+pub unsafe extern "C" fn foxglove_latency_tracer_write_chrome_trace(
+    tracer: Option<&FoxgloveLatencyTracer>,
+    path: FoxgloveString,
+) -> FoxgloveError {
+    let Some(tracer) = tracer else {
+        tracing::error!("foxglove_latency_tracer_write_chrome_trace called with null tracer");
+        return FoxgloveError::ValueError;
+    };
+    let result = unsafe { path.as_utf8_str() }
+        .map_err(|e| foxglove::FoxgloveError::Utf8Error(format!("path invalid: {e}")))
+        .and_then(|path| {
+            std::fs::write(path, tracer.0.chrome_trace()).map_err(foxglove::FoxgloveError::IoError)
+        });
+    unsafe { result_to_c(result, std::ptr::null_mut()) }
+}
@@ -18,14 +18,24 @@ mod channel;
 #[cfg(not(target_family = "wasm"))]
 mod channel_descriptor;
 #[cfg(not(target_family = "wasm"))]
+mod clock;
+#[cfg(not(target_family = "wasm"))]
 mod connection_graph;
 #[cfg(not(target_family = "wasm"))]
 mod fetch_asset;
 #[cfg(feature = "remote-access")]
 mod gateway;
 #[cfg(not(target_family = "wasm"))]
+mod latency;
+#[cfg(not(target_family = "wasm"))]
 mod logging;
 #[cfg(not(target_family = "wasm"))]
+mod mcap_reader;
+#[cfg(not(target_family = "wasm"))]
+mod memory_budget;
+#[cfg(not(target_family = "wasm"))]
+mod message_filter;
+#[cfg(not(target_family = "wasm"))]
 mod parameter;
 #[cfg(not(target_family = "wasm"))]
 mod parameter_handler;
@@ -34,10 +44,18 @@ mod playback_control_request;
 #[cfg(not(target_family = "wasm"))]
 mod playback_state;
 #[cfg(not(target_family = "wasm"))]
+mod ring_buffer;
+#[cfg(not(target_family = "wasm"))]
+mod runtime;
+#[cfg(not(target_family = "wasm"))]
+mod sdk_stats;
+#[cfg(not(target_family = "wasm"))]
 mod server;
 #[cfg(not(target_family = "wasm"))]
 mod service;
 #[cfg(not(target_family = "wasm"))]
+mod shared_memory;
+#[cfg(not(target_family = "wasm"))]
 mod sink_channel_filter;
 #[cfg(not(target_family = "wasm"))]
 mod system_info;
@@ -48,6 +66,9 @@ pub use server::*;
 #[cfg(not(target_family = "wasm"))]
 pub use channel::*;
 
+#[cfg(not(target_family = "wasm"))]
+pub use sdk_stats::*;
+
 #[cfg(not(target_family = "wasm"))]
 pub use system_info::*;
 
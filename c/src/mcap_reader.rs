@@ -0,0 +1,486 @@
+//! C FFI bindings for [`foxglove::McapReader`].
+
+use foxglove::{
+    McapMergedMessages, McapMessage, McapMessages, McapReadOptions, McapReadOrder, McapReader,
+};
+
+use crate::{
+    FoxgloveChannelMetadata, FoxgloveError, FoxgloveKeyValue, FoxgloveSchema, FoxgloveString,
+    result_to_c,
+};
+
+/// A reader for a finished MCAP file.
+///
+/// The reader is created by [`foxglove_mcap_reader_open`], and freed by
+/// [`foxglove_mcap_reader_free`].
+pub struct FoxgloveMcapReader {
+    reader: McapReader,
+    channels: Vec<FoxgloveMcapReaderChannel>,
+    // The metadata and schemas which `channels` point to.
+    _metadata: Vec<Vec<FoxgloveKeyValue>>,
+    _schemas: Vec<Box<FoxgloveSchema>>,
+}
+
+/// A channel in an MCAP file.
+///
+/// Its fields are valid until the reader is freed.
+#[repr(C)]
+pub struct FoxgloveMcapReaderChannel {
+    /// The channel id, unique within the file.
+    pub id: u16,
+    /// The channel topic.
+    pub topic: FoxgloveString,
+    /// The encoding of the channel's messages.
+    pub message_encoding: FoxgloveString,
+    /// The channel metadata.
+    pub metadata: FoxgloveChannelMetadata,
+    /// The channel's schema, or null if it has none.
+    pub schema: *const FoxgloveSchema,
+}
+
+/// The order in which messages are read from an MCAP file.
+#[repr(u8)]
+#[derive(Clone, Copy)]
+pub enum FoxgloveMcapReadOrder {
+    /// Messages are read in order of log time.
+    LogTime,
+    /// Messages are read in the order they appear in the file.
+    File,
+}
+
+impl From<FoxgloveMcapReadOrder> for McapReadOrder {
+    fn from(value: FoxgloveMcapReadOrder) -> Self {
+        match value {
+            FoxgloveMcapReadOrder::LogTime => Self::LogTime,
+            FoxgloveMcapReadOrder::File => Self::File,
+        }
+    }
+}
+
+/// Options for [`foxglove_mcap_reader_messages`] and [`foxglove_mcap_reader_merge`].
+///
+/// To use the default for any field, leave the field zero-initialized.
+#[repr(C)]
+pub struct FoxgloveMcapReadOptions<'a> {
+    /// Only read messages logged at or after this time, in nanoseconds. Ignored if null.
+    pub start_time: Option<&'a u64>,
+    /// Only read messages logged before this time, in nanoseconds. Ignored if null.
+    pub end_time: Option<&'a u64>,
+    /// Only read messages on these topics. If null, messages on all topics are read.
+    pub topics: *const FoxgloveString,
+    /// The number of topics in `topics`.
+    pub topics_count: usize,
+    /// The order in which messages are read.
+    pub order: FoxgloveMcapReadOrder,
+    /// Number of chunks to decompress in parallel. Values less than 2 decompress chunks on the
+    /// thread which calls [`foxglove_mcap_message_iter_next`].
+    pub decompression_threads: usize,
+}
+
+/// A message read from an MCAP file.
+#[repr(C)]
+pub struct FoxgloveMcapMessage {
+    /// The id of the channel the message was logged to.
+    pub channel_id: u16,
+    /// The message sequence number.
+    pub sequence: u32,
+    /// The time the message was logged, in nanoseconds.
+    pub log_time: u64,
+    /// The time the message was published, in nanoseconds.
+    pub publish_time: u64,
+    /// The message data. Valid until the next call to [`foxglove_mcap_message_iter_next`] or
+    /// [`foxglove_mcap_message_iter_free`].
+    pub data: *const u8,
+    /// The length of the message data.
+    pub data_len: usize,
+    /// The index of the reader the message was read from, for iterators created with
+    /// [`foxglove_mcap_reader_merge`]. Zero for other iterators.
+    pub reader_index: usize,
+}
+
+/// An iterator over the messages in one or more MCAP files.
+///
+/// The iterator is created by [`foxglove_mcap_reader_messages`] or
+/// [`foxglove_mcap_reader_merge`], and freed by [`foxglove_mcap_message_iter_free`]. It may
+/// outlive the readers it was created from.
+pub struct FoxgloveMcapMessageIterator {
+    messages: Messages,
+    // The last message returned, which keeps its data alive.
+    current: Option<McapMessage>,
+}
+
+enum Messages {
+    File(McapMessages),
+    Merged(McapMergedMessages),
+    Latest(std::vec::IntoIter<McapMessage>),
+}
+
+impl Iterator for Messages {
+    type Item = Result<(usize, McapMessage), foxglove::FoxgloveError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        match self {
+            Self::File(messages) => messages.next().map(|message| message.map(|m| (0, m))),
+            Self::Merged(messages) => messages.next(),
+            Self::Latest(messages) => messages.next().map(|message| Ok((0, message))),
+        }
+    }
+}
+
+/// Open a finished MCAP file for reading.
+///
+/// The file is memory-mapped, so it must not be truncated while it is being read. Unfinished
+/// files must be repaired with `foxglove_mcap_recover` first.
+///
+/// On success, writes the reader to `reader`. The reader must be freed with
+/// [`foxglove_mcap_reader_free`].
+///
+/// # Safety
+/// - `path` must be a valid pointer to a UTF-8 string.
+/// - `reader` must be a valid pointer to a `foxglove_mcap_reader*`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_reader_open(
+    path: &FoxgloveString,
+    reader: *mut *mut FoxgloveMcapReader,
+) -> FoxgloveError {
+    let result = unsafe { do_foxglove_mcap_reader_open(path) };
+    unsafe { result_to_c(result, reader) }
+}
+
+unsafe fn do_foxglove_mcap_reader_open(
+    path: &FoxgloveString,
+) -> Result<*mut FoxgloveMcapReader, foxglove::FoxgloveError> {
+    let path = unsafe { path.as_utf8_str() }
+        .map_err(|e| foxglove::FoxgloveError::Utf8Error(format!("path is invalid: {e}")))?;
+    let reader = McapReader::open(path)?;
+
+    let mut channels = Vec::new();
+    let mut metadata = Vec::new();
+    let mut schemas = Vec::new();
+    for channel in reader.channels() {
+        let items: Vec<_> = channel
+            .metadata
+            .iter()
+            .map(|(key, value)| FoxgloveKeyValue {
+                key: key.into(),
+                value: value.into(),
+            })
+            .collect();
+        let schema = channel.schema.as_ref().map(|schema| {
+            Box::new(FoxgloveSchema {
+                name: FoxgloveString::from(&schema.name),
+                encoding: FoxgloveString::from(&schema.encoding),
+                data: schema.data.as_ptr(),
+                data_len: schema.data.len(),
+            })
+        });
+        channels.push(FoxgloveMcapReaderChannel {
+            id: channel.id,
+            topic: FoxgloveString::from(&channel.topic),
+            message_encoding: FoxgloveString::from(&channel.message_encoding),
+            metadata: FoxgloveChannelMetadata {
+                items: items.as_ptr(),
+                count: items.len(),
+            },
+            schema: schema
+                .as_deref()
+                .map_or(std::ptr::null(), |schema| schema as *const _),
+        });
+        metadata.push(items);
+        schemas.extend(schema);
+    }
+    Ok(Box::into_raw(Box::new(FoxgloveMcapReader {
+        reader,
+        channels,
+        _metadata: metadata,
+        _schemas: schemas,
+    })))
+}
+
+/// Free a reader created with [`foxglove_mcap_reader_open`].
+///
+/// Message iterators created from the reader remain valid.
+///
+/// # Safety
+/// `reader` must be a pointer returned by [`foxglove_mcap_reader_open`], or null.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_reader_free(reader: *mut FoxgloveMcapReader) {
+    if !reader.is_null() {
+        // Safety: undo the Box::into_raw in foxglove_mcap_reader_open.
+        drop(unsafe { Box::from_raw(reader) });
+    }
+}
+
+/// Get the channels of an MCAP file, in order of id.
+///
+/// Writes the number of channels to `count`, and returns a pointer to the first, which is valid
+/// until the reader is freed.
+///
+/// # Safety
+/// - `reader` must be a valid pointer to a reader created with [`foxglove_mcap_reader_open`].
+/// - `count` must be a valid pointer to a `size_t`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_reader_channels(
+    reader: Option<&FoxgloveMcapReader>,
+    count: &mut usize,
+) -> *const FoxgloveMcapReaderChannel {
+    let Some(reader) = reader else {
+        *count = 0;
+        return std::ptr::null();
+    };
+    *count = reader.channels.len();
+    reader.channels.as_ptr()
+}
+
+/// Get the earliest and latest message log times in an MCAP file, from its chunk indexes.
+///
+/// Returns true and writes the times to `start_time` and `end_time` if they are known. Returns
+/// false if the file has no chunk indexes or no messages.
+///
+/// # Safety
+/// - `reader` must be a valid pointer to a reader created with [`foxglove_mcap_reader_open`].
+/// - `start_time` and `end_time` must be valid pointers to `uint64_t`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_reader_time_range(
+    reader: Option<&FoxgloveMcapReader>,
+    start_time: &mut u64,
+    end_time: &mut u64,
+) -> bool {
+    let Some((start, end)) = reader.and_then(|reader| reader.reader.time_range()) else {
+        return false;
+    };
+    *start_time = start;
+    *end_time = end;
+    true
+}
+
+/// Create an iterator over the messages of an MCAP file which match the options.
+///
+/// On success, writes the iterator to `iter`. The iterator must be freed with
+/// [`foxglove_mcap_message_iter_free`].
+///
+/// # Safety
+/// - `reader` must be a valid pointer to a reader created with [`foxglove_mcap_reader_open`].
+/// - `options` must be a valid pointer to a `foxglove_mcap_read_options`, or null to use the
+///   default options.
+/// - If `options->topics` is not null, it must point to `options->topics_count` valid UTF-8
+///   strings.
+/// - `iter` must be a valid pointer to a `foxglove_mcap_message_iterator*`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_reader_messages(
+    reader: Option<&FoxgloveMcapReader>,
+    options: Option<&FoxgloveMcapReadOptions>,
+    iter: *mut *mut FoxgloveMcapMessageIterator,
+) -> FoxgloveError {
+    let result = unsafe { do_foxglove_mcap_reader_messages(reader, options) };
+    unsafe { result_to_c(result, iter) }
+}
+
+unsafe fn do_foxglove_mcap_reader_messages(
+    reader: Option<&FoxgloveMcapReader>,
+    options: Option<&FoxgloveMcapReadOptions>,
+) -> Result<*mut FoxgloveMcapMessageIterator, foxglove::FoxgloveError> {
+    let Some(reader) = reader else {
+        return Err(foxglove::FoxgloveError::ValueError(
+            "reader is null".to_string(),
+        ));
+    };
+    let read_options = unsafe { to_read_options(options) }?;
+    Ok(Box::into_raw(Box::new(FoxgloveMcapMessageIterator {
+        messages: Messages::File(reader.reader.messages(&read_options)),
+        current: None,
+    })))
+}
+
+/// Create an iterator over the latest message logged before `time` on each channel of an MCAP
+/// file, in order of log time.
+///
+/// Only the `topics` option is used. Chunks are read from the latest to the earliest, and the
+/// chunk indexes are used to skip chunks which cannot hold a later message on a channel still
+/// missing one. The messages are read before this function returns.
+///
+/// On success, writes the iterator to `iter`. The iterator must be freed with
+/// [`foxglove_mcap_message_iter_free`].
+///
+/// # Safety
+/// - `reader` must be a valid pointer to a reader created with [`foxglove_mcap_reader_open`].
+/// - `options` must be a valid pointer to a `foxglove_mcap_read_options`, or null to use the
+///   default options.
+/// - If `options->topics` is not null, it must point to `options->topics_count` valid UTF-8
+///   strings.
+/// - `iter` must be a valid pointer to a `foxglove_mcap_message_iterator*`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_reader_latest_messages(
+    reader: Option<&FoxgloveMcapReader>,
+    time: u64,
+    options: Option<&FoxgloveMcapReadOptions>,
+    iter: *mut *mut FoxgloveMcapMessageIterator,
+) -> FoxgloveError {
+    let result = unsafe { do_foxglove_mcap_reader_latest_messages(reader, time, options) };
+    unsafe { result_to_c(result, iter) }
+}
+
+unsafe fn do_foxglove_mcap_reader_latest_messages(
+    reader: Option<&FoxgloveMcapReader>,
+    time: u64,
+    options: Option<&FoxgloveMcapReadOptions>,
+) -> Result<*mut FoxgloveMcapMessageIterator, foxglove::FoxgloveError> {
+    let Some(reader) = reader else {
+        return Err(foxglove::FoxgloveError::ValueError(
+            "reader is null".to_string(),
+        ));
+    };
+    let read_options = unsafe { to_read_options(options) }?;
+    let messages = reader
+        .reader
+        .latest_messages(time, read_options.topics.as_deref())?;
+    Ok(Box::into_raw(Box::new(FoxgloveMcapMessageIterator {
+        messages: Messages::Latest(messages.into_iter()),
+        current: None,
+    })))
+}
+
+/// Create an iterator over the messages of several MCAP files which match the options, merged
+/// in order of log time.
+///
+/// The `order` option is ignored. Each file's chunks are read as the merge reaches them, so only
+/// the chunks which overlap the current log time are held in memory. Messages with the same log
+/// time are returned in the order of their readers, and each message's `reader_index` is the
+/// index of its reader in `readers`.
+///
+/// On success, writes the iterator to `iter`. The iterator must be freed with
+/// [`foxglove_mcap_message_iter_free`].
+///
+/// # Safety
+/// - `readers` must point to `readers_count` valid pointers to readers created with
+///   [`foxglove_mcap_reader_open`].
+/// - `options` must be a valid pointer to a `foxglove_mcap_read_options`, or null to use the
+///   default options.
+/// - If `options->topics` is not null, it must point to `options->topics_count` valid UTF-8
+///   strings.
+/// - `iter` must be a valid pointer to a `foxglove_mcap_message_iterator*`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_reader_merge(
+    readers: *const *const FoxgloveMcapReader,
+    readers_count: usize,
+    options: Option<&FoxgloveMcapReadOptions>,
+    iter: *mut *mut FoxgloveMcapMessageIterator,
+) -> FoxgloveError {
+    let result = unsafe { do_foxglove_mcap_reader_merge(readers, readers_count, options) };
+    unsafe { result_to_c(result, iter) }
+}
+
+unsafe fn do_foxglove_mcap_reader_merge(
+    readers: *const *const FoxgloveMcapReader,
+    readers_count: usize,
+    options: Option<&FoxgloveMcapReadOptions>,
+) -> Result<*mut FoxgloveMcapMessageIterator, foxglove::FoxgloveError> {
+    if readers.is_null() && readers_count > 0 {
+        return Err(foxglove::FoxgloveError::ValueError(
+            "readers is null".to_string(),
+        ));
+    }
+    let readers: &[*const FoxgloveMcapReader] = if readers_count == 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(readers, readers_count) }
+    };
+    let readers = readers
+        .iter()
+        .map(|&reader| {
+            unsafe { reader.as_ref() }
+                .map(|reader| reader.reader.clone())
+                .ok_or_else(|| foxglove::FoxgloveError::ValueError("reader is null".to_string()))
+        })
+        .collect::<Result<Vec<_>, _>>()?;
+    let read_options = unsafe { to_read_options(options) }?;
+    Ok(Box::into_raw(Box::new(FoxgloveMcapMessageIterator {
+        messages: Messages::Merged(McapReader::merge(&readers, &read_options)),
+        current: None,
+    })))
+}
+
+unsafe fn to_read_options(
+    options: Option<&FoxgloveMcapReadOptions>,
+) -> Result<McapReadOptions, foxglove::FoxgloveError> {
+    let mut read_options = McapReadOptions::default();
+    if let Some(options) = options {
+        read_options.start_time = options.start_time.copied();
+        read_options.end_time = options.end_time.copied();
+        if !options.topics.is_null() {
+            let topics =
+                unsafe { std::slice::from_raw_parts(options.topics, options.topics_count) };
+            let topics = topics
+                .iter()
+                .map(|topic| unsafe { topic.as_utf8_str() }.map(str::to_string))
+                .collect::<Result<_, _>>()
+                .map_err(|e| {
+                    foxglove::FoxgloveError::Utf8Error(format!("topic is invalid: {e}"))
+                })?;
+            read_options.topics = Some(topics);
+        }
+        read_options.order = options.order.into();
+        read_options.decompression_threads = options.decompression_threads;
+    }
+    Ok(read_options)
+}
+
+/// Read the next message from an iterator.
+///
+/// Writes true to `has_message` and the message to `message` if there is a next message, or
+/// false to `has_message` once all messages have been read. If an error is returned, the
+/// iterator is exhausted.
+///
+/// # Safety
+/// - `iter` must be a valid pointer to an iterator created with
+///   [`foxglove_mcap_reader_messages`] or [`foxglove_mcap_reader_merge`].
+/// - `message` must be a valid pointer to a `foxglove_mcap_message`.
+/// - `has_message` must be a valid pointer to a `bool`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_message_iter_next(
+    iter: Option<&mut FoxgloveMcapMessageIterator>,
+    message: &mut FoxgloveMcapMessage,
+    has_message: &mut bool,
+) -> FoxgloveError {
+    *has_message = false;
+    let Some(iter) = iter else {
+        return FoxgloveError::ValueError;
+    };
+    iter.current = None;
+    match iter.messages.next() {
+        Some(Ok((reader_index, next))) => {
+            *message = FoxgloveMcapMessage {
+                channel_id: next.channel.id,
+                sequence: next.sequence,
+                log_time: next.log_time,
+                publish_time: next.publish_time,
+                data: next.data.as_ptr(),
+                data_len: next.data.len(),
+                reader_index,
+            };
+            iter.current = Some(next);
+            *has_message = true;
+            FoxgloveError::Ok
+        }
+        Some(Err(e)) => {
+            tracing::error!("{}", e);
+            e.into()
+        }
+        None => FoxgloveError::Ok,
+    }
+}
+
+/// Free an iterator created with [`foxglove_mcap_reader_messages`] or
+/// [`foxglove_mcap_reader_merge`].
+///
+/// # Safety
+/// `iter` must be a pointer returned by [`foxglove_mcap_reader_messages`] or
+/// [`foxglove_mcap_reader_merge`], or null.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_mcap_message_iter_free(iter: *mut FoxgloveMcapMessageIterator) {
+    if !iter.is_null() {
+        // Safety: undo the Box::into_raw in foxglove_mcap_reader_messages or
+        // foxglove_mcap_reader_merge.
+        drop(unsafe { Box::from_raw(iter) });
+    }
+}
@@ -0,0 +1,139 @@
+//! C FFI bindings for the memory budget of a context.
+
+use foxglove::{MemoryBudget, MemoryPool, MemoryPoolUsage};
+
+use crate::clock::with_context;
+use crate::{FoxgloveContext, FoxgloveError};
+
+/// A limit on the bytes buffered by the sinks of a context.
+///
+/// The budget applies to the messages which WebSocket clients, remote access participants, and
+/// MCAP writers hold until they can be sent or written. When a sink would exceed the budget, or
+/// its pool's share of it, it drops messages or blocks according to its own overflow policy.
+///
+/// Each share is the fraction of the budget, between 0 and 1, which the sinks of a pool may use.
+/// A share of zero leaves the pool limited only by the total budget.
+#[repr(C)]
+pub struct FoxgloveMemoryBudget {
+    /// The total number of bytes in the budget.
+    pub bytes: usize,
+    /// The share of the budget for the backlogs of WebSocket server clients.
+    pub websocket_share: f64,
+    /// The share of the budget for the backlogs of remote access participants.
+    pub remote_access_share: f64,
+    /// The share of the budget for the queues, open chunks, and pending output of MCAP writers.
+    pub mcap_share: f64,
+}
+
+impl FoxgloveMemoryBudget {
+    fn to_native(&self) -> MemoryBudget {
+        let mut budget = MemoryBudget::new(self.bytes);
+        for (pool, share) in [
+            (MemoryPool::WebSocket, self.websocket_share),
+            (MemoryPool::RemoteAccess, self.remote_access_share),
+            (MemoryPool::Mcap, self.mcap_share),
+        ] {
+            if share > 0.0 {
+                budget = budget.share(pool, share);
+            }
+        }
+        budget
+    }
+}
+
+/// The bytes buffered by the sinks of a pool. See [`FoxgloveMemoryUsage`].
+#[repr(C)]
+#[derive(Default)]
+pub struct FoxgloveMemoryPoolUsage {
+    /// The number of bytes currently buffered.
+    pub bytes: usize,
+    /// The highest number of bytes buffered at once.
+    pub peak_bytes: usize,
+    /// The number of bytes the pool may use, or zero if the context has no budget.
+    pub limit: usize,
+    /// The number of messages dropped because the budget or the pool's share was exhausted.
+    pub dropped: u64,
+}
+
+impl From<&MemoryPoolUsage> for FoxgloveMemoryPoolUsage {
+    fn from(usage: &MemoryPoolUsage) -> Self {
+        Self {
+            bytes: usage.bytes,
+            peak_bytes: usage.peak_bytes,
+            limit: usage.limit.unwrap_or(0),
+            dropped: usage.dropped,
+        }
+    }
+}
+
+/// The bytes buffered by the sinks of a context.
+#[repr(C)]
+pub struct FoxgloveMemoryUsage {
+    /// The number of bytes currently buffered.
+    pub bytes: usize,
+    /// The highest number of bytes buffered at once.
+    pub peak_bytes: usize,
+    /// The budget, or zero if the context has none.
+    pub limit: usize,
+    /// The usage of WebSocket server clients.
+    pub websocket: FoxgloveMemoryPoolUsage,
+    /// The usage of remote access participants.
+    pub remote_access: FoxgloveMemoryPoolUsage,
+    /// The usage of MCAP writers.
+    pub mcap: FoxgloveMemoryPoolUsage,
+}
+
+/// Set the budget for the bytes buffered by the sinks of a context.
+///
+/// If `budget` is null, the budget is removed. Sinks apply the budget to the messages they
+/// buffer from then on.
+///
+/// # Safety
+/// `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+/// If it's null, the budget of the default context is set. `budget` must be null, or a valid
+/// pointer to a `foxglove_memory_budget`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_context_set_memory_budget(
+    context: *const FoxgloveContext,
+    budget: Option<&FoxgloveMemoryBudget>,
+) {
+    let budget = budget.map(FoxgloveMemoryBudget::to_native);
+    unsafe { with_context(context, |context| context.set_memory_budget(budget)) }
+}
+
+/// Get the bytes buffered by the sinks of a context, and the budget they're held to.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+/// If it's null, the usage of the default context is read. `usage` must be a valid pointer to a
+/// `foxglove_memory_usage`, which is overwritten.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_context_memory_usage(
+    context: *const FoxgloveContext,
+    usage: Option<&mut FoxgloveMemoryUsage>,
+) -> FoxgloveError {
+    let Some(usage) = usage else {
+        tracing::error!("foxglove_context_memory_usage called with null usage");
+        return FoxgloveError::ValueError;
+    };
+    let native = unsafe { with_context(context, |context| context.memory_usage()) };
+    let pool = |pool: MemoryPool| {
+        native
+            .pools
+            .iter()
+            .find(|usage| usage.pool == pool)
+            .map(FoxgloveMemoryPoolUsage::from)
+            .unwrap_or_default()
+    };
+    *usage = FoxgloveMemoryUsage {
+        bytes: native.bytes,
+        peak_bytes: native.peak_bytes,
+        limit: native.limit.unwrap_or(0),
+        websocket: pool(MemoryPool::WebSocket),
+        remote_access: pool(MemoryPool::RemoteAccess),
+        mcap: pool(MemoryPool::Mcap),
+    };
+    FoxgloveError::Ok
+}
@@ -0,0 +1,99 @@
+use std::ffi::c_void;
+use std::sync::Arc;
+
+use foxglove::FilterAction;
+use foxglove::bytes::Bytes;
+
+use crate::FoxgloveError;
+use crate::bytes::FoxgloveBytes;
+use crate::channel_descriptor::FoxgloveChannelDescriptor;
+
+/// The output of a `message_filter` callback, which may replace the filtered message.
+///
+/// The output is only valid for the duration of the callback.
+pub struct FoxgloveMessageFilterOutput(Option<Bytes>);
+
+pub(crate) type MessageFilterCallback = unsafe extern "C" fn(
+    context: *const c_void,
+    channel: *const FoxgloveChannelDescriptor,
+    data: *const u8,
+    data_len: usize,
+    log_time: u64,
+    output: *mut FoxgloveMessageFilterOutput,
+) -> bool;
+
+/// Adapts a C `message_filter` callback to a [`foxglove::MessageFilter`].
+struct MessageFilter {
+    callback_context: *const c_void,
+    callback: MessageFilterCallback,
+}
+
+// Safety: the caller which provides the callback guarantees that the callback and its context can
+// be used from any thread.
+unsafe impl Send for MessageFilter {}
+unsafe impl Sync for MessageFilter {}
+
+impl foxglove::MessageFilter for MessageFilter {
+    fn filter(
+        &self,
+        channel: &foxglove::ChannelDescriptor,
+        msg: &[u8],
+        metadata: &foxglove::Metadata,
+    ) -> FilterAction {
+        let c_channel_descriptor = FoxgloveChannelDescriptor(channel.clone());
+        let mut output = FoxgloveMessageFilterOutput(None);
+        // Safety: the channel descriptor, message and output are valid for the duration of the
+        // call.
+        let keep = unsafe {
+            (self.callback)(
+                self.callback_context,
+                &raw const c_channel_descriptor,
+                msg.as_ptr(),
+                msg.len(),
+                metadata.log_time,
+                &raw mut output,
+            )
+        };
+        match (keep, output.0) {
+            (false, _) => FilterAction::Drop,
+            (true, Some(replacement)) => FilterAction::Replace(replacement),
+            (true, None) => FilterAction::Keep,
+        }
+    }
+}
+
+/// Returns the message filter for a sink's options, if any.
+pub(crate) fn message_filter(
+    callback_context: *const c_void,
+    callback: Option<MessageFilterCallback>,
+) -> Option<Arc<dyn foxglove::MessageFilter>> {
+    callback.map(|callback| {
+        Arc::new(MessageFilter {
+            callback_context,
+            callback,
+        }) as Arc<dyn foxglove::MessageFilter>
+    })
+}
+
+/// Replaces the message passed to a `message_filter` callback, for example with a cropped or
+/// downsampled copy of it.
+///
+/// The callback must return true for the replacement to be logged. The replacement is logged to
+/// every sink which shares the filter, without calling the filter again.
+///
+/// # Safety
+/// - `output` must be the pointer passed to a `message_filter` callback, and this function must be
+///   called from the context of that callback.
+/// - `data` must be a pointer to the replacement message. This value is copied by this function.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_message_filter_output_replace(
+    output: Option<&mut FoxgloveMessageFilterOutput>,
+    data: FoxgloveBytes,
+) -> FoxgloveError {
+    let Some(output) = output else {
+        return FoxgloveError::ValueError;
+    };
+    let data = unsafe { data.as_slice() };
+    output.0 = Some(Bytes::copy_from_slice(data));
+    FoxgloveError::Ok
+}
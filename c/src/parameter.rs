@@ -1367,3 +1367,200 @@ impl Drop for FoxgloveParameterValueDictEntry {
         drop(value);
     }
 }
+
+/// A borrowed description of a WebSocket parameter, for
+/// `foxglove_parameter_array_create_from_descs`.
+///
+/// Unlike `foxglove_parameter`, a description does not own its name or value, so a tree of
+/// descriptions can be allocated by the caller in bulk, and converted in a single call.
+#[repr(C)]
+pub struct FoxgloveParameterDesc {
+    /// Parameter name.
+    name: FoxgloveString,
+    /// Parameter type.
+    r#type: FoxgloveParameterType,
+    /// Parameter value, or NULL if the parameter has no value.
+    value: *const FoxgloveParameterValueDesc,
+}
+
+/// A borrowed description of a WebSocket parameter value.
+#[repr(C)]
+pub struct FoxgloveParameterValueDesc {
+    /// A variant discriminator for the `data` union.
+    tag: FoxgloveParameterValueTag,
+    /// Storage for the value's data.
+    data: FoxgloveParameterValueDescData,
+}
+
+/// Storage for `FoxgloveParameterValueDesc`.
+#[repr(C)]
+pub union FoxgloveParameterValueDescData {
+    float64: f64,
+    integer: i64,
+    boolean: bool,
+    string: ManuallyDrop<FoxgloveString>,
+    array: FoxgloveParameterValueDescArray,
+    dict: FoxgloveParameterValueDescDict,
+}
+
+/// A borrowed array of parameter value descriptions.
+#[derive(Clone, Copy)]
+#[repr(C)]
+pub struct FoxgloveParameterValueDescArray {
+    /// A pointer to the array of value descriptions.
+    values: *const FoxgloveParameterValueDesc,
+    /// Number of elements in the array.
+    len: usize,
+}
+
+/// A borrowed dictionary of parameter value descriptions.
+#[derive(Clone, Copy)]
+#[repr(C)]
+pub struct FoxgloveParameterValueDescDict {
+    /// A pointer to the array of dictionary entries.
+    entries: *const FoxgloveParameterValueDescEntry,
+    /// Number of elements in the dictionary.
+    len: usize,
+}
+
+/// A borrowed dictionary entry of a parameter value description.
+#[repr(C)]
+pub struct FoxgloveParameterValueDescEntry {
+    /// The dictionary entry's key.
+    key: FoxgloveString,
+    /// The dictionary entry's value.
+    value: *const FoxgloveParameterValueDesc,
+}
+
+/// Returns the elements of a borrowed array, which may be NULL if it is empty.
+///
+/// # Safety
+/// If `len` is non-zero, `ptr` must point to `len` valid elements.
+unsafe fn desc_slice<'a, T>(ptr: *const T, len: usize) -> Result<&'a [T], FoxgloveError> {
+    if len == 0 {
+        Ok(&[])
+    } else if ptr.is_null() {
+        Err(FoxgloveError::ValueError)
+    } else {
+        Ok(unsafe { std::slice::from_raw_parts(ptr, len) })
+    }
+}
+
+/// Copies a borrowed string into an owned string.
+///
+/// # Safety
+/// The string must be a valid `foxglove_string`.
+unsafe fn desc_string(string: &FoxgloveString) -> Result<String, FoxgloveError> {
+    let string = unsafe { string.as_utf8_str() };
+    string
+        .map(str::to_string)
+        .map_err(|_| FoxgloveError::Utf8Error)
+}
+
+impl FoxgloveParameterDesc {
+    /// Copies the description into an owned parameter.
+    ///
+    /// # Safety
+    /// The description must be valid, as documented on
+    /// `foxglove_parameter_array_create_from_descs`.
+    unsafe fn to_parameter(&self) -> Result<FoxgloveParameter, FoxgloveError> {
+        let name = unsafe { desc_string(&self.name) }?;
+        // SAFETY: The value pointer is either null or valid.
+        let value = match unsafe { self.value.as_ref() } {
+            Some(value) => Some(Box::new(unsafe { value.to_value() }?)),
+            None => None,
+        };
+        Ok(FoxgloveParameter::new(name, self.r#type, value))
+    }
+}
+
+impl FoxgloveParameterValueDesc {
+    /// Copies the description into an owned parameter value.
+    ///
+    /// # Safety
+    /// The description must be valid, as documented on
+    /// `foxglove_parameter_array_create_from_descs`.
+    unsafe fn to_value(&self) -> Result<FoxgloveParameterValue, FoxgloveError> {
+        // SAFETY: The tag is a valid discriminator for the data union.
+        let value = match self.tag {
+            FoxgloveParameterValueTag::Float64 => {
+                FoxgloveParameterValue::float64(unsafe { self.data.float64 })
+            }
+            FoxgloveParameterValueTag::Integer => {
+                FoxgloveParameterValue::integer(unsafe { self.data.integer })
+            }
+            FoxgloveParameterValueTag::Boolean => {
+                FoxgloveParameterValue::boolean(unsafe { self.data.boolean })
+            }
+            FoxgloveParameterValueTag::String => {
+                FoxgloveParameterValue::string(unsafe { desc_string(&self.data.string) }?)
+            }
+            FoxgloveParameterValueTag::Array => {
+                let array = unsafe { self.data.array };
+                let descs = unsafe { desc_slice(array.values, array.len) }?;
+                let values = descs
+                    .iter()
+                    .map(|desc| unsafe { desc.to_value() })
+                    .collect::<Result<Vec<_>, _>>()?;
+                FoxgloveParameterValue::array(FoxgloveParameterValueArray::from_vec(values))
+            }
+            FoxgloveParameterValueTag::Dict => {
+                let dict = unsafe { self.data.dict };
+                let descs = unsafe { desc_slice(dict.entries, dict.len) }?;
+                let entries = descs
+                    .iter()
+                    .map(|entry| {
+                        let key = unsafe { desc_string(&entry.key) }?;
+                        // SAFETY: The value pointer is either null or valid.
+                        let value =
+                            unsafe { entry.value.as_ref() }.ok_or(FoxgloveError::ValueError)?;
+                        let value = unsafe { value.to_value() }?;
+                        Ok(FoxgloveParameterValueDictEntry::new(key, Box::new(value)))
+                    })
+                    .collect::<Result<Vec<_>, FoxgloveError>>()?;
+                FoxgloveParameterValue::dict(FoxgloveParameterValueDict::from_vec(entries))
+            }
+        };
+        Ok(value)
+    }
+}
+
+/// Creates a new parameter array from an array of borrowed parameter descriptions.
+///
+/// This converts a whole tree of parameters in a single call, rather than allocating each
+/// parameter and value separately. Names, keys and strings are copied, so the descriptions may be
+/// freed as soon as this function returns.
+///
+/// On success, the array must be freed with `foxglove_parameter_array_free`. On failure, nothing
+/// is allocated.
+///
+/// # Safety
+/// - `array` must be a valid pointer.
+/// - `params` must point to `params_count` valid descriptions, or may be NULL if `params_count`
+///   is zero.
+/// - Each name, key and string must be a valid `foxglove_string`.
+/// - Each value pointer must be NULL or point to a valid description, whose `tag` matches the
+///   variant of `data` which was initialized. Dictionary entry values must not be NULL.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_parameter_array_create_from_descs(
+    params: *const FoxgloveParameterDesc,
+    params_count: usize,
+    array: *mut *mut FoxgloveParameterArray,
+) -> FoxgloveError {
+    if array.is_null() {
+        return FoxgloveError::ValueError;
+    }
+    let result = unsafe { desc_slice(params, params_count) }.and_then(|descs| {
+        descs
+            .iter()
+            .map(|desc| unsafe { desc.to_parameter() })
+            .collect::<Result<Vec<_>, _>>()
+    });
+    match result {
+        Ok(params) => {
+            unsafe { *array = FoxgloveParameterArray::from_vec(params).into_raw() };
+            FoxgloveError::Ok
+        }
+        Err(err) => err,
+    }
+}
@@ -183,3 +183,141 @@ fn test_clone() {
     let param = unsafe { FoxgloveParameter::from_raw(dst) };
     assert_eq!(param.into_native(), make_dict_native());
 }
+
+#[test]
+fn test_array_from_descs() {
+    let e = FoxgloveParameterValueDesc {
+        tag: FoxgloveParameterValueTag::Float64,
+        data: FoxgloveParameterValueDescData {
+            float64: std::f64::consts::E,
+        },
+    };
+    let pi = FoxgloveParameterValueDesc {
+        tag: FoxgloveParameterValueTag::Float64,
+        data: FoxgloveParameterValueDescData {
+            float64: std::f64::consts::PI,
+        },
+    };
+    let floats = [e, pi];
+    let float_array = FoxgloveParameterValueDesc {
+        tag: FoxgloveParameterValueTag::Array,
+        data: FoxgloveParameterValueDescData {
+            array: FoxgloveParameterValueDescArray {
+                values: floats.as_ptr(),
+                len: floats.len(),
+            },
+        },
+    };
+    let string = FoxgloveParameterValueDesc {
+        tag: FoxgloveParameterValueTag::String,
+        data: FoxgloveParameterValueDescData {
+            string: ManuallyDrop::new("xyzzy".into()),
+        },
+    };
+    let inner_entries = [
+        FoxgloveParameterValueDescEntry {
+            key: "string".into(),
+            value: &raw const string,
+        },
+        FoxgloveParameterValueDescEntry {
+            key: "f64[]".into(),
+            value: &raw const float_array,
+        },
+    ];
+    let inner = FoxgloveParameterValueDesc {
+        tag: FoxgloveParameterValueTag::Dict,
+        data: FoxgloveParameterValueDescData {
+            dict: FoxgloveParameterValueDescDict {
+                entries: inner_entries.as_ptr(),
+                len: inner_entries.len(),
+            },
+        },
+    };
+    let boolean = FoxgloveParameterValueDesc {
+        tag: FoxgloveParameterValueTag::Boolean,
+        data: FoxgloveParameterValueDescData { boolean: false },
+    };
+    let float = FoxgloveParameterValueDesc {
+        tag: FoxgloveParameterValueTag::Float64,
+        data: FoxgloveParameterValueDescData { float64: 1.23 },
+    };
+    let outer_entries = [
+        FoxgloveParameterValueDescEntry {
+            key: "bool".into(),
+            value: &raw const boolean,
+        },
+        FoxgloveParameterValueDescEntry {
+            key: "nested".into(),
+            value: &raw const inner,
+        },
+        FoxgloveParameterValueDescEntry {
+            key: "float64".into(),
+            value: &raw const float,
+        },
+    ];
+    let outer = FoxgloveParameterValueDesc {
+        tag: FoxgloveParameterValueTag::Dict,
+        data: FoxgloveParameterValueDescData {
+            dict: FoxgloveParameterValueDescDict {
+                entries: outer_entries.as_ptr(),
+                len: outer_entries.len(),
+            },
+        },
+    };
+    let params = [
+        FoxgloveParameterDesc {
+            name: "outer".into(),
+            r#type: FoxgloveParameterType::None,
+            value: &raw const outer,
+        },
+        FoxgloveParameterDesc {
+            name: "empty".into(),
+            r#type: FoxgloveParameterType::None,
+            value: std::ptr::null(),
+        },
+    ];
+
+    let mut array = std::ptr::null_mut();
+    let err = unsafe {
+        foxglove_parameter_array_create_from_descs(params.as_ptr(), params.len(), &raw mut array)
+    };
+    assert_eq!(err, FoxgloveError::Ok);
+    let array = unsafe { FoxgloveParameterArray::from_raw(array) };
+    assert_eq!(
+        array.into_native(),
+        vec![make_dict_native(), Parameter::empty("empty")]
+    );
+
+    // A dictionary entry without a value is rejected, without leaking the converted values.
+    let entries = [FoxgloveParameterValueDescEntry {
+        key: "missing".into(),
+        value: std::ptr::null(),
+    }];
+    let dict = FoxgloveParameterValueDesc {
+        tag: FoxgloveParameterValueTag::Dict,
+        data: FoxgloveParameterValueDescData {
+            dict: FoxgloveParameterValueDescDict {
+                entries: entries.as_ptr(),
+                len: entries.len(),
+            },
+        },
+    };
+    let params = [
+        FoxgloveParameterDesc {
+            name: "ok".into(),
+            r#type: FoxgloveParameterType::None,
+            value: &raw const float,
+        },
+        FoxgloveParameterDesc {
+            name: "bad".into(),
+            r#type: FoxgloveParameterType::None,
+            value: &raw const dict,
+        },
+    ];
+    let mut array = std::ptr::null_mut();
+    let err = unsafe {
+        foxglove_parameter_array_create_from_descs(params.as_ptr(), params.len(), &raw mut array)
+    };
+    assert_eq!(err, FoxgloveError::ValueError);
+    assert!(array.is_null());
+}
@@ -0,0 +1,232 @@
+//! C FFI bindings for [`foxglove::RingBufferSink`].
+
+use std::ffi::c_void;
+use std::mem::ManuallyDrop;
+use std::sync::Arc;
+use std::time::Duration;
+
+use crate::sink_channel_filter::sink_channel_filter;
+use crate::{
+    FoxgloveContext, FoxgloveError, FoxgloveMcapOptions, FoxgloveString,
+    channel_descriptor::FoxgloveChannelDescriptor, result_to_c,
+    sink_channel_filter::FoxgloveTopicFilter,
+};
+
+#[repr(C)]
+pub struct FoxgloveRingBufferSinkOptions {
+    /// `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+    /// If it's null, the sink will be attached to the default context.
+    pub context: *const FoxgloveContext,
+    /// How far back from the newest message to keep messages, in nanoseconds. A value of 0 means
+    /// the default of 60 seconds.
+    pub window_ns: u64,
+    /// Maximum total size of the buffered message data, in bytes. A value of 0 means the default
+    /// of 256 MiB. Messages larger than this are not buffered.
+    pub max_bytes: usize,
+    /// Options used to write snapshots, or null for the defaults. Only the options which control
+    /// the MCAP format are used; the path, custom writer and sink options are ignored.
+    pub mcap_options: *const FoxgloveMcapOptions,
+    /// Context provided to the `sink_channel_filter` callback.
+    pub sink_channel_filter_context: *const c_void,
+    /// A filter for channels that can be used to subscribe to or unsubscribe from channels.
+    ///
+    /// This can be used to omit one or more channels from a sink, but still log all channels to
+    /// another sink in the same context. Return false to disable logging of this channel.
+    ///
+    /// This method is invoked from the logging thread and must not block.
+    ///
+    /// # Safety
+    /// - If provided, the handler callback must be a pointer to the filter callback function,
+    ///   and must remain valid until the sink is closed.
+    pub sink_channel_filter: Option<
+        unsafe extern "C" fn(
+            context: *const c_void,
+            channel: *const FoxgloveChannelDescriptor,
+        ) -> bool,
+    >,
+    /// Optional topic filter, created via `foxglove_topic_filter_create`.
+    ///
+    /// The filter is evaluated without calling into C, and its result is cached per channel. If
+    /// `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+    /// filter. The sink holds its own reference to the filter.
+    pub topic_filter: *const FoxgloveTopicFilter,
+}
+
+/// A sink which keeps the most recent messages of every channel in memory, so that they can be
+/// written to an MCAP file after an incident.
+///
+/// The sink is created by `foxglove_ring_buffer_sink_create`, and closed and freed by
+/// `foxglove_ring_buffer_sink_close`.
+pub struct FoxgloveRingBufferSink(foxglove::RingBufferSinkHandle);
+
+/// A snapshot of a ring buffer sink which is being written to an MCAP file on a background
+/// thread.
+///
+/// The snapshot is created by `foxglove_ring_buffer_sink_snapshot`, and freed by
+/// `foxglove_ring_buffer_snapshot_wait` or `foxglove_ring_buffer_snapshot_detach`.
+pub struct FoxgloveRingBufferSnapshot(foxglove::RingBufferSnapshot);
+
+/// Create a ring buffer sink. Resources must later be freed with
+/// `foxglove_ring_buffer_sink_close`.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `mcap_options` must be null or a valid pointer to MCAP options. If `context` is non-null, it
+/// must have been created by `foxglove_context_new`.
+#[unsafe(no_mangle)]
+#[must_use]
+pub unsafe extern "C" fn foxglove_ring_buffer_sink_create(
+    options: &FoxgloveRingBufferSinkOptions,
+    sink: *mut *mut FoxgloveRingBufferSink,
+) -> FoxgloveError {
+    unsafe {
+        let result = do_foxglove_ring_buffer_sink_create(options);
+        result_to_c(result, sink)
+    }
+}
+
+unsafe fn do_foxglove_ring_buffer_sink_create(
+    options: &FoxgloveRingBufferSinkOptions,
+) -> Result<*mut FoxgloveRingBufferSink, foxglove::FoxgloveError> {
+    let mut builder = foxglove::RingBufferSink::new();
+    if options.window_ns > 0 {
+        builder = builder.window(Duration::from_nanos(options.window_ns));
+    }
+    if options.max_bytes > 0 {
+        builder = builder.max_bytes(options.max_bytes);
+    }
+    if let Some(mcap_options) = unsafe { options.mcap_options.as_ref() } {
+        builder = builder.mcap_options(unsafe { mcap_options.to_write_options() }?);
+    }
+    if let Some(filter) = unsafe {
+        sink_channel_filter(
+            options.sink_channel_filter_context,
+            options.sink_channel_filter,
+            options.topic_filter,
+        )
+    } {
+        builder = builder.channel_filter(filter);
+    }
+    if !options.context.is_null() {
+        let context = ManuallyDrop::new(unsafe { Arc::from_raw(options.context) });
+        builder = builder.context(&context);
+    }
+
+    let handle = builder.create()?;
+    Ok(Box::into_raw(Box::new(FoxgloveRingBufferSink(handle))))
+}
+
+/// Start writing the buffered messages logged within `window_ns` nanoseconds of the newest
+/// message to a new MCAP file at `path`.
+///
+/// The messages are copied out of the ring buffer before this function returns, and written on
+/// a background thread. The file must not already exist. Resources must later be freed with
+/// `foxglove_ring_buffer_snapshot_wait` or `foxglove_ring_buffer_snapshot_detach`.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `sink` must be a valid pointer to a sink created via `foxglove_ring_buffer_sink_create`.
+/// `path` must contain valid UTF8.
+#[unsafe(no_mangle)]
+#[must_use]
+pub unsafe extern "C" fn foxglove_ring_buffer_sink_snapshot(
+    sink: Option<&FoxgloveRingBufferSink>,
+    path: FoxgloveString,
+    window_ns: u64,
+    snapshot: *mut *mut FoxgloveRingBufferSnapshot,
+) -> FoxgloveError {
+    let Some(sink) = sink else {
+        tracing::error!("foxglove_ring_buffer_sink_snapshot called with null sink");
+        return FoxgloveError::ValueError;
+    };
+    let result = unsafe { path.as_utf8_str() }
+        .map_err(|e| foxglove::FoxgloveError::Utf8Error(format!("path is invalid: {e}")))
+        .and_then(|path| sink.0.snapshot(path, Duration::from_nanos(window_ns)))
+        .map(|inner| Box::into_raw(Box::new(FoxgloveRingBufferSnapshot(inner))));
+    unsafe { result_to_c(result, snapshot) }
+}
+
+/// Returns the number of messages currently buffered by the sink, or 0 if `sink` is null.
+///
+/// # Safety
+/// `sink` must be null, or a valid pointer to a sink created via
+/// `foxglove_ring_buffer_sink_create`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_ring_buffer_sink_buffered_messages(
+    sink: Option<&FoxgloveRingBufferSink>,
+) -> usize {
+    sink.map_or(0, |sink| sink.0.buffered_messages())
+}
+
+/// Returns the total size of the message data currently buffered by the sink, in bytes, or 0 if
+/// `sink` is null.
+///
+/// # Safety
+/// `sink` must be null, or a valid pointer to a sink created via
+/// `foxglove_ring_buffer_sink_create`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_ring_buffer_sink_buffered_bytes(
+    sink: Option<&FoxgloveRingBufferSink>,
+) -> usize {
+    sink.map_or(0, |sink| sink.0.buffered_bytes())
+}
+
+/// Close and free a ring buffer sink created via `foxglove_ring_buffer_sink_create`.
+///
+/// Closing releases the buffered messages. Snapshots which are being written are not affected.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `sink` must be a valid pointer to a sink created via `foxglove_ring_buffer_sink_create`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_ring_buffer_sink_close(
+    sink: Option<&mut FoxgloveRingBufferSink>,
+) -> FoxgloveError {
+    let Some(sink) = sink else {
+        tracing::error!("foxglove_ring_buffer_sink_close called with null sink");
+        return FoxgloveError::ValueError;
+    };
+    // Safety: undo the Box::into_raw in foxglove_ring_buffer_sink_create
+    let sink = unsafe { Box::from_raw(sink) };
+    sink.0.close();
+    FoxgloveError::Ok
+}
+
+/// Wait for a snapshot to be written, and free it.
+///
+/// Returns 0 if the snapshot was written, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `snapshot` must be a valid pointer to a snapshot created via
+/// `foxglove_ring_buffer_sink_snapshot`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_ring_buffer_snapshot_wait(
+    snapshot: Option<&mut FoxgloveRingBufferSnapshot>,
+) -> FoxgloveError {
+    let Some(snapshot) = snapshot else {
+        tracing::error!("foxglove_ring_buffer_snapshot_wait called with null snapshot");
+        return FoxgloveError::ValueError;
+    };
+    // Safety: undo the Box::into_raw in foxglove_ring_buffer_sink_snapshot
+    let snapshot = unsafe { Box::from_raw(snapshot) };
+    unsafe { result_to_c(snapshot.0.wait(), std::ptr::null_mut()) }
+}
+
+/// Free a snapshot without waiting for it to be written. The snapshot continues to be written
+/// in the background, and errors are logged.
+///
+/// # Safety
+/// `snapshot` must be null, or a valid pointer to a snapshot created via
+/// `foxglove_ring_buffer_sink_snapshot`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_ring_buffer_snapshot_detach(
+    snapshot: Option<&mut FoxgloveRingBufferSnapshot>,
+) {
+    if let Some(snapshot) = snapshot {
+        // Safety: undo the Box::into_raw in foxglove_ring_buffer_sink_snapshot
+        drop(unsafe { Box::from_raw(snapshot) });
+    }
+}
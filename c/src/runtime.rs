@@ -0,0 +1,80 @@
+//! C FFI bindings for the options of the SDK's internal runtime.
+
+use crate::{FoxgloveError, FoxgloveString, result_to_c};
+
+/// Options for the internal runtime which the SDK creates for its servers and publishers.
+///
+/// Zero-initialize the struct to use the defaults.
+#[repr(C)]
+pub struct FoxgloveRuntimeOptions<'a> {
+    /// Number of worker threads. A value of 0 means one per CPU.
+    pub worker_threads: usize,
+    /// Name of the runtime's threads, or null for the default.
+    pub thread_name: Option<&'a FoxgloveString>,
+    /// Indices of the CPUs to run the runtime's threads on. If `cpu_affinity_count` is 0, threads
+    /// may run on any CPU. Only supported on Linux.
+    ///
+    /// # Safety
+    /// - If `cpu_affinity_count` is nonzero, `cpu_affinity` must be a valid pointer to an array
+    ///   of that many indices.
+    pub cpu_affinity: *const usize,
+    pub cpu_affinity_count: usize,
+    /// Whether to set the nice value of the runtime's threads. Only supported on Linux.
+    pub set_nice: bool,
+    /// Nice value of the runtime's threads, from -20 (highest priority) to 19 (lowest), if
+    /// `set_nice` is true. Raising the priority requires privileges.
+    pub nice: i32,
+}
+
+/// Set the options of the SDK's internal runtime.
+///
+/// This must be called before starting anything which creates the runtime, such as a WebSocket
+/// server or system info publisher. The CPU affinity and nice value also apply to the dedicated
+/// threads of servers started with `writer_threads`.
+///
+/// Returns `FOXGLOVE_ERROR_CONFIGURATION_ERROR` if the runtime was already created, or
+/// `FOXGLOVE_ERROR_VALUE_ERROR` if the options are invalid.
+///
+/// # Safety
+/// `options` must be a valid pointer to options, whose pointers are valid as documented on
+/// `foxglove_runtime_options`.
+#[unsafe(no_mangle)]
+#[must_use]
+pub unsafe extern "C" fn foxglove_set_runtime_options(
+    options: Option<&FoxgloveRuntimeOptions>,
+) -> FoxgloveError {
+    let Some(options) = options else {
+        return FoxgloveError::ValueError;
+    };
+    let result = unsafe { runtime_options(options) }.and_then(foxglove::set_runtime_options);
+    unsafe { result_to_c(result, std::ptr::null_mut()) }
+}
+
+unsafe fn runtime_options(
+    options: &FoxgloveRuntimeOptions,
+) -> Result<foxglove::RuntimeOptions, foxglove::FoxgloveError> {
+    let mut runtime_options = foxglove::RuntimeOptions::new();
+    if options.worker_threads > 0 {
+        runtime_options = runtime_options.worker_threads(options.worker_threads);
+    }
+    if let Some(name) = options.thread_name {
+        let name = unsafe { name.as_utf8_str() }.map_err(|e| {
+            foxglove::FoxgloveError::Utf8Error(format!("thread name is invalid: {e}"))
+        })?;
+        runtime_options = runtime_options.thread_name(name);
+    }
+    if options.cpu_affinity_count > 0 {
+        if options.cpu_affinity.is_null() {
+            return Err(foxglove::FoxgloveError::ValueError(
+                "cpu_affinity is null".to_string(),
+            ));
+        }
+        let cpus =
+            unsafe { std::slice::from_raw_parts(options.cpu_affinity, options.cpu_affinity_count) };
+        runtime_options = runtime_options.cpu_affinity(cpus.iter().copied());
+    }
+    if options.set_nice {
+        runtime_options = runtime_options.nice(options.nice);
+    }
+    Ok(runtime_options)
+}
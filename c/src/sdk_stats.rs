@@ -0,0 +1,140 @@
+//! C FFI bindings for [`foxglove::sdk_stats::SdkStatsPublisher`].
+
+use std::mem::ManuallyDrop;
+use std::sync::Arc;
+use std::time::Duration;
+
+use foxglove::sdk_stats::{SdkStatsHandle, SdkStatsPublisher};
+
+use crate::{FoxgloveContext, FoxgloveError, FoxgloveString, result_to_c};
+
+/// Opaque handle to a running SDK stats publisher.
+///
+/// The handle is created by [`foxglove_sdk_stats_publisher_start`]. It is freed by
+/// [`foxglove_sdk_stats_publisher_stop`] (which aborts the background task) or by
+/// [`foxglove_sdk_stats_publisher_detach`] (which leaves the background task running until the
+/// process exits).
+pub struct FoxgloveSdkStatsPublisher(SdkStatsHandle);
+
+/// Options for [`foxglove_sdk_stats_publisher_start`].
+///
+/// All fields are optional. To use the default for any field, leave the field
+/// zero-initialized (e.g. by setting it via `memset` or `= {0}`).
+///
+/// # Safety
+/// - `context`, when non-null, must be a valid pointer to a context created via
+///   `foxglove_context_new`.
+/// - `topic`, when non-empty, must be a valid UTF-8 string.
+#[repr(C)]
+pub struct FoxgloveSdkStatsPublisherOptions<'a> {
+    /// Optional context whose channels and sinks are reported, and on which the publisher
+    /// creates its channel. When null, the default global context is used.
+    pub context: *const FoxgloveContext,
+
+    /// Optional channel topic name. If `data` is null or `len` is 0, defaults to
+    /// `/foxglove/sdk_stats`.
+    pub topic: FoxgloveString,
+
+    /// Optional refresh interval, in milliseconds.
+    ///
+    /// When null or zero, defaults to 1000 ms. Clamped to a minimum of 100 ms.
+    pub refresh_interval_ms: Option<&'a u64>,
+}
+
+/// Start the SDK stats publisher.
+///
+/// On success, writes a non-null handle to `out_publisher`. On failure, returns an error
+/// code and `out_publisher` is left untouched.
+///
+/// The returned handle must be freed by calling either
+/// [`foxglove_sdk_stats_publisher_stop`] (to abort the background task) or
+/// [`foxglove_sdk_stats_publisher_detach`] (to leave the background task running).
+///
+/// # Safety
+/// - `options` must be a valid pointer to a [`FoxgloveSdkStatsPublisherOptions`] struct.
+/// - `out_publisher` must be a valid, writable pointer to a `*mut FoxgloveSdkStatsPublisher`.
+/// - See the safety notes on [`FoxgloveSdkStatsPublisherOptions`].
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_sdk_stats_publisher_start(
+    options: Option<&FoxgloveSdkStatsPublisherOptions>,
+    out_publisher: *mut *mut FoxgloveSdkStatsPublisher,
+) -> FoxgloveError {
+    let result = unsafe { do_start(options) };
+    unsafe { result_to_c(result, out_publisher) }
+}
+
+unsafe fn do_start(
+    options: Option<&FoxgloveSdkStatsPublisherOptions>,
+) -> Result<*mut FoxgloveSdkStatsPublisher, foxglove::FoxgloveError> {
+    let Some(options) = options else {
+        return Err(foxglove::FoxgloveError::ValueError(
+            "options must not be null".to_string(),
+        ));
+    };
+
+    let mut builder = SdkStatsPublisher::new();
+
+    if !options.context.is_null() {
+        // SAFETY: options.context is a valid pointer to a FoxgloveContext created via foxglove_context_new.
+        let ctx = ManuallyDrop::new(unsafe { Arc::from_raw(options.context) });
+        builder = builder.context(&ctx);
+    }
+
+    let topic = unsafe { options.topic.as_utf8_str() }
+        .map_err(|e| foxglove::FoxgloveError::Utf8Error(format!("topic invalid: {e}")))?;
+    if !topic.is_empty() {
+        builder = builder.topic(topic);
+    }
+
+    if let Some(&refresh_ms) = options.refresh_interval_ms
+        && refresh_ms > 0
+    {
+        builder = builder.refresh_interval(Duration::from_millis(refresh_ms));
+    }
+
+    let handle = builder.start();
+    Ok(Box::into_raw(Box::new(FoxgloveSdkStatsPublisher(handle))))
+}
+
+/// Stop the SDK stats publisher and free its resources.
+///
+/// This aborts the background task. After calling this function, the handle is invalid
+/// and must not be used again. Passing a null pointer is a no-op.
+///
+/// # Safety
+/// - `publisher`, when non-null, must be a handle returned by
+///   [`foxglove_sdk_stats_publisher_start`] that has not already been passed to this
+///   function.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_sdk_stats_publisher_stop(
+    publisher: *mut FoxgloveSdkStatsPublisher,
+) -> FoxgloveError {
+    if publisher.is_null() {
+        return FoxgloveError::Ok;
+    }
+    let publisher = unsafe { Box::from_raw(publisher) };
+    publisher.0.abort();
+    FoxgloveError::Ok
+}
+
+/// Free the SDK stats publisher handle without stopping its background task.
+///
+/// The background task continues to run until the process exits. After calling this
+/// function, the handle is invalid and must not be used again. Passing a null pointer
+/// is a no-op.
+///
+/// # Safety
+/// - `publisher`, when non-null, must be a handle returned by
+///   [`foxglove_sdk_stats_publisher_start`] that has not already been passed to
+///   either this function or [`foxglove_sdk_stats_publisher_stop`].
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_sdk_stats_publisher_detach(
+    publisher: *mut FoxgloveSdkStatsPublisher,
+) -> FoxgloveError {
+    if publisher.is_null() {
+        return FoxgloveError::Ok;
+    }
+    // Dropping the handle does not abort the underlying task.
+    drop(unsafe { Box::from_raw(publisher) });
+    FoxgloveError::Ok
+}
@@ -1,13 +1,16 @@
 use crate::channel_descriptor::FoxgloveChannelDescriptor;
-use crate::connection_graph::FoxgloveConnectionGraph;
+use crate::connection_graph::{FoxgloveConnectionGraph, FoxgloveConnectionGraphPatch};
 use crate::fetch_asset::{FetchAssetHandler, FoxgloveFetchAssetResponder};
+use crate::message_filter::{FoxgloveMessageFilterOutput, message_filter};
 use crate::service::FoxgloveService;
-use crate::sink_channel_filter::ChannelFilter;
+use crate::shared_memory::FoxgloveSharedMemorySink;
+use crate::sink_channel_filter::{ChannelFilter, FoxgloveTopicFilter, sink_channel_filter};
 use crate::util::parse_key_value_array;
 use bitflags::bitflags;
 use std::ffi::{CString, c_char, c_void};
 use std::mem::ManuallyDrop;
 use std::sync::Arc;
+use std::time::Duration;
 
 use crate::parameter::FoxgloveParameterArray;
 use crate::parameter_handler::FoxgloveParameterHandler;
@@ -22,33 +25,39 @@ use crate::{
 #[derive(Clone, Copy)]
 #[repr(transparent)]
 pub struct FoxgloveServerCapability {
-    pub flags: u8,
+    pub flags: u16,
 }
 /// Allow clients to advertise channels to send data messages to the server.
-pub const FOXGLOVE_SERVER_CAPABILITY_CLIENT_PUBLISH: u8 = 1 << 0;
+pub const FOXGLOVE_SERVER_CAPABILITY_CLIENT_PUBLISH: u16 = 1 << 0;
 /// Allow clients to subscribe to connection graph updates
-pub const FOXGLOVE_SERVER_CAPABILITY_CONNECTION_GRAPH: u8 = 1 << 1;
+pub const FOXGLOVE_SERVER_CAPABILITY_CONNECTION_GRAPH: u16 = 1 << 1;
 /// Allow clients to get & set parameters.
-pub const FOXGLOVE_SERVER_CAPABILITY_PARAMETERS: u8 = 1 << 2;
+pub const FOXGLOVE_SERVER_CAPABILITY_PARAMETERS: u16 = 1 << 2;
 /// Inform clients about the latest server time.
 ///
 /// This allows accelerated, slowed, or stepped control over the progress of time. If the
 /// server publishes time data, then timestamps of published messages must originate from the
 /// same time source.
-pub const FOXGLOVE_SERVER_CAPABILITY_TIME: u8 = 1 << 3;
+pub const FOXGLOVE_SERVER_CAPABILITY_TIME: u16 = 1 << 3;
 /// Allow clients to call services.
-pub const FOXGLOVE_SERVER_CAPABILITY_SERVICES: u8 = 1 << 4;
+pub const FOXGLOVE_SERVER_CAPABILITY_SERVICES: u16 = 1 << 4;
 /// Allow clients to request assets. If you supply an asset handler to the server, this capability
 /// will be advertised automatically.
-pub const FOXGLOVE_SERVER_CAPABILITY_ASSETS: u8 = 1 << 5;
+pub const FOXGLOVE_SERVER_CAPABILITY_ASSETS: u16 = 1 << 5;
 /// Indicates that the server is capable of responding to playback control requests from controls
 /// in the Foxglove app. This requires the server to specify the `data_start_time` and
 /// `data_end_time` fields in `foxglove_server_options`.
-pub const FOXGLOVE_SERVER_CAPABILITY_PLAYBACK_CONTROL: u8 = 1 << 6;
+pub const FOXGLOVE_SERVER_CAPABILITY_PLAYBACK_CONTROL: u16 = 1 << 6;
+/// Allow clients to receive several messages in each binary frame. The limits on each batch are
+/// set by `message_batch_linger_us` and `message_batch_bytes` in `foxglove_server_options`.
+pub const FOXGLOVE_SERVER_CAPABILITY_MESSAGE_BATCHES: u16 = 1 << 7;
+/// Allow clients to subscribe to only some fields of each message on a channel. Supported for
+/// channels with `json` messages, and `protobuf` messages with a protobuf schema.
+pub const FOXGLOVE_SERVER_CAPABILITY_FIELD_PROJECTION: u16 = 1 << 8;
 
 bitflags! {
     #[derive(Clone, Copy, PartialEq, Eq)]
-    struct FoxgloveServerCapabilityBitFlags: u8 {
+    struct FoxgloveServerCapabilityBitFlags: u16 {
         const ClientPublish = FOXGLOVE_SERVER_CAPABILITY_CLIENT_PUBLISH;
         const ConnectionGraph = FOXGLOVE_SERVER_CAPABILITY_CONNECTION_GRAPH;
         const Parameters = FOXGLOVE_SERVER_CAPABILITY_PARAMETERS;
@@ -56,6 +65,8 @@ bitflags! {
         const Services = FOXGLOVE_SERVER_CAPABILITY_SERVICES;
         const Assets = FOXGLOVE_SERVER_CAPABILITY_ASSETS;
         const PlaybackControl = FOXGLOVE_SERVER_CAPABILITY_PLAYBACK_CONTROL;
+        const MessageBatches = FOXGLOVE_SERVER_CAPABILITY_MESSAGE_BATCHES;
+        const FieldProjection = FOXGLOVE_SERVER_CAPABILITY_FIELD_PROJECTION;
     }
 }
 
@@ -81,6 +92,12 @@ impl FoxgloveServerCapabilityBitFlags {
             FoxgloveServerCapabilityBitFlags::PlaybackControl => {
                 Some(foxglove::websocket::Capability::PlaybackControl)
             }
+            FoxgloveServerCapabilityBitFlags::MessageBatches => {
+                Some(foxglove::websocket::Capability::MessageBatches)
+            }
+            FoxgloveServerCapabilityBitFlags::FieldProjection => {
+                Some(foxglove::websocket::Capability::FieldProjection)
+            }
             _ => None,
         })
     }
@@ -92,6 +109,48 @@ impl From<FoxgloveServerCapability> for FoxgloveServerCapabilityBitFlags {
     }
 }
 
+/// How a client's message backlog makes room when it exceeds its limits.
+#[derive(Clone, Copy)]
+#[repr(u8)]
+pub enum FoxgloveBacklogDropPolicy {
+    /// Drop the oldest queued messages, whichever channel they were logged to.
+    DropOldest,
+    /// Drop stale messages from the busiest channels, keeping the latest message of each channel.
+    KeepLatestPerChannel,
+}
+
+impl From<FoxgloveBacklogDropPolicy> for foxglove::websocket::BacklogDropPolicy {
+    fn from(value: FoxgloveBacklogDropPolicy) -> Self {
+        match value {
+            FoxgloveBacklogDropPolicy::DropOldest => Self::DropOldest,
+            FoxgloveBacklogDropPolicy::KeepLatestPerChannel => Self::KeepLatestPerChannel,
+        }
+    }
+}
+
+/// Options for delivering the messages of each client subscription.
+///
+/// To use the default for any field, leave the field zero-initialized.
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub struct FoxgloveSubscriptionOptions {
+    /// The maximum rate at which messages are sent for each subscription, in messages per second.
+    /// Rate-limited subscriptions are conflated. A value of 0 means unlimited.
+    pub max_rate: f64,
+    /// Whether to conflate the messages of each subscription, keeping only the latest message of
+    /// each subscription queued for the client.
+    pub conflate: bool,
+}
+
+impl From<FoxgloveSubscriptionOptions> for foxglove::websocket::SubscriptionOptions {
+    fn from(value: FoxgloveSubscriptionOptions) -> Self {
+        Self {
+            max_rate: (value.max_rate > 0.0).then_some(value.max_rate),
+            conflate: value.conflate,
+        }
+    }
+}
+
 #[repr(C)]
 pub struct FoxgloveServerOptions<'a> {
     /// `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
@@ -171,6 +230,42 @@ pub struct FoxgloveServerOptions<'a> {
         ) -> bool,
     >,
 
+    /// Optional topic filter, created via `foxglove_topic_filter_create`.
+    ///
+    /// The filter is evaluated without calling into C, and its result is cached per channel. If
+    /// `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+    /// filter. The sink holds its own reference to the filter.
+    pub topic_filter: *const FoxgloveTopicFilter,
+
+    /// Context provided to the `message_filter` callback.
+    pub message_filter_context: *const c_void,
+
+    /// A filter which runs on each message before it is sent to clients, so that clients can
+    /// receive channels with a different policy than other sinks in the same context.
+    ///
+    /// Return false to drop the message, or true to send it. To send a different message
+    /// instead, for example a cropped or downsampled copy, pass it to
+    /// `foxglove_message_filter_output_replace` and return true. The message data is only valid
+    /// for the duration of the callback.
+    ///
+    /// The callback is invoked once for each logged message, however many clients are
+    /// connected, and its result is shared by all of them. It is invoked on the thread which logs
+    /// the message, and must not block.
+    ///
+    /// # Safety
+    /// - If provided, the callback must remain valid until the server is stopped, and may be
+    ///   called from any thread.
+    pub message_filter: Option<
+        unsafe extern "C" fn(
+            context: *const c_void,
+            channel: *const FoxgloveChannelDescriptor,
+            data: *const u8,
+            data_len: usize,
+            log_time: u64,
+            output: *mut FoxgloveMessageFilterOutput,
+        ) -> bool,
+    >,
+
     /// If the server is sending data from a fixed time range, and has the PlaybackControl capability,
     /// the start time of the data range.
     pub playback_start_time: Option<&'a u64>,
@@ -201,6 +296,100 @@ pub struct FoxgloveServerOptions<'a> {
     /// When provided, both `get` and `set` on the handler are required; otherwise
     /// `foxglove_server_start` returns `FOXGLOVE_ERROR_VALUE_ERROR`.
     pub parameter_handler: Option<&'a FoxgloveParameterHandler>,
+
+    /// Number of threads used to send messages to clients. A value of 0 means client connections
+    /// run on the SDK's shared runtime; otherwise the server creates a dedicated runtime with this
+    /// many threads.
+    pub writer_threads: usize,
+
+    /// Maximum number of bytes queued for each client. A value of 0 means the backlog is only
+    /// limited by its number of messages.
+    pub message_backlog_bytes: usize,
+
+    /// Maximum number of bytes queued for each channel of each client. A value of 0 means
+    /// channels are not limited individually.
+    pub channel_backlog_bytes: usize,
+
+    /// How messages are dropped when a client's backlog exceeds its limits.
+    pub backlog_drop_policy: FoxgloveBacklogDropPolicy,
+
+    /// How the messages of each client subscription are delivered.
+    pub subscription_options: FoxgloveSubscriptionOptions,
+
+    /// Enable the permessage-deflate WebSocket extension for clients which offer it.
+    pub compression: bool,
+
+    /// Context provided to the `compression_filter` callback.
+    pub compression_filter_context: *const c_void,
+
+    /// A filter which selects the channels whose messages are compressed, when `compression` is
+    /// enabled. Return false to send the channel's messages uncompressed.
+    ///
+    /// If not provided, all channels are compressed except those with schemas for data which is
+    /// already compressed, such as `foxglove.CompressedImage` and `foxglove.CompressedVideo`.
+    ///
+    /// This method is invoked from the client's main poll loop and must not block.
+    ///
+    /// # Safety
+    /// - If provided, the handler callback must be a pointer to the filter callback function,
+    ///   and must remain valid until the server is stopped.
+    pub compression_filter: Option<
+        unsafe extern "C" fn(
+            context: *const c_void,
+            channel: *const FoxgloveChannelDescriptor,
+        ) -> bool,
+    >,
+
+    /// A shared-memory sink to advertise to clients, so that viewers on the same host can read
+    /// messages from its ring buffer instead of the WebSocket connection.
+    ///
+    /// # Safety
+    /// - If provided, the sink must have been created by `foxglove_shared_memory_sink_create`,
+    ///   and must remain valid until this function returns.
+    pub shared_memory_sink: Option<&'a FoxgloveSharedMemorySink>,
+
+    /// Maximum total size, in bytes, of the successful fetch asset responses to cache in memory.
+    /// Requests for a cached URI are answered without invoking the `fetch_asset` callback, and
+    /// the least recently used assets are evicted when the cache is full. A value of 0 disables
+    /// the cache.
+    pub fetch_asset_cache_bytes: usize,
+
+    /// How long to collect values passed to `foxglove_server_publish_parameter_values` before
+    /// sending them, in milliseconds, so that a burst of updates results in one message to each
+    /// client with the latest value of each parameter. If 0, values are sent immediately. In
+    /// either case, each client is only sent the values it has not already been sent.
+    pub parameter_coalesce_window_ms: u64,
+
+    /// How long to collect changes passed to `foxglove_server_update_connection_graph` and
+    /// `foxglove_server_publish_connection_graph` before sending them, in milliseconds, so that a
+    /// burst of changes results in one connection graph update to each subscribed client. If 0,
+    /// changes are sent immediately.
+    pub connection_graph_coalesce_window_ms: u64,
+
+    /// Send broadcasts from `foxglove_server_broadcast_time` and
+    /// `foxglove_server_broadcast_playback_state` at most once per this many milliseconds. The
+    /// first broadcast after a quiet window is sent immediately, and the latest broadcast within
+    /// the window is sent at its end, from the server's runtime. If 0, every broadcast is sent
+    /// immediately.
+    pub broadcast_coalesce_window_ms: u64,
+
+    /// Bind the server's listener with `SO_REUSEPORT`, so that several servers sharing a context
+    /// can listen on the same port, and the kernel distributes incoming connections across them.
+    /// Every server sharing the port must set this. Only supported on Unix platforms.
+    pub reuse_port: bool,
+
+    /// How long to wait for more messages to batch with a client's next message, in microseconds,
+    /// for clients which enable message batches. If 0, a batch only gathers the messages already
+    /// queued for the client. Requires `FOXGLOVE_SERVER_CAPABILITY_MESSAGE_BATCHES`.
+    pub message_batch_linger_us: u64,
+
+    /// Maximum size of a message batch, in bytes. A value of 0 means the default of 64 KiB.
+    pub message_batch_bytes: usize,
+
+    /// Hand TLS sessions to the kernel once their handshake is complete, so that messages are
+    /// encrypted as they are written to the socket. Requires `tls_cert` and `tls_key`, and the
+    /// Linux `tls` kernel module; otherwise the server encrypts in userspace.
+    pub kernel_tls: bool,
 }
 
 #[repr(C)]
@@ -220,6 +409,143 @@ pub struct FoxgloveClientMetadata {
     pub sink_id: FoxgloveSinkId,
 }
 
+/// Delivery counters for the messages logged to one of a client's subscribed channels.
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub struct FoxgloveChannelStats {
+    /// The channel ID.
+    pub channel_id: u64,
+    /// The number of messages logged to the channel for the client, which is the sequence number
+    /// of the latest message.
+    pub sequence: u64,
+    /// The number of messages sent to the client.
+    pub sent: u64,
+    /// The number of messages dropped to keep the client's backlog within its limits.
+    pub dropped: u64,
+    /// The number of queued messages which were replaced by a newer message of the channel,
+    /// because the subscription is conflated.
+    pub conflated: u64,
+    /// The number of messages currently queued.
+    pub queued_messages: usize,
+    /// The number of bytes currently queued.
+    pub queued_bytes: usize,
+    /// The largest number of messages queued at once.
+    pub max_queued_messages: usize,
+    /// The largest number of bytes queued at once.
+    pub max_queued_bytes: usize,
+}
+
+impl From<&foxglove::websocket::ChannelStats> for FoxgloveChannelStats {
+    fn from(stats: &foxglove::websocket::ChannelStats) -> Self {
+        Self {
+            channel_id: stats.channel_id.into(),
+            sequence: stats.sequence,
+            sent: stats.sent,
+            dropped: stats.dropped,
+            conflated: stats.conflated,
+            queued_messages: stats.queued_messages,
+            queued_bytes: stats.queued_bytes,
+            max_queued_messages: stats.max_queued_messages,
+            max_queued_bytes: stats.max_queued_bytes,
+        }
+    }
+}
+
+/// Delivery counters for the data plane messages queued for a client.
+#[repr(C)]
+pub struct FoxgloveClientStats {
+    /// The client ID.
+    pub client_id: u32,
+    /// The number of messages sent to the client, including messages which were not logged to a
+    /// channel.
+    pub sent: u64,
+    /// The number of bytes sent to the client.
+    pub sent_bytes: u64,
+    /// The number of messages dropped to keep the client's backlog within its limits.
+    pub dropped: u64,
+    /// The number of messages currently queued.
+    pub queued_messages: usize,
+    /// The number of bytes currently queued.
+    pub queued_bytes: usize,
+    /// The largest number of messages queued at once.
+    pub max_queued_messages: usize,
+    /// The largest number of bytes queued at once.
+    pub max_queued_bytes: usize,
+    /// Counters for each subscribed channel, ordered by channel ID.
+    pub channels: *const FoxgloveChannelStats,
+    /// The number of elements in `channels`.
+    pub channels_count: usize,
+}
+
+/// The counters of a client, with the channel counters they point to.
+struct ClientStatsBuf {
+    stats: FoxgloveClientStats,
+    channels: Vec<FoxgloveChannelStats>,
+}
+
+impl From<&foxglove::websocket::ClientStats> for ClientStatsBuf {
+    fn from(stats: &foxglove::websocket::ClientStats) -> Self {
+        let channels: Vec<_> = stats.channels.iter().map(Into::into).collect();
+        Self {
+            stats: FoxgloveClientStats {
+                client_id: stats.client_id.into(),
+                sent: stats.sent,
+                sent_bytes: stats.sent_bytes,
+                dropped: stats.dropped,
+                queued_messages: stats.queued_messages,
+                queued_bytes: stats.queued_bytes,
+                max_queued_messages: stats.max_queued_messages,
+                max_queued_bytes: stats.max_queued_bytes,
+                channels: channels.as_ptr(),
+                channels_count: channels.len(),
+            },
+            channels,
+        }
+    }
+}
+
+/// A snapshot of the delivery counters of a server's clients.
+///
+/// The snapshot is created by `foxglove_server_get_stats`, and freed by
+/// `foxglove_server_stats_free`.
+pub struct FoxgloveServerStats {
+    clients: Vec<FoxgloveClientStats>,
+    _buffers: Vec<Vec<FoxgloveChannelStats>>,
+}
+
+/// A message received from a client, whose ownership is passed to `on_message_data_owned`.
+///
+/// The data shares the buffer the message was received into. The receiver must call
+/// `release(release_context)` exactly once when it no longer needs `data`. The buffer may be
+/// released from any thread.
+#[repr(C)]
+pub struct FoxgloveClientMessageBuffer {
+    /// Pointer to the data
+    pub data: *const u8,
+    /// Number of bytes
+    pub len: usize,
+    /// Context to pass to `release`
+    pub release_context: *mut c_void,
+    /// Release function: free the buffer
+    pub release: unsafe extern "C" fn(release_context: *mut c_void),
+}
+
+impl FoxgloveClientMessageBuffer {
+    fn new(data: foxglove::bytes::Bytes) -> Self {
+        let data = Box::new(data);
+        Self {
+            data: data.as_ptr(),
+            len: data.len(),
+            release_context: Box::into_raw(data).cast(),
+            release: release_client_message_buffer,
+        }
+    }
+}
+
+unsafe extern "C" fn release_client_message_buffer(release_context: *mut c_void) {
+    drop(unsafe { Box::from_raw(release_context.cast::<foxglove::bytes::Bytes>()) });
+}
+
 #[repr(C)]
 #[derive(Clone)]
 pub struct FoxgloveServerCallbacks {
@@ -255,6 +581,19 @@ pub struct FoxgloveServerCallbacks {
             payload_len: usize,
         ),
     >,
+    /// Callback invoked when a client message is received, with ownership of the payload.
+    ///
+    /// The payload shares the buffer the message was received into, so it can be kept without
+    /// copying. The callee owns the buffer, and must release it as described by
+    /// `FoxgloveClientMessageBuffer`. If set, `on_message_data` is not invoked.
+    pub on_message_data_owned: Option<
+        unsafe extern "C" fn(
+            context: *const c_void,
+            client_id: u32,
+            client_channel_id: u32,
+            payload: FoxgloveClientMessageBuffer,
+        ),
+    >,
     pub on_client_unadvertise: Option<
         unsafe extern "C" fn(client_id: u32, client_channel_id: u32, context: *const c_void),
     >,
@@ -345,6 +684,18 @@ pub struct FoxgloveServerCallbacks {
     pub on_connection_graph_unsubscribe: Option<unsafe extern "C" fn(context: *const c_void)>,
     pub on_client_connect: Option<unsafe extern "C" fn(context: *const c_void)>,
     pub on_client_disconnect: Option<unsafe extern "C" fn(context: *const c_void)>,
+    /// Callback invoked when messages are dropped from a client's backlog because the client
+    /// can't keep up with the rate at which messages are logged.
+    ///
+    /// The callback is invoked at most once every 100 milliseconds for each client, so the
+    /// counters may include drops since the previous call. Unlike the other callbacks, it is
+    /// invoked from the thread which logged the message that overflowed the backlog, and must not
+    /// block.
+    ///
+    /// The `stats` argument is guaranteed to be non-NULL, and is valid for the duration of the
+    /// call.
+    pub on_backpressure:
+        Option<unsafe extern "C" fn(context: *const c_void, stats: *const FoxgloveClientStats)>,
 
     /// Callback invoked when a client sends a playback control request message.
     ///
@@ -462,11 +813,17 @@ unsafe fn do_foxglove_server_start(
             fetch_asset,
         )));
     }
-    if let Some(sink_channel_filter) = options.sink_channel_filter {
-        server = server.channel_filter(Arc::new(ChannelFilter::new(
+    if let Some(filter) = unsafe {
+        sink_channel_filter(
             options.sink_channel_filter_context,
-            sink_channel_filter,
-        )));
+            options.sink_channel_filter,
+            options.topic_filter,
+        )
+    } {
+        server = server.channel_filter(filter);
+    }
+    if let Some(filter) = message_filter(options.message_filter_context, options.message_filter) {
+        server = server.message_filter(filter);
     }
     if !options.context.is_null() {
         let context = ManuallyDrop::new(unsafe { Arc::from_raw(options.context) });
@@ -489,7 +846,7 @@ unsafe fn do_foxglove_server_start(
             cert: cert.to_vec(),
             key: key.to_vec(),
         };
-        server = server.tls(tls_identity);
+        server = server.tls(tls_identity).kernel_tls(options.kernel_tls);
     }
     if options.server_info_count > 0 {
         let server_info = unsafe {
@@ -524,6 +881,36 @@ unsafe fn do_foxglove_server_start(
         server = server.message_backlog_size(options.message_backlog_size);
     }
 
+    server = server.writer_threads(options.writer_threads);
+    server = server.fetch_asset_cache(options.fetch_asset_cache_bytes);
+    server = server
+        .parameter_coalesce_window(Duration::from_millis(options.parameter_coalesce_window_ms))
+        .connection_graph_coalesce_window(Duration::from_millis(
+            options.connection_graph_coalesce_window_ms,
+        ))
+        .broadcast_coalesce_window(Duration::from_millis(options.broadcast_coalesce_window_ms));
+    server = server
+        .message_backlog_bytes(options.message_backlog_bytes)
+        .channel_backlog_bytes(options.channel_backlog_bytes)
+        .backlog_drop_policy(options.backlog_drop_policy.into())
+        .subscription_options(options.subscription_options.into())
+        .compression(options.compression)
+        .reuse_port(options.reuse_port)
+        .message_batch_linger(Duration::from_micros(options.message_batch_linger_us));
+    if options.message_batch_bytes != 0 {
+        server = server.message_batch_bytes(options.message_batch_bytes);
+    }
+    if let Some(compression_filter) = options.compression_filter {
+        server = server.compression_filter(Arc::new(ChannelFilter::new(
+            options.compression_filter_context,
+            compression_filter,
+        )));
+    }
+    #[cfg(unix)]
+    if let Some(handle) = options.shared_memory_sink.and_then(|sink| sink.handle()) {
+        server = server.shared_memory_sink(handle);
+    }
+
     let server = server.start_blocking()?;
     Ok(Box::into_raw(Box::new(FoxgloveWebSocketServer(Some(
         server,
@@ -692,6 +1079,75 @@ pub extern "C" fn foxglove_server_get_client_count(
     server.client_count()
 }
 
+/// Get a snapshot of the delivery counters of each connected client.
+///
+/// On success, writes a non-null snapshot to `stats`, which must be freed with
+/// `foxglove_server_stats_free`.
+///
+/// # Safety
+/// `stats` must be a valid, writable pointer.
+#[unsafe(no_mangle)]
+#[must_use]
+pub unsafe extern "C" fn foxglove_server_get_stats(
+    server: Option<&FoxgloveWebSocketServer>,
+    stats: *mut *mut FoxgloveServerStats,
+) -> FoxgloveError {
+    let Some(server) = server else {
+        tracing::error!("foxglove_server_get_stats called with null server");
+        return FoxgloveError::ValueError;
+    };
+    let Some(server) = server.as_ref() else {
+        tracing::error!("foxglove_server_get_stats called with closed server");
+        return FoxgloveError::SinkClosed;
+    };
+    let (clients, buffers) = server
+        .stats()
+        .iter()
+        .map(|stats| {
+            let ClientStatsBuf { stats, channels } = stats.into();
+            (stats, channels)
+        })
+        .unzip();
+    let result = Ok(Box::into_raw(Box::new(FoxgloveServerStats {
+        clients,
+        _buffers: buffers,
+    })));
+    unsafe { result_to_c(result, stats) }
+}
+
+/// Get the counters of each client in a snapshot, in order of connection.
+///
+/// Writes the number of clients to `count`, and returns a pointer to the first, which is valid
+/// until the snapshot is freed.
+///
+/// # Safety
+/// - `stats` must be a valid pointer to a snapshot created with `foxglove_server_get_stats`.
+/// - `count` must be a valid pointer to a `size_t`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_server_stats_clients(
+    stats: Option<&FoxgloveServerStats>,
+    count: &mut usize,
+) -> *const FoxgloveClientStats {
+    let Some(stats) = stats else {
+        *count = 0;
+        return std::ptr::null();
+    };
+    *count = stats.clients.len();
+    stats.clients.as_ptr()
+}
+
+/// Free a snapshot created with `foxglove_server_get_stats`.
+///
+/// # Safety
+/// `stats` must be a pointer returned by `foxglove_server_get_stats`, or null.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_server_stats_free(stats: *mut FoxgloveServerStats) {
+    if !stats.is_null() {
+        // Safety: undo the Box::into_raw in foxglove_server_get_stats.
+        drop(unsafe { Box::from_raw(stats) });
+    }
+}
+
 /// Stop and shut down `server` and free the resources associated with it.
 #[unsafe(no_mangle)]
 pub extern "C" fn foxglove_server_stop(
@@ -763,6 +1219,39 @@ pub extern "C" fn foxglove_server_publish_connection_graph(
     }
 }
 
+/// Apply a connection graph patch to the connection graph published by the server, and send the
+/// changes to subscribed clients.
+///
+/// The patch is consumed by this call, even if it fails, and must not be used or freed
+/// afterwards.
+///
+/// # Safety
+/// `patch` must be a valid pointer to a `foxglove_connection_graph_patch` created by
+/// `foxglove_connection_graph_patch_create`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_server_update_connection_graph(
+    server: Option<&mut FoxgloveWebSocketServer>,
+    patch: *mut FoxgloveConnectionGraphPatch,
+) -> FoxgloveError {
+    if patch.is_null() {
+        tracing::error!("foxglove_server_update_connection_graph called with null patch");
+        return FoxgloveError::ValueError;
+    }
+    let patch = unsafe { Box::from_raw(patch) };
+    let Some(server) = server else {
+        tracing::error!("foxglove_server_update_connection_graph called with null server");
+        return FoxgloveError::ValueError;
+    };
+    let Some(server) = server.as_ref() else {
+        tracing::error!("foxglove_server_update_connection_graph called with closed server");
+        return FoxgloveError::SinkClosed;
+    };
+    match server.update_connection_graph(patch.0) {
+        Ok(_) => FoxgloveError::Ok,
+        Err(e) => FoxgloveError::from(e),
+    }
+}
+
 /// Level indicator for a server status message.
 #[derive(Clone, Copy)]
 #[repr(u8)]
@@ -948,6 +1437,26 @@ impl foxglove::websocket::ServerListener for FoxgloveServerCallbacks {
         }
     }
 
+    fn on_message_data_shared(
+        &self,
+        client: foxglove::websocket::Client,
+        channel: &foxglove::websocket::ClientChannel,
+        payload: foxglove::bytes::Bytes,
+    ) {
+        if let Some(on_message_data_owned) = self.on_message_data_owned {
+            unsafe {
+                on_message_data_owned(
+                    self.context,
+                    client.id().into(),
+                    channel.id.into(),
+                    FoxgloveClientMessageBuffer::new(payload),
+                )
+            };
+        } else {
+            self.on_message_data(client, channel, &payload);
+        }
+    }
+
     fn on_client_unadvertise(
         &self,
         client: foxglove::websocket::Client,
@@ -1070,6 +1579,17 @@ impl foxglove::websocket::ServerListener for FoxgloveServerCallbacks {
         }
     }
 
+    fn on_backpressure(
+        &self,
+        _client: foxglove::websocket::Client,
+        stats: &foxglove::websocket::ClientStats,
+    ) {
+        if let Some(on_backpressure) = self.on_backpressure {
+            let stats = ClientStatsBuf::from(stats);
+            unsafe { on_backpressure(self.context, &raw const stats.stats) };
+        }
+    }
+
     fn on_playback_control_request(
         &self,
         playback_control_request: foxglove::websocket::PlaybackControlRequest,
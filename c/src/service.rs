@@ -1,6 +1,9 @@
 use std::ffi::c_void;
+use std::time::Duration;
 
-use foxglove::websocket::service::{Handler, Request, Responder, Service, ServiceSchema};
+use foxglove::websocket::service::{
+    Handler, Request, Responder, Service, ServiceBuilder, ServiceExecutor, ServiceSchema,
+};
 
 use crate::bytes::FoxgloveBytes;
 use crate::{FoxgloveError, FoxgloveSchema, FoxgloveString};
@@ -50,6 +53,44 @@ impl From<&Request> for FoxgloveServiceRequest {
     }
 }
 
+/// Options for dispatching calls to a WebSocket service.
+#[repr(C)]
+pub struct FoxgloveServiceOptions {
+    /// The number of worker threads dedicated to invoking the service's callback. If zero, the
+    /// callback is invoked from the client's main poll loop.
+    pub worker_threads: usize,
+    /// The maximum number of calls to the service which may be in flight at once, across all
+    /// clients. Further calls are queued until an in-flight call completes. If zero, the number of
+    /// calls is unlimited.
+    pub max_in_flight: usize,
+    /// How long a call may wait in the queue before it fails, in milliseconds. If zero, queued
+    /// calls wait indefinitely.
+    pub queue_timeout_ms: u64,
+    /// How long to cache successful responses, in milliseconds, for services whose calls are
+    /// idempotent. If nonzero, calls with the same request encoding and payload are answered from
+    /// the cache without invoking the callback, and identical calls which arrive while one is in
+    /// flight wait for its response. If zero, responses are not cached.
+    pub response_cache_ttl_ms: u64,
+}
+impl FoxgloveServiceOptions {
+    /// Applies the options to a service builder.
+    fn apply(&self, mut builder: ServiceBuilder) -> ServiceBuilder {
+        if self.worker_threads > 0 {
+            builder = builder.executor(ServiceExecutor::new(self.worker_threads));
+        }
+        if self.max_in_flight > 0 {
+            builder = builder.max_in_flight(self.max_in_flight);
+        }
+        if self.queue_timeout_ms > 0 {
+            builder = builder.queue_timeout(Duration::from_millis(self.queue_timeout_ms));
+        }
+        if self.response_cache_ttl_ms > 0 {
+            builder = builder.response_cache(Duration::from_millis(self.response_cache_ttl_ms));
+        }
+        builder
+    }
+}
+
 pub struct FoxgloveService(Service);
 impl FoxgloveService {
     /// Moves the service handle to the heap and returns a pointer.
@@ -187,6 +228,46 @@ pub unsafe extern "C" fn foxglove_service_create(
             responder: *mut FoxgloveServiceResponder,
         ),
     >,
+) -> FoxgloveError {
+    unsafe { foxglove_service_create_with_options(service, name, schema, None, context, callback) }
+}
+
+/// Creates a new WebSocket service, with options for dispatching calls to it.
+///
+/// This behaves like `foxglove_service_create`, except that if `options` sets `worker_threads`,
+/// the callback is invoked on a pool of worker threads dedicated to the service, and may block.
+/// If `options` sets `max_in_flight`, calls beyond the limit are queued until an earlier call
+/// completes, and queued calls are invoked on the worker threads, or on an internal blocking
+/// thread if there are none. Queued calls whose client disconnects, or which wait for longer than
+/// `queue_timeout_ms`, are failed without invoking the callback. If `options` sets
+/// `response_cache_ttl_ms`, identical calls are coalesced, and their successful responses are
+/// cached for that long.
+///
+/// A callback may use `foxglove_service_responder_is_cancelled` to check whether its client has
+/// disconnected.
+///
+/// # Safety
+/// - `service` must be a valid pointer.
+/// - `name` must be a valid UTF-8 string.
+/// - `schema` must be NULL, or a valid pointer to a service schema.
+/// - `options` must be NULL, or a valid pointer to service options.
+/// - `callback` must be a valid pointer to a service callback function, which must remain valid
+///   until the service is either unregistered or freed. If `worker_threads` or `max_in_flight`
+///   is set, the callback and `context` must be safe to use from other threads.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_service_create_with_options(
+    service: *mut *mut FoxgloveService,
+    name: FoxgloveString,
+    schema: Option<&FoxgloveServiceSchema>,
+    options: Option<&FoxgloveServiceOptions>,
+    context: *const c_void,
+    callback: Option<
+        unsafe extern "C" fn(
+            context: *const c_void,
+            request: *const FoxgloveServiceRequest,
+            responder: *mut FoxgloveServiceResponder,
+        ),
+    >,
 ) -> FoxgloveError {
     if service.is_null() {
         return FoxgloveError::ValueError;
@@ -209,7 +290,11 @@ pub unsafe extern "C" fn foxglove_service_create(
         callback_context: context,
         callback,
     };
-    let inner = Service::builder(name, schema).handler(handler);
+    let mut builder = Service::builder(name, schema);
+    if let Some(options) = options {
+        builder = options.apply(builder);
+    }
+    let inner = builder.handler(handler);
     let ptr = FoxgloveService(inner).into_raw();
     unsafe { *service = ptr };
     FoxgloveError::Ok
@@ -249,6 +334,22 @@ pub unsafe extern "C" fn foxglove_service_set_response_encoding(
     FoxgloveError::Ok
 }
 
+/// Returns true if the client which made a request has disconnected.
+///
+/// A long-running callback may use this to abandon work whose response would never be delivered.
+/// It must still complete the request, with `foxglove_service_respond_ok` or
+/// `foxglove_service_respond_error`.
+///
+/// # Safety
+/// - `responder` must be NULL, or a pointer to a `foxglove_service_responder` obtained via the
+///   `foxglove_service.handler` callback, which has not yet been completed.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_service_responder_is_cancelled(
+    responder: Option<&FoxgloveServiceResponder>,
+) -> bool {
+    responder.is_some_and(|responder| responder.0.is_cancelled())
+}
+
 /// Completes a request by sending response data to the client.
 ///
 /// # Safety
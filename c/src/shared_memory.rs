@@ -0,0 +1,183 @@
+//! C FFI bindings for [`foxglove::SharedMemorySink`].
+
+use std::ffi::c_void;
+#[cfg(unix)]
+use std::{mem::ManuallyDrop, sync::Arc};
+
+#[cfg(unix)]
+use crate::sink_channel_filter::sink_channel_filter;
+use crate::{
+    FoxgloveContext, FoxgloveError, FoxgloveString, channel_descriptor::FoxgloveChannelDescriptor,
+    result_to_c, sink_channel_filter::FoxgloveTopicFilter,
+};
+
+#[repr(C)]
+pub struct FoxgloveSharedMemorySinkOptions {
+    /// `context` can be null, or a valid pointer to a context created via `foxglove_context_new`.
+    /// If it's null, the sink will be attached to the default context.
+    pub context: *const FoxgloveContext,
+    /// Path of the file backing the shared-memory ring. If empty, a file is created under
+    /// `/dev/shm` (or the temporary directory) with a name unique to the process.
+    pub path: FoxgloveString,
+    /// Size of the ring buffer in bytes. A value of 0 means the default of 64 MiB.
+    pub capacity: usize,
+    /// Context provided to the `sink_channel_filter` callback.
+    pub sink_channel_filter_context: *const c_void,
+    /// A filter for channels that can be used to subscribe to or unsubscribe from channels.
+    ///
+    /// This can be used to omit one or more channels from a sink, but still log all channels to
+    /// another sink in the same context. Return false to disable logging of this channel.
+    ///
+    /// This method is invoked from the logging thread and must not block.
+    ///
+    /// # Safety
+    /// - If provided, the handler callback must be a pointer to the filter callback function,
+    ///   and must remain valid until the sink is closed.
+    pub sink_channel_filter: Option<
+        unsafe extern "C" fn(
+            context: *const c_void,
+            channel: *const FoxgloveChannelDescriptor,
+        ) -> bool,
+    >,
+    /// Optional topic filter, created via `foxglove_topic_filter_create`.
+    ///
+    /// The filter is evaluated without calling into C, and its result is cached per channel. If
+    /// `sink_channel_filter` is also set, it is only invoked for channels which pass the topic
+    /// filter. The sink holds its own reference to the filter.
+    pub topic_filter: *const FoxgloveTopicFilter,
+}
+
+/// A sink which writes logged messages to a shared-memory ring buffer, for viewers on the same
+/// host.
+///
+/// The sink is created by `foxglove_shared_memory_sink_create`, and closed and freed by
+/// `foxglove_shared_memory_sink_close`.
+pub struct FoxgloveSharedMemorySink(#[cfg(unix)] Option<foxglove::SharedMemorySinkHandle>);
+
+#[cfg(unix)]
+impl FoxgloveSharedMemorySink {
+    pub(crate) fn handle(&self) -> Option<&foxglove::SharedMemorySinkHandle> {
+        self.0.as_ref()
+    }
+}
+
+/// Create a shared-memory sink. Resources must later be freed with
+/// `foxglove_shared_memory_sink_close`.
+///
+/// Shared-memory sinks are only supported on Unix platforms; elsewhere this returns
+/// `FOXGLOVE_ERROR_VALUE_ERROR`.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `path` must contain valid UTF8. If `context` is non-null, it must have been created by
+/// `foxglove_context_new`.
+#[unsafe(no_mangle)]
+#[must_use]
+pub unsafe extern "C" fn foxglove_shared_memory_sink_create(
+    options: &FoxgloveSharedMemorySinkOptions,
+    sink: *mut *mut FoxgloveSharedMemorySink,
+) -> FoxgloveError {
+    unsafe {
+        let result = do_foxglove_shared_memory_sink_create(options);
+        result_to_c(result, sink)
+    }
+}
+
+#[cfg(unix)]
+unsafe fn do_foxglove_shared_memory_sink_create(
+    options: &FoxgloveSharedMemorySinkOptions,
+) -> Result<*mut FoxgloveSharedMemorySink, foxglove::FoxgloveError> {
+    let path = unsafe { options.path.as_utf8_str() }
+        .map_err(|e| foxglove::FoxgloveError::Utf8Error(format!("path is invalid: {e}")))?;
+
+    let mut builder = foxglove::SharedMemorySink::new();
+    if !path.is_empty() {
+        builder = builder.path(path);
+    }
+    if options.capacity > 0 {
+        builder = builder.capacity(options.capacity);
+    }
+    if let Some(filter) = unsafe {
+        sink_channel_filter(
+            options.sink_channel_filter_context,
+            options.sink_channel_filter,
+            options.topic_filter,
+        )
+    } {
+        builder = builder.channel_filter(filter);
+    }
+    if !options.context.is_null() {
+        let context = ManuallyDrop::new(unsafe { Arc::from_raw(options.context) });
+        builder = builder.context(&context);
+    }
+
+    let handle = builder.create()?;
+    Ok(Box::into_raw(Box::new(FoxgloveSharedMemorySink(Some(
+        handle,
+    )))))
+}
+
+#[cfg(not(unix))]
+unsafe fn do_foxglove_shared_memory_sink_create(
+    _options: &FoxgloveSharedMemorySinkOptions,
+) -> Result<*mut FoxgloveSharedMemorySink, foxglove::FoxgloveError> {
+    Err(foxglove::FoxgloveError::ValueError(
+        "shared-memory sinks are only supported on Unix".to_string(),
+    ))
+}
+
+/// Returns the token which viewers use to open the sink's ring buffer.
+///
+/// The returned string is valid until the sink is closed. It is empty if `sink` is null.
+///
+/// # Safety
+/// `sink` must be null, or a valid pointer to a sink created via
+/// `foxglove_shared_memory_sink_create`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_shared_memory_sink_token(
+    sink: Option<&FoxgloveSharedMemorySink>,
+) -> FoxgloveString {
+    #[cfg(unix)]
+    if let Some(handle) = sink.and_then(FoxgloveSharedMemorySink::handle) {
+        return handle.token().into();
+    }
+    #[cfg(not(unix))]
+    let _ = sink;
+    FoxgloveString::default()
+}
+
+/// Close and free a shared-memory sink created via `foxglove_shared_memory_sink_create`.
+///
+/// Closing marks the ring as closed for its readers and removes its backing file.
+///
+/// Returns 0 on success, or returns a FoxgloveError code on error.
+///
+/// # Safety
+/// `sink` must be a valid pointer to a sink created via `foxglove_shared_memory_sink_create`.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_shared_memory_sink_close(
+    sink: Option<&mut FoxgloveSharedMemorySink>,
+) -> FoxgloveError {
+    let Some(sink) = sink else {
+        tracing::error!("foxglove_shared_memory_sink_close called with null sink");
+        return FoxgloveError::ValueError;
+    };
+    // Safety: undo the Box::into_raw in foxglove_shared_memory_sink_create
+    let sink = unsafe { Box::from_raw(sink) };
+    close_sink(sink)
+}
+
+#[cfg(unix)]
+fn close_sink(mut sink: Box<FoxgloveSharedMemorySink>) -> FoxgloveError {
+    let Some(handle) = sink.0.take() else {
+        tracing::error!("foxglove_shared_memory_sink_close called with sink already closed");
+        return FoxgloveError::SinkClosed;
+    };
+    unsafe { result_to_c(handle.close(), std::ptr::null_mut()) }
+}
+
+#[cfg(not(unix))]
+fn close_sink(_sink: Box<FoxgloveSharedMemorySink>) -> FoxgloveError {
+    FoxgloveError::Ok
+}
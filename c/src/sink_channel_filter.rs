@@ -1,4 +1,9 @@
+use std::sync::Arc;
+
+use foxglove::{SinkChannelFilter, TopicFilter};
+
 use crate::channel_descriptor::FoxgloveChannelDescriptor;
+use crate::{FoxgloveError, FoxgloveString, result_to_c};
 
 /// A filter for channels that can be used to subscribe to or unsubscribe from channels.
 ///
@@ -31,7 +36,7 @@ impl ChannelFilter {
 
 unsafe impl Send for ChannelFilter {}
 unsafe impl Sync for ChannelFilter {}
-impl foxglove::SinkChannelFilter for ChannelFilter {
+impl SinkChannelFilter for ChannelFilter {
     /// Indicate whether the channel should be subscribed to.
     ///
     /// # Safety
@@ -41,3 +46,173 @@ impl foxglove::SinkChannelFilter for ChannelFilter {
         unsafe { (self.callback)(self.callback_context, &raw const c_channel_descriptor) }
     }
 }
+
+/// Returns the channel filter for a sink's options, if any.
+///
+/// If both a topic filter and a callback are provided, a channel must pass the topic filter
+/// before the callback is invoked.
+///
+/// # Safety
+/// `topic_filter` must be null or a valid pointer to a topic filter created via
+/// `foxglove_topic_filter_create`.
+pub(crate) unsafe fn sink_channel_filter(
+    callback_context: *const std::ffi::c_void,
+    callback: Option<
+        unsafe extern "C" fn(*const std::ffi::c_void, *const FoxgloveChannelDescriptor) -> bool,
+    >,
+    topic_filter: *const FoxgloveTopicFilter,
+) -> Option<Arc<dyn SinkChannelFilter>> {
+    let topic_filter = unsafe { topic_filter.as_ref() }.map(|f| f.0.clone());
+    let callback = callback.map(|callback| ChannelFilter::new(callback_context, callback));
+    match (topic_filter, callback) {
+        (None, None) => None,
+        (Some(topic_filter), None) => Some(topic_filter),
+        (None, Some(callback)) => Some(Arc::new(callback)),
+        (Some(topic_filter), Some(callback)) => Some(Arc::new(ChainedFilter {
+            topic_filter,
+            callback,
+        })),
+    }
+}
+
+/// A topic filter followed by a callback.
+struct ChainedFilter {
+    topic_filter: Arc<TopicFilter>,
+    callback: ChannelFilter,
+}
+
+impl SinkChannelFilter for ChainedFilter {
+    fn should_subscribe(&self, channel: &foxglove::ChannelDescriptor) -> bool {
+        self.topic_filter.should_subscribe(channel) && self.callback.should_subscribe(channel)
+    }
+}
+
+/// A compiled set of topic globs and regular expressions, which can be used as a sink channel
+/// filter without calling back into C for each channel.
+///
+/// The filter is created by `foxglove_topic_filter_create`, and freed by
+/// `foxglove_topic_filter_free`. Sinks which use the filter hold their own reference to it, so it
+/// may be freed as soon as the sink has been created.
+pub struct FoxgloveTopicFilter(Arc<TopicFilter>);
+
+/// Options for `foxglove_topic_filter_create`.
+///
+/// A channel passes the filter if its topic matches any of the include patterns (or there are
+/// none), and none of the exclude patterns. In globs, `*` matches any sequence of characters other
+/// than `/`, `**` matches any sequence of characters, and `?` matches any single character other
+/// than `/`. Globs match the whole topic, while regular expressions match anywhere in the topic
+/// unless anchored with `^` and `$`.
+#[repr(C)]
+pub struct FoxgloveTopicFilterOptions {
+    /// Globs of the topics to include.
+    pub include_globs: *const FoxgloveString,
+    /// The number of elements in `include_globs`.
+    pub include_globs_count: usize,
+    /// Regular expressions of the topics to include.
+    pub include_regexes: *const FoxgloveString,
+    /// The number of elements in `include_regexes`.
+    pub include_regexes_count: usize,
+    /// Globs of the topics to exclude.
+    pub exclude_globs: *const FoxgloveString,
+    /// The number of elements in `exclude_globs`.
+    pub exclude_globs_count: usize,
+    /// Regular expressions of the topics to exclude.
+    pub exclude_regexes: *const FoxgloveString,
+    /// The number of elements in `exclude_regexes`.
+    pub exclude_regexes_count: usize,
+}
+
+/// Compile a topic filter.
+///
+/// On success, writes a non-null filter to `filter`, which must be freed with
+/// `foxglove_topic_filter_free`. Returns `FOXGLOVE_ERROR_VALUE_ERROR` if a regular expression is
+/// invalid.
+///
+/// # Safety
+/// - Each pattern array must be null, or a valid pointer to the given number of valid UTF-8
+///   strings.
+/// - `filter` must be a valid, writable pointer.
+#[unsafe(no_mangle)]
+#[must_use]
+pub unsafe extern "C" fn foxglove_topic_filter_create(
+    options: Option<&FoxgloveTopicFilterOptions>,
+    filter: *mut *mut FoxgloveTopicFilter,
+) -> FoxgloveError {
+    let result = unsafe { do_topic_filter_create(options) };
+    unsafe { result_to_c(result, filter) }
+}
+
+unsafe fn do_topic_filter_create(
+    options: Option<&FoxgloveTopicFilterOptions>,
+) -> Result<*mut FoxgloveTopicFilter, foxglove::FoxgloveError> {
+    let Some(options) = options else {
+        return Err(foxglove::FoxgloveError::ValueError(
+            "options must not be null".to_string(),
+        ));
+    };
+    let mut builder = TopicFilter::builder();
+    for glob in unsafe { patterns(options.include_globs, options.include_globs_count)? } {
+        builder = builder.include_glob(glob);
+    }
+    for regex in unsafe { patterns(options.include_regexes, options.include_regexes_count)? } {
+        builder = builder.include_regex(regex);
+    }
+    for glob in unsafe { patterns(options.exclude_globs, options.exclude_globs_count)? } {
+        builder = builder.exclude_glob(glob);
+    }
+    for regex in unsafe { patterns(options.exclude_regexes, options.exclude_regexes_count)? } {
+        builder = builder.exclude_regex(regex);
+    }
+    let filter = builder.build()?;
+    Ok(Box::into_raw(Box::new(FoxgloveTopicFilter(Arc::new(
+        filter,
+    )))))
+}
+
+unsafe fn patterns<'a>(
+    data: *const FoxgloveString,
+    count: usize,
+) -> Result<Vec<&'a str>, foxglove::FoxgloveError> {
+    if data.is_null() || count == 0 {
+        return Ok(Vec::new());
+    }
+    unsafe { std::slice::from_raw_parts(data, count) }
+        .iter()
+        .map(|s| {
+            unsafe { s.as_utf8_str() }.map_err(|e| {
+                foxglove::FoxgloveError::Utf8Error(format!("topic pattern invalid: {e}"))
+            })
+        })
+        .collect()
+}
+
+/// Returns true if a channel with the given topic passes the filter.
+///
+/// # Safety
+/// `topic` must be a valid UTF-8 string.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_topic_filter_matches(
+    filter: Option<&FoxgloveTopicFilter>,
+    topic: FoxgloveString,
+) -> bool {
+    let Some(filter) = filter else {
+        return false;
+    };
+    let Ok(topic) = (unsafe { topic.as_utf8_str() }) else {
+        return false;
+    };
+    filter.0.matches(topic)
+}
+
+/// Free a topic filter created via `foxglove_topic_filter_create`.
+///
+/// Sinks which were created with the filter keep using it.
+///
+/// # Safety
+/// `filter` must be a pointer returned by `foxglove_topic_filter_create`, or null.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn foxglove_topic_filter_free(filter: *mut FoxgloveTopicFilter) {
+    if !filter.is_null() {
+        drop(unsafe { Box::from_raw(filter) });
+    }
+}
@@ -4,7 +4,7 @@ use std::mem::ManuallyDrop;
 use std::sync::Arc;
 use std::time::Duration;
 
-use foxglove::system_info::{SystemInfoHandle, SystemInfoPublisher};
+use foxglove::system_info::{SystemInfoHandle, SystemInfoMetric, SystemInfoPublisher};
 
 use crate::{FoxgloveContext, FoxgloveError, FoxgloveString, result_to_c};
 
@@ -16,6 +16,34 @@ use crate::{FoxgloveContext, FoxgloveError, FoxgloveString, result_to_c};
 /// running until the process exits).
 pub struct FoxgloveSystemInfoPublisher(SystemInfoHandle);
 
+/// Memory and CPU usage of the SDK process: the `process_*` fields.
+pub const FOXGLOVE_SYSINFO_METRIC_PROCESS: u32 = 1 << 0;
+/// Total CPU usage of the system: `total_cpu_percent` and `total_cpu_cores`.
+pub const FOXGLOVE_SYSINFO_METRIC_CPU: u32 = 1 << 1;
+/// CPU usage of each logical CPU: `cpu_percent_per_core`.
+pub const FOXGLOVE_SYSINFO_METRIC_CPU_PER_CORE: u32 = 1 << 2;
+/// Physical memory and swap usage of the system.
+pub const FOXGLOVE_SYSINFO_METRIC_MEMORY: u32 = 1 << 3;
+/// Network throughput, summed over all interfaces: the `network_*` fields.
+pub const FOXGLOVE_SYSINFO_METRIC_NETWORK: u32 = 1 << 4;
+/// Disk I/O throughput, summed over all disks: the `disk_*` fields.
+pub const FOXGLOVE_SYSINFO_METRIC_DISK: u32 = 1 << 5;
+/// The SDK's own delivery queues and threads: the `sdk_*` fields.
+pub const FOXGLOVE_SYSINFO_METRIC_SDK: u32 = 1 << 6;
+
+const METRIC_FLAGS: [(u32, SystemInfoMetric); 7] = [
+    (FOXGLOVE_SYSINFO_METRIC_PROCESS, SystemInfoMetric::Process),
+    (FOXGLOVE_SYSINFO_METRIC_CPU, SystemInfoMetric::Cpu),
+    (
+        FOXGLOVE_SYSINFO_METRIC_CPU_PER_CORE,
+        SystemInfoMetric::CpuPerCore,
+    ),
+    (FOXGLOVE_SYSINFO_METRIC_MEMORY, SystemInfoMetric::Memory),
+    (FOXGLOVE_SYSINFO_METRIC_NETWORK, SystemInfoMetric::Network),
+    (FOXGLOVE_SYSINFO_METRIC_DISK, SystemInfoMetric::Disk),
+    (FOXGLOVE_SYSINFO_METRIC_SDK, SystemInfoMetric::Sdk),
+];
+
 /// Options for [`foxglove_system_info_publisher_start`].
 ///
 /// All fields are optional. To use the default for any field, leave the field
@@ -37,6 +65,12 @@ pub struct FoxgloveSystemInfoPublisherOptions<'a> {
     ///
     /// When null or zero, defaults to 500 ms. Clamped to a minimum of 200 ms.
     pub refresh_interval_ms: Option<&'a u64>,
+
+    /// Optional bitmask of `FOXGLOVE_SYSINFO_METRIC_*` flags selecting the metrics to collect.
+    ///
+    /// When zero, defaults to process, CPU and memory metrics. Only the selected metrics are
+    /// refreshed, and the fields of unselected metrics are omitted from each message.
+    pub metrics: u32,
 }
 
 /// Start the system info publisher.
@@ -90,6 +124,15 @@ unsafe fn do_start(
         builder = builder.refresh_interval(Duration::from_millis(refresh_ms));
     }
 
+    if options.metrics != 0 {
+        builder = builder.metrics(
+            METRIC_FLAGS
+                .iter()
+                .filter(|(flag, _)| options.metrics & flag != 0)
+                .map(|&(_, metric)| metric),
+        );
+    }
+
     let handle = builder.start();
     Ok(Box::into_raw(Box::new(FoxgloveSystemInfoPublisher(handle))))
 }
@@ -12,15 +12,25 @@
 set(FOXGLOVE_CPP_HANDWRITTEN_SOURCES
   callback_forwarders.cpp
   channel.cpp
+  clock.cpp
   connection_graph.cpp
   context.cpp
   error.cpp
   fetch_asset.cpp
   foxglove.cpp
+  image.cpp
+  latency.cpp
   mcap.cpp
+  mcap_player.cpp
+  mcap_reader.cpp
   parameter.cpp
   parameter_handler.cpp
+  point_cloud.cpp
+  ring_buffer.cpp
+  scene_update_tracker.cpp
+  sdk_stats.cpp
   service.cpp
+  shared_memory.cpp
   system_info.cpp
   websocket.cpp
 )
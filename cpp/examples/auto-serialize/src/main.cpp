@@ -1,15 +1,20 @@
-#include <foxglove/channel.hpp>
+#include <foxglove/json.hpp>
 #include <foxglove/mcap.hpp>
+#include <foxglove/typed_channel.hpp>
 
 #include <nlohmann/json.hpp>
 
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <thread>
-
-#include "jsonschema.hpp"
+#include <tuple>
+#include <vector>
 
 using json = nlohmann::json;
 
@@ -18,7 +23,8 @@ using namespace std::chrono_literals;
 /**
  * Message definitions with auto-serialization.
  *
- * See https://json.nlohmann.me/features/arbitrary_types
+ * The nlohmann::json definitions are used for MessagePack. See
+ * https://json.nlohmann.me/features/arbitrary_types
  */
 namespace messages {
 enum class MessageLevel : std::uint8_t {
@@ -39,6 +45,54 @@ struct Message {
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Message, level, msg, count)
 }  // namespace messages
 
+/**
+ * Describes the message for foxglove::JsonWriter, which writes JSON directly into the channel's
+ * encode buffer, and generates the JSON schema at compile time.
+ */
+template<>
+struct foxglove::JsonEnumValues<::messages::MessageLevel> {
+  static constexpr std::array<JsonEnumValue<::messages::MessageLevel>, 2> values = {{
+    {::messages::MessageLevel::DEBUG, "debug"},
+    {::messages::MessageLevel::INFO, "info"},
+  }};
+};
+
+template<>
+struct foxglove::JsonFields<::messages::Message> {
+  static constexpr std::string_view name = "Test";
+  static constexpr auto fields = std::make_tuple(
+    FOXGLOVE_JSON_FIELD(::messages::Message, level), FOXGLOVE_JSON_FIELD(::messages::Message, msg),
+    FOXGLOVE_JSON_FIELD(::messages::Message, count)
+  );
+};
+
+/**
+ * Logs messages as JSON, with a JSON schema derived from the message type.
+ *
+ * Specializing foxglove::MessageTraits makes this the default for TypedChannel<messages::Message>.
+ */
+template<>
+struct foxglove::MessageTraits<::messages::Message>
+    : foxglove::JsonMessageTraits<::messages::Message> {};
+
+/**
+ * Logs messages as MessagePack, a schemaless binary format.
+ *
+ * Passed explicitly as the Traits argument of TypedChannel, to use an alternative encoding.
+ */
+struct MsgPackTraits {
+  static constexpr std::string_view message_encoding = "msgpack";
+
+  static std::optional<foxglove::Schema> schema() {
+    return std::nullopt;
+  }
+
+  static foxglove::FoxgloveError encode(const messages::Message& msg, std::vector<uint8_t>& buf) {
+    json::to_msgpack(json(msg), buf);
+    return foxglove::FoxgloveError::Ok;
+  }
+};
+
 /**
  * This example writes some messages to an MCAP file, which can be opened in Foxglove and viewed in
  * the Raw Messages panel.
@@ -58,15 +112,7 @@ int main() {
   auto writer = std::move(writer_result.value());
 
   // 1: Channel with a JSON schema
-  json msg_schema = jsonschema::generate_schema<messages::Message>();
-  foxglove::Schema schema;
-  schema.name = "Test";
-  schema.encoding = "jsonschema";
-  std::string schema_data = msg_schema.dump();
-  schema.data = reinterpret_cast<const std::byte*>(schema_data.data());
-  schema.data_len = schema_data.size();
-
-  auto chan1_result = foxglove::RawChannel::create("/json", "json", schema);
+  auto chan1_result = foxglove::TypedChannel<messages::Message>::create("/json");
   if (!chan1_result.has_value()) {
     std::cerr << "Failed to create JSON channel: " << foxglove::strerror(chan1_result.error())
               << '\n';
@@ -75,7 +121,7 @@ int main() {
   auto ch1 = std::move(chan1_result.value());
 
   // 2: Channel with MsgPack
-  auto chan2_result = foxglove::RawChannel::create("/msgpack", "msgpack");
+  auto chan2_result = foxglove::TypedChannel<messages::Message, MsgPackTraits>::create("/msgpack");
   if (!chan2_result.has_value()) {
     std::cerr << "Failed to create MsgPack channel: " << foxglove::strerror(chan2_result.error())
               << '\n';
@@ -89,15 +135,9 @@ int main() {
     msg.msg = "Hello, World";
     msg.count = i;
 
-    // Serialize using the macros from the messages namespace
-    json value = msg;
-
-    auto json_val = value.dump();
-    ch1.log(reinterpret_cast<const std::byte*>(json_val.c_str()), json_val.size());
-
-    // MessagePack
-    std::vector<std::uint8_t> msgpack_val = json::to_msgpack(value);
-    ch2.log(reinterpret_cast<const std::byte*>(msgpack_val.data()), msgpack_val.size());
+    // Serialize using the traits for each channel
+    ch1.log(msg);
+    ch2.log(msg);
 
     std::this_thread::sleep_for(100ms);
   }
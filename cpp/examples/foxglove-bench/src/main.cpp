@@ -0,0 +1,718 @@
+// foxglove_bench: logs a replayed MCAP file or synthetic load into a set of sinks, and reports
+// throughput, CPU time, C++ heap allocations, and latency percentiles.
+//
+// Log latency is the time spent in RawChannel::log. Delivery latency is the time from logging a
+// message until a synthetic WebSocket client receives it; messages are logged with the current
+// system time as their log time, so clients can compute it from the MessageData timestamp.
+
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap.hpp>
+#include <foxglove/mcap_reader.hpp>
+#include <foxglove/websocket.hpp>
+#ifdef FOXGLOVE_REMOTE_ACCESS
+#include <foxglove/remote_access.hpp>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <libwebsockets.h>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<uint64_t> allocation_count{0};
+std::atomic<uint64_t> allocated_bytes{0};
+std::atomic<bool> interrupted{false};
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+constexpr auto kSetupTimeout = std::chrono::seconds(10);
+constexpr auto kDrainTime = std::chrono::milliseconds(500);
+
+uint64_t systemNanos() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()
+    )
+      .count()
+  );
+}
+
+/// A histogram of durations in nanoseconds, with buckets about 3% wide.
+///
+/// Recording a sample never allocates, and may be done from several threads at once.
+class LatencyHistogram {
+public:
+  void record(uint64_t nanos) {
+    counts_[bucket(nanos)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (nanos > max && !max_.compare_exchange_weak(max, nanos, std::memory_order_relaxed)) {
+    }
+  }
+
+  [[nodiscard]] uint64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] uint64_t max() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the upper bound of the bucket holding the quantile `q`, in nanoseconds.
+  [[nodiscard]] uint64_t quantile(double q) const {
+    const auto total = count();
+    if (total == 0) {
+      return 0;
+    }
+    const auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+      seen += counts_[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        return std::min(upperBound(i), max());
+      }
+    }
+    return max();
+  }
+
+private:
+  static constexpr unsigned kSubBits = 5;
+  static constexpr uint64_t kSubBuckets = 1U << kSubBits;
+
+  static size_t bucket(uint64_t value) {
+    if (value < kSubBuckets) {
+      return static_cast<size_t>(value);
+    }
+    unsigned msb = 0;
+    while ((value >> (msb + 1)) != 0) {
+      ++msb;
+    }
+    const unsigned shift = msb - kSubBits;
+    return static_cast<size_t>(((shift + 1) << kSubBits) + ((value >> shift) & (kSubBuckets - 1)));
+  }
+
+  static uint64_t upperBound(size_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    const auto shift = static_cast<unsigned>((index >> kSubBits) - 1);
+    const uint64_t sub = index & (kSubBuckets - 1);
+    return ((kSubBuckets + sub + 1) << shift) - 1;
+  }
+
+  std::array<std::atomic<uint64_t>, 64 * kSubBuckets> counts_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+/// A WebSocket client which subscribes to channels, and records the delivery latency of each
+/// message it receives.
+class SubscribingClient {
+public:
+  SubscribingClient(uint16_t port, const std::vector<uint64_t>& channel_ids)
+      : histogram_(std::make_unique<LatencyHistogram>()) {
+    subscribe_ = R"({"op":"subscribe","subscriptions":[)";
+    for (size_t i = 0; i < channel_ids.size(); ++i) {
+      if (i > 0) {
+        subscribe_ += ",";
+      }
+      subscribe_ += R"({"id":)" + std::to_string(i + 1) +
+                    R"(,"channelId":)" + std::to_string(channel_ids[i]) + "}";
+    }
+    subscribe_ += "]}";
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+    static const struct lws_protocols kProtocols[] = {
+      {"foxglove.sdk.v1", &SubscribingClient::callback, 0, 65536, 0, nullptr, 0},
+      {nullptr, nullptr, 0, 0, 0, nullptr, 0},
+    };
+    // NOLINTEND(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+
+    struct lws_context_creation_info info = {};
+    info.port = CONTEXT_PORT_NO_LISTEN;
+    info.protocols =
+      kProtocols;  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay,hicpp-no-array-decay)
+    info.user = this;
+    context_ = lws_create_context(&info);
+    if (context_ == nullptr) {
+      std::fprintf(stderr, "lws_create_context failed\n");
+      std::abort();
+    }
+
+    struct lws_client_connect_info connect_info = {};
+    connect_info.context = context_;
+    connect_info.address = "127.0.0.1";
+    connect_info.port = port;
+    connect_info.path = "/";
+    connect_info.host = connect_info.address;
+    connect_info.origin = connect_info.address;
+    connect_info.protocol = "foxglove.sdk.v1";
+    if (lws_client_connect_via_info(&connect_info) == nullptr) {
+      std::fprintf(stderr, "lws_client_connect_via_info failed\n");
+      std::abort();
+    }
+
+    thread_ = std::thread([this] {
+      while (running_) {
+        lws_service(context_, 50);
+      }
+    });
+  }
+
+  SubscribingClient(const SubscribingClient&) = delete;
+  SubscribingClient(SubscribingClient&&) = delete;
+  SubscribingClient& operator=(const SubscribingClient&) = delete;
+  SubscribingClient& operator=(SubscribingClient&&) = delete;
+
+  ~SubscribingClient() {
+    running_ = false;
+    lws_cancel_service(context_);
+    thread_.join();
+    lws_context_destroy(context_);
+  }
+
+  [[nodiscard]] const LatencyHistogram& latency() const {
+    return *histogram_;
+  }
+
+  [[nodiscard]] uint64_t receivedBytes() const {
+    return received_bytes_.load(std::memory_order_relaxed);
+  }
+
+private:
+  // Length of the opcode, subscription id and timestamp at the start of a MessageData frame.
+  static constexpr size_t kMessageDataHeaderLen = 13;
+  static constexpr uint8_t kMessageDataOpcode = 1;
+
+  static int callback(
+    struct lws* wsi, enum lws_callback_reasons reason, void* /*user*/, void* in, size_t len
+  ) {
+    auto* self = static_cast<SubscribingClient*>(lws_context_user(lws_get_context(wsi)));
+    if (self == nullptr) {
+      return 0;
+    }
+    switch (reason) {
+      case LWS_CALLBACK_CLIENT_ESTABLISHED:
+        lws_callback_on_writable(wsi);
+        break;
+      case LWS_CALLBACK_CLIENT_WRITEABLE:
+        if (!self->subscribed_) {
+          std::vector<uint8_t> buf(LWS_PRE + self->subscribe_.size());
+          std::memcpy(buf.data() + LWS_PRE, self->subscribe_.data(), self->subscribe_.size());
+          lws_write(wsi, buf.data() + LWS_PRE, self->subscribe_.size(), LWS_WRITE_TEXT);
+          self->subscribed_ = true;
+        }
+        break;
+      case LWS_CALLBACK_CLIENT_RECEIVE: {
+        self->received_bytes_.fetch_add(len, std::memory_order_relaxed);
+        const auto* data = static_cast<const uint8_t*>(in);
+        if (lws_frame_is_binary(wsi) != 0 && lws_is_first_fragment(wsi) != 0 &&
+            len >= kMessageDataHeaderLen && data[0] == kMessageDataOpcode) {
+          uint64_t log_time = 0;
+          for (size_t i = 0; i < sizeof(log_time); ++i) {
+            log_time |= static_cast<uint64_t>(data[5 + i]) << (8 * i);
+          }
+          const auto now = systemNanos();
+          self->histogram_->record(now > log_time ? now - log_time : 0);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    return 0;
+  }
+
+  std::string subscribe_;
+  bool subscribed_ = false;
+  std::unique_ptr<LatencyHistogram> histogram_;
+  struct lws_context* context_ = nullptr;
+  std::atomic<bool> running_{true};
+  std::atomic<uint64_t> received_bytes_{0};
+  std::thread thread_;
+};
+
+/// A synthetic topic, logged at a fixed rate with messages of a fixed size.
+struct SyntheticLoad {
+  std::string topic;
+  size_t size = 0;
+  double rate = 0;
+};
+
+struct Options {
+  std::optional<std::string> replay_path;
+  double speed = 1.0;
+  std::vector<SyntheticLoad> loads;
+  double duration_secs = 10.0;
+  std::optional<std::string> mcap_path;
+  size_t ws_clients = 0;
+  bool gateway = false;
+};
+
+void printUsage(const char* program) {
+  std::cerr
+    << "Usage: " << program << " [source] [sinks]\n"
+    << "Source:\n"
+    << "  --replay <path>          Replay the messages of an MCAP file\n"
+    << "  --speed <factor>         Replay speed, or 0 to replay as fast as possible (default: 1)\n"
+    << "  --load <topic:bytes:hz>  Log synthetic messages of a size at a rate, or as fast as\n"
+    << "                           possible for a rate of 0. May be repeated (default:\n"
+    << "                           /bench:1024:1000)\n"
+    << "  --duration <seconds>     Length of a synthetic run (default: 10)\n"
+    << "Sinks:\n"
+    << "  --mcap <path>            Write an MCAP file\n"
+    << "  --ws-clients <count>     Serve a WebSocket server to this many subscribing clients\n"
+#ifdef FOXGLOVE_REMOTE_ACCESS
+    << "  --gateway                Run a remote access gateway; requires FOXGLOVE_DEVICE_TOKEN\n"
+#endif
+    ;
+}
+
+std::optional<SyntheticLoad> parseLoad(const std::string& spec) {
+  const auto first = spec.find(':');
+  const auto second = spec.find(':', first == std::string::npos ? first : first + 1);
+  if (first == std::string::npos || second == std::string::npos) {
+    return std::nullopt;
+  }
+  try {
+    return SyntheticLoad{
+      spec.substr(0, first),
+      std::stoul(spec.substr(first + 1, second - first - 1)),
+      std::stod(spec.substr(second + 1)),
+    };
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+std::optional<Options> parseArgs(int argc, char* argv[]) {
+  Options options;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      const bool has_value = i + 1 < argc;
+      if (arg == "--replay" && has_value) {
+        options.replay_path = argv[++i];
+      } else if (arg == "--speed" && has_value) {
+        options.speed = std::stod(argv[++i]);
+      } else if (arg == "--load" && has_value) {
+        auto load = parseLoad(argv[++i]);
+        if (!load) {
+          std::cerr << "Invalid load: " << argv[i] << '\n';
+          return std::nullopt;
+        }
+        options.loads.push_back(std::move(*load));
+      } else if (arg == "--duration" && has_value) {
+        options.duration_secs = std::stod(argv[++i]);
+      } else if (arg == "--mcap" && has_value) {
+        options.mcap_path = argv[++i];
+      } else if (arg == "--ws-clients" && has_value) {
+        options.ws_clients = std::stoul(argv[++i]);
+#ifdef FOXGLOVE_REMOTE_ACCESS
+      } else if (arg == "--gateway") {
+        options.gateway = true;
+#endif
+      } else {
+        std::cerr << "Unknown argument: " << arg << '\n';
+        return std::nullopt;
+      }
+    }
+  } catch (const std::exception&) {
+    std::cerr << "Invalid number in arguments\n";
+    return std::nullopt;
+  }
+  if (options.replay_path && !options.loads.empty()) {
+    std::cerr << "--replay and --load cannot be combined\n";
+    return std::nullopt;
+  }
+  if (!options.replay_path && options.loads.empty()) {
+    options.loads.push_back({"/bench", 1024, 1000});
+  }
+  return options;
+}
+
+/// Process CPU time, in seconds, or std::nullopt where it is not available.
+std::optional<double> cpuSeconds() {
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage = {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return std::nullopt;
+  }
+  auto seconds = [](const struct timeval& tv) {
+    return static_cast<double>(tv.tv_sec) + (static_cast<double>(tv.tv_usec) / 1e6);
+  };
+  return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+#else
+  return std::nullopt;
+#endif
+}
+
+/// Counters for the messages logged by the benchmark.
+struct LogStats {
+  uint64_t messages = 0;
+  uint64_t bytes = 0;
+  LatencyHistogram latency;
+};
+
+void logMessage(
+  foxglove::RawChannel& channel, const std::byte* data, size_t len, LogStats& stats
+) {
+  const auto start = std::chrono::steady_clock::now();
+  channel.log(data, len, systemNanos());
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  stats.latency.record(
+    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())
+  );
+  ++stats.messages;
+  stats.bytes += len;
+}
+
+/// Replays the messages of an MCAP file, pacing them by log time divided by `speed`.
+bool replay(
+  const foxglove::McapReader& reader, std::vector<foxglove::RawChannel>& channels, double speed,
+  LogStats& stats
+) {
+  auto messages = reader.messages();
+  if (!messages.has_value()) {
+    std::cerr << "Failed to read messages: " << foxglove::strerror(messages.error()) << '\n';
+    return false;
+  }
+  const auto wall_start = std::chrono::steady_clock::now();
+  std::optional<uint64_t> first_log_time;
+  while (!interrupted) {
+    auto next = messages->next();
+    if (!next.has_value()) {
+      std::cerr << "Failed to read message: " << foxglove::strerror(next.error()) << '\n';
+      return false;
+    }
+    if (!next->has_value()) {
+      break;
+    }
+    const auto& message = **next;
+    if (!first_log_time) {
+      first_log_time = message.log_time;
+    }
+    if (speed > 0 && message.log_time > *first_log_time) {
+      const auto offset =
+        static_cast<double>(message.log_time - *first_log_time) / speed;
+      std::this_thread::sleep_until(
+        wall_start + std::chrono::nanoseconds(static_cast<int64_t>(offset))
+      );
+    }
+    auto& channel = channels[message.channel->id];
+    logMessage(channel, message.data, message.data_len, stats);
+  }
+  return true;
+}
+
+/// Logs synthetic messages for each load at its rate until `duration` has passed.
+void generate(
+  const std::vector<SyntheticLoad>& loads, std::vector<foxglove::RawChannel>& channels,
+  std::chrono::duration<double> duration, LogStats& stats
+) {
+  std::vector<std::vector<std::byte>> payloads;
+  payloads.reserve(loads.size());
+  for (const auto& load : loads) {
+    payloads.emplace_back(load.size, std::byte{0x2a});
+  }
+  const auto start = std::chrono::steady_clock::now();
+  const auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+  std::vector<std::chrono::steady_clock::time_point> due(loads.size(), start);
+  while (!interrupted) {
+    const auto next = std::min_element(due.begin(), due.end());
+    if (*next >= end) {
+      break;
+    }
+    std::this_thread::sleep_until(*next);
+    const auto index = static_cast<size_t>(next - due.begin());
+    logMessage(channels[index], payloads[index].data(), payloads[index].size(), stats);
+    if (loads[index].rate > 0) {
+      *next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / loads[index].rate)
+      );
+    } else {
+      *next = std::chrono::steady_clock::now();
+    }
+  }
+}
+
+void printLatency(const char* label, const LatencyHistogram& histogram) {
+  auto micros = [](uint64_t nanos) {
+    return static_cast<double>(nanos) / 1e3;
+  };
+  std::printf(
+    "%-20s p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+    label,
+    micros(histogram.quantile(0.5)),
+    micros(histogram.quantile(0.9)),
+    micros(histogram.quantile(0.99)),
+    micros(histogram.quantile(0.999)),
+    micros(histogram.max())
+  );
+}
+
+}  // namespace
+
+// Count the C++ heap allocations made by the benchmark and the SDK's C++ wrapper. Allocations
+// made by the SDK's Rust core use a separate allocator, and are not counted.
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);  // NOLINT(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);  // NOLINT(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);  // NOLINT(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);  // NOLINT(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+}
+
+// NOLINTNEXTLINE(bugprone-exception-escape)
+int main(int argc, char* argv[]) {
+  auto parsed = parseArgs(argc, argv);
+  if (!parsed) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  const auto& options = *parsed;
+  std::signal(SIGINT, [](int) {
+    interrupted = true;
+  });
+
+  auto context = foxglove::Context::create();
+
+  // Create the channels first, so that clients can subscribe to all of them.
+  std::optional<foxglove::McapReader> reader;
+  std::vector<foxglove::RawChannel> channels;
+  if (options.replay_path) {
+    auto opened = foxglove::McapReader::open(*options.replay_path);
+    if (!opened.has_value()) {
+      std::cerr << "Failed to open " << *options.replay_path << ": "
+                << foxglove::strerror(opened.error()) << '\n';
+      return 1;
+    }
+    reader = std::move(*opened);
+    // Channels are indexed by MCAP channel id.
+    for (const auto& mcap_channel : reader->channels()) {
+      while (channels.size() <= mcap_channel.id) {
+        auto placeholder = foxglove::RawChannel::create(
+          "/foxglove_bench/unused/" + std::to_string(channels.size()), "", std::nullopt, context
+        );
+        channels.push_back(std::move(placeholder.value()));
+      }
+      auto channel = foxglove::RawChannel::create(
+        mcap_channel.topic, mcap_channel.message_encoding, mcap_channel.schema, context
+      );
+      if (!channel.has_value()) {
+        std::cerr << "Failed to create channel " << mcap_channel.topic << '\n';
+        return 1;
+      }
+      channels[mcap_channel.id] = std::move(channel.value());
+    }
+  } else {
+    for (const auto& load : options.loads) {
+      auto channel = foxglove::RawChannel::create(load.topic, "bytes", std::nullopt, context);
+      if (!channel.has_value()) {
+        std::cerr << "Failed to create channel " << load.topic << '\n';
+        return 1;
+      }
+      channels.push_back(std::move(channel.value()));
+    }
+  }
+
+  std::optional<foxglove::McapWriter> mcap;
+  if (options.mcap_path) {
+    foxglove::McapWriterOptions mcap_options;
+    mcap_options.context = context;
+    mcap_options.path = *options.mcap_path;
+    mcap_options.truncate = true;
+    auto writer = foxglove::McapWriter::create(mcap_options);
+    if (!writer.has_value()) {
+      std::cerr << "Failed to create MCAP writer: " << foxglove::strerror(writer.error()) << '\n';
+      return 1;
+    }
+    mcap = std::move(writer.value());
+  }
+
+  std::optional<foxglove::WebSocketServer> server;
+  std::vector<std::unique_ptr<SubscribingClient>> clients;
+  if (options.ws_clients > 0) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t subscriptions = 0;
+    foxglove::WebSocketServerOptions ws_options;
+    ws_options.context = context;
+    ws_options.name = "foxglove-bench";
+    ws_options.port = 0;
+    ws_options.callbacks.onSubscribe = [&](uint64_t, const foxglove::ClientMetadata&) {
+      std::scoped_lock lock{mutex};
+      ++subscriptions;
+      cv.notify_all();
+    };
+    auto created = foxglove::WebSocketServer::create(std::move(ws_options));
+    if (!created.has_value()) {
+      std::cerr << "Failed to create WebSocket server: " << foxglove::strerror(created.error())
+                << '\n';
+      return 1;
+    }
+    server = std::move(created.value());
+    std::vector<uint64_t> channel_ids;
+    channel_ids.reserve(channels.size());
+    for (const auto& channel : channels) {
+      channel_ids.push_back(channel.id());
+    }
+    for (size_t i = 0; i < options.ws_clients; ++i) {
+      clients.push_back(std::make_unique<SubscribingClient>(server->port(), channel_ids));
+    }
+    std::unique_lock lock{mutex};
+    if (!cv.wait_for(lock, kSetupTimeout, [&] {
+          return subscriptions == options.ws_clients * channel_ids.size();
+        })) {
+      std::cerr << "Timed out waiting for WebSocket clients to subscribe\n";
+      return 1;
+    }
+  }
+
+#ifdef FOXGLOVE_REMOTE_ACCESS
+  std::optional<foxglove::RemoteAccessGateway> gateway;
+  if (options.gateway) {
+    foxglove::RemoteAccessGatewayOptions gateway_options;
+    gateway_options.context = context;
+    gateway_options.name = "foxglove-bench";
+    auto created = foxglove::RemoteAccessGateway::create(std::move(gateway_options));
+    if (!created.has_value()) {
+      std::cerr << "Failed to create remote access gateway: "
+                << foxglove::strerror(created.error()) << '\n';
+      return 1;
+    }
+    gateway = std::move(created.value());
+  }
+#endif
+
+  LogStats stats;
+  const auto cpu_start = cpuSeconds();
+  const auto allocations_start = allocation_count.load();
+  const auto allocated_bytes_start = allocated_bytes.load();
+  const auto wall_start = std::chrono::steady_clock::now();
+  if (reader) {
+    if (!replay(*reader, channels, options.speed, stats)) {
+      return 1;
+    }
+  } else {
+    generate(
+      options.loads, channels, std::chrono::duration<double>(options.duration_secs), stats
+    );
+  }
+  const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wall_start;
+  const auto allocations = allocation_count.load() - allocations_start;
+  const auto allocations_bytes = allocated_bytes.load() - allocated_bytes_start;
+  const auto cpu_end = cpuSeconds();
+
+  // Give clients a moment to receive the last messages, and finish the MCAP file.
+  if (!clients.empty()) {
+    std::this_thread::sleep_for(kDrainTime);
+  }
+  if (mcap) {
+    mcap->close();
+  }
+
+  const double secs = wall.count();
+  std::printf("%-20s %.2f s\n", "Wall time:", secs);
+  std::printf(
+    "%-20s %llu (%.0f msg/s, %.1f MB/s)\n",
+    "Messages logged:",
+    static_cast<unsigned long long>(stats.messages),
+    static_cast<double>(stats.messages) / secs,
+    static_cast<double>(stats.bytes) / secs / 1e6
+  );
+  printLatency("Log latency:", stats.latency);
+  if (cpu_start && cpu_end) {
+    const double cpu = *cpu_end - *cpu_start;
+    std::printf("%-20s %.2f s (%.0f%% of one core)\n", "CPU time:", cpu, 100.0 * cpu / secs);
+  }
+  std::printf(
+    "%-20s %llu (%.0f per message, %.1f MB)\n",
+    "C++ allocations:",
+    static_cast<unsigned long long>(allocations),
+    stats.messages > 0 ? static_cast<double>(allocations) / static_cast<double>(stats.messages)
+                       : 0.0,
+    static_cast<double>(allocations_bytes) / 1e6
+  );
+  for (size_t i = 0; i < clients.size(); ++i) {
+    const auto& latency = clients[i]->latency();
+    std::printf(
+      "Client %zu:%*s %llu messages (%.1f%%), %.1f MB\n",
+      i,
+      static_cast<int>(12 - std::to_string(i).size()),
+      "",
+      static_cast<unsigned long long>(latency.count()),
+      stats.messages > 0
+        ? 100.0 * static_cast<double>(latency.count()) / static_cast<double>(stats.messages)
+        : 0.0,
+      static_cast<double>(clients[i]->receivedBytes()) / 1e6
+    );
+    printLatency("  Delivery latency:", latency);
+  }
+  if (options.mcap_path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(*options.mcap_path, ec);
+    if (!ec) {
+      std::printf("%-20s %.1f MB\n", "MCAP file size:", static_cast<double>(size) / 1e6);
+    }
+  }
+
+  clients.clear();
+  if (server) {
+    server->stop();
+  }
+#ifdef FOXGLOVE_REMOTE_ACCESS
+  if (gateway) {
+    gateway->stop();
+  }
+#endif
+  return 0;
+}
@@ -33,6 +33,13 @@
 /// @code{.sh}
 ///   mcap info data.mcap
 /// @endcode
+///
+/// The first request for a flight and time range generates the MCAP data into a file in a cache
+/// directory. Later requests, including `Range:` requests, are served from that file:
+/// @code{.sh}
+///   curl -r 0-1023 --output head.bin "http://localhost:8081/v1/data?flightId=ABC123\
+///     &startTime=2024-01-01T00:00:00Z&endTime=2024-01-02T00:00:00Z"
+/// @endcode
 
 #include <foxglove/context.hpp>
 #include <foxglove/error.hpp>
@@ -43,11 +50,15 @@
 #include <date/date.h>
 
 #include <algorithm>
-#include <cerrno>
 #include <chrono>
 #include <cstdint>
+#include <filesystem>
 #include <httplib.h>
 #include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -75,6 +86,20 @@ std::string formatIso8601(system_clock::time_point tp) {
   return date::format("%FT%TZ", date::floor<std::chrono::seconds>(tp));
 }
 
+/// Convert a time_point at or after the Unix epoch to nanoseconds since the epoch.
+uint64_t toUnixNanos(system_clock::time_point tp) {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count()
+  );
+}
+
+/// Convert nanoseconds since the Unix epoch to a time_point.
+system_clock::time_point fromUnixNanos(uint64_t ns) {
+  return system_clock::time_point{std::chrono::duration_cast<system_clock::duration>(
+    std::chrono::nanoseconds{static_cast<int64_t>(ns)}
+  )};
+}
+
 // ============================================================================
 // Routes
 // ============================================================================
@@ -84,6 +109,11 @@ static constexpr const char* kManifestRoute = "/v1/manifest";
 static constexpr const char* kDataRoute = "/v1/data";
 static constexpr int kPort = 8081;
 
+// Approximate size of the generated MCAP data per second of flight time, and the amount of data
+// each source in the manifest should hold.
+static constexpr uint64_t kEstimatedBytesPerSecond = 64;
+static constexpr uint64_t kTargetSegmentBytes = static_cast<uint64_t>(1) * 1024 * 1024;
+
 // ============================================================================
 // Flight parameters (parsed from query parameters)
 // ============================================================================
@@ -130,6 +160,50 @@ std::optional<FlightParams> requireFlightParams(
   return params;
 }
 
+// ============================================================================
+// Response caches
+// ============================================================================
+
+// Limit on the number of manifests kept in memory.
+static constexpr size_t kMaxCachedResponses = 16;
+
+/// Generated responses keyed by flight and time range, evicting the oldest entries first.
+template<typename T>
+class ResponseCache {
+public:
+  std::shared_ptr<const T> get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    return it == entries_.end() ? nullptr : it->second;
+  }
+
+  void insert(const std::string& key, std::shared_ptr<const T> value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!entries_.emplace(key, std::move(value)).second) {
+      return;
+    }
+    order_.push_back(key);
+    if (order_.size() > kMaxCachedResponses) {
+      entries_.erase(order_.front());
+      order_.pop_front();
+    }
+  }
+
+private:
+  std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<const T>> entries_;
+  std::list<std::string> order_;
+};
+
+static ResponseCache<rdl::SerializedManifest> manifest_cache;
+
+// Generating the data is the expensive part of serving a request, and the app re-requests a
+// source when it seeks. Each source is generated once into a file in this directory, which also
+// allows serving byte ranges, which a stream generated on the fly cannot.
+static rdl::McapFileCache mcap_cache(
+  std::filesystem::temp_directory_path() / "foxglove_remote_data_loader_backend"
+);
+
 // ============================================================================
 // Auth
 // ============================================================================
@@ -147,9 +221,63 @@ bool requireAuth(
 // Handlers
 // ============================================================================
 
+/// Build the source for a flight and time range.
+rdl::StreamedSource buildSource(const FlightParams& params) {
+  // Declare a single channel of Foxglove `Vector3` messages on topic "/demo". The channels are
+  // the same for every flight, so only extract and encode their schemas once.
+  static const rdl::ChannelSet channels = [] {
+    rdl::ChannelSet channels;
+    channels.insert<foxglove::messages::Vector3>("/demo");
+    return channels;
+  }();
+
+  auto query = params.toQueryString();
+  rdl::StreamedSource source;
+  // We're providing the data from this service in this example, but in principle this could
+  // be any URL.
+  source.url = kDataRoute + std::string("?") + query;
+  // `id` must be unique to this data source. Otherwise, incorrect data may be served from
+  // cache.
+  //
+  // Here we reuse the query string to make sure we don't forget any parameters. We also
+  // include a version number we increment whenever we change the data handler.
+  source.id = "flight-v1-" + query;
+  source.topics = channels.topics;
+  source.schemas = channels.schemas;
+  source.start_time = formatIso8601(params.start_time);
+  source.end_time = formatIso8601(params.end_time);
+  return source;
+}
+
+/// Build the manifest describing the channels and schemas available for a flight.
+rdl::Manifest buildManifest(const FlightParams& params) {
+  // Split long flights into several sources, so that the app can fetch them in parallel and the
+  // server can generate them concurrently. Query parameters only carry whole seconds, so segment
+  // boundaries are aligned to seconds.
+  rdl::SegmentOptions options;
+  options.estimated_bytes_per_second = kEstimatedBytesPerSecond;
+  options.target_bytes_per_segment = kTargetSegmentBytes;
+  options.alignment_ns = 1'000'000'000;
+  auto segments = rdl::splitTimeRange(
+    toUnixNanos(std::max(params.start_time, system_clock::time_point{})),
+    toUnixNanos(std::max(params.end_time, system_clock::time_point{})),
+    options
+  );
+
+  rdl::Manifest manifest;
+  manifest.name = "Flight " + params.flight_id;
+  for (const auto& segment : segments) {
+    FlightParams segment_params{
+      params.flight_id, fromUnixNanos(segment.start_ns), fromUnixNanos(segment.end_ns)
+    };
+    manifest.sources.push_back(buildSource(segment_params));
+  }
+  return manifest;
+}
+
 /// Handler for `GET /v1/manifest`.
 ///
-/// Builds a manifest describing the channels and schemas available for the requested flight.
+/// Returns a manifest describing the channels and schemas available for the requested flight.
 ///
 /// The user **MUST** be authorized to read all sources returned in the manifest. Do not rely
 /// on authorization checks on individual sources, because they may not be called for cached data.
@@ -163,36 +291,95 @@ void manifestHandler(const httplib::Request& req, httplib::Response& res) {
     return;
   }
 
-  // Declare a single channel of Foxglove `Vector3` messages on topic "/demo".
-  rdl::ChannelSet channels;
-  channels.insert<foxglove::messages::Vector3>("/demo");
-
+  // The manifest for a query never changes, so serialize it once. Clients that already have it
+  // revalidate with `If-None-Match` and get an empty `304 Not Modified` response.
   auto query = params->toQueryString();
+  auto manifest = manifest_cache.get(query);
+  if (!manifest) {
+    manifest = std::make_shared<const rdl::SerializedManifest>(
+      rdl::serializeManifest(buildManifest(*params))
+    );
+    manifest_cache.insert(query, manifest);
+  }
 
-  rdl::StreamedSource source;
-  // We're providing the data from this service in this example, but in principle this could
-  // be any URL.
-  source.url = kDataRoute + std::string("?") + query;
-  // `id` must be unique to this data source. Otherwise, incorrect data may be served from cache.
-  //
-  // Here we reuse the query string to make sure we don't forget any parameters. We also
-  // include a version number we increment whenever we change the data handler.
-  source.id = "flight-v1-" + query;
-  source.topics = std::move(channels.topics);
-  source.schemas = std::move(channels.schemas);
-  source.start_time = formatIso8601(params->start_time);
-  source.end_time = formatIso8601(params->end_time);
+  res.set_header("ETag", manifest->etag);
+  if (req.has_header("If-None-Match") &&
+      rdl::etagMatches(req.get_header_value("If-None-Match"), manifest->etag)) {
+    res.status = 304;
+    return;
+  }
+  res.set_content(manifest->json, "application/json");
+}
 
-  rdl::Manifest manifest;
-  manifest.name = "Flight " + params->flight_id;
-  manifest.sources = {std::move(source)};
+/// Write the MCAP data for a flight to a file.
+foxglove::FoxgloveError generateMcap(const FlightParams& params, const std::string& path) {
+  // Create a dedicated context for this request's MCAP output.
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path;
+  options.chunk_size = static_cast<uint64_t>(64) * 1024;
+
+  auto writer_result = foxglove::McapWriter::create(options);
+  if (!writer_result.has_value()) {
+    std::cerr << "[remote_data_loader_backend] failed to create MCAP writer: "
+              << foxglove::strerror(writer_result.error()) << "\n";
+    return writer_result.error();
+  }
+  auto writer = std::move(writer_result.value());
+
+  auto channel_result = foxglove::messages::Vector3Channel::create("/demo", context);
+  if (!channel_result.has_value()) {
+    std::cerr << "[remote_data_loader_backend] failed to create channel: "
+              << foxglove::strerror(channel_result.error()) << "\n";
+    return channel_result.error();
+  }
+  auto channel = std::move(channel_result.value());
+
+  // In this example, we query a simulated dataset, but in a real implementation you would
+  // probably query a database or other storage.
+  //
+  // This simulated dataset consists of messages emitted every second from the Unix epoch.
+  std::cerr << "[remote_data_loader_backend] generating data for flight " << params.flight_id
+            << "\n";
+
+  auto start = std::max(params.start_time, system_clock::time_point{});
+  auto ts = date::ceil<std::chrono::seconds>(start);
+
+  while (ts <= params.end_time) {
+    // Messages in the output MUST appear in ascending timestamp order. Otherwise, playback
+    // will be incorrect.
+    foxglove::messages::Vector3 msg;
+    msg.x = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::seconds>(ts.time_since_epoch()).count()
+    );
+    msg.y = 0.0;
+    msg.z = 0.0;
+
+    // Log with an explicit nanosecond timestamp. This assumes system_clock uses the
+    // Unix epoch, which is guaranteed by C++20 but not C++17 (true in practice on all
+    // major implementations).
+    channel.log(
+      msg,
+      static_cast<uint64_t>(date::floor<std::chrono::nanoseconds>(ts).time_since_epoch().count())
+    );
+
+    ts += std::chrono::seconds(1);
+  }
 
-  res.set_content(rdl::toJsonString(manifest), "application/json");
+  // Finalize the MCAP file (writes the summary and footer).
+  auto err = writer.close();
+  if (err != foxglove::FoxgloveError::Ok) {
+    std::cerr << "[remote_data_loader_backend] error closing MCAP writer: "
+              << foxglove::strerror(err) << "\n";
+  }
+  return err;
 }
 
 /// Handler for `GET /v1/data`.
 ///
-/// Streams MCAP data for the requested flight. The response body is a stream of MCAP bytes.
+/// Serves MCAP data for the requested flight. The response body is a stream of MCAP bytes.
 void dataHandler(const httplib::Request& req, httplib::Response& res) {
   auto params = requireFlightParams(req, res);
   if (!params) {
@@ -203,109 +390,21 @@ void dataHandler(const httplib::Request& req, httplib::Response& res) {
     return;
   }
 
-  res.set_chunked_content_provider(
-    "application/octet-stream",
-    [params = std::move(*params)](size_t /*offset*/, httplib::DataSink& sink) {
-      // Create a dedicated context for this request's MCAP output.
-      auto context = foxglove::Context::create();
-
-      bool write_ok = true;
-
-      // The CustomWriter sends MCAP data directly to the HTTP socket. The MCAP writer
-      // buffers internally (up to chunk_size bytes) before calling write, so each call
-      // here corresponds to one MCAP chunk being flushed.
-      uint64_t position = 0;
-      foxglove::CustomWriter custom_writer;
-      custom_writer.write =
-        [&position, &sink, &write_ok](const uint8_t* data, size_t len, int* error) -> size_t {
-        if (sink.write(reinterpret_cast<const char*>(data), len)) {
-          position += len;
-          return len;
-        }
-        *error = EIO;
-        write_ok = false;
-        return 0;
-      };
-      custom_writer.flush = []() -> int {
-        // httplib manages flushing itself, so we don't do anything here.
-        return 0;
-      };
-      custom_writer.seek = foxglove::noSeekFn(&position);
-
-      foxglove::McapWriterOptions options;
-      options.context = context;
-      options.custom_writer = custom_writer;
-      options.disable_seeking = true;
-      options.chunk_size = static_cast<uint64_t>(64) * 1024;
-
-      auto writer_result = foxglove::McapWriter::create(options);
-      if (!writer_result.has_value()) {
-        std::cerr << "[remote_data_loader_backend] failed to create MCAP writer: "
-                  << foxglove::strerror(writer_result.error()) << "\n";
-        sink.done();
-        return false;
-      }
-      auto writer = std::move(writer_result.value());
-
-      auto channel_result = foxglove::messages::Vector3Channel::create("/demo", context);
-      if (!channel_result.has_value()) {
-        std::cerr << "[remote_data_loader_backend] failed to create channel: "
-                  << foxglove::strerror(channel_result.error()) << "\n";
-        sink.done();
-        return false;
-      }
-      auto channel = std::move(channel_result.value());
-
-      // In this example, we query a simulated dataset, but in a real implementation you would
-      // probably query a database or other storage. Because the CustomWriter sends data directly
-      // to the client, you can iterate over a database cursor here and the client will receive
-      // data incrementally as MCAP chunks are flushed.
-      //
-      // This simulated dataset consists of messages emitted every second from the Unix epoch.
-      std::cerr << "[remote_data_loader_backend] streaming data for flight " << params.flight_id
-                << "\n";
-
-      auto start = std::max(params.start_time, system_clock::time_point{});
-      auto ts = date::ceil<std::chrono::seconds>(start);
-
-      while (write_ok && ts <= params.end_time) {
-        // Messages in the output MUST appear in ascending timestamp order. Otherwise, playback
-        // will be incorrect.
-        foxglove::messages::Vector3 msg;
-        msg.x = static_cast<double>(
-          std::chrono::duration_cast<std::chrono::seconds>(ts.time_since_epoch()).count()
-        );
-        msg.y = 0.0;
-        msg.z = 0.0;
-
-        // Log with an explicit nanosecond timestamp. This assumes system_clock uses the
-        // Unix epoch, which is guaranteed by C++20 but not C++17 (true in practice on all
-        // major implementations).
-        channel.log(
-          msg,
-          static_cast<uint64_t>(date::floor<std::chrono::nanoseconds>(ts).time_since_epoch().count()
-          )
-        );
-
-        ts += std::chrono::seconds(1);
-      }
-
-      if (!write_ok) {
-        std::cerr << "[remote_data_loader_backend] client disconnected\n";
-        return false;
-      }
-
-      // Finalize the MCAP file (writes header/footer via the CustomWriter to the socket).
-      auto err = writer.close();
-      if (err != foxglove::FoxgloveError::Ok) {
-        std::cerr << "[remote_data_loader_backend] error closing MCAP writer: "
-                  << foxglove::strerror(err) << "\n";
-      }
-
-      sink.done();
-      return false;
-    }
-  );
+  // Generate the data into the cache, unless a previous request already did. Concurrent requests
+  // for the same source wait for a single generation.
+  auto path = mcap_cache.getOrCreate(buildSource(*params), [&params](const std::string& path) {
+    return generateMcap(*params, path);
+  });
+  if (!path.has_value()) {
+    res.status = 500;
+    res.set_content("Failed to generate data", "text/plain");
+    return;
+  }
+
+  // httplib maps the file into memory and answers `Range:` requests with just the requested
+  // bytes.
+  res.set_header("Accept-Ranges", "bytes");
+  res.set_file_content(*path, "application/octet-stream");
 }
 
 // ============================================================================
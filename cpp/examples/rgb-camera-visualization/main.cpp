@@ -6,7 +6,6 @@
 #include <opencv2/videoio.hpp>
 
 #include <chrono>
-#include <cstring>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -65,23 +64,21 @@ public:
   cv::VideoCapture cap_;
 };
 
-foxglove::messages::RawImage create_raw_image_message(const cv::Mat& frame) {
-  int height = frame.rows;
-  int width = frame.cols;
-  int channels = frame.channels();
-
-  // Convert uint8_t data to std::byte
-  size_t data_size = frame.total() * frame.elemSize();
-  std::vector<std::byte> data(data_size);
-  std::memcpy(data.data(), frame.data, data_size);
+// The returned view borrows the frame's pixel data, so the frame must outlive the log call.
+// Frames whose rows aren't contiguous, such as an ROI of a larger image, are copied first.
+foxglove::messages::RawImageView create_raw_image_message(cv::Mat& frame) {
+  if (!frame.isContinuous()) {
+    frame = frame.clone();
+  }
 
-  foxglove::messages::RawImage msg;
-  msg.width = width;
-  msg.height = height;
-  msg.step = width * channels;
+  foxglove::messages::RawImageView msg;
+  msg.width = frame.cols;
+  msg.height = frame.rows;
+  msg.step = static_cast<uint32_t>(frame.step);
   msg.encoding = "bgr8";
   msg.frame_id = "camera";
-  msg.data = std::move(data);
+  msg.data = reinterpret_cast<const std::byte*>(frame.data);
+  msg.data_len = frame.step * frame.rows;
 
   // Create timestamp manually
   auto now = std::chrono::system_clock::now();
@@ -1,4 +1,5 @@
 #include <foxglove/foxglove.hpp>
+#include <foxglove/mcap_player.hpp>
 #include <foxglove/websocket.hpp>
 
 #include <atomic>
@@ -6,13 +7,10 @@
 #include <csignal>
 #include <functional>
 #include <iostream>
-#include <memory>
-#include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
 
-#include "mcap_player.hpp"
-
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 static std::function<void()> sigint_handler;
 
@@ -65,14 +63,29 @@ int main(int argc, char* argv[]) {
 
   std::cerr << "Loading MCAP summary\n";
 
-  auto player = McapPlayer::create(file_path);
-  if (!player) {
+  // The server is created once the player has read the file's time range. The player stays
+  // paused until a client asks it to play, so its callbacks only run once the server exists.
+  std::optional<foxglove::WebSocketServer> server;
+
+  foxglove::McapPlayerOptions player_options;
+  // Broadcast the current playback time (nanoseconds since epoch) at about 60 Hz.
+  // Requires WebSocketServerCapabilities::Time to be advertised by the server.
+  player_options.on_time = [&server](uint64_t current_time) {
+    server->broadcastTime(current_time);
+  };
+  // Tell clients when playback reaches the end of the file.
+  player_options.on_playback_state = [&server](const foxglove::PlaybackState& state) {
+    server->broadcastPlaybackState(state);
+  };
+
+  // The player reads and decompresses messages on one thread, and logs them at their log times
+  // on another.
+  auto player_result = foxglove::McapPlayer::create(file_path, std::move(player_options));
+  if (!player_result.has_value()) {
+    std::cerr << "Failed to open MCAP file: " << foxglove::strerror(player_result.error()) << '\n';
     return 1;
   }
-
-  auto time_range = player->timeRange();
-  auto player_mutex = std::make_shared<std::mutex>();
-  auto player_ptr = std::shared_ptr<McapPlayer>(std::move(player));
+  auto& player = player_result.value();
 
   foxglove::WebSocketServerOptions options = {};
   options.name = server_name;
@@ -83,44 +96,13 @@ int main(int argc, char* argv[]) {
   options.capabilities = foxglove::WebSocketServerCapabilities::PlaybackControl |
                          foxglove::WebSocketServerCapabilities::Time;
   // The playback time range tells clients the start/end bounds of the data (nanoseconds).
+  options.playback_time_range = player.timeRange();
 
-  options.playback_time_range = time_range;
-
-  // Capture shared objects by value so callback and main loop coordinate the same state safely.
-  const auto& mtx = player_mutex;
-  const auto& player_ref = player_ptr;
   // Handle playback control requests from Foxglove and return the updated playback state.
-  options.callbacks.onPlaybackControlRequest = [mtx, player_ref](
-                                                 const foxglove::PlaybackControlRequest& request
-                                               ) -> std::optional<foxglove::PlaybackState> {
-    std::lock_guard<std::mutex> lock(*mtx);
-
-    bool did_seek = request.seek_time.has_value();
-
-    if (request.seek_time.has_value()) {
-      if (!player_ref->seek(*request.seek_time)) {
-        did_seek = false;
-      }
-    }
-
-    player_ref->setPlaybackSpeed(request.playback_speed);
-
-    switch (request.playback_command) {
-      case foxglove::PlaybackCommand::Play:
-        player_ref->play();
-        break;
-      case foxglove::PlaybackCommand::Pause:
-        player_ref->pause();
-        break;
-    }
-
-    return foxglove::PlaybackState{
-      player_ref->status(),
-      player_ref->currentTime(),
-      player_ref->playbackSpeed(),
-      did_seek,
-      request.request_id,
-    };
+  options.callbacks.onPlaybackControlRequest =
+    [&player](const foxglove::PlaybackControlRequest& request
+    ) -> std::optional<foxglove::PlaybackState> {
+    return player.handlePlaybackControlRequest(request);
   };
 
   auto server_result = foxglove::WebSocketServer::create(std::move(options));
@@ -128,7 +110,7 @@ int main(int argc, char* argv[]) {
     std::cerr << "Failed to create server: " << foxglove::strerror(server_result.error()) << '\n';
     return 1;
   }
-  auto server = std::move(server_result.value());
+  server.emplace(std::move(server_result.value()));
 
   std::atomic_bool done{false};
   std::signal(SIGINT, [](int) {
@@ -143,45 +125,10 @@ int main(int argc, char* argv[]) {
 
   std::cerr << "Server ready on " << host << ":" << port << '\n';
 
-  std::cerr << "Starting stream\n";
-  auto last_status = foxglove::PlaybackStatus::Paused;
-  foxglove::PlaybackStatus current_status = foxglove::PlaybackStatus::Paused;
-
   while (!done) {
-    {
-      std::lock_guard<std::mutex> lock(*mtx);
-      current_status = player_ptr->status();
-
-      if (current_status == foxglove::PlaybackStatus::Ended &&
-          last_status != foxglove::PlaybackStatus::Ended) {
-        server.broadcastPlaybackState(foxglove::PlaybackState{
-          foxglove::PlaybackStatus::Ended,
-          player_ptr->currentTime(),
-          player_ptr->playbackSpeed(),
-          false,
-          std::nullopt,
-        });
-      }
-    }
-    last_status = current_status;
-
-    if (current_status != foxglove::PlaybackStatus::Playing) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
-      continue;
-    }
-
-    std::optional<std::chrono::nanoseconds> sleep_duration;
-    {
-      std::lock_guard<std::mutex> lock(*mtx);
-      sleep_duration = player_ptr->logNextMessage(server);
-    }
-
-    if (sleep_duration.has_value()) {
-      auto capped = std::min(*sleep_duration, std::chrono::nanoseconds(1'000'000'000));
-      std::this_thread::sleep_for(capped);
-    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
   }
 
-  server.stop();
+  server->stop();
   return 0;
 }
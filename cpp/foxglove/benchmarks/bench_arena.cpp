@@ -0,0 +1,66 @@
+#include <foxglove/arena.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+/// Allocates `range(0)` bytes from a fresh arena. Requests larger than the inline buffer fall back
+/// to a heap allocation.
+void BM_ArenaAllocFresh(benchmark::State& state) {
+  const auto bytes = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    foxglove::Arena arena;
+    auto* data = arena.alloc<uint8_t>(bytes);
+    benchmark::DoNotOptimize(data);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_ArenaAllocFresh)
+  ->ArgName("bytes")
+  ->Arg(1024)
+  ->Arg(static_cast<int64_t>(foxglove::Arena::kSize))
+  ->Arg(static_cast<int64_t>(foxglove::Arena::kSize) * 8)
+  ->Arg(static_cast<int64_t>(foxglove::Arena::kSize) * 64);
+
+/// Allocates `range(0)` bytes from an arena which is reset between iterations, as the typed
+/// channels do. Once warm, overflowing requests are served from the retained heap blocks.
+void BM_ArenaAllocReused(benchmark::State& state) {
+  const auto bytes = static_cast<size_t>(state.range(0));
+  foxglove::Arena arena;
+  for (auto _ : state) {
+    auto* data = arena.alloc<uint8_t>(bytes);
+    benchmark::DoNotOptimize(data);
+    benchmark::ClobberMemory();
+    arena.reset();
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+  state.counters["overflow_allocations"] = static_cast<double>(arena.overflowAllocations());
+}
+BENCHMARK(BM_ArenaAllocReused)
+  ->ArgName("bytes")
+  ->Arg(1024)
+  ->Arg(static_cast<int64_t>(foxglove::Arena::kSize))
+  ->Arg(static_cast<int64_t>(foxglove::Arena::kSize) * 8)
+  ->Arg(static_cast<int64_t>(foxglove::Arena::kSize) * 64);
+
+/// Fills an arena with many small allocations, as when converting a message with many nested
+/// fields, so that the later ones overflow the inline buffer.
+void BM_ArenaManySmallAllocs(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  constexpr size_t kElementBytes = 48;
+  foxglove::Arena arena;
+  for (auto _ : state) {
+    for (size_t i = 0; i < count; ++i) {
+      benchmark::DoNotOptimize(arena.alloc<uint8_t>(kElementBytes));
+    }
+    arena.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_ArenaManySmallAllocs)->ArgName("allocs")->Arg(64)->Arg(1024)->Arg(16384);
+
+}  // namespace
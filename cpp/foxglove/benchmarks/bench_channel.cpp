@@ -0,0 +1,115 @@
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/messages.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "common/bench_helpers.hpp"
+
+using foxglove_bench::DiscardingMcapWriter;
+using foxglove_bench::unwrap;
+
+namespace {
+
+/// Logs a raw message to a channel with `range(0)` sinks, each an uncompressed MCAP writer which
+/// discards its output. With no sinks, this measures the cost of the FFI call alone.
+void BM_RawChannelLog(benchmark::State& state) {
+  const auto sink_count = static_cast<size_t>(state.range(0));
+  const auto message_size = static_cast<size_t>(state.range(1));
+  auto context = foxglove::Context::create();
+  std::vector<DiscardingMcapWriter> sinks;
+  sinks.reserve(sink_count);
+  for (size_t i = 0; i < sink_count; ++i) {
+    sinks.emplace_back(context);
+  }
+  auto channel = unwrap(
+    foxglove::RawChannel::create("/bench", "json", std::nullopt, context), "RawChannel::create"
+  );
+  std::vector<std::byte> message(message_size, std::byte{0x2a});
+
+  uint64_t log_time = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(channel.log(message.data(), message.size(), ++log_time));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(message_size));
+  channel.close();
+}
+BENCHMARK(BM_RawChannelLog)->ArgNames({"sinks", "bytes"})->ArgsProduct({{0, 1, 4}, {64, 4096}});
+
+foxglove::messages::SceneUpdate makeSceneUpdate(size_t cubes) {
+  foxglove::messages::SceneEntity entity;
+  entity.frame_id = "base_link";
+  entity.id = "obstacles";
+  entity.cubes.resize(cubes);
+  for (size_t i = 0; i < cubes; ++i) {
+    auto& cube = entity.cubes[i];
+    cube.pose = foxglove::messages::Pose{
+      foxglove::messages::Vector3{static_cast<double>(i), 0.0, 0.0},
+      foxglove::messages::Quaternion{0.0, 0.0, 0.0, 1.0},
+    };
+    cube.size = foxglove::messages::Vector3{1.0, 1.0, 1.0};
+    cube.color = foxglove::messages::Color{1.0, 0.0, 0.0, 1.0};
+  }
+  foxglove::messages::SceneUpdate update;
+  update.entities.push_back(std::move(entity));
+  return update;
+}
+
+/// Logs a SceneUpdate with `range(0)` cubes to a single sink. This covers the conversion of the
+/// message to its C representation in the arena, and its encoding.
+void BM_SceneUpdateChannelLog(benchmark::State& state) {
+  auto context = foxglove::Context::create();
+  DiscardingMcapWriter sink(context);
+  auto channel = unwrap(
+    foxglove::messages::SceneUpdateChannel::create("/scene", context), "SceneUpdateChannel::create"
+  );
+  const auto update = makeSceneUpdate(static_cast<size_t>(state.range(0)));
+
+  uint64_t log_time = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(channel.log(update, ++log_time));
+  }
+  state.SetItemsProcessed(state.iterations());
+  channel.close();
+}
+BENCHMARK(BM_SceneUpdateChannelLog)->ArgName("cubes")->Arg(1)->Arg(64)->Arg(1024);
+
+/// Logs a PointCloud with `range(0)` XYZ points to a single sink.
+void BM_PointCloudChannelLog(benchmark::State& state) {
+  using foxglove::messages::PackedElementField;
+
+  auto context = foxglove::Context::create();
+  DiscardingMcapWriter sink(context);
+  auto channel = unwrap(
+    foxglove::messages::PointCloudChannel::create("/points", context), "PointCloudChannel::create"
+  );
+
+  const auto points = static_cast<size_t>(state.range(0));
+  foxglove::messages::PointCloud cloud;
+  cloud.frame_id = "lidar";
+  cloud.point_stride = static_cast<uint32_t>(3 * sizeof(float));
+  cloud.fields = {
+    PackedElementField{"x", 0, PackedElementField::NumericType::FLOAT32},
+    PackedElementField{"y", 4, PackedElementField::NumericType::FLOAT32},
+    PackedElementField{"z", 8, PackedElementField::NumericType::FLOAT32},
+  };
+  cloud.data.resize(points * cloud.point_stride, std::byte{0});
+
+  uint64_t log_time = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(channel.log(cloud, ++log_time));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(cloud.data.size()));
+  channel.close();
+}
+BENCHMARK(BM_PointCloudChannelLog)->ArgName("points")->Arg(1000)->Arg(100000);
+
+}  // namespace
@@ -0,0 +1,58 @@
+#include <foxglove/json.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct Diagnostic {
+  std::string name;
+  std::string message;
+  int level = 0;
+  double value = 0;
+  std::optional<std::string> hardware_id;
+};
+
+}  // namespace
+
+template<>
+struct foxglove::JsonFields<Diagnostic> {
+  static constexpr std::string_view name = "Diagnostic";
+  static constexpr auto fields = std::make_tuple(
+    FOXGLOVE_JSON_FIELD(Diagnostic, name), FOXGLOVE_JSON_FIELD(Diagnostic, message),
+    FOXGLOVE_JSON_FIELD(Diagnostic, level), FOXGLOVE_JSON_FIELD(Diagnostic, value),
+    FOXGLOVE_JSON_FIELD(Diagnostic, hardware_id)
+  );
+};
+
+namespace {
+
+/// Encodes a batch of `range(0)` diagnostics as a JSON array into a reused buffer.
+void BM_JsonWrite(benchmark::State& state) {
+  std::vector<Diagnostic> diagnostics(static_cast<size_t>(state.range(0)));
+  for (size_t i = 0; i < diagnostics.size(); ++i) {
+    diagnostics[i].name = "motor_controller_" + std::to_string(i);
+    diagnostics[i].message = "temperature nominal";
+    diagnostics[i].level = static_cast<int>(i % 3);
+    diagnostics[i].value = 41.5 + static_cast<double>(i);
+  }
+
+  std::vector<uint8_t> buf;
+  for (auto _ : state) {
+    buf.clear();
+    foxglove::writeJson(diagnostics, buf);
+    benchmark::DoNotOptimize(buf.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(buf.size()));
+}
+BENCHMARK(BM_JsonWrite)->ArgName("messages")->Arg(1)->Arg(64);
+
+}  // namespace
@@ -0,0 +1,68 @@
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/mcap.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "common/bench_helpers.hpp"
+
+using foxglove_bench::DiscardingMcapWriter;
+using foxglove_bench::unwrap;
+
+namespace {
+
+constexpr size_t kMessageSize = 1024;
+
+/// Returns a message which compresses moderately, so that compressed and uncompressed runs are
+/// comparable: half the bytes are random, and half are zero.
+std::vector<std::byte> makeMessage() {
+  std::vector<std::byte> message(kMessageSize, std::byte{0});
+  std::mt19937 rng(42);  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+  for (size_t i = 0; i < message.size(); i += 2) {
+    message[i] = static_cast<std::byte>(rng() & 0xff);
+  }
+  return message;
+}
+
+/// Logs messages to an MCAP writer with compression `range(0)` and chunk size `range(1)`, and
+/// reports the logged throughput and the number of bytes written per message.
+void BM_McapWriterThroughput(benchmark::State& state) {
+  const auto compression = static_cast<foxglove::McapCompression>(state.range(0));
+  const auto chunk_size = static_cast<uint64_t>(state.range(1));
+  auto context = foxglove::Context::create();
+  DiscardingMcapWriter writer(context, compression, chunk_size);
+  auto channel = unwrap(
+    foxglove::RawChannel::create("/bench", "bytes", std::nullopt, context), "RawChannel::create"
+  );
+  const auto message = makeMessage();
+
+  uint64_t log_time = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(channel.log(message.data(), message.size(), ++log_time));
+  }
+  // Include the final chunk in the output size.
+  channel.close();
+  writer.close();
+
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(kMessageSize));
+  state.counters["written_bytes_per_msg"] = benchmark::Counter(
+    static_cast<double>(writer.bytesWritten()), benchmark::Counter::kAvgIterations
+  );
+}
+BENCHMARK(BM_McapWriterThroughput)
+  ->ArgNames({"compression", "chunk_size"})
+  ->ArgsProduct({
+    {static_cast<int64_t>(foxglove::McapCompression::None),
+     static_cast<int64_t>(foxglove::McapCompression::Zstd),
+     static_cast<int64_t>(foxglove::McapCompression::Lz4)},
+    {64 * 1024, 1024 * 1024, 8 * 1024 * 1024},
+  });
+
+}  // namespace
@@ -0,0 +1,36 @@
+#include <foxglove/point_cloud.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+/// Packs a lidar sweep of `range(0)` points with xyz and intensity columns into a reused
+/// PointCloudBuilder.
+void BM_PointCloudPack(benchmark::State& state) {
+  const auto count = static_cast<size_t>(state.range(0));
+  std::vector<float> x(count, 1.0F);
+  std::vector<float> y(count, 2.0F);
+  std::vector<float> z(count, 3.0F);
+  std::vector<float> intensity(count, 4.0F);
+  foxglove::PointCloudColumns columns;
+  columns.x = x.data();
+  columns.y = y.data();
+  columns.z = z.data();
+  columns.intensity = intensity.data();
+  columns.count = count;
+
+  foxglove::PointCloudBuilder builder;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(builder.pack(columns));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(builder.data().size()));
+}
+BENCHMARK(BM_PointCloudPack)->ArgName("points")->Arg(1024)->Arg(1200 * 1000);
+
+}  // namespace
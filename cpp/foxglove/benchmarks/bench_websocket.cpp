@@ -0,0 +1,200 @@
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/websocket.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <libwebsockets.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/bench_helpers.hpp"
+
+using foxglove_bench::unwrap;
+
+namespace {
+
+constexpr auto kSetupTimeout = std::chrono::seconds(10);
+
+/// A WebSocket client which subscribes to a single channel, and counts the bytes it receives.
+class SubscribingClient {
+public:
+  SubscribingClient(uint16_t port, uint64_t channel_id)
+      : subscribe_(
+          R"({"op":"subscribe","subscriptions":[{"id":1,"channelId":)" +
+          std::to_string(channel_id) + "}]}"
+        ) {
+    // NOLINTBEGIN(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+    static const struct lws_protocols kProtocols[] = {
+      {"foxglove.sdk.v1", &SubscribingClient::callback, 0, 65536, 0, nullptr, 0},
+      {nullptr, nullptr, 0, 0, 0, nullptr, 0},
+    };
+    // NOLINTEND(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+
+    struct lws_context_creation_info info = {};
+    info.port = CONTEXT_PORT_NO_LISTEN;
+    info.protocols =
+      kProtocols;  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay,hicpp-no-array-decay)
+    info.user = this;
+    context_ = lws_create_context(&info);
+    if (context_ == nullptr) {
+      std::fprintf(stderr, "lws_create_context failed\n");
+      std::abort();
+    }
+
+    struct lws_client_connect_info connect_info = {};
+    connect_info.context = context_;
+    connect_info.address = "127.0.0.1";
+    connect_info.port = port;
+    connect_info.path = "/";
+    connect_info.host = connect_info.address;
+    connect_info.origin = connect_info.address;
+    connect_info.protocol = "foxglove.sdk.v1";
+    if (lws_client_connect_via_info(&connect_info) == nullptr) {
+      std::fprintf(stderr, "lws_client_connect_via_info failed\n");
+      std::abort();
+    }
+
+    thread_ = std::thread([this] {
+      while (running_) {
+        lws_service(context_, 50);
+      }
+    });
+  }
+
+  SubscribingClient(const SubscribingClient&) = delete;
+  SubscribingClient(SubscribingClient&&) = delete;
+  SubscribingClient& operator=(const SubscribingClient&) = delete;
+  SubscribingClient& operator=(SubscribingClient&&) = delete;
+
+  ~SubscribingClient() {
+    running_ = false;
+    lws_cancel_service(context_);
+    thread_.join();
+    lws_context_destroy(context_);
+  }
+
+  [[nodiscard]] uint64_t receivedBytes() const {
+    return received_bytes_.load(std::memory_order_relaxed);
+  }
+
+private:
+  static int callback(
+    struct lws* wsi, enum lws_callback_reasons reason, void* /*user*/, void* /*in*/, size_t len
+  ) {
+    auto* self = static_cast<SubscribingClient*>(lws_context_user(lws_get_context(wsi)));
+    if (self == nullptr) {
+      return 0;
+    }
+    switch (reason) {
+      case LWS_CALLBACK_CLIENT_ESTABLISHED:
+        lws_callback_on_writable(wsi);
+        break;
+      case LWS_CALLBACK_CLIENT_WRITEABLE:
+        if (!self->subscribed_) {
+          std::vector<uint8_t> buf(LWS_PRE + self->subscribe_.size());
+          std::memcpy(buf.data() + LWS_PRE, self->subscribe_.data(), self->subscribe_.size());
+          lws_write(wsi, buf.data() + LWS_PRE, self->subscribe_.size(), LWS_WRITE_TEXT);
+          self->subscribed_ = true;
+        }
+        break;
+      case LWS_CALLBACK_CLIENT_RECEIVE:
+        self->received_bytes_.fetch_add(len, std::memory_order_relaxed);
+        break;
+      default:
+        break;
+    }
+    return 0;
+  }
+
+  std::string subscribe_;
+  bool subscribed_ = false;
+  struct lws_context* context_ = nullptr;
+  std::atomic<bool> running_{true};
+  std::atomic<uint64_t> received_bytes_{0};
+  std::thread thread_;
+};
+
+/// Logs a message to a channel which `range(0)` in-process WebSocket clients are subscribed to.
+///
+/// This measures the logging thread's cost of fanning a message out to each client's send queue;
+/// clients which fall behind drop messages rather than slowing the logger down. The
+/// `received_bytes_per_sec` counter shows how much of the logged data the clients kept up with.
+void BM_WebSocketFanOut(benchmark::State& state) {
+  const auto client_count = static_cast<size_t>(state.range(0));
+  const auto message_size = static_cast<size_t>(state.range(1));
+  auto context = foxglove::Context::create();
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t subscriptions = 0;
+
+  foxglove::WebSocketServerOptions options;
+  options.context = context;
+  options.name = "foxglove-benchmarks";
+  options.port = 0;
+  options.callbacks.onSubscribe =
+    [&](uint64_t /*channel_id*/, const foxglove::ClientMetadata& /*client_metadata*/) {
+      std::scoped_lock lock{mutex};
+      ++subscriptions;
+      cv.notify_all();
+    };
+  auto server =
+    unwrap(foxglove::WebSocketServer::create(std::move(options)), "WebSocketServer::create");
+  auto channel = unwrap(
+    foxglove::RawChannel::create("/bench", "bytes", std::nullopt, context), "RawChannel::create"
+  );
+
+  std::vector<std::unique_ptr<SubscribingClient>> clients;
+  clients.reserve(client_count);
+  for (size_t i = 0; i < client_count; ++i) {
+    clients.push_back(std::make_unique<SubscribingClient>(server.port(), channel.id()));
+  }
+  {
+    std::unique_lock lock{mutex};
+    if (!cv.wait_for(lock, kSetupTimeout, [&] {
+          return subscriptions == client_count;
+        })) {
+      state.SkipWithError("Timed out waiting for clients to subscribe");
+      return;
+    }
+  }
+
+  std::vector<std::byte> message(message_size, std::byte{0x2a});
+  uint64_t log_time = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(channel.log(message.data(), message.size(), ++log_time));
+  }
+
+  uint64_t received = 0;
+  for (const auto& client : clients) {
+    received += client->receivedBytes();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(client_count));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(client_count * message_size));
+  state.counters["received_bytes_per_sec"] =
+    benchmark::Counter(static_cast<double>(received), benchmark::Counter::kIsRate);
+
+  channel.close();
+  clients.clear();
+  server.stop();
+}
+BENCHMARK(BM_WebSocketFanOut)
+  ->ArgNames({"clients", "bytes"})
+  ->ArgsProduct({{1, 4, 16}, {256, 65536}})
+  ->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace foxglove_bench {
+
+/// Returns the value of a result, or aborts the benchmark run if it holds an error.
+///
+/// Benchmarks measure the success path only, so a failure to set one up is fatal.
+template<typename T>
+T unwrap(foxglove::FoxgloveResult<T>&& result, const char* what) {
+  if (!result.has_value()) {
+    std::fprintf(stderr, "%s failed: %s\n", what, foxglove::strerror(result.error()));
+    std::abort();
+  }
+  return std::move(*result);
+}
+
+/// An MCAP writer which discards its output, so that benchmarks measure the SDK rather than the
+/// filesystem.
+class DiscardingMcapWriter {
+public:
+  explicit DiscardingMcapWriter(
+    const foxglove::Context& context,
+    foxglove::McapCompression compression = foxglove::McapCompression::None,
+    uint64_t chunk_size = static_cast<uint64_t>(1024 * 1024)
+  )
+      : position_(std::make_unique<uint64_t>(0)) {
+    foxglove::CustomWriter custom_writer;
+    uint64_t* position = position_.get();
+    custom_writer.write_owned = [position](foxglove::McapBuffer buffer) -> int {
+      *position += buffer.size();
+      return 0;
+    };
+    custom_writer.flush = []() -> int {
+      return 0;
+    };
+    custom_writer.seek = foxglove::noSeekFn(position);
+
+    foxglove::McapWriterOptions options;
+    options.context = context;
+    options.custom_writer = std::move(custom_writer);
+    options.disable_seeking = true;
+    options.compression = compression;
+    options.chunk_size = chunk_size;
+    writer_.emplace(unwrap(foxglove::McapWriter::create(options), "McapWriter::create"));
+  }
+
+  /// The number of bytes written so far.
+  [[nodiscard]] uint64_t bytesWritten() const {
+    return *position_;
+  }
+
+  /// Finishes the file, flushing any buffered chunk.
+  void close() {
+    if (writer_.has_value()) {
+      writer_->close();
+    }
+  }
+
+private:
+  // The writer callbacks hold a pointer to the position, so it must not move with this object.
+  std::unique_ptr<uint64_t> position_;
+  std::optional<foxglove::McapWriter> writer_;
+};
+
+}  // namespace foxglove_bench
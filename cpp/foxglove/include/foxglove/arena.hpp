@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
@@ -12,18 +13,34 @@
 
 namespace foxglove {
 
-/// A fixed-size memory arena that allocates aligned arrays of POD types on the stack.
-/// The arena contains a single inline array and allocates from it.
-/// If the arena runs out of space, it attempts to allocate the required space on the heap.
-/// If this fails, it throws std::bad_alloc(). On wasm32 platforms which do not support exceptions,
-/// It calls std::terminate().
-/// The allocated arrays are "freed" by dropping the arena, destructors are not run.
+/// A memory arena that allocates aligned arrays of POD types, first from an inline buffer and then
+/// from a chain of heap blocks.
+///
+/// Once the inline buffer of a BasicArena is exhausted, allocations are bump-allocated from heap
+/// blocks which double in size up to kMaxBlockSize, so that converting a message with many
+/// elements takes a handful of heap allocations rather than one per array. Allocations larger than
+/// a block get a block of their own. If a heap allocation fails, it throws std::bad_alloc(). On
+/// wasm32 platforms which do not support exceptions, it calls std::terminate().
+///
+/// The allocated arrays are "freed" by dropping or resetting the arena, destructors are not run.
+/// Heap blocks are kept across reset() calls so a reused arena stops allocating once it is warm.
+///
+/// ArenaBase holds the allocation logic, and is what conversion functions take, so that they work
+/// with arenas of any inline capacity. Create a BasicArena, or the default-sized Arena.
 /// @cond foxglove_internal
-class Arena {
+class ArenaBase {
 public:
-  static constexpr std::size_t kSize = static_cast<std::size_t>(8) * 1024;  // 8 KB
+  /// The maximum number of heap bytes retained by reset() for reuse.
+  static constexpr std::size_t kMaxRetainedBytes = static_cast<std::size_t>(1024) * 1024;  // 1 MB
+  /// The size of the first heap block.
+  static constexpr std::size_t kMinBlockSize = static_cast<std::size_t>(8) * 1024;  // 8 KB
+  /// The size past which heap blocks stop growing.
+  static constexpr std::size_t kMaxBlockSize = static_cast<std::size_t>(256) * 1024;  // 256 KB
 
-  Arena() = default;
+  ArenaBase(const ArenaBase&) = delete;
+  ArenaBase& operator=(const ArenaBase&) = delete;
+  ArenaBase(ArenaBase&&) = delete;
+  ArenaBase& operator=(ArenaBase&&) = delete;
 
   /// Maps elements from a vector to a new array allocated from the arena.
   ///
@@ -36,7 +53,8 @@ public:
   /// On wasm32 platforms which do not support exceptions, calls std::terminate().
   template<
     typename T, typename S, typename Fn,
-    typename = std::enable_if_t<std::is_pod_v<T> && std::is_invocable_v<Fn, T&, const S&, Arena&>>>
+    typename =
+      std::enable_if_t<std::is_pod_v<T> && std::is_invocable_v<Fn, T&, const S&, ArenaBase&>>>
   // NOLINTNEXTLINE(cppcoreguidelines-missing-std-forward)
   T* map(const std::vector<S>& src, Fn&& map_fn) {
     const size_t elements = src.size();
@@ -64,7 +82,8 @@ public:
   /// On wasm32 platforms which do not support exceptions, calls std::terminate().
   template<
     typename T, typename S, typename Fn,
-    typename = std::enable_if_t<std::is_pod_v<T> && std::is_invocable_v<Fn, T&, const S&, Arena&>>>
+    typename =
+      std::enable_if_t<std::is_pod_v<T> && std::is_invocable_v<Fn, T&, const S&, ArenaBase&>>>
   T* mapOne(const S& src, Fn&& map_fn) {
     T* result = alloc<T>(1);
     std::forward<Fn>(map_fn)(*result, src, *this);
@@ -85,47 +104,75 @@ public:
 
     // Calculate space available in the buffer
     size_t space_left = available();
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-    void* buffer_ptr = &buffer_[offset_];
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    void* buffer_ptr = buffer_ + offset_;
 
     // Align the pointer within the buffer
     void* aligned_ptr = std::align(alignment, bytes_needed, buffer_ptr, space_left);
 
     // Check if we have enough space
     if (aligned_ptr == nullptr) {
-      // We don't use aligned_alloc because it fails on some platforms for larger alignments
-      size_t size_with_alignment = alignment + bytes_needed;
-      // NOLINTBEGIN(cppcoreguidelines-no-malloc,hicpp-no-malloc,cppcoreguidelines-owning-memory)
-      auto* ptr = ::malloc(size_with_alignment);
-      // NOLINTNEXTLINE(clang-analyzer-unix.Malloc)
-      aligned_ptr = std::align(alignment, bytes_needed, ptr, size_with_alignment);
-      if (aligned_ptr == nullptr) {
-#ifndef __wasm32__
-        throw std::bad_alloc();
-#else
-        std::terminate();
-#endif
-      }
-      overflow_.emplace_back(static_cast<char*>(ptr));
-      // NOLINTEND(cppcoreguidelines-no-malloc,hicpp-no-malloc,cppcoreguidelines-owning-memory)
-      return reinterpret_cast<T*>(aligned_ptr);
+      return reinterpret_cast<T*>(blockAlloc(bytes_needed, alignment));
     }
 
     // Calculate the new offset
-    offset_ = kSize - space_left + bytes_needed;
+    offset_ = capacity_ - space_left + bytes_needed;
     return reinterpret_cast<T*>(aligned_ptr);
   }
 
-  /// Returns how many bytes are currently used in the arena.
+  /// Returns how many bytes are currently used in the arena's inline buffer.
   [[nodiscard]] size_t used() const {
     return offset_;
   }
 
-  /// Returns how many bytes are available in the arena.
+  /// Returns how many bytes are available in the arena's inline buffer.
   [[nodiscard]] size_t available() const {
-    return kSize - offset_;
+    return capacity_ - offset_;
+  }
+
+  /// Returns the number of heap allocations this arena has made since it was constructed.
+  ///
+  /// For a reused arena, this stops increasing once its retained blocks cover the workload.
+  [[nodiscard]] size_t overflowAllocations() const {
+    return overflow_allocations_;
+  }
+
+  /// Returns how many heap bytes the arena currently holds, whether in use or retained.
+  [[nodiscard]] size_t overflowBytes() const {
+    size_t total = 0;
+    for (const auto& block : blocks_) {
+      total += block.size;
+    }
+    return total;
   }
 
+  /// Releases all allocations, invalidating every pointer previously returned by the arena.
+  ///
+  /// Heap blocks are kept for reuse by later allocations, up to kMaxRetainedBytes in total; any
+  /// blocks past that high-water mark are freed.
+  void reset() noexcept {
+    offset_ = 0;
+    current_ = 0;
+    size_t retained = 0;
+    auto it = blocks_.begin();
+    while (it != blocks_.end()) {
+      it->used = 0;
+      if (retained + it->size > kMaxRetainedBytes) {
+        it = blocks_.erase(it);
+      } else {
+        retained += it->size;
+        ++it;
+      }
+    }
+  }
+
+protected:
+  ArenaBase(uint8_t* buffer, size_t capacity) noexcept
+      : buffer_(buffer)
+      , capacity_(capacity) {}
+
+  ~ArenaBase() = default;
+
 private:
   struct Deleter {
     void operator()(char* ptr) const {
@@ -134,10 +181,94 @@ private:
     }
   };
 
-  std::array<uint8_t, kSize> buffer_{};
+  struct Block {
+    std::unique_ptr<char, Deleter> ptr;
+    size_t size;
+    size_t used;
+  };
+
+  /// Bump-allocates from the chain of heap blocks, moving on to the next retained block or
+  /// allocating a new one when the current block is full.
+  void* blockAlloc(size_t bytes_needed, size_t alignment) {
+    for (; current_ < blocks_.size(); ++current_) {
+      Block& block = blocks_[current_];
+      size_t space_left = block.size - block.used;
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      void* ptr = block.ptr.get() + block.used;
+      if (void* aligned_ptr = std::align(alignment, bytes_needed, ptr, space_left)) {
+        block.used = block.size - space_left + bytes_needed;
+        return aligned_ptr;
+      }
+    }
+    // We don't use aligned_alloc because it fails on some platforms for larger alignments
+    const size_t size_with_alignment = alignment + bytes_needed;
+    const size_t size = std::max(nextBlockSize(), size_with_alignment);
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc,hicpp-no-malloc,cppcoreguidelines-owning-memory)
+    auto* ptr = static_cast<char*>(::malloc(size));
+    if (ptr == nullptr) {
+#ifndef __wasm32__
+      throw std::bad_alloc();
+#else
+      std::terminate();
+#endif
+    }
+    ++overflow_allocations_;
+    blocks_.push_back({std::unique_ptr<char, Deleter>(ptr), size, 0});
+    current_ = blocks_.size() - 1;
+    Block& block = blocks_.back();
+    void* block_ptr = ptr;
+    size_t space_left = size;
+    void* aligned_ptr = std::align(alignment, bytes_needed, block_ptr, space_left);
+    assert(aligned_ptr != nullptr);
+    block.used = size - space_left + bytes_needed;
+    return aligned_ptr;
+  }
+
+  /// Returns the size of the next heap block, double the last one up to kMaxBlockSize.
+  [[nodiscard]] size_t nextBlockSize() const {
+    if (blocks_.empty()) {
+      return kMinBlockSize;
+    }
+    return std::min(std::max(blocks_.back().size * 2, kMinBlockSize), kMaxBlockSize);
+  }
+
+  uint8_t* buffer_;
+  std::size_t capacity_;
   std::size_t offset_ = 0;
-  std::vector<std::unique_ptr<char, Deleter>> overflow_;
+  std::vector<Block> blocks_;
+  /// The index of the block being allocated from.
+  std::size_t current_ = 0;
+  std::size_t overflow_allocations_ = 0;
 };
+
+/// An arena with an inline buffer of N bytes, which allocates from the heap once it is full.
+///
+/// Size N to the typical memory needed to convert a message, so that most messages are converted
+/// without touching the heap.
+template<std::size_t N>
+class BasicArena final : public ArenaBase {
+public:
+  static_assert(N > 0, "the inline buffer must not be empty");
+
+  /// The size of the inline buffer.
+  static constexpr std::size_t kSize = N;
+
+  BasicArena() noexcept
+      : ArenaBase(buffer_.data(), N) {}
+
+  BasicArena(const BasicArena&) = delete;
+  BasicArena& operator=(const BasicArena&) = delete;
+  BasicArena(BasicArena&&) = delete;
+  BasicArena& operator=(BasicArena&&) = delete;
+  ~BasicArena() = default;
+
+private:
+  alignas(std::max_align_t) std::array<uint8_t, N> buffer_{};
+};
+
+/// An arena with an 8 KB inline buffer.
+using Arena = BasicArena<static_cast<std::size_t>(8) * 1024>;
+
 /// @endcond
 
 }  // namespace foxglove
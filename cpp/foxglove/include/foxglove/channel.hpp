@@ -6,17 +6,110 @@
 #include <foxglove/messages.hpp>
 #include <foxglove/schema.hpp>
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 /// The foxglove namespace.
 namespace foxglove {
 
+/// @cond foxglove_internal
+namespace internal {
+struct ForwarderAccess;
+}
+/// @endcond
+
+/// @brief A non-owning view of a channel descriptor's metadata, in key order.
+///
+/// Iterating the view does not allocate. The keys and values are only valid for the lifetime of
+/// the ChannelDescriptor the view was obtained from.
+class ChannelMetadataView {
+public:
+  /// @brief A key-value pair of metadata.
+  using value_type = std::pair<std::string_view, std::string_view>;
+
+  /// @brief A forward iterator over the metadata entries.
+  class Iterator {
+  public:
+    /// @brief The iterator category.
+    using iterator_category = std::forward_iterator_tag;
+    /// @brief The type of the entries.
+    using value_type = ChannelMetadataView::value_type;
+    /// @brief The difference type.
+    using difference_type = std::ptrdiff_t;
+    /// @brief The pointer type.
+    using pointer = const value_type*;
+    /// @brief The reference type.
+    using reference = const value_type&;
+
+    /// @brief Construct an end iterator.
+    Iterator() = default;
+
+    /// @brief Get the current entry.
+    reference operator*() const noexcept {
+      return entry_;
+    }
+    /// @brief Access the current entry.
+    pointer operator->() const noexcept {
+      return &entry_;
+    }
+    /// @brief Advance to the next entry.
+    Iterator& operator++() noexcept;
+    /// @brief Advance to the next entry.
+    Iterator operator++(int) noexcept {
+      Iterator prev = *this;
+      ++*this;
+      return prev;
+    }
+    /// @brief Compare two iterators.
+    bool operator==(const Iterator& other) const noexcept {
+      return channel_descriptor_ == other.channel_descriptor_ &&
+             (channel_descriptor_ == nullptr || entry_.first.data() == other.entry_.first.data());
+    }
+    /// @brief Compare two iterators.
+    bool operator!=(const Iterator& other) const noexcept {
+      return !(*this == other);
+    }
+
+  private:
+    friend class ChannelMetadataView;
+    explicit Iterator(const foxglove_channel_descriptor* channel_descriptor) noexcept;
+
+    const foxglove_channel_descriptor* channel_descriptor_ = nullptr;
+    value_type entry_;
+  };
+
+  /// @cond foxglove_internal
+  explicit ChannelMetadataView(const foxglove_channel_descriptor* channel_descriptor) noexcept
+      : channel_descriptor_(channel_descriptor) {}
+  /// @endcond
+
+  /// @brief Get an iterator to the first entry.
+  [[nodiscard]] Iterator begin() const noexcept {
+    return Iterator(channel_descriptor_);
+  }
+  /// @brief Get the end iterator.
+  [[nodiscard]] Iterator end() const noexcept {
+    return {};
+  }
+  /// @brief Check whether there is no metadata.
+  [[nodiscard]] bool empty() const noexcept {
+    return begin() == end();
+  }
+
+private:
+  const foxglove_channel_descriptor* channel_descriptor_;
+};
+
 /// @brief A description of a channel. This will be constructed by the SDK and passed to an
 /// implementation of a `SinkChannelFilterFn`.
 class ChannelDescriptor {
@@ -47,8 +140,84 @@ public:
   /// @brief Get the metadata for the channel descriptor.
   [[nodiscard]] std::optional<std::map<std::string, std::string>> metadata() const noexcept;
 
+  /// @brief Get the metadata for the channel descriptor.
+  ///
+  /// Unlike metadata(), this does not copy the metadata. The keys and values are only valid for
+  /// the lifetime of the descriptor.
+  [[nodiscard]] ChannelMetadataView metadataView() const noexcept;
+
+  /// @brief Look up a single metadata value, without copying the metadata.
+  ///
+  /// The value is only valid for the lifetime of the descriptor.
+  ///
+  /// @return The value, or std::nullopt if the key is not present.
+  [[nodiscard]] std::optional<std::string_view> metadataValue(std::string_view key) const noexcept;
+
   /// @brief Get the schema of the channel descriptor.
   [[nodiscard]] std::optional<Schema> schema() const noexcept;
+
+  /// @brief Get the schema of the channel descriptor, without copying its name and encoding.
+  ///
+  /// The view is only valid for the lifetime of the descriptor.
+  [[nodiscard]] std::optional<SchemaView> schemaView() const noexcept;
+
+private:
+  friend struct internal::ForwarderAccess;
+};
+
+/// @brief Options for TopicFilter::create.
+///
+/// In globs, `*` matches any sequence of characters other than `/`, `**` matches any sequence of
+/// characters, and `?` matches any single character other than `/`. Globs match the whole topic,
+/// while regular expressions match anywhere in the topic unless anchored with `^` and `$`.
+struct TopicFilterOptions {
+  /// @brief Globs of the topics to include. If there are no include patterns, all topics are
+  /// included.
+  std::vector<std::string> include_globs;
+  /// @brief Regular expressions of the topics to include.
+  std::vector<std::string> include_regexes;
+  /// @brief Globs of the topics to exclude.
+  std::vector<std::string> exclude_globs;
+  /// @brief Regular expressions of the topics to exclude.
+  std::vector<std::string> exclude_regexes;
+};
+
+/// @brief A compiled set of topic globs and regular expressions, for use as a SinkChannelFilterFn.
+///
+/// A channel passes the filter if its topic matches any of the include patterns (or there are
+/// none), and none of the exclude patterns. All patterns are compiled into a single automaton.
+///
+/// When a TopicFilter is used as a sink's SinkChannelFilterFn, the SDK evaluates it without
+/// calling back into C++, and caches the result for each channel, so that adding a sink to a
+/// context with many channels is cheap.
+///
+/// @note TopicFilter is copyable, and copies share the compiled patterns.
+class TopicFilter final {
+public:
+  /// @brief Compile a topic filter.
+  ///
+  /// @return The filter, or FoxgloveError::ValueError if a regular expression is invalid.
+  static FoxgloveResult<TopicFilter> create(const TopicFilterOptions& options);
+
+  /// @brief Check whether a channel with the given topic passes the filter.
+  [[nodiscard]] bool matches(std::string_view topic) const noexcept;
+
+  /// @brief Check whether a channel passes the filter.
+  bool operator()(const ChannelDescriptor& channel) const noexcept {
+    return matches(channel.topic());
+  }
+
+  /// For internal use only.
+  /// @cond foxglove_internal
+  [[nodiscard]] const foxglove_topic_filter* getInner() const noexcept {
+    return impl_.get();
+  }
+  /// @endcond
+
+private:
+  explicit TopicFilter(foxglove_topic_filter* impl);
+
+  std::shared_ptr<foxglove_topic_filter> impl_;
 };
 
 /// @brief A function that can be used to filter channels.
@@ -67,11 +236,20 @@ public:
   template<
     typename F, typename = std::enable_if_t<
                   std::is_invocable_r_v<bool, F, const ChannelDescriptor&> &&
-                  !std::is_same_v<std::decay_t<F>, SinkChannelFilterFn>>>
+                  !std::is_same_v<std::decay_t<F>, SinkChannelFilterFn> &&
+                  !std::is_same_v<std::decay_t<F>, TopicFilter>>>
   // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
   SinkChannelFilterFn(F&& fn)
       : fn_(std::forward<F>(fn)) {}
 
+  /// @brief Construct from a TopicFilter.
+  ///
+  /// Sinks evaluate the filter without calling back into C++, and cache its result per channel.
+  // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+  SinkChannelFilterFn(TopicFilter filter)
+      : fn_(filter)
+      , topic_filter_(std::move(filter)) {}
+
   /// @deprecated Use a filter function taking `const ChannelDescriptor&` instead of
   /// `ChannelDescriptor&&`.
   template<
@@ -101,8 +279,108 @@ public:
     return fn_(channel);
   }
 
+  /// For internal use only.
+  /// @cond foxglove_internal
+  [[nodiscard]] const TopicFilter* topicFilter() const noexcept {
+    return topic_filter_ ? &*topic_filter_ : nullptr;
+  }
+  /// @endcond
+
 private:
   std::function<bool(const ChannelDescriptor&)> fn_;
+  std::optional<TopicFilter> topic_filter_;
+};
+
+/// @brief The output of a MessageFilterFn, which may replace the filtered message.
+///
+/// The output is only valid for the duration of the filter call.
+class MessageFilterOutput final {
+public:
+  /// @brief Log `data` instead of the filtered message, for example a cropped or downsampled copy
+  /// of it. The data is copied.
+  ///
+  /// The filter must return true for the replacement to be logged.
+  FoxgloveError replace(const std::byte* data, size_t data_len) noexcept {
+    return FoxgloveError(foxglove_message_filter_output_replace(
+      impl_, {reinterpret_cast<const uint8_t*>(data), data_len}
+    ));
+  }
+
+  /// For internal use only.
+  /// @cond foxglove_internal
+  explicit MessageFilterOutput(foxglove_message_filter_output* impl) noexcept
+      : impl_(impl) {}
+  /// @endcond
+
+private:
+  foxglove_message_filter_output* impl_;
+};
+
+/// @brief A function which runs on each message logged to a sink, before the sink receives it.
+///
+/// The function is called with the channel, the message data and its log time. Return false to
+/// drop the message, or true to log it. To log a different message instead, pass it to
+/// MessageFilterOutput::replace and return true. The message data is only valid for the duration
+/// of the call.
+///
+/// Filters are set per sink, so that sinks in the same context can log the same channels with
+/// different policies; for example, an MCAP file at full rate and a WebSocket server at a reduced
+/// rate. A sink's filter runs once for each logged message, and its result is shared by every
+/// client of the sink, so the filter may keep state across messages. It is called on the thread
+/// which logs the message, and must not block.
+using MessageFilterFn = std::function<bool(
+  const ChannelDescriptor& channel, const std::byte* data, size_t data_len, uint64_t log_time,
+  MessageFilterOutput& output
+)>;
+
+/// @brief A single message in a batch passed to RawChannel::logBatch.
+struct LogItem {
+  /// @brief The message data. May be null when `data_len == 0`.
+  const std::byte* data = nullptr;
+  /// @brief The length of the message data, in bytes.
+  size_t data_len = 0;
+  /// @brief The timestamp of the message, as nanoseconds since epoch. If omitted, the current
+  /// time is used.
+  std::optional<uint64_t> log_time;
+};
+
+/// @brief The parameters of a channel created with Context::createChannels.
+///
+/// The fields correspond to the arguments of RawChannel::create.
+struct ChannelSpec {
+  /// @brief The topic name.
+  std::string topic;
+  /// @brief The encoding of messages logged to the channel.
+  std::string message_encoding;
+  /// @brief The schema of messages logged to the channel.
+  std::optional<Schema> schema;
+  /// @brief Key/value metadata for the channel.
+  std::optional<std::map<std::string, std::string>> metadata;
+  /// @brief The number of most recent messages the channel retains for sinks that subscribe
+  /// later. Zero retains no messages.
+  size_t keep_last = 0;
+};
+
+/// @brief The demand for the messages of a channel, combined across its sinks.
+///
+/// Producers can use this to skip producing messages that nobody receives, or to produce them at
+/// no more than the highest rate any consumer receives them.
+struct ChannelDemand {
+  /// @brief The number of consumers of the channel's messages.
+  ///
+  /// Sinks which fan out to several clients, such as the WebSocket server, count each client
+  /// which is subscribed to the channel.
+  size_t consumers = 0;
+  /// @brief The highest rate at which any consumer receives messages, in messages per second.
+  ///
+  /// Unset if some consumer receives every message, such as an MCAP writer. Zero if the channel
+  /// has no consumers.
+  std::optional<double> max_rate = 0.0;
+
+  /// @brief Returns true if at least one consumer receives the channel's messages.
+  [[nodiscard]] bool subscribed() const noexcept {
+    return consumers > 0;
+  }
 };
 
 /// @brief A channel for messages logged to a topic.
@@ -121,10 +399,15 @@ public:
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
   /// @param metadata Key/value metadata for the channel.
+  /// @param keep_last The number of most recent messages the channel retains, for data that
+  /// changes rarely such as static transforms or maps. Each WebSocket client, remote access
+  /// participant or MCAP writer that subscribes later receives them immediately, and each segment
+  /// of a rotated MCAP recording begins with them. Messages logged to a specific sink are not
+  /// retained. If zero, no messages are retained.
   static FoxgloveResult<RawChannel> create(
     const std::string_view& topic, const std::string_view& message_encoding,
     std::optional<Schema> schema = std::nullopt, const Context& context = Context(),
-    std::optional<std::map<std::string, std::string>> metadata = std::nullopt
+    std::optional<std::map<std::string, std::string>> metadata = std::nullopt, size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -149,6 +432,66 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a message held in a shared buffer to the channel, without copying it.
+  ///
+  /// Sinks that queue messages, such as the remote access gateway's video tracks and MCAP writers
+  /// with async writes, may keep a reference to the buffer after this call returns. `owner` is
+  /// retained until every sink has released the buffer, and may be released on another thread. `data` must remain valid and
+  /// unmodified for as long as `owner` is alive.
+  ///
+  /// @param owner Keeps the buffer alive, for example a shared_ptr to a middleware message.
+  /// @param data The message data. May be null when `data_len == 0`.
+  /// @param data_len The length of the message data, in bytes.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The sink ID associated with the message. See log().
+  FoxgloveError logShared(
+    std::shared_ptr<const void> owner, const std::byte* data, size_t data_len,
+    std::optional<uint64_t> log_time = std::nullopt, std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a message held in a shared array to the channel, without copying it.
+  ///
+  /// Equivalent to logShared() with the array as both the owner and the data.
+  ///
+  /// @param data The message data. May be null when `data_len == 0`.
+  /// @param data_len The length of the message data, in bytes.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The sink ID associated with the message. See log().
+  FoxgloveError logOwned(
+    std::shared_ptr<const std::byte[]> data, size_t data_len,
+    std::optional<uint64_t> log_time = std::nullopt, std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept {
+    const std::byte* ptr = data.get();
+    return logShared(std::move(data), ptr, data_len, log_time, sink_id);
+  }
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// Each sink receives the whole batch in a single call, which is considerably cheaper than
+  /// calling log() once per message when logging many small messages at high rates. Items without
+  /// a log time share a single reading of the current time.
+  ///
+  /// If any item is invalid, no messages are logged and an error is returned.
+  ///
+  /// @param items The messages to log. May be null when `count == 0`.
+  /// @param count The number of items.
+  /// @param sink_id The sink ID associated with the messages. See log().
+  FoxgloveError logBatch(
+    const LogItem* items, size_t count, std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// @param items The messages to log.
+  /// @param sink_id The sink ID associated with the messages. See log().
+  FoxgloveError logBatch(
+    const std::vector<LogItem>& items, std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept {
+    return logBatch(items.data(), items.size(), sink_id);
+  }
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -157,6 +500,18 @@ public:
   /// Attempts to log on a closed channel will elicit a throttled warning message.
   void close() noexcept;
 
+  /// @brief Bind the channel to another context, so that its sinks also receive the messages.
+  ///
+  /// Each message is encoded and logged once, and dispatched to the sinks of every bound context.
+  /// The channel still belongs to the context it was created in: closing the channel removes it
+  /// from every bound context. Binding to the channel's own context, or to a context it is
+  /// already bound to, has no effect.
+  ///
+  /// @param context The context to bind the channel to.
+  /// @return FoxgloveError::Ok, or an error if the channel is closed or the context already has a
+  /// substantially identical channel.
+  FoxgloveError bindContext(const Context& context) noexcept;
+
   /// @brief Uniquely identifies a channel in the context of this program.
   ///
   /// @return The ID of the channel.
@@ -180,9 +535,13 @@ public:
     return messageEncoding();
   }
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -191,6 +550,12 @@ public:
     return hasSinks();
   }
 
+  /// @brief Get the demand for the channel's messages, combined across its sinks.
+  ///
+  /// Like hasSinks(), this reflects live subscriptions. Use it to scale production to what is
+  /// consumed, for example by producing messages at no more than ChannelDemand::max_rate.
+  [[nodiscard]] ChannelDemand demand() const noexcept;
+
   /// @brief Get the schema of the channel.
   ///
   /// @return The schema of the channel. The value is valid only for the lifetime of the channel.
@@ -201,6 +566,13 @@ public:
   /// @return The metadata, or an empty map if it was not set.
   [[nodiscard]] std::optional<std::map<std::string, std::string>> metadata() const noexcept;
 
+  /// For internal use only.
+  /// @cond foxglove_internal
+  [[nodiscard]] const foxglove_channel* getInner() const noexcept {
+    return impl_.get();
+  }
+  /// @endcond
+
   RawChannel(const RawChannel&) = delete;
   RawChannel& operator=(const RawChannel&) = delete;
   /// @brief Default move constructor.
@@ -211,6 +583,8 @@ public:
   ~RawChannel() = default;
 
 private:
+  friend class Context;
+
   explicit RawChannel(const foxglove_channel* channel);
 
   messages::ChannelUniquePtr impl_;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+struct foxglove_sim_clock;
+
+namespace foxglove {
+
+class Context;
+
+/// @brief A clock which is set by the application, for example from simulation time.
+///
+/// Use Context::setClock to make a context log messages without a log time at the time of this
+/// clock. The clock only changes when it is set. Copies of a SimClock refer to the same clock.
+///
+/// @note SimClock is fully thread-safe.
+class SimClock final {
+public:
+  /// @brief Create a clock.
+  ///
+  /// @param start_ns The initial time, in nanoseconds since the Unix epoch.
+  explicit SimClock(uint64_t start_ns = 0);
+
+  /// @brief Set the current time, in nanoseconds since the Unix epoch.
+  void setTime(uint64_t time_ns) const noexcept;
+
+  /// @brief Advance the current time.
+  void advance(std::chrono::nanoseconds duration) const noexcept;
+
+private:
+  friend class Context;
+
+  std::shared_ptr<foxglove_sim_clock> impl_;
+};
+
+}  // namespace foxglove
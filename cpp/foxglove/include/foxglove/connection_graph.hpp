@@ -5,9 +5,11 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 struct foxglove_connection_graph;
+struct foxglove_connection_graph_patch;
 
 /// The foxglove namespace.
 namespace foxglove {
@@ -50,4 +52,45 @@ private:
   std::unique_ptr<foxglove_connection_graph, void (*)(foxglove_connection_graph*)> impl_;
 };
 
+/// @brief A set of changes to a published connection graph.
+///
+/// A patch can be applied with WebSocketServer::updateConnectionGraph or
+/// RemoteAccessGateway::updateConnectionGraph. Unlike publishing a complete ConnectionGraph, only
+/// the topics and services named in the patch are compared with the published graph, so the cost
+/// of an update is proportional to the size of the change rather than the size of the graph.
+class ConnectionGraphPatch final {
+  friend class WebSocketServer;
+  friend class RemoteAccessGateway;
+
+public:
+  ConnectionGraphPatch();
+
+  /// @brief Set a published topic and its associated publisher ids.
+  ///
+  /// Overwrites any existing publisher ids for the topic.
+  FoxgloveError setPublishedTopic(
+    std::string_view topic, const std::vector<std::string>& publisher_ids
+  );
+  /// @brief Set a subscribed topic and its associated subscriber ids.
+  ///
+  /// Overwrites any existing subscriber ids for the topic.
+  FoxgloveError setSubscribedTopic(
+    std::string_view topic, const std::vector<std::string>& subscriber_ids
+  );
+  /// @brief Set an advertised service and its associated provider ids.
+  ///
+  /// Overwrites any existing provider ids for the service.
+  FoxgloveError setAdvertisedService(
+    std::string_view service, const std::vector<std::string>& provider_ids
+  );
+  /// @brief Remove a topic, along with its publishers and subscribers.
+  FoxgloveError removeTopic(std::string_view topic);
+  /// @brief Remove a service, along with its providers.
+  FoxgloveError removeService(std::string_view service);
+
+private:
+  std::unique_ptr<foxglove_connection_graph_patch, void (*)(foxglove_connection_graph_patch*)>
+    impl_;
+};
+
 }  // namespace foxglove
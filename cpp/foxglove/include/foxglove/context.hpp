@@ -1,15 +1,73 @@
 #pragma once
 
+#include <foxglove/error.hpp>
+
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 struct foxglove_context;
 
 /// The foxglove namespace.
 namespace foxglove {
 
+class RawChannel;
+class SimClock;
+struct ChannelSpec;
+
+/// @brief A limit on the bytes buffered by the sinks of a context.
+///
+/// The budget applies to the messages which WebSocket clients, remote access participants, and
+/// MCAP writers hold until they can be sent or written. It is shared by the sinks of the context,
+/// and each kind of sink can be limited to a share of it, so that, for example, a slow WebSocket
+/// client can't starve an MCAP writer. When a sink would exceed the budget or its share, it drops
+/// messages or blocks according to its own overflow policy.
+///
+/// MCAP writers also charge the chunks they are building and the output waiting to be written.
+struct MemoryBudget final {
+  /// @brief The total number of bytes in the budget.
+  size_t bytes = 0;
+  /// @brief The fraction of the budget, between 0 and 1, for the backlogs of WebSocket clients.
+  /// If unset, they may use the whole budget.
+  std::optional<double> websocket_share;
+  /// @brief The fraction of the budget, between 0 and 1, for the backlogs of remote access
+  /// participants. If unset, they may use the whole budget.
+  std::optional<double> remote_access_share;
+  /// @brief The fraction of the budget, between 0 and 1, for MCAP writers. If unset, they may
+  /// use the whole budget.
+  std::optional<double> mcap_share;
+};
+
+/// @brief The bytes buffered by one kind of sink. See MemoryUsage.
+struct MemoryPoolUsage final {
+  /// @brief The number of bytes currently buffered.
+  size_t bytes = 0;
+  /// @brief The highest number of bytes buffered at once.
+  size_t peak_bytes = 0;
+  /// @brief The number of bytes the sinks may use, if the context has a budget.
+  std::optional<size_t> limit;
+  /// @brief The number of messages dropped because the budget or the share was exhausted.
+  uint64_t dropped = 0;
+};
+
+/// @brief The bytes buffered by the sinks of a context. See Context::memoryUsage.
+struct MemoryUsage final {
+  /// @brief The number of bytes currently buffered.
+  size_t bytes = 0;
+  /// @brief The highest number of bytes buffered at once.
+  size_t peak_bytes = 0;
+  /// @brief The budget, if the context has one.
+  std::optional<size_t> limit;
+  /// @brief The usage of WebSocket server clients.
+  MemoryPoolUsage websocket;
+  /// @brief The usage of remote access participants.
+  MemoryPoolUsage remote_access;
+  /// @brief The usage of MCAP writers.
+  MemoryPoolUsage mcap;
+};
+
 /// @brief A context is the binding between channels and sinks.
 ///
 /// Each channel and each sink belongs to exactly one context. Sinks receive advertisements about
@@ -32,6 +90,51 @@ public:
   /// Create a new context
   static Context create();
 
+  /// @brief Create a batch of channels in this context.
+  ///
+  /// The channels are registered atomically, and each sink is notified of them together. For
+  /// example, a WebSocket server sends each client a single advertisement for the batch, rather
+  /// than one per channel. Prefer this to calling RawChannel::create in a loop when creating many
+  /// channels at once, such as at startup.
+  ///
+  /// If any spec is invalid, no channels are created.
+  ///
+  /// @note Include `foxglove/channel.hpp` to use this method.
+  ///
+  /// @param specs The parameters of each channel.
+  /// @return The created channels, in the same order as `specs`.
+  [[nodiscard]] FoxgloveResult<std::vector<RawChannel>> createChannels(
+    const std::vector<ChannelSpec>& specs
+  ) const;
+
+  /// @brief Set the clock which provides the log time of messages logged without one.
+  ///
+  /// The context keeps the clock alive until it is replaced or reset.
+  ///
+  /// @note Include `foxglove/clock.hpp` to use this method.
+  ///
+  /// @param clock The clock to use.
+  void setClock(const SimClock& clock) const;
+
+  /// @brief Restore the default clock, which never goes backwards and is anchored to the system
+  /// wall clock.
+  void resetClock() const noexcept;
+
+  /// @brief The current time of this context's clock, in nanoseconds since the Unix epoch.
+  ///
+  /// This is the log time given to a message logged without one.
+  [[nodiscard]] uint64_t now() const noexcept;
+
+  /// @brief Set the budget for the bytes buffered by the sinks of this context.
+  ///
+  /// Sinks apply the budget to the messages they buffer from then on.
+  ///
+  /// @param budget The budget, or std::nullopt to remove it.
+  void setMemoryBudget(const std::optional<MemoryBudget>& budget) const noexcept;
+
+  /// @brief The bytes buffered by the sinks of this context, and the budget they're held to.
+  [[nodiscard]] MemoryUsage memoryUsage() const noexcept;
+
   /// For internal use only.
   /// @cond foxglove_internal
   [[nodiscard]] const foxglove_context* getInner() const noexcept {
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <foxglove/error.hpp>
+
 #include <functional>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -37,9 +40,25 @@ public:
 
   /// @brief Sends an error message to the client.
   ///
+  /// Any chunks appended with `append` are discarded.
+  ///
   /// @param message Error message.
   void respondError(std::string_view message) && noexcept;
 
+  /// @brief Appends a chunk of asset data, without completing the request.
+  ///
+  /// This allows an asset to be read piece by piece, for example from a large file. The protocol
+  /// delivers each asset to the client in a single message, so the chunks are assembled by the
+  /// SDK and sent by `finish`. A call to `respondOk` after appending chunks sends its data after
+  /// them.
+  ///
+  /// @param data Chunk data pointer.
+  /// @param size Chunk data length.
+  void append(const std::byte* data, size_t size) & noexcept;
+
+  /// @brief Sends the chunks appended with `append` to the client.
+  void finish() && noexcept;
+
   /// @brief Default destructor.
   ~FetchAssetResponder() = default;
   /// @brief Default move constructor.
@@ -81,4 +100,35 @@ private:
 using FetchAssetHandler =
   std::function<void(std::string_view uri, FetchAssetResponder&& responder)>;
 
+/// @brief A directory served by a handler created with fileAssetHandler.
+struct FileAssetRoot {
+  /// @brief The prefix of the URIs served from the directory, such as `package://my_robot/`.
+  ///
+  /// The prefix should usually end with a `/`, so that `package://robot` does not also match
+  /// `package://robot_description`.
+  std::string uri_prefix;
+  /// @brief The directory which the rest of the URI is resolved against.
+  std::string directory;
+};
+
+/// @brief Creates a fetch asset handler which serves files from a set of allowed directories.
+///
+/// A URI is resolved by replacing the longest matching FileAssetRoot::uri_prefix with its
+/// FileAssetRoot::directory. Requests for URIs which match no root, or which resolve to a path
+/// outside of the root's directory, for example via `..` components or symbolic links, fail.
+///
+/// Files are resolved and read on a background thread. Files larger than 256 MiB are not served.
+/// Concurrent requests for the same unchanged file share a single copy of its contents.
+///
+/// @code{.cpp}
+/// auto handler = foxglove::fileAssetHandler({
+///   {"package://my_robot/", "/opt/ros/humble/share/my_robot"},
+/// });
+/// options.fetch_asset = std::move(*handler);
+/// @endcode
+///
+/// @param roots The directories to serve.
+/// @return The handler, which may be copied and shared between servers.
+FoxgloveResult<FetchAssetHandler> fileAssetHandler(const std::vector<FileAssetRoot>& roots);
+
 }  // namespace foxglove
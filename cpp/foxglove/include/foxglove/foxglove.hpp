@@ -1,7 +1,13 @@
 #pragma once
 
+#include <foxglove/error.hpp>
+
+#include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace foxglove {
 
@@ -43,6 +49,39 @@ enum class LogLevel : uint8_t {
 /// @note This is thread-safe, but only the first call to this function will have an effect.
 void setLogLevel(LogLevel level);
 
+/// @brief Options for the internal runtime which the SDK creates for its servers and publishers.
+///
+/// The runtime runs the network I/O of WebSocket servers and remote access gateways, and the
+/// SystemInfoPublisher and SdkStatsPublisher. Use these options to keep it off cores which are
+/// reserved for other work, such as real-time control loops.
+struct RuntimeOptions {
+  /// @brief Number of worker threads. By default, there is one per CPU.
+  std::optional<size_t> worker_threads;
+  /// @brief Name of the runtime's threads.
+  std::optional<std::string> thread_name;
+  /// @brief Indices of the CPUs to run the runtime's threads on. If empty, threads may run on
+  /// any CPU.
+  ///
+  /// Also applies to the threads of servers with WebSocketServerOptions::writer_threads. Only
+  /// supported on Linux.
+  std::vector<size_t> cpu_affinity;
+  /// @brief Nice value of the runtime's threads, from -20 (highest priority) to 19 (lowest).
+  ///
+  /// Also applies to the threads of servers with WebSocketServerOptions::writer_threads.
+  /// Raising the priority requires privileges. Only supported on Linux.
+  std::optional<int32_t> nice;
+};
+
+/// @brief Set the options of the SDK's internal runtime.
+///
+/// This must be called before starting anything which creates the runtime, such as a WebSocket
+/// server.
+///
+/// @param options The runtime options.
+/// @return FoxgloveError::ConfigurationError if the runtime was already created, or
+/// FoxgloveError::ValueError if the options are invalid.
+FoxgloveError setRuntimeOptions(const RuntimeOptions& options);
+
 namespace internal {
 
 /// @cond foxglove_internal
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/messages.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace foxglove {
+
+/// @brief The pixel format of an ImageFrame.
+enum class PixelFormat : uint8_t {
+  /// @brief 8-bit red, green and blue channels.
+  Rgb8,
+  /// @brief 8-bit blue, green and red channels, as produced by OpenCV.
+  Bgr8,
+  /// @brief Packed 4:2:2 YUV, with bytes in the order Y0, U, Y1, V. The width must be even.
+  Yuyv,
+  /// @brief Planar 4:2:0 YUV, with a Y plane followed by an interleaved UV plane. The width and
+  /// height must be even.
+  Nv12,
+};
+
+/// @brief A borrowed image, as captured from a camera.
+///
+/// YUV data is interpreted as BT.601 with limited range.
+struct ImageFrame {
+  /// @brief The pixel data.
+  const std::byte* data = nullptr;
+  /// @brief The length of the pixel data, in bytes.
+  size_t data_len = 0;
+  /// @brief The width of the image, in pixels.
+  uint32_t width = 0;
+  /// @brief The height of the image, in pixels.
+  uint32_t height = 0;
+  /// @brief The length of each row, in bytes. For NV12, this is the length of each row of both
+  /// planes. If zero, rows are assumed to be tightly packed.
+  uint32_t step = 0;
+  /// @brief The pixel format.
+  PixelFormat format = PixelFormat::Rgb8;
+};
+
+/// @brief Converts camera frames to `rgb8` RawImages, optionally downscaling them.
+///
+/// BGR swizzling and the row accumulation for downscaling use SSSE3, SSE2 or NEON where the
+/// target supports them. Downscaling averages each 2x2 or 4x4 block of pixels; any remaining rows
+/// and columns at the bottom and right edges are dropped.
+///
+/// The converted image is written into a buffer owned by the builder, which keeps its capacity
+/// between calls to convert(). Log the result without copying it with view() and
+/// messages::RawImageChannel::log.
+///
+/// @note RawImageBuilder is not thread-safe.
+class RawImageBuilder final {
+public:
+  /// @brief Convert a frame, replacing any previously converted image.
+  ///
+  /// Returns FoxgloveError::ValueError if the frame's data is too short for its dimensions, if
+  /// its dimensions are invalid for its format, or if `downscale` is not 1, 2 or 4. On error, the
+  /// previously converted image is left unchanged.
+  ///
+  /// @param frame The frame to convert.
+  /// @param downscale The factor to reduce the width and height by: 1, 2 or 4.
+  FoxgloveError convert(const ImageFrame& frame, uint32_t downscale = 1);
+
+  /// @brief Get a view of the converted image, for logging without copying.
+  ///
+  /// Set the frame ID and timestamp on the returned view before logging it. The view refers to
+  /// the builder's buffer, and is valid until the next call to convert(), or until the builder is
+  /// destroyed.
+  [[nodiscard]] messages::RawImageView view() const;
+
+  /// @brief Get the converted `rgb8` pixel data, with tightly packed rows.
+  [[nodiscard]] const std::vector<std::byte>& data() const noexcept {
+    return data_;
+  }
+
+  /// @brief Get the width of the converted image, in pixels.
+  [[nodiscard]] uint32_t width() const noexcept {
+    return width_;
+  }
+
+  /// @brief Get the height of the converted image, in pixels.
+  [[nodiscard]] uint32_t height() const noexcept {
+    return height_;
+  }
+
+private:
+  std::vector<std::byte> data_;
+  std::vector<std::byte> rgb_;
+  std::vector<uint16_t> row_sums_;
+  uint32_t width_ = 0;
+  uint32_t height_ = 0;
+};
+
+/// @brief Options for an ImagePublisher.
+struct ImagePublisherOptions {
+  /// @brief The context which associates logs to a sink. If omitted, the default context is used.
+  Context context;
+  /// @brief The topic for full-resolution images.
+  std::string topic;
+  /// @brief The topic for downscaled preview images. If empty, defaults to `topic` followed by
+  /// `/preview`.
+  std::string preview_topic;
+  /// @brief The factor to reduce the width and height of preview images by: 2 or 4.
+  uint32_t preview_downscale = 4;
+  /// @brief The frame ID of published images.
+  std::string frame_id;
+};
+
+/// @brief Publishes camera frames as `rgb8` RawImages at full and preview resolution.
+///
+/// Frames are converted and logged on a worker thread, so publish() only copies the frame. Each
+/// resolution is only converted while a sink is subscribed to its topic, so a viewer that only
+/// subscribes to the preview doesn't pay for full-resolution conversion, and nothing is converted
+/// while there are no subscribers at all.
+///
+/// If frames are published faster than the worker converts them, only the most recent pending
+/// frame is kept.
+class ImagePublisher final {
+public:
+  /// @brief Create a publisher, and start its worker thread.
+  ///
+  /// @param options The options for the publisher.
+  static FoxgloveResult<ImagePublisher> create(ImagePublisherOptions options);
+
+  /// @brief Queue a frame to be converted and logged.
+  ///
+  /// Returns FoxgloveError::ValueError if the frame is invalid, as for RawImageBuilder::convert.
+  /// Frames are validated even if nothing is subscribed.
+  ///
+  /// @param frame The frame to publish. The data is copied before this returns.
+  /// @param log_time The timestamp of the frame, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  FoxgloveError publish(const ImageFrame& frame, std::optional<uint64_t> log_time = std::nullopt);
+
+  /// @brief Get the ID of the full-resolution channel.
+  [[nodiscard]] uint64_t id() const noexcept;
+
+  /// @brief Get the ID of the preview channel.
+  [[nodiscard]] uint64_t previewId() const noexcept;
+
+  /// @brief Stops the worker thread, discarding any pending frame.
+  ~ImagePublisher();
+  ImagePublisher(ImagePublisher&& other) noexcept;
+  ImagePublisher& operator=(ImagePublisher&& other) noexcept;
+  ImagePublisher(const ImagePublisher&) = delete;
+  ImagePublisher& operator=(const ImagePublisher&) = delete;
+
+private:
+  struct Impl;
+
+  explicit ImagePublisher(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace foxglove
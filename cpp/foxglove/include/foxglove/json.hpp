@@ -0,0 +1,556 @@
+#pragma once
+
+#include <foxglove/error.hpp>
+#include <foxglove/schema.hpp>
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief Describes the member `member` of `Type` as a JSON field with the same name, for use in a
+/// foxglove::JsonFields specialization.
+#define FOXGLOVE_JSON_FIELD(Type, member) ::foxglove::jsonField(#member, &Type::member)
+
+namespace foxglove {
+
+/// @brief Writes JSON text directly into a byte buffer, without building a document in memory.
+///
+/// The writer inserts commas between values, and escapes strings. It does not check that calls
+/// are balanced, or that every value in an object is preceded by a key.
+class JsonWriter final {
+public:
+  /// @brief Create a writer which appends to `buf`.
+  explicit JsonWriter(std::vector<uint8_t>& buf) noexcept
+      : buf_(buf) {}
+
+  /// @brief Begin an object.
+  void beginObject() {
+    separate();
+    buf_.push_back('{');
+    need_comma_ = false;
+  }
+
+  /// @brief End an object.
+  void endObject() {
+    buf_.push_back('}');
+    need_comma_ = true;
+  }
+
+  /// @brief Begin an array.
+  void beginArray() {
+    separate();
+    buf_.push_back('[');
+    need_comma_ = false;
+  }
+
+  /// @brief End an array.
+  void endArray() {
+    buf_.push_back(']');
+    need_comma_ = true;
+  }
+
+  /// @brief Write an object key. The next value is written without a leading comma.
+  void key(std::string_view key) {
+    string(key);
+    buf_.push_back(':');
+    need_comma_ = false;
+  }
+
+  /// @brief Write a null value.
+  void null() {
+    separate();
+    append("null");
+  }
+
+  /// @brief Write a boolean value.
+  void boolean(bool value) {
+    separate();
+    append(value ? "true" : "false");
+  }
+
+  /// @brief Write an integer value.
+  template<typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+  void integer(T value) {
+    separate();
+    char chars[24];
+    auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    append(std::string_view(chars, static_cast<size_t>(result.ptr - chars)));
+  }
+
+  /// @brief Write a floating point value. NaN and infinite values are written as null.
+  template<typename T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+  void number(T value) {
+    separate();
+    if (!std::isfinite(value)) {
+      append("null");
+      return;
+    }
+    char chars[64];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    // Shortest representation which round-trips.
+    auto result = std::to_chars(std::begin(chars), std::end(chars), value);
+    append(std::string_view(chars, static_cast<size_t>(result.ptr - chars)));
+#else
+    int len = std::snprintf(
+      chars, sizeof(chars), "%.*g", std::numeric_limits<T>::max_digits10, static_cast<double>(value)
+    );
+    append(std::string_view(chars, static_cast<size_t>(len)));
+#endif
+  }
+
+  /// @brief Write a string value, escaping it as necessary.
+  void string(std::string_view value) {
+    separate();
+    buf_.push_back('"');
+    // Copy runs of characters which don't need escaping in one go.
+    size_t run_start = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+      const auto c = static_cast<unsigned char>(value[i]);
+      if (c >= 0x20 && c != '"' && c != '\\') {
+        continue;
+      }
+      append(value.substr(run_start, i - run_start));
+      escape(c);
+      run_start = i + 1;
+    }
+    append(value.substr(run_start));
+    buf_.push_back('"');
+  }
+
+private:
+  void separate() {
+    if (need_comma_) {
+      buf_.push_back(',');
+    }
+    need_comma_ = true;
+  }
+
+  void append(std::string_view text) {
+    buf_.insert(buf_.end(), text.begin(), text.end());
+  }
+
+  void escape(unsigned char c) {
+    switch (c) {
+      case '"':
+        append("\\\"");
+        break;
+      case '\\':
+        append("\\\\");
+        break;
+      case '\n':
+        append("\\n");
+        break;
+      case '\r':
+        append("\\r");
+        break;
+      case '\t':
+        append("\\t");
+        break;
+      default: {
+        constexpr std::string_view kHex = "0123456789abcdef";
+        const std::array<char, 6> chars = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xf]};
+        append(std::string_view(chars.data(), chars.size()));
+        break;
+      }
+    }
+  }
+
+  std::vector<uint8_t>& buf_;
+  bool need_comma_ = false;
+};
+
+/// @brief Accumulates the text of a JSON schema. Used in constant expressions to generate schemas
+/// at compile time.
+///
+/// Without an output buffer, the writer only counts the length of the schema.
+class JsonSchemaWriter final {
+public:
+  /// @brief Create a writer which writes to `out`, or only counts if `out` is null.
+  constexpr explicit JsonSchemaWriter(char* out = nullptr) noexcept
+      : out_(out) {}
+
+  /// @brief Append text to the schema verbatim.
+  constexpr void raw(std::string_view text) noexcept {
+    for (char c : text) {
+      if (out_ != nullptr) {
+        out_[len_] = c;
+      }
+      ++len_;
+    }
+  }
+
+  /// @brief Get the length of the schema written so far.
+  [[nodiscard]] constexpr size_t size() const noexcept {
+    return len_;
+  }
+
+private:
+  char* out_;
+  size_t len_ = 0;
+};
+
+/// @brief Describes how values of type `T` are written as JSON.
+///
+/// A specialization provides:
+///
+/// - `static void write(JsonWriter& writer, const T& value)`, which writes the value.
+/// - `static constexpr void schema(JsonSchemaWriter& writer)`, which writes the JSON schema of
+///   the type.
+///
+/// Booleans, numbers, strings, `std::vector`, `std::array` and `std::optional` are supported out
+/// of the box, as are structs described by JsonFields and enums described by JsonEnumValues.
+template<typename T, typename Enable = void>
+struct JsonTraits;
+
+/// @brief A named field of a struct, for use in a JsonFields specialization.
+template<typename T, typename Member>
+struct JsonField {
+  /// @brief The JSON key of the field. Written verbatim in the schema, so must not require
+  /// escaping.
+  std::string_view name;
+  /// @brief The member holding the field's value.
+  Member T::*member;
+};
+
+/// @brief Create a JsonField. See also FOXGLOVE_JSON_FIELD.
+template<typename T, typename Member>
+constexpr JsonField<T, Member> jsonField(std::string_view name, Member T::*member) noexcept {
+  return {name, member};
+}
+
+/// @brief Describes the fields of a struct which is written as a JSON object.
+///
+/// A specialization provides:
+///
+/// - `static constexpr std::string_view name`, the name of the type, which is used as the schema
+///   name by JsonMessageTraits.
+/// - `static constexpr auto fields`, a tuple of JsonField, in the order they are written.
+///
+/// For example:
+///
+/// @code{.cpp}
+/// template<>
+/// struct foxglove::JsonFields<Pose> {
+///   static constexpr std::string_view name = "Pose";
+///   static constexpr auto fields =
+///     std::make_tuple(FOXGLOVE_JSON_FIELD(Pose, x), FOXGLOVE_JSON_FIELD(Pose, y));
+/// };
+/// @endcode
+///
+/// Fields of type `std::optional` are omitted from the object when empty, and are not required
+/// by the schema.
+template<typename T>
+struct JsonFields;
+
+/// @brief A named value of an enum, for use in a JsonEnumValues specialization.
+template<typename E>
+struct JsonEnumValue {
+  /// @brief The enum value.
+  E value;
+  /// @brief The string it is written as. Written verbatim in the schema, so must not require
+  /// escaping.
+  std::string_view name;
+};
+
+/// @brief Describes the values of an enum which is written as a JSON string.
+///
+/// A specialization provides `static constexpr std::array<JsonEnumValue<E>, N> values`. Values
+/// which are not listed are written as null.
+template<typename E>
+struct JsonEnumValues;
+
+/// @cond foxglove_internal
+namespace detail {
+
+template<typename T>
+struct IsOptional : std::false_type {};
+
+template<typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+template<typename T, typename = void>
+struct HasJsonFields : std::false_type {};
+
+template<typename T>
+struct HasJsonFields<T, std::void_t<decltype(JsonFields<T>::fields)>> : std::true_type {};
+
+template<typename T, typename = void>
+struct HasJsonEnumValues : std::false_type {};
+
+template<typename T>
+struct HasJsonEnumValues<T, std::void_t<decltype(JsonEnumValues<T>::values)>> : std::true_type {
+};
+
+template<typename T>
+struct IsJsonString
+    : std::bool_constant<
+        std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+        std::is_same_v<T, const char*>> {};
+
+template<typename T, typename = void>
+struct IsJsonSequence : std::false_type {};
+
+template<typename T>
+struct IsJsonSequence<std::vector<T>> : std::true_type {};
+
+template<typename T, size_t N>
+struct IsJsonSequence<std::array<T, N>> : std::true_type {};
+
+}  // namespace detail
+/// @endcond
+
+/// @brief JsonTraits for booleans.
+template<>
+struct JsonTraits<bool> {
+  static void write(JsonWriter& writer, bool value) {
+    writer.boolean(value);
+  }
+  static constexpr void schema(JsonSchemaWriter& writer) {
+    writer.raw(R"({"type":"boolean"})");
+  }
+};
+
+/// @brief JsonTraits for integers.
+template<typename T>
+struct JsonTraits<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+  static void write(JsonWriter& writer, T value) {
+    writer.integer(value);
+  }
+  static constexpr void schema(JsonSchemaWriter& writer) {
+    writer.raw(R"({"type":"integer"})");
+  }
+};
+
+/// @brief JsonTraits for floating point numbers.
+template<typename T>
+struct JsonTraits<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+  static void write(JsonWriter& writer, T value) {
+    writer.number(value);
+  }
+  static constexpr void schema(JsonSchemaWriter& writer) {
+    writer.raw(R"({"type":"number"})");
+  }
+};
+
+/// @brief JsonTraits for strings.
+template<typename T>
+struct JsonTraits<T, std::enable_if_t<detail::IsJsonString<T>::value>> {
+  static void write(JsonWriter& writer, std::string_view value) {
+    writer.string(value);
+  }
+  static constexpr void schema(JsonSchemaWriter& writer) {
+    writer.raw(R"({"type":"string"})");
+  }
+};
+
+/// @brief JsonTraits for `std::vector` and `std::array`.
+template<typename T>
+struct JsonTraits<T, std::enable_if_t<detail::IsJsonSequence<T>::value>> {
+  using Element = typename T::value_type;
+
+  static void write(JsonWriter& writer, const T& values) {
+    writer.beginArray();
+    for (const auto& value : values) {
+      JsonTraits<Element>::write(writer, value);
+    }
+    writer.endArray();
+  }
+  static constexpr void schema(JsonSchemaWriter& writer) {
+    writer.raw(R"({"type":"array","items":)");
+    JsonTraits<Element>::schema(writer);
+    writer.raw("}");
+  }
+};
+
+/// @brief JsonTraits for `std::optional`, which writes null when empty.
+template<typename T>
+struct JsonTraits<std::optional<T>> {
+  static void write(JsonWriter& writer, const std::optional<T>& value) {
+    if (value.has_value()) {
+      JsonTraits<T>::write(writer, *value);
+    } else {
+      writer.null();
+    }
+  }
+  static constexpr void schema(JsonSchemaWriter& writer) {
+    JsonTraits<T>::schema(writer);
+  }
+};
+
+/// @brief JsonTraits for enums described by JsonEnumValues.
+template<typename E>
+struct JsonTraits<E, std::enable_if_t<detail::HasJsonEnumValues<E>::value>> {
+  static void write(JsonWriter& writer, E value) {
+    for (const auto& entry : JsonEnumValues<E>::values) {
+      if (entry.value == value) {
+        writer.string(entry.name);
+        return;
+      }
+    }
+    writer.null();
+  }
+  static constexpr void schema(JsonSchemaWriter& writer) {
+    writer.raw(R"({"type":"string","enum":[)");
+    bool first = true;
+    for (const auto& entry : JsonEnumValues<E>::values) {
+      writer.raw(first ? "\"" : ",\"");
+      writer.raw(entry.name);
+      writer.raw("\"");
+      first = false;
+    }
+    writer.raw("]}");
+  }
+};
+
+/// @brief JsonTraits for structs described by JsonFields.
+template<typename T>
+struct JsonTraits<T, std::enable_if_t<detail::HasJsonFields<T>::value>> {
+  static void write(JsonWriter& writer, const T& value) {
+    writer.beginObject();
+    std::apply(
+      [&](const auto&... fields) {
+        (writeField(writer, value, fields), ...);
+      },
+      JsonFields<T>::fields
+    );
+    writer.endObject();
+  }
+
+  static constexpr void schema(JsonSchemaWriter& writer) {
+    writer.raw(R"({"type":"object","properties":{)");
+    bool first = true;
+    std::apply(
+      [&](const auto&... fields) {
+        (fieldSchema(writer, fields, first), ...);
+      },
+      JsonFields<T>::fields
+    );
+    writer.raw(R"(},"required":[)");
+    first = true;
+    std::apply(
+      [&](const auto&... fields) {
+        (requiredField(writer, fields, first), ...);
+      },
+      JsonFields<T>::fields
+    );
+    writer.raw("]}");
+  }
+
+private:
+  template<typename Member>
+  static void writeField(JsonWriter& writer, const T& value, const JsonField<T, Member>& field) {
+    const Member& member = value.*(field.member);
+    if constexpr (detail::IsOptional<Member>::value) {
+      if (!member.has_value()) {
+        return;
+      }
+    }
+    writer.key(field.name);
+    JsonTraits<Member>::write(writer, member);
+  }
+
+  template<typename Member>
+  static constexpr void fieldSchema(
+    JsonSchemaWriter& writer, const JsonField<T, Member>& field, bool& first
+  ) {
+    writer.raw(first ? "\"" : ",\"");
+    writer.raw(field.name);
+    writer.raw("\":");
+    JsonTraits<Member>::schema(writer);
+    first = false;
+  }
+
+  template<typename Member>
+  static constexpr void requiredField(
+    JsonSchemaWriter& writer, const JsonField<T, Member>& field, bool& first
+  ) {
+    if (!detail::IsOptional<Member>::value) {
+      writer.raw(first ? "\"" : ",\"");
+      writer.raw(field.name);
+      writer.raw("\"");
+      first = false;
+    }
+  }
+};
+
+/// @cond foxglove_internal
+namespace detail {
+
+template<typename T>
+constexpr size_t jsonSchemaLength() {
+  JsonSchemaWriter writer;
+  JsonTraits<T>::schema(writer);
+  return writer.size();
+}
+
+template<typename T>
+constexpr std::array<char, jsonSchemaLength<T>()> jsonSchemaChars() {
+  std::array<char, jsonSchemaLength<T>()> chars{};
+  JsonSchemaWriter writer(chars.data());
+  JsonTraits<T>::schema(writer);
+  return chars;
+}
+
+template<typename T>
+inline constexpr auto kJsonSchemaChars = jsonSchemaChars<T>();
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Get the JSON schema of `T`, which is generated at compile time.
+template<typename T>
+constexpr std::string_view jsonSchema() noexcept {
+  return {detail::kJsonSchemaChars<T>.data(), detail::kJsonSchemaChars<T>.size()};
+}
+
+/// @brief Append the JSON encoding of `value` to `buf`.
+template<typename T>
+void writeJson(const T& value, std::vector<uint8_t>& buf) {
+  JsonWriter writer(buf);
+  JsonTraits<T>::write(writer, value);
+}
+
+/// @brief MessageTraits which log a struct described by JsonFields as JSON, with a JSON schema
+/// generated at compile time.
+///
+/// Use it as the Traits argument of TypedChannel, or inherit from it to specialize MessageTraits:
+///
+/// @code{.cpp}
+/// template<>
+/// struct foxglove::MessageTraits<Pose> : foxglove::JsonMessageTraits<Pose> {};
+/// @endcode
+template<typename T>
+struct JsonMessageTraits {
+  /// @brief The message encoding.
+  static constexpr std::string_view message_encoding = "json";
+
+  /// @brief The schema of the message type.
+  static std::optional<Schema> schema() {
+    constexpr std::string_view data = jsonSchema<T>();
+    Schema schema;
+    schema.name = std::string(JsonFields<T>::name);
+    schema.encoding = "jsonschema";
+    schema.data = reinterpret_cast<const std::byte*>(data.data());
+    schema.data_len = data.size();
+    return schema;
+  }
+
+  /// @brief Append the JSON encoding of `msg` to `buf`.
+  static FoxgloveError encode(const T& msg, std::vector<uint8_t>& buf) {
+    writeJson(msg, buf);
+    return FoxgloveError::Ok;
+  }
+};
+
+}  // namespace foxglove
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/error.hpp>
+#include <foxglove/expected.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace foxglove {
+
+/// @brief A stage of a message's delivery by a sink.
+enum class LatencyStage : uint8_t {
+  /// From the call to log to the message being queued by the sink.
+  Serialize = 0,
+  /// Time spent waiting in the sink's queue.
+  Queue = 1,
+  /// From the message being taken from the queue to it being sent or written.
+  Io = 2,
+  /// From the call to log to the message being sent or written.
+  Total = 3,
+};
+
+/// @brief Latency percentiles for one stage of the messages logged to a channel and delivered by
+/// a sink.
+struct LatencyStats {
+  /// @brief The sink which delivered the messages.
+  uint64_t sink_id{};
+  /// @brief The channel the messages were logged to.
+  uint64_t channel_id{};
+  /// @brief The stage of delivery.
+  LatencyStage stage{};
+  /// @brief The number of sampled messages.
+  uint64_t count{};
+  /// @brief The median latency.
+  std::chrono::nanoseconds p50{};
+  /// @brief The 99th percentile latency.
+  std::chrono::nanoseconds p99{};
+  /// @brief The 99.9th percentile latency.
+  std::chrono::nanoseconds p999{};
+  /// @brief The largest latency.
+  std::chrono::nanoseconds max{};
+};
+
+/// @brief Options for LatencyTracer::install.
+struct LatencyTracerOptions final {
+  /// @brief Sample one in every `sample_every` logged messages.
+  uint32_t sample_every = 100;
+  /// @brief The number of recent samples retained for writeChromeTrace.
+  size_t trace_capacity = 10000;
+};
+
+// Keep this comment in sync with rust/foxglove/src/latency.rs
+
+/// @brief Traces the latency between logging a message and its delivery by each sink.
+///
+/// While installed, the tracer samples one in every N messages logged with RawChannel::log or a
+/// typed channel. For each sampled message, the WebSocket server and MCAP writer sinks record the
+/// time spent in each LatencyStage:
+///
+/// - Serialize: from the call to log to the message being queued by the sink. For a WebSocket
+///   client, this covers encoding the message frame.
+/// - Queue: time spent waiting in the sink's queue. For a WebSocket client, this is the client's
+///   backlog. For an MCAP writer, this is the queue of the background writer thread, if there is
+///   one, or otherwise the time spent waiting for the writer.
+/// - Io: from the message being taken from the queue to it being sent. For a WebSocket client,
+///   this covers compression and the write to the socket. For an MCAP writer, this covers writing
+///   the message to the current chunk, including the chunk's compression once it is full.
+///
+/// Only one tracer is installed at a time, for the whole process. Destroying the tracer
+/// uninstalls it.
+///
+/// @note LatencyTracer is movable but not copyable, and is thread-safe.
+class LatencyTracer final {
+public:
+  /// @brief Install a tracer, replacing any previously installed tracer.
+  static FoxgloveResult<LatencyTracer> install(const LatencyTracerOptions& options = {});
+
+  /// @brief Get the latency percentiles for each sink, channel and stage, ordered by sink,
+  /// channel and stage.
+  ///
+  /// Percentiles are reported with a relative error of less than 1/16.
+  [[nodiscard]] FoxgloveResult<std::vector<LatencyStats>> stats() const;
+
+  /// @brief Write the most recent samples to a file, in the Chrome trace event format.
+  ///
+  /// The file can be opened in Perfetto or `chrome://tracing`. Each sink is shown as a thread,
+  /// and each stage of a sample as a slice on it.
+  FoxgloveError writeChromeTrace(std::string_view path) const;
+
+  /// @brief Discard the samples recorded so far.
+  void clear() const noexcept;
+
+private:
+  explicit LatencyTracer(foxglove_latency_tracer* impl);
+
+  std::unique_ptr<foxglove_latency_tracer, void (*)(foxglove_latency_tracer*)> impl_;
+};
+
+}  // namespace foxglove
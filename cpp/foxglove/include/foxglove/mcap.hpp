@@ -5,9 +5,11 @@
 #include <foxglove/error.hpp>
 
 #include <cerrno>
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <functional>
+#include <iosfwd>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,6 +24,54 @@ namespace foxglove {
 
 class Context;
 
+/// @brief A buffer of MCAP output, whose ownership is passed to @ref CustomWriter::write_owned.
+///
+/// The buffer is released when this object is destroyed.
+class McapBuffer final {
+public:
+  /// @cond foxglove_internal
+  explicit McapBuffer(const foxglove_mcap_buffer& buffer) noexcept
+      : buffer_(buffer) {}
+  /// @endcond
+
+  McapBuffer(McapBuffer&& other) noexcept
+      : buffer_(other.buffer_) {
+    other.buffer_.release = nullptr;
+  }
+  McapBuffer& operator=(McapBuffer&& other) noexcept {
+    if (this != &other) {
+      reset();
+      buffer_ = other.buffer_;
+      other.buffer_.release = nullptr;
+    }
+    return *this;
+  }
+  McapBuffer(const McapBuffer&) = delete;
+  McapBuffer& operator=(const McapBuffer&) = delete;
+  ~McapBuffer() {
+    reset();
+  }
+
+  /// @brief Pointer to the data.
+  [[nodiscard]] const uint8_t* data() const noexcept {
+    return buffer_.data;
+  }
+  /// @brief Number of bytes.
+  [[nodiscard]] size_t size() const noexcept {
+    return buffer_.len;
+  }
+
+private:
+  void reset() noexcept {
+    if (buffer_.release != nullptr) {
+      buffer_.release(buffer_.release_context);
+      buffer_.release = nullptr;
+    }
+  }
+
+  foxglove_mcap_buffer buffer_;
+};
+
 /// @brief Custom writer for writing MCAP data to arbitrary destinations.
 ///
 /// This provides a simple function pointer interface that matches the C API.
@@ -45,6 +95,28 @@ struct CustomWriter {
   /// @param new_pos Pointer to store the new absolute position
   /// @return 0 on success, an error number defined in errno.h if seek fails
   std::function<int(int64_t pos, int whence, uint64_t* new_pos)> seek;
+
+  /// @brief Vectored write function: write several buffers, in order, to the custom destination
+  ///
+  /// If set, this is used instead of write. Small writes, such as record headers, are held back
+  /// and passed alongside the next large write, instead of being concatenated with it.
+  ///
+  /// @param iov Buffers to write
+  /// @param iovcnt Number of buffers
+  /// @param error Pointer to error code (set to an error number defined in errno.h if write fails)
+  /// @return Total number of bytes actually written
+  std::function<size_t(const foxglove_bytes* iov, size_t iovcnt, int* error)> writev;
+
+  /// @brief Owned write function: take ownership of a buffer and write all of it to the custom
+  /// destination
+  ///
+  /// If set, this is used instead of write and writev. Output is handed over in blocks, each
+  /// containing at least one whole record, so compressed chunks arrive in a single buffer which
+  /// can be kept without copying.
+  ///
+  /// @param buffer The buffer, which is released when it is destroyed
+  /// @return 0 on success, an error number defined in errno.h if write fails
+  std::function<int(McapBuffer buffer)> write_owned;
 };
 
 /// @brief The compression algorithm to use for an MCAP file.
@@ -57,6 +129,26 @@ enum class McapCompression : uint8_t {
   Lz4,
 };
 
+/// @brief What an asynchronous MCAP writer does when its queue is full.
+///
+/// @see McapWriterOptions::async_writes
+enum class McapOverflowPolicy : uint8_t {
+  /// Block the logging thread until the writer thread makes room in the queue.
+  Block,
+  /// Drop the message being logged.
+  DropNewest,
+  /// Drop the oldest queued message to make room for the message being logged.
+  DropOldest,
+};
+
+/// @brief Statistics for an MCAP writer.
+struct McapWriterStats {
+  /// @brief Number of logged messages which have not been written yet.
+  size_t queue_depth = 0;
+  /// @brief Number of messages dropped because the queue was full.
+  uint64_t dropped_messages = 0;
+};
+
 /// @brief An attachment to store in an MCAP file.
 ///
 /// Attachments are arbitrary binary data that can be stored alongside messages.
@@ -78,6 +170,27 @@ struct Attachment {
   size_t data_len = 0;
 };
 
+/// @brief How the chunks holding a channel's messages are compressed.
+struct McapChunkCompression {
+  /// @brief The compression algorithm.
+  McapCompression compression = McapCompression::None;
+  /// @brief Compression level passed to the compressor. 0 uses the compressor's default level.
+  uint32_t level = 0;
+};
+
+/// @brief A function which chooses how the chunks holding a channel's messages are compressed.
+///
+/// Return std::nullopt to use McapWriterOptions::compression for the channel. The function is
+/// called once per channel, when the first message is logged to it, and must not block.
+using McapCompressionPolicyFn =
+  std::function<std::optional<McapChunkCompression>(const ChannelDescriptor&)>;
+
+/// @brief A function which chooses the group of chunks holding a channel's messages.
+///
+/// Channels in group 0 share the writer's default chunks. The function is called once per
+/// channel, when the first message is logged to it, and must not block.
+using McapChannelGroupFn = std::function<uint32_t(const ChannelDescriptor&)>;
+
 /// @brief Options for an MCAP writer.
 struct McapWriterOptions {
   friend class McapWriter;
@@ -132,6 +245,102 @@ struct McapWriterOptions {
   bool truncate = false;
   /// @brief Optional channel filter to use for the MCAP file.
   SinkChannelFilterFn sink_channel_filter;
+  /// @brief Optional filter which runs on each message before it is written.
+  ///
+  /// Use it to record channels with a different policy than other sinks in the same context, for
+  /// example at full rate while a WebSocket server sends a downsampled stream.
+  MessageFilterFn message_filter;
+  /// @brief Whether to write messages on a dedicated background thread.
+  ///
+  /// Logging a message copies it into a bounded queue and returns, leaving compression and I/O
+  /// to the writer thread, so that slow storage does not stall the logging thread.
+  bool async_writes = false;
+  /// @brief Maximum number of messages waiting to be written, if async_writes is set.
+  size_t async_queue_capacity = 1024;
+  /// @brief What to do when a message is logged while the queue is full, if async_writes is set.
+  ///
+  /// With McapOverflowPolicy::Block, or without async_writes, the writer is lossless: it may
+  /// block the logging thread, but never drops messages. Lossless sinks receive each message after
+  /// the other sinks in the context, such as WebSocket clients, which drop messages rather than
+  /// block. This only orders delivery: while the writer blocks, the logging thread waits, and
+  /// later messages are delayed for every sink.
+  McapOverflowPolicy async_overflow_policy = McapOverflowPolicy::Block;
+  /// @brief Number of output blocks queued for a dedicated I/O thread. 0 disables the I/O thread.
+  ///
+  /// When non-zero, the next chunk is filled and compressed while earlier chunks are still being
+  /// written. Works with both Zstd and LZ4 compression.
+  size_t pipeline_depth = 0;
+  /// @brief If non-zero, start a new segment file once this many bytes have been written to the
+  /// current one.
+  ///
+  /// When rotation is enabled, path is a template which must contain `{index}`, which is replaced
+  /// by the segment number starting from 0. Each segment is a complete MCAP file with its own
+  /// schemas, channels, and summary. Rotation is not supported with custom_writer.
+  uint64_t rotation_max_bytes = 0;
+  /// @brief If set, start a new segment file once the current one has been open this long.
+  ///
+  /// @see rotation_max_bytes
+  std::optional<std::chrono::milliseconds> rotation_max_duration;
+  /// @brief Open the file with `O_DIRECT` and write it in large aligned blocks, bypassing the
+  /// page cache.
+  ///
+  /// This keeps long recordings from filling the page cache. It requires disable_seeking, and is
+  /// only supported on Linux.
+  bool direct_io = false;
+  /// @brief If set, flush the current chunk to the file at least this often.
+  ///
+  /// For file output without rotation, schemas and channels are also recorded in a journal
+  /// alongside the file, at path + ".checkpoint". If the process exits before the writer is
+  /// closed, recoverMcap() can then make the file readable again without decompressing any
+  /// chunks. The journal is removed when the writer is closed.
+  std::optional<std::chrono::milliseconds> checkpoint_interval;
+  /// @brief Optional function which chooses the compression of each channel's chunks.
+  ///
+  /// Channels with different compression are written to separately compressed streams of chunks
+  /// in the same file, so that, for example, compressed video is not compressed again while JSON
+  /// channels still are. The resulting file has no data section or summary CRCs.
+  McapCompressionPolicyFn compression_policy;
+  /// @brief Optional function which chooses the group of chunks holding each channel's messages.
+  ///
+  /// Each group is written to a separate stream of chunks in the same file, which are finished
+  /// independently, so each chunk only holds messages from one group. Readers which select a few
+  /// topics, such as cameras, then only decompress the chunks of their groups. Each group holds
+  /// up to chunk_size bytes in memory. The resulting file has no data section or summary CRCs.
+  McapChannelGroupFn channel_group;
+  /// @brief Number of messages of each schema to train a zstd dictionary from. 0 disables
+  /// dictionaries.
+  ///
+  /// Once trained, a schema's dictionary is stored in an attachment named after the schema, and
+  /// later chunks holding its messages are compressed with it, so that a small chunk_size keeps
+  /// a good compression ratio. Only readers which load the dictionaries from the file's
+  /// attachments can decompress those chunks.
+  size_t zstd_dictionary_training_messages = 0;
+  /// @brief Maximum size of each zstd dictionary, in bytes. 0 uses the default size.
+  size_t zstd_dictionary_max_size = 0;
+  /// @brief Compression level for chunks compressed with a zstd dictionary. 0 uses zstd's
+  /// default level.
+  uint32_t zstd_dictionary_level = 0;
+  /// @brief If non-zero, reserve disk space for the file in extents of this many bytes as it
+  /// grows, and release the unused space when the writer is closed.
+  ///
+  /// Long recordings otherwise grow in small appends, which fragments the file and occasionally
+  /// stalls a write while the filesystem allocates blocks. The reserved space does not change
+  /// the file's length, so a file which is not closed remains readable. This applies to each
+  /// segment when rotating. Not supported with direct_io, and only supported on Linux.
+  uint64_t preallocate_bytes = 0;
+  /// @brief If non-zero, write sparse message indexes, which keep the first message of each
+  /// channel in a chunk, and then one message at least every this many messages.
+  ///
+  /// A message index normally has an entry for every message, so for channels with very high
+  /// message rates the indexes can be larger than the messages. Readers which read whole chunks,
+  /// or scan forward from an indexed message, read every message; readers which only read the
+  /// messages listed in the indexes miss the others. Statistics still count every message.
+  uint64_t sparse_index_every_messages = 0;
+  /// @brief If set, write sparse message indexes which keep one message at least this often, by
+  /// log time.
+  ///
+  /// @see sparse_index_every_messages
+  std::optional<std::chrono::nanoseconds> sparse_index_interval;
 
   McapWriterOptions() = default;
 };
@@ -172,6 +381,21 @@ public:
   /// @return FoxgloveError::Ok on success, or an error code on failure
   FoxgloveError attach(const Attachment& attachment);
 
+  /// @brief Write an attachment whose data is read from a stream.
+  ///
+  /// Exactly attachment.data_len bytes are read from data and copied to the file in blocks, so
+  /// large attachments such as map archives never need to be held in memory. attachment.data
+  /// must be null. Messages logged while the data is copied wait until the attachment has been
+  /// written.
+  ///
+  /// If reading fails or the stream ends early, the rest of the attachment is filled with zeros
+  /// so that the file remains valid, and an error is returned.
+  ///
+  /// @param attachment The attachment to write, without its data
+  /// @param data The stream to read the attachment data from
+  /// @return FoxgloveError::Ok on success, or an error code on failure
+  FoxgloveError attach(const Attachment& attachment, std::istream& data);
+
   /// @brief Stops logging events and flushes buffered data.
   FoxgloveError close();
 
@@ -183,6 +407,21 @@ public:
   /// @return FoxgloveError::Ok on success, or an error code on failure
   FoxgloveError flush();
 
+  /// @brief Get the writer's queue depth and the number of dropped messages.
+  ///
+  /// Both are always zero unless the writer was created with McapWriterOptions::async_writes.
+  ///
+  /// @return The current statistics, or an error code if the writer is closed
+  [[nodiscard]] FoxgloveResult<McapWriterStats> stats() const;
+
+  /// @cond foxglove_internal
+  /// @brief Get the writer's sink ID.
+  ///
+  /// Messages logged with this sink ID are written only to this writer's file. Returns
+  /// std::nullopt if the writer is closed.
+  [[nodiscard]] std::optional<uint64_t> sinkId() const;
+  /// @endcond
+
   /// @brief Default move constructor.
   McapWriter(McapWriter&&) = default;
   /// @brief Default move assignment.
@@ -196,11 +435,17 @@ private:
   explicit McapWriter(
     foxglove_mcap_writer* writer,
     std::unique_ptr<SinkChannelFilterFn> sink_channel_filter = nullptr,
-    std::unique_ptr<CustomWriter> custom_writer = nullptr
+    std::unique_ptr<CustomWriter> custom_writer = nullptr,
+    std::unique_ptr<McapCompressionPolicyFn> compression_policy = nullptr,
+    std::unique_ptr<MessageFilterFn> message_filter = nullptr,
+    std::unique_ptr<McapChannelGroupFn> channel_group = nullptr
   );
 
   std::unique_ptr<SinkChannelFilterFn> sink_channel_filter_;
   std::unique_ptr<CustomWriter> custom_writer_;
+  std::unique_ptr<McapCompressionPolicyFn> compression_policy_;
+  std::unique_ptr<MessageFilterFn> message_filter_;
+  std::unique_ptr<McapChannelGroupFn> channel_group_;
   std::unique_ptr<foxglove_mcap_writer, foxglove_error (*)(foxglove_mcap_writer*)> impl_;
 };
 
@@ -252,6 +497,18 @@ inline SeekFunction noSeekFn(const uint64_t* position) {
   };
 }
 
+/// @brief Make an MCAP file which was not closed properly readable, by writing its summary.
+///
+/// The file is truncated after its last complete record, and a summary is appended which indexes
+/// the chunks, attachments, and metadata found in it. Chunks are located from their record
+/// headers, so the cost is proportional to the number of chunks rather than the file size. If
+/// the file was written with a checkpoint interval, the checkpoint journal supplies the schemas
+/// and channels, and is removed afterwards. Files which are already complete are left unchanged.
+///
+/// @param path The path to the MCAP file.
+/// @return The result of the recovery.
+FoxgloveError recoverMcap(const std::string& path);
+
 /// @deprecated Use noSeekFn() instead.
 // NOLINTNEXTLINE(readability-identifier-naming)
 [[deprecated("Use noSeekFn() instead")]] inline SeekFunction no_seek_fn(const uint64_t* position) {
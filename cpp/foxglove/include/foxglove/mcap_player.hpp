@@ -0,0 +1,161 @@
+#pragma once
+
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/playback_control_request.hpp>
+#include <foxglove/playback_state.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace foxglove {
+
+/// @brief Options for McapPlayer::create.
+struct McapPlayerOptions {
+  /// @brief The context which the player's channels log to. If omitted, the default context is
+  /// used.
+  Context context;
+  /// @brief Only play back messages on these topics. All topics are played back if unset.
+  std::optional<std::vector<std::string>> topics;
+  /// @brief The initial playback speed, as a factor of realtime.
+  float playback_speed = 1.0F;
+  /// @brief After each seek, immediately log the latest message before the seek time on each
+  /// channel, so that state such as transforms, scene entities and calibrations is shown without
+  /// waiting for it to be logged again. See McapReader::latestMessages.
+  bool backfill = true;
+  /// @brief Maximum number of messages the read-ahead thread decodes before they are due.
+  size_t read_ahead_messages = 4096;
+  /// @brief Maximum total size of the messages the read-ahead thread decodes before they are due.
+  ///
+  /// A single message larger than this is still played back.
+  size_t read_ahead_bytes = static_cast<size_t>(64) * 1024 * 1024;
+  /// @brief Number of chunks the read-ahead thread decompresses in parallel. See
+  /// McapReadOptions::decompression_threads.
+  size_t decompression_threads = 0;
+  /// @brief Length of the time slices in which the publish thread releases messages.
+  ///
+  /// The publish thread wakes when the next message is due, and logs every message due within
+  /// this slice of the wakeup as one batch. Dense recordings, such as a 1 kHz IMU, are then
+  /// played back with one wakeup per slice rather than one per message. Messages are logged up
+  /// to one slice early; a slice of 0 logs every message at its own deadline.
+  std::chrono::nanoseconds publish_slice = std::chrono::milliseconds(1);
+  /// @brief Drop messages which are more than this late, rather than logging them in a burst.
+  ///
+  /// When playback cannot keep up, such as at high speeds, messages fall behind their
+  /// deadlines. By default, they are all logged as soon as possible. With a maximum lateness,
+  /// messages further behind are dropped, so that playback stays in step with the playback
+  /// time. See McapPlayer::droppedMessages.
+  std::optional<std::chrono::nanoseconds> max_lateness;
+  /// @brief Called with the current playback time about 60 times a second during playback, for
+  /// example to call WebSocketServer::broadcastTime.
+  ///
+  /// Called from the publish thread, without the player's lock held. Must not destroy the player.
+  std::function<void(uint64_t current_time)> on_time;
+  /// @brief Called when playback reaches the end of the file, for example to call
+  /// WebSocketServer::broadcastPlaybackState.
+  ///
+  /// Called from the publish thread, without the player's lock held. Must not destroy the player.
+  std::function<void(const PlaybackState& state)> on_playback_state;
+};
+
+/// @brief Plays back the messages of an MCAP file into a Context, paced by their log times.
+///
+/// The player creates a channel for each channel in the file, and logs each message to it once
+/// its log time is reached, at the configured playback speed. Messages are read and
+/// decompressed ahead of time on a read-ahead thread, into a queue bounded by
+/// McapPlayerOptions::read_ahead_messages and McapPlayerOptions::read_ahead_bytes, and logged on
+/// a separate publish thread. Decompressing large chunks therefore does not delay the messages
+/// which are due, which matters at high playback speeds on high-bandwidth recordings.
+///
+/// Message deadlines are computed from a fixed point on the steady clock, which only moves when
+/// playback is paused, resumed or changes speed, so late wakeups do not accumulate into drift.
+/// Messages are released in time slices of McapPlayerOptions::publish_slice, and may be dropped
+/// when they fall behind by more than McapPlayerOptions::max_lateness.
+///
+/// The player starts out paused at the beginning of the file. Its methods may be called from any
+/// thread, for example from a WebSocketServer's onPlaybackControlRequest callback:
+///
+/// @code{.cpp}
+/// options.capabilities = WebSocketServerCapabilities::PlaybackControl |
+///                        WebSocketServerCapabilities::Time;
+/// options.playback_time_range = player.timeRange();
+/// options.callbacks.onPlaybackControlRequest = [&player](const PlaybackControlRequest& request) {
+///   return player.handlePlaybackControlRequest(request);
+/// };
+/// @endcode
+///
+/// @note McapPlayer is movable but not copyable.
+class McapPlayer final {
+public:
+  /// @brief Open a finished MCAP file for playback.
+  ///
+  /// @param path The path to the MCAP file.
+  /// @param options Options for the player.
+  /// @return A new, paused player.
+  static FoxgloveResult<McapPlayer> create(
+    std::string_view path, McapPlayerOptions options = McapPlayerOptions{}
+  );
+
+  /// @brief Stops playback and joins the player's threads.
+  ~McapPlayer();
+  McapPlayer(McapPlayer&& other) noexcept;
+  McapPlayer& operator=(McapPlayer&& other) noexcept;
+  McapPlayer(const McapPlayer&) = delete;
+  McapPlayer& operator=(const McapPlayer&) = delete;
+
+  /// @brief The inclusive (start, end) range of message log times in the file, in nanoseconds.
+  [[nodiscard]] std::pair<uint64_t, uint64_t> timeRange() const noexcept;
+
+  /// @brief Begin or resume playback. Has no effect unless playback is paused.
+  void play();
+
+  /// @brief Pause playback. Has no effect unless playback is playing.
+  void pause();
+
+  /// @brief Set the playback speed, as a factor of realtime.
+  void setPlaybackSpeed(float speed);
+
+  /// @brief Seek to a log time, in nanoseconds.
+  ///
+  /// The time is clamped to the file's time range. Messages queued by the read-ahead thread are
+  /// discarded, and reading restarts at the new time using the file's chunk indexes. Unless
+  /// McapPlayerOptions::backfill is false, the latest message before the new time on each
+  /// channel is logged right away, even while paused.
+  void seek(uint64_t log_time);
+
+  /// @brief Apply a playback control request, and return the resulting playback state.
+  [[nodiscard]] PlaybackState handlePlaybackControlRequest(const PlaybackControlRequest& request);
+
+  /// @brief The current playback state.
+  [[nodiscard]] PlaybackState state() const;
+
+  /// @brief The current playback status.
+  [[nodiscard]] PlaybackStatus status() const;
+
+  /// @brief The log time of the last message played back, in nanoseconds.
+  [[nodiscard]] uint64_t currentTime() const;
+
+  /// @brief The current playback speed, as a factor of realtime.
+  [[nodiscard]] float playbackSpeed() const;
+
+  /// @brief The number of messages dropped because they were later than
+  /// McapPlayerOptions::max_lateness.
+  [[nodiscard]] uint64_t droppedMessages() const;
+
+private:
+  struct Impl;
+
+  explicit McapPlayer(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace foxglove
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/error.hpp>
+#include <foxglove/schema.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace foxglove {
+
+/// @brief The order in which an McapReader returns messages.
+enum class McapReadOrder : uint8_t {
+  /// Messages are returned in order of log time. Chunks whose time ranges overlap are read
+  /// together and merged.
+  LogTime = 0,
+  /// Messages are returned in the order they appear in the file, which avoids holding
+  /// overlapping chunks in memory at once.
+  File = 1,
+};
+
+/// @brief Options for McapReader::messages and McapReader::merge.
+struct McapReadOptions {
+  /// @brief Only return messages logged at or after this time, in nanoseconds.
+  std::optional<uint64_t> start_time;
+  /// @brief Only return messages logged before this time, in nanoseconds.
+  std::optional<uint64_t> end_time;
+  /// @brief Only return messages on these topics. All topics are read if unset.
+  std::optional<std::vector<std::string>> topics;
+  /// @brief The order in which messages are returned.
+  McapReadOrder order = McapReadOrder::LogTime;
+  /// @brief Number of chunks to decompress in parallel. Values less than 2 decompress chunks on
+  /// the thread which calls McapMessageIterator::next.
+  size_t decompression_threads = 0;
+};
+
+/// @brief A channel in an MCAP file.
+struct McapReaderChannel {
+  /// @brief The channel id, unique within the file.
+  uint16_t id = 0;
+  /// @brief The channel topic.
+  std::string topic;
+  /// @brief The encoding of the channel's messages.
+  std::string message_encoding;
+  /// @brief The channel metadata.
+  std::map<std::string, std::string> metadata;
+  /// @brief The channel's schema, if it has one.
+  ///
+  /// The schema data refers to the mapped file, and is valid while the reader, or an iterator
+  /// created from it, exists.
+  std::optional<Schema> schema;
+};
+
+/// @brief A message read from an MCAP file.
+///
+/// The message data is not copied, and is valid until the next call to
+/// McapMessageIterator::next, or until the iterator is destroyed.
+struct McapMessageView {
+  /// @brief The channel the message was logged to.
+  const McapReaderChannel* channel = nullptr;
+  /// @brief The message sequence number.
+  uint32_t sequence = 0;
+  /// @brief The time the message was logged, in nanoseconds.
+  uint64_t log_time = 0;
+  /// @brief The time the message was published, in nanoseconds.
+  uint64_t publish_time = 0;
+  /// @brief The message data.
+  const std::byte* data = nullptr;
+  /// @brief The length of the message data.
+  size_t data_len = 0;
+  /// @brief For iterators created with McapReader::merge, the index of the reader the message
+  /// was read from. Zero for other iterators.
+  size_t reader_index = 0;
+};
+
+/// @brief An iterator over the messages in one or more MCAP files, created by
+/// McapReader::messages, McapReader::latestMessages or McapReader::merge.
+///
+/// The iterator may outlive the readers it was created from.
+///
+/// @note McapMessageIterator is movable but not copyable, and must not be used from multiple
+/// threads at once.
+class McapMessageIterator final {
+public:
+  /// @brief Read the next message.
+  ///
+  /// @return The next message, std::nullopt once all messages have been read, or an error if a
+  /// chunk could not be read. The iterator is exhausted after an error.
+  FoxgloveResult<std::optional<McapMessageView>> next();
+
+private:
+  friend class McapReader;
+
+  McapMessageIterator(
+    foxglove_mcap_message_iterator* impl,
+    std::vector<std::shared_ptr<const std::vector<McapReaderChannel>>> channels
+  );
+
+  // The channels of each reader the iterator reads from.
+  std::vector<std::shared_ptr<const std::vector<McapReaderChannel>>> channels_;
+  std::unique_ptr<foxglove_mcap_message_iterator, void (*)(foxglove_mcap_message_iterator*)>
+    impl_;
+};
+
+/// @brief A reader for a finished MCAP file.
+///
+/// The file is memory-mapped, and messages are read from it without copying. Chunks which
+/// cannot hold messages matching the McapReadOptions are skipped using the file's chunk
+/// indexes, so reading a short time range or a few topics of a large file only reads the chunks
+/// which hold them. Chunks compressed with zstd dictionaries, as written with
+/// McapWriterOptions::zstd_dictionary_training_messages, are supported.
+///
+/// The file must not be truncated while it is being read. Unfinished recordings have no summary
+/// section, and must be repaired with recoverMcap before they can be read.
+///
+/// @note McapReader is movable but not copyable. Iterators created from the same reader may be
+/// used from different threads.
+class McapReader final {
+public:
+  /// @brief Open a finished MCAP file for reading.
+  ///
+  /// @param path The path to the MCAP file.
+  /// @return A new reader.
+  static FoxgloveResult<McapReader> open(std::string_view path);
+
+  /// @brief The file's channels, in order of id.
+  [[nodiscard]] const std::vector<McapReaderChannel>& channels() const noexcept;
+
+  /// @brief Get the channel with the given id, or nullptr if there is none.
+  [[nodiscard]] const McapReaderChannel* channel(uint16_t id) const noexcept;
+
+  /// @brief The earliest and latest message log times in the file, from its chunk indexes.
+  ///
+  /// @return The time range, or std::nullopt if the file has no chunk indexes or no messages.
+  [[nodiscard]] std::optional<std::pair<uint64_t, uint64_t>> timeRange() const noexcept;
+
+  /// @brief Create an iterator over the messages which match the options.
+  [[nodiscard]] FoxgloveResult<McapMessageIterator> messages(
+    const McapReadOptions& options = {}
+  ) const;
+
+  /// @brief Create an iterator over the latest message logged before a time on each channel,
+  /// in order of log time.
+  ///
+  /// This is the state a viewer needs after seeking to `time`, such as the most recent
+  /// transforms, scene updates and calibrations. Chunks are read from the latest to the earliest,
+  /// and the chunk indexes are used to skip chunks which cannot hold a later message on a channel
+  /// still missing one, so usually only the chunks just before `time` are read.
+  ///
+  /// @param time The time to find the latest messages before, in nanoseconds.
+  /// @param options Options selecting the messages to read. Only the topics option is used.
+  [[nodiscard]] FoxgloveResult<McapMessageIterator> latestMessages(
+    uint64_t time, const McapReadOptions& options = {}
+  ) const;
+
+  /// @brief Create an iterator over the messages of several files which match the options,
+  /// merged in order of log time.
+  ///
+  /// This is useful for recordings which were rotated, or recorded as several files in parallel.
+  /// The order option is ignored. Each file's chunks are read as the merge reaches them, using
+  /// its chunk indexes, so only the chunks which overlap the current log time are decompressed
+  /// and held in memory. Messages with the same log time are returned in the order of their
+  /// readers.
+  ///
+  /// @param readers The readers to merge. McapMessageView::reader_index is an index into this
+  /// vector.
+  /// @param options Options selecting the messages to read.
+  [[nodiscard]] static FoxgloveResult<McapMessageIterator> merge(
+    const std::vector<McapReader>& readers, const McapReadOptions& options = {}
+  );
+
+private:
+  explicit McapReader(foxglove_mcap_reader* reader);
+
+  std::shared_ptr<const std::vector<McapReaderChannel>> channels_;
+  std::unique_ptr<foxglove_mcap_reader, void (*)(foxglove_mcap_reader*)> impl_;
+};
+
+}  // namespace foxglove
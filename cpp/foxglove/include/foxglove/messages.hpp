@@ -10,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 #ifndef __wasm32__
@@ -36,13 +37,28 @@ struct Vector3 {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Vector3 as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Vector3's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Vector3 schema.
   ///
@@ -69,13 +85,28 @@ struct Quaternion {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Quaternion as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Quaternion's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Quaternion schema.
   ///
@@ -96,13 +127,28 @@ struct Pose {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Pose as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Pose's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Pose schema.
   ///
@@ -129,13 +175,28 @@ struct Color {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Color as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Color's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Color schema.
   ///
@@ -169,13 +230,28 @@ struct ArrowPrimitive {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the ArrowPrimitive as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the ArrowPrimitive's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the ArrowPrimitive schema.
   ///
@@ -288,13 +364,28 @@ struct CameraCalibration {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the CameraCalibration as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the CameraCalibration's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the CameraCalibration schema.
   ///
@@ -315,13 +406,28 @@ struct Point2 {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Point2 as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Point2's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Point2 schema.
   ///
@@ -342,13 +448,28 @@ struct KeyValuePair {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the KeyValuePair as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the KeyValuePair's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the KeyValuePair schema.
   ///
@@ -385,13 +506,28 @@ struct CircleAnnotation {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the CircleAnnotation as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the CircleAnnotation's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the CircleAnnotation schema.
   ///
@@ -430,13 +566,28 @@ struct CompressedAudio {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the CompressedAudio as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the CompressedAudio's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the CompressedAudio schema.
   ///
@@ -444,6 +595,24 @@ struct CompressedAudio {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a CompressedAudio, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in CompressedAudio.
+struct CompressedAudioView {
+  /// @brief See CompressedAudio::timestamp.
+  std::optional<Timestamp> timestamp;
+
+  /// @brief See CompressedAudio::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+
+  /// @brief See CompressedAudio::format.
+  std::string_view format;
+};
+
 /// @brief A compressed image
 struct CompressedImage {
   /// @brief Timestamp of image
@@ -467,13 +636,28 @@ struct CompressedImage {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the CompressedImage as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the CompressedImage's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the CompressedImage schema.
   ///
@@ -481,6 +665,27 @@ struct CompressedImage {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a CompressedImage, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in CompressedImage.
+struct CompressedImageView {
+  /// @brief See CompressedImage::timestamp.
+  std::optional<Timestamp> timestamp;
+
+  /// @brief See CompressedImage::frame_id.
+  std::string_view frame_id;
+
+  /// @brief See CompressedImage::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+
+  /// @brief See CompressedImage::format.
+  std::string_view format;
+};
+
 /// @brief A compressed point cloud. A decoder for `format` must decompress `data`, using metadata
 /// stored in the compressed payload to recover point positions and any additional per-point
 /// attributes. The decoded point cloud must include at least 2 coordinate fields from `x`, `y`, and
@@ -509,13 +714,28 @@ struct CompressedPointCloud {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the CompressedPointCloud as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the CompressedPointCloud's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the CompressedPointCloud schema.
   ///
@@ -523,6 +743,30 @@ struct CompressedPointCloud {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a CompressedPointCloud, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in CompressedPointCloud.
+struct CompressedPointCloudView {
+  /// @brief See CompressedPointCloud::timestamp.
+  std::optional<Timestamp> timestamp;
+
+  /// @brief See CompressedPointCloud::frame_id.
+  std::string_view frame_id;
+
+  /// @brief See CompressedPointCloud::pose.
+  std::optional<Pose> pose;
+
+  /// @brief See CompressedPointCloud::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+
+  /// @brief See CompressedPointCloud::format.
+  std::string_view format;
+};
+
 /// @brief A single frame of a compressed video bitstream
 struct CompressedVideo {
   /// @brief Timestamp of video frame
@@ -580,13 +824,28 @@ struct CompressedVideo {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the CompressedVideo as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the CompressedVideo's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the CompressedVideo schema.
   ///
@@ -594,6 +853,27 @@ struct CompressedVideo {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a CompressedVideo, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in CompressedVideo.
+struct CompressedVideoView {
+  /// @brief See CompressedVideo::timestamp.
+  std::optional<Timestamp> timestamp;
+
+  /// @brief See CompressedVideo::frame_id.
+  std::string_view frame_id;
+
+  /// @brief See CompressedVideo::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+
+  /// @brief See CompressedVideo::format.
+  std::string_view format;
+};
+
 /// @brief A primitive representing a cylinder, elliptic cylinder, or truncated cone
 struct CylinderPrimitive {
   /// @brief Position of the center of the cylinder and orientation of the cylinder. The flat
@@ -619,13 +899,28 @@ struct CylinderPrimitive {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the CylinderPrimitive as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the CylinderPrimitive's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the CylinderPrimitive schema.
   ///
@@ -649,13 +944,28 @@ struct CubePrimitive {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the CubePrimitive as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the CubePrimitive's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the CubePrimitive schema.
   ///
@@ -688,13 +998,28 @@ struct Event {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Event as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Event's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Event schema.
   ///
@@ -738,13 +1063,28 @@ struct FrameTransform {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the FrameTransform as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the FrameTransform's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the FrameTransform schema.
   ///
@@ -762,13 +1102,28 @@ struct FrameTransforms {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the FrameTransforms as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the FrameTransforms's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the FrameTransforms schema.
   ///
@@ -786,13 +1141,28 @@ struct GeoJSON {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the GeoJSON as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the GeoJSON's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the GeoJSON schema.
   ///
@@ -813,13 +1183,28 @@ struct Vector2 {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Vector2 as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Vector2's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Vector2 schema.
   ///
@@ -864,13 +1249,28 @@ struct PackedElementField {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the PackedElementField as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the PackedElementField's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the PackedElementField schema.
   ///
@@ -960,13 +1360,28 @@ struct Grid {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Grid as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Grid's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Grid schema.
   ///
@@ -974,6 +1389,42 @@ struct Grid {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a Grid, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in Grid.
+struct GridView {
+  /// @brief See Grid::timestamp.
+  std::optional<Timestamp> timestamp;
+
+  /// @brief See Grid::frame_id.
+  std::string_view frame_id;
+
+  /// @brief See Grid::pose.
+  std::optional<Pose> pose;
+
+  /// @brief See Grid::column_count.
+  uint32_t column_count = 0;
+
+  /// @brief See Grid::cell_size.
+  std::optional<Vector2> cell_size;
+
+  /// @brief See Grid::row_stride.
+  uint32_t row_stride = 0;
+
+  /// @brief See Grid::cell_stride.
+  uint32_t cell_stride = 0;
+
+  /// @brief See Grid::fields.
+  std::vector<PackedElementField> fields;
+
+  /// @brief See Grid::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+};
+
 /// @brief A 3D grid of data
 struct VoxelGrid {
   /// @brief Timestamp of grid
@@ -1023,13 +1474,28 @@ struct VoxelGrid {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the VoxelGrid as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the VoxelGrid's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the VoxelGrid schema.
   ///
@@ -1037,6 +1503,48 @@ struct VoxelGrid {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a VoxelGrid, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in VoxelGrid.
+struct VoxelGridView {
+  /// @brief See VoxelGrid::timestamp.
+  std::optional<Timestamp> timestamp;
+
+  /// @brief See VoxelGrid::frame_id.
+  std::string_view frame_id;
+
+  /// @brief See VoxelGrid::pose.
+  std::optional<Pose> pose;
+
+  /// @brief See VoxelGrid::row_count.
+  uint32_t row_count = 0;
+
+  /// @brief See VoxelGrid::column_count.
+  uint32_t column_count = 0;
+
+  /// @brief See VoxelGrid::cell_size.
+  std::optional<Vector3> cell_size;
+
+  /// @brief See VoxelGrid::slice_stride.
+  uint32_t slice_stride = 0;
+
+  /// @brief See VoxelGrid::row_stride.
+  uint32_t row_stride = 0;
+
+  /// @brief See VoxelGrid::cell_stride.
+  uint32_t cell_stride = 0;
+
+  /// @brief See VoxelGrid::fields.
+  std::vector<PackedElementField> fields;
+
+  /// @brief See VoxelGrid::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+};
+
 /// @brief An array of points on a 2D image
 struct PointsAnnotation {
   /// @brief Type of points annotation
@@ -1083,13 +1591,28 @@ struct PointsAnnotation {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the PointsAnnotation as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the PointsAnnotation's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the PointsAnnotation schema.
   ///
@@ -1126,13 +1649,28 @@ struct TextAnnotation {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the TextAnnotation as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the TextAnnotation's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the TextAnnotation schema.
   ///
@@ -1164,13 +1702,28 @@ struct ImageAnnotations {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the ImageAnnotations as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the ImageAnnotations's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the ImageAnnotations schema.
   ///
@@ -1200,13 +1753,28 @@ struct JointState {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the JointState as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the JointState's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the JointState schema.
   ///
@@ -1227,13 +1795,28 @@ struct JointStates {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the JointStates as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the JointStates's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the JointStates schema.
   ///
@@ -1272,13 +1855,28 @@ struct LaserScan {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the LaserScan as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the LaserScan's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the LaserScan schema.
   ///
@@ -1302,13 +1900,28 @@ struct Point3 {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Point3 as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Point3's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Point3 schema.
   ///
@@ -1361,13 +1974,28 @@ struct LinePrimitive {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the LinePrimitive as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the LinePrimitive's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the LinePrimitive schema.
   ///
@@ -1429,13 +2057,28 @@ struct LocationFix {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the LocationFix as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the LocationFix's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the LocationFix schema.
   ///
@@ -1453,13 +2096,28 @@ struct LocationFixes {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the LocationFixes as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the LocationFixes's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the LocationFixes schema.
   ///
@@ -1507,13 +2165,28 @@ struct Log {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Log as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Log's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Log schema.
   ///
@@ -1545,13 +2218,28 @@ struct SceneEntityDeletion {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the SceneEntityDeletion as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the SceneEntityDeletion's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the SceneEntityDeletion schema.
   ///
@@ -1575,13 +2263,28 @@ struct SpherePrimitive {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the SpherePrimitive as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the SpherePrimitive's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the SpherePrimitive schema.
   ///
@@ -1615,13 +2318,28 @@ struct TriangleListPrimitive {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the TriangleListPrimitive as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the TriangleListPrimitive's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the TriangleListPrimitive schema.
   ///
@@ -1657,13 +2375,28 @@ struct TextPrimitive {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the TextPrimitive as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the TextPrimitive's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the TextPrimitive schema.
   ///
@@ -1704,13 +2437,28 @@ struct ModelPrimitive {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the ModelPrimitive as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the ModelPrimitive's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the ModelPrimitive schema.
   ///
@@ -1718,6 +2466,36 @@ struct ModelPrimitive {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a ModelPrimitive, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in ModelPrimitive.
+struct ModelPrimitiveView {
+  /// @brief See ModelPrimitive::pose.
+  std::optional<Pose> pose;
+
+  /// @brief See ModelPrimitive::scale.
+  std::optional<Vector3> scale;
+
+  /// @brief See ModelPrimitive::color.
+  std::optional<Color> color;
+
+  /// @brief See ModelPrimitive::override_color.
+  bool override_color = false;
+
+  /// @brief See ModelPrimitive::url.
+  std::string_view url;
+
+  /// @brief See ModelPrimitive::media_type.
+  std::string_view media_type;
+
+  /// @brief See ModelPrimitive::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+};
+
 /// @brief A visual element in a 3D scene. An entity may be composed of multiple primitives which
 /// all share the same frame of reference.
 struct SceneEntity {
@@ -1773,13 +2551,28 @@ struct SceneEntity {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the SceneEntity as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the SceneEntity's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the SceneEntity schema.
   ///
@@ -1800,13 +2593,28 @@ struct SceneUpdate {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the SceneUpdate as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the SceneUpdate's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the SceneUpdate schema.
   ///
@@ -1852,13 +2660,28 @@ struct Odometry {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Odometry as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Odometry's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Odometry schema.
   ///
@@ -1882,13 +2705,28 @@ struct Point3InFrame {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the Point3InFrame as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the Point3InFrame's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the Point3InFrame schema.
   ///
@@ -1924,13 +2762,28 @@ struct PointCloud {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the PointCloud as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the PointCloud's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the PointCloud schema.
   ///
@@ -1938,6 +2791,33 @@ struct PointCloud {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a PointCloud, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in PointCloud.
+struct PointCloudView {
+  /// @brief See PointCloud::timestamp.
+  std::optional<Timestamp> timestamp;
+
+  /// @brief See PointCloud::frame_id.
+  std::string_view frame_id;
+
+  /// @brief See PointCloud::pose.
+  std::optional<Pose> pose;
+
+  /// @brief See PointCloud::point_stride.
+  uint32_t point_stride = 0;
+
+  /// @brief See PointCloud::fields.
+  std::vector<PackedElementField> fields;
+
+  /// @brief See PointCloud::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+};
+
 /// @brief A timestamped pose for an object or reference frame in 3D space
 struct PoseInFrame {
   /// @brief Timestamp of pose
@@ -1954,13 +2834,28 @@ struct PoseInFrame {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the PoseInFrame as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the PoseInFrame's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the PoseInFrame schema.
   ///
@@ -1984,13 +2879,28 @@ struct PosesInFrame {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the PosesInFrame as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the PosesInFrame's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the PosesInFrame schema.
   ///
@@ -2020,13 +2930,28 @@ struct RawAudio {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the RawAudio as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the RawAudio's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the RawAudio schema.
   ///
@@ -2034,6 +2959,30 @@ struct RawAudio {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a RawAudio, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in RawAudio.
+struct RawAudioView {
+  /// @brief See RawAudio::timestamp.
+  std::optional<Timestamp> timestamp;
+
+  /// @brief See RawAudio::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+
+  /// @brief See RawAudio::format.
+  std::string_view format;
+
+  /// @brief See RawAudio::sample_rate.
+  uint32_t sample_rate = 0;
+
+  /// @brief See RawAudio::number_of_channels.
+  uint32_t number_of_channels = 0;
+};
+
 /// @brief A raw image
 struct RawImage {
   /// @brief Timestamp of image
@@ -2142,13 +3091,28 @@ struct RawImage {
   /// On success, writes the serialized length to *encoded_len.
   /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
   /// and returns FoxgloveError::BufferTooShort.
-  /// If the message cannot be encoded, writes the reason to stderr and returns
-  /// FoxgloveError::EncodeError.
+  /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+  /// for a string which is not valid UTF-8.
   ///
   /// @param ptr the destination buffer. must point to at least len valid bytes.
   /// @param len the length of the destination buffer.
   /// @param encoded_len where the serialized length or required capacity will be written to.
-  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);
+  FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+  /// @brief Encode the RawImage as protobuf, appending it to the provided buffer.
+  ///
+  /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+  /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+  /// buffer is left unchanged.
+  ///
+  /// @param buf the buffer to append the serialized message to.
+  FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+  /// @brief Get the length of the RawImage's protobuf encoding, in bytes.
+  ///
+  /// This computes the length without serializing the message. If the message cannot be
+  /// encoded, returns the reason, as encode does.
+  [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;
 
   /// @brief Get the RawImage schema.
   ///
@@ -2156,6 +3120,36 @@ struct RawImage {
   static Schema schema();
 };
 
+/// @brief A borrowed view of a RawImage, for logging without copying the payload.
+///
+/// String and byte fields reference memory owned by the caller, which must remain valid for the
+/// duration of the log call. All other fields have the same types as in RawImage.
+struct RawImageView {
+  /// @brief See RawImage::timestamp.
+  std::optional<Timestamp> timestamp;
+
+  /// @brief See RawImage::frame_id.
+  std::string_view frame_id;
+
+  /// @brief See RawImage::width.
+  uint32_t width = 0;
+
+  /// @brief See RawImage::height.
+  uint32_t height = 0;
+
+  /// @brief See RawImage::encoding.
+  std::string_view encoding;
+
+  /// @brief See RawImage::step.
+  uint32_t step = 0;
+
+  /// @brief See RawImage::data.
+  const std::byte* data = nullptr;
+
+  /// @brief Length of data, in bytes.
+  size_t data_len = 0;
+};
+
 #ifndef __wasm32__
 
 /// @brief A functor for freeing a channel. Used by ChannelUniquePtr. For internal use only.
@@ -2178,8 +3172,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<ArrowPrimitiveChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2193,6 +3189,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The ArrowPrimitive messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const ArrowPrimitive* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2206,9 +3217,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
+  ///
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2245,8 +3260,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<CameraCalibrationChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2260,6 +3277,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The CameraCalibration messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const CameraCalibration* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2273,9 +3305,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2312,8 +3348,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<CircleAnnotationChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2327,6 +3365,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The CircleAnnotation messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const CircleAnnotation* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2340,9 +3393,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2379,8 +3436,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<ColorChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2394,6 +3453,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Color messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Color* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2407,9 +3481,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
+  ///
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2446,8 +3524,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<CompressedAudioChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2461,6 +3541,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The CompressedAudioView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const CompressedAudioView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The CompressedAudio messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const CompressedAudio* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2474,9 +3580,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2513,8 +3623,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<CompressedImageChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2528,6 +3640,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The CompressedImageView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const CompressedImageView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The CompressedImage messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const CompressedImage* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2541,9 +3679,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2580,8 +3722,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<CompressedPointCloudChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2595,6 +3739,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The CompressedPointCloudView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const CompressedPointCloudView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The CompressedPointCloud messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const CompressedPointCloud* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2608,9 +3778,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
+  ///
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2648,8 +3822,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<CompressedVideoChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2663,6 +3839,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The CompressedVideoView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const CompressedVideoView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The CompressedVideo messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const CompressedVideo* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2676,9 +3878,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2715,8 +3921,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<CylinderPrimitiveChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2730,6 +3938,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The CylinderPrimitive messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const CylinderPrimitive* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2743,9 +3966,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
+  ///
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2782,8 +4009,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<CubePrimitiveChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2797,6 +4026,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The CubePrimitive messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const CubePrimitive* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2810,9 +4054,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
+  ///
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2849,8 +4097,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<EventChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2864,6 +4114,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Event messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Event* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2877,9 +4142,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2916,8 +4185,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<FrameTransformChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2931,6 +4202,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The FrameTransform messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const FrameTransform* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -2944,9 +4230,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -2983,8 +4273,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<FrameTransformsChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -2998,6 +4290,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The FrameTransforms messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const FrameTransforms* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3011,9 +4318,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
+  ///
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3050,8 +4361,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<GeoJSONChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3065,6 +4378,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The GeoJSON messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const GeoJSON* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3078,9 +4406,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3117,8 +4449,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<GridChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3132,6 +4466,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The GridView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const GridView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Grid messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Grid* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3145,9 +4505,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3184,8 +4548,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<VoxelGridChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3199,6 +4565,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The VoxelGridView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const VoxelGridView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The VoxelGrid messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const VoxelGrid* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3212,9 +4604,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3251,8 +4647,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<ImageAnnotationsChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3266,6 +4664,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The ImageAnnotations messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const ImageAnnotations* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3279,9 +4692,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3318,8 +4735,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<JointStateChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3333,6 +4752,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The JointState messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const JointState* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3346,9 +4780,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3385,8 +4823,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<JointStatesChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3400,6 +4840,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The JointStates messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const JointStates* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3413,9 +4868,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3452,8 +4911,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<KeyValuePairChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3467,6 +4928,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The KeyValuePair messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const KeyValuePair* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3480,9 +4956,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3519,8 +4999,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<LaserScanChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3534,6 +5016,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The LaserScan messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const LaserScan* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3547,9 +5044,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3586,8 +5087,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<LinePrimitiveChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3601,6 +5104,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The LinePrimitive messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const LinePrimitive* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3614,9 +5132,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3653,8 +5175,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<LocationFixChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3668,6 +5192,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The LocationFix messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const LocationFix* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3681,9 +5220,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3720,8 +5263,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<LocationFixesChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3735,6 +5280,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The LocationFixes messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const LocationFixes* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3748,9 +5308,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3787,8 +5351,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<LogChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3802,6 +5368,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Log messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Log* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3815,9 +5396,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3854,8 +5439,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<SceneEntityDeletionChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3869,6 +5456,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The SceneEntityDeletion messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const SceneEntityDeletion* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3882,9 +5484,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3921,8 +5527,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<SceneEntityChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -3936,6 +5544,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The SceneEntity messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const SceneEntity* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -3949,9 +5572,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -3988,8 +5615,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<SceneUpdateChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4003,6 +5632,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The SceneUpdate messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const SceneUpdate* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4016,9 +5660,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4055,8 +5703,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<ModelPrimitiveChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4070,6 +5720,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The ModelPrimitiveView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const ModelPrimitiveView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The ModelPrimitive messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const ModelPrimitive* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4083,9 +5759,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4122,8 +5802,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<OdometryChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4137,6 +5819,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Odometry messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Odometry* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4150,9 +5847,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4189,8 +5890,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<PackedElementFieldChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4204,6 +5907,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The PackedElementField messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const PackedElementField* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4217,9 +5935,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4256,8 +5978,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<Point2Channel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4271,6 +5995,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Point2 messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Point2* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4284,9 +6023,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4323,8 +6066,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<Point3Channel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4338,6 +6083,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Point3 messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Point3* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4351,9 +6111,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4390,8 +6154,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<Point3InFrameChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4405,6 +6171,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Point3InFrame messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Point3InFrame* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4418,9 +6199,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4457,8 +6242,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<PointCloudChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4472,6 +6259,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The PointCloudView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const PointCloudView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The PointCloud messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const PointCloud* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4485,9 +6298,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4524,8 +6341,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<PointsAnnotationChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4539,6 +6358,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The PointsAnnotation messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const PointsAnnotation* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4552,9 +6386,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4591,8 +6429,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<PoseChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4606,6 +6446,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Pose messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Pose* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4619,9 +6474,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4658,8 +6517,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<PoseInFrameChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4673,6 +6534,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The PoseInFrame messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const PoseInFrame* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4686,9 +6562,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4725,8 +6605,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<PosesInFrameChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4740,6 +6622,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The PosesInFrame messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const PosesInFrame* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4753,9 +6650,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4792,8 +6693,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<QuaternionChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4807,6 +6710,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Quaternion messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Quaternion* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4820,9 +6738,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4859,8 +6781,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<RawAudioChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4874,6 +6798,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The RawAudioView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const RawAudioView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The RawAudio messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const RawAudio* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4887,9 +6837,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4926,8 +6880,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<RawImageChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -4941,6 +6897,32 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+  ///
+  /// @param msg The RawImageView message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const RawImageView& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The RawImage messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const RawImage* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -4954,9 +6936,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -4993,8 +6979,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<SpherePrimitiveChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -5008,6 +6996,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The SpherePrimitive messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const SpherePrimitive* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -5021,9 +7024,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -5060,8 +7067,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<TextAnnotationChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -5075,6 +7084,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The TextAnnotation messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const TextAnnotation* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -5088,9 +7112,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -5127,8 +7155,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<TextPrimitiveChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -5142,6 +7172,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The TextPrimitive messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const TextPrimitive* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -5155,9 +7200,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -5194,8 +7243,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<TriangleListPrimitiveChannel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -5209,6 +7260,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The TriangleListPrimitive messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const TriangleListPrimitive* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -5222,9 +7288,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -5262,8 +7332,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<Vector2Channel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -5277,6 +7349,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Vector2 messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Vector2* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -5290,9 +7377,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
@@ -5329,8 +7420,10 @@ public:
   /// compatibility with the Foxglove app.
   /// @param context The context which associates logs to a sink. If omitted, the default context is
   /// used.
+  /// @param keep_last The number of most recent messages the channel retains for sinks that
+  /// subscribe later. See RawChannel::create.
   static FoxgloveResult<Vector3Channel> create(
-    const std::string_view& topic, const Context& context = Context()
+    const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0
   );
 
   /// @brief Log a message to the channel.
@@ -5344,6 +7437,21 @@ public:
     std::optional<uint64_t> sink_id = std::nullopt
   ) noexcept;
 
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The Vector3 messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const Vector3* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept;
+
   /// @brief Close the channel.
   ///
   /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
@@ -5357,9 +7465,13 @@ public:
   /// @return The ID of the channel.
   [[nodiscard]] uint64_t id() const noexcept;
 
-  /// @brief Find out if any sinks have been added to the channel.
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+  /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+  /// enough to call before every log, to skip building messages that no sink would receive.
   ///
-  /// @return True if sinks have been added to the channel, false otherwise.
+  /// @return True if sinks are subscribed to the channel, false otherwise.
   [[nodiscard]] bool hasSinks() const noexcept;
 
   /// @deprecated Use hasSinks() instead.
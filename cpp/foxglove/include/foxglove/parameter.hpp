@@ -3,12 +3,16 @@
 #include <foxglove/error.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -18,6 +22,8 @@ struct foxglove_parameter_value;
 struct foxglove_parameter;
 // NOLINTNEXTLINE(readability-identifier-naming)
 struct foxglove_parameter_array;
+// NOLINTNEXTLINE(readability-identifier-naming)
+struct foxglove_parameter_value_desc;
 
 namespace foxglove {
 
@@ -726,6 +732,7 @@ private:
   friend class RemoteAccessGateway;
   friend class GetParametersResponder;
   friend class SetParametersResponder;
+  friend class ParameterArrayBuilder;
   friend struct internal::ForwarderAccess;
 
   struct Deleter {
@@ -734,8 +741,110 @@ private:
 
   std::unique_ptr<foxglove_parameter_array, Deleter> impl_;
 
+  /// @brief Constructor from raw pointer.
+  explicit ParameterArray(foxglove_parameter_array* ptr);
+
   /// @brief Releases ownership of the underlying storage.
   [[nodiscard]] foxglove_parameter_array* release() noexcept;
 };
 
+/// @brief Builds a `ParameterArray` in bulk.
+///
+/// Constructing a `ParameterArray` from `Parameter` and `ParameterValue` objects allocates every
+/// node of every value separately, and copies each dictionary key into a `std::map`. The builder
+/// instead describes the parameters in an arena owned by the builder, and converts the whole tree
+/// in a single call to `build()`. This is considerably cheaper for large or deeply nested
+/// parameters, such as publishing the full configuration of a robot.
+///
+/// Names, dictionary keys and string values are viewed, not copied, so the data they refer to
+/// must remain valid until `build()` returns. Values are only valid for the builder which created
+/// them, until it is cleared.
+///
+/// @code{.cpp}
+/// foxglove::ParameterArrayBuilder builder;
+/// auto gains = builder.dict({{"p", builder.float64(1.0)}, {"i", builder.float64(0.1)}});
+/// builder.add("controller", gains).add("enabled", builder.boolean(true));
+/// server.publishParameterValues(builder.build());
+/// @endcode
+class ParameterArrayBuilder final {
+public:
+  /// @brief A value described by a `ParameterArrayBuilder`.
+  class Value final {
+  public:
+    Value() = delete;
+
+  private:
+    friend class ParameterArrayBuilder;
+
+    const foxglove_parameter_value_desc* desc_;
+
+    explicit Value(const foxglove_parameter_value_desc* desc)
+        : desc_(desc) {}
+  };
+
+  /// @brief A dictionary entry, as a key and value.
+  using Entry = std::pair<std::string_view, Value>;
+
+  ParameterArrayBuilder();
+  ~ParameterArrayBuilder();
+  /// @brief Default move constructor.
+  ParameterArrayBuilder(ParameterArrayBuilder&& other) noexcept;
+  /// @brief Default move assignment.
+  ParameterArrayBuilder& operator=(ParameterArrayBuilder&& other) noexcept;
+  ParameterArrayBuilder(const ParameterArrayBuilder&) = delete;
+  ParameterArrayBuilder& operator=(const ParameterArrayBuilder&) = delete;
+
+  /// @brief Describes a floating point value.
+  [[nodiscard]] Value float64(double value);
+  /// @brief Describes an integer value.
+  [[nodiscard]] Value integer(int64_t value);
+  /// @brief Describes a boolean value.
+  [[nodiscard]] Value boolean(bool value);
+  /// @brief Describes a string value. The string is not copied.
+  [[nodiscard]] Value string(std::string_view value);
+  /// @brief Describes an array value.
+  [[nodiscard]] Value array(std::initializer_list<Value> values);
+  /// @brief Describes an array value.
+  [[nodiscard]] Value array(const std::vector<Value>& values);
+  /// @brief Describes a dict value. The keys are not copied.
+  [[nodiscard]] Value dict(std::initializer_list<Entry> entries);
+  /// @brief Describes a dict value. The keys are not copied.
+  [[nodiscard]] Value dict(const std::vector<Entry>& entries);
+
+  /// @brief Adds a parameter without a value. The name is not copied.
+  ParameterArrayBuilder& add(std::string_view name);
+  /// @brief Adds a parameter. The name is not copied.
+  ///
+  /// @param name The parameter name.
+  /// @param value A value described by this builder.
+  /// @param type An optional type hint for the value.
+  ParameterArrayBuilder& add(
+    std::string_view name, Value value, ParameterType type = ParameterType::None
+  );
+
+  /// @brief Returns the number of parameters added to the builder.
+  [[nodiscard]] size_t size() const noexcept;
+
+  /// @brief Converts the described parameters into a parameter array.
+  ///
+  /// The builder is left unchanged, so the same parameters may be built again.
+  ///
+  /// @throws std::runtime_error if a name, key or string is not valid UTF-8.
+  [[nodiscard]] ParameterArray build() const;
+
+  /// @brief Removes all parameters and values, invalidating every `Value` described so far.
+  ///
+  /// The builder's memory is kept for reuse, so a builder which is cleared and refilled, for
+  /// example to publish a set of parameters periodically, stops allocating once it is warm.
+  void clear() noexcept;
+
+private:
+  struct Impl;
+
+  std::unique_ptr<Impl> impl_;
+
+  [[nodiscard]] Value describeArray(const Value* values, size_t count);
+  [[nodiscard]] Value describeDict(const Entry* entries, size_t count);
+};
+
 }  // namespace foxglove
@@ -42,6 +42,13 @@ public:
   /// @param params Parameter values to send.
   void respond(std::vector<Parameter>&& params) &&;
 
+  /// @brief Send parameter values back to the requesting client.
+  ///
+  /// This overload accepts an array from ParameterArrayBuilder.
+  ///
+  /// @param params Parameter values to send.
+  void respond(ParameterArray&& params) && noexcept;
+
   ~GetParametersResponder() = default;
   /// @brief Default move constructor.
   GetParametersResponder(GetParametersResponder&&) noexcept = default;
@@ -98,6 +105,13 @@ public:
   /// @param params Parameter values that were applied.
   void respond(std::vector<Parameter>&& params) &&;
 
+  /// @brief Send the applied parameter values back to the requesting client.
+  ///
+  /// This overload accepts an array from ParameterArrayBuilder.
+  ///
+  /// @param params Parameter values that were applied.
+  void respond(ParameterArray&& params) && noexcept;
+
   ~SetParametersResponder() = default;
   /// @brief Default move constructor.
   SetParametersResponder(SetParametersResponder&&) noexcept = default;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <foxglove/error.hpp>
+#include <foxglove/messages.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace foxglove {
+
+/// @brief The per-point columns of a point cloud, in structure-of-arrays form.
+///
+/// Each non-null column points to `count` values.
+struct PointCloudColumns {
+  /// @brief The x coordinates. Required.
+  const float* x = nullptr;
+  /// @brief The y coordinates. Required.
+  const float* y = nullptr;
+  /// @brief The z coordinates. Required.
+  const float* z = nullptr;
+  /// @brief The intensity of each point, packed into an `intensity` field. Optional.
+  const float* intensity = nullptr;
+  /// @brief The color of each point, packed into `red`, `green`, `blue` and `alpha` fields.
+  /// Optional.
+  ///
+  /// Each value holds the red, green, blue and alpha bytes in memory order, which is
+  /// `0xAABBGGRR` on little-endian platforms.
+  const uint32_t* rgba = nullptr;
+  /// @brief The number of points.
+  size_t count = 0;
+};
+
+/// @brief Packs structure-of-arrays point data into the interleaved layout of a PointCloud.
+///
+/// Points are packed as float32 `x`, `y` and `z` fields, followed by the optional `intensity` and
+/// color fields. On x86-64 and ARM64, the columns are interleaved with SSE2 or NEON.
+///
+/// The packed data is written into a buffer owned by the builder, which keeps its capacity between
+/// calls to pack(), so a builder reused for each sweep of a sensor doesn't allocate once it has
+/// reached its working size. Log the result without copying it with view() and
+/// messages::PointCloudChannel::log.
+///
+/// @note PointCloudBuilder is not thread-safe.
+class PointCloudBuilder final {
+public:
+  /// @brief Pack the columns, replacing any previously packed points.
+  ///
+  /// Returns FoxgloveError::ValueError if any of the coordinate columns is null and `count` is
+  /// not zero. On error, the previously packed points are left unchanged.
+  ///
+  /// @param columns The columns to pack.
+  FoxgloveError pack(const PointCloudColumns& columns);
+
+  /// @brief Get a view of the packed points, for logging without copying.
+  ///
+  /// Set the frame ID, and optionally the timestamp and pose, on the returned view before logging
+  /// it. The view refers to the builder's buffer, and is valid until the next call to pack(), or
+  /// until the builder is destroyed.
+  [[nodiscard]] messages::PointCloudView view() const;
+
+  /// @brief Get the packed point data.
+  [[nodiscard]] const std::vector<std::byte>& data() const noexcept {
+    return data_;
+  }
+
+  /// @brief Get the fields describing the packed point data.
+  [[nodiscard]] const std::vector<messages::PackedElementField>& fields() const noexcept {
+    return fields_;
+  }
+
+  /// @brief Get the number of bytes between points in the packed data.
+  [[nodiscard]] uint32_t pointStride() const noexcept {
+    return point_stride_;
+  }
+
+  /// @brief Get the number of packed points.
+  [[nodiscard]] size_t size() const noexcept {
+    return point_stride_ == 0 ? 0 : data_.size() / point_stride_;
+  }
+
+private:
+  std::vector<std::byte> data_;
+  std::vector<messages::PackedElementField> fields_;
+  uint32_t point_stride_ = 0;
+};
+
+}  // namespace foxglove
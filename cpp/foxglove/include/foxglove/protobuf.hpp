@@ -0,0 +1,127 @@
+#pragma once
+
+/// @file
+/// Helpers for logging messages generated by protoc.
+///
+/// @note This header requires [protobuf](https://github.com/protocolbuffers/protobuf) to be
+/// available on the include path, and the program to link against it.
+
+#include <foxglove/error.hpp>
+#include <foxglove/schema.hpp>
+#include <foxglove/typed_channel.hpp>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/message.h>
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace foxglove {
+
+/// @cond foxglove_internal
+namespace detail {
+
+/// Adds `file` to `set` after its transitive dependencies, so that each file follows the files it
+/// imports.
+inline void addFileWithDependencies(
+  const google::protobuf::FileDescriptor* file,
+  std::unordered_set<const google::protobuf::FileDescriptor*>& seen,
+  google::protobuf::FileDescriptorSet& set
+) {
+  if (!seen.insert(file).second) {
+    return;
+  }
+  for (int i = 0; i < file->dependency_count(); ++i) {
+    addFileWithDependencies(file->dependency(i), seen, set);
+  }
+  file->CopyTo(set.add_file());
+}
+
+}  // namespace detail
+/// @endcond
+
+/// @brief Get a protobuf schema for a message type.
+///
+/// The schema data is a serialized `FileDescriptorSet` containing the file which defines the
+/// message, and all of its transitive dependencies. Building it is relatively expensive, so it is
+/// built once per descriptor and cached for the lifetime of the program. This function is
+/// thread-safe.
+///
+/// The returned schema refers to the cached data, which is never freed.
+///
+/// @param descriptor The descriptor of the message type.
+inline Schema protobufSchema(const google::protobuf::Descriptor* descriptor) {
+  static std::mutex mutex;
+  // Nodes are never erased, so references to the cached data remain valid.
+  static std::unordered_map<const google::protobuf::Descriptor*, std::string> cache;
+
+  const std::string* data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = cache.try_emplace(descriptor);
+    if (inserted) {
+      google::protobuf::FileDescriptorSet set;
+      std::unordered_set<const google::protobuf::FileDescriptor*> seen;
+      detail::addFileWithDependencies(descriptor->file(), seen, set);
+      it->second = set.SerializeAsString();
+    }
+    data = &it->second;
+  }
+
+  Schema schema;
+  schema.name = descriptor->full_name();
+  schema.encoding = "protobuf";
+  schema.data = reinterpret_cast<const std::byte*>(data->data());
+  schema.data_len = data->size();
+  return schema;
+}
+
+/// @brief MessageTraits for message types generated by protoc.
+///
+/// Messages are serialized directly into the channel's reused encoding buffer, without the
+/// intermediate `std::string` of `SerializeAsString`. Messages may be allocated on a
+/// `google::protobuf::Arena`; only the message is read, and nothing is allocated on the arena.
+///
+/// The schema is built once per message type, with protobufSchema().
+///
+/// Use it as the Traits argument of TypedChannel, or through the ProtobufChannel alias.
+template<typename T>
+struct ProtobufMessageTraits {
+  /// @brief The message encoding.
+  static constexpr std::string_view message_encoding = "protobuf";
+
+  /// @brief The schema of the message type.
+  static std::optional<Schema> schema() {
+    return protobufSchema(T::descriptor());
+  }
+
+  /// @brief Append the serialized message to `buf`.
+  ///
+  /// Returns FoxgloveError::EncodeError if the message is larger than protobuf's 2GB limit.
+  static FoxgloveError encode(const T& msg, std::vector<uint8_t>& buf) {
+    // ByteSizeLong() caches the size of each submessage, for serialization to use.
+    const size_t size = msg.ByteSizeLong();
+    if (size > INT_MAX) {
+      return FoxgloveError::EncodeError;
+    }
+    const size_t offset = buf.size();
+    buf.resize(offset + size);
+    msg.SerializeWithCachedSizesToArray(buf.data() + offset);
+    return FoxgloveError::Ok;
+  }
+};
+
+/// @brief A channel for logging messages of a type generated by protoc.
+template<typename T>
+using ProtobufChannel = TypedChannel<T, ProtobufMessageTraits<T>>;
+
+}  // namespace foxglove
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <optional>
@@ -23,6 +24,12 @@ struct foxglove_gateway;
 
 namespace foxglove {
 
+/// @cond foxglove_internal
+namespace internal {
+class CallbackQueue;
+}
+/// @endcond
+
 /// @brief Connection status of the remote access gateway.
 enum class RemoteAccessConnectionStatus : uint8_t {
   /// The gateway is attempting to establish or re-establish a connection.
@@ -80,7 +87,8 @@ inline RemoteAccessGatewayCapabilities operator&(
 /// These methods are invoked from time-sensitive contexts and must not block.
 ///
 /// @note These callbacks may be invoked concurrently from multiple threads.
-/// You must synchronize access to your mutable internal state or shared resources.
+/// You must synchronize access to your mutable internal state or shared resources, unless the
+/// gateway is created with RemoteAccessGatewayOptions::poll_callbacks.
 // Suppress -Wdeprecated-declarations for synthesized special members; the
 // field-level [[deprecated]] still warns on direct use.
 #if defined(__GNUC__) || defined(__clang__)
@@ -181,10 +189,37 @@ enum class Reliability : uint8_t {
   Reliable = 1,
 };
 
+/// @brief The priority of a channel's data, relative to other channels.
+///
+/// When a participant's message backlog is congested, messages for higher-priority channels are
+/// sent more often, and messages for lower-priority channels are dropped first. Priority takes
+/// effect for reliable channels when the gateway is configured with a dropping
+/// MessageBacklogPolicy.
+enum class Priority : uint8_t {
+  /// The default priority.
+  Normal = 0,
+  /// Best-effort data, such as debug visualizations.
+  Low = 1,
+  /// Latency-sensitive data, such as teleoperation commands and transforms.
+  High = 2,
+};
+
 /// @brief Quality-of-service profile for a channel.
 struct QosProfile {
   /// @brief The reliability policy for the channel's data delivery.
   Reliability reliability = Reliability::Lossy;
+  /// @brief The priority of the channel's data.
+  Priority priority = Priority::Normal;
+  /// @brief How long a message may wait in a participant's message backlog before it is dropped.
+  ///
+  /// Like the priority, this takes effect for reliable channels when the gateway is configured
+  /// with a dropping MessageBacklogPolicy. By default, messages never expire.
+  std::optional<std::chrono::milliseconds> lifespan;
+  /// @brief Maximum rate of messages sent for the channel, in messages per second.
+  ///
+  /// Messages logged faster than this are dropped. Video channels are not affected. By default,
+  /// the rate is not limited.
+  std::optional<double> max_rate;
 };
 
 /// @brief A callable that assigns a QoS profile to each channel.
@@ -199,6 +234,15 @@ using QosClassifierFn = std::function<QosProfile(const ChannelDescriptor&)>;
 /// maps, whose pixel values encode depth and would be corrupted by lossy video transcoding.
 using SuppressVideoTranscodeFn = std::function<bool(const ChannelDescriptor&)>;
 
+/// @brief A callable that asks the producer of a pre-encoded video channel for a keyframe.
+///
+/// Accepts any callable with signature `void(const ChannelDescriptor&)`. Channels carrying
+/// `foxglove.CompressedVideo` are forwarded to clients without transcoding, and a viewer can only
+/// start decoding at a keyframe. The gateway invokes this callback when a client subscribes to
+/// such a channel, or when it drops one of its frames; the producer should force its encoder to
+/// emit a keyframe. Requests are throttled per channel. The callback must not block.
+using KeyframeRequestFn = std::function<void(const ChannelDescriptor&)>;
+
 /// @brief Preferred backend for encoding published video tracks.
 ///
 /// This preference applies to every video track the gateway publishes. If the requested
@@ -220,6 +264,38 @@ enum class VideoEncoderBackend : uint8_t {
   VideoToolbox = 5,
 };
 
+/// @brief How a participant's message backlog handles messages for reliable channels when it fills
+/// up.
+enum class MessageBacklogPolicy : uint8_t {
+  /// Queue channel messages with control plane messages, and disconnect the participant when the
+  /// queue is full. The participant is asked to reconnect. This is the default.
+  Disconnect = 0,
+  /// Queue channel messages separately, and drop the oldest queued message when the backlog is
+  /// full, whichever channel it was logged to.
+  DropOldest = 1,
+  /// Queue channel messages separately, and drop stale messages from the busiest channels when the
+  /// backlog is full, keeping the latest message of each channel.
+  KeepLatestPerChannel = 2,
+};
+
+/// @brief Limits for published video tracks, which are also adapted to the available bandwidth.
+///
+/// The gateway divides the bandwidth estimated by the WebRTC congestion controller between its
+/// video tracks. Each track keeps its full resolution and frame rate while its share allows, then
+/// steps down a resolution ladder (halving the width and height at each rung), and finally drops
+/// frames.
+struct VideoLimits {
+  /// @brief Maximum bitrate of each video track, in bits per second.
+  uint64_t max_bitrate = 4'000'000;
+  /// @brief Maximum frame rate of each video track. Frames arriving faster are dropped.
+  double max_framerate = 30.0;
+  /// @brief Lowest frame rate a track is reduced to when bandwidth is scarce.
+  double min_framerate = 5.0;
+  /// @brief Largest factor by which the width and height of frames are divided when bandwidth is
+  /// scarce. 1 disables the resolution ladder.
+  uint32_t max_downscale = 4;
+};
+
 /// @brief Options for creating a remote access gateway.
 struct RemoteAccessGatewayOptions {
   /// @brief The logging context for this gateway.
@@ -253,6 +329,11 @@ struct RemoteAccessGatewayOptions {
   /// data instead of transcoding it to video. If not set, all video-capable channels are
   /// transcoded.
   SuppressVideoTranscodeFn suppress_video_transcode;
+  /// @brief A keyframe request callback for pre-encoded video channels.
+  ///
+  /// If not set, compressed video channels are still forwarded, but viewers wait for the
+  /// producer's next scheduled keyframe before they can decode.
+  KeyframeRequestFn keyframe_request;
   /// @brief A parameter handler.
   ///
   /// When set, this handler takes precedence over the deprecated
@@ -281,7 +362,9 @@ struct RemoteAccessGatewayOptions {
   /// Each participant gets an independent queue of this size. If a participant's queue fills up
   /// (because it is not reading fast enough), it will be disconnected and asked to reconnect.
   ///
-  /// By default, each participant gets a queue of 1024 messages.
+  /// By default, each participant gets a queue of 1024 messages. With a message_backlog_policy
+  /// that drops messages, this is also the size of each participant's backlog of messages for
+  /// reliable channels.
   std::optional<size_t> message_backlog_size = std::nullopt;
   /// @brief Preferred backend for encoding published video tracks.
   ///
@@ -296,6 +379,67 @@ struct RemoteAccessGatewayOptions {
   ///
   /// By default, the limit is 102400 bytes (100 KiB).
   std::optional<size_t> max_data_track_message_size = std::nullopt;
+  /// @brief Maximum number of bytes in each participant's backlog of messages for reliable
+  /// channels.
+  ///
+  /// When the queued messages exceed this size, stale messages are dropped according to
+  /// message_backlog_policy. The most recent message is always queued, even if it is larger than
+  /// the limit. Has no effect with @ref MessageBacklogPolicy::Disconnect. By default, the backlog
+  /// is only limited by message_backlog_size.
+  std::optional<size_t> message_backlog_bytes = std::nullopt;
+  /// @brief How a participant's backlog handles messages for reliable channels when it fills up.
+  ///
+  /// On slow links, a policy that drops stale messages keeps participants connected, where the
+  /// default would disconnect them and have them reconnect. Control plane messages are never
+  /// dropped, and are sent ahead of queued channel messages.
+  MessageBacklogPolicy message_backlog_policy = MessageBacklogPolicy::Disconnect;
+  /// @brief Limits for published video tracks.
+  ///
+  /// If set, the bitrate and frame rate of each video track are limited, and its resolution and
+  /// frame rate are adapted to the available bandwidth. By default, the encoder bitrate is left to
+  /// libwebrtc, and frames are sent at the resolution and rate they are logged at.
+  std::optional<VideoLimits> video_limits = std::nullopt;
+  /// @brief Maximum size of a lossy message which is split into fragments rather than dropped.
+  ///
+  /// Lossy messages larger than max_data_track_message_size, and up to this many bytes, are sent
+  /// as fragments of at most max_data_track_message_size bytes each, so that they don't
+  /// monopolize the data channel. A viewer discards a message if any of its fragments is lost.
+  /// By default, messages are not fragmented.
+  std::optional<size_t> max_fragmented_message_size = std::nullopt;
+  /// @brief Whether published video tracks are sent as simulcast layers.
+  ///
+  /// Each video channel is encoded once, and the resulting track is shared by every participant
+  /// subscribed to it. With simulcast, the track is also encoded at half and a quarter of its
+  /// resolution, and the server picks a layer for each participant according to its bandwidth.
+  /// This adds to the encoding cost of each track, so it is disabled by default.
+  bool video_simulcast = false;
+  /// @brief How long small lossy messages wait to be packed with others into a shared frame.
+  ///
+  /// If set, small messages published to a lossy channel's data track are sent together in
+  /// frames that fit in one data-channel packet, which cuts the packet rate of channels that
+  /// publish many small messages at the cost of up to this much added latency. Messages are only
+  /// packed with others from the same channel. By default, messages are not packed. Viewers must
+  /// support packed data-track frames.
+  std::optional<std::chrono::microseconds> pack_linger = std::nullopt;
+  /// @brief Path of a file in which to cache the device info fetched from the Foxglove platform.
+  ///
+  /// With a cache, a restarted gateway names itself after the cached device info while it
+  /// refreshes it in the background, rather than waiting on the API. Cached info expires after 7
+  /// days, and is ignored if the device token or API URL change. By default, nothing is cached.
+  std::optional<std::string> device_info_cache_path = std::nullopt;
+  /// @brief Queue callbacks, to be invoked by RemoteAccessGateway::pollEvents on your own thread.
+  ///
+  /// By default, callbacks are invoked from the gateway's threads, possibly concurrently. When
+  /// this is set, the gateway queues the notification callbacks of RemoteAccessGatewayCallbacks,
+  /// along with copies of their arguments, and the requests to the parameter_handler. They are
+  /// then invoked in the order they were received, on the thread which calls pollEvents, so they
+  /// don't need synchronization and can be processed in batches. Service calls can be queued with
+  /// RemoteAccessGateway::polledServiceHandler.
+  ///
+  /// The legacy onGetParameters and onSetParameters callbacks, which return a value to the
+  /// gateway, as well as the fetch_asset handler, qos_classifier, suppress_video_transcode, and
+  /// keyframe_request, are still invoked directly.
+  bool poll_callbacks = false;
   // New fields are appended last so that adding them preserves the layout of pre-existing fields.
 };
 
@@ -306,6 +450,8 @@ struct RemoteAccessGatewayOptions {
 ///
 /// @note RemoteAccessGateway is fully thread-safe, but RemoteAccessGatewayCallbacks may be invoked
 /// concurrently from multiple threads, so you will need to use synchronization in your callbacks.
+/// Alternatively, set RemoteAccessGatewayOptions::poll_callbacks and call pollEvents() from your
+/// own thread.
 class RemoteAccessGateway final {
 public:
   /// @brief Create and start a gateway with the given options.
@@ -314,6 +460,24 @@ public:
   /// @brief Get the current connection status.
   [[nodiscard]] RemoteAccessConnectionStatus connectionStatus() const;
 
+  /// @brief Invoke the callbacks queued since the last call, on the calling thread.
+  ///
+  /// Requires RemoteAccessGatewayOptions::poll_callbacks; otherwise, callbacks are not queued and
+  /// this returns 0. Callbacks are invoked in the order the gateway received their events. Events
+  /// queued while polling are left for the next call.
+  ///
+  /// @param max_events The maximum number of callbacks to invoke.
+  /// @return The number of callbacks invoked.
+  size_t pollEvents(size_t max_events = std::numeric_limits<size_t>::max());
+
+  /// @brief Wrap a service handler, so that its calls are queued and invoked by pollEvents().
+  ///
+  /// The returned handler is passed to Service::create, and must outlive the service. If the
+  /// gateway doesn't poll its callbacks, `handler` is returned unchanged.
+  ///
+  /// @param handler The service handler.
+  [[nodiscard]] ServiceHandler polledServiceHandler(ServiceHandler&& handler) const;
+
   /// @brief Advertises support for the provided service.
   ///
   /// @param service The service to add.
@@ -331,6 +495,13 @@ public:
   /// @param params Updated parameters.
   void publishParameterValues(std::vector<Parameter>&& params);
 
+  /// @brief Publishes parameter values to all subscribed clients.
+  ///
+  /// This overload accepts an array from ParameterArrayBuilder.
+  ///
+  /// @param params Updated parameters.
+  void publishParameterValues(ParameterArray&& params);
+
   /// @brief Publishes a status message to all connected participants.
   ///
   /// The caller may optionally provide a message ID, which can be used in a
@@ -358,6 +529,17 @@ public:
   /// @param graph The connection graph to publish.
   [[nodiscard]] FoxgloveError publishConnectionGraph(const ConnectionGraph& graph) const;
 
+  /// @brief Apply a patch to the published connection graph, and send the changes to all
+  /// subscribed clients.
+  ///
+  /// Unlike publishConnectionGraph, this does not require the complete graph, and only the
+  /// topics and services named in the patch are compared with the published graph.
+  ///
+  /// Requires RemoteAccessGatewayCapabilities::ConnectionGraph.
+  ///
+  /// @param patch The changes to apply. The patch is consumed.
+  [[nodiscard]] FoxgloveError updateConnectionGraph(ConnectionGraphPatch&& patch) const;
+
   /// @cond foxglove_internal
   /// @brief Get the sink ID of the gateway's current session.
   ///
@@ -375,7 +557,9 @@ private:
     std::unique_ptr<SinkChannelFilterFn> sink_channel_filter,
     std::unique_ptr<QosClassifierFn> qos_classifier,
     std::unique_ptr<SuppressVideoTranscodeFn> suppress_video_transcode,
-    std::unique_ptr<ParameterHandler> parameter_handler
+    std::unique_ptr<KeyframeRequestFn> keyframe_request,
+    std::unique_ptr<ParameterHandler> parameter_handler,
+    std::shared_ptr<internal::CallbackQueue> callback_queue
   );
 
   std::unique_ptr<RemoteAccessGatewayCallbacks> callbacks_;
@@ -383,7 +567,9 @@ private:
   std::unique_ptr<SinkChannelFilterFn> sink_channel_filter_;
   std::unique_ptr<QosClassifierFn> qos_classifier_;
   std::unique_ptr<SuppressVideoTranscodeFn> suppress_video_transcode_;
+  std::unique_ptr<KeyframeRequestFn> keyframe_request_;
   std::unique_ptr<ParameterHandler> parameter_handler_;
+  std::shared_ptr<internal::CallbackQueue> callback_queue_;
   std::unique_ptr<foxglove_gateway, foxglove_error (*)(foxglove_gateway*)> impl_;
 };
 
@@ -11,16 +11,26 @@
 /// [tobiaslocker/base64](https://github.com/tobiaslocker/base64) to be available on the include
 /// path.
 
+#include <foxglove/error.hpp>
 #include <foxglove/schema.hpp>
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <base64.hpp>
+#include <cmath>
 #include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <unordered_map>
 #include <vector>
 
 /// The foxglove namespace.
@@ -110,6 +120,85 @@ struct Manifest {
   std::vector<StreamedSource> sources;
 };
 
+// ============================================================================
+// Time-sliced sources
+// ============================================================================
+
+/// @brief An inclusive time range, in nanoseconds since the Unix epoch.
+struct TimeSegment {
+  /// @brief Start of the segment.
+  uint64_t start_ns;
+  /// @brief End of the segment (inclusive).
+  uint64_t end_ns;
+};
+
+/// @brief Options for @ref splitTimeRange.
+struct SegmentOptions {
+  /// @brief Estimated amount of MCAP data generated per second of the time range.
+  uint64_t estimated_bytes_per_second = 0;
+  /// @brief Approximate amount of MCAP data each segment should contain.
+  uint64_t target_bytes_per_segment = static_cast<uint64_t>(64) * 1024 * 1024;
+  /// @brief Maximum number of segments to produce.
+  size_t max_segments = 64;
+  /// @brief Segment boundaries are rounded down to a multiple of this, e.g. 1 second if your
+  /// source URLs only carry timestamps with second precision.
+  uint64_t alignment_ns = 1;
+};
+
+/// @brief Split a time range into consecutive, non-overlapping segments of roughly equal size.
+///
+/// Listing one @ref StreamedSource per segment in a @ref Manifest, instead of a single source for
+/// the whole range, lets the app fetch the segments in parallel and the backend generate them
+/// concurrently, so the initial load time scales with the number of cores rather than the length
+/// of the range.
+///
+/// The number of segments is chosen so that each one holds about
+/// `options.target_bytes_per_segment` of data, between 1 and `options.max_segments`.
+///
+/// @code{.cpp}
+/// rdl::SegmentOptions options;
+/// options.estimated_bytes_per_second = 100 * 1024;
+/// for (const auto& segment : rdl::splitTimeRange(start_ns, end_ns, options)) {
+///   rdl::StreamedSource source;
+///   // Build a URL, ID and start/end time for this segment...
+///   manifest.sources.push_back(std::move(source));
+/// }
+/// @endcode
+inline std::vector<TimeSegment> splitTimeRange(
+  uint64_t start_ns, uint64_t end_ns, const SegmentOptions& options
+) {
+  if (end_ns < start_ns) {
+    return {};
+  }
+  const uint64_t duration = end_ns - start_ns;
+  const long double total_bytes =
+    static_cast<long double>(duration) / 1e9L * options.estimated_bytes_per_second;
+  size_t count = 1;
+  if (options.target_bytes_per_segment > 0) {
+    const long double segments = std::ceil(total_bytes / options.target_bytes_per_segment);
+    count = segments < static_cast<long double>(options.max_segments)
+              ? static_cast<size_t>(segments)
+              : options.max_segments;
+  }
+  count = std::max<size_t>(count, 1);
+  const uint64_t alignment = std::max<uint64_t>(options.alignment_ns, 1);
+
+  std::vector<TimeSegment> segments;
+  segments.reserve(count);
+  uint64_t segment_start = start_ns;
+  for (size_t i = 1; i < count; ++i) {
+    uint64_t boundary = start_ns + (duration / count) * i + (duration % count) * i / count;
+    boundary -= boundary % alignment;
+    if (boundary <= segment_start) {
+      continue;
+    }
+    segments.push_back(TimeSegment{segment_start, boundary - 1});
+    segment_start = boundary;
+  }
+  segments.push_back(TimeSegment{segment_start, end_ns});
+  return segments;
+}
+
 // ============================================================================
 // JSON serialization
 // ============================================================================
@@ -176,6 +265,237 @@ inline std::string toJsonString(const Manifest& m) {
   return j.dump();
 }
 
+// ============================================================================
+// ETags
+// ============================================================================
+
+/// @cond foxglove_internal
+namespace detail {
+// 64-bit FNV-1a hash of the content, as 16 hex digits.
+inline std::string hashHex(std::string_view content) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (char c : content) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  std::string hex(16, '0');
+  for (int i = 0; i < 16; ++i) {
+    hex[15 - i] = kHexDigits[(hash >> (4 * i)) & 0xf];
+  }
+  return hex;
+}
+}  // namespace detail
+/// @endcond
+
+/// @brief Compute a strong ETag for a response body, e.g. a serialized manifest.
+///
+/// The ETag is a quoted hash of the content, so every server instance returns the same ETag for
+/// the same manifest.
+inline std::string computeETag(std::string_view content) {
+  return '"' + detail::hashHex(content) + '"';
+}
+
+/// @brief Check whether the value of an `If-None-Match` request header matches an ETag.
+///
+/// If it does, the server can respond with `304 Not Modified` instead of the manifest. This uses
+/// the weak comparison required for `If-None-Match`, so `W/"..."` tags match too.
+inline bool etagMatches(std::string_view if_none_match, std::string_view etag) {
+  auto trim = [](std::string_view s) {
+    size_t start = s.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+      return std::string_view{};
+    }
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(start, end - start + 1);
+  };
+  auto opaque_tag = [](std::string_view tag) {
+    return tag.substr(0, 2) == "W/" ? tag.substr(2) : tag;
+  };
+  if (trim(if_none_match) == "*") {
+    return true;
+  }
+  while (!if_none_match.empty()) {
+    size_t comma = if_none_match.find(',');
+    std::string_view candidate = trim(if_none_match.substr(0, comma));
+    if (!candidate.empty() && opaque_tag(candidate) == opaque_tag(etag)) {
+      return true;
+    }
+    if (comma == std::string_view::npos) {
+      break;
+    }
+    if_none_match.remove_prefix(comma + 1);
+  }
+  return false;
+}
+
+/// @brief A manifest serialized to JSON, together with its ETag.
+///
+/// Serializing a manifest with many schemas is relatively expensive. If the manifest for a
+/// request doesn't change, serialize it once and cache the result, and answer requests whose
+/// `If-None-Match` header matches @ref etag with `304 Not Modified`.
+struct SerializedManifest {
+  /// @brief The manifest JSON.
+  std::string json;
+  /// @brief A strong ETag for @ref json.
+  std::string etag;
+};
+
+/// @brief Serialize a Manifest to JSON and compute its ETag.
+inline SerializedManifest serializeManifest(const Manifest& m) {
+  SerializedManifest serialized;
+  serialized.json = toJsonString(m);
+  serialized.etag = computeETag(serialized.json);
+  return serialized;
+}
+
+// ============================================================================
+// MCAP file cache
+// ============================================================================
+
+/// @brief Compute a cache key for the data of a source.
+///
+/// The key is a hash of the source's ID (or URL if it has none), time range, topics and schemas,
+/// so it changes whenever any of them do. As with `id`, include a version number in the ID that
+/// you increment whenever you change how the data is generated.
+inline std::string sourceCacheKey(const StreamedSource& source) {
+  std::string content;
+  auto append = [&content](std::string_view field) {
+    content += field;
+    content += '\0';
+  };
+  append(source.id.value_or(source.url));
+  append(source.start_time);
+  append(source.end_time);
+  for (const auto& topic : source.topics) {
+    append(topic.name);
+    append(topic.message_encoding);
+    append(topic.schema_id ? std::to_string(*topic.schema_id) : "");
+  }
+  content += '\0';
+  for (const auto& schema : source.schemas) {
+    append(std::to_string(schema.id));
+    append(schema.name);
+    append(schema.encoding);
+    append(schema.data);
+  }
+  return detail::hashHex(content);
+}
+
+/// @brief An on-disk cache of generated MCAP files.
+///
+/// Generating the data for a source is usually the expensive part of serving it, and the app
+/// requests a source again whenever it seeks. With this cache, each source is generated once,
+/// into a file named after its @ref sourceCacheKey, and later requests are served from that file.
+/// Serving a file also lets the HTTP server answer `Range:` requests.
+///
+/// Concurrent requests for the same source share a single generation: the first request runs
+/// the generator, and the others wait for its result.
+///
+/// The cache never evicts files; remove old files from the directory as needed. The directory
+/// must not be shared with other processes.
+///
+/// @code{.cpp}
+/// static rdl::McapFileCache cache("/var/cache/flights");
+///
+/// auto path = cache.getOrCreate(source, [&](const std::string& path) {
+///   foxglove::McapWriterOptions options;
+///   options.context = foxglove::Context::create();
+///   options.path = path;
+///   // Create the writer and channels, and log the source's messages...
+///   return writer.close();
+/// });
+/// if (path.has_value()) {
+///   res.set_file_content(*path, "application/octet-stream");
+/// }
+/// @endcode
+class McapFileCache {
+public:
+  /// @brief A function which writes an MCAP file to the given path.
+  using Generator = std::function<FoxgloveError(const std::string& path)>;
+
+  /// @brief Create a cache which stores files in `directory`, creating it if needed.
+  explicit McapFileCache(std::filesystem::path directory) : directory_(std::move(directory)) {}
+
+  /// @brief Get the path of the cached MCAP file for a source, generating it if needed.
+  ///
+  /// Returns the generator's error if it fails, or `FoxgloveError::IoError` if the file could not
+  /// be stored. A failed generation is retried by the next request.
+  FoxgloveResult<std::string> getOrCreate(const StreamedSource& source, const Generator& generate) {
+    return getOrCreate(sourceCacheKey(source), generate);
+  }
+
+  /// @brief Get the path of the cached MCAP file for an arbitrary key, generating it if needed.
+  ///
+  /// The key is used as the file name, so it must be a valid file name, such as the result of
+  /// @ref sourceCacheKey.
+  FoxgloveResult<std::string> getOrCreate(const std::string& key, const Generator& generate) {
+    const std::string path = (directory_ / (key + ".mcap")).string();
+    std::promise<FoxgloveResult<std::string>> promise;
+    std::shared_future<FoxgloveResult<std::string>> pending;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = pending_.find(key);
+      if (it != pending_.end()) {
+        pending = it->second;
+      } else {
+        std::error_code ec;
+        if (std::filesystem::exists(path, ec)) {
+          return path;
+        }
+        pending_.emplace(key, promise.get_future().share());
+      }
+    }
+    if (pending.valid()) {
+      return pending.get();
+    }
+
+    FoxgloveResult<std::string> result;
+    try {
+      result = generateFile(path, generate);
+    } catch (...) {
+      finish(key);
+      promise.set_exception(std::current_exception());
+      throw;
+    }
+    finish(key);
+    promise.set_value(result);
+    return result;
+  }
+
+private:
+  FoxgloveResult<std::string> generateFile(const std::string& path, const Generator& generate) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+      return tl::make_unexpected(FoxgloveError::IoError);
+    }
+    // Write to a temporary file and rename it into place, so that the cache never holds a
+    // partial file.
+    const std::string tmp_path = path + ".tmp";
+    FoxgloveError error = generate(tmp_path);
+    if (error == FoxgloveError::Ok) {
+      std::filesystem::rename(tmp_path, path, ec);
+      if (!ec) {
+        return path;
+      }
+      error = FoxgloveError::IoError;
+    }
+    std::filesystem::remove(tmp_path, ec);
+    return tl::make_unexpected(error);
+  }
+
+  void finish(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.erase(key);
+  }
+
+  std::filesystem::path directory_;
+  std::mutex mutex_;
+  // Generations in progress, by key.
+  std::unordered_map<std::string, std::shared_future<FoxgloveResult<std::string>>> pending_;
+};
+
 // ============================================================================
 // ChannelSet
 // ============================================================================
@@ -227,15 +547,26 @@ private:
     return base64::to_base64(sv);
   }
 
-  uint16_t addSchema(const foxglove::Schema& schema) {
-    auto encoded_data = encodeSchemaData(schema);
+  // Schema IDs by name, encoding and raw data, used to deduplicate schemas without encoding them.
+  std::unordered_map<std::string, uint16_t> schema_ids_;
+
+  static std::string schemaKey(const foxglove::Schema& schema) {
+    std::string key;
+    key.reserve(schema.name.size() + schema.encoding.size() + schema.data_len + 2);
+    key += schema.name;
+    key += '\0';
+    key += schema.encoding;
+    key += '\0';
+    key.append(reinterpret_cast<const char*>(schema.data), schema.data_len);
+    return key;
+  }
 
+  uint16_t addSchema(const foxglove::Schema& schema) {
     // Deduplicate: return existing ID if an identical schema was already added.
-    for (const auto& existing : schemas) {
-      if (existing.name == schema.name && existing.encoding == schema.encoding &&
-          existing.data == encoded_data) {
-        return existing.id;
-      }
+    auto key = schemaKey(schema);
+    auto it = schema_ids_.find(key);
+    if (it != schema_ids_.end()) {
+      return it->second;
     }
 
     if (next_schema_id_ == 0) {
@@ -247,8 +578,9 @@ private:
       id,
       schema.name,
       schema.encoding,
-      std::move(encoded_data),
+      encodeSchemaData(schema),
     });
+    schema_ids_.emplace(std::move(key), id);
     return id;
   }
 };
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace foxglove {
+
+/// @brief Options for a ring buffer sink.
+struct RingBufferSinkOptions {
+  /// @brief The context to attach the sink to.
+  Context context;
+  /// @brief How far back from the newest message to keep messages.
+  std::chrono::nanoseconds window = std::chrono::seconds(60);
+  /// @brief Maximum total size of the buffered message data, in bytes. A value of 0 means the
+  /// default of 256 MiB. Messages larger than this are not buffered.
+  size_t max_bytes = 0;
+  /// @brief Options used to write snapshots.
+  ///
+  /// Only the options which control the MCAP format, such as compression and chunk size, are
+  /// used. By default, snapshots are written with the default MCAP options.
+  std::optional<McapWriterOptions> mcap_options;
+  /// @brief Optional channel filter to use for the sink.
+  SinkChannelFilterFn sink_channel_filter;
+};
+
+/// @brief A snapshot of a ring buffer sink which is being written to an MCAP file.
+///
+/// If the snapshot is destroyed without calling wait(), it continues to be written in the
+/// background, and errors are logged.
+class RingBufferSnapshot final {
+public:
+  /// @brief Wait for the snapshot to be written.
+  FoxgloveError wait();
+
+  /// @brief Default move constructor.
+  RingBufferSnapshot(RingBufferSnapshot&&) = default;
+  /// @brief Default move assignment.
+  RingBufferSnapshot& operator=(RingBufferSnapshot&&) = default;
+  ~RingBufferSnapshot() = default;
+
+  RingBufferSnapshot(const RingBufferSnapshot&) = delete;
+  RingBufferSnapshot& operator=(const RingBufferSnapshot&) = delete;
+
+private:
+  friend class RingBufferSink;
+
+  explicit RingBufferSnapshot(foxglove_ring_buffer_snapshot* snapshot);
+
+  std::unique_ptr<foxglove_ring_buffer_snapshot, void (*)(foxglove_ring_buffer_snapshot*)> impl_;
+};
+
+/// @brief A sink which keeps the most recent messages of every channel in memory, so that they
+/// can be written to an MCAP file after an incident.
+///
+/// The sink keeps messages logged within a time window of the newest message, up to a limit on
+/// the total size of the message data, evicting the oldest messages first. When something goes
+/// wrong, such as a failed service call, call snapshot() to save the messages which led up to
+/// it. Logging threads are only blocked while the messages are copied out of the ring buffer;
+/// the file is written on a background thread.
+class RingBufferSink final {
+public:
+  /// @brief Create a ring buffer sink.
+  ///
+  /// @param options The options for the sink.
+  /// @return A new ring buffer sink.
+  static FoxgloveResult<RingBufferSink> create(RingBufferSinkOptions&& options);
+
+  /// @brief Start writing the messages logged within `window` of the newest message to a new
+  /// MCAP file.
+  ///
+  /// Messages logged after this call are not included. The file must not already exist.
+  ///
+  /// @param path The path of the MCAP file.
+  /// @param window How far back from the newest message to include messages.
+  /// @return The snapshot, which can be used to wait for the file to be written.
+  FoxgloveResult<RingBufferSnapshot> snapshot(
+    std::string_view path, std::chrono::nanoseconds window
+  ) const;
+
+  /// @brief The number of messages currently buffered.
+  [[nodiscard]] size_t bufferedMessages() const noexcept;
+
+  /// @brief The total size of the message data currently buffered, in bytes.
+  [[nodiscard]] size_t bufferedBytes() const noexcept;
+
+  /// @brief Stop buffering messages, and release the buffered messages.
+  FoxgloveError close();
+
+  /// @brief Default move constructor.
+  RingBufferSink(RingBufferSink&&) = default;
+  /// @brief Default move assignment.
+  RingBufferSink& operator=(RingBufferSink&&) = default;
+  ~RingBufferSink() = default;
+
+  RingBufferSink(const RingBufferSink&) = delete;
+  RingBufferSink& operator=(const RingBufferSink&) = delete;
+
+private:
+  explicit RingBufferSink(
+    foxglove_ring_buffer_sink* sink, std::unique_ptr<SinkChannelFilterFn> sink_channel_filter
+  );
+
+  std::unique_ptr<SinkChannelFilterFn> sink_channel_filter_;
+  std::unique_ptr<foxglove_ring_buffer_sink, foxglove_error (*)(foxglove_ring_buffer_sink*)> impl_;
+};
+
+}  // namespace foxglove
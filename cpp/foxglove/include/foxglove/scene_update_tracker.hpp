@@ -0,0 +1,91 @@
+#pragma once
+
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/messages.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace foxglove {
+
+/// @brief Logs a scene to a SceneUpdate channel, sending only the entities which changed.
+///
+/// Each call to log() takes the complete set of entities in the scene, keyed by their `id`. The
+/// tracker keeps the encoding of the entities it last logged, and logs a SceneUpdate with only the
+/// entities which were added or whose encoding changed, plus a `SceneEntityDeletion` for each
+/// entity which is no longer in the scene. When the scene changes little between frames, the
+/// logged bandwidth and encoding cost scale with the rate of change rather than the size of the
+/// scene.
+///
+/// Whenever the channel gains a consumer, such as a WebSocket client subscribing or an MCAP writer
+/// being added, the next update contains every entity so the new consumer receives the whole
+/// scene. The number of consumers is sampled on each call to log(), so a consumer which replaces
+/// another between two calls is not noticed; call reset() to force a full update.
+///
+/// While the channel has no consumers, the scene is not encoded or tracked.
+///
+/// @note SceneUpdateTracker is movable but not copyable, and is not thread-safe.
+class SceneUpdateTracker final {
+public:
+  /// @brief Create a tracker which logs to a new SceneUpdate channel.
+  ///
+  /// @param topic The topic name. You should choose a unique topic name per channel for
+  /// compatibility with the Foxglove app.
+  /// @param context The context which associates logs to a sink. If omitted, the default context is
+  /// used.
+  static FoxgloveResult<SceneUpdateTracker> create(
+    const std::string_view& topic, const Context& context = Context()
+  );
+
+  /// @brief Log the changes between the last logged scene and `scene`.
+  ///
+  /// The entities of `scene` replace the tracked scene; entity ids should be unique. The
+  /// deletions of `scene` are ignored, since entities missing from it are deleted. Nothing is
+  /// logged if no entity changed.
+  ///
+  /// @param scene The complete scene.
+  /// @param log_time The timestamp of the update, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  FoxgloveError log(
+    const messages::SceneUpdate& scene, std::optional<uint64_t> log_time = std::nullopt
+  ) noexcept;
+
+  /// @brief Forget the tracked scene, so that the next update contains every entity.
+  void reset() noexcept;
+
+  /// @brief Close the channel.
+  void close() noexcept;
+
+  /// @brief The channel that updates are logged to.
+  [[nodiscard]] const RawChannel& channel() const noexcept {
+    return channel_;
+  }
+
+private:
+  struct TrackedEntity {
+    std::optional<messages::Timestamp> timestamp;
+    std::vector<uint8_t> encoded;
+    // The generation of the last update which contained the entity.
+    uint64_t generation = 0;
+  };
+
+  explicit SceneUpdateTracker(RawChannel channel);
+
+  RawChannel channel_;
+  std::unordered_map<std::string, TrackedEntity> entities_;
+  size_t consumers_ = 0;
+  uint64_t generation_ = 0;
+  // Reused between updates, to avoid allocating on every frame.
+  std::vector<uint8_t> scratch_;
+  std::vector<uint8_t> changed_;
+  std::vector<uint8_t> update_;
+};
+
+}  // namespace foxglove
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace foxglove {
 
@@ -24,4 +26,18 @@ struct Schema {
   size_t data_len = 0;
 };
 
+/// @brief A non-owning view of a Schema.
+///
+/// The referenced data is only valid for the lifetime of the object the view was obtained from.
+struct SchemaView {
+  /// @brief An identifier for the schema.
+  std::string_view name;
+  /// @brief The encoding of the schema data.
+  std::string_view encoding;
+  /// @brief The schema data.
+  const std::byte* data = nullptr;
+  /// @brief The length of the schema data.
+  size_t data_len = 0;
+};
+
 }  // namespace foxglove
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/expected.hpp>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace foxglove {
+
+/// @brief Options for SdkStatsPublisher::create.
+///
+/// All fields are optional. Defaults are documented per field.
+struct SdkStatsOptions final {
+  /// @brief The context whose channels and sinks are reported, and on which the publisher
+  /// creates its channel.
+  ///
+  /// Defaults to the global default context.
+  Context context;
+
+  /// @brief Optional channel topic name.
+  ///
+  /// Defaults to `/foxglove/sdk_stats`.
+  std::optional<std::string> topic;
+
+  /// @brief Optional refresh interval.
+  ///
+  /// Defaults to 1s. Clamped to a minimum of 100ms.
+  std::optional<std::chrono::milliseconds> refresh_interval;
+};
+
+// Keep this comment in sync with rust/foxglove/src/sdk_stats.rs
+
+/// @brief A publisher that periodically logs the SDK's internal performance counters on a
+/// channel.
+///
+/// The publisher creates a channel on the configured Context (defaulting to
+/// `/foxglove/sdk_stats`) and spawns a background task that logs an `SdkStats` message at the
+/// configured interval with the counters of the context's channels and sinks:
+///
+/// - For each channel, the number of messages and bytes logged to its sinks while the publisher
+///   runs.
+/// - For each WebSocket client, the messages and bytes sent to the client, queued for it, and
+///   dropped from its backlog.
+/// - For each MCAP writer, the messages and bytes written, the size of the file after
+///   compression, and the time spent encoding and compressing chunks.
+/// - For each remote access session, the number of video tracks and the bitrate estimated to be
+///   available to them.
+///
+/// Each message is a JSON object with a JSON Schema attached to the channel. Counters are totals,
+/// and each is accompanied by a rate over the most recent refresh interval. The sink counters are
+/// maintained whether or not the publisher is running; channels only count the messages they log
+/// while a publisher reads them, so that logging doesn't otherwise update shared counters.
+///
+/// As with SystemInfoPublisher, destroying this object does **not** stop the publisher. Call
+/// `stop()` explicitly to abort the background task before the process exits.
+///
+/// @note SdkStatsPublisher is movable but not copyable, and is thread-safe.
+class SdkStatsPublisher final {
+public:
+  /// @brief Create and start an SDK stats publisher with the given options.
+  static FoxgloveResult<SdkStatsPublisher> create(SdkStatsOptions&& options = {});
+
+  /// @brief Stop the publisher and free its resources.
+  ///
+  /// Aborts the background task. After calling stop(), the publisher is in an
+  /// empty state and further calls to stop() are no-ops.
+  FoxgloveError stop() noexcept;
+
+private:
+  explicit SdkStatsPublisher(foxglove_sdk_stats_publisher* impl);
+
+  std::unique_ptr<foxglove_sdk_stats_publisher, foxglove_error (*)(foxglove_sdk_stats_publisher*)>
+    impl_;
+};
+
+}  // namespace foxglove
@@ -4,6 +4,8 @@
 #include <foxglove/error.hpp>
 
 #include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -14,6 +16,7 @@
 
 struct foxglove_service;
 struct foxglove_service_message_schema;
+struct foxglove_service_options;
 struct foxglove_service_request;
 struct foxglove_service_responder;
 struct foxglove_service_schema;
@@ -106,6 +109,12 @@ public:
   /// @param message Error message, which must be valid UTF-8.
   void respondError(std::string_view message) && noexcept;
 
+  /// @brief Returns true if the client which made the request has disconnected.
+  ///
+  /// A long-running handler may check this to abandon work whose response would never be
+  /// delivered. It must still respond, but the response is discarded.
+  [[nodiscard]] bool isCancelled() const noexcept;
+
   /// @brief Default destructor.
   ~ServiceResponder() = default;
   /// @brief Default move constructor.
@@ -145,6 +154,43 @@ private:
 using ServiceHandler =
   std::function<void(const ServiceRequest& request, ServiceResponder&& responder)>;
 
+/// @brief Options for dispatching calls to a service.
+///
+/// By default, a service's handler is invoked from the client's main poll loop, and must not
+/// block.
+struct ServiceOptions {
+  /// @brief The number of worker threads dedicated to invoking the service's handler.
+  ///
+  /// If nonzero, the handler is invoked on these threads, and may block without holding up other
+  /// messages from the client. The handler may then be invoked concurrently, and must be
+  /// thread-safe.
+  size_t worker_threads = 0;
+  /// @brief The maximum number of calls to the service which may be in flight at once, across all
+  /// clients. Zero means unlimited.
+  ///
+  /// A call is in flight from when its handler is invoked until it responds. Further calls are
+  /// queued in the order they arrive, and are invoked as in-flight calls complete, on the worker
+  /// threads or on an internal thread if there are none. Queued calls whose client disconnects
+  /// fail without invoking the handler.
+  size_t max_in_flight = 0;
+  /// @brief How long a call may wait in the queue before it fails. Zero means queued calls wait
+  /// indefinitely.
+  std::chrono::milliseconds queue_timeout = std::chrono::milliseconds::zero();
+  /// @brief How long to cache successful responses, for services whose calls are idempotent.
+  /// Zero means responses are not cached.
+  ///
+  /// Calls with the same request encoding and payload, from any client, are answered from the
+  /// cache without invoking the handler. Identical calls which arrive while one is in flight wait
+  /// for its response, which is sent to all of them. Error responses are not cached.
+  std::chrono::milliseconds response_cache_ttl = std::chrono::milliseconds::zero();
+
+private:
+  friend class Service;
+
+  /// @brief Writes the options to the provided C-style struct.
+  void writeTo(foxglove_service_options* c) const noexcept;
+};
+
 /// @brief A service.
 class Service final {
 public:
@@ -163,6 +209,17 @@ public:
     std::string_view name, ServiceSchema& schema, ServiceHandler& handler
   );
 
+  /// @brief Constructs a new service, with options for dispatching calls to it.
+  ///
+  /// @param name Locally unique service name.
+  /// @param schema Service schema.
+  /// @param handler Service handler callback.
+  /// @param options Options for dispatching calls to the service.
+  static FoxgloveResult<Service> create(
+    std::string_view name, ServiceSchema& schema, ServiceHandler& handler,
+    const ServiceOptions& options
+  );
+
   /// @brief Default destructor.
   ~Service() = default;
   /// @brief Default move constructor.
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+namespace foxglove {
+
+/// @brief Options for a shared-memory sink.
+struct SharedMemorySinkOptions {
+  /// @brief The context to attach the sink to.
+  Context context;
+  /// @brief Path of the file backing the ring buffer.
+  ///
+  /// If empty, a file is created under /dev/shm (or the temporary directory) with a name unique
+  /// to the process. The file must not already exist.
+  std::string_view path;
+  /// @brief Size of the ring buffer in bytes. A value of 0 means the default of 64 MiB.
+  size_t capacity = 0;
+  /// @brief Optional channel filter to use for the sink.
+  SinkChannelFilterFn sink_channel_filter;
+};
+
+/// @brief A sink which writes logged messages to a shared-memory ring buffer.
+///
+/// Viewers on the same host read messages from the ring instead of a WebSocket connection,
+/// which avoids serializing large messages such as point clouds and images through the network
+/// stack. Pass the sink to WebSocketServerOptions::shared_memory_sink to advertise it to
+/// clients.
+///
+/// Shared-memory sinks are only supported on Unix platforms.
+class SharedMemorySink final {
+public:
+  /// @brief Create a shared-memory sink.
+  ///
+  /// @param options The options for the sink.
+  /// @return A new shared-memory sink.
+  static FoxgloveResult<SharedMemorySink> create(SharedMemorySinkOptions&& options);
+
+  /// @brief The token which viewers use to open the ring buffer.
+  [[nodiscard]] std::string_view token() const noexcept;
+
+  /// @brief Stop logging to the sink, and remove its backing file.
+  FoxgloveError close();
+
+  /// @brief Default move constructor.
+  SharedMemorySink(SharedMemorySink&&) = default;
+  /// @brief Default move assignment.
+  SharedMemorySink& operator=(SharedMemorySink&&) = default;
+  ~SharedMemorySink() = default;
+
+  SharedMemorySink(const SharedMemorySink&) = delete;
+  SharedMemorySink& operator=(const SharedMemorySink&) = delete;
+
+private:
+  friend class WebSocketServer;
+
+  explicit SharedMemorySink(
+    foxglove_shared_memory_sink* sink, std::unique_ptr<SinkChannelFilterFn> sink_channel_filter
+  );
+
+  std::unique_ptr<SinkChannelFilterFn> sink_channel_filter_;
+  std::unique_ptr<foxglove_shared_memory_sink, foxglove_error (*)(foxglove_shared_memory_sink*)>
+    impl_;
+};
+
+}  // namespace foxglove
@@ -6,12 +6,42 @@
 #include <foxglove/expected.hpp>
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 
 namespace foxglove {
 
+/// @brief The groups of metrics a SystemInfoPublisher can collect.
+///
+/// Only the selected metrics are refreshed on each interval, and the fields of metrics which
+/// are not selected are omitted from each message.
+enum class SystemInfoMetrics : uint32_t {
+  /// No metrics.
+  None = 0,
+  /// Memory and CPU usage of the SDK process: the `process_*` fields.
+  Process = 1 << 0,
+  /// Total CPU usage of the system: `total_cpu_percent` and `total_cpu_cores`.
+  Cpu = 1 << 1,
+  /// CPU usage of each logical CPU: `cpu_percent_per_core`.
+  CpuPerCore = 1 << 2,
+  /// Physical memory and swap usage of the system.
+  Memory = 1 << 3,
+  /// Network throughput, summed over all interfaces: the `network_*` fields.
+  Network = 1 << 4,
+  /// Disk I/O throughput, summed over all disks: the `disk_*` fields.
+  Disk = 1 << 5,
+  /// The SDK's own delivery queues and threads: the `sdk_*` fields.
+  Sdk = 1 << 6,
+};
+
+/// @brief Combine two sets of metrics.
+inline SystemInfoMetrics operator|(SystemInfoMetrics a, SystemInfoMetrics b) {
+  // NOLINTNEXTLINE(clang-analyzer-optin.core.EnumCastOutOfRange)
+  return SystemInfoMetrics(uint32_t(a) | uint32_t(b));
+}
+
 /// @brief Options for SystemInfoPublisher::create.
 ///
 /// All fields are optional. Defaults are documented per field.
@@ -30,6 +60,12 @@ struct SystemInfoOptions final {
   ///
   /// Defaults to 500ms. Clamped to a minimum of 200ms.
   std::optional<std::chrono::milliseconds> refresh_interval;
+
+  /// @brief Optional set of metrics to collect.
+  ///
+  /// Defaults to SystemInfoMetrics::Process, SystemInfoMetrics::Cpu and
+  /// SystemInfoMetrics::Memory.
+  std::optional<SystemInfoMetrics> metrics;
 };
 
 // Keep this comment in sync with rust/foxglove/src/system_info.rs
@@ -43,7 +79,7 @@ struct SystemInfoOptions final {
 /// @par Published metrics
 ///
 /// Each message is a JSON object with a JSON Schema attached to the channel.
-/// The following fields are published:
+/// The following fields are published by default:
 ///
 /// - `process_memory` (number): Resident memory used by the SDK process, in bytes.
 /// - `process_virtual_memory` (number): Virtual memory used by the SDK process, in bytes.
@@ -64,6 +100,21 @@ struct SystemInfoOptions final {
 /// - `kernel_version` (string): Kernel version string, or empty if unknown.
 /// - `os_version` (string): OS version string, or empty if unknown.
 ///
+/// The following fields are only published when their metrics are selected via
+/// SystemInfoOptions::metrics:
+///
+/// - `cpu_percent_per_core` (array of numbers): CPU usage of each logical CPU, as a percent.
+/// - `network_received_bytes_per_sec`, `network_transmitted_bytes_per_sec` (number): Network
+///   throughput, summed over all interfaces.
+/// - `disk_read_bytes_per_sec`, `disk_written_bytes_per_sec` (number): Disk I/O throughput,
+///   summed over all disks.
+/// - `sdk_queued_messages`, `sdk_queued_bytes` (integer): Messages and bytes queued for the
+///   sinks of the context.
+/// - `sdk_sent_messages`, `sdk_sent_bytes`, `sdk_dropped_messages` (integer): Messages and
+///   bytes delivered or dropped by the sinks of the context since they were added.
+/// - `sdk_threads` (array of objects): CPU usage of the process's threads, grouped by thread
+///   name. Only available on Linux, and excludes the main thread.
+///
 /// CPU usage values are computed from the difference between consecutive samples, so they
 /// reflect activity over the most recent refresh interval.
 ///
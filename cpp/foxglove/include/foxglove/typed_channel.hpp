@@ -0,0 +1,218 @@
+#pragma once
+
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/schema.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace foxglove {
+
+/// @brief Describes how messages of type `T` are logged to a TypedChannel.
+///
+/// Specialize this template to log your own types on a TypedChannel. A specialization provides:
+///
+/// - `static constexpr std::string_view message_encoding`, the encoding of logged messages, such
+///   as "json" or "protobuf".
+/// - `static std::optional<Schema> schema()`, the schema of the channel. The schema data is copied
+///   when the channel is created, so it need only remain valid for the duration of the call.
+/// - `static FoxgloveError encode(const T& msg, std::vector<uint8_t>& buf)`, which appends the
+///   encoded message to `buf`.
+///
+/// Messages in the `foxglove::messages` namespace are supported out of the box, and are logged
+/// with protobuf encoding.
+///
+/// The traits are resolved at compile time; there is no virtual dispatch or type erasure on the
+/// logging path. To log the same type with different encodings, pass a traits class as the second
+/// template argument of TypedChannel instead of specializing this template.
+template<typename T, typename Enable = void>
+struct MessageTraits;
+
+/// @brief MessageTraits for the built-in message types, which are encoded as protobuf.
+template<typename T>
+struct MessageTraits<
+  T, std::void_t<
+       decltype(std::declval<const T&>().encode(std::declval<std::vector<uint8_t>&>())),
+       decltype(T::schema())>> {
+  /// @brief The message encoding.
+  static constexpr std::string_view message_encoding = "protobuf";
+
+  /// @brief The schema of the message type.
+  static std::optional<Schema> schema() {
+    return T::schema();
+  }
+
+  /// @brief Append the protobuf encoding of `msg` to `buf`.
+  static FoxgloveError encode(const T& msg, std::vector<uint8_t>& buf) noexcept {
+    return msg.encode(buf);
+  }
+};
+
+/// @brief A channel for logging messages of type `T` to a topic.
+///
+/// The channel's message encoding and schema, and the encoding of each logged message, are given
+/// by `Traits`. Messages are only encoded if a sink would receive them.
+///
+/// @note While channels are fully thread-safe, the logged message is not copied before it is
+/// encoded. Avoid modifying it concurrently or during a log operation.
+template<typename T, typename Traits = MessageTraits<T>>
+class TypedChannel final {
+  static constexpr bool kEncodeIsNoexcept = noexcept(
+    Traits::encode(std::declval<const T&>(), std::declval<std::vector<uint8_t>&>())
+  );
+
+public:
+  /// @brief Create a new channel.
+  ///
+  /// @param topic The topic name. You should choose a unique topic name per channel for
+  /// compatibility with the Foxglove app.
+  /// @param context The context which associates logs to a sink. If omitted, the default context is
+  /// used.
+  static FoxgloveResult<TypedChannel> create(
+    const std::string_view& topic, const Context& context = Context()
+  ) {
+    auto raw = RawChannel::create(topic, Traits::message_encoding, Traits::schema(), context);
+    if (!raw.has_value()) {
+      return tl::unexpected(raw.error());
+    }
+    return TypedChannel(std::move(*raw));
+  }
+
+  /// @brief Log a message to the channel.
+  ///
+  /// @param msg The message to log.
+  /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the
+  /// current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+  FoxgloveError log(
+    const T& msg, std::optional<uint64_t> log_time = std::nullopt,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept(kEncodeIsNoexcept) {
+    // Skip encoding the message if no sink would receive it.
+    if (!foxglove_channel_should_log(raw_.getInner())) {
+      return FoxgloveError::Ok;
+    }
+    std::vector<uint8_t>& buf = encodeBuffer();
+    buf.clear();
+    FoxgloveError error = Traits::encode(msg, buf);
+    if (error != FoxgloveError::Ok) {
+      return error;
+    }
+    return raw_.log(reinterpret_cast<const std::byte*>(buf.data()), buf.size(), log_time, sink_id);
+  }
+
+  /// @brief Log a batch of messages to the channel.
+  ///
+  /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+  /// calling log() once per message when logging many small messages at high rates.
+  ///
+  /// @param msgs The messages to log. May be null when `count == 0`.
+  /// @param count The number of messages.
+  /// @param log_times If non-null, must point to `count` timestamps, as nanoseconds since epoch. If
+  /// null, the current time is used.
+  /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+  FoxgloveError logBatch(
+    const T* msgs, size_t count, const uint64_t* log_times = nullptr,
+    std::optional<uint64_t> sink_id = std::nullopt
+  ) noexcept(kEncodeIsNoexcept) {
+    if (count == 0) {
+      return FoxgloveError::Ok;
+    }
+    if (msgs == nullptr) {
+      return FoxgloveError::ValueError;
+    }
+    if (!foxglove_channel_should_log(raw_.getInner())) {
+      return FoxgloveError::Ok;
+    }
+    std::vector<uint8_t>& buf = encodeBuffer();
+    buf.clear();
+    std::vector<size_t> offsets;
+    offsets.reserve(count + 1);
+    for (size_t i = 0; i < count; ++i) {
+      offsets.push_back(buf.size());
+      FoxgloveError error = Traits::encode(msgs[i], buf);
+      if (error != FoxgloveError::Ok) {
+        return error;
+      }
+    }
+    offsets.push_back(buf.size());
+
+    std::vector<LogItem> items(count);
+    for (size_t i = 0; i < count; ++i) {
+      items[i].data = reinterpret_cast<const std::byte*>(buf.data() + offsets[i]);
+      items[i].data_len = offsets[i + 1] - offsets[i];
+      if (log_times != nullptr) {
+        items[i].log_time = log_times[i];
+      }
+    }
+    return raw_.logBatch(items.data(), count, sink_id);
+  }
+
+  /// @brief Close the channel.
+  ///
+  /// You can use this to explicitly unadvertise the channel to sinks that subscribe to channels
+  /// dynamically, such as the WebSocketServer.
+  ///
+  /// Attempts to log on a closed channel will elicit a throttled warning message.
+  void close() noexcept {
+    raw_.close();
+  }
+
+  /// @brief Bind the channel to another context, so that its sinks also receive the messages.
+  ///
+  /// Each message is encoded and logged once, and dispatched to the sinks of every bound context.
+  /// See RawChannel::bindContext().
+  ///
+  /// @param context The context to bind the channel to.
+  FoxgloveError bindContext(const Context& context) noexcept {
+    return raw_.bindContext(context);
+  }
+
+  /// @brief Uniquely identifies a channel in the context of this program.
+  ///
+  /// @return The ID of the channel.
+  [[nodiscard]] uint64_t id() const noexcept {
+    return raw_.id();
+  }
+
+  /// @brief Get the topic of the channel.
+  ///
+  /// @return The topic of the channel. The value is valid only for the lifetime of the channel.
+  [[nodiscard]] std::string_view topic() const noexcept {
+    return raw_.topic();
+  }
+
+  /// @brief Find out if any sinks are subscribed to the channel.
+  ///
+  /// @return True if sinks are subscribed to the channel, false otherwise.
+  [[nodiscard]] bool hasSinks() const noexcept {
+    return raw_.hasSinks();
+  }
+
+  /// @brief Get the underlying channel, for logging pre-encoded messages.
+  [[nodiscard]] RawChannel& raw() noexcept {
+    return raw_;
+  }
+
+private:
+  explicit TypedChannel(RawChannel&& raw)
+      : raw_(std::move(raw)) {}
+
+  /// Returns a per-thread buffer for encoding messages, which keeps its capacity between calls.
+  static std::vector<uint8_t>& encodeBuffer() {
+    thread_local std::vector<uint8_t> buf;
+    return buf;
+  }
+
+  RawChannel raw_;
+};
+
+}  // namespace foxglove
@@ -10,13 +10,16 @@
 #include <foxglove/playback_control_request.hpp>
 #include <foxglove/playback_state.hpp>
 #include <foxglove/service.hpp>
+#include <foxglove/shared_memory.hpp>
 
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 enum foxglove_error : uint8_t;
 struct foxglove_websocket_server;
@@ -25,6 +28,12 @@ struct foxglove_client;
 
 namespace foxglove {
 
+/// @cond foxglove_internal
+namespace internal {
+class CallbackQueue;
+}
+/// @endcond
+
 /// @brief A channel advertised by a client.
 struct ClientChannel {
   /// @brief The ID of the channel.
@@ -43,6 +52,56 @@ struct ClientChannel {
   size_t schema_len;
 };
 
+/// @brief A message received from a client, whose ownership is passed to
+/// @ref WebSocketServerCallbacks::onMessageDataOwned.
+///
+/// The data shares the buffer the message was received into, so it can be kept, or handed to
+/// another thread, without copying. The buffer is released when this object is destroyed.
+class ClientMessageBuffer final {
+public:
+  /// @cond foxglove_internal
+  explicit ClientMessageBuffer(const foxglove_client_message_buffer& buffer) noexcept
+      : buffer_(buffer) {}
+  /// @endcond
+
+  ClientMessageBuffer(ClientMessageBuffer&& other) noexcept
+      : buffer_(other.buffer_) {
+    other.buffer_.release = nullptr;
+  }
+  ClientMessageBuffer& operator=(ClientMessageBuffer&& other) noexcept {
+    if (this != &other) {
+      reset();
+      buffer_ = other.buffer_;
+      other.buffer_.release = nullptr;
+    }
+    return *this;
+  }
+  ClientMessageBuffer(const ClientMessageBuffer&) = delete;
+  ClientMessageBuffer& operator=(const ClientMessageBuffer&) = delete;
+  ~ClientMessageBuffer() {
+    reset();
+  }
+
+  /// @brief Pointer to the data.
+  [[nodiscard]] const std::byte* data() const noexcept {
+    return reinterpret_cast<const std::byte*>(buffer_.data);
+  }
+  /// @brief Number of bytes.
+  [[nodiscard]] size_t size() const noexcept {
+    return buffer_.len;
+  }
+
+private:
+  void reset() noexcept {
+    if (buffer_.release != nullptr) {
+      buffer_.release(buffer_.release_context);
+      buffer_.release = nullptr;
+    }
+  }
+
+  foxglove_client_message_buffer buffer_;
+};
+
 /// @brief A client connected to the server.
 struct ClientMetadata {
   /// @brief The ID of the client.
@@ -51,11 +110,60 @@ struct ClientMetadata {
   std::optional<uint64_t> sink_id;
 };
 
+/// @brief Delivery counters for the messages logged to one of a client's subscribed channels.
+///
+/// Counters start when the client subscribes to the channel, and are reset if it unsubscribes.
+struct ChannelStats {
+  /// @brief The channel ID.
+  uint64_t channel_id{};
+  /// @brief The number of messages logged to the channel for the client, which is the sequence
+  /// number of the latest message.
+  uint64_t sequence{};
+  /// @brief The number of messages sent to the client.
+  uint64_t sent{};
+  /// @brief The number of messages dropped to keep the client's backlog within its limits.
+  uint64_t dropped{};
+  /// @brief The number of queued messages which were replaced by a newer message of the
+  /// channel, because the subscription is conflated.
+  uint64_t conflated{};
+  /// @brief The number of messages currently queued.
+  size_t queued_messages{};
+  /// @brief The number of bytes currently queued.
+  size_t queued_bytes{};
+  /// @brief The largest number of messages queued at once.
+  size_t max_queued_messages{};
+  /// @brief The largest number of bytes queued at once.
+  size_t max_queued_bytes{};
+};
+
+/// @brief Delivery counters for the data plane messages queued for a client.
+struct ClientStats {
+  /// @brief The ID of the client.
+  uint32_t client_id{};
+  /// @brief The number of messages sent to the client, including messages which were not logged
+  /// to a channel.
+  uint64_t sent{};
+  /// @brief The number of bytes sent to the client.
+  uint64_t sent_bytes{};
+  /// @brief The number of messages dropped to keep the client's backlog within its limits.
+  uint64_t dropped{};
+  /// @brief The number of messages currently queued.
+  size_t queued_messages{};
+  /// @brief The number of bytes currently queued.
+  size_t queued_bytes{};
+  /// @brief The largest number of messages queued at once.
+  size_t max_queued_messages{};
+  /// @brief The largest number of bytes queued at once.
+  size_t max_queued_bytes{};
+  /// @brief Counters for each subscribed channel, ordered by channel ID.
+  std::vector<ChannelStats> channels;
+};
+
 /// @brief The capabilities of a WebSocket server.
 ///
 /// A server may advertise certain capabilities to clients and provide related functionality
 /// in WebSocketServerCallbacks.
-enum class WebSocketServerCapabilities : uint8_t {
+enum class WebSocketServerCapabilities : uint16_t {
   /// No capabilities.
   None = 0,
   /// Allow clients to advertise channels to send data messages to the server.
@@ -79,6 +187,18 @@ enum class WebSocketServerCapabilities : uint8_t {
   /// controls in the Foxglove app. This requires the server to specify the `playback_time_range`
   /// field in its `WebSocketServerOptions`.
   PlaybackControl = 1 << 6,
+  /// Allow clients to receive several messages in each binary frame.
+  ///
+  /// Clients which enable message batches receive the messages queued for them in batches,
+  /// limited by `message_batch_linger` and `message_batch_bytes` in `WebSocketServerOptions`.
+  /// Other clients receive one message per frame.
+  MessageBatches = 1 << 7,
+  /// Allow clients to subscribe to only some fields of each message on a channel.
+  ///
+  /// Each message is projected once for every distinct set of fields requested on its channel.
+  /// Projection is supported for channels with `json` messages, and `protobuf` messages with a
+  /// protobuf schema.
+  FieldProjection = 1 << 8,
 };
 
 /// @brief Level indicator for a server status message.
@@ -91,6 +211,36 @@ enum class WebSocketServerStatusLevel : uint8_t {
   Error = 2,
 };
 
+/// @brief How a client's message backlog makes room when it exceeds its limits.
+enum class BacklogDropPolicy : uint8_t {
+  /// Drop the oldest queued messages, whichever channel they were logged to.
+  DropOldest = 0,
+  /// Drop stale messages from the busiest channels, keeping the latest message of each channel.
+  ///
+  /// When the backlog is full, the oldest message of the channel with the most queued messages
+  /// (or bytes, for the byte limit) is dropped, so that a high-rate topic does not push the
+  /// messages of low-rate topics out of the backlog.
+  KeepLatestPerChannel = 1,
+};
+
+/// @brief Options for delivering the messages of each client subscription.
+struct SubscriptionOptions {
+  /// @brief The maximum rate at which messages are sent for each subscription, in messages per
+  /// second.
+  ///
+  /// Rate-limited subscriptions are conflated: a message logged before the previous message of
+  /// the channel could be sent replaces it, so that the client receives the latest message at
+  /// most this often. Unlimited by default.
+  std::optional<double> max_rate = std::nullopt;
+  /// @brief Whether to conflate the messages of each subscription.
+  ///
+  /// At most one message per subscription is queued for the client, and a newer message replaces
+  /// the queued one. The rate of each subscription then adapts to how fast the client drains its
+  /// queue, so that a client on a slow link receives the latest message of each channel as
+  /// bandwidth frees up, instead of a backlog of stale ones.
+  bool conflate = false;
+};
+
 /// @brief Combine two capabilities.
 inline WebSocketServerCapabilities operator|(
   WebSocketServerCapabilities a, WebSocketServerCapabilities b
@@ -99,14 +249,14 @@ inline WebSocketServerCapabilities operator|(
   // clang-analyzer doesn't yet support exempting enums marked as bitflags. See:
   // https://github.com/llvm/llvm-project/issues/76208
   // NOLINTNEXTLINE(clang-analyzer-optin.core.EnumCastOutOfRange)
-  return WebSocketServerCapabilities(uint8_t(a) | uint8_t(b));
+  return WebSocketServerCapabilities(uint16_t(a) | uint16_t(b));
 }
 
 /// @brief Check if a capability is set.
 inline WebSocketServerCapabilities operator&(
   WebSocketServerCapabilities a, WebSocketServerCapabilities b
 ) {
-  return WebSocketServerCapabilities(uint8_t(a) & uint8_t(b));
+  return WebSocketServerCapabilities(uint16_t(a) & uint16_t(b));
 }
 
 /// @brief The callback interface for a WebSocket server.
@@ -115,7 +265,8 @@ inline WebSocketServerCapabilities operator&(
 /// possible.
 ///
 /// @note These callbacks may be invoked concurrently from multiple threads.
-/// You must synchronize access to your mutable internal state or shared resources.
+/// You must synchronize access to your mutable internal state or shared resources, unless the
+/// server is created with WebSocketServerOptions::poll_callbacks.
 // Suppress -Wdeprecated-declarations for synthesized special members; the
 // field-level [[deprecated]] still warns on direct use.
 #if defined(__GNUC__) || defined(__clang__)
@@ -148,6 +299,13 @@ struct WebSocketServerCallbacks {
     void(uint32_t client_id, uint32_t client_channel_id, const std::byte* data, size_t data_len)>
     onMessageData;
 
+  /// @brief Callback invoked when a client message is received, with ownership of the payload.
+  ///
+  /// Unlike onMessageData, the payload can be kept after the callback returns, without copying
+  /// it. If set, onMessageData is not invoked.
+  std::function<void(uint32_t client_id, uint32_t client_channel_id, ClientMessageBuffer data)>
+    onMessageDataOwned;
+
   /// @brief Callback invoked when a client unadvertises a client channel.
   ///
   /// Requires the capability WebSocketServerCapabilities::ClientPublish
@@ -230,6 +388,19 @@ struct WebSocketServerCallbacks {
 
   /// @brief Callback invoked when a client disconnects from the server.
   std::function<void()> onClientDisconnect;
+
+  /// @brief Callback invoked when messages are dropped from a client's backlog because the
+  /// client can't keep up with the rate at which messages are logged.
+  ///
+  /// The callback is invoked at most once every 100 milliseconds for each client, so the
+  /// counters may include drops since the previous call.
+  ///
+  /// @note Unlike the other callbacks, this is invoked from the thread which logged the message
+  /// that overflowed the backlog, and must not block.
+  ///
+  /// @param stats The client's delivery counters.
+  std::function<void(const ClientStats& stats)> onBackpressure;
+
   /// @brief Callback invoked when a playback control request is sent from the client.
   ///
   /// Requires the capability WebSocketServerCapabilities::PlaybackControl
@@ -287,8 +458,22 @@ struct WebSocketServerOptions {
   std::optional<std::string> session_id = std::nullopt;
   /// @brief A fetch asset handler callback.
   FetchAssetHandler fetch_asset;
+  /// @brief Maximum total size, in bytes, of the successful fetch asset responses to cache in
+  /// memory.
+  ///
+  /// Requests for a cached URI are answered without invoking the fetch asset handler, so that
+  /// reconnecting clients don't cause assets to be read again. The least recently used assets
+  /// are evicted when the cache is full. Cached assets are never refreshed. By default, responses
+  /// are not cached.
+  size_t fetch_asset_cache_bytes = 0;
   /// @brief A sink channel filter callback.
   SinkChannelFilterFn sink_channel_filter;
+  /// @brief Optional filter which runs on each message before it is sent to clients.
+  ///
+  /// Use it to send channels with a different policy than other sinks in the same context, for
+  /// example at a reduced rate while an MCAP writer records every message. The filter runs once
+  /// for each logged message, however many clients are connected.
+  MessageFilterFn message_filter;
   /// @brief A parameter handler.
   ///
   /// When set, this handler takes precedence over the deprecated
@@ -302,10 +487,35 @@ struct WebSocketServerOptions {
   /// required when a handler is supplied; setting only one returns
   /// `FoxgloveError::ValueError` from `WebSocketServer::create`.
   ParameterHandler parameter_handler;
+  /// @brief How long to collect values passed to WebSocketServer::publishParameterValues before
+  /// sending them.
+  ///
+  /// A burst of updates, such as a configuration reload, then results in one message to each
+  /// client, with the latest value of each parameter. By default, values are sent immediately.
+  std::chrono::milliseconds parameter_coalesce_window{0};
+  /// @brief How long to collect connection graph changes before sending them.
+  ///
+  /// Applies to WebSocketServer::publishConnectionGraph and
+  /// WebSocketServer::updateConnectionGraph. A burst of changes, such as many nodes starting at
+  /// once, then results in one update to each subscribed client. By default, changes are sent
+  /// immediately.
+  std::chrono::milliseconds connection_graph_coalesce_window{0};
+  /// @brief Send time and playback state broadcasts at most once per window.
+  ///
+  /// Applies to WebSocketServer::broadcastTime and WebSocketServer::broadcastPlaybackState, so
+  /// that they can be called on every tick of a simulation. The first broadcast after a quiet
+  /// window is sent immediately, and the latest broadcast within the window is sent at its end,
+  /// from the server's own runtime. By default, every broadcast is sent immediately.
+  std::chrono::milliseconds broadcast_coalesce_window{0};
   /// @brief (internal) TLS configuration for the server.
   ///
   /// This option is under active development and may change.
   std::optional<TlsIdentity> tls_identity = std::nullopt;
+  /// @brief (internal) Hand TLS sessions to the kernel once their handshake is complete.
+  ///
+  /// Messages are then encrypted by the kernel as they are written to the socket. Requires
+  /// `tls_identity` and the Linux `tls` kernel module; otherwise the server encrypts in userspace.
+  bool kernel_tls = false;
   /// @cond foxglove_internal
   /// @brief (internal) Information about the server, which is shared with clients.
   ///
@@ -326,6 +536,75 @@ struct WebSocketServerOptions {
   ///
   /// By default, the server buffers 1024 messages per client.
   std::optional<size_t> message_backlog_size = std::nullopt;
+  /// @brief Number of threads used to send messages to clients.
+  ///
+  /// Each message is serialized once and shared by the queues of the clients subscribed to it,
+  /// and each client's queue is written by its own task. By default, those tasks run on the
+  /// SDK's shared runtime. If set, the server creates a dedicated runtime with this many threads,
+  /// so that writes to many clients proceed in parallel.
+  std::optional<size_t> writer_threads = std::nullopt;
+  /// @brief Bind the server's listener with `SO_REUSEPORT`.
+  ///
+  /// Several servers sharing a context can then listen on the same host and port, and the kernel
+  /// distributes incoming connections across them. With writer_threads set, each server accepts
+  /// and writes to its clients on its own threads, so many clients are served in parallel.
+  /// Every server sharing the port must set this option. Only supported on Unix platforms.
+  bool reuse_port = false;
+  /// @brief Maximum number of bytes queued for each client.
+  ///
+  /// When the queued messages exceed this size, messages are dropped according to
+  /// backlog_drop_policy. The most recent message is always queued, even if it is larger than the
+  /// budget. By default, the backlog is only limited by message_backlog_size.
+  std::optional<size_t> message_backlog_bytes = std::nullopt;
+  /// @brief Maximum number of bytes queued for each channel of each client.
+  ///
+  /// When the messages queued on one channel exceed this size, that channel's oldest messages are
+  /// dropped, so that a high-bandwidth channel cannot take up the whole backlog. By default,
+  /// channels are not limited individually.
+  std::optional<size_t> channel_backlog_bytes = std::nullopt;
+  /// @brief How messages are dropped when a client's backlog exceeds its limits.
+  BacklogDropPolicy backlog_drop_policy = BacklogDropPolicy::DropOldest;
+  /// @brief How the messages of each client subscription are delivered.
+  SubscriptionOptions subscription_options;
+  /// @brief Enable the permessage-deflate WebSocket extension.
+  ///
+  /// Clients which offer the extension during the handshake, such as web browsers, receive
+  /// compressed messages, which reduces bandwidth on slow links at the cost of CPU time on the
+  /// server. Small messages are always sent uncompressed.
+  bool compression = false;
+  /// @brief Selects the channels whose messages are compressed, when compression is enabled.
+  ///
+  /// By default, all channels are compressed except those with schemas for data which is already
+  /// compressed, such as foxglove.CompressedImage and foxglove.CompressedVideo.
+  SinkChannelFilterFn compression_filter;
+  /// @brief A shared-memory sink to advertise to clients.
+  ///
+  /// Viewers on the same host can read messages from the sink's ring buffer instead of the
+  /// WebSocket connection. The sink is only referenced while the server starts.
+  const SharedMemorySink* shared_memory_sink = nullptr;
+  /// @brief Queue callbacks, to be invoked by WebSocketServer::pollEvents on your own thread.
+  ///
+  /// By default, callbacks are invoked from the server's threads, possibly concurrently. When
+  /// this is set, the server queues the notification callbacks of WebSocketServerCallbacks, along
+  /// with copies of their arguments, and the requests to the parameter_handler. They are then
+  /// invoked in the order they were received, on the thread which calls pollEvents, so they don't
+  /// need synchronization and can be processed in batches. Service calls can be queued with
+  /// WebSocketServer::polledServiceHandler.
+  ///
+  /// The callbacks which return a value to the server, onGetParameters, onSetParameters, and
+  /// onPlaybackControlRequest, as well as onBackpressure and the fetch_asset handler, are still
+  /// invoked directly.
+  bool poll_callbacks = false;
+  /// @brief How long to wait for more messages to batch with a client's next message.
+  ///
+  /// Applies to clients which enable message batches, when the server has the MessageBatches
+  /// capability. By default, a batch only gathers the messages already queued for the client, so
+  /// batching adds no latency. A small linger trades latency for fewer, larger frames.
+  std::chrono::microseconds message_batch_linger{0};
+  /// @brief Maximum size of a message batch, in bytes.
+  ///
+  /// Larger messages are sent in their own frames. By default, batches are limited to 64 KiB.
+  std::optional<size_t> message_batch_bytes = std::nullopt;
 };
 
 /// @brief A WebSocket server for visualization in Foxglove.
@@ -337,6 +616,8 @@ struct WebSocketServerOptions {
 ///
 /// @note WebSocketServer is fully thread-safe, but WebSocketServerCallbacks may be invoked
 /// concurrently from multiple threads, so you will need to use synchronization in your callbacks.
+/// Alternatively, set WebSocketServerOptions::poll_callbacks and call pollEvents() from your own
+/// thread.
 class WebSocketServer final {
 public:
   /// @brief Create a new WebSocket server with the given options.
@@ -348,19 +629,45 @@ public:
   /// @brief Get the current number of connected clients.
   [[nodiscard]] size_t clientCount() const;
 
+  /// @brief Get a snapshot of the delivery counters of each connected client.
+  ///
+  /// The counters can be polled to export metrics, or to detect clients which are falling
+  /// behind.
+  [[nodiscard]] FoxgloveResult<std::vector<ClientStats>> stats() const;
+
+  /// @brief Invoke the callbacks queued since the last call, on the calling thread.
+  ///
+  /// Requires WebSocketServerOptions::poll_callbacks; otherwise, callbacks are not queued and this
+  /// returns 0. Callbacks are invoked in the order the server received their events. Events
+  /// queued while polling are left for the next call.
+  ///
+  /// @param max_events The maximum number of callbacks to invoke.
+  /// @return The number of callbacks invoked.
+  size_t pollEvents(size_t max_events = std::numeric_limits<size_t>::max());
+
+  /// @brief Wrap a service handler, so that its calls are queued and invoked by pollEvents().
+  ///
+  /// The returned handler is passed to Service::create, and must outlive the service. If the
+  /// server doesn't poll its callbacks, `handler` is returned unchanged.
+  ///
+  /// @param handler The service handler.
+  [[nodiscard]] ServiceHandler polledServiceHandler(ServiceHandler&& handler) const;
+
   /// @brief Gracefully shut down the WebSocket server.
   FoxgloveError stop();
 
   /// @brief Publishes the current server timestamp to all clients.
   ///
-  /// Requires the capability WebSocketServerCapabilities::Time.
+  /// Requires the capability WebSocketServerCapabilities::Time. See
+  /// WebSocketServerOptions::broadcast_coalesce_window to limit the rate of broadcasts.
   ///
   /// @param timestamp_nanos An epoch offset in nanoseconds.
   void broadcastTime(uint64_t timestamp_nanos) const noexcept;
 
   /// @brief Publishes the current playback state to all clients.
   ///
-  /// Requires the capability WebSocketServerCapabilities::PlaybackControl.
+  /// Requires the capability WebSocketServerCapabilities::PlaybackControl. See
+  /// WebSocketServerOptions::broadcast_coalesce_window to limit the rate of broadcasts.
   ///
   /// @param playback_state The playback state to publish.
   void broadcastPlaybackState(const PlaybackState& playback_state) const noexcept;
@@ -405,9 +712,19 @@ public:
   ///
   /// Requires the capability WebSocketServerCapabilities::Parameters.
   ///
+  /// Each client is only sent the values it has not already been sent. See
+  /// WebSocketServerOptions::parameter_coalesce_window to combine bursts of updates.
+  ///
   /// @param params Updated parameters.
   void publishParameterValues(std::vector<Parameter>&& params);
 
+  /// @brief Publishes parameter values to all subscribed clients.
+  ///
+  /// This overload accepts an array from ParameterArrayBuilder.
+  ///
+  /// @param params Updated parameters.
+  void publishParameterValues(ParameterArray&& params);
+
   /// @brief Publish a connection graph to all subscribed clients.
   ///
   /// @param graph The connection graph to publish.
@@ -415,6 +732,17 @@ public:
   /// This requires the capability WebSocketServerCapabilities::ConnectionGraph
   void publishConnectionGraph(ConnectionGraph& graph);
 
+  /// @brief Apply a patch to the published connection graph, and send the changes to all
+  /// subscribed clients.
+  ///
+  /// Unlike publishConnectionGraph, this does not require the complete graph, and only the
+  /// topics and services named in the patch are compared with the published graph.
+  ///
+  /// This requires the capability WebSocketServerCapabilities::ConnectionGraph
+  ///
+  /// @param patch The changes to apply. The patch is consumed.
+  FoxgloveError updateConnectionGraph(ConnectionGraphPatch&& patch);
+
   /// @brief Publishes a status message to all clients.
   ///
   /// The server may send this message at any time. Client developers may use it
@@ -443,13 +771,19 @@ private:
     foxglove_websocket_server* server, std::unique_ptr<WebSocketServerCallbacks> callbacks,
     std::unique_ptr<FetchAssetHandler> fetch_asset,
     std::unique_ptr<SinkChannelFilterFn> sink_channel_filter,
-    std::unique_ptr<ParameterHandler> parameter_handler
+    std::unique_ptr<SinkChannelFilterFn> compression_filter,
+    std::unique_ptr<ParameterHandler> parameter_handler,
+    std::unique_ptr<MessageFilterFn> message_filter,
+    std::shared_ptr<internal::CallbackQueue> callback_queue
   );
 
   std::unique_ptr<WebSocketServerCallbacks> callbacks_;
   std::unique_ptr<FetchAssetHandler> fetch_asset_;
   std::unique_ptr<SinkChannelFilterFn> sink_channel_filter_;
+  std::unique_ptr<SinkChannelFilterFn> compression_filter_;
   std::unique_ptr<ParameterHandler> parameter_handler_;
+  std::unique_ptr<MessageFilterFn> message_filter_;
+  std::shared_ptr<internal::CallbackQueue> callback_queue_;
   std::unique_ptr<foxglove_websocket_server, foxglove_error (*)(foxglove_websocket_server*)> impl_;
 };
 
@@ -7,6 +7,8 @@
 #include <foxglove/parameter.hpp>
 #include <foxglove/parameter_handler.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string_view>
 #include <utility>
@@ -45,6 +47,26 @@ bool forwardSinkChannelFilter(const void* context, const foxglove_channel_descri
   }
 }
 
+bool forwardMessageFilter(
+  const void* context, const foxglove_channel_descriptor* channel, const uint8_t* data,
+  size_t data_len, uint64_t log_time, foxglove_message_filter_output* output
+) {
+  if (context == nullptr) {
+    return true;
+  }
+  try {
+    const auto* filter = static_cast<const MessageFilterFn*>(context);
+    auto cpp_channel = ChannelDescriptor(channel);
+    MessageFilterOutput cpp_output(output);
+    return (*filter)(
+      cpp_channel, reinterpret_cast<const std::byte*>(data), data_len, log_time, cpp_output
+    );
+  } catch (const std::exception& exc) {
+    warn() << "Message filter failed: " << exc.what();
+    return false;
+  }
+}
+
 void forwardParameterHandlerGet(
   const void* context, uint32_t client_id, const foxglove_string* c_request_id,
   const foxglove_string* c_param_names, size_t param_names_len,
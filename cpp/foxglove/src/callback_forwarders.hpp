@@ -38,6 +38,9 @@ struct ForwarderAccess {
   static foxglove_parameter_array* releaseParameterArray(ParameterArray& a) {
     return a.release();
   }
+  static const foxglove_channel_descriptor* rawChannelDescriptor(const ChannelDescriptor& c) {
+    return c.channel_descriptor_;
+  }
 };
 
 /// try/catch wrapper for callback bodies. Catches std::exception so an
@@ -60,6 +63,11 @@ void forwardFetchAsset(
 
 bool forwardSinkChannelFilter(const void* context, const foxglove_channel_descriptor* channel);
 
+bool forwardMessageFilter(
+  const void* context, const foxglove_channel_descriptor* channel, const uint8_t* data,
+  size_t data_len, uint64_t log_time, foxglove_message_filter_output* output
+);
+
 void forwardParameterHandlerGet(
   const void* context, uint32_t client_id, const foxglove_string* c_request_id,
   const foxglove_string* c_param_names, size_t param_names_len,
@@ -211,10 +219,26 @@ void wireSinkChannelFilter(
     return;
   }
   out = std::make_unique<SinkChannelFilterFn>(std::move(cpp_handler));
+  if (const auto* topic_filter = out->topicFilter()) {
+    c_options.topic_filter = topic_filter->getInner();
+    return;
+  }
   c_options.sink_channel_filter_context = out.get();
   c_options.sink_channel_filter = &forwardSinkChannelFilter;
 }
 
+template<class COptions>
+void wireMessageFilter(
+  COptions& c_options, MessageFilterFn&& cpp_filter, std::unique_ptr<MessageFilterFn>& out
+) {
+  if (!cpp_filter) {
+    return;
+  }
+  out = std::make_unique<MessageFilterFn>(std::move(cpp_filter));
+  c_options.message_filter_context = out.get();
+  c_options.message_filter = &forwardMessageFilter;
+}
+
 /// Validate and wire a ParameterHandler. Returns ValueError if exactly one of
 /// onGet/onSet is set. If both are unset, leaves c_options.parameter_handler
 /// untouched and returns Ok.
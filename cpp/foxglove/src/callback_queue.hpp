@@ -0,0 +1,184 @@
+#pragma once
+
+/// @cond foxglove_internal
+
+#include <foxglove/parameter.hpp>
+#include <foxglove/parameter_handler.hpp>
+#include <foxglove/service.hpp>
+
+#include "callback_forwarders.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace foxglove::internal {
+
+/// Callback events queued by the server's threads, and invoked by the thread which polls them.
+///
+/// Events own copies of their arguments, since the buffers passed to the forwarders are only
+/// valid for the duration of the forwarded call.
+class CallbackQueue final {
+public:
+  void push(std::function<void()> event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back(std::move(event));
+  }
+
+  /// Invokes up to `max_events` events, in the order they were queued, and returns the number
+  /// invoked. The lock is not held while invoking events, so they may be queued concurrently.
+  size_t poll(size_t max_events) {
+    std::vector<std::function<void()>> batch;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto end = events_.begin() + static_cast<std::ptrdiff_t>(std::min(max_events, events_.size()));
+      batch.reserve(static_cast<size_t>(end - events_.begin()));
+      std::move(events_.begin(), end, std::back_inserter(batch));
+      events_.erase(events_.begin(), end);
+    }
+    for (auto& event : batch) {
+      event();
+    }
+    return batch.size();
+  }
+
+private:
+  std::mutex mutex_;
+  std::deque<std::function<void()>> events_;
+};
+
+/// Returns a callback which queues calls to `callback`, with copies of their arguments, or an
+/// empty callback if `callback` is empty. The arguments must not borrow from the caller.
+template<class... Args>
+std::function<void(Args...)> queueCalls(
+  const std::shared_ptr<CallbackQueue>& queue, const char* name,
+  std::function<void(Args...)>&& callback
+) {
+  if (!callback) {
+    return nullptr;
+  }
+  auto target = std::make_shared<std::function<void(Args...)>>(std::move(callback));
+  return [queue, name, target](Args... args) {
+    queue->push([name, target, args = std::make_tuple(std::decay_t<Args>(args)...)] {
+      callbackGuard(name, [&] {
+        std::apply(*target, args);
+      });
+    });
+  };
+}
+
+/// Like queueCalls, for the callbacks which are passed a list of parameter names.
+inline std::function<void(const std::vector<std::string_view>&)> queueParameterNameCalls(
+  const std::shared_ptr<CallbackQueue>& queue, const char* name,
+  std::function<void(const std::vector<std::string_view>&)>&& callback
+) {
+  if (!callback) {
+    return nullptr;
+  }
+  auto target =
+    std::make_shared<std::function<void(const std::vector<std::string_view>&)>>(std::move(callback)
+    );
+  return [queue, name, target](const std::vector<std::string_view>& param_names) {
+    std::vector<std::string> names(param_names.begin(), param_names.end());
+    queue->push([name, target, names = std::move(names)] {
+      callbackGuard(name, [&] {
+        (*target)(std::vector<std::string_view>(names.begin(), names.end()));
+      });
+    });
+  };
+}
+
+/// Returns a parameter handler which queues the requests to `handler`.
+inline ParameterHandler queueParameterHandler(
+  const std::shared_ptr<CallbackQueue>& queue, ParameterHandler&& handler
+) {
+  ParameterHandler queued;
+  if (handler.onGet) {
+    auto on_get = std::make_shared<decltype(handler.onGet)>(std::move(handler.onGet));
+    queued.onGet = [queue, on_get](
+                     uint32_t client_id, std::optional<std::string_view> request_id,
+                     const std::vector<std::string_view>& param_names,
+                     GetParametersResponder&& responder
+                   ) {
+      std::optional<std::string> id(request_id);
+      std::vector<std::string> names(param_names.begin(), param_names.end());
+      auto shared_responder = std::make_shared<GetParametersResponder>(std::move(responder));
+      queue->push([on_get, client_id, id = std::move(id), names = std::move(names), shared_responder] {
+        callbackGuard("onGet", [&] {
+          (*on_get)(
+            client_id,
+            id ? std::optional<std::string_view>(*id) : std::nullopt,
+            std::vector<std::string_view>(names.begin(), names.end()),
+            std::move(*shared_responder)
+          );
+        });
+      });
+    };
+  }
+  if (handler.onSet) {
+    auto on_set = std::make_shared<decltype(handler.onSet)>(std::move(handler.onSet));
+    queued.onSet = [queue, on_set](
+                     uint32_t client_id, std::optional<std::string_view> request_id,
+                     const std::vector<ParameterView>& params, SetParametersResponder&& responder
+                   ) {
+      std::optional<std::string> id(request_id);
+      // Parameters are move-only, so they are shared with the queued event.
+      auto owned = std::make_shared<std::vector<Parameter>>();
+      owned->reserve(params.size());
+      for (const auto& param : params) {
+        owned->push_back(param.clone());
+      }
+      auto shared_responder = std::make_shared<SetParametersResponder>(std::move(responder));
+      queue->push([on_set, client_id, id = std::move(id), owned, shared_responder] {
+        callbackGuard("onSet", [&] {
+          std::vector<ParameterView> views;
+          views.reserve(owned->size());
+          for (const auto& param : *owned) {
+            views.push_back(param.view());
+          }
+          (*on_set)(
+            client_id,
+            id ? std::optional<std::string_view>(*id) : std::nullopt,
+            views,
+            std::move(*shared_responder)
+          );
+        });
+      });
+    };
+  }
+  return queued;
+}
+
+/// Returns a service handler which queues the calls to `handler`.
+inline ServiceHandler queueServiceCalls(
+  const std::shared_ptr<CallbackQueue>& queue, ServiceHandler&& handler
+) {
+  if (!handler) {
+    return nullptr;
+  }
+  auto target = std::make_shared<ServiceHandler>(std::move(handler));
+  return [queue, target](const ServiceRequest& request, ServiceResponder&& responder) {
+    auto shared_responder = std::make_shared<ServiceResponder>(std::move(responder));
+    queue->push([target, request, shared_responder] {
+      callbackGuard("Service handler", [&] {
+        (*target)(request, std::move(*shared_responder));
+      });
+    });
+  };
+}
+
+}  // namespace foxglove::internal
+
+/// @endcond
@@ -3,6 +3,9 @@
 #include <foxglove/context.hpp>
 #include <foxglove/error.hpp>
 
+#include <cmath>
+#include <vector>
+
 namespace foxglove {
 
 /// @cond foxglove_internal
@@ -10,6 +13,29 @@ ChannelDescriptor::ChannelDescriptor(const foxglove_channel_descriptor* channel_
     : channel_descriptor_(channel_descriptor) {}
 /// @endcond
 
+ChannelMetadataView::Iterator::Iterator(const foxglove_channel_descriptor* channel_descriptor
+) noexcept
+    : channel_descriptor_(channel_descriptor) {
+  foxglove_key_value item{};
+  if (foxglove_channel_descriptor_metadata_next(channel_descriptor_, {nullptr, 0}, &item)) {
+    entry_ = {{item.key.data, item.key.len}, {item.value.data, item.value.len}};
+  } else {
+    channel_descriptor_ = nullptr;
+  }
+}
+
+ChannelMetadataView::Iterator& ChannelMetadataView::Iterator::operator++() noexcept {
+  foxglove_key_value item{};
+  if (foxglove_channel_descriptor_metadata_next(
+        channel_descriptor_, {entry_.first.data(), entry_.first.size()}, &item
+      )) {
+    entry_ = {{item.key.data, item.key.len}, {item.value.data, item.value.len}};
+  } else {
+    *this = Iterator();
+  }
+  return *this;
+}
+
 uint64_t ChannelDescriptor::id() const noexcept {
   return foxglove_channel_descriptor_get_id(channel_descriptor_);
 }
@@ -42,6 +68,35 @@ std::optional<std::map<std::string, std::string>> ChannelDescriptor::metadata()
   return metadata;
 }
 
+ChannelMetadataView ChannelDescriptor::metadataView() const noexcept {
+  return ChannelMetadataView(channel_descriptor_);
+}
+
+std::optional<std::string_view> ChannelDescriptor::metadataValue(std::string_view key
+) const noexcept {
+  foxglove_string value = {};
+  if (!foxglove_channel_descriptor_get_metadata_value(
+        channel_descriptor_, {key.data(), key.size()}, &value
+      )) {
+    return std::nullopt;
+  }
+  return std::string_view(value.data, value.len);
+}
+
+std::optional<SchemaView> ChannelDescriptor::schemaView() const noexcept {
+  foxglove_schema c_schema = {};
+  foxglove_error error = foxglove_channel_descriptor_get_schema(channel_descriptor_, &c_schema);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK) {
+    return std::nullopt;
+  }
+  SchemaView schema;
+  schema.name = std::string_view(c_schema.name.data, c_schema.name.len);
+  schema.encoding = std::string_view(c_schema.encoding.data, c_schema.encoding.len);
+  schema.data = reinterpret_cast<const std::byte*>(c_schema.data);
+  schema.data_len = c_schema.data_len;
+  return schema;
+}
+
 std::optional<Schema> ChannelDescriptor::schema() const noexcept {
   foxglove_schema c_schema = {};
   foxglove_error error = foxglove_channel_descriptor_get_schema(channel_descriptor_, &c_schema);
@@ -57,10 +112,49 @@ std::optional<Schema> ChannelDescriptor::schema() const noexcept {
   return schema;
 }
 
+FoxgloveResult<TopicFilter> TopicFilter::create(const TopicFilterOptions& options) {
+  auto to_c = [](const std::vector<std::string>& patterns) {
+    std::vector<foxglove_string> c_patterns;
+    c_patterns.reserve(patterns.size());
+    for (const auto& pattern : patterns) {
+      c_patterns.push_back({pattern.data(), pattern.length()});
+    }
+    return c_patterns;
+  };
+  auto include_globs = to_c(options.include_globs);
+  auto include_regexes = to_c(options.include_regexes);
+  auto exclude_globs = to_c(options.exclude_globs);
+  auto exclude_regexes = to_c(options.exclude_regexes);
+
+  foxglove_topic_filter_options c_options = {};
+  c_options.include_globs = include_globs.data();
+  c_options.include_globs_count = include_globs.size();
+  c_options.include_regexes = include_regexes.data();
+  c_options.include_regexes_count = include_regexes.size();
+  c_options.exclude_globs = exclude_globs.data();
+  c_options.exclude_globs_count = exclude_globs.size();
+  c_options.exclude_regexes = exclude_regexes.data();
+  c_options.exclude_regexes_count = exclude_regexes.size();
+
+  foxglove_topic_filter* filter = nullptr;
+  foxglove_error error = foxglove_topic_filter_create(&c_options, &filter);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || filter == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return TopicFilter(filter);
+}
+
+TopicFilter::TopicFilter(foxglove_topic_filter* impl)
+    : impl_(impl, foxglove_topic_filter_free) {}
+
+bool TopicFilter::matches(std::string_view topic) const noexcept {
+  return foxglove_topic_filter_matches(impl_.get(), {topic.data(), topic.size()});
+}
+
 FoxgloveResult<RawChannel> RawChannel::create(
   const std::string_view& topic, const std::string_view& message_encoding,
   std::optional<Schema> schema, const Context& context,
-  std::optional<std::map<std::string, std::string>> metadata
+  std::optional<std::map<std::string, std::string>> metadata, size_t keep_last
 ) {
   foxglove_schema c_schema = {};
   if (schema) {
@@ -83,20 +177,80 @@ FoxgloveResult<RawChannel> RawChannel::create(
   }
 
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_raw_channel_create(
-    {topic.data(), topic.length()},
-    {message_encoding.data(), message_encoding.length()},
-    schema ? &c_schema : nullptr,
-    context.getInner(),
-    metadata ? &c_metadata : nullptr,
-    &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_raw_channel_create(
+      {topic.data(), topic.length()},
+      {message_encoding.data(), message_encoding.length()},
+      schema ? &c_schema : nullptr,
+      context.getInner(),
+      metadata ? &c_metadata : nullptr,
+      &channel
+    );
+  } else {
+    // Only channel specs carry the number of retained messages.
+    foxglove_channel_spec spec = {};
+    spec.topic = {topic.data(), topic.length()};
+    spec.message_encoding = {message_encoding.data(), message_encoding.length()};
+    spec.schema = schema ? &c_schema : nullptr;
+    spec.metadata = metadata ? &c_metadata : nullptr;
+    spec.keep_last = keep_last;
+    error = foxglove_raw_channels_create(&spec, 1, context.getInner(), &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
   return {RawChannel(channel)};
 }
 
+FoxgloveResult<std::vector<RawChannel>> Context::createChannels(
+  const std::vector<ChannelSpec>& specs
+) const {
+  // The C specs point into these, so they must be fully populated before any pointers are taken.
+  std::vector<foxglove_schema> c_schemas(specs.size());
+  std::vector<foxglove_channel_metadata> c_metadata(specs.size());
+  std::vector<std::vector<foxglove_key_value>> metadata_items(specs.size());
+  std::vector<foxglove_channel_spec> c_specs(specs.size());
+  for (size_t i = 0; i < specs.size(); ++i) {
+    const auto& spec = specs[i];
+    auto& c_spec = c_specs[i];
+    c_spec.topic = {spec.topic.data(), spec.topic.length()};
+    c_spec.message_encoding = {spec.message_encoding.data(), spec.message_encoding.length()};
+    if (spec.schema) {
+      auto& c_schema = c_schemas[i];
+      c_schema.name = {spec.schema->name.data(), spec.schema->name.length()};
+      c_schema.encoding = {spec.schema->encoding.data(), spec.schema->encoding.length()};
+      c_schema.data = reinterpret_cast<const uint8_t*>(spec.schema->data);
+      c_schema.data_len = spec.schema->data_len;
+      c_spec.schema = &c_schema;
+    }
+    if (spec.metadata) {
+      auto& items = metadata_items[i];
+      items.reserve(spec.metadata->size());
+      for (const auto& [key, value] : *spec.metadata) {
+        items.push_back({{key.data(), key.length()}, {value.data(), value.length()}});
+      }
+      c_metadata[i].items = items.data();
+      c_metadata[i].count = items.size();
+      c_spec.metadata = &c_metadata[i];
+    }
+    c_spec.keep_last = spec.keep_last;
+  }
+
+  std::vector<const foxglove_channel*> c_channels(specs.size(), nullptr);
+  foxglove_error error =
+    foxglove_raw_channels_create(c_specs.data(), c_specs.size(), getInner(), c_channels.data());
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK) {
+    return tl::unexpected(FoxgloveError(error));
+  }
+  std::vector<RawChannel> channels;
+  channels.reserve(c_channels.size());
+  for (const auto* channel : c_channels) {
+    channels.push_back(RawChannel(channel));
+  }
+  return channels;
+}
+
 RawChannel::RawChannel(const foxglove_channel* channel)
     : impl_(channel) {}
 
@@ -104,6 +258,10 @@ void RawChannel::close() noexcept {
   foxglove_channel_close(impl_.get());
 }
 
+FoxgloveError RawChannel::bindContext(const Context& context) noexcept {
+  return FoxgloveError(foxglove_channel_bind_context(impl_.get(), context.getInner()));
+}
+
 uint64_t RawChannel::id() const noexcept {
   return foxglove_channel_get_id(impl_.get());
 }
@@ -122,6 +280,18 @@ bool RawChannel::hasSinks() const noexcept {
   return foxglove_channel_has_sinks(impl_.get());
 }
 
+ChannelDemand RawChannel::demand() const noexcept {
+  foxglove_channel_demand c_demand = foxglove_channel_get_demand(impl_.get());
+  ChannelDemand demand;
+  demand.consumers = c_demand.consumers;
+  if (std::isinf(c_demand.max_rate)) {
+    demand.max_rate = std::nullopt;
+  } else {
+    demand.max_rate = c_demand.max_rate;
+  }
+  return demand;
+}
+
 std::optional<Schema> RawChannel::schema() const noexcept {
   foxglove_schema c_schema = {};
   foxglove_error error = foxglove_channel_get_schema(impl_.get(), &c_schema);
@@ -168,4 +338,45 @@ FoxgloveError RawChannel::log(
   );
   return FoxgloveError(error);
 }
+
+FoxgloveError RawChannel::logShared(
+  std::shared_ptr<const void> owner, const std::byte* data, size_t data_len,
+  std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  auto* release_context = new std::shared_ptr<const void>(std::move(owner));
+  foxglove_error error = foxglove_channel_log_shared(
+    impl_.get(),
+    reinterpret_cast<const uint8_t*>(data),
+    data_len,
+    release_context,
+    [](void* context) {
+      delete static_cast<std::shared_ptr<const void>*>(context);
+    },
+    log_time ? &*log_time : nullptr,
+    sink_id ? *sink_id : 0
+  );
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK) {
+    // The buffer is only released through the callback if it was logged.
+    delete release_context;
+  }
+  return FoxgloveError(error);
+}
+
+FoxgloveError RawChannel::logBatch(
+  const LogItem* items, size_t count, std::optional<uint64_t> sink_id
+) noexcept {
+  std::vector<foxglove_log_item> c_items;
+  c_items.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const LogItem& item = items[i];
+    c_items.push_back(
+      {reinterpret_cast<const uint8_t*>(item.data),
+       item.data_len,
+       item.log_time ? &*item.log_time : nullptr}
+    );
+  }
+  foxglove_error error =
+    foxglove_channel_log_batch(impl_.get(), c_items.data(), c_items.size(), sink_id ? *sink_id : 0);
+  return FoxgloveError(error);
+}
 }  // namespace foxglove
@@ -0,0 +1,21 @@
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/clock.hpp>
+
+#include <algorithm>
+
+namespace foxglove {
+
+SimClock::SimClock(uint64_t start_ns)
+    : impl_(foxglove_sim_clock_new(start_ns), foxglove_sim_clock_free) {}
+
+void SimClock::setTime(uint64_t time_ns) const noexcept {
+  foxglove_sim_clock_set_time(impl_.get(), time_ns);
+}
+
+void SimClock::advance(std::chrono::nanoseconds duration) const noexcept {
+  foxglove_sim_clock_advance(
+    impl_.get(), static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0))
+  );
+}
+
+}  // namespace foxglove
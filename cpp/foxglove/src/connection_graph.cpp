@@ -56,4 +56,63 @@ FoxgloveError ConnectionGraph::setAdvertisedService(
   return FoxgloveError(err);
 }
 
+namespace {
+
+std::vector<foxglove_string> toCStrings(const std::vector<std::string>& strings) {
+  std::vector<foxglove_string> result;
+  result.reserve(strings.size());
+  for (const auto& str : strings) {
+    result.push_back({str.c_str(), str.length()});
+  }
+  return result;
+}
+
+}  // namespace
+
+ConnectionGraphPatch::ConnectionGraphPatch()
+    : impl_(nullptr, foxglove_connection_graph_patch_free) {
+  foxglove_connection_graph_patch* impl = nullptr;
+  foxglove_connection_graph_patch_create(&impl);
+  impl_.reset(impl);
+}
+
+FoxgloveError ConnectionGraphPatch::setPublishedTopic(
+  std::string_view topic, const std::vector<std::string>& publisher_ids
+) {
+  auto ids = toCStrings(publisher_ids);
+  return FoxgloveError(foxglove_connection_graph_patch_set_published_topic(
+    impl_.get(), {topic.data(), topic.length()}, ids.data(), ids.size()
+  ));
+}
+
+FoxgloveError ConnectionGraphPatch::setSubscribedTopic(
+  std::string_view topic, const std::vector<std::string>& subscriber_ids
+) {
+  auto ids = toCStrings(subscriber_ids);
+  return FoxgloveError(foxglove_connection_graph_patch_set_subscribed_topic(
+    impl_.get(), {topic.data(), topic.length()}, ids.data(), ids.size()
+  ));
+}
+
+FoxgloveError ConnectionGraphPatch::setAdvertisedService(
+  std::string_view service, const std::vector<std::string>& provider_ids
+) {
+  auto ids = toCStrings(provider_ids);
+  return FoxgloveError(foxglove_connection_graph_patch_set_advertised_service(
+    impl_.get(), {service.data(), service.length()}, ids.data(), ids.size()
+  ));
+}
+
+FoxgloveError ConnectionGraphPatch::removeTopic(std::string_view topic) {
+  return FoxgloveError(
+    foxglove_connection_graph_patch_remove_topic(impl_.get(), {topic.data(), topic.length()})
+  );
+}
+
+FoxgloveError ConnectionGraphPatch::removeService(std::string_view service) {
+  return FoxgloveError(
+    foxglove_connection_graph_patch_remove_service(impl_.get(), {service.data(), service.length()})
+  );
+}
+
 }  // namespace foxglove
@@ -1,4 +1,5 @@
 #include <foxglove-c/foxglove-c.h>
+#include <foxglove/clock.hpp>
 #include <foxglove/context.hpp>
 
 namespace foxglove {
@@ -10,4 +11,63 @@ Context Context::create() {
   return Context(foxglove_context_new());
 }
 
+void Context::setClock(const SimClock& clock) const {
+  foxglove_context_set_sim_clock(impl_.get(), clock.impl_.get());
+}
+
+void Context::resetClock() const noexcept {
+  foxglove_context_set_sim_clock(impl_.get(), nullptr);
+}
+
+uint64_t Context::now() const noexcept {
+  return foxglove_context_now(impl_.get());
+}
+
+void Context::setMemoryBudget(const std::optional<MemoryBudget>& budget) const noexcept {
+  if (!budget) {
+    foxglove_context_set_memory_budget(impl_.get(), nullptr);
+    return;
+  }
+  // In the C API, a share of zero leaves the pool limited only by the total budget.
+  foxglove_memory_budget c_budget = {};
+  c_budget.bytes = budget->bytes;
+  c_budget.websocket_share = budget->websocket_share.value_or(0.0);
+  c_budget.remote_access_share = budget->remote_access_share.value_or(0.0);
+  c_budget.mcap_share = budget->mcap_share.value_or(0.0);
+  foxglove_context_set_memory_budget(impl_.get(), &c_budget);
+}
+
+namespace {
+
+std::optional<size_t> limitFromC(size_t limit) {
+  if (limit == 0) {
+    return std::nullopt;
+  }
+  return limit;
+}
+
+MemoryPoolUsage poolUsageFromC(const foxglove_memory_pool_usage& usage) {
+  MemoryPoolUsage result;
+  result.bytes = usage.bytes;
+  result.peak_bytes = usage.peak_bytes;
+  result.limit = limitFromC(usage.limit);
+  result.dropped = usage.dropped;
+  return result;
+}
+
+}  // namespace
+
+MemoryUsage Context::memoryUsage() const noexcept {
+  foxglove_memory_usage c_usage = {};
+  foxglove_context_memory_usage(impl_.get(), &c_usage);
+  MemoryUsage usage;
+  usage.bytes = c_usage.bytes;
+  usage.peak_bytes = c_usage.peak_bytes;
+  usage.limit = limitFromC(c_usage.limit);
+  usage.websocket = poolUsageFromC(c_usage.websocket);
+  usage.remote_access = poolUsageFromC(c_usage.remote_access);
+  usage.mcap = poolUsageFromC(c_usage.mcap);
+  return usage;
+}
+
 }  // namespace foxglove
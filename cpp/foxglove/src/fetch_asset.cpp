@@ -1,6 +1,8 @@
 #include <foxglove-c/foxglove-c.h>
 #include <foxglove/fetch_asset.hpp>
 
+#include "callback_forwarders.hpp"
+
 using namespace std::string_view_literals;
 
 namespace foxglove {
@@ -23,4 +25,40 @@ void FetchAssetResponder::respondError(std::string_view message) && noexcept {
   foxglove_fetch_asset_respond_error(ptr, {message.data(), message.length()});
 }
 
+void FetchAssetResponder::append(const std::byte* data, size_t size) & noexcept {
+  if (impl_) {
+    foxglove_fetch_asset_append(impl_.get(), {reinterpret_cast<const uint8_t*>(data), size});
+  }
+}
+
+void FetchAssetResponder::finish() && noexcept {
+  auto* ptr = impl_.release();
+  foxglove_fetch_asset_respond_finish(ptr);
+}
+
+FoxgloveResult<FetchAssetHandler> fileAssetHandler(const std::vector<FileAssetRoot>& roots) {
+  std::vector<foxglove_file_asset_root> c_roots;
+  c_roots.reserve(roots.size());
+  for (const auto& root : roots) {
+    c_roots.push_back(
+      {{root.uri_prefix.data(), root.uri_prefix.length()},
+       {root.directory.data(), root.directory.length()}}
+    );
+  }
+
+  foxglove_file_asset_handler* ptr = nullptr;
+  foxglove_error error = foxglove_file_asset_handler_create(c_roots.data(), c_roots.size(), &ptr);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || ptr == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  std::shared_ptr<foxglove_file_asset_handler> handler(ptr, foxglove_file_asset_handler_free);
+  return [handler](std::string_view uri, FetchAssetResponder&& responder) {
+    foxglove_file_asset_handler_fetch(
+      handler.get(),
+      {uri.data(), uri.length()},
+      internal::ForwarderAccess::releaseFetchAsset(responder)
+    );
+  };
+}
+
 }  // namespace foxglove
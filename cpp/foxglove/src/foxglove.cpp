@@ -7,6 +7,21 @@ void setLogLevel(LogLevel level) {
   foxglove_set_log_level(static_cast<foxglove_logging_level>(level));
 }
 
+FoxgloveError setRuntimeOptions(const RuntimeOptions& options) {
+  foxglove_runtime_options c_options = {};
+  c_options.worker_threads = options.worker_threads.value_or(0);
+  foxglove_string thread_name = {};
+  if (options.thread_name) {
+    thread_name = {options.thread_name->data(), options.thread_name->size()};
+    c_options.thread_name = &thread_name;
+  }
+  c_options.cpu_affinity = options.cpu_affinity.data();
+  c_options.cpu_affinity_count = options.cpu_affinity.size();
+  c_options.set_nice = options.nice.has_value();
+  c_options.nice = options.nice.value_or(0);
+  return FoxgloveError(foxglove_set_runtime_options(&c_options));
+}
+
 namespace internal {
 
 void setLibraryIdentifierPrefix(std::string_view prefix) {
@@ -0,0 +1,436 @@
+#include <foxglove/error.hpp>
+#include <foxglove/image.hpp>
+#include <foxglove/messages.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FOXGLOVE_IMAGE_SSE2
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define FOXGLOVE_IMAGE_SSSE3
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FOXGLOVE_IMAGE_NEON
+#endif
+
+namespace foxglove {
+
+namespace {
+
+constexpr size_t kRgbPixelSize = 3;
+
+/// The validated layout of a frame.
+struct FrameLayout {
+  /// The length of each row, in bytes.
+  size_t step = 0;
+  /// The number of bytes in each row which hold pixel data.
+  size_t row_len = 0;
+};
+
+/// Validates a frame's dimensions against its format and data length, and returns its layout.
+std::optional<FrameLayout> validateFrame(const ImageFrame& frame) {
+  if (frame.data == nullptr || frame.width == 0 || frame.height == 0) {
+    return std::nullopt;
+  }
+  const size_t width = frame.width;
+  const size_t height = frame.height;
+  FrameLayout layout;
+  size_t rows = height;
+  switch (frame.format) {
+    case PixelFormat::Rgb8:
+    case PixelFormat::Bgr8:
+      layout.row_len = width * kRgbPixelSize;
+      break;
+    case PixelFormat::Yuyv:
+      if (width % 2 != 0) {
+        return std::nullopt;
+      }
+      layout.row_len = width * 2;
+      break;
+    case PixelFormat::Nv12:
+      if (width % 2 != 0 || height % 2 != 0) {
+        return std::nullopt;
+      }
+      layout.row_len = width;
+      rows = height + (height / 2);
+      break;
+    default:
+      return std::nullopt;
+  }
+  layout.step = frame.step == 0 ? layout.row_len : frame.step;
+  if (layout.step < layout.row_len ||
+      frame.data_len < (layout.step * (rows - 1)) + layout.row_len) {
+    return std::nullopt;
+  }
+  return layout;
+}
+
+/// Swaps the first and third byte of each 3-byte pixel, converting between BGR and RGB. `src` and
+/// `dst` may be the same buffer.
+void swapRedBlue(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+#if defined(FOXGLOVE_IMAGE_SSSE3)
+  // Each iteration swizzles the four pixels in the first 12 bytes of a 16-byte block, and writes
+  // the last 4 bytes back unchanged; they are swizzled by the next iteration.
+  const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15);
+  for (; (i * kRgbPixelSize) + 16 <= pixels * kRgbPixelSize; i += 4) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (i * kRgbPixelSize)));
+    _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(dst + (i * kRgbPixelSize)), _mm_shuffle_epi8(v, shuffle)
+    );
+  }
+#elif defined(FOXGLOVE_IMAGE_NEON)
+  for (; i + 16 <= pixels; i += 16) {
+    uint8x16x3_t v = vld3q_u8(src + (i * kRgbPixelSize));
+    const uint8x16_t red = v.val[0];
+    v.val[0] = v.val[2];
+    v.val[2] = red;
+    vst3q_u8(dst + (i * kRgbPixelSize), v);
+  }
+#endif
+  for (; i < pixels; ++i) {
+    const uint8_t* s = src + (i * kRgbPixelSize);
+    uint8_t* d = dst + (i * kRgbPixelSize);
+    const uint8_t first = s[0];
+    d[0] = s[2];
+    d[1] = s[1];
+    d[2] = first;
+  }
+}
+
+uint8_t clampToByte(int value) {
+  return static_cast<uint8_t>(std::clamp(value, 0, 255));
+}
+
+/// Converts a BT.601 limited range YUV pixel to RGB, with 8-bit fixed point coefficients.
+void yuvToRgb(int y, int u, int v, uint8_t* dst) {
+  const int c = (298 * (y - 16)) + 128;
+  const int d = u - 128;
+  const int e = v - 128;
+  dst[0] = clampToByte((c + (409 * e)) >> 8);
+  dst[1] = clampToByte((c - (100 * d) - (208 * e)) >> 8);
+  dst[2] = clampToByte((c + (516 * d)) >> 8);
+}
+
+void yuyvToRgb(
+  const uint8_t* src, const FrameLayout& layout, const ImageFrame& frame, uint8_t* dst
+) {
+  for (size_t row = 0; row < frame.height; ++row) {
+    const uint8_t* s = src + (row * layout.step);
+    uint8_t* d = dst + (row * frame.width * kRgbPixelSize);
+    for (size_t x = 0; x < frame.width; x += 2) {
+      const uint8_t* yuyv = s + (x * 2);
+      yuvToRgb(yuyv[0], yuyv[1], yuyv[3], d + (x * kRgbPixelSize));
+      yuvToRgb(yuyv[2], yuyv[1], yuyv[3], d + ((x + 1) * kRgbPixelSize));
+    }
+  }
+}
+
+void nv12ToRgb(
+  const uint8_t* src, const FrameLayout& layout, const ImageFrame& frame, uint8_t* dst
+) {
+  const uint8_t* uv_plane = src + (layout.step * frame.height);
+  for (size_t row = 0; row < frame.height; ++row) {
+    const uint8_t* y_row = src + (row * layout.step);
+    const uint8_t* uv_row = uv_plane + ((row / 2) * layout.step);
+    uint8_t* d = dst + (row * frame.width * kRgbPixelSize);
+    for (size_t x = 0; x < frame.width; x += 2) {
+      const uint8_t u = uv_row[x];
+      const uint8_t v = uv_row[x + 1];
+      yuvToRgb(y_row[x], u, v, d + (x * kRgbPixelSize));
+      yuvToRgb(y_row[x + 1], u, v, d + ((x + 1) * kRgbPixelSize));
+    }
+  }
+}
+
+/// Adds each byte of a row to the corresponding 16-bit sum.
+void accumulateRow(const uint8_t* src, uint16_t* sums, size_t len) {
+  size_t i = 0;
+#if defined(FOXGLOVE_IMAGE_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= len; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    auto* lo = reinterpret_cast<__m128i*>(sums + i);
+    auto* hi = reinterpret_cast<__m128i*>(sums + i + 8);
+    _mm_storeu_si128(lo, _mm_add_epi16(_mm_loadu_si128(lo), _mm_unpacklo_epi8(v, zero)));
+    _mm_storeu_si128(hi, _mm_add_epi16(_mm_loadu_si128(hi), _mm_unpackhi_epi8(v, zero)));
+  }
+#elif defined(FOXGLOVE_IMAGE_NEON)
+  for (; i + 16 <= len; i += 16) {
+    const uint8x16_t v = vld1q_u8(src + i);
+    vst1q_u16(sums + i, vaddw_u8(vld1q_u16(sums + i), vget_low_u8(v)));
+    vst1q_u16(sums + i + 8, vaddw_u8(vld1q_u16(sums + i + 8), vget_high_u8(v)));
+  }
+#endif
+  for (; i < len; ++i) {
+    sums[i] = static_cast<uint16_t>(sums[i] + src[i]);
+  }
+}
+
+/// Averages each `factor` x `factor` block of 3-byte pixels. The channel order is preserved.
+void downscale(
+  const uint8_t* src, size_t src_step, uint32_t out_width, uint32_t out_height, uint32_t factor,
+  uint8_t* dst, std::vector<uint16_t>& sums
+) {
+  const size_t row_len = static_cast<size_t>(out_width) * factor * kRgbPixelSize;
+  const int shift = factor == 2 ? 2 : 4;
+  const int round = 1 << (shift - 1);
+  sums.resize(row_len);
+  for (size_t out_row = 0; out_row < out_height; ++out_row) {
+    std::fill(sums.begin(), sums.end(), 0);
+    for (size_t k = 0; k < factor; ++k) {
+      accumulateRow(src + (((out_row * factor) + k) * src_step), sums.data(), row_len);
+    }
+    uint8_t* d = dst + (out_row * out_width * kRgbPixelSize);
+    for (size_t x = 0; x < out_width; ++x) {
+      const uint16_t* block = sums.data() + (x * factor * kRgbPixelSize);
+      for (size_t c = 0; c < kRgbPixelSize; ++c) {
+        int sum = 0;
+        for (size_t j = 0; j < factor; ++j) {
+          sum += block[(j * kRgbPixelSize) + c];
+        }
+        d[(x * kRgbPixelSize) + c] = static_cast<uint8_t>((sum + round) >> shift);
+      }
+    }
+  }
+}
+
+uint64_t nowNanos() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch()
+  )
+                                 .count());
+}
+
+}  // namespace
+
+FoxgloveError RawImageBuilder::convert(const ImageFrame& frame, uint32_t downscale) {
+  if (downscale != 1 && downscale != 2 && downscale != 4) {
+    return FoxgloveError::ValueError;
+  }
+  auto layout = validateFrame(frame);
+  if (!layout) {
+    return FoxgloveError::ValueError;
+  }
+  const uint32_t out_width = frame.width / downscale;
+  const uint32_t out_height = frame.height / downscale;
+  if (out_width == 0 || out_height == 0) {
+    return FoxgloveError::ValueError;
+  }
+
+  const auto* src = reinterpret_cast<const uint8_t*>(frame.data);
+  const size_t out_row_len = static_cast<size_t>(out_width) * kRgbPixelSize;
+  data_.resize(out_row_len * out_height);
+  width_ = out_width;
+  height_ = out_height;
+  auto* dst = reinterpret_cast<uint8_t*>(data_.data());
+
+  if (frame.format == PixelFormat::Rgb8 || frame.format == PixelFormat::Bgr8) {
+    // Downscale before swizzling, so that only the output pixels are swizzled.
+    if (downscale == 1) {
+      for (size_t row = 0; row < out_height; ++row) {
+        std::memcpy(dst + (row * out_row_len), src + (row * layout->step), out_row_len);
+      }
+    } else {
+      foxglove::downscale(src, layout->step, out_width, out_height, downscale, dst, row_sums_);
+    }
+    if (frame.format == PixelFormat::Bgr8) {
+      swapRedBlue(dst, dst, static_cast<size_t>(out_width) * out_height);
+    }
+    return FoxgloveError::Ok;
+  }
+
+  // Convert YUV at full resolution, directly into the output if it isn't downscaled.
+  uint8_t* rgb = dst;
+  if (downscale != 1) {
+    rgb_.resize(static_cast<size_t>(frame.width) * frame.height * kRgbPixelSize);
+    rgb = reinterpret_cast<uint8_t*>(rgb_.data());
+  }
+  if (frame.format == PixelFormat::Yuyv) {
+    yuyvToRgb(src, *layout, frame, rgb);
+  } else {
+    nv12ToRgb(src, *layout, frame, rgb);
+  }
+  if (downscale != 1) {
+    foxglove::downscale(
+      rgb, static_cast<size_t>(frame.width) * kRgbPixelSize, out_width, out_height, downscale, dst,
+      row_sums_
+    );
+  }
+  return FoxgloveError::Ok;
+}
+
+messages::RawImageView RawImageBuilder::view() const {
+  messages::RawImageView view;
+  view.width = width_;
+  view.height = height_;
+  view.encoding = "rgb8";
+  view.step = width_ * static_cast<uint32_t>(kRgbPixelSize);
+  view.data = data_.data();
+  view.data_len = data_.size();
+  return view;
+}
+
+struct ImagePublisher::Impl {
+  Impl(
+    messages::RawImageChannel full, messages::RawImageChannel preview,
+    ImagePublisherOptions options
+  )
+      : full(std::move(full))
+      , preview(std::move(preview))
+      , options(std::move(options)) {}
+
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+  Impl(Impl&&) = delete;
+  Impl& operator=(Impl&&) = delete;
+
+  ~Impl() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    cv.notify_all();
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  void start() {
+    worker = std::thread([this] {
+      run();
+    });
+  }
+
+  FoxgloveError publish(const ImageFrame& frame, std::optional<uint64_t> log_time) {
+    if (frame.data == nullptr) {
+      return FoxgloveError::ValueError;
+    }
+    // Skip copying the frame if no sink would receive either resolution.
+    if (!full.hasSinks() && !preview.hasSinks()) {
+      return FoxgloveError::Ok;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending_data.assign(frame.data, frame.data + frame.data_len);
+      pending_frame = frame;
+      pending_log_time = log_time.value_or(nowNanos());
+      has_pending = true;
+    }
+    cv.notify_one();
+    return FoxgloveError::Ok;
+  }
+
+  void run() {
+    std::vector<std::byte> data;
+    while (true) {
+      ImageFrame frame;
+      uint64_t log_time = 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] {
+          return stopping || has_pending;
+        });
+        if (stopping) {
+          return;
+        }
+        // Swap buffers, so that both keep their capacity.
+        std::swap(data, pending_data);
+        frame = pending_frame;
+        log_time = pending_log_time;
+        has_pending = false;
+      }
+      frame.data = data.data();
+      logImage(full, full_builder, frame, 1, log_time);
+      logImage(preview, preview_builder, frame, options.preview_downscale, log_time);
+    }
+  }
+
+  void logImage(
+    messages::RawImageChannel& channel, RawImageBuilder& builder, const ImageFrame& frame,
+    uint32_t downscale, uint64_t log_time
+  ) {
+    if (!channel.hasSinks() || builder.convert(frame, downscale) != FoxgloveError::Ok) {
+      return;
+    }
+    auto view = builder.view();
+    view.frame_id = options.frame_id;
+    messages::Timestamp timestamp;
+    timestamp.sec = static_cast<uint32_t>(log_time / 1000000000);
+    timestamp.nsec = static_cast<uint32_t>(log_time % 1000000000);
+    view.timestamp = timestamp;
+    channel.log(view, log_time);
+  }
+
+  messages::RawImageChannel full;
+  messages::RawImageChannel preview;
+  ImagePublisherOptions options;
+  // Used only by the worker thread.
+  RawImageBuilder full_builder;
+  RawImageBuilder preview_builder;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::byte> pending_data;
+  ImageFrame pending_frame;
+  uint64_t pending_log_time = 0;
+  bool has_pending = false;
+  bool stopping = false;
+  std::thread worker;
+};
+
+FoxgloveResult<ImagePublisher> ImagePublisher::create(ImagePublisherOptions options) {
+  if (options.preview_downscale != 2 && options.preview_downscale != 4) {
+    return tl::unexpected(FoxgloveError::ValueError);
+  }
+  if (options.preview_topic.empty()) {
+    options.preview_topic = options.topic + "/preview";
+  }
+  auto full = messages::RawImageChannel::create(options.topic, options.context);
+  if (!full.has_value()) {
+    return tl::unexpected(full.error());
+  }
+  auto preview = messages::RawImageChannel::create(options.preview_topic, options.context);
+  if (!preview.has_value()) {
+    return tl::unexpected(preview.error());
+  }
+  auto impl = std::make_unique<Impl>(std::move(*full), std::move(*preview), std::move(options));
+  impl->start();
+  return ImagePublisher(std::move(impl));
+}
+
+ImagePublisher::ImagePublisher(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+
+ImagePublisher::~ImagePublisher() = default;
+ImagePublisher::ImagePublisher(ImagePublisher&& other) noexcept = default;
+ImagePublisher& ImagePublisher::operator=(ImagePublisher&& other) noexcept = default;
+
+FoxgloveError ImagePublisher::publish(const ImageFrame& frame, std::optional<uint64_t> log_time) {
+  if (!validateFrame(frame)) {
+    return FoxgloveError::ValueError;
+  }
+  return impl_->publish(frame, log_time);
+}
+
+uint64_t ImagePublisher::id() const noexcept {
+  return impl_->full.id();
+}
+
+uint64_t ImagePublisher::previewId() const noexcept {
+  return impl_->preview.id();
+}
+
+}  // namespace foxglove
@@ -0,0 +1,63 @@
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/error.hpp>
+#include <foxglove/latency.hpp>
+
+namespace foxglove {
+
+FoxgloveResult<LatencyTracer> LatencyTracer::install(const LatencyTracerOptions& options) {
+  foxglove_internal_register_cpp_wrapper();
+
+  foxglove_latency_tracer_options c_options = {};
+  c_options.sample_every = options.sample_every;
+  c_options.trace_capacity = options.trace_capacity;
+
+  foxglove_latency_tracer* tracer = nullptr;
+  foxglove_error error = foxglove_latency_tracer_install(&c_options, &tracer);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || tracer == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return LatencyTracer(tracer);
+}
+
+LatencyTracer::LatencyTracer(foxglove_latency_tracer* impl)
+    : impl_(impl, foxglove_latency_tracer_free) {}
+
+FoxgloveResult<std::vector<LatencyStats>> LatencyTracer::stats() const {
+  foxglove_latency_stats_snapshot* c_stats = nullptr;
+  foxglove_error error = foxglove_latency_tracer_get_stats(impl_.get(), &c_stats);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || c_stats == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  std::unique_ptr<foxglove_latency_stats_snapshot, void (*)(foxglove_latency_stats_snapshot*)>
+    guard(c_stats, foxglove_latency_stats_free);
+  size_t count = 0;
+  const foxglove_latency_stats* entries = foxglove_latency_stats_entries(c_stats, &count);
+  std::vector<LatencyStats> result;
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const auto& entry = entries[i];
+    LatencyStats stats;
+    stats.sink_id = entry.sink_id;
+    stats.channel_id = entry.channel_id;
+    stats.stage = static_cast<LatencyStage>(entry.stage);
+    stats.count = entry.count;
+    stats.p50 = std::chrono::nanoseconds(entry.p50_ns);
+    stats.p99 = std::chrono::nanoseconds(entry.p99_ns);
+    stats.p999 = std::chrono::nanoseconds(entry.p999_ns);
+    stats.max = std::chrono::nanoseconds(entry.max_ns);
+    result.push_back(stats);
+  }
+  return result;
+}
+
+FoxgloveError LatencyTracer::writeChromeTrace(std::string_view path) const {
+  foxglove_error error =
+    foxglove_latency_tracer_write_chrome_trace(impl_.get(), {path.data(), path.size()});
+  return static_cast<FoxgloveError>(error);
+}
+
+void LatencyTracer::clear() const noexcept {
+  foxglove_latency_tracer_clear(impl_.get());
+}
+
+}  // namespace foxglove
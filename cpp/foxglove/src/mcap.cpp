@@ -2,6 +2,11 @@
 #include <foxglove/context.hpp>
 #include <foxglove/error.hpp>
 
+#include <algorithm>
+#include <cerrno>
+#include <istream>
+
+#include "callback_forwarders.hpp"
 #include "mcap_internal.hpp"
 
 namespace foxglove {
@@ -21,6 +26,55 @@ static size_t customWrite(void* fn, const uint8_t* data, size_t len, int32_t* er
   return writer->write(data, len, error);
 }
 
+static size_t readAttachmentData(void* context, uint8_t* buffer, size_t len, int32_t* error) {
+  auto* stream = static_cast<std::istream*>(context);
+  stream->read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(len));
+  if (stream->bad()) {
+    *error = EIO;
+    return 0;
+  }
+  return static_cast<size_t>(stream->gcount());
+}
+
+static bool compressionPolicy(
+  const void* context, const foxglove_channel_descriptor* channel,
+  foxglove_mcap_chunk_compression* compression
+) {
+  try {
+    const auto* policy = static_cast<const McapCompressionPolicyFn*>(context);
+    auto chosen = (*policy)(ChannelDescriptor(channel));
+    if (!chosen) {
+      return false;
+    }
+    compression->compression = static_cast<foxglove_mcap_compression>(chosen->compression);
+    compression->level = chosen->level;
+    return true;
+  } catch (const std::exception& exc) {
+    warn() << "MCAP compression policy failed: " << exc.what();
+    return false;
+  }
+}
+
+static uint32_t channelGroup(const void* context, const foxglove_channel_descriptor* channel) {
+  try {
+    const auto* group = static_cast<const McapChannelGroupFn*>(context);
+    return (*group)(ChannelDescriptor(channel));
+  } catch (const std::exception& exc) {
+    warn() << "MCAP channel group function failed: " << exc.what();
+    return 0;
+  }
+}
+
+static size_t customWritev(void* fn, const foxglove_bytes* iov, size_t iovcnt, int32_t* error) {
+  auto* writer = static_cast<CustomWriter*>(fn);
+  return writer->writev(iov, iovcnt, error);
+}
+
+static int customWriteOwned(void* fn, foxglove_mcap_buffer buffer) {
+  auto* writer = static_cast<CustomWriter*>(fn);
+  return writer->write_owned(McapBuffer(buffer));
+}
+
 /// @cond foxglove_internal
 foxglove_mcap_options to_c_mcap_options(const McapWriterOptions& options) {
   foxglove_mcap_options c_options = foxglove_mcap_options_default();
@@ -49,6 +103,30 @@ foxglove_mcap_options to_c_mcap_options(const McapWriterOptions& options) {
   c_options.compression_threads =
     options.compression_threads.value_or(FOXGLOVE_MCAP_COMPRESSION_THREADS_DEFAULT);
   c_options.truncate = options.truncate;
+  c_options.async_writes = options.async_writes;
+  c_options.async_queue_capacity = options.async_queue_capacity;
+  c_options.async_overflow_policy =
+    static_cast<foxglove_mcap_overflow_policy>(options.async_overflow_policy);
+  c_options.pipeline_depth = options.pipeline_depth;
+  c_options.rotation_max_bytes = options.rotation_max_bytes;
+  if (options.rotation_max_duration) {
+    c_options.rotation_max_duration_ms =
+      static_cast<uint64_t>(std::max<int64_t>(options.rotation_max_duration->count(), 0));
+  }
+  c_options.direct_io = options.direct_io;
+  if (options.checkpoint_interval) {
+    c_options.checkpoint_interval_ms =
+      static_cast<uint64_t>(std::max<int64_t>(options.checkpoint_interval->count(), 0));
+  }
+  c_options.zstd_dictionary_training_messages = options.zstd_dictionary_training_messages;
+  c_options.zstd_dictionary_max_size = options.zstd_dictionary_max_size;
+  c_options.zstd_dictionary_level = options.zstd_dictionary_level;
+  c_options.preallocate_bytes = options.preallocate_bytes;
+  c_options.sparse_index_every_messages = options.sparse_index_every_messages;
+  if (options.sparse_index_interval) {
+    c_options.sparse_index_every_ns =
+      static_cast<uint64_t>(std::max<int64_t>(options.sparse_index_interval->count(), 0));
+  }
   return c_options;
 }
 /// @endcond
@@ -64,33 +142,36 @@ FoxgloveResult<McapWriter> McapWriter::create(const McapWriterOptions& options)
   if (options.custom_writer.has_value()) {
     custom_writer = std::make_unique<CustomWriter>(options.custom_writer.value());
     c_custom_writer.context = custom_writer.get();
-    c_custom_writer.write_fn = customWrite;
+    c_custom_writer.write_fn = custom_writer->write ? customWrite : nullptr;
     c_custom_writer.flush_fn = customFlush;
     c_custom_writer.seek_fn = customSeek;
+    c_custom_writer.writev_fn = custom_writer->writev ? customWritev : nullptr;
+    c_custom_writer.write_owned_fn = custom_writer->write_owned ? customWriteOwned : nullptr;
     c_options.custom_writer = &c_custom_writer;
   }
 
-  // Handle sink channel filter with context
   std::unique_ptr<SinkChannelFilterFn> sink_channel_filter;
-  if (options.sink_channel_filter) {
-    // Create a wrapper to hold the function
-    sink_channel_filter = std::make_unique<SinkChannelFilterFn>(options.sink_channel_filter);
-
-    c_options.sink_channel_filter_context = sink_channel_filter.get();
-    c_options.sink_channel_filter =
-      [](const void* context, const struct foxglove_channel_descriptor* channel) -> bool {
-      try {
-        if (!context) {
-          return true;
-        }
-        const auto* filter_func = static_cast<const SinkChannelFilterFn*>(context);
-        auto cpp_channel = ChannelDescriptor(channel);
-        return (*filter_func)(cpp_channel);
-      } catch (const std::exception& exc) {
-        warn() << "Sink channel filter failed: " << exc.what();
-        return false;
-      }
-    };
+  internal::wireSinkChannelFilter(
+    c_options, SinkChannelFilterFn(options.sink_channel_filter), sink_channel_filter
+  );
+
+  std::unique_ptr<MessageFilterFn> message_filter;
+  internal::wireMessageFilter(c_options, MessageFilterFn(options.message_filter), message_filter);
+
+  std::unique_ptr<McapCompressionPolicyFn> compression_policy;
+  if (options.compression_policy) {
+    compression_policy = std::make_unique<McapCompressionPolicyFn>(options.compression_policy);
+
+    c_options.compression_policy_context = compression_policy.get();
+    c_options.compression_policy = compressionPolicy;
+  }
+
+  std::unique_ptr<McapChannelGroupFn> channel_group;
+  if (options.channel_group) {
+    channel_group = std::make_unique<McapChannelGroupFn>(options.channel_group);
+
+    c_options.channel_group_context = channel_group.get();
+    c_options.channel_group = channelGroup;
   }
 
   foxglove_mcap_writer* writer = nullptr;
@@ -99,15 +180,28 @@ FoxgloveResult<McapWriter> McapWriter::create(const McapWriterOptions& options)
     return tl::unexpected(static_cast<FoxgloveError>(error));
   }
 
-  return McapWriter(writer, std::move(sink_channel_filter), std::move(custom_writer));
+  return McapWriter(
+    writer,
+    std::move(sink_channel_filter),
+    std::move(custom_writer),
+    std::move(compression_policy),
+    std::move(message_filter),
+    std::move(channel_group)
+  );
 }
 
 McapWriter::McapWriter(
   foxglove_mcap_writer* writer, std::unique_ptr<SinkChannelFilterFn> sink_channel_filter,
-  std::unique_ptr<CustomWriter> custom_writer
+  std::unique_ptr<CustomWriter> custom_writer,
+  std::unique_ptr<McapCompressionPolicyFn> compression_policy,
+  std::unique_ptr<MessageFilterFn> message_filter,
+  std::unique_ptr<McapChannelGroupFn> channel_group
 )
     : sink_channel_filter_(std::move(sink_channel_filter))
     , custom_writer_(std::move(custom_writer))
+    , compression_policy_(std::move(compression_policy))
+    , message_filter_(std::move(message_filter))
+    , channel_group_(std::move(channel_group))
     , impl_(writer, foxglove_mcap_close) {}
 
 FoxgloveError McapWriter::close() {
@@ -120,6 +214,23 @@ FoxgloveError McapWriter::flush() {
   return FoxgloveError(error);
 }
 
+FoxgloveResult<McapWriterStats> McapWriter::stats() const {
+  foxglove_mcap_writer_stats c_stats{};
+  foxglove_error error = foxglove_mcap_get_stats(impl_.get(), &c_stats);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return McapWriterStats{c_stats.queue_depth, c_stats.dropped_messages};
+}
+
+std::optional<uint64_t> McapWriter::sinkId() const {
+  uint64_t id = foxglove_mcap_sink_id(impl_.get());
+  if (id == 0) {
+    return std::nullopt;
+  }
+  return id;
+}
+
 FoxgloveError McapWriter::attach(const Attachment& attachment) {
   foxglove_mcap_attachment c_attachment;
   c_attachment.log_time = attachment.log_time;
@@ -133,4 +244,24 @@ FoxgloveError McapWriter::attach(const Attachment& attachment) {
   return FoxgloveError(error);
 }
 
+FoxgloveError McapWriter::attach(const Attachment& attachment, std::istream& data) {
+  foxglove_mcap_attachment c_attachment;
+  c_attachment.log_time = attachment.log_time;
+  c_attachment.create_time = attachment.create_time;
+  c_attachment.name = {attachment.name.data(), attachment.name.length()};
+  c_attachment.media_type = {attachment.media_type.data(), attachment.media_type.length()};
+  c_attachment.data = reinterpret_cast<const uint8_t*>(attachment.data);
+  c_attachment.data_len = attachment.data_len;
+
+  foxglove_error error =
+    foxglove_mcap_attach_stream(impl_.get(), &c_attachment, readAttachmentData, &data);
+  return FoxgloveError(error);
+}
+
+FoxgloveError recoverMcap(const std::string& path) {
+  foxglove_string c_path = {path.data(), path.length()};
+  foxglove_error error = foxglove_mcap_recover(&c_path);
+  return FoxgloveError(error);
+}
+
 }  // namespace foxglove
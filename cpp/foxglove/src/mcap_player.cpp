@@ -0,0 +1,528 @@
+#include <foxglove/channel.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap_player.hpp>
+#include <foxglove/mcap_reader.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "time_tracker.hpp"
+
+namespace foxglove {
+
+namespace {
+
+// Number of messages the read-ahead thread reads between acquiring the player's lock.
+constexpr size_t kReadBatchSize = 64;
+
+// Longest time the publish thread waits for a message before rechecking its deadline, which
+// keeps far-off deadlines at low playback speeds from overflowing the wait.
+constexpr auto kMaxPublishWait = std::chrono::seconds(1);
+
+struct QueuedMessage {
+  RawChannel* channel;
+  uint64_t log_time;
+  std::shared_ptr<const std::vector<std::byte>> data;
+  // Backfilled messages are logged as soon as they are queued, even while paused.
+  bool backfill;
+};
+
+/// Find the range of log times by reading every message, for files without chunk indexes.
+FoxgloveResult<std::pair<uint64_t, uint64_t>> scanTimeRange(const McapReader& reader) {
+  McapReadOptions options;
+  options.order = McapReadOrder::File;
+  auto iter = reader.messages(options);
+  if (!iter.has_value()) {
+    return tl::unexpected(iter.error());
+  }
+  std::optional<std::pair<uint64_t, uint64_t>> range;
+  while (true) {
+    auto next = iter->next();
+    if (!next.has_value()) {
+      return tl::unexpected(next.error());
+    }
+    if (!next->has_value()) {
+      break;
+    }
+    uint64_t log_time = (*next)->log_time;
+    if (range.has_value()) {
+      range->first = std::min(range->first, log_time);
+      range->second = std::max(range->second, log_time);
+    } else {
+      range = std::make_pair(log_time, log_time);
+    }
+  }
+  return range.value_or(std::make_pair(uint64_t{0}, uint64_t{0}));
+}
+
+}  // namespace
+
+struct McapPlayer::Impl {
+  Impl(
+    McapReader reader, McapPlayerOptions options,
+    std::unordered_map<uint16_t, RawChannel> channels, std::pair<uint64_t, uint64_t> time_range
+  )
+      : reader(std::move(reader))
+      , options(std::move(options))
+      , channels(std::move(channels))
+      , time_range(time_range)
+      , read_from(time_range.first)
+      , current_time(time_range.first)
+      , speed(TimeTracker::clampSpeed(this->options.playback_speed)) {}
+
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+  Impl(Impl&&) = delete;
+  Impl& operator=(Impl&&) = delete;
+
+  ~Impl() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    reader_cv.notify_all();
+    publish_cv.notify_all();
+    if (read_thread.joinable()) {
+      read_thread.join();
+    }
+    if (publish_thread.joinable()) {
+      publish_thread.join();
+    }
+  }
+
+  void start() {
+    read_thread = std::thread([this] {
+      readLoop();
+    });
+    publish_thread = std::thread([this] {
+      publishLoop();
+    });
+  }
+
+  /// Reads messages ahead of the publish thread, until the queue is full or the file ends.
+  void readLoop();
+
+  /// Logs queued messages as their log times are reached.
+  void publishLoop();
+
+  /// Copies a message read from the file, if it is on one of the player's channels.
+  std::optional<QueuedMessage> copyMessage(const McapMessageView& message, bool backfill) {
+    auto channel = message.channel ? channels.find(message.channel->id) : channels.end();
+    if (channel == channels.end()) {
+      return std::nullopt;
+    }
+    return QueuedMessage{
+      &channel->second,
+      message.log_time,
+      std::make_shared<const std::vector<std::byte>>(
+        message.data, message.data + message.data_len
+      ),
+      backfill,
+    };
+  }
+
+  /// Reads the latest message before `time` on each channel into `batch`. Errors are ignored,
+  /// since playback can continue without the backfilled state.
+  void readBackfill(uint64_t time, std::vector<QueuedMessage>& batch) {
+    McapReadOptions read_options;
+    read_options.topics = options.topics;
+    auto iter = reader.latestMessages(time, read_options);
+    if (!iter.has_value()) {
+      return;
+    }
+    while (true) {
+      auto next = iter->next();
+      if (!next.has_value() || !next->has_value()) {
+        return;
+      }
+      if (auto message = copyMessage(**next, true)) {
+        batch.push_back(std::move(*message));
+      }
+    }
+  }
+
+  [[nodiscard]] bool queueFull() const {
+    return queue.size() >= options.read_ahead_messages ||
+           (!queue.empty() && queued_bytes >= options.read_ahead_bytes);
+  }
+
+  // Playback state changes, called with the lock held.
+  void playLocked() {
+    if (status != PlaybackStatus::Paused) {
+      return;
+    }
+    if (time_tracker.has_value()) {
+      time_tracker->resume();
+    }
+    status = PlaybackStatus::Playing;
+    ++state_version;
+  }
+
+  void pauseLocked() {
+    if (status != PlaybackStatus::Playing) {
+      return;
+    }
+    if (time_tracker.has_value()) {
+      time_tracker->pause();
+    }
+    status = PlaybackStatus::Paused;
+    ++state_version;
+  }
+
+  void setSpeedLocked(float new_speed) {
+    speed = TimeTracker::clampSpeed(new_speed);
+    if (time_tracker.has_value()) {
+      time_tracker->setSpeed(speed);
+    }
+    ++state_version;
+  }
+
+  void seekLocked(uint64_t log_time) {
+    log_time = std::clamp(log_time, time_range.first, time_range.second);
+    ++generation;
+    read_from = log_time;
+    backfill_pending = options.backfill && log_time > time_range.first;
+    read_done = false;
+    queue.clear();
+    queued_bytes = 0;
+    time_tracker.reset();
+    current_time = log_time;
+    if (status == PlaybackStatus::Ended) {
+      status = PlaybackStatus::Paused;
+    }
+    ++state_version;
+  }
+
+  [[nodiscard]] PlaybackState stateLocked() const {
+    return PlaybackState{status, current_time, speed, false, std::nullopt};
+  }
+
+  McapReader reader;
+  McapPlayerOptions options;
+  // Channels by MCAP channel id. Nodes are not moved, so queued messages may point to them.
+  std::unordered_map<uint16_t, RawChannel> channels;
+  std::pair<uint64_t, uint64_t> time_range;
+
+  // Guards all of the state below.
+  mutable std::mutex mutex;
+  // Notified when the queue has room, or the read position changes.
+  std::condition_variable reader_cv;
+  // Notified when messages are queued, or the playback state changes.
+  std::condition_variable publish_cv;
+  bool stopping = false;
+
+  std::deque<QueuedMessage> queue;
+  size_t queued_bytes = 0;
+  // Incremented on every seek, so that the read-ahead thread discards messages it read from the
+  // previous position.
+  uint64_t generation = 0;
+  uint64_t read_from;
+  // True if the latest messages before read_from should be queued before reading from it.
+  bool backfill_pending = false;
+  // True once the read-ahead thread has queued the last message for the current generation.
+  bool read_done = false;
+
+  // Incremented on every playback state change, to wake the publish thread early.
+  uint64_t state_version = 0;
+  PlaybackStatus status = PlaybackStatus::Paused;
+  uint64_t current_time;
+  float speed;
+  std::optional<TimeTracker> time_tracker;
+  uint64_t dropped_messages = 0;
+
+  std::thread read_thread;
+  std::thread publish_thread;
+};
+
+void McapPlayer::Impl::readLoop() {
+  std::optional<McapMessageIterator> iter;
+  std::optional<uint64_t> iter_generation;
+  std::vector<QueuedMessage> batch;
+  batch.reserve(kReadBatchSize);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping) {
+    if (iter_generation != generation) {
+      // Start reading from the new position. Creating the iterator uses the chunk indexes to
+      // find the first chunk to read, so it's done without the lock held.
+      iter_generation = generation;
+      bool backfill = std::exchange(backfill_pending, false);
+      McapReadOptions read_options;
+      read_options.start_time = read_from;
+      read_options.topics = options.topics;
+      read_options.decompression_threads = options.decompression_threads;
+      lock.unlock();
+      iter.reset();
+      if (backfill) {
+        readBackfill(*read_options.start_time, batch);
+      }
+      auto result = reader.messages(read_options);
+      lock.lock();
+      if (iter_generation == generation && !batch.empty()) {
+        for (auto& message : batch) {
+          queued_bytes += message.data->size();
+          queue.push_back(std::move(message));
+        }
+        publish_cv.notify_all();
+      }
+      batch.clear();
+      if (result.has_value()) {
+        iter.emplace(std::move(*result));
+      } else if (iter_generation == generation) {
+        read_done = true;
+        publish_cv.notify_all();
+      }
+      continue;
+    }
+    if (read_done || queueFull()) {
+      reader_cv.wait(lock);
+      continue;
+    }
+
+    // Read and decompress a batch of messages without the lock held, so that the publish
+    // thread is not delayed.
+    lock.unlock();
+    bool done = false;
+    size_t batch_bytes = 0;
+    while (batch.size() < kReadBatchSize && batch_bytes < options.read_ahead_bytes) {
+      auto next = iter->next();
+      // Errors end playback, like the end of the file.
+      if (!next.has_value() || !next->has_value()) {
+        done = true;
+        break;
+      }
+      if (auto message = copyMessage(**next, false)) {
+        batch_bytes += message->data->size();
+        batch.push_back(std::move(*message));
+      }
+    }
+    lock.lock();
+
+    if (iter_generation == generation) {
+      for (auto& message : batch) {
+        queued_bytes += message.data->size();
+        queue.push_back(std::move(message));
+      }
+      read_done = done;
+      publish_cv.notify_all();
+    }
+    batch.clear();
+  }
+}
+
+void McapPlayer::Impl::publishLoop() {
+  std::vector<QueuedMessage> batch;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping) {
+    if (!queue.empty() && queue.front().backfill) {
+      QueuedMessage message = std::move(queue.front());
+      queue.pop_front();
+      queued_bytes -= message.data->size();
+      lock.unlock();
+      const auto& data = *message.data;
+      message.channel->logShared(message.data, data.data(), data.size(), message.log_time);
+      lock.lock();
+      continue;
+    }
+
+    if (status != PlaybackStatus::Playing) {
+      publish_cv.wait(lock);
+      continue;
+    }
+
+    if (queue.empty()) {
+      if (!read_done) {
+        publish_cv.wait(lock);
+        continue;
+      }
+      status = PlaybackStatus::Ended;
+      current_time = time_range.second;
+      auto state = stateLocked();
+      lock.unlock();
+      if (options.on_playback_state) {
+        options.on_playback_state(state);
+      }
+      lock.lock();
+      continue;
+    }
+
+    // Initialize the time tracker on the first message after starting or seeking.
+    uint64_t log_time = queue.front().log_time;
+    if (!time_tracker.has_value()) {
+      time_tracker.emplace(log_time, speed);
+    }
+    auto now = TimeTracker::Clock::now();
+    auto deadline = time_tracker->deadlineFor(log_time);
+    if (deadline > now) {
+      uint64_t version = state_version;
+      publish_cv.wait_until(lock, std::min(deadline, now + kMaxPublishWait), [&] {
+        return stopping || state_version != version;
+      });
+      continue;
+    }
+
+    // Release every message due within this time slice.
+    auto slice = std::chrono::duration_cast<TimeTracker::Clock::duration>(options.publish_slice);
+    auto slice_end = now + std::max(slice, TimeTracker::Clock::duration::zero());
+    while (!queue.empty() && !queue.front().backfill &&
+           time_tracker->deadlineFor(queue.front().log_time) <= slice_end) {
+      QueuedMessage message = std::move(queue.front());
+      queue.pop_front();
+      queued_bytes -= message.data->size();
+      current_time = message.log_time;
+      if (options.max_lateness &&
+          time_tracker->latenessOf(message.log_time, now) > *options.max_lateness) {
+        ++dropped_messages;
+        continue;
+      }
+      batch.push_back(std::move(message));
+    }
+    auto notify_time = time_tracker->notify(current_time);
+    reader_cv.notify_one();
+
+    lock.unlock();
+    for (const auto& message : batch) {
+      const auto& data = *message.data;
+      message.channel->logShared(message.data, data.data(), data.size(), message.log_time);
+    }
+    batch.clear();
+    if (notify_time && options.on_time) {
+      options.on_time(*notify_time);
+    }
+    lock.lock();
+  }
+}
+
+FoxgloveResult<McapPlayer> McapPlayer::create(std::string_view path, McapPlayerOptions options) {
+  auto reader = McapReader::open(path);
+  if (!reader.has_value()) {
+    return tl::unexpected(reader.error());
+  }
+
+  auto time_range = reader->timeRange();
+  if (!time_range.has_value()) {
+    auto scanned = scanTimeRange(*reader);
+    if (!scanned.has_value()) {
+      return tl::unexpected(scanned.error());
+    }
+    time_range = *scanned;
+  }
+
+  std::unordered_map<uint16_t, RawChannel> channels;
+  for (const auto& mcap_channel : reader->channels()) {
+    if (options.topics && std::find(
+                            options.topics->begin(), options.topics->end(), mcap_channel.topic
+                          ) == options.topics->end()) {
+      continue;
+    }
+    auto channel = RawChannel::create(
+      mcap_channel.topic,
+      mcap_channel.message_encoding,
+      mcap_channel.schema,
+      options.context,
+      mcap_channel.metadata
+    );
+    if (!channel.has_value()) {
+      return tl::unexpected(channel.error());
+    }
+    channels.emplace(mcap_channel.id, std::move(*channel));
+  }
+
+  auto impl = std::make_unique<Impl>(
+    std::move(*reader), std::move(options), std::move(channels), *time_range
+  );
+  impl->start();
+  return McapPlayer(std::move(impl));
+}
+
+McapPlayer::McapPlayer(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+
+McapPlayer::~McapPlayer() = default;
+McapPlayer::McapPlayer(McapPlayer&& other) noexcept = default;
+McapPlayer& McapPlayer::operator=(McapPlayer&& other) noexcept = default;
+
+std::pair<uint64_t, uint64_t> McapPlayer::timeRange() const noexcept {
+  return impl_->time_range;
+}
+
+void McapPlayer::play() {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->playLocked();
+  impl_->publish_cv.notify_all();
+}
+
+void McapPlayer::pause() {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->pauseLocked();
+  impl_->publish_cv.notify_all();
+}
+
+void McapPlayer::setPlaybackSpeed(float speed) {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->setSpeedLocked(speed);
+  impl_->publish_cv.notify_all();
+}
+
+void McapPlayer::seek(uint64_t log_time) {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->seekLocked(log_time);
+  impl_->reader_cv.notify_all();
+  impl_->publish_cv.notify_all();
+}
+
+PlaybackState McapPlayer::handlePlaybackControlRequest(const PlaybackControlRequest& request) {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  if (request.seek_time.has_value()) {
+    impl_->seekLocked(*request.seek_time);
+    impl_->reader_cv.notify_all();
+  }
+  impl_->setSpeedLocked(request.playback_speed);
+  switch (request.playback_command) {
+    case PlaybackCommand::Play:
+      impl_->playLocked();
+      break;
+    case PlaybackCommand::Pause:
+      impl_->pauseLocked();
+      break;
+  }
+  impl_->publish_cv.notify_all();
+
+  auto state = impl_->stateLocked();
+  state.did_seek = request.seek_time.has_value();
+  state.request_id = request.request_id;
+  return state;
+}
+
+PlaybackState McapPlayer::state() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->stateLocked();
+}
+
+PlaybackStatus McapPlayer::status() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->status;
+}
+
+uint64_t McapPlayer::currentTime() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->current_time;
+}
+
+float McapPlayer::playbackSpeed() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->speed;
+}
+
+uint64_t McapPlayer::droppedMessages() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->dropped_messages;
+}
+
+}  // namespace foxglove
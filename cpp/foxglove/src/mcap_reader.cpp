@@ -0,0 +1,199 @@
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap_reader.hpp>
+
+#include <algorithm>
+
+namespace foxglove {
+
+static const McapReaderChannel* findChannel(
+  const std::vector<McapReaderChannel>& channels, uint16_t id
+) {
+  auto it = std::lower_bound(
+    channels.begin(),
+    channels.end(),
+    id,
+    [](const McapReaderChannel& channel, uint16_t id) {
+      return channel.id < id;
+    }
+  );
+  return it != channels.end() && it->id == id ? &*it : nullptr;
+}
+
+namespace {
+
+/// The C representation of McapReadOptions, which refers to the options' topics.
+class CReadOptions {
+public:
+  explicit CReadOptions(const McapReadOptions& options) {
+    if (options.start_time) {
+      options_.start_time = &*options.start_time;
+    }
+    if (options.end_time) {
+      options_.end_time = &*options.end_time;
+    }
+    if (options.topics) {
+      topics_.reserve(options.topics->size());
+      for (const auto& topic : *options.topics) {
+        topics_.push_back({topic.data(), topic.length()});
+      }
+      // A non-null pointer with no topics selects no messages.
+      options_.topics = topics_.empty() ? &no_topics_ : topics_.data();
+      options_.topics_count = topics_.size();
+    }
+    options_.order = static_cast<foxglove_mcap_read_order>(options.order);
+    options_.decompression_threads = options.decompression_threads;
+  }
+
+  CReadOptions(const CReadOptions&) = delete;
+  CReadOptions& operator=(const CReadOptions&) = delete;
+
+  [[nodiscard]] const foxglove_mcap_read_options* get() const noexcept {
+    return &options_;
+  }
+
+private:
+  foxglove_mcap_read_options options_ = {};
+  std::vector<foxglove_string> topics_;
+  foxglove_string no_topics_ = {};
+};
+
+}  // namespace
+
+FoxgloveResult<McapReader> McapReader::open(std::string_view path) {
+  foxglove_internal_register_cpp_wrapper();
+
+  foxglove_string c_path = {path.data(), path.length()};
+  foxglove_mcap_reader* reader = nullptr;
+  foxglove_error error = foxglove_mcap_reader_open(&c_path, &reader);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || reader == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return McapReader(reader);
+}
+
+McapReader::McapReader(foxglove_mcap_reader* reader)
+    : impl_(reader, foxglove_mcap_reader_free) {
+  size_t count = 0;
+  const foxglove_mcap_reader_channel* c_channels = foxglove_mcap_reader_channels(reader, &count);
+  std::vector<McapReaderChannel> channels;
+  channels.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const auto& c_channel = c_channels[i];
+    McapReaderChannel channel;
+    channel.id = c_channel.id;
+    channel.topic = std::string(c_channel.topic.data, c_channel.topic.len);
+    channel.message_encoding =
+      std::string(c_channel.message_encoding.data, c_channel.message_encoding.len);
+    for (size_t j = 0; j < c_channel.metadata.count; ++j) {
+      const auto& item = c_channel.metadata.items[j];
+      channel.metadata.emplace(
+        std::string(item.key.data, item.key.len), std::string(item.value.data, item.value.len)
+      );
+    }
+    if (c_channel.schema != nullptr) {
+      Schema schema;
+      schema.name = std::string(c_channel.schema->name.data, c_channel.schema->name.len);
+      schema.encoding =
+        std::string(c_channel.schema->encoding.data, c_channel.schema->encoding.len);
+      schema.data = reinterpret_cast<const std::byte*>(c_channel.schema->data);
+      schema.data_len = c_channel.schema->data_len;
+      channel.schema = std::move(schema);
+    }
+    channels.push_back(std::move(channel));
+  }
+  channels_ = std::make_shared<const std::vector<McapReaderChannel>>(std::move(channels));
+}
+
+const std::vector<McapReaderChannel>& McapReader::channels() const noexcept {
+  return *channels_;
+}
+
+const McapReaderChannel* McapReader::channel(uint16_t id) const noexcept {
+  return findChannel(*channels_, id);
+}
+
+std::optional<std::pair<uint64_t, uint64_t>> McapReader::timeRange() const noexcept {
+  uint64_t start_time = 0;
+  uint64_t end_time = 0;
+  if (!foxglove_mcap_reader_time_range(impl_.get(), &start_time, &end_time)) {
+    return std::nullopt;
+  }
+  return std::make_pair(start_time, end_time);
+}
+
+FoxgloveResult<McapMessageIterator> McapReader::messages(const McapReadOptions& options) const {
+  CReadOptions c_options(options);
+  foxglove_mcap_message_iterator* iter = nullptr;
+  foxglove_error error = foxglove_mcap_reader_messages(impl_.get(), c_options.get(), &iter);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || iter == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return McapMessageIterator(iter, {channels_});
+}
+
+FoxgloveResult<McapMessageIterator> McapReader::latestMessages(
+  uint64_t time, const McapReadOptions& options
+) const {
+  CReadOptions c_options(options);
+  foxglove_mcap_message_iterator* iter = nullptr;
+  foxglove_error error =
+    foxglove_mcap_reader_latest_messages(impl_.get(), time, c_options.get(), &iter);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || iter == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return McapMessageIterator(iter, {channels_});
+}
+
+FoxgloveResult<McapMessageIterator> McapReader::merge(
+  const std::vector<McapReader>& readers, const McapReadOptions& options
+) {
+  std::vector<const foxglove_mcap_reader*> c_readers;
+  std::vector<std::shared_ptr<const std::vector<McapReaderChannel>>> channels;
+  c_readers.reserve(readers.size());
+  channels.reserve(readers.size());
+  for (const auto& reader : readers) {
+    c_readers.push_back(reader.impl_.get());
+    channels.push_back(reader.channels_);
+  }
+  CReadOptions c_options(options);
+  foxglove_mcap_message_iterator* iter = nullptr;
+  foxglove_error error =
+    foxglove_mcap_reader_merge(c_readers.data(), c_readers.size(), c_options.get(), &iter);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || iter == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return McapMessageIterator(iter, std::move(channels));
+}
+
+McapMessageIterator::McapMessageIterator(
+  foxglove_mcap_message_iterator* impl,
+  std::vector<std::shared_ptr<const std::vector<McapReaderChannel>>> channels
+)
+    : channels_(std::move(channels))
+    , impl_(impl, foxglove_mcap_message_iter_free) {}
+
+FoxgloveResult<std::optional<McapMessageView>> McapMessageIterator::next() {
+  foxglove_mcap_message message = {};
+  bool has_message = false;
+  foxglove_error error = foxglove_mcap_message_iter_next(impl_.get(), &message, &has_message);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  if (!has_message) {
+    return std::optional<McapMessageView>{};
+  }
+  McapMessageView view;
+  if (message.reader_index < channels_.size()) {
+    view.channel = findChannel(*channels_[message.reader_index], message.channel_id);
+  }
+  view.sequence = message.sequence;
+  view.log_time = message.log_time;
+  view.publish_time = message.publish_time;
+  view.data = reinterpret_cast<const std::byte*>(message.data);
+  view.data_len = message.data_len;
+  view.reader_index = message.reader_index;
+  return std::optional<McapMessageView>{view};
+}
+
+}  // namespace foxglove
@@ -1,7 +1,6 @@
 // Generated by https://github.com/foxglove/foxglove-sdk
 
 #include <foxglove-c/foxglove-c.h>
-#include <foxglove/arena.hpp>
 #include <foxglove/error.hpp>
 #include <foxglove/messages.hpp>
 #include <foxglove/schema.hpp>
@@ -9,71 +8,171 @@
 #include <foxglove/context.hpp>
 #endif
 
-#include <cstring>
 #include <optional>
+#include <vector>
+
+#include "protobuf_encoder.hpp"
 
 namespace foxglove::messages {
 
-void arrowPrimitiveToC(foxglove_arrow_primitive& dest, const ArrowPrimitive& src, Arena& arena);
-void cameraCalibrationToC(
-  foxglove_camera_calibration& dest, const CameraCalibration& src, Arena& arena
-);
-void circleAnnotationToC(
-  foxglove_circle_annotation& dest, const CircleAnnotation& src, Arena& arena
-);
-void compressedAudioToC(foxglove_compressed_audio& dest, const CompressedAudio& src, Arena& arena);
-void compressedImageToC(foxglove_compressed_image& dest, const CompressedImage& src, Arena& arena);
-void compressedPointCloudToC(
-  foxglove_compressed_point_cloud& dest, const CompressedPointCloud& src, Arena& arena
-);
-void compressedVideoToC(foxglove_compressed_video& dest, const CompressedVideo& src, Arena& arena);
-void cubePrimitiveToC(foxglove_cube_primitive& dest, const CubePrimitive& src, Arena& arena);
-void cylinderPrimitiveToC(
-  foxglove_cylinder_primitive& dest, const CylinderPrimitive& src, Arena& arena
-);
-void eventToC(foxglove_event& dest, const Event& src, Arena& arena);
-void frameTransformToC(foxglove_frame_transform& dest, const FrameTransform& src, Arena& arena);
-void frameTransformsToC(foxglove_frame_transforms& dest, const FrameTransforms& src, Arena& arena);
-void geoJSONToC(foxglove_geo_json& dest, const GeoJSON& src, Arena& arena);
-void gridToC(foxglove_grid& dest, const Grid& src, Arena& arena);
-void imageAnnotationsToC(
-  foxglove_image_annotations& dest, const ImageAnnotations& src, Arena& arena
-);
-void jointStateToC(foxglove_joint_state& dest, const JointState& src, Arena& arena);
-void jointStatesToC(foxglove_joint_states& dest, const JointStates& src, Arena& arena);
-void keyValuePairToC(foxglove_key_value_pair& dest, const KeyValuePair& src, Arena& arena);
-void laserScanToC(foxglove_laser_scan& dest, const LaserScan& src, Arena& arena);
-void linePrimitiveToC(foxglove_line_primitive& dest, const LinePrimitive& src, Arena& arena);
-void locationFixToC(foxglove_location_fix& dest, const LocationFix& src, Arena& arena);
-void locationFixesToC(foxglove_location_fixes& dest, const LocationFixes& src, Arena& arena);
-void logToC(foxglove_log& dest, const Log& src, Arena& arena);
-void modelPrimitiveToC(foxglove_model_primitive& dest, const ModelPrimitive& src, Arena& arena);
-void odometryToC(foxglove_odometry& dest, const Odometry& src, Arena& arena);
-void packedElementFieldToC(
-  foxglove_packed_element_field& dest, const PackedElementField& src, Arena& arena
-);
-void point3InFrameToC(foxglove_point3_in_frame& dest, const Point3InFrame& src, Arena& arena);
-void pointCloudToC(foxglove_point_cloud& dest, const PointCloud& src, Arena& arena);
-void pointsAnnotationToC(
-  foxglove_points_annotation& dest, const PointsAnnotation& src, Arena& arena
-);
-void poseToC(foxglove_pose& dest, const Pose& src, Arena& arena);
-void poseInFrameToC(foxglove_pose_in_frame& dest, const PoseInFrame& src, Arena& arena);
-void posesInFrameToC(foxglove_poses_in_frame& dest, const PosesInFrame& src, Arena& arena);
-void rawAudioToC(foxglove_raw_audio& dest, const RawAudio& src, Arena& arena);
-void rawImageToC(foxglove_raw_image& dest, const RawImage& src, Arena& arena);
-void sceneEntityToC(foxglove_scene_entity& dest, const SceneEntity& src, Arena& arena);
-void sceneEntityDeletionToC(
-  foxglove_scene_entity_deletion& dest, const SceneEntityDeletion& src, Arena& arena
-);
-void sceneUpdateToC(foxglove_scene_update& dest, const SceneUpdate& src, Arena& arena);
-void spherePrimitiveToC(foxglove_sphere_primitive& dest, const SpherePrimitive& src, Arena& arena);
-void textAnnotationToC(foxglove_text_annotation& dest, const TextAnnotation& src, Arena& arena);
-void textPrimitiveToC(foxglove_text_primitive& dest, const TextPrimitive& src, Arena& arena);
-void triangleListPrimitiveToC(
-  foxglove_triangle_list_primitive& dest, const TriangleListPrimitive& src, Arena& arena
-);
-void voxelGridToC(foxglove_voxel_grid& dest, const VoxelGrid& src, Arena& arena);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const ArrowPrimitive& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CameraCalibration& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CircleAnnotation& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Color& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedAudio& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedAudioView& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedImage& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedImageView& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedPointCloud& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedPointCloudView& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedVideo& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedVideoView& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CubePrimitive& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CylinderPrimitive& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Event& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const FrameTransform& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const FrameTransforms& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const GeoJSON& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Grid& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const GridView& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const ImageAnnotations& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const JointState& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const JointStates& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const KeyValuePair& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const LaserScan& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const LinePrimitive& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const LocationFix& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const LocationFixes& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Log& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const ModelPrimitive& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const ModelPrimitiveView& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Odometry& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PackedElementField& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Point2& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Point3& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Point3InFrame& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PointCloud& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PointCloudView& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PointsAnnotation& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Pose& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PoseInFrame& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PosesInFrame& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Quaternion& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const RawAudio& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const RawAudioView& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const RawImage& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const RawImageView& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const SceneEntity& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const SceneEntityDeletion& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const SceneUpdate& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const SpherePrimitive& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const TextAnnotation& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const TextPrimitive& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const TriangleListPrimitive& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Vector2& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Vector3& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const VoxelGrid& msg);
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const VoxelGridView& msg);
+
+/// Encodes msg into the buffer at ptr, with the same contract as the C API's encode functions:
+/// if ptr is null or len is too short, writes the required length to *encoded_len and returns
+/// FoxgloveError::BufferTooShort.
+template<typename T>
+static FoxgloveError encodeToBuffer(const T& msg, uint8_t* ptr, size_t len, size_t* encoded_len) {
+  ProtobufEncoding encoding(msg);
+  if (encoding.error() != FoxgloveError::Ok) {
+    return encoding.error();
+  }
+  if (encoded_len != nullptr) {
+    *encoded_len = encoding.size();
+  }
+  if (ptr == nullptr || len < encoding.size()) {
+    return FoxgloveError::BufferTooShort;
+  }
+  encoding.write(ptr);
+  return FoxgloveError::Ok;
+}
+
+/// Appends msg to buf, growing the buffer exactly once. On failure, buf is left unchanged.
+template<typename T>
+static FoxgloveError encodeAppend(const T& msg, std::vector<uint8_t>& buf) {
+  ProtobufEncoding encoding(msg);
+  if (encoding.error() != FoxgloveError::Ok) {
+    return encoding.error();
+  }
+  size_t offset = buf.size();
+  buf.resize(offset + encoding.size());
+  encoding.write(buf.data() + offset);
+  return FoxgloveError::Ok;
+}
+
+/// Returns the length of msg's encoding, or the reason it cannot be encoded.
+template<typename T>
+static FoxgloveResult<size_t> encodedSizeOf(const T& msg) {
+  ProtobufEncoding encoding(msg);
+  if (encoding.error() != FoxgloveError::Ok) {
+    return tl::unexpected(encoding.error());
+  }
+  return encoding.size();
+}
 
 #ifndef __wasm32__
 
@@ -81,13 +180,94 @@ void ChannelDeleter::operator()(const foxglove_channel* ptr) const noexcept {
   foxglove_channel_free(ptr);
 };
 
+/// Creates a protobuf channel with the given schema, which retains its last keep_last messages.
+static foxglove_error createLatchedChannel(
+  const std::string_view& topic, const foxglove_schema& schema, const Context& context,
+  size_t keep_last, const foxglove_channel** channel
+) {
+  static constexpr std::string_view kEncoding = "protobuf";
+  foxglove_channel_spec spec = {};
+  spec.topic = {topic.data(), topic.size()};
+  spec.message_encoding = {kEncoding.data(), kEncoding.size()};
+  spec.schema = &schema;
+  spec.keep_last = keep_last;
+  return foxglove_raw_channels_create(&spec, 1, context.getInner(), channel);
+}
+
+/// Encodes the message into the calling thread's reusable buffer, then logs its bytes.
+template<typename T>
+static FoxgloveError logEncoded(
+  const foxglove_channel* channel, const T& msg, std::optional<uint64_t> log_time,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  // Skip encoding the message if no sink would receive it.
+  if (!foxglove_channel_should_log(channel)) {
+    return FoxgloveError::Ok;
+  }
+  ScopedEncodeBuffer scoped_buffer;
+  std::vector<uint8_t>& buffer = scoped_buffer.get();
+  FoxgloveError error = encodeAppend(msg, buffer);
+  if (error != FoxgloveError::Ok) {
+    return error;
+  }
+  return FoxgloveError(foxglove_channel_log(
+    channel, buffer.data(), buffer.size(), log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
+  ));
+}
+
+/// Encodes each message into one shared buffer, then logs them as a single batch.
+template<typename T>
+static FoxgloveError logEncodedBatch(
+  const foxglove_channel* channel, const T* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  if (count == 0) {
+    return FoxgloveError::Ok;
+  }
+  if (msgs == nullptr) {
+    return FoxgloveError::ValueError;
+  }
+  if (!foxglove_channel_should_log(channel)) {
+    return FoxgloveError::Ok;
+  }
+  ScopedEncodeBuffer scoped_buffer;
+  std::vector<uint8_t>& buffer = scoped_buffer.get();
+  std::vector<size_t> offsets;
+  offsets.reserve(count + 1);
+  for (size_t i = 0; i < count; ++i) {
+    offsets.push_back(buffer.size());
+    FoxgloveError error = msgs[i].encode(buffer);
+    if (error != FoxgloveError::Ok) {
+      return error;
+    }
+  }
+  offsets.push_back(buffer.size());
+
+  std::vector<foxglove_log_item> items(count);
+  for (size_t i = 0; i < count; ++i) {
+    items[i].data = buffer.data() + offsets[i];
+    items[i].data_len = offsets[i + 1] - offsets[i];
+    items[i].log_time = log_times != nullptr ? &log_times[i] : nullptr;
+  }
+  return FoxgloveError(
+    foxglove_channel_log_batch(channel, items.data(), count, sink_id ? *sink_id : 0)
+  );
+}
+
 FoxgloveResult<ArrowPrimitiveChannel> ArrowPrimitiveChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_arrow_primitive(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_arrow_primitive(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_arrow_primitive_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -97,12 +277,14 @@ FoxgloveResult<ArrowPrimitiveChannel> ArrowPrimitiveChannel::create(
 FoxgloveError ArrowPrimitiveChannel::log(
   const ArrowPrimitive& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_arrow_primitive c_msg;
-  arrowPrimitiveToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_arrow_primitive(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError ArrowPrimitiveChannel::logBatch(
+  const ArrowPrimitive* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void ArrowPrimitiveChannel::close() noexcept {
@@ -118,12 +300,19 @@ bool ArrowPrimitiveChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<CameraCalibrationChannel> CameraCalibrationChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_camera_calibration(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_camera_calibration(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_camera_calibration_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -133,12 +322,14 @@ FoxgloveResult<CameraCalibrationChannel> CameraCalibrationChannel::create(
 FoxgloveError CameraCalibrationChannel::log(
   const CameraCalibration& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_camera_calibration c_msg;
-  cameraCalibrationToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_camera_calibration(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CameraCalibrationChannel::logBatch(
+  const CameraCalibration* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void CameraCalibrationChannel::close() noexcept {
@@ -154,12 +345,19 @@ bool CameraCalibrationChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<CircleAnnotationChannel> CircleAnnotationChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_circle_annotation(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_circle_annotation(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_circle_annotation_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -169,12 +367,14 @@ FoxgloveResult<CircleAnnotationChannel> CircleAnnotationChannel::create(
 FoxgloveError CircleAnnotationChannel::log(
   const CircleAnnotation& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_circle_annotation c_msg;
-  circleAnnotationToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_circle_annotation(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CircleAnnotationChannel::logBatch(
+  const CircleAnnotation* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void CircleAnnotationChannel::close() noexcept {
@@ -190,11 +390,17 @@ bool CircleAnnotationChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<ColorChannel> ColorChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_color({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_color(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_color_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -204,12 +410,13 @@ FoxgloveResult<ColorChannel> ColorChannel::create(
 FoxgloveError ColorChannel::log(
   const Color& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  return FoxgloveError(foxglove_channel_log_color(
-    impl_.get(),
-    reinterpret_cast<const foxglove_color*>(&msg),
-    log_time ? &*log_time : nullptr,
-    sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError ColorChannel::logBatch(
+  const Color* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void ColorChannel::close() noexcept {
@@ -225,12 +432,19 @@ bool ColorChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<CompressedAudioChannel> CompressedAudioChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_compressed_audio(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_compressed_audio(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_compressed_audio_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -240,12 +454,20 @@ FoxgloveResult<CompressedAudioChannel> CompressedAudioChannel::create(
 FoxgloveError CompressedAudioChannel::log(
   const CompressedAudio& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_compressed_audio c_msg;
-  compressedAudioToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_compressed_audio(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CompressedAudioChannel::log(
+  const CompressedAudioView& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CompressedAudioChannel::logBatch(
+  const CompressedAudio* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void CompressedAudioChannel::close() noexcept {
@@ -261,12 +483,19 @@ bool CompressedAudioChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<CompressedImageChannel> CompressedImageChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_compressed_image(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_compressed_image(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_compressed_image_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -276,12 +505,20 @@ FoxgloveResult<CompressedImageChannel> CompressedImageChannel::create(
 FoxgloveError CompressedImageChannel::log(
   const CompressedImage& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_compressed_image c_msg;
-  compressedImageToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_compressed_image(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CompressedImageChannel::log(
+  const CompressedImageView& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CompressedImageChannel::logBatch(
+  const CompressedImage* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void CompressedImageChannel::close() noexcept {
@@ -297,12 +534,19 @@ bool CompressedImageChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<CompressedPointCloudChannel> CompressedPointCloudChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_compressed_point_cloud(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_compressed_point_cloud(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_compressed_point_cloud_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -312,12 +556,21 @@ FoxgloveResult<CompressedPointCloudChannel> CompressedPointCloudChannel::create(
 FoxgloveError CompressedPointCloudChannel::log(
   const CompressedPointCloud& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_compressed_point_cloud c_msg;
-  compressedPointCloudToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_compressed_point_cloud(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CompressedPointCloudChannel::log(
+  const CompressedPointCloudView& msg, std::optional<uint64_t> log_time,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CompressedPointCloudChannel::logBatch(
+  const CompressedPointCloud* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void CompressedPointCloudChannel::close() noexcept {
@@ -333,12 +586,19 @@ bool CompressedPointCloudChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<CompressedVideoChannel> CompressedVideoChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_compressed_video(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_compressed_video(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_compressed_video_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -348,12 +608,20 @@ FoxgloveResult<CompressedVideoChannel> CompressedVideoChannel::create(
 FoxgloveError CompressedVideoChannel::log(
   const CompressedVideo& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_compressed_video c_msg;
-  compressedVideoToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_compressed_video(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CompressedVideoChannel::log(
+  const CompressedVideoView& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CompressedVideoChannel::logBatch(
+  const CompressedVideo* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void CompressedVideoChannel::close() noexcept {
@@ -369,12 +637,19 @@ bool CompressedVideoChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<CubePrimitiveChannel> CubePrimitiveChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_cube_primitive(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_cube_primitive(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_cube_primitive_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -384,12 +659,14 @@ FoxgloveResult<CubePrimitiveChannel> CubePrimitiveChannel::create(
 FoxgloveError CubePrimitiveChannel::log(
   const CubePrimitive& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_cube_primitive c_msg;
-  cubePrimitiveToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_cube_primitive(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CubePrimitiveChannel::logBatch(
+  const CubePrimitive* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void CubePrimitiveChannel::close() noexcept {
@@ -405,12 +682,19 @@ bool CubePrimitiveChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<CylinderPrimitiveChannel> CylinderPrimitiveChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_cylinder_primitive(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_cylinder_primitive(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_cylinder_primitive_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -420,12 +704,14 @@ FoxgloveResult<CylinderPrimitiveChannel> CylinderPrimitiveChannel::create(
 FoxgloveError CylinderPrimitiveChannel::log(
   const CylinderPrimitive& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_cylinder_primitive c_msg;
-  cylinderPrimitiveToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_cylinder_primitive(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError CylinderPrimitiveChannel::logBatch(
+  const CylinderPrimitive* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void CylinderPrimitiveChannel::close() noexcept {
@@ -441,11 +727,17 @@ bool CylinderPrimitiveChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<EventChannel> EventChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_event({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_event(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_event_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -455,12 +747,13 @@ FoxgloveResult<EventChannel> EventChannel::create(
 FoxgloveError EventChannel::log(
   const Event& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_event c_msg;
-  eventToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_event(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError EventChannel::logBatch(
+  const Event* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void EventChannel::close() noexcept {
@@ -476,12 +769,19 @@ bool EventChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<FrameTransformChannel> FrameTransformChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_frame_transform(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_frame_transform(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_frame_transform_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -491,12 +791,14 @@ FoxgloveResult<FrameTransformChannel> FrameTransformChannel::create(
 FoxgloveError FrameTransformChannel::log(
   const FrameTransform& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_frame_transform c_msg;
-  frameTransformToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_frame_transform(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError FrameTransformChannel::logBatch(
+  const FrameTransform* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void FrameTransformChannel::close() noexcept {
@@ -512,12 +814,19 @@ bool FrameTransformChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<FrameTransformsChannel> FrameTransformsChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_frame_transforms(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_frame_transforms(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_frame_transforms_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -527,12 +836,14 @@ FoxgloveResult<FrameTransformsChannel> FrameTransformsChannel::create(
 FoxgloveError FrameTransformsChannel::log(
   const FrameTransforms& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_frame_transforms c_msg;
-  frameTransformsToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_frame_transforms(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError FrameTransformsChannel::logBatch(
+  const FrameTransforms* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void FrameTransformsChannel::close() noexcept {
@@ -548,11 +859,17 @@ bool FrameTransformsChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<GeoJSONChannel> GeoJSONChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_geo_json({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_geo_json(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_geo_json_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -562,12 +879,13 @@ FoxgloveResult<GeoJSONChannel> GeoJSONChannel::create(
 FoxgloveError GeoJSONChannel::log(
   const GeoJSON& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_geo_json c_msg;
-  geoJSONToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_geo_json(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError GeoJSONChannel::logBatch(
+  const GeoJSON* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void GeoJSONChannel::close() noexcept {
@@ -583,11 +901,17 @@ bool GeoJSONChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<GridChannel> GridChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_grid({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_grid(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_grid_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -597,12 +921,19 @@ FoxgloveResult<GridChannel> GridChannel::create(
 FoxgloveError GridChannel::log(
   const Grid& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_grid c_msg;
-  gridToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_grid(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError GridChannel::log(
+  const GridView& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError GridChannel::logBatch(
+  const Grid* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void GridChannel::close() noexcept {
@@ -618,12 +949,19 @@ bool GridChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<ImageAnnotationsChannel> ImageAnnotationsChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_image_annotations(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_image_annotations(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_image_annotations_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -633,12 +971,14 @@ FoxgloveResult<ImageAnnotationsChannel> ImageAnnotationsChannel::create(
 FoxgloveError ImageAnnotationsChannel::log(
   const ImageAnnotations& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_image_annotations c_msg;
-  imageAnnotationsToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_image_annotations(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError ImageAnnotationsChannel::logBatch(
+  const ImageAnnotations* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void ImageAnnotationsChannel::close() noexcept {
@@ -654,11 +994,19 @@ bool ImageAnnotationsChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<JointStateChannel> JointStateChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_joint_state({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_joint_state(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_joint_state_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -668,12 +1016,13 @@ FoxgloveResult<JointStateChannel> JointStateChannel::create(
 FoxgloveError JointStateChannel::log(
   const JointState& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_joint_state c_msg;
-  jointStateToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_joint_state(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError JointStateChannel::logBatch(
+  const JointState* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void JointStateChannel::close() noexcept {
@@ -689,12 +1038,19 @@ bool JointStateChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<JointStatesChannel> JointStatesChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_joint_states(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_joint_states(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_joint_states_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -704,12 +1060,13 @@ FoxgloveResult<JointStatesChannel> JointStatesChannel::create(
 FoxgloveError JointStatesChannel::log(
   const JointStates& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_joint_states c_msg;
-  jointStatesToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_joint_states(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError JointStatesChannel::logBatch(
+  const JointStates* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void JointStatesChannel::close() noexcept {
@@ -725,12 +1082,19 @@ bool JointStatesChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<KeyValuePairChannel> KeyValuePairChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_key_value_pair(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_key_value_pair(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_key_value_pair_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -740,12 +1104,13 @@ FoxgloveResult<KeyValuePairChannel> KeyValuePairChannel::create(
 FoxgloveError KeyValuePairChannel::log(
   const KeyValuePair& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_key_value_pair c_msg;
-  keyValuePairToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_key_value_pair(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError KeyValuePairChannel::logBatch(
+  const KeyValuePair* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void KeyValuePairChannel::close() noexcept {
@@ -761,11 +1126,17 @@ bool KeyValuePairChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<LaserScanChannel> LaserScanChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_laser_scan({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_laser_scan(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_laser_scan_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -775,12 +1146,13 @@ FoxgloveResult<LaserScanChannel> LaserScanChannel::create(
 FoxgloveError LaserScanChannel::log(
   const LaserScan& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_laser_scan c_msg;
-  laserScanToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_laser_scan(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError LaserScanChannel::logBatch(
+  const LaserScan* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void LaserScanChannel::close() noexcept {
@@ -796,12 +1168,19 @@ bool LaserScanChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<LinePrimitiveChannel> LinePrimitiveChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_line_primitive(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_line_primitive(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_line_primitive_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -811,12 +1190,14 @@ FoxgloveResult<LinePrimitiveChannel> LinePrimitiveChannel::create(
 FoxgloveError LinePrimitiveChannel::log(
   const LinePrimitive& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_line_primitive c_msg;
-  linePrimitiveToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_line_primitive(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError LinePrimitiveChannel::logBatch(
+  const LinePrimitive* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void LinePrimitiveChannel::close() noexcept {
@@ -832,12 +1213,19 @@ bool LinePrimitiveChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<LocationFixChannel> LocationFixChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_location_fix(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_location_fix(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_location_fix_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -847,12 +1235,13 @@ FoxgloveResult<LocationFixChannel> LocationFixChannel::create(
 FoxgloveError LocationFixChannel::log(
   const LocationFix& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_location_fix c_msg;
-  locationFixToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_location_fix(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError LocationFixChannel::logBatch(
+  const LocationFix* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void LocationFixChannel::close() noexcept {
@@ -868,12 +1257,19 @@ bool LocationFixChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<LocationFixesChannel> LocationFixesChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_location_fixes(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_location_fixes(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_location_fixes_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -883,12 +1279,14 @@ FoxgloveResult<LocationFixesChannel> LocationFixesChannel::create(
 FoxgloveError LocationFixesChannel::log(
   const LocationFixes& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_location_fixes c_msg;
-  locationFixesToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_location_fixes(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError LocationFixesChannel::logBatch(
+  const LocationFixes* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void LocationFixesChannel::close() noexcept {
@@ -904,11 +1302,15 @@ bool LocationFixesChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<LogChannel> LogChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_log({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_log({topic.data(), topic.size()}, context.getInner(), &channel);
+  } else {
+    error = createLatchedChannel(topic, foxglove_log_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -918,12 +1320,13 @@ FoxgloveResult<LogChannel> LogChannel::create(
 FoxgloveError LogChannel::log(
   const Log& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_log c_msg;
-  logToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_log(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError LogChannel::logBatch(
+  const Log* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void LogChannel::close() noexcept {
@@ -939,12 +1342,19 @@ bool LogChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<ModelPrimitiveChannel> ModelPrimitiveChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_model_primitive(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_model_primitive(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_model_primitive_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -954,12 +1364,20 @@ FoxgloveResult<ModelPrimitiveChannel> ModelPrimitiveChannel::create(
 FoxgloveError ModelPrimitiveChannel::log(
   const ModelPrimitive& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_model_primitive c_msg;
-  modelPrimitiveToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_model_primitive(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError ModelPrimitiveChannel::log(
+  const ModelPrimitiveView& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError ModelPrimitiveChannel::logBatch(
+  const ModelPrimitive* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void ModelPrimitiveChannel::close() noexcept {
@@ -975,11 +1393,17 @@ bool ModelPrimitiveChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<OdometryChannel> OdometryChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_odometry({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_odometry(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_odometry_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -989,12 +1413,13 @@ FoxgloveResult<OdometryChannel> OdometryChannel::create(
 FoxgloveError OdometryChannel::log(
   const Odometry& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_odometry c_msg;
-  odometryToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_odometry(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError OdometryChannel::logBatch(
+  const Odometry* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void OdometryChannel::close() noexcept {
@@ -1010,12 +1435,19 @@ bool OdometryChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<PackedElementFieldChannel> PackedElementFieldChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_packed_element_field(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_packed_element_field(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_packed_element_field_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1025,12 +1457,14 @@ FoxgloveResult<PackedElementFieldChannel> PackedElementFieldChannel::create(
 FoxgloveError PackedElementFieldChannel::log(
   const PackedElementField& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_packed_element_field c_msg;
-  packedElementFieldToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_packed_element_field(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError PackedElementFieldChannel::logBatch(
+  const PackedElementField* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void PackedElementFieldChannel::close() noexcept {
@@ -1046,11 +1480,17 @@ bool PackedElementFieldChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<Point2Channel> Point2Channel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_point2({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_point2(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_point2_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1060,12 +1500,13 @@ FoxgloveResult<Point2Channel> Point2Channel::create(
 FoxgloveError Point2Channel::log(
   const Point2& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  return FoxgloveError(foxglove_channel_log_point2(
-    impl_.get(),
-    reinterpret_cast<const foxglove_point2*>(&msg),
-    log_time ? &*log_time : nullptr,
-    sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError Point2Channel::logBatch(
+  const Point2* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void Point2Channel::close() noexcept {
@@ -1081,11 +1522,17 @@ bool Point2Channel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<Point3Channel> Point3Channel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_point3({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_point3(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_point3_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1095,12 +1542,13 @@ FoxgloveResult<Point3Channel> Point3Channel::create(
 FoxgloveError Point3Channel::log(
   const Point3& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  return FoxgloveError(foxglove_channel_log_point3(
-    impl_.get(),
-    reinterpret_cast<const foxglove_point3*>(&msg),
-    log_time ? &*log_time : nullptr,
-    sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError Point3Channel::logBatch(
+  const Point3* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void Point3Channel::close() noexcept {
@@ -1116,12 +1564,19 @@ bool Point3Channel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<Point3InFrameChannel> Point3InFrameChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_point3_in_frame(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_point3_in_frame(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_point3_in_frame_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1131,12 +1586,14 @@ FoxgloveResult<Point3InFrameChannel> Point3InFrameChannel::create(
 FoxgloveError Point3InFrameChannel::log(
   const Point3InFrame& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_point3_in_frame c_msg;
-  point3InFrameToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_point3_in_frame(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError Point3InFrameChannel::logBatch(
+  const Point3InFrame* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void Point3InFrameChannel::close() noexcept {
@@ -1152,11 +1609,19 @@ bool Point3InFrameChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<PointCloudChannel> PointCloudChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_point_cloud({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_point_cloud(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_point_cloud_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1166,12 +1631,19 @@ FoxgloveResult<PointCloudChannel> PointCloudChannel::create(
 FoxgloveError PointCloudChannel::log(
   const PointCloud& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_point_cloud c_msg;
-  pointCloudToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_point_cloud(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError PointCloudChannel::log(
+  const PointCloudView& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError PointCloudChannel::logBatch(
+  const PointCloud* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void PointCloudChannel::close() noexcept {
@@ -1187,12 +1659,19 @@ bool PointCloudChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<PointsAnnotationChannel> PointsAnnotationChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_points_annotation(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_points_annotation(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_points_annotation_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1202,15 +1681,17 @@ FoxgloveResult<PointsAnnotationChannel> PointsAnnotationChannel::create(
 FoxgloveError PointsAnnotationChannel::log(
   const PointsAnnotation& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_points_annotation c_msg;
-  pointsAnnotationToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_points_annotation(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
 }
 
-void PointsAnnotationChannel::close() noexcept {
+FoxgloveError PointsAnnotationChannel::logBatch(
+  const PointsAnnotation* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
+}
+
+void PointsAnnotationChannel::close() noexcept {
   foxglove_channel_close(impl_.get());
 }
 
@@ -1223,11 +1704,17 @@ bool PointsAnnotationChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<PoseChannel> PoseChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_pose({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_pose(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_pose_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1237,12 +1724,13 @@ FoxgloveResult<PoseChannel> PoseChannel::create(
 FoxgloveError PoseChannel::log(
   const Pose& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_pose c_msg;
-  poseToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_pose(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError PoseChannel::logBatch(
+  const Pose* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void PoseChannel::close() noexcept {
@@ -1258,12 +1746,19 @@ bool PoseChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<PoseInFrameChannel> PoseInFrameChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_pose_in_frame(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_pose_in_frame(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_pose_in_frame_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1273,12 +1768,13 @@ FoxgloveResult<PoseInFrameChannel> PoseInFrameChannel::create(
 FoxgloveError PoseInFrameChannel::log(
   const PoseInFrame& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_pose_in_frame c_msg;
-  poseInFrameToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_pose_in_frame(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError PoseInFrameChannel::logBatch(
+  const PoseInFrame* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void PoseInFrameChannel::close() noexcept {
@@ -1294,12 +1790,19 @@ bool PoseInFrameChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<PosesInFrameChannel> PosesInFrameChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_poses_in_frame(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_poses_in_frame(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_poses_in_frame_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1309,12 +1812,13 @@ FoxgloveResult<PosesInFrameChannel> PosesInFrameChannel::create(
 FoxgloveError PosesInFrameChannel::log(
   const PosesInFrame& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_poses_in_frame c_msg;
-  posesInFrameToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_poses_in_frame(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError PosesInFrameChannel::logBatch(
+  const PosesInFrame* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void PosesInFrameChannel::close() noexcept {
@@ -1330,11 +1834,17 @@ bool PosesInFrameChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<QuaternionChannel> QuaternionChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_quaternion({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_quaternion(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_quaternion_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1344,12 +1854,13 @@ FoxgloveResult<QuaternionChannel> QuaternionChannel::create(
 FoxgloveError QuaternionChannel::log(
   const Quaternion& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  return FoxgloveError(foxglove_channel_log_quaternion(
-    impl_.get(),
-    reinterpret_cast<const foxglove_quaternion*>(&msg),
-    log_time ? &*log_time : nullptr,
-    sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError QuaternionChannel::logBatch(
+  const Quaternion* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void QuaternionChannel::close() noexcept {
@@ -1365,11 +1876,17 @@ bool QuaternionChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<RawAudioChannel> RawAudioChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_raw_audio({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_raw_audio(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_raw_audio_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1379,12 +1896,19 @@ FoxgloveResult<RawAudioChannel> RawAudioChannel::create(
 FoxgloveError RawAudioChannel::log(
   const RawAudio& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_raw_audio c_msg;
-  rawAudioToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_raw_audio(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError RawAudioChannel::log(
+  const RawAudioView& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError RawAudioChannel::logBatch(
+  const RawAudio* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void RawAudioChannel::close() noexcept {
@@ -1400,11 +1924,17 @@ bool RawAudioChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<RawImageChannel> RawImageChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_raw_image({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_raw_image(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_raw_image_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1414,12 +1944,19 @@ FoxgloveResult<RawImageChannel> RawImageChannel::create(
 FoxgloveError RawImageChannel::log(
   const RawImage& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_raw_image c_msg;
-  rawImageToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_raw_image(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError RawImageChannel::log(
+  const RawImageView& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError RawImageChannel::logBatch(
+  const RawImage* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void RawImageChannel::close() noexcept {
@@ -1435,12 +1972,19 @@ bool RawImageChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<SceneEntityChannel> SceneEntityChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_scene_entity(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_scene_entity(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_scene_entity_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1450,12 +1994,13 @@ FoxgloveResult<SceneEntityChannel> SceneEntityChannel::create(
 FoxgloveError SceneEntityChannel::log(
   const SceneEntity& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_scene_entity c_msg;
-  sceneEntityToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_scene_entity(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError SceneEntityChannel::logBatch(
+  const SceneEntity* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void SceneEntityChannel::close() noexcept {
@@ -1471,12 +2016,19 @@ bool SceneEntityChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<SceneEntityDeletionChannel> SceneEntityDeletionChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_scene_entity_deletion(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_scene_entity_deletion(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_scene_entity_deletion_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1486,12 +2038,14 @@ FoxgloveResult<SceneEntityDeletionChannel> SceneEntityDeletionChannel::create(
 FoxgloveError SceneEntityDeletionChannel::log(
   const SceneEntityDeletion& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_scene_entity_deletion c_msg;
-  sceneEntityDeletionToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_scene_entity_deletion(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError SceneEntityDeletionChannel::logBatch(
+  const SceneEntityDeletion* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void SceneEntityDeletionChannel::close() noexcept {
@@ -1507,12 +2061,19 @@ bool SceneEntityDeletionChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<SceneUpdateChannel> SceneUpdateChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_scene_update(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_scene_update(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_scene_update_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1522,12 +2083,13 @@ FoxgloveResult<SceneUpdateChannel> SceneUpdateChannel::create(
 FoxgloveError SceneUpdateChannel::log(
   const SceneUpdate& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_scene_update c_msg;
-  sceneUpdateToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_scene_update(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError SceneUpdateChannel::logBatch(
+  const SceneUpdate* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void SceneUpdateChannel::close() noexcept {
@@ -1543,12 +2105,19 @@ bool SceneUpdateChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<SpherePrimitiveChannel> SpherePrimitiveChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_sphere_primitive(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_sphere_primitive(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_sphere_primitive_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1558,12 +2127,14 @@ FoxgloveResult<SpherePrimitiveChannel> SpherePrimitiveChannel::create(
 FoxgloveError SpherePrimitiveChannel::log(
   const SpherePrimitive& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_sphere_primitive c_msg;
-  spherePrimitiveToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_sphere_primitive(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError SpherePrimitiveChannel::logBatch(
+  const SpherePrimitive* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void SpherePrimitiveChannel::close() noexcept {
@@ -1579,12 +2150,19 @@ bool SpherePrimitiveChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<TextAnnotationChannel> TextAnnotationChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_text_annotation(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_text_annotation(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_text_annotation_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1594,12 +2172,14 @@ FoxgloveResult<TextAnnotationChannel> TextAnnotationChannel::create(
 FoxgloveError TextAnnotationChannel::log(
   const TextAnnotation& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_text_annotation c_msg;
-  textAnnotationToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_text_annotation(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError TextAnnotationChannel::logBatch(
+  const TextAnnotation* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void TextAnnotationChannel::close() noexcept {
@@ -1615,12 +2195,19 @@ bool TextAnnotationChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<TextPrimitiveChannel> TextPrimitiveChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_text_primitive(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_text_primitive(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_text_primitive_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1630,12 +2217,14 @@ FoxgloveResult<TextPrimitiveChannel> TextPrimitiveChannel::create(
 FoxgloveError TextPrimitiveChannel::log(
   const TextPrimitive& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_text_primitive c_msg;
-  textPrimitiveToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_text_primitive(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError TextPrimitiveChannel::logBatch(
+  const TextPrimitive* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void TextPrimitiveChannel::close() noexcept {
@@ -1651,12 +2240,19 @@ bool TextPrimitiveChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<TriangleListPrimitiveChannel> TriangleListPrimitiveChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error = foxglove_channel_create_triangle_list_primitive(
-    {topic.data(), topic.size()}, context.getInner(), &channel
-  );
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_triangle_list_primitive(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(
+      topic, foxglove_triangle_list_primitive_schema(), context, keep_last, &channel
+    );
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1667,12 +2263,14 @@ FoxgloveError TriangleListPrimitiveChannel::log(
   const TriangleListPrimitive& msg, std::optional<uint64_t> log_time,
   std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_triangle_list_primitive c_msg;
-  triangleListPrimitiveToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_triangle_list_primitive(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError TriangleListPrimitiveChannel::logBatch(
+  const TriangleListPrimitive* msgs, size_t count, const uint64_t* log_times,
+  std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void TriangleListPrimitiveChannel::close() noexcept {
@@ -1688,11 +2286,17 @@ bool TriangleListPrimitiveChannel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<Vector2Channel> Vector2Channel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_vector2({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_vector2(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_vector2_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1702,12 +2306,13 @@ FoxgloveResult<Vector2Channel> Vector2Channel::create(
 FoxgloveError Vector2Channel::log(
   const Vector2& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  return FoxgloveError(foxglove_channel_log_vector2(
-    impl_.get(),
-    reinterpret_cast<const foxglove_vector2*>(&msg),
-    log_time ? &*log_time : nullptr,
-    sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError Vector2Channel::logBatch(
+  const Vector2* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void Vector2Channel::close() noexcept {
@@ -1723,11 +2328,17 @@ bool Vector2Channel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<Vector3Channel> Vector3Channel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_vector3({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_vector3(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_vector3_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1737,12 +2348,13 @@ FoxgloveResult<Vector3Channel> Vector3Channel::create(
 FoxgloveError Vector3Channel::log(
   const Vector3& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  return FoxgloveError(foxglove_channel_log_vector3(
-    impl_.get(),
-    reinterpret_cast<const foxglove_vector3*>(&msg),
-    log_time ? &*log_time : nullptr,
-    sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError Vector3Channel::logBatch(
+  const Vector3* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void Vector3Channel::close() noexcept {
@@ -1758,11 +2370,17 @@ bool Vector3Channel::hasSinks() const noexcept {
 }
 
 FoxgloveResult<VoxelGridChannel> VoxelGridChannel::create(
-  const std::string_view& topic, const Context& context
+  const std::string_view& topic, const Context& context, size_t keep_last
 ) {
   const foxglove_channel* channel = nullptr;
-  foxglove_error error =
-    foxglove_channel_create_voxel_grid({topic.data(), topic.size()}, context.getInner(), &channel);
+  foxglove_error error;
+  if (keep_last == 0) {
+    error = foxglove_channel_create_voxel_grid(
+      {topic.data(), topic.size()}, context.getInner(), &channel
+    );
+  } else {
+    error = createLatchedChannel(topic, foxglove_voxel_grid_schema(), context, keep_last, &channel);
+  }
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {
     return tl::unexpected(FoxgloveError(error));
   }
@@ -1772,12 +2390,19 @@ FoxgloveResult<VoxelGridChannel> VoxelGridChannel::create(
 FoxgloveError VoxelGridChannel::log(
   const VoxelGrid& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
 ) noexcept {
-  Arena arena;
-  foxglove_voxel_grid c_msg;
-  voxelGridToC(c_msg, msg, arena);
-  return FoxgloveError(foxglove_channel_log_voxel_grid(
-    impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0
-  ));
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError VoxelGridChannel::log(
+  const VoxelGridView& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncoded(impl_.get(), msg, log_time, sink_id);
+}
+
+FoxgloveError VoxelGridChannel::logBatch(
+  const VoxelGrid* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id
+) noexcept {
+  return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);
 }
 
 void VoxelGridChannel::close() noexcept {
@@ -1794,857 +2419,1114 @@ bool VoxelGridChannel::hasSinks() const noexcept {
 
 #endif
 
-void arrowPrimitiveToC(
-  foxglove_arrow_primitive& dest, const ArrowPrimitive& src, [[maybe_unused]] Arena& arena
-) {
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.shaft_length = src.shaft_length;
-  dest.shaft_diameter = src.shaft_diameter;
-  dest.head_length = src.head_length;
-  dest.head_diameter = src.head_diameter;
-  dest.color = src.color ? reinterpret_cast<const foxglove_color*>(&*src.color) : nullptr;
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const ArrowPrimitive& msg) {
+  enc.message(1, msg.pose);
+  enc.float64(2, msg.shaft_length);
+  enc.float64(3, msg.shaft_diameter);
+  enc.float64(4, msg.head_length);
+  enc.float64(5, msg.head_diameter);
+  enc.message(6, msg.color);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CameraCalibration& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.fixed32(2, msg.width);
+  enc.fixed32(3, msg.height);
+  enc.string(4, msg.distortion_model);
+  enc.packedFloat64(5, msg.d);
+  enc.packedFloat64(6, msg.k);
+  enc.packedFloat64(7, msg.r);
+  enc.packedFloat64(8, msg.p);
+  enc.string(9, msg.frame_id);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CircleAnnotation& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.message(2, msg.position);
+  enc.float64(3, msg.diameter);
+  enc.float64(4, msg.thickness);
+  enc.message(5, msg.fill_color);
+  enc.message(6, msg.outline_color);
+  enc.messages(7, msg.metadata);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Color& msg) {
+  enc.float64(1, msg.r);
+  enc.float64(2, msg.g);
+  enc.float64(3, msg.b);
+  enc.float64(4, msg.a);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedAudio& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.bytes(2, msg.data.data(), msg.data.size());
+  enc.string(3, msg.format);
 }
 
-void cameraCalibrationToC(
-  foxglove_camera_calibration& dest, const CameraCalibration& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.width = src.width;
-  dest.height = src.height;
-  dest.distortion_model = {src.distortion_model.data(), src.distortion_model.size()};
-  dest.d = src.d.data();
-  dest.d_count = src.d.size();
-  ::memcpy(dest.k, src.k.data(), src.k.size() * sizeof(*src.k.data()));
-  ::memcpy(dest.r, src.r.data(), src.r.size() * sizeof(*src.r.data()));
-  ::memcpy(dest.p, src.p.data(), src.p.size() * sizeof(*src.p.data()));
-}
-
-void circleAnnotationToC(
-  foxglove_circle_annotation& dest, const CircleAnnotation& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.position = src.position ? reinterpret_cast<const foxglove_point2*>(&*src.position) : nullptr;
-  dest.diameter = src.diameter;
-  dest.thickness = src.thickness;
-  dest.fill_color =
-    src.fill_color ? reinterpret_cast<const foxglove_color*>(&*src.fill_color) : nullptr;
-  dest.outline_color =
-    src.outline_color ? reinterpret_cast<const foxglove_color*>(&*src.outline_color) : nullptr;
-  dest.metadata = arena.map<foxglove_key_value_pair>(src.metadata, keyValuePairToC);
-  dest.metadata_count = src.metadata.size();
-}
-
-void compressedAudioToC(
-  foxglove_compressed_audio& dest, const CompressedAudio& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
-  dest.format = {src.format.data(), src.format.size()};
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedAudioView& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.bytes(2, msg.data, msg.data_len);
+  enc.string(3, msg.format);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedImage& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.bytes(2, msg.data.data(), msg.data.size());
+  enc.string(3, msg.format);
+  enc.string(4, msg.frame_id);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedImageView& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.bytes(2, msg.data, msg.data_len);
+  enc.string(3, msg.format);
+  enc.string(4, msg.frame_id);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedPointCloud& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+  enc.bytes(4, msg.data.data(), msg.data.size());
+  enc.string(5, msg.format);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedPointCloudView& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+  enc.bytes(4, msg.data, msg.data_len);
+  enc.string(5, msg.format);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedVideo& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.bytes(3, msg.data.data(), msg.data.size());
+  enc.string(4, msg.format);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CompressedVideoView& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.bytes(3, msg.data, msg.data_len);
+  enc.string(4, msg.format);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CubePrimitive& msg) {
+  enc.message(1, msg.pose);
+  enc.message(2, msg.size);
+  enc.message(3, msg.color);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const CylinderPrimitive& msg) {
+  enc.message(1, msg.pose);
+  enc.message(2, msg.size);
+  enc.float64(3, msg.bottom_scale);
+  enc.float64(4, msg.top_scale);
+  enc.message(5, msg.color);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Event& msg) {
+  enc.timestamp(1, msg.start_time);
+  enc.timestamp(2, msg.end_time);
+  enc.messages(3, msg.metadata);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const FrameTransform& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.parent_frame_id);
+  enc.string(3, msg.child_frame_id);
+  enc.message(4, msg.translation);
+  enc.message(5, msg.rotation);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const FrameTransforms& msg) {
+  enc.messages(1, msg.transforms);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const GeoJSON& msg) {
+  enc.string(1, msg.geojson);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Grid& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+  enc.fixed32(4, msg.column_count);
+  enc.message(5, msg.cell_size);
+  enc.fixed32(6, msg.row_stride);
+  enc.fixed32(7, msg.cell_stride);
+  enc.messages(8, msg.fields);
+  enc.bytes(9, msg.data.data(), msg.data.size());
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const GridView& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+  enc.fixed32(4, msg.column_count);
+  enc.message(5, msg.cell_size);
+  enc.fixed32(6, msg.row_stride);
+  enc.fixed32(7, msg.cell_stride);
+  enc.messages(8, msg.fields);
+  enc.bytes(9, msg.data, msg.data_len);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const ImageAnnotations& msg) {
+  enc.messages(1, msg.circles);
+  enc.messages(2, msg.points);
+  enc.messages(3, msg.texts);
+  enc.messages(4, msg.metadata);
+  enc.timestamp(5, msg.timestamp);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const JointState& msg) {
+  enc.string(1, msg.name);
+  enc.float64(2, msg.position);
+  enc.float64(3, msg.velocity);
+  enc.float64(4, msg.acceleration);
+  enc.float64(5, msg.effort);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const JointStates& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.messages(2, msg.joints);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const KeyValuePair& msg) {
+  enc.string(1, msg.key);
+  enc.string(2, msg.value);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const LaserScan& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+  enc.float64(4, msg.start_angle);
+  enc.float64(5, msg.end_angle);
+  enc.packedFloat64(6, msg.ranges);
+  enc.packedFloat64(7, msg.intensities);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const LinePrimitive& msg) {
+  enc.enumeration(1, msg.type);
+  enc.message(2, msg.pose);
+  enc.float64(3, msg.thickness);
+  enc.boolean(4, msg.scale_invariant);
+  enc.messages(5, msg.points);
+  enc.message(6, msg.color);
+  enc.messages(7, msg.colors);
+  enc.packedFixed32(8, msg.indices);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const LocationFix& msg) {
+  enc.float64(1, msg.latitude);
+  enc.float64(2, msg.longitude);
+  enc.float64(3, msg.altitude);
+  enc.packedFloat64(4, msg.position_covariance);
+  enc.enumeration(5, msg.position_covariance_type);
+  enc.timestamp(6, msg.timestamp);
+  enc.string(7, msg.frame_id);
+  enc.message(8, msg.color);
+  enc.messages(9, msg.metadata);
+  enc.float64(10, msg.heading);
+  enc.message(11, msg.velocity);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const LocationFixes& msg) {
+  enc.messages(1, msg.fixes);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Log& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.enumeration(2, msg.level);
+  enc.string(3, msg.message);
+  enc.string(4, msg.name);
+  enc.string(5, msg.file);
+  enc.fixed32(6, msg.line);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const ModelPrimitive& msg) {
+  enc.message(1, msg.pose);
+  enc.message(2, msg.scale);
+  enc.message(3, msg.color);
+  enc.boolean(4, msg.override_color);
+  enc.string(5, msg.url);
+  enc.string(6, msg.media_type);
+  enc.bytes(7, msg.data.data(), msg.data.size());
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const ModelPrimitiveView& msg) {
+  enc.message(1, msg.pose);
+  enc.message(2, msg.scale);
+  enc.message(3, msg.color);
+  enc.boolean(4, msg.override_color);
+  enc.string(5, msg.url);
+  enc.string(6, msg.media_type);
+  enc.bytes(7, msg.data, msg.data_len);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Odometry& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.string(3, msg.body_frame_id);
+  enc.message(4, msg.pose);
+  enc.message(5, msg.linear_velocity);
+  enc.message(6, msg.angular_velocity);
+  enc.packedFloat64(7, msg.pose_covariance);
+  enc.packedFloat64(8, msg.velocity_covariance);
+  enc.messages(9, msg.metadata);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PackedElementField& msg) {
+  enc.string(1, msg.name);
+  enc.fixed32(2, msg.offset);
+  enc.enumeration(3, msg.type);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Point2& msg) {
+  enc.float64(1, msg.x);
+  enc.float64(2, msg.y);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Point3& msg) {
+  enc.float64(1, msg.x);
+  enc.float64(2, msg.y);
+  enc.float64(3, msg.z);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Point3InFrame& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.point);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PointCloud& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+  enc.fixed32(4, msg.point_stride);
+  enc.messages(5, msg.fields);
+  enc.bytes(6, msg.data.data(), msg.data.size());
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PointCloudView& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+  enc.fixed32(4, msg.point_stride);
+  enc.messages(5, msg.fields);
+  enc.bytes(6, msg.data, msg.data_len);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PointsAnnotation& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.enumeration(2, msg.type);
+  enc.messages(3, msg.points);
+  enc.message(4, msg.outline_color);
+  enc.messages(5, msg.outline_colors);
+  enc.message(6, msg.fill_color);
+  enc.float64(7, msg.thickness);
+  enc.messages(8, msg.metadata);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Pose& msg) {
+  enc.message(1, msg.position);
+  enc.message(2, msg.orientation);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PoseInFrame& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const PosesInFrame& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.messages(3, msg.poses);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Quaternion& msg) {
+  enc.float64(1, msg.x);
+  enc.float64(2, msg.y);
+  enc.float64(3, msg.z);
+  enc.float64(4, msg.w);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const RawAudio& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.bytes(2, msg.data.data(), msg.data.size());
+  enc.string(3, msg.format);
+  enc.fixed32(4, msg.sample_rate);
+  enc.fixed32(5, msg.number_of_channels);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const RawAudioView& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.bytes(2, msg.data, msg.data_len);
+  enc.string(3, msg.format);
+  enc.fixed32(4, msg.sample_rate);
+  enc.fixed32(5, msg.number_of_channels);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const RawImage& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.fixed32(2, msg.width);
+  enc.fixed32(3, msg.height);
+  enc.string(4, msg.encoding);
+  enc.fixed32(5, msg.step);
+  enc.bytes(6, msg.data.data(), msg.data.size());
+  enc.string(7, msg.frame_id);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const RawImageView& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.fixed32(2, msg.width);
+  enc.fixed32(3, msg.height);
+  enc.string(4, msg.encoding);
+  enc.fixed32(5, msg.step);
+  enc.bytes(6, msg.data, msg.data_len);
+  enc.string(7, msg.frame_id);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const SceneEntity& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.string(3, msg.id);
+  enc.duration(4, msg.lifetime);
+  enc.boolean(5, msg.frame_locked);
+  enc.messages(6, msg.metadata);
+  enc.messages(7, msg.arrows);
+  enc.messages(8, msg.cubes);
+  enc.messages(9, msg.spheres);
+  enc.messages(10, msg.cylinders);
+  enc.messages(11, msg.lines);
+  enc.messages(12, msg.triangles);
+  enc.messages(13, msg.texts);
+  enc.messages(14, msg.models);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const SceneEntityDeletion& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.enumeration(2, msg.type);
+  enc.string(3, msg.id);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const SceneUpdate& msg) {
+  enc.messages(1, msg.deletions);
+  enc.messages(2, msg.entities);
+}
+
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const SpherePrimitive& msg) {
+  enc.message(1, msg.pose);
+  enc.message(2, msg.size);
+  enc.message(3, msg.color);
 }
 
-void compressedImageToC(
-  foxglove_compressed_image& dest, const CompressedImage& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
-  dest.format = {src.format.data(), src.format.size()};
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const TextAnnotation& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.message(2, msg.position);
+  enc.string(3, msg.text);
+  enc.float64(4, msg.font_size);
+  enc.message(5, msg.text_color);
+  enc.message(6, msg.background_color);
+  enc.messages(7, msg.metadata);
 }
 
-void compressedPointCloudToC(
-  foxglove_compressed_point_cloud& dest, const CompressedPointCloud& src,
-  [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
-  dest.format = {src.format.data(), src.format.size()};
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const TextPrimitive& msg) {
+  enc.message(1, msg.pose);
+  enc.boolean(2, msg.billboard);
+  enc.float64(3, msg.font_size);
+  enc.boolean(4, msg.scale_invariant);
+  enc.message(5, msg.color);
+  enc.string(6, msg.text);
 }
 
-void compressedVideoToC(
-  foxglove_compressed_video& dest, const CompressedVideo& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
-  dest.format = {src.format.data(), src.format.size()};
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const TriangleListPrimitive& msg) {
+  enc.message(1, msg.pose);
+  enc.messages(2, msg.points);
+  enc.message(3, msg.color);
+  enc.messages(4, msg.colors);
+  enc.packedFixed32(5, msg.indices);
 }
 
-void cubePrimitiveToC(
-  foxglove_cube_primitive& dest, const CubePrimitive& src, [[maybe_unused]] Arena& arena
-) {
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.size = src.size ? reinterpret_cast<const foxglove_vector3*>(&*src.size) : nullptr;
-  dest.color = src.color ? reinterpret_cast<const foxglove_color*>(&*src.color) : nullptr;
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Vector2& msg) {
+  enc.float64(1, msg.x);
+  enc.float64(2, msg.y);
 }
 
-void cylinderPrimitiveToC(
-  foxglove_cylinder_primitive& dest, const CylinderPrimitive& src, [[maybe_unused]] Arena& arena
-) {
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.size = src.size ? reinterpret_cast<const foxglove_vector3*>(&*src.size) : nullptr;
-  dest.bottom_scale = src.bottom_scale;
-  dest.top_scale = src.top_scale;
-  dest.color = src.color ? reinterpret_cast<const foxglove_color*>(&*src.color) : nullptr;
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const Vector3& msg) {
+  enc.float64(1, msg.x);
+  enc.float64(2, msg.y);
+  enc.float64(3, msg.z);
 }
 
-void eventToC(foxglove_event& dest, const Event& src, [[maybe_unused]] Arena& arena) {
-  dest.start_time =
-    src.start_time ? reinterpret_cast<const foxglove_timestamp*>(&*src.start_time) : nullptr;
-  dest.end_time =
-    src.end_time ? reinterpret_cast<const foxglove_timestamp*>(&*src.end_time) : nullptr;
-  dest.metadata = arena.map<foxglove_key_value_pair>(src.metadata, keyValuePairToC);
-  dest.metadata_count = src.metadata.size();
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const VoxelGrid& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+  enc.fixed32(4, msg.row_count);
+  enc.fixed32(5, msg.column_count);
+  enc.message(6, msg.cell_size);
+  enc.fixed32(7, msg.slice_stride);
+  enc.fixed32(8, msg.row_stride);
+  enc.fixed32(9, msg.cell_stride);
+  enc.messages(10, msg.fields);
+  enc.bytes(11, msg.data.data(), msg.data.size());
 }
 
-void frameTransformToC(
-  foxglove_frame_transform& dest, const FrameTransform& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.parent_frame_id = {src.parent_frame_id.data(), src.parent_frame_id.size()};
-  dest.child_frame_id = {src.child_frame_id.data(), src.child_frame_id.size()};
-  dest.translation =
-    src.translation ? reinterpret_cast<const foxglove_vector3*>(&*src.translation) : nullptr;
-  dest.rotation =
-    src.rotation ? reinterpret_cast<const foxglove_quaternion*>(&*src.rotation) : nullptr;
-}
-
-void frameTransformsToC(
-  foxglove_frame_transforms& dest, const FrameTransforms& src, [[maybe_unused]] Arena& arena
-) {
-  dest.transforms = arena.map<foxglove_frame_transform>(src.transforms, frameTransformToC);
-  dest.transforms_count = src.transforms.size();
+template<typename Encoder>
+static void protobufFields(Encoder& enc, const VoxelGridView& msg) {
+  enc.timestamp(1, msg.timestamp);
+  enc.string(2, msg.frame_id);
+  enc.message(3, msg.pose);
+  enc.fixed32(4, msg.row_count);
+  enc.fixed32(5, msg.column_count);
+  enc.message(6, msg.cell_size);
+  enc.fixed32(7, msg.slice_stride);
+  enc.fixed32(8, msg.row_stride);
+  enc.fixed32(9, msg.cell_stride);
+  enc.messages(10, msg.fields);
+  enc.bytes(11, msg.data, msg.data_len);
 }
 
-void geoJSONToC(foxglove_geo_json& dest, const GeoJSON& src, [[maybe_unused]] Arena& arena) {
-  dest.geojson = {src.geojson.data(), src.geojson.size()};
+
+FoxgloveError ArrowPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-void gridToC(foxglove_grid& dest, const Grid& src, [[maybe_unused]] Arena& arena) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.column_count = src.column_count;
-  dest.cell_size =
-    src.cell_size ? reinterpret_cast<const foxglove_vector2*>(&*src.cell_size) : nullptr;
-  dest.row_stride = src.row_stride;
-  dest.cell_stride = src.cell_stride;
-  dest.fields = arena.map<foxglove_packed_element_field>(src.fields, packedElementFieldToC);
-  dest.fields_count = src.fields.size();
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
+FoxgloveError ArrowPrimitive::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-void imageAnnotationsToC(
-  foxglove_image_annotations& dest, const ImageAnnotations& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.circles = arena.map<foxglove_circle_annotation>(src.circles, circleAnnotationToC);
-  dest.circles_count = src.circles.size();
-  dest.points = arena.map<foxglove_points_annotation>(src.points, pointsAnnotationToC);
-  dest.points_count = src.points.size();
-  dest.texts = arena.map<foxglove_text_annotation>(src.texts, textAnnotationToC);
-  dest.texts_count = src.texts.size();
-  dest.metadata = arena.map<foxglove_key_value_pair>(src.metadata, keyValuePairToC);
-  dest.metadata_count = src.metadata.size();
-}
-
-void jointStateToC(
-  foxglove_joint_state& dest, const JointState& src, [[maybe_unused]] Arena& arena
-) {
-  dest.name = {src.name.data(), src.name.size()};
-  dest.position = src.position ? &*src.position : nullptr;
-  dest.velocity = src.velocity ? &*src.velocity : nullptr;
-  dest.acceleration = src.acceleration ? &*src.acceleration : nullptr;
-  dest.effort = src.effort ? &*src.effort : nullptr;
+FoxgloveResult<size_t> ArrowPrimitive::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-void jointStatesToC(
-  foxglove_joint_states& dest, const JointStates& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.joints = arena.map<foxglove_joint_state>(src.joints, jointStateToC);
-  dest.joints_count = src.joints.size();
+FoxgloveError CameraCalibration::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-void keyValuePairToC(
-  foxglove_key_value_pair& dest, const KeyValuePair& src, [[maybe_unused]] Arena& arena
-) {
-  dest.key = {src.key.data(), src.key.size()};
-  dest.value = {src.value.data(), src.value.size()};
+FoxgloveError CameraCalibration::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-void laserScanToC(foxglove_laser_scan& dest, const LaserScan& src, [[maybe_unused]] Arena& arena) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.start_angle = src.start_angle;
-  dest.end_angle = src.end_angle;
-  dest.ranges = src.ranges.data();
-  dest.ranges_count = src.ranges.size();
-  dest.intensities = src.intensities.data();
-  dest.intensities_count = src.intensities.size();
+FoxgloveResult<size_t> CameraCalibration::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-void linePrimitiveToC(
-  foxglove_line_primitive& dest, const LinePrimitive& src, [[maybe_unused]] Arena& arena
-) {
-  dest.type = static_cast<foxglove_line_type>(src.type);
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.thickness = src.thickness;
-  dest.scale_invariant = src.scale_invariant;
-  dest.points = reinterpret_cast<const foxglove_point3*>(src.points.data());
-  dest.points_count = src.points.size();
-  dest.color = src.color ? reinterpret_cast<const foxglove_color*>(&*src.color) : nullptr;
-  dest.colors = reinterpret_cast<const foxglove_color*>(src.colors.data());
-  dest.colors_count = src.colors.size();
-  dest.indices = src.indices.data();
-  dest.indices_count = src.indices.size();
-}
-
-void locationFixToC(
-  foxglove_location_fix& dest, const LocationFix& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.latitude = src.latitude;
-  dest.longitude = src.longitude;
-  dest.altitude = src.altitude;
-  ::memcpy(
-    dest.position_covariance,
-    src.position_covariance.data(),
-    src.position_covariance.size() * sizeof(*src.position_covariance.data())
-  );
-  dest.position_covariance_type =
-    static_cast<foxglove_position_covariance_type>(src.position_covariance_type);
-  dest.heading = src.heading ? &*src.heading : nullptr;
-  dest.velocity =
-    src.velocity ? reinterpret_cast<const foxglove_vector3*>(&*src.velocity) : nullptr;
-  dest.color = src.color ? reinterpret_cast<const foxglove_color*>(&*src.color) : nullptr;
-  dest.metadata = arena.map<foxglove_key_value_pair>(src.metadata, keyValuePairToC);
-  dest.metadata_count = src.metadata.size();
-}
-
-void locationFixesToC(
-  foxglove_location_fixes& dest, const LocationFixes& src, [[maybe_unused]] Arena& arena
-) {
-  dest.fixes = arena.map<foxglove_location_fix>(src.fixes, locationFixToC);
-  dest.fixes_count = src.fixes.size();
+FoxgloveError CircleAnnotation::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-void logToC(foxglove_log& dest, const Log& src, [[maybe_unused]] Arena& arena) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.level = static_cast<foxglove_log_level>(src.level);
-  dest.message = {src.message.data(), src.message.size()};
-  dest.name = {src.name.data(), src.name.size()};
-  dest.file = {src.file.data(), src.file.size()};
-  dest.line = src.line;
+FoxgloveError CircleAnnotation::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-void modelPrimitiveToC(
-  foxglove_model_primitive& dest, const ModelPrimitive& src, [[maybe_unused]] Arena& arena
-) {
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.scale = src.scale ? reinterpret_cast<const foxglove_vector3*>(&*src.scale) : nullptr;
-  dest.color = src.color ? reinterpret_cast<const foxglove_color*>(&*src.color) : nullptr;
-  dest.override_color = src.override_color;
-  dest.url = {src.url.data(), src.url.size()};
-  dest.media_type = {src.media_type.data(), src.media_type.size()};
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
-}
-
-void odometryToC(foxglove_odometry& dest, const Odometry& src, [[maybe_unused]] Arena& arena) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.body_frame_id = {src.body_frame_id.data(), src.body_frame_id.size()};
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.linear_velocity = src.linear_velocity
-                           ? reinterpret_cast<const foxglove_vector3*>(&*src.linear_velocity)
-                           : nullptr;
-  dest.angular_velocity = src.angular_velocity
-                            ? reinterpret_cast<const foxglove_vector3*>(&*src.angular_velocity)
-                            : nullptr;
-  ::memcpy(
-    dest.pose_covariance,
-    src.pose_covariance.data(),
-    src.pose_covariance.size() * sizeof(*src.pose_covariance.data())
-  );
-  ::memcpy(
-    dest.velocity_covariance,
-    src.velocity_covariance.data(),
-    src.velocity_covariance.size() * sizeof(*src.velocity_covariance.data())
-  );
-  dest.metadata = arena.map<foxglove_key_value_pair>(src.metadata, keyValuePairToC);
-  dest.metadata_count = src.metadata.size();
+FoxgloveResult<size_t> CircleAnnotation::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-void packedElementFieldToC(
-  foxglove_packed_element_field& dest, const PackedElementField& src, [[maybe_unused]] Arena& arena
-) {
-  dest.name = {src.name.data(), src.name.size()};
-  dest.offset = src.offset;
-  dest.type = static_cast<foxglove_numeric_type>(src.type);
+FoxgloveError Color::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-void point3InFrameToC(
-  foxglove_point3_in_frame& dest, const Point3InFrame& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.point = src.point ? reinterpret_cast<const foxglove_point3*>(&*src.point) : nullptr;
+FoxgloveError Color::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-void pointCloudToC(
-  foxglove_point_cloud& dest, const PointCloud& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.point_stride = src.point_stride;
-  dest.fields = arena.map<foxglove_packed_element_field>(src.fields, packedElementFieldToC);
-  dest.fields_count = src.fields.size();
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
-}
-
-void pointsAnnotationToC(
-  foxglove_points_annotation& dest, const PointsAnnotation& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.type = static_cast<foxglove_points_annotation_type>(src.type);
-  dest.points = reinterpret_cast<const foxglove_point2*>(src.points.data());
-  dest.points_count = src.points.size();
-  dest.outline_color =
-    src.outline_color ? reinterpret_cast<const foxglove_color*>(&*src.outline_color) : nullptr;
-  dest.outline_colors = reinterpret_cast<const foxglove_color*>(src.outline_colors.data());
-  dest.outline_colors_count = src.outline_colors.size();
-  dest.fill_color =
-    src.fill_color ? reinterpret_cast<const foxglove_color*>(&*src.fill_color) : nullptr;
-  dest.thickness = src.thickness;
-  dest.metadata = arena.map<foxglove_key_value_pair>(src.metadata, keyValuePairToC);
-  dest.metadata_count = src.metadata.size();
-}
-
-void poseToC(foxglove_pose& dest, const Pose& src, [[maybe_unused]] Arena& arena) {
-  dest.position =
-    src.position ? reinterpret_cast<const foxglove_vector3*>(&*src.position) : nullptr;
-  dest.orientation =
-    src.orientation ? reinterpret_cast<const foxglove_quaternion*>(&*src.orientation) : nullptr;
-}
-
-void poseInFrameToC(
-  foxglove_pose_in_frame& dest, const PoseInFrame& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
+FoxgloveResult<size_t> Color::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-void posesInFrameToC(
-  foxglove_poses_in_frame& dest, const PosesInFrame& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.poses = arena.map<foxglove_pose>(src.poses, poseToC);
-  dest.poses_count = src.poses.size();
-}
-
-void rawAudioToC(foxglove_raw_audio& dest, const RawAudio& src, [[maybe_unused]] Arena& arena) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
-  dest.format = {src.format.data(), src.format.size()};
-  dest.sample_rate = src.sample_rate;
-  dest.number_of_channels = src.number_of_channels;
-}
-
-void rawImageToC(foxglove_raw_image& dest, const RawImage& src, [[maybe_unused]] Arena& arena) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.width = src.width;
-  dest.height = src.height;
-  dest.encoding = {src.encoding.data(), src.encoding.size()};
-  dest.step = src.step;
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
-}
-
-void sceneEntityToC(
-  foxglove_scene_entity& dest, const SceneEntity& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.id = {src.id.data(), src.id.size()};
-  dest.lifetime =
-    src.lifetime ? reinterpret_cast<const foxglove_duration*>(&*src.lifetime) : nullptr;
-  dest.frame_locked = src.frame_locked;
-  dest.metadata = arena.map<foxglove_key_value_pair>(src.metadata, keyValuePairToC);
-  dest.metadata_count = src.metadata.size();
-  dest.arrows = arena.map<foxglove_arrow_primitive>(src.arrows, arrowPrimitiveToC);
-  dest.arrows_count = src.arrows.size();
-  dest.cubes = arena.map<foxglove_cube_primitive>(src.cubes, cubePrimitiveToC);
-  dest.cubes_count = src.cubes.size();
-  dest.spheres = arena.map<foxglove_sphere_primitive>(src.spheres, spherePrimitiveToC);
-  dest.spheres_count = src.spheres.size();
-  dest.cylinders = arena.map<foxglove_cylinder_primitive>(src.cylinders, cylinderPrimitiveToC);
-  dest.cylinders_count = src.cylinders.size();
-  dest.lines = arena.map<foxglove_line_primitive>(src.lines, linePrimitiveToC);
-  dest.lines_count = src.lines.size();
-  dest.triangles =
-    arena.map<foxglove_triangle_list_primitive>(src.triangles, triangleListPrimitiveToC);
-  dest.triangles_count = src.triangles.size();
-  dest.texts = arena.map<foxglove_text_primitive>(src.texts, textPrimitiveToC);
-  dest.texts_count = src.texts.size();
-  dest.models = arena.map<foxglove_model_primitive>(src.models, modelPrimitiveToC);
-  dest.models_count = src.models.size();
-}
-
-void sceneEntityDeletionToC(
-  foxglove_scene_entity_deletion& dest, const SceneEntityDeletion& src,
-  [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.type = static_cast<foxglove_scene_entity_deletion_type>(src.type);
-  dest.id = {src.id.data(), src.id.size()};
+FoxgloveError CompressedAudio::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-void sceneUpdateToC(
-  foxglove_scene_update& dest, const SceneUpdate& src, [[maybe_unused]] Arena& arena
-) {
-  dest.deletions = arena.map<foxglove_scene_entity_deletion>(src.deletions, sceneEntityDeletionToC);
-  dest.deletions_count = src.deletions.size();
-  dest.entities = arena.map<foxglove_scene_entity>(src.entities, sceneEntityToC);
-  dest.entities_count = src.entities.size();
+FoxgloveError CompressedAudio::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-void spherePrimitiveToC(
-  foxglove_sphere_primitive& dest, const SpherePrimitive& src, [[maybe_unused]] Arena& arena
-) {
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.size = src.size ? reinterpret_cast<const foxglove_vector3*>(&*src.size) : nullptr;
-  dest.color = src.color ? reinterpret_cast<const foxglove_color*>(&*src.color) : nullptr;
+FoxgloveResult<size_t> CompressedAudio::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-void textAnnotationToC(
-  foxglove_text_annotation& dest, const TextAnnotation& src, [[maybe_unused]] Arena& arena
-) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.position = src.position ? reinterpret_cast<const foxglove_point2*>(&*src.position) : nullptr;
-  dest.text = {src.text.data(), src.text.size()};
-  dest.font_size = src.font_size;
-  dest.text_color =
-    src.text_color ? reinterpret_cast<const foxglove_color*>(&*src.text_color) : nullptr;
-  dest.background_color = src.background_color
-                            ? reinterpret_cast<const foxglove_color*>(&*src.background_color)
-                            : nullptr;
-  dest.metadata = arena.map<foxglove_key_value_pair>(src.metadata, keyValuePairToC);
-  dest.metadata_count = src.metadata.size();
-}
-
-void textPrimitiveToC(
-  foxglove_text_primitive& dest, const TextPrimitive& src, [[maybe_unused]] Arena& arena
-) {
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.billboard = src.billboard;
-  dest.font_size = src.font_size;
-  dest.scale_invariant = src.scale_invariant;
-  dest.color = src.color ? reinterpret_cast<const foxglove_color*>(&*src.color) : nullptr;
-  dest.text = {src.text.data(), src.text.size()};
+FoxgloveError CompressedImage::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-void triangleListPrimitiveToC(
-  foxglove_triangle_list_primitive& dest, const TriangleListPrimitive& src,
-  [[maybe_unused]] Arena& arena
-) {
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.points = reinterpret_cast<const foxglove_point3*>(src.points.data());
-  dest.points_count = src.points.size();
-  dest.color = src.color ? reinterpret_cast<const foxglove_color*>(&*src.color) : nullptr;
-  dest.colors = reinterpret_cast<const foxglove_color*>(src.colors.data());
-  dest.colors_count = src.colors.size();
-  dest.indices = src.indices.data();
-  dest.indices_count = src.indices.size();
-}
-
-void voxelGridToC(foxglove_voxel_grid& dest, const VoxelGrid& src, [[maybe_unused]] Arena& arena) {
-  dest.timestamp =
-    src.timestamp ? reinterpret_cast<const foxglove_timestamp*>(&*src.timestamp) : nullptr;
-  dest.frame_id = {src.frame_id.data(), src.frame_id.size()};
-  dest.pose = src.pose ? arena.mapOne<foxglove_pose>(src.pose.value(), poseToC) : nullptr;
-  dest.row_count = src.row_count;
-  dest.column_count = src.column_count;
-  dest.cell_size =
-    src.cell_size ? reinterpret_cast<const foxglove_vector3*>(&*src.cell_size) : nullptr;
-  dest.slice_stride = src.slice_stride;
-  dest.row_stride = src.row_stride;
-  dest.cell_stride = src.cell_stride;
-  dest.fields = arena.map<foxglove_packed_element_field>(src.fields, packedElementFieldToC);
-  dest.fields_count = src.fields.size();
-  dest.data = reinterpret_cast<const unsigned char*>(src.data.data());
-  dest.data_len = src.data.size();
-}
-
-FoxgloveError ArrowPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_arrow_primitive c_msg;
-  arrowPrimitiveToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_arrow_primitive_encode(&c_msg, ptr, len, encoded_len));
-}
-
-FoxgloveError CameraCalibration::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_camera_calibration c_msg;
-  cameraCalibrationToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_camera_calibration_encode(&c_msg, ptr, len, encoded_len));
-}
-
-FoxgloveError CircleAnnotation::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_circle_annotation c_msg;
-  circleAnnotationToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_circle_annotation_encode(&c_msg, ptr, len, encoded_len));
-}
-
-FoxgloveError Color::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  return FoxgloveError(
-    foxglove_color_encode(reinterpret_cast<const foxglove_color*>(this), ptr, len, encoded_len)
-  );
+FoxgloveError CompressedImage::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError CompressedAudio::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_compressed_audio c_msg;
-  compressedAudioToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_compressed_audio_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> CompressedImage::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError CompressedImage::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_compressed_image c_msg;
-  compressedImageToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_compressed_image_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError CompressedPointCloud::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError CompressedPointCloud::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_compressed_point_cloud c_msg;
-  compressedPointCloudToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_compressed_point_cloud_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError CompressedPointCloud::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError CompressedVideo::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_compressed_video c_msg;
-  compressedVideoToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_compressed_video_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> CompressedPointCloud::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError CubePrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_cube_primitive c_msg;
-  cubePrimitiveToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_cube_primitive_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError CompressedVideo::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError CylinderPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_cylinder_primitive c_msg;
-  cylinderPrimitiveToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_cylinder_primitive_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError CompressedVideo::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError Event::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_event c_msg;
-  eventToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_event_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> CompressedVideo::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError FrameTransform::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_frame_transform c_msg;
-  frameTransformToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_frame_transform_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError CubePrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError FrameTransforms::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_frame_transforms c_msg;
-  frameTransformsToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_frame_transforms_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError CubePrimitive::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError GeoJSON::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_geo_json c_msg;
-  geoJSONToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_geo_json_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> CubePrimitive::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError Grid::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_grid c_msg;
-  gridToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_grid_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError CylinderPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError ImageAnnotations::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_image_annotations c_msg;
-  imageAnnotationsToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_image_annotations_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError CylinderPrimitive::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError JointState::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_joint_state c_msg;
-  jointStateToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_joint_state_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> CylinderPrimitive::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError JointStates::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_joint_states c_msg;
-  jointStatesToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_joint_states_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError Event::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError KeyValuePair::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_key_value_pair c_msg;
-  keyValuePairToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_key_value_pair_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError Event::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError LaserScan::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_laser_scan c_msg;
-  laserScanToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_laser_scan_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> Event::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError LinePrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_line_primitive c_msg;
-  linePrimitiveToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_line_primitive_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError FrameTransform::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError LocationFix::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_location_fix c_msg;
-  locationFixToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_location_fix_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError FrameTransform::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError LocationFixes::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_location_fixes c_msg;
-  locationFixesToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_location_fixes_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> FrameTransform::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError Log::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_log c_msg;
-  logToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_log_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError FrameTransforms::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError ModelPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_model_primitive c_msg;
-  modelPrimitiveToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_model_primitive_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError FrameTransforms::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError Odometry::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_odometry c_msg;
-  odometryToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_odometry_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> FrameTransforms::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError PackedElementField::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_packed_element_field c_msg;
-  packedElementFieldToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_packed_element_field_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError GeoJSON::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError Point2::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  return FoxgloveError(
-    foxglove_point2_encode(reinterpret_cast<const foxglove_point2*>(this), ptr, len, encoded_len)
-  );
+FoxgloveError GeoJSON::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError Point3::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  return FoxgloveError(
-    foxglove_point3_encode(reinterpret_cast<const foxglove_point3*>(this), ptr, len, encoded_len)
-  );
+FoxgloveResult<size_t> GeoJSON::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError Point3InFrame::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_point3_in_frame c_msg;
-  point3InFrameToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_point3_in_frame_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError Grid::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError PointCloud::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_point_cloud c_msg;
-  pointCloudToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_point_cloud_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError Grid::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError PointsAnnotation::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_points_annotation c_msg;
-  pointsAnnotationToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_points_annotation_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> Grid::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError Pose::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_pose c_msg;
-  poseToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_pose_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError ImageAnnotations::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError PoseInFrame::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_pose_in_frame c_msg;
-  poseInFrameToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_pose_in_frame_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError ImageAnnotations::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError PosesInFrame::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_poses_in_frame c_msg;
-  posesInFrameToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_poses_in_frame_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> ImageAnnotations::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError Quaternion::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  return FoxgloveError(foxglove_quaternion_encode(
-    reinterpret_cast<const foxglove_quaternion*>(this), ptr, len, encoded_len
-  ));
+FoxgloveError JointState::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError RawAudio::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_raw_audio c_msg;
-  rawAudioToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_raw_audio_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError JointState::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError RawImage::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_raw_image c_msg;
-  rawImageToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_raw_image_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> JointState::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError SceneEntity::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_scene_entity c_msg;
-  sceneEntityToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_scene_entity_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError JointStates::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError SceneEntityDeletion::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_scene_entity_deletion c_msg;
-  sceneEntityDeletionToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_scene_entity_deletion_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError JointStates::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError SceneUpdate::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_scene_update c_msg;
-  sceneUpdateToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_scene_update_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> JointStates::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError SpherePrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_sphere_primitive c_msg;
-  spherePrimitiveToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_sphere_primitive_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError KeyValuePair::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError TextAnnotation::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_text_annotation c_msg;
-  textAnnotationToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_text_annotation_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError KeyValuePair::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError TextPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_text_primitive c_msg;
-  textPrimitiveToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_text_primitive_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> KeyValuePair::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
-FoxgloveError TriangleListPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_triangle_list_primitive c_msg;
-  triangleListPrimitiveToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_triangle_list_primitive_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveError LaserScan::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
 }
 
-FoxgloveError Vector2::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  return FoxgloveError(
-    foxglove_vector2_encode(reinterpret_cast<const foxglove_vector2*>(this), ptr, len, encoded_len)
-  );
+FoxgloveError LaserScan::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError Vector3::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  return FoxgloveError(
-    foxglove_vector3_encode(reinterpret_cast<const foxglove_vector3*>(this), ptr, len, encoded_len)
-  );
+FoxgloveResult<size_t> LaserScan::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError LinePrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError LinePrimitive::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
 }
 
-FoxgloveError VoxelGrid::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {
-  Arena arena;
-  foxglove_voxel_grid c_msg;
-  voxelGridToC(c_msg, *this, arena);
-  return FoxgloveError(foxglove_voxel_grid_encode(&c_msg, ptr, len, encoded_len));
+FoxgloveResult<size_t> LinePrimitive::encodedSize() const {
+  return encodedSizeOf(*this);
 }
 
+FoxgloveError LocationFix::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError LocationFix::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> LocationFix::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError LocationFixes::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError LocationFixes::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> LocationFixes::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError Log::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError Log::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> Log::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError ModelPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError ModelPrimitive::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> ModelPrimitive::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError Odometry::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError Odometry::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> Odometry::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError PackedElementField::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError PackedElementField::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> PackedElementField::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError Point2::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError Point2::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> Point2::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError Point3::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError Point3::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> Point3::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError Point3InFrame::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError Point3InFrame::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> Point3InFrame::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError PointCloud::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError PointCloud::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> PointCloud::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError PointsAnnotation::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError PointsAnnotation::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> PointsAnnotation::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError Pose::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError Pose::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> Pose::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError PoseInFrame::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError PoseInFrame::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> PoseInFrame::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError PosesInFrame::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError PosesInFrame::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> PosesInFrame::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError Quaternion::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError Quaternion::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> Quaternion::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError RawAudio::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError RawAudio::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> RawAudio::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError RawImage::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError RawImage::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> RawImage::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError SceneEntity::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError SceneEntity::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> SceneEntity::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError SceneEntityDeletion::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError SceneEntityDeletion::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> SceneEntityDeletion::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError SceneUpdate::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError SceneUpdate::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> SceneUpdate::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError SpherePrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError SpherePrimitive::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> SpherePrimitive::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError TextAnnotation::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError TextAnnotation::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> TextAnnotation::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError TextPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError TextPrimitive::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> TextPrimitive::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError TriangleListPrimitive::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError TriangleListPrimitive::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> TriangleListPrimitive::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError Vector2::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError Vector2::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> Vector2::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError Vector3::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError Vector3::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> Vector3::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+FoxgloveError VoxelGrid::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {
+  return encodeToBuffer(*this, ptr, len, encoded_len);
+}
+
+FoxgloveError VoxelGrid::encode(std::vector<uint8_t>& buf) const {
+  return encodeAppend(*this, buf);
+}
+
+FoxgloveResult<size_t> VoxelGrid::encodedSize() const {
+  return encodedSizeOf(*this);
+}
+
+
 Schema ArrowPrimitive::schema() {
   struct foxglove_schema c_schema = foxglove_arrow_primitive_schema();
   Schema result;
@@ -1,4 +1,5 @@
 #include <foxglove-c/foxglove-c.h>
+#include <foxglove/arena.hpp>
 #include <foxglove/error.hpp>
 #include <foxglove/parameter.hpp>
 
@@ -373,6 +374,9 @@ ParameterArray::ParameterArray(std::vector<Parameter>&& params)
   impl_.reset(array_ptr);
 }
 
+ParameterArray::ParameterArray(foxglove_parameter_array* ptr)
+    : impl_(ptr) {}
+
 ParameterArrayView ParameterArray::view() const noexcept {
   return ParameterArrayView(impl_.get());
 }
@@ -381,4 +385,139 @@ foxglove_parameter_array* ParameterArray::release() noexcept {
   return impl_.release();
 }
 
+/**
+ * ParameterArrayBuilder implementation
+ */
+struct ParameterArrayBuilder::Impl {
+  Arena arena;
+  std::vector<foxglove_parameter_desc> params;
+
+  foxglove_parameter_value_desc* value(foxglove_parameter_value_tag tag) {
+    auto* desc = arena.alloc<foxglove_parameter_value_desc>(1);
+    desc->tag = tag;
+    return desc;
+  }
+};
+
+ParameterArrayBuilder::ParameterArrayBuilder()
+    : impl_(std::make_unique<Impl>()) {}
+
+ParameterArrayBuilder::~ParameterArrayBuilder() = default;
+ParameterArrayBuilder::ParameterArrayBuilder(ParameterArrayBuilder&& other) noexcept = default;
+ParameterArrayBuilder& ParameterArrayBuilder::operator=(ParameterArrayBuilder&& other
+) noexcept = default;
+
+// Union members are written according to the tag.
+// NOLINTBEGIN(cppcoreguidelines-pro-type-union-access)
+ParameterArrayBuilder::Value ParameterArrayBuilder::float64(double value) {
+  auto* desc = impl_->value(FOXGLOVE_PARAMETER_VALUE_TAG_FLOAT64);
+  desc->data.float64 = value;
+  return Value(desc);
+}
+
+ParameterArrayBuilder::Value ParameterArrayBuilder::integer(int64_t value) {
+  auto* desc = impl_->value(FOXGLOVE_PARAMETER_VALUE_TAG_INTEGER);
+  desc->data.integer = value;
+  return Value(desc);
+}
+
+ParameterArrayBuilder::Value ParameterArrayBuilder::boolean(bool value) {
+  auto* desc = impl_->value(FOXGLOVE_PARAMETER_VALUE_TAG_BOOLEAN);
+  desc->data.boolean = value;
+  return Value(desc);
+}
+
+ParameterArrayBuilder::Value ParameterArrayBuilder::string(std::string_view value) {
+  auto* desc = impl_->value(FOXGLOVE_PARAMETER_VALUE_TAG_STRING);
+  desc->data.string = {value.data(), value.size()};
+  return Value(desc);
+}
+
+ParameterArrayBuilder::Value ParameterArrayBuilder::array(std::initializer_list<Value> values) {
+  return describeArray(values.begin(), values.size());
+}
+
+ParameterArrayBuilder::Value ParameterArrayBuilder::array(const std::vector<Value>& values) {
+  return describeArray(values.data(), values.size());
+}
+
+ParameterArrayBuilder::Value ParameterArrayBuilder::dict(std::initializer_list<Entry> entries) {
+  return describeDict(entries.begin(), entries.size());
+}
+
+ParameterArrayBuilder::Value ParameterArrayBuilder::dict(const std::vector<Entry>& entries) {
+  return describeDict(entries.data(), entries.size());
+}
+
+ParameterArrayBuilder::Value ParameterArrayBuilder::describeArray(
+  const Value* values, size_t count
+) {
+  foxglove_parameter_value_desc* items = nullptr;
+  if (count > 0) {
+    items = impl_->arena.alloc<foxglove_parameter_value_desc>(count);
+    for (size_t i = 0; i < count; ++i) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      items[i] = *values[i].desc_;
+    }
+  }
+  auto* desc = impl_->value(FOXGLOVE_PARAMETER_VALUE_TAG_ARRAY);
+  desc->data.array = {items, count};
+  return Value(desc);
+}
+
+ParameterArrayBuilder::Value ParameterArrayBuilder::describeDict(
+  const Entry* entries, size_t count
+) {
+  foxglove_parameter_value_desc_entry* items = nullptr;
+  if (count > 0) {
+    items = impl_->arena.alloc<foxglove_parameter_value_desc_entry>(count);
+    for (size_t i = 0; i < count; ++i) {
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      const auto& [key, value] = entries[i];
+      items[i] = {{key.data(), key.size()}, value.desc_};
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+  }
+  auto* desc = impl_->value(FOXGLOVE_PARAMETER_VALUE_TAG_DICT);
+  desc->data.dict = {items, count};
+  return Value(desc);
+}
+// NOLINTEND(cppcoreguidelines-pro-type-union-access)
+
+ParameterArrayBuilder& ParameterArrayBuilder::add(std::string_view name) {
+  impl_->params.push_back(
+    {{name.data(), name.size()}, FOXGLOVE_PARAMETER_TYPE_NONE, nullptr}
+  );
+  return *this;
+}
+
+ParameterArrayBuilder& ParameterArrayBuilder::add(
+  std::string_view name, Value value, ParameterType type
+) {
+  impl_->params.push_back(
+    {{name.data(), name.size()}, static_cast<foxglove_parameter_type>(type), value.desc_}
+  );
+  return *this;
+}
+
+size_t ParameterArrayBuilder::size() const noexcept {
+  return impl_->params.size();
+}
+
+ParameterArray ParameterArrayBuilder::build() const {
+  foxglove_parameter_array* array = nullptr;
+  auto error = foxglove_parameter_array_create_from_descs(
+    impl_->params.data(), impl_->params.size(), &array
+  );
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK) {
+    throw std::runtime_error(foxglove_error_to_cstr(error));
+  }
+  return ParameterArray(array);
+}
+
+void ParameterArrayBuilder::clear() noexcept {
+  impl_->arena.reset();
+  impl_->params.clear();
+}
+
 }  // namespace foxglove
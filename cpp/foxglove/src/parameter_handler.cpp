@@ -9,8 +9,11 @@ void GetParametersResponder::Deleter::operator()(foxglove_get_parameters_respond
 }
 
 void GetParametersResponder::respond(std::vector<Parameter>&& params) && {
-  ParameterArray array(std::move(params));
-  foxglove_get_parameters_responder_respond(impl_.release(), array.release());
+  std::move(*this).respond(ParameterArray(std::move(params)));
+}
+
+void GetParametersResponder::respond(ParameterArray&& params) && noexcept {
+  foxglove_get_parameters_responder_respond(impl_.release(), params.release());
 }
 
 void SetParametersResponder::Deleter::operator()(foxglove_set_parameters_responder* ptr
@@ -19,8 +22,11 @@ void SetParametersResponder::Deleter::operator()(foxglove_set_parameters_respond
 }
 
 void SetParametersResponder::respond(std::vector<Parameter>&& params) && {
-  ParameterArray array(std::move(params));
-  foxglove_set_parameters_responder_respond(impl_.release(), array.release());
+  std::move(*this).respond(ParameterArray(std::move(params)));
+}
+
+void SetParametersResponder::respond(ParameterArray&& params) && noexcept {
+  foxglove_set_parameters_responder_respond(impl_.release(), params.release());
 }
 
 }  // namespace foxglove
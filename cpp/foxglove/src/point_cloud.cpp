@@ -0,0 +1,168 @@
+#include <foxglove/error.hpp>
+#include <foxglove/messages.hpp>
+#include <foxglove/point_cloud.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define FOXGLOVE_POINT_CLOUD_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FOXGLOVE_POINT_CLOUD_NEON
+#endif
+
+namespace foxglove {
+
+namespace {
+
+using NumericType = messages::PackedElementField::NumericType;
+
+constexpr size_t kMaxColumns = 5;
+constexpr size_t kColumnSize = 4;
+
+/// Up to five 4-byte columns, which are packed in order at the start of each point.
+struct Columns {
+  std::array<const std::byte*, kMaxColumns> data{};
+  size_t len = 0;
+};
+
+/// Copies columns [first, columns.len) of points [begin, end) one value at a time.
+void packScalar(
+  const Columns& columns, size_t first, std::byte* out, size_t stride, size_t begin, size_t end
+) {
+  for (size_t i = begin; i < end; ++i) {
+    std::byte* point = out + (i * stride);
+    for (size_t c = first; c < columns.len; ++c) {
+      std::memcpy(point + (c * kColumnSize), columns.data[c] + (i * kColumnSize), kColumnSize);
+    }
+  }
+}
+
+#if defined(FOXGLOVE_POINT_CLOUD_SSE2) || defined(FOXGLOVE_POINT_CLOUD_NEON)
+
+#if defined(FOXGLOVE_POINT_CLOUD_SSE2)
+/// Transposes four values from each of up to four columns into four 16-byte points, and stores
+/// them at `stride` byte intervals. A missing fourth column is stored as zeros.
+inline void transposeStore4(const Columns& columns, size_t i, std::byte* out, size_t stride) {
+  const auto load = [&](size_t c) {
+    return c < columns.len
+             ? _mm_loadu_ps(reinterpret_cast<const float*>(columns.data[c] + (i * kColumnSize)))
+             : _mm_setzero_ps();
+  };
+  __m128 r0 = load(0);
+  __m128 r1 = load(1);
+  __m128 r2 = load(2);
+  __m128 r3 = load(3);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  std::byte* point = out + (i * stride);
+  _mm_storeu_ps(reinterpret_cast<float*>(point), r0);
+  _mm_storeu_ps(reinterpret_cast<float*>(point + stride), r1);
+  _mm_storeu_ps(reinterpret_cast<float*>(point + (2 * stride)), r2);
+  _mm_storeu_ps(reinterpret_cast<float*>(point + (3 * stride)), r3);
+}
+#else
+/// Transposes four values from each of up to four columns into four 16-byte points, and stores
+/// them at `stride` byte intervals. A missing fourth column is stored as zeros.
+inline void transposeStore4(const Columns& columns, size_t i, std::byte* out, size_t stride) {
+  const auto load = [&](size_t c) {
+    return c < columns.len
+             ? vld1q_f32(reinterpret_cast<const float*>(columns.data[c] + (i * kColumnSize)))
+             : vdupq_n_f32(0.0F);
+  };
+  const float32x4x2_t xy = vzipq_f32(load(0), load(1));
+  const float32x4x2_t zw = vzipq_f32(load(2), load(3));
+  std::byte* point = out + (i * stride);
+  vst1q_f32(
+    reinterpret_cast<float*>(point),
+    vcombine_f32(vget_low_f32(xy.val[0]), vget_low_f32(zw.val[0]))
+  );
+  vst1q_f32(
+    reinterpret_cast<float*>(point + stride),
+    vcombine_f32(vget_high_f32(xy.val[0]), vget_high_f32(zw.val[0]))
+  );
+  vst1q_f32(
+    reinterpret_cast<float*>(point + (2 * stride)),
+    vcombine_f32(vget_low_f32(xy.val[1]), vget_low_f32(zw.val[1]))
+  );
+  vst1q_f32(
+    reinterpret_cast<float*>(point + (3 * stride)),
+    vcombine_f32(vget_high_f32(xy.val[1]), vget_high_f32(zw.val[1]))
+  );
+}
+#endif
+
+/// Packs the columns four points at a time, transposing the first four columns in vector
+/// registers, and falls back to scalar copies for the remaining points and columns.
+void pack(const Columns& columns, std::byte* out, size_t stride, size_t count) {
+  // Each store writes 16 bytes per point. With a 12-byte stride, that spills 4 bytes into the next
+  // point, which is overwritten when that point is stored; the last block must not spill past
+  // the end of the buffer, so it is left to the scalar path.
+  size_t simd_end = count - (count % 4);
+  if (stride < 16 && simd_end == count && count > 0) {
+    simd_end -= 4;
+  }
+  for (size_t i = 0; i < simd_end; i += 4) {
+    transposeStore4(columns, i, out, stride);
+  }
+  if (columns.len > 4) {
+    packScalar(columns, 4, out, stride, 0, simd_end);
+  }
+  packScalar(columns, 0, out, stride, simd_end, count);
+}
+
+#else
+
+void pack(const Columns& columns, std::byte* out, size_t stride, size_t count) {
+  packScalar(columns, 0, out, stride, 0, count);
+}
+
+#endif
+
+}  // namespace
+
+FoxgloveError PointCloudBuilder::pack(const PointCloudColumns& columns) {
+  if (columns.count > 0 && (columns.x == nullptr || columns.y == nullptr || columns.z == nullptr)) {
+    return FoxgloveError::ValueError;
+  }
+
+  Columns packed;
+  fields_.clear();
+  const auto add_column = [&](const void* data, const char* name, NumericType type) {
+    auto offset = static_cast<uint32_t>(packed.len * kColumnSize);
+    fields_.push_back({name, offset, type});
+    packed.data[packed.len++] = static_cast<const std::byte*>(data);
+  };
+  add_column(columns.x, "x", NumericType::FLOAT32);
+  add_column(columns.y, "y", NumericType::FLOAT32);
+  add_column(columns.z, "z", NumericType::FLOAT32);
+  if (columns.intensity != nullptr) {
+    add_column(columns.intensity, "intensity", NumericType::FLOAT32);
+  }
+  if (columns.rgba != nullptr) {
+    const auto offset = static_cast<uint32_t>(packed.len * kColumnSize);
+    add_column(columns.rgba, "red", NumericType::UINT8);
+    fields_.push_back({"green", offset + 1, NumericType::UINT8});
+    fields_.push_back({"blue", offset + 2, NumericType::UINT8});
+    fields_.push_back({"alpha", offset + 3, NumericType::UINT8});
+  }
+
+  point_stride_ = static_cast<uint32_t>(packed.len * kColumnSize);
+  data_.resize(columns.count * point_stride_);
+  foxglove::pack(packed, data_.data(), point_stride_, columns.count);
+  return FoxgloveError::Ok;
+}
+
+messages::PointCloudView PointCloudBuilder::view() const {
+  messages::PointCloudView view;
+  view.point_stride = point_stride_;
+  view.fields = fields_;
+  view.data = data_.data();
+  view.data_len = data_.size();
+  return view;
+}
+
+}  // namespace foxglove
@@ -0,0 +1,464 @@
+#pragma once
+
+/// @cond foxglove_internal
+
+#include <foxglove/error.hpp>
+#include <foxglove/messages.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace foxglove {
+
+/// Encodes the fields of the messages in foxglove::messages as protobuf.
+///
+/// Each message type has a generated `protobufFields(Encoder&, const T&)` overload, which calls
+/// one method of this class per field, in the order the fields are declared in the schema. The
+/// methods apply the proto3 encoding rules, such as omitting scalars with their default value, and
+/// defer to the Derived class to either measure or write the encoding. Running the same field
+/// calls through both makes the two passes agree on every byte.
+template<typename Derived>
+class ProtobufFieldEncoder {
+public:
+  void boolean(uint32_t field, bool value) {
+    if (value) {
+      key(field, kVarint);
+      self().varint(1);
+    }
+  }
+
+  void fixed32(uint32_t field, uint32_t value) {
+    if (value != 0) {
+      key(field, kFixed32);
+      self().fixed32Raw(value);
+    }
+  }
+
+  void sfixed32(uint32_t field, int32_t value) {
+    fixed32(field, static_cast<uint32_t>(value));
+  }
+
+  void float64(uint32_t field, double value) {
+    if (value != 0.0) {
+      key(field, kFixed64);
+      self().fixed64Raw(doubleBits(value));
+    }
+  }
+
+  /// Encodes a field with explicit presence, which is written whenever it is set.
+  void float64(uint32_t field, const std::optional<double>& value) {
+    if (value) {
+      key(field, kFixed64);
+      self().fixed64Raw(doubleBits(*value));
+    }
+  }
+
+  template<typename Enum>
+  void enumeration(uint32_t field, Enum value) {
+    auto raw = static_cast<uint64_t>(value);
+    if (raw != 0) {
+      key(field, kVarint);
+      self().varint(raw);
+    }
+  }
+
+  void string(uint32_t field, std::string_view value) {
+    if (!value.empty()) {
+      self().checkUtf8(value);
+      key(field, kLengthDelimited);
+      self().varint(value.size());
+      self().raw(value.data(), value.size());
+    }
+  }
+
+  void bytes(uint32_t field, const std::byte* data, size_t len) {
+    if (len != 0) {
+      key(field, kLengthDelimited);
+      self().varint(len);
+      self().raw(data, len);
+    }
+  }
+
+  template<typename Container>
+  void packedFloat64(uint32_t field, const Container& values) {
+    if (!values.empty()) {
+      key(field, kLengthDelimited);
+      self().varint(values.size() * sizeof(uint64_t));
+      for (double value : values) {
+        self().fixed64Raw(doubleBits(value));
+      }
+    }
+  }
+
+  template<typename Container>
+  void packedFixed32(uint32_t field, const Container& values) {
+    if (!values.empty()) {
+      key(field, kLengthDelimited);
+      self().varint(values.size() * sizeof(uint32_t));
+      for (uint32_t value : values) {
+        self().fixed32Raw(value);
+      }
+    }
+  }
+
+  template<typename T>
+  void message(uint32_t field, const std::optional<T>& value) {
+    if (value) {
+      self().nested(field, *value);
+    }
+  }
+
+  template<typename T>
+  void messages(uint32_t field, const std::vector<T>& values) {
+    for (const T& value : values) {
+      self().nested(field, value);
+    }
+  }
+
+  /// Encodes a timestamp with its nanoseconds normalized into [0, 1e9), as the C API does.
+  void timestamp(uint32_t field, const std::optional<messages::Timestamp>& value) {
+    if (!value) {
+      return;
+    }
+    uint64_t sec = uint64_t(value->sec) + value->nsec / kNanosPerSecond;
+    if (sec > UINT32_MAX) {
+      self().fail(FoxgloveError::EncodeError);
+      return;
+    }
+    wellKnownTime(field, sec, value->nsec % kNanosPerSecond);
+  }
+
+  /// Encodes a duration with its nanoseconds normalized into [0, 1e9), as the C API does.
+  void duration(uint32_t field, const std::optional<messages::Duration>& value) {
+    if (!value) {
+      return;
+    }
+    int64_t sec = int64_t(value->sec) + value->nsec / kNanosPerSecond;
+    if (sec > INT32_MAX) {
+      self().fail(FoxgloveError::EncodeError);
+      return;
+    }
+    // Negative int32 values are sign-extended to ten bytes on the wire.
+    wellKnownTime(field, static_cast<uint64_t>(sec), value->nsec % kNanosPerSecond);
+  }
+
+  /// Returns the number of bytes in the varint encoding of value.
+  static size_t varintSize(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+      value >>= 7;
+      ++size;
+    }
+    return size;
+  }
+
+private:
+  static constexpr uint32_t kVarint = 0;
+  static constexpr uint32_t kFixed64 = 1;
+  static constexpr uint32_t kLengthDelimited = 2;
+  static constexpr uint32_t kFixed32 = 5;
+  static constexpr uint32_t kNanosPerSecond = 1'000'000'000;
+
+  Derived& self() {
+    return static_cast<Derived&>(*this);
+  }
+
+  void key(uint32_t field, uint32_t wire_type) {
+    self().varint((uint64_t(field) << 3) | wire_type);
+  }
+
+  static uint64_t doubleBits(double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  /// Writes the seconds and nanoseconds of a timestamp or duration as a nested message. The
+  /// message is small enough that its length is computed inline rather than in the size pass.
+  void wellKnownTime(uint32_t field, uint64_t sec, uint32_t nsec) {
+    size_t len = 0;
+    if (sec != 0) {
+      len += 1 + varintSize(sec);
+    }
+    if (nsec != 0) {
+      len += 1 + varintSize(nsec);
+    }
+    key(field, kLengthDelimited);
+    self().varint(len);
+    if (sec != 0) {
+      key(1, kVarint);
+      self().varint(sec);
+    }
+    if (nsec != 0) {
+      key(2, kVarint);
+      self().varint(nsec);
+    }
+  }
+};
+
+/// The first pass of encoding, which measures the message.
+///
+/// Records the length of every nested message in the order they are visited, so the second pass
+/// can write each length prefix without measuring the nested message again. Also validates the
+/// message, so that the second pass cannot fail.
+class ProtobufSizer : public ProtobufFieldEncoder<ProtobufSizer> {
+public:
+  explicit ProtobufSizer(std::vector<size_t>& nested_sizes)
+      : nested_sizes_(nested_sizes) {}
+
+  void varint(uint64_t value) {
+    size_ += varintSize(value);
+  }
+
+  void fixed32Raw(uint32_t /*value*/) {
+    size_ += sizeof(uint32_t);
+  }
+
+  void fixed64Raw(uint64_t /*value*/) {
+    size_ += sizeof(uint64_t);
+  }
+
+  void raw(const void* /*data*/, size_t len) {
+    size_ += len;
+  }
+
+  template<typename T>
+  void nested(uint32_t field, const T& msg) {
+    size_t index = nested_sizes_.size();
+    nested_sizes_.push_back(0);
+    size_t outer_size = size_;
+    size_ = 0;
+    protobufFields(*this, msg);
+    size_t len = size_;
+    nested_sizes_[index] = len;
+    size_ = outer_size + varintSize(uint64_t(field) << 3) + varintSize(len) + len;
+  }
+
+  void checkUtf8(std::string_view value) {
+    if (!isValidUtf8(value)) {
+      fail(FoxgloveError::Utf8Error);
+    }
+  }
+
+  void fail(FoxgloveError error) {
+    if (error_ == FoxgloveError::Ok) {
+      error_ = error;
+    }
+  }
+
+  [[nodiscard]] size_t size() const {
+    return size_;
+  }
+
+  [[nodiscard]] FoxgloveError error() const {
+    return error_;
+  }
+
+private:
+  static bool isValidUtf8(std::string_view value) {
+    const auto* ptr = reinterpret_cast<const uint8_t*>(value.data());
+    const uint8_t* end = ptr + value.size();
+    while (ptr < end) {
+      uint8_t lead = *ptr;
+      if (lead < 0x80) {
+        ++ptr;
+        continue;
+      }
+      size_t len = 0;
+      uint32_t min = 0;
+      uint32_t code_point = 0;
+      if ((lead & 0xE0) == 0xC0) {
+        len = 2;
+        min = 0x80;
+        code_point = lead & 0x1F;
+      } else if ((lead & 0xF0) == 0xE0) {
+        len = 3;
+        min = 0x800;
+        code_point = lead & 0x0F;
+      } else if ((lead & 0xF8) == 0xF0) {
+        len = 4;
+        min = 0x10000;
+        code_point = lead & 0x07;
+      } else {
+        return false;
+      }
+      if (size_t(end - ptr) < len) {
+        return false;
+      }
+      for (size_t i = 1; i < len; ++i) {
+        if ((ptr[i] & 0xC0) != 0x80) {
+          return false;
+        }
+        code_point = (code_point << 6) | (ptr[i] & 0x3F);
+      }
+      // Reject overlong encodings, surrogates, and code points past U+10FFFF.
+      if (code_point < min || (code_point >= 0xD800 && code_point <= 0xDFFF) ||
+          code_point > 0x10FFFF) {
+        return false;
+      }
+      ptr += len;
+    }
+    return true;
+  }
+
+  std::vector<size_t>& nested_sizes_;
+  size_t size_ = 0;
+  FoxgloveError error_ = FoxgloveError::Ok;
+};
+
+/// The second pass of encoding, which writes the message into a buffer measured by ProtobufSizer.
+class ProtobufWriter : public ProtobufFieldEncoder<ProtobufWriter> {
+public:
+  ProtobufWriter(uint8_t* out, const size_t* nested_sizes)
+      : out_(out)
+      , nested_sizes_(nested_sizes) {}
+
+  void varint(uint64_t value) {
+    while (value >= 0x80) {
+      *out_++ = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    *out_++ = static_cast<uint8_t>(value);
+  }
+
+  void fixed32Raw(uint32_t value) {
+    for (size_t i = 0; i < sizeof(value); ++i) {
+      *out_++ = static_cast<uint8_t>(value >> (8 * i));
+    }
+  }
+
+  void fixed64Raw(uint64_t value) {
+    for (size_t i = 0; i < sizeof(value); ++i) {
+      *out_++ = static_cast<uint8_t>(value >> (8 * i));
+    }
+  }
+
+  void raw(const void* data, size_t len) {
+    std::memcpy(out_, data, len);
+    out_ += len;
+  }
+
+  template<typename T>
+  void nested(uint32_t field, const T& msg) {
+    varint((uint64_t(field) << 3) | 2);
+    varint(*nested_sizes_++);
+    protobufFields(*this, msg);
+  }
+
+  void checkUtf8(std::string_view /*value*/) {}
+
+  void fail(FoxgloveError /*error*/) {}
+
+private:
+  uint8_t* out_;
+  const size_t* nested_sizes_;
+};
+
+/// Encodes a message as protobuf directly from its C++ struct.
+///
+/// The constructor measures and validates the message; write() then encodes it into a buffer of
+/// size() bytes. The lengths of nested messages are kept in a buffer reused by the calling
+/// thread, so a ProtobufEncoding must be written before another is created on the same thread.
+template<typename T>
+class ProtobufEncoding {
+public:
+  explicit ProtobufEncoding(const T& msg)
+      : msg_(msg)
+      , nested_sizes_(threadNestedSizes()) {
+    nested_sizes_.clear();
+    ProtobufSizer sizer(nested_sizes_);
+    protobufFields(sizer, msg_);
+    size_ = sizer.size();
+    error_ = sizer.error();
+  }
+
+  /// Returns the reason the message cannot be encoded, or FoxgloveError::Ok.
+  [[nodiscard]] FoxgloveError error() const {
+    return error_;
+  }
+
+  /// Returns the length of the encoded message, in bytes.
+  [[nodiscard]] size_t size() const {
+    return size_;
+  }
+
+  /// Writes the encoded message, which must be valid, to out.
+  void write(uint8_t* out) const {
+    ProtobufWriter writer(out, nested_sizes_.data());
+    protobufFields(writer, msg_);
+  }
+
+private:
+  static std::vector<size_t>& threadNestedSizes() {
+    thread_local std::vector<size_t> nested_sizes;
+    return nested_sizes;
+  }
+
+  const T& msg_;
+  std::vector<size_t>& nested_sizes_;
+  size_t size_ = 0;
+  FoxgloveError error_ = FoxgloveError::Ok;
+};
+
+/// Borrows the calling thread's reusable encode buffer for the lifetime of this object.
+///
+/// The buffer is cleared when the ScopedEncodeBuffer is destroyed, keeping its capacity for the
+/// next borrower on the same thread, up to kMaxRetainedBytes. A nested ScopedEncodeBuffer on a
+/// thread whose buffer is already borrowed, such as from a sink which logs, gets a private buffer.
+class ScopedEncodeBuffer {
+public:
+  /// The largest capacity kept for reuse once the buffer is returned.
+  static constexpr size_t kMaxRetainedBytes = static_cast<size_t>(1024) * 1024;  // 1 MB
+
+  ScopedEncodeBuffer() {
+    Slot& slot = threadSlot();
+    if (slot.borrowed) {
+      buffer_ = &owned_;
+    } else {
+      slot.borrowed = true;
+      buffer_ = &slot.buffer;
+    }
+  }
+
+  ~ScopedEncodeBuffer() {
+    if (buffer_ != &owned_) {
+      buffer_->clear();
+      if (buffer_->capacity() > kMaxRetainedBytes) {
+        buffer_->shrink_to_fit();
+      }
+      threadSlot().borrowed = false;
+    }
+  }
+
+  ScopedEncodeBuffer(const ScopedEncodeBuffer&) = delete;
+  ScopedEncodeBuffer& operator=(const ScopedEncodeBuffer&) = delete;
+  ScopedEncodeBuffer(ScopedEncodeBuffer&&) = delete;
+  ScopedEncodeBuffer& operator=(ScopedEncodeBuffer&&) = delete;
+
+  /// Returns the borrowed buffer.
+  std::vector<uint8_t>& get() noexcept {
+    return *buffer_;
+  }
+
+private:
+  struct Slot {
+    std::vector<uint8_t> buffer;
+    bool borrowed = false;
+  };
+
+  static Slot& threadSlot() {
+    thread_local Slot slot;
+    return slot;
+  }
+
+  std::vector<uint8_t>* buffer_ = nullptr;
+  std::vector<uint8_t> owned_;
+};
+
+}  // namespace foxglove
+
+/// @endcond
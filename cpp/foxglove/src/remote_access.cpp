@@ -13,6 +13,9 @@
 #include <foxglove/remote_access.hpp>
 
 #include "callback_forwarders.hpp"
+#include "callback_queue.hpp"
+
+#include <algorithm>
 
 namespace foxglove {
 namespace {
@@ -89,7 +92,14 @@ foxglove_qos_profile forwardQosClassifier(
     const auto* classifier = static_cast<const QosClassifierFn*>(context);
     auto cpp_channel = ChannelDescriptor(channel);
     auto profile = (*classifier)(cpp_channel);
-    return {static_cast<foxglove_reliability>(profile.reliability)};
+    foxglove_qos_profile c_profile = {};
+    c_profile.reliability = static_cast<foxglove_reliability>(profile.reliability);
+    c_profile.priority = static_cast<foxglove_priority>(profile.priority);
+    c_profile.lifespan_ms =
+      profile.lifespan ? static_cast<uint64_t>(std::max<int64_t>(profile.lifespan->count(), 0))
+                       : 0;
+    c_profile.max_rate = profile.max_rate.value_or(0.0);
+    return c_profile;
   } catch (const std::exception& exc) {
     warn() << "QoS classifier failed: " << exc.what();
     return {FOXGLOVE_RELIABILITY_LOSSY};
@@ -112,6 +122,19 @@ bool forwardSuppressVideoTranscode(
   }
 }
 
+void forwardKeyframeRequest(const void* context, const foxglove_channel_descriptor* channel) {
+  if (context == nullptr) {
+    return;
+  }
+  try {
+    const auto* handler = static_cast<const KeyframeRequestFn*>(context);
+    auto cpp_channel = ChannelDescriptor(channel);
+    (*handler)(cpp_channel);
+  } catch (const std::exception& exc) {
+    warn() << "Keyframe request handler failed: " << exc.what();
+  }
+}
+
 // Populates `c` with forward function pointers for every callback set on `cb`,
 // and reports whether any callback was set. Callers should leave both the
 // heap-allocated callbacks wrapper unallocated and `c_options.callbacks` null
@@ -191,6 +214,85 @@ bool wireGatewayCallbacks(foxglove_gateway_callbacks& c, const RemoteAccessGatew
 #pragma warning(pop)
 #endif
 
+// A channel descriptor kept by a queued event, beyond the callback it was passed to.
+std::shared_ptr<foxglove_channel_descriptor> cloneChannelDescriptor(const ChannelDescriptor& channel
+) {
+  return {
+    foxglove_channel_descriptor_clone(internal::ForwarderAccess::rawChannelDescriptor(channel)),
+    foxglove_channel_descriptor_free
+  };
+}
+
+// Like internal::queueCalls, for the callbacks which are passed a channel descriptor.
+std::function<void(uint32_t, const ChannelDescriptor&)> queueChannelCalls(
+  const std::shared_ptr<internal::CallbackQueue>& queue, const char* name,
+  std::function<void(uint32_t, const ChannelDescriptor&)>&& callback
+) {
+  if (!callback) {
+    return nullptr;
+  }
+  auto target =
+    std::make_shared<std::function<void(uint32_t, const ChannelDescriptor&)>>(std::move(callback));
+  return [queue, name, target](uint32_t client_id, const ChannelDescriptor& channel) {
+    queue->push([name, target, client_id, owned = cloneChannelDescriptor(channel)] {
+      internal::callbackGuard(name, [&] {
+        (*target)(client_id, ChannelDescriptor(owned.get()));
+      });
+    });
+  };
+}
+
+// Replaces the notification callbacks of `cb` with callbacks which queue them on `queue`, for
+// RemoteAccessGatewayOptions::poll_callbacks. The legacy parameter callbacks, which return a
+// value to the gateway, are left to be invoked directly.
+RemoteAccessGatewayCallbacks queueGatewayCallbacks(
+  const std::shared_ptr<internal::CallbackQueue>& queue, RemoteAccessGatewayCallbacks&& cb
+) {
+  RemoteAccessGatewayCallbacks queued = std::move(cb);
+  queued.onConnectionStatusChanged = internal::queueCalls(
+    queue, "onConnectionStatusChanged", std::move(queued.onConnectionStatusChanged)
+  );
+  queued.onSubscribe = queueChannelCalls(queue, "onSubscribe", std::move(queued.onSubscribe));
+  queued.onUnsubscribe =
+    queueChannelCalls(queue, "onUnsubscribe", std::move(queued.onUnsubscribe));
+  queued.onClientAdvertise =
+    queueChannelCalls(queue, "onClientAdvertise", std::move(queued.onClientAdvertise));
+  queued.onClientUnadvertise =
+    queueChannelCalls(queue, "onClientUnadvertise", std::move(queued.onClientUnadvertise));
+  queued.onParametersSubscribe = internal::queueParameterNameCalls(
+    queue, "onParametersSubscribe", std::move(queued.onParametersSubscribe)
+  );
+  queued.onParametersUnsubscribe = internal::queueParameterNameCalls(
+    queue, "onParametersUnsubscribe", std::move(queued.onParametersUnsubscribe)
+  );
+  queued.onConnectionGraphSubscribe = internal::queueCalls(
+    queue, "onConnectionGraphSubscribe", std::move(queued.onConnectionGraphSubscribe)
+  );
+  queued.onConnectionGraphUnsubscribe = internal::queueCalls(
+    queue, "onConnectionGraphUnsubscribe", std::move(queued.onConnectionGraphUnsubscribe)
+  );
+
+  if (queued.onMessageData) {
+    auto target =
+      std::make_shared<decltype(queued.onMessageData)>(std::move(queued.onMessageData));
+    queued.onMessageData = [queue, target](
+                             uint32_t client_id, const ChannelDescriptor& channel,
+                             const std::byte* data, size_t data_len
+                           ) {
+      std::vector<std::byte> payload(data, data + data_len);
+      queue->push([target,
+                   client_id,
+                   owned = cloneChannelDescriptor(channel),
+                   payload = std::move(payload)] {
+        internal::callbackGuard("onMessageData", [&] {
+          (*target)(client_id, ChannelDescriptor(owned.get()), payload.data(), payload.size());
+        });
+      });
+    };
+  }
+  return queued;
+}
+
 }  // namespace
 
 FoxgloveResult<RemoteAccessGateway> RemoteAccessGateway::create(
@@ -199,6 +301,14 @@ FoxgloveResult<RemoteAccessGateway> RemoteAccessGateway::create(
 ) {
   foxglove_internal_register_cpp_wrapper();
 
+  std::shared_ptr<internal::CallbackQueue> callback_queue;
+  if (options.poll_callbacks) {
+    callback_queue = std::make_shared<internal::CallbackQueue>();
+    options.callbacks = queueGatewayCallbacks(callback_queue, std::move(options.callbacks));
+    options.parameter_handler =
+      internal::queueParameterHandler(callback_queue, std::move(options.parameter_handler));
+  }
+
   foxglove_gateway_callbacks c_callbacks = {};
   std::unique_ptr<RemoteAccessGatewayCallbacks> callbacks;
   if (wireGatewayCallbacks(c_callbacks, options.callbacks)) {
@@ -220,6 +330,12 @@ FoxgloveResult<RemoteAccessGateway> RemoteAccessGateway::create(
     static_cast<std::underlying_type_t<decltype(options.capabilities)>>(options.capabilities)
   };
   c_options.video_encoder = static_cast<foxglove_video_encoder_backend>(options.video_encoder);
+  c_options.video_simulcast = options.video_simulcast;
+  if (options.pack_linger) {
+    // A linger of 0 disables packing in the C API, so round it up to 1us.
+    auto linger_us = std::max<int64_t>(options.pack_linger->count(), 1);
+    c_options.pack_linger_us = static_cast<uint64_t>(linger_us);
+  }
 
   // Supported encodings
   std::vector<foxglove_string> supported_encodings;
@@ -252,6 +368,14 @@ FoxgloveResult<RemoteAccessGateway> RemoteAccessGateway::create(
     c_options.suppress_video_transcode = &forwardSuppressVideoTranscode;
   }
 
+  // Keyframe requests
+  std::unique_ptr<KeyframeRequestFn> keyframe_request;
+  if (options.keyframe_request) {
+    keyframe_request = std::make_unique<KeyframeRequestFn>(std::move(options.keyframe_request));
+    c_options.keyframe_request_context = keyframe_request.get();
+    c_options.keyframe_request = &forwardKeyframeRequest;
+  }
+
   // Fetch asset handler
   internal::wireFetchAsset(c_options, std::move(options.fetch_asset), fetch_asset);
 
@@ -275,8 +399,27 @@ FoxgloveResult<RemoteAccessGateway> RemoteAccessGateway::create(
     c_options.foxglove_api_timeout_secs = &*options.foxglove_api_timeout_secs;
   }
 
+  if (options.device_info_cache_path) {
+    c_options.device_info_cache_path = {
+      options.device_info_cache_path->c_str(), options.device_info_cache_path->length()
+    };
+  }
+
   c_options.message_backlog_size = options.message_backlog_size.value_or(0);
   c_options.max_data_track_message_size = options.max_data_track_message_size.value_or(0);
+  c_options.max_fragmented_message_size = options.max_fragmented_message_size.value_or(0);
+  c_options.message_backlog_bytes = options.message_backlog_bytes.value_or(0);
+  c_options.message_backlog_policy =
+    static_cast<foxglove_message_backlog_policy>(options.message_backlog_policy);
+
+  foxglove_video_limits video_limits = {};
+  if (options.video_limits) {
+    video_limits.max_bitrate = options.video_limits->max_bitrate;
+    video_limits.max_framerate = options.video_limits->max_framerate;
+    video_limits.min_framerate = options.video_limits->min_framerate;
+    video_limits.max_downscale = options.video_limits->max_downscale;
+    c_options.video_limits = &video_limits;
+  }
 
   std::vector<foxglove_key_value> server_info;
   if (options.server_info) {
@@ -301,7 +444,9 @@ FoxgloveResult<RemoteAccessGateway> RemoteAccessGateway::create(
     std::move(sink_channel_filter),
     std::move(qos_classifier),
     std::move(suppress_video_transcode),
-    std::move(parameter_handler)
+    std::move(keyframe_request),
+    std::move(parameter_handler),
+    std::move(callback_queue)
   );
 }
 
@@ -311,20 +456,38 @@ RemoteAccessGateway::RemoteAccessGateway(
   std::unique_ptr<SinkChannelFilterFn> sink_channel_filter,
   std::unique_ptr<QosClassifierFn> qos_classifier,
   std::unique_ptr<SuppressVideoTranscodeFn> suppress_video_transcode,
-  std::unique_ptr<ParameterHandler> parameter_handler
+  std::unique_ptr<KeyframeRequestFn> keyframe_request,
+  std::unique_ptr<ParameterHandler> parameter_handler,
+  std::shared_ptr<internal::CallbackQueue> callback_queue
 )
     : callbacks_(std::move(callbacks))
     , fetch_asset_(std::move(fetch_asset))
     , sink_channel_filter_(std::move(sink_channel_filter))
     , qos_classifier_(std::move(qos_classifier))
     , suppress_video_transcode_(std::move(suppress_video_transcode))
+    , keyframe_request_(std::move(keyframe_request))
     , parameter_handler_(std::move(parameter_handler))
+    , callback_queue_(std::move(callback_queue))
     , impl_(gateway, foxglove_gateway_stop) {}
 
 RemoteAccessConnectionStatus RemoteAccessGateway::connectionStatus() const {
   return static_cast<RemoteAccessConnectionStatus>(foxglove_gateway_connection_status(impl_.get()));
 }
 
+size_t RemoteAccessGateway::pollEvents(size_t max_events) {
+  if (!callback_queue_) {
+    return 0;
+  }
+  return callback_queue_->poll(max_events);
+}
+
+ServiceHandler RemoteAccessGateway::polledServiceHandler(ServiceHandler&& handler) const {
+  if (!callback_queue_) {
+    return std::move(handler);
+  }
+  return internal::queueServiceCalls(callback_queue_, std::move(handler));
+}
+
 // NOLINTNEXTLINE(cppcoreguidelines-rvalue-reference-param-not-moved)
 FoxgloveError RemoteAccessGateway::addService(Service&& service) const noexcept {
   auto error = foxglove_gateway_add_service(impl_.get(), service.release());
@@ -338,8 +501,11 @@ FoxgloveError RemoteAccessGateway::removeService(std::string_view name) const no
 }
 
 void RemoteAccessGateway::publishParameterValues(std::vector<Parameter>&& params) {
-  ParameterArray array(std::move(params));
-  foxglove_gateway_publish_parameter_values(impl_.get(), array.release());
+  publishParameterValues(ParameterArray(std::move(params)));
+}
+
+void RemoteAccessGateway::publishParameterValues(ParameterArray&& params) {
+  foxglove_gateway_publish_parameter_values(impl_.get(), params.release());
 }
 
 FoxgloveError RemoteAccessGateway::publishStatus(
@@ -369,6 +535,11 @@ FoxgloveError RemoteAccessGateway::publishConnectionGraph(const ConnectionGraph&
   return FoxgloveError(foxglove_gateway_publish_connection_graph(impl_.get(), graph.impl_.get()));
 }
 
+FoxgloveError RemoteAccessGateway::updateConnectionGraph(ConnectionGraphPatch&& patch) const {
+  auto* c_patch = patch.impl_.release();
+  return FoxgloveError(foxglove_gateway_update_connection_graph(impl_.get(), c_patch));
+}
+
 std::optional<uint64_t> RemoteAccessGateway::sinkId() const {
   uint64_t id = foxglove_gateway_sink_id(impl_.get());
   if (id == 0) {
@@ -0,0 +1,89 @@
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/error.hpp>
+#include <foxglove/ring_buffer.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "callback_forwarders.hpp"
+#include "mcap_internal.hpp"
+
+namespace foxglove {
+
+namespace {
+
+uint64_t toNanos(std::chrono::nanoseconds duration) {
+  return static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+}
+
+}  // namespace
+
+FoxgloveResult<RingBufferSink> RingBufferSink::create(RingBufferSinkOptions&& options) {
+  foxglove_internal_register_cpp_wrapper();
+
+  foxglove_ring_buffer_sink_options c_options = {};
+  c_options.context = options.context.getInner();
+  // A window of 0 would select the default, so keep at least one nanosecond.
+  c_options.window_ns = std::max<uint64_t>(toNanos(options.window), 1);
+  c_options.max_bytes = options.max_bytes;
+
+  foxglove_mcap_options c_mcap_options = {};
+  if (options.mcap_options) {
+    c_mcap_options = to_c_mcap_options(*options.mcap_options);
+    c_options.mcap_options = &c_mcap_options;
+  }
+
+  std::unique_ptr<SinkChannelFilterFn> sink_channel_filter;
+  internal::wireSinkChannelFilter(
+    c_options, std::move(options.sink_channel_filter), sink_channel_filter
+  );
+
+  foxglove_ring_buffer_sink* sink = nullptr;
+  foxglove_error error = foxglove_ring_buffer_sink_create(&c_options, &sink);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || sink == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return RingBufferSink(sink, std::move(sink_channel_filter));
+}
+
+RingBufferSink::RingBufferSink(
+  foxglove_ring_buffer_sink* sink, std::unique_ptr<SinkChannelFilterFn> sink_channel_filter
+)
+    : sink_channel_filter_(std::move(sink_channel_filter))
+    , impl_(sink, foxglove_ring_buffer_sink_close) {}
+
+FoxgloveResult<RingBufferSnapshot> RingBufferSink::snapshot(
+  std::string_view path, std::chrono::nanoseconds window
+) const {
+  foxglove_ring_buffer_snapshot* snapshot = nullptr;
+  foxglove_error error = foxglove_ring_buffer_sink_snapshot(
+    impl_.get(), {path.data(), path.length()}, toNanos(window), &snapshot
+  );
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || snapshot == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return RingBufferSnapshot(snapshot);
+}
+
+size_t RingBufferSink::bufferedMessages() const noexcept {
+  return foxglove_ring_buffer_sink_buffered_messages(impl_.get());
+}
+
+size_t RingBufferSink::bufferedBytes() const noexcept {
+  return foxglove_ring_buffer_sink_buffered_bytes(impl_.get());
+}
+
+FoxgloveError RingBufferSink::close() {
+  foxglove_error error = foxglove_ring_buffer_sink_close(impl_.release());
+  return FoxgloveError(error);
+}
+
+RingBufferSnapshot::RingBufferSnapshot(foxglove_ring_buffer_snapshot* snapshot)
+    : impl_(snapshot, foxglove_ring_buffer_snapshot_detach) {}
+
+FoxgloveError RingBufferSnapshot::wait() {
+  foxglove_error error = foxglove_ring_buffer_snapshot_wait(impl_.release());
+  return FoxgloveError(error);
+}
+
+}  // namespace foxglove
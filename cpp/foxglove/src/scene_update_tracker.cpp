@@ -0,0 +1,132 @@
+#include <foxglove/scene_update_tracker.hpp>
+
+#include <utility>
+
+namespace foxglove {
+
+namespace {
+
+// Keys of the SceneUpdate fields, as length-delimited protobuf fields.
+constexpr uint8_t kDeletionsKey = (1 << 3) | 2;
+constexpr uint8_t kEntitiesKey = (2 << 3) | 2;
+
+/// Appends a length-delimited field holding already encoded bytes.
+void appendField(std::vector<uint8_t>& buf, uint8_t key, const std::vector<uint8_t>& encoded) {
+  buf.push_back(key);
+  uint64_t len = encoded.size();
+  while (len >= 0x80) {
+    buf.push_back(static_cast<uint8_t>(len | 0x80));
+    len >>= 7;
+  }
+  buf.push_back(static_cast<uint8_t>(len));
+  buf.insert(buf.end(), encoded.begin(), encoded.end());
+}
+
+/// Returns a deletion timestamp later than the entity's own, since the Foxglove app only deletes
+/// entities older than the deletion.
+std::optional<messages::Timestamp> deletionTimestamp(
+  const std::optional<messages::Timestamp>& entity_timestamp
+) {
+  if (!entity_timestamp) {
+    return std::nullopt;
+  }
+  messages::Timestamp timestamp = *entity_timestamp;
+  if (++timestamp.nsec >= 1'000'000'000) {
+    timestamp.nsec = 0;
+    ++timestamp.sec;
+  }
+  return timestamp;
+}
+
+}  // namespace
+
+FoxgloveResult<SceneUpdateTracker> SceneUpdateTracker::create(
+  const std::string_view& topic, const Context& context
+) {
+  auto channel = RawChannel::create(topic, "protobuf", messages::SceneUpdate::schema(), context);
+  if (!channel.has_value()) {
+    return tl::unexpected(channel.error());
+  }
+  return SceneUpdateTracker(std::move(*channel));
+}
+
+SceneUpdateTracker::SceneUpdateTracker(RawChannel channel)
+    : channel_(std::move(channel)) {}
+
+FoxgloveError SceneUpdateTracker::log(
+  const messages::SceneUpdate& scene, std::optional<uint64_t> log_time
+) noexcept {
+  const size_t consumers = channel_.demand().consumers;
+  if (consumers == 0) {
+    // Nobody has seen the scene, so the next consumer starts from a full update anyway.
+    reset();
+    return FoxgloveError::Ok;
+  }
+  const bool full = consumers > consumers_;
+  consumers_ = consumers;
+  ++generation_;
+
+  changed_.clear();
+  for (const auto& entity : scene.entities) {
+    scratch_.clear();
+    FoxgloveError error = entity.encode(scratch_);
+    if (error != FoxgloveError::Ok) {
+      // The tracked scene no longer matches what consumers have seen.
+      reset();
+      return error;
+    }
+    auto [it, inserted] = entities_.try_emplace(entity.id);
+    TrackedEntity& tracked = it->second;
+    tracked.generation = generation_;
+    if (inserted || tracked.encoded != scratch_) {
+      tracked.encoded.swap(scratch_);
+      tracked.timestamp = entity.timestamp;
+    } else if (!full) {
+      continue;
+    }
+    appendField(changed_, kEntitiesKey, tracked.encoded);
+  }
+
+  // Fields are written in the order of the schema, as the message's own encoder does.
+  update_.clear();
+  for (auto it = entities_.begin(); it != entities_.end();) {
+    if (it->second.generation == generation_) {
+      ++it;
+      continue;
+    }
+    messages::SceneEntityDeletion deletion;
+    deletion.timestamp = deletionTimestamp(it->second.timestamp);
+    deletion.type = messages::SceneEntityDeletion::SceneEntityDeletionType::MATCHING_ID;
+    deletion.id = it->first;
+    scratch_.clear();
+    FoxgloveError error = deletion.encode(scratch_);
+    if (error != FoxgloveError::Ok) {
+      reset();
+      return error;
+    }
+    appendField(update_, kDeletionsKey, scratch_);
+    it = entities_.erase(it);
+  }
+  update_.insert(update_.end(), changed_.begin(), changed_.end());
+
+  if (update_.empty()) {
+    return FoxgloveError::Ok;
+  }
+  FoxgloveError error =
+    channel_.log(reinterpret_cast<const std::byte*>(update_.data()), update_.size(), log_time);
+  if (error != FoxgloveError::Ok) {
+    reset();
+  }
+  return error;
+}
+
+void SceneUpdateTracker::reset() noexcept {
+  entities_.clear();
+  consumers_ = 0;
+}
+
+void SceneUpdateTracker::close() noexcept {
+  channel_.close();
+}
+
+}  // namespace foxglove
@@ -71,20 +71,48 @@ void ServiceResponder::respondError(std::string_view message) && noexcept {
   foxglove_service_respond_error(ptr, {message.data(), message.length()});
 }
 
+bool ServiceResponder::isCancelled() const noexcept {
+  return foxglove_service_responder_is_cancelled(impl_.get());
+}
+
+/**
+ * ServiceOptions implementation.
+ */
+void ServiceOptions::writeTo(foxglove_service_options* c) const noexcept {
+  c->worker_threads = this->worker_threads;
+  c->max_in_flight = this->max_in_flight;
+  c->queue_timeout_ms = this->queue_timeout.count() > 0
+                          ? static_cast<uint64_t>(this->queue_timeout.count())
+                          : 0;
+  c->response_cache_ttl_ms = this->response_cache_ttl.count() > 0
+                               ? static_cast<uint64_t>(this->response_cache_ttl.count())
+                               : 0;
+}
+
 /**
  * Service implementation.
  */
 FoxgloveResult<Service> Service::create(
   std::string_view name, ServiceSchema& schema, ServiceHandler& handler
+) {
+  return create(name, schema, handler, ServiceOptions{});
+}
+
+FoxgloveResult<Service> Service::create(
+  std::string_view name, ServiceSchema& schema, ServiceHandler& handler,
+  const ServiceOptions& options
 ) {
   std::array<foxglove_service_message_schema, 2> msg_schemas{};
   foxglove_service_schema c_schema;
   schema.writeTo(&c_schema, msg_schemas);
+  foxglove_service_options c_options{};
+  options.writeTo(&c_options);
   foxglove_service* ptr = nullptr;
-  auto error = foxglove_service_create(
+  auto error = foxglove_service_create_with_options(
     &ptr,
     {name.data(), name.length()},
     &c_schema,
+    &c_options,
     &handler,
     [](
       const void* context,
@@ -0,0 +1,46 @@
+#include <foxglove-c/foxglove-c.h>
+#include <foxglove/error.hpp>
+#include <foxglove/shared_memory.hpp>
+
+#include "callback_forwarders.hpp"
+
+namespace foxglove {
+
+FoxgloveResult<SharedMemorySink> SharedMemorySink::create(SharedMemorySinkOptions&& options) {
+  foxglove_internal_register_cpp_wrapper();
+
+  foxglove_shared_memory_sink_options c_options = {};
+  c_options.context = options.context.getInner();
+  c_options.path = {options.path.data(), options.path.length()};
+  c_options.capacity = options.capacity;
+
+  std::unique_ptr<SinkChannelFilterFn> sink_channel_filter;
+  internal::wireSinkChannelFilter(
+    c_options, std::move(options.sink_channel_filter), sink_channel_filter
+  );
+
+  foxglove_shared_memory_sink* sink = nullptr;
+  foxglove_error error = foxglove_shared_memory_sink_create(&c_options, &sink);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || sink == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  return SharedMemorySink(sink, std::move(sink_channel_filter));
+}
+
+SharedMemorySink::SharedMemorySink(
+  foxglove_shared_memory_sink* sink, std::unique_ptr<SinkChannelFilterFn> sink_channel_filter
+)
+    : sink_channel_filter_(std::move(sink_channel_filter))
+    , impl_(sink, foxglove_shared_memory_sink_close) {}
+
+std::string_view SharedMemorySink::token() const noexcept {
+  foxglove_string token = foxglove_shared_memory_sink_token(impl_.get());
+  return {token.data, token.len};
+}
+
+FoxgloveError SharedMemorySink::close() {
+  foxglove_error error = foxglove_shared_memory_sink_close(impl_.release());
+  return FoxgloveError(error);
+}
+
+}  // namespace foxglove
@@ -25,6 +25,10 @@ FoxgloveResult<SystemInfoPublisher> SystemInfoPublisher::create(
     c_options.refresh_interval_ms = &*refresh_interval_ms;
   }
 
+  if (options.metrics) {
+    c_options.metrics = static_cast<uint32_t>(*options.metrics);
+  }
+
   foxglove_system_info_publisher* publisher = nullptr;
   foxglove_error error = foxglove_system_info_publisher_start(&c_options, &publisher);
   if (error != foxglove_error::FOXGLOVE_ERROR_OK || publisher == nullptr) {
@@ -0,0 +1,126 @@
+#pragma once
+
+/// @cond foxglove_internal
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+
+namespace foxglove {
+
+/// Tracks the relationship between file timestamps and wall-clock time.
+///
+/// Converts between "log time" (nanosecond timestamps in the MCAP file) and real wall-clock
+/// time, accounting for playback speed, pause/resume, and speed changes.
+///
+/// The mapping is anchored at a (wall time, log time) pair, which only moves when playback is
+/// paused, resumed or changes speed. Deadlines are computed from the anchor rather than from the
+/// time of the previous wakeup, so late wakeups do not accumulate into drift.
+class TimeTracker {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr float kMinPlaybackSpeed = 0.01f;
+
+  TimeTracker(uint64_t offset_ns, float speed, Clock::time_point now = Clock::now())
+      : anchor_wall_(now)
+      , anchor_log_(offset_ns)
+      , speed_(clampSpeed(speed))
+      , paused_(false)
+      , notify_interval_ns_(1'000'000'000 / 60)
+      , notify_last_(0) {}
+
+  /// Returns the current log time based on elapsed wall time and playback speed.
+  uint64_t currentLogTime(Clock::time_point now = Clock::now()) const {
+    if (paused_ || now <= anchor_wall_) {
+      return anchor_log_;
+    }
+    double elapsed_ns = std::chrono::duration<double, std::nano>(now - anchor_wall_).count();
+    return anchor_log_ + static_cast<uint64_t>(elapsed_ns * static_cast<double>(speed_));
+  }
+
+  /// Returns the wall-clock time point at which a message with the given log_time is due, or
+  /// Clock::time_point::max() while paused.
+  Clock::time_point deadlineFor(uint64_t log_time) const {
+    if (paused_) {
+      return Clock::time_point::max();
+    }
+    if (log_time <= anchor_log_) {
+      return anchor_wall_;
+    }
+    std::chrono::duration<double, std::nano> wait(
+      static_cast<double>(log_time - anchor_log_) / static_cast<double>(speed_)
+    );
+    // Keep far-off deadlines, such as at the minimum speed, from overflowing the clock.
+    if (wait > std::chrono::hours(24 * 365)) {
+      return Clock::time_point::max();
+    }
+    return anchor_wall_ + std::chrono::duration_cast<Clock::duration>(wait);
+  }
+
+  /// Returns how far past its deadline a message with the given log_time is, or zero if it is
+  /// not yet due.
+  std::chrono::nanoseconds latenessOf(uint64_t log_time, Clock::time_point now) const {
+    auto deadline = deadlineFor(log_time);
+    if (now <= deadline) {
+      return std::chrono::nanoseconds::zero();
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline);
+  }
+
+  /// Pauses time tracking, accumulating elapsed log time.
+  void pause(Clock::time_point now = Clock::now()) {
+    if (!paused_) {
+      anchor_log_ = currentLogTime(now);
+      paused_ = true;
+    }
+  }
+
+  /// Resumes time tracking from where it was paused.
+  void resume(Clock::time_point now = Clock::now()) {
+    if (paused_) {
+      anchor_wall_ = now;
+      paused_ = false;
+    }
+  }
+
+  /// Changes the playback speed, accumulating elapsed time at the old speed.
+  void setSpeed(float speed, Clock::time_point now = Clock::now()) {
+    if (!paused_) {
+      anchor_log_ = currentLogTime(now);
+      anchor_wall_ = now;
+    }
+    speed_ = clampSpeed(speed);
+  }
+
+  /// Clamps speed to a minimum value.
+  static float clampSpeed(float speed) {
+    if (std::isfinite(speed) && speed >= kMinPlaybackSpeed) {
+      return speed;
+    }
+    return kMinPlaybackSpeed;
+  }
+
+  /// Returns the current log time if enough time has passed since the last notification (~60 Hz).
+  std::optional<uint64_t> notify(uint64_t current_ns) {
+    if (current_ns - notify_last_ >= notify_interval_ns_) {
+      notify_last_ = current_ns;
+      return current_ns;
+    }
+    return std::nullopt;
+  }
+
+private:
+  Clock::time_point anchor_wall_;
+  uint64_t anchor_log_;
+  float speed_;
+  bool paused_;
+  uint64_t notify_interval_ns_;
+  uint64_t notify_last_;
+};
+
+}  // namespace foxglove
+
+/// @endcond
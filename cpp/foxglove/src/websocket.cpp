@@ -4,9 +4,12 @@
 #include <foxglove/error.hpp>
 #include <foxglove/websocket.hpp>
 
+#include <algorithm>
 #include <type_traits>
+#include <utility>
 
 #include "callback_forwarders.hpp"
+#include "callback_queue.hpp"
 
 namespace foxglove {
 namespace {
@@ -69,6 +72,19 @@ void forwardOnMessageData(
   });
 }
 
+void forwardOnMessageDataOwned(
+  const void* context, uint32_t client_id, uint32_t client_channel_id,
+  foxglove_client_message_buffer payload
+) {
+  // Take ownership first, so that the buffer is released even if the callback throws.
+  ClientMessageBuffer buffer(payload);
+  internal::callbackGuard("onMessageDataOwned", [&] {
+    static_cast<const WebSocketServerCallbacks*>(context)->onMessageDataOwned(
+      client_id, client_channel_id, std::move(buffer)
+    );
+  });
+}
+
 // The C ABI signature for on_client_unadvertise places context after the ids,
 // not first; we preserve that to match the C header.
 void forwardOnClientUnadvertise(
@@ -93,6 +109,40 @@ void forwardOnClientDisconnect(const void* context) {
   });
 }
 
+ClientStats toClientStats(const foxglove_client_stats& c_stats) {
+  ClientStats stats;
+  stats.client_id = c_stats.client_id;
+  stats.sent = c_stats.sent;
+  stats.sent_bytes = c_stats.sent_bytes;
+  stats.dropped = c_stats.dropped;
+  stats.queued_messages = c_stats.queued_messages;
+  stats.queued_bytes = c_stats.queued_bytes;
+  stats.max_queued_messages = c_stats.max_queued_messages;
+  stats.max_queued_bytes = c_stats.max_queued_bytes;
+  stats.channels.reserve(c_stats.channels_count);
+  for (size_t i = 0; i < c_stats.channels_count; ++i) {
+    const foxglove_channel_stats& c_channel = c_stats.channels[i];
+    ChannelStats channel;
+    channel.channel_id = c_channel.channel_id;
+    channel.sequence = c_channel.sequence;
+    channel.sent = c_channel.sent;
+    channel.dropped = c_channel.dropped;
+    channel.conflated = c_channel.conflated;
+    channel.queued_messages = c_channel.queued_messages;
+    channel.queued_bytes = c_channel.queued_bytes;
+    channel.max_queued_messages = c_channel.max_queued_messages;
+    channel.max_queued_bytes = c_channel.max_queued_bytes;
+    stats.channels.push_back(channel);
+  }
+  return stats;
+}
+
+void forwardOnBackpressure(const void* context, const foxglove_client_stats* c_stats) {
+  internal::callbackGuard("onBackpressure", [&] {
+    static_cast<const WebSocketServerCallbacks*>(context)->onBackpressure(toClientStats(*c_stats));
+  });
+}
+
 void forwardOnPlaybackControlRequest(
   const void* context, const foxglove_playback_control_request* c_request,
   foxglove_playback_state* c_state
@@ -151,6 +201,10 @@ bool wireServerCallbacks(foxglove_server_callbacks& c, const WebSocketServerCall
     c.on_message_data = &forwardOnMessageData;
     any = true;
   }
+  if (cb.onMessageDataOwned) {
+    c.on_message_data_owned = &forwardOnMessageDataOwned;
+    any = true;
+  }
   if (cb.onClientUnadvertise) {
     c.on_client_unadvertise = &forwardOnClientUnadvertise;
     any = true;
@@ -189,6 +243,10 @@ bool wireServerCallbacks(foxglove_server_callbacks& c, const WebSocketServerCall
     c.on_client_disconnect = &forwardOnClientDisconnect;
     any = true;
   }
+  if (cb.onBackpressure) {
+    c.on_backpressure = &forwardOnBackpressure;
+    any = true;
+  }
   if (cb.onPlaybackControlRequest) {
     c.on_playback_control_request = &forwardOnPlaybackControlRequest;
     any = true;
@@ -201,6 +259,91 @@ bool wireServerCallbacks(foxglove_server_callbacks& c, const WebSocketServerCall
 #pragma warning(pop)
 #endif
 
+// Replaces the notification callbacks of `cb` with callbacks which queue them on `queue`, for
+// WebSocketServerOptions::poll_callbacks. Callbacks which return a value to the server, and
+// onBackpressure, are left to be invoked directly.
+WebSocketServerCallbacks queueServerCallbacks(
+  const std::shared_ptr<internal::CallbackQueue>& queue, WebSocketServerCallbacks&& cb
+) {
+  WebSocketServerCallbacks queued = std::move(cb);
+  queued.onSubscribe = internal::queueCalls(queue, "onSubscribe", std::move(queued.onSubscribe));
+  queued.onUnsubscribe =
+    internal::queueCalls(queue, "onUnsubscribe", std::move(queued.onUnsubscribe));
+  queued.onClientUnadvertise =
+    internal::queueCalls(queue, "onClientUnadvertise", std::move(queued.onClientUnadvertise));
+  queued.onParametersSubscribe = internal::queueParameterNameCalls(
+    queue, "onParametersSubscribe", std::move(queued.onParametersSubscribe)
+  );
+  queued.onParametersUnsubscribe = internal::queueParameterNameCalls(
+    queue, "onParametersUnsubscribe", std::move(queued.onParametersUnsubscribe)
+  );
+  queued.onConnectionGraphSubscribe = internal::queueCalls(
+    queue, "onConnectionGraphSubscribe", std::move(queued.onConnectionGraphSubscribe)
+  );
+  queued.onConnectionGraphUnsubscribe = internal::queueCalls(
+    queue, "onConnectionGraphUnsubscribe", std::move(queued.onConnectionGraphUnsubscribe)
+  );
+  queued.onClientConnect =
+    internal::queueCalls(queue, "onClientConnect", std::move(queued.onClientConnect));
+  queued.onClientDisconnect =
+    internal::queueCalls(queue, "onClientDisconnect", std::move(queued.onClientDisconnect));
+
+  if (queued.onClientAdvertise) {
+    auto target = std::make_shared<decltype(queued.onClientAdvertise)>(
+      std::move(queued.onClientAdvertise)
+    );
+    queued.onClientAdvertise = [queue, target](uint32_t client_id, const ClientChannel& channel) {
+      queue->push([target,
+                   client_id,
+                   id = channel.id,
+                   topic = std::string(channel.topic),
+                   encoding = std::string(channel.encoding),
+                   schema_name = std::string(channel.schema_name),
+                   schema_encoding = std::string(channel.schema_encoding),
+                   schema = std::vector<std::byte>(
+                     channel.schema, channel.schema + (channel.schema ? channel.schema_len : 0)
+                   )] {
+        internal::callbackGuard("onClientAdvertise", [&] {
+          ClientChannel view = {
+            id, topic, encoding, schema_name, schema_encoding, schema.data(), schema.size()
+          };
+          (*target)(client_id, view);
+        });
+      });
+    };
+  }
+  if (queued.onMessageData) {
+    auto target =
+      std::make_shared<decltype(queued.onMessageData)>(std::move(queued.onMessageData));
+    queued.onMessageData = [queue, target](
+                             uint32_t client_id, uint32_t client_channel_id,
+                             const std::byte* data, size_t data_len
+                           ) {
+      std::vector<std::byte> payload(data, data + data_len);
+      queue->push([target, client_id, client_channel_id, payload = std::move(payload)] {
+        internal::callbackGuard("onMessageData", [&] {
+          (*target)(client_id, client_channel_id, payload.data(), payload.size());
+        });
+      });
+    };
+  }
+  if (queued.onMessageDataOwned) {
+    auto target =
+      std::make_shared<decltype(queued.onMessageDataOwned)>(std::move(queued.onMessageDataOwned));
+    queued.onMessageDataOwned =
+      [queue, target](uint32_t client_id, uint32_t client_channel_id, ClientMessageBuffer data) {
+        // The buffer is move-only, so it is shared with the queued event.
+        auto buffer = std::make_shared<ClientMessageBuffer>(std::move(data));
+        queue->push([target, client_id, client_channel_id, buffer] {
+          internal::callbackGuard("onMessageDataOwned", [&] {
+            (*target)(client_id, client_channel_id, std::move(*buffer));
+          });
+        });
+      };
+  }
+  return queued;
+}
+
 }  // namespace
 
 FoxgloveResult<WebSocketServer> WebSocketServer::create(
@@ -208,6 +351,14 @@ FoxgloveResult<WebSocketServer> WebSocketServer::create(
 ) {
   foxglove_internal_register_cpp_wrapper();
 
+  std::shared_ptr<internal::CallbackQueue> callback_queue;
+  if (options.poll_callbacks) {
+    callback_queue = std::make_shared<internal::CallbackQueue>();
+    options.callbacks = queueServerCallbacks(callback_queue, std::move(options.callbacks));
+    options.parameter_handler =
+      internal::queueParameterHandler(callback_queue, std::move(options.parameter_handler));
+  }
+
   foxglove_server_callbacks c_callbacks = {};
   std::unique_ptr<WebSocketServerCallbacks> callbacks;
   if (wireServerCallbacks(c_callbacks, options.callbacks)) {
@@ -217,7 +368,9 @@ FoxgloveResult<WebSocketServer> WebSocketServer::create(
 
   std::unique_ptr<FetchAssetHandler> fetch_asset;
   std::unique_ptr<SinkChannelFilterFn> sink_channel_filter;
+  std::unique_ptr<SinkChannelFilterFn> compression_filter;
   std::unique_ptr<ParameterHandler> parameter_handler;
+  std::unique_ptr<MessageFilterFn> message_filter;
 
   foxglove_server_options c_options = {};
   c_options.context = options.context.getInner();
@@ -264,11 +417,13 @@ FoxgloveResult<WebSocketServer> WebSocketServer::create(
     c_options.tls_cert_len = options.tls_identity->cert.size();
     c_options.tls_key = reinterpret_cast<const uint8_t*>(options.tls_identity->key.data());
     c_options.tls_key_len = options.tls_identity->key.size();
+    c_options.kernel_tls = options.kernel_tls;
   }
 
   internal::wireSinkChannelFilter(
     c_options, std::move(options.sink_channel_filter), sink_channel_filter
   );
+  internal::wireMessageFilter(c_options, std::move(options.message_filter), message_filter);
 
   std::optional<foxglove_string> session_id;
   if (options.session_id) {
@@ -277,6 +432,34 @@ FoxgloveResult<WebSocketServer> WebSocketServer::create(
   }
 
   c_options.message_backlog_size = options.message_backlog_size.value_or(0);
+  c_options.writer_threads = options.writer_threads.value_or(0);
+  c_options.reuse_port = options.reuse_port;
+  c_options.fetch_asset_cache_bytes = options.fetch_asset_cache_bytes;
+  c_options.parameter_coalesce_window_ms =
+    static_cast<uint64_t>(std::max<int64_t>(options.parameter_coalesce_window.count(), 0));
+  c_options.connection_graph_coalesce_window_ms =
+    static_cast<uint64_t>(std::max<int64_t>(options.connection_graph_coalesce_window.count(), 0));
+  c_options.broadcast_coalesce_window_ms =
+    static_cast<uint64_t>(std::max<int64_t>(options.broadcast_coalesce_window.count(), 0));
+  c_options.message_backlog_bytes = options.message_backlog_bytes.value_or(0);
+  c_options.channel_backlog_bytes = options.channel_backlog_bytes.value_or(0);
+  c_options.backlog_drop_policy =
+    static_cast<foxglove_backlog_drop_policy>(options.backlog_drop_policy);
+  c_options.subscription_options.max_rate = options.subscription_options.max_rate.value_or(0);
+  c_options.subscription_options.conflate = options.subscription_options.conflate;
+  c_options.compression = options.compression;
+  c_options.message_batch_linger_us =
+    static_cast<uint64_t>(std::max<int64_t>(options.message_batch_linger.count(), 0));
+  c_options.message_batch_bytes = options.message_batch_bytes.value_or(0);
+  if (options.compression_filter) {
+    compression_filter =
+      std::make_unique<SinkChannelFilterFn>(std::move(options.compression_filter));
+    c_options.compression_filter_context = compression_filter.get();
+    c_options.compression_filter = &internal::forwardSinkChannelFilter;
+  }
+  if (options.shared_memory_sink != nullptr) {
+    c_options.shared_memory_sink = options.shared_memory_sink->impl_.get();
+  }
 
   foxglove_websocket_server* server = nullptr;
   foxglove_error error = foxglove_server_start(&c_options, &server);
@@ -289,7 +472,10 @@ FoxgloveResult<WebSocketServer> WebSocketServer::create(
     std::move(callbacks),
     std::move(fetch_asset),
     std::move(sink_channel_filter),
-    std::move(parameter_handler)
+    std::move(compression_filter),
+    std::move(parameter_handler),
+    std::move(message_filter),
+    std::move(callback_queue)
   );
 }
 
@@ -297,14 +483,34 @@ WebSocketServer::WebSocketServer(
   foxglove_websocket_server* server, std::unique_ptr<WebSocketServerCallbacks> callbacks,
   std::unique_ptr<FetchAssetHandler> fetch_asset,
   std::unique_ptr<SinkChannelFilterFn> sink_channel_filter,
-  std::unique_ptr<ParameterHandler> parameter_handler
+  std::unique_ptr<SinkChannelFilterFn> compression_filter,
+  std::unique_ptr<ParameterHandler> parameter_handler,
+  std::unique_ptr<MessageFilterFn> message_filter,
+  std::shared_ptr<internal::CallbackQueue> callback_queue
 )
     : callbacks_(std::move(callbacks))
     , fetch_asset_(std::move(fetch_asset))
     , sink_channel_filter_(std::move(sink_channel_filter))
+    , compression_filter_(std::move(compression_filter))
     , parameter_handler_(std::move(parameter_handler))
+    , message_filter_(std::move(message_filter))
+    , callback_queue_(std::move(callback_queue))
     , impl_(server, foxglove_server_stop) {}
 
+size_t WebSocketServer::pollEvents(size_t max_events) {
+  if (!callback_queue_) {
+    return 0;
+  }
+  return callback_queue_->poll(max_events);
+}
+
+ServiceHandler WebSocketServer::polledServiceHandler(ServiceHandler&& handler) const {
+  if (!callback_queue_) {
+    return std::move(handler);
+  }
+  return internal::queueServiceCalls(callback_queue_, std::move(handler));
+}
+
 FoxgloveError WebSocketServer::stop() {
   foxglove_error error = foxglove_server_stop(impl_.release());
   return FoxgloveError(error);
@@ -318,6 +524,25 @@ size_t WebSocketServer::clientCount() const {
   return foxglove_server_get_client_count(impl_.get());
 }
 
+FoxgloveResult<std::vector<ClientStats>> WebSocketServer::stats() const {
+  foxglove_server_stats* c_stats = nullptr;
+  foxglove_error error = foxglove_server_get_stats(impl_.get(), &c_stats);
+  if (error != foxglove_error::FOXGLOVE_ERROR_OK || c_stats == nullptr) {
+    return tl::unexpected(static_cast<FoxgloveError>(error));
+  }
+  std::unique_ptr<foxglove_server_stats, void (*)(foxglove_server_stats*)> guard(
+    c_stats, foxglove_server_stats_free
+  );
+  size_t count = 0;
+  const foxglove_client_stats* clients = foxglove_server_stats_clients(c_stats, &count);
+  std::vector<ClientStats> result;
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    result.push_back(toClientStats(clients[i]));
+  }
+  return result;
+}
+
 void WebSocketServer::broadcastTime(uint64_t timestamp_nanos) const noexcept {
   foxglove_server_broadcast_time(impl_.get(), timestamp_nanos);
 }
@@ -361,14 +586,22 @@ FoxgloveError WebSocketServer::removeService(std::string_view name) const noexce
 }
 
 void WebSocketServer::publishParameterValues(std::vector<Parameter>&& params) {
-  ParameterArray array(std::move(params));
-  foxglove_server_publish_parameter_values(impl_.get(), array.release());
+  publishParameterValues(ParameterArray(std::move(params)));
+}
+
+void WebSocketServer::publishParameterValues(ParameterArray&& params) {
+  foxglove_server_publish_parameter_values(impl_.get(), params.release());
 }
 
 void WebSocketServer::publishConnectionGraph(ConnectionGraph& graph) {
   foxglove_server_publish_connection_graph(impl_.get(), graph.impl_.get());
 }
 
+FoxgloveError WebSocketServer::updateConnectionGraph(ConnectionGraphPatch&& patch) {
+  auto* c_patch = patch.impl_.release();
+  return FoxgloveError(foxglove_server_update_connection_graph(impl_.get(), c_patch));
+}
+
 FoxgloveError WebSocketServer::publishStatus(
   WebSocketServerStatusLevel level, std::string_view message, std::optional<std::string_view> id
 ) const noexcept {
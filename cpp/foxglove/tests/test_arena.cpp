@@ -5,6 +5,7 @@
 
 #include <array>
 #include <string>
+#include <vector>
 
 using Catch::Matchers::ContainsSubstring;
 using Catch::Matchers::Equals;
@@ -87,3 +88,80 @@ TEST_CASE("allocate from heap when arena capacity is exceeded") {
   REQUIRE(overflow1[0] == 1234567890);
   REQUIRE(overflow2[0] == 1234567890123456789);
 }
+
+TEST_CASE("reset arena reuses retained overflow blocks") {
+  foxglove::Arena arena;
+  constexpr size_t kOverflowSize = foxglove::Arena::kSize * 2;
+
+  char* first = arena.alloc<char>(kOverflowSize);
+  REQUIRE(first != nullptr);
+  REQUIRE(arena.overflowAllocations() == 1);
+
+  arena.reset();
+  REQUIRE(arena.used() == 0);
+  REQUIRE(arena.available() == foxglove::Arena::kSize);
+
+  // The same workload after reset is served from the retained block
+  char* second = arena.alloc<char>(kOverflowSize);
+  REQUIRE(second != nullptr);
+  REQUIRE(arena.overflowAllocations() == 1);
+
+  // A second overflow in the same cycle needs a new block
+  auto* third = arena.alloc<uint64_t>(kOverflowSize / sizeof(uint64_t));
+  REQUIRE(third != nullptr);
+  REQUIRE(arena.overflowAllocations() == 2);
+}
+
+TEST_CASE("reset arena frees overflow blocks past the retention limit") {
+  foxglove::Arena arena;
+  arena.alloc<char>(foxglove::Arena::kMaxRetainedBytes);
+  arena.alloc<char>(foxglove::Arena::kMaxRetainedBytes);
+  REQUIRE(arena.overflowBytes() > foxglove::Arena::kMaxRetainedBytes);
+
+  arena.reset();
+  REQUIRE(arena.overflowBytes() <= foxglove::Arena::kMaxRetainedBytes);
+}
+
+TEST_CASE("overflow allocations bump-allocate from growing blocks") {
+  foxglove::Arena arena;
+  arena.alloc<char>(foxglove::Arena::kSize);
+
+  // 10k small arrays take a handful of blocks rather than one allocation each
+  constexpr size_t kCount = 10000;
+  std::array<uint64_t*, 8> first{};
+  for (size_t i = 0; i < kCount; ++i) {
+    auto* ptr = arena.alloc<uint64_t>(4);
+    REQUIRE(reinterpret_cast<uintptr_t>(ptr) % alignof(uint64_t) == 0);
+    ptr[0] = i;
+    if (i < first.size()) {
+      first[i] = ptr;
+    }
+  }
+  REQUIRE(arena.overflowAllocations() < 16);
+  for (size_t i = 0; i < first.size(); ++i) {
+    REQUIRE(first[i][0] == i);
+  }
+
+  // Once warm, the same workload allocates nothing
+  const size_t warm_allocations = arena.overflowAllocations();
+  arena.reset();
+  arena.alloc<char>(foxglove::Arena::kSize);
+  for (size_t i = 0; i < kCount; ++i) {
+    arena.alloc<uint64_t>(4);
+  }
+  REQUIRE(arena.overflowAllocations() == warm_allocations);
+}
+
+TEST_CASE("basic arena with a custom inline capacity") {
+  foxglove::BasicArena<64> arena;
+  REQUIRE(arena.available() == 64);
+  arena.alloc<char>(64);
+  REQUIRE(arena.overflowAllocations() == 0);
+
+  foxglove::ArenaBase& base = arena;
+  auto* mapped = base.map<int>(std::vector<int>{1, 2, 3}, [](int& dest, const int& src, auto&) {
+    dest = src * 2;
+  });
+  REQUIRE(mapped[2] == 6);
+  REQUIRE(arena.overflowAllocations() == 1);
+}
@@ -9,7 +9,12 @@
 
 #include <array>
 #include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "common/file_cleanup.hpp"
 #include "common/test_helpers.hpp"
@@ -65,6 +70,49 @@ TEST_CASE("channel.hasSinks()") {
   REQUIRE(requireValue(channel2).hasSinks());
 }
 
+TEST_CASE("channel.demand()") {
+  const auto* fname = "test-channel-demand.mcap";
+  FileCleanup cleanup(fname);
+
+  auto context = foxglove::Context::create();
+  auto channel = foxglove::RawChannel::create("test", "json", std::nullopt, context);
+  auto demand = requireValue(channel).demand();
+  REQUIRE(!demand.subscribed());
+  REQUIRE(demand.consumers == 0);
+  REQUIRE(demand.max_rate == 0.0);
+
+  foxglove::McapWriterOptions mcap_options = {};
+  mcap_options.context = context;
+  mcap_options.path = fname;
+  auto writer = foxglove::McapWriter::create(mcap_options);
+  REQUIRE(writer.has_value());
+
+  // An MCAP writer receives every message.
+  demand = requireValue(channel).demand();
+  REQUIRE(demand.subscribed());
+  REQUIRE(demand.consumers == 1);
+  REQUIRE(!demand.max_rate.has_value());
+}
+
+TEST_CASE("channel.logOwned() releases the buffer once logged") {
+  const auto* fname = "test-channel-log-owned.mcap";
+  FileCleanup cleanup(fname);
+
+  auto context = foxglove::Context::create();
+  foxglove::McapWriterOptions mcap_options = {};
+  mcap_options.context = context;
+  mcap_options.path = fname;
+  mcap_options.async_writes = true;
+  auto writer = foxglove::McapWriter::create(mcap_options);
+  REQUIRE(writer.has_value());
+  auto channel = foxglove::RawChannel::create("test", "json", std::nullopt, context);
+
+  std::shared_ptr<const std::byte[]> data(new std::byte[2]{std::byte{'{'}, std::byte{'}'}});
+  REQUIRE(requireValue(channel).logOwned(data, 2) == foxglove::FoxgloveError::Ok);
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+  REQUIRE(data.use_count() == 1);
+}
+
 TEST_CASE("channel.close() disconnects sinks") {
   const auto* fname = "test-channel-close-disconnects-sinks.mcap";
   FileCleanup cleanup(fname);
@@ -90,6 +138,38 @@ TEST_CASE("channel.close() disconnects sinks") {
   REQUIRE(!requireValue(typed_channel).hasSinks());
 }
 
+TEST_CASE("channel.bindContext() dispatches to the sinks of both contexts") {
+  const auto* fname = "test-channel-bind-context.mcap";
+  FileCleanup cleanup(fname);
+
+  auto context = foxglove::Context::create();
+  auto other = foxglove::Context::create();
+
+  foxglove::McapWriterOptions mcap_options = {};
+  mcap_options.context = other;
+  mcap_options.path = fname;
+  auto writer = foxglove::McapWriter::create(mcap_options);
+  REQUIRE(writer.has_value());
+
+  auto channel = foxglove::RawChannel::create("bound", "json", std::nullopt, context);
+  REQUIRE(!requireValue(channel).hasSinks());
+
+  // Binding to the channel's own context is a no-op.
+  REQUIRE(requireValue(channel).bindContext(context) == foxglove::FoxgloveError::Ok);
+  REQUIRE(requireValue(channel).bindContext(other) == foxglove::FoxgloveError::Ok);
+  REQUIRE(requireValue(channel).hasSinks());
+
+  // A context which already has an identical channel can't be bound.
+  auto third = foxglove::Context::create();
+  auto existing = foxglove::RawChannel::create("bound", "json", std::nullopt, third);
+  REQUIRE(existing.has_value());
+  REQUIRE(requireValue(channel).bindContext(third) == foxglove::FoxgloveError::ValueError);
+
+  requireValue(channel).close();
+  REQUIRE(!requireValue(channel).hasSinks());
+  REQUIRE(requireValue(channel).bindContext(other) == foxglove::FoxgloveError::ValueError);
+}
+
 TEST_CASE("channel.schema()") {
   foxglove::Schema mock_schema;
   mock_schema.encoding = "jsonschema";
@@ -138,6 +218,45 @@ TEST_CASE("channel with no metadata returns an empty value from metadata()") {
   REQUIRE(requireValue(chan_metadata).empty());
 }
 
+TEST_CASE("Context::createChannels") {
+  auto context = foxglove::Context::create();
+  auto existing = foxglove::RawChannel::create("/a", "json", std::nullopt, context);
+
+  std::string schema_data = R"({"type": "object"})";
+  foxglove::Schema schema;
+  schema.name = "test_schema";
+  schema.encoding = "jsonschema";
+  schema.data = reinterpret_cast<const std::byte*>(schema_data.data());
+  schema.data_len = schema_data.size();
+  std::map<std::string, std::string> metadata = {{"key", "value"}};
+
+  std::vector<foxglove::ChannelSpec> specs;
+  specs.push_back({"/a", "json", std::nullopt, std::nullopt});
+  specs.push_back({"/b", "json", schema, metadata});
+  specs.push_back({"/c", "protobuf", std::nullopt, std::nullopt});
+  auto channels = context.createChannels(specs);
+  auto& channels_val = requireValue(channels);
+  REQUIRE(channels_val.size() == 3);
+
+  // A matching channel which already exists is returned.
+  REQUIRE(channels_val[0].id() == requireValue(existing).id());
+  REQUIRE(channels_val[1].topic() == "/b");
+  REQUIRE(requireValue(channels_val[1].schema()).name == "test_schema");
+  REQUIRE(channels_val[1].metadata() == metadata);
+  REQUIRE(channels_val[2].messageEncoding() == "protobuf");
+
+  // If any spec is invalid, no channels are created.
+  specs.clear();
+  specs.push_back({"/d", "json", std::nullopt, std::nullopt});
+  specs.push_back({std::string("\x80\x80"), "json", std::nullopt, std::nullopt});
+  auto invalid = context.createChannels(specs);
+  REQUIRE(!invalid.has_value());
+  REQUIRE(invalid.error() == foxglove::FoxgloveError::Utf8Error);
+
+  auto empty = context.createChannels({});
+  REQUIRE(requireValue(empty).empty());
+}
+
 TEST_CASE("channel.log() accepts a zero-length message") {
   auto context = foxglove::Context::create();
   auto channel_result = foxglove::RawChannel::create("/empty-msg", "json", std::nullopt, context);
@@ -148,3 +267,39 @@ TEST_CASE("channel.log() accepts a zero-length message") {
   const std::array<std::byte, 1> dummy{std::byte{0}};
   REQUIRE(channel.log(dummy.data(), 0) == foxglove::FoxgloveError::Ok);
 }
+
+TEST_CASE("typed channel.log() skips encoding when no sink is subscribed") {
+  const auto* fname = "test-typed-channel-skips-encoding.mcap";
+  FileCleanup cleanup(fname);
+
+  auto context = foxglove::Context::create();
+  auto channel_result = foxglove::messages::LogChannel::create("/log", context);
+  auto& channel = requireValue(channel_result);
+  REQUIRE(!channel.hasSinks());
+
+  // Encoding this message fails, so logging it only succeeds if it is not encoded.
+  foxglove::messages::Log invalid;
+  invalid.message = "\xff";
+  REQUIRE(channel.log(invalid) == foxglove::FoxgloveError::Ok);
+  REQUIRE(channel.logBatch(&invalid, 1) == foxglove::FoxgloveError::Ok);
+
+  foxglove::McapWriterOptions mcap_options = {};
+  mcap_options.context = context;
+  mcap_options.path = fname;
+  mcap_options.compression = foxglove::McapCompression::None;
+  auto writer = foxglove::McapWriter::create(mcap_options);
+  REQUIRE(writer.has_value());
+  REQUIRE(channel.hasSinks());
+
+  // Once a sink is subscribed, messages are encoded, and the encoded bytes reach the sink.
+  REQUIRE(channel.log(invalid) == foxglove::FoxgloveError::Utf8Error);
+  REQUIRE(channel.logBatch(&invalid, 1) == foxglove::FoxgloveError::Utf8Error);
+  foxglove::messages::Log valid;
+  valid.message = "encoded for the sink";
+  REQUIRE(channel.log(valid) == foxglove::FoxgloveError::Ok);
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+
+  std::ifstream file(fname, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  REQUIRE_THAT(content, ContainsSubstring("encoded for the sink"));
+}
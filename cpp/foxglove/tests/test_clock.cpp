@@ -0,0 +1,30 @@
+#include <foxglove/clock.hpp>
+#include <foxglove/context.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+TEST_CASE("Context uses a sim clock until it is reset") {
+  auto context = foxglove::Context::create();
+  uint64_t before = context.now();
+  REQUIRE(before > 0);
+
+  foxglove::SimClock clock(1000);
+  context.setClock(clock);
+  REQUIRE(context.now() == 1000);
+  clock.setTime(2000);
+  REQUIRE(context.now() == 2000);
+  clock.advance(std::chrono::microseconds(1));
+  REQUIRE(context.now() == 3000);
+
+  // The context keeps the clock alive.
+  {
+    foxglove::SimClock other(5000);
+    context.setClock(other);
+  }
+  REQUIRE(context.now() == 5000);
+
+  context.resetClock();
+  REQUIRE(context.now() >= before);
+}
@@ -0,0 +1,197 @@
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/image.hpp>
+#include <foxglove/mcap.hpp>
+#include <foxglove/messages.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using foxglove::FoxgloveError;
+using foxglove::ImageFrame;
+using foxglove::PixelFormat;
+using foxglove::RawImageBuilder;
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+namespace {
+
+ImageFrame makeFrame(
+  const std::vector<uint8_t>& data, uint32_t width, uint32_t height, PixelFormat format,
+  uint32_t step = 0
+) {
+  ImageFrame frame;
+  frame.data = reinterpret_cast<const std::byte*>(data.data());
+  frame.data_len = data.size();
+  frame.width = width;
+  frame.height = height;
+  frame.step = step;
+  frame.format = format;
+  return frame;
+}
+
+uint8_t pixelAt(const RawImageBuilder& builder, size_t x, size_t y, size_t channel) {
+  return static_cast<uint8_t>(builder.data()[(((y * builder.width()) + x) * 3) + channel]);
+}
+
+}  // namespace
+
+TEST_CASE("RawImageBuilder swizzles BGR to RGB") {
+  // Enough pixels to exercise both the vectorized and the scalar paths, with padded rows.
+  const uint32_t width = 21;
+  const uint32_t height = 2;
+  const uint32_t step = (width * 3) + 5;
+  std::vector<uint8_t> data(static_cast<size_t>(step) * height);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+
+  RawImageBuilder builder;
+  REQUIRE(
+    builder.convert(makeFrame(data, width, height, PixelFormat::Bgr8, step)) == FoxgloveError::Ok
+  );
+  REQUIRE(builder.width() == width);
+  REQUIRE(builder.height() == height);
+  REQUIRE(builder.data().size() == static_cast<size_t>(width) * height * 3);
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < width; ++x) {
+      const size_t offset = (y * step) + (x * 3);
+      REQUIRE(pixelAt(builder, x, y, 0) == data[offset + 2]);
+      REQUIRE(pixelAt(builder, x, y, 1) == data[offset + 1]);
+      REQUIRE(pixelAt(builder, x, y, 2) == data[offset]);
+    }
+  }
+
+  auto view = builder.view();
+  REQUIRE(view.encoding == "rgb8");
+  REQUIRE(view.step == width * 3);
+  REQUIRE(view.data == builder.data().data());
+}
+
+TEST_CASE("RawImageBuilder converts YUV to RGB") {
+  SECTION("YUYV") {
+    // White and black pixels sharing neutral chroma.
+    std::vector<uint8_t> data = {235, 128, 16, 128};
+    RawImageBuilder builder;
+    REQUIRE(builder.convert(makeFrame(data, 2, 1, PixelFormat::Yuyv)) == FoxgloveError::Ok);
+    for (size_t c = 0; c < 3; ++c) {
+      REQUIRE(pixelAt(builder, 0, 0, c) == 255);
+      REQUIRE(pixelAt(builder, 1, 0, c) == 0);
+    }
+  }
+
+  SECTION("NV12") {
+    // A 2x2 Y plane and a single UV sample for pure red.
+    std::vector<uint8_t> data = {81, 81, 81, 81, 90, 240};
+    RawImageBuilder builder;
+    REQUIRE(builder.convert(makeFrame(data, 2, 2, PixelFormat::Nv12)) == FoxgloveError::Ok);
+    for (size_t y = 0; y < 2; ++y) {
+      for (size_t x = 0; x < 2; ++x) {
+        REQUIRE(pixelAt(builder, x, y, 0) == 255);
+        REQUIRE(pixelAt(builder, x, y, 1) == 0);
+        REQUIRE(pixelAt(builder, x, y, 2) == 0);
+      }
+    }
+  }
+}
+
+TEST_CASE("RawImageBuilder downscales by averaging blocks") {
+  // Each pixel's channels are (x, y, x + y) scaled, so block averages are easy to compute.
+  const uint32_t width = 18;
+  const uint32_t height = 9;
+  std::vector<uint8_t> data(static_cast<size_t>(width) * height * 3);
+  for (size_t y = 0; y < height; ++y) {
+    for (size_t x = 0; x < width; ++x) {
+      uint8_t* pixel = &data[((y * width) + x) * 3];
+      pixel[0] = static_cast<uint8_t>(x * 10);
+      pixel[1] = static_cast<uint8_t>(y * 10);
+      pixel[2] = static_cast<uint8_t>((x + y) * 5);
+    }
+  }
+
+  RawImageBuilder builder;
+  REQUIRE(
+    builder.convert(makeFrame(data, width, height, PixelFormat::Rgb8), 2) == FoxgloveError::Ok
+  );
+  REQUIRE(builder.width() == 9);
+  REQUIRE(builder.height() == 4);
+  // The block at (1, 1) covers x and y in [2, 3].
+  REQUIRE(pixelAt(builder, 1, 1, 0) == 25);
+  REQUIRE(pixelAt(builder, 1, 1, 1) == 25);
+  REQUIRE(pixelAt(builder, 1, 1, 2) == 25);
+
+  REQUIRE(
+    builder.convert(makeFrame(data, width, height, PixelFormat::Bgr8), 4) == FoxgloveError::Ok
+  );
+  REQUIRE(builder.width() == 4);
+  REQUIRE(builder.height() == 2);
+  // The block at (3, 1) covers x in [12, 15] and y in [4, 7]; BGR input swaps the channels.
+  REQUIRE(pixelAt(builder, 3, 1, 0) == 95);
+  REQUIRE(pixelAt(builder, 3, 1, 1) == 55);
+  REQUIRE(pixelAt(builder, 3, 1, 2) == 135);
+}
+
+TEST_CASE("RawImageBuilder rejects invalid frames") {
+  std::vector<uint8_t> data(12);
+  RawImageBuilder builder;
+  REQUIRE(builder.convert(makeFrame(data, 2, 2, PixelFormat::Rgb8)) == FoxgloveError::Ok);
+
+  // Too short for the dimensions.
+  REQUIRE(builder.convert(makeFrame(data, 3, 2, PixelFormat::Rgb8)) == FoxgloveError::ValueError);
+  // Step shorter than a row.
+  REQUIRE(
+    builder.convert(makeFrame(data, 2, 1, PixelFormat::Rgb8, 4)) == FoxgloveError::ValueError
+  );
+  // Odd width for YUYV.
+  REQUIRE(builder.convert(makeFrame(data, 3, 1, PixelFormat::Yuyv)) == FoxgloveError::ValueError);
+  // Unsupported downscale factor.
+  REQUIRE(
+    builder.convert(makeFrame(data, 2, 2, PixelFormat::Rgb8), 3) == FoxgloveError::ValueError
+  );
+  // Downscaled to nothing.
+  REQUIRE(
+    builder.convert(makeFrame(data, 2, 2, PixelFormat::Rgb8), 4) == FoxgloveError::ValueError
+  );
+
+  // The previous image is left unchanged.
+  REQUIRE(builder.width() == 2);
+  REQUIRE(builder.height() == 2);
+}
+
+TEST_CASE("ImagePublisher creates full and preview channels") {
+  FileCleanup cleanup("test_image_" + std::to_string(std::random_device{}()) + ".mcap");
+  auto context = foxglove::Context::create();
+
+  foxglove::ImagePublisherOptions options;
+  options.context = context;
+  options.topic = "/camera";
+  options.preview_downscale = 3;
+  REQUIRE(foxglove::ImagePublisher::create(options).error() == FoxgloveError::ValueError);
+
+  options.preview_downscale = 2;
+  options.frame_id = "camera";
+  auto publisher_result = foxglove::ImagePublisher::create(options);
+  auto& publisher = requireValue(publisher_result);
+  REQUIRE(publisher.id() != publisher.previewId());
+
+  std::vector<uint8_t> data(4 * 4 * 3, 128);
+  // Without sinks, publishing is a no-op, but frames are still validated.
+  REQUIRE(publisher.publish(makeFrame(data, 4, 4, PixelFormat::Bgr8)) == FoxgloveError::Ok);
+  REQUIRE(publisher.publish(makeFrame(data, 5, 4, PixelFormat::Bgr8)) == FoxgloveError::ValueError);
+
+  foxglove::McapWriterOptions mcap_options;
+  mcap_options.context = context;
+  mcap_options.path = cleanup.path();
+  auto writer = foxglove::McapWriter::create(mcap_options);
+  REQUIRE(writer.has_value());
+  REQUIRE(publisher.publish(makeFrame(data, 4, 4, PixelFormat::Bgr8), 1) == FoxgloveError::Ok);
+  REQUIRE(writer->close() == FoxgloveError::Ok);
+}
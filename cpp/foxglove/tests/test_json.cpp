@@ -0,0 +1,177 @@
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/json.hpp>
+#include <foxglove/mcap.hpp>
+#include <foxglove/typed_channel.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+namespace {
+
+enum class Level : uint8_t {
+  Debug,
+  Info,
+  Warn,
+};
+
+struct Reading {
+  double value = 0;
+  std::optional<int> sensor;
+};
+
+struct Report {
+  Level level = Level::Debug;
+  std::string text;
+  int64_t count = 0;
+  std::vector<Reading> readings;
+  std::array<bool, 2> flags{};
+  std::optional<std::string> note;
+};
+
+}  // namespace
+
+template<>
+struct foxglove::JsonEnumValues<Level> {
+  static constexpr std::array<JsonEnumValue<Level>, 2> values = {{
+    {Level::Debug, "debug"},
+    {Level::Info, "info"},
+  }};
+};
+
+template<>
+struct foxglove::JsonFields<Reading> {
+  static constexpr std::string_view name = "Reading";
+  static constexpr auto fields =
+    std::make_tuple(FOXGLOVE_JSON_FIELD(Reading, value), FOXGLOVE_JSON_FIELD(Reading, sensor));
+};
+
+template<>
+struct foxglove::JsonFields<Report> {
+  static constexpr std::string_view name = "Report";
+  static constexpr auto fields = std::make_tuple(
+    FOXGLOVE_JSON_FIELD(Report, level), FOXGLOVE_JSON_FIELD(Report, text),
+    FOXGLOVE_JSON_FIELD(Report, count), FOXGLOVE_JSON_FIELD(Report, readings),
+    FOXGLOVE_JSON_FIELD(Report, flags), FOXGLOVE_JSON_FIELD(Report, note)
+  );
+};
+
+namespace {
+
+nlohmann::json parse(const std::vector<uint8_t>& buf) {
+  return nlohmann::json::parse(buf.begin(), buf.end());
+}
+
+}  // namespace
+
+TEST_CASE("JsonWriter writes structs") {
+  Report report;
+  report.level = Level::Info;
+  report.text = "quote \" backslash \\ newline \n control \x01";
+  report.count = -42;
+  report.readings = {{1.5, 3}, {0.25, std::nullopt}};
+  report.flags = {true, false};
+
+  std::vector<uint8_t> buf = {'x'};
+  foxglove::writeJson(report, buf);
+  // The value is appended to the buffer.
+  REQUIRE(buf[0] == 'x');
+  buf.erase(buf.begin());
+
+  auto json = parse(buf);
+  REQUIRE(json["level"] == "info");
+  REQUIRE(json["text"] == report.text);
+  REQUIRE(json["count"] == -42);
+  REQUIRE(json["readings"].size() == 2);
+  REQUIRE(json["readings"][0]["value"] == 1.5);
+  REQUIRE(json["readings"][0]["sensor"] == 3);
+  // Empty optional fields are omitted.
+  REQUIRE(!json["readings"][1].contains("sensor"));
+  REQUIRE(!json.contains("note"));
+  REQUIRE(json["flags"] == nlohmann::json::array({true, false}));
+
+  // Unlisted enum values are written as null.
+  report.level = Level::Warn;
+  report.note = "note";
+  buf.clear();
+  foxglove::writeJson(report, buf);
+  json = parse(buf);
+  REQUIRE(json["level"].is_null());
+  REQUIRE(json["note"] == "note");
+}
+
+TEST_CASE("JsonWriter writes numbers") {
+  std::vector<uint8_t> buf;
+  foxglove::JsonWriter writer(buf);
+  writer.beginArray();
+  writer.integer(INT64_MIN);
+  writer.integer(UINT64_MAX);
+  writer.number(0.1);
+  writer.number(1e30F);
+  writer.number(std::nan(""));
+  writer.number(-INFINITY);
+  writer.endArray();
+
+  auto json = parse(buf);
+  REQUIRE(json[0] == INT64_MIN);
+  REQUIRE(json[1] == UINT64_MAX);
+  REQUIRE(json[2] == 0.1);
+  REQUIRE(json[3].get<float>() == 1e30F);
+  REQUIRE(json[4].is_null());
+  REQUIRE(json[5].is_null());
+}
+
+TEST_CASE("jsonSchema is generated at compile time") {
+  constexpr std::string_view schema = foxglove::jsonSchema<Report>();
+  static_assert(!schema.empty());
+
+  auto json = nlohmann::json::parse(schema);
+  REQUIRE(json["type"] == "object");
+  REQUIRE(json["properties"]["level"]["enum"] == nlohmann::json::array({"debug", "info"}));
+  REQUIRE(json["properties"]["count"]["type"] == "integer");
+  REQUIRE(json["properties"]["flags"]["items"]["type"] == "boolean");
+  const auto& reading = json["properties"]["readings"]["items"];
+  REQUIRE(reading["properties"]["value"]["type"] == "number");
+  REQUIRE(reading["required"] == nlohmann::json::array({"value"}));
+  REQUIRE(
+    json["required"] == nlohmann::json::array({"level", "text", "count", "readings", "flags"})
+  );
+}
+
+TEST_CASE("JsonMessageTraits logs to a TypedChannel") {
+  FileCleanup cleanup("test_json_" + std::to_string(std::random_device{}()) + ".mcap");
+  auto context = foxglove::Context::create();
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = cleanup.path();
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto schema = foxglove::JsonMessageTraits<Report>::schema();
+  REQUIRE(schema.has_value());
+  REQUIRE(schema->name == "Report");
+  REQUIRE(schema->encoding == "jsonschema");
+
+  using Channel = foxglove::TypedChannel<Report, foxglove::JsonMessageTraits<Report>>;
+  auto channel_result = Channel::create("/report", context);
+  auto& channel = requireValue(channel_result);
+  REQUIRE(channel.raw().messageEncoding() == "json");
+  REQUIRE(channel.log(Report{}) == foxglove::FoxgloveError::Ok);
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+}
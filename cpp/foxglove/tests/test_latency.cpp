@@ -0,0 +1,74 @@
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/latency.hpp>
+#include <foxglove/mcap.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <cstddef>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using Catch::Matchers::ContainsSubstring;
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+TEST_CASE("LatencyTracer records sampled messages delivered by an MCAP writer") {
+  auto suffix = std::to_string(std::random_device{}());
+  FileCleanup mcap("test_latency_" + suffix + ".mcap");
+  FileCleanup trace("test_latency_" + suffix + ".json");
+
+  foxglove::LatencyTracerOptions tracer_options;
+  tracer_options.sample_every = 1;
+  auto tracer_result = foxglove::LatencyTracer::install(tracer_options);
+  auto& tracer = requireValue(tracer_result);
+
+  auto context = foxglove::Context::create();
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = mcap.path();
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto channel_result = foxglove::RawChannel::create("/test", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+  const std::string data = "{}";
+  for (int i = 0; i < 3; ++i) {
+    REQUIRE(
+      channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size()) ==
+      foxglove::FoxgloveError::Ok
+    );
+  }
+
+  auto stats_result = tracer.stats();
+  auto& stats = requireValue(stats_result);
+  size_t stages = 0;
+  for (const auto& entry : stats) {
+    if (entry.channel_id != channel.id()) {
+      continue;
+    }
+    ++stages;
+    REQUIRE(entry.count == 3);
+    REQUIRE(entry.p50 <= entry.max);
+  }
+  REQUIRE(stages == 4);
+
+  REQUIRE(tracer.writeChromeTrace(trace.path()) == foxglove::FoxgloveError::Ok);
+  std::ifstream file(trace.path());
+  std::stringstream contents;
+  contents << file.rdbuf();
+  REQUIRE_THAT(contents.str(), ContainsSubstring("traceEvents"));
+
+  tracer.clear();
+  auto cleared_result = tracer.stats();
+  REQUIRE(requireValue(cleared_result).empty());
+  writer->close();
+}
@@ -1,4 +1,3 @@
-#include <foxglove/arena.hpp>
 #include <foxglove/channel.hpp>
 #include <foxglove/context.hpp>
 #include <foxglove/error.hpp>
@@ -8,10 +7,21 @@
 #include <catch2/matchers/catch_matchers_string.hpp>
 
 #include <array>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <optional>
 #include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "../src/mcap_internal.hpp"
 #include "common/file_cleanup.hpp"
@@ -172,6 +182,42 @@ TEST_CASE_METHOD(McapTestFile, "flush writes data without closing") {
   writer->close();
 }
 
+TEST_CASE_METHOD(McapTestFile, "open chunk is charged to the memory budget") {
+  auto context = foxglove::Context::create();
+  foxglove::MemoryBudget budget;
+  budget.bytes = 1024 * 1024;
+  budget.mcap_share = 0.5;
+  context.setMemoryBudget(budget);
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  foxglove::Schema schema;
+  schema.name = "ExampleSchema";
+  auto channel_result = foxglove::RawChannel::create("example_budget", "json", schema, context);
+  auto& channel = requireValue(channel_result);
+  std::string data = "Hello, budget!";
+  channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size());
+
+  auto usage = context.memoryUsage();
+  REQUIRE(usage.limit == 1024 * 1024);
+  REQUIRE(usage.mcap.limit == 512 * 1024);
+  REQUIRE(usage.mcap.bytes > data.size());
+  REQUIRE(usage.websocket.bytes == 0);
+
+  // Flushing writes the chunk, and releases it.
+  REQUIRE(writer->flush() == foxglove::FoxgloveError::Ok);
+  REQUIRE(context.memoryUsage().mcap.bytes == 0);
+  REQUIRE(context.memoryUsage().mcap.peak_bytes == usage.mcap.bytes);
+
+  context.setMemoryBudget(std::nullopt);
+  REQUIRE_FALSE(context.memoryUsage().limit.has_value());
+  writer->close();
+}
+
 TEST_CASE_METHOD(McapTestFile, "specify profile") {
   auto context = foxglove::Context::create();
 
@@ -299,94 +345,6 @@ TEST_CASE_METHOD(McapTestFile, "Channel can outlive Schema") {
   REQUIRE_THAT(content, ContainsSubstring("FAKESCHEMA"));
 }
 
-namespace foxglove::messages {
-void imageAnnotationsToC(
-  foxglove_image_annotations& dest, const ImageAnnotations& src, Arena& arena
-);
-}  // namespace foxglove::messages
-
-void convertToCAndCheck(const foxglove::messages::ImageAnnotations& msg) {
-  // Convert to C struct and then compare them
-  foxglove::Arena arena;
-  foxglove_image_annotations c_msg;
-  foxglove::messages::imageAnnotationsToC(c_msg, msg, arena);
-
-  // Compare the C struct with the original message
-  REQUIRE(c_msg.circles_count == msg.circles.size());
-  REQUIRE(c_msg.points_count == msg.points.size());
-  REQUIRE(c_msg.texts_count == msg.texts.size());
-
-  // Comapre circle annotation
-  const auto& circle_ts = requireValue(msg.circles[0].timestamp);
-  REQUIRE(c_msg.circles[0].timestamp->sec == circle_ts.sec);
-  REQUIRE(c_msg.circles[0].timestamp->nsec == circle_ts.nsec);
-  const auto& circle_pos = requireValue(msg.circles[0].position);
-  REQUIRE(c_msg.circles[0].position->x == circle_pos.x);
-  REQUIRE(c_msg.circles[0].position->y == circle_pos.y);
-  REQUIRE(c_msg.circles[0].diameter == msg.circles[0].diameter);
-  REQUIRE(c_msg.circles[0].thickness == msg.circles[0].thickness);
-  const auto& circle_fill = requireValue(msg.circles[0].fill_color);
-  REQUIRE(c_msg.circles[0].fill_color->r == circle_fill.r);
-  REQUIRE(c_msg.circles[0].fill_color->g == circle_fill.g);
-  REQUIRE(c_msg.circles[0].fill_color->b == circle_fill.b);
-  REQUIRE(c_msg.circles[0].fill_color->a == circle_fill.a);
-  const auto& circle_outline = requireValue(msg.circles[0].outline_color);
-  REQUIRE(c_msg.circles[0].outline_color->r == circle_outline.r);
-  REQUIRE(c_msg.circles[0].outline_color->g == circle_outline.g);
-  REQUIRE(c_msg.circles[0].outline_color->b == circle_outline.b);
-  REQUIRE(c_msg.circles[0].outline_color->a == circle_outline.a);
-
-  // Compare points annotation
-  const auto& point_ts = requireValue(msg.points[0].timestamp);
-  REQUIRE(c_msg.points[0].timestamp->sec == point_ts.sec);
-  REQUIRE(c_msg.points[0].timestamp->nsec == point_ts.nsec);
-  REQUIRE(static_cast<uint8_t>(c_msg.points[0].type) == static_cast<uint8_t>(msg.points[0].type));
-  REQUIRE(c_msg.points[0].points_count == msg.points[0].points.size());
-  for (size_t i = 0; i < msg.points[0].points.size(); ++i) {
-    REQUIRE(c_msg.points[0].points[i].x == msg.points[0].points[i].x);
-    REQUIRE(c_msg.points[0].points[i].y == msg.points[0].points[i].y);
-  }
-  const auto& point_outline = requireValue(msg.points[0].outline_color);
-  REQUIRE(c_msg.points[0].outline_color->r == point_outline.r);
-  REQUIRE(c_msg.points[0].outline_color->g == point_outline.g);
-  REQUIRE(c_msg.points[0].outline_color->b == point_outline.b);
-  REQUIRE(c_msg.points[0].outline_color->a == point_outline.a);
-  REQUIRE(c_msg.points[0].outline_colors_count == msg.points[0].outline_colors.size());
-  for (size_t i = 0; i < msg.points[0].outline_colors.size(); ++i) {
-    REQUIRE(c_msg.points[0].outline_colors[i].r == msg.points[0].outline_colors[i].r);
-    REQUIRE(c_msg.points[0].outline_colors[i].g == msg.points[0].outline_colors[i].g);
-    REQUIRE(c_msg.points[0].outline_colors[i].b == msg.points[0].outline_colors[i].b);
-    REQUIRE(c_msg.points[0].outline_colors[i].a == msg.points[0].outline_colors[i].a);
-  }
-  const auto& point_fill = requireValue(msg.points[0].fill_color);
-  REQUIRE(c_msg.points[0].fill_color->r == point_fill.r);
-  REQUIRE(c_msg.points[0].fill_color->g == point_fill.g);
-  REQUIRE(c_msg.points[0].fill_color->b == point_fill.b);
-  REQUIRE(c_msg.points[0].fill_color->a == point_fill.a);
-  REQUIRE(c_msg.points[0].thickness == msg.points[0].thickness);
-
-  // Compare text annotation
-  const auto& text_ts = requireValue(msg.texts[0].timestamp);
-  REQUIRE(c_msg.texts[0].timestamp->sec == text_ts.sec);
-  REQUIRE(c_msg.texts[0].timestamp->nsec == text_ts.nsec);
-  const auto& text_pos = requireValue(msg.texts[0].position);
-  REQUIRE(c_msg.texts[0].position->x == text_pos.x);
-  REQUIRE(c_msg.texts[0].position->y == text_pos.y);
-  REQUIRE(c_msg.texts[0].text.data == msg.texts[0].text.data());
-  REQUIRE(c_msg.texts[0].text.len == msg.texts[0].text.size());
-  REQUIRE(c_msg.texts[0].font_size == msg.texts[0].font_size);
-  const auto& text_color = requireValue(msg.texts[0].text_color);
-  REQUIRE(c_msg.texts[0].text_color->r == text_color.r);
-  REQUIRE(c_msg.texts[0].text_color->g == text_color.g);
-  REQUIRE(c_msg.texts[0].text_color->b == text_color.b);
-  REQUIRE(c_msg.texts[0].text_color->a == text_color.a);
-  const auto& bg_color = requireValue(msg.texts[0].background_color);
-  REQUIRE(c_msg.texts[0].background_color->r == bg_color.r);
-  REQUIRE(c_msg.texts[0].background_color->g == bg_color.g);
-  REQUIRE(c_msg.texts[0].background_color->b == bg_color.b);
-  REQUIRE(c_msg.texts[0].background_color->a == bg_color.a);
-}
-
 TEST_CASE_METHOD(McapTestFile, "ImageAnnotations channel") {
   auto context = foxglove::Context::create();
 
@@ -436,8 +394,6 @@ TEST_CASE_METHOD(McapTestFile, "ImageAnnotations channel") {
   text.background_color = foxglove::messages::Color{1.0, 1.0, 1.0, 0.7};
   msg.texts.push_back(text);
 
-  convertToCAndCheck(msg);
-
   channel.log(msg);
 
   writer->close();
@@ -448,6 +404,482 @@ TEST_CASE_METHOD(McapTestFile, "ImageAnnotations channel") {
   std::string content = readFile(path());
   REQUIRE_THAT(content, ContainsSubstring("Sample text"));
   REQUIRE_THAT(content, ContainsSubstring("ImageAnnotations"));
+
+  std::vector<uint8_t> encoded;
+  REQUIRE(msg.encode(encoded) == foxglove::FoxgloveError::Ok);
+  REQUIRE_THAT(content, ContainsSubstring(std::string(encoded.begin(), encoded.end())));
+}
+
+TEST_CASE_METHOD(McapTestFile, "RawImageView is logged with the encoding of RawImage") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::None;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto channel_result = foxglove::messages::RawImageChannel::create("camera", context);
+  auto channel = std::move(requireValue(channel_result));
+
+  // The view borrows caller-owned pixels, and is encoded without copying them into a RawImage.
+  std::array<std::byte, 12> pixels{};
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = static_cast<std::byte>(0xa0 + i);
+  }
+  foxglove::messages::RawImageView view;
+  view.frame_id = "camera";
+  view.width = 2;
+  view.height = 2;
+  view.encoding = "rgb8";
+  view.step = 6;
+  view.data = pixels.data();
+  view.data_len = pixels.size();
+  REQUIRE(channel.log(view) == foxglove::FoxgloveError::Ok);
+
+  writer->close();
+
+  foxglove::messages::RawImage image;
+  image.frame_id = "camera";
+  image.width = 2;
+  image.height = 2;
+  image.encoding = "rgb8";
+  image.step = 6;
+  image.data.assign(pixels.begin(), pixels.end());
+  std::vector<uint8_t> encoded;
+  REQUIRE(image.encode(encoded) == foxglove::FoxgloveError::Ok);
+
+  std::string content = readFile(path());
+  REQUIRE_THAT(content, ContainsSubstring(std::string(encoded.begin(), encoded.end())));
+}
+
+TEST_CASE_METHOD(McapTestFile, "RawChannel logBatch writes every message") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::None;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto channel_result = foxglove::RawChannel::create("batch", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+
+  std::vector<std::string> payloads = {"batch-first", "batch-second", "batch-third"};
+  std::vector<foxglove::LogItem> items;
+  for (const auto& payload : payloads) {
+    items.push_back({reinterpret_cast<const std::byte*>(payload.data()), payload.size(), 1});
+  }
+  REQUIRE(channel.logBatch(items) == foxglove::FoxgloveError::Ok);
+  REQUIRE(channel.logBatch(nullptr, 0) == foxglove::FoxgloveError::Ok);
+
+  foxglove::LogItem invalid{nullptr, 4, std::nullopt};
+  REQUIRE(channel.logBatch(&invalid, 1) == foxglove::FoxgloveError::ValueError);
+
+  writer->close();
+
+  std::string content = readFile(path());
+  for (const auto& payload : payloads) {
+    REQUIRE_THAT(content, ContainsSubstring(payload));
+  }
+}
+
+TEST_CASE_METHOD(McapTestFile, "async writer writes every message on close") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::None;
+  options.async_writes = true;
+  options.async_queue_capacity = 4;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto channel_result = foxglove::RawChannel::create("async", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+
+  std::vector<std::string> payloads;
+  for (int i = 0; i < 32; ++i) {
+    payloads.push_back("async-message-" + std::to_string(i));
+    const auto& payload = payloads.back();
+    REQUIRE(
+      channel.log(reinterpret_cast<const std::byte*>(payload.data()), payload.size()) ==
+      foxglove::FoxgloveError::Ok
+    );
+  }
+
+  REQUIRE(writer->flush() == foxglove::FoxgloveError::Ok);
+  auto stats = writer->stats();
+  REQUIRE(stats.has_value());
+  CHECK(stats->queue_depth == 0);
+  CHECK(stats->dropped_messages == 0);
+
+  writer->close();
+  CHECK(writer->stats().error() == foxglove::FoxgloveError::ValueError);
+
+  std::string content = readFile(path());
+  for (const auto& payload : payloads) {
+    REQUIRE_THAT(content, ContainsSubstring(payload));
+  }
+}
+
+TEST_CASE_METHOD(McapTestFile, "pipelined writer writes every chunk") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::Lz4;
+  options.chunk_size = 1024;
+  options.pipeline_depth = 2;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto channel_result = foxglove::RawChannel::create("pipelined", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+
+  std::string payload(600, 'x');
+  for (int i = 0; i < 100; ++i) {
+    REQUIRE(
+      channel.log(reinterpret_cast<const std::byte*>(payload.data()), payload.size()) ==
+      foxglove::FoxgloveError::Ok
+    );
+  }
+  REQUIRE(writer->flush() == foxglove::FoxgloveError::Ok);
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+
+  std::string content = readFile(path());
+  REQUIRE_THAT(content, ContainsSubstring("pipelined"));
+}
+
+TEST_CASE("rotating writer starts a new segment when the size limit is reached") {
+  const std::string prefix = "test_mcap_rotation_" + std::to_string(std::random_device{}());
+  std::vector<std::unique_ptr<FileCleanup>> segments;
+  for (int i = 0; i < 4; ++i) {
+    segments.push_back(std::make_unique<FileCleanup>(prefix + "_" + std::to_string(i) + ".mcap"));
+  }
+  const std::string templ = prefix + "_{index}.mcap";
+
+  auto context = foxglove::Context::create();
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = templ;
+  options.compression = foxglove::McapCompression::None;
+  // Every write exceeds the limit, so each message ends up in its own segment.
+  options.rotation_max_bytes = 1;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto channel_result = foxglove::RawChannel::create("rotation", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+  for (int i = 0; i < 3; ++i) {
+    std::string payload = "segment-message-" + std::to_string(i);
+    REQUIRE(
+      channel.log(reinterpret_cast<const std::byte*>(payload.data()), payload.size()) ==
+      foxglove::FoxgloveError::Ok
+    );
+  }
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+
+  for (int i = 0; i < 3; ++i) {
+    std::string content = readFile(segments[i]->path());
+    REQUIRE_THAT(content, ContainsSubstring("rotation"));
+    REQUIRE_THAT(content, ContainsSubstring("segment-message-" + std::to_string(i)));
+  }
+  // The segment opened by the last rotation still declares the channel.
+  REQUIRE_THAT(readFile(segments[3]->path()), ContainsSubstring("rotation"));
+}
+
+TEST_CASE_METHOD(McapTestFile, "rotating writer requires an index placeholder") {
+  foxglove::McapWriterOptions options;
+  options.path = path();
+  options.rotation_max_duration = std::chrono::milliseconds(1000);
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(!writer.has_value());
+  REQUIRE(writer.error() == foxglove::FoxgloveError::ValueError);
+}
+
+TEST_CASE_METHOD(McapTestFile, "direct I/O requires disable_seeking") {
+  foxglove::McapWriterOptions options;
+  options.path = path();
+  options.direct_io = true;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(!writer.has_value());
+  REQUIRE(writer.error() == foxglove::FoxgloveError::ValueError);
+}
+
+#ifdef __linux__
+TEST_CASE_METHOD(McapTestFile, "preallocated file is truncated to its length on close") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.preallocate_bytes = static_cast<uint64_t>(16) * 1024 * 1024;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  foxglove::Schema schema;
+  schema.name = "ExampleSchema";
+  auto channel_result = foxglove::RawChannel::create("example_prealloc", "json", schema, context);
+  auto& channel = requireValue(channel_result);
+  std::string data = "Hello, preallocated!";
+  channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size());
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+
+  std::string content = readFile(path());
+  REQUIRE(std::filesystem::file_size(path()) == content.size());
+  REQUIRE_THAT(content, ContainsSubstring("Hello, preallocated!"));
+  REQUIRE(content.substr(content.size() - 8) == std::string("\x89MCAP0\r\n", 8));
+}
+#endif
+
+TEST_CASE_METHOD(McapTestFile, "preallocation is not supported with direct I/O") {
+  foxglove::McapWriterOptions options;
+  options.path = path();
+  options.direct_io = true;
+  options.disable_seeking = true;
+  options.preallocate_bytes = 1024 * 1024;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(!writer.has_value());
+  REQUIRE(writer.error() == foxglove::FoxgloveError::ValueError);
+}
+
+TEST_CASE_METHOD(McapTestFile, "recover a recording which was not closed") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.checkpoint_interval = std::chrono::milliseconds(1);
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  foxglove::Schema schema;
+  schema.name = "ExampleSchema";
+  auto channel_result = foxglove::RawChannel::create("example_recover", "json", schema, context);
+  auto& channel = requireValue(channel_result);
+  std::string data = "Hello, checkpoint!";
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size());
+
+  // Capture the file and its journal as they would be left by a crash.
+  FileCleanup recovered(path() + ".recovered");
+  FileCleanup journal(recovered.path() + ".checkpoint");
+  std::filesystem::copy_file(path(), recovered.path());
+  std::filesystem::copy_file(path() + ".checkpoint", journal.path());
+  writer->close();
+  REQUIRE(!std::filesystem::exists(path() + ".checkpoint"));
+
+  REQUIRE(foxglove::recoverMcap(recovered.path()) == foxglove::FoxgloveError::Ok);
+  REQUIRE(!std::filesystem::exists(journal.path()));
+  std::string content = readFile(recovered.path());
+  REQUIRE_THAT(content, ContainsSubstring("example_recover"));
+  REQUIRE_THAT(content, ContainsSubstring("Hello, checkpoint!"));
+  REQUIRE(content.substr(content.size() - 8) == std::string("\x89MCAP0\r\n", 8));
+}
+
+TEST_CASE_METHOD(McapTestFile, "recover rejects a file which is not an MCAP") {
+  std::ofstream(path()) << "not an mcap file";
+  REQUIRE(foxglove::recoverMcap(path()) != foxglove::FoxgloveError::Ok);
+}
+
+TEST_CASE_METHOD(McapTestFile, "compression policy leaves selected channels uncompressed") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::Zstd;
+  options.compression_policy = [](const foxglove::ChannelDescriptor& channel) {
+    std::optional<foxglove::McapChunkCompression> compression;
+    if (channel.topic() == "video") {
+      compression = foxglove::McapChunkCompression{foxglove::McapCompression::None, 0};
+    }
+    return compression;
+  };
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  foxglove::Schema schema;
+  schema.name = "ExampleSchema";
+  auto video_result = foxglove::RawChannel::create("video", "json", schema, context);
+  auto& video = requireValue(video_result);
+  auto json_result = foxglove::RawChannel::create("json", "json", schema, context);
+  auto& json = requireValue(json_result);
+  std::string video_data(1000, 'v');
+  std::string json_data(1000, 'j');
+  video.log(reinterpret_cast<const std::byte*>(video_data.data()), video_data.size());
+  json.log(reinterpret_cast<const std::byte*>(json_data.data()), json_data.size());
+  writer->close();
+
+  std::string content = readFile(path());
+  REQUIRE_THAT(content, ContainsSubstring(video_data));
+  REQUIRE_THAT(content, !ContainsSubstring(json_data));
+}
+
+TEST_CASE_METHOD(McapTestFile, "channel group is chosen once per channel") {
+  auto context = foxglove::Context::create();
+
+  std::vector<std::string> grouped;
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::None;
+  options.channel_group = [&grouped](const foxglove::ChannelDescriptor& channel) {
+    grouped.emplace_back(channel.topic());
+    return channel.topic().rfind("camera/", 0) == 0 ? 1U : 0U;
+  };
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  foxglove::Schema schema;
+  schema.name = "ExampleSchema";
+  auto camera_result = foxglove::RawChannel::create("camera/front", "json", schema, context);
+  auto& camera = requireValue(camera_result);
+  auto imu_result = foxglove::RawChannel::create("imu", "json", schema, context);
+  auto& imu = requireValue(imu_result);
+  std::string camera_data(100, 'c');
+  std::string imu_data(100, 'i');
+  for (int i = 0; i < 3; ++i) {
+    camera.log(reinterpret_cast<const std::byte*>(camera_data.data()), camera_data.size());
+    imu.log(reinterpret_cast<const std::byte*>(imu_data.data()), imu_data.size());
+  }
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+
+  REQUIRE(grouped == std::vector<std::string>{"camera/front", "imu"});
+  std::string content = readFile(path());
+  REQUIRE_THAT(content, ContainsSubstring(camera_data));
+  REQUIRE_THAT(content, ContainsSubstring(imu_data));
+}
+
+TEST_CASE_METHOD(McapTestFile, "zstd dictionary is trained and attached") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::None;
+  options.chunk_size = 512;
+  options.zstd_dictionary_training_messages = 500;
+  options.zstd_dictionary_max_size = 4096;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  foxglove::Schema schema;
+  schema.name = "ExampleSchema";
+  auto channel_result = foxglove::RawChannel::create("/log", "json", schema, context);
+  auto& channel = requireValue(channel_result);
+  for (int i = 0; i < 1000; ++i) {
+    std::string msg = R"({"level":"info","node":"planner","msg":"cycle )" + std::to_string(i) +
+                      R"( done","count":)" + std::to_string(i % 17) + "}";
+    channel.log(reinterpret_cast<const std::byte*>(msg.data()), msg.size());
+  }
+  writer->close();
+
+  std::string content = readFile(path());
+  REQUIRE_THAT(content, ContainsSubstring("application/vnd.foxglove.zstd-dictionary"));
+  // Messages logged after training are in dictionary-compressed chunks.
+  REQUIRE_THAT(content, ContainsSubstring(R"("msg":"cycle 0 done")"));
+  REQUIRE_THAT(content, !ContainsSubstring(R"("msg":"cycle 999 done")"));
+}
+
+TEST_CASE_METHOD(McapTestFile, "RawChannel logShared writes the message and releases its owner") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::None;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto channel_result = foxglove::RawChannel::create("shared", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+
+  auto payload = std::make_shared<const std::string>("shared-payload");
+  REQUIRE(
+    channel.logShared(
+      payload, reinterpret_cast<const std::byte*>(payload->data()), payload->size(), 1
+    ) == foxglove::FoxgloveError::Ok
+  );
+  // The MCAP writer copies the message, so the owner is released before logShared returns.
+  REQUIRE(payload.use_count() == 1);
+
+  // On error, the owner is not retained.
+  REQUIRE(channel.logShared(payload, nullptr, 4) == foxglove::FoxgloveError::ValueError);
+  REQUIRE(payload.use_count() == 1);
+
+  writer->close();
+
+  std::string content = readFile(path());
+  REQUIRE_THAT(content, ContainsSubstring("shared-payload"));
+}
+
+TEST_CASE_METHOD(McapTestFile, "typed channel logBatch writes every message") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::None;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto channel_result = foxglove::messages::LogChannel::create("/log", context);
+  auto& channel = requireValue(channel_result);
+
+  std::vector<foxglove::messages::Log> msgs(3);
+  msgs[0].message = "typed-batch-first";
+  // Long enough to exceed the initial per-message buffer reservation.
+  msgs[1].message = std::string(1024, 'x') + "typed-batch-second";
+  msgs[2].message = "typed-batch-third";
+  const std::array<uint64_t, 3> log_times = {10, 20, 30};
+  REQUIRE(
+    channel.logBatch(msgs.data(), msgs.size(), log_times.data()) == foxglove::FoxgloveError::Ok
+  );
+
+  writer->close();
+
+  std::string content = readFile(path());
+  REQUIRE_THAT(content, ContainsSubstring("typed-batch-first"));
+  REQUIRE_THAT(content, ContainsSubstring("typed-batch-second"));
+  REQUIRE_THAT(content, ContainsSubstring("typed-batch-third"));
+}
+
+TEST_CASE_METHOD(McapTestFile, "latched channels deliver their last messages to a new writer") {
+  auto context = foxglove::Context::create();
+
+  // Messages are logged before any sink exists.
+  auto raw_result =
+    foxglove::RawChannel::create("/map", "json", std::nullopt, context, std::nullopt, 1);
+  auto& raw = requireValue(raw_result);
+  for (std::string_view payload : {"latched-stale", "latched-latest"}) {
+    const auto* data = reinterpret_cast<const std::byte*>(payload.data());
+    REQUIRE(raw.log(data, payload.size()) == foxglove::FoxgloveError::Ok);
+  }
+
+  auto typed_result = foxglove::messages::LogChannel::create("/log", context, 2);
+  auto& typed = requireValue(typed_result);
+  foxglove::messages::Log msg;
+  msg.message = "latched-typed";
+  REQUIRE(typed.log(msg) == foxglove::FoxgloveError::Ok);
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  options.compression = foxglove::McapCompression::None;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+  writer->close();
+
+  std::string content = readFile(path());
+  REQUIRE_THAT(content, !ContainsSubstring("latched-stale"));
+  REQUIRE_THAT(content, ContainsSubstring("latched-latest"));
+  REQUIRE_THAT(content, ContainsSubstring("latched-typed"));
 }
 
 TEST_CASE("MCAP Channel filtering") {
@@ -483,8 +915,27 @@ TEST_CASE("MCAP Channel filtering") {
       REQUIRE(requireValue(metadata).size() == 2);
       REQUIRE(requireValue(metadata).at("key1") == "value1");
       REQUIRE(requireValue(metadata).at("key2") == "value2");
+
+      auto schema_view = channel.schemaView();
+      REQUIRE(requireValue(schema_view).name == "Topic2Schema");
+      REQUIRE(requireValue(schema_view).encoding == "fake-encoding");
+      REQUIRE(requireValue(schema_view).data_len == 10);
+      REQUIRE(channel.metadataValue("key2") == "value2");
+      REQUIRE_FALSE(channel.metadataValue("key3").has_value());
+      std::vector<std::pair<std::string_view, std::string_view>> entries;
+      for (const auto& [key, value] : channel.metadataView()) {
+        entries.emplace_back(key, value);
+      }
+      REQUIRE(entries.size() == 2);
+      REQUIRE(entries[0] == std::make_pair(std::string_view("key1"), std::string_view("value1")));
+      REQUIRE(entries[1] == std::make_pair(std::string_view("key2"), std::string_view("value2")));
       return true;
     }
+    if (channel.topic() == "/1") {
+      REQUIRE_FALSE(channel.schemaView().has_value());
+      REQUIRE(channel.metadataView().empty());
+      REQUIRE_FALSE(channel.metadataValue("key1").has_value());
+    }
     return false;
   };
   auto writer_res_2 = foxglove::McapWriter::create(opts_2);
@@ -526,6 +977,111 @@ TEST_CASE("MCAP Channel filtering") {
   REQUIRE_THAT(content, ContainsSubstring("Topic 2 msg"));
 }
 
+TEST_CASE("MCAP channel filtering with a TopicFilter") {
+  foxglove::TopicFilterOptions filter_options;
+  filter_options.include_globs = {"/camera/**"};
+  filter_options.exclude_regexes = {"compressed$"};
+  auto filter_result = foxglove::TopicFilter::create(filter_options);
+  auto& filter = requireValue(filter_result);
+  REQUIRE(filter.matches("/camera/front/image"));
+  REQUIRE_FALSE(filter.matches("/camera/front/compressed"));
+  REQUIRE_FALSE(filter.matches("/lidar"));
+
+  FileCleanup file("test_topic_filter_" + std::to_string(std::random_device{}()) + ".mcap");
+  auto context = foxglove::Context::create();
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.compression = foxglove::McapCompression::None;
+  options.path = file.path();
+  options.sink_channel_filter = filter;
+  auto writer_result = foxglove::McapWriter::create(options);
+  auto writer = std::move(requireValue(writer_result));
+
+  for (const char* topic : {"/camera/front/image", "/camera/front/compressed", "/lidar"}) {
+    auto result = foxglove::RawChannel::create(topic, "json", std::nullopt, context);
+    auto channel = std::move(requireValue(result));
+    std::string data = std::string("msg on ") + topic;
+    channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size());
+  }
+  writer.close();
+
+  std::string content = readFile(file.path());
+  REQUIRE_THAT(content, ContainsSubstring("msg on /camera/front/image"));
+  REQUIRE_THAT(content, !ContainsSubstring("msg on /camera/front/compressed"));
+  REQUIRE_THAT(content, !ContainsSubstring("msg on /lidar"));
+}
+
+TEST_CASE("MCAP message filter drops and replaces messages for one writer") {
+  FileCleanup full_file("test_message_filter_" + std::to_string(std::random_device{}()) + ".mcap");
+  FileCleanup filtered_file(
+    "test_message_filter_" + std::to_string(std::random_device{}()) + ".mcap"
+  );
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions full_options;
+  full_options.context = context;
+  full_options.compression = foxglove::McapCompression::None;
+  full_options.path = full_file.path();
+  auto full_writer_result = foxglove::McapWriter::create(full_options);
+  auto full_writer = std::move(requireValue(full_writer_result));
+
+  foxglove::McapWriterOptions filtered_options = full_options;
+  filtered_options.path = filtered_file.path();
+  std::vector<uint64_t> log_times;
+  filtered_options.message_filter = [&log_times](
+                                      const foxglove::ChannelDescriptor& channel,
+                                      const std::byte* data, size_t data_len, uint64_t log_time,
+                                      foxglove::MessageFilterOutput& output
+                                    ) {
+    REQUIRE(channel.topic() == "/filtered");
+    log_times.push_back(log_time);
+    std::string_view msg(reinterpret_cast<const char*>(data), data_len);
+    if (msg == "msg to drop") {
+      return false;
+    }
+    if (msg == "msg to crop") {
+      constexpr std::string_view cropped = "cropped msg";
+      REQUIRE(
+        output.replace(reinterpret_cast<const std::byte*>(cropped.data()), cropped.size()) ==
+        foxglove::FoxgloveError::Ok
+      );
+    }
+    return true;
+  };
+  auto filtered_writer_result = foxglove::McapWriter::create(filtered_options);
+  auto filtered_writer = std::move(requireValue(filtered_writer_result));
+
+  auto result = foxglove::RawChannel::create("/filtered", "json", std::nullopt, context);
+  auto channel = std::move(requireValue(result));
+  uint64_t log_time = 1;
+  for (std::string_view data : {"msg to keep", "msg to drop", "msg to crop"}) {
+    channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size(), log_time++);
+  }
+  full_writer.close();
+  filtered_writer.close();
+
+  REQUIRE(log_times == std::vector<uint64_t>{1, 2, 3});
+
+  std::string full = readFile(full_file.path());
+  REQUIRE_THAT(full, ContainsSubstring("msg to keep"));
+  REQUIRE_THAT(full, ContainsSubstring("msg to drop"));
+  REQUIRE_THAT(full, ContainsSubstring("msg to crop"));
+
+  std::string filtered = readFile(filtered_file.path());
+  REQUIRE_THAT(filtered, ContainsSubstring("msg to keep"));
+  REQUIRE_THAT(filtered, !ContainsSubstring("msg to drop"));
+  REQUIRE_THAT(filtered, !ContainsSubstring("msg to crop"));
+  REQUIRE_THAT(filtered, ContainsSubstring("cropped msg"));
+}
+
+TEST_CASE("TopicFilter rejects an invalid regex") {
+  foxglove::TopicFilterOptions filter_options;
+  filter_options.include_regexes = {"("};
+  auto filter_result = foxglove::TopicFilter::create(filter_options);
+  REQUIRE_FALSE(filter_result.has_value());
+  REQUIRE(filter_result.error() == foxglove::FoxgloveError::ValueError);
+}
+
 TEST_CASE_METHOD(McapTestFile, "Write metadata records to MCAP") {
   auto context = foxglove::Context::create();
 
@@ -654,6 +1210,88 @@ TEST_CASE("Custom writer basic functionality") {
   REQUIRE_THAT(custom_content, ContainsSubstring("Point2"));
 }
 
+TEST_CASE("Custom writer takes ownership of output buffers") {
+  auto context = foxglove::Context::create();
+
+  uint64_t position = 0;
+  std::vector<foxglove::McapBuffer> buffers;
+  foxglove::CustomWriter custom_writer;
+  custom_writer.write_owned = [&buffers, &position](foxglove::McapBuffer buffer) -> int {
+    position += buffer.size();
+    buffers.push_back(std::move(buffer));
+    return 0;
+  };
+  custom_writer.flush = []() -> int {
+    return 0;
+  };
+  custom_writer.seek = foxglove::noSeekFn(&position);
+
+  foxglove::McapWriterOptions options;
+  options.custom_writer = custom_writer;
+  options.context = context;
+  options.disable_seeking = true;
+
+  auto custom_mcap = foxglove::McapWriter::create(options);
+  REQUIRE(custom_mcap.has_value());
+
+  auto channel_result = foxglove::messages::Point2Channel::create("test_topic", context);
+  auto channel = std::move(requireValue(channel_result));
+  channel.log(foxglove::messages::Point2{1.0, 2.0});
+  channel.close();
+  requireValue(custom_mcap).close();
+
+  REQUIRE(!buffers.empty());
+  std::string content;
+  for (const auto& buffer : buffers) {
+    content.append(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+  }
+  REQUIRE(content.size() == position);
+  REQUIRE_THAT(content, ContainsSubstring("Point2"));
+}
+
+TEST_CASE("Custom writer with vectored writes") {
+  auto context = foxglove::Context::create();
+
+  uint64_t position = 0;
+  std::string content;
+  foxglove::CustomWriter custom_writer;
+  custom_writer.writev =
+    [&content, &position](const foxglove_bytes* iov, size_t iovcnt, int* error) -> size_t {
+    *error = 0;
+    size_t written = 0;
+    for (size_t i = 0; i < iovcnt; ++i) {
+      content.append(reinterpret_cast<const char*>(iov[i].data), iov[i].len);
+      written += iov[i].len;
+    }
+    position += written;
+    return written;
+  };
+  custom_writer.flush = []() -> int {
+    return 0;
+  };
+  custom_writer.seek = foxglove::noSeekFn(&position);
+
+  foxglove::McapWriterOptions options;
+  options.custom_writer = custom_writer;
+  options.context = context;
+  options.disable_seeking = true;
+  options.compression = foxglove::McapCompression::None;
+
+  auto custom_mcap = foxglove::McapWriter::create(options);
+  REQUIRE(custom_mcap.has_value());
+
+  auto channel_result = foxglove::messages::LogChannel::create("/log", context);
+  auto channel = std::move(requireValue(channel_result));
+  foxglove::messages::Log msg;
+  msg.message = std::string(64 * 1024, 'x') + "vectored-message";
+  channel.log(msg);
+  channel.close();
+  requireValue(custom_mcap).close();
+
+  REQUIRE(content.size() == position);
+  REQUIRE_THAT(content, ContainsSubstring("vectored-message"));
+}
+
 TEST_CASE_METHOD(McapTestFile, "Write single attachment to MCAP") {
   auto context = foxglove::Context::create();
 
@@ -687,6 +1325,41 @@ TEST_CASE_METHOD(McapTestFile, "Write single attachment to MCAP") {
   REQUIRE_THAT(content, ContainsSubstring(R"({"setting": true})"));
 }
 
+TEST_CASE_METHOD(McapTestFile, "Write attachment streamed from an istream") {
+  auto context = foxglove::Context::create();
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path();
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  // Larger than the blocks in which attachment data is copied.
+  std::string attachment_data;
+  for (int i = 0; i < 20000; ++i) {
+    attachment_data += "tile " + std::to_string(i) + ";";
+  }
+  std::istringstream stream(attachment_data);
+  foxglove::Attachment attachment;
+  attachment.name = "tiles.txt";
+  attachment.media_type = "text/plain";
+  attachment.data_len = attachment_data.size();
+  REQUIRE(writer->attach(attachment, stream) == foxglove::FoxgloveError::Ok);
+
+  // A stream which ends early is an error, but leaves the file valid.
+  std::istringstream short_stream("short");
+  attachment.name = "short.txt";
+  attachment.data_len = 100;
+  REQUIRE(writer->attach(attachment, short_stream) != foxglove::FoxgloveError::Ok);
+
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+
+  std::string content = readFile(path());
+  REQUIRE_THAT(content, ContainsSubstring("tiles.txt"));
+  REQUIRE_THAT(content, ContainsSubstring(attachment_data));
+  REQUIRE_THAT(content, ContainsSubstring("short.txt"));
+}
+
 TEST_CASE_METHOD(McapTestFile, "Write multiple attachments to MCAP") {
   auto context = foxglove::Context::create();
 
@@ -787,4 +1460,20 @@ TEST_CASE("McapWriterOptions defaults match C defaults") {
   CHECK(converted.compression_level == c.compression_level);
   CHECK(converted.compression_threads == c.compression_threads);
   CHECK(converted.truncate == c.truncate);
+  CHECK(converted.async_writes == c.async_writes);
+  CHECK(converted.async_queue_capacity == c.async_queue_capacity);
+  CHECK(converted.async_overflow_policy == c.async_overflow_policy);
+  CHECK(converted.pipeline_depth == c.pipeline_depth);
+  CHECK(converted.rotation_max_bytes == c.rotation_max_bytes);
+  CHECK(converted.rotation_max_duration_ms == c.rotation_max_duration_ms);
+  CHECK(converted.direct_io == c.direct_io);
+  CHECK(converted.checkpoint_interval_ms == c.checkpoint_interval_ms);
+  CHECK(converted.compression_policy == c.compression_policy);
+  CHECK(converted.channel_group == c.channel_group);
+  CHECK(converted.zstd_dictionary_training_messages == c.zstd_dictionary_training_messages);
+  CHECK(converted.zstd_dictionary_max_size == c.zstd_dictionary_max_size);
+  CHECK(converted.zstd_dictionary_level == c.zstd_dictionary_level);
+  CHECK(converted.preallocate_bytes == c.preallocate_bytes);
+  CHECK(converted.sparse_index_every_messages == c.sparse_index_every_messages);
+  CHECK(converted.sparse_index_every_ns == c.sparse_index_every_ns);
 }
@@ -0,0 +1,183 @@
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap.hpp>
+#include <foxglove/mcap_player.hpp>
+#include <foxglove/mcap_reader.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <future>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/time_tracker.hpp"
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+  return "test_mcap_player_" + name + "_" + std::to_string(std::random_device{}()) + ".mcap";
+}
+
+/// Writes 100 messages on topic "/a", logged at 0..99 ns, with each message's log time as its
+/// payload.
+void writeRecording(const std::string& path) {
+  auto context = foxglove::Context::create();
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = path;
+  options.chunk_size = 256;
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+  auto channel_result = foxglove::RawChannel::create("/a", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+  for (uint64_t log_time = 0; log_time < 100; ++log_time) {
+    std::string data = std::to_string(log_time);
+    channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size(), log_time);
+  }
+  writer->close();
+}
+
+/// Plays back the recording at `input` from `start_time` until it ends, recording the messages
+/// played back to `output`, and returns their log times.
+std::vector<uint64_t> playBack(
+  const std::string& input, const std::string& output, uint64_t start_time
+) {
+  auto context = foxglove::Context::create();
+  foxglove::McapWriterOptions writer_options;
+  writer_options.context = context;
+  writer_options.path = output;
+  auto writer = foxglove::McapWriter::create(writer_options);
+  REQUIRE(writer.has_value());
+
+  std::promise<foxglove::PlaybackState> ended;
+  foxglove::McapPlayerOptions options;
+  options.context = context;
+  options.read_ahead_messages = 8;
+  options.on_playback_state = [&ended](const foxglove::PlaybackState& state) {
+    ended.set_value(state);
+  };
+  auto player_result = foxglove::McapPlayer::create(input, std::move(options));
+  auto& player = requireValue(player_result);
+  REQUIRE(player.timeRange() == std::make_pair(uint64_t{0}, uint64_t{99}));
+  REQUIRE(player.status() == foxglove::PlaybackStatus::Paused);
+
+  foxglove::PlaybackControlRequest request{
+    foxglove::PlaybackCommand::Play, 2.0F, start_time, "request-1"
+  };
+  auto state = player.handlePlaybackControlRequest(request);
+  REQUIRE(state.status == foxglove::PlaybackStatus::Playing);
+  REQUIRE(state.current_time == start_time);
+  REQUIRE(state.playback_speed == 2.0F);
+  REQUIRE(state.did_seek);
+  REQUIRE(state.request_id == "request-1");
+
+  auto future = ended.get_future();
+  REQUIRE(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+  auto end_state = future.get();
+  REQUIRE(end_state.status == foxglove::PlaybackStatus::Ended);
+  REQUIRE(end_state.current_time == 99);
+  REQUIRE(player.status() == foxglove::PlaybackStatus::Ended);
+  REQUIRE(player.droppedMessages() == 0);
+  writer->close();
+
+  auto reader_result = foxglove::McapReader::open(output);
+  auto& reader = requireValue(reader_result);
+  auto iter_result = reader.messages();
+  auto& iter = requireValue(iter_result);
+  std::vector<uint64_t> log_times;
+  while (true) {
+    auto next = iter.next();
+    REQUIRE(next.has_value());
+    if (!next->has_value()) {
+      break;
+    }
+    const auto& message = **next;
+    REQUIRE(message.channel->topic == "/a");
+    std::string data(reinterpret_cast<const char*>(message.data), message.data_len);
+    REQUIRE(data == std::to_string(message.log_time));
+    log_times.push_back(message.log_time);
+  }
+  return log_times;
+}
+
+}  // namespace
+
+TEST_CASE("McapPlayer plays back every message in order") {
+  FileCleanup input(tempPath("input"));
+  FileCleanup output(tempPath("output"));
+  writeRecording(input.path());
+
+  std::vector<uint64_t> expected;
+  for (uint64_t log_time = 0; log_time < 100; ++log_time) {
+    expected.push_back(log_time);
+  }
+  REQUIRE(playBack(input.path(), output.path(), 0) == expected);
+}
+
+TEST_CASE("McapPlayer plays back from the seek position") {
+  FileCleanup input(tempPath("input"));
+  FileCleanup output(tempPath("output"));
+  writeRecording(input.path());
+
+  std::vector<uint64_t> expected;
+  for (uint64_t log_time = 50; log_time < 100; ++log_time) {
+    expected.push_back(log_time);
+  }
+  REQUIRE(playBack(input.path(), output.path(), 50) == expected);
+}
+
+TEST_CASE("McapPlayer clamps seek times and playback speed") {
+  FileCleanup input(tempPath("input"));
+  writeRecording(input.path());
+
+  auto player_result = foxglove::McapPlayer::create(input.path());
+  auto& player = requireValue(player_result);
+  player.seek(1000);
+  REQUIRE(player.currentTime() == 99);
+  player.seek(0);
+  REQUIRE(player.currentTime() == 0);
+  player.setPlaybackSpeed(0.0F);
+  REQUIRE(player.playbackSpeed() > 0.0F);
+  player.pause();
+  REQUIRE(player.status() == foxglove::PlaybackStatus::Paused);
+}
+
+TEST_CASE("McapPlayer fails to open a file which is not an MCAP") {
+  REQUIRE(!foxglove::McapPlayer::create("missing.mcap").has_value());
+}
+
+TEST_CASE("TimeTracker computes deadlines from its anchor") {
+  using foxglove::TimeTracker;
+  using std::chrono::milliseconds;
+  auto start = TimeTracker::Clock::now();
+  TimeTracker tracker(1'000'000, 2.0F, start);
+
+  // At double speed, 10 ms of log time is due after 5 ms.
+  REQUIRE(tracker.deadlineFor(11'000'000) == start + milliseconds(5));
+  REQUIRE(tracker.deadlineFor(0) == start);
+  REQUIRE(tracker.currentLogTime(start + milliseconds(5)) == 11'000'000);
+
+  // Deadlines do not depend on when they are computed, so late wakeups do not accumulate.
+  auto late = start + milliseconds(7);
+  REQUIRE(tracker.latenessOf(11'000'000, late) == milliseconds(2));
+  REQUIRE(tracker.latenessOf(21'000'000, late) == milliseconds(0));
+
+  // Pausing holds the log time, and resuming continues from it.
+  tracker.pause(start + milliseconds(5));
+  REQUIRE(tracker.currentLogTime(start + milliseconds(100)) == 11'000'000);
+  REQUIRE(tracker.deadlineFor(12'000'000) == TimeTracker::Clock::time_point::max());
+  tracker.resume(start + milliseconds(100));
+  REQUIRE(tracker.deadlineFor(21'000'000) == start + milliseconds(105));
+
+  // Changing speed re-anchors at the current log time.
+  tracker.setSpeed(1.0F, start + milliseconds(105));
+  REQUIRE(tracker.deadlineFor(31'000'000) == start + milliseconds(115));
+}
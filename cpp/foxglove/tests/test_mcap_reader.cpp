@@ -0,0 +1,213 @@
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap.hpp>
+#include <foxglove/mcap_reader.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+namespace {
+
+struct McapReaderTestFile {
+  McapReaderTestFile()
+      : cleanup_("test_mcap_reader_" + std::to_string(std::random_device{}()) + ".mcap") {}
+  [[nodiscard]] const std::string& path() const {
+    return cleanup_.path();
+  }
+
+  /// Writes 100 messages alternating between topics "/a" and "/b", with each message's log time
+  /// as its payload.
+  void writeRecording(foxglove::McapCompression compression) const {
+    auto context = foxglove::Context::create();
+    foxglove::McapWriterOptions options;
+    options.context = context;
+    options.path = path();
+    options.compression = compression;
+    options.chunk_size = 256;
+    auto writer = foxglove::McapWriter::create(options);
+    REQUIRE(writer.has_value());
+
+    foxglove::Schema schema;
+    schema.name = "ExampleSchema";
+    schema.encoding = "jsonschema";
+    auto a_result = foxglove::RawChannel::create("/a", "json", schema, context);
+    auto& a = requireValue(a_result);
+    auto b_result = foxglove::RawChannel::create("/b", "json", std::nullopt, context);
+    auto& b = requireValue(b_result);
+    for (uint64_t log_time = 0; log_time < 100; ++log_time) {
+      std::string data = std::to_string(log_time);
+      auto& channel = log_time % 2 == 0 ? a : b;
+      channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size(), log_time);
+    }
+    writer->close();
+  }
+
+private:
+  FileCleanup cleanup_;
+};
+
+std::vector<uint64_t> readLogTimes(
+  const foxglove::McapReader& reader, const foxglove::McapReadOptions& options
+) {
+  auto iter_result = reader.messages(options);
+  auto& iter = requireValue(iter_result);
+  std::vector<uint64_t> log_times;
+  while (true) {
+    auto next = iter.next();
+    REQUIRE(next.has_value());
+    if (!next->has_value()) {
+      break;
+    }
+    const auto& message = **next;
+    REQUIRE(message.channel != nullptr);
+    std::string data(reinterpret_cast<const char*>(message.data), message.data_len);
+    REQUIRE(data == std::to_string(message.log_time));
+    log_times.push_back(message.log_time);
+  }
+  return log_times;
+}
+
+}  // namespace
+
+TEST_CASE_METHOD(McapReaderTestFile, "McapReader reads channels and messages") {
+  writeRecording(foxglove::McapCompression::Zstd);
+  auto reader_result = foxglove::McapReader::open(path());
+  auto& reader = requireValue(reader_result);
+
+  const auto& channels = reader.channels();
+  REQUIRE(channels.size() == 2);
+  REQUIRE(channels[0].topic == "/a");
+  REQUIRE(channels[0].message_encoding == "json");
+  const auto& schema = requireValue(channels[0].schema);
+  REQUIRE(schema.name == "ExampleSchema");
+  REQUIRE(schema.encoding == "jsonschema");
+  REQUIRE(!channels[1].schema.has_value());
+  REQUIRE(reader.channel(channels[1].id) == &channels[1]);
+  REQUIRE(reader.timeRange() == std::make_pair(uint64_t{0}, uint64_t{99}));
+
+  std::vector<uint64_t> expected;
+  for (uint64_t log_time = 0; log_time < 100; ++log_time) {
+    expected.push_back(log_time);
+  }
+  REQUIRE(readLogTimes(reader, {}) == expected);
+
+  foxglove::McapReadOptions options;
+  options.order = foxglove::McapReadOrder::File;
+  options.decompression_threads = 4;
+  REQUIRE(readLogTimes(reader, options) == expected);
+}
+
+TEST_CASE_METHOD(McapReaderTestFile, "McapReader filters by time range and topic") {
+  writeRecording(foxglove::McapCompression::None);
+  auto reader_result = foxglove::McapReader::open(path());
+  auto& reader = requireValue(reader_result);
+
+  foxglove::McapReadOptions options;
+  options.start_time = 10;
+  options.end_time = 20;
+  options.topics = std::vector<std::string>{"/b"};
+  REQUIRE(readLogTimes(reader, options) == std::vector<uint64_t>{11, 13, 15, 17, 19});
+
+  options.topics = std::vector<std::string>{};
+  REQUIRE(readLogTimes(reader, options).empty());
+}
+
+TEST_CASE_METHOD(McapReaderTestFile, "McapReader finds the latest message on each channel") {
+  writeRecording(foxglove::McapCompression::Zstd);
+  auto reader_result = foxglove::McapReader::open(path());
+  auto& reader = requireValue(reader_result);
+
+  auto latest = [&reader](uint64_t time, const foxglove::McapReadOptions& options) {
+    auto iter_result = reader.latestMessages(time, options);
+    auto& iter = requireValue(iter_result);
+    std::vector<std::pair<std::string, uint64_t>> messages;
+    while (true) {
+      auto next = iter.next();
+      REQUIRE(next.has_value());
+      if (!next->has_value()) {
+        break;
+      }
+      const auto& message = **next;
+      std::string data(reinterpret_cast<const char*>(message.data), message.data_len);
+      REQUIRE(data == std::to_string(message.log_time));
+      messages.emplace_back(message.channel->topic, message.log_time);
+    }
+    return messages;
+  };
+
+  using Messages = std::vector<std::pair<std::string, uint64_t>>;
+  REQUIRE(latest(51, {}) == Messages{{"/b", 49}, {"/a", 50}});
+  REQUIRE(latest(1, {}) == Messages{{"/a", 0}});
+  REQUIRE(latest(0, {}).empty());
+
+  foxglove::McapReadOptions options;
+  options.topics = std::vector<std::string>{"/b"};
+  REQUIRE(latest(1000, options) == Messages{{"/b", 99}});
+}
+
+TEST_CASE_METHOD(McapReaderTestFile, "McapMessageIterator outlives its reader") {
+  writeRecording(foxglove::McapCompression::Lz4);
+  std::optional<foxglove::McapMessageIterator> iter;
+  {
+    auto reader_result = foxglove::McapReader::open(path());
+    auto& reader = requireValue(reader_result);
+    auto iter_result = reader.messages();
+    iter.emplace(std::move(requireValue(iter_result)));
+  }
+  auto next = requireValue(iter).next();
+  REQUIRE(next.has_value());
+  const auto& message = requireValue(*next);
+  REQUIRE(message.log_time == 0);
+  REQUIRE(message.channel->topic == "/a");
+}
+
+TEST_CASE_METHOD(McapReaderTestFile, "McapReader rejects a file which is not a finished MCAP") {
+  std::ofstream(path()) << "not an mcap file";
+  REQUIRE(!foxglove::McapReader::open(path()).has_value());
+  REQUIRE(!foxglove::McapReader::open(path() + ".missing").has_value());
+}
+
+TEST_CASE_METHOD(McapReaderTestFile, "McapReader merges files in log time order") {
+  McapReaderTestFile other;
+  writeRecording(foxglove::McapCompression::Zstd);
+  other.writeRecording(foxglove::McapCompression::None);
+  std::vector<foxglove::McapReader> readers;
+  auto reader_result = foxglove::McapReader::open(path());
+  readers.push_back(std::move(requireValue(reader_result)));
+  auto other_result = foxglove::McapReader::open(other.path());
+  readers.push_back(std::move(requireValue(other_result)));
+
+  foxglove::McapReadOptions options;
+  options.start_time = 10;
+  options.topics = std::vector<std::string>{"/a"};
+  auto iter_result = foxglove::McapReader::merge(readers, options);
+  auto& iter = requireValue(iter_result);
+  size_t count = 0;
+  while (true) {
+    auto next = iter.next();
+    REQUIRE(next.has_value());
+    if (!next->has_value()) {
+      break;
+    }
+    const auto& message = **next;
+    REQUIRE(message.log_time == 10 + (count / 2) * 2);
+    REQUIRE(message.reader_index == count % 2);
+    REQUIRE(message.channel == &readers[message.reader_index].channels()[0]);
+    std::string data(reinterpret_cast<const char*>(message.data), message.data_len);
+    REQUIRE(data == std::to_string(message.log_time));
+    ++count;
+  }
+  REQUIRE(count == 90);
+}
@@ -1,78 +1,69 @@
 #include <foxglove-c/foxglove-c.h>
-#include <foxglove/arena.hpp>
 #include <foxglove/messages.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
 using namespace foxglove;
 using namespace foxglove::messages;
 
-namespace foxglove::messages {
-void triangleListPrimitiveToC(
-  foxglove_triangle_list_primitive& dest, const TriangleListPrimitive& src, Arena& arena
-);
-}  // namespace foxglove::messages
+namespace {
 
-TEST_CASE("triangle list primitive to c") {
-  Arena arena;
-  foxglove_triangle_list_primitive dest;
-  TriangleListPrimitive src;
+foxglove_string cString(std::string_view str) {
+  return {str.data(), str.size()};
+}
 
-  // Populate the pose
-  src.pose = Pose{};
-  src.pose->position = Vector3{1.0, 2.0, 3.0};
-  src.pose->orientation = Quaternion{0.1, 0.2, 0.3, 0.4};
+/// Encodes a message built from the C API's structs with the C API's encode function.
+template<typename T>
+std::vector<uint8_t> encodeWithC(
+  const T& msg, foxglove_error (*encode)(const T*, uint8_t*, size_t, size_t*)
+) {
+  size_t len = 0;
+  encode(&msg, nullptr, 0, &len);
+  std::vector<uint8_t> buf(len);
+  REQUIRE(encode(&msg, buf.data(), buf.size(), &len) == FOXGLOVE_ERROR_OK);
+  REQUIRE(len == buf.size());
+  return buf;
+}
 
-  // Add at least one triangle (3 points)
-  src.points.push_back(Point3{0.0, 0.0, 0.0});
-  src.points.push_back(Point3{1.0, 0.0, 0.0});
-  src.points.push_back(Point3{0.5, 1.0, 0.0});
+}  // namespace
 
-  // Set a solid color for the whole shape
-  src.color = Color{1.0, 0.0, 0.0, 1.0};
+TEST_CASE("triangle list primitive encoding matches the C API") {
+  TriangleListPrimitive msg;
+  msg.pose = Pose{Vector3{1.0, 2.0, 3.0}, Quaternion{0.1, 0.2, 0.3, 0.4}};
+  msg.points = {Point3{0.0, 0.0, 0.0}, Point3{1.0, 0.0, 0.0}, Point3{0.5, 1.0, 0.0}};
+  msg.color = Color{1.0, 0.0, 0.0, 1.0};
+  msg.colors = {Color{1.0, 0.0, 0.0, 1.0}, Color{0.0, 1.0, 0.0, 1.0}, Color{0.0, 0.0, 1.0, 1.0}};
+  msg.indices = {0, 1, 2};
 
-  // Add per-vertex colors (same length as points)
-  src.colors.push_back(Color{1.0, 0.0, 0.0, 1.0});
-  src.colors.push_back(Color{0.0, 1.0, 0.0, 1.0});
-  src.colors.push_back(Color{0.0, 0.0, 1.0, 1.0});
+  foxglove_vector3 c_position{1.0, 2.0, 3.0};
+  foxglove_quaternion c_orientation{0.1, 0.2, 0.3, 0.4};
+  foxglove_pose c_pose{&c_position, &c_orientation};
+  std::array<foxglove_point3, 3> c_points{{{0.0, 0.0, 0.0}, {1.0, 0.0, 0.0}, {0.5, 1.0, 0.0}}};
+  foxglove_color c_color{1.0, 0.0, 0.0, 1.0};
+  std::array<foxglove_color, 3> c_colors{
+    {{1.0, 0.0, 0.0, 1.0}, {0.0, 1.0, 0.0, 1.0}, {0.0, 0.0, 1.0, 1.0}}
+  };
+  std::array<uint32_t, 3> c_indices{0, 1, 2};
+  foxglove_triangle_list_primitive c_msg{
+    &c_pose,
+    c_points.data(),
+    c_points.size(),
+    &c_color,
+    c_colors.data(),
+    c_colors.size(),
+    c_indices.data(),
+    c_indices.size(),
+  };
 
-  // Add some indices
-  src.indices.push_back(0);
-  src.indices.push_back(1);
-  src.indices.push_back(2);
-
-  foxglove::messages::triangleListPrimitiveToC(dest, src, arena);
-
-  // Verify the conversion worked
-  REQUIRE(dest.pose != nullptr);
-  REQUIRE(dest.pose->position != nullptr);
-  REQUIRE(dest.pose->position->x == 1.0);
-  REQUIRE(dest.pose->position->y == 2.0);
-  REQUIRE(dest.pose->position->z == 3.0);
-  REQUIRE(dest.pose->orientation != nullptr);
-  REQUIRE(dest.pose->orientation->x == 0.1);
-  REQUIRE(dest.pose->orientation->y == 0.2);
-  REQUIRE(dest.pose->orientation->z == 0.3);
-  REQUIRE(dest.pose->orientation->w == 0.4);
-
-  REQUIRE(dest.points_count == 3);
-  REQUIRE(dest.points[0].x == 0.0);
-  REQUIRE(dest.points[1].x == 1.0);
-  REQUIRE(dest.points[2].y == 1.0);
-
-  REQUIRE(dest.color != nullptr);
-  REQUIRE(dest.color->r == 1.0);
-  REQUIRE(dest.color->g == 0.0);
-
-  REQUIRE(dest.colors_count == 3);
-  REQUIRE(dest.colors[0].r == 1.0);
-  REQUIRE(dest.colors[1].g == 1.0);
-  REQUIRE(dest.colors[2].b == 1.0);
-
-  REQUIRE(dest.indices_count == 3);
-  REQUIRE(dest.indices[0] == 0);
-  REQUIRE(dest.indices[1] == 1);
-  REQUIRE(dest.indices[2] == 2);
+  std::vector<uint8_t> encoded;
+  REQUIRE(msg.encode(encoded) == FoxgloveError::Ok);
+  REQUIRE(encoded == encodeWithC(c_msg, foxglove_triangle_list_primitive_encode));
 }
 
 TEST_CASE("triangle list primitive to protobuf") {
@@ -110,6 +101,153 @@ TEST_CASE("triangle list primitive to protobuf") {
   REQUIRE(capacity > 0);
 }
 
+TEST_CASE("encodedSize and encode into a vector agree with encode into a buffer") {
+  Log msg;
+  msg.message = "hello";
+  msg.name = "encoder";
+  msg.line = 42;
+
+  auto encoded_size_result = msg.encodedSize();
+  REQUIRE(encoded_size_result.has_value());
+  size_t encoded_size = *encoded_size_result;
+  REQUIRE(encoded_size > 0);
+
+  std::vector<uint8_t> expected(encoded_size);
+  size_t encoded_len = 0;
+  REQUIRE(msg.encode(expected.data(), expected.size(), &encoded_len) == FoxgloveError::Ok);
+  REQUIRE(encoded_len == encoded_size);
+
+  // Appends after existing contents.
+  std::vector<uint8_t> buf = {0xff};
+  REQUIRE(msg.encode(buf) == FoxgloveError::Ok);
+  REQUIRE(buf.size() == encoded_size + 1);
+  REQUIRE(buf[0] == 0xff);
+  REQUIRE(std::equal(expected.begin(), expected.end(), buf.begin() + 1));
+
+  // A warm buffer is reused without reallocating.
+  buf.clear();
+  const uint8_t* data = buf.data();
+  REQUIRE(msg.encode(buf) == FoxgloveError::Ok);
+  REQUIRE(buf.data() == data);
+  REQUIRE(buf == expected);
+
+  Color color{1.0, 0.5, 0.25, 1.0};
+  std::vector<uint8_t> color_buf;
+  REQUIRE(color.encode(color_buf) == FoxgloveError::Ok);
+  REQUIRE(color.encodedSize() == color_buf.size());
+}
+
+TEST_CASE("encoding matches the C API for nested messages") {
+  SceneEntity entity;
+  // Excess nanoseconds are normalized into seconds.
+  entity.timestamp = Timestamp{100, 1'500'000'000};
+  entity.frame_id = "map";
+  entity.id = "entity";
+  entity.lifetime = Duration{-3, 500};
+  entity.frame_locked = true;
+  entity.metadata.push_back({"key", "value"});
+
+  CubePrimitive cube;
+  cube.pose = Pose{Vector3{1.0, 2.0, 3.0}, Quaternion{0.0, 0.0, 0.0, 1.0}};
+  cube.size = Vector3{1.0, 1.0, 1.0};
+  cube.color = Color{1.0, 0.0, 0.0, 1.0};
+  entity.cubes.assign(100, cube);
+
+  LinePrimitive line;
+  line.type = LinePrimitive::LineType::LINE_LOOP;
+  line.thickness = 0.5;
+  line.points = {Point3{1.0, 2.0, 3.0}, Point3{}, Point3{-1.0, 0.0, 0.0}};
+  line.indices = {0, 1, 2, 300};
+  entity.lines.push_back(line);
+
+  TextPrimitive text;
+  text.text = "h\xc3\xa9llo";
+  text.font_size = 12.0;
+  entity.texts.push_back(text);
+
+  ModelPrimitive model;
+  model.url = "package://model.glb";
+  model.data = {std::byte{1}, std::byte{2}, std::byte{3}};
+  entity.models.push_back(model);
+
+  SceneUpdate msg;
+  msg.deletions.push_back({Timestamp{5, 0}, SceneEntityDeletion::SceneEntityDeletionType::ALL, ""});
+  msg.entities.push_back(entity);
+
+  std::vector<uint8_t> encoded;
+  REQUIRE(msg.encode(encoded) == FoxgloveError::Ok);
+  REQUIRE(msg.encodedSize() == encoded.size());
+
+  // The same message, built from the C API's structs, which the C API normalizes in the same way.
+  foxglove_timestamp c_timestamp{100, 1'500'000'000};
+  foxglove_duration c_lifetime{-3, 500};
+  foxglove_key_value_pair c_metadata{cString("key"), cString("value")};
+
+  foxglove_vector3 c_position{1.0, 2.0, 3.0};
+  foxglove_quaternion c_orientation{0.0, 0.0, 0.0, 1.0};
+  foxglove_pose c_pose{&c_position, &c_orientation};
+  foxglove_vector3 c_size{1.0, 1.0, 1.0};
+  foxglove_color c_color{1.0, 0.0, 0.0, 1.0};
+  std::vector<foxglove_cube_primitive> c_cubes(100, {&c_pose, &c_size, &c_color});
+
+  std::array<foxglove_point3, 3> c_points{{{1.0, 2.0, 3.0}, {0.0, 0.0, 0.0}, {-1.0, 0.0, 0.0}}};
+  std::array<uint32_t, 4> c_indices{0, 1, 2, 300};
+  foxglove_line_primitive c_line{};
+  c_line.type = FOXGLOVE_LINE_TYPE_LINE_LOOP;
+  c_line.thickness = 0.5;
+  c_line.points = c_points.data();
+  c_line.points_count = c_points.size();
+  c_line.indices = c_indices.data();
+  c_line.indices_count = c_indices.size();
+
+  foxglove_text_primitive c_text{};
+  c_text.font_size = 12.0;
+  c_text.text = cString(text.text);
+
+  std::array<unsigned char, 3> c_model_data{1, 2, 3};
+  foxglove_model_primitive c_model{};
+  c_model.url = cString("package://model.glb");
+  c_model.media_type = cString("");
+  c_model.data = c_model_data.data();
+  c_model.data_len = c_model_data.size();
+
+  foxglove_scene_entity c_entity{};
+  c_entity.timestamp = &c_timestamp;
+  c_entity.frame_id = cString("map");
+  c_entity.id = cString("entity");
+  c_entity.lifetime = &c_lifetime;
+  c_entity.frame_locked = true;
+  c_entity.metadata = &c_metadata;
+  c_entity.metadata_count = 1;
+  c_entity.cubes = c_cubes.data();
+  c_entity.cubes_count = c_cubes.size();
+  c_entity.lines = &c_line;
+  c_entity.lines_count = 1;
+  c_entity.texts = &c_text;
+  c_entity.texts_count = 1;
+  c_entity.models = &c_model;
+  c_entity.models_count = 1;
+
+  foxglove_timestamp c_deletion_timestamp{5, 0};
+  foxglove_scene_entity_deletion c_deletion{
+    &c_deletion_timestamp, FOXGLOVE_SCENE_ENTITY_DELETION_TYPE_ALL, cString("")
+  };
+  foxglove_scene_update c_msg{&c_deletion, 1, &c_entity, 1};
+
+  REQUIRE(encoded == encodeWithC(c_msg, foxglove_scene_update_encode));
+}
+
+TEST_CASE("encoding rejects invalid UTF-8") {
+  TextPrimitive msg;
+  msg.text = "\xff";
+  std::vector<uint8_t> buf;
+  REQUIRE(msg.encode(buf) == FoxgloveError::Utf8Error);
+  REQUIRE(buf.empty());
+  auto encoded_size = msg.encodedSize();
+  REQUIRE(!encoded_size.has_value());
+  REQUIRE(encoded_size.error() == FoxgloveError::Utf8Error);
+}
+
 TEST_CASE("triangle list primitive returns a schema") {
   Schema schema = TriangleListPrimitive::schema();
   REQUIRE(schema.name == "foxglove.TriangleListPrimitive");
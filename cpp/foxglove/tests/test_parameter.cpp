@@ -419,3 +419,60 @@ TEST_CASE("Parameter cloning") {
     REQUIRE(original_array[1].get<int64_t>() == clone_array[1].get<int64_t>());
   }
 }
+
+TEST_CASE("ParameterArrayBuilder builds nested parameters") {
+  foxglove::ParameterArrayBuilder builder;
+  // Keys and strings are viewed until the array is built.
+  std::string key = "gain";
+  auto gains = builder.dict({
+    {"p", builder.float64(1.5)},
+    {"limits", builder.array({builder.integer(-3), builder.integer(3)})},
+    {key, builder.string("high")},
+  });
+  std::vector<foxglove::ParameterArrayBuilder::Value> flags;
+  flags.reserve(2);
+  flags.push_back(builder.boolean(true));
+  flags.push_back(builder.boolean(false));
+  builder.add("controller", gains)
+    .add("flags", builder.array(flags))
+    .add("ratio", builder.float64(2.0), foxglove::ParameterType::Float64)
+    .add("unset");
+  REQUIRE(builder.size() == 4);
+
+  auto array = builder.build();
+  auto params = array.parameters();
+  REQUIRE(params.size() == 4);
+
+  REQUIRE(params[0].name() == "controller");
+  auto controller = params[0].get<foxglove::ParameterValueView::Dict>();
+  REQUIRE(controller.size() == 3);
+  REQUIRE(controller.at("p").get<double>() == 1.5);
+  REQUIRE(controller.at("gain").get<std::string>() == "high");
+  auto limits = controller.at("limits").get<foxglove::ParameterValueView::Array>();
+  REQUIRE(limits.size() == 2);
+  REQUIRE(limits[0].get<int64_t>() == -3);
+  REQUIRE(limits[1].get<int64_t>() == 3);
+
+  auto flag_values = params[1].get<foxglove::ParameterValueView::Array>();
+  REQUIRE(flag_values.size() == 2);
+  REQUIRE(flag_values[0].get<bool>());
+  REQUIRE_FALSE(flag_values[1].get<bool>());
+
+  REQUIRE(params[2].type() == foxglove::ParameterType::Float64);
+  REQUIRE(params[2].get<double>() == 2.0);
+  REQUIRE_FALSE(params[3].hasValue());
+
+  // A cleared builder can be reused.
+  builder.clear();
+  REQUIRE(builder.size() == 0);
+  builder.add("empty", builder.dict({}));
+  auto rebuilt = builder.build();
+  REQUIRE(rebuilt.parameters().size() == 1);
+  REQUIRE(rebuilt.parameters()[0].get<foxglove::ParameterValueView::Dict>().empty());
+}
+
+TEST_CASE("ParameterArrayBuilder rejects invalid UTF-8") {
+  foxglove::ParameterArrayBuilder builder;
+  builder.add("bad", builder.string("\xff"));
+  REQUIRE_THROWS_AS(builder.build(), std::runtime_error);
+}
@@ -0,0 +1,150 @@
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap.hpp>
+#include <foxglove/messages.hpp>
+#include <foxglove/point_cloud.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using foxglove::messages::PackedElementField;
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+namespace {
+
+template<typename T>
+T readAt(const std::vector<std::byte>& data, size_t offset) {
+  T value{};
+  std::memcpy(&value, data.data() + offset, sizeof(T));
+  return value;
+}
+
+}  // namespace
+
+TEST_CASE("PointCloudBuilder packs xyz columns") {
+  // Enough points to exercise both the vectorized and the scalar paths.
+  const size_t count = 7;
+  std::vector<float> x(count);
+  std::vector<float> y(count);
+  std::vector<float> z(count);
+  for (size_t i = 0; i < count; ++i) {
+    x[i] = static_cast<float>(i);
+    y[i] = static_cast<float>(i) + 0.25F;
+    z[i] = static_cast<float>(i) + 0.5F;
+  }
+  foxglove::PointCloudColumns columns;
+  columns.x = x.data();
+  columns.y = y.data();
+  columns.z = z.data();
+  columns.count = count;
+
+  foxglove::PointCloudBuilder builder;
+  REQUIRE(builder.pack(columns) == foxglove::FoxgloveError::Ok);
+  REQUIRE(builder.pointStride() == 12);
+  REQUIRE(builder.size() == count);
+  REQUIRE(builder.data().size() == count * 12);
+  REQUIRE(builder.fields().size() == 3);
+  REQUIRE(builder.fields()[2].name == "z");
+  REQUIRE(builder.fields()[2].offset == 8);
+  REQUIRE(builder.fields()[2].type == PackedElementField::NumericType::FLOAT32);
+  for (size_t i = 0; i < count; ++i) {
+    REQUIRE(readAt<float>(builder.data(), (i * 12)) == x[i]);
+    REQUIRE(readAt<float>(builder.data(), (i * 12) + 4) == y[i]);
+    REQUIRE(readAt<float>(builder.data(), (i * 12) + 8) == z[i]);
+  }
+}
+
+TEST_CASE("PointCloudBuilder packs intensity and color columns") {
+  const size_t count = 9;
+  std::vector<float> xyz(count, 1.0F);
+  std::vector<float> intensity(count);
+  std::vector<uint32_t> rgba(count);
+  for (size_t i = 0; i < count; ++i) {
+    intensity[i] = static_cast<float>(i) * 2.0F;
+    rgba[i] = 0x10203040U + static_cast<uint32_t>(i);
+  }
+  foxglove::PointCloudColumns columns;
+  columns.x = xyz.data();
+  columns.y = xyz.data();
+  columns.z = xyz.data();
+  columns.intensity = intensity.data();
+  columns.rgba = rgba.data();
+  columns.count = count;
+
+  foxglove::PointCloudBuilder builder;
+  REQUIRE(builder.pack(columns) == foxglove::FoxgloveError::Ok);
+  REQUIRE(builder.pointStride() == 20);
+  const auto& fields = builder.fields();
+  REQUIRE(fields.size() == 8);
+  REQUIRE(fields[3].name == "intensity");
+  REQUIRE(fields[3].offset == 12);
+  REQUIRE(fields[4].name == "red");
+  REQUIRE(fields[4].offset == 16);
+  REQUIRE(fields[4].type == PackedElementField::NumericType::UINT8);
+  REQUIRE(fields[7].name == "alpha");
+  REQUIRE(fields[7].offset == 19);
+  for (size_t i = 0; i < count; ++i) {
+    REQUIRE(readAt<float>(builder.data(), (i * 20) + 12) == intensity[i]);
+    REQUIRE(readAt<uint32_t>(builder.data(), (i * 20) + 16) == rgba[i]);
+  }
+
+  // Packing again reuses the buffer.
+  const auto* buffer = builder.data().data();
+  columns.rgba = nullptr;
+  REQUIRE(builder.pack(columns) == foxglove::FoxgloveError::Ok);
+  REQUIRE(builder.pointStride() == 16);
+  REQUIRE(builder.fields().size() == 4);
+  REQUIRE(builder.data().data() == buffer);
+}
+
+TEST_CASE("PointCloudBuilder requires coordinate columns") {
+  foxglove::PointCloudBuilder builder;
+  foxglove::PointCloudColumns columns;
+  REQUIRE(builder.pack(columns) == foxglove::FoxgloveError::Ok);
+  REQUIRE(builder.size() == 0);
+
+  std::vector<float> x(4);
+  columns.x = x.data();
+  columns.count = x.size();
+  REQUIRE(builder.pack(columns) == foxglove::FoxgloveError::ValueError);
+}
+
+TEST_CASE("PointCloudBuilder view can be logged") {
+  FileCleanup cleanup("test_point_cloud_" + std::to_string(std::random_device{}()) + ".mcap");
+  auto context = foxglove::Context::create();
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = cleanup.path();
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  std::vector<float> xyz = {1.0F, 2.0F, 3.0F, 4.0F, 5.0F};
+  foxglove::PointCloudColumns columns;
+  columns.x = xyz.data();
+  columns.y = xyz.data();
+  columns.z = xyz.data();
+  columns.count = xyz.size();
+  foxglove::PointCloudBuilder builder;
+  REQUIRE(builder.pack(columns) == foxglove::FoxgloveError::Ok);
+
+  auto view = builder.view();
+  REQUIRE(view.data == builder.data().data());
+  REQUIRE(view.data_len == builder.data().size());
+  REQUIRE(view.point_stride == builder.pointStride());
+  view.frame_id = "lidar";
+
+  auto channel_result = foxglove::messages::PointCloudChannel::create("/points", context);
+  auto& channel = requireValue(channel_result);
+  REQUIRE(channel.log(view) == foxglove::FoxgloveError::Ok);
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+}
@@ -0,0 +1,144 @@
+#include <foxglove/messages.hpp>
+#include <foxglove/remote_data_loader_backend.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace rdl = foxglove::remote_data_loader_backend;
+
+TEST_CASE("ChannelSet deduplicates schemas") {
+  rdl::ChannelSet channels;
+  channels.insert<foxglove::messages::Vector3>("/a");
+  channels.insert<foxglove::messages::Vector3>("/b");
+  channels.insert<foxglove::messages::Pose>("/c");
+
+  REQUIRE(channels.topics.size() == 3);
+  REQUIRE(channels.schemas.size() == 2);
+  REQUIRE(channels.topics[0].schema_id == channels.topics[1].schema_id);
+  REQUIRE(channels.topics[0].schema_id != channels.topics[2].schema_id);
+}
+
+TEST_CASE("serializeManifest computes a stable strong ETag") {
+  rdl::Manifest manifest;
+  manifest.name = "Flight ABC123";
+  auto first = rdl::serializeManifest(manifest);
+  auto second = rdl::serializeManifest(manifest);
+
+  REQUIRE(first.json == rdl::toJsonString(manifest));
+  REQUIRE(first.etag == second.etag);
+  REQUIRE(first.etag.size() == 18);
+  REQUIRE(first.etag.front() == '"');
+  REQUIRE(first.etag.back() == '"');
+
+  manifest.name = "Flight DEF456";
+  REQUIRE(rdl::serializeManifest(manifest).etag != first.etag);
+}
+
+TEST_CASE("etagMatches handles If-None-Match lists") {
+  const std::string etag = "\"0123456789abcdef\"";
+  REQUIRE(rdl::etagMatches(etag, etag));
+  REQUIRE(rdl::etagMatches("*", etag));
+  REQUIRE(rdl::etagMatches("\"other\", W/\"0123456789abcdef\"", etag));
+  REQUIRE_FALSE(rdl::etagMatches("\"other\"", etag));
+  REQUIRE_FALSE(rdl::etagMatches("", etag));
+}
+
+TEST_CASE("splitTimeRange produces contiguous segments of the target size") {
+  const uint64_t second = 1'000'000'000;
+  const uint64_t start = 1'704'067'200 * second;
+  const uint64_t end = start + 86'400 * second;
+
+  rdl::SegmentOptions options;
+  options.estimated_bytes_per_second = 60;
+  options.target_bytes_per_segment = 1024 * 1024;
+  options.alignment_ns = second;
+  auto segments = rdl::splitTimeRange(start, end, options);
+  REQUIRE(segments.size() == 5);
+  REQUIRE(segments.front().start_ns == start);
+  REQUIRE(segments.back().end_ns == end);
+  for (size_t i = 1; i < segments.size(); ++i) {
+    REQUIRE(segments[i].start_ns == segments[i - 1].end_ns + 1);
+    REQUIRE(segments[i].start_ns % second == 0);
+  }
+
+  // Without a rate estimate the range is kept whole, and the segment count is bounded.
+  options.estimated_bytes_per_second = 0;
+  REQUIRE(rdl::splitTimeRange(start, end, options).size() == 1);
+  options.estimated_bytes_per_second = UINT64_MAX;
+  REQUIRE(rdl::splitTimeRange(start, end, options).size() == options.max_segments);
+  REQUIRE(rdl::splitTimeRange(end, start, options).empty());
+}
+
+TEST_CASE("sourceCacheKey changes with the source's parameters") {
+  rdl::StreamedSource source;
+  source.url = "/v1/data?flightId=ABC123";
+  source.start_time = "2024-01-01T00:00:00Z";
+  source.end_time = "2024-01-02T00:00:00Z";
+  const auto key = rdl::sourceCacheKey(source);
+  REQUIRE(key.size() == 16);
+  REQUIRE(rdl::sourceCacheKey(source) == key);
+
+  auto other = source;
+  other.id = "flight-v2-ABC123";
+  REQUIRE(rdl::sourceCacheKey(other) != key);
+  other = source;
+  other.end_time = "2024-01-03T00:00:00Z";
+  REQUIRE(rdl::sourceCacheKey(other) != key);
+  other = source;
+  other.topics.push_back(rdl::Topic{"/demo", "protobuf", std::nullopt});
+  REQUIRE(rdl::sourceCacheKey(other) != key);
+}
+
+TEST_CASE("McapFileCache generates each source once") {
+  const auto directory = std::filesystem::temp_directory_path() / "foxglove_test_mcap_file_cache";
+  std::filesystem::remove_all(directory);
+  rdl::McapFileCache cache(directory);
+  std::atomic<int> generations{0};
+  auto generate = [&generations](const std::string& path) {
+    ++generations;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::ofstream(path) << "mcap";
+    return foxglove::FoxgloveError::Ok;
+  };
+
+  rdl::StreamedSource source;
+  source.url = "/v1/data?flightId=ABC123";
+  std::vector<std::thread> threads;
+  std::vector<foxglove::FoxgloveResult<std::string>> results(4);
+  for (auto& result : results) {
+    threads.emplace_back([&] {
+      result = cache.getOrCreate(source, generate);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  REQUIRE(generations == 1);
+  for (const auto& result : results) {
+    REQUIRE(result.has_value());
+    REQUIRE(*result == (directory / (rdl::sourceCacheKey(source) + ".mcap")).string());
+  }
+  REQUIRE(std::filesystem::file_size(*results[0]) == 4);
+
+  REQUIRE(cache.getOrCreate(source, generate).has_value());
+  REQUIRE(generations == 1);
+
+  // Failed generations leave nothing behind, and are retried.
+  auto fail = [](const std::string& path) {
+    std::ofstream(path) << "partial";
+    return foxglove::FoxgloveError::ValueError;
+  };
+  auto failed = cache.getOrCreate("failed", fail);
+  REQUIRE(failed.error() == foxglove::FoxgloveError::ValueError);
+  REQUIRE_FALSE(std::filesystem::exists(directory / "failed.mcap"));
+  REQUIRE_FALSE(std::filesystem::exists(directory / "failed.mcap.tmp"));
+  REQUIRE(cache.getOrCreate("failed", generate).has_value());
+  REQUIRE(generations == 2);
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,81 @@
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/ring_buffer.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using Catch::Matchers::ContainsSubstring;
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+namespace {
+
+std::string readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  REQUIRE(file.is_open());
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void log(foxglove::RawChannel& channel, std::string_view data, uint64_t log_time) {
+  REQUIRE(
+    channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size(), log_time) ==
+    foxglove::FoxgloveError::Ok
+  );
+}
+
+}  // namespace
+
+TEST_CASE("RingBufferSink snapshots the most recent messages") {
+  FileCleanup cleanup("test_ring_buffer_" + std::to_string(std::random_device{}()) + ".mcap");
+  auto context = foxglove::Context::create();
+  foxglove::RingBufferSinkOptions options;
+  options.context = context;
+  options.window = std::chrono::seconds(10);
+  options.sink_channel_filter = [](const foxglove::ChannelDescriptor& channel) -> bool {
+    return channel.topic() != "/skipped";
+  };
+  auto sink_result = foxglove::RingBufferSink::create(std::move(options));
+  auto& sink = requireValue(sink_result);
+
+  auto channel_result = foxglove::RawChannel::create("/test", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+  auto skipped_result = foxglove::RawChannel::create("/skipped", "json", std::nullopt, context);
+  auto& skipped = requireValue(skipped_result);
+
+  constexpr uint64_t kSecond = 1'000'000'000;
+  log(channel, "evicted msg", 0);
+  log(channel, "older msg", 5 * kSecond);
+  log(channel, "newer msg", 12 * kSecond);
+  log(skipped, "skipped msg", 12 * kSecond);
+  REQUIRE(sink.bufferedMessages() == 2);
+  REQUIRE(sink.bufferedBytes() == 18);
+
+  auto snapshot_result = sink.snapshot(cleanup.path(), std::chrono::seconds(5));
+  auto& snapshot = requireValue(snapshot_result);
+  REQUIRE(snapshot.wait() == foxglove::FoxgloveError::Ok);
+
+  std::string content = readFile(cleanup.path());
+  REQUIRE_THAT(content, ContainsSubstring("newer msg"));
+  REQUIRE_THAT(content, !ContainsSubstring("older msg"));
+  REQUIRE_THAT(content, !ContainsSubstring("evicted msg"));
+  REQUIRE_THAT(content, !ContainsSubstring("skipped msg"));
+
+  // Snapshots never overwrite an existing file.
+  auto duplicate_result = sink.snapshot(cleanup.path(), std::chrono::seconds(5));
+  REQUIRE(requireValue(duplicate_result).wait() != foxglove::FoxgloveError::Ok);
+
+  REQUIRE(sink.close() == foxglove::FoxgloveError::Ok);
+}
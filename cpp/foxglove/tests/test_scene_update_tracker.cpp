@@ -0,0 +1,146 @@
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap.hpp>
+#include <foxglove/mcap_reader.hpp>
+#include <foxglove/messages.hpp>
+#include <foxglove/scene_update_tracker.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using foxglove::messages::SceneEntity;
+using foxglove::messages::SceneEntityDeletion;
+using foxglove::messages::SceneUpdate;
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+namespace {
+
+SceneEntity makeEntity(const std::string& id, double size) {
+  SceneEntity entity;
+  entity.id = id;
+  entity.frame_id = "map";
+  entity.timestamp = foxglove::messages::Timestamp{10, 999'999'999};
+  foxglove::messages::CubePrimitive cube;
+  cube.size = foxglove::messages::Vector3{size, size, size};
+  entity.cubes.push_back(cube);
+  return entity;
+}
+
+std::string encode(const SceneUpdate& update) {
+  std::vector<uint8_t> buf;
+  REQUIRE(update.encode(buf) == foxglove::FoxgloveError::Ok);
+  return {buf.begin(), buf.end()};
+}
+
+std::vector<std::string> readMessages(const std::string& path) {
+  auto reader_result = foxglove::McapReader::open(path);
+  auto& reader = requireValue(reader_result);
+  auto iter_result = reader.messages();
+  auto& iter = requireValue(iter_result);
+  std::vector<std::string> messages;
+  while (true) {
+    auto next = iter.next();
+    REQUIRE(next.has_value());
+    if (!next->has_value()) {
+      break;
+    }
+    const auto& message = **next;
+    messages.emplace_back(reinterpret_cast<const char*>(message.data), message.data_len);
+  }
+  return messages;
+}
+
+}  // namespace
+
+TEST_CASE("SceneUpdateTracker logs only changed entities") {
+  FileCleanup cleanup(
+    "test_scene_update_tracker_" + std::to_string(std::random_device{}()) + ".mcap"
+  );
+  auto context = foxglove::Context::create();
+  auto tracker_result = foxglove::SceneUpdateTracker::create("/scene", context);
+  auto& tracker = requireValue(tracker_result);
+
+  SceneUpdate scene;
+  scene.entities = {makeEntity("a", 1.0), makeEntity("b", 2.0)};
+  // Without consumers, nothing is logged or tracked.
+  REQUIRE(tracker.log(scene, 1) == foxglove::FoxgloveError::Ok);
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = cleanup.path();
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  // The first update contains the whole scene.
+  REQUIRE(tracker.log(scene, 2) == foxglove::FoxgloveError::Ok);
+  std::vector<std::string> expected = {encode(scene)};
+
+  // An unchanged scene logs nothing.
+  REQUIRE(tracker.log(scene, 3) == foxglove::FoxgloveError::Ok);
+
+  // Changed and added entities are logged.
+  scene.entities = {makeEntity("a", 1.0), makeEntity("b", 3.0), makeEntity("c", 4.0)};
+  REQUIRE(tracker.log(scene, 4) == foxglove::FoxgloveError::Ok);
+  SceneUpdate changed;
+  changed.entities = {makeEntity("b", 3.0), makeEntity("c", 4.0)};
+  expected.push_back(encode(changed));
+
+  // Removed entities are deleted, after their own timestamp.
+  scene.entities = {makeEntity("b", 3.0), makeEntity("c", 4.0)};
+  REQUIRE(tracker.log(scene, 5) == foxglove::FoxgloveError::Ok);
+  SceneUpdate removed;
+  SceneEntityDeletion deletion;
+  deletion.id = "a";
+  deletion.type = SceneEntityDeletion::SceneEntityDeletionType::MATCHING_ID;
+  deletion.timestamp = foxglove::messages::Timestamp{11, 0};
+  removed.deletions.push_back(deletion);
+  expected.push_back(encode(removed));
+
+  // After a reset, the whole scene is logged again.
+  tracker.reset();
+  REQUIRE(tracker.log(scene, 6) == foxglove::FoxgloveError::Ok);
+  expected.push_back(encode(scene));
+
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+  REQUIRE(readMessages(cleanup.path()) == expected);
+}
+
+TEST_CASE("SceneUpdateTracker logs the whole scene when a consumer is added") {
+  const std::string suffix = std::to_string(std::random_device{}());
+  FileCleanup first_cleanup("test_scene_update_tracker_first_" + suffix + ".mcap");
+  FileCleanup second_cleanup("test_scene_update_tracker_second_" + suffix + ".mcap");
+  auto context = foxglove::Context::create();
+  auto tracker_result = foxglove::SceneUpdateTracker::create("/scene", context);
+  auto& tracker = requireValue(tracker_result);
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = first_cleanup.path();
+  auto first = foxglove::McapWriter::create(options);
+  REQUIRE(first.has_value());
+
+  SceneUpdate scene;
+  scene.entities = {makeEntity("a", 1.0), makeEntity("b", 2.0)};
+  REQUIRE(tracker.log(scene, 1) == foxglove::FoxgloveError::Ok);
+  REQUIRE(tracker.log(scene, 2) == foxglove::FoxgloveError::Ok);
+
+  options.path = second_cleanup.path();
+  auto second = foxglove::McapWriter::create(options);
+  REQUIRE(second.has_value());
+  REQUIRE(tracker.log(scene, 3) == foxglove::FoxgloveError::Ok);
+
+  REQUIRE(first->close() == foxglove::FoxgloveError::Ok);
+  REQUIRE(second->close() == foxglove::FoxgloveError::Ok);
+  // Both consumers receive the whole scene.
+  const std::string full = encode(scene);
+  REQUIRE(readMessages(first_cleanup.path()) == std::vector<std::string>{full, full});
+  REQUIRE(readMessages(second_cleanup.path()) == std::vector<std::string>{full});
+}
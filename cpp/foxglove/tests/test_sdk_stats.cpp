@@ -0,0 +1,27 @@
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/sdk_stats.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+#include "common/test_helpers.hpp"
+
+using foxglove_tests::requireValue;
+
+TEST_CASE("SdkStatsPublisher start and stop") {
+  auto context = foxglove::Context::create();
+  foxglove::SdkStatsOptions options;
+  options.context = context;
+  options.topic = "/custom/sdk_stats";
+  options.refresh_interval = std::chrono::milliseconds(100);
+
+  auto publisher = foxglove::SdkStatsPublisher::create(std::move(options));
+  REQUIRE(publisher.has_value());
+
+  auto& pub = requireValue(publisher);
+  REQUIRE(pub.stop() == foxglove::FoxgloveError::Ok);
+  // Stopping twice is a no-op.
+  REQUIRE(pub.stop() == foxglove::FoxgloveError::Ok);
+}
@@ -0,0 +1,78 @@
+#include <foxglove/channel.hpp>
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/shared_memory.hpp>
+#include <foxglove/websocket.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <random>
+#include <string>
+
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+// Shared-memory sinks are only supported on Unix platforms.
+#ifndef _WIN32
+
+TEST_CASE("SharedMemorySink create and close") {
+  FileCleanup cleanup(
+    (std::filesystem::temp_directory_path() /
+     ("test_shared_memory_" + std::to_string(std::random_device{}())))
+      .string()
+  );
+  auto context = foxglove::Context::create();
+  foxglove::SharedMemorySinkOptions options;
+  options.context = context;
+  options.path = cleanup.path();
+  options.capacity = 1 << 16;
+  options.sink_channel_filter = [](const foxglove::ChannelDescriptor& channel) -> bool {
+    return channel.topic() != "/skipped";
+  };
+  auto sink_result = foxglove::SharedMemorySink::create(std::move(options));
+  auto& sink = requireValue(sink_result);
+  REQUIRE(sink.token() == cleanup.path());
+  REQUIRE(std::filesystem::file_size(cleanup.path()) > (1U << 16));
+
+  auto channel_result = foxglove::RawChannel::create("/test", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+  std::string data = "{}";
+  channel.log(reinterpret_cast<const std::byte*>(data.data()), data.size());
+
+  // A second sink can't share the same file.
+  foxglove::SharedMemorySinkOptions duplicate;
+  duplicate.context = context;
+  duplicate.path = cleanup.path();
+  REQUIRE(!foxglove::SharedMemorySink::create(std::move(duplicate)).has_value());
+
+  REQUIRE(sink.close() == foxglove::FoxgloveError::Ok);
+  REQUIRE(!std::filesystem::exists(cleanup.path()));
+}
+
+TEST_CASE("SharedMemorySink is advertised by a WebSocket server") {
+  auto context = foxglove::Context::create();
+  foxglove::SharedMemorySinkOptions sink_options;
+  sink_options.context = context;
+  auto sink_result = foxglove::SharedMemorySink::create(std::move(sink_options));
+  auto& sink = requireValue(sink_result);
+  REQUIRE(!sink.token().empty());
+
+  foxglove::WebSocketServerOptions options;
+  options.context = context;
+  options.name = "unit-test";
+  options.port = 0;
+  options.shared_memory_sink = &sink;
+  auto server_result = foxglove::WebSocketServer::create(std::move(options));
+  auto& server = requireValue(server_result);
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+
+  std::string token(sink.token());
+  REQUIRE(sink.close() == foxglove::FoxgloveError::Ok);
+  REQUIRE(!std::filesystem::exists(token));
+}
+
+#endif
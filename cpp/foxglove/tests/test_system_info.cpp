@@ -64,3 +64,15 @@ TEST_CASE("SystemInfoPublisher destructor does not stop the publisher") {
   }
   std::this_thread::sleep_for(std::chrono::milliseconds(50));
 }
+
+TEST_CASE("SystemInfoPublisher with selected metrics") {
+  auto context = foxglove::Context::create();
+  foxglove::SystemInfoOptions options;
+  options.context = context;
+  options.refresh_interval = std::chrono::milliseconds(200);
+  options.metrics = foxglove::SystemInfoMetrics::CpuPerCore | foxglove::SystemInfoMetrics::Sdk;
+
+  auto publisher = foxglove::SystemInfoPublisher::create(std::move(options));
+  REQUIRE(publisher.has_value());
+  REQUIRE(requireValue(publisher).stop() == foxglove::FoxgloveError::Ok);
+}
@@ -0,0 +1,135 @@
+#include <foxglove/context.hpp>
+#include <foxglove/error.hpp>
+#include <foxglove/mcap.hpp>
+#include <foxglove/mcap_reader.hpp>
+#include <foxglove/messages.hpp>
+#include <foxglove/typed_channel.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/file_cleanup.hpp"
+#include "common/test_helpers.hpp"
+
+using foxglove_tests::FileCleanup;
+using foxglove_tests::requireValue;
+
+namespace {
+
+struct Point {
+  int x = 0;
+  int y = 0;
+};
+
+/// Encodes a Point as "x,y", and counts the number of encoded messages.
+struct PointTraits {
+  static constexpr std::string_view message_encoding = "csv";
+
+  static inline int encoded = 0;
+
+  static std::optional<foxglove::Schema> schema() {
+    foxglove::Schema schema;
+    schema.name = "Point";
+    return schema;
+  }
+
+  static foxglove::FoxgloveError encode(const Point& msg, std::vector<uint8_t>& buf) noexcept {
+    ++encoded;
+    std::string data = std::to_string(msg.x) + "," + std::to_string(msg.y);
+    buf.insert(buf.end(), data.begin(), data.end());
+    return foxglove::FoxgloveError::Ok;
+  }
+};
+
+std::vector<std::string> readMessages(const std::string& path, const std::string& topic) {
+  auto reader_result = foxglove::McapReader::open(path);
+  auto& reader = requireValue(reader_result);
+  foxglove::McapReadOptions options;
+  options.topics = std::vector<std::string>{topic};
+  auto iter_result = reader.messages(options);
+  auto& iter = requireValue(iter_result);
+  std::vector<std::string> messages;
+  while (true) {
+    auto next = iter.next();
+    REQUIRE(next.has_value());
+    if (!next->has_value()) {
+      break;
+    }
+    const auto& message = **next;
+    messages.emplace_back(reinterpret_cast<const char*>(message.data), message.data_len);
+  }
+  return messages;
+}
+
+}  // namespace
+
+TEST_CASE("TypedChannel logs built-in messages as protobuf") {
+  FileCleanup cleanup("test_typed_channel_" + std::to_string(std::random_device{}()) + ".mcap");
+  auto context = foxglove::Context::create();
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = cleanup.path();
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  auto channel_result = foxglove::TypedChannel<foxglove::messages::Log>::create("/log", context);
+  auto& channel = requireValue(channel_result);
+  REQUIRE(channel.topic() == "/log");
+  REQUIRE(channel.hasSinks());
+
+  foxglove::messages::Log msg;
+  msg.message = "hello";
+  REQUIRE(channel.log(msg, 1) == foxglove::FoxgloveError::Ok);
+  std::vector<uint8_t> expected;
+  REQUIRE(msg.encode(expected) == foxglove::FoxgloveError::Ok);
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+
+  auto reader_result = foxglove::McapReader::open(cleanup.path());
+  auto& reader = requireValue(reader_result);
+  REQUIRE(reader.channels().size() == 1);
+  REQUIRE(reader.channels()[0].message_encoding == "protobuf");
+  REQUIRE(requireValue(reader.channels()[0].schema).name == "foxglove.Log");
+
+  auto messages = readMessages(cleanup.path(), "/log");
+  REQUIRE(messages.size() == 1);
+  REQUIRE(messages[0] == std::string(expected.begin(), expected.end()));
+}
+
+TEST_CASE("TypedChannel logs custom types with the given traits") {
+  FileCleanup cleanup("test_typed_channel_" + std::to_string(std::random_device{}()) + ".mcap");
+  auto context = foxglove::Context::create();
+  PointTraits::encoded = 0;
+
+  auto channel_result = foxglove::TypedChannel<Point, PointTraits>::create("/point", context);
+  auto& channel = requireValue(channel_result);
+
+  // Messages aren't encoded if no sink would receive them.
+  const std::array<Point, 2> points = {Point{1, 2}, Point{3, 4}};
+  REQUIRE(channel.log(points[0]) == foxglove::FoxgloveError::Ok);
+  REQUIRE(channel.logBatch(points.data(), points.size()) == foxglove::FoxgloveError::Ok);
+  REQUIRE(PointTraits::encoded == 0);
+
+  foxglove::McapWriterOptions options;
+  options.context = context;
+  options.path = cleanup.path();
+  auto writer = foxglove::McapWriter::create(options);
+  REQUIRE(writer.has_value());
+
+  REQUIRE(channel.log(points[0], 1) == foxglove::FoxgloveError::Ok);
+  const std::array<uint64_t, 2> log_times = {2, 3};
+  REQUIRE(
+    channel.logBatch(points.data(), points.size(), log_times.data()) == foxglove::FoxgloveError::Ok
+  );
+  REQUIRE(PointTraits::encoded == 3);
+  REQUIRE(writer->close() == foxglove::FoxgloveError::Ok);
+
+  auto messages = readMessages(cleanup.path(), "/point");
+  REQUIRE(messages == std::vector<std::string>{"1,2", "1,2", "3,4"});
+}
@@ -12,26 +12,46 @@
 #include <catch2/matchers/catch_matchers_vector.hpp>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <libwebsockets.h>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <random>
 #include <thread>
 #include <type_traits>
 
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include "common/file_cleanup.hpp"
 #include "common/test_helpers.hpp"
 #include "foxglove/playback_state.hpp"
 
 using Catch::Matchers::ContainsSubstring;
 using Catch::Matchers::Equals;
+using Catch::Matchers::StartsWith;
 
 using Json = nlohmann::json;
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 
+using foxglove_tests::FileCleanup;
 using foxglove_tests::requireValue;
 
 namespace {
@@ -168,6 +188,13 @@ public:
     this->send(payload.data(), payload.size());
   }
 
+  /// Stops or resumes reading from the connection. While the client isn't reading, the server's
+  /// messages back up in the socket buffers and then in the server's backlog for the client.
+  void setReceiving(bool receiving) {
+    receiving_ = receiving;
+    lws_cancel_service(context_);
+  }
+
 private:
   struct TxMessage {
     std::vector<uint8_t> data;
@@ -219,6 +246,7 @@ private:
       }
       case LWS_CALLBACK_EVENT_WAIT_CANCELLED: {
         if (self->wsi_ != nullptr) {
+          lws_rx_flow_control(self->wsi_, self->receiving_ ? 1 : 0);
           lws_callback_on_writable(self->wsi_);
         }
         break;
@@ -241,6 +269,7 @@ private:
   uint16_t port_ = 0;
   std::thread thread_;
   std::atomic<bool> running_{false};
+  std::atomic<bool> receiving_{true};
 
   std::mutex tx_mutex_;
   std::queue<TxMessage> tx_queue_;
@@ -288,6 +317,193 @@ foxglove::WebSocketServer startServer(
   return startServer(std::move(options));
 }
 
+/// Counts the subscriptions reported by a server's onSubscribe callback.
+class SubscriptionCounter {
+public:
+  void add() {
+    std::scoped_lock lock{mutex_};
+    ++count_;
+    cv_.notify_one();
+  }
+
+  void waitFor(size_t count) {
+    std::unique_lock lock{mutex_};
+    auto wait_result = cv_.wait_for(lock, kTestTimeout, [&] {
+      return count_ >= count;
+    });
+    REQUIRE(wait_result);
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t count_ = 0;
+};
+
+/// Connects the client, flushes the serverInfo and advertise messages, and subscribes to each of
+/// the channels, with subscription IDs counting up from 1.
+void connectAndSubscribe(
+  WebSocketClient& client, uint16_t port, const std::vector<uint64_t>& channel_ids
+) {
+  client.start(port);
+  client.waitForConnection();
+
+  auto has_op = [](std::string_view op) {
+    return [op](const std::string& payload) {
+      auto parsed = Json::parse(payload);
+      return parsed.contains("op") && parsed["op"] == op;
+    };
+  };
+  REQUIRE(client.filterRecv(has_op("serverInfo")).has_value());
+  REQUIRE(client.filterRecv(has_op("advertise")).has_value());
+
+  Json subscriptions = Json::array();
+  for (size_t i = 0; i < channel_ids.size(); ++i) {
+    subscriptions.push_back({{"id", i + 1}, {"channelId", channel_ids[i]}});
+  }
+  client.send(Json{{"op", "subscribe"}, {"subscriptions", subscriptions}}.dump());
+}
+
+/// A MessageData message received by a client.
+struct MessageData {
+  uint32_t subscription_id;
+  std::string data;
+};
+
+/// Parses a MessageData message: an opcode, a subscription ID and a timestamp, followed by the
+/// message data. Returns nullopt for other messages.
+std::optional<MessageData> parseMessageData(const std::string& payload) {
+  constexpr size_t kHeaderLen = 1 + 4 + 8;
+  if (payload.size() < kHeaderLen || payload[0] != '\x01') {
+    return std::nullopt;
+  }
+  uint32_t subscription_id = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    subscription_id |= static_cast<uint32_t>(static_cast<uint8_t>(payload[1 + i])) << (8 * i);
+  }
+  return MessageData{subscription_id, payload.substr(kHeaderLen)};
+}
+
+#ifndef _WIN32
+/// A minimal WebSocket client over a plain socket, for observing the handshake and the framing
+/// of the server's messages, which libwebsockets handles internally.
+class RawWebSocketClient {
+public:
+  explicit RawWebSocketClient(uint16_t port)
+      : fd_(socket(AF_INET, SOCK_STREAM, 0)) {
+    REQUIRE(fd_ >= 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(connect(fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+    timeval timeout{};
+    timeout.tv_sec = std::chrono::seconds(kTestTimeout).count();
+    REQUIRE(setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0);
+  }
+
+  RawWebSocketClient(const RawWebSocketClient&) = delete;
+  RawWebSocketClient(RawWebSocketClient&&) = delete;
+  RawWebSocketClient& operator=(const RawWebSocketClient&) = delete;
+  RawWebSocketClient& operator=(RawWebSocketClient&&) = delete;
+
+  ~RawWebSocketClient() {
+    close(fd_);
+  }
+
+  /// Sends an opening handshake offering the permessage-deflate extension, and returns the
+  /// server's response, up to the end of its headers.
+  std::string handshake() {
+    sendAll(
+      "GET / HTTP/1.1\r\n"
+      "Host: 127.0.0.1\r\n"
+      "Upgrade: websocket\r\n"
+      "Connection: Upgrade\r\n"
+      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+      "Sec-WebSocket-Version: 13\r\n"
+      "Sec-WebSocket-Protocol: foxglove.sdk.v1\r\n"
+      "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n"
+      "\r\n"
+    );
+    std::string response;
+    while (response.size() < 4 || response.compare(response.size() - 4, 4, "\r\n\r\n") != 0) {
+      response += readExact(1);
+    }
+    return response;
+  }
+
+  /// Sends a text message. Client frames must be masked; a zero mask leaves the payload as is.
+  void sendText(const std::string& text) {
+    REQUIRE(text.size() <= UINT16_MAX);
+    std::string frame = "\x81";
+    if (text.size() < 126) {
+      frame += static_cast<char>(0x80 | text.size());
+    } else {
+      frame += static_cast<char>(0x80 | 126);
+      frame += static_cast<char>(text.size() >> 8);
+      frame += static_cast<char>(text.size() & 0xff);
+    }
+    frame.append(4, '\0');
+    frame += text;
+    sendAll(frame);
+  }
+
+  struct Frame {
+    /// Whether the RSV1 bit is set, which marks a compressed message.
+    bool compressed;
+    uint8_t opcode;
+    std::string payload;
+  };
+
+  /// Receives a frame. The server's frames are not masked.
+  Frame recvFrame() {
+    auto header = readExact(2);
+    auto first = static_cast<uint8_t>(header[0]);
+    uint64_t len = static_cast<uint8_t>(header[1]) & 0x7f;
+    if (len >= 126) {
+      auto extended = readExact(len == 126 ? 2 : 8);
+      len = 0;
+      for (char byte : extended) {
+        len = (len << 8) | static_cast<uint8_t>(byte);
+      }
+    }
+    return {(first & 0x40) != 0, static_cast<uint8_t>(first & 0x0f), readExact(len)};
+  }
+
+private:
+  void sendAll(const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+      auto result = ::send(fd_, data.data() + sent, data.size() - sent, 0);
+      REQUIRE(result > 0);
+      sent += static_cast<size_t>(result);
+    }
+  }
+
+  std::string readExact(size_t len) {
+    std::string data(len, '\0');
+    size_t received = 0;
+    while (received < len) {
+      auto result = ::recv(fd_, data.data() + received, len - received, 0);
+      REQUIRE(result > 0);
+      received += static_cast<size_t>(result);
+    }
+    return data;
+  }
+
+  int fd_;
+};
+#endif
+
+#ifdef __linux__
+/// Returns the name of the calling thread, which Linux truncates to 15 characters.
+std::string currentThreadName() {
+  std::array<char, 16> name{};
+  REQUIRE(pthread_getname_np(pthread_self(), name.data(), name.size()) == 0);
+  return name.data();
+}
+#endif
+
 }  // namespace
 
 TEST_CASE("Start and stop server") {
@@ -296,6 +512,260 @@ TEST_CASE("Start and stop server") {
   REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
 }
 
+TEST_CASE("Server with writer threads serves clients on its own threads") {
+  auto context = foxglove::Context::create();
+  auto channel_result = foxglove::RawChannel::create("/test", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+
+  SubscriptionCounter subscriptions;
+  std::string subscribe_thread;
+  foxglove::WebSocketServerOptions options;
+  options.context = context;
+  options.name = "unit-test";
+  options.writer_threads = 2;
+  options.callbacks.onSubscribe = [&](uint64_t, const foxglove::ClientMetadata&) {
+#ifdef __linux__
+    // Client messages are handled by the client's task, which runs on the writer runtime.
+    subscribe_thread = currentThreadName();
+#endif
+    subscriptions.add();
+  };
+  auto server = startServer(std::move(options));
+
+  WebSocketClient client;
+  connectAndSubscribe(client, server.port(), {channel.id()});
+  subscriptions.waitFor(1);
+#ifdef __linux__
+  REQUIRE(subscribe_thread == "foxglove-ws-wri");
+#endif
+
+  std::string message = R"({"data": "foxglove"})";
+  channel.log(reinterpret_cast<const std::byte*>(message.data()), message.size());
+  auto received = client.filterRecv([](const std::string& payload) {
+    return parseMessageData(payload).has_value();
+  });
+  REQUIRE(received.has_value());
+  REQUIRE(parseMessageData(*received)->data == message);
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
+TEST_CASE("Backlog byte limits drop messages of the busy channel") {
+  auto context = foxglove::Context::create();
+  auto busy_result = foxglove::RawChannel::create("/busy", "json", std::nullopt, context);
+  auto& busy = requireValue(busy_result);
+  auto quiet_result = foxglove::RawChannel::create("/quiet", "json", std::nullopt, context);
+  auto& quiet = requireValue(quiet_result);
+
+  SubscriptionCounter subscriptions;
+  foxglove::WebSocketServerOptions options;
+  options.context = context;
+  options.name = "unit-test";
+  options.callbacks.onSubscribe = [&](uint64_t, const foxglove::ClientMetadata&) {
+    subscriptions.add();
+  };
+  SECTION("Message budget, keeping the latest message of each channel") {
+    options.message_backlog_bytes = 1024 * 1024;
+    options.backlog_drop_policy = foxglove::BacklogDropPolicy::KeepLatestPerChannel;
+  }
+  SECTION("Channel budget") {
+    options.channel_backlog_bytes = 1024 * 1024;
+  }
+  auto server = startServer(std::move(options));
+
+  WebSocketClient client;
+  connectAndSubscribe(client, server.port(), {busy.id(), quiet.id()});
+  subscriptions.waitFor(2);
+
+  // Log far more than the socket buffers and the budget hold while the client isn't reading.
+  constexpr size_t kBurst = 200;
+  constexpr size_t kMessageSize = 256 * 1024;
+  const std::string quiet_message = "quiet";
+  client.setReceiving(false);
+  for (size_t i = 0; i < kBurst; ++i) {
+    std::string message = std::to_string(i) + " ";
+    message.resize(kMessageSize, ' ');
+    busy.log(reinterpret_cast<const std::byte*>(message.data()), message.size());
+    if (i == kBurst / 2) {
+      quiet.log(reinterpret_cast<const std::byte*>(quiet_message.data()), quiet_message.size());
+    }
+  }
+  client.setReceiving(true);
+
+  // The quiet channel's message and the latest message of the busy channel are delivered.
+  bool received_quiet = false;
+  const std::string last_prefix = std::to_string(kBurst - 1) + " ";
+  auto last = client.filterRecv(
+    [&](const std::string& payload) {
+      auto message = parseMessageData(payload);
+      if (!message.has_value()) {
+        return false;
+      }
+      if (message->subscription_id == 2) {
+        received_quiet = message->data == quiet_message;
+        return false;
+      }
+      return message->data.compare(0, last_prefix.size(), last_prefix) == 0;
+    },
+    kTestTimeout
+  );
+  REQUIRE(last.has_value());
+  REQUIRE(received_quiet);
+
+  auto stats = server.stats();
+  REQUIRE(stats.has_value());
+  REQUIRE(stats->size() == 1);
+  const auto& channels = stats->front().channels;
+  auto channel_stats = [&](uint64_t channel_id) {
+    auto it = std::find_if(channels.begin(), channels.end(), [&](const auto& channel) {
+      return channel.channel_id == channel_id;
+    });
+    REQUIRE(it != channels.end());
+    return *it;
+  };
+  auto busy_stats = channel_stats(busy.id());
+  REQUIRE(busy_stats.sequence == kBurst);
+  REQUIRE(busy_stats.dropped > 0);
+  REQUIRE(busy_stats.sent + busy_stats.dropped == kBurst);
+  REQUIRE(channel_stats(quiet.id()).dropped == 0);
+  REQUIRE(stats->front().dropped == busy_stats.dropped);
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
+TEST_CASE("Rate-limited subscriptions deliver the latest message") {
+  auto context = foxglove::Context::create();
+  auto channel_result = foxglove::RawChannel::create("/test", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+
+  SubscriptionCounter subscriptions;
+  foxglove::WebSocketServerOptions options;
+  options.context = context;
+  options.name = "unit-test";
+  options.subscription_options.max_rate = 2.0;
+  options.subscription_options.conflate = true;
+  options.callbacks.onSubscribe = [&](uint64_t, const foxglove::ClientMetadata&) {
+    subscriptions.add();
+  };
+  auto server = startServer(std::move(options));
+
+  WebSocketClient client;
+  connectAndSubscribe(client, server.port(), {channel.id()});
+  subscriptions.waitFor(1);
+
+  // At most the first message is sent right away. The rest replace one another until the
+  // subscription's interval has passed.
+  constexpr int kMessages = 10;
+  for (int i = 0; i < kMessages; ++i) {
+    std::string message = std::to_string(i);
+    channel.log(reinterpret_cast<const std::byte*>(message.data()), message.size());
+  }
+
+  std::vector<std::string> received;
+  auto last = client.filterRecv(
+    [&](const std::string& payload) {
+      auto message = parseMessageData(payload);
+      if (!message.has_value()) {
+        return false;
+      }
+      received.push_back(message->data);
+      return message->data == std::to_string(kMessages - 1);
+    },
+    kTestTimeout
+  );
+  REQUIRE(last.has_value());
+  REQUIRE(received.size() <= 2);
+
+  auto stats = server.stats();
+  REQUIRE(stats.has_value());
+  REQUIRE(stats->size() == 1);
+  REQUIRE(stats->front().channels.size() == 1);
+  const auto& channel_stats = stats->front().channels.front();
+  REQUIRE(channel_stats.sent == received.size());
+  REQUIRE(channel_stats.conflated == kMessages - received.size());
+  REQUIRE(channel_stats.dropped == 0);
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
+// The handshake is checked with a plain socket client, which is only implemented for Unix.
+#ifndef _WIN32
+TEST_CASE("Compression negotiates permessage-deflate for the filtered channels") {
+  auto context = foxglove::Context::create();
+  auto data_result = foxglove::RawChannel::create("/data", "json", std::nullopt, context);
+  auto& data = requireValue(data_result);
+  auto video_result = foxglove::RawChannel::create("/video", "json", std::nullopt, context);
+  auto& video = requireValue(video_result);
+
+  SubscriptionCounter subscriptions;
+  foxglove::WebSocketServerOptions options;
+  options.context = context;
+  options.name = "unit-test";
+  options.compression = true;
+  options.compression_filter = [](const foxglove::ChannelDescriptor& channel) -> bool {
+    return channel.topic() != "/video";
+  };
+  options.callbacks.onSubscribe = [&](uint64_t, const foxglove::ClientMetadata&) {
+    subscriptions.add();
+  };
+  auto server = startServer(std::move(options));
+
+  RawWebSocketClient client(server.port());
+  auto response = client.handshake();
+  REQUIRE_THAT(response, StartsWith("HTTP/1.1 101"));
+  REQUIRE_THAT(
+    response,
+    ContainsSubstring("sec-websocket-extensions: permessage-deflate", Catch::CaseSensitive::No)
+  );
+
+  Json subscription_list = Json::array();
+  subscription_list.push_back({{"id", 1}, {"channelId", data.id()}});
+  subscription_list.push_back({{"id", 2}, {"channelId", video.id()}});
+  client.sendText(Json{{"op", "subscribe"}, {"subscriptions", subscription_list}}.dump());
+  subscriptions.waitFor(2);
+
+  // Messages of the filtered-out channel are sent as is; the others are compressed.
+  auto recv_message_data = [&] {
+    while (true) {
+      auto frame = client.recvFrame();
+      if (frame.opcode == 0x2) {
+        return frame;
+      }
+    }
+  };
+  std::string message(1024, 'x');
+  video.log(reinterpret_cast<const std::byte*>(message.data()), message.size());
+  data.log(reinterpret_cast<const std::byte*>(message.data()), message.size());
+
+  auto video_frame = recv_message_data();
+  REQUIRE_FALSE(video_frame.compressed);
+  auto video_message = parseMessageData(video_frame.payload);
+  REQUIRE(video_message.has_value());
+  REQUIRE(video_message->subscription_id == 2);
+  REQUIRE(video_message->data == message);
+
+  auto data_frame = recv_message_data();
+  REQUIRE(data_frame.compressed);
+  REQUIRE(data_frame.payload.size() < message.size());
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
+TEST_CASE("Server without compression declines permessage-deflate") {
+  foxglove::WebSocketServerOptions options;
+  options.context = foxglove::Context::create();
+  options.name = "unit-test";
+  auto server = startServer(std::move(options));
+
+  RawWebSocketClient client(server.port());
+  auto response = client.handshake();
+  REQUIRE_THAT(response, StartsWith("HTTP/1.1 101"));
+  REQUIRE_THAT(response, !ContainsSubstring("permessage-deflate"));
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+#endif
+
 TEST_CASE("name is not valid utf-8") {
   foxglove::WebSocketServerOptions options;
   options.name = "\x80\x80\x80\x80";
@@ -435,6 +905,50 @@ TEST_CASE("Capability enums") {
     toUnderlying(foxglove::WebSocketServerCapabilities::Services) ==
     (FOXGLOVE_SERVER_CAPABILITY_SERVICES)
   );
+  REQUIRE(
+    toUnderlying(foxglove::WebSocketServerCapabilities::FieldProjection) ==
+    (FOXGLOVE_SERVER_CAPABILITY_FIELD_PROJECTION)
+  );
+}
+
+TEST_CASE("Field projection sends only the requested fields") {
+  auto context = foxglove::Context::create();
+  auto channel_result = foxglove::RawChannel::create("/pose", "json", std::nullopt, context);
+  auto& channel = requireValue(channel_result);
+
+  SubscriptionCounter subscriptions;
+  foxglove::WebSocketServerOptions options;
+  options.context = context;
+  options.name = "unit-test";
+  options.capabilities = foxglove::WebSocketServerCapabilities::FieldProjection;
+  options.callbacks.onSubscribe = [&](uint64_t, const foxglove::ClientMetadata&) {
+    subscriptions.add();
+  };
+  auto server = startServer(std::move(options));
+
+  WebSocketClient client;
+  client.start(server.port());
+  client.waitForConnection();
+  auto server_info = client.filterRecv([](const std::string& payload) {
+    return Json::parse(payload).value("op", "") == "serverInfo";
+  });
+  REQUIRE(server_info.has_value());
+  auto capabilities = Json::parse(*server_info)["capabilities"];
+  REQUIRE(std::count(capabilities.begin(), capabilities.end(), "fieldProjection") == 1);
+
+  Json subscription = {{"id", 1}, {"channelId", channel.id()}, {"fields", Json::array({"frame_id"})}};
+  client.send(Json{{"op", "subscribeFields"}, {"subscriptions", Json::array({subscription})}}.dump());
+  subscriptions.waitFor(1);
+
+  std::string message = R"({"frame_id": "map", "position": {"x": 1}})";
+  channel.log(reinterpret_cast<const std::byte*>(message.data()), message.size());
+  auto received = client.filterRecv([](const std::string& payload) {
+    return parseMessageData(payload).has_value();
+  });
+  REQUIRE(received.has_value());
+  REQUIRE(Json::parse(parseMessageData(*received)->data) == Json{{"frame_id", "map"}});
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
 }
 
 TEST_CASE("Client advertise/publish callbacks") {
@@ -559,6 +1073,140 @@ TEST_CASE("Client advertise/publish callbacks") {
   REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
 }
 
+TEST_CASE("Client publish with owned message buffers") {
+  auto context = foxglove::Context::create();
+  std::mutex mutex;
+  std::condition_variable cv;
+  // the following variables are protected by the mutex:
+  bool advertised = false;
+  bool borrowed_message = false;
+  std::optional<foxglove::ClientMessageBuffer> owned_message;
+
+  foxglove::WebSocketServerCallbacks callbacks;
+  callbacks.onClientAdvertise = [&](uint32_t, const foxglove::ClientChannel&) {
+    std::scoped_lock lock{mutex};
+    advertised = true;
+    cv.notify_all();
+  };
+  callbacks.onMessageData = [&](uint32_t, uint32_t, const std::byte*, size_t) {
+    std::scoped_lock lock{mutex};
+    borrowed_message = true;
+  };
+  callbacks.onMessageDataOwned = [&](uint32_t, uint32_t, foxglove::ClientMessageBuffer data) {
+    std::scoped_lock lock{mutex};
+    owned_message.emplace(std::move(data));
+    cv.notify_all();
+  };
+  auto server = startServer(
+    context, foxglove::WebSocketServerCapabilities::ClientPublish, std::move(callbacks), {"json"}
+  );
+
+  // Acquired after `server` so it is released before the server's destructor runs.
+  std::unique_lock lock{mutex};
+
+  WebSocketClient client;
+  client.start(server.port());
+  client.waitForConnection();
+  auto parsed = Json::parse(client.recv());
+  REQUIRE(parsed["op"] == "serverInfo");
+
+  client.send(
+    R"({
+      "op": "advertise",
+      "channels": [{ "id": 100, "topic": "topic", "encoding": "json", "schemaName": "schema" }]
+    })"
+  );
+  REQUIRE(cv.wait_for(lock, kTestTimeout, [&] {
+    return advertised;
+  }));
+
+  std::array<char, 8> msg = {1, 100, 0, 0, 0, 'a', 'b', 'c'};
+  client.send(msg.data(), msg.size());
+  REQUIRE(cv.wait_for(lock, kTestTimeout, [&] {
+    return owned_message.has_value();
+  }));
+  // onMessageData is not invoked when onMessageDataOwned is set.
+  REQUIRE(!borrowed_message);
+
+  // The buffer remains valid after the callback has returned, and after being moved.
+  foxglove::ClientMessageBuffer buffer = std::move(*owned_message);
+  owned_message.reset();
+  REQUIRE(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()) == "abc");
+
+  lock.unlock();
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
+TEST_CASE("Polled callbacks are invoked by pollEvents") {
+  auto context = foxglove::Context::create();
+  // Only accessed from the test thread, since callbacks are polled.
+  const auto test_thread = std::this_thread::get_id();
+  std::vector<std::string> events;
+  bool other_thread = false;
+  auto record = [&](std::string event) {
+    other_thread = other_thread || std::this_thread::get_id() != test_thread;
+    events.push_back(std::move(event));
+  };
+
+  foxglove::WebSocketServerOptions options;
+  options.context = context;
+  options.name = "unit-test";
+  options.capabilities = foxglove::WebSocketServerCapabilities::ClientPublish;
+  options.supported_encodings = {"json"};
+  options.poll_callbacks = true;
+  options.callbacks.onClientConnect = [&]() {
+    record("connect");
+  };
+  options.callbacks.onClientAdvertise = [&](uint32_t, const foxglove::ClientChannel& channel) {
+    record("advertise " + std::string(channel.topic) + " " + std::string(channel.schema_name));
+  };
+  options.callbacks.onMessageData = [&](uint32_t, uint32_t, const std::byte* data, size_t len) {
+    record("message " + std::string(reinterpret_cast<const char*>(data), len));
+  };
+  auto server = startServer(std::move(options));
+
+  auto poll_until = [&](size_t count, size_t max_events) {
+    auto deadline = std::chrono::steady_clock::now() + kTestTimeout;
+    while (events.size() < count && std::chrono::steady_clock::now() < deadline) {
+      REQUIRE(server.pollEvents(max_events) <= max_events);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  };
+
+  WebSocketClient client;
+  client.start(server.port());
+  client.waitForConnection();
+  auto parsed = Json::parse(client.recv());
+  REQUIRE(parsed["op"] == "serverInfo");
+
+  client.send(
+    R"({
+      "op": "advertise",
+      "channels": [{ "id": 100, "topic": "topic", "encoding": "json", "schemaName": "schema" }]
+    })"
+  );
+  std::array<char, 8> msg = {1, 100, 0, 0, 0, 'a', 'b', 'c'};
+  client.send(msg.data(), msg.size());
+  poll_until(3, std::numeric_limits<size_t>::max());
+  REQUIRE_THAT(
+    events,
+    Equals(std::vector<std::string>{"connect", "advertise topic schema", "message abc"})
+  );
+
+  // Events are delivered in order, at most max_events at a time.
+  msg[5] = 'x';
+  client.send(msg.data(), msg.size());
+  msg[5] = 'y';
+  client.send(msg.data(), msg.size());
+  poll_until(5, 1);
+  REQUIRE(events.size() == 5);
+  REQUIRE(events[3] == "message xbc");
+  REQUIRE(events[4] == "message ybc");
+  REQUIRE(!other_thread);
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
 TEST_CASE("Parameter callbacks") {
   std::mutex mutex;
   std::condition_variable cv;
@@ -1272,6 +1920,54 @@ TEST_CASE("Parameter subscription callbacks") {
   REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
 }
 
+TEST_CASE("Parameter values published in a burst are coalesced") {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool subscribed = false;
+  foxglove::WebSocketServerCallbacks callbacks;
+  callbacks.onParametersSubscribe = [&](const std::vector<std::string_view>& /*names*/) {
+    std::scoped_lock lock{mutex};
+    subscribed = true;
+    cv.notify_one();
+  };
+
+  foxglove::WebSocketServerOptions options;
+  options.context = foxglove::Context::create();
+  options.name = "unit-test";
+  options.capabilities = foxglove::WebSocketServerCapabilities::Parameters;
+  options.callbacks = std::move(callbacks);
+  options.parameter_coalesce_window = std::chrono::milliseconds(50);
+  auto server = startServer(std::move(options));
+
+  WebSocketClient client;
+  client.start(server.port());
+  client.waitForConnection();
+  REQUIRE(Json::parse(client.recv())["op"] == "serverInfo");
+
+  client.send(R"({"op": "subscribeParameterUpdates", "parameterNames": ["foo"]})");
+  {
+    std::unique_lock lock{mutex};
+    REQUIRE(cv.wait_for(lock, kTestTimeout, [&] {
+      return subscribed;
+    }));
+  }
+
+  for (int64_t i = 0; i < 10; ++i) {
+    std::vector<foxglove::Parameter> params;
+    params.emplace_back("foo", i);
+    server.publishParameterValues(std::move(params));
+  }
+
+  auto parsed = Json::parse(client.recv());
+  auto expected = Json::parse(R"({
+      "op": "parameterValues",
+      "parameters": [{ "name": "foo", "value": 9 }]
+    })");
+  REQUIRE(parsed == expected);
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
 TEST_CASE("Publish a connection graph") {
   auto context = foxglove::Context::create();
   auto server = startServer(context, foxglove::WebSocketServerCapabilities::ConnectionGraph);
@@ -1282,6 +1978,45 @@ TEST_CASE("Publish a connection graph") {
   server.publishConnectionGraph(graph);
 }
 
+TEST_CASE("Connection graph patches published in a burst are coalesced") {
+  foxglove::WebSocketServerOptions options;
+  options.context = foxglove::Context::create();
+  options.name = "unit-test";
+  options.capabilities = foxglove::WebSocketServerCapabilities::ConnectionGraph;
+  options.connection_graph_coalesce_window = std::chrono::milliseconds(50);
+  auto server = startServer(std::move(options));
+
+  WebSocketClient client;
+  client.start(server.port());
+  client.waitForConnection();
+  REQUIRE(Json::parse(client.recv())["op"] == "serverInfo");
+
+  client.send(R"({"op": "subscribeConnectionGraph"})");
+  REQUIRE(Json::parse(client.recv())["op"] == "connectionGraphUpdate");
+
+  for (int i = 0; i < 10; ++i) {
+    foxglove::ConnectionGraphPatch patch;
+    REQUIRE(
+      patch.setPublishedTopic("topic", {"publisher" + std::to_string(i)}) ==
+      foxglove::FoxgloveError::Ok
+    );
+    REQUIRE(server.updateConnectionGraph(std::move(patch)) == foxglove::FoxgloveError::Ok);
+  }
+
+  auto parsed = Json::parse(client.recv());
+  auto expected = Json::parse(R"({
+      "op": "connectionGraphUpdate",
+      "publishedTopics": [{ "name": "topic", "publisherIds": ["publisher9"] }],
+      "subscribedTopics": [],
+      "advertisedServices": [],
+      "removedTopics": [],
+      "removedServices": []
+    })");
+  REQUIRE(parsed == expected);
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
 std::vector<std::byte> makeBytes(std::string_view sv) {
   const auto* data = reinterpret_cast<const std::byte*>(sv.data());
   return {data, data + sv.size()};
@@ -1539,6 +2274,100 @@ TEST_CASE("Service callbacks") {
   REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
 }
 
+TEST_CASE("Service calls on worker threads within an in-flight limit") {
+  std::mutex mutex;
+  std::condition_variable cv;
+  // the following variables are protected by the mutex:
+  std::vector<uint32_t> slow_calls;
+  bool release = false;
+  bool cancelled = false;
+
+  auto context = foxglove::Context::create();
+  auto server = startServer(context, foxglove::WebSocketServerCapabilities::Services, {}, {"json"});
+
+  // Register a service whose handler blocks until released.
+  foxglove::ServiceSchema slow_schema{"slow schema"};
+  foxglove::ServiceHandler slow_handler(
+    [&](const foxglove::ServiceRequest& request, foxglove::ServiceResponder&& responder) {
+      std::unique_lock lock{mutex};
+      slow_calls.push_back(request.call_id);
+      cv.notify_all();
+      cv.wait(lock, [&] {
+        return release;
+      });
+      cancelled = cancelled || responder.isCancelled();
+      std::move(responder).respondOk(request.payload);
+    }
+  );
+  foxglove::ServiceOptions slow_options;
+  slow_options.worker_threads = 2;
+  slow_options.max_in_flight = 1;
+  auto service = foxglove::Service::create("/slow", slow_schema, slow_handler, slow_options);
+  REQUIRE(service.has_value());
+  REQUIRE(server.addService(std::move(*service)) == foxglove::FoxgloveError::Ok);
+
+  // Register an echo service, invoked from the client's poll loop.
+  foxglove::ServiceSchema echo_schema{"echo schema"};
+  foxglove::ServiceHandler echo_handler(
+    [&](const foxglove::ServiceRequest& request, foxglove::ServiceResponder&& responder) {
+      std::move(responder).respondOk(request.payload);
+    }
+  );
+  service = foxglove::Service::create("/echo", echo_schema, echo_handler);
+  REQUIRE(service.has_value());
+  REQUIRE(server.addService(std::move(*service)) == foxglove::FoxgloveError::Ok);
+
+  WebSocketClient client;
+  client.start(server.port());
+  client.waitForConnection();
+
+  auto parsed = Json::parse(client.recv());
+  REQUIRE(parsed["op"] == "serverInfo");
+  std::map<std::string, uint32_t> service_ids;
+  while (service_ids.size() < 2) {
+    parsed = Json::parse(client.recv());
+    REQUIRE(parsed["op"] == "advertiseServices");
+    for (const auto& parsed_service : parsed["services"]) {
+      std::string name(parsed_service["name"]);
+      service_ids[name] = parsed_service["id"];
+    }
+  }
+
+  // Make two calls to the slow service. Only the first is dispatched while it blocks.
+  auto request_payload = makeBytes(R"({"hello": "there"})");
+  auto first_request = makeServiceRequest(service_ids["/slow"], 1, "json", request_payload);
+  client.send(first_request);
+  auto second_request = makeServiceRequest(service_ids["/slow"], 2, "json", request_payload);
+  client.send(second_request);
+  {
+    std::unique_lock lock{mutex};
+    REQUIRE(cv.wait_for(lock, kTestTimeout, [&] {
+      return !slow_calls.empty();
+    }));
+  }
+
+  // The blocked handler doesn't hold up other calls from the client.
+  auto echo_request = makeServiceRequest(service_ids["/echo"], 3, "json", request_payload);
+  client.send(echo_request);
+  validateServiceResponse(client.recv(), service_ids["/echo"], 3, "json", request_payload);
+  {
+    std::scoped_lock lock{mutex};
+    REQUIRE(slow_calls == std::vector<uint32_t>{1});
+    release = true;
+  }
+  cv.notify_all();
+
+  validateServiceResponse(client.recv(), service_ids["/slow"], 1, "json", request_payload);
+  validateServiceResponse(client.recv(), service_ids["/slow"], 2, "json", request_payload);
+  {
+    std::scoped_lock lock{mutex};
+    REQUIRE(slow_calls == std::vector<uint32_t>{1, 2});
+    REQUIRE(!cancelled);
+  }
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
 void validateFetchAssetOkResponse(
   const std::string_view response, uint32_t request_id, const std::vector<std::byte>& payload
 ) {
@@ -1610,6 +2439,43 @@ TEST_CASE("Fetch asset callback") {
   REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
 }
 
+TEST_CASE("Fetch asset responses are assembled from chunks and cached") {
+  std::atomic<int> calls = 0;
+
+  foxglove::WebSocketServerOptions options;
+  options.context = foxglove::Context::create();
+  options.name = "unit-test";
+  options.fetch_asset_cache_bytes = 1024;
+  options.fetch_asset = [&](std::string_view, foxglove::FetchAssetResponder&& responder) {
+    ++calls;
+    auto head = makeBytes("da");
+    auto tail = makeBytes("ta");
+    responder.append(head.data(), head.size());
+    responder.append(tail.data(), tail.size());
+    std::move(responder).finish();
+  };
+  auto server = startServer(std::move(options));
+
+  WebSocketClient client;
+  client.start(server.port());
+  client.waitForConnection();
+
+  auto parsed = Json::parse(client.recv());
+  REQUIRE(parsed["op"] == "serverInfo");
+
+  // The second request is answered from the cache, without invoking the handler.
+  for (uint32_t request_id : {1U, 2U}) {
+    Json request = {
+      {"op", "fetchAsset"}, {"uri", "package://foo/robot.urdf"}, {"requestId", request_id}
+    };
+    client.send(request.dump());
+    validateFetchAssetOkResponse(client.recv(), request_id, makeBytes("data"));
+  }
+  REQUIRE(calls == 1);
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
 void validateFetchAssetErrorResponse(
   const std::string_view response, uint32_t request_id, std::string_view error_message
 ) {
@@ -1624,6 +2490,41 @@ void validateFetchAssetErrorResponse(
   REQUIRE(memcmp(response.data() + 10, error_message.data(), error_message.size()) == 0);
 }
 
+TEST_CASE("Built-in file asset handler serves files from allowed directories") {
+  auto directory = std::filesystem::temp_directory_path();
+  auto name = "test_file_asset_" + std::to_string(std::random_device{}()) + ".urdf";
+  FileCleanup file((directory / name).string());
+  std::ofstream(file.path()) << "<robot/>";
+
+  auto handler = foxglove::fileAssetHandler({{"package://test/", directory.string()}});
+  REQUIRE(handler.has_value());
+
+  foxglove::WebSocketServerOptions options;
+  options.context = foxglove::Context::create();
+  options.name = "unit-test";
+  options.fetch_asset = std::move(*handler);
+  auto server = startServer(std::move(options));
+
+  WebSocketClient client;
+  client.start(server.port());
+  client.waitForConnection();
+
+  auto parsed = Json::parse(client.recv());
+  REQUIRE(parsed["op"] == "serverInfo");
+
+  Json request = {{"op", "fetchAsset"}, {"uri", "package://test/" + name}, {"requestId", 1}};
+  client.send(request.dump());
+  validateFetchAssetOkResponse(client.recv(), 1, makeBytes("<robot/>"));
+
+  request = {{"op", "fetchAsset"}, {"uri", "package://test/../" + name}, {"requestId", 2}};
+  client.send(request.dump());
+  validateFetchAssetErrorResponse(
+    client.recv(), 2, "Asset URI not allowed: package://test/../" + name
+  );
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
 TEST_CASE("Fetch asset error") {
   std::mutex mutex;
   std::condition_variable cv;
@@ -1814,6 +2715,48 @@ TEST_CASE("Clear session") {
   REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
 }
 
+TEST_CASE("Client stats") {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool client_connected = false;
+
+  auto context = foxglove::Context::create();
+
+  foxglove::WebSocketServerOptions options;
+  options.context = context;
+  options.name = "unit-test";
+  options.callbacks.onClientConnect = [&]() {
+    std::scoped_lock lock{mutex};
+    client_connected = true;
+    cv.notify_one();
+  };
+  options.callbacks.onBackpressure = [](const foxglove::ClientStats&) {};
+  auto server = startServer(std::move(options));
+
+  auto stats = server.stats();
+  REQUIRE(stats.has_value());
+  REQUIRE(stats->empty());
+
+  WebSocketClient client;
+  client.start(server.port());
+  client.waitForConnection();
+  {
+    std::unique_lock lock{mutex};
+    auto wait_result = cv.wait_for(lock, kTestTimeout, [&] {
+      return client_connected;
+    });
+    REQUIRE(wait_result);
+  }
+
+  stats = server.stats();
+  REQUIRE(stats.has_value());
+  REQUIRE(stats->size() == 1);
+  REQUIRE(stats->front().dropped == 0);
+  REQUIRE(stats->front().channels.empty());
+
+  REQUIRE(server.stop() == foxglove::FoxgloveError::Ok);
+}
+
 TEST_CASE("Initial session id") {
   auto context = foxglove::Context::create();
 
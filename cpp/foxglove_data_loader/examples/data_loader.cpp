@@ -194,15 +194,8 @@ std::optional<Result<Message>> TextMessageIterator::next() {
           reinterpret_cast<const char*>(&(data_loader->files[line.file][line.start])),
           line.end - line.start
         );
-        size_t encoded_len = 0;
-
-        auto result =
-          message.encode(last_encoded_message.data(), last_encoded_message.size(), &encoded_len);
-        if (result == foxglove::FoxgloveError::BufferTooShort) {
-          last_encoded_message.resize(encoded_len);
-          result =
-            message.encode(last_encoded_message.data(), last_encoded_message.size(), &encoded_len);
-        }
+        last_encoded_message.clear();
+        auto result = message.encode(last_encoded_message);
         if (result != foxglove::FoxgloveError::Ok) {
           error("failed to encode message:", foxglove::strerror(result));
           return Result<Message>{.error = "failed to encode message"};
@@ -217,7 +210,7 @@ std::optional<Result<Message>> TextMessageIterator::next() {
               .data =
                 BytesView{
                   .ptr = last_encoded_message.data(),
-                  .len = encoded_len,
+                  .len = last_encoded_message.size(),
                 }
             }
         };
@@ -1,6 +1,8 @@
 #ifndef FOXGLOVE_DATA_LOADER_HPP
 #define FOXGLOVE_DATA_LOADER_HPP
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -126,6 +128,37 @@ struct Message {
   BytesView data;
 };
 
+/** A range of one of the input files. */
+struct FileRange {
+  /** The index of the file in `DataLoaderArgs::paths`. */
+  uint32_t file;
+  /** The offset of the range from the start of the file. */
+  uint64_t offset;
+  /** The length of the range in bytes. */
+  uint64_t len;
+};
+
+/** A message whose data may be left in the input file for the host to read, yielded by
+ * `next_batch_refs()`.
+ */
+struct MessageRef {
+  ChannelId channel_id;
+  /** The time when this message was logged to the file. */
+  TimeNanos log_time;
+  /** The time when this message was published by its source.
+   * If not known, set this to log_time.
+   * */
+  TimeNanos publish_time;
+  /** The serialized message data, if `file_range` is empty. The underlying pointer must remain
+   * valid as for `next_batch()`.
+   */
+  BytesView data;
+  /** If set, the serialized message data is stored verbatim in this range of an input file, which
+   * the host reads itself, and `data` is ignored.
+   */
+  std::optional<FileRange> file_range;
+};
+
 struct MessageIteratorArgs {
   /** Yield only messages with these channel IDs. */
   std::vector<ChannelId> channel_ids;
@@ -143,11 +176,39 @@ struct BackfillArgs {
   std::vector<ChannelId> channel_ids;
 };
 
+/** An entry of a seek index, mapping a log time to the position in a file from which messages
+ * logged at or after that time can be read.
+ */
+struct IndexEntry {
+  /** The index of the file in `DataLoaderArgs::paths`. */
+  uint32_t file;
+  TimeNanos log_time;
+  /** The offset from the start of the file at which to start reading. */
+  uint64_t offset;
+};
+
+/** Returns the offset from which to read the messages in `file` logged at or after `time`: the
+ * offset of the latest entry for `file` with a log time at or before `time`. Returns std::nullopt
+ * if the index has no such entry, in which case the file must be read from the beginning.
+ */
+std::optional<uint64_t> find_index_offset(
+  const std::vector<IndexEntry>& index, uint32_t file, TimeNanos time
+);
+
 struct DataLoaderArgs {
   /** The set of files that this data loader should return messages from. */
   std::vector<std::string> paths;
 };
 
+/** A range of a file to read with `Reader::read_ranges()`. */
+struct ReadRange {
+  /** The offset from the start of the file to read from. */
+  uint64_t offset;
+  /** The buffer to read into, which must hold at least `len` bytes. */
+  uint8_t* target;
+  size_t len;
+};
+
 /**
  * A file reader resource. This API does not provide I/O errors to the data loader,
  * these are handled by the host.
@@ -170,8 +231,32 @@ public:
   /** read up to `len` bytes into `target`, returning the number of bytes successfully read.
    */
   uint64_t read(uint8_t* target, size_t len);
+  /** Read several ranges of the file in a single call to the host, returning the number of bytes
+   * read into each range's target. The cursor position is unchanged.
+   *
+   * The host may coalesce adjacent ranges and fetch them in parallel, which is much faster than
+   * seeking and reading each range in turn, particularly for remote files.
+   */
+  std::vector<uint64_t> read_ranges(const std::vector<ReadRange>& ranges);
+  /** Hint that `len` bytes starting at `offset` will be read soon, so that the host can start
+   * fetching them.
+   */
+  void prefetch(uint64_t offset, uint64_t len);
+};
+
+/** A compression format which the host can decompress with `decompress()`. */
+enum class Compression : uint8_t {
+  Zstd,
+  /** The lz4 frame format. */
+  Lz4,
 };
 
+/** Decompresses `data` into `target`, which has room for `len` bytes, using the host's
+ * implementation of the codec. Returns the number of bytes written, or an error if the data is
+ * invalid or its decompressed size exceeds `len`.
+ */
+Result<size_t> decompress(Compression compression, BytesView data, uint8_t* target, size_t len);
+
 /** Logs an info-level diagnostic message to the console. */
 void console_log(const char* msg);
 
@@ -190,7 +275,32 @@ public:
    * std::nullopt indicates that no more messages can be read.
    * */
   virtual std::optional<Result<Message>> next() = 0;
+  /** Return up to `max_messages` results from the set of files being read, stopping early once the
+   * data of the returned messages reaches `max_bytes`. An empty batch indicates that no more
+   * messages can be read.
+   *
+   * The host fetches messages in batches to reduce the number of calls into the data loader, which
+   * dominate load time for files with many small messages. Unlike `next()`, the data of every
+   * message in the batch must remain valid until the next call to `next()` or `next_batch()`.
+   *
+   * The default implementation calls `next()` until the batch is full, copying the data of each
+   * message before the following call may invalidate it. Override this if your iterator can keep
+   * the data of several messages valid at once, to avoid the copy.
+   */
+  virtual std::vector<Result<Message>> next_batch(size_t max_messages, size_t max_bytes);
+  /** Like `next_batch()`, but the data of a message which is stored verbatim in an input file may
+   * be returned as its `file_range`. The host then reads the data from the file itself, rather than
+   * copying it out of the data loader's memory, which saves a copy of every payload for formats with
+   * large messages such as images. `max_bytes` counts the data of messages of both kinds.
+   *
+   * The default implementation returns the messages of `next_batch()`, with their data in memory.
+   */
+  virtual std::vector<Result<MessageRef>> next_batch_refs(size_t max_messages, size_t max_bytes);
   virtual ~AbstractMessageIterator() {};
+
+private:
+  /** Message data copied by the default `next_batch()`. */
+  std::vector<std::vector<uint8_t>> batch_data;
 };
 
 class AbstractDataLoader {
@@ -208,9 +318,87 @@ public:
    * within a recording.
    */
   virtual Result<std::vector<Message>> get_backfill(const BackfillArgs& args);
+  /** Build a seek index over the input files, so that iterators can start near
+   * `MessageIteratorArgs::start_time` (see `find_index_offset()`) instead of reading the files from
+   * the beginning. This is called once after `initialize()`.
+   *
+   * The host caches the index per file, keyed by size and modification time, and passes it to
+   * `load_index()` instead of calling this method when the same files are loaded again. The default
+   * implementation returns an empty index. You may implement this to speed up seeking within
+   * formats that have no index of their own.
+   */
+  virtual Result<std::vector<IndexEntry>> build_index();
+  /** Receive an index returned by an earlier `build_index()` call on the same files. The default
+   * implementation ignores it.
+   */
+  virtual void load_index(const std::vector<IndexEntry>& index);
+  /** Return true to allow the host to drive several iterators concurrently, e.g. one per file or
+   * time slice, and merge their messages by log time. Only do so if iterators share no mutable
+   * state with each other or with `get_backfill()`. The default implementation returns false.
+   */
+  virtual bool supports_concurrent_iterators() const;
   virtual ~AbstractDataLoader() {}
 };
 
+/** Merges several iterators, each yielding messages in log_time order, into one iterator in
+ * log_time order. Use this to read each of `DataLoaderArgs::paths`, or each time slice of a file,
+ * with a separate iterator.
+ *
+ * A message's source iterator is only advanced on the following call to `next()`, so message data
+ * stays valid for as long as the source iterator guarantees.
+ */
+class MergedMessageIterator : public AbstractMessageIterator {
+public:
+  explicit MergedMessageIterator(std::vector<std::unique_ptr<AbstractMessageIterator>> iterators);
+  std::optional<Result<Message>> next() override;
+
+private:
+  struct Head {
+    Message message;
+    size_t iterator;
+  };
+  std::vector<std::unique_ptr<AbstractMessageIterator>> iterators;
+  /** The next message of each active iterator, as a min-heap ordered by log_time. */
+  std::vector<Head> heads;
+  /** Iterators that must be advanced before the next message can be chosen. */
+  std::vector<size_t> to_advance;
+};
+
+/** A generic implementation of `AbstractDataLoader::get_backfill()`.
+ *
+ * Record each message your iterators yield with `record()`. For every channel, the index keeps the
+ * first and last log times of recorded messages within each `stride` interval. A backfill request
+ * then creates an iterator for each requested channel that covers at most one interval, ending at
+ * the requested time, rather than scanning the files.
+ *
+ * Only recorded messages are considered, so backfill is complete for the time ranges your
+ * iterators have already covered, which is typically the whole file after the first playthrough.
+ */
+class BackfillIndex {
+public:
+  /** Creates an index with the given interval between checkpoints, in nanoseconds. */
+  explicit BackfillIndex(TimeNanos stride = 1'000'000'000);
+
+  /** Records a message yielded by one of your iterators. */
+  void record(const Message& message);
+
+  /** Answers a backfill request by creating iterators on `loader`. The data of the returned
+   * messages remains valid until the next call.
+   */
+  Result<std::vector<Message>> get_backfill(AbstractDataLoader& loader, const BackfillArgs& args);
+
+private:
+  struct Checkpoint {
+    TimeNanos first_log_time;
+    TimeNanos last_log_time;
+  };
+  TimeNanos stride;
+  /** Checkpoints per channel, keyed by interval number (log_time / stride). */
+  std::map<ChannelId, std::map<TimeNanos, Checkpoint>> checkpoints;
+  /** Data of the messages returned by the last get_backfill() call. */
+  std::vector<std::vector<uint8_t>> backfill_data;
+};
+
 }  // namespace foxglove_data_loader
 
 /** Constructs a new data loader for the given arguments.
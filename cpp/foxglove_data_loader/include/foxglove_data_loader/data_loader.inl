@@ -62,6 +62,53 @@ uint64_t Reader::read(uint8_t* into, size_t len) {
   return foxglove_loader_reader_method_reader_read(reader, &target);
 }
 
+std::vector<uint64_t> Reader::read_ranges(const std::vector<ReadRange>& ranges) {
+  foxglove_loader_reader_borrow_reader_t reader;
+  reader.__handle = this->handle;
+  std::vector<foxglove_loader_reader_read_range_t> host_ranges(ranges.size());
+  for (size_t i = 0; i < ranges.size(); i++) {
+    host_ranges[i].offset = ranges[i].offset;
+    host_ranges[i].ptr = (uint32_t)(uintptr_t)ranges[i].target;
+    host_ranges[i].len = (uint32_t)ranges[i].len;
+  }
+  foxglove_loader_reader_list_read_range_t list;
+  list.ptr = host_ranges.data();
+  list.len = host_ranges.size();
+  host_list_u64_t lens;
+  foxglove_loader_reader_method_reader_read_ranges(reader, &list, &lens);
+  std::vector<uint64_t> result(lens.ptr, lens.ptr + lens.len);
+  host_list_u64_free(&lens);
+  return result;
+}
+
+void Reader::prefetch(uint64_t offset, uint64_t len) {
+  foxglove_loader_reader_borrow_reader_t reader;
+  reader.__handle = this->handle;
+  foxglove_loader_reader_method_reader_prefetch(reader, offset, len);
+}
+
+Result<size_t> foxglove_data_loader::decompress(
+  Compression compression, BytesView data, uint8_t* target, size_t len
+) {
+  host_list_u8_t host_data;
+  host_data.ptr = const_cast<uint8_t*>(data.ptr);
+  host_data.len = data.len;
+  host_list_u8_t host_target;
+  host_target.ptr = target;
+  host_target.len = len;
+  uint64_t written = 0;
+  host_string_t err;
+  if (!foxglove_loader_codec_decompress(
+        static_cast<foxglove_loader_codec_compression_t>(compression), &host_data, &host_target,
+        &written, &err
+      )) {
+    std::string message(reinterpret_cast<const char*>(err.ptr), err.len);
+    host_string_free(&err);
+    return Result<size_t>::error_with_message(std::move(message));
+  }
+  return Result<size_t>{.value = static_cast<size_t>(written)};
+}
+
 extern void exports_foxglove_loader_loader_message_iterator_destructor(
   exports_foxglove_loader_loader_message_iterator_t* rep
 ) {
@@ -74,19 +121,12 @@ extern void exports_foxglove_loader_loader_data_loader_destructor(
   delete rep->data_loader;
 }
 
-extern bool exports_foxglove_loader_loader_method_message_iterator_next(
-  exports_foxglove_loader_loader_borrow_message_iterator_t self,
-  exports_foxglove_loader_loader_result_message_error_t* ret
+static void set_host_message_result(
+  const Result<Message>& result, exports_foxglove_loader_loader_result_message_error_t* ret
 ) {
-  AbstractMessageIterator* iter = self->message_iterator;
-  std::optional<Result<Message>> optional_result = iter->next();
-  if (!optional_result.has_value()) {
-    return false;
-  }
-  Result<Message> result = optional_result.value();
   if (result.value.has_value()) {
     ret->is_err = false;
-    Message msg = result.value.value();
+    const Message& msg = result.value.value();
     ret->val.ok.channel_id = msg.channel_id;
     ret->val.ok.log_time = msg.log_time;
     ret->val.ok.publish_time = msg.publish_time;
@@ -101,9 +141,128 @@ extern bool exports_foxglove_loader_loader_method_message_iterator_next(
     ret->is_err = true;
     host_string_dup(&ret->val.err, result.error.c_str());
   }
+}
+
+extern bool exports_foxglove_loader_loader_method_message_iterator_next(
+  exports_foxglove_loader_loader_borrow_message_iterator_t self,
+  exports_foxglove_loader_loader_result_message_error_t* ret
+) {
+  AbstractMessageIterator* iter = self->message_iterator;
+  std::optional<Result<Message>> optional_result = iter->next();
+  if (!optional_result.has_value()) {
+    return false;
+  }
+  set_host_message_result(optional_result.value(), ret);
   return true;
 }
 
+std::vector<Result<Message>> AbstractMessageIterator::next_batch(
+  size_t max_messages, size_t max_bytes
+) {
+  // The host has finished with the previous batch by the time it asks for another one.
+  batch_data.clear();
+  std::vector<Result<Message>> batch;
+  size_t bytes = 0;
+  while (batch.size() < max_messages && bytes < max_bytes) {
+    // The next call to next() may invalidate the data of the previous message. The message which
+    // fills the batch is never followed by another call, so it doesn't need to be copied.
+    if (!batch.empty() && batch.back().ok()) {
+      BytesView& data = batch.back().value->data;
+      std::vector<uint8_t>& copy = batch_data.emplace_back(data.ptr, data.ptr + data.len);
+      data.ptr = copy.data();
+    }
+    std::optional<Result<Message>> result = next();
+    if (!result.has_value()) {
+      break;
+    }
+    if (result->ok()) {
+      bytes += result->get().data.len;
+    }
+    batch.push_back(std::move(result.value()));
+  }
+  return batch;
+}
+
+extern void exports_foxglove_loader_loader_method_message_iterator_next_batch(
+  exports_foxglove_loader_loader_borrow_message_iterator_t self, uint32_t max_messages,
+  uint64_t max_bytes, exports_foxglove_loader_loader_list_result_message_error_t* ret
+) {
+  AbstractMessageIterator* iter = self->message_iterator;
+  size_t max_batch_bytes = max_bytes > SIZE_MAX ? SIZE_MAX : static_cast<size_t>(max_bytes);
+  std::vector<Result<Message>> batch = iter->next_batch(max_messages, max_batch_bytes);
+  size_t len = batch.size();
+  ret->len = len;
+  ret->ptr = (exports_foxglove_loader_loader_result_message_error_t*)calloc(
+    len, sizeof(exports_foxglove_loader_loader_result_message_error_t)
+  );
+  for (size_t i = 0; i < len; i++) {
+    set_host_message_result(batch[i], &ret->ptr[i]);
+  }
+}
+
+std::vector<Result<MessageRef>> AbstractMessageIterator::next_batch_refs(
+  size_t max_messages, size_t max_bytes
+) {
+  std::vector<Result<MessageRef>> batch;
+  for (Result<Message>& result : next_batch(max_messages, max_bytes)) {
+    if (!result.ok()) {
+      batch.push_back(Result<MessageRef>::error_with_message(std::move(result.error)));
+      continue;
+    }
+    const Message& msg = result.get();
+    batch.push_back(Result<MessageRef>{
+      .value =
+        MessageRef{
+          .channel_id = msg.channel_id,
+          .log_time = msg.log_time,
+          .publish_time = msg.publish_time,
+          .data = msg.data,
+          .file_range = std::nullopt,
+        },
+    });
+  }
+  return batch;
+}
+
+extern void exports_foxglove_loader_loader_method_message_iterator_next_batch_refs(
+  exports_foxglove_loader_loader_borrow_message_iterator_t self, uint32_t max_messages,
+  uint64_t max_bytes, exports_foxglove_loader_loader_list_result_message_ref_error_t* ret
+) {
+  AbstractMessageIterator* iter = self->message_iterator;
+  size_t max_batch_bytes = max_bytes > SIZE_MAX ? SIZE_MAX : static_cast<size_t>(max_bytes);
+  std::vector<Result<MessageRef>> batch = iter->next_batch_refs(max_messages, max_batch_bytes);
+  size_t len = batch.size();
+  ret->len = len;
+  ret->ptr = (exports_foxglove_loader_loader_result_message_ref_error_t*)calloc(
+    len, sizeof(exports_foxglove_loader_loader_result_message_ref_error_t)
+  );
+  for (size_t i = 0; i < len; i++) {
+    const Result<MessageRef>& result = batch[i];
+    exports_foxglove_loader_loader_result_message_ref_error_t* out = &ret->ptr[i];
+    if (!result.ok()) {
+      out->is_err = true;
+      host_string_dup(&out->val.err, result.error.c_str());
+      continue;
+    }
+    const MessageRef& msg = result.get();
+    out->is_err = false;
+    out->val.ok.channel_id = msg.channel_id;
+    out->val.ok.log_time = msg.log_time;
+    out->val.ok.publish_time = msg.publish_time;
+    if (msg.file_range.has_value()) {
+      out->val.ok.data.tag = EXPORTS_FOXGLOVE_LOADER_LOADER_MESSAGE_DATA_FILE_RANGE;
+      out->val.ok.data.val.file_range.file = msg.file_range->file;
+      out->val.ok.data.val.file_range.offset = msg.file_range->offset;
+      out->val.ok.data.val.file_range.len = msg.file_range->len;
+    } else {
+      out->val.ok.data.tag = EXPORTS_FOXGLOVE_LOADER_LOADER_MESSAGE_DATA_BYTES;
+      // NOTE: as for `next()`, the message data is not copied, and not freed in the post-return.
+      out->val.ok.data.val.bytes.len = msg.data.len;
+      out->val.ok.data.val.bytes.ptr = const_cast<uint8_t*>(msg.data.ptr);
+    }
+  }
+}
+
 extern exports_foxglove_loader_loader_own_data_loader_t
 exports_foxglove_loader_loader_constructor_data_loader(
   exports_foxglove_loader_loader_data_loader_args_t* args
@@ -239,6 +398,122 @@ Result<std::vector<Message>> AbstractDataLoader::get_backfill(const BackfillArgs
   return Result<std::vector<Message>>{.value = std::vector<Message>()};
 }
 
+// Orders the heap so that the earliest message, breaking ties by iterator order, is at the front.
+static bool later_head(const Message& a, size_t a_iter, const Message& b, size_t b_iter) {
+  return a.log_time != b.log_time ? a.log_time > b.log_time : a_iter > b_iter;
+}
+
+MergedMessageIterator::MergedMessageIterator(
+  std::vector<std::unique_ptr<AbstractMessageIterator>> iterators_
+)
+    : iterators(std::move(iterators_)) {
+  heads.reserve(iterators.size());
+  for (size_t i = iterators.size(); i > 0; i--) {
+    to_advance.push_back(i - 1);
+  }
+}
+
+std::optional<Result<Message>> MergedMessageIterator::next() {
+  auto compare = [](const Head& a, const Head& b) {
+    return later_head(a.message, a.iterator, b.message, b.iterator);
+  };
+  while (!to_advance.empty()) {
+    size_t i = to_advance.back();
+    to_advance.pop_back();
+    std::optional<Result<Message>> result = iterators[i]->next();
+    if (!result.has_value()) {
+      continue;
+    }
+    if (!result->ok()) {
+      // Surface the error, then carry on with this iterator's next message.
+      to_advance.push_back(i);
+      return result;
+    }
+    heads.push_back(Head{result->get(), i});
+    std::push_heap(heads.begin(), heads.end(), compare);
+  }
+  if (heads.empty()) {
+    return std::nullopt;
+  }
+  std::pop_heap(heads.begin(), heads.end(), compare);
+  Head head = heads.back();
+  heads.pop_back();
+  to_advance.push_back(head.iterator);
+  return Result<Message>{.value = head.message};
+}
+
+BackfillIndex::BackfillIndex(TimeNanos stride_)
+    : stride(stride_ > 0 ? stride_ : 1) {}
+
+void BackfillIndex::record(const Message& message) {
+  auto& channel_checkpoints = checkpoints[message.channel_id];
+  auto [it, inserted] = channel_checkpoints.try_emplace(
+    message.log_time / stride, Checkpoint{message.log_time, message.log_time}
+  );
+  if (!inserted) {
+    it->second.first_log_time = std::min(it->second.first_log_time, message.log_time);
+    it->second.last_log_time = std::max(it->second.last_log_time, message.log_time);
+  }
+}
+
+Result<std::vector<Message>> BackfillIndex::get_backfill(
+  AbstractDataLoader& loader, const BackfillArgs& args
+) {
+  backfill_data.clear();
+  std::vector<Message> messages;
+  for (ChannelId channel_id : args.channel_ids) {
+    auto channel_it = checkpoints.find(channel_id);
+    if (channel_it == checkpoints.end()) {
+      continue;
+    }
+    // Find the last interval with a message at or before the requested time.
+    const auto& channel_checkpoints = channel_it->second;
+    auto it = channel_checkpoints.upper_bound(args.time / stride);
+    if (it == channel_checkpoints.begin()) {
+      continue;
+    }
+    --it;
+    const Checkpoint& checkpoint = it->second;
+    if (checkpoint.first_log_time > args.time) {
+      if (it == channel_checkpoints.begin()) {
+        continue;
+      }
+      --it;
+    }
+    // A checkpoint entirely before the requested time pins down the latest message exactly.
+    // Otherwise the requested time falls within the checkpoint's interval.
+    MessageIteratorArgs iter_args;
+    iter_args.channel_ids.push_back(channel_id);
+    iter_args.start_time =
+      it->second.last_log_time <= args.time ? it->second.last_log_time : it->second.first_log_time;
+    iter_args.end_time = args.time;
+    auto iter_result = loader.create_iterator(iter_args);
+    if (!iter_result.ok()) {
+      return Result<std::vector<Message>>::error_with_message(iter_result.error);
+    }
+    AbstractMessageIterator& iter = *iter_result.value.value();
+    std::optional<Message> latest;
+    std::vector<uint8_t> latest_data;
+    while (auto result = iter.next()) {
+      if (!result->ok()) {
+        return Result<std::vector<Message>>::error_with_message(result->error);
+      }
+      const Message& message = result->get();
+      if (message.channel_id != channel_id || message.log_time > args.time) {
+        continue;
+      }
+      // The iterator may invalidate the data of this message on the next call.
+      latest = message;
+      latest_data.assign(message.data.ptr, message.data.ptr + message.data.len);
+    }
+    if (latest.has_value()) {
+      latest->data.ptr = backfill_data.emplace_back(std::move(latest_data)).data();
+      messages.push_back(latest.value());
+    }
+  }
+  return Result<std::vector<Message>>{.value = std::move(messages)};
+}
+
 extern bool exports_foxglove_loader_loader_method_data_loader_get_backfill(
   exports_foxglove_loader_loader_borrow_data_loader_t self,
   exports_foxglove_loader_loader_backfill_args_t* args,
@@ -277,3 +552,76 @@ extern bool exports_foxglove_loader_loader_method_data_loader_get_backfill(
     return false;
   }
 }
+
+std::optional<uint64_t> foxglove_data_loader::find_index_offset(
+  const std::vector<IndexEntry>& index, uint32_t file, TimeNanos time
+) {
+  std::optional<IndexEntry> best;
+  for (const IndexEntry& entry : index) {
+    if (entry.file == file && entry.log_time <= time &&
+        (!best.has_value() || entry.log_time > best->log_time)) {
+      best = entry;
+    }
+  }
+  if (!best.has_value()) {
+    return std::nullopt;
+  }
+  return best->offset;
+}
+
+bool AbstractDataLoader::supports_concurrent_iterators() const {
+  return false;
+}
+
+extern bool exports_foxglove_loader_loader_method_data_loader_supports_concurrent_iterators(
+  exports_foxglove_loader_loader_borrow_data_loader_t self
+) {
+  return self->data_loader->supports_concurrent_iterators();
+}
+
+Result<std::vector<IndexEntry>> AbstractDataLoader::build_index() {
+  return Result<std::vector<IndexEntry>>{.value = std::vector<IndexEntry>()};
+}
+
+void AbstractDataLoader::load_index(const std::vector<IndexEntry>& index) {}
+
+extern bool exports_foxglove_loader_loader_method_data_loader_build_index(
+  exports_foxglove_loader_loader_borrow_data_loader_t self,
+  exports_foxglove_loader_loader_list_index_entry_t* ret, exports_foxglove_loader_loader_error_t* err
+) {
+  Result<std::vector<IndexEntry>> index_result = self->data_loader->build_index();
+  if (!index_result.ok()) {
+    host_string_dup(err, index_result.error.c_str());
+    return false;
+  }
+  const std::vector<IndexEntry>& index = index_result.get();
+  size_t len = index.size();
+  ret->len = len;
+  ret->ptr = (exports_foxglove_loader_loader_index_entry_t*)calloc(
+    len, sizeof(exports_foxglove_loader_loader_index_entry_t)
+  );
+  for (size_t i = 0; i < len; i++) {
+    ret->ptr[i].file = index[i].file;
+    ret->ptr[i].log_time = index[i].log_time;
+    ret->ptr[i].offset = index[i].offset;
+  }
+  return true;
+}
+
+extern void exports_foxglove_loader_loader_method_data_loader_load_index(
+  exports_foxglove_loader_loader_borrow_data_loader_t self,
+  exports_foxglove_loader_loader_list_index_entry_t* index
+) {
+  std::vector<IndexEntry> entries;
+  entries.reserve(index->len);
+  for (size_t i = 0; i < index->len; i++) {
+    const exports_foxglove_loader_loader_index_entry_t* entry = &index->ptr[i];
+    entries.push_back(IndexEntry{
+      .file = entry->file,
+      .log_time = entry->log_time,
+      .offset = entry->offset,
+    });
+  }
+  exports_foxglove_loader_loader_list_index_entry_free(index);
+  self->data_loader->load_index(entries);
+}
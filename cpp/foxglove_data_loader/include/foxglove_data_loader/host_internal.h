@@ -27,6 +27,38 @@ typedef struct {
   size_t len;
 } host_list_u8_t;
 
+typedef struct foxglove_loader_reader_read_range_t {
+  // The offset from the start of the file to read from.
+  uint64_t   offset;
+  // The address to write the data to. The caller must ensure that this memory region is valid.
+  uint32_t   ptr;
+  // The number of bytes to read.
+  uint32_t   len;
+} foxglove_loader_reader_read_range_t;
+
+typedef struct {
+  foxglove_loader_reader_read_range_t *ptr;
+  size_t len;
+} foxglove_loader_reader_list_read_range_t;
+
+typedef struct {
+  uint64_t *ptr;
+  size_t len;
+} host_list_u64_t;
+
+typedef uint8_t foxglove_loader_codec_compression_t;
+
+#define FOXGLOVE_LOADER_CODEC_COMPRESSION_ZSTD 0
+#define FOXGLOVE_LOADER_CODEC_COMPRESSION_LZ4 1
+
+typedef struct {
+  bool is_err;
+  union {
+    uint64_t ok;
+    host_string_t err;
+  } val;
+} foxglove_loader_codec_result_u64_string_t;
+
 typedef uint64_t foxglove_loader_time_time_nanos_t;
 
 typedef struct foxglove_loader_time_time_range_t {
@@ -151,6 +183,41 @@ typedef struct exports_foxglove_loader_loader_message_t {
   host_list_u8_t   data;
 } exports_foxglove_loader_loader_message_t;
 
+typedef struct exports_foxglove_loader_loader_file_range_t {
+  uint32_t   file;
+  uint64_t   offset;
+  uint64_t   len;
+} exports_foxglove_loader_loader_file_range_t;
+
+typedef struct exports_foxglove_loader_loader_message_data_t {
+  uint8_t tag;
+  union {
+    host_list_u8_t     bytes;
+    exports_foxglove_loader_loader_file_range_t     file_range;
+  } val;
+} exports_foxglove_loader_loader_message_data_t;
+
+#define EXPORTS_FOXGLOVE_LOADER_LOADER_MESSAGE_DATA_BYTES 0
+#define EXPORTS_FOXGLOVE_LOADER_LOADER_MESSAGE_DATA_FILE_RANGE 1
+
+typedef struct exports_foxglove_loader_loader_message_ref_t {
+  exports_foxglove_loader_loader_channel_id_t   channel_id;
+  exports_foxglove_loader_loader_time_nanos_t   log_time;
+  exports_foxglove_loader_loader_time_nanos_t   publish_time;
+  exports_foxglove_loader_loader_message_data_t   data;
+} exports_foxglove_loader_loader_message_ref_t;
+
+typedef struct exports_foxglove_loader_loader_index_entry_t {
+  uint32_t   file;
+  exports_foxglove_loader_loader_time_nanos_t   log_time;
+  uint64_t   offset;
+} exports_foxglove_loader_loader_index_entry_t;
+
+typedef struct {
+  exports_foxglove_loader_loader_index_entry_t *ptr;
+  size_t len;
+} exports_foxglove_loader_loader_list_index_entry_t;
+
 typedef struct {
   host_string_t *ptr;
   size_t len;
@@ -205,6 +272,24 @@ typedef struct {
   } val;
 } exports_foxglove_loader_loader_result_own_message_iterator_error_t;
 
+typedef struct {
+  exports_foxglove_loader_loader_result_message_error_t *ptr;
+  size_t len;
+} exports_foxglove_loader_loader_list_result_message_error_t;
+
+typedef struct {
+  bool is_err;
+  union {
+    exports_foxglove_loader_loader_message_ref_t ok;
+    exports_foxglove_loader_loader_error_t err;
+  } val;
+} exports_foxglove_loader_loader_result_message_ref_error_t;
+
+typedef struct {
+  exports_foxglove_loader_loader_result_message_ref_error_t *ptr;
+  size_t len;
+} exports_foxglove_loader_loader_list_result_message_ref_error_t;
+
 typedef struct {
   exports_foxglove_loader_loader_message_t *ptr;
   size_t len;
@@ -218,6 +303,14 @@ typedef struct {
   } val;
 } exports_foxglove_loader_loader_result_list_message_error_t;
 
+typedef struct {
+  bool is_err;
+  union {
+    exports_foxglove_loader_loader_list_index_entry_t ok;
+    exports_foxglove_loader_loader_error_t err;
+  } val;
+} exports_foxglove_loader_loader_result_list_index_entry_error_t;
+
 // Imported Functions from `foxglove:loader/console@0.1.0`
 extern void foxglove_loader_console_log(host_string_t *log);
 extern void foxglove_loader_console_error(host_string_t *log);
@@ -228,14 +321,24 @@ extern uint64_t foxglove_loader_reader_method_reader_seek(foxglove_loader_reader
 extern uint64_t foxglove_loader_reader_method_reader_position(foxglove_loader_reader_borrow_reader_t self);
 extern uint64_t foxglove_loader_reader_method_reader_read(foxglove_loader_reader_borrow_reader_t self, host_list_u8_t *target);
 extern uint64_t foxglove_loader_reader_method_reader_size(foxglove_loader_reader_borrow_reader_t self);
+extern void foxglove_loader_reader_method_reader_read_ranges(foxglove_loader_reader_borrow_reader_t self, foxglove_loader_reader_list_read_range_t *ranges, host_list_u64_t *ret);
+extern void foxglove_loader_reader_method_reader_prefetch(foxglove_loader_reader_borrow_reader_t self, uint64_t offset, uint64_t len);
 extern foxglove_loader_reader_own_reader_t foxglove_loader_reader_open(host_string_t *path);
 
+// Imported Functions from `foxglove:loader/codec@0.1.0`
+extern bool foxglove_loader_codec_decompress(foxglove_loader_codec_compression_t compression, host_list_u8_t *data, host_list_u8_t *target, uint64_t *ret, host_string_t *err);
+
 // Exported Functions from `foxglove:loader/loader@0.1.0`
 bool exports_foxglove_loader_loader_method_message_iterator_next(exports_foxglove_loader_loader_borrow_message_iterator_t self, exports_foxglove_loader_loader_result_message_error_t *ret);
+void exports_foxglove_loader_loader_method_message_iterator_next_batch(exports_foxglove_loader_loader_borrow_message_iterator_t self, uint32_t max_messages, uint64_t max_bytes, exports_foxglove_loader_loader_list_result_message_error_t *ret);
+void exports_foxglove_loader_loader_method_message_iterator_next_batch_refs(exports_foxglove_loader_loader_borrow_message_iterator_t self, uint32_t max_messages, uint64_t max_bytes, exports_foxglove_loader_loader_list_result_message_ref_error_t *ret);
 exports_foxglove_loader_loader_own_data_loader_t exports_foxglove_loader_loader_constructor_data_loader(exports_foxglove_loader_loader_data_loader_args_t *args);
 bool exports_foxglove_loader_loader_method_data_loader_initialize(exports_foxglove_loader_loader_borrow_data_loader_t self, exports_foxglove_loader_loader_initialization_t *ret, exports_foxglove_loader_loader_error_t *err);
 bool exports_foxglove_loader_loader_method_data_loader_create_iterator(exports_foxglove_loader_loader_borrow_data_loader_t self, exports_foxglove_loader_loader_message_iterator_args_t *args, exports_foxglove_loader_loader_own_message_iterator_t *ret, exports_foxglove_loader_loader_error_t *err);
 bool exports_foxglove_loader_loader_method_data_loader_get_backfill(exports_foxglove_loader_loader_borrow_data_loader_t self, exports_foxglove_loader_loader_backfill_args_t *args, exports_foxglove_loader_loader_list_message_t *ret, exports_foxglove_loader_loader_error_t *err);
+bool exports_foxglove_loader_loader_method_data_loader_build_index(exports_foxglove_loader_loader_borrow_data_loader_t self, exports_foxglove_loader_loader_list_index_entry_t *ret, exports_foxglove_loader_loader_error_t *err);
+void exports_foxglove_loader_loader_method_data_loader_load_index(exports_foxglove_loader_loader_borrow_data_loader_t self, exports_foxglove_loader_loader_list_index_entry_t *index);
+bool exports_foxglove_loader_loader_method_data_loader_supports_concurrent_iterators(exports_foxglove_loader_loader_borrow_data_loader_t self);
 
 // Helper Functions
 
@@ -245,8 +348,14 @@ extern void foxglove_loader_reader_reader_drop_borrow(foxglove_loader_reader_bor
 
 extern foxglove_loader_reader_borrow_reader_t foxglove_loader_reader_borrow_reader(foxglove_loader_reader_own_reader_t handle);
 
+void foxglove_loader_reader_read_range_free(foxglove_loader_reader_read_range_t *ptr);
+
+void foxglove_loader_reader_list_read_range_free(foxglove_loader_reader_list_read_range_t *ptr);
+
 void host_list_u8_free(host_list_u8_t *ptr);
 
+void host_list_u64_free(host_list_u64_t *ptr);
+
 void exports_foxglove_loader_loader_error_free(exports_foxglove_loader_loader_error_t *ptr);
 
 void host_option_string_free(host_option_string_t *ptr);
@@ -277,6 +386,8 @@ void exports_foxglove_loader_loader_list_problem_free(exports_foxglove_loader_lo
 
 void exports_foxglove_loader_loader_initialization_free(exports_foxglove_loader_loader_initialization_t *ptr);
 
+void exports_foxglove_loader_loader_list_index_entry_free(exports_foxglove_loader_loader_list_index_entry_t *ptr);
+
 void host_list_string_free(host_list_string_t *ptr);
 
 void exports_foxglove_loader_loader_data_loader_args_free(exports_foxglove_loader_loader_data_loader_args_t *ptr);
@@ -297,6 +408,12 @@ void exports_foxglove_loader_loader_result_message_error_free(exports_foxglove_l
 
 void exports_foxglove_loader_loader_option_result_message_error_free(exports_foxglove_loader_loader_option_result_message_error_t *ptr);
 
+void exports_foxglove_loader_loader_list_result_message_error_free(exports_foxglove_loader_loader_list_result_message_error_t *ptr);
+
+void exports_foxglove_loader_loader_result_message_ref_error_free(exports_foxglove_loader_loader_result_message_ref_error_t *ptr);
+
+void exports_foxglove_loader_loader_list_result_message_ref_error_free(exports_foxglove_loader_loader_list_result_message_ref_error_t *ptr);
+
 void exports_foxglove_loader_loader_result_initialization_error_free(exports_foxglove_loader_loader_result_initialization_error_t *ptr);
 
 void exports_foxglove_loader_loader_result_own_message_iterator_error_free(exports_foxglove_loader_loader_result_own_message_iterator_error_t *ptr);
@@ -305,6 +422,8 @@ void exports_foxglove_loader_loader_list_message_free(exports_foxglove_loader_lo
 
 void exports_foxglove_loader_loader_result_list_message_error_free(exports_foxglove_loader_loader_result_list_message_error_t *ptr);
 
+void exports_foxglove_loader_loader_result_list_index_entry_error_free(exports_foxglove_loader_loader_result_list_index_entry_error_t *ptr);
+
 // Sets the string `ret` to reference the input string `s` without copying it
 void host_string_set(host_string_t *ret, const char*s);
 
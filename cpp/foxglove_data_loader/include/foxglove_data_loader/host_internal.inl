@@ -40,10 +40,26 @@ __attribute__((
 )) extern int64_t
 __wasm_import_foxglove_loader_reader_method_reader_size(int32_t);
 
+__attribute__((
+  __import_module__("foxglove:loader/reader@0.1.0"), __import_name__("[method]reader.read-ranges")
+)) extern void
+__wasm_import_foxglove_loader_reader_method_reader_read_ranges(int32_t, uint8_t*, size_t, uint8_t*);
+
+__attribute__((
+  __import_module__("foxglove:loader/reader@0.1.0"), __import_name__("[method]reader.prefetch")
+)) extern void
+__wasm_import_foxglove_loader_reader_method_reader_prefetch(int32_t, int64_t, int64_t);
+
 __attribute__((__import_module__("foxglove:loader/reader@0.1.0"), __import_name__("open"))
 ) extern int32_t
 __wasm_import_foxglove_loader_reader_open(uint8_t*, size_t);
 
+// Imported Functions from `foxglove:loader/codec@0.1.0`
+
+__attribute__((__import_module__("foxglove:loader/codec@0.1.0"), __import_name__("decompress"))
+) extern void
+__wasm_import_foxglove_loader_codec_decompress(int32_t, uint8_t*, size_t, uint8_t*, size_t, uint8_t*);
+
 // Exported Functions from `foxglove:loader/loader@0.1.0`
 
 __attribute__((
@@ -87,6 +103,66 @@ __wasm_export_exports_foxglove_loader_loader_method_message_iterator_next_post_r
   }
 }
 
+__attribute__((__weak__,
+               __export_name__(
+                 "cabi_post_foxglove:loader/loader@0.1.0#[method]message-iterator.next-batch"
+               ))) void
+__wasm_export_exports_foxglove_loader_loader_method_message_iterator_next_batch_post_return(
+  uint8_t* arg0
+) {
+  size_t len0 = *((size_t*)(arg0 + sizeof(void*)));
+  if (len0 > 0) {
+    uint8_t* ptr1 = *((uint8_t**)(arg0 + 0));
+    for (size_t i2 = 0; i2 < len0; i2++) {
+      uint8_t* base = ptr1 + i2 * (32 + 2 * sizeof(void*));
+      switch ((int32_t)(int32_t)*((uint8_t*)(base + 0))) {
+        case 0: {
+          // NOTE: message data is not freed here, for the same reason as in the `next` post-return
+          // above.
+          break;
+        }
+        case 1: {
+          if ((*((size_t*)(base + (8 + 1 * sizeof(void*))))) > 0) {
+            free(*((uint8_t**)(base + 8)));
+          }
+          break;
+        }
+      }
+    }
+    free(ptr1);
+  }
+}
+
+__attribute__((__weak__,
+               __export_name__(
+                 "cabi_post_foxglove:loader/loader@0.1.0#[method]message-iterator.next-batch-refs"
+               ))) void
+__wasm_export_exports_foxglove_loader_loader_method_message_iterator_next_batch_refs_post_return(
+  uint8_t* arg0
+) {
+  size_t len0 = *((size_t*)(arg0 + sizeof(void*)));
+  if (len0 > 0) {
+    uint8_t* ptr1 = *((uint8_t**)(arg0 + 0));
+    for (size_t i2 = 0; i2 < len0; i2++) {
+      uint8_t* base = ptr1 + i2 * 64;
+      switch ((int32_t)(int32_t)*((uint8_t*)(base + 0))) {
+        case 0: {
+          // NOTE: message data is not freed here, for the same reason as in the `next` post-return
+          // above. File ranges own no memory.
+          break;
+        }
+        case 1: {
+          if ((*((size_t*)(base + (8 + 1 * sizeof(void*))))) > 0) {
+            free(*((uint8_t**)(base + 8)));
+          }
+          break;
+        }
+      }
+    }
+    free(ptr1);
+  }
+}
+
 __attribute__((
   __weak__, __export_name__("cabi_post_foxglove:loader/loader@0.1.0#[method]data-loader.initialize")
 )) void
@@ -231,6 +307,29 @@ __wasm_export_exports_foxglove_loader_loader_method_data_loader_get_backfill_pos
   }
 }
 
+__attribute__((
+  __weak__,
+  __export_name__("cabi_post_foxglove:loader/loader@0.1.0#[method]data-loader.build-index")
+)) void
+__wasm_export_exports_foxglove_loader_loader_method_data_loader_build_index_post_return(
+  uint8_t* arg0
+) {
+  switch ((int32_t)(int32_t)*((uint8_t*)(arg0 + 0))) {
+    case 0: {
+      if ((*((size_t*)(arg0 + (2 * sizeof(void*))))) > 0) {
+        free(*((uint8_t**)(arg0 + sizeof(void*))));
+      }
+      break;
+    }
+    case 1: {
+      if ((*((size_t*)(arg0 + (2 * sizeof(void*))))) > 0) {
+        free(*((uint8_t**)(arg0 + sizeof(void*))));
+      }
+      break;
+    }
+  }
+}
+
 // Canonical ABI intrinsics
 
 __attribute__((__weak__, __export_name__("cabi_realloc"))) void* cabi_realloc(
@@ -266,6 +365,19 @@ foxglove_loader_reader_borrow_reader_t foxglove_loader_reader_borrow_reader(
   return (foxglove_loader_reader_borrow_reader_t){arg.__handle};
 }
 
+void foxglove_loader_reader_read_range_free(foxglove_loader_reader_read_range_t* ptr) {}
+
+void foxglove_loader_reader_list_read_range_free(foxglove_loader_reader_list_read_range_t* ptr) {
+  size_t list_len = ptr->len;
+  if (list_len > 0) {
+    foxglove_loader_reader_read_range_t* list_ptr = ptr->ptr;
+    for (size_t i = 0; i < list_len; i++) {
+      foxglove_loader_reader_read_range_free(&list_ptr[i]);
+    }
+    free(list_ptr);
+  }
+}
+
 void host_list_u8_free(host_list_u8_t* ptr) {
   size_t list_len = ptr->len;
   if (list_len > 0) {
@@ -276,6 +388,16 @@ void host_list_u8_free(host_list_u8_t* ptr) {
   }
 }
 
+void host_list_u64_free(host_list_u64_t* ptr) {
+  size_t list_len = ptr->len;
+  if (list_len > 0) {
+    uint64_t* list_ptr = ptr->ptr;
+    for (size_t i = 0; i < list_len; i++) {
+    }
+    free(list_ptr);
+  }
+}
+
 void exports_foxglove_loader_loader_error_free(exports_foxglove_loader_loader_error_t* ptr) {
   host_string_free(ptr);
 }
@@ -389,6 +511,18 @@ void exports_foxglove_loader_loader_initialization_free(
   exports_foxglove_loader_loader_list_problem_free(&ptr->problems);
 }
 
+void exports_foxglove_loader_loader_list_index_entry_free(
+  exports_foxglove_loader_loader_list_index_entry_t* ptr
+) {
+  size_t list_len = ptr->len;
+  if (list_len > 0) {
+    exports_foxglove_loader_loader_index_entry_t* list_ptr = ptr->ptr;
+    for (size_t i = 0; i < list_len; i++) {
+    }
+    free(list_ptr);
+  }
+}
+
 void host_list_string_free(host_list_string_t* ptr) {
   size_t list_len = ptr->len;
   if (list_len > 0) {
@@ -519,6 +653,41 @@ void exports_foxglove_loader_loader_option_result_message_error_free(
   }
 }
 
+void exports_foxglove_loader_loader_list_result_message_error_free(
+  exports_foxglove_loader_loader_list_result_message_error_t* ptr
+) {
+  size_t list_len = ptr->len;
+  if (list_len > 0) {
+    exports_foxglove_loader_loader_result_message_error_t* list_ptr = ptr->ptr;
+    for (size_t i = 0; i < list_len; i++) {
+      exports_foxglove_loader_loader_result_message_error_free(&list_ptr[i]);
+    }
+    free(list_ptr);
+  }
+}
+
+void exports_foxglove_loader_loader_result_message_ref_error_free(
+  exports_foxglove_loader_loader_result_message_ref_error_t* ptr
+) {
+  if (!ptr->is_err) {
+  } else {
+    exports_foxglove_loader_loader_error_free(&ptr->val.err);
+  }
+}
+
+void exports_foxglove_loader_loader_list_result_message_ref_error_free(
+  exports_foxglove_loader_loader_list_result_message_ref_error_t* ptr
+) {
+  size_t list_len = ptr->len;
+  if (list_len > 0) {
+    exports_foxglove_loader_loader_result_message_ref_error_t* list_ptr = ptr->ptr;
+    for (size_t i = 0; i < list_len; i++) {
+      exports_foxglove_loader_loader_result_message_ref_error_free(&list_ptr[i]);
+    }
+    free(list_ptr);
+  }
+}
+
 void exports_foxglove_loader_loader_result_initialization_error_free(
   exports_foxglove_loader_loader_result_initialization_error_t* ptr
 ) {
@@ -560,6 +729,16 @@ void exports_foxglove_loader_loader_result_list_message_error_free(
   }
 }
 
+void exports_foxglove_loader_loader_result_list_index_entry_error_free(
+  exports_foxglove_loader_loader_result_list_index_entry_error_t* ptr
+) {
+  if (!ptr->is_err) {
+    exports_foxglove_loader_loader_list_index_entry_free(&ptr->val.ok);
+  } else {
+    exports_foxglove_loader_loader_error_free(&ptr->val.err);
+  }
+}
+
 void host_string_set(host_string_t* ret, const char* s) {
   ret->ptr = (uint8_t*)s;
   ret->len = strlen(s);
@@ -627,11 +806,69 @@ uint64_t foxglove_loader_reader_method_reader_size(foxglove_loader_reader_borrow
   return (uint64_t)(ret);
 }
 
+void foxglove_loader_reader_method_reader_read_ranges(
+  foxglove_loader_reader_borrow_reader_t self, foxglove_loader_reader_list_read_range_t* ranges,
+  host_list_u64_t* ret
+) {
+  __attribute__((__aligned__(sizeof(void*)))) uint8_t ret_area[(2 * sizeof(void*))];
+  uint8_t* ptr = (uint8_t*)&ret_area;
+  __wasm_import_foxglove_loader_reader_method_reader_read_ranges(
+    (self).__handle, (uint8_t*)(*ranges).ptr, (*ranges).len, ptr
+  );
+  *ret = (host_list_u64_t){
+    (uint64_t*)(*((uint8_t**)(ptr + 0))),
+    (*((size_t*)(ptr + sizeof(void*)))),
+  };
+}
+
+void foxglove_loader_reader_method_reader_prefetch(
+  foxglove_loader_reader_borrow_reader_t self, uint64_t offset, uint64_t len
+) {
+  __wasm_import_foxglove_loader_reader_method_reader_prefetch(
+    (self).__handle, (int64_t)(offset), (int64_t)(len)
+  );
+}
+
 foxglove_loader_reader_own_reader_t foxglove_loader_reader_open(host_string_t* path) {
   int32_t ret = __wasm_import_foxglove_loader_reader_open((uint8_t*)(*path).ptr, (*path).len);
   return (foxglove_loader_reader_own_reader_t){ret};
 }
 
+bool foxglove_loader_codec_decompress(
+  foxglove_loader_codec_compression_t compression, host_list_u8_t* data, host_list_u8_t* target,
+  uint64_t* ret, host_string_t* err
+) {
+  __attribute__((__aligned__(8))) uint8_t ret_area[16];
+  uint8_t* ptr = (uint8_t*)&ret_area;
+  __wasm_import_foxglove_loader_codec_decompress(
+    (int32_t)compression, (uint8_t*)(*data).ptr, (*data).len, (uint8_t*)(*target).ptr,
+    (*target).len, ptr
+  );
+  foxglove_loader_codec_result_u64_string_t result;
+  switch ((int32_t)(*((uint8_t*)(ptr + 0)))) {
+    case 0: {
+      result.is_err = false;
+      result.val.ok = (uint64_t)(*((int64_t*)(ptr + 8)));
+      break;
+    }
+    case 1: {
+      result.is_err = true;
+      result.val.err = (host_string_t){
+        (uint8_t*)(*((uint8_t**)(ptr + 8))),
+        (*((size_t*)(ptr + 8 + sizeof(void*)))),
+      };
+      break;
+    }
+  }
+  if (!result.is_err) {
+    *ret = result.val.ok;
+    return 1;
+  } else {
+    *err = result.val.err;
+    return 0;
+  }
+}
+
 __attribute__((__export_name__("foxglove:loader/loader@0.1.0#[method]message-iterator.next")))
 uint8_t*
 __wasm_export_exports_foxglove_loader_loader_method_message_iterator_next(uint8_t* arg) {
@@ -667,6 +904,40 @@ __wasm_export_exports_foxglove_loader_loader_method_message_iterator_next(uint8_
   return ptr;
 }
 
+__attribute__((
+  __export_name__("foxglove:loader/loader@0.1.0#[method]message-iterator.next-batch")
+)) uint8_t*
+__wasm_export_exports_foxglove_loader_loader_method_message_iterator_next_batch(
+  uint8_t* arg, int32_t arg0, int64_t arg1
+) {
+  exports_foxglove_loader_loader_list_result_message_error_t ret;
+  exports_foxglove_loader_loader_method_message_iterator_next_batch(
+    ((exports_foxglove_loader_loader_message_iterator_t*)arg), (uint32_t)(arg0), (uint64_t)(arg1),
+    &ret
+  );
+  uint8_t* ptr = (uint8_t*)&RET_AREA;
+  *((size_t*)(ptr + sizeof(void*))) = (ret).len;
+  *((uint8_t**)(ptr + 0)) = (uint8_t*)(ret).ptr;
+  return ptr;
+}
+
+__attribute__((
+  __export_name__("foxglove:loader/loader@0.1.0#[method]message-iterator.next-batch-refs")
+)) uint8_t*
+__wasm_export_exports_foxglove_loader_loader_method_message_iterator_next_batch_refs(
+  uint8_t* arg, int32_t arg0, int64_t arg1
+) {
+  exports_foxglove_loader_loader_list_result_message_ref_error_t ret;
+  exports_foxglove_loader_loader_method_message_iterator_next_batch_refs(
+    ((exports_foxglove_loader_loader_message_iterator_t*)arg), (uint32_t)(arg0), (uint64_t)(arg1),
+    &ret
+  );
+  uint8_t* ptr = (uint8_t*)&RET_AREA;
+  *((size_t*)(ptr + sizeof(void*))) = (ret).len;
+  *((uint8_t**)(ptr + 0)) = (uint8_t*)(ret).ptr;
+  return ptr;
+}
+
 __attribute__((__export_name__("foxglove:loader/loader@0.1.0#[constructor]data-loader"))) int32_t
 __wasm_export_exports_foxglove_loader_loader_constructor_data_loader(uint8_t* arg, size_t arg0) {
   exports_foxglove_loader_loader_data_loader_args_t arg1 =
@@ -814,6 +1085,61 @@ __wasm_export_exports_foxglove_loader_loader_method_data_loader_get_backfill(
   return ptr;
 }
 
+__attribute__((__export_name__("foxglove:loader/loader@0.1.0#[method]data-loader.build-index")))
+uint8_t*
+__wasm_export_exports_foxglove_loader_loader_method_data_loader_build_index(uint8_t* arg) {
+  exports_foxglove_loader_loader_result_list_index_entry_error_t ret;
+  exports_foxglove_loader_loader_list_index_entry_t ok;
+  exports_foxglove_loader_loader_error_t err;
+  ret.is_err = !exports_foxglove_loader_loader_method_data_loader_build_index(
+    ((exports_foxglove_loader_loader_data_loader_t*)arg), &ok, &err
+  );
+  if (ret.is_err) {
+    ret.val.err = err;
+  }
+  if (!ret.is_err) {
+    ret.val.ok = ok;
+  }
+  uint8_t* ptr = (uint8_t*)&RET_AREA;
+  if ((ret).is_err) {
+    const exports_foxglove_loader_loader_error_t* payload1 = &(ret).val.err;
+    *((int8_t*)(ptr + 0)) = 1;
+    *((size_t*)(ptr + (2 * sizeof(void*)))) = (*payload1).len;
+    *((uint8_t**)(ptr + sizeof(void*))) = (uint8_t*)(*payload1).ptr;
+  } else {
+    const exports_foxglove_loader_loader_list_index_entry_t* payload = &(ret).val.ok;
+    *((int8_t*)(ptr + 0)) = 0;
+    *((size_t*)(ptr + (2 * sizeof(void*)))) = (*payload).len;
+    *((uint8_t**)(ptr + sizeof(void*))) = (uint8_t*)(*payload).ptr;
+  }
+  return ptr;
+}
+
+__attribute__((__export_name__("foxglove:loader/loader@0.1.0#[method]data-loader.load-index"))) void
+__wasm_export_exports_foxglove_loader_loader_method_data_loader_load_index(
+  uint8_t* arg, uint8_t* arg0, size_t arg1
+) {
+  exports_foxglove_loader_loader_list_index_entry_t arg2 =
+    (exports_foxglove_loader_loader_list_index_entry_t){
+      (exports_foxglove_loader_loader_index_entry_t*)(arg0), (arg1)
+    };
+  exports_foxglove_loader_loader_method_data_loader_load_index(
+    ((exports_foxglove_loader_loader_data_loader_t*)arg), &arg2
+  );
+}
+
+__attribute__((__export_name__(
+  "foxglove:loader/loader@0.1.0#[method]data-loader.supports-concurrent-iterators"
+))) int32_t
+__wasm_export_exports_foxglove_loader_loader_method_data_loader_supports_concurrent_iterators(
+  uint8_t* arg
+) {
+  bool ret = exports_foxglove_loader_loader_method_data_loader_supports_concurrent_iterators(
+    ((exports_foxglove_loader_loader_data_loader_t*)arg)
+  );
+  return ret;
+}
+
 // Ensure that the *_component_type.o object is linked in
 
 extern void __component_type_object_force_link_host(void);
@@ -24,14 +24,51 @@ class Reliability(Enum):
     Reliable = ...
     """Data is sent over the reliable control channel (ordered, guaranteed delivery)."""
 
+class Priority(Enum):
+    """
+    The priority of a channel's data, relative to other channels.
+
+    When a participant's message backlog is congested, messages for higher-priority channels are
+    sent more often, and messages for lower-priority channels are dropped first. Priority takes
+    effect for reliable channels when the gateway is configured with a dropping message backlog
+    policy.
+    """
+
+    Low = ...
+    """Best-effort data, such as debug visualizations."""
+
+    Normal = ...
+    """The default priority."""
+
+    High = ...
+    """Latency-sensitive data, such as teleoperation commands and transforms."""
+
 class QosProfile:
     """
     Quality-of-service profile for a channel.
+
+    :param reliability: The reliability policy for the channel's data delivery.
+    :param priority: The priority of the channel's data.
+    :param lifespan: How long a message may wait in a participant's message backlog before it is
+        dropped, in seconds. Like the priority, this takes effect for reliable channels when the
+        gateway is configured with a dropping message backlog policy.
+    :param max_rate: Maximum rate of messages sent for the channel, in messages per second.
+        Messages logged faster than this are dropped. Video channels are not affected.
     """
 
     reliability: Reliability
-
-    def __init__(self, *, reliability: Reliability = Reliability.Lossy) -> None: ...
+    priority: Priority
+    lifespan: float | None
+    max_rate: float | None
+
+    def __init__(
+        self,
+        *,
+        reliability: Reliability = Reliability.Lossy,
+        priority: Priority = Priority.Normal,
+        lifespan: float | None = None,
+        max_rate: float | None = None,
+    ) -> None: ...
 
 class Capability(Enum):
     """
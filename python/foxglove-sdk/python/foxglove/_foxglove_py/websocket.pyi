@@ -38,6 +38,12 @@ class Capability(Enum):
     PlaybackControl = ...
     """Indicates that the server is capable of responding to playback control requests from controls in the Foxglove app."""
 
+    MessageBatches = ...
+    """Allow clients to receive several messages in each binary frame."""
+
+    FieldProjection = ...
+    """Allow clients to subscribe to a subset of the fields of a channel's messages."""
+
 class Client:
     """
     A client that is connected to a running WebSocket server.
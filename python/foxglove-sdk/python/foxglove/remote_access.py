@@ -18,6 +18,7 @@ from foxglove import (
 from ._foxglove_py.remote_access import (
     Capability,
     Client,
+    Priority,
     QosProfile,
     Reliability,
     RemoteAccessConnectionStatus,
@@ -179,6 +180,7 @@ __all__ = [
     "Parameter",
     "ParameterType",
     "ParameterValue",
+    "Priority",
     "QosProfile",
     "Reliability",
     "RemoteAccessConnectionStatus",
@@ -3,9 +3,10 @@ use std::time::Duration;
 
 use foxglove::ChannelDescriptor;
 use foxglove::remote_access::{
-    self, Capability, ConnectionStatus, Gateway, GatewayHandle, Listener, QosProfile, Reliability,
-    Status, VideoEncoderBackend,
+    self, Capability, ConnectionStatus, Gateway, GatewayHandle, Listener, Priority, QosProfile,
+    Reliability, Status, VideoEncoderBackend,
 };
+use pyo3::exceptions::PyValueError;
 use pyo3::prelude::*;
 use pyo3::types::PyBytes;
 
@@ -557,28 +558,110 @@ impl From<PyReliability> for Reliability {
     }
 }
 
+/// The priority of a channel's data, relative to other channels.
+#[pyclass(
+    from_py_object,
+    name = "Priority",
+    module = "foxglove.remote_access",
+    eq,
+    eq_int
+)]
+#[derive(Clone, PartialEq)]
+pub enum PyPriority {
+    /// Best-effort data, such as debug visualizations.
+    Low,
+    /// The default priority.
+    Normal,
+    /// Latency-sensitive data, such as teleoperation commands and transforms.
+    High,
+}
+
+#[pymethods]
+impl PyPriority {
+    #[getter]
+    fn name(&self) -> &'static str {
+        match self {
+            Self::Low => "Low",
+            Self::Normal => "Normal",
+            Self::High => "High",
+        }
+    }
+
+    #[getter]
+    fn value(&self) -> i32 {
+        match self {
+            Self::Low => 0,
+            Self::Normal => 1,
+            Self::High => 2,
+        }
+    }
+}
+
+impl From<PyPriority> for Priority {
+    fn from(value: PyPriority) -> Self {
+        match value {
+            PyPriority::Low => Priority::Low,
+            PyPriority::Normal => Priority::Normal,
+            PyPriority::High => Priority::High,
+        }
+    }
+}
+
 /// Quality-of-service profile for a channel.
 #[pyclass(from_py_object, name = "QosProfile", module = "foxglove.remote_access")]
 #[derive(Clone)]
 pub struct PyQosProfile {
     #[pyo3(get, set)]
     pub reliability: PyReliability,
+    #[pyo3(get, set)]
+    pub priority: PyPriority,
+    /// How long a message may wait to be sent before it is dropped, in seconds.
+    #[pyo3(get, set)]
+    pub lifespan: Option<f64>,
+    /// Maximum rate of messages sent for the channel, in messages per second.
+    #[pyo3(get, set)]
+    pub max_rate: Option<f64>,
 }
 
 #[pymethods]
 impl PyQosProfile {
     #[new]
-    #[pyo3(signature = (*, reliability=PyReliability::Lossy))]
-    fn new(reliability: PyReliability) -> Self {
-        Self { reliability }
+    #[pyo3(signature = (*, reliability=PyReliability::Lossy, priority=PyPriority::Normal, lifespan=None, max_rate=None))]
+    fn new(
+        reliability: PyReliability,
+        priority: PyPriority,
+        lifespan: Option<f64>,
+        max_rate: Option<f64>,
+    ) -> PyResult<Self> {
+        if lifespan.is_some_and(|lifespan| !lifespan.is_finite() || lifespan < 0.0) {
+            return Err(PyValueError::new_err(
+                "lifespan must be a non-negative number of seconds",
+            ));
+        }
+        Ok(Self {
+            reliability,
+            priority,
+            lifespan,
+            max_rate,
+        })
     }
 }
 
 impl From<PyQosProfile> for QosProfile {
     fn from(value: PyQosProfile) -> Self {
-        QosProfile::builder()
+        let mut builder = QosProfile::builder()
             .reliability(value.reliability.into())
-            .build()
+            .priority(value.priority.into());
+        if let Some(lifespan) = value
+            .lifespan
+            .and_then(|s| Duration::try_from_secs_f64(s).ok())
+        {
+            builder = builder.lifespan(lifespan);
+        }
+        if let Some(max_rate) = value.max_rate {
+            builder = builder.max_rate(max_rate);
+        }
+        builder.build()
     }
 }
 
@@ -742,6 +825,7 @@ pub fn register_submodule(parent_module: &Bound<'_, PyModule>) -> PyResult<()> {
     module.add_class::<PyRemoteAccessClient>()?;
     module.add_class::<PyConnectionStatus>()?;
     module.add_class::<PyReliability>()?;
+    module.add_class::<PyPriority>()?;
     module.add_class::<PyQosProfile>()?;
 
     let py = parent_module.py();
@@ -811,6 +811,10 @@ pub enum PyCapability {
     /// controls in the Foxglove app. This requires the server to specify the `data_start_time`
     /// and `data_end_time` fields in its `ServerInfo` message.
     PlaybackControl,
+    /// Allow clients to receive several messages in each binary frame.
+    MessageBatches,
+    /// Allow clients to subscribe to a subset of the fields of a channel's messages.
+    FieldProjection,
 }
 
 #[pymethods]
@@ -824,6 +828,8 @@ impl PyCapability {
             Self::Time => "Time",
             Self::Services => "Services",
             Self::PlaybackControl => "PlaybackControl",
+            Self::MessageBatches => "MessageBatches",
+            Self::FieldProjection => "FieldProjection",
         }
     }
 
@@ -836,6 +842,8 @@ impl PyCapability {
             Self::Time => 3,
             Self::Services => 4,
             Self::PlaybackControl => 5,
+            Self::MessageBatches => 6,
+            Self::FieldProjection => 7,
         }
     }
 }
@@ -849,6 +857,8 @@ impl From<PyCapability> for foxglove::websocket::Capability {
             PyCapability::Time => foxglove::websocket::Capability::Time,
             PyCapability::Services => foxglove::websocket::Capability::Services,
             PyCapability::PlaybackControl => foxglove::websocket::Capability::PlaybackControl,
+            PyCapability::MessageBatches => foxglove::websocket::Capability::MessageBatches,
+            PyCapability::FieldProjection => foxglove::websocket::Capability::FieldProjection,
         }
     }
 }
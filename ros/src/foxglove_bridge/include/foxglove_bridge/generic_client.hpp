@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <rclcpp/client.hpp>
 #include <rclcpp/serialized_message.hpp>
 #include <rclcpp/version.h>
@@ -9,6 +13,8 @@
 
 namespace foxglove_bridge {
 
+struct ServiceTypeSupport;
+
 class GenericClient : public rclcpp::ClientBase {
 public:
   using SharedRequest = std::shared_ptr<rclcpp::SerializedMessage>;
@@ -30,21 +36,20 @@ public:
   void handle_response(std::shared_ptr<rmw_request_id_t> request_header,
                        std::shared_ptr<void> response) override;
 #endif
-  void async_send_request(SharedRequest request, foxglove::ServiceResponder&& cb);
+  /// Sends a CDR-encoded request. The response is delivered through `responder` from the
+  /// executor thread that takes it.
+  void async_send_request(const std::byte* data, size_t size, foxglove::ServiceResponder&& cb);
 
 private:
   RCLCPP_DISABLE_COPY(GenericClient)
 
-  const rosidl_service_type_support_t* getServiceTypeSupportHandle(const std::string& serviceType);
-
   std::map<int64_t, foxglove::ServiceResponder> pending_requests_;
   std::mutex pending_requests_mutex_;
-  std::shared_ptr<rcpputils::SharedLibrary> _typeSupportLib;
-  std::shared_ptr<rcpputils::SharedLibrary> _typeIntrospectionLib;
-  const rosidl_service_type_support_t* _serviceTypeSupportHdl;
-  const rosidl_message_type_support_t* _requestTypeSupportHdl;
-  const rosidl_message_type_support_t* _responseTypeSupportHdl;
-  const rosidl_service_type_support_t* _typeIntrospectionHdl;
+  // Shared by all clients of the same service type.
+  std::shared_ptr<ServiceTypeSupport> _typeSupport;
+  // Serialized response buffers, reused across responses.
+  std::vector<std::unique_ptr<rclcpp::SerializedMessage>> _idleSerializedResponses;
+  std::mutex _idleSerializedResponsesMutex;
 };
 
 }  // namespace foxglove_bridge
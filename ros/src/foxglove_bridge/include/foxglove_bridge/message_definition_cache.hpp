@@ -1,10 +1,15 @@
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 namespace foxglove_bridge {
 
@@ -53,6 +58,15 @@ public:
 
 class MessageDefinitionCache final {
 public:
+  MessageDefinitionCache() = default;
+
+  /**
+   * Create a cache that also persists resolved full texts in `disk_cache_dir`, so that later runs
+   * skip resolving them from package share directories. A persisted entry is used only while every
+   * definition file it was built from is unchanged (same size and modification time).
+   */
+  explicit MessageDefinitionCache(std::filesystem::path disk_cache_dir);
+
   /**
    * Concatenate the message definition with its dependencies into a self-contained schema.
    * The format is different for MSG and IDL definitions, and is described fully here:
@@ -64,7 +78,21 @@ public:
   std::pair<MessageDefinitionFormat, const std::string&> get_full_text(
     const std::string& package_resource_name);
 
+  /**
+   * Resolve the full texts of the given package resource names in parallel, so that later calls to
+   * get_full_text return immediately. Errors are ignored here; get_full_text reports them when the
+   * definition is used.
+   */
+  void prefetch(const std::vector<std::string>& package_resource_names);
+
 private:
+  // The size and modification time of a definition file, used to validate persisted entries.
+  struct SourceFile {
+    std::filesystem::path path;
+    std::uintmax_t size;
+    int64_t mtime;
+  };
+
   struct DefinitionIdentifierHash {
     std::size_t operator()(const DefinitionIdentifier& di) const {
       std::size_t h1 = std::hash<MessageDefinitionFormat>()(di.format);
@@ -78,9 +106,22 @@ private:
    */
   const MessageSpec& load_message_spec(const DefinitionIdentifier& definition_identifier);
 
+  static std::optional<SourceFile> stat_source_file(const std::filesystem::path& path);
+  std::filesystem::path disk_cache_path(const std::string& package_resource_name) const;
+  std::optional<std::pair<MessageDefinitionFormat, std::string>> read_disk_cache(
+    const std::string& package_resource_name) const;
+  void write_disk_cache(const std::string& package_resource_name, MessageDefinitionFormat format,
+                        const std::string& text, const std::vector<SourceFile>& sources) const;
+
+  // Guards the maps below. Definition files are read without holding it, so that definitions can
+  // be resolved in parallel.
+  std::mutex mutex_;
   std::unordered_map<DefinitionIdentifier, MessageSpec, DefinitionIdentifierHash>
     msg_specs_by_definition_identifier_;
+  std::unordered_map<DefinitionIdentifier, SourceFile, DefinitionIdentifierHash>
+    sources_by_definition_identifier_;
   std::unordered_map<std::string, std::pair<MessageDefinitionFormat, std::string>> full_text_cache_;
+  std::optional<std::filesystem::path> disk_cache_dir_;
 };
 
 std::set<std::string> parse_dependencies(MessageDefinitionFormat format, const std::string& text,
@@ -1,11 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <cctype>
+#include <optional>
 #include <regex>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <rclcpp/node.hpp>
 
+#include <foxglove/mcap.hpp>
+
 namespace foxglove_bridge {
 
 constexpr char PARAM_PORT[] = "port";
@@ -26,6 +33,17 @@ constexpr char PARAM_CAPABILITIES[] = "capabilities";
 constexpr char PARAM_CLIENT_TOPIC_WHITELIST[] = "client_topic_whitelist";
 constexpr char PARAM_INCLUDE_HIDDEN[] = "include_hidden";
 constexpr char PARAM_DISABLE_LOAN_MESSAGE[] = "disable_load_message";
+constexpr char PARAM_CACHE_MESSAGE_DEFINITIONS[] = "cache_message_definitions";
+constexpr char PARAM_ISOLATED_TOPIC_EXECUTORS[] = "isolated_topic_executors";
+constexpr char PARAM_RECORD_PATH[] = "record_path";
+constexpr char PARAM_RECORD_TOPIC_WHITELIST[] = "record_topic_whitelist";
+constexpr char PARAM_RECORD_COMPRESSION[] = "record_compression";
+constexpr char PARAM_RECORD_ROTATION_MAX_BYTES[] = "record_rotation_max_bytes";
+constexpr char PARAM_RECORD_ROTATION_MAX_DURATION[] = "record_rotation_max_duration";
+constexpr char PARAM_RECORD_THROTTLED_TOPICS[] = "record_throttled_topics";
+constexpr char PARAM_TOPIC_MAX_RATES[] = "topic_max_rates";
+constexpr char PARAM_INTRA_PROCESS_TOPICS[] = "intra_process_topics";
+constexpr char PARAM_SUBSCRIPTION_LINGER_MS[] = "subscription_linger_ms";
 constexpr char PARAM_ASSET_URI_ALLOWLIST[] = "asset_uri_allowlist";
 constexpr char PARAM_IGN_UNRESPONSIVE_PARAM_NODES[] = "ignore_unresponsive_param_nodes";
 constexpr char PARAM_PUBLISH_CLIENT_COUNT[] = "publish_client_count";
@@ -51,6 +69,7 @@ constexpr int64_t DEFAULT_SYSINFO_REFRESH_INTERVAL_MS = 500;
 constexpr int64_t DEFAULT_MESSAGE_BACKLOG_SIZE = 1024;
 constexpr int64_t DEFAULT_MAX_DATA_TRACK_MESSAGE_SIZE = 102400;
 constexpr char DEFAULT_VIDEO_TRANSCODE_TOPIC_DENYLIST[] = ".*/compressedDepth";
+constexpr char DEFAULT_RECORD_COMPRESSION[] = "zstd";
 
 void declareParameters(rclcpp::Node* node);
 
@@ -64,4 +83,84 @@ inline std::regex compileTopicRegex(const std::string& pattern) {
 std::vector<std::regex> parseRegexStrings(rclcpp::Node* node,
                                           const std::vector<std::string>& strings);
 
+/// Parses a record_compression value (case-insensitively). Returns std::nullopt for an
+/// unrecognized value.
+inline std::optional<foxglove::McapCompression> parseMcapCompression(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  if (value == "zstd") {
+    return foxglove::McapCompression::Zstd;
+  } else if (value == "lz4") {
+    return foxglove::McapCompression::Lz4;
+  } else if (value == "none") {
+    return foxglove::McapCompression::None;
+  }
+  return std::nullopt;
+}
+
+/// Returns the MCAP writer path template for a rotated recording. The writer replaces `{index}`
+/// with the segment number; if `path` doesn't contain it, it is inserted before the extension.
+inline std::string mcapRotationPathTemplate(const std::string& path) {
+  constexpr std::string_view INDEX = "{index}";
+  if (path.find(INDEX) != std::string::npos) {
+    return path;
+  }
+  const auto slash = path.find_last_of('/');
+  const auto dot = path.find_last_of('.');
+  if (dot != std::string::npos && dot > 0 && (slash == std::string::npos || dot > slash + 1)) {
+    return path.substr(0, dot) + "_" + std::string(INDEX) + path.substr(dot);
+  }
+  return path + "_" + std::string(INDEX);
+}
+
+/// An entry of the isolated_topic_executors parameter: topics matching `pattern` are served by a
+/// dedicated executor thread, pinned to `cpu` if given.
+struct IsolatedTopicExecutorConfig {
+  std::string pattern;
+  std::optional<int> cpu;
+};
+
+/// Parses an isolated_topic_executors entry of the form "<regex>" or "<regex>@<cpu>". ROS names
+/// cannot contain '@', so a trailing "@<digits>" is always a CPU index.
+inline IsolatedTopicExecutorConfig parseIsolatedTopicExecutor(const std::string& entry) {
+  const auto at = entry.rfind('@');
+  if (at != std::string::npos && at + 1 < entry.size() && entry.size() - at <= 5 &&
+      std::all_of(entry.begin() + at + 1, entry.end(), [](unsigned char c) {
+        return std::isdigit(c);
+      })) {
+    return {entry.substr(0, at), std::stoi(entry.substr(at + 1))};
+  }
+  return {entry, std::nullopt};
+}
+
+/// An entry of the topic_max_rates parameter: messages on topics matching `pattern` are forwarded
+/// at most `maxRate` times per second.
+struct TopicMaxRateConfig {
+  std::string pattern;
+  double maxRate;
+};
+
+/// Parses a topic_max_rates entry of the form "<regex>@<hz>". ROS names cannot contain '@', so
+/// the rate follows the last '@'. Throws std::invalid_argument if the rate is missing or is not a
+/// positive number.
+inline TopicMaxRateConfig parseTopicMaxRate(const std::string& entry) {
+  const auto at = entry.rfind('@');
+  if (at == std::string::npos || at + 1 == entry.size()) {
+    throw std::invalid_argument("expected '<regex>@<hz>'");
+  }
+  const auto rateStr = entry.substr(at + 1);
+  size_t parsed = 0;
+  double rate = 0;
+  try {
+    rate = std::stod(rateStr, &parsed);
+  } catch (const std::exception&) {
+    parsed = 0;
+  }
+  if (parsed != rateStr.size() || !(rate > 0)) {
+    throw std::invalid_argument("max rate '" + rateStr + "' is not a positive number");
+  }
+  return {entry.substr(0, at), rate};
+}
+
 }  // namespace foxglove_bridge
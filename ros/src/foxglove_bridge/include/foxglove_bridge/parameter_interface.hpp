@@ -48,10 +48,15 @@ private:
   UnresponsiveNodePolicy _unresponsiveNodePolicy;
   ParamUpdateFunc _paramUpdateFunc;
 
-  ParameterList getNodeParameters(rclcpp::AsyncParametersClient::SharedPtr paramClient,
-                                  const std::string& nodeName,
-                                  const std::vector<std::string>& paramNames,
-                                  const std::chrono::duration<double>& timeout);
+  struct GetParamsBatch;
+
+  void requestNodeParameters(const std::shared_ptr<GetParamsBatch>& batch,
+                             const rclcpp::AsyncParametersClient::SharedPtr& paramClient,
+                             const std::string& nodeName,
+                             const std::vector<std::string>& paramNames);
+  void completeNodeRequest(const std::shared_ptr<GetParamsBatch>& batch,
+                           const std::string& nodeName,
+                           const std::vector<rclcpp::Parameter>& params, const char* error);
   void setNodeParameters(rclcpp::AsyncParametersClient::SharedPtr paramClient,
                          const std::string& nodeName, const std::vector<rclcpp::Parameter>& params,
                          const std::chrono::duration<double>& timeout);
@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <regex>
 #include <thread>
@@ -31,6 +32,7 @@
 #include <foxglove_bridge/message_definition_cache.hpp>
 #include <foxglove_bridge/param_utils.hpp>
 #include <foxglove_bridge/parameter_interface.hpp>
+#include <foxglove_bridge/strand_pool.hpp>
 #include <foxglove_bridge/utils.hpp>
 
 namespace foxglove_bridge {
@@ -38,7 +40,7 @@ namespace foxglove_bridge {
 extern const char FOXGLOVE_BRIDGE_VERSION[];
 extern const char FOXGLOVE_BRIDGE_GIT_HASH[];
 
-using Subscription = rclcpp::GenericSubscription::SharedPtr;
+using Subscription = rclcpp::SubscriptionBase::SharedPtr;
 using Publication = rclcpp::GenericPublisher::SharedPtr;
 
 using MapOfSets = std::unordered_map<std::string, std::unordered_set<std::string>>;
@@ -48,12 +50,19 @@ using ClientId = uint32_t;
 using SinkId = uint64_t;
 using ChannelId = uint64_t;
 using ChannelAndClientId = std::pair<ChannelId, ClientId>;
+
+class SerializedMessagePool;
+
 struct ClientAdvertisement {
   Publication publisher;
   std::string topicName;
   std::string topicType;
   std::string encoding;
   std::shared_ptr<RosMsgParser::Parser> jsonParser;
+  // Buffers for messages published on this channel, reused across messages.
+  std::shared_ptr<SerializedMessagePool> messagePool;
+  // Publishes this channel's messages in order, in parallel with other channels.
+  std::shared_ptr<StrandPool::Strand> strand;
 };
 
 class ClientChannelError : public std::runtime_error {
@@ -95,11 +104,32 @@ private:
 
   std::unique_ptr<foxglove::WebSocketServer> _server;
   std::unique_ptr<foxglove::SystemInfoPublisher> _sysinfoPublisher;
-  std::unordered_map<ChannelId, foxglove::RawChannel> _channels;
+  // Records matching channels straight from the bridge's subscriptions, if record_path is set.
+  std::unique_ptr<foxglove::McapWriter> _mcapWriter;
+  std::vector<std::regex> _recordTopicPatterns;
+  // Whether topic_max_rates also applies to recorded messages.
+  bool _recordThrottledTopics = false;
+  // Minimum interval between forwarded messages on topics matching each pattern, from
+  // topic_max_rates.
+  std::vector<std::pair<std::regex, std::chrono::nanoseconds>> _topicMinIntervals;
+  // Topics subscribed to with intra-process communication, from intra_process_topics.
+  std::vector<std::regex> _intraProcessTopicPatterns;
+  // Channels are shared with the message state of their ROS subscription, which may outlive the
+  // channel's entry in this map while a callback is in flight.
+  std::unordered_map<ChannelId, std::shared_ptr<foxglove::RawChannel>> _channels;
+  // The channel advertised for each (topic, datatype) pair, including channels advertised without
+  // a schema.
+  std::map<TopicAndDatatype, ChannelId> _channelIdsByTopic;
+  // The ROS graph as of the previous update, diffed against the current graph so that only changed
+  // topics and services are processed. Only accessed from the rosgraph thread.
+  std::map<std::string, std::vector<std::string>> _topicNamesAndTypes;
+  std::map<std::string, std::vector<std::string>> _serviceNamesAndTypes;
 
   // One shared ROS subscription per channel, reference-counted by client subscriptions
+  // Cached messages share the SerializedMessage received from the executor rather than copying
+  // it; rclcpp allocates a new one for every message taken.
   struct CachedMessage {
-    std::vector<uint8_t> data;
+    std::shared_ptr<const rclcpp::SerializedMessage> msg;
     uint64_t timestamp;
   };
   using Gid = std::array<uint8_t, RMW_GID_STORAGE_SIZE>;
@@ -107,13 +137,45 @@ private:
     std::deque<CachedMessage> messages;
     size_t maxMessages = 1;
   };
+  // Everything the ROS message callback of a channel needs. The callback holds its own reference,
+  // so the message path never looks up _channels or takes _subscriptionsMutex.
+  struct MessageState {
+    std::shared_ptr<foxglove::RawChannel> channel;
+    std::atomic<bool> transientLocal{false};
+    // Minimum steady-clock interval between forwarded messages, or zero if the topic is not
+    // throttled. Messages arriving before nextForwardNs are dropped.
+    int64_t minForwardIntervalNs = 0;
+    std::atomic<int64_t> nextForwardNs{0};
+    // Set while the subscription lingers with no clients; messages are then only cached.
+    std::atomic<bool> lingering{false};
+    // The recording's sink, which still receives throttled messages unless
+    // record_throttled_topics is set.
+    std::optional<uint64_t> unthrottledSinkId;
+    // Generation of the ROS subscription whose messages are forwarded; see ChannelSubscription.
+    std::atomic<uint32_t> activeGeneration{0};
+    // Per-publisher message cache for transient_local topics, replayed to late subscribers.
+    // Guarded by cacheMutex, which only contends between callbacks of the same topic.
+    std::mutex cacheMutex;
+    std::map<Gid, PublisherCache> publisherCaches;
+  };
   struct ChannelSubscription {
     Subscription rosSubscription;
     std::unordered_set<ClientId> wsClientIds;
     std::unordered_set<ClientId> gatewayClientIds;
-    rclcpp::QoS qos{10};
-    // Per-publisher message cache for transient_local topics, replayed to late subscribers.
-    std::map<Gid, PublisherCache> publisherCaches;
+    std::shared_ptr<MessageState> messageState;
+    // Whether the channel is recorded, which keeps the subscription alive without clients.
+    bool recorded = false;
+    std::string datatype;
+    rclcpp::QoS qos{rclcpp::KeepLast(1)};
+    // A ROS subscription's QoS can't be changed, so when the topic's publishers call for a
+    // different QoS, rosSubscription is replaced by one of the next generation. The previous
+    // subscription keeps forwarding messages until the replacement delivers its first message.
+    uint32_t generation = 0;
+    Subscription previousRosSubscription;
+    std::chrono::steady_clock::time_point replacedAt;
+    // When a subscription left without clients is removed, if it is lingering; see
+    // subscription_linger_ms.
+    std::optional<std::chrono::steady_clock::time_point> lingerUntil;
   };
   std::unordered_map<ChannelId, ChannelSubscription> _subscriptions;
 
@@ -129,7 +191,7 @@ private:
   std::unordered_map<std::string, GenericClient::SharedPtr> _serviceClients;
   std::unordered_map<std::string, std::unique_ptr<foxglove::ServiceHandler>> _serviceHandlers;
 
-  foxglove_bridge::MessageDefinitionCache _messageDefinitionCache;
+  std::unique_ptr<foxglove_bridge::MessageDefinitionCache> _messageDefinitionCache;
   std::vector<std::regex> _topicWhitelistPatterns;
   std::vector<std::regex> _serviceWhitelistPatterns;
   std::vector<std::regex> _assetUriAllowlistPatterns;
@@ -140,16 +202,41 @@ private:
   std::shared_ptr<ParameterInterface> _paramInterface;
   rclcpp::CallbackGroup::SharedPtr _subscriptionCallbackGroup;
   rclcpp::CallbackGroup::SharedPtr _clientPublishCallbackGroup;
+  // Publishes client messages off the server's threads, one strand per client channel.
+  std::unique_ptr<StrandPool> _clientPublishPool;
   rclcpp::CallbackGroup::SharedPtr _servicesCallbackGroup;
+
+  // A callback group spun by its own executor thread. Subscriptions to topics matching `pattern`
+  // are placed in it, so that they don't compete with other topics for the node executor's
+  // threads, e.g. a high-rate IMU topic with a large point cloud.
+  struct IsolatedExecutor {
+    std::regex pattern;
+    rclcpp::CallbackGroup::SharedPtr callbackGroup;
+    std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> executor;
+    std::thread thread;
+  };
+  std::vector<IsolatedExecutor> _isolatedExecutors;
+
+  void startIsolatedExecutors(const std::vector<std::string>& entries);
+  void parseTopicMaxRates(const std::vector<std::string>& entries);
+  std::chrono::nanoseconds topicMinForwardInterval(const std::string& topic) const;
+  void stopIsolatedExecutors();
+  rclcpp::CallbackGroup::SharedPtr subscriptionCallbackGroup(const std::string& topic) const;
   std::mutex _subscriptionsMutex;
   std::mutex _clientAdvertisementsMutex;
   std::mutex _servicesMutex;
   std::unique_ptr<std::thread> _rosgraphPollThread;
   size_t _minQosDepth = DEFAULT_MIN_QOS_DEPTH;
   size_t _maxQosDepth = DEFAULT_MAX_QOS_DEPTH;
+  std::chrono::milliseconds _subscriptionLinger{0};
   std::shared_ptr<rclcpp::Subscription<rosgraph_msgs::msg::Clock>> _clockSubscription;
   bool _useSimTime = false;
   std::atomic<int> _graphSubscriptionCount = 0;
+  // The connection graph last published to the server and gateway, owned by the rosgraph polling
+  // thread. Each update sends only the topics and services which have changed since.
+  MapOfSets _graphPublishers;
+  MapOfSets _graphSubscribers;
+  MapOfSets _graphServices;
   bool _includeHidden = false;
   bool _disableLoanMessage = true;
   std::unordered_map<std::string, std::shared_ptr<RosMsgParser::Parser>> _jsonParsers;
@@ -168,8 +255,8 @@ private:
 
   void clientUnadvertise(ClientId clientId, ChannelId clientChannelId);
 
-  void clientMessage(ClientId clientId, ChannelId clientChannelId, const std::byte* data,
-                     size_t dataLen);
+  void clientMessage(ClientId clientId, ChannelId clientChannelId,
+                     foxglove::ClientMessageBuffer data);
 
   // Each parameter op carries enough state to be handled by the worker thread.
   // Get and Set ops own their responders; Subscribe/Unsubscribe carry just the
@@ -224,11 +311,29 @@ private:
   // transports.
   std::unordered_map<std::string, int> _paramSubscriberCount;
 
-  void rosMessageHandler(ChannelId channelId, std::shared_ptr<const rclcpp::SerializedMessage> msg,
+  void rosMessageHandler(MessageState& state, std::shared_ptr<const rclcpp::SerializedMessage> msg,
                          const rclcpp::MessageInfo& messageInfo);
 
-  Subscription createRosSubscription(ChannelId channelId, const std::string& topic,
-                                     const std::string& datatype, const rclcpp::QoS& qos);
+  Subscription createRosSubscription(const std::string& topic, const std::string& datatype,
+                                     const rclcpp::QoS& qos,
+                                     std::shared_ptr<MessageState> messageState,
+                                     uint32_t generation);
+  // Sizes the per-publisher caches of a transient_local topic. Must be called with the state's
+  // cacheMutex held, or before the state is shared.
+  void initPublisherCaches(MessageState& state, const std::string& topic);
+  // Replaces subscriptions whose QoS no longer matches the topic's publishers.
+  void updateSubscriptionQos();
+  // Drops replaced subscriptions once their replacement is active, or has timed out.
+  void retireReplacedSubscriptions();
+  void removeLingeringSubscriptions();
+
+  void startRecording(const std::string& path);
+
+  // Returns the subscription for a channel, creating the ROS subscription if there is none, or
+  // _subscriptions.end() if it couldn't be created. Must be called with _subscriptionsMutex held.
+  std::unordered_map<ChannelId, ChannelSubscription>::iterator findOrCreateSubscriptionLocked(
+    ChannelId channelId, bool& isNewSubscription);
+  void recordChannelLocked(ChannelId channelId);
 
   void createOrIncrementSubscription(ChannelId channelId, ClientId clientId, bool isGateway,
                                      std::optional<SinkId> sinkId = std::nullopt);
@@ -245,6 +350,10 @@ private:
                                             const std::string& encoding,
                                             const std::byte* schemaData, size_t schemaLen);
   void publishClientData(const ClientAdvertisement& ad, const std::byte* data, size_t dataLen);
+  // Queues a client message to be published on its channel's strand. `owner` keeps `data` alive
+  // until it is published.
+  void postClientData(const ClientAdvertisement& ad, std::shared_ptr<const void> owner,
+                      const std::byte* data, size_t dataLen);
 
   void handleServiceRequest(const foxglove::ServiceRequest& request,
                             foxglove::ServiceResponder&& responder);
@@ -263,11 +372,22 @@ private:
     size_t transientLocalCount = 0;
     size_t totalHistoryDepth = 0;
     bool bestEffortForced = false;
+    // The history depth of each publisher, at least 1.
+    std::vector<std::pair<Gid, size_t>> publisherDepths;
   };
 
+  // Returns the topic's publisher QoS, from the cache when possible.
   TopicQosInfo collectTopicQosInfo(const std::string& topic);
+  // Drops the cached publisher QoS after the ROS graph changed.
+  void invalidateTopicQosCache();
+
+  // Publisher QoS by topic, so that subscribing doesn't query the ROS graph every time. Cleared on
+  // every graph change; entries are only added if no change happened while they were queried.
+  std::mutex _topicQosCacheMutex;
+  std::unordered_map<std::string, TopicQosInfo> _topicQosCache;
+  uint64_t _topicQosCacheGeneration = 0;
 
-  rclcpp::QoS determineQoS(const std::string& topic);
+  rclcpp::QoS determineQoS(const std::string& topic, bool warn = true);
 
 #ifdef FOXGLOVE_REMOTE_ACCESS
   void gatewaySubscribe(uint32_t clientId, const foxglove::ChannelDescriptor& channel);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace foxglove_bridge {
+
+/// A fixed pool of worker threads which runs tasks posted to strands.
+///
+/// Tasks posted to the same strand run one at a time, in the order they were posted. Tasks on
+/// different strands run in parallel on the pool's threads.
+class StrandPool {
+public:
+  class Strand;
+
+  explicit StrandPool(size_t threadCount);
+  /// Stops the worker threads. Tasks which have not started yet are dropped.
+  ~StrandPool();
+
+  StrandPool(const StrandPool&) = delete;
+  StrandPool& operator=(const StrandPool&) = delete;
+
+  /// Creates a strand which holds at most `maxQueuedTasks` tasks waiting to run.
+  std::shared_ptr<Strand> makeStrand(size_t maxQueuedTasks);
+
+  /// Queues a task on a strand. Returns false, without queueing it, if the strand's queue is full
+  /// or the pool is stopped. Tasks must not throw.
+  bool post(const std::shared_ptr<Strand>& strand, std::function<void()> task);
+
+private:
+  void workerLoop();
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  // Strands which have tasks waiting and are not running on a worker.
+  std::deque<std::shared_ptr<Strand>> _ready;
+  bool _stopped = false;
+  std::vector<std::thread> _threads;
+};
+
+}  // namespace foxglove_bridge
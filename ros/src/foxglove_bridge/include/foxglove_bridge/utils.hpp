@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <limits>
+#include <map>
 #include <regex>
 #include <stdexcept>
 #include <string>
@@ -30,6 +32,50 @@ inline bool matchesRegex(const std::string& name, const std::vector<std::regex>&
          }) != regexPatterns.end();
 }
 
+/// The (name, type) pairs added and removed between two ROS graph listings.
+struct NamesAndTypesDiff {
+  std::vector<std::pair<std::string, std::string>> added;
+  std::vector<std::pair<std::string, std::string>> removed;
+};
+
+/// Diff two name -> types listings, as returned by `get_topic_names_and_types()` or
+/// `get_service_names_and_types()`. Both maps are sorted by name, so this is a single merge pass in
+/// which unchanged entries only cost a comparison.
+inline NamesAndTypesDiff diffNamesAndTypes(
+  const std::map<std::string, std::vector<std::string>>& previous,
+  const std::map<std::string, std::vector<std::string>>& current) {
+  NamesAndTypesDiff diff;
+  const auto appendMissing = [](const std::string& name, const std::vector<std::string>& types,
+                                const std::vector<std::string>& others, auto& out) {
+    for (const auto& type : types) {
+      if (std::find(others.begin(), others.end(), type) == others.end()) {
+        out.emplace_back(name, type);
+      }
+    }
+  };
+  const std::vector<std::string> none;
+
+  auto prevIt = previous.begin();
+  auto currIt = current.begin();
+  while (prevIt != previous.end() || currIt != current.end()) {
+    if (currIt == current.end() || (prevIt != previous.end() && prevIt->first < currIt->first)) {
+      appendMissing(prevIt->first, prevIt->second, none, diff.removed);
+      ++prevIt;
+    } else if (prevIt == previous.end() || currIt->first < prevIt->first) {
+      appendMissing(currIt->first, currIt->second, none, diff.added);
+      ++currIt;
+    } else {
+      if (prevIt->second != currIt->second) {
+        appendMissing(prevIt->first, prevIt->second, currIt->second, diff.removed);
+        appendMissing(currIt->first, currIt->second, prevIt->second, diff.added);
+      }
+      ++prevIt;
+      ++currIt;
+    }
+  }
+  return diff;
+}
+
 inline std::pair<std::string, std::string> getNodeAndNodeNamespace(const std::string& fqnNodeName) {
   const std::size_t found = fqnNodeName.find_last_of("/");
   if (found == std::string::npos) {
@@ -65,4 +111,18 @@ inline std::vector<std::string> splitMessageDefinitions(std::istream& stream) {
   return definitions;
 }
 
+/// Returns whether a message received by the subscription of the given generation should be
+/// forwarded. The first message of a newer generation makes it the active one, after which
+/// messages of older generations are dropped.
+inline bool acceptSubscriptionGeneration(std::atomic<uint32_t>& activeGeneration,
+                                         uint32_t generation) {
+  uint32_t current = activeGeneration.load(std::memory_order_acquire);
+  while (generation > current) {
+    if (activeGeneration.compare_exchange_weak(current, generation, std::memory_order_acq_rel)) {
+      return true;
+    }
+  }
+  return generation == current;
+}
+
 }  // namespace foxglove_bridge
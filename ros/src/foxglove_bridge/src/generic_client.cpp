@@ -1,9 +1,12 @@
+#include <cstring>
 #include <iostream>
+#include <unordered_map>
 
 #include <rclcpp/client.hpp>
 #include <rclcpp/serialized_message.hpp>
 #include <rclcpp/typesupport_helpers.hpp>
 #include <rclcpp/version.h>
+#include <rmw/serialized_message.h>
 #include <rosidl_typesupport_introspection_cpp/field_types.hpp>
 #include <rosidl_typesupport_introspection_cpp/service_introspection.hpp>
 
@@ -42,25 +45,91 @@ constexpr char TYPESUPPORT_LIB_NAME[] = "rosidl_typesupport_cpp";
 using rosidl_typesupport_introspection_cpp::MessageMembers;
 using rosidl_typesupport_introspection_cpp::ServiceMembers;
 
-std::shared_ptr<void> allocate_message(const MessageMembers* members) {
+// Number of idle messages and serialized buffers kept for reuse. Service calls are request and
+// response pairs, so only a few are in flight at once.
+constexpr size_t MESSAGE_POOL_SIZE = 4;
+
+void* allocate_message(const MessageMembers* members) {
   void* buffer = malloc(members->size_of_);
   if (buffer == nullptr) {
     throw std::runtime_error("Failed to allocate memory");
   }
   memset(buffer, 0, members->size_of_);
   members->init_function(buffer, rosidl_runtime_cpp::MessageInitialization::ALL);
-  auto deleter = [members](void* ptr) {
-    if (ptr) {
-      // Call the message's destructor to clean up nested allocations
-      members->fini_function(ptr);
-      // Then free the main buffer
-      free(ptr);
-    }
-  };
+  return buffer;
+}
 
-  return std::shared_ptr<void>(buffer, deleter);
+void free_message(const MessageMembers* members, void* ptr) {
+  // Call the message's destructor to clean up nested allocations
+  members->fini_function(ptr);
+  // Then free the main buffer
+  free(ptr);
 }
 
+// A pool of type-erased messages of one type. Messages are returned to the pool rather than
+// finalized and freed, so that a message and its nested allocations (strings, sequences) are
+// reused by the next call. Deserialization overwrites every field of a reused message.
+class MessagePool : public std::enable_shared_from_this<MessagePool> {
+public:
+  explicit MessagePool(const MessageMembers* members)
+      : _members(members) {}
+
+  ~MessagePool() {
+    for (void* msg : _idle) {
+      free_message(_members, msg);
+    }
+  }
+
+  std::shared_ptr<void> acquire() {
+    void* msg = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_idle.empty()) {
+        msg = _idle.back();
+        _idle.pop_back();
+      }
+    }
+    if (msg == nullptr) {
+      msg = allocate_message(_members);
+    }
+    return std::shared_ptr<void>(msg, [weakPool = weak_from_this(), members = _members](void* ptr) {
+      if (auto pool = weakPool.lock()) {
+        pool->release(ptr);
+      } else {
+        free_message(members, ptr);
+      }
+    });
+  }
+
+private:
+  void release(void* msg) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_idle.size() < MESSAGE_POOL_SIZE) {
+        _idle.push_back(msg);
+        return;
+      }
+    }
+    free_message(_members, msg);
+  }
+
+  const MessageMembers* _members;
+  std::mutex _mutex;
+  std::vector<void*> _idle;
+};
+
+// Type support for a service type, loaded once and shared by all clients of that type.
+struct ServiceTypeSupport {
+  std::shared_ptr<rcpputils::SharedLibrary> typeSupportLib;
+  std::shared_ptr<rcpputils::SharedLibrary> typeIntrospectionLib;
+  const rosidl_service_type_support_t* serviceTypeSupportHdl = nullptr;
+  const rosidl_message_type_support_t* requestTypeSupportHdl = nullptr;
+  const rosidl_message_type_support_t* responseTypeSupportHdl = nullptr;
+  const rosidl_service_type_support_t* typeIntrospectionHdl = nullptr;
+  std::shared_ptr<MessagePool> requestPool;
+  std::shared_ptr<MessagePool> responsePool;
+};
+
 std::string getTypeIntrospectionSymbolName(const std::string& serviceType) {
   const auto [pkgName, middleModule, typeName] = extract_type_identifier(serviceType);
 
@@ -68,12 +137,11 @@ std::string getTypeIntrospectionSymbolName(const std::string& serviceType) {
          pkgName + "__" + (middleModule.empty() ? "srv" : middleModule) + "__" + typeName;
 }
 
-const rosidl_service_type_support_t* GenericClient::getServiceTypeSupportHandle(
-  const std::string& serviceType) {
+const rosidl_service_type_support_t* getServiceTypeSupportHandle(
+  const std::string& serviceType, rcpputils::SharedLibrary& typeSupportLib) {
 #if RCLCPP_VERSION_GTE(25, 0, 0)
   // Jazzy and newer can use the built-in rclcpp call.
-  return rclcpp::get_service_typesupport_handle(serviceType, TYPESUPPORT_LIB_NAME,
-                                                *_typeSupportLib);
+  return rclcpp::get_service_typesupport_handle(serviceType, TYPESUPPORT_LIB_NAME, typeSupportLib);
 #else
   // Humble needs to do additional work; the code below is essentially a copy of what
   // rclcpp::get_service_typesupport_handle() does in later ROS 2 versions.
@@ -83,57 +151,80 @@ const rosidl_service_type_support_t* GenericClient::getServiceTypeSupportHandle(
     std::string(TYPESUPPORT_LIB_NAME) + "__get_service_type_support_handle__" + pkgName + "__" +
     (middleModule.empty() ? "srv" : middleModule) + "__" + typeName;
 
-  if (!_typeSupportLib->has_symbol(typesupportSymbolName)) {
+  if (!typeSupportLib.has_symbol(typesupportSymbolName)) {
     throw std::runtime_error("Failed to find symbol '" + typesupportSymbolName + "' in " +
-                             _typeSupportLib->get_library_path());
+                             typeSupportLib.get_library_path());
   }
 
   const rosidl_service_type_support_t* (*get_ts)() = nullptr;
-  return (reinterpret_cast<decltype(get_ts)>(_typeSupportLib->get_symbol(typesupportSymbolName)))();
+  return (reinterpret_cast<decltype(get_ts)>(typeSupportLib.get_symbol(typesupportSymbolName)))();
 #endif
 }
 
-GenericClient::GenericClient(rclcpp::node_interfaces::NodeBaseInterface* nodeBase,
-                             rclcpp::node_interfaces::NodeGraphInterface::SharedPtr nodeGraph,
-                             std::string serviceName, std::string serviceType,
-                             rcl_client_options_t& client_options)
-    : rclcpp::ClientBase(nodeBase, nodeGraph) {
-  const auto [pkgName, middleModule, typeName] = extract_type_identifier(serviceType);
+std::shared_ptr<ServiceTypeSupport> loadServiceTypeSupport(const std::string& serviceType) {
   const auto requestTypeName = serviceType + "_Request";
   const auto responseTypeName = serviceType + "_Response";
 
-  _typeSupportLib = rclcpp::get_typesupport_library(serviceType, TYPESUPPORT_LIB_NAME);
-  _typeIntrospectionLib =
+  auto ts = std::make_shared<ServiceTypeSupport>();
+  ts->typeSupportLib = rclcpp::get_typesupport_library(serviceType, TYPESUPPORT_LIB_NAME);
+  ts->typeIntrospectionLib =
     rclcpp::get_typesupport_library(serviceType, TYPESUPPORT_INTROSPECTION_LIB_NAME);
-  if (!_typeSupportLib || !_typeIntrospectionLib) {
+  if (!ts->typeSupportLib || !ts->typeIntrospectionLib) {
     throw std::runtime_error("Failed to load shared library for service type " + serviceType);
   }
 
-  _serviceTypeSupportHdl = getServiceTypeSupportHandle(serviceType);
+  ts->serviceTypeSupportHdl = getServiceTypeSupportHandle(serviceType, *ts->typeSupportLib);
 
   const auto typeinstrospection_symbol_name = getTypeIntrospectionSymbolName(serviceType);
 
   // This will throw runtime_error if the symbol was not found.
   const rosidl_service_type_support_t* (*get_ts)() = nullptr;
-  _typeIntrospectionHdl = (reinterpret_cast<decltype(get_ts)>(
-    _typeIntrospectionLib->get_symbol(typeinstrospection_symbol_name)))();
+  ts->typeIntrospectionHdl = (reinterpret_cast<decltype(get_ts)>(
+    ts->typeIntrospectionLib->get_symbol(typeinstrospection_symbol_name)))();
 
   // get_typesupport_handle is deprecated since rclcpp 25.0.0
   // (https://github.com/ros2/rclcpp/pull/2209)
 #if RCLCPP_VERSION_GTE(25, 0, 0)
-  _requestTypeSupportHdl =
-    rclcpp::get_message_typesupport_handle(requestTypeName, TYPESUPPORT_LIB_NAME, *_typeSupportLib);
-  _responseTypeSupportHdl = rclcpp::get_message_typesupport_handle(
-    responseTypeName, TYPESUPPORT_LIB_NAME, *_typeSupportLib);
+  ts->requestTypeSupportHdl = rclcpp::get_message_typesupport_handle(
+    requestTypeName, TYPESUPPORT_LIB_NAME, *ts->typeSupportLib);
+  ts->responseTypeSupportHdl = rclcpp::get_message_typesupport_handle(
+    responseTypeName, TYPESUPPORT_LIB_NAME, *ts->typeSupportLib);
 #else
-  _requestTypeSupportHdl =
-    rclcpp::get_typesupport_handle(requestTypeName, TYPESUPPORT_LIB_NAME, *_typeSupportLib);
-  _responseTypeSupportHdl =
-    rclcpp::get_typesupport_handle(responseTypeName, TYPESUPPORT_LIB_NAME, *_typeSupportLib);
+  ts->requestTypeSupportHdl =
+    rclcpp::get_typesupport_handle(requestTypeName, TYPESUPPORT_LIB_NAME, *ts->typeSupportLib);
+  ts->responseTypeSupportHdl =
+    rclcpp::get_typesupport_handle(responseTypeName, TYPESUPPORT_LIB_NAME, *ts->typeSupportLib);
 #endif
 
-  rcl_ret_t ret = rcl_client_init(this->get_client_handle().get(), this->get_rcl_node_handle(),
-                                  _serviceTypeSupportHdl, serviceName.c_str(), &client_options);
+  const auto srv_members = static_cast<const ServiceMembers*>(ts->typeIntrospectionHdl->data);
+  ts->requestPool = std::make_shared<MessagePool>(srv_members->request_members_);
+  ts->responsePool = std::make_shared<MessagePool>(srv_members->response_members_);
+  return ts;
+}
+
+// Returns the type support for a service type, loading it if no client of that type exists.
+std::shared_ptr<ServiceTypeSupport> getServiceTypeSupport(const std::string& serviceType) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::weak_ptr<ServiceTypeSupport>> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (auto ts = cache[serviceType].lock()) {
+    return ts;
+  }
+  auto ts = loadServiceTypeSupport(serviceType);
+  cache[serviceType] = ts;
+  return ts;
+}
+
+GenericClient::GenericClient(rclcpp::node_interfaces::NodeBaseInterface* nodeBase,
+                             rclcpp::node_interfaces::NodeGraphInterface::SharedPtr nodeGraph,
+                             std::string serviceName, std::string serviceType,
+                             rcl_client_options_t& client_options)
+    : rclcpp::ClientBase(nodeBase, nodeGraph)
+    , _typeSupport(getServiceTypeSupport(serviceType)) {
+  rcl_ret_t ret =
+    rcl_client_init(this->get_client_handle().get(), this->get_rcl_node_handle(),
+                    _typeSupport->serviceTypeSupportHdl, serviceName.c_str(), &client_options);
   if (ret != RCL_RET_OK) {
     if (ret == RCL_RET_SERVICE_NAME_INVALID) {
       auto rcl_node_handle = this->get_rcl_node_handle();
@@ -147,8 +238,7 @@ GenericClient::GenericClient(rclcpp::node_interfaces::NodeBaseInterface* nodeBas
 }
 
 std::shared_ptr<void> GenericClient::create_response() {
-  auto srv_members = static_cast<const ServiceMembers*>(_typeIntrospectionHdl->data);
-  return allocate_message(srv_members->response_members_);
+  return _typeSupport->responsePool->acquire();
 }
 
 std::shared_ptr<rmw_request_id_t> GenericClient::create_request_header() {
@@ -165,14 +255,6 @@ void GenericClient::handle_response(std::shared_ptr<rmw_request_id_t> request_he
   std::unique_lock<std::mutex> lock(pending_requests_mutex_);
   int64_t sequence_number = request_header->sequence_number;
 
-  auto ser_response = std::make_shared<rclcpp::SerializedMessage>();
-  rmw_ret_t r = rmw_serialize(response.get(), _responseTypeSupportHdl,
-                              &ser_response->get_rcl_serialized_message());
-  if (r != RMW_RET_OK) {
-    RCUTILS_LOG_ERROR_NAMED("foxglove_bridge", "Failed to serialize service response. Ignoring...");
-    return;
-  }
-
   // TODO(esteve) this should throw instead since it is not expected to happen in the first place
   if (this->pending_requests_.count(sequence_number) == 0) {
     RCUTILS_LOG_ERROR_NAMED("foxglove_bridge", "Received invalid sequence number. Ignoring...");
@@ -183,24 +265,54 @@ void GenericClient::handle_response(std::shared_ptr<rmw_request_id_t> request_he
   // Unlock here to allow the service to be called recursively from one of its callbacks.
   lock.unlock();
 
+  std::unique_ptr<rclcpp::SerializedMessage> ser_response;
+  {
+    std::lock_guard<std::mutex> poolLock(_idleSerializedResponsesMutex);
+    if (!_idleSerializedResponses.empty()) {
+      ser_response = std::move(_idleSerializedResponses.back());
+      _idleSerializedResponses.pop_back();
+    }
+  }
+  if (!ser_response) {
+    ser_response = std::make_unique<rclcpp::SerializedMessage>();
+  }
+
+  rmw_ret_t r = rmw_serialize(response.get(), _typeSupport->responseTypeSupportHdl,
+                              &ser_response->get_rcl_serialized_message());
+  if (r != RMW_RET_OK) {
+    RCUTILS_LOG_ERROR_NAMED("foxglove_bridge", "Failed to serialize service response. Ignoring...");
+    // Dropping the responder sends the client an error status.
+    return;
+  }
+
   std::move(responder).respondOk(
     reinterpret_cast<const std::byte*>(ser_response->get_rcl_serialized_message().buffer),
     ser_response->get_rcl_serialized_message().buffer_length);
+
+  std::lock_guard<std::mutex> poolLock(_idleSerializedResponsesMutex);
+  if (_idleSerializedResponses.size() < MESSAGE_POOL_SIZE) {
+    _idleSerializedResponses.push_back(std::move(ser_response));
+  }
 }
 
-void GenericClient::async_send_request(SharedRequest request,
+void GenericClient::async_send_request(const std::byte* data, size_t size,
                                        foxglove::ServiceResponder&& responder) {
+  auto request = _typeSupport->requestPool->acquire();
+
+  // Deserialize straight from the caller's buffer; rmw_deserialize only reads it.
+  rmw_serialized_message_t sm = rmw_get_zero_initialized_serialized_message();
+  sm.buffer = reinterpret_cast<uint8_t*>(const_cast<std::byte*>(data));
+  sm.buffer_length = size;
+  sm.buffer_capacity = size;
+  if (const auto ret = rmw_deserialize(&sm, _typeSupport->requestTypeSupportHdl, request.get());
+      ret != RMW_RET_OK) {
+    rclcpp::exceptions::throw_from_rcl_error(ret, "failed to deserialize request");
+  }
+
+  // Hold the lock until the responder is registered, so that a fast response can't arrive first.
   std::lock_guard<std::mutex> lock(pending_requests_mutex_);
   int64_t sequence_number;
-
-  auto srv_members = static_cast<const ServiceMembers*>(_typeIntrospectionHdl->data);
-  auto buf = allocate_message(srv_members->request_members_);
-
-  const rmw_serialized_message_t* sm = &request->get_rcl_serialized_message();
-  if (const auto ret = rmw_deserialize(sm, _requestTypeSupportHdl, buf.get()) != RCL_RET_OK) {
-    rclcpp::exceptions::throw_from_rcl_error(ret, "failed to desirialize request");
-  }
-  rcl_ret_t ret = rcl_send_request(get_client_handle().get(), buf.get(), &sequence_number);
+  rcl_ret_t ret = rcl_send_request(get_client_handle().get(), request.get(), &sequence_number);
   if (RCL_RET_OK != ret) {
     rclcpp::exceptions::throw_from_rcl_error(ret, "failed to send request");
   }
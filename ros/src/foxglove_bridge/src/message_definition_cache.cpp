@@ -1,12 +1,17 @@
 #include "foxglove_bridge/message_definition_cache.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <map>
 #include <optional>
+#include <random>
 #include <regex>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 
@@ -34,6 +39,12 @@ static const std::regex MSG_FIELD_TYPE_REGEX{R"((?:^|\n)\s*([a-zA-Z0-9_/]+)(?:\[
 static const std::regex IDL_FIELD_TYPE_REGEX{
   R"((?:^|\n)#include\s+(?:"|<)([a-zA-Z0-9_/]+)\.idl(?:"|>))"};
 
+// First line of every on-disk cache entry. Bump the version when the entry format changes.
+static constexpr char DISK_CACHE_HEADER[] = "foxglove_bridge message definition cache v1";
+
+// Upper bound on the threads used by MessageDefinitionCache::prefetch.
+static constexpr size_t MAX_PREFETCH_THREADS = 8;
+
 static const std::unordered_set<std::string> PRIMITIVE_TYPES{
   "bool",  "byte",   "char",  "float32", "float64", "int8",   "uint8",
   "int16", "uint16", "int32", "uint32",  "int64",   "uint64", "string"};
@@ -188,11 +199,17 @@ MessageSpec::MessageSpec(MessageDefinitionFormat format, std::string text,
     , text(std::move(text))
     , format(format) {}
 
+MessageDefinitionCache::MessageDefinitionCache(std::filesystem::path disk_cache_dir)
+    : disk_cache_dir_(std::move(disk_cache_dir)) {}
+
 const MessageSpec& MessageDefinitionCache::load_message_spec(
   const DefinitionIdentifier& definition_identifier) {
-  if (auto it = msg_specs_by_definition_identifier_.find(definition_identifier);
-      it != msg_specs_by_definition_identifier_.end()) {
-    return it->second;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = msg_specs_by_definition_identifier_.find(definition_identifier);
+        it != msg_specs_by_definition_identifier_.end()) {
+      return it->second;
+    }
   }
 
   std::smatch match;
@@ -257,10 +274,15 @@ const MessageSpec& MessageDefinitionCache::load_message_spec(
   // Read the file
   const auto full_path = share_dir / *it;
   std::ifstream file{full_path};
-  if (!file.good()) {
+  const auto source = stat_source_file(full_path);
+  if (!file.good() || !source.has_value()) {
     throw DefinitionNotFoundError(definition_identifier.package_resource_name);
   }
 
+  // The specs defined by the file. Service and action files define several subtypes, which are all
+  // added to the cache.
+  std::vector<std::pair<DefinitionIdentifier, MessageSpec>> specs;
+
   if (subfolder == "action") {
     if (definition_identifier.format == MessageDefinitionFormat::IDL) {
       RCUTILS_LOG_ERROR_NAMED("foxglove_bridge",
@@ -311,21 +333,13 @@ const MessageSpec& MessageDefinitionCache::load_message_spec(
       {std::string(ACTION_GOAL_SERVICE_SUFFIX) + SERVICE_EVENT_MESSAGE_SUFFIX,
        make_event_definition(ACTION_GOAL_SERVICE_SUFFIX)}};
 
-    // Create a MessageSpec instance for every action subtype and add it to the cache.
+    // Create a MessageSpec instance for every action subtype.
     for (const auto& [action_suffix, definition] : action_type_definitions) {
       DefinitionIdentifier definition_id;
       definition_id.format = definition_identifier.format;
       definition_id.package_resource_name = package + "/action/" + action_name + action_suffix;
-      msg_specs_by_definition_identifier_.emplace(
-        definition_id, MessageSpec(definition_id.format, definition, package));
-    }
-
-    // Find the the subtype that was originally requested and return it.
-    const auto it = msg_specs_by_definition_identifier_.find(definition_identifier);
-    if (it == msg_specs_by_definition_identifier_.end()) {
-      throw DefinitionNotFoundError(definition_identifier.package_resource_name);
+      specs.emplace_back(definition_id, MessageSpec(definition_id.format, definition, package));
     }
-    return it->second;
   } else if (subfolder == "srv") {
     if (definition_identifier.format == MessageDefinitionFormat::IDL) {
       RCUTILS_LOG_ERROR_NAMED("foxglove_bridge",
@@ -360,48 +374,59 @@ const MessageSpec& MessageDefinitionCache::load_message_spec(
       {SERVICE_RESPONSE_MESSAGE_SUFFIX, responseDef},
       {SERVICE_EVENT_MESSAGE_SUFFIX, eventDef}};
 
-    // Create a MessageSpec instance for the request, response and event subtypes and add them to
-    // the cache.
+    // Create a MessageSpec instance for the request, response and event subtypes.
     for (const auto& [subType, definition] : service_type_definitions) {
       DefinitionIdentifier definition_id;
       definition_id.format = definition_identifier.format;
       definition_id.package_resource_name = package + "/srv/" + service_name + subType;
-      msg_specs_by_definition_identifier_.emplace(
-        definition_id, MessageSpec(definition_id.format, definition, package));
-    }
-
-    // Find the the subtype that was originally requested and return it.
-    const auto it = msg_specs_by_definition_identifier_.find(definition_identifier);
-    if (it == msg_specs_by_definition_identifier_.end()) {
-      throw DefinitionNotFoundError(definition_identifier.package_resource_name);
+      specs.emplace_back(definition_id, MessageSpec(definition_id.format, definition, package));
     }
-    return it->second;
   } else {
     // Normal message type.
-    const MessageSpec& spec =
-      msg_specs_by_definition_identifier_
-        .emplace(definition_identifier,
-                 MessageSpec(definition_identifier.format,
-                             std::string{std::istreambuf_iterator(file), {}}, package))
-        .first->second;
+    specs.emplace_back(definition_identifier,
+                       MessageSpec(definition_identifier.format,
+                                   std::string{std::istreambuf_iterator(file), {}}, package));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& [definition_id, spec] : specs) {
+    msg_specs_by_definition_identifier_.emplace(definition_id, std::move(spec));
+    sources_by_definition_identifier_.emplace(definition_id, *source);
+  }
 
-    // "References and pointers to data stored in the container are only invalidated by erasing that
-    // element, even when the corresponding iterator is invalidated."
-    return spec;
+  // Find the the subtype that was originally requested and return it.
+  const auto it = msg_specs_by_definition_identifier_.find(definition_identifier);
+  if (it == msg_specs_by_definition_identifier_.end()) {
+    throw DefinitionNotFoundError(definition_identifier.package_resource_name);
   }
+  // "References and pointers to data stored in the container are only invalidated by erasing that
+  // element, even when the corresponding iterator is invalidated."
+  return it->second;
 }
 
 std::pair<MessageDefinitionFormat, const std::string&> MessageDefinitionCache::get_full_text(
   const std::string& root_package_resource_name) {
-  if (auto it = full_text_cache_.find(root_package_resource_name); it != full_text_cache_.end()) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = full_text_cache_.find(root_package_resource_name); it != full_text_cache_.end()) {
+      return it->second;
+    }
+  }
+
+  if (auto persisted = read_disk_cache(root_package_resource_name)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, _] = full_text_cache_.emplace(root_package_resource_name, std::move(*persisted));
     return it->second;
   }
 
   std::unordered_set<DefinitionIdentifier, DefinitionIdentifierHash> seen_deps;
+  // Every definition the full text is built from, to validate the on-disk cache entry.
+  std::vector<DefinitionIdentifier> visited;
 
   std::function<std::string(const DefinitionIdentifier&)> append_recursive =
     [&](const DefinitionIdentifier& definition_identifier) {
       const MessageSpec& spec = load_message_spec(definition_identifier);
+      visited.push_back(definition_identifier);
       std::string result = spec.text;
       for (const auto& dep_name : spec.dependencies) {
         DefinitionIdentifier dep{definition_identifier.format, dep_name};
@@ -424,13 +449,161 @@ std::pair<MessageDefinitionFormat, const std::string&> MessageDefinitionCache::g
     RCUTILS_LOG_WARN_NAMED("foxglove_bridge", "no .msg definition for %s, falling back to IDL",
                            err.what());
     format = MessageDefinitionFormat::IDL;
+    visited.clear();
     DefinitionIdentifier root_definition_identifier{format, root_package_resource_name};
     result = delimiter(root_definition_identifier) + append_recursive(root_definition_identifier);
   }
 
+  if (disk_cache_dir_.has_value()) {
+    std::map<std::filesystem::path, SourceFile> sources;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& definition_identifier : visited) {
+        const auto& source = sources_by_definition_identifier_.at(definition_identifier);
+        sources.emplace(source.path, source);
+      }
+    }
+    std::vector<SourceFile> source_list;
+    for (auto& [_, source] : sources) {
+      source_list.push_back(std::move(source));
+    }
+    write_disk_cache(root_package_resource_name, format, result, source_list);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
   auto [it, _] =
-    full_text_cache_.emplace(root_package_resource_name, std::make_pair(format, result));
+    full_text_cache_.emplace(root_package_resource_name, std::make_pair(format, std::move(result)));
   return it->second;
 }
 
+void MessageDefinitionCache::prefetch(const std::vector<std::string>& package_resource_names) {
+  const size_t num_threads =
+    std::min(package_resource_names.size(),
+             std::clamp<size_t>(std::thread::hardware_concurrency(), 1, MAX_PREFETCH_THREADS));
+  std::atomic<size_t> next{0};
+  const auto worker = [&]() {
+    for (size_t i = next++; i < package_resource_names.size(); i = next++) {
+      try {
+        get_full_text(package_resource_names[i]);
+      } catch (const std::exception&) {
+        // Reported by get_full_text when the definition is used.
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+std::optional<MessageDefinitionCache::SourceFile> MessageDefinitionCache::stat_source_file(
+  const std::filesystem::path& path) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  return SourceFile{path, size, static_cast<int64_t>(mtime.time_since_epoch().count())};
+}
+
+std::filesystem::path MessageDefinitionCache::disk_cache_path(
+  const std::string& package_resource_name) const {
+  // Package resource names only contain [a-zA-Z0-9_/], so this mapping is unambiguous.
+  std::string file_name = package_resource_name;
+  std::replace(file_name.begin(), file_name.end(), '/', '.');
+  return *disk_cache_dir_ / (file_name + ".txt");
+}
+
+std::optional<std::pair<MessageDefinitionFormat, std::string>>
+MessageDefinitionCache::read_disk_cache(const std::string& package_resource_name) const {
+  if (!disk_cache_dir_.has_value()) {
+    return std::nullopt;
+  }
+  std::ifstream file{disk_cache_path(package_resource_name)};
+  std::string line;
+  if (!file.good() || !std::getline(file, line) || line != DISK_CACHE_HEADER) {
+    return std::nullopt;
+  }
+
+  MessageDefinitionFormat format;
+  if (!std::getline(file, line)) {
+    return std::nullopt;
+  } else if (line == "MSG") {
+    format = MessageDefinitionFormat::MSG;
+  } else if (line == "IDL") {
+    format = MessageDefinitionFormat::IDL;
+  } else {
+    return std::nullopt;
+  }
+
+  // The entry is stale if any definition file it was built from has changed.
+  size_t num_sources = 0;
+  if (!(file >> num_sources)) {
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < num_sources; ++i) {
+    std::uintmax_t size = 0;
+    int64_t mtime = 0;
+    if (!(file >> size >> mtime) || file.get() != ' ' || !std::getline(file, line)) {
+      return std::nullopt;
+    }
+    const auto current = stat_source_file(line);
+    if (!current.has_value() || current->size != size || current->mtime != mtime) {
+      return std::nullopt;
+    }
+  }
+  if (num_sources == 0 && file.get() != '\n') {
+    return std::nullopt;
+  }
+
+  return std::make_pair(format, std::string{std::istreambuf_iterator<char>(file), {}});
+}
+
+void MessageDefinitionCache::write_disk_cache(const std::string& package_resource_name,
+                                              MessageDefinitionFormat format,
+                                              const std::string& text,
+                                              const std::vector<SourceFile>& sources) const {
+  std::error_code ec;
+  std::filesystem::create_directories(*disk_cache_dir_, ec);
+  if (ec) {
+    RCUTILS_LOG_DEBUG_NAMED("foxglove_bridge", "cannot create message definition cache %s: %s",
+                            disk_cache_dir_->c_str(), ec.message().c_str());
+    return;
+  }
+
+  // Write to a temporary file and rename it into place, so that readers, including other bridge
+  // processes, never see a partial entry.
+  const auto path = disk_cache_path(package_resource_name);
+  auto tmp_path = path;
+  tmp_path += ".tmp" + std::to_string(std::random_device{}());
+  {
+    std::ofstream file{tmp_path, std::ios::trunc};
+    file << DISK_CACHE_HEADER << '\n'
+         << (format == MessageDefinitionFormat::MSG ? "MSG" : "IDL") << '\n'
+         << sources.size() << '\n';
+    for (const auto& source : sources) {
+      file << source.size << ' ' << source.mtime << ' ' << source.path.string() << '\n';
+    }
+    file << text;
+    if (!file.good()) {
+      file.close();
+      std::filesystem::remove(tmp_path, ec);
+      return;
+    }
+  }
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmp_path, ec);
+  }
+}
+
 }  // namespace foxglove_bridge
@@ -92,6 +92,22 @@ void declareParameters(rclcpp::Node* node) {
   maxQosDepthDescription.integer_range[0].step = 1;
   node->declare_parameter(PARAM_MAX_QOS_DEPTH, DEFAULT_MAX_QOS_DEPTH, maxQosDepthDescription);
 
+  auto subscriptionLingerDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  subscriptionLingerDescription.name = PARAM_SUBSCRIPTION_LINGER_MS;
+  subscriptionLingerDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER;
+  subscriptionLingerDescription.description =
+    "How long, in milliseconds, a ROS subscription is kept alive after its last client "
+    "unsubscribes, so that a client which resubscribes soon after, e.g. when switching layouts, "
+    "reuses it. Messages received in the meantime are discarded. 0 removes the subscription "
+    "immediately.";
+  subscriptionLingerDescription.read_only = true;
+  subscriptionLingerDescription.additional_constraints = "Must be a non-negative integer";
+  subscriptionLingerDescription.integer_range.resize(1);
+  subscriptionLingerDescription.integer_range[0].from_value = 0;
+  subscriptionLingerDescription.integer_range[0].to_value = INT32_MAX;
+  subscriptionLingerDescription.integer_range[0].step = 1;
+  node->declare_parameter(PARAM_SUBSCRIPTION_LINGER_MS, 0, subscriptionLingerDescription);
+
   auto bestEffortQosTopicWhiteListDescription = rcl_interfaces::msg::ParameterDescriptor{};
   bestEffortQosTopicWhiteListDescription.name = PARAM_BEST_EFFORT_QOS_TOPIC_WHITELIST;
   bestEffortQosTopicWhiteListDescription.type =
@@ -104,6 +120,103 @@ void declareParameters(rclcpp::Node* node) {
   node->declare_parameter(PARAM_BEST_EFFORT_QOS_TOPIC_WHITELIST, std::vector<std::string>({"(?!)"}),
                           bestEffortQosTopicWhiteListDescription);
 
+  auto isolatedTopicExecutorsDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  isolatedTopicExecutorsDescription.name = PARAM_ISOLATED_TOPIC_EXECUTORS;
+  isolatedTopicExecutorsDescription.type =
+    rcl_interfaces::msg::ParameterType::PARAMETER_STRING_ARRAY;
+  isolatedTopicExecutorsDescription.description =
+    "List of regular expressions (ECMAScript) of topics whose subscriptions get a dedicated "
+    "executor thread instead of sharing the node's executor. Append '@<cpu>' to pin the thread to "
+    "a CPU. A topic is served by the first matching entry.";
+  isolatedTopicExecutorsDescription.read_only = true;
+  node->declare_parameter(PARAM_ISOLATED_TOPIC_EXECUTORS, std::vector<std::string>(),
+                          isolatedTopicExecutorsDescription);
+
+  auto intraProcessTopicsDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  intraProcessTopicsDescription.name = PARAM_INTRA_PROCESS_TOPICS;
+  intraProcessTopicsDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_STRING_ARRAY;
+  intraProcessTopicsDescription.description =
+    "List of regular expressions (ECMAScript) of topics to subscribe to with intra-process "
+    "communication, so that publishers loaded into the same component container hand their "
+    "messages to the bridge without going through the middleware. Only applies to "
+    "sensor_msgs/msg/Image, CompressedImage and PointCloud2 topics with volatile durability.";
+  intraProcessTopicsDescription.read_only = true;
+  node->declare_parameter(PARAM_INTRA_PROCESS_TOPICS, std::vector<std::string>(),
+                          intraProcessTopicsDescription);
+
+  auto recordPathDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  recordPathDescription.name = PARAM_RECORD_PATH;
+  recordPathDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_STRING;
+  recordPathDescription.description =
+    "If set, record topics matching record_topic_whitelist to an MCAP file at this path.";
+  recordPathDescription.read_only = true;
+  node->declare_parameter(PARAM_RECORD_PATH, "", recordPathDescription);
+
+  auto recordTopicWhiteListDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  recordTopicWhiteListDescription.name = PARAM_RECORD_TOPIC_WHITELIST;
+  recordTopicWhiteListDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_STRING_ARRAY;
+  recordTopicWhiteListDescription.description =
+    "List of regular expressions (ECMAScript) of topic names to record when record_path is set.";
+  recordTopicWhiteListDescription.read_only = true;
+  node->declare_parameter(PARAM_RECORD_TOPIC_WHITELIST, std::vector<std::string>({".*"}),
+                          recordTopicWhiteListDescription);
+
+  auto recordCompressionDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  recordCompressionDescription.name = PARAM_RECORD_COMPRESSION;
+  recordCompressionDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_STRING;
+  recordCompressionDescription.description =
+    "Chunk compression of the recording: one of zstd, lz4, none.";
+  recordCompressionDescription.read_only = true;
+  node->declare_parameter(PARAM_RECORD_COMPRESSION, DEFAULT_RECORD_COMPRESSION,
+                          recordCompressionDescription);
+
+  auto recordRotationMaxBytesDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  recordRotationMaxBytesDescription.name = PARAM_RECORD_ROTATION_MAX_BYTES;
+  recordRotationMaxBytesDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER;
+  recordRotationMaxBytesDescription.description =
+    "If non-zero, start a new recording file once the current one reaches this many bytes.";
+  recordRotationMaxBytesDescription.read_only = true;
+  recordRotationMaxBytesDescription.integer_range.resize(1);
+  recordRotationMaxBytesDescription.integer_range[0].from_value = 0;
+  recordRotationMaxBytesDescription.integer_range[0].to_value = INT64_MAX;
+  recordRotationMaxBytesDescription.integer_range[0].step = 1;
+  node->declare_parameter(PARAM_RECORD_ROTATION_MAX_BYTES, 0, recordRotationMaxBytesDescription);
+
+  auto recordRotationMaxDurationDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  recordRotationMaxDurationDescription.name = PARAM_RECORD_ROTATION_MAX_DURATION;
+  recordRotationMaxDurationDescription.type =
+    rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER;
+  recordRotationMaxDurationDescription.description =
+    "If non-zero, start a new recording file once the current one has been open this many "
+    "seconds.";
+  recordRotationMaxDurationDescription.read_only = true;
+  recordRotationMaxDurationDescription.integer_range.resize(1);
+  recordRotationMaxDurationDescription.integer_range[0].from_value = 0;
+  recordRotationMaxDurationDescription.integer_range[0].to_value = INT32_MAX;
+  recordRotationMaxDurationDescription.integer_range[0].step = 1;
+  node->declare_parameter(PARAM_RECORD_ROTATION_MAX_DURATION, 0,
+                          recordRotationMaxDurationDescription);
+
+  auto recordThrottledTopicsDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  recordThrottledTopicsDescription.name = PARAM_RECORD_THROTTLED_TOPICS;
+  recordThrottledTopicsDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_BOOL;
+  recordThrottledTopicsDescription.description =
+    "Whether topics throttled by topic_max_rates are also throttled in the recording. By default, "
+    "they are recorded at their full rate.";
+  recordThrottledTopicsDescription.read_only = true;
+  node->declare_parameter(PARAM_RECORD_THROTTLED_TOPICS, false, recordThrottledTopicsDescription);
+
+  auto topicMaxRatesDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  topicMaxRatesDescription.name = PARAM_TOPIC_MAX_RATES;
+  topicMaxRatesDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_STRING_ARRAY;
+  topicMaxRatesDescription.description =
+    "List of regular expressions (ECMAScript) of topics with a maximum forwarding rate, each "
+    "followed by '@<hz>', e.g. '/joint_states@50'. Messages arriving faster are dropped before "
+    "they are cached or sent to clients. A topic is limited by the first matching entry.";
+  topicMaxRatesDescription.read_only = true;
+  node->declare_parameter(PARAM_TOPIC_MAX_RATES, std::vector<std::string>(),
+                          topicMaxRatesDescription);
+
   auto topicWhiteListDescription = rcl_interfaces::msg::ParameterDescriptor{};
   topicWhiteListDescription.name = PARAM_TOPIC_WHITELIST;
   topicWhiteListDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_STRING_ARRAY;
@@ -166,6 +279,16 @@ void declareParameters(rclcpp::Node* node) {
   includeHiddenDescription.read_only = true;
   node->declare_parameter(PARAM_INCLUDE_HIDDEN, false, includeHiddenDescription);
 
+  auto cacheMessageDefinitionsDescription = rcl_interfaces::msg::ParameterDescriptor{};
+  cacheMessageDefinitionsDescription.name = PARAM_CACHE_MESSAGE_DEFINITIONS;
+  cacheMessageDefinitionsDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_BOOL;
+  cacheMessageDefinitionsDescription.description =
+    "Persist resolved message definitions in $ROS_HOME/foxglove_bridge/message_definitions to "
+    "speed up later starts";
+  cacheMessageDefinitionsDescription.read_only = true;
+  node->declare_parameter(PARAM_CACHE_MESSAGE_DEFINITIONS, true,
+                          cacheMessageDefinitionsDescription);
+
   auto disableLoanMessageDescription = rcl_interfaces::msg::ParameterDescriptor{};
   disableLoanMessageDescription.name = PARAM_DISABLE_LOAN_MESSAGE;
   disableLoanMessageDescription.type = rcl_interfaces::msg::ParameterType::PARAMETER_BOOL;
@@ -1,5 +1,11 @@
 #include "foxglove_bridge/parameter_interface.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <iterator>
+#include <string_view>
+
 #include <rcl_interfaces/msg/parameter_event.hpp>
 #include <rclcpp/qos.hpp>
 #include <rclcpp/version.h>
@@ -158,6 +164,18 @@ namespace foxglove_bridge {
 
 using foxglove_bridge::matchesRegex;
 
+// State of one getParams call, shared with the service response callbacks of its node requests.
+// Callbacks may run after getParams has given up waiting; once the batch has expired they must not
+// touch the ParameterInterface.
+struct ParameterInterface::GetParamsBatch {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool expired = false;
+  std::unordered_set<std::string> pendingNodes;
+  std::vector<std::string> failedNodes;
+  ParameterList result;
+};
+
 ParameterList ParameterInterface::cloneParameterList(const ParameterList& other) {
   ParameterList result;
   result.reserve(other.size());
@@ -195,31 +213,28 @@ ParameterList ParameterInterface::getParams(const std::vector<std::string_view>&
                  paramNamesByNodeName.size());
   } else {
     // Make a map of node names to empty parameter lists
-    // Only consider nodes that offer services to list & get parameters.
-    for (const auto& fqnNodeName : _node->get_node_names()) {
-      if (_ignoredNodeNames.find(fqnNodeName) != _ignoredNodeNames.end()) {
-        continue;
-      }
-      const auto [nodeNs, nodeName] = getNodeAndNodeNamespace(fqnNodeName);
-      const auto serviceNamesAndTypes =
-        _node->get_service_names_and_types_by_node(nodeName, nodeNs);
-
-      bool listParamsSrvFound = false, getParamsSrvFound = false;
-      for (const auto& [serviceName, serviceTypes] : serviceNamesAndTypes) {
-        constexpr char GET_PARAMS_SERVICE_TYPE[] = "rcl_interfaces/srv/GetParameters";
-        constexpr char LIST_PARAMS_SERVICE_TYPE[] = "rcl_interfaces/srv/ListParameters";
-
-        if (!getParamsSrvFound) {
-          getParamsSrvFound = std::find(serviceTypes.begin(), serviceTypes.end(),
-                                        GET_PARAMS_SERVICE_TYPE) != serviceTypes.end();
-        }
-        if (!listParamsSrvFound) {
-          listParamsSrvFound = std::find(serviceTypes.begin(), serviceTypes.end(),
-                                         LIST_PARAMS_SERVICE_TYPE) != serviceTypes.end();
+    // Only consider nodes that offer services to list & get parameters. Parameter services are
+    // named <node>/get_parameters and <node>/list_parameters (which is also how
+    // AsyncParametersClient addresses them), so a single graph query finds them for all nodes.
+    constexpr std::pair<std::string_view, std::string_view> PARAM_SERVICES[] = {
+      {"/get_parameters", "rcl_interfaces/srv/GetParameters"},
+      {"/list_parameters", "rcl_interfaces/srv/ListParameters"},
+    };
+    std::unordered_map<std::string, size_t> numParamServicesByNodeName;
+    for (const auto& [serviceName, serviceTypes] : _node->get_service_names_and_types()) {
+      for (const auto& [suffix, serviceType] : PARAM_SERVICES) {
+        if (serviceName.size() > suffix.size() &&
+            std::string_view(serviceName).substr(serviceName.size() - suffix.size()) == suffix &&
+            std::find(serviceTypes.begin(), serviceTypes.end(), serviceType) !=
+              serviceTypes.end()) {
+          ++numParamServicesByNodeName[serviceName.substr(0, serviceName.size() - suffix.size())];
         }
       }
+    }
 
-      if (listParamsSrvFound && getParamsSrvFound) {
+    for (const auto& [fqnNodeName, numParamServices] : numParamServicesByNodeName) {
+      if (numParamServices == std::size(PARAM_SERVICES) &&
+          _ignoredNodeNames.find(fqnNodeName) == _ignoredNodeNames.end()) {
         paramNamesByNodeName.insert({fqnNodeName, {}});
       }
     }
@@ -230,7 +245,12 @@ ParameterList ParameterInterface::getParams(const std::vector<std::string_view>&
     }
   }
 
-  std::unordered_map<std::string, std::future<ParameterList>> getParametersFuture;
+  // Requests to all nodes are in flight at once, and each node's list and get requests are chained
+  // in service response callbacks, so the whole batch completes within a single timeout and an
+  // unresponsive node only costs its own missing values.
+  auto batch = std::make_shared<GetParamsBatch>();
+  std::vector<std::pair<rclcpp::AsyncParametersClient::SharedPtr, std::string>> requests;
+  std::vector<std::string> failedNodes;
   for (const auto& [nodeName, nodeParamNames] : paramNamesByNodeName) {
     if (nodeName == thisNode) {
       continue;
@@ -244,9 +264,21 @@ ParameterList ParameterInterface::getParams(const std::vector<std::string_view>&
       paramClientIt = insertedPair.first;
     }
 
-    getParametersFuture.emplace(
-      nodeName, std::async(std::launch::async, &ParameterInterface::getNodeParameters, this,
-                           paramClientIt->second, nodeName, nodeParamNames, timeout));
+    if (!paramClientIt->second->service_is_ready()) {
+      RCLCPP_ERROR(_node->get_logger(),
+                   "Failed to retrieve parameters from node '%s': parameter service is not ready",
+                   nodeName.c_str());
+      failedNodes.push_back(nodeName);
+      continue;
+    }
+    batch->pendingNodes.insert(nodeName);
+    requests.emplace_back(paramClientIt->second, nodeName);
+  }
+
+  // Register every node as pending before sending any request, since responses may arrive
+  // immediately.
+  for (const auto& [paramClient, nodeName] : requests) {
+    requestNodeParameters(batch, paramClient, nodeName, paramNamesByNodeName.at(nodeName));
   }
 
   // Don't hold _mutex across blocking waits; parameter-event callbacks may need it to make
@@ -254,36 +286,35 @@ ParameterList ParameterInterface::getParams(const std::vector<std::string_view>&
   lock.unlock();
 
   ParameterList result;
-  std::vector<std::string> nodesToIgnore;
-  for (auto& [nodeName, future] : getParametersFuture) {
-    try {
-      // Move the parameters from the future into result. Must be done using rvalue reference
-      // to avoid copying the parameters.
-      for (auto& param : future.get()) {
-        result.push_back(param.clone());
-      }
-    } catch (const std::exception& e) {
-      RCLCPP_ERROR(_node->get_logger(), "Failed to retrieve parameters from node '%s': %s",
-                   nodeName.c_str(), e.what());
-
-      if (_unresponsiveNodePolicy == UnresponsiveNodePolicy::Ignore) {
-        // Certain nodes may fail to handle incoming service requests, for example, if they're
-        // stuck in a busy loop or otherwise unresponsive. In such cases, attempting to retrieve
-        // parameter names or values can result in timeouts. To avoid repeated failures, these nodes
-        // are added to an ignore list, and future parameter-related service calls to them will be
-        // skipped.
-        nodesToIgnore.push_back(nodeName);
-        RCLCPP_WARN(_node->get_logger(),
-                    "Adding node %s to the ignore list to prevent repeated timeouts or failures in "
-                    "future parameter requests.",
-                    nodeName.c_str());
-      }
+  {
+    std::unique_lock<std::mutex> batchLock(batch->mutex);
+    batch->cv.wait_for(batchLock, timeout, [&batch] {
+      return batch->pendingNodes.empty();
+    });
+    // Responses arriving after this point are discarded.
+    batch->expired = true;
+    result = std::move(batch->result);
+    failedNodes.insert(failedNodes.end(), batch->failedNodes.begin(), batch->failedNodes.end());
+    for (const auto& nodeName : batch->pendingNodes) {
+      RCLCPP_ERROR(_node->get_logger(),
+                   "Failed to retrieve parameters from node '%s': timed out after %.1f s",
+                   nodeName.c_str(), timeout.count());
+      failedNodes.push_back(nodeName);
     }
   }
 
-  if (!nodesToIgnore.empty()) {
+  if (_unresponsiveNodePolicy == UnresponsiveNodePolicy::Ignore && !failedNodes.empty()) {
+    // Certain nodes may fail to handle incoming service requests, for example, if they're
+    // stuck in a busy loop or otherwise unresponsive. In such cases, attempting to retrieve
+    // parameter names or values can result in timeouts. To avoid repeated failures, these nodes
+    // are added to an ignore list, and future parameter-related service calls to them will be
+    // skipped.
     lock.lock();
-    for (auto& nodeName : nodesToIgnore) {
+    for (auto& nodeName : failedNodes) {
+      RCLCPP_WARN(_node->get_logger(),
+                  "Adding node %s to the ignore list to prevent repeated timeouts or failures in "
+                  "future parameter requests.",
+                  nodeName.c_str());
       _ignoredNodeNames.insert(std::move(nodeName));
     }
   }
@@ -423,39 +454,81 @@ void ParameterInterface::setParamUpdateCallback(ParamUpdateFunc paramUpdateFunc)
   _paramUpdateFunc = paramUpdateFunc;
 }
 
-ParameterList ParameterInterface::getNodeParameters(
-  const rclcpp::AsyncParametersClient::SharedPtr paramClient, const std::string& nodeName,
-  const std::vector<std::string>& paramNames, const std::chrono::duration<double>& timeout) {
-  if (!paramClient->service_is_ready()) {
-    throw std::runtime_error("Parameter service for node '" + nodeName + "' is not ready");
-  }
+void ParameterInterface::requestNodeParameters(
+  const std::shared_ptr<GetParamsBatch>& batch,
+  const rclcpp::AsyncParametersClient::SharedPtr& paramClient, const std::string& nodeName,
+  const std::vector<std::string>& paramNames) {
+  const auto getParameters = [this, batch, paramClient,
+                              nodeName](const std::vector<std::string>& names) {
+    paramClient->get_parameters(
+      names,
+      [this, batch, nodeName](std::shared_future<std::vector<rclcpp::Parameter>> future) {
+        try {
+          completeNodeRequest(batch, nodeName, future.get(), nullptr);
+        } catch (const std::exception& e) {
+          completeNodeRequest(batch, nodeName, {}, e.what());
+        }
+      });
+  };
 
-  auto paramsToRequest = paramNames;
-  if (paramsToRequest.empty()) {
-    // `paramNames` is empty, list all parameter names for this node
-    auto future = paramClient->list_parameters({}, 0UL);
-    if (std::future_status::ready != future.wait_for(timeout)) {
-      throw std::runtime_error("Failed to retrieve parameter names for node '" + nodeName + "'");
-    }
-    paramsToRequest = future.get().names;
+  if (!paramNames.empty()) {
+    getParameters(paramNames);
+    return;
   }
 
-  // Start parameter fetches and wait for them to complete
-  auto getParamsFuture = paramClient->get_parameters(paramsToRequest);
-  if (std::future_status::ready != getParamsFuture.wait_for(timeout)) {
-    throw std::runtime_error("Timed out waiting for " + std::to_string(paramsToRequest.size()) +
-                             " parameter(s) from node '" + nodeName + "'");
+  // `paramNames` is empty, list all parameter names for this node, then fetch their values
+  paramClient->list_parameters(
+    {}, 0UL,
+    [this, batch, nodeName,
+     getParameters](std::shared_future<rcl_interfaces::msg::ListParametersResult> future) {
+      std::vector<std::string> names;
+      try {
+        names = future.get().names;
+      } catch (const std::exception& e) {
+        completeNodeRequest(batch, nodeName, {}, e.what());
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        if (batch->expired) {
+          return;
+        }
+      }
+      if (names.empty()) {
+        completeNodeRequest(batch, nodeName, {}, nullptr);
+      } else {
+        getParameters(names);
+      }
+    });
+}
+
+void ParameterInterface::completeNodeRequest(const std::shared_ptr<GetParamsBatch>& batch,
+                                             const std::string& nodeName,
+                                             const std::vector<rclcpp::Parameter>& params,
+                                             const char* error) {
+  std::lock_guard<std::mutex> lock(batch->mutex);
+  // Once the batch has expired, getParams may have returned, and this object may be gone.
+  if (batch->expired || batch->pendingNodes.erase(nodeName) == 0) {
+    return;
   }
-  const auto params = getParamsFuture.get();
 
-  ParameterList result;
-  for (const auto& param : params) {
-    const auto fullParamName = prependNodeNameToParamName(param.get_name(), nodeName);
-    if (matchesRegex(fullParamName, _paramWhitelistPatterns)) {
-      result.push_back(fromRosParam(rclcpp::Parameter(fullParamName, param.get_parameter_value())));
+  if (error != nullptr) {
+    RCLCPP_ERROR(_node->get_logger(), "Failed to retrieve parameters from node '%s': %s",
+                 nodeName.c_str(), error);
+    batch->failedNodes.push_back(nodeName);
+  } else {
+    for (const auto& param : params) {
+      const auto fullParamName = prependNodeNameToParamName(param.get_name(), nodeName);
+      if (matchesRegex(fullParamName, _paramWhitelistPatterns)) {
+        batch->result.push_back(
+          fromRosParam(rclcpp::Parameter(fullParamName, param.get_parameter_value())));
+      }
     }
   }
-  return result;
+
+  if (batch->pendingNodes.empty()) {
+    batch->cv.notify_all();
+  }
 }
 
 void ParameterInterface::setNodeParameters(rclcpp::AsyncParametersClient::SharedPtr paramClient,
@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <cctype>
 #include <cinttypes>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <optional>
@@ -8,8 +10,17 @@
 #include <type_traits>
 #include <unordered_set>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <rclcpp/serialization.hpp>
 #include <rclcpp/version.h>
 #include <resource_retriever/retriever.hpp>
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
 
 #include <foxglove_bridge/ros2_foxglove_bridge.hpp>
 #include <foxglove_bridge/utils.hpp>
@@ -94,16 +105,90 @@ inline std::vector<std::byte> readFile(const std::string& filepath) {
   return buffer;
 }
 
-#if !RCLCPP_VERSION_GTE(28, 0, 0)
-// Prior to Jazzy, GenericSubscription drops MessageInfo from the callback.
-// This subclass overrides handle_serialized_message to forward it.
-class GenericSubscriptionWithMessageInfo : public rclcpp::GenericSubscription {
+// Returns the directory that resolved message definitions are persisted in, following the ROS
+// convention of $ROS_HOME, which defaults to ~/.ros.
+std::optional<std::filesystem::path> messageDefinitionCacheDir() {
+  std::filesystem::path rosHome;
+  if (const char* env = std::getenv("ROS_HOME"); env != nullptr && *env != '\0') {
+    rosHome = env;
+  } else if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+    rosHome = std::filesystem::path(home) / ".ros";
+  } else {
+    return std::nullopt;
+  }
+  return rosHome / "foxglove_bridge" / "message_definitions";
+}
+
+// Number of idle serialized message buffers kept per subscription for reuse.
+constexpr size_t SERIALIZED_MESSAGE_POOL_SIZE = 2;
+
+// Threads which publish client messages, and the number of messages a client channel may queue
+// before further messages on it are dropped.
+constexpr size_t MAX_CLIENT_PUBLISH_THREADS = 4;
+constexpr size_t CLIENT_PUBLISH_QUEUE_SIZE = 64;
+
+// How long the ROS graph must be quiet before a change is processed, and the longest a change is
+// deferred while further changes keep arriving.
+constexpr auto GRAPH_UPDATE_DEBOUNCE = std::chrono::milliseconds(50);
+constexpr auto GRAPH_UPDATE_MAX_DELAY = std::chrono::milliseconds(250);
+
+// How long a subscription replaced for a QoS change keeps forwarding messages if its replacement
+// receives none, e.g. because no publisher is currently sending.
+constexpr auto SUBSCRIPTION_HANDOVER_TIMEOUT = std::chrono::seconds(5);
+
+}  // namespace
+
+// A pool of serialized message buffers. The middleware only grows a buffer when a message does not
+// fit, so reusing buffers avoids a fresh allocation (and, for large messages, the page faults of
+// touching new memory) for every message taken. Messages still referenced elsewhere, for example by
+// the transient_local cache or a sink's queue, return to the pool once released.
+class SerializedMessagePool : public std::enable_shared_from_this<SerializedMessagePool> {
+public:
+  std::shared_ptr<rclcpp::SerializedMessage> acquire() {
+    std::unique_ptr<rclcpp::SerializedMessage> msg;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_idle.empty()) {
+        msg = std::move(_idle.back());
+        _idle.pop_back();
+      }
+    }
+    if (!msg) {
+      msg = std::make_unique<rclcpp::SerializedMessage>(0);
+    }
+    std::weak_ptr<SerializedMessagePool> weakPool = shared_from_this();
+    return std::shared_ptr<rclcpp::SerializedMessage>(
+      msg.release(), [weakPool](rclcpp::SerializedMessage* released) {
+        std::unique_ptr<rclcpp::SerializedMessage> owned(released);
+        if (auto pool = weakPool.lock()) {
+          pool->recycle(std::move(owned));
+        }
+      });
+  }
+
+private:
+  void recycle(std::unique_ptr<rclcpp::SerializedMessage> msg) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_idle.size() < SERIALIZED_MESSAGE_POOL_SIZE) {
+      _idle.push_back(std::move(msg));
+    }
+  }
+
+  std::mutex _mutex;
+  std::vector<std::unique_ptr<rclcpp::SerializedMessage>> _idle;
+};
+
+namespace {
+
+// A GenericSubscription that takes messages into buffers from a SerializedMessagePool, and
+// forwards MessageInfo to its callback, which GenericSubscription drops prior to Jazzy.
+class PooledGenericSubscription : public rclcpp::GenericSubscription {
 public:
   using CallbackWithInfoT =
     std::function<void(std::shared_ptr<rclcpp::SerializedMessage>, const rclcpp::MessageInfo&)>;
 
   template <typename AllocatorT = std::allocator<void>>
-  GenericSubscriptionWithMessageInfo(
+  PooledGenericSubscription(
     rclcpp::node_interfaces::NodeBaseInterface* node_base,
     const std::shared_ptr<rcpputils::SharedLibrary> ts_lib, const std::string& topic_name,
     const std::string& topic_type, const rclcpp::QoS& qos, CallbackWithInfoT callback,
@@ -111,10 +196,14 @@ public:
       // The base class callback is never invoked because we override
       // handle_serialized_message below. A no-op is passed to satisfy
       // the constructor signature.
-      : GenericSubscription(
-          node_base, ts_lib, topic_name, topic_type, qos,
-          [](std::shared_ptr<rclcpp::SerializedMessage>) {}, options)
-      , callback_with_info_(std::move(callback)) {}
+      : GenericSubscription(node_base, ts_lib, topic_name, topic_type, qos,
+                            noopCallback<AllocatorT>(), options)
+      , callback_with_info_(std::move(callback))
+      , pool_(std::make_shared<SerializedMessagePool>()) {}
+
+  std::shared_ptr<rclcpp::SerializedMessage> create_serialized_message() override {
+    return pool_->acquire();
+  }
 
   void handle_serialized_message(const std::shared_ptr<rclcpp::SerializedMessage>& message,
                                  const rclcpp::MessageInfo& message_info) override {
@@ -122,9 +211,60 @@ public:
   }
 
 private:
+  template <typename AllocatorT>
+  static auto noopCallback() {
+#if RCLCPP_VERSION_GTE(28, 0, 0)
+    rclcpp::AnySubscriptionCallback<rclcpp::SerializedMessage, AllocatorT> callback;
+    callback.set([](std::shared_ptr<const rclcpp::SerializedMessage>) {});
+    return callback;
+#else
+    return [](std::shared_ptr<rclcpp::SerializedMessage>) {};
+#endif
+  }
+
   CallbackWithInfoT callback_with_info_;
+  std::shared_ptr<SerializedMessagePool> pool_;
 };
-#endif
+
+// Subscribes with a typed subscription, which, unlike a GenericSubscription, can receive messages
+// intra-process: a publisher in the same process hands over its message without the middleware
+// serializing, transporting and copying it. Each message is serialized once, into a buffer from a
+// SerializedMessagePool, and passed on like a message taken by a PooledGenericSubscription.
+template <typename MessageT>
+Subscription createIntraProcessSubscription(rclcpp::Node* node, const std::string& topic,
+                                            const rclcpp::QoS& qos,
+                                            rclcpp::SubscriptionOptions options,
+                                            PooledGenericSubscription::CallbackWithInfoT callback) {
+  options.use_intra_process_comm = rclcpp::IntraProcessSetting::Enable;
+  auto pool = std::make_shared<SerializedMessagePool>();
+  return node->create_subscription<MessageT>(
+    topic, qos,
+    [pool, serialization = rclcpp::Serialization<MessageT>(), callback = std::move(callback)](
+      std::shared_ptr<const MessageT> msg, const rclcpp::MessageInfo& messageInfo) {
+      auto serialized = pool->acquire();
+      serialization.serialize_message(msg.get(), serialized.get());
+      callback(std::move(serialized), messageInfo);
+    },
+    options);
+}
+
+using IntraProcessSubscriptionFactory = Subscription (*)(
+  rclcpp::Node*, const std::string&, const rclcpp::QoS&, rclcpp::SubscriptionOptions,
+  PooledGenericSubscription::CallbackWithInfoT);
+
+// The datatypes that intra_process_topics applies to. Intra-process delivery needs the message
+// type at compile time, so it is limited to the large sensor messages where skipping the
+// middleware pays off.
+const std::unordered_map<std::string, IntraProcessSubscriptionFactory>&
+intraProcessSubscriptionFactories() {
+  static const std::unordered_map<std::string, IntraProcessSubscriptionFactory> FACTORIES = {
+    {"sensor_msgs/msg/CompressedImage",
+     &createIntraProcessSubscription<sensor_msgs::msg::CompressedImage>},
+    {"sensor_msgs/msg/Image", &createIntraProcessSubscription<sensor_msgs::msg::Image>},
+    {"sensor_msgs/msg/PointCloud2", &createIntraProcessSubscription<sensor_msgs::msg::PointCloud2>},
+  };
+  return FACTORIES;
+}
 
 }  // namespace
 
@@ -151,6 +291,8 @@ FoxgloveBridge::FoxgloveBridge(const rclcpp::NodeOptions& options)
   const auto address = this->get_parameter(PARAM_ADDRESS).as_string();
   _minQosDepth = saturatingToSizeT(this->get_parameter(PARAM_MIN_QOS_DEPTH).as_int());
   _maxQosDepth = saturatingToSizeT(this->get_parameter(PARAM_MAX_QOS_DEPTH).as_int());
+  _subscriptionLinger =
+    std::chrono::milliseconds(this->get_parameter(PARAM_SUBSCRIPTION_LINGER_MS).as_int());
   const bool useTls = this->get_parameter(PARAM_USETLS).as_bool();
   const std::string certfile = this->get_parameter(PARAM_CERTFILE).as_string();
   const std::string keyfile = this->get_parameter(PARAM_KEYFILE).as_string();
@@ -172,6 +314,12 @@ FoxgloveBridge::FoxgloveBridge(const rclcpp::NodeOptions& options)
   const auto assetUriAllowlist = this->get_parameter(PARAM_ASSET_URI_ALLOWLIST).as_string_array();
   _assetUriAllowlistPatterns = parseRegexStrings(this, assetUriAllowlist);
   _disableLoanMessage = this->get_parameter(PARAM_DISABLE_LOAN_MESSAGE).as_bool();
+  const auto cacheDir = this->get_parameter(PARAM_CACHE_MESSAGE_DEFINITIONS).as_bool()
+                          ? messageDefinitionCacheDir()
+                          : std::nullopt;
+  _messageDefinitionCache =
+    cacheDir ? std::make_unique<foxglove_bridge::MessageDefinitionCache>(*cacheDir)
+             : std::make_unique<foxglove_bridge::MessageDefinitionCache>();
   const auto ignoreUnresponsiveParamNodes =
     this->get_parameter(PARAM_IGN_UNRESPONSIVE_PARAM_NODES).as_bool();
   const bool publishClientCount = this->get_parameter(PARAM_PUBLISH_CLIENT_COUNT).as_bool();
@@ -219,6 +367,9 @@ FoxgloveBridge::FoxgloveBridge(const rclcpp::NodeOptions& options)
     sdkServerOptions.tls_identity->key = readFile(keyfile);
   }
 
+  _clientPublishPool = std::make_unique<StrandPool>(
+    std::clamp<size_t>(std::thread::hardware_concurrency(), 1, MAX_CLIENT_PUBLISH_THREADS));
+
   // Setup callbacks
   sdkServerOptions.callbacks.onConnectionGraphSubscribe =
     std::bind(&FoxgloveBridge::subscribeConnectionGraph, this, true);
@@ -232,8 +383,8 @@ FoxgloveBridge::FoxgloveBridge(const rclcpp::NodeOptions& options)
       std::bind(&FoxgloveBridge::clientAdvertise, this, _1, _2);
     sdkServerOptions.callbacks.onClientUnadvertise =
       std::bind(&FoxgloveBridge::clientUnadvertise, this, _1, _2);
-    sdkServerOptions.callbacks.onMessageData =
-      std::bind(&FoxgloveBridge::clientMessage, this, _1, _2, _3, _4);
+    sdkServerOptions.callbacks.onMessageDataOwned =
+      std::bind(&FoxgloveBridge::clientMessage, this, _1, _2, _3);
   }
 
   if (hasCapability(_capabilities, foxglove::WebSocketServerCapabilities::Assets)) {
@@ -298,9 +449,14 @@ FoxgloveBridge::FoxgloveBridge(const rclcpp::NodeOptions& options)
   }
 
   _subscriptionCallbackGroup = this->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
-  _clientPublishCallbackGroup =
-    this->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  // Only serves publisher events; client messages are published on _clientPublishPool.
+  _clientPublishCallbackGroup = this->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
   _servicesCallbackGroup = this->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+  startIsolatedExecutors(this->get_parameter(PARAM_ISOLATED_TOPIC_EXECUTORS).as_string_array());
+  parseTopicMaxRates(this->get_parameter(PARAM_TOPIC_MAX_RATES).as_string_array());
+  _intraProcessTopicPatterns =
+    parseRegexStrings(this, this->get_parameter(PARAM_INTRA_PROCESS_TOPICS).as_string_array());
+  _recordThrottledTopics = this->get_parameter(PARAM_RECORD_THROTTLED_TOPICS).as_bool();
 
   if (_useSimTime) {
     _clockSubscription = this->create_subscription<rosgraph_msgs::msg::Clock>(
@@ -434,6 +590,11 @@ FoxgloveBridge::FoxgloveBridge(const rclcpp::NodeOptions& options)
   }
 #endif
 
+  if (const auto recordPath = this->get_parameter(PARAM_RECORD_PATH).as_string();
+      !recordPath.empty()) {
+    startRecording(recordPath);
+  }
+
   if (_paramInterface) {
     _paramWorkerThread =
       std::make_unique<std::thread>(std::bind(&FoxgloveBridge::parameterWorkerLoop, this));
@@ -449,6 +610,7 @@ FoxgloveBridge::~FoxgloveBridge() {
   if (_rosgraphPollThread) {
     _rosgraphPollThread->join();
   }
+  stopIsolatedExecutors();
   if (_sysinfoPublisher) {
     _sysinfoPublisher->stop();
   }
@@ -458,6 +620,14 @@ FoxgloveBridge::~FoxgloveBridge() {
   }
 #endif
   _server->stop();
+  // Drop client messages which haven't been published yet, now that no more can arrive.
+  _clientPublishPool.reset();
+  if (_mcapWriter) {
+    const auto error = _mcapWriter->close();
+    if (error != foxglove::FoxgloveError::Ok) {
+      RCLCPP_ERROR(this->get_logger(), "Failed to close recording: %s", foxglove::strerror(error));
+    }
+  }
   // Stop the parameter worker after the server and gateway are stopped, so no new ops
   // arrive while we're shutting it down. Any ops still in the queue get dropped.
   if (_paramWorkerThread) {
@@ -473,6 +643,138 @@ FoxgloveBridge::~FoxgloveBridge() {
   RCLCPP_INFO(this->get_logger(), "Shutdown complete");
 }
 
+void FoxgloveBridge::startRecording(const std::string& path) {
+  _recordTopicPatterns =
+    parseRegexStrings(this, this->get_parameter(PARAM_RECORD_TOPIC_WHITELIST).as_string_array());
+  const auto compressionName = this->get_parameter(PARAM_RECORD_COMPRESSION).as_string();
+  const auto compression = parseMcapCompression(compressionName);
+  if (!compression.has_value()) {
+    throw std::invalid_argument("Unsupported record_compression '" + compressionName +
+                                "': must be one of zstd, lz4, none");
+  }
+  const auto rotationMaxBytes =
+    static_cast<uint64_t>(this->get_parameter(PARAM_RECORD_ROTATION_MAX_BYTES).as_int());
+  const auto rotationMaxDuration =
+    std::chrono::seconds(this->get_parameter(PARAM_RECORD_ROTATION_MAX_DURATION).as_int());
+  const bool rotate = rotationMaxBytes > 0 || rotationMaxDuration.count() > 0;
+  const std::string pathTemplate = rotate ? mcapRotationPathTemplate(path) : path;
+
+  foxglove::McapWriterOptions options;
+  options.context = _serverContext;
+  options.path = pathTemplate;
+  options.profile = "ros2";
+  options.compression = *compression;
+  options.rotation_max_bytes = rotationMaxBytes;
+  if (rotationMaxDuration.count() > 0) {
+    options.rotation_max_duration = rotationMaxDuration;
+  }
+  // Messages are logged from executor threads; keep compression and disk I/O off them.
+  options.async_writes = true;
+  options.sink_channel_filter = [this](const foxglove::ChannelDescriptor& channel) {
+    return matchesRegex(std::string(channel.topic()), _recordTopicPatterns);
+  };
+
+  auto maybeWriter = foxglove::McapWriter::create(options);
+  if (!maybeWriter.has_value()) {
+    throw std::runtime_error("Failed to start recording to " + pathTemplate + ": " +
+                             foxglove::strerror(maybeWriter.error()));
+  }
+  _mcapWriter = std::make_unique<foxglove::McapWriter>(std::move(maybeWriter.value()));
+  RCLCPP_INFO(this->get_logger(), "Recording to %s", pathTemplate.c_str());
+}
+
+void FoxgloveBridge::startIsolatedExecutors(const std::vector<std::string>& entries) {
+  for (const auto& entry : entries) {
+    IsolatedExecutor isolated;
+    std::optional<int> cpu;
+    try {
+      auto config = parseIsolatedTopicExecutor(entry);
+      isolated.pattern = compileTopicRegex(config.pattern);
+      cpu = config.cpu;
+    } catch (const std::exception& ex) {
+      RCLCPP_ERROR(this->get_logger(), "Ignoring invalid isolated topic executor '%s': %s",
+                   entry.c_str(), ex.what());
+      continue;
+    }
+
+    // Mutually exclusive, since the group is only spun by one thread anyway.
+    isolated.callbackGroup =
+      this->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+    isolated.executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    isolated.executor->add_callback_group(isolated.callbackGroup, this->get_node_base_interface());
+    isolated.thread = std::thread([executor = isolated.executor] {
+      executor->spin();
+    });
+
+    if (cpu.has_value()) {
+#ifdef __linux__
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      CPU_SET(*cpu, &cpuSet);
+      const int err =
+        pthread_setaffinity_np(isolated.thread.native_handle(), sizeof(cpuSet), &cpuSet);
+      if (err != 0) {
+        RCLCPP_WARN(this->get_logger(), "Failed to pin executor for '%s' to CPU %d: %s",
+                    entry.c_str(), *cpu, std::strerror(err));
+      }
+#else
+      RCLCPP_WARN(this->get_logger(),
+                  "Pinning executor threads to CPUs is not supported on this platform");
+#endif
+    }
+
+    RCLCPP_INFO(this->get_logger(), "Topics matching '%s' are served by a dedicated executor",
+                entry.c_str());
+    _isolatedExecutors.push_back(std::move(isolated));
+  }
+}
+
+void FoxgloveBridge::parseTopicMaxRates(const std::vector<std::string>& entries) {
+  for (const auto& entry : entries) {
+    try {
+      const auto config = parseTopicMaxRate(entry);
+      const auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(1.0 / config.maxRate));
+      _topicMinIntervals.emplace_back(compileTopicRegex(config.pattern), interval);
+      RCLCPP_INFO(this->get_logger(), "Topics matching '%s' are forwarded at most %g times/s",
+                  config.pattern.c_str(), config.maxRate);
+    } catch (const std::exception& ex) {
+      RCLCPP_ERROR(this->get_logger(), "Ignoring invalid topic max rate '%s': %s", entry.c_str(),
+                   ex.what());
+    }
+  }
+}
+
+std::chrono::nanoseconds FoxgloveBridge::topicMinForwardInterval(const std::string& topic) const {
+  for (const auto& [pattern, interval] : _topicMinIntervals) {
+    if (std::regex_match(topic, pattern)) {
+      return interval;
+    }
+  }
+  return std::chrono::nanoseconds::zero();
+}
+
+void FoxgloveBridge::stopIsolatedExecutors() {
+  for (auto& isolated : _isolatedExecutors) {
+    isolated.executor->cancel();
+  }
+  for (auto& isolated : _isolatedExecutors) {
+    if (isolated.thread.joinable()) {
+      isolated.thread.join();
+    }
+  }
+}
+
+rclcpp::CallbackGroup::SharedPtr FoxgloveBridge::subscriptionCallbackGroup(
+  const std::string& topic) const {
+  for (const auto& isolated : _isolatedExecutors) {
+    if (std::regex_match(topic, isolated.pattern)) {
+      return isolated.callbackGroup;
+    }
+  }
+  return _subscriptionCallbackGroup;
+}
+
 void FoxgloveBridge::rosgraphPollThread() {
   updateAdvertisedTopics(get_topic_names_and_types());
   updateAdvertisedServices();
@@ -484,15 +786,35 @@ void FoxgloveBridge::rosgraphPollThread() {
       bool triggered = graphEvent->check_and_clear();
       if (triggered) {
         RCLCPP_DEBUG(this->get_logger(), "rosgraph change detected");
+        // Subscribe requests arriving while the burst settles must not see QoS cached before it.
+        invalidateTopicQosCache();
+        // Graph changes tend to come in bursts, e.g. when a node starts and advertises all of its
+        // topics. Wait until the graph has been quiet for a moment, bounded by a maximum delay, so
+        // that a burst is handled in a single update.
+        const auto deadline = std::chrono::steady_clock::now() + GRAPH_UPDATE_MAX_DELAY;
+        while (!_shuttingDown && rclcpp::ok()) {
+          const auto remaining = deadline - std::chrono::steady_clock::now();
+          if (remaining <= std::chrono::steady_clock::duration::zero()) {
+            break;
+          }
+          this->wait_for_graph_change(
+            graphEvent, std::min<std::chrono::nanoseconds>(GRAPH_UPDATE_DEBOUNCE, remaining));
+          if (!graphEvent->check_and_clear()) {
+            break;
+          }
+        }
+        // Also drop QoS cached while the burst was settling.
+        invalidateTopicQosCache();
         const auto topicNamesAndTypes = get_topic_names_and_types();
         updateAdvertisedTopics(topicNamesAndTypes);
+        updateSubscriptionQos();
         updateAdvertisedServices();
         if (_graphSubscriptionCount > 0) {
           updateConnectionGraph(topicNamesAndTypes);
         }
-        // Graph changes tend to come in batches, so wait a bit before checking again
-        std::this_thread::sleep_for(500ms);
       }
+      retireReplacedSubscriptions();
+      removeLingeringSubscriptions();
     } catch (const std::exception& ex) {
       RCLCPP_ERROR(this->get_logger(), "Exception thrown in rosgraphPollThread: %s", ex.what());
     }
@@ -507,82 +829,76 @@ void FoxgloveBridge::updateAdvertisedTopics(
     return;
   }
 
-  std::unordered_set<TopicAndDatatype, PairHash> latestTopics;
-  latestTopics.reserve(topicNamesAndTypes.size());
-  for (const auto& topicNamesAndType : topicNamesAndTypes) {
-    const auto& topicName = topicNamesAndType.first;
-    const auto& datatypes = topicNamesAndType.second;
+  // Only (topic, datatype) pairs that changed since the previous update need any work, so updates
+  // stay cheap on graphs with thousands of topics.
+  const auto diff = diffNamesAndTypes(_topicNamesAndTypes, topicNamesAndTypes);
+  _topicNamesAndTypes = topicNamesAndTypes;
+  // Drops a pair from the snapshot, so that it is reported as added, and retried, next time.
+  const auto retryLater = [this](const TopicAndDatatype& topicAndDatatype) {
+    auto& datatypes = _topicNamesAndTypes[topicAndDatatype.first];
+    datatypes.erase(std::remove(datatypes.begin(), datatypes.end(), topicAndDatatype.second),
+                    datatypes.end());
+  };
 
-    // Ignore hidden topics if not explicitly included
-    if (!_includeHidden && isHiddenTopicOrService(topicName)) {
-      continue;
-    }
+  // Ignore hidden topics if not explicitly included, and topics not on the topic whitelist. Both
+  // filters are fixed at startup, so a topic only needs to be checked when it appears.
+  const auto isIgnored = [this](const std::string& topic) {
+    return (!_includeHidden && isHiddenTopicOrService(topic)) ||
+           !matchesRegex(topic, _topicWhitelistPatterns);
+  };
 
-    // Ignore the topic if it is not on the topic whitelist
-    if (matchesRegex(topicName, _topicWhitelistPatterns)) {
-      for (const auto& datatype : datatypes) {
-        latestTopics.emplace(topicName, datatype);
-      }
+  // Resolve the schemas of new topics in parallel before taking _subscriptionsMutex, so that
+  // reading definition files neither serializes startup nor blocks subscribe requests.
+  std::vector<std::string> newSchemaNames;
+  for (const auto& [topic, schemaName] : diff.added) {
+    if (!isIgnored(topic)) {
+      newSchemaNames.push_back(schemaName);
     }
   }
-
-  if (const auto numIgnoredTopics = topicNamesAndTypes.size() - latestTopics.size()) {
-    RCLCPP_DEBUG(
-      this->get_logger(),
-      "%zu topics have been ignored as they do not match any pattern on the topic whitelist",
-      numIgnoredTopics);
-  }
+  std::sort(newSchemaNames.begin(), newSchemaNames.end());
+  newSchemaNames.erase(std::unique(newSchemaNames.begin(), newSchemaNames.end()),
+                       newSchemaNames.end());
+  _messageDefinitionCache->prefetch(newSchemaNames);
 
   // Collect channels to close outside the lock to avoid deadlock:
   // channel.close() can fire onUnsubscribe callbacks that re-acquire _subscriptionsMutex.
-  std::vector<foxglove::RawChannel> channelsToClose;
+  std::vector<std::shared_ptr<foxglove::RawChannel>> channelsToClose;
 
   {
     std::lock_guard<std::mutex> lock(_subscriptionsMutex);
 
     // Remove channels for which the topic does not exist anymore
-    for (auto channelIt = _channels.begin(); channelIt != _channels.end();) {
-      auto& channel = channelIt->second;
-      const auto channelSchema = channel.schema();
-      // Channels advertised without a schema (definition lookup failed) have no schema name.
-      // Accessing .value() unconditionally would throw bad_optional_access and abort the whole
-      // topic update, permanently stopping advertisement of new topics. Match those channels by
-      // topic alone.
-      std::string schemaName = channelSchema.has_value() ? channelSchema->name : "";
-      std::string topic(channel.topic());
-      const TopicAndDatatype topicAndSchemaName = {topic, schemaName};
-      const bool topicStillExists =
-        channelSchema.has_value() ? latestTopics.find(topicAndSchemaName) != latestTopics.end()
-                                  : std::any_of(latestTopics.begin(), latestTopics.end(),
-                                                [&topic](const TopicAndDatatype& topicAndDatatype) {
-                                                  return topicAndDatatype.first == topic;
-                                                });
-      if (!topicStillExists) {
-        const auto channelId = channel.id();
-        RCLCPP_INFO(this->get_logger(), "Removing channel %" PRIu64 " for topic \"%s\" (%s)",
-                    static_cast<uint64_t>(channelId), topic.c_str(), schemaName.c_str());
-        // Remove any active subscriptions for this channel
-        _subscriptions.erase(channelId);
-        channelsToClose.push_back(std::move(channel));
-        channelIt = _channels.erase(channelIt);
-      } else {
-        channelIt++;
+    for (const auto& topicAndDatatype : diff.removed) {
+      const auto indexIt = _channelIdsByTopic.find(topicAndDatatype);
+      if (indexIt == _channelIdsByTopic.end()) {
+        continue;
+      }
+      const ChannelId channelId = indexIt->second;
+      _channelIdsByTopic.erase(indexIt);
+      auto channelIt = _channels.find(channelId);
+      if (channelIt == _channels.end()) {
+        continue;
       }
+      RCLCPP_INFO(this->get_logger(), "Removing channel %" PRIu64 " for topic \"%s\" (%s)",
+                  static_cast<uint64_t>(channelId), topicAndDatatype.first.c_str(),
+                  topicAndDatatype.second.c_str());
+      // Remove any active subscriptions for this channel
+      _subscriptions.erase(channelId);
+      channelsToClose.push_back(std::move(channelIt->second));
+      _channels.erase(channelIt);
     }
 
     // Advertise new topics
-    for (const auto& topicAndDatatype : latestTopics) {
+    size_t numIgnoredTopics = 0;
+    for (const auto& topicAndDatatype : diff.added) {
       const auto& topic = topicAndDatatype.first;
       const auto& schemaName = topicAndDatatype.second;
 
-      if (std::find_if(_channels.begin(), _channels.end(), [&topic, &schemaName](const auto& kvp) {
-            const auto& [channelId, channel] = kvp;
-            const auto channelSchema = channel.schema();
-            // A channel without a schema (definition lookup failed) matches by topic alone so
-            // that the topic is not re-advertised on every graph change.
-            return channel.topic() == topic &&
-                   (!channelSchema.has_value() || channelSchema->name == schemaName);
-          }) != _channels.end()) {
+      if (isIgnored(topic)) {
+        ++numIgnoredTopics;
+        continue;
+      }
+      if (_channelIdsByTopic.find(topicAndDatatype) != _channelIdsByTopic.end()) {
         continue;
       }
 
@@ -593,7 +909,7 @@ void FoxgloveBridge::updateAdvertisedTopics(
       std::string messageEncoding;
 
       try {
-        auto [format, msgDefinition] = _messageDefinitionCache.get_full_text(schemaName);
+        auto [format, msgDefinition] = _messageDefinitionCache->get_full_text(schemaName);
         schema->data_len = msgDefinition.size();
         schema->data = reinterpret_cast<const std::byte*>(msgDefinition.data());
 
@@ -609,6 +925,7 @@ void FoxgloveBridge::updateAdvertisedTopics(
           default:
             RCLCPP_WARN(this->get_logger(), "Unsupported message definition format for type %s",
                         schemaName.c_str());
+            retryLater(topicAndDatatype);
             continue;
         }
       } catch (const foxglove_bridge::DefinitionNotFoundError& err) {
@@ -620,6 +937,7 @@ void FoxgloveBridge::updateAdvertisedTopics(
         RCLCPP_ERROR(this->get_logger(),
                      "Failed to load schemaDefinition for topic \"%s\" (%s): %s", topic.c_str(),
                      schemaName.c_str(), err.what());
+        retryLater(topicAndDatatype);
         continue;
       }
 
@@ -629,13 +947,27 @@ void FoxgloveBridge::updateAdvertisedTopics(
       if (!channelResult.has_value()) {
         RCLCPP_ERROR(this->get_logger(), "Failed to create channel for topic \"%s\" (%s)",
                      topic.c_str(), foxglove::strerror(channelResult.error()));
+        retryLater(topicAndDatatype);
         continue;
       }
 
       const ChannelId channelId = channelResult.value().id();
       RCLCPP_INFO(this->get_logger(), "Advertising new channel %" PRIu64 " for topic \"%s\"",
                   static_cast<uint64_t>(channelId), topic.c_str());
-      _channels.insert({channelId, std::move(channelResult.value())});
+      _channelIdsByTopic.emplace(topicAndDatatype, channelId);
+      _channels.insert(
+        {channelId, std::make_shared<foxglove::RawChannel>(std::move(channelResult.value()))});
+
+      if (_mcapWriter && matchesRegex(topic, _recordTopicPatterns)) {
+        recordChannelLocked(channelId);
+      }
+    }
+
+    if (numIgnoredTopics > 0) {
+      RCLCPP_DEBUG(
+        this->get_logger(),
+        "%zu topics have been ignored as they do not match any pattern on the topic whitelist",
+        numIgnoredTopics);
     }
   }
 
@@ -644,10 +976,11 @@ void FoxgloveBridge::updateAdvertisedTopics(
   //
   // This is safe to do outside of the lock because this function is only called
   // single-threaded from rosgraphPollThread, and the removal of the channel
-  // from _channels mean both createOrIncrementSubscriptionLocked and
-  // rosMessageHandler gracefully ignore channels they can't find.
+  // from _channels means createOrIncrementSubscriptionLocked ignores it. A
+  // rosMessageHandler call that is still in flight keeps the channel alive
+  // through its MessageState, and logging to a closed channel is a no-op.
   for (auto& channel : channelsToClose) {
-    channel.close();
+    channel->close();
   }
 }
 
@@ -660,13 +993,35 @@ void FoxgloveBridge::updateAdvertisedServices() {
 
   // Get the current list of visible services and datatypes from the ROS graph
   const auto serviceNamesAndTypes = this->get_node_graph_interface()->get_service_names_and_types();
+  if (serviceNamesAndTypes == _serviceNamesAndTypes) {
+    return;
+  }
+  const auto diff = diffNamesAndTypes(_serviceNamesAndTypes, serviceNamesAndTypes);
+  _serviceNamesAndTypes = serviceNamesAndTypes;
+
+  // Services that appeared since the previous update and pass the hidden and whitelist filters
+  std::vector<std::string> newServices;
+  std::vector<std::string> newSchemaNames;
+  for (const auto& [serviceName, _] : diff.added) {
+    if ((!newServices.empty() && newServices.back() == serviceName) ||
+        (!_includeHidden && isHiddenTopicOrService(serviceName)) ||
+        !matchesRegex(serviceName, _serviceWhitelistPatterns)) {
+      continue;
+    }
+    newServices.push_back(serviceName);
+    const auto& serviceType = serviceNamesAndTypes.at(serviceName).front();
+    newSchemaNames.push_back(serviceType + foxglove_bridge::SERVICE_REQUEST_MESSAGE_SUFFIX);
+    newSchemaNames.push_back(serviceType + foxglove_bridge::SERVICE_RESPONSE_MESSAGE_SUFFIX);
+  }
+  _messageDefinitionCache->prefetch(newSchemaNames);
 
   std::lock_guard<std::mutex> lock(_servicesMutex);
 
   // Remove advertisements for services that have been removed
   std::vector<std::string> servicesToRemove;
-  for (const auto& [serviceName, _] : _advertisedServices) {
-    if (serviceNamesAndTypes.find(serviceName) == serviceNamesAndTypes.end()) {
+  for (const auto& [serviceName, _] : diff.removed) {
+    if (_advertisedServices.find(serviceName) != _advertisedServices.end() &&
+        serviceNamesAndTypes.find(serviceName) == serviceNamesAndTypes.end()) {
       servicesToRemove.push_back(serviceName);
     }
   }
@@ -691,26 +1046,14 @@ void FoxgloveBridge::updateAdvertisedServices() {
   }
 
   // Advertise new services
-  for (const auto& serviceNamesAndType : serviceNamesAndTypes) {
-    const auto& serviceName = serviceNamesAndType.first;
-    const auto& datatypes = serviceNamesAndType.second;
-    const auto& serviceType = datatypes.front();
+  for (const auto& serviceName : newServices) {
+    const auto& serviceType = serviceNamesAndTypes.at(serviceName).front();
 
     // Ignore the service if it's already advertised
     if (_advertisedServices.find(serviceName) != _advertisedServices.end()) {
       continue;
     }
 
-    // Ignore hidden services if not explicitly included
-    if (!_includeHidden && isHiddenTopicOrService(serviceName)) {
-      continue;
-    }
-
-    // Ignore the service if it is not on the service whitelist
-    if (!matchesRegex(serviceName, _serviceWhitelistPatterns)) {
-      continue;
-    }
-
     foxglove::ServiceSchema serviceSchema;
     serviceSchema.name = serviceType;
 
@@ -718,8 +1061,8 @@ void FoxgloveBridge::updateAdvertisedServices() {
     try {
       const auto requestTypeName = serviceType + foxglove_bridge::SERVICE_REQUEST_MESSAGE_SUFFIX;
       const auto responseTypeName = serviceType + foxglove_bridge::SERVICE_RESPONSE_MESSAGE_SUFFIX;
-      const auto& [format, reqSchema] = _messageDefinitionCache.get_full_text(requestTypeName);
-      const auto& resSchema = _messageDefinitionCache.get_full_text(responseTypeName).second;
+      const auto& [format, reqSchema] = _messageDefinitionCache->get_full_text(requestTypeName);
+      const auto& resSchema = _messageDefinitionCache->get_full_text(responseTypeName).second;
       std::string schemaEncoding = "";
       std::string messageEncoding = "";
       switch (format) {
@@ -825,12 +1168,21 @@ void FoxgloveBridge::updateAdvertisedServices() {
 
     _advertisedServices.insert({serviceName, serviceType});
   }
+
+  // Drop services that should have been advertised but failed from the snapshot, so that they are
+  // retried on the next update.
+  for (const auto& serviceName : newServices) {
+    if (_advertisedServices.find(serviceName) == _advertisedServices.end() &&
+        (_includeHidden || !isHiddenTopicOrService(serviceName)) &&
+        matchesRegex(serviceName, _serviceWhitelistPatterns)) {
+      _serviceNamesAndTypes.erase(serviceName);
+    }
+  }
 }
 
 void FoxgloveBridge::updateConnectionGraph(
   const std::map<std::string, std::vector<std::string>>& topicNamesAndTypes) {
   MapOfSets publishers, subscribers;
-  foxglove::ConnectionGraph connectionGraph;
 
   for (const auto& topicNameAndType : topicNamesAndTypes) {
     const auto& topicName = topicNameAndType.first;
@@ -853,11 +1205,6 @@ void FoxgloveBridge::updateConnectionGraph(
     }
     publishers.emplace(topicName, publisherIds);
     subscribers.emplace(topicName, subscriberIds);
-
-    std::vector<std::string> publisherIdsVec(publisherIds.begin(), publisherIds.end());
-    std::vector<std::string> subscriberIdsVec(subscriberIds.begin(), subscriberIds.end());
-    connectionGraph.setPublishedTopic(topicName, publisherIdsVec);
-    connectionGraph.setSubscribedTopic(topicName, subscriberIdsVec);
   }
 
   MapOfSets services;
@@ -872,16 +1219,66 @@ void FoxgloveBridge::updateConnectionGraph(
       }
     }
   }
-  for (const auto& [serviceName, providerIds] : services) {
-    connectionGraph.setAdvertisedService(serviceName,
-                                         std::vector(providerIds.begin(), providerIds.end()));
+
+  // Compare with the graph which was last published, so that only the changes are sent.
+  using Ids = std::vector<std::string>;
+  std::vector<std::pair<std::string, Ids>> changedPublishers, changedSubscribers, changedServices;
+  std::vector<std::string> removedTopics, removedServices;
+  const auto diff = [](const MapOfSets& previous, const MapOfSets& current,
+                       std::vector<std::pair<std::string, Ids>>& changed) {
+    for (const auto& [name, ids] : current) {
+      const auto it = previous.find(name);
+      if (it == previous.end() || it->second != ids) {
+        changed.emplace_back(name, Ids(ids.begin(), ids.end()));
+      }
+    }
+  };
+  diff(_graphPublishers, publishers, changedPublishers);
+  diff(_graphSubscribers, subscribers, changedSubscribers);
+  diff(_graphServices, services, changedServices);
+  for (const auto& [topicName, _] : _graphPublishers) {
+    if (publishers.find(topicName) == publishers.end()) {
+      removedTopics.push_back(topicName);
+    }
+  }
+  for (const auto& [serviceName, _] : _graphServices) {
+    if (services.find(serviceName) == services.end()) {
+      removedServices.push_back(serviceName);
+    }
+  }
+  if (changedPublishers.empty() && changedSubscribers.empty() && changedServices.empty() &&
+      removedTopics.empty() && removedServices.empty()) {
+    return;
   }
+  _graphPublishers = std::move(publishers);
+  _graphSubscribers = std::move(subscribers);
+  _graphServices = std::move(services);
 
-  RCLCPP_INFO(this->get_logger(), "publishing connection graph");
-  _server->publishConnectionGraph(connectionGraph);
+  const auto makePatch = [&] {
+    foxglove::ConnectionGraphPatch patch;
+    for (const auto& [topicName, ids] : changedPublishers) {
+      patch.setPublishedTopic(topicName, ids);
+    }
+    for (const auto& [topicName, ids] : changedSubscribers) {
+      patch.setSubscribedTopic(topicName, ids);
+    }
+    for (const auto& [serviceName, ids] : changedServices) {
+      patch.setAdvertisedService(serviceName, ids);
+    }
+    for (const auto& topicName : removedTopics) {
+      patch.removeTopic(topicName);
+    }
+    for (const auto& serviceName : removedServices) {
+      patch.removeService(serviceName);
+    }
+    return patch;
+  };
+
+  RCLCPP_INFO(this->get_logger(), "publishing connection graph changes");
+  (void)_server->updateConnectionGraph(makePatch());
 #ifdef FOXGLOVE_REMOTE_ACCESS
   if (_gateway) {
-    (void)_gateway->publishConnectionGraph(connectionGraph);
+    (void)_gateway->updateConnectionGraph(makePatch());
   }
 #endif
 }
@@ -904,9 +1301,11 @@ void FoxgloveBridge::subscribe(ChannelId channelId, const foxglove::ClientMetada
   createOrIncrementSubscription(channelId, client.id, false, client.sink_id);
 }
 
-Subscription FoxgloveBridge::createRosSubscription(ChannelId channelId, const std::string& topic,
+Subscription FoxgloveBridge::createRosSubscription(const std::string& topic,
                                                    const std::string& datatype,
-                                                   const rclcpp::QoS& qos) {
+                                                   const rclcpp::QoS& qos,
+                                                   std::shared_ptr<MessageState> messageState,
+                                                   uint32_t generation) {
   rclcpp::SubscriptionEventCallbacks eventCallbacks;
   eventCallbacks.incompatible_qos_callback =
     [this, topic, datatype](const rclcpp::QOSRequestedIncompatibleQoSInfo&) {
@@ -916,29 +1315,39 @@ Subscription FoxgloveBridge::createRosSubscription(ChannelId channelId, const st
 
   rclcpp::SubscriptionOptions subscriptionOptions;
   subscriptionOptions.event_callbacks = eventCallbacks;
-  subscriptionOptions.callback_group = _subscriptionCallbackGroup;
+  subscriptionOptions.callback_group = subscriptionCallbackGroup(topic);
+
+  PooledGenericSubscription::CallbackWithInfoT callback =
+    [this, messageState, generation](std::shared_ptr<rclcpp::SerializedMessage> msg,
+                                     const rclcpp::MessageInfo& messageInfo) {
+      if (acceptSubscriptionGeneration(messageState->activeGeneration, generation)) {
+        this->rosMessageHandler(*messageState, msg, messageInfo);
+      }
+    };
+
+  // Intra-process messages carry no publisher GID, which the transient_local cache is keyed by,
+  // and not every distro supports intra-process transient_local subscriptions.
+  if (qos.durability() == rclcpp::DurabilityPolicy::Volatile &&
+      matchesRegex(topic, _intraProcessTopicPatterns)) {
+    const auto& factories = intraProcessSubscriptionFactories();
+    if (const auto factoryIt = factories.find(datatype); factoryIt != factories.end()) {
+      RCLCPP_INFO(this->get_logger(), "Subscribing to %s with intra-process communication",
+                  topic.c_str());
+      return factoryIt->second(this, topic, qos, subscriptionOptions, std::move(callback));
+    }
+    RCLCPP_WARN(this->get_logger(),
+                "Topic %s matches intra_process_topics, but its type %s is not supported; "
+                "subscribing through the middleware",
+                topic.c_str(), datatype.c_str());
+  }
 
-#if RCLCPP_VERSION_GTE(28, 0, 0)
-  return this->create_generic_subscription(
-    topic, datatype, qos,
-    [this, channelId](std::shared_ptr<const rclcpp::SerializedMessage> msg,
-                      const rclcpp::MessageInfo& messageInfo) {
-      this->rosMessageHandler(channelId, msg, messageInfo);
-    },
-    subscriptionOptions);
-#else
   auto ts_lib = rclcpp::get_typesupport_library(datatype, "rosidl_typesupport_cpp");
-  auto subscription = std::make_shared<GenericSubscriptionWithMessageInfo>(
+  auto subscription = std::make_shared<PooledGenericSubscription>(
     this->get_node_base_interface().get(), std::move(ts_lib), topic, datatype, qos,
-    [this, channelId](std::shared_ptr<rclcpp::SerializedMessage> msg,
-                      const rclcpp::MessageInfo& messageInfo) {
-      this->rosMessageHandler(channelId, msg, messageInfo);
-    },
-    subscriptionOptions);
+    std::move(callback), subscriptionOptions);
   this->get_node_topics_interface()->add_subscription(subscription,
                                                       subscriptionOptions.callback_group);
   return subscription;
-#endif
 }
 
 void FoxgloveBridge::createOrIncrementSubscription(ChannelId channelId, ClientId clientId,
@@ -947,20 +1356,19 @@ void FoxgloveBridge::createOrIncrementSubscription(ChannelId channelId, ClientId
   createOrIncrementSubscriptionLocked(channelId, clientId, isGateway, sinkId);
 }
 
-void FoxgloveBridge::createOrIncrementSubscriptionLocked(ChannelId channelId, ClientId clientId,
-                                                         bool isGateway,
-                                                         std::optional<SinkId> sinkId) {
+std::unordered_map<ChannelId, FoxgloveBridge::ChannelSubscription>::iterator
+FoxgloveBridge::findOrCreateSubscriptionLocked(ChannelId channelId, bool& isNewSubscription) {
   auto channelIt = _channels.find(channelId);
   if (channelIt == _channels.end()) {
     RCLCPP_ERROR(this->get_logger(), "received subscribe request for unknown channel: %" PRIu64,
                  static_cast<uint64_t>(channelId));
-    return;
+    return _subscriptions.end();
   }
 
-  auto& channel = channelIt->second;
+  auto& channel = *channelIt->second;
 
   auto subIt = _subscriptions.find(channelId);
-  bool isNewSubscription = (subIt == _subscriptions.end());
+  isNewSubscription = (subIt == _subscriptions.end());
 
   if (isNewSubscription) {
     // First subscriber for this channel -- create the ROS subscription
@@ -978,38 +1386,158 @@ void FoxgloveBridge::createOrIncrementSubscriptionLocked(ChannelId channelId, Cl
                      "Cannot subscribe to topic \"%s\" on channel %" PRIu64
                      ": no schema and no matching topic in the ROS graph",
                      topic.c_str(), static_cast<uint64_t>(channelId));
-        return;
+        return _subscriptions.end();
       }
       datatype = topicIt->second.front();
     }
     const rclcpp::QoS qos = determineQoS(topic);
 
+    auto messageState = std::make_shared<MessageState>();
+    messageState->channel = channelIt->second;
+    messageState->transientLocal = qos.durability() == rclcpp::DurabilityPolicy::TransientLocal;
+    if (messageState->transientLocal) {
+      initPublisherCaches(*messageState, topic);
+    }
+    messageState->minForwardIntervalNs = topicMinForwardInterval(topic).count();
+    if (messageState->minForwardIntervalNs > 0 && _mcapWriter && !_recordThrottledTopics &&
+        matchesRegex(topic, _recordTopicPatterns)) {
+      messageState->unthrottledSinkId = _mcapWriter->sinkId();
+    }
+
     ChannelSubscription channelSub;
-    channelSub.rosSubscription = createRosSubscription(channelId, topic, datatype, qos);
+    channelSub.messageState = messageState;
+    channelSub.datatype = datatype;
     channelSub.qos = qos;
-
-    if (qos.durability() == rclcpp::DurabilityPolicy::TransientLocal) {
-      for (const auto& pub : this->get_publishers_info_by_topic(topic)) {
-        Gid gid = pub.endpoint_gid();
-        channelSub.publisherCaches[gid].maxMessages =
-          std::max(static_cast<size_t>(1), pub.qos_profile().depth());
-      }
-    }
+    channelSub.rosSubscription = createRosSubscription(topic, datatype, qos, messageState, 0);
 
     auto [it, inserted] = _subscriptions.emplace(channelId, std::move(channelSub));
     subIt = it;
 
     RCLCPP_INFO(this->get_logger(), "Created ROS subscription on %s (%s) for channel %" PRIu64,
                 topic.c_str(), datatype.c_str(), static_cast<uint64_t>(channelId));
+  } else if (subIt->second.lingerUntil.has_value()) {
+    RCLCPP_DEBUG(this->get_logger(), "Reusing lingering ROS subscription for channel %" PRIu64,
+                 static_cast<uint64_t>(channelId));
+    subIt->second.lingerUntil.reset();
+    subIt->second.messageState->lingering = false;
   }
+  return subIt;
+}
+
+void FoxgloveBridge::initPublisherCaches(MessageState& state, const std::string& topic) {
+  for (const auto& [gid, depth] : collectTopicQosInfo(topic).publisherDepths) {
+    state.publisherCaches[gid].maxMessages = depth;
+  }
+}
+
+void FoxgloveBridge::updateSubscriptionQos() {
+  std::lock_guard<std::mutex> lock(_subscriptionsMutex);
+  for (auto& [channelId, channelSub] : _subscriptions) {
+    auto& state = *channelSub.messageState;
+    const std::string topic(state.channel->topic());
+    // Keep the current QoS while a topic has no publishers, rather than downgrading it.
+    if (this->count_publishers(topic) == 0) {
+      continue;
+    }
+    // The topic's QoS warnings were already logged when the subscription was created.
+    const rclcpp::QoS qos = determineQoS(topic, false);
+    // The history depth only matters to the middleware for transient_local subscriptions, where it
+    // bounds how many latched messages are delivered on (re)connection.
+    const bool transientLocal = qos.durability() == rclcpp::DurabilityPolicy::TransientLocal;
+    if (qos.reliability() == channelSub.qos.reliability() &&
+        qos.durability() == channelSub.qos.durability() &&
+        (!transientLocal || qos.depth() <= channelSub.qos.depth())) {
+      continue;
+    }
+
+    // Make before break: the current subscription keeps forwarding messages until the replacement
+    // delivers its first one, so clients sharing this subscription see no gap.
+    const uint32_t generation = channelSub.generation + 1;
+    Subscription replacement;
+    try {
+      replacement =
+        createRosSubscription(topic, channelSub.datatype, qos, channelSub.messageState, generation);
+    } catch (const std::exception& ex) {
+      RCLCPP_ERROR(this->get_logger(), "Failed to update QoS of ROS subscription on %s: %s",
+                   topic.c_str(), ex.what());
+      continue;
+    }
+
+    if (transientLocal != state.transientLocal) {
+      std::lock_guard<std::mutex> cacheLock(state.cacheMutex);
+      state.publisherCaches.clear();
+      if (transientLocal) {
+        initPublisherCaches(state, topic);
+      }
+      state.transientLocal = transientLocal;
+    }
+
+    RCLCPP_INFO(this->get_logger(),
+                "Publisher QoS changed, replacing ROS subscription on %s for channel %" PRIu64,
+                topic.c_str(), static_cast<uint64_t>(channelId));
+    channelSub.previousRosSubscription = std::move(channelSub.rosSubscription);
+    channelSub.rosSubscription = std::move(replacement);
+    channelSub.qos = qos;
+    channelSub.generation = generation;
+    channelSub.replacedAt = std::chrono::steady_clock::now();
+  }
+}
+
+void FoxgloveBridge::retireReplacedSubscriptions() {
+  std::lock_guard<std::mutex> lock(_subscriptionsMutex);
+  const auto now = std::chrono::steady_clock::now();
+  for (auto& [channelId, channelSub] : _subscriptions) {
+    if (channelSub.previousRosSubscription &&
+        (channelSub.messageState->activeGeneration >= channelSub.generation ||
+         now - channelSub.replacedAt >= SUBSCRIPTION_HANDOVER_TIMEOUT)) {
+      channelSub.previousRosSubscription.reset();
+    }
+  }
+}
+
+void FoxgloveBridge::removeLingeringSubscriptions() {
+  std::lock_guard<std::mutex> lock(_subscriptionsMutex);
+  const auto now = std::chrono::steady_clock::now();
+  for (auto it = _subscriptions.begin(); it != _subscriptions.end();) {
+    if (it->second.lingerUntil.has_value() && now >= *it->second.lingerUntil) {
+      RCLCPP_INFO(this->get_logger(),
+                  "Cleaned up ROS subscription for channel %" PRIu64 " (no more subscribers)",
+                  static_cast<uint64_t>(it->first));
+      it = _subscriptions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void FoxgloveBridge::recordChannelLocked(ChannelId channelId) {
+  bool isNewSubscription = false;
+  auto subIt = findOrCreateSubscriptionLocked(channelId, isNewSubscription);
+  if (subIt != _subscriptions.end()) {
+    subIt->second.recorded = true;
+  }
+}
+
+void FoxgloveBridge::createOrIncrementSubscriptionLocked(ChannelId channelId, ClientId clientId,
+                                                         bool isGateway,
+                                                         std::optional<SinkId> sinkId) {
+  bool isNewSubscription = false;
+  auto subIt = findOrCreateSubscriptionLocked(channelId, isNewSubscription);
+  if (subIt == _subscriptions.end()) {
+    return;
+  }
+  auto& channel = *subIt->second.messageState->channel;
 
   // For transient_local topics, replay cached messages to the new client before adding
   // them to the broadcast set, so they don't miss latched values.
-  if (!isNewSubscription && sinkId.has_value()) {
-    for (const auto& [gid, cache] : subIt->second.publisherCaches) {
+  if (!isNewSubscription && sinkId.has_value() && subIt->second.messageState->transientLocal) {
+    auto& messageState = *subIt->second.messageState;
+    std::lock_guard<std::mutex> cacheLock(messageState.cacheMutex);
+    for (const auto& [gid, cache] : messageState.publisherCaches) {
       for (const auto& cached : cache.messages) {
-        channel.log(reinterpret_cast<const std::byte*>(cached.data.data()), cached.data.size(),
-                    cached.timestamp, sinkId.value());
+        const auto& serialized = cached.msg->get_rcl_serialized_message();
+        channel.logShared(cached.msg, reinterpret_cast<const std::byte*>(serialized.buffer),
+                          serialized.buffer_length, cached.timestamp, sinkId.value());
       }
     }
   }
@@ -1053,8 +1581,15 @@ void FoxgloveBridge::removeOrDecrementSubscriptionLocked(ChannelId channelId, Cl
     subIt->second.wsClientIds.erase(clientId);
   }
 
-  // If no more subscribers, destroy the ROS subscription
-  if (subIt->second.wsClientIds.empty() && subIt->second.gatewayClientIds.empty()) {
+  // If no more subscribers, destroy the ROS subscription, or keep it for a while in case a client
+  // subscribes again
+  if (subIt->second.wsClientIds.empty() && subIt->second.gatewayClientIds.empty() &&
+      !subIt->second.recorded) {
+    if (_subscriptionLinger.count() > 0) {
+      subIt->second.lingerUntil = std::chrono::steady_clock::now() + _subscriptionLinger;
+      subIt->second.messageState->lingering = true;
+      return;
+    }
     RCLCPP_INFO(this->get_logger(),
                 "Cleaned up ROS subscription for channel %" PRIu64 " (no more subscribers)",
                 static_cast<uint64_t>(channelId));
@@ -1078,7 +1613,7 @@ ClientAdvertisement FoxgloveBridge::createClientPublisher(const std::string& top
       if (schemaLen > 0) {
         schema = std::string(reinterpret_cast<const char*>(schemaData), schemaLen);
       } else {
-        auto [format, msgDefinition] = _messageDefinitionCache.get_full_text(topicType);
+        auto [format, msgDefinition] = _messageDefinitionCache->get_full_text(topicType);
         if (format != foxglove_bridge::MessageDefinitionFormat::MSG) {
           throw std::runtime_error("Message definition (.msg) for schema " + topicType +
                                    " not found");
@@ -1114,22 +1649,33 @@ ClientAdvertisement FoxgloveBridge::createClientPublisher(const std::string& top
   publisherOptions.callback_group = _clientPublishCallbackGroup;
   auto publisher = this->create_generic_publisher(topicName, topicType, qos, publisherOptions);
 
-  return ClientAdvertisement{std::move(publisher), topicName, topicType, encoding, jsonParser};
+  return ClientAdvertisement{std::move(publisher),
+                             topicName,
+                             topicType,
+                             encoding,
+                             jsonParser,
+                             std::make_shared<SerializedMessagePool>(),
+                             _clientPublishPool->makeStrand(CLIENT_PUBLISH_QUEUE_SIZE)};
 }
 
 void FoxgloveBridge::publishClientData(const ClientAdvertisement& ad, const std::byte* data,
                                        size_t dataLen) {
   auto publishMessage = [&ad, this](const void* msgData, size_t size) {
-    // Copy the message payload into a SerializedMessage object
-    rclcpp::SerializedMessage serializedMessage{size};
-    auto& rclSerializedMsg = serializedMessage.get_rcl_serialized_message();
+    // Copy the message payload into a buffer from the channel's pool, which is only reallocated
+    // when a message doesn't fit. Publishing copies the message, so the buffer is returned to the
+    // pool on return.
+    auto serializedMessage = ad.messagePool->acquire();
+    if (serializedMessage->capacity() < size) {
+      serializedMessage->reserve(size);
+    }
+    auto& rclSerializedMsg = serializedMessage->get_rcl_serialized_message();
     std::memcpy(rclSerializedMsg.buffer, msgData, size);
     rclSerializedMsg.buffer_length = size;
     // Publish the message
     if (_disableLoanMessage || !ad.publisher->can_loan_messages()) {
-      ad.publisher->publish(serializedMessage);
+      ad.publisher->publish(*serializedMessage);
     } else {
-      ad.publisher->publish_as_loaned_msg(serializedMessage);
+      ad.publisher->publish_as_loaned_msg(*serializedMessage);
     }
   };
 
@@ -1149,6 +1695,23 @@ void FoxgloveBridge::publishClientData(const ClientAdvertisement& ad, const std:
   }
 }
 
+void FoxgloveBridge::postClientData(const ClientAdvertisement& ad,
+                                    std::shared_ptr<const void> owner, const std::byte* data,
+                                    size_t dataLen) {
+  const bool queued = _clientPublishPool->post(
+    ad.strand, [this, ad, owner = std::move(owner), data, dataLen]() {
+      try {
+        publishClientData(ad, data, dataLen);
+      } catch (const std::exception& ex) {
+        RCLCPP_ERROR(this->get_logger(), "Dropping client message on %s: %s",
+                     ad.topicName.c_str(), ex.what());
+      }
+    });
+  if (!queued) {
+    throw std::runtime_error("too many messages waiting to be published on " + ad.topicName);
+  }
+}
+
 void FoxgloveBridge::clientAdvertise(ClientId clientId, const foxglove::ClientChannel& channel) {
   std::lock_guard<std::mutex> lock(_clientAdvertisementsMutex);
 
@@ -1211,7 +1774,7 @@ void FoxgloveBridge::clientUnadvertise(ClientId clientId, ChannelId clientChanne
 }
 
 void FoxgloveBridge::clientMessage(ClientId clientId, ChannelId clientChannelId,
-                                   const std::byte* data, size_t dataLen) {
+                                   foxglove::ClientMessageBuffer data) {
   ClientAdvertisement ad;
   {
     const ChannelAndClientId key = {clientChannelId, clientId};
@@ -1229,7 +1792,11 @@ void FoxgloveBridge::clientMessage(ClientId clientId, ChannelId clientChannelId,
   }
 
   try {
-    publishClientData(ad, data, dataLen);
+    // The buffer is shared with the task, which publishes straight from it.
+    auto buffer = std::make_shared<foxglove::ClientMessageBuffer>(std::move(data));
+    const std::byte* bytes = buffer->data();
+    const size_t size = buffer->size();
+    postClientData(ad, std::move(buffer), bytes, size);
   } catch (const std::exception& ex) {
     throw ClientChannelError("Dropping client message on client channel " +
                              std::to_string(clientChannelId) + " from client ID " +
@@ -1409,7 +1976,7 @@ void FoxgloveBridge::parameterUpdates(const std::vector<foxglove::Parameter>& pa
 #endif
 }
 
-void FoxgloveBridge::rosMessageHandler(ChannelId channelId,
+void FoxgloveBridge::rosMessageHandler(MessageState& state,
                                        std::shared_ptr<const rclcpp::SerializedMessage> msg,
                                        const rclcpp::MessageInfo& messageInfo) {
   // NOTE: Do not call any RCLCPP_* logging functions from this function. Otherwise, subscribing
@@ -1418,35 +1985,49 @@ void FoxgloveBridge::rosMessageHandler(ChannelId channelId,
   assert(timestamp >= 0 && "Timestamp is negative");
   const auto rclSerializedMsg = msg->get_rcl_serialized_message();
 
-  std::lock_guard<std::mutex> lock(_subscriptionsMutex);
-  auto channelIt = _channels.find(channelId);
-  if (channelIt == _channels.end()) {
-    return;
+  // Drop messages which arrive faster than the topic's max rate, before doing any other work.
+  // Throttling uses the steady clock, so that it is unaffected by sim time jumps.
+  if (state.minForwardIntervalNs > 0) {
+    const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+    int64_t next = state.nextForwardNs.load(std::memory_order_relaxed);
+    if (now < next || !state.nextForwardNs.compare_exchange_strong(
+                        next, now + state.minForwardIntervalNs, std::memory_order_relaxed)) {
+      if (state.unthrottledSinkId) {
+        state.channel->logShared(msg, reinterpret_cast<const std::byte*>(rclSerializedMsg.buffer),
+                                 rclSerializedMsg.buffer_length, timestamp,
+                                 state.unthrottledSinkId);
+      }
+      return;
+    }
   }
 
   // Cache messages per-publisher for transient_local subscriptions so late subscribers receive
   // them.
-  auto subIt = _subscriptions.find(channelId);
-  if (subIt != _subscriptions.end() &&
-      subIt->second.qos.durability() == rclcpp::DurabilityPolicy::TransientLocal) {
+  if (state.transientLocal) {
     Gid gid;
     const auto& rawGid = messageInfo.get_rmw_message_info().publisher_gid;
     std::copy(rawGid.data, rawGid.data + RMW_GID_STORAGE_SIZE, gid.begin());
 
-    auto& pubCache = subIt->second.publisherCaches[gid];
+    std::lock_guard<std::mutex> cacheLock(state.cacheMutex);
+    auto& pubCache = state.publisherCaches[gid];
     if (pubCache.messages.size() >= pubCache.maxMessages) {
       pubCache.messages.pop_front();
     }
-    pubCache.messages.push_back(CachedMessage{
-      {rclSerializedMsg.buffer, rclSerializedMsg.buffer + rclSerializedMsg.buffer_length},
-      static_cast<uint64_t>(timestamp),
-    });
+    pubCache.messages.push_back(CachedMessage{msg, static_cast<uint64_t>(timestamp)});
+  }
+
+  // A lingering subscription has no clients, and only keeps the cache above up to date.
+  if (state.lingering.load(std::memory_order_relaxed)) {
+    return;
   }
 
   // Log without sink_id to broadcast to all sinks (WebSocket server + Gateway).
-  // Each sink internally handles routing to its subscribed clients.
-  channelIt->second.log(reinterpret_cast<const std::byte*>(rclSerializedMsg.buffer),
-                        rclSerializedMsg.buffer_length, timestamp);
+  // Each sink internally handles routing to its subscribed clients. Sinks that queue the payload
+  // hold a reference to the SerializedMessage instead of copying it.
+  state.channel->logShared(msg, reinterpret_cast<const std::byte*>(rclSerializedMsg.buffer),
+                           rclSerializedMsg.buffer_length, timestamp);
 }
 
 void FoxgloveBridge::handleServiceRequest(const foxglove::ServiceRequest& request,
@@ -1454,7 +2035,7 @@ void FoxgloveBridge::handleServiceRequest(const foxglove::ServiceRequest& reques
   RCLCPP_DEBUG(this->get_logger(), "Received a request for service %s",
                request.service_name.c_str());
 
-  std::lock_guard<std::mutex> lock(_servicesMutex);
+  std::unique_lock<std::mutex> lock(_servicesMutex);
   auto serviceIt = _advertisedServices.find(request.service_name);
   if (serviceIt == _advertisedServices.end()) {
     std::string errorMessage = "Service " + request.service_name + " does not exist";
@@ -1474,15 +2055,19 @@ void FoxgloveBridge::handleServiceRequest(const foxglove::ServiceRequest& reques
   }
 
   auto client = _serviceClients.at(serviceName);
-  if (!client->wait_for_service(1s)) {
-    std::string errorMessage = "Service " + serviceName + " is not available";
+  // Don't block service advertisement while waiting for the server.
+  lock.unlock();
+
+  // service_is_ready does not block; only wait for the server if it is not yet known.
+  if (!client->service_is_ready() && !client->wait_for_service(1s)) {
+    std::string errorMessage = "Service " + request.service_name + " is not available";
     RCLCPP_ERROR(this->get_logger(), "%s", errorMessage.c_str());
     std::move(responder).respondError(errorMessage);
     return;
   }
 
   if (request.encoding != "cdr") {
-    std::string errorMessage = "Service " + serviceName +
+    std::string errorMessage = "Service " + request.service_name +
                                " received a request with an unsupported encoding " +
                                request.encoding;
     RCLCPP_ERROR(this->get_logger(), "%s", errorMessage.c_str());
@@ -1490,12 +2075,7 @@ void FoxgloveBridge::handleServiceRequest(const foxglove::ServiceRequest& reques
     return;
   }
 
-  auto reqMessage = std::make_shared<rclcpp::SerializedMessage>(request.payload.size());
-  std::memcpy(reqMessage->get_rcl_serialized_message().buffer, request.payload.data(),
-              request.payload.size());
-  reqMessage->get_rcl_serialized_message().buffer_length = request.payload.size();
-
-  client->async_send_request(reqMessage, std::move(responder));
+  client->async_send_request(request.payload.data(), request.payload.size(), std::move(responder));
 }
 
 void FoxgloveBridge::fetchAsset(const std::string_view uriView,
@@ -1533,6 +2113,16 @@ void FoxgloveBridge::fetchAsset(const std::string_view uriView,
 }
 
 FoxgloveBridge::TopicQosInfo FoxgloveBridge::collectTopicQosInfo(const std::string& topic) {
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(_topicQosCacheMutex);
+    auto it = _topicQosCache.find(topic);
+    if (it != _topicQosCache.end()) {
+      return it->second;
+    }
+    generation = _topicQosCacheGeneration;
+  }
+
   TopicQosInfo info;
   info.bestEffortForced = matchesRegex(topic, _bestEffortQosTopicWhiteListPatterns);
 
@@ -1553,26 +2143,38 @@ FoxgloveBridge::TopicQosInfo FoxgloveBridge::collectTopicQosInfo(const std::stri
     // broadcasters). See also
     // https://github.com/foxglove/ros-foxglove-bridge/issues/238 and
     // https://github.com/foxglove/ros-foxglove-bridge/issues/208
-    info.totalHistoryDepth += std::max(static_cast<size_t>(1), qos.depth());
+    const size_t depth = std::max(static_cast<size_t>(1), qos.depth());
+    info.totalHistoryDepth += depth;
+    info.publisherDepths.emplace_back(publisher.endpoint_gid(), depth);
   }
 
+  std::lock_guard<std::mutex> lock(_topicQosCacheMutex);
+  if (generation == _topicQosCacheGeneration) {
+    _topicQosCache.emplace(topic, info);
+  }
   return info;
 }
 
-rclcpp::QoS FoxgloveBridge::determineQoS(const std::string& topic) {
+void FoxgloveBridge::invalidateTopicQosCache() {
+  std::lock_guard<std::mutex> lock(_topicQosCacheMutex);
+  _topicQosCache.clear();
+  ++_topicQosCacheGeneration;
+}
+
+rclcpp::QoS FoxgloveBridge::determineQoS(const std::string& topic, bool warn) {
   // Select an appropriate subscription QOS profile. This is similar to how ros2 topic echo
   // does it:
   // https://github.com/ros2/ros2cli/blob/619b3d1c9/ros2topic/ros2topic/verb/echo.py#L137-L194
   const auto info = collectTopicQosInfo(topic);
 
   size_t depth = std::max(info.totalHistoryDepth, _minQosDepth);
-  if (depth > _maxQosDepth) {
+  if (depth > _maxQosDepth && warn) {
     RCLCPP_WARN(this->get_logger(),
                 "Limiting history depth for topic '%s' to %zu (was %zu). You may want to increase "
                 "the max_qos_depth parameter value.",
                 topic.c_str(), _maxQosDepth, depth);
-    depth = _maxQosDepth;
   }
+  depth = std::min(depth, _maxQosDepth);
 
   rclcpp::QoS qos{rclcpp::KeepLast(depth)};
 
@@ -1583,7 +2185,7 @@ rclcpp::QoS FoxgloveBridge::determineQoS(const std::string& topic) {
     // If all endpoints are reliable, ask for reliable
     qos.reliable();
   } else {
-    if (info.reliableCount > 0) {
+    if (info.reliableCount > 0 && warn) {
       RCLCPP_WARN(
         this->get_logger(),
         "Some, but not all, publishers on topic '%s' are offering "
@@ -1598,7 +2200,7 @@ rclcpp::QoS FoxgloveBridge::determineQoS(const std::string& topic) {
   if (info.publisherCount > 0 && info.transientLocalCount == info.publisherCount) {
     qos.transient_local();
   } else {
-    if (info.transientLocalCount > 0) {
+    if (info.transientLocalCount > 0 && warn) {
       RCLCPP_WARN(this->get_logger(),
                   "Some, but not all, publishers on topic '%s' are offering "
                   "QoSDurabilityPolicy.TRANSIENT_LOCAL. Falling back to "
@@ -1809,7 +2411,10 @@ void FoxgloveBridge::gatewayClientMessage(uint32_t clientId,
   }
 
   try {
-    publishClientData(ad, data, dataLen);
+    // The payload is only valid during the callback, so copy it for the publishing task.
+    auto buffer = std::make_shared<std::vector<std::byte>>(data, data + dataLen);
+    const std::byte* bytes = buffer->data();
+    postClientData(ad, std::move(buffer), bytes, dataLen);
   } catch (const std::exception& ex) {
     RCLCPP_ERROR(this->get_logger(),
                  "Gateway: dropping message from client %u for channel %" PRIu64 ": %s", clientId,
@@ -0,0 +1,87 @@
+#include "foxglove_bridge/strand_pool.hpp"
+
+#include <algorithm>
+
+namespace foxglove_bridge {
+
+class StrandPool::Strand {
+public:
+  explicit Strand(size_t maxQueuedTasks)
+      : maxQueuedTasks(maxQueuedTasks) {}
+
+private:
+  friend class StrandPool;
+
+  // Guarded by the pool's mutex.
+  const size_t maxQueuedTasks;
+  std::deque<std::function<void()>> tasks;
+  // Whether the strand is in the pool's ready queue or running on a worker.
+  bool scheduled = false;
+};
+
+StrandPool::StrandPool(size_t threadCount) {
+  for (size_t i = 0; i < std::max<size_t>(threadCount, 1); ++i) {
+    _threads.emplace_back(&StrandPool::workerLoop, this);
+  }
+}
+
+StrandPool::~StrandPool() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopped = true;
+  }
+  _cv.notify_all();
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+std::shared_ptr<StrandPool::Strand> StrandPool::makeStrand(size_t maxQueuedTasks) {
+  return std::make_shared<Strand>(maxQueuedTasks);
+}
+
+bool StrandPool::post(const std::shared_ptr<Strand>& strand, std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_stopped || strand->tasks.size() >= strand->maxQueuedTasks) {
+      return false;
+    }
+    strand->tasks.push_back(std::move(task));
+    if (strand->scheduled) {
+      // The worker running the strand picks up the task after the ones before it.
+      return true;
+    }
+    strand->scheduled = true;
+    _ready.push_back(strand);
+  }
+  _cv.notify_one();
+  return true;
+}
+
+void StrandPool::workerLoop() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _cv.wait(lock, [this] { return _stopped || !_ready.empty(); });
+    if (_stopped) {
+      return;
+    }
+    auto strand = std::move(_ready.front());
+    _ready.pop_front();
+    auto task = std::move(strand->tasks.front());
+    strand->tasks.pop_front();
+
+    lock.unlock();
+    task();
+    task = nullptr;
+    lock.lock();
+
+    // Run one task per turn, so that a busy strand doesn't hold up the others.
+    if (strand->tasks.empty()) {
+      strand->scheduled = false;
+    } else {
+      _ready.push_back(std::move(strand));
+    }
+  }
+}
+
+}  // namespace foxglove_bridge
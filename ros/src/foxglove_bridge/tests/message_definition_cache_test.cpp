@@ -1,3 +1,5 @@
+#include <filesystem>
+#include <random>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -64,3 +66,33 @@ TEST(MessageDefinitionCacheTest, UnknownTypeThrows) {
   EXPECT_THROW(cache.get_full_text("std_msgs/msg/DoesNotExist"),
                foxglove_bridge::DefinitionNotFoundError);
 }
+
+TEST(MessageDefinitionCacheTest, PersistsFullTextsOnDisk) {
+  const auto dir = std::filesystem::temp_directory_path() /
+                   ("foxglove_bridge_test_" + std::to_string(std::random_device{}()));
+  std::string expected;
+  {
+    MessageDefinitionCache cache(dir);
+    expected = cache.get_full_text("std_srvs/srv/SetBool_Request").second;
+  }
+  ASSERT_TRUE(std::filesystem::exists(dir / "std_srvs.srv.SetBool_Request.txt"));
+
+  // A second cache returns the persisted entry.
+  MessageDefinitionCache cache(dir);
+  const auto [format, text] = cache.get_full_text("std_srvs/srv/SetBool_Request");
+  EXPECT_EQ(format, MessageDefinitionFormat::MSG);
+  EXPECT_EQ(text, expected);
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST(MessageDefinitionCacheTest, PrefetchResolvesInParallel) {
+  MessageDefinitionCache cache;
+  // Unknown types are skipped; get_full_text reports them when they are used.
+  cache.prefetch({"std_srvs/srv/SetBool_Request", "std_srvs/srv/SetBool_Response",
+                  "std_msgs/msg/DoesNotExist"});
+  EXPECT_NE(std::string::npos,
+            cache.get_full_text("std_srvs/srv/SetBool_Response").second.find("bool success"));
+  EXPECT_THROW(cache.get_full_text("std_msgs/msg/DoesNotExist"),
+               foxglove_bridge::DefinitionNotFoundError);
+}
@@ -1,16 +1,26 @@
+#include <chrono>
 #include <cstdint>
+#include <future>
 #include <limits>
+#include <map>
 #include <regex>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include <foxglove_bridge/param_utils.hpp>
+#include <foxglove_bridge/strand_pool.hpp>
 #include <foxglove_bridge/utils.hpp>
 
 using foxglove_bridge::compileTopicRegex;
 using foxglove_bridge::DEFAULT_VIDEO_TRANSCODE_TOPIC_DENYLIST;
 using foxglove_bridge::matchesRegex;
+using foxglove_bridge::mcapRotationPathTemplate;
+using foxglove_bridge::parseMcapCompression;
+using foxglove_bridge::parseIsolatedTopicExecutor;
+using foxglove_bridge::parseTopicMaxRate;
 using foxglove_bridge::saturatingToSizeT;
 
 namespace {
@@ -87,6 +97,52 @@ TEST(VideoTranscodeTopicDenylistTest, MatchesCaseInsensitively) {
   EXPECT_TRUE(matchesRegex("/camera/depth/image_raw/CompressedDepth", defaultDenylistPatterns()));
 }
 
+TEST(IsolatedTopicExecutorTest, ParsesOptionalCpu) {
+  const auto plain = parseIsolatedTopicExecutor("/imu/.*");
+  EXPECT_EQ(plain.pattern, "/imu/.*");
+  EXPECT_FALSE(plain.cpu.has_value());
+
+  const auto pinned = parseIsolatedTopicExecutor("/imu/.*@3");
+  EXPECT_EQ(pinned.pattern, "/imu/.*");
+  EXPECT_EQ(pinned.cpu, 3);
+
+  // Only a trailing number is a CPU index.
+  const auto notCpu = parseIsolatedTopicExecutor("/imu@x");
+  EXPECT_EQ(notCpu.pattern, "/imu@x");
+  EXPECT_FALSE(notCpu.cpu.has_value());
+}
+
+TEST(TopicMaxRateTest, ParsesRate) {
+  const auto config = parseTopicMaxRate("/joint_states@50");
+  EXPECT_EQ(config.pattern, "/joint_states");
+  EXPECT_DOUBLE_EQ(config.maxRate, 50.0);
+
+  // The rate follows the last '@', and may be fractional.
+  const auto fractional = parseTopicMaxRate("/a@b@0.5");
+  EXPECT_EQ(fractional.pattern, "/a@b");
+  EXPECT_DOUBLE_EQ(fractional.maxRate, 0.5);
+
+  EXPECT_THROW(parseTopicMaxRate("/joint_states"), std::invalid_argument);
+  EXPECT_THROW(parseTopicMaxRate("/joint_states@"), std::invalid_argument);
+  EXPECT_THROW(parseTopicMaxRate("/joint_states@fast"), std::invalid_argument);
+  EXPECT_THROW(parseTopicMaxRate("/joint_states@10hz"), std::invalid_argument);
+  EXPECT_THROW(parseTopicMaxRate("/joint_states@0"), std::invalid_argument);
+}
+
+TEST(RecordingParamsTest, RotationPathTemplateInsertsIndex) {
+  EXPECT_EQ(mcapRotationPathTemplate("/data/run.mcap"), "/data/run_{index}.mcap");
+  EXPECT_EQ(mcapRotationPathTemplate("/data/run_{index}.mcap"), "/data/run_{index}.mcap");
+  EXPECT_EQ(mcapRotationPathTemplate("/data.d/run"), "/data.d/run_{index}");
+  EXPECT_EQ(mcapRotationPathTemplate("/data/.hidden"), "/data/.hidden_{index}");
+}
+
+TEST(RecordingParamsTest, ParsesCompression) {
+  EXPECT_EQ(parseMcapCompression("zstd"), foxglove::McapCompression::Zstd);
+  EXPECT_EQ(parseMcapCompression("LZ4"), foxglove::McapCompression::Lz4);
+  EXPECT_EQ(parseMcapCompression("none"), foxglove::McapCompression::None);
+  EXPECT_FALSE(parseMcapCompression("gzip").has_value());
+}
+
 TEST(SplitDefinitionsTest, EmptyMessageDefinition) {
   const std::string messageDef = "";
   std::istringstream stream(messageDef);
@@ -158,6 +214,30 @@ TEST(SplitDefinitionsTest, ActionDefinitionNoGoal) {
   EXPECT_EQ(definitions[2], "bool feedback");
 }
 
+TEST(DiffNamesAndTypesTest, ReportsOnlyChangedPairs) {
+  const std::map<std::string, std::vector<std::string>> previous = {
+    {"/a", {"std_msgs/msg/String"}},
+    {"/b", {"std_msgs/msg/Int32", "std_msgs/msg/Int64"}},
+    {"/c", {"std_msgs/msg/Bool"}},
+  };
+  const std::map<std::string, std::vector<std::string>> current = {
+    {"/a", {"std_msgs/msg/String"}},
+    {"/b", {"std_msgs/msg/Int64", "std_msgs/msg/Float64"}},
+    {"/d", {"std_msgs/msg/Empty"}},
+  };
+  const auto diff = foxglove_bridge::diffNamesAndTypes(previous, current);
+
+  using Pair = std::pair<std::string, std::string>;
+  EXPECT_EQ(diff.removed, (std::vector<Pair>{{"/b", "std_msgs/msg/Int32"},
+                                             {"/c", "std_msgs/msg/Bool"}}));
+  EXPECT_EQ(diff.added, (std::vector<Pair>{{"/b", "std_msgs/msg/Float64"},
+                                           {"/d", "std_msgs/msg/Empty"}}));
+
+  const auto unchanged = foxglove_bridge::diffNamesAndTypes(current, current);
+  EXPECT_TRUE(unchanged.added.empty());
+  EXPECT_TRUE(unchanged.removed.empty());
+}
+
 TEST(SplitDefinitionsTest, HandleCarriageReturn) {
   const std::string messageDef =
     "---\r\n"
@@ -169,6 +249,53 @@ TEST(SplitDefinitionsTest, HandleCarriageReturn) {
   EXPECT_EQ(definitions[1], "string device_name");
 }
 
+TEST(SubscriptionGenerationTest, NewerGenerationTakesOver) {
+  std::atomic<uint32_t> activeGeneration{0};
+  EXPECT_TRUE(foxglove_bridge::acceptSubscriptionGeneration(activeGeneration, 0));
+
+  // The replaced subscription keeps forwarding until its replacement receives a message.
+  EXPECT_TRUE(foxglove_bridge::acceptSubscriptionGeneration(activeGeneration, 0));
+  EXPECT_TRUE(foxglove_bridge::acceptSubscriptionGeneration(activeGeneration, 1));
+  EXPECT_EQ(activeGeneration.load(), 1u);
+  EXPECT_FALSE(foxglove_bridge::acceptSubscriptionGeneration(activeGeneration, 0));
+  EXPECT_TRUE(foxglove_bridge::acceptSubscriptionGeneration(activeGeneration, 1));
+}
+
+TEST(StrandPoolTest, OrdersTasksPerStrand) {
+  foxglove_bridge::StrandPool pool(2);
+  auto blocked = pool.makeStrand(2);
+  auto free = pool.makeStrand(100);
+
+  // A strand whose task is stuck doesn't hold up the other strand, and its queue fills up.
+  std::promise<void> started;
+  std::promise<void> unblock;
+  std::promise<void> blockedDone;
+  ASSERT_TRUE(pool.post(blocked, [&started, future = unblock.get_future().share()] {
+    started.set_value();
+    future.wait();
+  }));
+  ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  ASSERT_TRUE(pool.post(blocked, [] {}));
+  ASSERT_TRUE(pool.post(blocked, [&blockedDone] { blockedDone.set_value(); }));
+  EXPECT_FALSE(pool.post(blocked, [] {}));
+
+  std::vector<int> order;
+  std::promise<void> freeDone;
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_TRUE(pool.post(free, [&order, i] { order.push_back(i); }));
+  }
+  ASSERT_TRUE(pool.post(free, [&freeDone] { freeDone.set_value(); }));
+  ASSERT_EQ(freeDone.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  ASSERT_EQ(order.size(), 50u);
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+
+  unblock.set_value();
+  EXPECT_EQ(blockedDone.get_future().wait_for(std::chrono::seconds(10)),
+            std::future_status::ready);
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
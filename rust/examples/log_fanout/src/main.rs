@@ -0,0 +1,96 @@
+//! Measures the cost of `RawChannel::log` as the number of channels and subscribed sinks grows.
+//!
+//! Each sink subscribes to every channel dynamically, the way WebSocket clients do. The cost of
+//! logging a message should not depend on the number of channels in the context, and should grow
+//! linearly with the number of sinks subscribed to the channel.
+//!
+//! Run with `cargo run --release -p example_log_fanout`.
+
+use std::hint::black_box;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::{Duration, Instant};
+
+use foxglove::{
+    ChannelBuilder, ChannelId, Context, FoxgloveError, Metadata, PartialMetadata, RawChannel, Sink,
+    SinkId,
+};
+
+const CHANNEL_COUNTS: &[usize] = &[1, 100, 1_500];
+const SINK_COUNTS: &[usize] = &[0, 1, 10];
+const ITERATIONS: u32 = 1_000_000;
+
+/// A sink which counts the messages logged to it.
+struct CountingSink {
+    id: SinkId,
+    count: AtomicU64,
+}
+
+impl Sink for CountingSink {
+    fn id(&self) -> SinkId {
+        self.id
+    }
+
+    fn log(&self, _: &RawChannel, _: &[u8], _: &Metadata) -> Result<(), FoxgloveError> {
+        self.count.fetch_add(1, Ordering::Relaxed);
+        Ok(())
+    }
+
+    fn auto_subscribe(&self) -> bool {
+        false
+    }
+}
+
+/// Returns the average time to log a message to one of `num_channels` channels, each of which
+/// is subscribed to by `num_sinks` sinks.
+fn measure(num_channels: usize, num_sinks: usize) -> Duration {
+    let ctx = Context::new();
+    let channels: Vec<_> = (0..num_channels)
+        .map(|i| {
+            ChannelBuilder::new(format!("/topic/{i}"))
+                .message_encoding("json")
+                .context(&ctx)
+                .build_raw()
+                .expect("Failed to create channel")
+        })
+        .collect();
+    let channel_ids: Vec<ChannelId> = channels.iter().map(|c| c.id()).collect();
+
+    let sinks: Vec<_> = (0..num_sinks)
+        .map(|_| {
+            let sink = Arc::new(CountingSink {
+                id: SinkId::next(),
+                count: AtomicU64::new(0),
+            });
+            ctx.add_sink(sink.clone());
+            ctx.subscribe_channels(sink.id, &channel_ids);
+            sink
+        })
+        .collect();
+
+    let msg = b"{}";
+    let start = Instant::now();
+    for i in 0..ITERATIONS {
+        let channel = &channels[i as usize % channels.len()];
+        channel.log_with_meta(black_box(msg), PartialMetadata::with_log_time(0u64));
+    }
+    let elapsed = start.elapsed();
+
+    for sink in &sinks {
+        assert_eq!(sink.count.load(Ordering::Relaxed), u64::from(ITERATIONS));
+    }
+    elapsed / ITERATIONS
+}
+
+fn main() {
+    println!("{:>10} {:>10} {:>12}", "channels", "sinks", "ns/log");
+    for &num_channels in CHANNEL_COUNTS {
+        for &num_sinks in SINK_COUNTS {
+            let per_log = measure(num_channels, num_sinks);
+            println!(
+                "{num_channels:>10} {num_sinks:>10} {:>12}",
+                per_log.as_nanos()
+            );
+        }
+    }
+}
@@ -3,11 +3,15 @@ use std::sync::Arc;
 use std::sync::atomic::AtomicU64;
 use std::sync::atomic::Ordering::Relaxed;
 
+use bytes::BytesMut;
 use delegate::delegate;
 use serde::{Deserialize, Serialize};
 use smallbytes::SmallBytes;
 
-use crate::{ChannelBuilder, Encode, PartialMetadata, Schema, SinkId, metadata::ToUnixNanos};
+use crate::{
+    ChannelBuilder, ChannelDemand, Context, Encode, FoxgloveError, PartialMetadata, Schema, SinkId,
+    metadata::ToUnixNanos,
+};
 
 mod channel_descriptor;
 mod lazy_channel;
@@ -120,6 +124,17 @@ impl<T: Encode> Channel<T> {
         /// Returns true if there's at least one sink subscribed to this channel.
         pub fn has_sinks(&self) -> bool;
 
+        /// Returns the demand for the channel's messages, combined across its sinks.
+        ///
+        /// See [`RawChannel::demand`].
+        pub fn demand(&self) -> ChannelDemand;
+
+        /// Binds the channel to another context, so that the sinks of that context also receive
+        /// the channel's messages. Each message is still encoded only once.
+        ///
+        /// See [`RawChannel::bind_context`].
+        pub fn bind_context(&self, context: &Arc<Context>) -> Result<(), FoxgloveError>;
+
         /// Closes the channel, removing it from the context.
         ///
         /// You can use this to explicitly unadvertise the channel to sinks that subscribe to
@@ -169,10 +184,8 @@ impl<T: Encode> Channel<T> {
         metadata: PartialMetadata,
         sink_id: Option<SinkId>,
     ) {
-        if self.has_sinks() {
+        if self.inner.should_log() {
             self.log_to_sinks(msg, metadata, sink_id);
-        } else {
-            self.inner.log_warn_if_closed();
         }
     }
 
@@ -186,7 +199,22 @@ impl<T: Encode> Channel<T> {
         self.log_with_meta(msg, PartialMetadata::with_log_time(timestamp))
     }
 
+    /// Returns the current time of the channel's clock.
+    pub(crate) fn now(&self) -> u64 {
+        self.inner.now()
+    }
+
     fn log_to_sinks(&self, msg: &T, metadata: PartialMetadata, sink_id: Option<SinkId>) {
+        if sink_id.is_none() && self.inner.is_latched() {
+            // A latched channel retains the message, so encode it into a buffer which can be
+            // shared with the sinks rather than copied.
+            let mut buf = BytesMut::with_capacity(msg.encoded_len().unwrap_or_default());
+            msg.encode(&mut buf).unwrap();
+            self.inner
+                .log_shared_to_sinks(buf.freeze(), metadata, sink_id);
+            return;
+        }
+
         // Try to avoid heap allocation by using a stack buffer.
         let mut buf: SmallBytes<STACK_BUFFER_SIZE> = SmallBytes::new();
         if let Some(estimated_size) = msg.encoded_len() {
@@ -203,8 +231,13 @@ mod test {
     use crate::channel_builder::ChannelBuilder;
     use crate::log_sink_set::ERROR_LOGGING_MESSAGE;
     use crate::testutil::RecordingSink;
-    use crate::{Context, FoxgloveError, RawChannel, Schema, Sink};
+    use crate::{
+        ChannelDescriptor, Context, FilterAction, FoxgloveError, MessageFilter, Metadata,
+        PartialMetadata, RawChannel, Schema, Sink,
+    };
+    use bytes::Bytes;
     use std::sync::Arc;
+    use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering::Relaxed};
     use tracing_test::traced_test;
 
     fn new_test_channel(ctx: &Arc<Context>) -> Result<Arc<RawChannel>, FoxgloveError> {
@@ -327,6 +360,26 @@ mod test {
         assert!(logs_contain("Cannot log on closed channel for /topic"));
     }
 
+    #[traced_test]
+    #[test]
+    fn test_should_log() {
+        let ctx = Context::new();
+        let ch = new_test_channel(&ctx).unwrap();
+        assert!(!ch.should_log());
+        assert!(!logs_contain("Cannot log on closed channel for /topic"));
+
+        let sink = Arc::new(RecordingSink::new());
+        assert!(ctx.add_sink(sink.clone()));
+        assert!(ch.should_log());
+
+        assert!(ctx.remove_sink(sink.id()));
+        assert!(!ch.should_log());
+
+        ch.close();
+        assert!(!ch.should_log());
+        assert!(logs_contain("Cannot log on closed channel for /topic"));
+    }
+
     #[traced_test]
     #[test]
     fn test_log_to_specific_sink() {
@@ -391,4 +444,241 @@ mod test {
 
         assert!(!logs_contain(ERROR_LOGGING_MESSAGE));
     }
+
+    #[traced_test]
+    #[test]
+    fn test_log_batch() {
+        let ctx = Context::new();
+        let sink1 = Arc::new(RecordingSink::new());
+        let sink2 = Arc::new(RecordingSink::new());
+        assert!(ctx.add_sink(sink1.clone()));
+        assert!(ctx.add_sink(sink2.clone()));
+
+        let channel = new_test_channel(&ctx).unwrap();
+        let batch: &[(&[u8], PartialMetadata)] = &[
+            (b"first", PartialMetadata::with_log_time(10u64)),
+            (b"second", PartialMetadata::default()),
+            (b"third", PartialMetadata::default()),
+        ];
+        channel.log_batch(batch);
+        assert!(!logs_contain(ERROR_LOGGING_MESSAGE));
+
+        let messages = sink1.take_messages();
+        assert_eq!(messages.len(), 3);
+        assert_eq!(messages[0].msg, b"first".to_vec());
+        assert_eq!(messages[0].metadata.log_time, 10);
+        assert_eq!(messages[1].msg, b"second".to_vec());
+        assert_eq!(messages[2].msg, b"third".to_vec());
+        // Messages without a log time share a single clock reading.
+        assert!(messages[1].metadata.log_time > 1732847588055322395);
+        assert_eq!(messages[1].metadata.log_time, messages[2].metadata.log_time);
+        assert_eq!(sink2.take_messages().len(), 3);
+
+        // A targeted batch only reaches the given sink.
+        channel.log_batch_to_sink(batch, Some(sink2.id()));
+        assert_eq!(sink1.take_messages().len(), 0);
+        assert_eq!(sink2.take_messages().len(), 3);
+    }
+
+    #[traced_test]
+    #[test]
+    fn test_log_shared() {
+        let ctx = Context::new();
+        let sink1 = Arc::new(RecordingSink::new());
+        let sink2 = Arc::new(RecordingSink::new());
+        assert!(ctx.add_sink(sink1.clone()));
+        assert!(ctx.add_sink(sink2.clone()));
+
+        let channel = new_test_channel(&ctx).unwrap();
+        let released = Arc::new(AtomicBool::new(false));
+        struct Owner(Vec<u8>, Arc<AtomicBool>);
+        impl AsRef<[u8]> for Owner {
+            fn as_ref(&self) -> &[u8] {
+                &self.0
+            }
+        }
+        impl Drop for Owner {
+            fn drop(&mut self) {
+                self.1.store(true, Relaxed);
+            }
+        }
+        let msg = Bytes::from_owner(Owner(b"shared".to_vec(), released.clone()));
+        let ptr = msg.as_ptr();
+        channel.log_shared_with_meta_to_sink(msg, PartialMetadata::with_log_time(10u64), None);
+        assert!(!logs_contain(ERROR_LOGGING_MESSAGE));
+
+        // Each sink receives a reference to the same buffer, which is released with the last one.
+        let messages1 = sink1.take_messages();
+        let messages2 = sink2.take_messages();
+        assert_eq!(messages1.len(), 1);
+        assert_eq!(messages1[0].msg, b"shared".to_vec());
+        assert_eq!(messages1[0].metadata.log_time, 10);
+        assert_eq!(messages1[0].shared.as_ref().unwrap().as_ptr(), ptr);
+        assert_eq!(messages2[0].shared.as_ref().unwrap().as_ptr(), ptr);
+        drop(messages1);
+        assert!(!released.load(Relaxed));
+        drop(messages2);
+        assert!(released.load(Relaxed));
+
+        // A targeted message only reaches the given sink.
+        channel.log_shared_with_meta_to_sink(
+            Bytes::from_static(b"targeted"),
+            PartialMetadata::default(),
+            Some(sink2.id()),
+        );
+        assert_eq!(sink1.take_messages().len(), 0);
+        assert_eq!(sink2.take_messages().len(), 1);
+    }
+
+    #[traced_test]
+    #[test]
+    fn test_message_filter() {
+        struct CropFilter(AtomicUsize);
+        impl MessageFilter for CropFilter {
+            fn filter(
+                &self,
+                _channel: &ChannelDescriptor,
+                msg: &[u8],
+                _metadata: &Metadata,
+            ) -> FilterAction {
+                self.0.fetch_add(1, Relaxed);
+                match msg {
+                    b"drop" => FilterAction::Drop,
+                    b"crop" => FilterAction::Replace(Bytes::from_static(b"cropped")),
+                    _ => FilterAction::Keep,
+                }
+            }
+        }
+
+        let ctx = Context::new();
+        let filter = Arc::new(CropFilter(AtomicUsize::new(0)));
+        let sink1 = Arc::new(RecordingSink::new().message_filter(filter.clone()));
+        let sink2 = Arc::new(RecordingSink::new().message_filter(filter.clone()));
+        let unfiltered = Arc::new(RecordingSink::new());
+        assert!(ctx.add_sink(sink1.clone()));
+        assert!(ctx.add_sink(sink2.clone()));
+        assert!(ctx.add_sink(unfiltered.clone()));
+
+        let channel = new_test_channel(&ctx).unwrap();
+        channel.log(b"keep");
+        channel.log(b"drop");
+        channel.log_shared(Bytes::from_static(b"crop"));
+        assert!(!logs_contain(ERROR_LOGGING_MESSAGE));
+
+        // The filter runs once per message, and its result is shared by the sinks which use it.
+        assert_eq!(filter.0.load(Relaxed), 3);
+        let messages1 = sink1.take_messages();
+        let messages2 = sink2.take_messages();
+        for messages in [&messages1, &messages2] {
+            assert_eq!(messages.len(), 2);
+            assert_eq!(messages[0].msg, b"keep".to_vec());
+            assert!(messages[0].shared.is_none());
+            assert_eq!(messages[1].msg, b"cropped".to_vec());
+        }
+        assert_eq!(
+            messages1[1].shared.as_ref().unwrap().as_ptr(),
+            messages2[1].shared.as_ref().unwrap().as_ptr()
+        );
+        assert_eq!(unfiltered.take_messages().len(), 3);
+
+        // Batches are filtered per message.
+        let batch: &[(&[u8], PartialMetadata)] = &[
+            (b"drop", PartialMetadata::default()),
+            (b"crop", PartialMetadata::default()),
+        ];
+        channel.log_batch(batch);
+        assert_eq!(filter.0.load(Relaxed), 5);
+        let messages = sink1.take_messages();
+        assert_eq!(messages.len(), 1);
+        assert_eq!(messages[0].msg, b"cropped".to_vec());
+        assert_eq!(sink2.take_messages().len(), 1);
+        assert_eq!(unfiltered.take_messages().len(), 2);
+    }
+
+    #[test]
+    fn test_latched_channel() {
+        let ctx = Context::new();
+        let channel = ChannelBuilder::new("/latched")
+            .context(&ctx)
+            .message_encoding("raw")
+            .keep_last(2)
+            .build_raw()
+            .expect("Failed to create channel");
+
+        // Messages are retained even without sinks.
+        assert!(channel.should_log());
+        channel.log_with_meta(b"1", PartialMetadata::with_log_time(1));
+        channel.log_with_meta(b"2", PartialMetadata::with_log_time(2));
+        channel.log_with_meta(b"3", PartialMetadata::with_log_time(3));
+
+        // A new sink receives the last two messages, with their original log times.
+        let sink1 = Arc::new(RecordingSink::new());
+        assert!(ctx.add_sink(sink1.clone()));
+        let messages = sink1.take_messages();
+        assert_eq!(messages.len(), 2);
+        assert_eq!(messages[0].msg, b"2".to_vec());
+        assert_eq!(messages[0].metadata.log_time, 2);
+        assert_eq!(messages[1].msg, b"3".to_vec());
+
+        // Subscribed sinks receive new messages once, and aren't replayed to again when another
+        // sink subscribes.
+        channel.log_shared(Bytes::from_static(b"4"));
+        let sink2 = Arc::new(RecordingSink::new().auto_subscribe(false));
+        assert!(ctx.add_sink(sink2.clone()));
+        ctx.subscribe_channels(sink2.id(), &[channel.id()]);
+        assert_eq!(sink1.take_messages().len(), 1);
+        let messages = sink2.take_messages();
+        assert_eq!(messages.len(), 2);
+        assert_eq!(messages[0].msg, b"3".to_vec());
+        assert_eq!(messages[1].msg, b"4".to_vec());
+
+        // Messages logged to a specific sink are not retained.
+        channel.log_to_sink(b"5", Some(sink2.id()));
+        ctx.unsubscribe_channels(sink2.id(), &[channel.id()]);
+        ctx.subscribe_channels(sink2.id(), &[channel.id()]);
+        let messages = sink2.take_messages();
+        assert_eq!(messages.len(), 3);
+        assert_eq!(messages[1].msg, b"3".to_vec());
+        assert_eq!(messages[2].msg, b"4".to_vec());
+
+        // A closed channel retains nothing.
+        channel.close();
+        assert!(!channel.should_log());
+    }
+
+    #[test]
+    fn test_latched_channel_concurrent_subscribe() {
+        const COUNT: usize = 1000;
+        let ctx = Context::new();
+        let channel = ChannelBuilder::new("/latched")
+            .context(&ctx)
+            .message_encoding("raw")
+            .keep_last(COUNT)
+            .build_raw()
+            .expect("Failed to create channel");
+
+        // Sinks which subscribe while messages are logged receive each message exactly once,
+        // either replayed or as it is logged.
+        let sinks: Vec<_> = (0..10).map(|_| Arc::new(RecordingSink::new())).collect();
+        std::thread::scope(|scope| {
+            scope.spawn(|| {
+                for i in 0..COUNT {
+                    channel.log(i.to_string().as_bytes());
+                }
+            });
+            for sink in &sinks {
+                assert!(ctx.add_sink(sink.clone()));
+                std::thread::yield_now();
+            }
+        });
+        for sink in &sinks {
+            let mut messages: Vec<usize> = sink
+                .take_messages()
+                .iter()
+                .map(|m| String::from_utf8_lossy(&m.msg).parse().unwrap())
+                .collect();
+            messages.sort_unstable();
+            assert_eq!(messages, (0..COUNT).collect::<Vec<_>>());
+        }
+    }
 }
@@ -13,7 +13,8 @@ struct Inner {
     topic: String,
     message_encoding: String,
     metadata: BTreeMap<String, String>,
-    schema: Option<Schema>,
+    schema: Option<Arc<Schema>>,
+    keep_last: usize,
 }
 
 impl ChannelDescriptor {
@@ -23,6 +24,25 @@ impl ChannelDescriptor {
         message_encoding: String,
         metadata: BTreeMap<String, String>,
         schema: Option<Schema>,
+    ) -> Self {
+        Self::with_shared_schema(
+            id,
+            topic,
+            message_encoding,
+            metadata,
+            schema.map(Arc::new),
+            0,
+        )
+    }
+
+    /// Returns a new descriptor whose schema may be shared with other channels.
+    pub(crate) fn with_shared_schema(
+        id: ChannelId,
+        topic: String,
+        message_encoding: String,
+        metadata: BTreeMap<String, String>,
+        schema: Option<Arc<Schema>>,
+        keep_last: usize,
     ) -> Self {
         Self(Arc::new(Inner {
             id,
@@ -30,6 +50,7 @@ impl ChannelDescriptor {
             message_encoding,
             metadata,
             schema,
+            keep_last,
         }))
     }
 
@@ -63,13 +84,29 @@ impl ChannelDescriptor {
 
     /// Returns the schema for this channel.
     pub fn schema(&self) -> Option<&Schema> {
+        self.0.schema.as_deref()
+    }
+
+    /// Returns the schema for this channel, which may be shared with other channels in the same
+    /// context.
+    pub(crate) fn shared_schema(&self) -> Option<&Arc<Schema>> {
         self.0.schema.as_ref()
     }
 
+    /// Returns the number of most recent messages which the channel retains for sinks that
+    /// subscribe later, or zero if the channel is not latched.
+    pub(crate) fn keep_last(&self) -> usize {
+        self.0.keep_last
+    }
+
     pub(crate) fn matches(&self, other: &Self) -> bool {
         self.0.topic == other.0.topic
             && self.0.message_encoding == other.0.message_encoding
             && self.0.metadata == other.0.metadata
-            && self.0.schema == other.0.schema
+            && match (&self.0.schema, &other.0.schema) {
+                (Some(a), Some(b)) => Arc::ptr_eq(a, b) || a == b,
+                (None, None) => true,
+                _ => false,
+            }
     }
 }
@@ -1,23 +1,98 @@
 //! A raw channel.
 
-use std::collections::BTreeMap;
-use std::sync::atomic::AtomicBool;
-use std::sync::atomic::Ordering::{Acquire, Release};
+use std::cell::OnceCell;
+use std::collections::{BTreeMap, VecDeque};
+use std::sync::atomic::Ordering::{Acquire, Relaxed, Release};
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize};
 use std::sync::{Arc, Weak};
 use std::time::Duration;
 
+use arc_swap::ArcSwap;
+use bytes::Bytes;
 use parking_lot::Mutex;
+use smallvec::SmallVec;
 use tracing::warn;
 
 use super::{ChannelDescriptor, ChannelId};
-use crate::log_sink_set::LogSinkSet;
+use crate::clock::ContextClock;
+use crate::latency;
+use crate::log_sink_set::{LogSinkSet, shared_filter_action};
 use crate::sink::SmallSinkVec;
 use crate::throttler::Throttler;
-use crate::{Context, Metadata, PartialMetadata, Schema, SinkId, nanoseconds_since_epoch};
+use crate::{
+    ChannelDemand, Context, FilterAction, FoxgloveError, Metadata, PartialMetadata, Schema, Sink,
+    SinkId,
+};
 
 /// Interval for throttled warnings.
 static WARN_THROTTLER_INTERVAL: Duration = Duration::from_secs(10);
 
+/// The state of a latched channel.
+///
+/// Each retained message is numbered by a generation, and each subscribed sink records the
+/// generation at which it joined. A sink is replayed the messages retained before it joined, and
+/// receives the messages logged from then on, so it receives each message exactly once without
+/// logging under the lock.
+#[derive(Default)]
+struct Latched {
+    retained: Mutex<Retained>,
+    /// The generation at which each subscribed sink joined.
+    joined: ArcSwap<SmallVec<[(SinkId, u64); 6]>>,
+}
+
+/// The most recent messages logged on a latched channel.
+#[derive(Default)]
+struct Retained {
+    /// The retained messages, oldest first.
+    messages: VecDeque<(Bytes, Metadata)>,
+    /// The generation of the next message to be logged.
+    generation: u64,
+}
+
+impl Latched {
+    /// Records the generation at which each sink joined, keeping it for sinks which had already
+    /// joined, and using `generation` for new ones.
+    ///
+    /// This must be stored before the sinks themselves, so that a logger which loads a sink, and
+    /// then the joined generations, finds the sink's generation.
+    fn join(&self, sinks: &SmallSinkVec, generation: u64) {
+        let previous = self.joined.load();
+        let joined = sinks
+            .iter()
+            .map(|sink| {
+                let since = previous
+                    .iter()
+                    .find(|(id, _)| *id == sink.id())
+                    .map_or(generation, |(_, since)| *since);
+                (sink.id(), since)
+            })
+            .collect();
+        self.joined.store(Arc::new(joined));
+    }
+}
+
+/// The sinks subscribed to a channel, by the context which subscribed them.
+#[derive(Default)]
+struct Bindings {
+    /// Sinks subscribed through the channel's own context.
+    own: SmallSinkVec,
+    /// The other contexts the channel is bound to, and the sinks subscribed through each.
+    bound: SmallVec<[(Weak<Context>, SmallSinkVec); 1]>,
+}
+
+impl Bindings {
+    /// Returns the sinks subscribed through any context, without duplicates.
+    fn sinks(&self) -> SmallSinkVec {
+        let mut sinks = self.own.clone();
+        for sink in self.bound.iter().flat_map(|(_, sinks)| sinks) {
+            if !sinks.iter().any(|s| s.id() == sink.id()) {
+                sinks.push(sink.clone());
+            }
+        }
+        sinks
+    }
+}
+
 /// A log channel that can be used to log binary messages.
 ///
 /// A "channel" is conceptually the same as a [MCAP channel]: it is a stream of messages which all
@@ -36,9 +111,22 @@ static WARN_THROTTLER_INTERVAL: Duration = Duration::from_secs(10);
 pub struct RawChannel {
     descriptor: ChannelDescriptor,
     context: Weak<Context>,
+    /// The context's clock, which provides the log time of messages logged without one.
+    clock: Arc<ContextClock>,
     sinks: LogSinkSet,
+    /// The sinks of each context, which are combined into `sinks`.
+    bindings: Mutex<Bindings>,
     closed: AtomicBool,
     warn_throttler: Mutex<Throttler>,
+    /// The context's count of readers of the logged counters, which are only updated while it's
+    /// nonzero.
+    logged_readers: Arc<AtomicUsize>,
+    /// The number of messages logged to the channel's sinks.
+    logged_messages: AtomicU64,
+    /// The total size of the messages logged to the channel's sinks, in bytes.
+    logged_bytes: AtomicU64,
+    /// The messages retained for sinks that subscribe later, if the channel is latched.
+    latched: Option<Latched>,
 }
 
 impl RawChannel {
@@ -46,21 +134,29 @@ impl RawChannel {
         context: &Arc<Context>,
         topic: String,
         message_encoding: String,
-        schema: Option<Schema>,
+        schema: Option<Arc<Schema>>,
         metadata: BTreeMap<String, String>,
+        keep_last: usize,
     ) -> Arc<Self> {
         Arc::new(Self {
-            descriptor: ChannelDescriptor::new(
+            descriptor: ChannelDescriptor::with_shared_schema(
                 ChannelId::next(),
                 topic,
                 message_encoding,
                 metadata,
                 schema,
+                keep_last,
             ),
             context: Arc::downgrade(context),
+            clock: Arc::clone(context.shared_clock()),
             sinks: LogSinkSet::new(),
+            bindings: Mutex::default(),
             closed: AtomicBool::new(false),
             warn_throttler: Mutex::new(Throttler::new(WARN_THROTTLER_INTERVAL)),
+            logged_readers: Arc::clone(context.logged_readers()),
+            logged_messages: AtomicU64::new(0),
+            logged_bytes: AtomicU64::new(0),
+            latched: (keep_last > 0).then(Latched::default),
         })
     }
 
@@ -112,13 +208,98 @@ impl RawChannel {
         }
     }
 
-    /// Invoked when the channel is removed from its context.
+    /// Binds the channel to another context, so that the sinks of that context also receive the
+    /// channel's messages.
+    ///
+    /// This lets one channel feed sinks which are partitioned by context, such as a full-rate MCAP
+    /// recording in one context and a live WebSocket view in another. Each message is encoded and
+    /// logged once, and dispatched to the sinks of every bound context.
     ///
-    /// This can happen either in the context of an explicit call to [`RawChannel::close`], or due
-    /// to the context being dropped.
-    pub(crate) fn remove_from_context(&self) {
+    /// The channel is advertised to the sinks of `context` as if it had been created there. It
+    /// still belongs to the context it was created in: closing the channel, or dropping that
+    /// context, removes it from every bound context, while dropping a bound context only unbinds
+    /// it. Binding a channel to its own context, or to a context it is already bound to, has no
+    /// effect.
+    ///
+    /// Returns [`FoxgloveError::ValueError`] if the channel is closed, or if `context` already has
+    /// a substantially identical channel.
+    pub fn bind_context(self: &Arc<Self>, context: &Arc<Context>) -> Result<(), FoxgloveError> {
+        let weak_context = Arc::downgrade(context);
+        {
+            let mut bindings = self.bindings.lock();
+            if Weak::ptr_eq(&weak_context, &self.context)
+                || bindings
+                    .bound
+                    .iter()
+                    .any(|(bound, _)| Weak::ptr_eq(bound, &weak_context))
+            {
+                return Ok(());
+            }
+            if self.is_closed() {
+                return Err(FoxgloveError::ValueError(format!(
+                    "channel for {} is closed",
+                    self.topic()
+                )));
+            }
+            bindings
+                .bound
+                .push((weak_context.clone(), SmallSinkVec::new()));
+        }
+        if let Err(err) = context.bind_channel(self) {
+            self.remove_from_context(&weak_context);
+            return Err(err);
+        }
+        // If the channel was closed concurrently, the context may have listed it too late to be
+        // removed along with the others.
+        if self.is_closed() {
+            context.remove_channel(self.id());
+        }
+        Ok(())
+    }
+
+    /// Invoked when the channel is removed from a context.
+    ///
+    /// For the channel's own context, this can happen either in the context of an explicit call
+    /// to [`RawChannel::close`], or due to the context being dropped, and closes the channel.
+    /// Removing the channel from a bound context only disconnects that context's sinks.
+    pub(crate) fn remove_from_context(&self, context: &Weak<Context>) {
+        let mut bindings = self.bindings.lock();
+        if !Weak::ptr_eq(context, &self.context) {
+            bindings
+                .bound
+                .retain(|(bound, _)| !Weak::ptr_eq(bound, context));
+            if !self.is_closed() {
+                let sinks = bindings.sinks();
+                if let Some(latched) = &self.latched {
+                    latched.join(&sinks, latched.retained.lock().generation);
+                }
+                self.sinks.store(sinks);
+            }
+            return;
+        }
         self.closed.store(true, Release);
+        bindings.own.clear();
         self.sinks.clear();
+        if let Some(latched) = &self.latched {
+            latched.retained.lock().messages.clear();
+            latched.joined.store(Arc::default());
+        }
+    }
+
+    /// Removes a closed channel from the contexts it was bound to.
+    ///
+    /// This is called after the channel is removed from its own context, outside of that
+    /// context's lock.
+    pub(crate) fn unbind_closed(&self) {
+        if !self.is_closed() {
+            return;
+        }
+        let bound = std::mem::take(&mut self.bindings.lock().bound);
+        for (context, _) in bound {
+            if let Some(context) = context.upgrade() {
+                context.remove_channel(self.id());
+            }
+        }
     }
 
     /// Returns true if the channel is closed.
@@ -136,9 +317,58 @@ impl RawChannel {
         }
     }
 
-    /// Updates the set of sinks that are subscribed to this channel.
-    pub(crate) fn update_sinks(&self, sinks: SmallSinkVec) {
-        self.sinks.store(sinks);
+    /// Updates the set of sinks that are subscribed to this channel through a context.
+    ///
+    /// If the channel is latched, sinks which were not already subscribed receive the retained
+    /// messages.
+    pub(crate) fn update_sinks(&self, context: &Weak<Context>, sinks: SmallSinkVec) {
+        let mut bindings = self.bindings.lock();
+        if Weak::ptr_eq(context, &self.context) {
+            bindings.own = sinks;
+        } else if self.is_closed() {
+            // The channel is being removed from the contexts it was bound to.
+            return;
+        } else if let Some((_, bound)) = bindings
+            .bound
+            .iter_mut()
+            .find(|(bound, _)| Weak::ptr_eq(bound, context))
+        {
+            *bound = sinks;
+        } else {
+            // The channel has been unbound from the context.
+            return;
+        }
+        // The lock is held while storing the combined set, so that concurrent updates from
+        // different contexts are stored in order.
+        let sinks = bindings.sinks();
+        let Some(latched) = &self.latched else {
+            self.sinks.store(sinks);
+            return;
+        };
+        // New sinks join at the next generation, and are replayed the messages retained before
+        // it. The lock is only held to take the snapshot, so logging isn't blocked by the replay.
+        let retained = latched.retained.lock();
+        latched.join(&sinks, retained.generation);
+        let mut added = SmallVec::<[SinkId; 6]>::new();
+        self.sinks.store_and_for_each_added(sinks, |sink| {
+            added.push(sink.id());
+            Ok(())
+        });
+        if added.is_empty() {
+            return;
+        }
+        let replay: Vec<(Bytes, Metadata)> = retained.messages.iter().cloned().collect();
+        drop(retained);
+        // The set of sinks can't change while the bindings are locked.
+        self.sinks.for_each_filtered(
+            |sink| added.contains(&sink.id()),
+            |sink| {
+                for (msg, metadata) in &replay {
+                    self.log_to(sink, msg, Some(msg), metadata)?;
+                }
+                Ok(())
+            },
+        );
     }
 
     /// Returns true if at least one sink is subscribed to this channel.
@@ -146,6 +376,54 @@ impl RawChannel {
         !self.sinks.is_empty()
     }
 
+    /// Returns the demand for the channel's messages, combined across its sinks.
+    ///
+    /// Producers of expensive messages can use this to scale their work to what is consumed, for
+    /// example by producing messages no faster than [`ChannelDemand::max_rate`]. Demand changes
+    /// as sinks subscribe and unsubscribe, so query it when deciding what to produce.
+    pub fn demand(&self) -> ChannelDemand {
+        self.sinks.demand(self)
+    }
+
+    /// Returns true if a message logged now would reach at least one sink, or be retained by a
+    /// latched channel.
+    ///
+    /// Otherwise, issues the same throttled warning as logging would if the channel is closed.
+    /// This lets wrappers skip building and encoding messages that no sink would receive.
+    #[doc(hidden)]
+    pub fn should_log(&self) -> bool {
+        if self.has_sinks() {
+            return true;
+        }
+        self.log_warn_if_closed();
+        self.latched.is_some() && !self.is_closed()
+    }
+
+    /// Returns the number of messages logged to the channel's sinks, and their total size in
+    /// bytes.
+    ///
+    /// Messages logged while no sink is subscribed, or while nothing reads the counters, are not
+    /// counted. See [`Context::read_logged_counters`].
+    #[cfg_attr(
+        not(any(feature = "_remote-common", feature = "sysinfo")),
+        allow(dead_code)
+    )]
+    pub(crate) fn logged(&self) -> (u64, u64) {
+        (
+            self.logged_messages.load(Relaxed),
+            self.logged_bytes.load(Relaxed),
+        )
+    }
+
+    /// Counts messages logged to the channel's sinks, if anything reads the counters.
+    fn count_logged(&self, messages: u64, bytes: usize) {
+        if self.logged_readers.load(Relaxed) == 0 {
+            return;
+        }
+        self.logged_messages.fetch_add(messages, Relaxed);
+        self.logged_bytes.fetch_add(bytes as u64, Relaxed);
+    }
+
     /// Returns the count of sinks subscribed to this channel.
     #[cfg(all(test, feature = "websocket"))]
     pub(crate) fn num_sinks(&self) -> usize {
@@ -192,30 +470,273 @@ impl RawChannel {
         opts: PartialMetadata,
         sink_id: Option<SinkId>,
     ) {
-        if self.has_sinks() {
+        if self.should_log() {
             self.log_to_sinks(msg, opts, sink_id);
-        } else {
-            self.log_warn_if_closed();
+        }
+    }
+
+    /// Logs a message held in a shared, reference-counted buffer.
+    ///
+    /// Sinks that queue messages may keep a reference to `msg` rather than copying it. Use
+    /// [`Bytes::from_owner`] to wrap a buffer owned by another library, such as a middleware
+    /// message, without copying it; the owner is dropped once every sink has released it.
+    ///
+    /// The buffering behavior depends on the log sink; see [`McapWriter`][crate::McapWriter] and
+    /// [`WebSocketServer`][crate::WebSocketServer] for details.
+    pub fn log_shared(&self, msg: Bytes) {
+        self.log_shared_with_meta_to_sink(msg, PartialMetadata::default(), None);
+    }
+
+    /// Logs a message held in a shared buffer with additional metadata to a specific sink.
+    ///
+    /// If a sink ID is provided, only that sink will receive the message.
+    /// Otherwise, the message will be sent to all subscribed sinks.
+    ///
+    /// See [`RawChannel::log_shared`] for details.
+    pub fn log_shared_with_meta_to_sink(
+        &self,
+        msg: Bytes,
+        opts: PartialMetadata,
+        sink_id: Option<SinkId>,
+    ) {
+        if self.should_log() {
+            self.log_shared_to_sinks(msg, opts, sink_id);
+        }
+    }
+
+    /// Logs a message held in a shared buffer with additional metadata.
+    pub(crate) fn log_shared_to_sinks(
+        &self,
+        msg: Bytes,
+        opts: PartialMetadata,
+        sink_id: Option<SinkId>,
+    ) {
+        let metadata = self.message_metadata(opts);
+        if sink_id.is_none()
+            && let Some(latched) = &self.latched
+        {
+            self.log_latched(latched, msg, metadata);
+            return;
+        }
+        self.dispatch(&msg, Some(&msg), &metadata, sink_id);
+    }
+
+    /// Logs a batch of messages, each with its own metadata.
+    ///
+    /// The set of subscribed sinks is loaded once for the whole batch, and each sink receives the
+    /// batch in a single call. This amortizes per-message overhead when logging many small
+    /// messages at high rates. Messages without a log time share a single clock reading.
+    ///
+    /// The buffering behavior depends on the log sink; see [`McapWriter`][crate::McapWriter] and
+    /// [`WebSocketServer`][crate::WebSocketServer] for details.
+    pub fn log_batch(&self, msgs: &[(&[u8], PartialMetadata)]) {
+        self.log_batch_to_sink(msgs, None);
+    }
+
+    /// Logs a batch of messages to a specific sink.
+    ///
+    /// If a sink ID is provided, only that sink will receive the messages.
+    /// Otherwise, the messages will be sent to all subscribed sinks.
+    ///
+    /// See [`RawChannel::log_batch`] for details.
+    pub fn log_batch_to_sink(&self, msgs: &[(&[u8], PartialMetadata)], sink_id: Option<SinkId>) {
+        if msgs.is_empty() || !self.should_log() {
+            return;
+        }
+        if sink_id.is_none()
+            && let Some(latched) = &self.latched
+        {
+            // Latched messages are retained individually, so log them one at a time. They're copied
+            // to be retained; see [`RawChannel::log_shared`] to avoid the copy.
+            for (msg, opts) in msgs {
+                let metadata = self.message_metadata(*opts);
+                self.log_latched(latched, Bytes::copy_from_slice(msg), metadata);
+            }
+            return;
+        }
+        self.count_logged(
+            msgs.len() as u64,
+            msgs.iter().map(|(msg, _)| msg.len()).sum(),
+        );
+
+        let mut now = None;
+        let batch: Vec<(&[u8], Metadata)> = msgs
+            .iter()
+            .map(|(msg, opts)| {
+                let log_time = opts
+                    .log_time
+                    .unwrap_or_else(|| *now.get_or_insert_with(|| self.clock.now()));
+                (*msg, Metadata { log_time })
+            })
+            .collect();
+
+        match sink_id {
+            Some(id) => {
+                self.sinks.for_each_filtered(
+                    |sink| sink.id() == id,
+                    |sink| self.log_batch_to(sink, &batch),
+                );
+            }
+            None => {
+                self.sinks.for_each(|sink| self.log_batch_to(sink, &batch));
+            }
         }
     }
 
     /// Logs a message with additional metadata.
+    ///
+    /// A message logged on a latched channel is copied to be retained; see
+    /// [`RawChannel::log_shared_to_sinks`] to avoid the copy.
     pub(crate) fn log_to_sinks(&self, msg: &[u8], opts: PartialMetadata, sink_id: Option<SinkId>) {
-        let metadata = Metadata {
-            log_time: opts.log_time.unwrap_or_else(nanoseconds_since_epoch),
-        };
+        let metadata = self.message_metadata(opts);
+        if sink_id.is_none()
+            && let Some(latched) = &self.latched
+        {
+            self.log_latched(latched, Bytes::copy_from_slice(msg), metadata);
+            return;
+        }
+        self.dispatch(msg, None, &metadata, sink_id);
+    }
+
+    /// Returns true if the channel retains messages for sinks that subscribe later.
+    pub(crate) fn is_latched(&self) -> bool {
+        self.latched.is_some()
+    }
+
+    /// Returns the current time of the channel's clock, which provides the log time of messages
+    /// logged without one.
+    pub(crate) fn now(&self) -> u64 {
+        self.clock.now()
+    }
+
+    /// Returns the metadata of a message, reading the clock if no log time was provided.
+    fn message_metadata(&self, opts: PartialMetadata) -> Metadata {
+        Metadata {
+            log_time: opts.log_time.unwrap_or_else(|| self.clock.now()),
+        }
+    }
 
+    /// Logs a message to the channel's sinks, or only to the given sink.
+    ///
+    /// `shared` is the message as a shared buffer, if it was logged as one.
+    fn dispatch(
+        &self,
+        msg: &[u8],
+        shared: Option<&Bytes>,
+        metadata: &Metadata,
+        sink_id: Option<SinkId>,
+    ) {
+        self.count_logged(1, msg.len());
+        let _sample = latency::sample();
         match sink_id {
             Some(id) => {
                 self.sinks.for_each_filtered(
                     |sink| sink.id() == id,
-                    |sink| sink.log(self, msg, &metadata),
+                    |sink| self.log_to(sink, msg, shared, metadata),
                 );
             }
             None => {
-                self.sinks.for_each(|sink| sink.log(self, msg, &metadata));
+                self.sinks
+                    .for_each(|sink| self.log_to(sink, msg, shared, metadata));
+            }
+        }
+    }
+
+    /// Retains a message on a latched channel, evicting the oldest if the channel is full, and
+    /// logs it to the channel's sinks.
+    ///
+    /// The lock is only held to retain the message. It's logged to the sinks which joined at or
+    /// before its generation; a sink which joins later is replayed it instead. A sink subscribing
+    /// concurrently may receive a newer message before the replayed ones, as it may when messages
+    /// are logged concurrently.
+    fn log_latched(&self, latched: &Latched, msg: Bytes, metadata: Metadata) {
+        let generation = {
+            let mut retained = latched.retained.lock();
+            if retained.messages.len() >= self.descriptor.keep_last() {
+                retained.messages.pop_front();
+            }
+            retained.messages.push_back((msg.clone(), metadata));
+            retained.generation += 1;
+            retained.generation - 1
+        };
+        if !self.has_sinks() {
+            return;
+        }
+        self.count_logged(1, msg.len());
+        let _sample = latency::sample();
+        // The joined generations are loaded after the sinks, so they include every sink loaded.
+        let joined = OnceCell::new();
+        self.sinks.for_each_filtered(
+            |sink| {
+                joined
+                    .get_or_init(|| latched.joined.load())
+                    .iter()
+                    .any(|(id, since)| *id == sink.id() && *since <= generation)
+            },
+            |sink| self.log_to(sink, &msg, Some(&msg), &metadata),
+        );
+    }
+
+    /// Returns the messages retained by a latched channel, oldest first.
+    #[cfg_attr(not(feature = "remote-access"), allow(dead_code))]
+    pub(crate) fn latched_messages(&self) -> Vec<(Bytes, Metadata)> {
+        self.latched
+            .as_ref()
+            .map(|latched| latched.retained.lock().messages.iter().cloned().collect())
+            .unwrap_or_default()
+    }
+
+    /// Logs a message to a sink, after running the sink's message filter, if it has one.
+    ///
+    /// `shared` is the message as a shared buffer, if it was logged as one.
+    fn log_to(
+        &self,
+        sink: &Arc<dyn Sink>,
+        msg: &[u8],
+        shared: Option<&Bytes>,
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        if let Some(filter) = sink.message_filter() {
+            match shared_filter_action(filter, &self.descriptor, msg, metadata) {
+                FilterAction::Keep => {}
+                FilterAction::Drop => return Ok(()),
+                FilterAction::Replace(replacement) => {
+                    return sink.log_shared(self, &replacement, metadata);
+                }
             }
         }
+        match shared {
+            Some(shared) => sink.log_shared(self, shared, metadata),
+            None => sink.log(self, msg, metadata),
+        }
+    }
+
+    /// Logs a batch of messages to a sink, after running the sink's message filter, if it has one.
+    fn log_batch_to(
+        &self,
+        sink: &Arc<dyn Sink>,
+        batch: &[(&[u8], Metadata)],
+    ) -> Result<(), FoxgloveError> {
+        let Some(filter) = sink.message_filter() else {
+            return sink.log_batch(self, batch);
+        };
+        let actions: Vec<FilterAction> = batch
+            .iter()
+            .map(|(msg, metadata)| shared_filter_action(filter, &self.descriptor, msg, metadata))
+            .collect();
+        let filtered: Vec<(&[u8], Metadata)> = batch
+            .iter()
+            .zip(&actions)
+            .filter_map(|(&(msg, metadata), action)| match action {
+                FilterAction::Keep => Some((msg, metadata)),
+                FilterAction::Drop => None,
+                FilterAction::Replace(replacement) => Some((replacement.as_ref(), metadata)),
+            })
+            .collect();
+        if filtered.is_empty() {
+            return Ok(());
+        }
+        sink.log_batch(self, &filtered)
     }
 }
 
@@ -11,6 +11,7 @@ pub struct ChannelBuilder {
     message_encoding: Option<String>,
     schema: Option<Schema>,
     metadata: BTreeMap<String, String>,
+    keep_last: usize,
     context: Arc<Context>,
 }
 
@@ -24,6 +25,7 @@ impl ChannelBuilder {
             message_encoding: None,
             schema: None,
             metadata: BTreeMap::new(),
+            keep_last: 0,
             context: Context::get_default(),
         }
     }
@@ -59,6 +61,20 @@ impl ChannelBuilder {
         self
     }
 
+    /// Latches the channel, retaining its last `n` messages for sinks that subscribe later.
+    ///
+    /// Use this for data that changes rarely, such as static transforms, calibrations or maps.
+    /// Each WebSocket client, remote access participant or MCAP writer that subscribes to the
+    /// channel receives the retained messages immediately, and each segment of a rotated MCAP
+    /// recording begins with them, so the data doesn't need to be logged periodically.
+    ///
+    /// Retained messages are delivered with their original log time. Messages logged to a specific
+    /// sink are not retained. The default of zero retains no messages.
+    pub fn keep_last(mut self, n: usize) -> Self {
+        self.keep_last = n;
+        self
+    }
+
     /// Sets the context for this channel.
     pub fn context(mut self, ctx: &Arc<Context>) -> Self {
         self.context = ctx.clone();
@@ -69,16 +85,25 @@ impl ChannelBuilder {
     ///
     /// Returns [`FoxgloveError::MessageEncodingRequired`] if no message encoding was specified.
     pub fn build_raw(self) -> Result<Arc<RawChannel>, FoxgloveError> {
-        let mut channel = RawChannel::new(
+        let context = self.context.clone();
+        let channel = self.into_raw_channel()?;
+        Ok(context.add_channel(channel))
+    }
+
+    /// Constructs a [`RawChannel`], without adding it to the context.
+    pub(crate) fn into_raw_channel(self) -> Result<Arc<RawChannel>, FoxgloveError> {
+        let message_encoding = self
+            .message_encoding
+            .ok_or_else(|| FoxgloveError::MessageEncodingRequired)?;
+        let schema = self.schema.map(|schema| self.context.intern_schema(schema));
+        Ok(RawChannel::new(
             &self.context,
             self.topic,
-            self.message_encoding
-                .ok_or_else(|| FoxgloveError::MessageEncodingRequired)?,
-            self.schema,
+            message_encoding,
+            schema,
             self.metadata,
-        );
-        channel = self.context.add_channel(channel);
-        Ok(channel)
+            self.keep_last,
+        ))
     }
 
     /// Builds a [`Channel`].
@@ -0,0 +1,261 @@
+//! Clocks which provide the log time of messages logged without one.
+use std::sync::atomic::Ordering::Relaxed;
+use std::sync::atomic::{AtomicBool, AtomicU64};
+use std::sync::{Arc, LazyLock};
+use std::time::{Duration, Instant, SystemTime, UNIX_EPOCH};
+
+use arc_swap::ArcSwapOption;
+
+use crate::ToUnixNanos;
+
+/// A source of the current time, in nanoseconds since the Unix epoch.
+///
+/// The clock of a [`Context`][crate::Context] provides the log time of messages which are logged
+/// without one. Set it with [`Context::set_clock`][crate::Context::set_clock]. By default, each
+/// context uses a shared [`MonotonicClock`].
+///
+/// Clocks are read on the logging thread, once per message or batch, and must be cheap.
+pub trait Clock: Send + Sync {
+    /// Returns the current time, in nanoseconds since the Unix epoch.
+    fn now(&self) -> u64;
+}
+
+/// A [`Clock`] which reads the system wall clock.
+///
+/// The wall clock may jump backwards or forwards, for example when it is stepped by NTP, so log
+/// times from this clock are not guaranteed to be in order.
+#[derive(Debug, Default, Clone, Copy)]
+pub struct SystemClock;
+
+impl Clock for SystemClock {
+    fn now(&self) -> u64 {
+        wall_nanos()
+    }
+}
+
+/// A [`Clock`] which never goes backwards, anchored to the system wall clock.
+///
+/// The clock reads the monotonic clock, which is served from the vDSO on Linux without a system
+/// call, and adds an offset to the Unix epoch. The offset is resynchronized with the wall clock
+/// periodically, on the first read after each resync interval. Forward steps of the wall clock
+/// are applied immediately. Backward steps are applied gradually, by at most one thousandth of
+/// the resync interval at each resync, so that the clock slows down briefly rather than going
+/// backwards.
+///
+/// This is the default clock of every [`Context`][crate::Context].
+#[derive(Debug)]
+pub struct MonotonicClock {
+    base: Instant,
+    /// Nanoseconds since the epoch at `base`.
+    offset: AtomicU64,
+    /// Nanoseconds since `base` at which the offset is next resynchronized.
+    next_resync: AtomicU64,
+    resync_interval: u64,
+    /// The latest time returned by the clock.
+    last: AtomicU64,
+}
+
+impl Default for MonotonicClock {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl MonotonicClock {
+    /// Creates a clock which resynchronizes with the wall clock every second.
+    pub fn new() -> Self {
+        Self::with_resync_interval(Duration::from_secs(1))
+    }
+
+    /// Creates a clock which resynchronizes with the wall clock at the given interval.
+    pub fn with_resync_interval(interval: Duration) -> Self {
+        let resync_interval = u64::try_from(interval.as_nanos()).unwrap_or(u64::MAX);
+        let base = Instant::now();
+        Self {
+            base,
+            offset: AtomicU64::new(wall_nanos().saturating_sub(elapsed_nanos(base))),
+            next_resync: AtomicU64::new(resync_interval),
+            resync_interval,
+            last: AtomicU64::new(0),
+        }
+    }
+
+    fn resync(&self, elapsed: u64) {
+        // Only the thread which advances the deadline resynchronizes.
+        let next = self.next_resync.load(Relaxed);
+        if elapsed < next
+            || self
+                .next_resync
+                .compare_exchange(
+                    next,
+                    elapsed.saturating_add(self.resync_interval),
+                    Relaxed,
+                    Relaxed,
+                )
+                .is_err()
+        {
+            return;
+        }
+        let target = wall_nanos().saturating_sub(elapsed);
+        let offset = self.offset.load(Relaxed);
+        let max_slew = (self.resync_interval / 1000).max(1);
+        let offset = target.max(offset.saturating_sub(max_slew));
+        self.offset.store(offset, Relaxed);
+    }
+}
+
+impl Clock for MonotonicClock {
+    fn now(&self) -> u64 {
+        let elapsed = elapsed_nanos(self.base);
+        if elapsed >= self.next_resync.load(Relaxed) {
+            self.resync(elapsed);
+        }
+        let now = elapsed + self.offset.load(Relaxed);
+        // A backward slew, or a race with a resync, may produce a time earlier than one already
+        // returned.
+        self.last.fetch_max(now, Relaxed).max(now)
+    }
+}
+
+/// A [`Clock`] which is set by the application, for example from simulation time.
+///
+/// The clock only changes when it is set. When serving WebSocket clients, publish the same time
+/// with `WebSocketServerHandle::broadcast_time`, so that the app's playback time follows the
+/// logged messages.
+///
+/// ```
+/// use std::sync::Arc;
+///
+/// use foxglove::{Context, SimClock};
+///
+/// let ctx = Context::new();
+/// let clock = Arc::new(SimClock::new(0));
+/// ctx.set_clock(clock.clone());
+/// clock.set_time(1_000_000_000u64);
+/// assert_eq!(ctx.now(), 1_000_000_000);
+/// ```
+#[derive(Debug, Default)]
+pub struct SimClock(AtomicU64);
+
+impl SimClock {
+    /// Creates a clock which starts at the given time.
+    pub fn new(start: impl ToUnixNanos) -> Self {
+        Self(AtomicU64::new(start.to_unix_nanos()))
+    }
+
+    /// Sets the current time.
+    pub fn set_time(&self, time: impl ToUnixNanos) {
+        self.0.store(time.to_unix_nanos(), Relaxed);
+    }
+
+    /// Advances the current time.
+    pub fn advance(&self, duration: Duration) {
+        let nanos = u64::try_from(duration.as_nanos()).unwrap_or(u64::MAX);
+        let _ = self
+            .0
+            .fetch_update(Relaxed, Relaxed, |now| Some(now.saturating_add(nanos)));
+    }
+}
+
+impl Clock for SimClock {
+    fn now(&self) -> u64 {
+        self.0.load(Relaxed)
+    }
+}
+
+/// The clock shared by a context and its channels.
+#[derive(Default)]
+pub(crate) struct ContextClock {
+    /// Whether `clock` is set, checked first so that the default clock is read without touching
+    /// the swap.
+    custom: AtomicBool,
+    clock: ArcSwapOption<Arc<dyn Clock>>,
+}
+
+impl ContextClock {
+    pub(crate) fn set(&self, clock: Option<Arc<dyn Clock>>) {
+        self.custom.store(clock.is_some(), Relaxed);
+        self.clock.store(clock.map(Arc::new));
+    }
+
+    pub(crate) fn now(&self) -> u64 {
+        if self.custom.load(Relaxed)
+            && let Some(clock) = &*self.clock.load()
+        {
+            return clock.now();
+        }
+        default_now()
+    }
+}
+
+/// Returns the time of the default clock, shared by every context.
+pub(crate) fn default_now() -> u64 {
+    static DEFAULT_CLOCK: LazyLock<MonotonicClock> = LazyLock::new(MonotonicClock::new);
+    DEFAULT_CLOCK.now()
+}
+
+fn wall_nanos() -> u64 {
+    SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .map_or(0, |duration| {
+            u64::try_from(duration.as_nanos()).unwrap_or(u64::MAX)
+        })
+}
+
+fn elapsed_nanos(base: Instant) -> u64 {
+    u64::try_from(base.elapsed().as_nanos()).unwrap_or(u64::MAX)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_monotonic_clock_tracks_wall_clock() {
+        let clock = MonotonicClock::with_resync_interval(Duration::from_millis(1));
+        let mut last = 0;
+        for _ in 0..1000 {
+            let now = clock.now();
+            assert!(now >= last);
+            last = now;
+        }
+        let wall = wall_nanos();
+        assert!(last.abs_diff(wall) < Duration::from_millis(100).as_nanos() as u64);
+    }
+
+    #[test]
+    fn test_monotonic_clock_slews_backward_steps() {
+        let clock = MonotonicClock::with_resync_interval(Duration::from_secs(1));
+        let before = clock.now();
+        // Simulate the wall clock stepping back by a minute, and force a resync.
+        clock.offset.fetch_add(60_000_000_000, Relaxed);
+        clock.next_resync.store(0, Relaxed);
+        let stepped = clock.now();
+        assert!(stepped >= before);
+        clock.next_resync.store(0, Relaxed);
+        let slewed = clock.now();
+        // The correction is applied by at most a millisecond per resync.
+        assert!(slewed >= stepped);
+        assert!(slewed - before > 59_000_000_000);
+    }
+
+    #[test]
+    fn test_sim_clock() {
+        let clock = SimClock::new(10u64);
+        assert_eq!(clock.now(), 10);
+        clock.set_time(5u64);
+        assert_eq!(clock.now(), 5);
+        clock.advance(Duration::from_nanos(3));
+        assert_eq!(clock.now(), 8);
+    }
+
+    #[test]
+    fn test_context_clock() {
+        let context_clock = ContextClock::default();
+        let sim = Arc::new(SimClock::new(42u64));
+        context_clock.set(Some(sim.clone()));
+        assert_eq!(context_clock.now(), 42);
+        context_clock.set(None);
+        assert!(context_clock.now() > 42);
+    }
+}
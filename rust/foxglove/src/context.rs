@@ -1,26 +1,38 @@
 use std::collections::HashMap;
 use std::collections::hash_map::Entry;
 use std::fmt::Debug;
-use std::sync::Arc;
+use std::sync::atomic::AtomicUsize;
+use std::sync::atomic::Ordering::Relaxed;
+use std::sync::{Arc, Weak};
 
 use parking_lot::RwLock;
 use smallvec::SmallVec;
 use tracing::warn;
 
-use crate::{ChannelBuilder, ChannelId, McapWriteOptions, McapWriter, RawChannel, Sink, SinkId};
+use crate::clock::ContextClock;
+use crate::memory_budget::{MemoryAccount, MemoryAccounting};
+use crate::{
+    ChannelBuilder, ChannelId, Clock, FoxgloveError, McapWriteOptions, McapWriter, MemoryBudget,
+    MemoryPool, MemoryUsage, RawChannel, Schema, Sink, SinkId, SinkStats,
+};
 
 mod lazy_context;
+mod schemas;
 mod subscriptions;
 
 pub use lazy_context::LazyContext;
+use schemas::SchemaInterner;
 use subscriptions::Subscriptions;
 
 #[derive(Default)]
 struct ContextInner {
+    /// The context which owns this state, which identifies it to the channels bound to it.
+    this: Weak<Context>,
     channels: HashMap<ChannelId, Arc<RawChannel>>,
     channels_by_topic: HashMap<String, SmallVec<[Arc<RawChannel>; 1]>>,
     sinks: HashMap<SinkId, Arc<dyn Sink>>,
     subs: Subscriptions,
+    schemas: SchemaInterner,
 }
 impl ContextInner {
     /// Returns the channel for the specified topic, if there is one.
@@ -33,12 +45,91 @@ impl ContextInner {
 
     /// Adds a channel to the context.
     fn add_channel(&mut self, channel: Arc<RawChannel>) -> Arc<RawChannel> {
+        if let Some(matching) = self.index_channel(&channel) {
+            return matching;
+        }
+        self.connect_channel(&channel);
+        channel
+    }
+
+    /// Adds a channel which belongs to another context.
+    fn bind_channel(&mut self, channel: &Arc<RawChannel>) -> Result<(), FoxgloveError> {
+        if self.index_channel(channel).is_some() {
+            return Err(FoxgloveError::ValueError(format!(
+                "a channel for {} already exists in this context",
+                channel.topic()
+            )));
+        }
+        self.connect_channel(channel);
+        Ok(())
+    }
+
+    /// Notifies sinks of a newly indexed channel, and connects its subscribers.
+    fn connect_channel(&mut self, channel: &Arc<RawChannel>) {
+        // Notify sinks of new channel. Sinks that dynamically manage subscriptions may return true
+        // from `add_channel` to add a subscription synchronously.
+        for sink in self.sinks.values() {
+            if sink.add_channel(channel) && !sink.auto_subscribe() {
+                self.subs.subscribe_channels(sink, &[channel.id()]);
+            }
+        }
+
+        // Connect channel sinks.
+        let sinks = self.subs.get_subscribers(channel.id());
+        channel.update_sinks(&self.this, sinks);
+    }
+
+    /// Adds a batch of channels to the context.
+    ///
+    /// Unlike calling [`ContextInner::add_channel`] for each channel, each sink is notified once,
+    /// with all of the new channels, so that it can advertise them together.
+    ///
+    /// Returns the added channels in order, or for channels that are substantially identical to an
+    /// existing channel, the existing channel.
+    fn add_channels(&mut self, channels: Vec<Arc<RawChannel>>) -> Vec<Arc<RawChannel>> {
+        let mut added = Vec::with_capacity(channels.len());
+        let mut result = Vec::with_capacity(channels.len());
+        for channel in channels {
+            if let Some(matching) = self.index_channel(&channel) {
+                result.push(matching);
+            } else {
+                added.push(channel.clone());
+                result.push(channel);
+            }
+        }
+        if added.is_empty() {
+            return result;
+        }
+
+        // Notify sinks of new channels. Sinks that dynamically manage subscriptions may return a
+        // set of channel IDs that they want to subscribe to immediately.
+        let added_refs: Vec<_> = added.iter().collect();
+        for sink in self.sinks.values() {
+            let Some(mut ids) = sink.add_channels(&added_refs) else {
+                continue;
+            };
+            ids.retain(|id| added.iter().any(|c| c.id() == *id));
+            if !ids.is_empty() && !sink.auto_subscribe() {
+                self.subs.subscribe_channels(sink, &ids);
+            }
+        }
+
+        // Connect channel sinks.
+        self.update_channel_sinks(&added);
+        result
+    }
+
+    /// Adds a channel to the context's indexes.
+    ///
+    /// If a substantially identical channel already exists, returns that channel, and the indexes
+    /// are left unchanged.
+    fn index_channel(&mut self, channel: &Arc<RawChannel>) -> Option<Arc<RawChannel>> {
         let topic = channel.topic();
 
         // If a substantially identical channel already exists, just return that.
         let topic_channels = self.channels_by_topic.entry(topic.to_string()).or_default();
         if let Some(matching) = topic_channels.iter().find(|c| channel.matches(c)) {
-            return matching.clone();
+            return Some(matching.clone());
         }
 
         // Friends don't let friends create multiple channels on the same topic.
@@ -52,26 +143,12 @@ impl ContextInner {
         // Add the channel to the indexes.
         self.channels.insert(channel.id(), channel.clone());
         topic_channels.push(channel.clone());
-
-        // Notify sinks of new channel. Sinks that dynamically manage subscriptions may return true
-        // from `add_channel` to add a subscription synchronously.
-        for sink in self.sinks.values() {
-            if sink.add_channel(&channel) && !sink.auto_subscribe() {
-                self.subs.subscribe_channels(sink, &[channel.id()]);
-            }
-        }
-
-        // Connect channel sinks.
-        let sinks = self.subs.get_subscribers(channel.id());
-        channel.update_sinks(sinks);
-        channel
+        None
     }
 
-    /// Removes a channel from the context.
-    fn remove_channel(&mut self, channel_id: ChannelId) -> bool {
-        let Some(channel) = self.channels.remove(&channel_id) else {
-            return false;
-        };
+    /// Removes a channel from the context, and returns it.
+    fn remove_channel(&mut self, channel_id: ChannelId) -> Option<Arc<RawChannel>> {
+        let channel = self.channels.remove(&channel_id)?;
 
         // Remove the channel from the topic index.
         if let Some(topic_channels) = self.channels_by_topic.get_mut(channel.topic()) {
@@ -84,15 +161,19 @@ impl ContextInner {
         // Remove subscriptions for this channel.
         self.subs.remove_channel_subscriptions(channel.id());
 
+        if let Some(schema) = channel.descriptor().shared_schema() {
+            self.schemas.release(schema);
+        }
+
         // Close the channel and remove sinks.
-        channel.remove_from_context();
+        channel.remove_from_context(&self.this);
 
         // Notify sinks of removed channel.
         for sink in self.sinks.values() {
             sink.remove_channel(&channel);
         }
 
-        true
+        Some(channel)
     }
 
     /// Adds a sink to the context.
@@ -164,24 +245,26 @@ impl ContextInner {
         for channel in channels {
             let channel = channel.as_ref();
             let sinks = self.subs.get_subscribers(channel.id());
-            channel.update_sinks(sinks);
+            channel.update_sinks(&self.this, sinks);
         }
     }
 
-    /// Removes all channels and sinks from the context.
-    fn clear(&mut self) {
-        for (_, channel) in self.channels.drain() {
+    /// Removes all channels and sinks from the context, and returns the removed channels.
+    fn clear(&mut self) -> Vec<Arc<RawChannel>> {
+        let channels: Vec<_> = self.channels.drain().map(|(_, channel)| channel).collect();
+        for channel in &channels {
             // Close the channel and remove sinks.
-            channel.remove_from_context();
+            channel.remove_from_context(&self.this);
 
             // Notify sink of removed channel.
             for sink in self.sinks.values() {
-                sink.remove_channel(&channel);
+                sink.remove_channel(channel);
             }
         }
         self.channels_by_topic.clear();
         self.sinks.clear();
         self.subs.clear();
+        channels
     }
 }
 
@@ -189,7 +272,8 @@ impl ContextInner {
 ///
 /// Each channel and each sink belongs to exactly one context. Sinks receive advertisements about
 /// channels on the context, and can optionally subscribe to receive logged messages on those
-/// channels.
+/// channels. A channel can also be bound to other contexts with [`RawChannel::bind_context`], so
+/// that their sinks receive its messages without logging them twice.
 ///
 /// When the context is dropped, its corresponding channels and sinks will be disconnected from one
 /// another, and logging will stop. Attempts to log on a channel after its context has been dropped
@@ -222,7 +306,24 @@ impl ContextInner {
 ///     ..Log::default()
 /// });
 /// ```
-pub struct Context(RwLock<ContextInner>);
+pub struct Context {
+    inner: RwLock<ContextInner>,
+    clock: Arc<ContextClock>,
+    memory: Arc<MemoryAccounting>,
+    /// The number of readers of the channels' logged counters. Channels only count the messages
+    /// they log while there is a reader.
+    logged_readers: Arc<AtomicUsize>,
+}
+
+/// Keeps the logged counters of a context's channels enabled. See
+/// [`Context::read_logged_counters`].
+pub(crate) struct LoggedCountersReader(Arc<AtomicUsize>);
+
+impl Drop for LoggedCountersReader {
+    fn drop(&mut self) {
+        self.0.fetch_sub(1, Relaxed);
+    }
+}
 
 impl Debug for Context {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
@@ -234,7 +335,15 @@ impl Context {
     /// Instantiates a new context.
     #[allow(clippy::new_without_default)] // avoid confusion with Context::get_default()
     pub fn new() -> Arc<Self> {
-        Arc::new(Self(RwLock::default()))
+        Arc::new_cyclic(|this| Self {
+            inner: RwLock::new(ContextInner {
+                this: this.clone(),
+                ..ContextInner::default()
+            }),
+            clock: Arc::default(),
+            memory: Arc::default(),
+            logged_readers: Arc::default(),
+        })
     }
 
     /// Returns a reference to the default context.
@@ -244,6 +353,70 @@ impl Context {
         Arc::clone(LazyContext::get_default())
     }
 
+    /// Sets the clock which provides the log time of messages logged without one.
+    ///
+    /// Channels in this context read the clock once for each such message, or once for each
+    /// batch. By default, contexts use a shared [`MonotonicClock`][crate::MonotonicClock].
+    pub fn set_clock(&self, clock: Arc<dyn Clock>) {
+        self.clock.set(Some(clock));
+    }
+
+    /// Restores the default clock, after [`Context::set_clock`].
+    pub fn reset_clock(&self) {
+        self.clock.set(None);
+    }
+
+    /// Returns the current time of this context's clock, in nanoseconds since the Unix epoch.
+    ///
+    /// This is the log time given to a message logged without one.
+    pub fn now(&self) -> u64 {
+        self.clock.now()
+    }
+
+    /// Returns the clock shared by this context and its channels.
+    pub(crate) fn shared_clock(&self) -> &Arc<ContextClock> {
+        &self.clock
+    }
+
+    /// Returns the reader count shared by this context and its channels, which enables their
+    /// logged counters.
+    pub(crate) fn logged_readers(&self) -> &Arc<AtomicUsize> {
+        &self.logged_readers
+    }
+
+    /// Enables the logged counters of this context's channels until the returned guard is dropped.
+    ///
+    /// Otherwise, logging doesn't touch the shared counters, which would cost cross-core traffic
+    /// on every log call while nothing reads them.
+    #[cfg_attr(
+        not(any(feature = "_remote-common", feature = "sysinfo")),
+        allow(dead_code)
+    )]
+    pub(crate) fn read_logged_counters(&self) -> LoggedCountersReader {
+        self.logged_readers.fetch_add(1, Relaxed);
+        LoggedCountersReader(self.logged_readers.clone())
+    }
+
+    /// Sets or removes the budget for the messages buffered by the sinks of this context.
+    ///
+    /// The budget applies to sinks created before or after it is set. By default, a context has no
+    /// budget, and each sink is only limited by its own options. See [`MemoryBudget`].
+    pub fn set_memory_budget(&self, budget: Option<MemoryBudget>) {
+        self.memory.set_budget(budget);
+    }
+
+    /// Returns the number of bytes buffered by the sinks of this context.
+    ///
+    /// Usage is accounted whether or not the context has a budget.
+    pub fn memory_usage(&self) -> MemoryUsage {
+        self.memory.usage()
+    }
+
+    /// Returns an account for a sink to charge the bytes it buffers to this context.
+    pub(crate) fn memory_account(&self, pool: MemoryPool) -> MemoryAccount {
+        MemoryAccount::new(self.memory.clone(), pool)
+    }
+
     /// Returns a channel builder for a channel in this context.
     ///
     /// You should choose a unique topic name per channel for compatibility with the Foxglove app.
@@ -273,7 +446,13 @@ impl Context {
     /// If multiple channels use the same topic name, this will return the first channel that was
     /// added to this context.
     pub fn get_channel_by_topic(&self, topic: &str) -> Option<Arc<RawChannel>> {
-        self.0.read().get_channel_by_topic(topic).cloned()
+        self.inner.read().get_channel_by_topic(topic).cloned()
+    }
+
+    /// Returns a copy of the schema which is shared with any other channels in this context that
+    /// use a schema with the same content.
+    pub(crate) fn intern_schema(&self, schema: Schema) -> Arc<Schema> {
+        self.inner.write().schemas.intern(schema)
     }
 
     /// Adds a channel to the context, or returns a channel with the same topic and schema.
@@ -282,7 +461,38 @@ impl Context {
     /// consistent. Publicly, the only way to add a channel to a context is by constructing it via
     /// a [`ChannelBuilder`][crate::ChannelBuilder].
     pub(crate) fn add_channel(&self, channel: Arc<RawChannel>) -> Arc<RawChannel> {
-        self.0.write().add_channel(channel)
+        self.inner.write().add_channel(channel)
+    }
+
+    /// Adds a channel which belongs to another context.
+    ///
+    /// Publicly, channels are bound to a context with [`RawChannel::bind_context`].
+    pub(crate) fn bind_channel(&self, channel: &Arc<RawChannel>) -> Result<(), FoxgloveError> {
+        self.inner.write().bind_channel(channel)
+    }
+
+    /// Creates a batch of channels in this context.
+    ///
+    /// The channels are registered atomically, and each sink is notified of them together. For
+    /// example, the WebSocket server sends each client a single advertisement for the batch,
+    /// rather than one per channel. Prefer this to calling [`ChannelBuilder::build_raw`] in a loop
+    /// when creating many channels at once.
+    ///
+    /// The context of each builder is ignored; all channels are created in this context. As with
+    /// [`ChannelBuilder::build_raw`], if a substantially identical channel already exists, that
+    /// channel is returned in place of a new one.
+    ///
+    /// Returns [`FoxgloveError::MessageEncodingRequired`] if any builder has no message encoding,
+    /// in which case no channels are created.
+    pub fn create_channels(
+        self: &Arc<Self>,
+        builders: impl IntoIterator<Item = ChannelBuilder>,
+    ) -> Result<Vec<Arc<RawChannel>>, FoxgloveError> {
+        let channels = builders
+            .into_iter()
+            .map(|builder| builder.context(self).into_raw_channel())
+            .collect::<Result<Vec<_>, _>>()?;
+        Ok(self.inner.write().add_channels(channels))
     }
 
     /// Removes a channel from the context.
@@ -291,7 +501,11 @@ impl Context {
     /// consistent. Publicly, the only way to remove a channel from a context is by calling
     /// [`RawChannel::close`], or by dropping the context entirely.
     pub(crate) fn remove_channel(&self, channel_id: ChannelId) -> bool {
-        self.0.write().remove_channel(channel_id)
+        let Some(channel) = self.inner.write().remove_channel(channel_id) else {
+            return false;
+        };
+        channel.unbind_closed();
+        true
     }
 
     /// Adds a sink to the context.
@@ -304,13 +518,13 @@ impl Context {
     /// [`Context::unsubscribe_channels`].
     #[doc(hidden)] // Hidden until Sink is public
     pub fn add_sink(&self, sink: Arc<dyn Sink>) -> bool {
-        self.0.write().add_sink(sink)
+        self.inner.write().add_sink(sink)
     }
 
     /// Removes a sink from the context.
     #[doc(hidden)] // Hidden until Sink is public.
     pub fn remove_sink(&self, sink_id: SinkId) -> bool {
-        self.0.write().remove_sink(sink_id)
+        self.inner.write().remove_sink(sink_id)
     }
 
     /// Subscribes a sink to the specified channels.
@@ -318,7 +532,7 @@ impl Context {
     /// This method has no effect for sinks that return true from [`Sink::auto_subscribe`].
     #[doc(hidden)] // Hidden until Sink is public.
     pub fn subscribe_channels(&self, sink_id: SinkId, channel_ids: &[ChannelId]) {
-        self.0.write().subscribe_channels(sink_id, channel_ids);
+        self.inner.write().subscribe_channels(sink_id, channel_ids);
     }
 
     /// Unsubscribes a sink from the specified channels.
@@ -326,12 +540,60 @@ impl Context {
     /// This method has no effect for sinks that return true from [`Sink::auto_subscribe`].
     #[doc(hidden)] // Hidden until Sink is public.
     pub fn unsubscribe_channels(&self, sink_id: SinkId, channel_ids: &[ChannelId]) {
-        self.0.write().unsubscribe_channels(sink_id, channel_ids);
+        self.inner
+            .write()
+            .unsubscribe_channels(sink_id, channel_ids);
+    }
+
+    /// Returns the sum of the delivery counters reported by the context's sinks.
+    #[cfg_attr(not(feature = "sysinfo"), allow(dead_code))]
+    pub(crate) fn sink_stats(&self) -> SinkStats {
+        let mut total = SinkStats::default();
+        for (_, stats) in self.sink_stats_by_sink() {
+            total += stats;
+        }
+        total
+    }
+
+    /// Returns the delivery counters reported by each of the context's sinks, ordered by sink ID.
+    #[cfg_attr(
+        not(any(feature = "_remote-common", feature = "sysinfo")),
+        allow(dead_code)
+    )]
+    pub(crate) fn sink_stats_by_sink(&self) -> Vec<(SinkId, SinkStats)> {
+        // Collect the sinks first, so that their counters are not read under the context's lock.
+        let sinks: Vec<_> = self.inner.read().sinks.values().cloned().collect();
+        let mut stats: Vec<_> = sinks
+            .iter()
+            .filter_map(|sink| Some((sink.id(), sink.sink_stats()?)))
+            .collect();
+        stats.sort_unstable_by_key(|(id, _)| *id);
+        stats
+    }
+
+    /// Returns the channel with the given ID, if there is one.
+    #[cfg_attr(not(feature = "remote-access"), allow(dead_code))]
+    pub(crate) fn get_channel(&self, channel_id: ChannelId) -> Option<Arc<RawChannel>> {
+        self.inner.read().channels.get(&channel_id).cloned()
+    }
+
+    /// Returns the context's channels, ordered by channel ID.
+    #[cfg_attr(
+        not(any(feature = "_remote-common", feature = "sysinfo")),
+        allow(dead_code)
+    )]
+    pub(crate) fn channels(&self) -> Vec<Arc<RawChannel>> {
+        let mut channels: Vec<_> = self.inner.read().channels.values().cloned().collect();
+        channels.sort_unstable_by_key(|channel| u64::from(channel.id()));
+        channels
     }
 
     /// Removes all channels and sinks from the context.
     pub(crate) fn clear(&self) {
-        self.0.write().clear();
+        let channels = self.inner.write().clear();
+        for channel in channels {
+            channel.unbind_closed();
+        }
     }
 }
 
@@ -373,6 +635,37 @@ mod tests {
         new_test_channel_builder(ctx, topic).build_raw()
     }
 
+    #[test]
+    fn test_channels_share_identical_schemas() {
+        let ctx = Context::new();
+        let a = new_test_channel(&ctx, "/a").unwrap();
+        let b = new_test_channel(&ctx, "/b").unwrap();
+        let c = new_test_channel_builder(&ctx, "/c")
+            .schema(Schema::new("other", "encoding", b"{}"))
+            .build_raw()
+            .unwrap();
+        let schema_a = a.descriptor().shared_schema().unwrap();
+        let schema_b = b.descriptor().shared_schema().unwrap();
+        let schema_c = c.descriptor().shared_schema().unwrap();
+        assert!(Arc::ptr_eq(schema_a, schema_b));
+        assert!(!Arc::ptr_eq(schema_a, schema_c));
+
+        // Channels in other contexts don't share schemas.
+        let other = new_test_channel(&Context::new(), "/a").unwrap();
+        assert!(!Arc::ptr_eq(
+            schema_a,
+            other.descriptor().shared_schema().unwrap()
+        ));
+
+        // The schema stays interned while any channel uses it.
+        a.close();
+        let d = new_test_channel(&ctx, "/d").unwrap();
+        assert!(Arc::ptr_eq(
+            schema_b,
+            d.descriptor().shared_schema().unwrap()
+        ));
+    }
+
     #[test]
     fn test_add_and_remove_sink() {
         let ctx = Context::new();
@@ -397,6 +690,53 @@ mod tests {
     }
 
     #[traced_test]
+    #[test]
+    fn test_sink_stats() {
+        struct StatsSink(SinkId, SinkStats);
+        impl Sink for StatsSink {
+            fn id(&self) -> SinkId {
+                self.0
+            }
+            fn log(
+                &self,
+                _channel: &RawChannel,
+                _msg: &[u8],
+                _metadata: &crate::Metadata,
+            ) -> Result<(), FoxgloveError> {
+                Ok(())
+            }
+            fn sink_stats(&self) -> Option<SinkStats> {
+                Some(self.1)
+            }
+        }
+
+        let ctx = Context::new();
+        assert_eq!(ctx.sink_stats(), SinkStats::default());
+        let stats = SinkStats {
+            queued_messages: 1,
+            queued_bytes: 10,
+            sent_messages: 2,
+            sent_bytes: 20,
+            dropped_messages: 3,
+            ..SinkStats::default()
+        };
+        ctx.add_sink(Arc::new(StatsSink(SinkId::next(), stats)));
+        ctx.add_sink(Arc::new(StatsSink(SinkId::next(), stats)));
+        // Sinks which don't report stats are ignored.
+        ctx.add_sink(Arc::new(MockSink::default()));
+        assert_eq!(
+            ctx.sink_stats(),
+            SinkStats {
+                queued_messages: 2,
+                queued_bytes: 20,
+                sent_messages: 4,
+                sent_bytes: 40,
+                dropped_messages: 6,
+                ..SinkStats::default()
+            }
+        );
+    }
+
     #[test]
     fn test_log_calls_sinks() {
         let ctx = Context::new();
@@ -475,7 +815,78 @@ mod tests {
         let ctx = Context::new();
         let ch = new_test_channel(&ctx, "topic").unwrap();
         assert!(ctx.remove_channel(ch.id()));
-        assert!(ctx.0.read().channels.is_empty());
+        assert!(ctx.inner.read().channels.is_empty());
+    }
+
+    #[test]
+    fn test_bind_channel_to_other_context() {
+        let ctx_a = Context::new();
+        let ctx_b = Context::new();
+        let sink_a = Arc::new(RecordingSink::new());
+        let sink_b = Arc::new(RecordingSink::new());
+        assert!(ctx_a.add_sink(sink_a.clone()));
+        assert!(ctx_b.add_sink(sink_b.clone()));
+
+        let channel = new_test_channel(&ctx_a, "topic").unwrap();
+        channel.bind_context(&ctx_b).unwrap();
+        // Binding again, or to the channel's own context, has no effect.
+        channel.bind_context(&ctx_b).unwrap();
+        channel.bind_context(&ctx_a).unwrap();
+        assert_eq!(
+            ctx_b.get_channel_by_topic("topic").unwrap().id(),
+            channel.id()
+        );
+        assert_eq!(channel.demand().consumers(), 2);
+
+        // One log reaches the sinks of both contexts.
+        channel.log(b"both");
+        assert_eq!(sink_a.take_messages()[0].msg, b"both");
+        let messages = sink_b.take_messages();
+        assert_eq!(messages.len(), 1);
+        assert_eq!(messages[0].channel_id, channel.id());
+
+        // Sinks added to the bound context later are connected too.
+        let sink_c = Arc::new(RecordingSink::new());
+        assert!(ctx_b.add_sink(sink_c.clone()));
+        channel.log(b"later");
+        assert_eq!(sink_b.take_messages().len(), 1);
+        assert_eq!(sink_c.take_messages().len(), 1);
+
+        // Dropping the bound context only unbinds the channel.
+        drop(ctx_b);
+        assert!(channel.has_sinks());
+        channel.log(b"unbound");
+        assert_eq!(sink_a.take_messages().len(), 2);
+        assert!(sink_b.take_messages().is_empty());
+        assert!(sink_c.take_messages().is_empty());
+    }
+
+    #[test]
+    fn test_close_bound_channel() {
+        let ctx_a = Context::new();
+        let ctx_b = Context::new();
+        let sink_b = Arc::new(RecordingSink::new());
+        assert!(ctx_b.add_sink(sink_b.clone()));
+
+        let channel = new_test_channel(&ctx_a, "topic").unwrap();
+        channel.bind_context(&ctx_b).unwrap();
+        assert!(channel.has_sinks());
+
+        // Closing the channel removes it from the bound context.
+        channel.close();
+        assert!(!channel.has_sinks());
+        assert!(ctx_b.get_channel_by_topic("topic").is_none());
+        assert!(channel.bind_context(&ctx_b).is_err());
+
+        // A context can't list two substantially identical channels.
+        let other = new_test_channel(&ctx_a, "other").unwrap();
+        new_test_channel(&ctx_b, "other").unwrap();
+        assert!(other.bind_context(&ctx_b).is_err());
+        assert!(!other.has_sinks());
+        assert_ne!(
+            ctx_b.get_channel_by_topic("other").unwrap().id(),
+            other.id()
+        );
     }
 
     #[test]
@@ -629,6 +1040,56 @@ mod tests {
         assert!(!c2.has_sinks());
     }
 
+    #[test]
+    fn test_create_channels_notifies_sinks_once() {
+        let ctx = Context::new();
+        let batches = Arc::new(parking_lot::Mutex::new(Vec::new()));
+        let sink = Arc::new(RecordingSink::new().auto_subscribe(false).add_channels({
+            let batches = batches.clone();
+            move |channels| {
+                batches.lock().push(channels.len());
+                channels
+                    .iter()
+                    .find(|c| c.topic() == "t1")
+                    .map(|c| vec![c.id()])
+            }
+        }));
+        ctx.add_sink(sink.clone());
+
+        let existing = new_test_channel(&ctx, "t0").unwrap();
+        batches.lock().clear();
+
+        let channels = ctx
+            .create_channels(
+                ["t0", "t1", "t2", "t2"]
+                    .into_iter()
+                    .map(|topic| new_test_channel_builder(&ctx, topic)),
+            )
+            .unwrap();
+        assert_eq!(channels.len(), 4);
+
+        // The existing channel and the duplicate are returned, but not re-advertised.
+        assert!(Arc::ptr_eq(&channels[0], &existing));
+        assert!(Arc::ptr_eq(&channels[2], &channels[3]));
+        assert_eq!(*batches.lock(), vec![2]);
+
+        // Requested subscriptions are connected.
+        assert!(channels[1].has_sinks());
+        assert!(!channels[2].has_sinks());
+
+        // If any builder is invalid, no channels are created.
+        let result = ctx.create_channels([
+            new_test_channel_builder(&ctx, "t3"),
+            ChannelBuilder::new("t4").context(&ctx),
+        ]);
+        assert!(matches!(
+            result,
+            Err(FoxgloveError::MessageEncodingRequired)
+        ));
+        assert!(ctx.get_channel_by_topic("t3").is_none());
+        assert_eq!(*batches.lock(), vec![2]);
+    }
+
     #[test]
     fn test_no_add_channels_cb() {
         let ctx = Context::new();
@@ -704,18 +1165,18 @@ mod tests {
 
         // Actual matches.
         let c1 = new_test_channel(&ctx, "dupe").unwrap();
-        assert_eq!(ctx.0.read().channels.len(), 4);
+        assert_eq!(ctx.inner.read().channels.len(), 4);
 
         // Reuses the matching channel.
         let c2 = new_test_channel(&ctx, "dupe").unwrap();
         assert_eq!(c1.id(), c2.id());
         assert_eq!(Arc::as_ptr(&c1), Arc::as_ptr(&c2));
-        assert_eq!(ctx.0.read().channels.len(), 4);
+        assert_eq!(ctx.inner.read().channels.len(), 4);
 
         // No matches, creates a new channel.
         assert!(ctx.remove_channel(c1.id()));
-        assert_eq!(ctx.0.read().channels.len(), 3);
+        assert_eq!(ctx.inner.read().channels.len(), 3);
         let _ = new_test_channel(&ctx, "dupe").unwrap();
-        assert_eq!(ctx.0.read().channels.len(), 4);
+        assert_eq!(ctx.inner.read().channels.len(), 4);
     }
 }
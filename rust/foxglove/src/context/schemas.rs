@@ -0,0 +1,96 @@
+//! Schema interning.
+
+use std::collections::HashMap;
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::sync::{Arc, Weak};
+
+use smallvec::SmallVec;
+
+use crate::Schema;
+
+/// A set of the schemas used by a context's channels, keyed by content.
+///
+/// Channels which are created with identical schemas share a single copy of the schema, so that
+/// a large descriptor set used by many channels is only held in memory once. Entries are weak, so
+/// a schema is freed once the last channel using it is dropped.
+#[derive(Default)]
+pub(crate) struct SchemaInterner {
+    by_hash: HashMap<u64, SmallVec<[Weak<Schema>; 1]>>,
+}
+
+impl SchemaInterner {
+    /// Returns the shared copy of a schema with the same content, or adds this one.
+    pub fn intern(&mut self, schema: Schema) -> Arc<Schema> {
+        let entries = self.by_hash.entry(content_hash(&schema)).or_default();
+        entries.retain(|entry| entry.strong_count() > 0);
+        if let Some(shared) = entries
+            .iter()
+            .filter_map(Weak::upgrade)
+            .find(|shared| **shared == schema)
+        {
+            return shared;
+        }
+        let shared = Arc::new(schema);
+        entries.push(Arc::downgrade(&shared));
+        shared
+    }
+
+    /// Removes the entry for the schema of a channel which is being removed from the context, if
+    /// no other channel shares it.
+    pub fn release(&mut self, schema: &Arc<Schema>) {
+        if Arc::strong_count(schema) > 1 {
+            return;
+        }
+        let hash = content_hash(schema);
+        if let Some(entries) = self.by_hash.get_mut(&hash) {
+            entries
+                .retain(|entry| entry.strong_count() > 0 && !entry.ptr_eq(&Arc::downgrade(schema)));
+            if entries.is_empty() {
+                self.by_hash.remove(&hash);
+            }
+        }
+    }
+
+    /// Returns the number of distinct schemas.
+    #[cfg(test)]
+    pub fn len(&self) -> usize {
+        self.by_hash
+            .values()
+            .flatten()
+            .filter(|entry| entry.strong_count() > 0)
+            .count()
+    }
+}
+
+fn content_hash(schema: &Schema) -> u64 {
+    let mut hasher = DefaultHasher::new();
+    schema.name.hash(&mut hasher);
+    schema.encoding.hash(&mut hasher);
+    schema.data.hash(&mut hasher);
+    hasher.finish()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_intern_shares_identical_schemas() {
+        let mut interner = SchemaInterner::default();
+        let a = interner.intern(Schema::new("S", "protobuf", vec![1, 2, 3]));
+        let b = interner.intern(Schema::new("S", "protobuf", vec![1, 2, 3]));
+        let c = interner.intern(Schema::new("S", "protobuf", vec![4]));
+        assert!(Arc::ptr_eq(&a, &b));
+        assert!(!Arc::ptr_eq(&a, &c));
+        assert_eq!(interner.len(), 2);
+
+        drop(b);
+        interner.release(&a);
+        assert_eq!(interner.len(), 2);
+        interner.release(&c);
+        drop(c);
+        assert_eq!(interner.len(), 1);
+        drop(a);
+        assert_eq!(interner.len(), 0);
+    }
+}
@@ -35,3 +35,14 @@ pub(crate) fn install_default_crypto_provider() {
         tracing::debug!("rustls crypto provider already installed; using the existing provider");
     }
 }
+
+/// Returns a session ticket issuer from the configured crypto backend, whose keys are rotated
+/// periodically.
+#[cfg(feature = "websocket-tls")]
+pub(crate) fn ticketer()
+-> Result<std::sync::Arc<dyn rustls::server::ProducesTickets>, rustls::Error> {
+    #[cfg(feature = "aws-lc-rs")]
+    return rustls::crypto::aws_lc_rs::Ticketer::new();
+    #[cfg(all(feature = "ring", not(feature = "aws-lc-rs")))]
+    return rustls::crypto::ring::Ticketer::new();
+}
@@ -0,0 +1,94 @@
+//! Demand for the messages of a channel.
+
+/// The demand for the messages of a channel, combined across its sinks.
+///
+/// Producers can use this to scale their work to what is consumed: skip producing messages that
+/// nobody receives, or produce them at no more than the highest rate any consumer receives them.
+/// See [`RawChannel::demand`][crate::RawChannel::demand].
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct ChannelDemand {
+    consumers: usize,
+    max_rate: Option<f64>,
+}
+
+impl ChannelDemand {
+    /// No demand: the channel has no consumers.
+    pub const NONE: Self = Self {
+        consumers: 0,
+        max_rate: Some(0.0),
+    };
+
+    /// Demand from `consumers` consumers, which receive messages at no more than `max_rate`
+    /// messages per second, or every message if `None`.
+    #[doc(hidden)] // Hidden until Sink is public.
+    pub fn new(consumers: usize, max_rate: Option<f64>) -> Self {
+        if consumers == 0 {
+            return Self::NONE;
+        }
+        Self {
+            consumers,
+            max_rate: max_rate.filter(|rate| *rate > 0.0 && rate.is_finite()),
+        }
+    }
+
+    /// Returns true if at least one consumer receives the channel's messages.
+    pub fn is_subscribed(&self) -> bool {
+        self.consumers > 0
+    }
+
+    /// Returns the number of consumers of the channel's messages.
+    ///
+    /// Sinks which fan out to several clients, such as the WebSocket server, count each client
+    /// which is subscribed to the channel.
+    pub fn consumers(&self) -> usize {
+        self.consumers
+    }
+
+    /// Returns the highest rate at which any consumer receives messages, in messages per second.
+    ///
+    /// Returns `None` if some consumer receives every message, such as an MCAP writer, and
+    /// `Some(0.0)` if the channel has no consumers.
+    pub fn max_rate(&self) -> Option<f64> {
+        self.max_rate
+    }
+
+    /// Combines the demand of two sets of consumers.
+    pub(crate) fn combine(self, other: Self) -> Self {
+        if !self.is_subscribed() {
+            return other;
+        }
+        if !other.is_subscribed() {
+            return self;
+        }
+        Self {
+            consumers: self.consumers + other.consumers,
+            max_rate: self.max_rate.zip(other.max_rate).map(|(a, b)| a.max(b)),
+        }
+    }
+}
+
+impl Default for ChannelDemand {
+    fn default() -> Self {
+        Self::NONE
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_combine() {
+        let limited = ChannelDemand::new(2, Some(10.0));
+        let other = ChannelDemand::new(1, Some(30.0));
+        let unlimited = ChannelDemand::new(1, None);
+
+        assert_eq!(ChannelDemand::NONE.combine(limited), limited);
+        assert_eq!(limited.combine(ChannelDemand::NONE), limited);
+        assert_eq!(limited.combine(other), ChannelDemand::new(3, Some(30.0)));
+        assert_eq!(limited.combine(unlimited), ChannelDemand::new(3, None));
+        assert_eq!(ChannelDemand::new(0, None), ChannelDemand::NONE);
+        assert_eq!(ChannelDemand::new(1, Some(0.0)).max_rate(), None);
+        assert!(!ChannelDemand::NONE.is_subscribed());
+    }
+}
@@ -0,0 +1,658 @@
+//! Draco compression of point clouds.
+//!
+//! [`DracoEncoder`] compresses a [`PointCloud`] into a [`CompressedPointCloud`] with the `draco`
+//! format. [`DracoPublisher`] does so on background worker threads, and logs the compressed
+//! point clouds to a channel:
+//!
+//! ```no_run
+//! use foxglove::Channel;
+//! use foxglove::draco::{DracoEncoder, DracoPublisher};
+//! use foxglove::messages::{CompressedPointCloud, PointCloud};
+//!
+//! let channel = Channel::<CompressedPointCloud>::new("/lidar/compressed");
+//! let publisher = DracoPublisher::new(channel)
+//!     .encoder(DracoEncoder::new().quantization_bits(12))
+//!     .worker_threads(2)
+//!     .start();
+//!
+//! # let point_cloud = PointCloud::default();
+//! // Returns immediately; the point cloud is only encoded if a sink subscribes to the channel.
+//! publisher.log(point_cloud);
+//! ```
+//!
+//! The encoder writes a Draco bitstream which any Draco decoder can read. Point positions are
+//! quantized to [`quantization_bits`][DracoEncoder::quantization_bits] bits per coordinate, and
+//! colors are kept as 8-bit values. Values are stored as fixed-width integers, without Draco's
+//! entropy coding, so the compression comes from quantization and from dropping other fields.
+use std::sync::mpsc::{Receiver, SyncSender, TrySendError, sync_channel};
+use std::sync::{Arc, Mutex};
+use std::thread::JoinHandle;
+
+use bytes::{BufMut, Bytes, BytesMut};
+
+use crate::messages::packed_element_field::NumericType;
+use crate::messages::{CompressedPointCloud, PackedElementField, PointCloud};
+use crate::{Channel, FoxgloveError, PartialMetadata, ToUnixNanos};
+
+/// The default number of bits to which each coordinate of a point's position is quantized.
+pub const DEFAULT_QUANTIZATION_BITS: u8 = 14;
+
+// Draco bitstream constants.
+const DRACO_MAGIC: &[u8] = b"DRACO";
+const BITSTREAM_VERSION: [u8; 2] = [2, 2];
+const ENCODER_TYPE_POINT_CLOUD: u8 = 0;
+const ENCODER_METHOD_SEQUENTIAL: u8 = 0;
+const ATTRIBUTE_POSITION: u8 = 0;
+const ATTRIBUTE_COLOR: u8 = 2;
+const DATA_TYPE_UINT8: u8 = 2;
+const DATA_TYPE_FLOAT32: u8 = 9;
+const ATTRIBUTE_ENCODER_GENERIC: u8 = 0;
+const ATTRIBUTE_ENCODER_QUANTIZATION: u8 = 2;
+const PREDICTION_NONE: i8 = -2;
+
+/// Compresses point clouds with Draco.
+#[derive(Debug, Clone, Copy)]
+pub struct DracoEncoder {
+    quantization_bits: u8,
+}
+
+impl Default for DracoEncoder {
+    fn default() -> Self {
+        Self {
+            quantization_bits: DEFAULT_QUANTIZATION_BITS,
+        }
+    }
+}
+
+impl DracoEncoder {
+    /// Creates an encoder with the default options.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Sets the number of bits to which each coordinate of a point's position is quantized,
+    /// between 1 and 30.
+    ///
+    /// Positions are quantized over the bounding box of the point cloud, so the precision is the
+    /// size of the largest side of the box divided by `2^bits`.
+    pub fn quantization_bits(mut self, bits: u8) -> Self {
+        self.quantization_bits = bits.clamp(1, 30);
+        self
+    }
+
+    /// Compresses a point cloud, keeping its timestamp, frame and pose.
+    pub fn compress(
+        &self,
+        point_cloud: &PointCloud,
+    ) -> Result<CompressedPointCloud, FoxgloveError> {
+        Ok(CompressedPointCloud {
+            timestamp: point_cloud.timestamp,
+            frame_id: point_cloud.frame_id.clone(),
+            pose: point_cloud.pose,
+            data: self.encode(point_cloud)?,
+            format: "draco".to_string(),
+        })
+    }
+
+    /// Encodes the points of a point cloud as a Draco bitstream.
+    ///
+    /// The positions are read from the `x`, `y` and `z` fields, at least two of which are
+    /// required, and the colors from the `red`, `green`, `blue` and optional `alpha` fields.
+    /// Points with a non-finite coordinate are dropped, as are all other fields.
+    pub fn encode(&self, point_cloud: &PointCloud) -> Result<Bytes, FoxgloveError> {
+        let reader = PointReader::new(point_cloud)?;
+        let coordinates = [reader.field("x")?, reader.field("y")?, reader.field("z")?];
+        if coordinates.iter().flatten().count() < 2 {
+            return Err(FoxgloveError::ValueError(
+                "point cloud must have at least two of the fields x, y and z".to_string(),
+            ));
+        }
+        let mut color = vec![];
+        for name in ["red", "green", "blue", "alpha"] {
+            match reader.field(name)? {
+                Some(field) => color.push(field),
+                None if name == "alpha" => (),
+                None => {
+                    color.clear();
+                    break;
+                }
+            }
+        }
+
+        let mut positions = Vec::with_capacity(reader.len());
+        let mut colors = Vec::with_capacity(if color.is_empty() { 0 } else { reader.len() });
+        for index in 0..reader.len() {
+            let position = coordinates.map(|field| field.map_or(0.0, |f| reader.value(index, f)));
+            if !position.iter().all(|v| v.is_finite()) {
+                continue;
+            }
+            positions.push(position.map(|v| v as f32));
+            for field in &color {
+                colors.push(color_byte(field, reader.value(index, field)));
+            }
+        }
+
+        let mut buf = BytesMut::new();
+        // Header.
+        buf.put_slice(DRACO_MAGIC);
+        buf.put_slice(&BITSTREAM_VERSION);
+        buf.put_u8(ENCODER_TYPE_POINT_CLOUD);
+        buf.put_u8(ENCODER_METHOD_SEQUENTIAL);
+        buf.put_u16_le(0); // Flags: no metadata.
+        // Geometry: the number of points.
+        let num_points = i32::try_from(positions.len())
+            .map_err(|_| FoxgloveError::ValueError("point cloud has too many points".into()))?;
+        buf.put_i32_le(num_points);
+
+        // A single attributes decoder, with a descriptor and an encoder type for each attribute.
+        buf.put_u8(1);
+        let num_attributes = if color.is_empty() { 1 } else { 2 };
+        put_varint(&mut buf, num_attributes);
+        // Attribute type, data type, number of components, normalized, and unique id.
+        buf.put_slice(&[ATTRIBUTE_POSITION, DATA_TYPE_FLOAT32, 3, 0]);
+        put_varint(&mut buf, 0);
+        if !color.is_empty() {
+            buf.put_slice(&[ATTRIBUTE_COLOR, DATA_TYPE_UINT8, color.len() as u8, 1]);
+            put_varint(&mut buf, 1);
+        }
+        buf.put_u8(ATTRIBUTE_ENCODER_QUANTIZATION);
+        if !color.is_empty() {
+            buf.put_u8(ATTRIBUTE_ENCODER_GENERIC);
+        }
+
+        // Attribute values: the quantized positions, then the raw colors.
+        let quantization = Quantization::new(&positions, self.quantization_bits);
+        buf.put_i8(PREDICTION_NONE);
+        buf.put_u8(0); // Not entropy coded.
+        // Values are stored as zigzag encoded symbols, which take one more bit.
+        let num_bytes = (u32::from(self.quantization_bits) + 1).div_ceil(8) as usize;
+        buf.put_u8(num_bytes as u8);
+        buf.reserve(positions.len() * 3 * num_bytes + colors.len());
+        for position in &positions {
+            for (component, value) in position.iter().enumerate() {
+                let symbol = quantization.quantize(component, *value) << 1;
+                buf.put_uint_le(u64::from(symbol), num_bytes);
+            }
+        }
+        buf.put_slice(&colors);
+
+        // Data needed to transform the attributes back: the quantization parameters.
+        for min in quantization.min {
+            buf.put_f32_le(min);
+        }
+        buf.put_f32_le(quantization.range);
+        buf.put_u8(self.quantization_bits);
+
+        Ok(buf.freeze())
+    }
+}
+
+/// Converts a color component to a byte, scaling floating point values from `[0, 1]`.
+fn color_byte(field: &PackedElementField, value: f64) -> u8 {
+    let value = match field.r#type() {
+        NumericType::Float32 | NumericType::Float64 => value * 255.0,
+        _ => value,
+    };
+    value.round().clamp(0.0, 255.0) as u8
+}
+
+fn put_varint(buf: &mut BytesMut, mut value: u32) {
+    while value >= 0x80 {
+        buf.put_u8((value as u8) | 0x80);
+        value >>= 7;
+    }
+    buf.put_u8(value as u8);
+}
+
+/// Draco's quantization of an attribute: every component is quantized over the same range, from
+/// its own minimum.
+struct Quantization {
+    min: [f32; 3],
+    range: f32,
+    inverse_delta: f32,
+}
+
+impl Quantization {
+    fn new(positions: &[[f32; 3]], bits: u8) -> Self {
+        let mut min = [f32::MAX; 3];
+        let mut max = [f32::MIN; 3];
+        for position in positions {
+            for i in 0..3 {
+                min[i] = min[i].min(position[i]);
+                max[i] = max[i].max(position[i]);
+            }
+        }
+        if positions.is_empty() {
+            (min, max) = ([0.0; 3], [0.0; 3]);
+        }
+        let mut range = (0..3).map(|i| max[i] - min[i]).fold(0.0, f32::max);
+        if range == 0.0 {
+            range = 1.0;
+        }
+        let max_quantized_value = ((1_u32 << bits) - 1) as f32;
+        Self {
+            min,
+            range,
+            inverse_delta: max_quantized_value / range,
+        }
+    }
+
+    fn quantize(&self, component: usize, value: f32) -> u32 {
+        ((value - self.min[component]) * self.inverse_delta + 0.5).floor() as u32
+    }
+}
+
+/// Reads the fields of the points in a point cloud.
+struct PointReader<'a> {
+    point_cloud: &'a PointCloud,
+    stride: usize,
+    len: usize,
+}
+
+impl<'a> PointReader<'a> {
+    fn new(point_cloud: &'a PointCloud) -> Result<Self, FoxgloveError> {
+        let stride = point_cloud.point_stride as usize;
+        if stride == 0 {
+            return Err(FoxgloveError::ValueError(
+                "point cloud has a point stride of 0".to_string(),
+            ));
+        }
+        Ok(Self {
+            point_cloud,
+            stride,
+            len: point_cloud.data.len() / stride,
+        })
+    }
+
+    fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Returns the field with the given name, if the point cloud has it.
+    fn field(&self, name: &str) -> Result<Option<&'a PackedElementField>, FoxgloveError> {
+        let Some(field) = self.point_cloud.fields.iter().find(|f| f.name == name) else {
+            return Ok(None);
+        };
+        let size = numeric_size(field.r#type()).ok_or_else(|| {
+            FoxgloveError::ValueError(format!("field {name} has an unknown numeric type"))
+        })?;
+        if field.offset as usize + size > self.stride {
+            return Err(FoxgloveError::ValueError(format!(
+                "field {name} extends past the point stride"
+            )));
+        }
+        Ok(Some(field))
+    }
+
+    /// Reads a field of the point at `index`.
+    fn value(&self, index: usize, field: &PackedElementField) -> f64 {
+        let start = index * self.stride + field.offset as usize;
+        let data = &self.point_cloud.data[start..];
+        let bytes = |n: usize| -> [u8; 8] {
+            let mut buf = [0; 8];
+            buf[..n].copy_from_slice(&data[..n]);
+            buf
+        };
+        match field.r#type() {
+            NumericType::Uint8 => f64::from(data[0]),
+            NumericType::Int8 => f64::from(data[0] as i8),
+            NumericType::Uint16 => f64::from(u16::from_le_bytes([data[0], data[1]])),
+            NumericType::Int16 => f64::from(i16::from_le_bytes([data[0], data[1]])),
+            NumericType::Uint32 => f64::from(u64::from_le_bytes(bytes(4)) as u32),
+            NumericType::Int32 => f64::from(u64::from_le_bytes(bytes(4)) as u32 as i32),
+            NumericType::Float32 => f64::from(f32::from_bits(u64::from_le_bytes(bytes(4)) as u32)),
+            NumericType::Float64 => f64::from_le_bytes(bytes(8)),
+            NumericType::Unknown => f64::NAN,
+        }
+    }
+}
+
+fn numeric_size(numeric_type: NumericType) -> Option<usize> {
+    match numeric_type {
+        NumericType::Uint8 | NumericType::Int8 => Some(1),
+        NumericType::Uint16 | NumericType::Int16 => Some(2),
+        NumericType::Uint32 | NumericType::Int32 | NumericType::Float32 => Some(4),
+        NumericType::Float64 => Some(8),
+        NumericType::Unknown => None,
+    }
+}
+
+/// Compresses point clouds with Draco on background threads, and logs them to a channel.
+///
+/// Call [`start`][Self::start] to start the worker threads.
+#[must_use]
+#[derive(Debug)]
+pub struct DracoPublisher {
+    channel: Channel<CompressedPointCloud>,
+    encoder: DracoEncoder,
+    worker_threads: usize,
+    queue_size: usize,
+}
+
+impl DracoPublisher {
+    /// Creates a publisher which logs to `channel`, with one worker thread and a queue of two
+    /// point clouds.
+    pub fn new(channel: Channel<CompressedPointCloud>) -> Self {
+        Self {
+            channel,
+            encoder: DracoEncoder::default(),
+            worker_threads: 1,
+            queue_size: 2,
+        }
+    }
+
+    /// Sets the encoder.
+    pub fn encoder(mut self, encoder: DracoEncoder) -> Self {
+        self.encoder = encoder;
+        self
+    }
+
+    /// Sets the number of threads which encode point clouds, at least 1.
+    ///
+    /// With more than one thread, point clouds may be logged out of order, each with the log time
+    /// at which it was passed to the publisher.
+    pub fn worker_threads(mut self, threads: usize) -> Self {
+        self.worker_threads = threads.max(1);
+        self
+    }
+
+    /// Sets the number of point clouds which may wait to be encoded, at least 1.
+    ///
+    /// Point clouds logged while the queue is full are dropped, so that a producer is never
+    /// blocked by slow encoding.
+    pub fn queue_size(mut self, size: usize) -> Self {
+        self.queue_size = size.max(1);
+        self
+    }
+
+    /// Starts the worker threads.
+    pub fn start(self) -> DracoPublisherHandle {
+        let (sender, receiver) = sync_channel(self.queue_size);
+        let receiver = Arc::new(Mutex::new(receiver));
+        let channel = Arc::new(self.channel);
+        let workers = (0..self.worker_threads)
+            .map(|i| {
+                let receiver = receiver.clone();
+                let channel = channel.clone();
+                let encoder = self.encoder;
+                std::thread::Builder::new()
+                    .name(format!("foxglove-draco-{i}"))
+                    .spawn(move || encode_loop(&receiver, &channel, &encoder))
+                    .expect("failed to spawn Draco worker thread")
+            })
+            .collect();
+        DracoPublisherHandle {
+            channel,
+            sender: Some(sender),
+            workers,
+        }
+    }
+}
+
+struct Job {
+    point_cloud: PointCloud,
+    log_time: u64,
+}
+
+fn encode_loop(
+    receiver: &Mutex<Receiver<Job>>,
+    channel: &Channel<CompressedPointCloud>,
+    encoder: &DracoEncoder,
+) {
+    loop {
+        let Ok(job) = receiver.lock().unwrap().recv() else {
+            return;
+        };
+        // Demand may have gone away while the point cloud was queued.
+        if !channel.demand().is_subscribed() {
+            continue;
+        }
+        match encoder.compress(&job.point_cloud) {
+            Ok(compressed) => {
+                channel.log_with_meta(&compressed, PartialMetadata::with_log_time(job.log_time));
+            }
+            Err(e) => {
+                tracing::warn!("Failed to compress point cloud on {}: {e}", channel.topic());
+            }
+        }
+    }
+}
+
+/// A handle to a running [`DracoPublisher`].
+///
+/// Dropping the handle waits for the point clouds which are queued to be logged, and stops the
+/// worker threads.
+#[derive(Debug)]
+pub struct DracoPublisherHandle {
+    channel: Arc<Channel<CompressedPointCloud>>,
+    sender: Option<SyncSender<Job>>,
+    workers: Vec<JoinHandle<()>>,
+}
+
+impl DracoPublisherHandle {
+    /// Queues a point cloud to be compressed and logged, with the current time as its log time.
+    ///
+    /// Returns false if the point cloud was dropped, because no sink subscribes to the channel
+    /// or the queue is full.
+    pub fn log(&self, point_cloud: PointCloud) -> bool {
+        self.log_with_time(point_cloud, self.channel.now())
+    }
+
+    /// Queues a point cloud to be compressed and logged with the given log time.
+    ///
+    /// Returns false if the point cloud was dropped, because no sink subscribes to the channel
+    /// or the queue is full.
+    pub fn log_with_time(&self, point_cloud: PointCloud, log_time: impl ToUnixNanos) -> bool {
+        if !self.channel.demand().is_subscribed() {
+            return false;
+        }
+        let Some(sender) = &self.sender else {
+            return false;
+        };
+        let job = Job {
+            point_cloud,
+            log_time: log_time.to_unix_nanos(),
+        };
+        match sender.try_send(job) {
+            Ok(()) => true,
+            Err(TrySendError::Full(_) | TrySendError::Disconnected(_)) => false,
+        }
+    }
+}
+
+impl Drop for DracoPublisherHandle {
+    fn drop(&mut self) {
+        self.sender.take();
+        for worker in self.workers.drain(..) {
+            let _ = worker.join();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::messages::Timestamp;
+    use crate::testutil::RecordingSink;
+    use crate::{ChannelBuilder, Context, Decode};
+
+    fn field(name: &str, offset: u32, numeric_type: NumericType) -> PackedElementField {
+        PackedElementField {
+            name: name.to_string(),
+            offset,
+            r#type: numeric_type as i32,
+        }
+    }
+
+    /// A point cloud with float positions and byte colors.
+    fn point_cloud(points: &[([f32; 3], [u8; 3])]) -> PointCloud {
+        let mut data = BytesMut::new();
+        for (position, color) in points {
+            for v in position {
+                data.put_f32_le(*v);
+            }
+            data.put_slice(color);
+            data.put_u8(0);
+        }
+        PointCloud {
+            timestamp: Some(Timestamp::new(1, 2)),
+            frame_id: "lidar".to_string(),
+            pose: None,
+            point_stride: 16,
+            fields: vec![
+                field("x", 0, NumericType::Float32),
+                field("y", 4, NumericType::Float32),
+                field("z", 8, NumericType::Float32),
+                field("red", 12, NumericType::Uint8),
+                field("green", 13, NumericType::Uint8),
+                field("blue", 14, NumericType::Uint8),
+            ],
+            data: data.freeze(),
+        }
+    }
+
+    struct Decoded {
+        positions: Vec<[f32; 3]>,
+        colors: Vec<Vec<u8>>,
+    }
+
+    /// Decodes the subset of the Draco bitstream which the encoder writes, following the reference
+    /// decoder.
+    fn decode(data: &[u8]) -> Decoded {
+        let mut buf = data;
+        let mut take = |n: usize| -> &[u8] {
+            let (head, rest) = buf.split_at(n);
+            buf = rest;
+            head
+        };
+        assert_eq!(take(5), DRACO_MAGIC);
+        assert_eq!(take(2), BITSTREAM_VERSION);
+        assert_eq!(
+            take(2),
+            [ENCODER_TYPE_POINT_CLOUD, ENCODER_METHOD_SEQUENTIAL]
+        );
+        assert_eq!(take(2), [0, 0]);
+        let num_points = i32::from_le_bytes(take(4).try_into().unwrap()) as usize;
+        assert_eq!(take(1), [1]);
+        let num_attributes = take(1)[0] as usize;
+        let mut descriptors = vec![];
+        for unique_id in 0..num_attributes {
+            let descriptor: [u8; 4] = take(4).try_into().unwrap();
+            assert_eq!(take(1), [unique_id as u8]);
+            descriptors.push(descriptor);
+        }
+        let encoders = take(num_attributes).to_vec();
+        assert_eq!(encoders[0], ATTRIBUTE_ENCODER_QUANTIZATION);
+        assert_eq!(
+            descriptors[0],
+            [ATTRIBUTE_POSITION, DATA_TYPE_FLOAT32, 3, 0]
+        );
+
+        // Portable attributes.
+        assert_eq!(take(1), [PREDICTION_NONE as u8]);
+        assert_eq!(take(1), [0]);
+        let num_bytes = take(1)[0] as usize;
+        let mut quantized = vec![];
+        for _ in 0..num_points * 3 {
+            let mut value = [0; 4];
+            value[..num_bytes].copy_from_slice(take(num_bytes));
+            let symbol = u32::from_le_bytes(value);
+            assert_eq!(symbol & 1, 0, "quantized values are positive");
+            quantized.push(symbol >> 1);
+        }
+        let mut colors = vec![];
+        if num_attributes == 2 {
+            assert_eq!(encoders[1], ATTRIBUTE_ENCODER_GENERIC);
+            let [att_type, data_type, components, normalized] = descriptors[1];
+            assert_eq!(
+                (att_type, data_type, normalized),
+                (ATTRIBUTE_COLOR, DATA_TYPE_UINT8, 1)
+            );
+            for _ in 0..num_points {
+                colors.push(take(components as usize).to_vec());
+            }
+        }
+
+        // Quantization parameters.
+        let min: Vec<f32> = (0..3)
+            .map(|_| f32::from_le_bytes(take(4).try_into().unwrap()))
+            .collect();
+        let range = f32::from_le_bytes(take(4).try_into().unwrap());
+        let bits = take(1)[0];
+        assert!(buf.is_empty());
+        let delta = range / ((1_u32 << bits) - 1) as f32;
+        let positions = quantized
+            .chunks(3)
+            .map(|q| [0, 1, 2].map(|i| q[i] as f32 * delta + min[i]))
+            .collect();
+        Decoded { positions, colors }
+    }
+
+    #[test]
+    fn test_encode_quantizes_positions_and_keeps_colors() {
+        let points = [
+            ([0.0, 0.0, 0.0], [255, 0, 0]),
+            ([10.0, -5.0, 1.0], [0, 255, 0]),
+            ([f32::NAN, 1.0, 1.0], [0, 0, 0]),
+            ([2.5, 3.25, -1.0], [1, 2, 3]),
+        ];
+        let cloud = point_cloud(&points);
+        let compressed = DracoEncoder::new()
+            .quantization_bits(12)
+            .compress(&cloud)
+            .expect("failed to compress");
+        assert_eq!(compressed.format, "draco");
+        assert_eq!(compressed.frame_id, "lidar");
+        assert_eq!(compressed.timestamp, cloud.timestamp);
+
+        // The point with a NaN coordinate is dropped.
+        let decoded = decode(&compressed.data);
+        let expected: Vec<_> = points.iter().filter(|(p, _)| !p[0].is_nan()).collect();
+        assert_eq!(decoded.positions.len(), expected.len());
+        // The largest side of the bounding box is 15.
+        let tolerance = 15.0 / 4095.0;
+        for (decoded, (position, _)) in decoded.positions.iter().zip(&expected) {
+            for i in 0..3 {
+                assert!((decoded[i] - position[i]).abs() <= tolerance);
+            }
+        }
+        let colors: Vec<Vec<u8>> = expected.iter().map(|(_, c)| c.to_vec()).collect();
+        assert_eq!(decoded.colors, colors);
+    }
+
+    #[test]
+    fn test_encode_requires_two_coordinates() {
+        let mut cloud = point_cloud(&[([1.0, 2.0, 3.0], [0, 0, 0])]);
+        cloud.fields.retain(|f| f.name != "x" && f.name != "y");
+        assert!(DracoEncoder::new().encode(&cloud).is_err());
+
+        // Without colors, only positions are encoded.
+        let mut cloud = point_cloud(&[([1.0, 2.0, 3.0], [0, 0, 0])]);
+        cloud.fields.retain(|f| f.name != "green");
+        let decoded = decode(&DracoEncoder::new().encode(&cloud).unwrap());
+        assert_eq!(decoded.positions, vec![[1.0, 2.0, 3.0]]);
+        assert!(decoded.colors.is_empty());
+    }
+
+    #[test]
+    fn test_publisher_encodes_only_with_subscribers() {
+        let ctx = Context::new();
+        let channel = ChannelBuilder::new("/compressed")
+            .context(&ctx)
+            .build::<CompressedPointCloud>();
+        let publisher = DracoPublisher::new(channel).queue_size(4).start();
+        let cloud = point_cloud(&[([1.0, 2.0, 3.0], [4, 5, 6])]);
+        assert!(!publisher.log(cloud.clone()));
+
+        let sink = Arc::new(RecordingSink::new());
+        assert!(ctx.add_sink(sink.clone()));
+        assert!(publisher.log_with_time(cloud, 42_u64));
+        // Dropping the handle waits for the queued point cloud to be logged.
+        drop(publisher);
+        let messages = sink.take_messages();
+        assert_eq!(messages.len(), 1);
+        assert_eq!(messages[0].metadata.log_time, 42);
+        let compressed = CompressedPointCloud::decode(messages[0].msg.as_slice()).unwrap();
+        assert_eq!(decode(&compressed.data).colors, vec![vec![4, 5, 6]]);
+    }
+}
@@ -0,0 +1,259 @@
+//! Detection and decoding of the image messages which can be transcoded to video.
+
+use super::ImageMessage;
+
+/// An error decoding an image message.
+#[derive(Debug, thiserror::Error)]
+#[error("failed to decode image message: {0}")]
+pub(crate) struct DecodeImageError(String);
+
+/// The input schema type for a video-capable channel.
+///
+/// Each variant identifies which message format decoder to use for extracting image data.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[allow(clippy::enum_variant_names)]
+pub enum VideoInputSchema {
+    /// `foxglove.CompressedImage` with protobuf encoding.
+    FoxgloveCompressedImage,
+    /// `foxglove.RawImage` with protobuf encoding.
+    FoxgloveRawImage,
+    /// `foxglove.CompressedImage` with json encoding.
+    #[cfg(feature = "img2yuv-json")]
+    FoxgloveJsonCompressedImage,
+    /// `foxglove.RawImage` with json encoding.
+    #[cfg(feature = "img2yuv-json")]
+    FoxgloveJsonRawImage,
+    /// `foxglove.CompressedImage` with flatbuffer encoding.
+    #[cfg(feature = "img2yuv-flatbuffer")]
+    FoxgloveFlatbufferCompressedImage,
+    /// `foxglove.RawImage` with flatbuffer encoding.
+    #[cfg(feature = "img2yuv-flatbuffer")]
+    FoxgloveFlatbufferRawImage,
+    /// `foxglove::CompressedImage` (OMG IDL) with cdr encoding.
+    #[cfg(feature = "img2yuv-omgidl")]
+    FoxgloveOmgidlCompressedImage,
+    /// `foxglove::RawImage` (OMG IDL) with cdr encoding.
+    #[cfg(feature = "img2yuv-omgidl")]
+    FoxgloveOmgidlRawImage,
+    /// ROS 1 `sensor_msgs/CompressedImage` with ros1 encoding.
+    #[cfg(feature = "img2yuv-ros1")]
+    Ros1CompressedImage,
+    /// ROS 1 `sensor_msgs/Image` with ros1 encoding.
+    #[cfg(feature = "img2yuv-ros1")]
+    Ros1Image,
+    /// ROS 2 `sensor_msgs/msg/CompressedImage` with cdr encoding.
+    #[cfg(feature = "img2yuv-ros2")]
+    Ros2CompressedImage,
+    /// ROS 2 `sensor_msgs/msg/Image` with cdr encoding.
+    #[cfg(feature = "img2yuv-ros2")]
+    Ros2Image,
+}
+
+/// Detect the video input schema from an (encoding, schema_name) pair.
+///
+/// Returns `Some(InputSchema)` if the channel carries an image type we can transcode to video.
+pub(crate) fn detect_video_schema(encoding: &str, schema_name: &str) -> Option<VideoInputSchema> {
+    match (encoding, schema_name) {
+        ("protobuf", "foxglove.CompressedImage") => Some(VideoInputSchema::FoxgloveCompressedImage),
+        ("protobuf", "foxglove.RawImage") => Some(VideoInputSchema::FoxgloveRawImage),
+        #[cfg(feature = "img2yuv-json")]
+        ("json", "foxglove.CompressedImage") => Some(VideoInputSchema::FoxgloveJsonCompressedImage),
+        #[cfg(feature = "img2yuv-json")]
+        ("json", "foxglove.RawImage") => Some(VideoInputSchema::FoxgloveJsonRawImage),
+        #[cfg(feature = "img2yuv-flatbuffer")]
+        ("flatbuffer", "foxglove.CompressedImage") => {
+            Some(VideoInputSchema::FoxgloveFlatbufferCompressedImage)
+        }
+        #[cfg(feature = "img2yuv-flatbuffer")]
+        ("flatbuffer", "foxglove.RawImage") => Some(VideoInputSchema::FoxgloveFlatbufferRawImage),
+        #[cfg(feature = "img2yuv-omgidl")]
+        ("cdr", "foxglove::CompressedImage") => {
+            Some(VideoInputSchema::FoxgloveOmgidlCompressedImage)
+        }
+        #[cfg(feature = "img2yuv-omgidl")]
+        ("cdr", "foxglove::RawImage") => Some(VideoInputSchema::FoxgloveOmgidlRawImage),
+        #[cfg(feature = "img2yuv-ros1")]
+        ("ros1", "sensor_msgs/CompressedImage") => Some(VideoInputSchema::Ros1CompressedImage),
+        #[cfg(feature = "img2yuv-ros1")]
+        ("ros1", "sensor_msgs/Image") => Some(VideoInputSchema::Ros1Image),
+        #[cfg(feature = "img2yuv-ros2")]
+        ("cdr", "sensor_msgs/msg/CompressedImage") => Some(VideoInputSchema::Ros2CompressedImage),
+        #[cfg(feature = "img2yuv-ros2")]
+        ("cdr", "sensor_msgs/msg/Image") => Some(VideoInputSchema::Ros2Image),
+        _ => None,
+    }
+}
+
+/// Decode raw message bytes into an [`ImageMessage`] based on the input schema.
+pub(crate) fn decode_image_message<'a>(
+    input_schema: VideoInputSchema,
+    data: &'a [u8],
+) -> Result<ImageMessage<'a>, DecodeImageError> {
+    match input_schema {
+        VideoInputSchema::FoxgloveCompressedImage => {
+            let msg = <crate::messages::CompressedImage as crate::Decode>::decode(data)
+                .map_err(|e| DecodeImageError(e.to_string()))?;
+            ImageMessage::try_from(msg).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        VideoInputSchema::FoxgloveRawImage => {
+            let msg = <crate::messages::RawImage as crate::Decode>::decode(data)
+                .map_err(|e| DecodeImageError(e.to_string()))?;
+            ImageMessage::try_from(msg).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-json")]
+        VideoInputSchema::FoxgloveJsonCompressedImage => {
+            super::json::decode_compressed_image(data).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-json")]
+        VideoInputSchema::FoxgloveJsonRawImage => {
+            super::json::decode_raw_image(data).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-flatbuffer")]
+        VideoInputSchema::FoxgloveFlatbufferCompressedImage => {
+            super::flatbuffer::decode_compressed_image(data)
+                .map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-flatbuffer")]
+        VideoInputSchema::FoxgloveFlatbufferRawImage => {
+            super::flatbuffer::decode_raw_image(data).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-omgidl")]
+        VideoInputSchema::FoxgloveOmgidlCompressedImage => {
+            let msg = super::omgidl::OmgidlCompressedImage::decode(data)
+                .map_err(|e| DecodeImageError(e.to_string()))?;
+            ImageMessage::try_from(msg).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-omgidl")]
+        VideoInputSchema::FoxgloveOmgidlRawImage => {
+            let msg = super::omgidl::OmgidlRawImage::decode(data)
+                .map_err(|e| DecodeImageError(e.to_string()))?;
+            ImageMessage::try_from(msg).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-ros1")]
+        VideoInputSchema::Ros1CompressedImage => {
+            let msg = super::ros1::Ros1CompressedImage::decode(data)
+                .map_err(|e| DecodeImageError(e.to_string()))?;
+            ImageMessage::try_from(msg).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-ros1")]
+        VideoInputSchema::Ros1Image => {
+            let msg = super::ros1::Ros1Image::decode(data)
+                .map_err(|e| DecodeImageError(e.to_string()))?;
+            ImageMessage::try_from(msg).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-ros2")]
+        VideoInputSchema::Ros2CompressedImage => {
+            let msg = super::ros2::Ros2CompressedImage::decode(data)
+                .map_err(|e| DecodeImageError(e.to_string()))?;
+            ImageMessage::try_from(msg).map_err(|e| DecodeImageError(e.to_string()))
+        }
+        #[cfg(feature = "img2yuv-ros2")]
+        VideoInputSchema::Ros2Image => {
+            let msg = super::ros2::Ros2Image::decode(data)
+                .map_err(|e| DecodeImageError(e.to_string()))?;
+            ImageMessage::try_from(msg).map_err(|e| DecodeImageError(e.to_string()))
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_foxglove_compressed_image() {
+        assert_eq!(
+            detect_video_schema("protobuf", "foxglove.CompressedImage"),
+            Some(VideoInputSchema::FoxgloveCompressedImage)
+        );
+    }
+
+    #[test]
+    fn test_foxglove_raw_image() {
+        assert_eq!(
+            detect_video_schema("protobuf", "foxglove.RawImage"),
+            Some(VideoInputSchema::FoxgloveRawImage)
+        );
+    }
+
+    #[cfg(feature = "img2yuv-ros1")]
+    #[test]
+    fn test_ros1_compressed_image() {
+        assert_eq!(
+            detect_video_schema("ros1", "sensor_msgs/CompressedImage"),
+            Some(VideoInputSchema::Ros1CompressedImage)
+        );
+    }
+
+    #[cfg(feature = "img2yuv-ros1")]
+    #[test]
+    fn test_ros1_image() {
+        assert_eq!(
+            detect_video_schema("ros1", "sensor_msgs/Image"),
+            Some(VideoInputSchema::Ros1Image)
+        );
+    }
+
+    #[cfg(feature = "img2yuv-ros2")]
+    #[test]
+    fn test_ros2_compressed_image() {
+        assert_eq!(
+            detect_video_schema("cdr", "sensor_msgs/msg/CompressedImage"),
+            Some(VideoInputSchema::Ros2CompressedImage)
+        );
+    }
+
+    #[cfg(feature = "img2yuv-ros2")]
+    #[test]
+    fn test_ros2_image() {
+        assert_eq!(
+            detect_video_schema("cdr", "sensor_msgs/msg/Image"),
+            Some(VideoInputSchema::Ros2Image)
+        );
+    }
+
+    #[cfg(feature = "img2yuv-json")]
+    #[test]
+    fn test_foxglove_json_images() {
+        assert_eq!(
+            detect_video_schema("json", "foxglove.CompressedImage"),
+            Some(VideoInputSchema::FoxgloveJsonCompressedImage)
+        );
+        assert_eq!(
+            detect_video_schema("json", "foxglove.RawImage"),
+            Some(VideoInputSchema::FoxgloveJsonRawImage)
+        );
+    }
+
+    #[cfg(feature = "img2yuv-flatbuffer")]
+    #[test]
+    fn test_foxglove_flatbuffer_images() {
+        assert_eq!(
+            detect_video_schema("flatbuffer", "foxglove.CompressedImage"),
+            Some(VideoInputSchema::FoxgloveFlatbufferCompressedImage)
+        );
+        assert_eq!(
+            detect_video_schema("flatbuffer", "foxglove.RawImage"),
+            Some(VideoInputSchema::FoxgloveFlatbufferRawImage)
+        );
+    }
+
+    #[cfg(feature = "img2yuv-omgidl")]
+    #[test]
+    fn test_foxglove_omgidl_images() {
+        assert_eq!(
+            detect_video_schema("cdr", "foxglove::CompressedImage"),
+            Some(VideoInputSchema::FoxgloveOmgidlCompressedImage)
+        );
+        assert_eq!(
+            detect_video_schema("cdr", "foxglove::RawImage"),
+            Some(VideoInputSchema::FoxgloveOmgidlRawImage)
+        );
+    }
+
+    #[test]
+    fn test_unknown_schema() {
+        assert_eq!(detect_video_schema("json", "SomeCustomType"), None);
+        assert_eq!(detect_video_schema("protobuf", "foxglove.Pose"), None);
+    }
+}
@@ -5,6 +5,7 @@
 mod compressed;
 #[cfg(feature = "img2yuv-flatbuffer")]
 pub mod flatbuffer;
+mod input;
 #[cfg(feature = "img2yuv-json")]
 pub mod json;
 mod message;
@@ -19,6 +20,9 @@ pub mod ros2;
 mod tests;
 
 pub use self::compressed::{CompressedImage, Compression, UnknownCompressionError};
+pub(crate) use self::input::{
+    DecodeImageError, VideoInputSchema, decode_image_message, detect_video_schema,
+};
 pub use self::message::ImageMessage;
 pub use self::raw::{BayerCfa, Endian, RawImage, RawImageEncoding, UnknownEncodingError};
 
@@ -0,0 +1,583 @@
+//! Optional tracing of the latency between logging a message and its delivery by each sink.
+//!
+//! Install a [`LatencyTracer`] to sample one in every N logged messages. For each sampled
+//! message, the sinks record when the message was queued, when it was taken from the queue, and
+//! when it left the socket or was written to the file. The samples are aggregated into
+//! histograms for each sink and channel, which can be read with [`LatencyTracerHandle::stats`],
+//! and the most recent samples can be exported as a Chrome trace with
+//! [`LatencyTracerHandle::chrome_trace`], to be opened in Perfetto or `chrome://tracing`.
+//!
+//! Each sample is split into the following stages:
+//!
+//! - [`LatencyStage::Serialize`]: from the call to log to the message being queued by the sink.
+//!   For a WebSocket client, this covers encoding the message frame.
+//! - [`LatencyStage::Queue`]: time spent waiting in the sink's queue. For a WebSocket client,
+//!   this is the client's backlog. For an MCAP writer, this is the queue of the background writer
+//!   thread, if there is one, or otherwise the time spent waiting for the writer.
+//! - [`LatencyStage::Io`]: from the message being taken from the queue to it being sent. For a
+//!   WebSocket client, this covers compression and the write to the socket. For an MCAP writer,
+//!   this covers writing the message to the current chunk, including the chunk's compression
+//!   once it is full.
+//!
+//! Messages logged with [`RawChannel::log_batch`][crate::RawChannel::log_batch] are not sampled.
+//! Only the WebSocket server and MCAP writer sinks record samples.
+//!
+//! ```no_run
+//! use foxglove::latency::LatencyTracer;
+//!
+//! let tracer = LatencyTracer::new().sample_every(10).install();
+//! // ... log messages ...
+//! for stats in tracer.stats() {
+//!     println!(
+//!         "sink {} channel {} {:?}: p50={:?} p99={:?}",
+//!         stats.sink_id, stats.channel_id, stats.stage, stats.p50, stats.p99
+//!     );
+//! }
+//! std::fs::write("trace.json", tracer.chrome_trace()).unwrap();
+//! ```
+
+use std::cell::Cell;
+use std::collections::{HashMap, VecDeque};
+use std::sync::Arc;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::time::{Duration, Instant};
+
+use parking_lot::{Mutex, RwLock};
+use serde_json::json;
+
+use crate::{ChannelId, SinkId};
+
+/// The default sampling interval of a [`LatencyTracer`].
+pub const DEFAULT_SAMPLE_EVERY: u32 = 100;
+
+/// The default number of samples retained for [`LatencyTracerHandle::chrome_trace`].
+pub const DEFAULT_TRACE_CAPACITY: usize = 10_000;
+
+/// Set while a tracer is installed, so that logging checks a single flag when tracing is off.
+static ENABLED: AtomicBool = AtomicBool::new(false);
+
+/// The installed tracer.
+static TRACER: RwLock<Option<Arc<Tracer>>> = RwLock::new(None);
+
+thread_local! {
+    /// The time at which the message currently being logged on this thread was logged, if it is
+    /// sampled.
+    static SAMPLE: Cell<Option<Instant>> = const { Cell::new(None) };
+}
+
+/// A stage of a message's delivery by a sink.
+///
+/// See the [module documentation][self] for what each stage covers.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum LatencyStage {
+    /// From the call to log to the message being queued by the sink.
+    Serialize,
+    /// Time spent waiting in the sink's queue.
+    Queue,
+    /// From the message being taken from the queue to it being sent or written.
+    Io,
+    /// From the call to log to the message being sent or written.
+    Total,
+}
+
+impl LatencyStage {
+    const ALL: [LatencyStage; 4] = [
+        LatencyStage::Serialize,
+        LatencyStage::Queue,
+        LatencyStage::Io,
+        LatencyStage::Total,
+    ];
+
+    /// Returns the name of the stage, as used in the Chrome trace.
+    pub fn name(self) -> &'static str {
+        match self {
+            LatencyStage::Serialize => "serialize",
+            LatencyStage::Queue => "queue",
+            LatencyStage::Io => "io",
+            LatencyStage::Total => "total",
+        }
+    }
+}
+
+/// Latency percentiles for one stage of the messages logged to a channel and delivered by a sink.
+///
+/// Percentiles are reported with a relative error of less than 1/16.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[non_exhaustive]
+pub struct LatencyStats {
+    /// The sink which delivered the messages.
+    pub sink_id: SinkId,
+    /// The channel the messages were logged to.
+    pub channel_id: ChannelId,
+    /// The stage of delivery.
+    pub stage: LatencyStage,
+    /// The number of sampled messages.
+    pub count: u64,
+    /// The median latency.
+    pub p50: Duration,
+    /// The 99th percentile latency.
+    pub p99: Duration,
+    /// The 99.9th percentile latency.
+    pub p999: Duration,
+    /// The largest latency.
+    pub max: Duration,
+}
+
+/// Builder for a latency tracer.
+///
+/// See the [module documentation][self] for details.
+#[derive(Debug, Clone)]
+#[must_use]
+pub struct LatencyTracer {
+    sample_every: u32,
+    trace_capacity: usize,
+}
+
+impl Default for LatencyTracer {
+    fn default() -> Self {
+        Self {
+            sample_every: DEFAULT_SAMPLE_EVERY,
+            trace_capacity: DEFAULT_TRACE_CAPACITY,
+        }
+    }
+}
+
+impl LatencyTracer {
+    /// Creates a builder with the default options.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Samples one in every `n` logged messages. Defaults to [`DEFAULT_SAMPLE_EVERY`].
+    ///
+    /// A value of 0 or 1 samples every message.
+    pub fn sample_every(mut self, n: u32) -> Self {
+        self.sample_every = n.max(1);
+        self
+    }
+
+    /// Sets the number of the most recent samples retained for the Chrome trace. Defaults to
+    /// [`DEFAULT_TRACE_CAPACITY`].
+    ///
+    /// Histograms include every sample, regardless of this limit.
+    pub fn trace_capacity(mut self, capacity: usize) -> Self {
+        self.trace_capacity = capacity;
+        self
+    }
+
+    /// Installs the tracer for the whole process, replacing any tracer which is already
+    /// installed.
+    ///
+    /// The tracer is uninstalled when the returned handle is dropped.
+    pub fn install(self) -> LatencyTracerHandle {
+        let tracer = Arc::new(Tracer {
+            sample_every: u64::from(self.sample_every),
+            trace_capacity: self.trace_capacity,
+            logged: AtomicU64::new(0),
+            epoch: Instant::now(),
+            state: Mutex::default(),
+        });
+        *TRACER.write() = Some(tracer.clone());
+        ENABLED.store(true, Ordering::Release);
+        LatencyTracerHandle(tracer)
+    }
+}
+
+/// A handle to an installed [`LatencyTracer`].
+///
+/// Dropping the handle uninstalls the tracer, unless it has already been replaced by another one.
+#[derive(Debug)]
+pub struct LatencyTracerHandle(Arc<Tracer>);
+
+impl LatencyTracerHandle {
+    /// Returns latency percentiles for each sink, channel and stage, ordered by sink and channel.
+    pub fn stats(&self) -> Vec<LatencyStats> {
+        self.0.stats()
+    }
+
+    /// Returns the most recent samples in the Chrome trace event format, as JSON.
+    ///
+    /// Each sink is shown as a thread, and each stage of a sample as a slice on it. The trace can
+    /// be opened in [Perfetto](https://ui.perfetto.dev) or `chrome://tracing`.
+    pub fn chrome_trace(&self) -> String {
+        self.0.chrome_trace()
+    }
+
+    /// Discards the samples recorded so far.
+    pub fn clear(&self) {
+        *self.0.state.lock() = TracerState::default();
+    }
+}
+
+impl Drop for LatencyTracerHandle {
+    fn drop(&mut self) {
+        let mut installed = TRACER.write();
+        if installed
+            .as_ref()
+            .is_some_and(|tracer| Arc::ptr_eq(tracer, &self.0))
+        {
+            *installed = None;
+            ENABLED.store(false, Ordering::Release);
+        }
+    }
+}
+
+/// Returns the installed tracer, if any.
+fn installed() -> Option<Arc<Tracer>> {
+    if !ENABLED.load(Ordering::Relaxed) {
+        return None;
+    }
+    TRACER.read().clone()
+}
+
+/// Marks the message being logged on the current thread as sampled, if the installed tracer
+/// samples it.
+///
+/// The mark is removed when the returned guard is dropped, so the guard must be held while the
+/// message is passed to the sinks.
+pub(crate) fn sample() -> Option<SampleGuard> {
+    if !ENABLED.load(Ordering::Relaxed) {
+        return None;
+    }
+    let tracer = TRACER.read().clone()?;
+    if tracer.logged.fetch_add(1, Ordering::Relaxed) % tracer.sample_every != 0 {
+        return None;
+    }
+    let previous = SAMPLE.replace(Some(Instant::now()));
+    Some(SampleGuard { previous })
+}
+
+/// Removes the sample mark when dropped. See [`sample`].
+pub(crate) struct SampleGuard {
+    previous: Option<Instant>,
+}
+
+impl Drop for SampleGuard {
+    fn drop(&mut self) {
+        SAMPLE.set(self.previous);
+    }
+}
+
+/// Starts tracing the delivery of the message being logged on the current thread, if it is
+/// sampled. Sinks call this when they queue the message.
+pub(crate) fn enqueue() -> Option<Trace> {
+    let logged = SAMPLE.get()?;
+    Some(Trace {
+        logged,
+        enqueued: Instant::now(),
+        dequeued: None,
+    })
+}
+
+/// The timestamps of a sampled message, which travels with the message through a sink's queue.
+#[derive(Debug, Clone, Copy)]
+pub(crate) struct Trace {
+    logged: Instant,
+    enqueued: Instant,
+    dequeued: Option<Instant>,
+}
+
+impl Trace {
+    /// Records that the message was taken from the sink's queue.
+    pub fn dequeue(&mut self) {
+        self.dequeued = Some(Instant::now());
+    }
+
+    /// Records that the message was sent, and adds the sample to the installed tracer.
+    pub fn finish(self, sink_id: SinkId, channel_id: ChannelId) {
+        let sent = Instant::now();
+        if let Some(tracer) = installed() {
+            tracer.record(Span {
+                sink_id,
+                channel_id,
+                logged: self.logged,
+                enqueued: self.enqueued,
+                dequeued: self.dequeued.unwrap_or(self.enqueued),
+                sent,
+            });
+        }
+    }
+}
+
+/// The timestamps of a sampled message's delivery by a sink.
+#[derive(Debug, Clone, Copy)]
+struct Span {
+    sink_id: SinkId,
+    channel_id: ChannelId,
+    logged: Instant,
+    enqueued: Instant,
+    dequeued: Instant,
+    sent: Instant,
+}
+
+impl Span {
+    /// Returns the start and end of a stage.
+    fn stage(&self, stage: LatencyStage) -> (Instant, Instant) {
+        match stage {
+            LatencyStage::Serialize => (self.logged, self.enqueued),
+            LatencyStage::Queue => (self.enqueued, self.dequeued),
+            LatencyStage::Io => (self.dequeued, self.sent),
+            LatencyStage::Total => (self.logged, self.sent),
+        }
+    }
+}
+
+#[derive(Debug)]
+struct Tracer {
+    sample_every: u64,
+    trace_capacity: usize,
+    /// The number of messages logged while the tracer was installed.
+    logged: AtomicU64,
+    /// The origin of timestamps in the Chrome trace.
+    epoch: Instant,
+    state: Mutex<TracerState>,
+}
+
+#[derive(Debug, Default)]
+struct TracerState {
+    histograms: HashMap<(SinkId, ChannelId), [Histogram; 4]>,
+    spans: VecDeque<Span>,
+}
+
+impl Tracer {
+    fn record(&self, span: Span) {
+        let mut state = self.state.lock();
+        let histograms = state
+            .histograms
+            .entry((span.sink_id, span.channel_id))
+            .or_default();
+        for (histogram, stage) in histograms.iter_mut().zip(LatencyStage::ALL) {
+            let (start, end) = span.stage(stage);
+            histogram.record(end.saturating_duration_since(start));
+        }
+        if self.trace_capacity > 0 {
+            if state.spans.len() == self.trace_capacity {
+                state.spans.pop_front();
+            }
+            state.spans.push_back(span);
+        }
+    }
+
+    fn stats(&self) -> Vec<LatencyStats> {
+        let state = self.state.lock();
+        let mut keys: Vec<_> = state.histograms.keys().copied().collect();
+        keys.sort_by_key(|(sink_id, channel_id)| (*sink_id, u64::from(*channel_id)));
+        keys.into_iter()
+            .flat_map(|key| {
+                let (sink_id, channel_id) = key;
+                state.histograms[&key]
+                    .iter()
+                    .zip(LatencyStage::ALL)
+                    .map(move |(histogram, stage)| LatencyStats {
+                        sink_id,
+                        channel_id,
+                        stage,
+                        count: histogram.count,
+                        p50: histogram.percentile(0.5),
+                        p99: histogram.percentile(0.99),
+                        p999: histogram.percentile(0.999),
+                        max: Duration::from_nanos(histogram.max),
+                    })
+                    .collect::<Vec<_>>()
+            })
+            .collect()
+    }
+
+    fn chrome_trace(&self) -> String {
+        let state = self.state.lock();
+        let micros = |instant: Instant| {
+            instant.saturating_duration_since(self.epoch).as_nanos() as f64 / 1000.0
+        };
+        let mut sinks: Vec<_> = state.spans.iter().map(|span| span.sink_id).collect();
+        sinks.sort();
+        sinks.dedup();
+        let mut events: Vec<_> = sinks
+            .into_iter()
+            .map(|sink_id| {
+                json!({
+                    "name": "thread_name",
+                    "ph": "M",
+                    "pid": 1,
+                    "tid": u64::from(sink_id),
+                    "args": { "name": format!("sink {sink_id}") },
+                })
+            })
+            .collect();
+        for span in &state.spans {
+            for stage in [
+                LatencyStage::Serialize,
+                LatencyStage::Queue,
+                LatencyStage::Io,
+            ] {
+                let (start, end) = span.stage(stage);
+                events.push(json!({
+                    "name": stage.name(),
+                    "cat": "foxglove",
+                    "ph": "X",
+                    "ts": micros(start),
+                    "dur": micros(end) - micros(start),
+                    "pid": 1,
+                    "tid": u64::from(span.sink_id),
+                    "args": { "channel_id": u64::from(span.channel_id) },
+                }));
+            }
+        }
+        json!({ "traceEvents": events, "displayTimeUnit": "ns" }).to_string()
+    }
+}
+
+/// The number of linear buckets each power of two is divided into.
+const SUB_BUCKET_BITS: u32 = 4;
+const SUB_BUCKETS: u64 = 1 << SUB_BUCKET_BITS;
+/// Enough buckets for any `u64`.
+const BUCKETS: usize = ((64 - SUB_BUCKET_BITS + 1) as usize) * SUB_BUCKETS as usize;
+
+/// A log-linear histogram of durations, in nanoseconds.
+///
+/// Values are grouped by their highest set bit, and each power of two is divided into
+/// [`SUB_BUCKETS`] linear buckets.
+#[derive(Debug)]
+struct Histogram {
+    buckets: Box<[u64]>,
+    count: u64,
+    max: u64,
+}
+
+impl Default for Histogram {
+    fn default() -> Self {
+        Self {
+            buckets: vec![0; BUCKETS].into_boxed_slice(),
+            count: 0,
+            max: 0,
+        }
+    }
+}
+
+impl Histogram {
+    fn record(&mut self, value: Duration) {
+        let nanos = u64::try_from(value.as_nanos()).unwrap_or(u64::MAX);
+        self.buckets[bucket_index(nanos)] += 1;
+        self.count += 1;
+        self.max = self.max.max(nanos);
+    }
+
+    /// Returns the upper bound of the bucket containing the given quantile, or zero if the
+    /// histogram is empty.
+    fn percentile(&self, quantile: f64) -> Duration {
+        if self.count == 0 {
+            return Duration::ZERO;
+        }
+        let rank = ((quantile * self.count as f64).ceil() as u64).clamp(1, self.count);
+        let mut seen = 0;
+        for (index, count) in self.buckets.iter().enumerate() {
+            seen += count;
+            if seen >= rank {
+                return Duration::from_nanos(bucket_upper_bound(index).min(self.max));
+            }
+        }
+        Duration::from_nanos(self.max)
+    }
+}
+
+fn bucket_index(value: u64) -> usize {
+    if value < SUB_BUCKETS {
+        return value as usize;
+    }
+    let shift = 63 - value.leading_zeros() - SUB_BUCKET_BITS;
+    let sub_bucket = (value >> shift) & (SUB_BUCKETS - 1);
+    ((u64::from(shift) + 1) * SUB_BUCKETS + sub_bucket) as usize
+}
+
+fn bucket_upper_bound(index: usize) -> u64 {
+    let index = index as u64;
+    if index < SUB_BUCKETS {
+        return index;
+    }
+    let shift = index / SUB_BUCKETS - 1;
+    let lower = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    lower.saturating_add((1 << shift) - 1)
+}
+
+#[cfg(test)]
+mod tests {
+    use std::io::Cursor;
+
+    use super::*;
+    use crate::{ChannelBuilder, Context, McapWriter, PartialMetadata};
+
+    #[test]
+    fn test_bucket_bounds() {
+        for value in [0, 1, 15, 16, 17, 31, 32, 1000, 123_456_789, u64::MAX] {
+            let index = bucket_index(value);
+            assert!(index < BUCKETS);
+            let upper = bucket_upper_bound(index);
+            assert!(value <= upper, "{value} > {upper}");
+            // The bucket is at most 1/16th of its lower bound wide.
+            assert!(upper - value <= value / SUB_BUCKETS, "{value} in {upper}");
+        }
+    }
+
+    #[test]
+    fn test_histogram_percentiles() {
+        let mut histogram = Histogram::default();
+        assert_eq!(histogram.percentile(0.5), Duration::ZERO);
+        for micros in 1..=1000 {
+            histogram.record(Duration::from_micros(micros));
+        }
+        let p50 = histogram.percentile(0.5).as_micros();
+        assert!((500..=532).contains(&p50), "{p50}");
+        let p99 = histogram.percentile(0.99).as_micros();
+        assert!((990..=1000).contains(&p99), "{p99}");
+        assert_eq!(histogram.percentile(0.999), Duration::from_micros(1000));
+        assert_eq!(histogram.max, 1_000_000);
+    }
+
+    #[test]
+    fn test_tracer_records_sampled_messages() {
+        let ctx = Context::new();
+        let channel = ChannelBuilder::new("/topic")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .unwrap();
+        let writer = McapWriter::new()
+            .context(&ctx)
+            .create(Cursor::new(Vec::new()))
+            .unwrap();
+        let tracer = LatencyTracer::new()
+            .sample_every(1)
+            .trace_capacity(1)
+            .install();
+
+        for _ in 0..3 {
+            channel.log(b"{}");
+        }
+        // Messages logged in a batch are not sampled.
+        channel.log_batch(&[(&b"{}"[..], PartialMetadata::default())]);
+        // Traces outside of a log call are not recorded.
+        assert!(enqueue().is_none());
+
+        let stats: Vec<_> = tracer
+            .stats()
+            .into_iter()
+            .filter(|stats| stats.channel_id == channel.id())
+            .collect();
+        let stages: Vec<_> = stats.iter().map(|stats| stats.stage).collect();
+        assert_eq!(stages, LatencyStage::ALL);
+        assert!(stats.iter().all(|stats| stats.count == 3));
+        assert!(stats[3].max >= stats[2].max);
+
+        let trace: serde_json::Value = serde_json::from_str(&tracer.chrome_trace()).unwrap();
+        let events = trace["traceEvents"].as_array().unwrap();
+        // One thread name, and the three stages of the one retained sample.
+        assert_eq!(events.len(), 4);
+        assert_eq!(events[0]["ph"], "M");
+        assert_eq!(events[1]["name"], "serialize");
+        assert_eq!(events[3]["name"], "io");
+
+        drop(tracer);
+        assert!(installed().is_none());
+        assert!(sample().is_none());
+        writer.close().unwrap();
+    }
+}
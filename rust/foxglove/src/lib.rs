@@ -211,6 +211,22 @@
 //! A sink is typically associated with exactly one [`Context`] throughout its lifecycle. Details
 //! about the how the sink is registered and unregistered from the context are sink-specific.
 //!
+//! Messages are delivered to sinks on the thread which logs them. Each sink has its own queue and
+//! limits, and most sinks drop messages rather than wait when they fall behind. Only lossless
+//! sinks block the logging thread:
+//!
+//! - An [`McapWriter`] is lossless, unless it uses [`async_writes`][McapWriter::async_writes]
+//!   with an overflow policy which drops messages. A synchronous writer blocks while it writes,
+//!   and an asynchronous writer with [`McapOverflowPolicy::Block`] blocks while its queue is full.
+//! - WebSocket clients, the remote access gateway, the ring buffer sink and the shared-memory sink
+//!   are lossy. They drop messages according to their own backlog or buffer limits.
+//!
+//! A channel logs each message to its lossy sinks first, so a stalled lossless sink, such as an
+//! MCAP writer on a slow disk, does not delay delivery of that message to the others. This only
+//! orders delivery, and does not isolate the sinks from each other: the stalled sink still
+//! delays the logging thread, and so the next message to every sink. To keep the logging thread
+//! from waiting on the disk, write MCAP files asynchronously with a dropping overflow policy.
+//!
 //! ### MCAP file
 //!
 //! Use [`McapWriter::new()`] to register a new MCAP writer. As long as the handle remains in scope,
@@ -356,6 +372,8 @@
 //!   version.
 //! - `websocket`: enables the WebSocket server and client for live visualization. Enabled by
 //!   default.
+//! - `websocket-video`: enables transcoding image channels to video for WebSocket clients. See
+//!   [`WebSocketServer::video_transcode`].
 //! - `zstd`: enables support for the zstd compression algorithm for mcap files. Enabled by
 //!   default.
 //!
@@ -407,21 +425,30 @@ use thiserror::Error;
 mod app_url;
 mod channel;
 mod channel_builder;
+mod clock;
 mod context;
 pub mod convert;
 mod decode;
+mod demand;
+pub mod draco;
 mod encode;
+pub mod latency;
 pub mod library_version;
 #[doc(hidden)]
 pub mod log_macro;
 mod log_sink_set;
+mod mapped_file;
+mod mcap_reader;
 mod mcap_writer;
+mod memory_budget;
+mod message_filter;
 pub mod messages;
 mod messages_wkt;
 mod metadata;
 #[doc(hidden)]
 #[cfg(feature = "derive")]
 pub mod protobuf;
+mod ring_buffer_sink;
 mod schema;
 
 /// Deprecated: Use [`messages`] instead.
@@ -457,17 +484,31 @@ pub use app_url::AppUrl;
 pub use bytes;
 pub use channel::{Channel, ChannelDescriptor, ChannelId, LazyChannel, LazyRawChannel, RawChannel};
 pub use channel_builder::ChannelBuilder;
+pub use clock::{Clock, MonotonicClock, SimClock, SystemClock};
 pub use context::{Context, LazyContext};
 #[doc(hidden)]
 pub use decode::Decode;
+pub use demand::ChannelDemand;
 pub use encode::Encode;
+pub use mcap_reader::{
+    McapChannel, McapChunkCommit, McapLiveReader, McapMergedMessages, McapMessage, McapMessages,
+    McapReadOptions, McapReadOrder, McapReader, McapSchema,
+};
 pub use mcap_writer::{
-    McapAttachment, McapCompression, McapWriteOptions, McapWriter, McapWriterHandle,
+    MCAP_ZSTD_DICTIONARY_MEDIA_TYPE, McapAdaptiveChunks, McapAsyncOptions, McapAttachment,
+    McapAttachmentHeader, McapChannelGrouping, McapChunkCompression, McapCompression,
+    McapCompressionPolicy, McapOverflowPolicy, McapRotation, McapSparseIndex, McapWriteOptions,
+    McapWriter, McapWriterHandle, McapWriterStats, McapZstdDictionary, recover_mcap,
 };
+#[cfg(target_os = "linux")]
+pub use mcap_writer::{McapDirectFile, McapPreallocatedFile};
+pub use memory_budget::{MemoryBudget, MemoryPool, MemoryPoolUsage, MemoryUsage};
+pub use message_filter::{FilterAction, MessageFilter, RateLimitFilter};
 pub use metadata::{Metadata, PartialMetadata, ToUnixNanos};
+pub use ring_buffer_sink::{RingBufferSink, RingBufferSinkHandle, RingBufferSnapshot};
 pub use schema::Schema;
-pub use sink::{Sink, SinkId};
-pub use sink_channel_filter::SinkChannelFilter;
+pub use sink::{Sink, SinkId, SinkStats};
+pub use sink_channel_filter::{SinkChannelFilter, TopicFilter, TopicFilterBuilder};
 pub use std::collections::BTreeMap;
 pub(crate) use time::nanoseconds_since_epoch;
 
@@ -493,7 +534,7 @@ mod runtime;
     docsrs,
     doc(cfg(any(feature = "remote-access", feature = "websocket", feature = "sysinfo")))
 )]
-pub use runtime::shutdown_runtime;
+pub use runtime::{RuntimeOptions, set_runtime_options, shutdown_runtime};
 
 #[cfg(any(feature = "websocket-tls", feature = "remote-access"))]
 mod crypto;
@@ -503,6 +544,12 @@ mod api_client;
 #[cfg(feature = "remote-access")]
 pub mod remote_access;
 
+#[cfg(any(feature = "_remote-common", feature = "sysinfo"))]
+#[cfg_attr(
+    docsrs,
+    doc(cfg(any(feature = "remote-access", feature = "websocket", feature = "sysinfo")))
+)]
+pub mod sdk_stats;
 #[cfg(feature = "sysinfo")]
 pub mod system_info;
 
@@ -516,6 +563,13 @@ pub use websocket::ws_protocol;
 #[cfg(feature = "websocket")]
 pub use websocket_server::{WebSocketServer, WebSocketServerHandle};
 
+#[cfg(all(unix, feature = "websocket"))]
+mod shm_sink;
+#[cfg(all(unix, feature = "websocket"))]
+pub use shm_sink::{
+    SharedMemoryReader, SharedMemoryRecord, SharedMemorySink, SharedMemorySinkHandle,
+};
+
 #[doc(hidden)]
 #[cfg(feature = "derive")]
 pub use foxglove_derive::Encode;
@@ -1,9 +1,15 @@
+use std::cell::RefCell;
+use std::collections::HashMap;
 use std::sync::Arc;
 
 use arc_swap::ArcSwap;
+use bytes::Bytes;
 
 use crate::sink::SmallSinkVec;
-use crate::{FoxgloveError, Sink};
+use crate::{
+    ChannelDemand, ChannelDescriptor, FilterAction, FoxgloveError, MessageFilter, Metadata,
+    RawChannel, Sink,
+};
 
 pub(crate) const ERROR_LOGGING_MESSAGE: &str = "error logging message";
 
@@ -26,17 +32,50 @@ impl LogSinkSet {
         self.0.load().len()
     }
 
+    /// Returns the combined demand of the sinks in the set for the channel's messages.
+    pub fn demand(&self, channel: &RawChannel) -> ChannelDemand {
+        self.0
+            .load()
+            .iter()
+            .map(|sink| sink.demand(channel))
+            .fold(ChannelDemand::NONE, ChannelDemand::combine)
+    }
+
     /// Replaces the set of sinks in the set.
-    pub fn store(&self, sinks: SmallSinkVec) {
+    ///
+    /// Lossy sinks are ordered before lossless ones, which may block, so that each message reaches
+    /// the lossy sinks without waiting on the others. This only orders delivery; a blocked sink
+    /// still blocks the caller for later messages.
+    pub fn store(&self, mut sinks: SmallSinkVec) {
+        sinks.sort_by_key(|sink| sink.is_lossless());
         self.0.store(Arc::new(sinks));
     }
 
+    /// Replaces the set of sinks in the set, then calls the given function on each sink that was
+    /// not in the previous set, logging any errors via tracing::warn!().
+    pub fn store_and_for_each_added<F>(&self, sinks: SmallSinkVec, mut f: F)
+    where
+        F: FnMut(&Arc<dyn Sink>) -> Result<(), FoxgloveError>,
+    {
+        let previous = self.0.load_full();
+        self.store(sinks);
+        let _dispatch = Dispatch::enter();
+        for sink in self.0.load().iter() {
+            if !previous.iter().any(|p| p.id() == sink.id())
+                && let Err(err) = f(sink)
+            {
+                tracing::warn!("{ERROR_LOGGING_MESSAGE}: {:?}", err);
+            }
+        }
+    }
+
     /// Iterate over all the sinks in the set, calling the given function on each,
     /// logging any errors via tracing::warn!().
     pub fn for_each<F>(&self, mut f: F)
     where
         F: FnMut(&Arc<dyn Sink>) -> Result<(), FoxgloveError>,
     {
+        let _dispatch = Dispatch::enter();
         for sink in self.0.load().iter() {
             if let Err(err) = f(sink) {
                 tracing::warn!("{ERROR_LOGGING_MESSAGE}: {:?}", err);
@@ -46,11 +85,14 @@ impl LogSinkSet {
 
     /// Iterate over sinks that match the predicate, calling the given function on each,
     /// logging any errors via tracing::warn!().
+    ///
+    /// The predicate is called on each sink after the set is loaded.
     pub fn for_each_filtered<F, P>(&self, predicate: P, mut f: F)
     where
         F: FnMut(&Arc<dyn Sink>) -> Result<(), FoxgloveError>,
         P: Fn(&Arc<dyn Sink>) -> bool,
     {
+        let _dispatch = Dispatch::enter();
         for sink in self.0.load().iter() {
             if predicate(sink)
                 && let Err(err) = f(sink)
@@ -65,3 +107,196 @@ impl LogSinkSet {
         self.0.store(Arc::default());
     }
 }
+
+thread_local! {
+    static DISPATCH: RefCell<DispatchState> = RefCell::default();
+}
+
+/// The state of the dispatches of messages to sinks on this thread.
+#[derive(Default)]
+struct DispatchState {
+    /// The id of the innermost dispatch, or zero outside of a dispatch.
+    current: u64,
+    /// The number of dispatches started on this thread, used to assign ids.
+    started: u64,
+    /// Encodings of the messages being dispatched, shared between sinks.
+    encodings: HashMap<EncodingKey, Bytes>,
+    /// Results of message filters for the messages being dispatched, shared between sinks.
+    filter_actions: HashMap<EncodingKey, FilterAction>,
+}
+
+#[derive(Clone, Copy, PartialEq, Eq, Hash)]
+struct EncodingKey {
+    dispatch: u64,
+    kind: &'static str,
+    id: u64,
+    log_time: u64,
+    data: usize,
+    len: usize,
+}
+
+/// A dispatch of messages to the sinks in a set.
+///
+/// Dispatches nest when a sink logs messages while handling a message.
+struct Dispatch {
+    parent: u64,
+}
+
+impl Dispatch {
+    fn enter() -> Self {
+        DISPATCH.with_borrow_mut(|state| {
+            state.started += 1;
+            let parent = std::mem::replace(&mut state.current, state.started);
+            Self { parent }
+        })
+    }
+}
+
+impl Drop for Dispatch {
+    fn drop(&mut self) {
+        DISPATCH.with_borrow_mut(|state| {
+            state.current = self.parent;
+            if self.parent == 0 {
+                state.encodings.clear();
+                state.filter_actions.clear();
+            }
+        });
+    }
+}
+
+/// Returns an encoding of a message which is being logged to a set of sinks.
+///
+/// Several sinks of the same kind, such as the clients of a WebSocket server, may encode each
+/// message identically. This encodes the message once per dispatch for each `kind` and `id`, and
+/// shares the buffer between the sinks, rather than encoding it once per sink. Outside of a
+/// dispatch, the message is encoded on every call.
+///
+/// The message data is borrowed for the whole dispatch, so within a dispatch it is identified by
+/// its address and length. Encodings are released when the outermost dispatch on the thread ends.
+#[cfg_attr(not(feature = "websocket"), allow(dead_code))]
+pub(crate) fn shared_encoding(
+    kind: &'static str,
+    id: u64,
+    msg: &[u8],
+    log_time: u64,
+    encode: impl FnOnce() -> Bytes,
+) -> Bytes {
+    let dispatch = DISPATCH.with_borrow(|state| state.current);
+    if dispatch == 0 {
+        return encode();
+    }
+    let key = EncodingKey {
+        dispatch,
+        kind,
+        id,
+        log_time,
+        data: msg.as_ptr() as usize,
+        len: msg.len(),
+    };
+    if let Some(encoded) = DISPATCH.with_borrow(|state| state.encodings.get(&key).cloned()) {
+        return encoded;
+    }
+    // Encode without borrowing the state, in case encoding logs a message.
+    let encoded = encode();
+    DISPATCH.with_borrow_mut(|state| state.encodings.insert(key, encoded.clone()));
+    encoded
+}
+
+/// Returns the result of a message filter for a message which is being logged to a set of sinks.
+///
+/// The filter runs once per dispatch for each message, and its result is shared between the sinks
+/// which use it, in the same way as [`shared_encoding`]. Outside of a dispatch, the filter runs on
+/// every call.
+pub(crate) fn shared_filter_action(
+    filter: &Arc<dyn MessageFilter>,
+    channel: &ChannelDescriptor,
+    msg: &[u8],
+    metadata: &Metadata,
+) -> FilterAction {
+    let dispatch = DISPATCH.with_borrow(|state| state.current);
+    if dispatch == 0 {
+        return filter.filter(channel, msg, metadata);
+    }
+    let key = EncodingKey {
+        dispatch,
+        kind: "filter",
+        id: Arc::as_ptr(filter).cast::<()>() as usize as u64,
+        log_time: metadata.log_time,
+        data: msg.as_ptr() as usize,
+        len: msg.len(),
+    };
+    if let Some(action) = DISPATCH.with_borrow(|state| state.filter_actions.get(&key).cloned()) {
+        return action;
+    }
+    // Filter without borrowing the state, in case the filter logs a message.
+    let action = filter.filter(channel, msg, metadata);
+    DISPATCH.with_borrow_mut(|state| state.filter_actions.insert(key, action.clone()));
+    action
+}
+
+#[cfg(test)]
+mod tests {
+    use std::cell::Cell;
+
+    use super::*;
+    use crate::testutil::RecordingSink;
+
+    fn encode_counted(count: &Cell<usize>, msg: &[u8]) -> Bytes {
+        count.set(count.get() + 1);
+        Bytes::copy_from_slice(msg)
+    }
+
+    #[test]
+    fn test_shared_encoding_within_dispatch() {
+        let count = Cell::new(0);
+        let msg = b"message";
+        {
+            let _dispatch = Dispatch::enter();
+            let first = shared_encoding("test", 1, msg, 10, || encode_counted(&count, msg));
+            let second = shared_encoding("test", 1, msg, 10, || encode_counted(&count, msg));
+            assert_eq!(count.get(), 1);
+            assert_eq!(first.as_ptr(), second.as_ptr());
+
+            // A different id, kind or log time is encoded separately.
+            shared_encoding("test", 2, msg, 10, || encode_counted(&count, msg));
+            shared_encoding("other", 1, msg, 10, || encode_counted(&count, msg));
+            shared_encoding("test", 1, msg, 11, || encode_counted(&count, msg));
+            assert_eq!(count.get(), 4);
+
+            // Nested dispatches don't share encodings with their parent.
+            {
+                let _nested = Dispatch::enter();
+                shared_encoding("test", 1, msg, 10, || encode_counted(&count, msg));
+                assert_eq!(count.get(), 5);
+            }
+            shared_encoding("test", 1, msg, 10, || encode_counted(&count, msg));
+            assert_eq!(count.get(), 5);
+        }
+        DISPATCH.with_borrow(|state| assert!(state.encodings.is_empty()));
+
+        // Outside of a dispatch, every call encodes.
+        shared_encoding("test", 1, msg, 10, || encode_counted(&count, msg));
+        shared_encoding("test", 1, msg, 10, || encode_counted(&count, msg));
+        assert_eq!(count.get(), 7);
+    }
+
+    #[test]
+    fn test_lossy_sinks_come_first() {
+        let lossless: Arc<dyn Sink> = Arc::new(RecordingSink::new().lossless(true));
+        let lossy1: Arc<dyn Sink> = Arc::new(RecordingSink::new());
+        let lossy2: Arc<dyn Sink> = Arc::new(RecordingSink::new());
+        let set = LogSinkSet::new();
+        set.store(SmallSinkVec::from_iter([
+            lossless.clone(),
+            lossy1.clone(),
+            lossy2.clone(),
+        ]));
+
+        let mut order = vec![];
+        set.for_each(|sink| {
+            order.push(sink.id());
+            Ok(())
+        });
+        assert_eq!(order, [lossy1.id(), lossy2.id(), lossless.id()]);
+    }
+}
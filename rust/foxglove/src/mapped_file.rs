@@ -0,0 +1,102 @@
+//! Memory-mapped files, so that their contents can be read and shared without copying them.
+use std::fs::File;
+use std::io;
+use std::path::Path;
+
+use bytes::Bytes;
+
+/// Maps the file into memory, or reads it where memory-mapping is not supported.
+///
+/// The file must not be truncated while it is mapped, since reading the missing pages would
+/// fault.
+pub(crate) fn map_file(path: &Path) -> io::Result<Bytes> {
+    let file = File::open(path)?;
+    #[cfg(unix)]
+    {
+        let len = usize::try_from(file.metadata()?.len())
+            .map_err(|e| io::Error::new(io::ErrorKind::FileTooLarge, e))?;
+        if len == 0 {
+            return Ok(Bytes::new());
+        }
+        Ok(Bytes::from_owner(MappedFile::new(&file, len)?))
+    }
+    #[cfg(not(unix))]
+    {
+        let mut file = file;
+        let mut data = Vec::new();
+        io::Read::read_to_end(&mut file, &mut data)?;
+        Ok(Bytes::from(data))
+    }
+}
+
+/// A read-only, private mapping of a whole file.
+#[cfg(unix)]
+struct MappedFile {
+    ptr: std::ptr::NonNull<u8>,
+    len: usize,
+}
+
+// Safety: the mapping is read-only, and unmapped only when dropped.
+#[cfg(unix)]
+unsafe impl Send for MappedFile {}
+#[cfg(unix)]
+unsafe impl Sync for MappedFile {}
+
+#[cfg(unix)]
+impl MappedFile {
+    fn new(file: &File, len: usize) -> io::Result<Self> {
+        use std::os::fd::AsRawFd;
+
+        // Safety: the arguments describe a read-only mapping of `len` bytes of an open file.
+        let ptr = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                len,
+                libc::PROT_READ,
+                libc::MAP_PRIVATE,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if ptr == libc::MAP_FAILED {
+            return Err(io::Error::last_os_error());
+        }
+        let ptr = std::ptr::NonNull::new(ptr.cast())
+            .ok_or_else(|| io::Error::other("mmap returned a null pointer"))?;
+        Ok(Self { ptr, len })
+    }
+}
+
+#[cfg(unix)]
+impl AsRef<[u8]> for MappedFile {
+    fn as_ref(&self) -> &[u8] {
+        // Safety: the mapping is valid for `len` bytes until it is dropped.
+        unsafe { std::slice::from_raw_parts(self.ptr.as_ptr(), self.len) }
+    }
+}
+
+#[cfg(unix)]
+impl Drop for MappedFile {
+    fn drop(&mut self) {
+        // Safety: the mapping was created with this address and length.
+        unsafe { libc::munmap(self.ptr.as_ptr().cast(), self.len) };
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_map_file() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("data.bin");
+        std::fs::write(&path, b"mapped data").unwrap();
+        let data = map_file(&path).unwrap();
+        assert_eq!(data.as_ref(), b"mapped data");
+        assert_eq!(data.slice(7..).as_ref(), b"data");
+
+        std::fs::write(&path, b"").unwrap();
+        assert!(map_file(&path).unwrap().is_empty());
+    }
+}
@@ -0,0 +1,912 @@
+//! MCAP reader
+
+use std::cmp::Reverse;
+use std::collections::{BTreeMap, BinaryHeap, HashMap, HashSet, VecDeque};
+use std::path::Path;
+use std::sync::Arc;
+
+use bytes::Bytes;
+
+use crate::FoxgloveError;
+use crate::mapped_file;
+use crate::mcap_writer::records::{RECORD_PREFIX_LEN, RecordReader, op, split_record};
+
+mod chunk;
+mod live;
+mod merge;
+mod summary;
+use chunk::{Dictionaries, chunk_records};
+pub use live::{McapChunkCommit, McapLiveReader};
+pub use merge::McapMergedMessages;
+use summary::{ChunkEntry, range, read_summary};
+
+/// A schema read from an MCAP file.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct McapSchema {
+    /// The schema id, unique within the file.
+    pub id: u16,
+    /// The schema name.
+    pub name: String,
+    /// The schema encoding, such as `jsonschema` or `protobuf`.
+    pub encoding: String,
+    /// The schema data.
+    pub data: Bytes,
+}
+
+/// A channel read from an MCAP file.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct McapChannel {
+    /// The channel id, unique within the file.
+    pub id: u16,
+    /// The channel topic.
+    pub topic: String,
+    /// The encoding of the channel's messages, such as `json` or `protobuf`.
+    pub message_encoding: String,
+    /// The channel metadata.
+    pub metadata: BTreeMap<String, String>,
+    /// The channel's schema, if it has one.
+    pub schema: Option<Arc<McapSchema>>,
+}
+
+/// A message read from an MCAP file.
+#[derive(Debug, Clone)]
+pub struct McapMessage {
+    /// The channel the message was logged to.
+    pub channel: Arc<McapChannel>,
+    /// The message sequence number.
+    pub sequence: u32,
+    /// The time the message was logged, in nanoseconds.
+    pub log_time: u64,
+    /// The time the message was published, in nanoseconds.
+    pub publish_time: u64,
+    /// The message data.
+    ///
+    /// This refers to the memory-mapped file, or to the decompressed chunk which held the
+    /// message, so it is not copied.
+    pub data: Bytes,
+}
+
+/// The order in which [`McapReader::messages`] returns messages.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum McapReadOrder {
+    /// Messages are returned in order of log time. Chunks whose time ranges overlap are read
+    /// together and merged.
+    #[default]
+    LogTime,
+    /// Messages are returned in the order they appear in the file, which avoids holding
+    /// overlapping chunks in memory at once.
+    File,
+}
+
+/// Options for [`McapReader::messages`].
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct McapReadOptions {
+    /// Only return messages logged at or after this time, in nanoseconds.
+    pub start_time: Option<u64>,
+    /// Only return messages logged before this time, in nanoseconds.
+    pub end_time: Option<u64>,
+    /// Only return messages on these topics. All topics are read if `None`.
+    pub topics: Option<Vec<String>>,
+    /// The order in which messages are returned.
+    pub order: McapReadOrder,
+    /// Number of chunks to decompress in parallel, on scoped threads. Values less than 2
+    /// decompress chunks on the thread which iterates over the messages.
+    pub decompression_threads: usize,
+}
+
+/// Reads messages from a finished MCAP file, using its summary section to find them.
+///
+/// The file is memory-mapped, and message data refers to the mapping, or to the decompressed
+/// chunk which held the message, rather than being copied. Chunks which cannot hold messages
+/// matching the [`McapReadOptions`] are skipped using the chunk indexes, so reading a short
+/// time range or a few topics of a large file only reads the chunks which hold them.
+///
+/// Chunks compressed with zstd dictionaries, as written with
+/// [`McapWriter::zstd_dictionary`][crate::McapWriter::zstd_dictionary], are decompressed with
+/// the dictionaries attached to the file.
+///
+/// Unfinished files have no summary section, and must be repaired with
+/// [`recover_mcap`][crate::recover_mcap] before they can be read. Files which are still being
+/// written can be read with an [`McapLiveReader`].
+///
+/// Cloning the reader is cheap, and clones share the mapping.
+///
+/// ```no_run
+/// # fn func() -> Result<(), foxglove::FoxgloveError> {
+/// use foxglove::{McapReadOptions, McapReader};
+///
+/// let reader = McapReader::open("recording.mcap")?;
+/// let options = McapReadOptions {
+///     start_time: Some(1_700_000_000_000_000_000),
+///     topics: Some(vec!["/imu".to_string()]),
+///     ..Default::default()
+/// };
+/// for message in reader.messages(&options) {
+///     let message = message?;
+///     println!("{} {} bytes", message.log_time, message.data.len());
+/// }
+/// # Ok(()) }
+/// ```
+#[derive(Clone)]
+pub struct McapReader {
+    inner: Arc<Inner>,
+}
+
+struct Inner {
+    data: Bytes,
+    channels: BTreeMap<u16, Arc<McapChannel>>,
+    chunks: Vec<ChunkEntry>,
+    dictionaries: Dictionaries,
+}
+
+impl McapReader {
+    /// Opens and memory-maps the MCAP file at `path`.
+    ///
+    /// The file must not be truncated while it is being read.
+    pub fn open(path: impl AsRef<Path>) -> Result<Self, FoxgloveError> {
+        Self::from_bytes(mapped_file::map_file(path.as_ref())?)
+    }
+
+    /// Creates a reader for an MCAP file held in memory.
+    pub fn from_bytes(data: impl Into<Bytes>) -> Result<Self, FoxgloveError> {
+        let data = data.into();
+        let summary = read_summary(&data)?;
+        Ok(Self {
+            inner: Arc::new(Inner {
+                data,
+                channels: summary.channels,
+                chunks: summary.chunks,
+                dictionaries: summary.dictionaries,
+            }),
+        })
+    }
+
+    /// Returns the file's channels, in order of id.
+    pub fn channels(&self) -> impl Iterator<Item = &Arc<McapChannel>> {
+        self.inner.channels.values()
+    }
+
+    /// Returns the earliest and latest message log times in the file, from its chunk indexes.
+    ///
+    /// Returns `None` if the file has no chunk indexes, or no messages.
+    pub fn time_range(&self) -> Option<(u64, u64)> {
+        self.inner
+            .chunks
+            .iter()
+            .filter(|chunk| !chunk.records)
+            .map(|chunk| (chunk.message_start_time, chunk.message_end_time))
+            .reduce(|(start, end), (chunk_start, chunk_end)| {
+                (start.min(chunk_start), end.max(chunk_end))
+            })
+    }
+
+    /// Returns an iterator over the messages which match the options.
+    ///
+    /// Chunks are read as the iterator advances. If a chunk cannot be read, the iterator returns
+    /// the error and then ends.
+    pub fn messages(&self, options: &McapReadOptions) -> McapMessages {
+        let channels = options.topics.as_ref().map(|topics| {
+            self.inner
+                .channels
+                .values()
+                .filter(|channel| topics.contains(&channel.topic))
+                .map(|channel| channel.id)
+                .collect()
+        });
+        let filter = Filter {
+            channels,
+            start_time: options.start_time.unwrap_or(0),
+            end_time: options.end_time,
+        };
+        let mut pending: Vec<usize> = (0..self.inner.chunks.len())
+            .filter(|&index| filter.may_match(&self.inner.chunks[index]))
+            .collect();
+        if options.order == McapReadOrder::LogTime {
+            pending.sort_by_key(|&index| self.inner.chunks[index].message_start_time);
+        }
+        McapMessages {
+            inner: self.inner.clone(),
+            filter,
+            order: options.order,
+            threads: options.decompression_threads.max(1),
+            pending: pending.into(),
+            decoded: VecDeque::new(),
+            current: VecDeque::new(),
+            merging: HashMap::new(),
+            heap: BinaryHeap::new(),
+            next_slot: 0,
+            failed: false,
+        }
+    }
+
+    /// Returns the latest message logged before `time` on each channel, in order of log time.
+    ///
+    /// This is the state a viewer needs after seeking to `time`, such as the most recent
+    /// transforms, scene updates and calibrations. Only channels on `topics` are considered, if
+    /// set. Chunks are visited from the latest to the earliest, and the chunk indexes are used to
+    /// skip chunks which cannot hold a later message on a channel still missing one, so usually
+    /// only the chunks just before `time` are read.
+    pub fn latest_messages(
+        &self,
+        time: u64,
+        topics: Option<&[String]>,
+    ) -> Result<Vec<McapMessage>, FoxgloveError> {
+        let wanted: HashSet<u16> = self
+            .inner
+            .channels
+            .values()
+            .filter(|channel| topics.is_none_or(|topics| topics.contains(&channel.topic)))
+            .map(|channel| channel.id)
+            .collect();
+        let filter = Filter {
+            channels: Some(wanted.clone()),
+            start_time: 0,
+            end_time: Some(time),
+        };
+        let mut chunks: Vec<&ChunkEntry> = self
+            .inner
+            .chunks
+            .iter()
+            .filter(|chunk| filter.may_match(chunk))
+            .collect();
+        chunks.sort_by_key(|chunk| Reverse(chunk.message_end_time));
+
+        let mut latest: HashMap<u16, McapMessage> = HashMap::new();
+        for chunk in chunks {
+            // The latest time a matching message in this chunk can have.
+            let chunk_end = chunk.message_end_time.min(time - 1);
+            let improves = |id: &u16| {
+                latest
+                    .get(id)
+                    .is_none_or(|message| message.log_time < chunk_end)
+            };
+            let needed = if chunk.channels.is_empty() {
+                wanted.iter().any(improves)
+            } else {
+                chunk
+                    .channels
+                    .iter()
+                    .filter(|id| wanted.contains(*id))
+                    .any(improves)
+            };
+            if !needed {
+                // Chunks are sorted by end time, so once no channel can be improved by this
+                // chunk's time range, none of the remaining chunks can improve any channel.
+                if !wanted.iter().any(improves) {
+                    break;
+                }
+                continue;
+            }
+            for message in self.inner.read_chunk(chunk, &filter)? {
+                let previous = latest.get(&message.channel.id);
+                if previous.is_none_or(|previous| message.log_time >= previous.log_time) {
+                    latest.insert(message.channel.id, message);
+                }
+            }
+        }
+        let mut messages: Vec<_> = latest.into_values().collect();
+        messages.sort_by_key(|message| message.log_time);
+        Ok(messages)
+    }
+
+    /// Returns an iterator over the messages of several files which match the options, merged in
+    /// order of log time.
+    ///
+    /// This is useful for recordings which were rotated, or recorded as several files in
+    /// parallel. The `order` option is ignored. Each file's chunks are read as the merge reaches
+    /// them, using its chunk indexes, so only the chunks which overlap the current log time are
+    /// decompressed and held in memory.
+    ///
+    /// ```no_run
+    /// # fn func() -> Result<(), foxglove::FoxgloveError> {
+    /// use foxglove::{Context, McapReadOptions, McapReader};
+    ///
+    /// let readers = ["front.mcap", "rear.mcap"]
+    ///     .into_iter()
+    ///     .map(McapReader::open)
+    ///     .collect::<Result<Vec<_>, _>>()?;
+    /// let mut merged = McapReader::merge(&readers, &McapReadOptions::default());
+    /// merged.log_all(&Context::get_default())?;
+    /// # Ok(()) }
+    /// ```
+    pub fn merge(readers: &[McapReader], options: &McapReadOptions) -> McapMergedMessages {
+        McapMergedMessages::new(readers, options)
+    }
+}
+
+impl std::fmt::Debug for McapReader {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("McapReader")
+            .field("channels", &self.inner.channels.len())
+            .field("chunks", &self.inner.chunks.len())
+            .finish_non_exhaustive()
+    }
+}
+
+impl Inner {
+    /// Reads the messages in a chunk which match the filter, in file order.
+    fn read_chunk(
+        &self,
+        chunk: &ChunkEntry,
+        filter: &Filter,
+    ) -> Result<Vec<McapMessage>, FoxgloveError> {
+        let record = range(&self.data, chunk.offset, chunk.length)?;
+        let mut messages = Vec::new();
+        if chunk.records {
+            self.read_records(&self.data.slice_ref(record), filter, &mut messages)?;
+        } else {
+            let Some((op::CHUNK, body)) = split_record(record) else {
+                return Err(FoxgloveError::ValueError(format!(
+                    "MCAP chunk index refers to a record at offset {} which is not a chunk",
+                    chunk.offset
+                )));
+            };
+            let records = chunk_records(&self.data.slice_ref(body), &self.dictionaries)?;
+            self.read_records(&records, filter, &mut messages)?;
+        }
+        Ok(messages)
+    }
+
+    fn read_records(
+        &self,
+        records: &Bytes,
+        filter: &Filter,
+        messages: &mut Vec<McapMessage>,
+    ) -> Result<(), FoxgloveError> {
+        let mut rest: &[u8] = records;
+        while let Some((opcode, body)) = split_record(rest) {
+            rest = &rest[RECORD_PREFIX_LEN as usize + body.len()..];
+            match opcode {
+                op::MESSAGE => {
+                    let mut fields = RecordReader::new(body);
+                    let channel_id = fields.u16()?;
+                    let sequence = fields.u32()?;
+                    let log_time = fields.u64()?;
+                    let publish_time = fields.u64()?;
+                    if !filter.matches(channel_id, log_time) {
+                        continue;
+                    }
+                    let Some(channel) = self.channels.get(&channel_id) else {
+                        return Err(FoxgloveError::ValueError(format!(
+                            "MCAP message refers to unknown channel {channel_id}"
+                        )));
+                    };
+                    messages.push(McapMessage {
+                        channel: channel.clone(),
+                        sequence,
+                        log_time,
+                        publish_time,
+                        data: records.slice_ref(fields.remaining()),
+                    });
+                }
+                // Chunks are only found here when reading a data section without chunk indexes.
+                op::CHUNK => {
+                    let chunk = chunk_records(&records.slice_ref(body), &self.dictionaries)?;
+                    self.read_records(&chunk, filter, messages)?;
+                }
+                _ => (),
+            }
+        }
+        if !rest.is_empty() {
+            return Err(FoxgloveError::ValueError(
+                "MCAP chunk ends with a truncated record".to_string(),
+            ));
+        }
+        Ok(())
+    }
+}
+
+/// Selects messages by channel and log time.
+struct Filter {
+    channels: Option<HashSet<u16>>,
+    start_time: u64,
+    end_time: Option<u64>,
+}
+
+impl Filter {
+    fn matches(&self, channel_id: u16, log_time: u64) -> bool {
+        log_time >= self.start_time
+            && self.end_time.is_none_or(|end| log_time < end)
+            && self
+                .channels
+                .as_ref()
+                .is_none_or(|channels| channels.contains(&channel_id))
+    }
+
+    /// Returns false if the chunk cannot hold a matching message.
+    fn may_match(&self, chunk: &ChunkEntry) -> bool {
+        chunk.message_end_time >= self.start_time
+            && self
+                .end_time
+                .is_none_or(|end| chunk.message_start_time < end)
+            && match &self.channels {
+                // Chunks without message indexes may hold messages on any channel.
+                Some(channels) if !chunk.channels.is_empty() => {
+                    chunk.channels.iter().any(|id| channels.contains(id))
+                }
+                Some(channels) => !channels.is_empty(),
+                None => true,
+            }
+    }
+}
+
+/// An iterator over messages in an MCAP file.
+///
+/// See [`McapReader::messages`].
+pub struct McapMessages {
+    inner: Arc<Inner>,
+    filter: Filter,
+    order: McapReadOrder,
+    threads: usize,
+    // Indexes of chunks which have not been read yet, in the order they are read.
+    pending: VecDeque<usize>,
+    // Chunks which have been read, but not yet iterated over, with their indexes.
+    decoded: VecDeque<(usize, Result<Vec<McapMessage>, FoxgloveError>)>,
+    // Messages of the chunk being iterated over in file order.
+    current: VecDeque<McapMessage>,
+    // Messages of the chunks being merged in log time order, by slot.
+    merging: HashMap<usize, VecDeque<McapMessage>>,
+    // The log time of the next message of each chunk being merged, with its slot. Slots are
+    // assigned in the order chunks are read, so ties are broken by that order.
+    heap: BinaryHeap<Reverse<(u64, usize)>>,
+    next_slot: usize,
+    failed: bool,
+}
+
+impl McapMessages {
+    /// Returns the messages of the next chunk, reading a batch of chunks if needed.
+    fn next_chunk(&mut self) -> Result<Option<Vec<McapMessage>>, FoxgloveError> {
+        if self.decoded.is_empty() {
+            self.read_batch();
+        }
+        self.decoded
+            .pop_front()
+            .map(|(_, messages)| messages)
+            .transpose()
+    }
+
+    /// Returns the index of the next chunk to be iterated over.
+    fn next_chunk_index(&self) -> Option<usize> {
+        self.decoded
+            .front()
+            .map(|&(index, _)| index)
+            .or_else(|| self.pending.front().copied())
+    }
+
+    /// Reads up to one chunk per decompression thread.
+    fn read_batch(&mut self) {
+        let count = self.threads.min(self.pending.len());
+        let batch: Vec<usize> = self.pending.drain(..count).collect();
+        let inner = &self.inner;
+        let filter = &self.filter;
+        let order = self.order;
+        let read = |index: usize| {
+            let messages = inner
+                .read_chunk(&inner.chunks[index], filter)
+                .map(|mut messages| {
+                    if order == McapReadOrder::LogTime {
+                        messages.sort_by_key(|message| message.log_time);
+                    }
+                    messages
+                });
+            (index, messages)
+        };
+        if batch.len() < 2 {
+            self.decoded.extend(batch.into_iter().map(read));
+            return;
+        }
+        std::thread::scope(|scope| {
+            let handles: Vec<_> = batch
+                .iter()
+                .map(|&index| scope.spawn(move || read(index)))
+                .collect();
+            for (handle, &index) in handles.into_iter().zip(&batch) {
+                self.decoded.push_back(handle.join().unwrap_or_else(|_| {
+                    let error = format!("reading MCAP chunk {index} panicked");
+                    (index, Err(FoxgloveError::Unspecified(error.into())))
+                }));
+            }
+        });
+    }
+
+    fn next_in_file_order(&mut self) -> Result<Option<McapMessage>, FoxgloveError> {
+        loop {
+            if let Some(message) = self.current.pop_front() {
+                return Ok(Some(message));
+            }
+            let Some(messages) = self.next_chunk()? else {
+                return Ok(None);
+            };
+            self.current = messages.into();
+        }
+    }
+
+    fn next_in_log_time_order(&mut self) -> Result<Option<McapMessage>, FoxgloveError> {
+        // Read every chunk which may hold a message earlier than the earliest one read so far.
+        while let Some(index) = self.next_chunk_index() {
+            let start_time = self.inner.chunks[index].message_start_time;
+            if self
+                .heap
+                .peek()
+                .is_some_and(|Reverse((log_time, _))| *log_time < start_time)
+            {
+                break;
+            }
+            let messages: VecDeque<_> = self.next_chunk()?.unwrap_or_default().into();
+            if let Some(first) = messages.front() {
+                let slot = self.next_slot;
+                self.next_slot += 1;
+                self.heap.push(Reverse((first.log_time, slot)));
+                self.merging.insert(slot, messages);
+            }
+        }
+        let Some(Reverse((_, slot))) = self.heap.pop() else {
+            return Ok(None);
+        };
+        let Some(messages) = self.merging.get_mut(&slot) else {
+            return Ok(None);
+        };
+        let message = messages.pop_front();
+        match messages.front() {
+            Some(next) => self.heap.push(Reverse((next.log_time, slot))),
+            None => {
+                self.merging.remove(&slot);
+            }
+        }
+        Ok(message)
+    }
+}
+
+impl Iterator for McapMessages {
+    type Item = Result<McapMessage, FoxgloveError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.failed {
+            return None;
+        }
+        let result = match self.order {
+            McapReadOrder::File => self.next_in_file_order(),
+            McapReadOrder::LogTime => self.next_in_log_time_order(),
+        };
+        match result {
+            Ok(message) => message.map(Ok),
+            Err(e) => {
+                self.failed = true;
+                Some(Err(e))
+            }
+        }
+    }
+}
+
+impl std::fmt::Debug for McapMessages {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("McapMessages")
+            .field("order", &self.order)
+            .field("pending_chunks", &self.pending.len())
+            .finish_non_exhaustive()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::io::Cursor;
+
+    use super::*;
+
+    const MESSAGE_COUNT: u64 = 1000;
+
+    /// Writes messages alternating between topics `/a` and `/b`, with log times which are a
+    /// permutation of `0..MESSAGE_COUNT`, so that chunks overlap in time.
+    fn write_shuffled(options: mcap::WriteOptions) -> Vec<u8> {
+        let mut writer = options
+            .create(Cursor::new(Vec::new()))
+            .expect("failed to create writer");
+        let schema_id = writer
+            .add_schema("Schema", "jsonschema", b"{}")
+            .expect("failed to add schema");
+        let a = writer
+            .add_channel(schema_id, "/a", "json", &BTreeMap::new())
+            .expect("failed to add channel");
+        let b = writer
+            .add_channel(0, "/b", "json", &BTreeMap::new())
+            .expect("failed to add channel");
+        for i in 0..MESSAGE_COUNT {
+            let log_time = shuffled_time(i);
+            let header = mcap::records::MessageHeader {
+                channel_id: if log_time % 2 == 0 { a } else { b },
+                sequence: i as u32,
+                log_time,
+                publish_time: log_time,
+            };
+            writer
+                .write_to_known_channel(&header, log_time.to_string().as_bytes())
+                .expect("failed to write message");
+        }
+        writer.finish().expect("failed to finish");
+        writer.into_inner().into_inner()
+    }
+
+    fn shuffled_time(i: u64) -> u64 {
+        // 389 is prime, so this is a permutation.
+        (i * 389) % MESSAGE_COUNT
+    }
+
+    fn read_times(reader: &McapReader, options: &McapReadOptions) -> Vec<u64> {
+        reader
+            .messages(options)
+            .map(|message| {
+                let message = message.expect("failed to read message");
+                assert_eq!(message.data, message.log_time.to_string().as_bytes());
+                message.log_time
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_read_in_log_time_and_file_order() {
+        let options = mcap::WriteOptions::default().chunk_size(Some(256));
+        let reader = McapReader::from_bytes(write_shuffled(options)).expect("failed to open");
+        assert!(reader.inner.chunks.len() > 10);
+
+        let topics: Vec<_> = reader.channels().map(|c| c.topic.as_str()).collect();
+        assert_eq!(topics, ["/a", "/b"]);
+        let schema = reader.channels().next().unwrap().schema.clone().unwrap();
+        assert_eq!(schema.name, "Schema");
+        assert_eq!(schema.data, Bytes::from_static(b"{}"));
+
+        assert_eq!(reader.time_range(), Some((0, MESSAGE_COUNT - 1)));
+        let times = read_times(&reader, &McapReadOptions::default());
+        assert_eq!(times, (0..MESSAGE_COUNT).collect::<Vec<_>>());
+
+        let options = McapReadOptions {
+            order: McapReadOrder::File,
+            ..Default::default()
+        };
+        let times = read_times(&reader, &options);
+        assert_eq!(
+            times,
+            (0..MESSAGE_COUNT).map(shuffled_time).collect::<Vec<_>>()
+        );
+    }
+
+    #[test]
+    fn test_filters_skip_chunks() {
+        // Messages are written in log time order, so each chunk holds a short time range.
+        let mut writer = mcap::WriteOptions::default()
+            .chunk_size(Some(256))
+            .create(Cursor::new(Vec::new()))
+            .expect("failed to create writer");
+        let a = writer
+            .add_channel(0, "/a", "json", &BTreeMap::new())
+            .expect("failed to add channel");
+        let b = writer
+            .add_channel(0, "/b", "json", &BTreeMap::new())
+            .expect("failed to add channel");
+        for log_time in 0..MESSAGE_COUNT {
+            // The first half of the file only has messages on /a.
+            let channel_id = if log_time >= 500 && log_time % 2 == 1 {
+                b
+            } else {
+                a
+            };
+            let header = mcap::records::MessageHeader {
+                channel_id,
+                sequence: 0,
+                log_time,
+                publish_time: log_time,
+            };
+            writer
+                .write_to_known_channel(&header, log_time.to_string().as_bytes())
+                .expect("failed to write message");
+        }
+        writer.finish().expect("failed to finish");
+        let reader =
+            McapReader::from_bytes(writer.into_inner().into_inner()).expect("failed to open");
+        let chunk_count = reader.inner.chunks.len();
+
+        let options = McapReadOptions {
+            start_time: Some(100),
+            end_time: Some(200),
+            ..Default::default()
+        };
+        assert!(reader.messages(&options).pending.len() < chunk_count / 4);
+        assert_eq!(
+            read_times(&reader, &options),
+            (100..200).collect::<Vec<_>>()
+        );
+
+        let options = McapReadOptions {
+            topics: Some(vec!["/b".to_string()]),
+            ..Default::default()
+        };
+        assert!(reader.messages(&options).pending.len() <= chunk_count / 2 + 1);
+        let expected: Vec<_> = (500..MESSAGE_COUNT).filter(|t| t % 2 == 1).collect();
+        assert_eq!(read_times(&reader, &options), expected);
+
+        let options = McapReadOptions {
+            topics: Some(vec!["/missing".to_string()]),
+            ..Default::default()
+        };
+        assert_eq!(reader.messages(&options).count(), 0);
+    }
+
+    #[test]
+    fn test_latest_messages() {
+        let options = mcap::WriteOptions::default().chunk_size(Some(256));
+        let reader = McapReader::from_bytes(write_shuffled(options)).expect("failed to open");
+        let latest = |time: u64, topics: Option<&[String]>| -> Vec<(String, u64)> {
+            reader
+                .latest_messages(time, topics)
+                .expect("failed to read latest messages")
+                .into_iter()
+                .map(|message| (message.channel.topic.clone(), message.log_time))
+                .collect()
+        };
+        // Even log times are on /a, and odd log times on /b.
+        assert_eq!(
+            latest(500, None),
+            [("/a".to_string(), 498), ("/b".to_string(), 499)]
+        );
+        assert_eq!(latest(1, None), [("/a".to_string(), 0)]);
+        assert!(latest(0, None).is_empty());
+        let topics = ["/b".to_string()];
+        assert_eq!(
+            latest(u64::MAX, Some(&topics[..])),
+            [("/b".to_string(), 999)]
+        );
+    }
+
+    #[test]
+    fn test_latest_messages_skip_chunks() {
+        // Messages are written in log time order, so each chunk holds a short time range.
+        let mut writer = mcap::WriteOptions::default()
+            .chunk_size(Some(256))
+            .create(Cursor::new(Vec::new()))
+            .expect("failed to create writer");
+        let a = writer
+            .add_channel(0, "/a", "json", &BTreeMap::new())
+            .expect("failed to add channel");
+        for log_time in 0..MESSAGE_COUNT {
+            let header = mcap::records::MessageHeader {
+                channel_id: a,
+                sequence: 0,
+                log_time,
+                publish_time: log_time,
+            };
+            writer
+                .write_to_known_channel(&header, log_time.to_string().as_bytes())
+                .expect("failed to write message");
+        }
+        writer.finish().expect("failed to finish");
+        let reader =
+            McapReader::from_bytes(writer.into_inner().into_inner()).expect("failed to open");
+        assert!(reader.inner.chunks.len() > 10);
+
+        // Overwrite all but the chunk holding the latest message before 500, so that reading
+        // any other chunk fails.
+        let latest = reader
+            .latest_messages(500, None)
+            .expect("failed to read latest messages");
+        assert_eq!(latest.len(), 1);
+        assert_eq!(latest[0].log_time, 499);
+        let chunk = reader
+            .inner
+            .chunks
+            .iter()
+            .find(|chunk| (chunk.message_start_time..=chunk.message_end_time).contains(&499))
+            .expect("no chunk holds the message");
+        let mut data = reader.inner.data.to_vec();
+        for other in &reader.inner.chunks {
+            if other.offset != chunk.offset {
+                let start = other.offset as usize;
+                data[start..start + other.length as usize].fill(0);
+            }
+        }
+        let corrupted = McapReader::from_bytes(data).expect("failed to open");
+        let latest = corrupted
+            .latest_messages(500, None)
+            .expect("read a chunk which was not needed");
+        assert_eq!(latest[0].log_time, 499);
+    }
+
+    #[cfg(feature = "zstd")]
+    #[test]
+    fn test_parallel_decompression() {
+        let options = mcap::WriteOptions::default()
+            .compression(Some(crate::McapCompression::Zstd))
+            .chunk_size(Some(256));
+        let reader = McapReader::from_bytes(write_shuffled(options)).expect("failed to open");
+        for order in [McapReadOrder::LogTime, McapReadOrder::File] {
+            let serial = McapReadOptions {
+                order,
+                ..Default::default()
+            };
+            let parallel = McapReadOptions {
+                decompression_threads: 4,
+                ..serial.clone()
+            };
+            assert_eq!(read_times(&reader, &parallel), read_times(&reader, &serial));
+        }
+    }
+
+    #[test]
+    fn test_uncompressed_messages_are_not_copied() {
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let path = dir.path().join("recording.mcap");
+        let options = mcap::WriteOptions::default().compression(None);
+        std::fs::write(&path, write_shuffled(options)).expect("failed to write file");
+
+        let reader = McapReader::open(&path).expect("failed to open");
+        let file = reader.inner.data.as_ptr_range();
+        for message in reader.messages(&McapReadOptions::default()) {
+            let message = message.expect("failed to read message");
+            assert!(file.contains(&message.data.as_ptr()));
+        }
+    }
+
+    #[test]
+    fn test_read_without_chunks() {
+        let options = mcap::WriteOptions::default().use_chunks(false);
+        let reader = McapReader::from_bytes(write_shuffled(options)).expect("failed to open");
+        assert_eq!(reader.time_range(), None);
+        let times = read_times(&reader, &McapReadOptions::default());
+        assert_eq!(times, (0..MESSAGE_COUNT).collect::<Vec<_>>());
+    }
+
+    #[test]
+    fn test_unfinished_file() {
+        let mut data = write_shuffled(mcap::WriteOptions::default());
+        data.truncate(data.len() / 2);
+        assert!(McapReader::from_bytes(data).is_err());
+        assert!(McapReader::from_bytes(Vec::new()).is_err());
+    }
+
+    #[cfg(feature = "zstd")]
+    #[test]
+    fn test_read_zstd_dictionary_chunks() {
+        use crate::{
+            ChannelBuilder, Context, McapWriter, McapZstdDictionary, PartialMetadata, Schema,
+        };
+
+        let ctx = Context::new();
+        let channel = ChannelBuilder::new("/log")
+            .context(&ctx)
+            .message_encoding("json")
+            .schema(Schema::new("Log", "jsonschema", b"{}".to_vec()))
+            .build_raw()
+            .expect("failed to create channel");
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let path = dir.path().join("recording.mcap");
+        let options = mcap::WriteOptions::default()
+            .compression(None)
+            .chunk_size(Some(512));
+        let writer = McapWriter::with_options(options)
+            .context(&ctx)
+            .zstd_dictionary(McapZstdDictionary {
+                training_messages: 200,
+                max_size: 4096,
+                level: 0,
+            })
+            .create_new_buffered_file(&path)
+            .expect("failed to create writer");
+        for log_time in 0..MESSAGE_COUNT {
+            let msg = format!(r#"{{"level":"info","msg":"cycle {log_time} done"}}"#);
+            channel.log_with_meta(msg.as_bytes(), PartialMetadata::with_log_time(log_time));
+        }
+        writer.close().expect("failed to close writer");
+
+        let reader = McapReader::open(&path).expect("failed to open");
+        let messages: Vec<_> = reader
+            .messages(&McapReadOptions::default())
+            .collect::<Result<_, _>>()
+            .expect("failed to read messages");
+        assert_eq!(messages.len(), MESSAGE_COUNT as usize);
+        for (log_time, message) in (0..).zip(&messages) {
+            assert_eq!(message.log_time, log_time);
+            assert_eq!(
+                message.data,
+                format!(r#"{{"level":"info","msg":"cycle {log_time} done"}}"#).as_bytes()
+            );
+        }
+    }
+}
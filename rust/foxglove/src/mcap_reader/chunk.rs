@@ -0,0 +1,177 @@
+//! Decompression of the records in MCAP chunks.
+use std::io;
+
+use bytes::Bytes;
+
+use crate::FoxgloveError;
+use crate::mcap_writer::records::{RecordReader, op, split_record};
+
+/// The zstd dictionaries attached to an MCAP file, by dictionary id.
+///
+/// See [`McapWriter::zstd_dictionary`][crate::McapWriter::zstd_dictionary].
+#[derive(Default)]
+pub(crate) struct Dictionaries {
+    #[cfg(feature = "zstd")]
+    by_id: std::collections::HashMap<u32, zstd::dict::DecoderDictionary<'static>>,
+}
+
+impl Dictionaries {
+    /// Loads the dictionary from the attachment record at the start of `record`.
+    pub fn add_attachment(&mut self, record: &[u8]) -> io::Result<()> {
+        let Some((op::ATTACHMENT, body)) = split_record(record) else {
+            return Err(truncated("attachment"));
+        };
+        let mut attachment = RecordReader::new(body);
+        let _log_time = attachment.u64()?;
+        let _create_time = attachment.u64()?;
+        let _name = attachment.str()?;
+        let _media_type = attachment.str()?;
+        let len = attachment.u64()?;
+        let data = usize::try_from(len)
+            .ok()
+            .and_then(|len| attachment.remaining().get(..len))
+            .ok_or_else(|| truncated("attachment"))?;
+        self.add(data);
+        Ok(())
+    }
+
+    #[cfg(feature = "zstd")]
+    fn add(&mut self, dictionary: &[u8]) {
+        // Dictionaries without a header have no id, so no frame can refer to them.
+        if let Some(id) = dictionary_id(dictionary) {
+            self.by_id
+                .insert(id, zstd::dict::DecoderDictionary::copy(dictionary));
+        }
+    }
+
+    #[cfg(not(feature = "zstd"))]
+    fn add(&mut self, _dictionary: &[u8]) {}
+
+    #[cfg(feature = "zstd")]
+    fn decompress_zstd(&self, data: &[u8], uncompressed_size: usize) -> io::Result<Vec<u8>> {
+        match frame_dictionary_id(data) {
+            Some(id) => {
+                let dictionary = self.by_id.get(&id).ok_or_else(|| {
+                    io::Error::new(
+                        io::ErrorKind::InvalidData,
+                        format!("MCAP chunk uses zstd dictionary {id}, which is not attached"),
+                    )
+                })?;
+                zstd::bulk::Decompressor::with_prepared_dictionary(dictionary)?
+                    .decompress(data, uncompressed_size)
+            }
+            None => zstd::bulk::decompress(data, uncompressed_size),
+        }
+    }
+}
+
+/// Returns the records of the chunk whose body is `chunk`, decompressing them if needed.
+///
+/// Uncompressed records are returned without copying them.
+#[cfg_attr(not(all(feature = "zstd", feature = "lz4")), allow(unused_variables))]
+pub(crate) fn chunk_records(
+    chunk: &Bytes,
+    dictionaries: &Dictionaries,
+) -> Result<Bytes, FoxgloveError> {
+    let mut fields = RecordReader::new(chunk);
+    let _message_start_time = fields.u64()?;
+    let _message_end_time = fields.u64()?;
+    let uncompressed_size = fields.u64()?;
+    let _uncompressed_crc = fields.u32()?;
+    let compression = fields.str()?;
+    let len = fields.u64()?;
+    let records = usize::try_from(len)
+        .ok()
+        .and_then(|len| fields.remaining().get(..len))
+        .ok_or_else(|| truncated("chunk"))?;
+    let uncompressed_size = usize::try_from(uncompressed_size)
+        .map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))?;
+    match compression.as_str() {
+        "" => Ok(chunk.slice_ref(records)),
+        #[cfg(feature = "zstd")]
+        "zstd" => Ok(dictionaries
+            .decompress_zstd(records, uncompressed_size)?
+            .into()),
+        #[cfg(feature = "lz4")]
+        "lz4" => {
+            let mut data = Vec::with_capacity(uncompressed_size);
+            io::Read::read_to_end(&mut lz4::Decoder::new(records)?, &mut data)?;
+            Ok(data.into())
+        }
+        other => Err(FoxgloveError::ValueError(format!(
+            "MCAP chunk compression {other:?} is not supported"
+        ))),
+    }
+}
+
+fn truncated(record: &str) -> io::Error {
+    io::Error::new(
+        io::ErrorKind::UnexpectedEof,
+        format!("MCAP {record} record is truncated"),
+    )
+}
+
+/// Returns the id in the header of a zstd dictionary.
+#[cfg(feature = "zstd")]
+fn dictionary_id(dictionary: &[u8]) -> Option<u32> {
+    const DICTIONARY_MAGIC: u32 = 0xEC30_A437;
+    let magic = u32::from_le_bytes(dictionary.get(..4)?.try_into().ok()?);
+    let id = u32::from_le_bytes(dictionary.get(4..8)?.try_into().ok()?);
+    (magic == DICTIONARY_MAGIC && id != 0).then_some(id)
+}
+
+/// Returns the id of the dictionary which a zstd frame was compressed with, if any.
+///
+/// See the frame header layout in <https://www.rfc-editor.org/rfc/rfc8878#section-3.1.1.1>.
+#[cfg(feature = "zstd")]
+fn frame_dictionary_id(frame: &[u8]) -> Option<u32> {
+    const FRAME_MAGIC: u32 = 0xFD2F_B528;
+    let magic = u32::from_le_bytes(frame.get(..4)?.try_into().ok()?);
+    let descriptor = *frame.get(4)?;
+    if magic != FRAME_MAGIC {
+        return None;
+    }
+    let single_segment = descriptor & 0x20 != 0;
+    let id_len = [0, 1, 2, 4][usize::from(descriptor & 0x03)];
+    // The window descriptor precedes the dictionary id, unless the frame is a single segment.
+    let start = 5 + usize::from(!single_segment);
+    let mut id = [0; 4];
+    id[..id_len].copy_from_slice(frame.get(start..start + id_len)?);
+    Some(u32::from_le_bytes(id)).filter(|&id| id != 0)
+}
+
+#[cfg(all(test, feature = "zstd"))]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_frame_dictionary_id() {
+        let samples: Vec<Vec<u8>> = (0..500)
+            .map(|i| format!(r#"{{"level":"info","message":"sample {i}"}}"#).into_bytes())
+            .collect();
+        let dictionary = zstd::dict::from_samples(&samples, 4096).unwrap();
+        let id = dictionary_id(&dictionary).unwrap();
+
+        let mut compressor = zstd::bulk::Compressor::with_dictionary(0, &dictionary).unwrap();
+        let frame = compressor.compress(&samples[0]).unwrap();
+        assert_eq!(frame_dictionary_id(&frame), Some(id));
+        assert_eq!(
+            frame_dictionary_id(&zstd::bulk::compress(&samples[0], 0).unwrap()),
+            None
+        );
+
+        let mut dictionaries = Dictionaries::default();
+        dictionaries.add(&dictionary);
+        assert_eq!(
+            dictionaries
+                .decompress_zstd(&frame, samples[0].len())
+                .unwrap(),
+            samples[0]
+        );
+        assert!(
+            Dictionaries::default()
+                .decompress_zstd(&frame, samples[0].len())
+                .is_err()
+        );
+    }
+}
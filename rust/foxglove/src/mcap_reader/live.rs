@@ -0,0 +1,214 @@
+//! Reading an MCAP file while it is being written.
+use std::collections::BTreeMap;
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+
+use crate::FoxgloveError;
+use crate::mapped_file;
+use crate::mcap_reader::chunk::Dictionaries;
+use crate::mcap_reader::summary::{ChunkEntry, range};
+use crate::mcap_reader::{Inner, McapChannel, McapReader};
+
+/// A chunk which an [`McapWriter`][crate::McapWriter] has finished writing to its file.
+///
+/// See [`McapWriter::chunk_commit_fn`][crate::McapWriter::chunk_commit_fn]. Each commit also
+/// carries the channels and zstd dictionaries which were added since the previous commit, so an
+/// [`McapLiveReader`] must be given every commit, in order.
+#[derive(Debug, Clone)]
+pub struct McapChunkCommit {
+    /// Length of the part of the file which has been written and flushed, which ends after this
+    /// chunk and its message indexes. The writer never changes this part of the file.
+    pub committed_len: u64,
+    /// Offset of the chunk record in the file.
+    pub offset: u64,
+    /// Length of the chunk record, including its opcode and length prefix.
+    pub length: u64,
+    /// Earliest message log time in the chunk, in nanoseconds.
+    pub message_start_time: u64,
+    /// Latest message log time in the chunk, in nanoseconds.
+    pub message_end_time: u64,
+    /// Ids of the channels with messages in the chunk.
+    pub channel_ids: Vec<u16>,
+    // Channels added since the previous commit.
+    pub(crate) channels: Vec<Arc<McapChannel>>,
+    // Offset and length of each dictionary attachment written since the previous commit.
+    pub(crate) dictionaries: Vec<(u64, u64)>,
+}
+
+/// Reads the committed chunks of an MCAP file while it is still being written.
+///
+/// A file has no summary section until it is finished, so [`McapReader::open`] cannot read it.
+/// Instead, pass each [`McapChunkCommit`] reported by the writer to [`push`][Self::push], and
+/// call [`reader`][Self::reader] to read the chunks committed so far. The reader maps only the
+/// committed part of the file, and uses the commits as chunk indexes, so it can seek by log time
+/// and topic within the completed chunks as usual.
+///
+/// ```no_run
+/// # fn func() -> Result<(), foxglove::FoxgloveError> {
+/// use std::sync::{Arc, Mutex};
+///
+/// use foxglove::{McapLiveReader, McapReadOptions, McapWriter};
+///
+/// let live = Arc::new(Mutex::new(McapLiveReader::new("recording.mcap")));
+/// let commits = live.clone();
+/// let writer = McapWriter::new()
+///     .chunk_commit_fn(move |commit| commits.lock().unwrap().push(commit))
+///     .create_new_buffered_file("recording.mcap")?;
+///
+/// // Later, on another thread:
+/// let reader = live.lock().unwrap().reader()?;
+/// for message in reader.messages(&McapReadOptions::default()) {
+///     println!("{}", message?.log_time);
+/// }
+/// # Ok(()) }
+/// ```
+#[derive(Debug)]
+pub struct McapLiveReader {
+    path: PathBuf,
+    committed_len: u64,
+    channels: BTreeMap<u16, Arc<McapChannel>>,
+    chunks: Vec<ChunkEntry>,
+    dictionaries: Vec<(u64, u64)>,
+}
+
+impl McapLiveReader {
+    /// Creates a reader for the MCAP file being written at `path`, with no committed chunks.
+    pub fn new(path: impl AsRef<Path>) -> Self {
+        Self {
+            path: path.as_ref().to_path_buf(),
+            committed_len: 0,
+            channels: BTreeMap::new(),
+            chunks: Vec::new(),
+            dictionaries: Vec::new(),
+        }
+    }
+
+    /// Adds a committed chunk.
+    pub fn push(&mut self, commit: &McapChunkCommit) {
+        self.committed_len = self.committed_len.max(commit.committed_len);
+        for channel in &commit.channels {
+            self.channels.insert(channel.id, channel.clone());
+        }
+        self.dictionaries.extend_from_slice(&commit.dictionaries);
+        self.chunks.push(ChunkEntry {
+            message_start_time: commit.message_start_time,
+            message_end_time: commit.message_end_time,
+            offset: commit.offset,
+            length: commit.length,
+            channels: commit.channel_ids.clone(),
+            records: false,
+        });
+    }
+
+    /// Returns the length of the part of the file which holds the committed chunks.
+    pub fn committed_len(&self) -> u64 {
+        self.committed_len
+    }
+
+    /// Returns the number of committed chunks.
+    pub fn chunk_count(&self) -> usize {
+        self.chunks.len()
+    }
+
+    /// Returns a reader for the chunks committed so far.
+    ///
+    /// The reader maps the committed part of the file as it is now, and does not see chunks
+    /// committed later. It is cheap to call again for an up to date reader.
+    pub fn reader(&self) -> Result<McapReader, FoxgloveError> {
+        let data = if self.committed_len == 0 {
+            bytes::Bytes::new()
+        } else {
+            mapped_file::map_file(&self.path)?
+        };
+        let len = usize::try_from(self.committed_len)
+            .ok()
+            .filter(|&len| len <= data.len())
+            .ok_or_else(|| {
+                FoxgloveError::ValueError(format!(
+                    "MCAP file is shorter than its committed length of {} bytes",
+                    self.committed_len
+                ))
+            })?;
+        let data = data.slice(..len);
+        let mut dictionaries = Dictionaries::default();
+        for &(offset, length) in &self.dictionaries {
+            dictionaries.add_attachment(range(&data, offset, length)?)?;
+        }
+        Ok(McapReader {
+            inner: Arc::new(Inner {
+                data,
+                channels: self.channels.clone(),
+                chunks: self.chunks.clone(),
+                dictionaries,
+            }),
+        })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::sync::Mutex;
+
+    use super::*;
+    use crate::{
+        ChannelBuilder, Context, McapReadOptions, McapWriteOptions, McapWriter, PartialMetadata,
+    };
+
+    #[test]
+    fn test_live_reader_reads_committed_chunks() {
+        let ctx = Context::new();
+        let channel = ChannelBuilder::new("/topic")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .expect("failed to create channel");
+
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let path = dir.path().join("live.mcap");
+        let live = Arc::new(Mutex::new(McapLiveReader::new(&path)));
+        let commits = live.clone();
+        let writer = McapWriter::with_options(McapWriteOptions::default().chunk_size(Some(256)))
+            .context(&ctx)
+            .chunk_commit_fn(move |commit| commits.lock().unwrap().push(commit))
+            .create_new_buffered_file(&path)
+            .expect("failed to create writer");
+
+        let reader = live.lock().unwrap().reader().expect("failed to read");
+        assert_eq!(reader.messages(&McapReadOptions::default()).count(), 0);
+
+        for i in 0..100_u64 {
+            channel.log_with_meta(b"{}", PartialMetadata::with_log_time(i));
+        }
+        writer.flush().expect("failed to flush");
+
+        let live_reader = live.lock().unwrap();
+        assert!(live_reader.chunk_count() > 1);
+        assert!(
+            std::fs::metadata(&path).unwrap().len() >= live_reader.committed_len(),
+            "committed data must be in the file"
+        );
+        let reader = live_reader.reader().expect("failed to read");
+        drop(live_reader);
+        let times: Vec<u64> = reader
+            .messages(&McapReadOptions::default())
+            .map(|message| message.expect("failed to read message").log_time)
+            .collect();
+        assert_eq!(times, (0..100).collect::<Vec<_>>());
+        let channels: Vec<_> = reader.channels().map(|c| c.topic.clone()).collect();
+        assert_eq!(channels, vec!["/topic"]);
+
+        // Seeking within the committed chunks uses their indexes.
+        let options = McapReadOptions {
+            start_time: Some(90),
+            ..Default::default()
+        };
+        assert_eq!(reader.messages(&options).count(), 10);
+
+        writer.close().expect("failed to close writer");
+        let finished = McapReader::open(&path).expect("failed to open finished file");
+        assert_eq!(
+            finished.messages(&McapReadOptions::default()).count(),
+            times.len()
+        );
+    }
+}
@@ -0,0 +1,286 @@
+//! Merging the messages of several MCAP files in log time order.
+
+use std::cmp::Reverse;
+use std::collections::{BinaryHeap, HashMap};
+use std::sync::Arc;
+
+use crate::{ChannelBuilder, Context, FoxgloveError, PartialMetadata, RawChannel, Schema};
+
+use super::{McapChannel, McapMessage, McapMessages, McapReadOptions, McapReadOrder, McapReader};
+
+/// An iterator over the messages of several MCAP files, merged in order of log time.
+///
+/// Each item is the index of the file the message was read from, in the order the readers were
+/// passed to [`McapReader::merge`], and the message. Messages with the same log time are returned
+/// in order of file index.
+///
+/// The iterator holds one cursor per file. Each cursor reads the chunks of its file as the merge
+/// reaches their time ranges, so only the chunks which overlap the current log time are held in
+/// memory, however many files are merged.
+pub struct McapMergedMessages {
+    files: Vec<McapMessages>,
+    // The next message of each file, which has not been returned yet.
+    heads: Vec<Option<McapMessage>>,
+    // The log time of each head, with the index of its file.
+    heap: BinaryHeap<Reverse<(u64, usize)>>,
+    // Files whose head has been returned, and which must be advanced.
+    advance: Vec<usize>,
+    failed: bool,
+    // The context messages are logged to, and its channel for each file and channel id.
+    context: Option<Arc<Context>>,
+    channels: HashMap<(usize, u16), Arc<RawChannel>>,
+}
+
+impl McapMergedMessages {
+    pub(super) fn new(readers: &[McapReader], options: &McapReadOptions) -> Self {
+        let options = McapReadOptions {
+            order: McapReadOrder::LogTime,
+            ..options.clone()
+        };
+        let files: Vec<_> = readers
+            .iter()
+            .map(|reader| reader.messages(&options))
+            .collect();
+        Self {
+            heads: vec![None; files.len()],
+            heap: BinaryHeap::with_capacity(files.len()),
+            advance: (0..files.len()).collect(),
+            files,
+            failed: false,
+            context: None,
+            channels: HashMap::new(),
+        }
+    }
+
+    /// Reads the next message of each file whose head has been returned.
+    fn fill(&mut self) -> Result<(), FoxgloveError> {
+        while let Some(file) = self.advance.pop() {
+            match self.files[file].next() {
+                Some(Ok(message)) => {
+                    self.heap.push(Reverse((message.log_time, file)));
+                    self.heads[file] = Some(message);
+                }
+                Some(Err(e)) => {
+                    self.failed = true;
+                    return Err(e);
+                }
+                None => (),
+            }
+        }
+        Ok(())
+    }
+
+    /// Returns the log time of the next message, without consuming it.
+    ///
+    /// Returns `None` once all messages have been read, or after an error.
+    pub fn next_log_time(&mut self) -> Result<Option<u64>, FoxgloveError> {
+        if self.failed {
+            return Ok(None);
+        }
+        self.fill()?;
+        Ok(self.heap.peek().map(|Reverse((log_time, _))| *log_time))
+    }
+
+    /// Logs all remaining messages to channels in `ctx`, with their original log times.
+    ///
+    /// Returns the number of messages logged. See [`McapMergedMessages::log_until`].
+    pub fn log_all(&mut self, ctx: &Arc<Context>) -> Result<usize, FoxgloveError> {
+        self.log(ctx, None)
+    }
+
+    /// Logs the messages logged before `end_time` to channels in `ctx`, with their original log
+    /// times.
+    ///
+    /// A channel is created in `ctx` for each channel of the files, the first time a message is
+    /// logged to it. Channels with the same topic, encoding, schema and metadata in different
+    /// files, as in rotated recordings, share a channel in the context.
+    ///
+    /// A player can call this with its playback time as it advances, to stream the files into
+    /// the context's sinks. Returns the number of messages logged.
+    pub fn log_until(&mut self, ctx: &Arc<Context>, end_time: u64) -> Result<usize, FoxgloveError> {
+        self.log(ctx, Some(end_time))
+    }
+
+    fn log(&mut self, ctx: &Arc<Context>, end_time: Option<u64>) -> Result<usize, FoxgloveError> {
+        if !self
+            .context
+            .as_ref()
+            .is_some_and(|context| Arc::ptr_eq(context, ctx))
+        {
+            self.context = Some(ctx.clone());
+            self.channels.clear();
+        }
+        let mut count = 0;
+        while let Some(log_time) = self.next_log_time()? {
+            if end_time.is_some_and(|end_time| log_time >= end_time) {
+                break;
+            }
+            let Some((file, message)) = self.next().transpose()? else {
+                break;
+            };
+            let channel = self.context_channel(ctx, file, &message.channel)?;
+            channel.log_with_meta(
+                &message.data,
+                PartialMetadata::with_log_time(message.log_time),
+            );
+            count += 1;
+        }
+        Ok(count)
+    }
+
+    fn context_channel(
+        &mut self,
+        ctx: &Arc<Context>,
+        file: usize,
+        channel: &McapChannel,
+    ) -> Result<Arc<RawChannel>, FoxgloveError> {
+        if let Some(raw) = self.channels.get(&(file, channel.id)) {
+            return Ok(raw.clone());
+        }
+        let schema = channel
+            .schema
+            .as_ref()
+            .map(|schema| Schema::new(&schema.name, &schema.encoding, schema.data.to_vec()));
+        let raw = ChannelBuilder::new(&channel.topic)
+            .context(ctx)
+            .message_encoding(&channel.message_encoding)
+            .schema(schema)
+            .metadata(channel.metadata.clone())
+            .build_raw()?;
+        self.channels.insert((file, channel.id), raw.clone());
+        Ok(raw)
+    }
+}
+
+impl Iterator for McapMergedMessages {
+    type Item = Result<(usize, McapMessage), FoxgloveError>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.failed {
+            return None;
+        }
+        if let Err(e) = self.fill() {
+            return Some(Err(e));
+        }
+        let Reverse((_, file)) = self.heap.pop()?;
+        self.advance.push(file);
+        self.heads[file].take().map(|message| Ok((file, message)))
+    }
+}
+
+impl std::fmt::Debug for McapMergedMessages {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("McapMergedMessages")
+            .field("files", &self.files.len())
+            .finish_non_exhaustive()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::collections::BTreeMap;
+    use std::io::Cursor;
+
+    use super::*;
+    use crate::testutil::RecordingSink;
+
+    /// Writes a file with a message on topic `/t` at each log time, whose data is the log time.
+    fn write_file(log_times: impl IntoIterator<Item = u64>) -> McapReader {
+        let mut writer = mcap::WriteOptions::default()
+            .chunk_size(Some(128))
+            .create(Cursor::new(Vec::new()))
+            .expect("failed to create writer");
+        let schema_id = writer
+            .add_schema("Schema", "jsonschema", b"{}")
+            .expect("failed to add schema");
+        let channel_id = writer
+            .add_channel(schema_id, "/t", "json", &BTreeMap::new())
+            .expect("failed to add channel");
+        for (sequence, log_time) in log_times.into_iter().enumerate() {
+            let header = mcap::records::MessageHeader {
+                channel_id,
+                sequence: sequence as u32,
+                log_time,
+                publish_time: log_time,
+            };
+            writer
+                .write_to_known_channel(&header, log_time.to_string().as_bytes())
+                .expect("failed to write message");
+        }
+        writer.finish().expect("failed to finish");
+        McapReader::from_bytes(writer.into_inner().into_inner()).expect("failed to open")
+    }
+
+    /// Returns files which interleave: file `i` of `count` holds the times equal to `i` modulo
+    /// `count`, and a rotated segment holds the times after them.
+    fn write_files(count: u64) -> Vec<McapReader> {
+        let mut readers: Vec<_> = (0..count)
+            .map(|i| write_file((0..100).map(|n| n * count + i)))
+            .collect();
+        readers.push(write_file(100 * count..110 * count));
+        readers
+    }
+
+    #[test]
+    fn test_merge_in_log_time_order() {
+        let readers = write_files(20);
+        let messages: Vec<_> = McapReader::merge(&readers, &McapReadOptions::default())
+            .map(|message| message.expect("failed to read message"))
+            .collect();
+        assert_eq!(messages.len(), 2200);
+        for (expected, (file, message)) in messages.iter().enumerate() {
+            assert_eq!(message.log_time, expected as u64);
+            assert_eq!(message.data, message.log_time.to_string().as_bytes());
+            let expected_file = if expected < 2000 { expected % 20 } else { 20 };
+            assert_eq!(*file, expected_file);
+        }
+    }
+
+    #[test]
+    fn test_merge_applies_options() {
+        let readers = write_files(4);
+        let options = McapReadOptions {
+            start_time: Some(10),
+            end_time: Some(20),
+            order: McapReadOrder::File,
+            ..Default::default()
+        };
+        let log_times: Vec<_> = McapReader::merge(&readers, &options)
+            .map(|message| message.expect("failed to read message").1.log_time)
+            .collect();
+        assert_eq!(log_times, (10..20).collect::<Vec<_>>());
+
+        let options = McapReadOptions {
+            topics: Some(vec![]),
+            ..Default::default()
+        };
+        assert_eq!(McapReader::merge(&readers, &options).count(), 0);
+    }
+
+    #[test]
+    fn test_log_until() {
+        let readers = write_files(3);
+        let ctx = Context::new();
+        let sink = Arc::new(RecordingSink::new());
+        ctx.add_sink(sink.clone());
+
+        let mut merged = McapReader::merge(&readers, &McapReadOptions::default());
+        assert_eq!(merged.next_log_time().expect("failed to read"), Some(0));
+        assert_eq!(merged.log_until(&ctx, 50).expect("failed to log"), 50);
+        assert_eq!(merged.next_log_time().expect("failed to read"), Some(50));
+        assert_eq!(merged.log_all(&ctx).expect("failed to log"), 280);
+        assert_eq!(merged.next_log_time().expect("failed to read"), None);
+
+        let logged = sink.take_messages();
+        assert_eq!(logged.len(), 330);
+        for (expected, call) in logged.iter().enumerate() {
+            assert_eq!(call.metadata.log_time, expected as u64);
+            assert_eq!(call.msg, expected.to_string().as_bytes());
+            assert_eq!(call.channel_id, logged[0].channel_id);
+        }
+        let channel = ctx
+            .get_channel_by_topic("/t")
+            .expect("channel was not created");
+        assert_eq!(channel.message_encoding(), "json");
+    }
+}
@@ -0,0 +1,166 @@
+//! Reading of the summary section of an MCAP file.
+use std::collections::BTreeMap;
+use std::sync::Arc;
+
+use bytes::Bytes;
+
+use crate::FoxgloveError;
+use crate::mcap_reader::chunk::Dictionaries;
+use crate::mcap_reader::{McapChannel, McapSchema};
+use crate::mcap_writer::MCAP_ZSTD_DICTIONARY_MEDIA_TYPE;
+use crate::mcap_writer::records::{MAGIC, RECORD_PREFIX_LEN, RecordReader, op, split_record};
+
+/// Length of a footer record, including its opcode and length prefix.
+const FOOTER_LEN: usize = RECORD_PREFIX_LEN as usize + 20;
+
+/// A range of the file which is read as a unit.
+#[derive(Clone)]
+pub(crate) struct ChunkEntry {
+    pub message_start_time: u64,
+    pub message_end_time: u64,
+    pub offset: u64,
+    pub length: u64,
+    /// Channels with messages in the chunk, or empty if the chunk has no message indexes.
+    pub channels: Vec<u16>,
+    /// True if the range holds data section records rather than a single chunk record.
+    pub records: bool,
+}
+
+pub(crate) struct Summary {
+    pub channels: BTreeMap<u16, Arc<McapChannel>>,
+    pub chunks: Vec<ChunkEntry>,
+    pub dictionaries: Dictionaries,
+}
+
+/// Reads the summary section of the MCAP file in `data`.
+pub(crate) fn read_summary(data: &Bytes) -> Result<Summary, FoxgloveError> {
+    let len = data.len();
+    if len < 2 * MAGIC.len() + FOOTER_LEN
+        || &data[..MAGIC.len()] != MAGIC
+        || &data[len - MAGIC.len()..] != MAGIC
+        || data[len - MAGIC.len() - FOOTER_LEN] != op::FOOTER
+    {
+        return Err(FoxgloveError::ValueError(
+            "not a finished MCAP file; unfinished recordings can be repaired with recover_mcap"
+                .to_string(),
+        ));
+    }
+    let footer_offset = len - MAGIC.len() - FOOTER_LEN;
+    let mut footer = RecordReader::new(&data[footer_offset + RECORD_PREFIX_LEN as usize..]);
+    let summary_start = footer.u64()?;
+    let summary_offset_start = footer.u64()?;
+    if summary_start == 0 {
+        return Err(FoxgloveError::ValueError(
+            "MCAP file has no summary section".to_string(),
+        ));
+    }
+    let summary_end = if summary_offset_start == 0 {
+        footer_offset as u64
+    } else {
+        summary_offset_start
+    };
+    let section = range(
+        data,
+        summary_start,
+        summary_end.saturating_sub(summary_start),
+    )?;
+
+    let mut schemas = BTreeMap::new();
+    let mut channels = Vec::new();
+    let mut chunks = Vec::new();
+    let mut dictionaries = Dictionaries::default();
+    let mut rest = section;
+    while let Some((opcode, body)) = split_record(rest) {
+        rest = &rest[RECORD_PREFIX_LEN as usize + body.len()..];
+        let mut fields = RecordReader::new(body);
+        match opcode {
+            op::SCHEMA => {
+                let schema = McapSchema {
+                    id: fields.u16()?,
+                    name: fields.str()?,
+                    encoding: fields.str()?,
+                    data: data.slice_ref(fields.bytes()?),
+                };
+                schemas.insert(schema.id, Arc::new(schema));
+            }
+            op::CHANNEL => channels.push(fields.channel()?),
+            op::CHUNK_INDEX => {
+                let message_start_time = fields.u64()?;
+                let message_end_time = fields.u64()?;
+                let offset = fields.u64()?;
+                let length = fields.u64()?;
+                let mut index_offsets = RecordReader::new(fields.bytes()?);
+                let mut chunk_channels = Vec::new();
+                while !index_offsets.remaining().is_empty() {
+                    chunk_channels.push(index_offsets.u16()?);
+                    let _offset = index_offsets.u64()?;
+                }
+                chunks.push(ChunkEntry {
+                    message_start_time,
+                    message_end_time,
+                    offset,
+                    length,
+                    channels: chunk_channels,
+                    records: false,
+                });
+            }
+            op::ATTACHMENT_INDEX => {
+                let offset = fields.u64()?;
+                let length = fields.u64()?;
+                let _log_time = fields.u64()?;
+                let _create_time = fields.u64()?;
+                let _data_size = fields.u64()?;
+                let _name = fields.str()?;
+                if fields.str()? == MCAP_ZSTD_DICTIONARY_MEDIA_TYPE {
+                    dictionaries.add_attachment(range(data, offset, length)?)?;
+                }
+            }
+            _ => (),
+        }
+    }
+
+    let channels = channels
+        .into_iter()
+        .map(|channel| {
+            let channel = McapChannel {
+                id: channel.id,
+                topic: channel.topic,
+                message_encoding: channel.message_encoding,
+                metadata: channel.metadata,
+                schema: schemas.get(&channel.schema_id).cloned(),
+            };
+            (channel.id, Arc::new(channel))
+        })
+        .collect();
+    if chunks.is_empty() {
+        // Without chunk indexes, the whole data section is read, including any chunks in it.
+        let offset = MAGIC.len() as u64;
+        chunks.push(ChunkEntry {
+            message_start_time: 0,
+            message_end_time: u64::MAX,
+            offset,
+            length: summary_start.saturating_sub(offset),
+            channels: Vec::new(),
+            records: true,
+        });
+    }
+    chunks.sort_by_key(|chunk| chunk.offset);
+    Ok(Summary {
+        channels,
+        chunks,
+        dictionaries,
+    })
+}
+
+/// Returns `length` bytes of the file starting at `offset`.
+pub(crate) fn range(data: &[u8], offset: u64, length: u64) -> Result<&[u8], FoxgloveError> {
+    usize::try_from(offset)
+        .ok()
+        .zip(usize::try_from(length).ok())
+        .and_then(|(offset, length)| data.get(offset..offset.checked_add(length)?))
+        .ok_or_else(|| {
+            FoxgloveError::ValueError(format!(
+                "MCAP record at offset {offset} extends past the end of the file"
+            ))
+        })
+}
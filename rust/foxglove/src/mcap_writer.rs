@@ -1,14 +1,19 @@
 //! MCAP writer
 
 use std::fs::File;
-use std::io::{BufWriter, Seek};
-use std::path::Path;
+use std::io::{BufWriter, Read, Seek};
+use std::path::{Path, PathBuf};
 use std::sync::{Arc, Weak};
+use std::time::Duration;
 use std::{fmt::Debug, io::Write};
 
 use crate::library_version::get_library_identifier;
+use crate::message_filter::MessageFilterFn;
 use crate::sink_channel_filter::SinkChannelFilterFn;
-use crate::{ChannelDescriptor, Context, FoxgloveError, Sink, SinkChannelFilter};
+use crate::{
+    ChannelDescriptor, Context, FilterAction, FoxgloveError, McapChunkCommit, MemoryPool,
+    MessageFilter, Metadata, Sink, SinkChannelFilter, SinkId,
+};
 
 /// An attachment to store in an MCAP file.
 ///
@@ -20,9 +25,88 @@ pub use mcap::Attachment as McapAttachment;
 pub use mcap::Compression as McapCompression;
 /// Options for use with an [`McapWriter`][crate::McapWriter].
 pub use mcap::WriteOptions as McapWriteOptions;
+/// The fields of an attachment other than its data, for
+/// [`McapWriterHandle::attach_reader`].
+pub use mcap::records::AttachmentHeader as McapAttachmentHeader;
 
+mod adaptive_chunks;
+mod channel_grouping;
+mod checkpoint;
+mod chunk_streams;
+mod compression_policy;
+#[cfg(target_os = "linux")]
+mod direct_file;
 mod mcap_sink;
+mod pipelined_writer;
+#[cfg(target_os = "linux")]
+mod preallocated_file;
+pub(crate) mod records;
+mod recovery;
+mod rotation;
+mod sparse_index;
+mod summary;
+mod write_queue;
+mod zstd_dictionary;
+use adaptive_chunks::AdaptiveChunks;
+pub use adaptive_chunks::McapAdaptiveChunks;
+pub use channel_grouping::McapChannelGrouping;
+use channel_grouping::McapChannelGroupingFn;
+use checkpoint::{Checkpoint, journal_path};
+use chunk_streams::ChunkStreamOptions;
+use compression_policy::McapCompressionPolicyFn;
+pub use compression_policy::{McapChunkCompression, McapCompressionPolicy};
+#[cfg(target_os = "linux")]
+pub use direct_file::McapDirectFile;
 use mcap_sink::McapSink;
+#[cfg(target_os = "linux")]
+pub use preallocated_file::McapPreallocatedFile;
+pub use recovery::recover_mcap;
+pub use rotation::McapRotation;
+use rotation::{SEGMENT_INDEX_PLACEHOLDER, segment_path};
+pub use sparse_index::McapSparseIndex;
+pub use zstd_dictionary::{MCAP_ZSTD_DICTIONARY_MEDIA_TYPE, McapZstdDictionary};
+
+/// What an asynchronous [`McapWriter`] does when its queue is full.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum McapOverflowPolicy {
+    /// Block the logging thread until the writer thread makes room in the queue.
+    #[default]
+    Block,
+    /// Drop the message being logged.
+    DropNewest,
+    /// Drop the oldest queued message to make room for the message being logged.
+    DropOldest,
+}
+
+/// Options for an [`McapWriter`] that writes on a background thread.
+///
+/// See [`McapWriter::async_writes`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct McapAsyncOptions {
+    /// Maximum number of messages waiting to be written. Values less than 1 are treated as 1.
+    pub queue_capacity: usize,
+    /// What to do when a message is logged while the queue is full, or while the context's
+    /// [memory budget][crate::MemoryBudget] is exceeded.
+    pub overflow_policy: McapOverflowPolicy,
+}
+
+impl Default for McapAsyncOptions {
+    fn default() -> Self {
+        Self {
+            queue_capacity: 1024,
+            overflow_policy: McapOverflowPolicy::default(),
+        }
+    }
+}
+
+/// Statistics for an [`McapWriterHandle`].
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct McapWriterStats {
+    /// Number of logged messages which have not been written yet.
+    pub queue_depth: usize,
+    /// Number of messages dropped because the queue was full.
+    pub dropped_messages: u64,
+}
 
 /// An MCAP writer for logging events.
 ///
@@ -36,6 +120,14 @@ pub struct McapWriter {
     options: McapWriteOptions,
     context: Arc<Context>,
     channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+    message_filter: Option<Arc<dyn MessageFilter>>,
+    async_options: Option<McapAsyncOptions>,
+    pipeline_depth: usize,
+    rotation: Option<McapRotation>,
+    checkpoint_interval: Option<Duration>,
+    checkpoint_journal: Option<PathBuf>,
+    adaptive_chunks: Option<McapAdaptiveChunks>,
+    chunk_streams: ChunkStreamOptions,
 }
 
 impl Debug for McapWriter {
@@ -43,6 +135,13 @@ impl Debug for McapWriter {
         f.debug_struct("McapWriter")
             .field("options", &self.options)
             .field("context", &self.context)
+            .field("async_options", &self.async_options)
+            .field("pipeline_depth", &self.pipeline_depth)
+            .field("rotation", &self.rotation)
+            .field("checkpoint_interval", &self.checkpoint_interval)
+            .field("checkpoint_journal", &self.checkpoint_journal)
+            .field("adaptive_chunks", &self.adaptive_chunks)
+            .field("zstd_dictionary", &self.chunk_streams.dictionary)
             .finish_non_exhaustive()
     }
 }
@@ -58,6 +157,14 @@ impl From<McapWriteOptions> for McapWriter {
             options,
             context: Context::get_default(),
             channel_filter: None,
+            message_filter: None,
+            async_options: None,
+            pipeline_depth: 0,
+            rotation: None,
+            checkpoint_interval: None,
+            checkpoint_journal: None,
+            adaptive_chunks: None,
+            chunk_streams: ChunkStreamOptions::default(),
         }
     }
 }
@@ -102,16 +209,265 @@ impl McapWriter {
         self
     }
 
+    /// Sets a [`MessageFilter`] which runs on each message before it is written to this file.
+    ///
+    /// This lets the file record channels with a different policy than other sinks in the same
+    /// context, for example at a lower rate with a [`RateLimitFilter`][crate::RateLimitFilter].
+    pub fn message_filter(mut self, filter: Arc<dyn MessageFilter>) -> Self {
+        self.message_filter = Some(filter);
+        self
+    }
+
+    /// Sets a message filter for this file. See [`MessageFilter`] for more information.
+    pub fn message_filter_fn(
+        mut self,
+        filter: impl Fn(&ChannelDescriptor, &[u8], &Metadata) -> FilterAction + Sync + Send + 'static,
+    ) -> Self {
+        self.message_filter = Some(Arc::new(MessageFilterFn(filter)));
+        self
+    }
+
+    /// Writes messages on a dedicated background thread.
+    ///
+    /// Logging a message copies it into a bounded queue and returns, leaving serialization,
+    /// compression, and I/O to the writer thread. This keeps slow storage from stalling the
+    /// logging thread. When the queue is full, the [`McapOverflowPolicy`] decides whether to
+    /// block or drop messages; see [`McapWriterHandle::stats`] for the number dropped.
+    ///
+    /// Errors writing messages on the background thread are reported as warnings.
+    pub fn async_writes(mut self, options: McapAsyncOptions) -> Self {
+        self.async_options = Some(options);
+        self
+    }
+
+    /// Writes completed chunks on a dedicated I/O thread.
+    ///
+    /// The next chunk is filled and compressed while earlier ones are still being written, with
+    /// up to `depth` blocks of output queued before writes block. This applies to both Zstd and
+    /// LZ4 compression, and can be combined with [`McapWriter::async_writes`] to keep
+    /// compression off the logging thread as well. A depth of 0 (the default) disables the I/O
+    /// thread.
+    pub fn pipeline_depth(mut self, depth: usize) -> Self {
+        self.pipeline_depth = depth;
+        self
+    }
+
+    /// Splits the recording into segments, according to the provided policy.
+    ///
+    /// Each segment is a complete MCAP file, with its own schemas, channels, and summary, so a
+    /// crash only loses the segment being written. The next segment is opened before the previous
+    /// one is finished, so no messages are lost during rotation.
+    ///
+    /// Use with [`McapWriter::create_new_buffered_file`], where the path becomes a template, or
+    /// with [`McapWriter::create_rotating`].
+    pub fn rotation(mut self, rotation: McapRotation) -> Self {
+        self.rotation = Some(rotation);
+        self
+    }
+
+    /// Finishes the current chunk and flushes it to the writer at least this often.
+    ///
+    /// If the process exits without closing the writer, at most one interval of messages is
+    /// lost, and the rest of the file can be made readable with [`recover_mcap`]. Flushing more
+    /// often may reduce compression, since chunks are smaller.
+    ///
+    /// For files created with [`McapWriter::create_new_buffered_file`] without rotation, this
+    /// also enables a [checkpoint journal][McapWriter::checkpoint_journal] next to the file.
+    pub fn checkpoint_interval(mut self, interval: Duration) -> Self {
+        self.checkpoint_interval = Some(interval);
+        self
+    }
+
+    /// Records schemas and channels in a sidecar journal file at `path` as they are added.
+    ///
+    /// Chunked recordings declare schemas and channels inside compressed chunks. With a journal,
+    /// [`recover_mcap`] can rebuild a summary without decompressing any chunks. The journal
+    /// must be at the MCAP file's path with `.checkpoint` appended for recovery to find it, and
+    /// is removed when the writer is closed.
+    ///
+    /// Not supported with [rotation][McapWriter::rotation].
+    pub fn checkpoint_journal(mut self, path: impl Into<PathBuf>) -> Self {
+        self.checkpoint_journal = Some(path.into());
+        self
+    }
+
+    /// Chooses chunk boundaries from the observed throughput and compression ratio, instead of
+    /// finishing chunks at a fixed `chunk_size`.
+    ///
+    /// A chunk is finished once its oldest message has waited
+    /// [`max_age`][McapAdaptiveChunks::max_age], so channels with low message rates don't leave
+    /// chunks open for minutes, or once it reaches a size target chosen from the chunks written so
+    /// far, so that high-rate channels fill larger chunks which compress better. See
+    /// [`McapAdaptiveChunks`] for how the target is chosen.
+    ///
+    /// This overrides the `chunk_size` of the write options. As with
+    /// [`checkpoint_interval`][McapWriter::checkpoint_interval], the underlying writer is flushed
+    /// whenever a chunk is finished.
+    pub fn adaptive_chunks(mut self, options: McapAdaptiveChunks) -> Self {
+        // Chunks are only finished when the policy calls for it.
+        self.options = self.options.chunk_size(None);
+        self.adaptive_chunks = Some(options);
+        self
+    }
+
+    /// Sets a [`McapCompressionPolicy`], which chooses how each channel's chunks are compressed.
+    ///
+    /// Channels are written to a separate stream of chunks for each compression, so that, for
+    /// example, compressed video is not compressed again while JSON channels still are.
+    /// Channels for which the policy returns `None` use the writer's compression.
+    ///
+    /// With a policy, the writer builds its own summary section, which always includes
+    /// statistics and all indexes, and does not include data section or summary CRCs.
+    pub fn compression_policy(mut self, policy: Arc<dyn McapCompressionPolicy>) -> Self {
+        self.chunk_streams.policy = Some(policy);
+        self
+    }
+
+    /// Sets a compression policy for this file. See [`McapCompressionPolicy`] for more
+    /// information.
+    pub fn compression_policy_fn(
+        mut self,
+        policy: impl Fn(&ChannelDescriptor) -> Option<McapChunkCompression> + Sync + Send + 'static,
+    ) -> Self {
+        self.chunk_streams.policy = Some(Arc::new(McapCompressionPolicyFn(policy)));
+        self
+    }
+
+    /// Sets a [`McapChannelGrouping`], which chooses the group of chunks holding each channel's
+    /// messages.
+    ///
+    /// Each group is written to a separate stream of chunks, which are finished independently,
+    /// so each chunk only holds messages from one group. Readers which select a few topics, such
+    /// as [`McapReader`][crate::McapReader], then only decompress the chunks of their groups.
+    /// Channels in group 0 share the writer's default chunks.
+    ///
+    /// Every group holds up to `chunk_size` bytes in memory, and chunks of different groups
+    /// overlap in time. As with a compression policy, the writer builds its own summary section.
+    pub fn channel_grouping(mut self, grouping: Arc<dyn McapChannelGrouping>) -> Self {
+        self.chunk_streams.grouping = Some(grouping);
+        self
+    }
+
+    /// Sets a channel grouping for this file. See [`McapChannelGrouping`] for more information.
+    pub fn channel_grouping_fn(
+        mut self,
+        grouping: impl Fn(&ChannelDescriptor) -> u32 + Sync + Send + 'static,
+    ) -> Self {
+        self.chunk_streams.grouping = Some(Arc::new(McapChannelGroupingFn(grouping)));
+        self
+    }
+
+    /// Compresses the chunks of small messages with zstd dictionaries trained from the
+    /// recording.
+    ///
+    /// A dictionary is trained for each schema from its first
+    /// [`training_messages`][McapZstdDictionary::training_messages] messages, which are written
+    /// as usual. The dictionary is then stored in an attachment named after the schema, with the
+    /// media type [`MCAP_ZSTD_DICTIONARY_MEDIA_TYPE`], and later chunks holding the schema's
+    /// messages are compressed with it. Since the dictionary carries much of what the messages
+    /// have in common, a small `chunk_size` can be used, for example to keep the latency of a
+    /// live tail low, without losing compression ratio.
+    ///
+    /// This applies to channels with a schema which use the writer's compression, or zstd from
+    /// the [compression policy][McapWriter::compression_policy]. Their dictionary-compressed
+    /// chunks always use zstd, whatever the writer's compression.
+    ///
+    /// Dictionary-compressed chunks have `zstd` compression, and each zstd frame records the id
+    /// of its dictionary. Readers must load the dictionaries from the file's attachments to
+    /// decompress these chunks, and other readers will fail to read them. As with a
+    /// compression policy, the writer builds its own summary section.
+    ///
+    /// Requires the `zstd` feature.
+    pub fn zstd_dictionary(mut self, options: McapZstdDictionary) -> Self {
+        self.chunk_streams.dictionary = Some(options);
+        self
+    }
+
+    /// Writes sparse message indexes, which only index some of the messages of each channel.
+    ///
+    /// A message index normally has an entry for every message in a chunk, so for a channel with
+    /// a very high message rate, the indexes can be larger than the data they index. With a
+    /// sparse index, each channel's index for a chunk keeps its first entry, and then one entry
+    /// every [`every_messages`][McapSparseIndex::every_messages] messages or
+    /// [`every_nanos`][McapSparseIndex::every_nanos] nanoseconds of log time, whichever comes
+    /// first. Channels with a low message rate keep every entry if `every_nanos` is shorter than
+    /// the interval between their messages.
+    ///
+    /// The chunk indexes and statistics are unchanged, so readers which read whole chunks, or
+    /// which use message indexes only to locate the first message in a time range and scan
+    /// forward from it, read every message. Readers which only read the messages listed in the
+    /// message indexes miss the others. As with a compression policy, the writer builds its own
+    /// summary section.
+    pub fn sparse_message_index(mut self, options: McapSparseIndex) -> Self {
+        self.chunk_streams.sparse_index = Some(options);
+        self
+    }
+
+    /// Calls `f` with each chunk once it has been written to the file, so that the file can be
+    /// read while it is being written.
+    ///
+    /// After each chunk and its message indexes are written, the underlying writer is flushed,
+    /// and `f` is called with an [`McapChunkCommit`], which describes the chunk and the length of
+    /// the part of the file which will not change. Pass the commits to an [`McapLiveReader`][crate::McapLiveReader] to
+    /// read the completed chunks while the recording continues.
+    ///
+    /// `f` is called on the thread which writes the file, and should return quickly. Flushing
+    /// after every chunk means more, smaller writes; use a larger chunk size if that matters. As
+    /// with a compression policy, the writer builds its own summary section.
+    ///
+    /// Not supported with [rotation][McapWriter::rotation].
+    pub fn chunk_commit_fn(mut self, f: impl Fn(&McapChunkCommit) + Send + Sync + 'static) -> Self {
+        self.chunk_streams.on_commit = Some(Arc::new(f));
+        self
+    }
+
+    /// Creates the checkpoint state for a new sink, if checkpoints are enabled.
+    fn checkpoint(&self) -> Result<Option<Checkpoint>, FoxgloveError> {
+        if self.checkpoint_interval.is_none() && self.checkpoint_journal.is_none() {
+            return Ok(None);
+        }
+        let checkpoint =
+            Checkpoint::new(self.checkpoint_interval, self.checkpoint_journal.as_deref())?;
+        Ok(Some(checkpoint))
+    }
+
     /// Begins logging events to the specified writer.
     ///
     /// Returns a handle. When the handle is dropped, the recording will be flushed to the writer
     /// and closed. Alternatively, the caller may choose to call [`McapWriterHandle::close`] to
     /// manually flush the recording and recover the writer.
+    ///
+    /// Returns [`FoxgloveError::ValueError`] if a [rotation policy][McapWriter::rotation] was set,
+    /// since only one writer is provided.
     pub fn create<W>(self, writer: W) -> Result<McapWriterHandle<W>, FoxgloveError>
     where
         W: Write + Seek + Send + 'static,
     {
-        let sink = McapSink::new(writer, self.options, self.channel_filter)?;
+        if self.rotation.is_some() {
+            return Err(FoxgloveError::ValueError(
+                "MCAP rotation requires create_rotating or create_new_buffered_file".to_string(),
+            ));
+        }
+        let checkpoint = self.checkpoint()?;
+        let sink = McapSink::new_threaded(
+            writer,
+            self.options,
+            self.channel_filter,
+            self.async_options.as_ref(),
+            self.context.memory_account(MemoryPool::Mcap),
+            self.pipeline_depth,
+            None,
+            self.chunk_streams,
+        )?;
+        if let Some(checkpoint) = checkpoint {
+            sink.set_checkpoint(checkpoint);
+        }
+        if let Some(options) = self.adaptive_chunks {
+            sink.set_adaptive_chunks(AdaptiveChunks::new(options));
+        }
+        if let Some(filter) = self.message_filter {
+            sink.set_message_filter(filter);
+        }
         self.context.add_sink(sink.clone());
         Ok(McapWriterHandle {
             sink,
@@ -126,6 +482,10 @@ impl McapWriter {
     ///
     /// If you want more control over how the file is opened, or you want to write to something
     /// other than a file, use [`McapWriter::create`].
+    ///
+    /// If a [rotation policy][McapWriter::rotation] was set, `path` is a template which must
+    /// contain `{index}`. Each segment is written to the path with `{index}` replaced by the
+    /// segment number, starting from 0.
     pub fn create_new_buffered_file<P>(
         self,
         path: P,
@@ -133,9 +493,86 @@ impl McapWriter {
     where
         P: AsRef<Path>,
     {
-        let file = File::create_new(path)?;
-        let writer = BufWriter::new(file);
-        self.create(writer)
+        if self.rotation.is_none() {
+            let file = File::create_new(&path)?;
+            let writer = BufWriter::new(file);
+            let mut builder = self;
+            if builder.checkpoint_interval.is_some() && builder.checkpoint_journal.is_none() {
+                builder.checkpoint_journal = Some(journal_path(path.as_ref()));
+            }
+            return builder.create(writer);
+        }
+        let template = path
+            .as_ref()
+            .to_str()
+            .ok_or_else(|| FoxgloveError::Utf8Error("path template is not UTF-8".to_string()))?
+            .to_string();
+        if !template.contains(SEGMENT_INDEX_PLACEHOLDER) {
+            return Err(FoxgloveError::ValueError(format!(
+                "path template must contain {SEGMENT_INDEX_PLACEHOLDER}"
+            )));
+        }
+        self.create_rotating(move |index| {
+            let file = File::create_new(segment_path(&template, index))?;
+            Ok(BufWriter::new(file))
+        })
+    }
+
+    /// Begins logging events to a sequence of segments.
+    ///
+    /// `open_segment` is called with the index of each segment, starting from 0, and returns the
+    /// writer for that segment. Segments are rotated according to the policy set with
+    /// [`McapWriter::rotation`]; if none was set, only the first segment is written.
+    ///
+    /// [`McapWriterHandle::close`] returns the writer for the last segment. Writers for earlier
+    /// segments are finished, flushed, and dropped as each segment is rotated.
+    pub fn create_rotating<W, F>(
+        self,
+        mut open_segment: F,
+    ) -> Result<McapWriterHandle<W>, FoxgloveError>
+    where
+        W: Write + Seek + Send + 'static,
+        F: FnMut(u32) -> Result<W, FoxgloveError> + Send + 'static,
+    {
+        if self.rotation.is_some() && self.checkpoint_journal.is_some() {
+            return Err(FoxgloveError::ValueError(
+                "MCAP checkpoint journals are not supported with rotation".to_string(),
+            ));
+        }
+        if self.rotation.is_some() && self.chunk_streams.on_commit.is_some() {
+            return Err(FoxgloveError::ValueError(
+                "MCAP chunk commit callbacks are not supported with rotation".to_string(),
+            ));
+        }
+        let checkpoint = self.checkpoint()?;
+        let writer = open_segment(0)?;
+        let rotation = self
+            .rotation
+            .map(|policy| (policy, Box::new(open_segment) as mcap_sink::SegmentFn<W>));
+        let sink = McapSink::new_threaded(
+            writer,
+            self.options,
+            self.channel_filter,
+            self.async_options.as_ref(),
+            self.context.memory_account(MemoryPool::Mcap),
+            self.pipeline_depth,
+            rotation,
+            self.chunk_streams,
+        )?;
+        if let Some(checkpoint) = checkpoint {
+            sink.set_checkpoint(checkpoint);
+        }
+        if let Some(options) = self.adaptive_chunks {
+            sink.set_adaptive_chunks(AdaptiveChunks::new(options));
+        }
+        if let Some(filter) = self.message_filter {
+            sink.set_message_filter(filter);
+        }
+        self.context.add_sink(sink.clone());
+        Ok(McapWriterHandle {
+            sink,
+            context: Arc::downgrade(&self.context),
+        })
     }
 }
 
@@ -169,10 +606,26 @@ impl<W: Write + Seek + Send + 'static> McapWriterHandle<W> {
     ///
     /// Note that compression ratios tend to improve over the lifetime of a chunk, so flushing
     /// frequently with chunked output may reduce overall compression.
+    ///
+    /// For an asynchronous writer, this first waits for all queued messages to be written.
     pub fn flush(&self) -> Result<(), FoxgloveError> {
         self.sink.flush()
     }
 
+    /// Returns the writer's queue depth and the number of dropped messages.
+    ///
+    /// Both are always zero unless the writer was created with [`McapWriter::async_writes`].
+    pub fn stats(&self) -> McapWriterStats {
+        self.sink.stats()
+    }
+
+    /// Returns the writer's sink ID.
+    ///
+    /// Messages logged with this sink ID are written only to this file, and not to other sinks.
+    pub fn sink_id(&self) -> SinkId {
+        self.sink.id()
+    }
+
     /// Writes MCAP metadata to the file.
     ///
     /// If the metadata map is empty, this method returns early without writing anything.
@@ -217,6 +670,46 @@ impl<W: Write + Seek + Send + 'static> McapWriterHandle<W> {
     pub fn attach(&self, attachment: &McapAttachment<'_>) -> Result<(), FoxgloveError> {
         self.sink.attach(attachment)
     }
+
+    /// Writes an attachment whose data is streamed from a reader.
+    ///
+    /// Exactly `length` bytes are read from `data`, and copied to the file in blocks, so large
+    /// attachments such as map archives or calibration bundles never need to be held in memory.
+    /// The attachment's CRC is computed as the data is copied. Messages logged while the data is
+    /// being copied wait until the attachment has been written.
+    ///
+    /// If reading fails or `data` ends before `length` bytes, the rest of the attachment is
+    /// filled with zeros so that the file remains valid, and the error is returned.
+    ///
+    /// # Example
+    /// ```no_run
+    /// use std::fs::File;
+    /// use foxglove::{McapAttachmentHeader, McapWriter};
+    ///
+    /// let mcap = McapWriter::new()
+    ///     .create_new_buffered_file("test.mcap")
+    ///     .expect("create failed");
+    ///
+    /// let file = File::open("tiles.tar").expect("open failed");
+    /// let length = file.metadata().expect("metadata failed").len();
+    /// let header = McapAttachmentHeader {
+    ///     log_time: 0,
+    ///     create_time: 0,
+    ///     name: "tiles.tar".to_string(),
+    ///     media_type: "application/x-tar".to_string(),
+    /// };
+    /// mcap.attach_reader(&header, length, file).expect("attach failed");
+    ///
+    /// mcap.close().expect("close failed");
+    /// ```
+    pub fn attach_reader(
+        &self,
+        header: &McapAttachmentHeader,
+        length: u64,
+        mut data: impl Read,
+    ) -> Result<(), FoxgloveError> {
+        self.sink.attach_reader(header, length, &mut data)
+    }
 }
 
 impl<W: Write + Seek + Send + 'static> Drop for McapWriterHandle<W> {
@@ -257,4 +750,235 @@ mod tests {
         assert_eq!(tokens[1], mcap::LIBRARY_IDENTIFIER);
         assert!(tokens[1].starts_with("mcap-rust/"));
     }
+
+    #[test]
+    fn test_rotation_writes_complete_segments() {
+        let ctx = Context::new();
+        let channel = crate::ChannelBuilder::new("/topic")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .expect("failed to create channel");
+
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let template = dir.path().join("segment-{index}.mcap");
+        // Every write exceeds the limit, so each message ends up in its own segment.
+        let writer = McapWriter::new()
+            .context(&ctx)
+            .rotation(McapRotation {
+                max_bytes: Some(1),
+                max_duration: None,
+            })
+            .create_new_buffered_file(&template)
+            .expect("failed to create writer");
+        for i in 0..3_u8 {
+            channel.log(&[b'0' + i]);
+        }
+        writer.close().expect("failed to close writer");
+
+        let mut payloads = vec![];
+        for index in 0..4 {
+            let path = dir.path().join(format!("segment-{index}.mcap"));
+            let summary = crate::testutil::read_summary(&path);
+            assert_eq!(summary.channels.len(), 1);
+            let contents = std::fs::read(&path).expect("failed to read segment");
+            for message in mcap::MessageStream::new(&contents).expect("failed to read messages") {
+                payloads.push(message.expect("invalid message").data.to_vec());
+            }
+        }
+        assert!(!dir.path().join("segment-4.mcap").exists());
+        assert_eq!(payloads, vec![b"0".to_vec(), b"1".to_vec(), b"2".to_vec()]);
+    }
+
+    #[test]
+    fn test_rotation_repeats_latched_messages() {
+        let ctx = Context::new();
+        let latched = crate::ChannelBuilder::new("/latched")
+            .context(&ctx)
+            .message_encoding("json")
+            .keep_last(1)
+            .build_raw()
+            .expect("failed to create channel");
+        let channel = crate::ChannelBuilder::new("/topic")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .expect("failed to create channel");
+        latched.log(b"static");
+
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let template = dir.path().join("segment-{index}.mcap");
+        let writer = McapWriter::new()
+            .context(&ctx)
+            .rotation(McapRotation {
+                max_bytes: Some(1),
+                max_duration: None,
+            })
+            .create_new_buffered_file(&template)
+            .expect("failed to create writer");
+        for i in 0..2_u8 {
+            channel.log(&[b'0' + i]);
+        }
+        writer.close().expect("failed to close writer");
+
+        // The writer receives the latched message when it's added, and each segment begins with
+        // it.
+        let mut segments = vec![];
+        for index in 0..4 {
+            let path = dir.path().join(format!("segment-{index}.mcap"));
+            let contents = std::fs::read(&path).expect("failed to read segment");
+            let payloads: Vec<_> = mcap::MessageStream::new(&contents)
+                .expect("failed to read messages")
+                .map(|message| message.expect("invalid message").data.to_vec())
+                .collect();
+            segments.push(payloads);
+        }
+        assert_eq!(
+            segments,
+            vec![
+                vec![b"static".to_vec()],
+                vec![b"static".to_vec(), b"0".to_vec()],
+                vec![b"static".to_vec(), b"1".to_vec()],
+                vec![b"static".to_vec()],
+            ]
+        );
+    }
+
+    /// Logs three messages with a checkpoint after each, and copies the file before closing the
+    /// writer, as if the process had exited.
+    fn write_unfinished_recording(dir: &Path, builder: McapWriter) -> PathBuf {
+        let ctx = Context::new();
+        let channel = crate::ChannelBuilder::new("/topic")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .expect("failed to create channel");
+        let path = dir.join("recording.mcap");
+        let writer = builder
+            .context(&ctx)
+            .checkpoint_interval(Duration::ZERO)
+            .create_new_buffered_file(&path)
+            .expect("failed to create writer");
+        for i in 0..3_u8 {
+            channel.log(&[b'0' + i]);
+        }
+        let unfinished = dir.join("unfinished.mcap");
+        std::fs::copy(&path, &unfinished).expect("failed to copy recording");
+        if journal_path(&path).exists() {
+            std::fs::copy(journal_path(&path), journal_path(&unfinished))
+                .expect("failed to copy journal");
+        }
+        writer.close().expect("failed to close writer");
+        assert!(!journal_path(&path).exists());
+        unfinished
+    }
+
+    fn assert_recovered(path: &Path) {
+        let summary = crate::testutil::read_summary(path);
+        assert_eq!(summary.channels.len(), 1);
+        assert_eq!(summary.chunk_indexes.len(), 3);
+        assert_eq!(summary.stats.expect("missing statistics").message_count, 3);
+        let contents = std::fs::read(path).expect("failed to read recording");
+        let payloads: Vec<_> = mcap::MessageStream::new(&contents)
+            .expect("failed to read messages")
+            .map(|message| message.expect("invalid message").data.to_vec())
+            .collect();
+        assert_eq!(payloads, vec![b"0".to_vec(), b"1".to_vec(), b"2".to_vec()]);
+    }
+
+    #[test]
+    fn test_recover_with_checkpoint_journal() {
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let path = write_unfinished_recording(dir.path(), McapWriter::new());
+        assert!(journal_path(&path).exists());
+
+        recover_mcap(&path).expect("failed to recover");
+        assert!(!journal_path(&path).exists());
+        assert_recovered(&path);
+
+        // Recovering a finished file leaves it unchanged.
+        let contents = std::fs::read(&path).expect("failed to read recording");
+        recover_mcap(&path).expect("failed to recover");
+        assert_eq!(
+            std::fs::read(&path).expect("failed to read recording"),
+            contents
+        );
+    }
+
+    #[test]
+    fn test_recover_without_checkpoint_journal() {
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let path = write_unfinished_recording(dir.path(), McapWriter::new());
+        std::fs::remove_file(journal_path(&path)).expect("failed to remove journal");
+
+        recover_mcap(&path).expect("failed to recover");
+        assert_recovered(&path);
+    }
+
+    #[test]
+    fn test_adaptive_chunks() {
+        let ctx = Context::new();
+        let channel = crate::ChannelBuilder::new("/topic")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .expect("failed to create channel");
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let path = dir.path().join("recording.mcap");
+        let writer = McapWriter::new()
+            .context(&ctx)
+            .adaptive_chunks(McapAdaptiveChunks {
+                max_age: Duration::from_secs(3600),
+                min_size: 100,
+                max_size: 100,
+            })
+            .create_new_buffered_file(&path)
+            .expect("failed to create writer");
+        // Each chunk is finished once it holds 100 bytes of message records.
+        for _ in 0..4 {
+            channel.log(&[b'x'; 60]);
+        }
+        writer.close().expect("failed to close writer");
+
+        let summary = crate::testutil::read_summary(&path);
+        assert_eq!(summary.chunk_indexes.len(), 2);
+        assert_eq!(summary.stats.expect("missing statistics").message_count, 4);
+    }
+
+    #[test]
+    fn test_adaptive_chunks_max_age() {
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let ctx = Context::new();
+        let channel = crate::ChannelBuilder::new("/topic")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .expect("failed to create channel");
+        let path = dir.path().join("recording.mcap");
+        let writer = McapWriter::new()
+            .context(&ctx)
+            .adaptive_chunks(McapAdaptiveChunks {
+                max_age: Duration::ZERO,
+                ..McapAdaptiveChunks::default()
+            })
+            .create_new_buffered_file(&path)
+            .expect("failed to create writer");
+        for i in 0..3_u8 {
+            channel.log(&[b'0' + i]);
+        }
+        writer.close().expect("failed to close writer");
+
+        // Every message is older than the max age once it's written, so each is its own chunk.
+        let summary = crate::testutil::read_summary(&path);
+        assert_eq!(summary.chunk_indexes.len(), 3);
+    }
+
+    #[test]
+    fn test_rotation_requires_template() {
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let result = McapWriter::new()
+            .rotation(McapRotation::default())
+            .create_new_buffered_file(dir.path().join("recording.mcap"));
+        assert!(matches!(result, Err(FoxgloveError::ValueError(_))));
+    }
 }
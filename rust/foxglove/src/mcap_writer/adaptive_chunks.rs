@@ -0,0 +1,231 @@
+//! Chunk boundaries chosen from the observed throughput and compression ratio.
+use std::time::{Duration, Instant};
+
+use crate::mcap_writer::records::RECORD_PREFIX_LEN;
+
+/// Size of a message record, other than its data: the channel id, sequence, log time and publish
+/// time.
+pub(crate) const MESSAGE_RECORD_OVERHEAD: u64 = RECORD_PREFIX_LEN + 2 + 4 + 8 + 8;
+
+/// The size target before any chunk has been finished, as for a fixed `chunk_size`.
+const INITIAL_TARGET: u64 = 1024 * 1024;
+
+/// Weight of each finished chunk in the averaged throughput and compression ratio.
+const SMOOTHING: f64 = 0.25;
+
+/// Compression ratio (compressed size over uncompressed size) above which data is considered
+/// incompressible, and larger chunks are not worth their latency.
+const INCOMPRESSIBLE_RATIO: f64 = 0.9;
+
+/// The shortest time a chunk is treated as having taken to fill, so that a burst which fills a
+/// chunk at once doesn't measure as infinite throughput.
+const MIN_FILL_TIME: Duration = Duration::from_millis(1);
+
+/// Options for choosing chunk boundaries adaptively, instead of at a fixed `chunk_size`.
+///
+/// A chunk is finished once its oldest message has waited [`max_age`][Self::max_age], or once it
+/// reaches a size target, whichever comes first. The size target is chosen from the chunks
+/// written so far:
+///
+/// - For data which compresses well, the target is the amount of data logged within `max_age` at
+///   the observed throughput, so that chunks are as large as the age limit allows. Larger chunks
+///   compress better, and carry less per-chunk overhead.
+/// - For data which barely compresses, such as compressed images, larger chunks don't pay for
+///   themselves, and the target is [`min_size`][Self::min_size].
+///
+/// The target is always between `min_size` and [`max_size`][Self::max_size], in uncompressed
+/// bytes.
+///
+/// See [`McapWriter::adaptive_chunks`][crate::McapWriter::adaptive_chunks].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct McapAdaptiveChunks {
+    /// Finish a chunk once its oldest message has waited this long.
+    ///
+    /// This bounds the messages lost if the process exits without closing the writer, and the
+    /// latency of a live tail. The age is checked as messages are written.
+    pub max_age: Duration,
+    /// The smallest size target, in uncompressed bytes.
+    pub min_size: u64,
+    /// The largest size target, in uncompressed bytes. This also bounds the memory held by each
+    /// chunk while it is filled.
+    pub max_size: u64,
+}
+
+impl Default for McapAdaptiveChunks {
+    fn default() -> Self {
+        Self {
+            max_age: Duration::from_secs(5),
+            min_size: 64 * 1024,
+            max_size: 16 * 1024 * 1024,
+        }
+    }
+}
+
+/// The chunk being filled.
+struct OpenChunk {
+    started: Instant,
+    /// Uncompressed bytes of the message records written to the chunk.
+    bytes: u64,
+    /// Bytes written to the output when the chunk was started.
+    output_start: u64,
+}
+
+/// Decides when the current chunk is finished, for [`McapAdaptiveChunks`].
+pub(crate) struct AdaptiveChunks {
+    options: McapAdaptiveChunks,
+    /// The current size target, in uncompressed bytes.
+    target: u64,
+    /// Averaged uncompressed bytes logged per second.
+    throughput: Option<f64>,
+    /// Averaged compressed size over uncompressed size of finished chunks.
+    ratio: Option<f64>,
+    chunk: Option<OpenChunk>,
+}
+
+impl AdaptiveChunks {
+    pub fn new(options: McapAdaptiveChunks) -> Self {
+        let options = McapAdaptiveChunks {
+            max_size: options.max_size.max(options.min_size),
+            ..options
+        };
+        Self {
+            options,
+            target: INITIAL_TARGET.clamp(options.min_size, options.max_size),
+            throughput: None,
+            ratio: None,
+            chunk: None,
+        }
+    }
+
+    /// Records a message written to the current chunk. `output` is the number of bytes written to
+    /// the output before the message was written.
+    pub fn wrote(&mut self, len: usize, output: u64) {
+        let chunk = self.chunk.get_or_insert_with(|| OpenChunk {
+            started: Instant::now(),
+            bytes: 0,
+            output_start: output,
+        });
+        chunk.bytes += len as u64 + MESSAGE_RECORD_OVERHEAD;
+    }
+
+    /// Returns true if the current chunk should be finished.
+    pub fn is_due(&self) -> bool {
+        self.chunk.as_ref().is_some_and(|chunk| {
+            chunk.bytes >= self.target || chunk.started.elapsed() >= self.options.max_age
+        })
+    }
+
+    /// Records that the current chunk was finished. `output` is the number of bytes written to the
+    /// output, including the chunk and its indexes.
+    pub fn finished(&mut self, output: u64) {
+        let Some(chunk) = self.chunk.take() else {
+            return;
+        };
+        let compressed = output.saturating_sub(chunk.output_start);
+        self.record(chunk.bytes, compressed, chunk.started.elapsed());
+    }
+
+    /// Forgets the current chunk without measuring it, when the output is replaced.
+    pub fn discard(&mut self) {
+        self.chunk = None;
+    }
+
+    /// Updates the averages and the size target with a finished chunk of `bytes` uncompressed
+    /// bytes, which was written as `compressed` bytes after `elapsed`.
+    fn record(&mut self, bytes: u64, compressed: u64, elapsed: Duration) {
+        if bytes == 0 {
+            return;
+        }
+        let ratio = compressed as f64 / bytes as f64;
+        let throughput = bytes as f64 / elapsed.max(MIN_FILL_TIME).as_secs_f64();
+        let smooth = |average: Option<f64>, sample: f64| {
+            average.map_or(sample, |average| average + SMOOTHING * (sample - average))
+        };
+        let ratio = *self.ratio.insert(smooth(self.ratio, ratio));
+        let throughput = *self.throughput.insert(smooth(self.throughput, throughput));
+
+        let target = if ratio >= INCOMPRESSIBLE_RATIO {
+            self.options.min_size
+        } else {
+            (throughput * self.options.max_age.as_secs_f64()) as u64
+        };
+        self.target = target.clamp(self.options.min_size, self.options.max_size);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn options() -> McapAdaptiveChunks {
+        McapAdaptiveChunks {
+            max_age: Duration::from_secs(1),
+            min_size: 1000,
+            max_size: 100_000,
+        }
+    }
+
+    #[test]
+    fn test_due_by_size() {
+        let mut chunks = AdaptiveChunks::new(McapAdaptiveChunks {
+            max_size: 1000,
+            ..options()
+        });
+        assert!(!chunks.is_due());
+        chunks.wrote(500, 0);
+        assert!(!chunks.is_due());
+        chunks.wrote(500, 0);
+        assert!(chunks.is_due());
+        chunks.finished(100);
+        assert!(!chunks.is_due());
+    }
+
+    #[test]
+    fn test_due_by_age() {
+        let mut chunks = AdaptiveChunks::new(McapAdaptiveChunks {
+            max_age: Duration::ZERO,
+            ..options()
+        });
+        chunks.wrote(1, 0);
+        assert!(chunks.is_due());
+        chunks.discard();
+        assert!(!chunks.is_due());
+    }
+
+    #[test]
+    fn test_target_follows_throughput() {
+        let mut chunks = AdaptiveChunks::new(options());
+        // 10 kB/s of compressible data: a second's worth.
+        chunks.record(10_000, 2_000, Duration::from_secs(1));
+        assert_eq!(chunks.target, 10_000);
+
+        // A burst grows the target, up to the maximum.
+        for _ in 0..20 {
+            chunks.record(10_000, 2_000, Duration::from_millis(10));
+        }
+        assert_eq!(chunks.target, 100_000);
+
+        // A trickle shrinks it, down to the minimum.
+        for _ in 0..50 {
+            chunks.record(100, 20, Duration::from_secs(1));
+        }
+        assert_eq!(chunks.target, 1000);
+    }
+
+    #[test]
+    fn test_incompressible_data_uses_small_chunks() {
+        let mut chunks = AdaptiveChunks::new(options());
+        chunks.record(50_000, 49_000, Duration::from_millis(10));
+        assert_eq!(chunks.target, 1000);
+    }
+
+    #[test]
+    fn test_max_size_is_at_least_min_size() {
+        let chunks = AdaptiveChunks::new(McapAdaptiveChunks {
+            min_size: 2000,
+            max_size: 10,
+            ..options()
+        });
+        assert_eq!(chunks.target, 2000);
+    }
+}
@@ -0,0 +1,34 @@
+//! Grouping of channels into separate streams of chunks.
+use crate::ChannelDescriptor;
+
+/// Chooses which group of chunks holds each channel's messages.
+///
+/// Each group is written to a separate stream of chunks in the same file, and each stream
+/// finishes its chunks independently. A chunk then only holds messages from channels of one
+/// group, so a reader which only wants some topics, such as the cameras of a recording, skips
+/// the chunks of the other groups without decompressing them.
+///
+/// Channels in group 0 share the writer's default chunks. Grouping is combined with a
+/// [compression policy][crate::McapCompressionPolicy], so channels in the same group with
+/// different compression are still written to separate streams.
+///
+/// See [`McapWriter::channel_grouping`][crate::McapWriter::channel_grouping].
+pub trait McapChannelGrouping: Sync + Send {
+    /// Returns the group of the chunks holding the channel's messages.
+    ///
+    /// This is called once, when the first message is logged to the channel.
+    fn group(&self, channel: &ChannelDescriptor) -> u32;
+}
+
+pub(crate) struct McapChannelGroupingFn<F>(pub F)
+where
+    F: Fn(&ChannelDescriptor) -> u32 + Sync + Send;
+
+impl<F> McapChannelGrouping for McapChannelGroupingFn<F>
+where
+    F: Fn(&ChannelDescriptor) -> u32 + Sync + Send,
+{
+    fn group(&self, channel: &ChannelDescriptor) -> u32 {
+        self.0(channel)
+    }
+}
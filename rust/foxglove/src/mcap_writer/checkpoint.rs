@@ -0,0 +1,133 @@
+//! Periodic checkpoints, which keep an unfinished MCAP recording recoverable.
+use std::collections::{BTreeMap, HashSet};
+use std::ffi::OsString;
+use std::fs::File;
+use std::io::{self, Write};
+use std::path::{Path, PathBuf};
+use std::time::{Duration, Instant};
+
+use crate::mcap_writer::records::{MAGIC, RecordWriter};
+
+/// Suffix appended to an MCAP file's path to name its checkpoint journal.
+pub(crate) const CHECKPOINT_JOURNAL_SUFFIX: &str = ".checkpoint";
+
+/// Returns the path of the checkpoint journal for the MCAP file at `path`.
+pub(crate) fn journal_path(path: &Path) -> PathBuf {
+    let mut journal = OsString::from(path.as_os_str());
+    journal.push(CHECKPOINT_JOURNAL_SUFFIX);
+    journal.into()
+}
+
+pub(crate) struct Checkpoint {
+    interval: Option<Duration>,
+    last_checkpoint: Instant,
+    journal: Option<Journal>,
+}
+
+impl Checkpoint {
+    /// Creates the checkpoint state, creating or truncating the journal if a path is provided.
+    pub fn new(interval: Option<Duration>, journal_path: Option<&Path>) -> io::Result<Self> {
+        Ok(Self {
+            interval,
+            last_checkpoint: Instant::now(),
+            journal: journal_path.map(Journal::create).transpose()?,
+        })
+    }
+
+    /// Returns true if the current chunk should be flushed.
+    pub fn is_due(&self) -> bool {
+        self.interval
+            .is_some_and(|interval| self.last_checkpoint.elapsed() >= interval)
+    }
+
+    pub fn checkpointed(&mut self) {
+        self.last_checkpoint = Instant::now();
+    }
+
+    pub fn record_schema(
+        &mut self,
+        id: u16,
+        name: &str,
+        encoding: &str,
+        data: &[u8],
+    ) -> io::Result<()> {
+        match &mut self.journal {
+            Some(journal) if journal.schemas.insert(id) => {
+                journal.append(|w| w.schema(id, name, encoding, data))
+            }
+            _ => Ok(()),
+        }
+    }
+
+    pub fn record_channel(
+        &mut self,
+        id: u16,
+        schema_id: u16,
+        topic: &str,
+        message_encoding: &str,
+        metadata: &BTreeMap<String, String>,
+    ) -> io::Result<()> {
+        match &mut self.journal {
+            Some(journal) if journal.channels.insert(id) => {
+                journal.append(|w| w.channel(id, schema_id, topic, message_encoding, metadata))
+            }
+            _ => Ok(()),
+        }
+    }
+
+    /// Removes the journal, once the recording has been finished.
+    pub fn finish(self) -> io::Result<()> {
+        match self.journal {
+            Some(journal) => {
+                drop(journal.file);
+                std::fs::remove_file(journal.path)
+            }
+            None => Ok(()),
+        }
+    }
+}
+
+/// A sidecar file listing the schemas and channels of an MCAP recording.
+///
+/// Chunked recordings declare schemas and channels inside compressed chunks. The journal lets
+/// [`recover_mcap`][crate::recover_mcap] rebuild the summary without decompressing any chunks.
+/// It starts with the MCAP magic, followed by Schema and Channel records, each appended with a
+/// single write as soon as it is added to the recording.
+struct Journal {
+    path: PathBuf,
+    file: File,
+    schemas: HashSet<u16>,
+    channels: HashSet<u16>,
+}
+
+impl Journal {
+    fn create(path: &Path) -> io::Result<Self> {
+        let mut file = File::create(path)?;
+        file.write_all(MAGIC)?;
+        Ok(Self {
+            path: path.to_path_buf(),
+            file,
+            schemas: HashSet::new(),
+            channels: HashSet::new(),
+        })
+    }
+
+    fn append(&mut self, record: impl FnOnce(&mut RecordWriter)) -> io::Result<()> {
+        let mut writer = RecordWriter::default();
+        record(&mut writer);
+        self.file.write_all(&writer.into_inner())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_journal_path() {
+        assert_eq!(
+            journal_path(Path::new("dir/test.mcap")),
+            Path::new("dir/test.mcap.checkpoint")
+        );
+    }
+}
@@ -0,0 +1,835 @@
+//! Writing an MCAP file whose chunks are compressed differently for different channels.
+use std::borrow::Cow;
+use std::collections::HashMap;
+use std::io::{self, Read, Seek, SeekFrom, Write};
+use std::sync::Arc;
+
+use mcap::WriteOptions;
+use mcap::records::AttachmentHeader;
+use parking_lot::Mutex;
+
+use crate::mcap_writer::channel_grouping::McapChannelGrouping;
+use crate::mcap_writer::compression_policy::{McapChunkCompression, McapCompressionPolicy};
+use crate::mcap_writer::records::{
+    ChannelRecord, MAGIC, RECORD_PREFIX_LEN, RecordReader, RecordWriter, SchemaRecord, op,
+    split_record,
+};
+use crate::mcap_writer::sparse_index::McapSparseIndex;
+use crate::mcap_writer::summary::SummaryBuilder;
+use crate::mcap_writer::zstd_dictionary::{
+    DictionaryCompressor, MCAP_ZSTD_DICTIONARY_MEDIA_TYPE, McapZstdDictionary, uses_dictionary,
+};
+use crate::{ChannelDescriptor, FoxgloveError, McapChannel, McapChunkCommit, McapSchema};
+
+/// Size of the blocks in which streamed attachment data is copied.
+const ATTACHMENT_BLOCK_SIZE: usize = 64 * 1024;
+
+/// Called with each chunk once it has been written to the file.
+pub(crate) type ChunkCommitFn = Arc<dyn Fn(&McapChunkCommit) + Send + Sync>;
+
+/// Options which require chunks to be built by [`ChunkStreams`].
+#[derive(Clone, Default)]
+pub(crate) struct ChunkStreamOptions {
+    pub policy: Option<Arc<dyn McapCompressionPolicy>>,
+    pub grouping: Option<Arc<dyn McapChannelGrouping>>,
+    pub dictionary: Option<McapZstdDictionary>,
+    pub sparse_index: Option<McapSparseIndex>,
+    pub on_commit: Option<ChunkCommitFn>,
+}
+
+impl ChunkStreamOptions {
+    pub fn is_enabled(&self) -> bool {
+        self.policy.is_some()
+            || self.grouping.is_some()
+            || self.dictionary.is_some()
+            || self.sparse_index.is_some()
+            || self.on_commit.is_some()
+    }
+}
+
+/// The MCAP writer for a recording, or for one segment of a rotating recording.
+pub(crate) enum SegmentWriter<W: Write + Seek> {
+    /// A single stream of chunks, all with the same compression.
+    Single(mcap::Writer<W>),
+    /// Separate streams of chunks for channels with different compression.
+    Streams(ChunkStreams<W>),
+}
+
+impl<W: Write + Seek> SegmentWriter<W> {
+    pub fn new(
+        writer: W,
+        options: WriteOptions,
+        streams: &ChunkStreamOptions,
+    ) -> Result<Self, FoxgloveError> {
+        Ok(if streams.is_enabled() {
+            Self::Streams(ChunkStreams::new(writer, options, streams.clone())?)
+        } else {
+            Self::Single(options.create(writer)?)
+        })
+    }
+
+    pub fn add_schema(
+        &mut self,
+        name: &str,
+        encoding: &str,
+        data: &[u8],
+    ) -> Result<u16, FoxgloveError> {
+        match self {
+            Self::Single(writer) => Ok(writer.add_schema(name, encoding, data)?),
+            Self::Streams(streams) => streams.add_schema(name, encoding, data),
+        }
+    }
+
+    pub fn add_channel(
+        &mut self,
+        schema_id: u16,
+        channel: &ChannelDescriptor,
+    ) -> Result<u16, FoxgloveError> {
+        match self {
+            Self::Single(writer) => Ok(writer.add_channel(
+                schema_id,
+                channel.topic(),
+                channel.message_encoding(),
+                channel.metadata(),
+            )?),
+            Self::Streams(streams) => streams.add_channel(schema_id, channel),
+        }
+    }
+
+    pub fn write_to_known_channel(
+        &mut self,
+        header: &mcap::records::MessageHeader,
+        data: &[u8],
+    ) -> Result<(), FoxgloveError> {
+        match self {
+            Self::Single(writer) => Ok(writer.write_to_known_channel(header, data)?),
+            Self::Streams(streams) => streams.write_to_known_channel(header, data),
+        }
+    }
+
+    /// Finishes the current chunks, and flushes the underlying writer.
+    pub fn flush(&mut self) -> Result<(), FoxgloveError> {
+        match self {
+            Self::Single(writer) => Ok(writer.flush()?),
+            Self::Streams(streams) => streams.flush(),
+        }
+    }
+
+    pub fn write_metadata(
+        &mut self,
+        metadata: &mcap::records::Metadata,
+    ) -> Result<(), FoxgloveError> {
+        match self {
+            Self::Single(writer) => Ok(writer.write_metadata(metadata)?),
+            Self::Streams(streams) => streams.write_metadata(metadata),
+        }
+    }
+
+    pub fn attach(&mut self, attachment: &mcap::Attachment<'_>) -> Result<(), FoxgloveError> {
+        match self {
+            Self::Single(writer) => Ok(writer.attach(attachment)?),
+            Self::Streams(streams) => streams.attach(attachment),
+        }
+    }
+
+    /// Writes an attachment whose `length` bytes of data are read from `data`, without holding
+    /// all of it in memory.
+    pub fn attach_reader(
+        &mut self,
+        header: &AttachmentHeader,
+        length: u64,
+        data: &mut dyn Read,
+    ) -> Result<(), FoxgloveError> {
+        match self {
+            Self::Single(writer) => {
+                writer.start_attachment(length, header.clone())?;
+                let copied = copy_attachment_data(length, data, |block| {
+                    Ok(writer.put_attachment_bytes(block)?)
+                });
+                writer.finish_attachment()?;
+                copied
+            }
+            Self::Streams(streams) => streams.attach_reader(header, length, data),
+        }
+    }
+
+    /// Writes the summary and returns the underlying writer.
+    pub fn finish(self) -> Result<W, FoxgloveError> {
+        match self {
+            Self::Single(mut writer) => {
+                writer.finish()?;
+                Ok(writer.into_inner())
+            }
+            Self::Streams(streams) => streams.finish(),
+        }
+    }
+}
+
+/// Writes channels into separate streams of chunks, according to a [`McapCompressionPolicy`],
+/// an [`McapChannelGrouping`] and zstd dictionaries.
+///
+/// Each stream has its own MCAP writer, which builds and compresses chunks in memory. Completed
+/// records are copied from the streams into the file as they are produced, and indexed, so that
+/// the summary can describe the chunks of every stream. Schemas and channels are declared to
+/// every stream in the same order, so that their ids agree.
+///
+/// With dictionaries, the first messages of each schema are kept as samples. Once there are
+/// enough, a dictionary is trained from them and attached to the file, and the schema's channels
+/// move to a new stream. That stream's writer builds uncompressed chunks, which are compressed
+/// with the dictionary as they are copied into the file.
+///
+/// With a sparse index, message index records are thinned out as they are copied, and the
+/// messages left out of them are still counted in the statistics.
+///
+/// With a commit callback, the file is flushed after each chunk is copied into it, and the
+/// callback is told about the chunk, along with any channels and dictionaries added since the
+/// previous chunk.
+///
+/// The summary always includes statistics and all indexes, and no data section or summary CRCs
+/// are written.
+pub(crate) struct ChunkStreams<W: Write + Seek> {
+    out: W,
+    // Offset in `out` of the next byte to be written.
+    position: u64,
+    options: WriteOptions,
+    policy: Option<Arc<dyn McapCompressionPolicy>>,
+    grouping: Option<Arc<dyn McapChannelGrouping>>,
+    dictionary: Option<McapZstdDictionary>,
+    sparse_index: Option<McapSparseIndex>,
+    commits: Option<ChunkCommits>,
+    // The first stream uses the writer's own compression, and also holds attachments and
+    // metadata.
+    streams: Vec<Stream>,
+    // Index into `streams` for each MCAP channel id.
+    channel_streams: HashMap<u16, usize>,
+    // Dictionary state for each schema id.
+    dictionaries: HashMap<u16, SchemaDictionary>,
+    // Schema id of each channel which may be compressed with its schema's dictionary.
+    dictionary_channels: HashMap<u16, u16>,
+    summary: SummaryBuilder,
+}
+
+enum SchemaDictionary {
+    /// Messages collected to train the dictionary.
+    Training(Vec<Vec<u8>>),
+    /// The dictionary was trained, and its chunks are written by the stream with this index.
+    Trained(usize),
+    /// The dictionary could not be trained, so the schema's channels keep their compression.
+    Failed,
+}
+
+impl<W: Write + Seek> ChunkStreams<W> {
+    fn new(
+        mut out: W,
+        options: WriteOptions,
+        streams: ChunkStreamOptions,
+    ) -> Result<Self, FoxgloveError> {
+        if streams.dictionary.is_some() && !cfg!(feature = "zstd") {
+            return Err(FoxgloveError::ValueError(
+                "MCAP zstd dictionaries require the zstd feature".to_string(),
+            ));
+        }
+        let position = out.stream_position()?;
+        let (stream, header) = Stream::new(options.clone(), None, 0)?;
+        // The first stream's magic and header record start the file.
+        out.write_all(&header)?;
+        Ok(Self {
+            out,
+            position: position + header.len() as u64,
+            options,
+            policy: streams.policy,
+            grouping: streams.grouping,
+            dictionary: streams.dictionary,
+            sparse_index: streams.sparse_index,
+            commits: streams.on_commit.map(ChunkCommits::new),
+            streams: vec![stream],
+            channel_streams: HashMap::new(),
+            dictionaries: HashMap::new(),
+            dictionary_channels: HashMap::new(),
+            summary: SummaryBuilder::default(),
+        })
+    }
+
+    fn add_schema(
+        &mut self,
+        name: &str,
+        encoding: &str,
+        data: &[u8],
+    ) -> Result<u16, FoxgloveError> {
+        let id = self.streams[0].writer.add_schema(name, encoding, data)?;
+        for stream in &mut self.streams[1..] {
+            check_id(stream.writer.add_schema(name, encoding, data)?, id)?;
+        }
+        self.summary
+            .schemas
+            .entry(id)
+            .or_insert_with(|| SchemaRecord {
+                id,
+                name: name.to_string(),
+                encoding: encoding.to_string(),
+                data: data.to_vec(),
+            });
+        self.drain_all()?;
+        Ok(id)
+    }
+
+    fn add_channel(
+        &mut self,
+        schema_id: u16,
+        channel: &ChannelDescriptor,
+    ) -> Result<u16, FoxgloveError> {
+        let topic = channel.topic();
+        let message_encoding = channel.message_encoding();
+        let metadata = channel.metadata();
+        let id =
+            self.streams[0]
+                .writer
+                .add_channel(schema_id, topic, message_encoding, metadata)?;
+        for stream in &mut self.streams[1..] {
+            let stream_id =
+                stream
+                    .writer
+                    .add_channel(schema_id, topic, message_encoding, metadata)?;
+            check_id(stream_id, id)?;
+        }
+        self.summary
+            .channels
+            .entry(id)
+            .or_insert_with(|| ChannelRecord {
+                id,
+                schema_id,
+                topic: topic.to_string(),
+                message_encoding: message_encoding.to_string(),
+                metadata: metadata.clone(),
+            });
+        let compression = self
+            .policy
+            .as_ref()
+            .and_then(|policy| policy.compression(channel));
+        let group = self
+            .grouping
+            .as_ref()
+            .map_or(0, |grouping| grouping.group(channel));
+        let mut stream = self.stream_for(compression, group)?;
+        if self.dictionary.is_some() && schema_id != 0 && uses_dictionary(compression) {
+            self.dictionary_channels.insert(id, schema_id);
+            if let Some(SchemaDictionary::Trained(trained)) = self.dictionaries.get(&schema_id) {
+                stream = *trained;
+            }
+        }
+        self.channel_streams.insert(id, stream);
+        self.drain_all()?;
+        Ok(id)
+    }
+
+    /// Returns the index of the stream with the given compression and group, creating it if
+    /// needed.
+    fn stream_for(
+        &mut self,
+        compression: Option<McapChunkCompression>,
+        group: u32,
+    ) -> Result<usize, FoxgloveError> {
+        if compression.is_none() && group == 0 {
+            return Ok(0);
+        }
+        if let Some(index) = self.streams.iter().position(|s| {
+            s.dictionary.is_none() && s.compression == compression && s.group == group
+        }) {
+            return Ok(index);
+        }
+        self.new_stream(compression, group, None)
+    }
+
+    /// Adds a stream, declaring the existing schemas and channels to it.
+    fn new_stream(
+        &mut self,
+        compression: Option<McapChunkCompression>,
+        group: u32,
+        dictionary: Option<DictionaryCompressor>,
+    ) -> Result<usize, FoxgloveError> {
+        let (mut stream, _header) = Stream::new(self.options.clone(), compression, group)?;
+        stream.dictionary = dictionary;
+        // Declare the existing schemas and channels in id order, so the stream assigns the same
+        // ids as the others.
+        for schema in self.summary.schemas.values() {
+            let id = stream
+                .writer
+                .add_schema(&schema.name, &schema.encoding, &schema.data)?;
+            check_id(id, schema.id)?;
+        }
+        for channel in self.summary.channels.values() {
+            let id = stream.writer.add_channel(
+                channel.schema_id,
+                &channel.topic,
+                &channel.message_encoding,
+                &channel.metadata,
+            )?;
+            check_id(id, channel.id)?;
+        }
+        self.streams.push(stream);
+        Ok(self.streams.len() - 1)
+    }
+
+    fn write_to_known_channel(
+        &mut self,
+        header: &mcap::records::MessageHeader,
+        data: &[u8],
+    ) -> Result<(), FoxgloveError> {
+        let index = self
+            .channel_streams
+            .get(&header.channel_id)
+            .copied()
+            .unwrap_or(0);
+        self.streams[index]
+            .writer
+            .write_to_known_channel(header, data)?;
+        self.drain(index)?;
+        if let Some(&schema_id) = self.dictionary_channels.get(&header.channel_id) {
+            self.add_sample(schema_id, header.log_time, data)?;
+        }
+        Ok(())
+    }
+
+    /// Keeps a message as a sample for its schema's dictionary, and trains the dictionary once
+    /// there are enough samples.
+    fn add_sample(
+        &mut self,
+        schema_id: u16,
+        log_time: u64,
+        data: &[u8],
+    ) -> Result<(), FoxgloveError> {
+        let Some(options) = self.dictionary else {
+            return Ok(());
+        };
+        let state = self
+            .dictionaries
+            .entry(schema_id)
+            .or_insert_with(|| SchemaDictionary::Training(Vec::new()));
+        let SchemaDictionary::Training(samples) = state else {
+            return Ok(());
+        };
+        samples.push(data.to_vec());
+        if samples.len() < options.training_messages.max(1) {
+            return Ok(());
+        }
+        let samples = std::mem::take(samples);
+        match DictionaryCompressor::train(&samples, &options) {
+            Ok((compressor, dictionary)) => {
+                let stream = self.add_dictionary(schema_id, log_time, compressor, &dictionary)?;
+                self.dictionaries
+                    .insert(schema_id, SchemaDictionary::Trained(stream));
+            }
+            Err(e) => {
+                tracing::warn!("Failed to train zstd dictionary for schema {schema_id}: {e}");
+                self.dictionaries
+                    .insert(schema_id, SchemaDictionary::Failed);
+            }
+        }
+        Ok(())
+    }
+
+    /// Attaches a schema's dictionary to the file, and moves the schema's channels to a new
+    /// stream whose chunks are compressed with it. Returns the index of the new stream.
+    fn add_dictionary(
+        &mut self,
+        schema_id: u16,
+        log_time: u64,
+        compressor: DictionaryCompressor,
+        dictionary: &[u8],
+    ) -> Result<usize, FoxgloveError> {
+        let name = self
+            .summary
+            .schemas
+            .get(&schema_id)
+            .map(|schema| schema.name.clone())
+            .unwrap_or_default();
+        self.attach(&mcap::Attachment {
+            log_time,
+            create_time: log_time,
+            name,
+            media_type: MCAP_ZSTD_DICTIONARY_MEDIA_TYPE.to_string(),
+            data: Cow::Borrowed(dictionary),
+        })?;
+        let stream = self.new_stream(Some(McapChunkCompression::NONE), 0, Some(compressor))?;
+        for (&channel_id, &channel_schema_id) in &self.dictionary_channels {
+            if channel_schema_id == schema_id {
+                self.channel_streams.insert(channel_id, stream);
+            }
+        }
+        Ok(stream)
+    }
+
+    fn flush(&mut self) -> Result<(), FoxgloveError> {
+        for index in 0..self.streams.len() {
+            self.streams[index].writer.flush()?;
+            self.drain(index)?;
+        }
+        self.out.flush()?;
+        Ok(())
+    }
+
+    fn write_metadata(&mut self, metadata: &mcap::records::Metadata) -> Result<(), FoxgloveError> {
+        self.streams[0].writer.write_metadata(metadata)?;
+        self.drain(0)
+    }
+
+    fn attach(&mut self, attachment: &mcap::Attachment<'_>) -> Result<(), FoxgloveError> {
+        self.streams[0].writer.attach(attachment)?;
+        self.drain(0)
+    }
+
+    /// Writes a streamed attachment directly to the file, between the records of the streams.
+    fn attach_reader(
+        &mut self,
+        header: &AttachmentHeader,
+        length: u64,
+        data: &mut dyn Read,
+    ) -> Result<(), FoxgloveError> {
+        self.drain_all()?;
+        let mut fields = RecordWriter::default();
+        fields.u64(header.log_time);
+        fields.u64(header.create_time);
+        fields.str(&header.name);
+        fields.str(&header.media_type);
+        fields.u64(length);
+        let fields = fields.into_inner();
+        // The fields, the data, and a CRC of both.
+        let body_len = fields.len() as u64 + length + 4;
+        self.out.write_all(&[op::ATTACHMENT])?;
+        self.out.write_all(&body_len.to_le_bytes())?;
+        self.out.write_all(&fields)?;
+        let mut crc = crc32fast::Hasher::new();
+        crc.update(&fields);
+        let copied = copy_attachment_data(length, data, |block| {
+            crc.update(block);
+            Ok(self.out.write_all(block)?)
+        });
+        self.out.write_all(&crc.finalize().to_le_bytes())?;
+        let record_len = RECORD_PREFIX_LEN + body_len;
+        self.summary.index_record(
+            op::ATTACHMENT,
+            self.position,
+            record_len,
+            &mut RecordReader::new(&fields),
+        )?;
+        self.position += record_len;
+        copied
+    }
+
+    fn finish(mut self) -> Result<W, FoxgloveError> {
+        self.flush()?;
+        self.summary.end_data_section();
+        self.out.write_all(&self.summary.summary(self.position))?;
+        self.out.flush()?;
+        Ok(self.out)
+    }
+
+    fn drain_all(&mut self) -> Result<(), FoxgloveError> {
+        for index in 0..self.streams.len() {
+            self.drain(index)?;
+        }
+        Ok(())
+    }
+
+    /// Copies the complete records produced by a stream into the file, and indexes them.
+    ///
+    /// A chunk and its message indexes are produced together, so they stay adjacent in the file.
+    fn drain(&mut self, index: usize) -> Result<(), FoxgloveError> {
+        let mut records = self.streams[index].output.take_records();
+        if records.is_empty() {
+            return Ok(());
+        }
+        if let Some(compressor) = &mut self.streams[index].dictionary {
+            records = compress_chunks(&records, compressor)?;
+        }
+        if let Some(sparse_index) = &self.sparse_index {
+            let summary = &mut self.summary;
+            records = sparse_index.apply(&records, |channel_id, count| {
+                summary.add_unindexed_messages(channel_id, count);
+            })?;
+        }
+        let mut rest = records.as_slice();
+        let mut position = self.position;
+        while let Some((opcode, body)) = split_record(rest) {
+            let len = RECORD_PREFIX_LEN as usize + body.len();
+            self.summary.index_record(
+                opcode,
+                position,
+                len as u64,
+                &mut RecordReader::new(body),
+            )?;
+            position += len as u64;
+            rest = &rest[len..];
+        }
+        self.out.write_all(&records)?;
+        self.position = position;
+        self.commit_chunks()
+    }
+
+    /// Flushes the file and reports the chunks written since the last commit, if any.
+    fn commit_chunks(&mut self) -> Result<(), FoxgloveError> {
+        let Some(commits) = &mut self.commits else {
+            return Ok(());
+        };
+        let chunks = &self.summary.chunks()[commits.chunks..];
+        if chunks.is_empty() {
+            return Ok(());
+        }
+        self.out.flush()?;
+        let mut channels = commits.new_channels(&self.summary);
+        let mut dictionaries = commits.new_dictionaries(&self.summary);
+        for chunk in chunks {
+            let commit = McapChunkCommit {
+                committed_len: self.position,
+                offset: chunk.offset,
+                length: chunk.length,
+                message_start_time: chunk.message_start_time,
+                message_end_time: chunk.message_end_time,
+                channel_ids: chunk.message_index_offsets.keys().copied().collect(),
+                channels: std::mem::take(&mut channels),
+                dictionaries: std::mem::take(&mut dictionaries),
+            };
+            (commits.callback)(&commit);
+        }
+        commits.chunks = self.summary.chunks().len();
+        Ok(())
+    }
+}
+
+/// Tracks what has been reported to a chunk commit callback.
+struct ChunkCommits {
+    callback: ChunkCommitFn,
+    // Number of chunks, channels and attachments already reported.
+    chunks: usize,
+    channels: usize,
+    attachments: usize,
+    schemas: HashMap<u16, Arc<McapSchema>>,
+}
+
+impl ChunkCommits {
+    fn new(callback: ChunkCommitFn) -> Self {
+        Self {
+            callback,
+            chunks: 0,
+            channels: 0,
+            attachments: 0,
+            schemas: HashMap::new(),
+        }
+    }
+
+    /// Returns the channels added since the last commit.
+    ///
+    /// Channel ids are assigned in increasing order, so new channels are at the end of the map.
+    fn new_channels(&mut self, summary: &SummaryBuilder) -> Vec<Arc<McapChannel>> {
+        let mut channels = Vec::new();
+        for channel in summary.channels.values().skip(self.channels) {
+            let schema = summary.schemas.get(&channel.schema_id).map(|schema| {
+                self.schemas
+                    .entry(schema.id)
+                    .or_insert_with(|| {
+                        Arc::new(McapSchema {
+                            id: schema.id,
+                            name: schema.name.clone(),
+                            encoding: schema.encoding.clone(),
+                            data: schema.data.clone().into(),
+                        })
+                    })
+                    .clone()
+            });
+            channels.push(Arc::new(McapChannel {
+                id: channel.id,
+                topic: channel.topic.clone(),
+                message_encoding: channel.message_encoding.clone(),
+                metadata: channel.metadata.clone(),
+                schema,
+            }));
+        }
+        self.channels = summary.channels.len();
+        channels
+    }
+
+    /// Returns the offset and length of the dictionary attachments written since the last commit.
+    fn new_dictionaries(&mut self, summary: &SummaryBuilder) -> Vec<(u64, u64)> {
+        let attachments = &summary.attachments()[self.attachments..];
+        self.attachments = summary.attachments().len();
+        attachments
+            .iter()
+            .filter(|attachment| attachment.media_type == MCAP_ZSTD_DICTIONARY_MEDIA_TYPE)
+            .map(|attachment| (attachment.offset, attachment.length))
+            .collect()
+    }
+}
+
+/// Copies `length` bytes of attachment data from `data` to `put`, in blocks.
+///
+/// If reading fails or `data` ends early, the rest of the attachment is filled with zeros, so
+/// that its record is still complete, and the read error is returned once all of it has been
+/// written.
+fn copy_attachment_data(
+    length: u64,
+    data: &mut dyn Read,
+    mut put: impl FnMut(&[u8]) -> Result<(), FoxgloveError>,
+) -> Result<(), FoxgloveError> {
+    let mut buf = vec![0; length.min(ATTACHMENT_BLOCK_SIZE as u64) as usize];
+    let mut remaining = length;
+    let mut result = Ok(());
+    while remaining > 0 {
+        let len = remaining.min(buf.len() as u64) as usize;
+        let block = &mut buf[..len];
+        if result.is_ok()
+            && let Err(e) = data.read_exact(block)
+        {
+            result = Err(if e.kind() == io::ErrorKind::UnexpectedEof {
+                FoxgloveError::ValueError(format!(
+                    "attachment data ended before its length of {length} bytes"
+                ))
+            } else {
+                e.into()
+            });
+        }
+        if result.is_err() {
+            block.fill(0);
+        }
+        put(block)?;
+        remaining -= len as u64;
+    }
+    result
+}
+
+/// Compresses the records of each uncompressed chunk in `records` with a dictionary.
+fn compress_chunks(records: &[u8], compressor: &mut DictionaryCompressor) -> io::Result<Vec<u8>> {
+    let mut w = RecordWriter::default();
+    let mut rest = records;
+    while let Some((opcode, body)) = split_record(rest) {
+        rest = &rest[RECORD_PREFIX_LEN as usize + body.len()..];
+        if opcode != op::CHUNK {
+            w.record(opcode, |w| w.raw(body));
+            continue;
+        }
+        let mut chunk = RecordReader::new(body);
+        let message_start_time = chunk.u64()?;
+        let message_end_time = chunk.u64()?;
+        let uncompressed_size = chunk.u64()?;
+        let uncompressed_crc = chunk.u32()?;
+        let _compression = chunk.str()?;
+        let _records_len = chunk.u64()?;
+        let compressed = compressor.compress(chunk.remaining())?;
+        w.record(op::CHUNK, |w| {
+            w.u64(message_start_time);
+            w.u64(message_end_time);
+            w.u64(uncompressed_size);
+            w.u32(uncompressed_crc);
+            w.str("zstd");
+            w.u64(compressed.len() as u64);
+            w.raw(&compressed);
+        });
+    }
+    Ok(w.into_inner())
+}
+
+fn check_id(id: u16, expected: u16) -> Result<(), FoxgloveError> {
+    if id == expected {
+        Ok(())
+    } else {
+        Err(FoxgloveError::Unspecified(
+            format!("MCAP chunk streams assigned id {id} instead of {expected}").into(),
+        ))
+    }
+}
+
+struct Stream {
+    compression: Option<McapChunkCompression>,
+    // The channel group whose messages the stream holds.
+    group: u32,
+    // Compresses the stream's chunks, which its writer leaves uncompressed.
+    dictionary: Option<DictionaryCompressor>,
+    writer: mcap::Writer<SharedBuffer>,
+    output: SharedBuffer,
+}
+
+impl Stream {
+    /// Creates a stream for a channel group, which overrides the writer's compression, if
+    /// provided.
+    ///
+    /// Returns the stream and the magic and header record written by its MCAP writer.
+    fn new(
+        options: WriteOptions,
+        compression: Option<McapChunkCompression>,
+        group: u32,
+    ) -> Result<(Self, Vec<u8>), FoxgloveError> {
+        let options = match compression {
+            Some(chunk) => options
+                .compression(chunk.compression)
+                .compression_level(chunk.level),
+            None => options,
+        };
+        let output = SharedBuffer::default();
+        // Records are taken from the output as soon as they are complete, so the writer must
+        // not seek back into them.
+        let writer = options.disable_seeking(true).create(output.clone())?;
+        let header = output.take_records();
+        let stream = Self {
+            compression,
+            group,
+            dictionary: None,
+            writer,
+            output,
+        };
+        Ok((stream, header))
+    }
+}
+
+/// The in-memory output of a stream's MCAP writer.
+#[derive(Clone, Default)]
+struct SharedBuffer(Arc<Mutex<BufferState>>);
+
+#[derive(Default)]
+struct BufferState {
+    data: Vec<u8>,
+    // Number of bytes taken from the buffer so far.
+    taken: u64,
+}
+
+impl SharedBuffer {
+    /// Takes the complete records at the start of the buffer, along with the magic if it has not
+    /// been taken yet.
+    fn take_records(&self) -> Vec<u8> {
+        let mut state = self.0.lock();
+        let mut len = 0;
+        if state.taken == 0 && state.data.starts_with(MAGIC) {
+            len = MAGIC.len();
+        }
+        while let Some((_, body)) = split_record(&state.data[len..]) {
+            len += RECORD_PREFIX_LEN as usize + body.len();
+        }
+        let rest = state.data.split_off(len);
+        state.taken += len as u64;
+        std::mem::replace(&mut state.data, rest)
+    }
+}
+
+impl Write for SharedBuffer {
+    fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
+        self.0.lock().data.extend_from_slice(buf);
+        Ok(buf.len())
+    }
+
+    fn flush(&mut self) -> io::Result<()> {
+        Ok(())
+    }
+}
+
+impl Seek for SharedBuffer {
+    fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
+        let state = self.0.lock();
+        let position = state.taken + state.data.len() as u64;
+        match pos {
+            SeekFrom::Current(0) => Ok(position),
+            SeekFrom::Start(offset) if offset == position => Ok(position),
+            _ => Err(io::Error::new(
+                io::ErrorKind::Unsupported,
+                "MCAP chunk streams do not support seeking",
+            )),
+        }
+    }
+}
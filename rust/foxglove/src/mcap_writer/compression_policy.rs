@@ -0,0 +1,64 @@
+//! Per-channel chunk compression.
+use crate::ChannelDescriptor;
+use crate::mcap_writer::McapCompression;
+
+/// How the chunks holding a channel's messages are compressed.
+///
+/// See [`McapCompressionPolicy`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct McapChunkCompression {
+    /// The compression algorithm, or `None` to write the chunks uncompressed.
+    pub compression: Option<McapCompression>,
+    /// Compression level passed to the compressor. 0 uses the compressor's default level.
+    pub level: u32,
+}
+
+impl McapChunkCompression {
+    /// Chunks which are not compressed, for data which is already compressed, such as video.
+    pub const NONE: Self = Self {
+        compression: None,
+        level: 0,
+    };
+
+    /// Chunks which are compressed with the given algorithm at its default level.
+    pub fn new(compression: McapCompression) -> Self {
+        Self {
+            compression: Some(compression),
+            level: 0,
+        }
+    }
+
+    /// Sets the compression level.
+    pub fn with_level(mut self, level: u32) -> Self {
+        self.level = level;
+        self
+    }
+}
+
+/// Chooses how the chunks holding each channel's messages are compressed.
+///
+/// Channels are grouped by compression into separate streams of chunks in the same file, so a
+/// compressor is only run over the data it suits. For example, channels carrying compressed
+/// video can be written to uncompressed chunks, while JSON channels use zstd.
+///
+/// See [`McapWriter::compression_policy`][crate::McapWriter::compression_policy].
+pub trait McapCompressionPolicy: Sync + Send {
+    /// Returns the compression for the chunks holding the channel's messages, or `None` to use
+    /// the writer's compression.
+    ///
+    /// This is called once, when the first message is logged to the channel.
+    fn compression(&self, channel: &ChannelDescriptor) -> Option<McapChunkCompression>;
+}
+
+pub(crate) struct McapCompressionPolicyFn<F>(pub F)
+where
+    F: Fn(&ChannelDescriptor) -> Option<McapChunkCompression> + Sync + Send;
+
+impl<F> McapCompressionPolicy for McapCompressionPolicyFn<F>
+where
+    F: Fn(&ChannelDescriptor) -> Option<McapChunkCompression> + Sync + Send,
+{
+    fn compression(&self, channel: &ChannelDescriptor) -> Option<McapChunkCompression> {
+        self.0(channel)
+    }
+}
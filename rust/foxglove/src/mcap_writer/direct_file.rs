@@ -0,0 +1,199 @@
+//! A file writer which bypasses the page cache.
+use std::alloc::{Layout, alloc_zeroed, dealloc};
+use std::fs::{File, OpenOptions};
+use std::io::{self, Seek, SeekFrom, Write};
+use std::os::unix::fs::{FileExt, OpenOptionsExt};
+use std::path::Path;
+use std::ptr::NonNull;
+
+/// Alignment of buffers, file offsets, and write lengths required by `O_DIRECT`.
+const ALIGNMENT: usize = 4096;
+
+/// Size of the staging buffer. Data is written to the file in blocks of this size.
+const BUFFER_SIZE: usize = 4 * 1024 * 1024;
+
+/// A write-only file opened with `O_DIRECT`, which bypasses the page cache.
+///
+/// Writes are staged in an aligned buffer and submitted to the file in large aligned blocks, so
+/// that sustained recording does not grow the page cache or contend with page-cache writeback.
+///
+/// This writer does not support seeking, beyond querying the current position. Use it with
+/// [`McapWriteOptions::disable_seeking`][crate::McapWriteOptions::disable_seeking] set to true.
+///
+/// Only available on Linux.
+pub struct McapDirectFile {
+    file: File,
+    buffer: AlignedBuffer,
+    // Number of bytes of `buffer` which hold data.
+    buffered: usize,
+    // File offset of the start of `buffer`. Always a multiple of `ALIGNMENT`.
+    buffer_offset: u64,
+}
+
+impl McapDirectFile {
+    /// Creates a new file for writing with `O_DIRECT`.
+    ///
+    /// Fails with [`AlreadyExists`](`std::io::ErrorKind::AlreadyExists`) if the file exists.
+    pub fn create_new(path: impl AsRef<Path>) -> io::Result<Self> {
+        Self::open(path, OpenOptions::new().create_new(true))
+    }
+
+    /// Creates or truncates a file for writing with `O_DIRECT`.
+    pub fn create(path: impl AsRef<Path>) -> io::Result<Self> {
+        Self::open(path, OpenOptions::new().create(true).truncate(true))
+    }
+
+    fn open(path: impl AsRef<Path>, options: &mut OpenOptions) -> io::Result<Self> {
+        let file = options
+            .write(true)
+            .custom_flags(libc::O_DIRECT)
+            .open(path)?;
+        Ok(Self {
+            file,
+            buffer: AlignedBuffer::new(BUFFER_SIZE)?,
+            buffered: 0,
+            buffer_offset: 0,
+        })
+    }
+
+    fn position(&self) -> u64 {
+        self.buffer_offset + self.buffered as u64
+    }
+
+    /// Writes the full buffer to the file, and starts a new one.
+    fn write_buffer(&mut self) -> io::Result<()> {
+        self.file
+            .write_all_at(self.buffer.as_slice(), self.buffer_offset)?;
+        self.buffer_offset += BUFFER_SIZE as u64;
+        self.buffered = 0;
+        Ok(())
+    }
+}
+
+impl Write for McapDirectFile {
+    fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
+        let len = buf.len().min(BUFFER_SIZE - self.buffered);
+        self.buffer.as_mut_slice()[self.buffered..self.buffered + len].copy_from_slice(&buf[..len]);
+        self.buffered += len;
+        if self.buffered == BUFFER_SIZE {
+            self.write_buffer()?;
+        }
+        Ok(len)
+    }
+
+    /// Writes buffered data to the file.
+    ///
+    /// `O_DIRECT` only permits aligned writes, so a partial block is written padded to the
+    /// alignment and the file is truncated to its logical length. The partial block stays
+    /// buffered, and is rewritten in place by later writes.
+    fn flush(&mut self) -> io::Result<()> {
+        if self.buffered == 0 {
+            return Ok(());
+        }
+        let padded = self.buffered.next_multiple_of(ALIGNMENT);
+        self.buffer.as_mut_slice()[self.buffered..padded].fill(0);
+        self.file
+            .write_all_at(&self.buffer.as_slice()[..padded], self.buffer_offset)?;
+        self.file.set_len(self.position())
+    }
+}
+
+impl Seek for McapDirectFile {
+    fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
+        let position = self.position();
+        match pos {
+            SeekFrom::Current(0) => Ok(position),
+            SeekFrom::Start(offset) if offset == position => Ok(position),
+            _ => Err(io::Error::new(
+                io::ErrorKind::Unsupported,
+                "McapDirectFile does not support seeking; set disable_seeking",
+            )),
+        }
+    }
+}
+
+impl Drop for McapDirectFile {
+    fn drop(&mut self) {
+        if let Err(e) = self.flush() {
+            tracing::warn!("Failed to flush direct I/O file: {e}");
+        }
+    }
+}
+
+impl std::fmt::Debug for McapDirectFile {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("McapDirectFile")
+            .field("file", &self.file)
+            .field("position", &self.position())
+            .finish_non_exhaustive()
+    }
+}
+
+/// A zeroed heap buffer aligned to [`ALIGNMENT`].
+struct AlignedBuffer {
+    ptr: NonNull<u8>,
+    layout: Layout,
+}
+
+// Safety: the buffer is uniquely owned heap memory.
+unsafe impl Send for AlignedBuffer {}
+
+impl AlignedBuffer {
+    fn new(size: usize) -> io::Result<Self> {
+        let layout = Layout::from_size_align(size, ALIGNMENT)
+            .map_err(|e| io::Error::new(io::ErrorKind::InvalidInput, e))?;
+        // Safety: the layout has a non-zero size.
+        let ptr = NonNull::new(unsafe { alloc_zeroed(layout) })
+            .ok_or_else(|| io::Error::new(io::ErrorKind::OutOfMemory, "allocation failed"))?;
+        Ok(Self { ptr, layout })
+    }
+
+    fn as_slice(&self) -> &[u8] {
+        // Safety: the pointer is valid for `layout.size()` initialized bytes.
+        unsafe { std::slice::from_raw_parts(self.ptr.as_ptr(), self.layout.size()) }
+    }
+
+    fn as_mut_slice(&mut self) -> &mut [u8] {
+        // Safety: the pointer is valid for `layout.size()` initialized bytes, and uniquely borrowed.
+        unsafe { std::slice::from_raw_parts_mut(self.ptr.as_ptr(), self.layout.size()) }
+    }
+}
+
+impl Drop for AlignedBuffer {
+    fn drop(&mut self) {
+        // Safety: the pointer was allocated with this layout.
+        unsafe { dealloc(self.ptr.as_ptr(), self.layout) };
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn open_in(dir: &tempfile::TempDir) -> Option<McapDirectFile> {
+        match McapDirectFile::create_new(dir.path().join("direct.bin")) {
+            Ok(file) => Some(file),
+            // Some filesystems, like tmpfs, do not support O_DIRECT.
+            Err(e) if e.raw_os_error() == Some(libc::EINVAL) => None,
+            Err(e) => panic!("failed to open file: {e}"),
+        }
+    }
+
+    #[test]
+    fn test_direct_file_writes_unaligned_lengths() {
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let Some(mut file) = open_in(&dir) else {
+            return;
+        };
+        let data: Vec<u8> = (0..BUFFER_SIZE + 5000).map(|i| (i % 251) as u8).collect();
+        file.write_all(&data[..100]).unwrap();
+        file.flush().unwrap();
+        assert_eq!(file.stream_position().unwrap(), 100);
+        file.write_all(&data[100..]).unwrap();
+        assert!(file.seek(SeekFrom::Start(0)).is_err());
+        drop(file);
+
+        let written = std::fs::read(dir.path().join("direct.bin")).unwrap();
+        assert_eq!(written, data);
+    }
+}
@@ -1,17 +1,55 @@
 //! [`Sink`] implementation for an MCAP writer.
-use crate::{ChannelId, FoxgloveError, Metadata, RawChannel, Sink, SinkChannelFilter, SinkId};
+use crate::latency;
+use crate::mcap_writer::adaptive_chunks::{AdaptiveChunks, MESSAGE_RECORD_OVERHEAD};
+use crate::mcap_writer::checkpoint::Checkpoint;
+use crate::mcap_writer::chunk_streams::{ChunkStreamOptions, SegmentWriter};
+use crate::mcap_writer::pipelined_writer::PipelinedWriter;
+use crate::mcap_writer::rotation::{McapRotation, OpenSegment, Rotation};
+use crate::mcap_writer::write_queue::{QueuedMessage, WriteQueue};
+use crate::mcap_writer::{McapAsyncOptions, McapWriterStats};
+use crate::memory_budget::MemoryAccount;
+use crate::throttler::Throttler;
+use crate::{
+    ChannelDescriptor, ChannelId, FoxgloveError, MessageFilter, Metadata, RawChannel, Sink,
+    SinkChannelFilter, SinkId, SinkStats,
+};
+use bytes::Bytes;
 use mcap::WriteOptions;
 use parking_lot::Mutex;
-use std::collections::hash_map::Entry;
-use std::collections::{BTreeMap, HashMap};
+use std::collections::{BTreeMap, HashMap, VecDeque};
 use std::fmt::Debug;
-use std::io::{Seek, Write};
-use std::sync::Arc;
+use std::io::{Read, Seek, Write};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, OnceLock};
+use std::thread::JoinHandle;
+use std::time::{Duration, Instant};
 
 type McapChannelId = u16;
 
+/// Opens the user-provided writer for the segment with the given index.
+pub(crate) type SegmentFn<W> = Box<dyn FnMut(u32) -> Result<W, FoxgloveError> + Send>;
+
+/// Minimum interval between warnings about failed writes on the background writer thread.
+const WRITE_ERROR_WARN_INTERVAL: Duration = Duration::from_secs(10);
+
+/// Counters for the messages written by an [`McapSink`], which can be read while a message is
+/// being written.
+#[derive(Debug, Default)]
+struct WriteCounters {
+    messages: AtomicU64,
+    bytes: AtomicU64,
+    // Bytes written to the output, across all segments.
+    written_bytes: AtomicU64,
+    write_nanos: AtomicU64,
+}
+
 struct WriterState<W: Write + Seek> {
-    writer: mcap::Writer<W>,
+    writer: SegmentWriter<PipelinedWriter<W>>,
+    // Bytes written to the current segment.
+    bytes_written: Arc<AtomicU64>,
+    // Bytes written to the previous segments.
+    previous_bytes_written: u64,
+    counters: Arc<WriteCounters>,
     // ChannelId -> mcap file channel id.
     //
     // Note that the underlying writer may re-use channel_ids based on the metadata of the channel,
@@ -20,15 +58,70 @@ struct WriterState<W: Write + Seek> {
     // Current message sequence number for each channel.
     // Indexed by `McapChannelId` to ensure increasing sequence within each MCAP channel.
     channel_sequence: HashMap<McapChannelId, u32>,
+    // Every channel logged so far, so that each segment can declare all of them.
+    channels: Vec<ChannelDescriptor>,
+    // The last messages of each latched channel, so that each segment begins with them.
+    latched: HashMap<ChannelId, (ChannelDescriptor, VecDeque<(Bytes, Metadata)>)>,
+    rotation: Option<Rotation<W>>,
+    checkpoint: Option<Checkpoint>,
+    adaptive_chunks: Option<AdaptiveChunks>,
+    chunk_streams: ChunkStreamOptions,
+    // The account charged for the records of the open chunks.
+    memory: Arc<MemoryAccount>,
+    // Bytes of message records written since the output last grew, which the writer holds in its
+    // open chunks.
+    chunk_bytes: usize,
+    // Bytes written to the output of the current segment when `chunk_bytes` was last reset.
+    chunk_output: u64,
 }
 
 impl<W: Write + Seek> WriterState<W> {
-    fn new(writer: mcap::Writer<W>) -> Self {
+    fn new(
+        writer: SegmentWriter<PipelinedWriter<W>>,
+        bytes_written: Arc<AtomicU64>,
+        chunk_streams: ChunkStreamOptions,
+        counters: Arc<WriteCounters>,
+        memory: Arc<MemoryAccount>,
+    ) -> Self {
+        let chunk_output = bytes_written.load(Ordering::Relaxed);
         Self {
             writer,
+            bytes_written,
+            previous_bytes_written: 0,
+            counters,
             channel_map: HashMap::new(),
             channel_sequence: HashMap::new(),
+            channels: Vec::new(),
+            latched: HashMap::new(),
+            rotation: None,
+            checkpoint: None,
+            adaptive_chunks: None,
+            chunk_streams,
+            memory,
+            chunk_bytes: 0,
+            chunk_output,
+        }
+    }
+
+    /// Charges a message record written to the open chunks to the memory budget.
+    ///
+    /// The writer holds the records of a chunk until it is full, then compresses the chunk and
+    /// writes it to the output. The records are charged until the output grows, which
+    /// approximates the chunk being finished.
+    fn charge_chunk(&mut self, len: usize) {
+        if self.bytes_written.load(Ordering::Relaxed) != self.chunk_output {
+            self.release_chunks();
         }
+        let bytes = len + MESSAGE_RECORD_OVERHEAD as usize;
+        self.memory.charge(bytes);
+        self.chunk_bytes += bytes;
+    }
+
+    /// Releases the records charged by [`WriterState::charge_chunk`], once the open chunks have
+    /// been written.
+    fn release_chunks(&mut self) {
+        self.memory.release(std::mem::take(&mut self.chunk_bytes));
+        self.chunk_output = self.bytes_written.load(Ordering::Relaxed);
     }
 
     fn next_sequence(&mut self, channel_id: McapChannelId) -> u32 {
@@ -39,60 +132,196 @@ impl<W: Write + Seek> WriterState<W> {
             .or_insert(1)
     }
 
+    fn add_channel(&mut self, channel: &ChannelDescriptor) -> Result<McapChannelId, FoxgloveError> {
+        let schema_id = if let Some(schema) = channel.schema() {
+            let schema_id = self
+                .writer
+                .add_schema(&schema.name, &schema.encoding, &schema.data)?;
+            if let Some(checkpoint) = &mut self.checkpoint {
+                checkpoint.record_schema(
+                    schema_id,
+                    &schema.name,
+                    &schema.encoding,
+                    &schema.data,
+                )?;
+            }
+            schema_id
+        } else {
+            0 // 0 indicates a channel without a schema
+        };
+
+        let channel_id = self.writer.add_channel(schema_id, channel)?;
+        if let Some(checkpoint) = &mut self.checkpoint {
+            checkpoint.record_channel(
+                channel_id,
+                schema_id,
+                channel.topic(),
+                channel.message_encoding(),
+                channel.metadata(),
+            )?;
+        }
+        Ok(channel_id)
+    }
+
     fn log(
         &mut self,
-        channel: &RawChannel,
+        channel: &ChannelDescriptor,
+        msg: &[u8],
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        let keep_last = channel.keep_last();
+        if keep_last > 0 && self.rotation.is_some() {
+            let (_, latched) = self
+                .latched
+                .entry(channel.id())
+                .or_insert_with(|| (channel.clone(), VecDeque::new()));
+            if latched.len() >= keep_last {
+                latched.pop_front();
+            }
+            latched.push_back((Bytes::copy_from_slice(msg), *metadata));
+        }
+        self.write(channel, msg, metadata)
+    }
+
+    fn write(
+        &mut self,
+        channel: &ChannelDescriptor,
         msg: &[u8],
         metadata: &Metadata,
     ) -> Result<(), FoxgloveError> {
-        let channel_id = channel.id();
-        let mcap_channel_id = match self.channel_map.entry(channel_id) {
-            Entry::Occupied(entry) => *entry.get(),
-            Entry::Vacant(entry) => {
-                let schema_id = if let Some(schema) = channel.schema() {
-                    self.writer
-                        .add_schema(&schema.name, &schema.encoding, &schema.data)
-                        .map_err(FoxgloveError::from)?
-                } else {
-                    0 // 0 indicates a channel without a schema
-                };
-
-                let mcap_channel_id = self
-                    .writer
-                    .add_channel(
-                        schema_id,
-                        channel.topic(),
-                        channel.message_encoding(),
-                        channel.metadata(),
-                    )
-                    .map_err(FoxgloveError::from)?;
-
-                entry.insert(mcap_channel_id);
+        let mcap_channel_id = match self.channel_map.get(&channel.id()) {
+            Some(id) => *id,
+            None => {
+                let mcap_channel_id = self.add_channel(channel)?;
+                self.channel_map.insert(channel.id(), mcap_channel_id);
+                if self.rotation.is_some() {
+                    self.channels.push(channel.clone());
+                }
                 mcap_channel_id
             }
         };
 
         let sequence = self.next_sequence(mcap_channel_id);
 
-        self.writer
-            .write_to_known_channel(
-                &mcap::records::MessageHeader {
-                    channel_id: mcap_channel_id,
-                    sequence,
-                    log_time: metadata.log_time,
-                    // Use log_time as publish_time (required when publish_time unavailable)
-                    publish_time: metadata.log_time,
-                },
-                msg,
-            )
-            .map_err(FoxgloveError::from)
+        if let Some(chunks) = &mut self.adaptive_chunks {
+            chunks.wrote(msg.len(), self.bytes_written.load(Ordering::Relaxed));
+        }
+
+        // The writer encodes the message into the current chunk, and compresses the chunk once
+        // it is full, so the time spent writing includes the chunk's compression.
+        let start = Instant::now();
+        self.writer.write_to_known_channel(
+            &mcap::records::MessageHeader {
+                channel_id: mcap_channel_id,
+                sequence,
+                log_time: metadata.log_time,
+                // Use log_time as publish_time (required when publish_time unavailable)
+                publish_time: metadata.log_time,
+            },
+            msg,
+        )?;
+        self.charge_chunk(msg.len());
+
+        let checkpoint_due = self.checkpoint.as_ref().is_some_and(Checkpoint::is_due);
+        let chunk_due = self
+            .adaptive_chunks
+            .as_ref()
+            .is_some_and(AdaptiveChunks::is_due);
+        if checkpoint_due || chunk_due {
+            self.flush()?;
+            if let Some(checkpoint) = &mut self.checkpoint {
+                checkpoint.checkpointed();
+            }
+        }
+
+        let counters = &self.counters;
+        counters.messages.fetch_add(1, Ordering::Relaxed);
+        counters
+            .bytes
+            .fetch_add(msg.len() as u64, Ordering::Relaxed);
+        counters.write_nanos.fetch_add(
+            u64::try_from(start.elapsed().as_nanos()).unwrap_or(u64::MAX),
+            Ordering::Relaxed,
+        );
+        counters.written_bytes.store(
+            self.previous_bytes_written + self.bytes_written.load(Ordering::Relaxed),
+            Ordering::Relaxed,
+        );
+        Ok(())
     }
+
+    /// Finishes the current chunks, and flushes the underlying writer.
+    fn flush(&mut self) -> Result<(), FoxgloveError> {
+        self.writer.flush()?;
+        self.release_chunks();
+        if let Some(chunks) = &mut self.adaptive_chunks {
+            chunks.finished(self.bytes_written.load(Ordering::Relaxed));
+        }
+        Ok(())
+    }
+
+    /// Starts a new segment if the rotation policy calls for it.
+    ///
+    /// The next segment is opened, and its schemas, channels and the retained messages of latched
+    /// channels written, before the previous one is released. Returns the previous segment's
+    /// writer, which the caller must finish.
+    fn rotate_if_needed(
+        &mut self,
+    ) -> Result<Option<SegmentWriter<PipelinedWriter<W>>>, FoxgloveError> {
+        let Some(rotation) = &mut self.rotation else {
+            return Ok(None);
+        };
+        if !rotation.should_rotate(self.bytes_written.load(Ordering::Relaxed)) {
+            return Ok(None);
+        }
+        let writer = rotation.open_next()?;
+        let bytes_written = writer.bytes_written();
+        let writer = SegmentWriter::new(writer, rotation.options(), &self.chunk_streams)?;
+        let previous = std::mem::replace(&mut self.writer, writer);
+        self.previous_bytes_written += self.bytes_written.load(Ordering::Relaxed);
+        self.bytes_written = bytes_written;
+        // The previous segment's chunks are written when it's finished.
+        self.release_chunks();
+        if let Some(chunks) = &mut self.adaptive_chunks {
+            chunks.discard();
+        }
+        self.channel_map.clear();
+        self.channel_sequence.clear();
+        for channel in std::mem::take(&mut self.channels) {
+            let mcap_channel_id = self.add_channel(&channel)?;
+            self.channel_map.insert(channel.id(), mcap_channel_id);
+            self.channels.push(channel);
+        }
+        let latched = std::mem::take(&mut self.latched);
+        for (channel, messages) in latched.values() {
+            for (msg, metadata) in messages {
+                self.write(channel, msg, metadata)?;
+            }
+        }
+        self.latched = latched;
+        Ok(Some(previous))
+    }
+}
+
+/// Finishes a segment returned by [`WriterState::rotate_if_needed`], and closes its writer.
+fn finish_segment<W: Write + Seek>(
+    segment: Option<SegmentWriter<PipelinedWriter<W>>>,
+) -> Result<(), FoxgloveError> {
+    if let Some(writer) = segment {
+        writer.finish()?.into_inner()?;
+    }
+    Ok(())
 }
 
 pub struct McapSink<W: Write + Seek> {
     sink_id: SinkId,
-    inner: Mutex<Option<WriterState<W>>>,
+    inner: Arc<Mutex<Option<WriterState<W>>>>,
     channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+    message_filter: OnceLock<Arc<dyn MessageFilter>>,
+    // Present when messages are written on a background thread.
+    queue: Option<Arc<WriteQueue>>,
+    worker: Mutex<Option<JoinHandle<()>>>,
+    counters: Arc<WriteCounters>,
 }
 impl<W: Write + Seek> Debug for McapSink<W> {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
@@ -103,30 +332,97 @@ impl<W: Write + Seek> Debug for McapSink<W> {
 }
 
 impl<W: Write + Seek> McapSink<W> {
-    /// Creates a new MCAP writer sink.
+    /// Creates a new MCAP writer sink, which writes on the logging thread and isn't charged to a
+    /// memory budget.
+    #[cfg(test)]
     pub fn new(
         writer: W,
         options: WriteOptions,
         channel_filter: Option<Arc<dyn SinkChannelFilter>>,
     ) -> Result<Arc<McapSink<W>>, FoxgloveError> {
-        let mcap_writer = options.create(writer).map_err(FoxgloveError::from)?;
-        let writer = Arc::new(Self {
+        let sink = Self::from_writer(
+            PipelinedWriter::direct(writer),
+            options,
+            channel_filter,
+            ChunkStreamOptions::default(),
+            Arc::new(MemoryAccount::detached(crate::MemoryPool::Mcap)),
+        )?;
+        Ok(Arc::new(sink))
+    }
+
+    fn from_writer(
+        writer: PipelinedWriter<W>,
+        options: WriteOptions,
+        channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+        chunk_streams: ChunkStreamOptions,
+        memory: Arc<MemoryAccount>,
+    ) -> Result<Self, FoxgloveError> {
+        let bytes_written = writer.bytes_written();
+        let mcap_writer = SegmentWriter::new(writer, options, &chunk_streams)?;
+        let counters = Arc::new(WriteCounters::default());
+        let state = WriterState::new(
+            mcap_writer,
+            bytes_written,
+            chunk_streams,
+            counters.clone(),
+            memory,
+        );
+        Ok(Self {
             sink_id: SinkId::next(),
-            inner: Mutex::new(Some(WriterState::new(mcap_writer))),
+            inner: Arc::new(Mutex::new(Some(state))),
             channel_filter,
-        });
-        Ok(writer)
+            message_filter: OnceLock::new(),
+            queue: None,
+            worker: Mutex::new(None),
+            counters,
+        })
     }
 
     /// Finalizes the MCAP recording and flushes it to the file.
     ///
+    /// If messages are written on a background thread, this first waits for the queued
+    /// messages to be written and for the thread to exit.
+    ///
     /// Returns the inner writer that was passed to [`McapWriter::new`].
     pub fn finish(&self) -> Result<Option<W>, FoxgloveError> {
-        let Some(mut writer) = self.inner.lock().take() else {
+        if let Some(queue) = &self.queue {
+            queue.close();
+            if let Some(worker) = self.worker.lock().take() {
+                if worker.join().is_err() {
+                    tracing::error!("MCAP writer thread panicked");
+                }
+            }
+        }
+        let Some(writer) = self.inner.lock().take() else {
             return Ok(None);
         };
-        writer.writer.finish()?;
-        Ok(Some(writer.writer.into_inner()))
+        let inner = writer.writer.finish()?.into_inner()?;
+        if let Some(checkpoint) = writer.checkpoint {
+            if let Err(e) = checkpoint.finish() {
+                tracing::warn!("Failed to remove MCAP checkpoint journal: {e}");
+            }
+        }
+        Ok(Some(inner))
+    }
+
+    /// Enables periodic checkpoints. Must be called before any messages are logged.
+    pub(crate) fn set_checkpoint(&self, checkpoint: Checkpoint) {
+        if let Some(state) = self.inner.lock().as_mut() {
+            state.checkpoint = Some(checkpoint);
+        }
+    }
+
+    /// Chooses chunk boundaries adaptively. Must be called before any messages are logged.
+    pub(crate) fn set_adaptive_chunks(&self, chunks: AdaptiveChunks) {
+        if let Some(state) = self.inner.lock().as_mut() {
+            state.adaptive_chunks = Some(chunks);
+        }
+    }
+
+    /// Sets the filter which runs on messages before they are written. Must be called before the
+    /// sink is added to a context.
+    pub(crate) fn set_message_filter(&self, filter: Arc<dyn MessageFilter>) {
+        let _ = self.message_filter.set(filter);
     }
 
     /// Finishes the current chunk (if any) and flushes the underlying writer.
@@ -136,9 +432,12 @@ impl<W: Write + Seek> McapSink<W> {
     /// * `Err(FoxgloveError::SinkClosed)` if the writer has been closed
     /// * `Err(FoxgloveError)` if there was an error writing to the file
     pub fn flush(&self) -> Result<(), FoxgloveError> {
+        if let Some(queue) = &self.queue {
+            queue.wait_idle();
+        }
         let mut guard = self.inner.lock();
         let writer = guard.as_mut().ok_or(FoxgloveError::SinkClosed)?;
-        writer.writer.flush().map_err(FoxgloveError::from)
+        writer.flush()
     }
 
     /// Writes MCAP metadata to the file.
@@ -166,13 +465,10 @@ impl<W: Write + Seek> McapSink<W> {
         let mut guard = self.inner.lock();
         let writer = guard.as_mut().ok_or(FoxgloveError::SinkClosed)?;
 
-        writer
-            .writer
-            .write_metadata(&mcap::records::Metadata {
-                name: name.into(),
-                metadata,
-            })
-            .map_err(FoxgloveError::from)
+        writer.writer.write_metadata(&mcap::records::Metadata {
+            name: name.into(),
+            metadata,
+        })
     }
 
     /// Writes an attachment to the MCAP file.
@@ -192,10 +488,158 @@ impl<W: Write + Seek> McapSink<W> {
         let mut guard = self.inner.lock();
         let writer = guard.as_mut().ok_or(FoxgloveError::SinkClosed)?;
 
-        writer
-            .writer
-            .attach(attachment)
-            .map_err(FoxgloveError::from)
+        writer.writer.attach(attachment)
+    }
+
+    /// Writes an attachment whose `length` bytes of data are read from `data`.
+    ///
+    /// The data is copied to the file in blocks, so it is never held in memory all at once. The
+    /// writer is locked while the data is copied, so messages logged meanwhile are delayed.
+    ///
+    /// If reading fails or `data` ends early, the rest of the attachment is filled with zeros so
+    /// that the file remains valid, and the error is returned.
+    pub fn attach_reader(
+        &self,
+        header: &mcap::records::AttachmentHeader,
+        length: u64,
+        data: &mut dyn Read,
+    ) -> Result<(), FoxgloveError> {
+        let mut guard = self.inner.lock();
+        let writer = guard.as_mut().ok_or(FoxgloveError::SinkClosed)?;
+
+        writer.writer.attach_reader(header, length, data)
+    }
+}
+
+impl<W: Write + Seek + Send + 'static> McapSink<W> {
+    /// Creates a new MCAP writer sink, which may use background threads.
+    ///
+    /// The records of the chunks being built are charged to `memory`.
+    ///
+    /// If `async_options` is provided, logged messages are copied into a bounded queue, and
+    /// serialization, compression, and I/O happen on a writer thread. The queued bytes are also
+    /// charged to the budget of `memory`.
+    ///
+    /// If `pipeline_depth` is non-zero, completed chunks are written to `writer` by a separate
+    /// I/O thread, so that the next chunk can be built and compressed while the previous one is
+    /// written. Up to `pipeline_depth` blocks of output are queued before writes block, and are
+    /// charged to `memory` until they are written.
+    ///
+    /// If `rotation` is provided, `writer` is the first segment, and subsequent segments are
+    /// opened with the provided function when the rotation policy calls for it.
+    ///
+    /// If `chunk_streams` sets a compression policy or zstd dictionaries, channels are written to
+    /// separately compressed streams of chunks.
+    pub fn new_threaded(
+        writer: W,
+        options: WriteOptions,
+        channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+        async_options: Option<&McapAsyncOptions>,
+        memory: MemoryAccount,
+        pipeline_depth: usize,
+        rotation: Option<(McapRotation, SegmentFn<W>)>,
+        chunk_streams: ChunkStreamOptions,
+    ) -> Result<Arc<McapSink<W>>, FoxgloveError> {
+        let queue_memory = memory.sibling();
+        let memory = Arc::new(memory);
+        let writer = PipelinedWriter::with_depth(writer, pipeline_depth, memory.clone())?;
+        let rotation = rotation.map(|(policy, mut open)| {
+            let memory = memory.clone();
+            let open_segment: OpenSegment<W> = Box::new(move |index| {
+                let writer = open(index)?;
+                Ok(PipelinedWriter::with_depth(
+                    writer,
+                    pipeline_depth,
+                    memory.clone(),
+                )?)
+            });
+            Rotation::new(policy, options.clone(), open_segment)
+        });
+        let mut sink = Self::from_writer(writer, options, channel_filter, chunk_streams, memory)?;
+        if let Some(state) = sink.inner.lock().as_mut() {
+            state.rotation = rotation;
+        }
+        if let Some(async_options) = async_options {
+            let queue = Arc::new(WriteQueue::new(async_options, queue_memory));
+            let worker = std::thread::Builder::new()
+                .name("foxglove-mcap-writer".into())
+                .spawn({
+                    let inner = sink.inner.clone();
+                    let queue = queue.clone();
+                    let sink_id = sink.sink_id;
+                    move || run_writer(&queue, &inner, sink_id)
+                })?;
+            sink.queue = Some(queue);
+            sink.worker = Mutex::new(Some(worker));
+        }
+        Ok(Arc::new(sink))
+    }
+}
+
+impl<W: Write + Seek> McapSink<W> {
+    /// Returns the current queue depth and the number of messages dropped by the overflow
+    /// policy. Both are zero unless messages are written on a background thread.
+    pub fn stats(&self) -> McapWriterStats {
+        self.queue
+            .as_ref()
+            .map(|queue| queue.stats())
+            .unwrap_or_default()
+    }
+}
+
+impl<W: Write + Seek> Drop for McapSink<W> {
+    fn drop(&mut self) {
+        // Let the writer thread exit if the sink was dropped without being finished.
+        if let Some(queue) = &self.queue {
+            queue.close();
+        }
+    }
+}
+
+/// Writes queued messages until the queue is closed and drained.
+fn run_writer<W: Write + Seek>(
+    queue: &WriteQueue,
+    inner: &Mutex<Option<WriterState<W>>>,
+    sink_id: SinkId,
+) {
+    struct FinishGuard<'a>(&'a WriteQueue);
+    impl Drop for FinishGuard<'_> {
+        fn drop(&mut self) {
+            self.0.finished();
+        }
+    }
+    let _guard = FinishGuard(queue);
+
+    let mut batch = VecDeque::new();
+    let mut warn_throttler = Throttler::new(WRITE_ERROR_WARN_INTERVAL);
+    while queue.take(&mut batch) {
+        let mut guard = inner.lock();
+        if let Some(writer) = guard.as_mut() {
+            for message in &batch {
+                let mut trace = message.trace;
+                if let Some(trace) = &mut trace {
+                    trace.dequeue();
+                }
+                let result = writer
+                    .log(&message.channel, &message.data, &message.metadata)
+                    .and_then(|()| finish_segment(writer.rotate_if_needed()?));
+                match result {
+                    Ok(()) => {
+                        if let Some(trace) = trace {
+                            trace.finish(sink_id, message.channel.id());
+                        }
+                    }
+                    Err(e) => {
+                        if warn_throttler.try_acquire() {
+                            tracing::warn!("Failed to write MCAP message: {e}");
+                        }
+                    }
+                }
+            }
+        }
+        drop(guard);
+        batch.clear();
+        queue.done();
     }
 }
 
@@ -210,16 +654,88 @@ impl<W: Write + Seek + Send> Sink for McapSink<W> {
         msg: &[u8],
         metadata: &Metadata,
     ) -> Result<(), FoxgloveError> {
-        _ = metadata;
+        if let Some(queue) = &self.queue {
+            return queue.push(std::iter::once(QueuedMessage {
+                channel: channel.descriptor().clone(),
+                data: Bytes::copy_from_slice(msg),
+                metadata: *metadata,
+                trace: latency::enqueue(),
+            }));
+        }
+        // Without a writer thread, the time spent waiting for the writer is the queueing delay.
+        let mut trace = latency::enqueue();
         let mut guard = self.inner.lock();
+        if let Some(trace) = &mut trace {
+            trace.dequeue();
+        }
         let writer = guard.as_mut().ok_or(FoxgloveError::SinkClosed)?;
-        writer.log(channel, msg, metadata)
+        writer.log(channel.descriptor(), msg, metadata)?;
+        let previous = writer.rotate_if_needed()?;
+        drop(guard);
+        if let Some(trace) = trace {
+            trace.finish(self.sink_id, channel.id());
+        }
+        finish_segment(previous)
+    }
+
+    fn log_shared(
+        &self,
+        channel: &RawChannel,
+        msg: &Bytes,
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        // The writer thread holds a reference to the buffer rather than a copy.
+        if let Some(queue) = &self.queue {
+            return queue.push(std::iter::once(QueuedMessage {
+                channel: channel.descriptor().clone(),
+                data: msg.clone(),
+                metadata: *metadata,
+                trace: latency::enqueue(),
+            }));
+        }
+        self.log(channel, msg, metadata)
+    }
+
+    fn log_batch(
+        &self,
+        channel: &RawChannel,
+        msgs: &[(&[u8], Metadata)],
+    ) -> Result<(), FoxgloveError> {
+        if let Some(queue) = &self.queue {
+            let descriptor = channel.descriptor();
+            let messages: Vec<_> = msgs
+                .iter()
+                .map(|(msg, metadata)| QueuedMessage {
+                    channel: descriptor.clone(),
+                    data: Bytes::copy_from_slice(msg),
+                    metadata: *metadata,
+                    trace: None,
+                })
+                .collect();
+            return queue.push(messages);
+        }
+        let mut guard = self.inner.lock();
+        let writer = guard.as_mut().ok_or(FoxgloveError::SinkClosed)?;
+        for (msg, metadata) in msgs {
+            writer.log(channel.descriptor(), msg, metadata)?;
+        }
+        let previous = writer.rotate_if_needed()?;
+        drop(guard);
+        finish_segment(previous)
+    }
+
+    fn message_filter(&self) -> Option<&Arc<dyn MessageFilter>> {
+        self.message_filter.get()
     }
 
     fn auto_subscribe(&self) -> bool {
         self.channel_filter.is_none()
     }
 
+    fn is_lossless(&self) -> bool {
+        self.queue.as_ref().is_none_or(|queue| queue.blocks())
+    }
+
     fn add_channels(&self, channels: &[&Arc<RawChannel>]) -> Option<Vec<ChannelId>> {
         let filter = self.channel_filter.as_ref()?;
         let channel_ids = channels
@@ -229,12 +745,27 @@ impl<W: Write + Seek + Send> Sink for McapSink<W> {
             .collect();
         Some(channel_ids)
     }
+
+    fn sink_stats(&self) -> Option<SinkStats> {
+        let stats = self.stats();
+        let counters = &self.counters;
+        Some(SinkStats {
+            kind: "mcap",
+            queued_messages: stats.queue_depth,
+            sent_messages: counters.messages.load(Ordering::Relaxed),
+            sent_bytes: counters.bytes.load(Ordering::Relaxed),
+            dropped_messages: stats.dropped_messages,
+            written_bytes: counters.written_bytes.load(Ordering::Relaxed),
+            write_time: Duration::from_nanos(counters.write_nanos.load(Ordering::Relaxed)),
+            ..SinkStats::default()
+        })
+    }
 }
 
 #[cfg(test)]
 mod tests {
     use super::*;
-    use crate::{ChannelBuilder, Context, Metadata, Schema, testutil::read_summary};
+    use crate::{ChannelBuilder, Context, MemoryPool, Metadata, Schema, testutil::read_summary};
     use mcap::McapError;
     use std::path::Path;
     use tempfile::NamedTempFile;
@@ -349,6 +880,29 @@ mod tests {
         .expect("failed to read MCAP messages");
     }
 
+    #[test]
+    fn test_sink_stats_count_written_messages() {
+        let ctx = Context::new();
+        let ch = new_test_channel(&ctx, "foo".to_string(), "foo_schema".to_string());
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let writer = McapSink::new(&temp_file, WriteOptions::default(), None)
+            .expect("failed to create writer");
+        writer
+            .log(&ch, b"msg1", &Metadata { log_time: 1 })
+            .expect("failed to log");
+        writer
+            .log_batch(&ch, &[(&b"msg22"[..], Metadata { log_time: 2 })])
+            .expect("failed to log");
+
+        let stats = writer.sink_stats().expect("sink stats");
+        assert_eq!(stats.kind, "mcap");
+        assert_eq!(stats.sent_messages, 2);
+        assert_eq!(stats.sent_bytes, 9);
+        // The file's header is written before the first message.
+        assert!(stats.written_bytes > 0);
+        writer.finish().expect("failed to finish recording");
+    }
+
     #[test]
     fn test_message_sequence_increases_by_channel() {
         let ctx = Context::new();
@@ -715,6 +1269,126 @@ mod tests {
         assert_eq!(image.1, &[0x89, 0x50, 0x4E, 0x47]);
     }
 
+    fn attachment_header(name: &str) -> mcap::records::AttachmentHeader {
+        mcap::records::AttachmentHeader {
+            log_time: 100,
+            create_time: 200,
+            name: name.to_string(),
+            media_type: "application/octet-stream".to_string(),
+        }
+    }
+
+    #[test]
+    fn test_attach_reader() {
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+
+        let writer = McapSink::new(&temp_file, WriteOptions::default(), None)
+            .expect("failed to create writer");
+
+        // Larger than one block, and not a multiple of the block size.
+        let data: Vec<u8> = (0..200_003u32).map(|i| (i % 251) as u8).collect();
+        writer
+            .attach_reader(
+                &attachment_header("bundle.tar"),
+                data.len() as u64,
+                &mut data.as_slice(),
+            )
+            .expect("failed to attach");
+        writer.finish().expect("failed to finish recording");
+
+        let mut found_attachments = Vec::new();
+        foreach_mcap_attachment(&temp_path, |header, data| {
+            found_attachments.push((header.clone(), data.to_vec()));
+        })
+        .expect("failed to read MCAP attachments");
+        assert_eq!(found_attachments.len(), 1);
+        let (header, found) = &found_attachments[0];
+        assert_eq!(header.log_time, 100);
+        assert_eq!(header.create_time, 200);
+        assert_eq!(header.name, "bundle.tar");
+        assert_eq!(found, &data);
+    }
+
+    #[test]
+    fn test_attach_reader_with_chunk_streams() {
+        use crate::mcap_writer::compression_policy::{
+            McapChunkCompression, McapCompressionPolicyFn,
+        };
+
+        let ctx = Context::new();
+        let ch = new_test_channel(&ctx, "foo".to_string(), "foo_schema".to_string());
+
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+        let file = temp_file.reopen().expect("reopen tempfile");
+
+        let policy =
+            McapCompressionPolicyFn(|_: &ChannelDescriptor| Some(McapChunkCompression::NONE));
+        let chunk_streams = ChunkStreamOptions {
+            policy: Some(Arc::new(policy)),
+            ..Default::default()
+        };
+        let writer = McapSink::new_threaded(
+            file,
+            WriteOptions::default(),
+            None,
+            None,
+            MemoryAccount::detached(MemoryPool::Mcap),
+            0,
+            None,
+            chunk_streams,
+        )
+        .expect("failed to create writer");
+
+        let data: Vec<u8> = (0..100_000u32).map(|i| (i % 13) as u8).collect();
+        writer
+            .log(&ch, b"before", &Metadata { log_time: 1 })
+            .expect("failed to log");
+        writer
+            .attach_reader(
+                &attachment_header("tiles.bin"),
+                data.len() as u64,
+                &mut data.as_slice(),
+            )
+            .expect("failed to attach");
+        writer
+            .log(&ch, b"after", &Metadata { log_time: 2 })
+            .expect("failed to log");
+        writer.finish().expect("failed to finish recording");
+
+        let contents = std::fs::read(&temp_path).expect("failed to read file");
+        let summary = read_summary(&temp_path);
+        assert_eq!(summary.attachment_indexes.len(), 1);
+        let attachment = mcap::read::attachment(&contents, &summary.attachment_indexes[0])
+            .expect("failed to read attachment");
+        assert_eq!(attachment.name, "tiles.bin");
+        assert_eq!(attachment.data.as_ref(), data.as_slice());
+
+        let mut messages = Vec::new();
+        foreach_mcap_message(&temp_path, |msg| messages.push(msg.data.to_vec()))
+            .expect("failed to read messages");
+        assert_eq!(messages, vec![b"before".to_vec(), b"after".to_vec()]);
+    }
+
+    #[test]
+    fn test_attach_reader_short_data() {
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+
+        let writer = McapSink::new(&temp_file, WriteOptions::default(), None)
+            .expect("failed to create writer");
+
+        let result = writer.attach_reader(&attachment_header("short.bin"), 10, &mut &b"abc"[..]);
+        assert!(matches!(result, Err(FoxgloveError::ValueError(_))));
+        writer.finish().expect("failed to finish recording");
+
+        let mut found_attachments = Vec::new();
+        foreach_mcap_attachment(&temp_path, |_, data| found_attachments.push(data.to_vec()))
+            .expect("failed to read MCAP attachments");
+        assert_eq!(found_attachments, vec![vec![0; 10]]);
+    }
+
     #[test]
     fn test_flush_writes_data_to_underlying_writer() {
         let temp_file = NamedTempFile::new().expect("create tempfile");
@@ -784,4 +1458,489 @@ mod tests {
         assert!(result.is_err(), "Should fail to attach after close");
         assert!(matches!(result.unwrap_err(), FoxgloveError::SinkClosed));
     }
+
+    #[test]
+    fn test_async_log() {
+        let ctx = Context::new();
+        let ch1 = new_test_channel(&ctx, "foo".to_string(), "foo_schema".to_string());
+        let ch2 = new_test_channel(&ctx, "bar".to_string(), "bar_schema".to_string());
+
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+        let file = temp_file.reopen().expect("reopen tempfile");
+
+        let writer = McapSink::new_threaded(
+            file,
+            WriteOptions::default(),
+            None,
+            Some(&McapAsyncOptions::default()),
+            MemoryAccount::detached(MemoryPool::Mcap),
+            0,
+            None,
+            ChunkStreamOptions::default(),
+        )
+        .expect("failed to create writer");
+        writer
+            .log(&ch1, b"msg1", &Metadata { log_time: 1 })
+            .expect("failed to log to channel 1");
+        writer
+            .log_batch(
+                &ch2,
+                &[
+                    (&b"msg2"[..], Metadata { log_time: 2 }),
+                    (&b"msg3"[..], Metadata { log_time: 3 }),
+                ],
+            )
+            .expect("failed to log batch to channel 2");
+        writer.flush().expect("failed to flush");
+        assert_eq!(writer.stats(), McapWriterStats::default());
+        writer.finish().expect("failed to finish recording");
+
+        let result = writer.log(&ch1, b"msg4", &Metadata { log_time: 4 });
+        assert!(matches!(result, Err(FoxgloveError::SinkClosed)));
+
+        let mut messages = vec![];
+        foreach_mcap_message(&temp_path, |msg| {
+            messages.push((msg.channel.topic.clone(), msg.data.to_vec(), msg.log_time))
+        })
+        .expect("failed to read messages");
+        assert_eq!(
+            messages,
+            vec![
+                ("foo".to_string(), b"msg1".to_vec(), 1),
+                ("bar".to_string(), b"msg2".to_vec(), 2),
+                ("bar".to_string(), b"msg3".to_vec(), 3),
+            ]
+        );
+    }
+
+    #[test]
+    fn test_async_log_shared() {
+        use std::sync::atomic::AtomicBool;
+
+        struct Owner(Vec<u8>, Arc<AtomicBool>);
+        impl AsRef<[u8]> for Owner {
+            fn as_ref(&self) -> &[u8] {
+                &self.0
+            }
+        }
+        impl Drop for Owner {
+            fn drop(&mut self) {
+                self.1.store(true, Ordering::Relaxed);
+            }
+        }
+
+        let ctx = Context::new();
+        let ch = new_test_channel(&ctx, "foo".to_string(), "foo_schema".to_string());
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+        let file = temp_file.reopen().expect("reopen tempfile");
+        let writer = McapSink::new_threaded(
+            file,
+            WriteOptions::default(),
+            None,
+            Some(&McapAsyncOptions::default()),
+            MemoryAccount::detached(MemoryPool::Mcap),
+            0,
+            None,
+            ChunkStreamOptions::default(),
+        )
+        .expect("failed to create writer");
+
+        // The writer thread holds the buffer until the message is written.
+        let released = Arc::new(AtomicBool::new(false));
+        let msg = Bytes::from_owner(Owner(b"shared".to_vec(), released.clone()));
+        writer
+            .log_shared(&ch, &msg, &Metadata { log_time: 1 })
+            .expect("failed to log");
+        drop(msg);
+        writer.finish().expect("failed to finish recording");
+        assert!(released.load(Ordering::Relaxed));
+
+        let mut messages = vec![];
+        foreach_mcap_message(&temp_path, |msg| messages.push(msg.data.to_vec()))
+            .expect("failed to read messages");
+        assert_eq!(messages, vec![b"shared".to_vec()]);
+    }
+
+    #[test]
+    fn test_pipelined_io() {
+        let ctx = Context::new();
+        let ch = new_test_channel(&ctx, "foo".to_string(), "foo_schema".to_string());
+
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+        let file = temp_file.reopen().expect("reopen tempfile");
+
+        // Use small chunks, so that several are in flight at once.
+        let options = WriteOptions::default()
+            .compression(Some(mcap::Compression::Lz4))
+            .chunk_size(Some(1024));
+        let writer = McapSink::new_threaded(
+            file,
+            options,
+            None,
+            None,
+            MemoryAccount::detached(MemoryPool::Mcap),
+            2,
+            None,
+            ChunkStreamOptions::default(),
+        )
+        .expect("failed to create writer");
+        let payload = vec![7u8; 600];
+        for log_time in 0..100 {
+            writer
+                .log(&ch, &payload, &Metadata { log_time })
+                .expect("failed to log");
+        }
+        writer.flush().expect("failed to flush");
+        writer.finish().expect("failed to finish recording");
+
+        let summary = read_summary(&temp_path);
+        assert_eq!(summary.stats.unwrap().message_count, 100);
+        assert!(summary.chunk_indexes.len() > 1);
+
+        let mut log_times = vec![];
+        foreach_mcap_message(&temp_path, |msg| {
+            assert_eq!(msg.data.as_ref(), payload.as_slice());
+            log_times.push(msg.log_time);
+        })
+        .expect("failed to read messages");
+        assert_eq!(log_times, (0..100).collect::<Vec<_>>());
+    }
+
+    #[test]
+    fn test_open_chunk_is_charged_to_memory_budget() {
+        let ctx = Context::new();
+        let ch = new_test_channel(&ctx, "foo".to_string(), "foo_schema".to_string());
+        let mcap_bytes = |ctx: &Context| {
+            let usage = ctx.memory_usage();
+            let pool = usage.pools.iter().find(|p| p.pool == MemoryPool::Mcap);
+            pool.unwrap().bytes
+        };
+
+        let file = tempfile::tempfile().expect("create tempfile");
+        let writer = McapSink::new_threaded(
+            file,
+            WriteOptions::default(),
+            None,
+            None,
+            ctx.memory_account(MemoryPool::Mcap),
+            0,
+            None,
+            ChunkStreamOptions::default(),
+        )
+        .expect("failed to create writer");
+        for log_time in 0..3 {
+            writer
+                .log(&ch, &[0u8; 100], &Metadata { log_time })
+                .expect("failed to log");
+        }
+        let record = 100 + MESSAGE_RECORD_OVERHEAD as usize;
+        assert_eq!(mcap_bytes(&ctx), 3 * record);
+
+        // Flushing writes the chunk, and releases its records.
+        writer.flush().expect("failed to flush");
+        assert_eq!(mcap_bytes(&ctx), 0);
+        writer
+            .log(&ch, &[0u8; 100], &Metadata { log_time: 3 })
+            .expect("failed to log");
+        assert_eq!(mcap_bytes(&ctx), record);
+
+        writer.finish().expect("failed to finish recording");
+        assert_eq!(mcap_bytes(&ctx), 0);
+    }
+
+    #[test]
+    fn test_compression_policy() {
+        use crate::mcap_writer::compression_policy::{
+            McapChunkCompression, McapCompressionPolicyFn,
+        };
+
+        let ctx = Context::new();
+        let video = new_test_channel(&ctx, "video".to_string(), "video_schema".to_string());
+        let json = new_test_channel(&ctx, "json".to_string(), "json_schema".to_string());
+
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+        let file = temp_file.reopen().expect("reopen tempfile");
+
+        let policy = McapCompressionPolicyFn(|channel: &ChannelDescriptor| {
+            (channel.topic() == "video").then_some(McapChunkCompression::NONE)
+        });
+        let options = WriteOptions::default()
+            .compression(Some(mcap::Compression::Lz4))
+            .chunk_size(Some(1024));
+        let chunk_streams = ChunkStreamOptions {
+            policy: Some(Arc::new(policy)),
+            ..Default::default()
+        };
+        let writer = McapSink::new_threaded(
+            file,
+            options,
+            None,
+            None,
+            MemoryAccount::detached(MemoryPool::Mcap),
+            0,
+            None,
+            chunk_streams,
+        )
+        .expect("failed to create writer");
+        for log_time in 0..20 {
+            let channel = if log_time % 2 == 0 { &video } else { &json };
+            writer
+                .log(channel, &[log_time as u8; 200], &Metadata { log_time })
+                .expect("failed to log");
+        }
+        writer
+            .write_metadata("meta", BTreeMap::from([("k".to_string(), "v".to_string())]))
+            .expect("failed to write metadata");
+        writer.finish().expect("failed to finish recording");
+
+        let summary = read_summary(&temp_path);
+        let stats = summary.stats.expect("missing statistics");
+        assert_eq!(stats.message_count, 20);
+        assert_eq!(stats.metadata_count, 1);
+        assert_eq!(summary.channels.len(), 2);
+        let mut compressions: Vec<_> = summary
+            .chunk_indexes
+            .iter()
+            .map(|index| index.compression.as_str())
+            .collect();
+        compressions.sort_unstable();
+        compressions.dedup();
+        assert_eq!(compressions, vec!["", "lz4"]);
+
+        let mut messages = vec![];
+        foreach_mcap_message(&temp_path, |msg| {
+            assert_eq!(msg.data[0] as u64, msg.log_time);
+            let expected_topic = if msg.log_time % 2 == 0 {
+                "video"
+            } else {
+                "json"
+            };
+            assert_eq!(msg.channel.topic, expected_topic);
+            messages.push(msg.log_time);
+        })
+        .expect("failed to read messages");
+        messages.sort_unstable();
+        assert_eq!(messages, (0..20).collect::<Vec<_>>());
+    }
+
+    #[test]
+    fn test_channel_grouping() {
+        use crate::mcap_writer::channel_grouping::McapChannelGroupingFn;
+
+        let ctx = Context::new();
+        let channels = ["camera/front", "camera/rear", "imu"]
+            .map(|topic| new_test_channel(&ctx, topic.to_string(), format!("{topic}_schema")));
+
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+        let file = temp_file.reopen().expect("reopen tempfile");
+
+        let grouping = McapChannelGroupingFn(|channel: &ChannelDescriptor| {
+            u32::from(channel.topic().starts_with("camera/"))
+        });
+        let options = WriteOptions::default().chunk_size(Some(1024));
+        let chunk_streams = ChunkStreamOptions {
+            grouping: Some(Arc::new(grouping)),
+            ..Default::default()
+        };
+        let writer = McapSink::new_threaded(
+            file,
+            options,
+            None,
+            None,
+            MemoryAccount::detached(MemoryPool::Mcap),
+            0,
+            None,
+            chunk_streams,
+        )
+        .expect("failed to create writer");
+        for log_time in 0..60 {
+            let channel = &channels[log_time as usize % channels.len()];
+            writer
+                .log(channel, &[log_time as u8; 100], &Metadata { log_time })
+                .expect("failed to log");
+        }
+        writer.finish().expect("failed to finish recording");
+
+        let summary = read_summary(&temp_path);
+        assert_eq!(summary.stats.expect("missing statistics").message_count, 60);
+        let is_camera = |id: &u16| summary.channels[id].topic.starts_with("camera/");
+        let mut camera_chunks = 0;
+        for index in &summary.chunk_indexes {
+            let ids: Vec<u16> = index.message_index_offsets.keys().copied().collect();
+            assert!(!ids.is_empty());
+            // Each chunk only holds messages from one group.
+            assert!(ids.iter().all(is_camera) || !ids.iter().any(is_camera));
+            if is_camera(&ids[0]) {
+                camera_chunks += 1;
+            }
+        }
+        assert!(camera_chunks > 0 && camera_chunks < summary.chunk_indexes.len());
+
+        let mut count = 0;
+        foreach_mcap_message(&temp_path, |msg| {
+            assert_eq!(msg.data[0] as u64, msg.log_time);
+            count += 1;
+        })
+        .expect("failed to read messages");
+        assert_eq!(count, 60);
+    }
+
+    #[test]
+    fn test_sparse_message_index() {
+        use crate::mcap_writer::sparse_index::McapSparseIndex;
+
+        let ctx = Context::new();
+        let ch = new_test_channel(&ctx, "imu".to_string(), "imu_schema".to_string());
+
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+        let file = temp_file.reopen().expect("reopen tempfile");
+
+        let chunk_streams = ChunkStreamOptions {
+            sparse_index: Some(McapSparseIndex {
+                every_messages: 100,
+                every_nanos: 0,
+            }),
+            ..Default::default()
+        };
+        let writer = McapSink::new_threaded(
+            file,
+            WriteOptions::default().chunk_size(Some(16 * 1024)),
+            None,
+            None,
+            MemoryAccount::detached(MemoryPool::Mcap),
+            0,
+            None,
+            chunk_streams,
+        )
+        .expect("failed to create writer");
+        for log_time in 0..10_000 {
+            writer
+                .log(&ch, &log_time.to_le_bytes(), &Metadata { log_time })
+                .expect("failed to log");
+        }
+        writer.finish().expect("failed to finish recording");
+
+        let summary = read_summary(&temp_path);
+        let stats = summary.stats.expect("missing statistics");
+        assert_eq!(stats.message_count, 10_000);
+        assert_eq!(stats.channel_message_counts.values().sum::<u64>(), 10_000);
+        assert!(summary.chunk_indexes.len() > 1);
+        // A dense index would hold 16 bytes per message.
+        let index_length: u64 = summary
+            .chunk_indexes
+            .iter()
+            .map(|index| index.message_index_length)
+            .sum();
+        assert!(index_length < 10_000 * 16 / 10);
+
+        let mut count = 0;
+        foreach_mcap_message(&temp_path, |msg| {
+            assert_eq!(msg.data.as_ref(), &msg.log_time.to_le_bytes());
+            count += 1;
+        })
+        .expect("failed to read messages");
+        assert_eq!(count, 10_000);
+    }
+
+    #[cfg(feature = "zstd")]
+    #[test]
+    fn test_zstd_dictionary() {
+        use crate::mcap_writer::records::{RECORD_PREFIX_LEN, RecordReader, op, split_record};
+        use crate::mcap_writer::zstd_dictionary::{
+            MCAP_ZSTD_DICTIONARY_MEDIA_TYPE, McapZstdDictionary,
+        };
+
+        let ctx = Context::new();
+        let ch = new_test_channel(&ctx, "log".to_string(), "log_schema".to_string());
+
+        let temp_file = NamedTempFile::new().expect("create tempfile");
+        let temp_path = temp_file.path().to_owned();
+        let file = temp_file.reopen().expect("reopen tempfile");
+
+        let options = WriteOptions::default()
+            .compression(None)
+            .chunk_size(Some(512));
+        let chunk_streams = ChunkStreamOptions {
+            dictionary: Some(McapZstdDictionary {
+                training_messages: 500,
+                max_size: 4096,
+                level: 0,
+            }),
+            ..Default::default()
+        };
+        let writer = McapSink::new_threaded(
+            file,
+            options,
+            None,
+            None,
+            MemoryAccount::detached(MemoryPool::Mcap),
+            0,
+            None,
+            chunk_streams,
+        )
+        .expect("failed to create writer");
+        for log_time in 0..1000 {
+            let msg = format!(
+                r#"{{"level":"info","node":"planner","msg":"cycle {log_time} done","count":{}}}"#,
+                log_time % 17
+            );
+            writer
+                .log(&ch, msg.as_bytes(), &Metadata { log_time })
+                .expect("failed to log");
+        }
+        writer.finish().expect("failed to finish recording");
+
+        let contents = std::fs::read(&temp_path).expect("failed to read file");
+        let summary = read_summary(&temp_path);
+        assert_eq!(summary.attachment_indexes.len(), 1);
+        let index = &summary.attachment_indexes[0];
+        assert_eq!(index.name, "log_schema");
+        assert_eq!(index.media_type, MCAP_ZSTD_DICTIONARY_MEDIA_TYPE);
+        let dictionary = mcap::read::attachment(&contents, index).expect("failed to read");
+        let mut decompressor = zstd::bulk::Decompressor::with_dictionary(&dictionary.data)
+            .expect("failed to load dictionary");
+
+        let mut message_count = 0;
+        let mut dictionary_chunks = 0;
+        for chunk_index in &summary.chunk_indexes {
+            let start = chunk_index.chunk_start_offset as usize;
+            let (opcode, body) = split_record(&contents[start..]).expect("missing chunk");
+            assert_eq!(opcode, op::CHUNK);
+            let mut chunk = RecordReader::new(body);
+            let _message_start_time = chunk.u64().expect("invalid chunk");
+            let _message_end_time = chunk.u64().expect("invalid chunk");
+            let uncompressed_size = chunk.u64().expect("invalid chunk") as usize;
+            let _uncompressed_crc = chunk.u32().expect("invalid chunk");
+            let compression = chunk.str().expect("invalid chunk");
+            let _compressed_size = chunk.u64().expect("invalid chunk");
+            let records = match compression.as_str() {
+                "" => chunk.remaining().to_vec(),
+                "zstd" => {
+                    dictionary_chunks += 1;
+                    decompressor
+                        .decompress(chunk.remaining(), uncompressed_size)
+                        .expect("failed to decompress chunk")
+                }
+                other => panic!("unexpected compression {other}"),
+            };
+            let mut rest = records.as_slice();
+            while let Some((opcode, body)) = split_record(rest) {
+                if opcode == op::MESSAGE {
+                    message_count += 1;
+                }
+                rest = &rest[RECORD_PREFIX_LEN as usize + body.len()..];
+            }
+        }
+        assert!(dictionary_chunks > 0);
+        assert_eq!(message_count, 1000);
+        let stats = summary.stats.expect("missing statistics");
+        assert_eq!(stats.message_count, 1000);
+        assert_eq!(stats.attachment_count, 1);
+    }
 }
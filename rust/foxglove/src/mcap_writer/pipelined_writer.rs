@@ -0,0 +1,345 @@
+//! A writer which hands finished chunk data to a dedicated I/O thread.
+use std::io::{self, Seek, SeekFrom, Write};
+use std::sync::Arc;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::mpsc::{Receiver, SyncSender, sync_channel};
+use std::thread::JoinHandle;
+
+use parking_lot::Mutex;
+
+use crate::memory_budget::MemoryAccount;
+
+/// Buffered bytes are handed to the I/O thread once they reach this size.
+const BLOCK_SIZE: usize = 256 * 1024;
+
+enum Op {
+    Write(Vec<u8>),
+    Seek(u64),
+    Flush(SyncSender<io::Result<()>>),
+    Position(SyncSender<io::Result<Offsets>>),
+}
+
+#[derive(Clone, Copy)]
+struct Offsets {
+    position: u64,
+    len: u64,
+}
+
+/// The output of an MCAP writer.
+///
+/// In pipelined mode, writes and seeks are queued to an I/O thread which owns the underlying
+/// writer, so the MCAP writer can build and compress the next chunk while the previous one is
+/// still being written. The queue holds up to `depth` blocks, after which writes block.
+pub(crate) struct PipelinedWriter<W> {
+    output: Output<W>,
+    // Total bytes handed to this writer, shared so it can be read while the MCAP writer owns it.
+    bytes_written: Arc<AtomicU64>,
+}
+
+enum Output<W> {
+    Direct(W),
+    Pipelined(Pipeline<W>),
+}
+
+struct Pipeline<W> {
+    sender: Option<SyncSender<Op>>,
+    worker: Option<JoinHandle<W>>,
+    failed: Arc<AtomicBool>,
+    error: Arc<Mutex<Option<io::Error>>>,
+    /// The account charged for the blocks queued to the I/O thread.
+    memory: Arc<MemoryAccount>,
+    buffer: Vec<u8>,
+    // Position and length of the output as seen by the MCAP writer. This is only queried from
+    // the I/O thread the first time the MCAP writer seeks, since non-seekable writers may not
+    // support it.
+    offsets: Option<Offsets>,
+}
+
+impl<W: Write + Seek + Send + 'static> PipelinedWriter<W> {
+    /// Wraps a writer, with an I/O thread if `depth` is non-zero.
+    pub fn with_depth(writer: W, depth: usize, memory: Arc<MemoryAccount>) -> io::Result<Self> {
+        if depth > 0 {
+            Self::spawn(writer, depth, memory)
+        } else {
+            Ok(Self::direct(writer))
+        }
+    }
+
+    /// Moves `writer` to a new I/O thread, with room for `depth` queued blocks. The queued blocks
+    /// are charged to `memory` until they are written.
+    pub fn spawn(writer: W, depth: usize, memory: Arc<MemoryAccount>) -> io::Result<Self> {
+        let (sender, receiver) = sync_channel(depth.max(1));
+        let failed = Arc::new(AtomicBool::new(false));
+        let error = Arc::new(Mutex::new(None));
+        let worker = std::thread::Builder::new()
+            .name("foxglove-mcap-io".into())
+            .spawn({
+                let failed = failed.clone();
+                let error = error.clone();
+                let memory = memory.clone();
+                move || run_io(writer, &receiver, &failed, &error, &memory)
+            })?;
+        Ok(Self::new(Output::Pipelined(Pipeline {
+            sender: Some(sender),
+            worker: Some(worker),
+            failed,
+            error,
+            memory,
+            buffer: Vec::with_capacity(BLOCK_SIZE),
+            offsets: None,
+        })))
+    }
+}
+
+impl<W> PipelinedWriter<W> {
+    /// Wraps a writer without an I/O thread.
+    pub fn direct(writer: W) -> Self {
+        Self::new(Output::Direct(writer))
+    }
+
+    fn new(output: Output<W>) -> Self {
+        Self {
+            output,
+            bytes_written: Arc::default(),
+        }
+    }
+
+    /// Returns a counter of the bytes written so far.
+    pub fn bytes_written(&self) -> Arc<AtomicU64> {
+        self.bytes_written.clone()
+    }
+
+    /// Waits for all queued writes to complete, and returns the underlying writer.
+    pub fn into_inner(self) -> io::Result<W> {
+        match self.output {
+            Output::Direct(writer) => Ok(writer),
+            Output::Pipelined(mut pipeline) => {
+                pipeline.send_buffer()?;
+                pipeline.sender.take();
+                let worker = pipeline.worker.take().ok_or_else(worker_gone)?;
+                let writer = worker.join().map_err(|_| worker_gone())?;
+                pipeline.check()?;
+                Ok(writer)
+            }
+        }
+    }
+}
+
+fn worker_gone() -> io::Error {
+    io::Error::other("MCAP I/O thread exited unexpectedly")
+}
+
+impl<W> Pipeline<W> {
+    /// Returns the first error reported by the I/O thread, if any.
+    fn check(&self) -> io::Result<()> {
+        if !self.failed.load(Ordering::Acquire) {
+            return Ok(());
+        }
+        match self.error.lock().take() {
+            Some(e) => Err(e),
+            None => Err(io::Error::other("a previous MCAP write failed")),
+        }
+    }
+
+    fn send(&self, op: Op) -> io::Result<()> {
+        let sender = self.sender.as_ref().ok_or_else(worker_gone)?;
+        sender.send(op).map_err(|_| worker_gone())
+    }
+
+    fn send_buffer(&mut self) -> io::Result<()> {
+        self.check()?;
+        if self.buffer.is_empty() {
+            return Ok(());
+        }
+        let block = std::mem::replace(&mut self.buffer, Vec::with_capacity(BLOCK_SIZE));
+        let len = block.len();
+        self.memory.charge(len);
+        self.send(Op::Write(block))
+            .inspect_err(|_| self.memory.release(len))
+    }
+
+    fn offsets(&mut self) -> io::Result<Offsets> {
+        if let Some(offsets) = self.offsets {
+            return Ok(offsets);
+        }
+        self.send_buffer()?;
+        let (ack, result) = sync_channel(1);
+        self.send(Op::Position(ack))?;
+        let offsets = result.recv().map_err(|_| worker_gone())??;
+        self.offsets = Some(offsets);
+        Ok(offsets)
+    }
+}
+
+impl<W> Drop for Pipeline<W> {
+    fn drop(&mut self) {
+        // Let the I/O thread finish queued writes and exit.
+        if self.sender.is_some() && self.send_buffer().is_err() {
+            tracing::warn!("Failed to write buffered MCAP data");
+        }
+    }
+}
+
+fn run_io<W: Write + Seek>(
+    mut writer: W,
+    receiver: &Receiver<Op>,
+    failed: &AtomicBool,
+    error: &Mutex<Option<io::Error>>,
+    memory: &MemoryAccount,
+) -> W {
+    for op in receiver {
+        if failed.load(Ordering::Relaxed) {
+            match op {
+                Op::Flush(ack) => {
+                    _ = ack.send(Ok(()));
+                }
+                Op::Position(ack) => {
+                    _ = ack.send(Err(io::Error::other("a previous MCAP write failed")));
+                }
+                Op::Write(block) => memory.release(block.len()),
+                Op::Seek(_) => (),
+            }
+            continue;
+        }
+        let result = match op {
+            Op::Write(block) => {
+                let result = writer.write_all(&block);
+                memory.release(block.len());
+                result
+            }
+            Op::Seek(position) => writer.seek(SeekFrom::Start(position)).map(|_| ()),
+            Op::Flush(ack) => {
+                _ = ack.send(writer.flush());
+                Ok(())
+            }
+            Op::Position(ack) => {
+                _ = ack.send(query_offsets(&mut writer));
+                Ok(())
+            }
+        };
+        if let Err(e) = result {
+            *error.lock() = Some(e);
+            failed.store(true, Ordering::Release);
+        }
+    }
+    writer
+}
+
+fn query_offsets<W: Seek>(writer: &mut W) -> io::Result<Offsets> {
+    let position = writer.stream_position()?;
+    let len = writer.seek(SeekFrom::End(0))?;
+    writer.seek(SeekFrom::Start(position))?;
+    Ok(Offsets { position, len })
+}
+
+impl<W: Write> Write for PipelinedWriter<W> {
+    fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
+        let written = match &mut self.output {
+            Output::Direct(writer) => writer.write(buf)?,
+            Output::Pipelined(pipeline) => {
+                pipeline.buffer.extend_from_slice(buf);
+                if let Some(offsets) = &mut pipeline.offsets {
+                    offsets.position += buf.len() as u64;
+                    offsets.len = offsets.len.max(offsets.position);
+                }
+                if pipeline.buffer.len() >= BLOCK_SIZE {
+                    pipeline.send_buffer()?;
+                }
+                buf.len()
+            }
+        };
+        self.bytes_written
+            .fetch_add(written as u64, Ordering::Relaxed);
+        Ok(written)
+    }
+
+    fn flush(&mut self) -> io::Result<()> {
+        match &mut self.output {
+            Output::Direct(writer) => writer.flush(),
+            Output::Pipelined(pipeline) => {
+                pipeline.send_buffer()?;
+                let (ack, result) = sync_channel(1);
+                pipeline.send(Op::Flush(ack))?;
+                result.recv().map_err(|_| worker_gone())??;
+                pipeline.check()
+            }
+        }
+    }
+}
+
+impl<W: Seek> Seek for PipelinedWriter<W> {
+    fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
+        match &mut self.output {
+            Output::Direct(writer) => writer.seek(pos),
+            Output::Pipelined(pipeline) => {
+                let mut offsets = pipeline.offsets()?;
+                let target = match pos {
+                    SeekFrom::Start(offset) => Some(offset),
+                    SeekFrom::Current(offset) => offsets.position.checked_add_signed(offset),
+                    SeekFrom::End(offset) => offsets.len.checked_add_signed(offset),
+                }
+                .ok_or_else(|| {
+                    io::Error::new(io::ErrorKind::InvalidInput, "invalid seek position")
+                })?;
+                if target != offsets.position {
+                    pipeline.send_buffer()?;
+                    pipeline.send(Op::Seek(target))?;
+                    offsets.position = target;
+                    pipeline.offsets = Some(offsets);
+                }
+                Ok(target)
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::MemoryPool;
+    use std::io::Cursor;
+
+    fn detached() -> Arc<MemoryAccount> {
+        Arc::new(MemoryAccount::detached(MemoryPool::Mcap))
+    }
+
+    #[test]
+    fn test_pipelined_writes_and_seeks() {
+        let mut writer = PipelinedWriter::spawn(Cursor::new(Vec::new()), 2, detached()).unwrap();
+        writer.write_all(b"hello world").unwrap();
+        assert_eq!(writer.stream_position().unwrap(), 11);
+        writer.seek(SeekFrom::Start(6)).unwrap();
+        writer.write_all(b"there").unwrap();
+        assert_eq!(writer.seek(SeekFrom::End(0)).unwrap(), 11);
+        writer.write_all(&vec![b'!'; BLOCK_SIZE]).unwrap();
+        writer.flush().unwrap();
+
+        let data = writer.into_inner().unwrap().into_inner();
+        assert_eq!(&data[..11], b"hello there");
+        assert_eq!(data.len(), 11 + BLOCK_SIZE);
+        assert!(data[11..].iter().all(|&b| b == b'!'));
+    }
+
+    #[test]
+    fn test_pipelined_write_error() {
+        struct FailingWriter;
+        impl Write for FailingWriter {
+            fn write(&mut self, _buf: &[u8]) -> io::Result<usize> {
+                Err(io::Error::other("disk full"))
+            }
+            fn flush(&mut self) -> io::Result<()> {
+                Ok(())
+            }
+        }
+        impl Seek for FailingWriter {
+            fn seek(&mut self, _pos: SeekFrom) -> io::Result<u64> {
+                Ok(0)
+            }
+        }
+
+        let mut writer = PipelinedWriter::spawn(FailingWriter, 1, detached()).unwrap();
+        writer.write_all(b"data").unwrap();
+        let err = writer.flush().unwrap_err();
+        assert_eq!(err.to_string(), "disk full");
+    }
+}
@@ -0,0 +1,192 @@
+//! A file writer which reserves disk space ahead of its writes.
+use std::fs::{File, OpenOptions};
+use std::io::{self, Seek, SeekFrom, Write};
+use std::os::fd::AsRawFd;
+use std::path::Path;
+
+/// A file which reserves disk space in large extents with `fallocate` as it grows.
+///
+/// A long recording written in small appends allocates its blocks a few at a time, which
+/// fragments the file and occasionally stalls a write on filesystem metadata updates. This writer
+/// instead reserves `extent_size` bytes at a time beyond the end of the file, so that most writes
+/// land in space which is already allocated.
+///
+/// Space is reserved without changing the file's length, so the file is always readable up to
+/// the last write, even if the process exits without closing it. When the writer is dropped, the
+/// file is truncated to its length, which releases the unused reserved space.
+///
+/// Wrap it in a [`BufWriter`](std::io::BufWriter) to batch small writes. If the filesystem does
+/// not support `fallocate`, the file is written without reserving space.
+///
+/// Only available on Linux.
+pub struct McapPreallocatedFile {
+    file: File,
+    extent_size: u64,
+    // Current position of the file cursor.
+    position: u64,
+    // Length of the data written to the file.
+    len: u64,
+    // Offset up to which space has been reserved.
+    allocated: u64,
+    // Whether to keep reserving space, which stops if `fallocate` fails.
+    preallocate: bool,
+}
+
+impl McapPreallocatedFile {
+    /// Creates a new file for writing, which reserves space in extents of `extent_size` bytes.
+    ///
+    /// Fails with [`AlreadyExists`](`std::io::ErrorKind::AlreadyExists`) if the file exists.
+    pub fn create_new(path: impl AsRef<Path>, extent_size: u64) -> io::Result<Self> {
+        Self::open(path, OpenOptions::new().create_new(true), extent_size)
+    }
+
+    /// Creates or truncates a file for writing, which reserves space in extents of `extent_size`
+    /// bytes.
+    pub fn create(path: impl AsRef<Path>, extent_size: u64) -> io::Result<Self> {
+        Self::open(
+            path,
+            OpenOptions::new().create(true).truncate(true),
+            extent_size,
+        )
+    }
+
+    fn open(
+        path: impl AsRef<Path>,
+        options: &mut OpenOptions,
+        extent_size: u64,
+    ) -> io::Result<Self> {
+        if extent_size == 0 {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidInput,
+                "extent size must be nonzero",
+            ));
+        }
+        let file = options.write(true).open(path)?;
+        let mut file = Self {
+            file,
+            extent_size,
+            position: 0,
+            len: 0,
+            allocated: 0,
+            preallocate: true,
+        };
+        file.reserve(1);
+        Ok(file)
+    }
+
+    /// Reserves space for the file to grow to at least `end` bytes.
+    fn reserve(&mut self, end: u64) {
+        if !self.preallocate || end <= self.allocated {
+            return;
+        }
+        let target = end.next_multiple_of(self.extent_size);
+        let (Ok(offset), Ok(len)) = (
+            libc::off_t::try_from(self.allocated),
+            libc::off_t::try_from(target - self.allocated),
+        ) else {
+            self.preallocate = false;
+            return;
+        };
+        // Safety: the file descriptor is valid for the lifetime of `self.file`.
+        let result = unsafe {
+            libc::fallocate(
+                self.file.as_raw_fd(),
+                libc::FALLOC_FL_KEEP_SIZE,
+                offset,
+                len,
+            )
+        };
+        if result == 0 {
+            self.allocated = target;
+        } else {
+            // Writes still succeed without reserved space, so carry on without it.
+            let e = io::Error::last_os_error();
+            tracing::debug!("Not preallocating MCAP file space: {e}");
+            self.preallocate = false;
+        }
+    }
+}
+
+impl Write for McapPreallocatedFile {
+    fn write(&mut self, buf: &[u8]) -> io::Result<usize> {
+        self.reserve(self.position + buf.len() as u64);
+        let n = self.file.write(buf)?;
+        self.position += n as u64;
+        self.len = self.len.max(self.position);
+        Ok(n)
+    }
+
+    fn flush(&mut self) -> io::Result<()> {
+        self.file.flush()
+    }
+}
+
+impl Seek for McapPreallocatedFile {
+    fn seek(&mut self, pos: SeekFrom) -> io::Result<u64> {
+        self.position = self.file.seek(pos)?;
+        Ok(self.position)
+    }
+}
+
+impl Drop for McapPreallocatedFile {
+    fn drop(&mut self) {
+        // Truncating to the current length releases the space reserved beyond it.
+        if self.allocated > self.len
+            && let Err(e) = self.file.set_len(self.len)
+        {
+            tracing::warn!("Failed to release preallocated file space: {e}");
+        }
+    }
+}
+
+impl std::fmt::Debug for McapPreallocatedFile {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("McapPreallocatedFile")
+            .field("file", &self.file)
+            .field("len", &self.len)
+            .field("allocated", &self.allocated)
+            .finish_non_exhaustive()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::os::unix::fs::MetadataExt;
+
+    #[test]
+    fn test_preallocated_file_reserves_and_releases_space() {
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let path = dir.path().join("preallocated.bin");
+        let extent_size = 1024 * 1024;
+        let mut file = McapPreallocatedFile::create_new(&path, extent_size).unwrap();
+        file.write_all(&[1; 100]).unwrap();
+        file.seek(SeekFrom::Start(10)).unwrap();
+        file.write_all(&[2; 10]).unwrap();
+        file.seek(SeekFrom::End(0)).unwrap();
+        file.write_all(&[3; 100]).unwrap();
+        file.flush().unwrap();
+
+        // The reserved space doesn't change the file's length.
+        let metadata = std::fs::metadata(&path).unwrap();
+        assert_eq!(metadata.len(), 200);
+        if file.preallocate {
+            assert!(metadata.blocks() * 512 >= extent_size);
+        }
+        drop(file);
+
+        let metadata = std::fs::metadata(&path).unwrap();
+        assert!(metadata.blocks() * 512 < extent_size);
+        let mut expected = vec![1; 100];
+        expected[10..20].fill(2);
+        expected.extend([3; 100]);
+        assert_eq!(std::fs::read(&path).unwrap(), expected);
+    }
+
+    #[test]
+    fn test_preallocated_file_requires_extent_size() {
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let result = McapPreallocatedFile::create_new(dir.path().join("empty.bin"), 0);
+        assert_eq!(result.unwrap_err().kind(), io::ErrorKind::InvalidInput);
+    }
+}
@@ -0,0 +1,308 @@
+//! Encoding and decoding of the MCAP records which the SDK handles itself, rather than through
+//! the mcap crate.
+//!
+//! See <https://mcap.dev/spec> for the record layouts.
+use std::collections::BTreeMap;
+use std::io;
+
+/// The magic bytes at the start and end of every MCAP file.
+pub(crate) const MAGIC: &[u8; 8] = b"\x89MCAP0\r\n";
+
+/// Length of a record's opcode and length prefix.
+pub(crate) const RECORD_PREFIX_LEN: u64 = 9;
+
+/// Splits the complete record at the start of `buf` into its opcode and body.
+///
+/// Returns `None` if `buf` does not start with a complete record.
+pub(crate) fn split_record(buf: &[u8]) -> Option<(u8, &[u8])> {
+    let prefix = buf.get(..RECORD_PREFIX_LEN as usize)?;
+    let len = u64::from_le_bytes(prefix[1..].try_into().ok()?);
+    let body = buf[RECORD_PREFIX_LEN as usize..].get(..usize::try_from(len).ok()?)?;
+    Some((prefix[0], body))
+}
+
+/// Record opcodes.
+pub(crate) mod op {
+    pub const HEADER: u8 = 0x01;
+    pub const FOOTER: u8 = 0x02;
+    pub const SCHEMA: u8 = 0x03;
+    pub const CHANNEL: u8 = 0x04;
+    pub const MESSAGE: u8 = 0x05;
+    pub const CHUNK: u8 = 0x06;
+    pub const MESSAGE_INDEX: u8 = 0x07;
+    pub const CHUNK_INDEX: u8 = 0x08;
+    pub const ATTACHMENT: u8 = 0x09;
+    pub const ATTACHMENT_INDEX: u8 = 0x0A;
+    pub const STATISTICS: u8 = 0x0B;
+    pub const METADATA: u8 = 0x0C;
+    pub const METADATA_INDEX: u8 = 0x0D;
+    pub const SUMMARY_OFFSET: u8 = 0x0E;
+    pub const DATA_END: u8 = 0x0F;
+}
+
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub(crate) struct SchemaRecord {
+    pub id: u16,
+    pub name: String,
+    pub encoding: String,
+    pub data: Vec<u8>,
+}
+
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub(crate) struct ChannelRecord {
+    pub id: u16,
+    pub schema_id: u16,
+    pub topic: String,
+    pub message_encoding: String,
+    pub metadata: BTreeMap<String, String>,
+}
+
+/// Appends records to a buffer.
+#[derive(Default)]
+pub(crate) struct RecordWriter {
+    buf: Vec<u8>,
+    // Offset just past the length prefix of the record being written.
+    record_start: usize,
+}
+
+impl RecordWriter {
+    pub fn into_inner(self) -> Vec<u8> {
+        self.buf
+    }
+
+    pub fn len(&self) -> usize {
+        self.buf.len()
+    }
+
+    /// Writes a complete record, whose body is written by `body`.
+    pub fn record(&mut self, opcode: u8, body: impl FnOnce(&mut Self)) {
+        self.buf.push(opcode);
+        self.buf.extend_from_slice(&[0; 8]);
+        let outer = std::mem::replace(&mut self.record_start, self.buf.len());
+        body(self);
+        let len = (self.buf.len() - self.record_start) as u64;
+        self.buf[self.record_start - 8..self.record_start].copy_from_slice(&len.to_le_bytes());
+        self.record_start = outer;
+    }
+
+    pub fn u8(&mut self, value: u8) {
+        self.buf.push(value);
+    }
+
+    pub fn u16(&mut self, value: u16) {
+        self.buf.extend_from_slice(&value.to_le_bytes());
+    }
+
+    pub fn u32(&mut self, value: u32) {
+        self.buf.extend_from_slice(&value.to_le_bytes());
+    }
+
+    pub fn u64(&mut self, value: u64) {
+        self.buf.extend_from_slice(&value.to_le_bytes());
+    }
+
+    pub fn str(&mut self, value: &str) {
+        self.bytes(value.as_bytes());
+    }
+
+    /// Writes a byte array with a 32-bit length prefix.
+    pub fn bytes(&mut self, value: &[u8]) {
+        self.u32(value.len() as u32);
+        self.buf.extend_from_slice(value);
+    }
+
+    /// Writes bytes without a length prefix.
+    pub fn raw(&mut self, value: &[u8]) {
+        self.buf.extend_from_slice(value);
+    }
+
+    /// Writes a map or array, prefixed by its length in bytes.
+    pub fn sized(&mut self, body: impl FnOnce(&mut Self)) {
+        let start = self.buf.len();
+        self.u32(0);
+        body(self);
+        let len = (self.buf.len() - start - 4) as u32;
+        self.buf[start..start + 4].copy_from_slice(&len.to_le_bytes());
+    }
+
+    pub fn string_map(&mut self, map: &BTreeMap<String, String>) {
+        self.sized(|w| {
+            for (key, value) in map {
+                w.str(key);
+                w.str(value);
+            }
+        });
+    }
+
+    pub fn schema(&mut self, id: u16, name: &str, encoding: &str, data: &[u8]) {
+        self.record(op::SCHEMA, |w| {
+            w.u16(id);
+            w.str(name);
+            w.str(encoding);
+            w.bytes(data);
+        });
+    }
+
+    pub fn channel(
+        &mut self,
+        id: u16,
+        schema_id: u16,
+        topic: &str,
+        message_encoding: &str,
+        metadata: &BTreeMap<String, String>,
+    ) {
+        self.record(op::CHANNEL, |w| {
+            w.u16(id);
+            w.u16(schema_id);
+            w.str(topic);
+            w.str(message_encoding);
+            w.string_map(metadata);
+        });
+    }
+}
+
+/// Reads the fields of a record body, from memory or from a file.
+pub(crate) trait FieldReader {
+    fn u16(&mut self) -> io::Result<u16>;
+    fn u32(&mut self) -> io::Result<u32>;
+    fn u64(&mut self) -> io::Result<u64>;
+    fn str(&mut self) -> io::Result<String>;
+    /// Reads the remainder of the record body.
+    fn rest(&mut self) -> io::Result<Vec<u8>>;
+}
+
+/// Reads fields from a record body.
+pub(crate) struct RecordReader<'a> {
+    data: &'a [u8],
+}
+
+impl<'a> RecordReader<'a> {
+    pub fn new(data: &'a [u8]) -> Self {
+        Self { data }
+    }
+
+    fn take(&mut self, len: usize) -> io::Result<&'a [u8]> {
+        if self.data.len() < len {
+            return Err(io::Error::new(
+                io::ErrorKind::UnexpectedEof,
+                "MCAP record is truncated",
+            ));
+        }
+        let (head, tail) = self.data.split_at(len);
+        self.data = tail;
+        Ok(head)
+    }
+
+    fn array<const N: usize>(&mut self) -> io::Result<[u8; N]> {
+        let mut value = [0; N];
+        value.copy_from_slice(self.take(N)?);
+        Ok(value)
+    }
+
+    pub fn u16(&mut self) -> io::Result<u16> {
+        self.array().map(u16::from_le_bytes)
+    }
+
+    pub fn u32(&mut self) -> io::Result<u32> {
+        self.array().map(u32::from_le_bytes)
+    }
+
+    pub fn u64(&mut self) -> io::Result<u64> {
+        self.array().map(u64::from_le_bytes)
+    }
+
+    pub fn str(&mut self) -> io::Result<String> {
+        let bytes = self.bytes()?;
+        String::from_utf8(bytes.to_vec()).map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))
+    }
+
+    /// Reads a byte array with a 32-bit length prefix.
+    pub fn bytes(&mut self) -> io::Result<&'a [u8]> {
+        let len = self.u32()? as usize;
+        self.take(len)
+    }
+
+    /// Returns the bytes which have not been read yet.
+    pub fn remaining(&self) -> &'a [u8] {
+        self.data
+    }
+
+    pub fn string_map(&mut self) -> io::Result<BTreeMap<String, String>> {
+        let mut entries = RecordReader::new(self.bytes()?);
+        let mut map = BTreeMap::new();
+        while !entries.data.is_empty() {
+            let key = entries.str()?;
+            map.insert(key, entries.str()?);
+        }
+        Ok(map)
+    }
+
+    pub fn schema(&mut self) -> io::Result<SchemaRecord> {
+        Ok(SchemaRecord {
+            id: self.u16()?,
+            name: self.str()?,
+            encoding: self.str()?,
+            data: self.bytes()?.to_vec(),
+        })
+    }
+
+    pub fn channel(&mut self) -> io::Result<ChannelRecord> {
+        Ok(ChannelRecord {
+            id: self.u16()?,
+            schema_id: self.u16()?,
+            topic: self.str()?,
+            message_encoding: self.str()?,
+            metadata: self.string_map()?,
+        })
+    }
+}
+
+impl FieldReader for RecordReader<'_> {
+    fn u16(&mut self) -> io::Result<u16> {
+        RecordReader::u16(self)
+    }
+
+    fn u32(&mut self) -> io::Result<u32> {
+        RecordReader::u32(self)
+    }
+
+    fn u64(&mut self) -> io::Result<u64> {
+        RecordReader::u64(self)
+    }
+
+    fn str(&mut self) -> io::Result<String> {
+        RecordReader::str(self)
+    }
+
+    fn rest(&mut self) -> io::Result<Vec<u8>> {
+        Ok(std::mem::take(&mut self.data).to_vec())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_channel_round_trip() {
+        let metadata = BTreeMap::from([("key".to_string(), "value".to_string())]);
+        let mut writer = RecordWriter::default();
+        writer.channel(3, 1, "/topic", "json", &metadata);
+        let buf = writer.into_inner();
+
+        assert_eq!(buf[0], op::CHANNEL);
+        let len = u64::from_le_bytes(buf[1..9].try_into().unwrap());
+        assert_eq!(len as usize, buf.len() - 9);
+        let channel = RecordReader::new(&buf[9..]).channel().unwrap();
+        assert_eq!(
+            channel,
+            ChannelRecord {
+                id: 3,
+                schema_id: 1,
+                topic: "/topic".to_string(),
+                message_encoding: "json".to_string(),
+                metadata,
+            }
+        );
+    }
+}
@@ -0,0 +1,304 @@
+//! Rebuilding the summary of an MCAP file which was not finished.
+use std::collections::BTreeSet;
+use std::fs::{File, OpenOptions};
+use std::io::{self, BufReader, BufWriter, Read, Seek, SeekFrom, Write};
+use std::path::Path;
+
+use crate::FoxgloveError;
+use crate::mcap_writer::checkpoint::journal_path;
+use crate::mcap_writer::records::{
+    ChannelRecord, FieldReader, MAGIC, RECORD_PREFIX_LEN, RecordReader, RecordWriter, SchemaRecord,
+    op,
+};
+use crate::mcap_writer::summary::SummaryBuilder;
+
+/// Rebuilds the summary of an MCAP file whose writer did not finish, for example because the
+/// process exited while recording.
+///
+/// The file is truncated after its last complete record, and a new summary section, with
+/// schemas, channels, chunk indexes, attachment and metadata indexes, and statistics, is
+/// appended. Files which already end with a footer are left unchanged.
+///
+/// Recovery only reads record headers, and skips over chunk bodies, so it takes time
+/// proportional to the number of records outside of chunks rather than the size of the file.
+/// Schemas and channels are read from the checkpoint journal written by
+/// [`McapWriter::checkpoint_journal`][crate::McapWriter::checkpoint_journal], if present, which is
+/// removed once the file has been recovered. Without a journal, chunks are decompressed until
+/// every channel with messages has been found, which is usually only the first chunk.
+///
+/// Statistics are omitted if the message counts cannot be determined, for example if the last
+/// chunk's message indexes were not written.
+pub fn recover_mcap(path: impl AsRef<Path>) -> Result<(), FoxgloveError> {
+    let path = path.as_ref();
+    let mut file = OpenOptions::new().read(true).write(true).open(path)?;
+    if is_finished(&mut file)? {
+        return Ok(());
+    }
+
+    let mut scan = Scan::default();
+    scan.read_data_section(&mut file)?;
+
+    let journal = journal_path(path);
+    let has_journal = journal.exists();
+    if has_journal {
+        scan.read_journal(&journal)?;
+    }
+    scan.find_missing_channels(&mut file)?;
+
+    file.set_len(scan.data_end)?;
+    file.seek(SeekFrom::Start(scan.data_end))?;
+    let mut writer = BufWriter::new(file);
+    writer.write_all(&scan.summary.summary(scan.data_end))?;
+    writer
+        .into_inner()
+        .map_err(|e| e.into_error())?
+        .sync_all()?;
+
+    if has_journal {
+        std::fs::remove_file(journal)?;
+    }
+    Ok(())
+}
+
+/// Returns true if the file ends with a footer and magic.
+fn is_finished(file: &mut File) -> io::Result<bool> {
+    let len = file.seek(SeekFrom::End(0))?;
+    let footer_len = RECORD_PREFIX_LEN + 20 + MAGIC.len() as u64;
+    if len < MAGIC.len() as u64 + footer_len {
+        return Ok(false);
+    }
+    let mut tail = [0; 29 + 8];
+    file.seek(SeekFrom::End(-(footer_len as i64)))?;
+    file.read_exact(&mut tail)?;
+    Ok(tail[0] == op::FOOTER && &tail[29..] == MAGIC)
+}
+
+#[derive(Default)]
+struct Scan {
+    summary: SummaryBuilder,
+    // End of the last complete record in the data section.
+    data_end: u64,
+}
+
+impl Scan {
+    /// Reads the headers of all complete records in the data section.
+    fn read_data_section(&mut self, file: &mut File) -> Result<(), FoxgloveError> {
+        let file_len = file.metadata()?.len();
+        file.seek(SeekFrom::Start(0))?;
+        let mut reader = BufReader::new(file);
+        let mut magic = [0; 8];
+        if reader.read_exact(&mut magic).is_err() || &magic != MAGIC {
+            return Err(FoxgloveError::ValueError("not an MCAP file".to_string()));
+        }
+        let mut position = MAGIC.len() as u64;
+        self.data_end = position;
+        while position + RECORD_PREFIX_LEN <= file_len {
+            let mut prefix = [0; RECORD_PREFIX_LEN as usize];
+            reader.read_exact(&mut prefix)?;
+            let opcode = prefix[0];
+            let mut body_len = [0; 8];
+            body_len.copy_from_slice(&prefix[1..]);
+            let body_len = u64::from_le_bytes(body_len);
+            let record_len = RECORD_PREFIX_LEN.saturating_add(body_len);
+            if record_len > file_len - position {
+                // The last record was only partly written.
+                break;
+            }
+            if matches!(
+                opcode,
+                op::FOOTER
+                    | op::DATA_END
+                    | op::CHUNK_INDEX
+                    | op::ATTACHMENT_INDEX
+                    | op::STATISTICS
+                    | op::METADATA_INDEX
+                    | op::SUMMARY_OFFSET
+            ) {
+                // The data section ended. The summary which follows it is replaced.
+                break;
+            }
+            let mut body = BodyReader {
+                reader: &mut reader,
+                remaining: body_len,
+            };
+            self.summary
+                .index_record(opcode, position, record_len, &mut body)?;
+            body.skip_rest()?;
+            position += record_len;
+            self.data_end = position;
+        }
+        self.summary.end_data_section();
+        Ok(())
+    }
+
+    /// Reads schemas and channels from a checkpoint journal.
+    fn read_journal(&mut self, path: &Path) -> Result<(), FoxgloveError> {
+        let journal = std::fs::read(path)?;
+        let Some(mut records) = journal.strip_prefix(MAGIC.as_slice()) else {
+            return Err(FoxgloveError::ValueError(
+                "checkpoint journal is invalid".to_string(),
+            ));
+        };
+        while records.len() >= RECORD_PREFIX_LEN as usize {
+            let mut prefix = RecordReader::new(&records[1..RECORD_PREFIX_LEN as usize]);
+            let body_len = usize::try_from(prefix.u64()?).unwrap_or(usize::MAX);
+            let Some(body) = records[RECORD_PREFIX_LEN as usize..].get(..body_len) else {
+                // The last record was only partly written.
+                break;
+            };
+            match records[0] {
+                op::SCHEMA => {
+                    let schema = RecordReader::new(body).schema()?;
+                    self.summary.schemas.insert(schema.id, schema);
+                }
+                op::CHANNEL => {
+                    let channel = RecordReader::new(body).channel()?;
+                    self.summary.channels.insert(channel.id, channel);
+                }
+                _ => (),
+            }
+            records = &records[RECORD_PREFIX_LEN as usize + body_len..];
+        }
+        Ok(())
+    }
+
+    /// Decompresses chunks to find channels which have messages, but were not declared outside
+    /// of a chunk or in a journal.
+    fn find_missing_channels(&mut self, file: &mut File) -> Result<(), FoxgloveError> {
+        let summary = &mut self.summary;
+        let mut missing: BTreeSet<u16> = summary
+            .message_channels()
+            .filter(|id| !summary.channels.contains_key(id))
+            .collect();
+        for chunk_index in 0..summary.chunks().len() {
+            if missing.is_empty() {
+                break;
+            }
+            let chunk = &summary.chunks()[chunk_index];
+            if !chunk.message_index_offsets.is_empty()
+                && !chunk
+                    .message_index_offsets
+                    .keys()
+                    .any(|id| missing.contains(id))
+            {
+                continue;
+            }
+            // Parse the chunk as a standalone file, preceded by the schemas and channels found so
+            // far, so messages on previously declared channels can be read.
+            let mut known = RecordWriter::default();
+            for schema in summary.schemas.values() {
+                known.schema(schema.id, &schema.name, &schema.encoding, &schema.data);
+            }
+            for channel in summary.channels.values() {
+                known.channel(
+                    channel.id,
+                    channel.schema_id,
+                    &channel.topic,
+                    &channel.message_encoding,
+                    &channel.metadata,
+                );
+            }
+            let mut buf = MAGIC.to_vec();
+            buf.extend_from_slice(&known.into_inner());
+            let start = buf.len();
+            buf.resize(start + chunk.length as usize, 0);
+            file.seek(SeekFrom::Start(chunk.offset))?;
+            file.read_exact(&mut buf[start..])?;
+            buf.extend_from_slice(MAGIC);
+
+            let Ok(stream) = mcap::MessageStream::new(&buf) else {
+                continue;
+            };
+            // The stream ends with an error, since the buffer has no footer.
+            for message in stream.map_while(Result::ok) {
+                let channel = &message.channel;
+                if !missing.remove(&channel.id) {
+                    continue;
+                }
+                let schema_id = match &channel.schema {
+                    Some(schema) => {
+                        summary
+                            .schemas
+                            .entry(schema.id)
+                            .or_insert_with(|| SchemaRecord {
+                                id: schema.id,
+                                name: schema.name.clone(),
+                                encoding: schema.encoding.clone(),
+                                data: schema.data.to_vec(),
+                            });
+                        schema.id
+                    }
+                    None => 0,
+                };
+                summary.channels.insert(
+                    channel.id,
+                    ChannelRecord {
+                        id: channel.id,
+                        schema_id,
+                        topic: channel.topic.clone(),
+                        message_encoding: channel.message_encoding.clone(),
+                        metadata: channel.metadata.clone(),
+                    },
+                );
+            }
+        }
+        Ok(())
+    }
+}
+
+/// Reads the fields of a record body from a file, without reading past its end.
+struct BodyReader<'a, 'f> {
+    reader: &'a mut BufReader<&'f mut File>,
+    remaining: u64,
+}
+
+impl BodyReader<'_, '_> {
+    fn bytes(&mut self, len: u64) -> io::Result<Vec<u8>> {
+        if len > self.remaining {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidData,
+                "MCAP record field exceeds the record length",
+            ));
+        }
+        let mut buf = vec![0; len as usize];
+        self.reader.read_exact(&mut buf)?;
+        self.remaining -= len;
+        Ok(buf)
+    }
+
+    fn array<const N: usize>(&mut self) -> io::Result<[u8; N]> {
+        let mut value = [0; N];
+        value.copy_from_slice(&self.bytes(N as u64)?);
+        Ok(value)
+    }
+
+    fn skip_rest(self) -> io::Result<()> {
+        let remaining = i64::try_from(self.remaining)
+            .map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))?;
+        self.reader.seek_relative(remaining)
+    }
+}
+
+impl FieldReader for BodyReader<'_, '_> {
+    fn u16(&mut self) -> io::Result<u16> {
+        self.array().map(u16::from_le_bytes)
+    }
+
+    fn u32(&mut self) -> io::Result<u32> {
+        self.array().map(u32::from_le_bytes)
+    }
+
+    fn u64(&mut self) -> io::Result<u64> {
+        self.array().map(u64::from_le_bytes)
+    }
+
+    fn str(&mut self) -> io::Result<String> {
+        let len = self.u32()?;
+        String::from_utf8(self.bytes(u64::from(len))?)
+            .map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))
+    }
+
+    fn rest(&mut self) -> io::Result<Vec<u8>> {
+        self.bytes(self.remaining)
+    }
+}
@@ -0,0 +1,88 @@
+//! Splitting an MCAP recording into multiple segment files.
+use std::time::{Duration, Instant};
+
+use mcap::WriteOptions;
+
+use crate::FoxgloveError;
+use crate::mcap_writer::pipelined_writer::PipelinedWriter;
+
+/// The placeholder in a segment path template which is replaced by the segment index.
+pub(crate) const SEGMENT_INDEX_PLACEHOLDER: &str = "{index}";
+
+/// When an [`McapWriter`][crate::McapWriter] closes the current segment and starts a new one.
+///
+/// A segment is rotated when either limit is reached. Each segment is a complete MCAP file with
+/// its own schemas, channels, and summary.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct McapRotation {
+    /// Rotate once this many bytes have been written to the current segment.
+    ///
+    /// Chunked output reaches the file a chunk at a time, so a segment may exceed this by up to
+    /// one chunk.
+    pub max_bytes: Option<u64>,
+    /// Rotate once the current segment has been open for this long.
+    pub max_duration: Option<Duration>,
+}
+
+/// Opens the writer for the segment with the given index.
+pub(crate) type OpenSegment<W> =
+    Box<dyn FnMut(u32) -> Result<PipelinedWriter<W>, FoxgloveError> + Send>;
+
+pub(crate) struct Rotation<W> {
+    policy: McapRotation,
+    options: WriteOptions,
+    open_segment: OpenSegment<W>,
+    index: u32,
+    opened_at: Instant,
+}
+
+impl<W> Rotation<W> {
+    /// Creates the rotation state, once the first segment has been opened.
+    pub fn new(policy: McapRotation, options: WriteOptions, open_segment: OpenSegment<W>) -> Self {
+        Self {
+            policy,
+            options,
+            open_segment,
+            index: 0,
+            opened_at: Instant::now(),
+        }
+    }
+
+    pub fn should_rotate(&self, bytes_written: u64) -> bool {
+        self.policy
+            .max_bytes
+            .is_some_and(|max| bytes_written >= max)
+            || self
+                .policy
+                .max_duration
+                .is_some_and(|max| self.opened_at.elapsed() >= max)
+    }
+
+    /// Opens the next segment.
+    pub fn open_next(&mut self) -> Result<PipelinedWriter<W>, FoxgloveError> {
+        let writer = (self.open_segment)(self.index + 1)?;
+        self.index += 1;
+        self.opened_at = Instant::now();
+        Ok(writer)
+    }
+
+    pub fn options(&self) -> WriteOptions {
+        self.options.clone()
+    }
+}
+
+/// Returns the path of a segment, given a path template containing `{index}`.
+pub(crate) fn segment_path(template: &str, index: u32) -> String {
+    template.replace(SEGMENT_INDEX_PLACEHOLDER, &index.to_string())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_segment_path() {
+        assert_eq!(segment_path("shift-{index}.mcap", 0), "shift-0.mcap");
+        assert_eq!(segment_path("{index}/{index}.mcap", 12), "12/12.mcap");
+    }
+}
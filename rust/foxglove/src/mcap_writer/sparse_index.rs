@@ -0,0 +1,175 @@
+//! Sparse message indexes for channels with high message rates.
+use std::io;
+
+use crate::mcap_writer::records::{
+    RECORD_PREFIX_LEN, RecordReader, RecordWriter, op, split_record,
+};
+
+/// Size of a message index entry: a log time and an offset.
+const ENTRY_SIZE: usize = 16;
+
+/// Options for writing sparse message indexes.
+///
+/// A message index holds an entry for every message of a channel in a chunk. For a channel with a
+/// very high message rate, the indexes can be larger than the messages they index. A sparse index
+/// keeps the first entry of each channel in each chunk, and then only an entry once
+/// [`every_messages`][Self::every_messages] messages or [`every_nanos`][Self::every_nanos]
+/// nanoseconds of log time have passed since the last one, whichever comes first.
+///
+/// See [`McapWriter::sparse_message_index`][crate::McapWriter::sparse_message_index].
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct McapSparseIndex {
+    /// Keep an entry at least once every this many messages. 0 disables this limit.
+    pub every_messages: u64,
+    /// Keep an entry at least once every this many nanoseconds of log time. 0 disables this
+    /// limit.
+    pub every_nanos: u64,
+}
+
+impl McapSparseIndex {
+    /// Returns true if an entry should be kept after `messages` messages and `nanos` nanoseconds
+    /// since the last kept entry.
+    fn keep(&self, messages: u64, nanos: u64) -> bool {
+        let by_count = self.every_messages > 0 && messages >= self.every_messages;
+        let by_time = self.every_nanos > 0 && nanos >= self.every_nanos;
+        by_count || by_time || (self.every_messages == 0 && self.every_nanos == 0)
+    }
+
+    /// Rewrites the message index records in `records` to keep only the sampled entries.
+    ///
+    /// `dropped` is called with the channel id and number of entries dropped from each record,
+    /// so that the caller can still count every message.
+    pub(crate) fn apply(
+        &self,
+        records: &[u8],
+        mut dropped: impl FnMut(u16, u64),
+    ) -> io::Result<Vec<u8>> {
+        let mut out = RecordWriter::default();
+        let mut rest = records;
+        while let Some((opcode, body)) = split_record(rest) {
+            let len = RECORD_PREFIX_LEN as usize + body.len();
+            if opcode == op::MESSAGE_INDEX {
+                let (channel_id, dropped_count) = self.write_index(&mut out, body)?;
+                if dropped_count > 0 {
+                    dropped(channel_id, dropped_count);
+                }
+            } else {
+                out.raw(&rest[..len]);
+            }
+            rest = &rest[len..];
+        }
+        out.raw(rest);
+        Ok(out.into_inner())
+    }
+
+    /// Writes the sampled entries of a message index record body. Returns the record's channel
+    /// id and the number of entries dropped.
+    fn write_index(&self, out: &mut RecordWriter, body: &[u8]) -> io::Result<(u16, u64)> {
+        let mut reader = RecordReader::new(body);
+        let channel_id = reader.u16()?;
+        let entries = reader.bytes()?;
+        if entries.len() % ENTRY_SIZE != 0 {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidData,
+                "MCAP message index is truncated",
+            ));
+        }
+        let mut dropped = 0;
+        out.record(op::MESSAGE_INDEX, |w| {
+            w.u16(channel_id);
+            w.sized(|w| {
+                // The log time of the last kept entry, and the number of entries since it.
+                let mut last: Option<(u64, u64)> = None;
+                for entry in entries.chunks_exact(ENTRY_SIZE) {
+                    let mut log_time = [0; 8];
+                    log_time.copy_from_slice(&entry[..8]);
+                    let log_time = u64::from_le_bytes(log_time);
+                    match &mut last {
+                        Some((time, count))
+                            if !self.keep(*count + 1, log_time.saturating_sub(*time)) =>
+                        {
+                            *count += 1;
+                            dropped += 1;
+                        }
+                        _ => {
+                            w.raw(entry);
+                            last = Some((log_time, 0));
+                        }
+                    }
+                }
+            });
+        });
+        Ok((channel_id, dropped))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn message_index(channel_id: u16, entries: &[(u64, u64)]) -> Vec<u8> {
+        let mut w = RecordWriter::default();
+        w.record(op::MESSAGE_INDEX, |w| {
+            w.u16(channel_id);
+            w.sized(|w| {
+                for &(log_time, offset) in entries {
+                    w.u64(log_time);
+                    w.u64(offset);
+                }
+            });
+        });
+        w.into_inner()
+    }
+
+    fn entries(records: &[u8]) -> Vec<(u16, Vec<u64>)> {
+        let mut indexes = vec![];
+        let mut rest = records;
+        while let Some((opcode, body)) = split_record(rest) {
+            if opcode == op::MESSAGE_INDEX {
+                let mut reader = RecordReader::new(body);
+                let channel_id = reader.u16().unwrap();
+                let data = reader.bytes().unwrap();
+                let times = data
+                    .chunks_exact(ENTRY_SIZE)
+                    .map(|entry| u64::from_le_bytes(entry[..8].try_into().unwrap()))
+                    .collect();
+                indexes.push((channel_id, times));
+            }
+            rest = &rest[RECORD_PREFIX_LEN as usize + body.len()..];
+        }
+        indexes
+    }
+
+    #[test]
+    fn test_sparse_index_samples_by_count_and_time() {
+        let mut records = RecordWriter::default();
+        records.record(op::CHUNK, |w| w.u64(0));
+        let dense: Vec<_> = (0..10).map(|i| (i * 10, i)).collect();
+        records.raw(&message_index(1, &dense));
+        records.raw(&message_index(2, &[(0, 0), (1000, 1), (2000, 2)]));
+        let records = records.into_inner();
+
+        let sparse = McapSparseIndex {
+            every_messages: 4,
+            every_nanos: 500,
+        };
+        let mut dropped = vec![];
+        let out = sparse
+            .apply(&records, |channel_id, count| {
+                dropped.push((channel_id, count))
+            })
+            .unwrap();
+        assert_eq!(
+            entries(&out),
+            vec![(1, vec![0, 40, 80]), (2, vec![0, 1000, 2000])]
+        );
+        assert_eq!(dropped, vec![(1, 7)]);
+        assert_eq!(split_record(&out).unwrap().0, op::CHUNK);
+
+        // With no limits, the indexes are unchanged.
+        let out = McapSparseIndex::default()
+            .apply(&records, |_, _| ())
+            .unwrap();
+        assert_eq!(out, records);
+    }
+}
@@ -0,0 +1,316 @@
+//! Indexing of data section records, and encoding of the summary section which follows them.
+use std::collections::BTreeMap;
+use std::io;
+
+use crate::mcap_writer::records::{
+    ChannelRecord, FieldReader, MAGIC, RecordReader, RecordWriter, SchemaRecord, op,
+};
+
+pub(crate) struct ChunkIndex {
+    pub message_start_time: u64,
+    pub message_end_time: u64,
+    pub offset: u64,
+    pub length: u64,
+    pub message_index_offsets: BTreeMap<u16, u64>,
+    pub message_index_length: u64,
+    pub compression: String,
+    pub compressed_size: u64,
+    pub uncompressed_size: u64,
+}
+
+pub(crate) struct AttachmentIndex {
+    pub offset: u64,
+    pub length: u64,
+    log_time: u64,
+    create_time: u64,
+    data_size: u64,
+    name: String,
+    pub media_type: String,
+}
+
+struct MetadataIndex {
+    offset: u64,
+    length: u64,
+    name: String,
+}
+
+/// Builds the summary section of an MCAP file from the records of its data section.
+pub(crate) struct SummaryBuilder {
+    pub schemas: BTreeMap<u16, SchemaRecord>,
+    pub channels: BTreeMap<u16, ChannelRecord>,
+    chunks: Vec<ChunkIndex>,
+    attachments: Vec<AttachmentIndex>,
+    metadata: Vec<MetadataIndex>,
+    channel_message_counts: BTreeMap<u16, u64>,
+    message_start_time: Option<u64>,
+    message_end_time: u64,
+    // False if some messages may be missing from `channel_message_counts`.
+    counts_exact: bool,
+    // True if the last record was a chunk or one of its message indexes.
+    in_chunk: bool,
+}
+
+impl Default for SummaryBuilder {
+    fn default() -> Self {
+        Self {
+            schemas: BTreeMap::new(),
+            channels: BTreeMap::new(),
+            chunks: Vec::new(),
+            attachments: Vec::new(),
+            metadata: Vec::new(),
+            channel_message_counts: BTreeMap::new(),
+            message_start_time: None,
+            message_end_time: 0,
+            counts_exact: true,
+            in_chunk: false,
+        }
+    }
+}
+
+impl SummaryBuilder {
+    pub fn chunks(&self) -> &[ChunkIndex] {
+        &self.chunks
+    }
+
+    pub fn attachments(&self) -> &[AttachmentIndex] {
+        &self.attachments
+    }
+
+    /// Returns the ids of channels with messages.
+    pub fn message_channels(&self) -> impl Iterator<Item = u16> + '_ {
+        self.channel_message_counts.keys().copied()
+    }
+
+    /// Indexes a data section record which starts at `offset` and is `length` bytes long,
+    /// including its opcode and length prefix. `body` reads the record's fields.
+    pub fn index_record(
+        &mut self,
+        opcode: u8,
+        offset: u64,
+        length: u64,
+        body: &mut impl FieldReader,
+    ) -> io::Result<()> {
+        if opcode == op::CHUNK && self.in_chunk && self.last_chunk_is_unindexed() {
+            self.counts_exact = false;
+        }
+        match opcode {
+            op::SCHEMA => {
+                let schema = RecordReader::new(&body.rest()?).schema()?;
+                self.schemas.insert(schema.id, schema);
+            }
+            op::CHANNEL => {
+                let channel = RecordReader::new(&body.rest()?).channel()?;
+                self.channels.insert(channel.id, channel);
+            }
+            op::MESSAGE => {
+                let channel_id = body.u16()?;
+                let _sequence = body.u32()?;
+                let log_time = body.u64()?;
+                *self.channel_message_counts.entry(channel_id).or_default() += 1;
+                self.add_time_range(log_time, log_time);
+            }
+            op::CHUNK => {
+                let message_start_time = body.u64()?;
+                let message_end_time = body.u64()?;
+                let uncompressed_size = body.u64()?;
+                let _uncompressed_crc = body.u32()?;
+                let compression = body.str()?;
+                let compressed_size = body.u64()?;
+                self.chunks.push(ChunkIndex {
+                    message_start_time,
+                    message_end_time,
+                    offset,
+                    length,
+                    message_index_offsets: BTreeMap::new(),
+                    message_index_length: 0,
+                    compression,
+                    compressed_size,
+                    uncompressed_size,
+                });
+            }
+            op::MESSAGE_INDEX if self.in_chunk => {
+                let channel_id = body.u16()?;
+                // Each entry is a log time and an offset.
+                let count = u64::from(body.u32()?) / 16;
+                *self.channel_message_counts.entry(channel_id).or_default() += count;
+                if let Some(chunk) = self.chunks.last_mut() {
+                    chunk.message_index_offsets.insert(channel_id, offset);
+                    chunk.message_index_length += length;
+                    let (start, end) = (chunk.message_start_time, chunk.message_end_time);
+                    if count > 0 {
+                        self.add_time_range(start, end);
+                    }
+                }
+            }
+            op::ATTACHMENT => {
+                let log_time = body.u64()?;
+                let create_time = body.u64()?;
+                let name = body.str()?;
+                let media_type = body.str()?;
+                let data_size = body.u64()?;
+                self.attachments.push(AttachmentIndex {
+                    offset,
+                    length,
+                    log_time,
+                    create_time,
+                    data_size,
+                    name,
+                    media_type,
+                });
+            }
+            op::METADATA => {
+                let name = body.str()?;
+                self.metadata.push(MetadataIndex {
+                    offset,
+                    length,
+                    name,
+                });
+            }
+            _ => (),
+        }
+        self.in_chunk = match opcode {
+            op::CHUNK => true,
+            op::MESSAGE_INDEX => self.in_chunk,
+            _ => false,
+        };
+        Ok(())
+    }
+
+    /// Marks the end of the data section.
+    pub fn end_data_section(&mut self) {
+        if self.in_chunk && self.last_chunk_is_unindexed() {
+            // The writer may have stopped before the chunk's message indexes were written.
+            self.counts_exact = false;
+        }
+        self.in_chunk = false;
+    }
+
+    fn last_chunk_is_unindexed(&self) -> bool {
+        self.chunks
+            .last()
+            .is_some_and(|chunk| chunk.message_index_offsets.is_empty())
+    }
+
+    /// Counts messages of a channel which are in a chunk, but were left out of its message index.
+    pub fn add_unindexed_messages(&mut self, channel_id: u16, count: u64) {
+        *self.channel_message_counts.entry(channel_id).or_default() += count;
+    }
+
+    fn add_time_range(&mut self, start: u64, end: u64) {
+        self.message_start_time = Some(self.message_start_time.map_or(start, |t| t.min(start)));
+        self.message_end_time = self.message_end_time.max(end);
+    }
+
+    /// Encodes the data end record, summary section, footer, and closing magic, for a data
+    /// section which ends at `data_end`.
+    pub fn summary(&self, data_end: u64) -> Vec<u8> {
+        let mut w = RecordWriter::default();
+        w.record(op::DATA_END, |w| w.u32(0));
+        let summary_start = data_end + w.len() as u64;
+        // Opcode, start, and length of each group of summary records.
+        let mut groups = Vec::new();
+        let mut group_start = w.len();
+        let mut end_group = |w: &RecordWriter, opcode: u8| {
+            if w.len() > group_start {
+                groups.push((opcode, group_start, w.len() - group_start));
+            }
+            group_start = w.len();
+        };
+
+        for schema in self.schemas.values() {
+            w.schema(schema.id, &schema.name, &schema.encoding, &schema.data);
+        }
+        end_group(&w, op::SCHEMA);
+        for channel in self.channels.values() {
+            w.channel(
+                channel.id,
+                channel.schema_id,
+                &channel.topic,
+                &channel.message_encoding,
+                &channel.metadata,
+            );
+        }
+        end_group(&w, op::CHANNEL);
+        if self.counts_exact {
+            self.write_statistics(&mut w);
+        }
+        end_group(&w, op::STATISTICS);
+        for chunk in &self.chunks {
+            w.record(op::CHUNK_INDEX, |w| {
+                w.u64(chunk.message_start_time);
+                w.u64(chunk.message_end_time);
+                w.u64(chunk.offset);
+                w.u64(chunk.length);
+                w.sized(|w| {
+                    for (&channel_id, &offset) in &chunk.message_index_offsets {
+                        w.u16(channel_id);
+                        w.u64(offset);
+                    }
+                });
+                w.u64(chunk.message_index_length);
+                w.str(&chunk.compression);
+                w.u64(chunk.compressed_size);
+                w.u64(chunk.uncompressed_size);
+            });
+        }
+        end_group(&w, op::CHUNK_INDEX);
+        for attachment in &self.attachments {
+            w.record(op::ATTACHMENT_INDEX, |w| {
+                w.u64(attachment.offset);
+                w.u64(attachment.length);
+                w.u64(attachment.log_time);
+                w.u64(attachment.create_time);
+                w.u64(attachment.data_size);
+                w.str(&attachment.name);
+                w.str(&attachment.media_type);
+            });
+        }
+        end_group(&w, op::ATTACHMENT_INDEX);
+        for metadata in &self.metadata {
+            w.record(op::METADATA_INDEX, |w| {
+                w.u64(metadata.offset);
+                w.u64(metadata.length);
+                w.str(&metadata.name);
+            });
+        }
+        end_group(&w, op::METADATA_INDEX);
+
+        let summary_offset_start = data_end + w.len() as u64;
+        for (opcode, start, len) in groups {
+            w.record(op::SUMMARY_OFFSET, |w| {
+                w.u8(opcode);
+                w.u64(data_end + start as u64);
+                w.u64(len as u64);
+            });
+        }
+        let has_summary = summary_offset_start > summary_start;
+        w.record(op::FOOTER, |w| {
+            w.u64(if has_summary { summary_start } else { 0 });
+            w.u64(if has_summary { summary_offset_start } else { 0 });
+            // A CRC of zero indicates that the CRC is not available.
+            w.u32(0);
+        });
+        let mut buf = w.into_inner();
+        buf.extend_from_slice(MAGIC);
+        buf
+    }
+
+    fn write_statistics(&self, w: &mut RecordWriter) {
+        w.record(op::STATISTICS, |w| {
+            w.u64(self.channel_message_counts.values().sum());
+            w.u16(self.schemas.len() as u16);
+            w.u32(self.channels.len() as u32);
+            w.u32(self.attachments.len() as u32);
+            w.u32(self.metadata.len() as u32);
+            w.u32(self.chunks.len() as u32);
+            w.u64(self.message_start_time.unwrap_or(0));
+            w.u64(self.message_end_time);
+            w.sized(|w| {
+                for (&channel_id, &count) in &self.channel_message_counts {
+                    w.u16(channel_id);
+                    w.u64(count);
+                }
+            });
+        });
+    }
+}
@@ -0,0 +1,551 @@
+//! Bounded queue between logging threads and the background MCAP writer thread.
+//!
+//! Each logging thread stages messages in one of several lanes, so that threads logging
+//! concurrently don't contend on a single lock. The writer thread drains every lane at once and
+//! merges them in log time order. Messages staged in the same lane keep the order in which they
+//! were logged, so messages logged from one thread (and in particular, to one channel from one
+//! thread) are always written in order.
+//!
+//! The queue is sharded rather than lock-free: each lane is a mutex-guarded deque, which is
+//! usually uncontended, and the writer thread waits on a condition variable. Only the
+//! asynchronous MCAP writer uses it; other sinks are called on the logging thread.
+use std::cmp::Reverse;
+use std::collections::{BinaryHeap, VecDeque};
+use std::num::NonZeroUsize;
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
+
+use bytes::Bytes;
+use parking_lot::{Condvar, Mutex};
+
+use crate::latency::Trace;
+use crate::mcap_writer::{McapAsyncOptions, McapOverflowPolicy, McapWriterStats};
+use crate::memory_budget::MemoryAccount;
+use crate::{ChannelDescriptor, FoxgloveError, Metadata};
+
+/// The maximum number of lanes in a queue.
+const MAX_LANES: usize = 64;
+
+/// Source of lane indices for logging threads.
+static NEXT_LANE: AtomicUsize = AtomicUsize::new(0);
+
+thread_local! {
+    /// The index of this thread's lane, assigned round-robin on first use.
+    static LANE: usize = NEXT_LANE.fetch_add(1, Ordering::Relaxed);
+}
+
+/// Returns the index of the calling thread's lane.
+fn thread_lane() -> usize {
+    LANE.with(|lane| *lane)
+}
+
+/// A message waiting to be written by the background thread.
+pub(crate) struct QueuedMessage {
+    pub channel: ChannelDescriptor,
+    /// The message data, which shares the logged buffer if it was logged with
+    /// [`Sink::log_shared`][crate::Sink::log_shared].
+    pub data: Bytes,
+    pub metadata: Metadata,
+    /// The latency trace of the message, if it was sampled.
+    pub trace: Option<Trace>,
+}
+
+/// Messages staged by the threads assigned to a lane.
+///
+/// Aligned to keep the locks of neighboring lanes on separate cache lines.
+#[derive(Default)]
+#[repr(align(128))]
+struct Lane(Mutex<VecDeque<QueuedMessage>>);
+
+#[derive(Default)]
+struct QueueState {
+    // Number of messages taken by the writer thread which have not been written yet.
+    in_flight: usize,
+    // Number of bytes of the messages in flight, which are still charged to the memory budget.
+    in_flight_bytes: usize,
+    // Set when the writer thread has exited.
+    finished: bool,
+}
+
+pub(crate) struct WriteQueue {
+    lanes: Box<[Lane]>,
+    // Number of messages staged in the lanes. Incremented while holding the lock of the lane the
+    // message is pushed to, and only decremented while holding `state`, so that it never counts
+    // fewer messages than the writer thread can take from the lanes.
+    len: AtomicUsize,
+    state: Mutex<QueueState>,
+    // Set when no more messages will be accepted.
+    closed: AtomicBool,
+    // Set while the writer thread waits for messages, so producers know to wake it.
+    waiting: AtomicBool,
+    // Signalled when messages are queued, or when the queue is closed.
+    work: Condvar,
+    // Signalled when the writer thread takes or finishes writing a batch of messages.
+    progress: Condvar,
+    capacity: usize,
+    overflow_policy: McapOverflowPolicy,
+    dropped: AtomicU64,
+    // Charged with the bytes of queued and in-flight messages, against the context's memory
+    // budget.
+    memory: MemoryAccount,
+}
+
+impl WriteQueue {
+    /// Creates a queue with a lane for each available CPU.
+    pub fn new(options: &McapAsyncOptions, memory: MemoryAccount) -> Self {
+        let lanes = std::thread::available_parallelism().map_or(1, NonZeroUsize::get);
+        Self::with_lanes(options, memory, lanes)
+    }
+
+    fn with_lanes(options: &McapAsyncOptions, memory: MemoryAccount, lanes: usize) -> Self {
+        Self {
+            lanes: (0..lanes.clamp(1, MAX_LANES))
+                .map(|_| Lane::default())
+                .collect(),
+            len: AtomicUsize::new(0),
+            state: Mutex::default(),
+            closed: AtomicBool::new(false),
+            waiting: AtomicBool::new(false),
+            work: Condvar::new(),
+            progress: Condvar::new(),
+            capacity: options.queue_capacity.max(1),
+            overflow_policy: options.overflow_policy,
+            dropped: AtomicU64::new(0),
+            memory,
+        }
+    }
+
+    /// Returns true if pushing to a full queue blocks until the writer thread makes room.
+    pub fn blocks(&self) -> bool {
+        self.overflow_policy == McapOverflowPolicy::Block
+    }
+
+    /// Queues messages for the writer thread, applying the overflow policy when the queue is full,
+    /// or when the context's memory budget is exceeded while messages are queued.
+    ///
+    /// The capacity is shared by all lanes, and is checked without synchronizing with other
+    /// logging threads, so the queue may briefly exceed it by a message per thread.
+    ///
+    /// Returns [`FoxgloveError::SinkClosed`] if the queue has been closed.
+    pub fn push(
+        &self,
+        messages: impl IntoIterator<Item = QueuedMessage>,
+    ) -> Result<(), FoxgloveError> {
+        self.push_to_lane(thread_lane() % self.lanes.len(), messages)
+    }
+
+    fn push_to_lane(
+        &self,
+        index: usize,
+        messages: impl IntoIterator<Item = QueuedMessage>,
+    ) -> Result<(), FoxgloveError> {
+        let lane = &self.lanes[index].0;
+        let mut queued = false;
+        for message in messages {
+            if self.closed.load(Ordering::Acquire) {
+                return Err(FoxgloveError::SinkClosed);
+            }
+            let full = self.len.load(Ordering::Relaxed) >= self.capacity;
+            if full || self.over_budget() {
+                if !full {
+                    self.memory.dropped();
+                }
+                match self.overflow_policy {
+                    McapOverflowPolicy::Block => self.wait_for_capacity()?,
+                    McapOverflowPolicy::DropNewest => {
+                        self.dropped.fetch_add(1, Ordering::Relaxed);
+                        continue;
+                    }
+                    McapOverflowPolicy::DropOldest => self.drop_oldest(index),
+                }
+            }
+            self.memory.charge(message.data.len());
+            let mut lane = lane.lock();
+            lane.push_back(message);
+            self.len.fetch_add(1, Ordering::SeqCst);
+            drop(lane);
+            queued = true;
+        }
+        if queued && self.waiting.load(Ordering::SeqCst) {
+            // Take the lock so the notification can't be lost between the writer thread setting
+            // `waiting` and going to sleep.
+            let _state = self.state.lock();
+            self.work.notify_one();
+        }
+        Ok(())
+    }
+
+    /// Returns true if the memory budget is exceeded while this queue holds messages.
+    ///
+    /// An empty queue always accepts a message, so that a sink is never starved by the messages
+    /// buffered by other sinks.
+    fn over_budget(&self) -> bool {
+        self.memory.exceeded() && self.len.load(Ordering::Relaxed) > 0
+    }
+
+    /// Blocks until the writer thread has made room in the queue.
+    fn wait_for_capacity(&self) -> Result<(), FoxgloveError> {
+        let mut state = self.state.lock();
+        // Make sure the writer thread is awake before waiting on it.
+        self.work.notify_one();
+        while (self.len.load(Ordering::SeqCst) >= self.capacity
+            || (self.memory.exceeded() && self.len.load(Ordering::SeqCst) + state.in_flight > 0))
+            && !self.closed.load(Ordering::Acquire)
+        {
+            self.progress.wait(&mut state);
+        }
+        if self.closed.load(Ordering::Acquire) {
+            return Err(FoxgloveError::SinkClosed);
+        }
+        Ok(())
+    }
+
+    /// Drops the oldest message of the lane at `index`, or of the next lane with messages.
+    fn drop_oldest(&self, index: usize) {
+        let _state = self.state.lock();
+        let lanes = self.lanes.len();
+        for lane in (0..lanes).map(|i| &self.lanes[(index + i) % lanes].0) {
+            if let Some(message) = lane.lock().pop_front() {
+                self.memory.release(message.data.len());
+                self.len.fetch_sub(1, Ordering::SeqCst);
+                self.dropped.fetch_add(1, Ordering::Relaxed);
+                return;
+            }
+        }
+    }
+
+    /// Moves every queued message into `batch`, blocking until at least one is available.
+    ///
+    /// Messages are merged from all lanes in log time order, keeping the order of messages within
+    /// each lane. `batch` must be empty. Returns false once the queue is closed and drained.
+    pub fn take(&self, batch: &mut VecDeque<QueuedMessage>) -> bool {
+        debug_assert!(batch.is_empty());
+        let mut state = self.state.lock();
+        let (staged, count) = loop {
+            while self.len.load(Ordering::SeqCst) == 0 && !self.closed.load(Ordering::Acquire) {
+                self.waiting.store(true, Ordering::SeqCst);
+                // Re-check after publishing `waiting`, in case a producer queued a message without
+                // seeing it.
+                if self.len.load(Ordering::SeqCst) == 0 && !self.closed.load(Ordering::Acquire) {
+                    self.work.wait(&mut state);
+                }
+                self.waiting.store(false, Ordering::SeqCst);
+            }
+
+            let mut staged: Vec<VecDeque<QueuedMessage>> = Vec::new();
+            for lane in self.lanes.iter() {
+                let mut lane = lane.0.lock();
+                if !lane.is_empty() {
+                    staged.push(std::mem::take(&mut *lane));
+                }
+            }
+            let count: usize = staged.iter().map(VecDeque::len).sum();
+            if count > 0 {
+                break (staged, count);
+            }
+            if self.closed.load(Ordering::Acquire) {
+                return false;
+            }
+        };
+        self.len.fetch_sub(count, Ordering::SeqCst);
+        state.in_flight = count;
+        state.in_flight_bytes = staged
+            .iter()
+            .flatten()
+            .map(|message| message.data.len())
+            .sum();
+        self.progress.notify_all();
+        drop(state);
+
+        merge(staged, batch);
+        true
+    }
+
+    /// Marks the batch returned by the last call to [`WriteQueue::take`] as written.
+    pub fn done(&self) {
+        let mut state = self.state.lock();
+        state.in_flight = 0;
+        self.memory
+            .release(std::mem::take(&mut state.in_flight_bytes));
+        self.progress.notify_all();
+    }
+
+    /// Blocks until every message queued so far has been written.
+    pub fn wait_idle(&self) {
+        let mut state = self.state.lock();
+        while (self.len.load(Ordering::SeqCst) > 0 || state.in_flight > 0) && !state.finished {
+            // Wake the writer thread, in case messages were queued without notifying it.
+            self.work.notify_one();
+            self.progress.wait(&mut state);
+        }
+    }
+
+    /// Stops accepting new messages. The writer thread exits once the queue is drained.
+    pub fn close(&self) {
+        let _state = self.state.lock();
+        self.closed.store(true, Ordering::Release);
+        self.work.notify_all();
+        self.progress.notify_all();
+    }
+
+    /// Called by the writer thread when it exits.
+    pub fn finished(&self) {
+        let mut state = self.state.lock();
+        state.finished = true;
+        state.in_flight = 0;
+        self.memory
+            .release(std::mem::take(&mut state.in_flight_bytes));
+        for lane in self.lanes.iter() {
+            let mut lane = lane.0.lock();
+            self.len.fetch_sub(lane.len(), Ordering::SeqCst);
+            for message in lane.drain(..) {
+                self.memory.release(message.data.len());
+            }
+        }
+        self.progress.notify_all();
+    }
+
+    pub fn stats(&self) -> McapWriterStats {
+        let state = self.state.lock();
+        McapWriterStats {
+            queue_depth: self.len.load(Ordering::SeqCst) + state.in_flight,
+            dropped_messages: self.dropped.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// Merges messages staged in several lanes into `batch`, in log time order.
+///
+/// The lanes are merged by comparing their oldest messages, so the order of messages within each
+/// lane is kept even if their log times are out of order.
+fn merge(mut staged: Vec<VecDeque<QueuedMessage>>, batch: &mut VecDeque<QueuedMessage>) {
+    if staged.len() == 1 {
+        *batch = staged.remove(0);
+        return;
+    }
+    let mut heads: BinaryHeap<_> = staged
+        .iter()
+        .enumerate()
+        .filter_map(|(i, lane)| Some(Reverse((lane.front()?.metadata.log_time, i))))
+        .collect();
+    while let Some(Reverse((_, i))) = heads.pop() {
+        let lane = &mut staged[i];
+        if let Some(message) = lane.pop_front() {
+            batch.push_back(message);
+        }
+        if let Some(next) = lane.front() {
+            heads.push(Reverse((next.metadata.log_time, i)));
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::memory_budget::{MemoryAccounting, MemoryBudget};
+    use crate::{ChannelId, MemoryPool};
+    use std::sync::Arc;
+
+    fn message(log_time: u64) -> QueuedMessage {
+        QueuedMessage {
+            channel: ChannelDescriptor::new(
+                ChannelId::new(1),
+                "/topic".into(),
+                "json".into(),
+                Default::default(),
+                None,
+            ),
+            data: Bytes::copy_from_slice(&log_time.to_le_bytes()),
+            metadata: Metadata { log_time },
+            trace: None,
+        }
+    }
+
+    fn queue(overflow_policy: McapOverflowPolicy) -> WriteQueue {
+        WriteQueue::new(
+            &McapAsyncOptions {
+                queue_capacity: 2,
+                overflow_policy,
+            },
+            MemoryAccount::detached(MemoryPool::Mcap),
+        )
+    }
+
+    fn drain(queue: &WriteQueue) -> Vec<u64> {
+        let mut batch = VecDeque::new();
+        assert!(queue.take(&mut batch));
+        queue.done();
+        batch.iter().map(|m| m.metadata.log_time).collect()
+    }
+
+    #[test]
+    fn test_drop_newest() {
+        let queue = queue(McapOverflowPolicy::DropNewest);
+        queue.push((1..=4).map(message)).unwrap();
+        assert_eq!(
+            queue.stats(),
+            McapWriterStats {
+                queue_depth: 2,
+                dropped_messages: 2
+            }
+        );
+        assert_eq!(drain(&queue), vec![1, 2]);
+        assert_eq!(queue.stats().queue_depth, 0);
+    }
+
+    #[test]
+    fn test_drop_oldest() {
+        let queue = queue(McapOverflowPolicy::DropOldest);
+        queue.push((1..=4).map(message)).unwrap();
+        assert_eq!(queue.stats().dropped_messages, 2);
+        assert_eq!(drain(&queue), vec![3, 4]);
+    }
+
+    #[test]
+    fn test_memory_budget() {
+        let accounting = Arc::new(MemoryAccounting::default());
+        // Each message is 8 bytes, so the budget is exceeded once three are queued.
+        accounting.set_budget(Some(MemoryBudget::new(16)));
+        let queue = WriteQueue::new(
+            &McapAsyncOptions {
+                queue_capacity: 16,
+                overflow_policy: McapOverflowPolicy::DropNewest,
+            },
+            MemoryAccount::new(accounting.clone(), MemoryPool::Mcap),
+        );
+        queue.push((1..=4).map(message)).unwrap();
+        assert_eq!(queue.stats().dropped_messages, 1);
+        assert_eq!(accounting.usage().bytes, 24);
+
+        // Messages stay charged until they have been written.
+        let mut batch = VecDeque::new();
+        assert!(queue.take(&mut batch));
+        assert_eq!(accounting.usage().bytes, 24);
+        queue.done();
+        assert_eq!(accounting.usage().bytes, 0);
+        assert_eq!(accounting.usage().pools[2].dropped, 1);
+    }
+
+    #[test]
+    fn test_merge_lanes_in_log_time_order() {
+        let queue = WriteQueue::with_lanes(
+            &McapAsyncOptions {
+                queue_capacity: 16,
+                overflow_policy: McapOverflowPolicy::Block,
+            },
+            MemoryAccount::detached(MemoryPool::Mcap),
+            2,
+        );
+        queue.push_to_lane(0, [1, 4, 3].map(message)).unwrap();
+        queue.push_to_lane(1, [2, 5].map(message)).unwrap();
+        assert_eq!(queue.stats().queue_depth, 5);
+        // Messages from the same lane stay in order, even when their log times are not.
+        assert_eq!(drain(&queue), vec![1, 2, 4, 3, 5]);
+    }
+
+    #[test]
+    fn test_block_waits_for_writer() {
+        let queue = Arc::new(queue(McapOverflowPolicy::Block));
+        let writer = std::thread::spawn({
+            let queue = queue.clone();
+            move || {
+                let mut written = vec![];
+                let mut batch = VecDeque::new();
+                while queue.take(&mut batch) {
+                    written.extend(batch.drain(..).map(|m| m.metadata.log_time));
+                    queue.done();
+                }
+                queue.finished();
+                written
+            }
+        });
+        queue.push((1..=10).map(message)).unwrap();
+        queue.wait_idle();
+        queue.close();
+        assert!(matches!(
+            queue.push(std::iter::once(message(11))),
+            Err(FoxgloveError::SinkClosed)
+        ));
+        assert_eq!(writer.join().unwrap(), (1..=10).collect::<Vec<_>>());
+        assert_eq!(queue.stats().dropped_messages, 0);
+    }
+
+    /// Pushes messages from several threads to a queue drained by a writer thread. Returns the
+    /// number of messages logged, written and dropped.
+    fn stress(overflow_policy: McapOverflowPolicy) -> (u64, u64, u64) {
+        const PRODUCERS: u64 = 16;
+        const MESSAGES: u64 = 50_000;
+        // Fewer lanes than producers, so that producers also contend on each lane.
+        let queue = Arc::new(WriteQueue::with_lanes(
+            &McapAsyncOptions {
+                queue_capacity: 1024,
+                overflow_policy,
+            },
+            MemoryAccount::detached(MemoryPool::Mcap),
+            4,
+        ));
+        let writer = std::thread::spawn({
+            let queue = queue.clone();
+            move || {
+                let mut written = 0;
+                let mut last = [None; PRODUCERS as usize];
+                let mut batch = VecDeque::new();
+                while queue.take(&mut batch) {
+                    for message in batch.drain(..) {
+                        let log_time = message.metadata.log_time;
+                        // Messages from each producer are written in the order they were logged.
+                        let last = &mut last[(log_time / MESSAGES) as usize];
+                        assert!(last.is_none_or(|last| last < log_time));
+                        *last = Some(log_time);
+                        written += 1;
+                    }
+                    queue.done();
+                }
+                queue.finished();
+                written
+            }
+        });
+        let producers: Vec<_> = (0..PRODUCERS)
+            .map(|producer| {
+                let queue = queue.clone();
+                std::thread::spawn(move || {
+                    for i in 0..MESSAGES {
+                        queue
+                            .push(std::iter::once(message(producer * MESSAGES + i)))
+                            .unwrap();
+                    }
+                })
+            })
+            .collect();
+        for producer in producers {
+            producer.join().unwrap();
+        }
+        queue.wait_idle();
+        assert_eq!(queue.stats().queue_depth, 0);
+        queue.close();
+        let written = writer.join().unwrap();
+        (
+            PRODUCERS * MESSAGES,
+            written,
+            queue.stats().dropped_messages,
+        )
+    }
+
+    #[test]
+    fn test_stress_block() {
+        let (logged, written, dropped) = stress(McapOverflowPolicy::Block);
+        assert_eq!(written, logged);
+        assert_eq!(dropped, 0);
+    }
+
+    #[test]
+    fn test_stress_drop_newest() {
+        let (logged, written, dropped) = stress(McapOverflowPolicy::DropNewest);
+        assert_eq!(written + dropped, logged);
+    }
+
+    #[test]
+    fn test_stress_drop_oldest() {
+        let (logged, written, dropped) = stress(McapOverflowPolicy::DropOldest);
+        assert_eq!(written + dropped, logged);
+    }
+}
@@ -0,0 +1,94 @@
+//! Zstd dictionaries for chunks of small messages.
+use std::io;
+
+use crate::mcap_writer::compression_policy::McapChunkCompression;
+
+/// Media type of the attachments which hold the zstd dictionaries of an MCAP file.
+pub const MCAP_ZSTD_DICTIONARY_MEDIA_TYPE: &str = "application/vnd.foxglove.zstd-dictionary";
+
+/// Options for compressing chunks with zstd dictionaries trained from the recording.
+///
+/// Small messages, such as logs or key-value pairs, only compress well once a chunk holds many
+/// of them. A dictionary trained from earlier messages of the same schema lets small chunks
+/// compress about as well as large ones, so that a small chunk size can be used for a live
+/// tail without losing compression ratio.
+///
+/// See [`McapWriter::zstd_dictionary`][crate::McapWriter::zstd_dictionary].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct McapZstdDictionary {
+    /// Number of messages of each schema to train the schema's dictionary from.
+    ///
+    /// The training messages are written with the writer's compression. Values less than 1 are
+    /// treated as 1.
+    pub training_messages: usize,
+    /// Maximum size of each dictionary, in bytes.
+    pub max_size: usize,
+    /// Compression level for chunks compressed with a dictionary. 0 uses zstd's default level.
+    pub level: u32,
+}
+
+impl Default for McapZstdDictionary {
+    fn default() -> Self {
+        Self {
+            training_messages: 1000,
+            max_size: 16 * 1024,
+            level: 0,
+        }
+    }
+}
+
+/// Returns true if channels whose chunks have the given compression may use a dictionary.
+///
+/// `None` is the writer's compression, which dictionary streams replace with zstd.
+pub(crate) fn uses_dictionary(compression: Option<McapChunkCompression>) -> bool {
+    #[cfg(feature = "zstd")]
+    {
+        compression.is_none_or(|chunk| chunk.compression == Some(crate::McapCompression::Zstd))
+    }
+    #[cfg(not(feature = "zstd"))]
+    {
+        let _ = compression;
+        false
+    }
+}
+
+/// A zstd compressor which uses a dictionary trained from sample messages.
+#[cfg(feature = "zstd")]
+pub(crate) struct DictionaryCompressor(zstd::bulk::Compressor<'static>);
+
+#[cfg(feature = "zstd")]
+impl DictionaryCompressor {
+    /// Trains a dictionary from the samples, and returns a compressor which uses it along with
+    /// the dictionary.
+    pub fn train(samples: &[Vec<u8>], options: &McapZstdDictionary) -> io::Result<(Self, Vec<u8>)> {
+        let dictionary = zstd::dict::from_samples(samples, options.max_size)?;
+        let level = i32::try_from(options.level).unwrap_or(i32::MAX);
+        let compressor = zstd::bulk::Compressor::with_dictionary(level, &dictionary)?;
+        Ok((Self(compressor), dictionary))
+    }
+
+    pub fn compress(&mut self, data: &[u8]) -> io::Result<Vec<u8>> {
+        self.0.compress(data)
+    }
+}
+
+/// Dictionaries require the `zstd` feature, so no compressor can be created without it.
+#[cfg(not(feature = "zstd"))]
+pub(crate) enum DictionaryCompressor {}
+
+#[cfg(not(feature = "zstd"))]
+impl DictionaryCompressor {
+    pub fn train(
+        _samples: &[Vec<u8>],
+        _options: &McapZstdDictionary,
+    ) -> io::Result<(Self, Vec<u8>)> {
+        Err(io::Error::new(
+            io::ErrorKind::Unsupported,
+            "zstd dictionaries require the zstd feature",
+        ))
+    }
+
+    pub fn compress(&mut self, _data: &[u8]) -> io::Result<Vec<u8>> {
+        match *self {}
+    }
+}
@@ -0,0 +1,338 @@
+//! Byte budget for the messages buffered by the sinks of a context.
+//!
+//! Each sink which buffers messages, such as a WebSocket client's backlog, a remote access
+//! participant's backlog, or the queue of a background MCAP writer, charges the bytes it holds to
+//! the budget of its context. When the budget, or the share of it allotted to the sink's pool, is
+//! exhausted, the sink applies its own overflow policy: it drops messages, or blocks, as it would
+//! when its own limits are exceeded.
+
+use std::sync::Arc;
+use std::sync::atomic::{AtomicU64, AtomicUsize, Ordering};
+
+/// A kind of sink which buffers messages, whose buffered bytes are accounted together.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum MemoryPool {
+    /// The backlogs of WebSocket server clients.
+    WebSocket,
+    /// The backlogs of remote access participants.
+    RemoteAccess,
+    /// The queues, open chunks, and pending output of MCAP writers.
+    Mcap,
+}
+
+impl MemoryPool {
+    const ALL: [Self; 3] = [Self::WebSocket, Self::RemoteAccess, Self::Mcap];
+
+    fn index(self) -> usize {
+        self as usize
+    }
+}
+
+/// A limit on the bytes buffered by the sinks of a context.
+///
+/// The budget applies to the messages which sinks hold until they can be sent or written. It is
+/// shared by the sinks of the context, and each [`MemoryPool`] can be limited to a share of it,
+/// so that, for example, a slow WebSocket client can't starve an MCAP writer.
+///
+/// When a sink would exceed the budget or its pool's share, it applies its overflow policy:
+/// WebSocket clients and remote access participants drop messages according to their backlog
+/// policy, and MCAP writers apply their [`McapOverflowPolicy`][crate::McapOverflowPolicy]. A sink
+/// always keeps at least one message, so that a single message larger than the budget can still
+/// be delivered.
+///
+/// Remote access participants queue channel messages only with a dropping backlog policy, and
+/// MCAP writers only when they write on a background thread. MCAP writers also charge the records
+/// of the chunks they are building, and the compressed output waiting for their I/O thread. These
+/// buffers are bounded by the chunk size and pipeline depth rather than by the budget, but count
+/// towards it, so that the queues of the writers and of the other sinks make room for them.
+///
+/// ```
+/// use foxglove::{Context, MemoryBudget, MemoryPool};
+///
+/// let ctx = Context::new();
+/// ctx.set_memory_budget(Some(
+///     MemoryBudget::new(256 * 1024 * 1024).share(MemoryPool::WebSocket, 0.25),
+/// ));
+/// ```
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct MemoryBudget {
+    bytes: usize,
+    shares: [Option<f64>; MemoryPool::ALL.len()],
+}
+
+impl MemoryBudget {
+    /// Creates a budget of `bytes` bytes, shared by all sinks.
+    pub fn new(bytes: usize) -> Self {
+        Self {
+            bytes,
+            shares: [None; MemoryPool::ALL.len()],
+        }
+    }
+
+    /// Limits the sinks of `pool` to a fraction of the budget, between 0 and 1.
+    ///
+    /// By default, each pool may use the whole budget.
+    #[must_use]
+    pub fn share(mut self, pool: MemoryPool, fraction: f64) -> Self {
+        self.shares[pool.index()] = Some(fraction.clamp(0.0, 1.0));
+        self
+    }
+
+    /// Returns the total number of bytes in the budget.
+    pub fn bytes(&self) -> usize {
+        self.bytes
+    }
+
+    /// Returns the number of bytes the sinks of `pool` may use.
+    pub fn pool_bytes(&self, pool: MemoryPool) -> usize {
+        match self.shares[pool.index()] {
+            Some(fraction) => (self.bytes as f64 * fraction) as usize,
+            None => self.bytes,
+        }
+    }
+}
+
+/// The bytes buffered by the sinks of a pool. See [`MemoryUsage`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct MemoryPoolUsage {
+    /// The pool.
+    pub pool: MemoryPool,
+    /// The number of bytes currently buffered.
+    pub bytes: usize,
+    /// The highest number of bytes buffered at once.
+    pub peak_bytes: usize,
+    /// The number of bytes the pool may use, if the context has a budget.
+    pub limit: Option<usize>,
+    /// The number of messages dropped because the budget or the pool's share was exhausted.
+    pub dropped: u64,
+}
+
+/// The bytes buffered by the sinks of a context. See [`Context::memory_usage`].
+///
+/// [`Context::memory_usage`]: crate::Context::memory_usage
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct MemoryUsage {
+    /// The number of bytes currently buffered.
+    pub bytes: usize,
+    /// The highest number of bytes buffered at once.
+    pub peak_bytes: usize,
+    /// The budget, if the context has one.
+    pub limit: Option<usize>,
+    /// The usage of each pool.
+    pub pools: Vec<MemoryPoolUsage>,
+}
+
+/// A byte counter with a limit.
+struct Counter {
+    /// The limit, or `usize::MAX` if unlimited.
+    limit: AtomicUsize,
+    bytes: AtomicUsize,
+    peak_bytes: AtomicUsize,
+}
+
+impl Counter {
+    const fn new() -> Self {
+        Self {
+            limit: AtomicUsize::new(usize::MAX),
+            bytes: AtomicUsize::new(0),
+            peak_bytes: AtomicUsize::new(0),
+        }
+    }
+
+    fn add(&self, bytes: usize) {
+        let total = self.bytes.fetch_add(bytes, Ordering::Relaxed) + bytes;
+        self.peak_bytes.fetch_max(total, Ordering::Relaxed);
+    }
+
+    fn sub(&self, bytes: usize) {
+        self.bytes.fetch_sub(bytes, Ordering::Relaxed);
+    }
+
+    fn exceeded(&self) -> bool {
+        self.bytes.load(Ordering::Relaxed) > self.limit.load(Ordering::Relaxed)
+    }
+
+    fn limit(&self) -> Option<usize> {
+        Some(self.limit.load(Ordering::Relaxed)).filter(|&limit| limit != usize::MAX)
+    }
+}
+
+/// The memory accounting of a context, shared with the sinks which buffer messages.
+pub(crate) struct MemoryAccounting {
+    total: Counter,
+    pools: [Counter; MemoryPool::ALL.len()],
+    dropped: [AtomicU64; MemoryPool::ALL.len()],
+}
+
+impl Default for MemoryAccounting {
+    fn default() -> Self {
+        Self {
+            total: Counter::new(),
+            pools: [const { Counter::new() }; MemoryPool::ALL.len()],
+            dropped: [const { AtomicU64::new(0) }; MemoryPool::ALL.len()],
+        }
+    }
+}
+
+impl MemoryAccounting {
+    /// Sets or removes the budget. Sinks apply it to the messages they buffer from then on.
+    pub fn set_budget(&self, budget: Option<MemoryBudget>) {
+        let limit = |bytes: Option<usize>| bytes.unwrap_or(usize::MAX);
+        self.total
+            .limit
+            .store(limit(budget.map(|b| b.bytes())), Ordering::Relaxed);
+        for pool in MemoryPool::ALL {
+            self.pools[pool.index()]
+                .limit
+                .store(limit(budget.map(|b| b.pool_bytes(pool))), Ordering::Relaxed);
+        }
+    }
+
+    pub fn usage(&self) -> MemoryUsage {
+        MemoryUsage {
+            bytes: self.total.bytes.load(Ordering::Relaxed),
+            peak_bytes: self.total.peak_bytes.load(Ordering::Relaxed),
+            limit: self.total.limit(),
+            pools: MemoryPool::ALL
+                .into_iter()
+                .map(|pool| {
+                    let counter = &self.pools[pool.index()];
+                    MemoryPoolUsage {
+                        pool,
+                        bytes: counter.bytes.load(Ordering::Relaxed),
+                        peak_bytes: counter.peak_bytes.load(Ordering::Relaxed),
+                        limit: counter.limit(),
+                        dropped: self.dropped[pool.index()].load(Ordering::Relaxed),
+                    }
+                })
+                .collect(),
+        }
+    }
+}
+
+/// A sink's handle for charging the bytes it buffers to its context's budget.
+///
+/// The sink charges each message it buffers, and releases it once the message is sent, written,
+/// or dropped. Any bytes still charged are released when the account is dropped.
+pub(crate) struct MemoryAccount {
+    accounting: Arc<MemoryAccounting>,
+    pool: MemoryPool,
+    bytes: AtomicUsize,
+}
+
+impl MemoryAccount {
+    pub fn new(accounting: Arc<MemoryAccounting>, pool: MemoryPool) -> Self {
+        Self {
+            accounting,
+            pool,
+            bytes: AtomicUsize::new(0),
+        }
+    }
+
+    /// Returns an account which isn't charged to any context, for sinks created without one.
+    pub fn detached(pool: MemoryPool) -> Self {
+        Self::new(Arc::default(), pool)
+    }
+
+    /// Returns a new account, charged to the same budget and pool as this one.
+    pub fn sibling(&self) -> Self {
+        Self::new(self.accounting.clone(), self.pool)
+    }
+
+    /// Charges bytes for a buffered message.
+    pub fn charge(&self, bytes: usize) {
+        self.bytes.fetch_add(bytes, Ordering::Relaxed);
+        self.accounting.total.add(bytes);
+        self.accounting.pools[self.pool.index()].add(bytes);
+    }
+
+    /// Releases bytes charged with [`MemoryAccount::charge`].
+    pub fn release(&self, bytes: usize) {
+        self.bytes.fetch_sub(bytes, Ordering::Relaxed);
+        self.accounting.total.sub(bytes);
+        self.accounting.pools[self.pool.index()].sub(bytes);
+    }
+
+    /// Returns true if the budget or the pool's share of it is exceeded.
+    pub fn exceeded(&self) -> bool {
+        self.accounting.total.exceeded() || self.accounting.pools[self.pool.index()].exceeded()
+    }
+
+    /// Counts a message dropped because the budget was exceeded.
+    pub fn dropped(&self) {
+        self.accounting.dropped[self.pool.index()].fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+impl Drop for MemoryAccount {
+    fn drop(&mut self) {
+        let bytes = *self.bytes.get_mut();
+        self.accounting.total.sub(bytes);
+        self.accounting.pools[self.pool.index()].sub(bytes);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn pool_usage(accounting: &MemoryAccounting, pool: MemoryPool) -> MemoryPoolUsage {
+        accounting.usage().pools[pool.index()]
+    }
+
+    #[test]
+    fn test_charge_and_release() {
+        let accounting = Arc::new(MemoryAccounting::default());
+        let ws = MemoryAccount::new(accounting.clone(), MemoryPool::WebSocket);
+        let mcap = MemoryAccount::new(accounting.clone(), MemoryPool::Mcap);
+        ws.charge(10);
+        mcap.charge(5);
+        ws.release(4);
+        let usage = accounting.usage();
+        assert_eq!(usage.bytes, 11);
+        assert_eq!(usage.peak_bytes, 15);
+        assert_eq!(usage.limit, None);
+        assert_eq!(pool_usage(&accounting, MemoryPool::WebSocket).bytes, 6);
+        assert_eq!(pool_usage(&accounting, MemoryPool::Mcap).bytes, 5);
+        assert!(!ws.exceeded());
+
+        // Dropping an account releases what it still holds.
+        drop(ws);
+        assert_eq!(accounting.usage().bytes, 5);
+        assert_eq!(pool_usage(&accounting, MemoryPool::WebSocket).bytes, 0);
+    }
+
+    #[test]
+    fn test_budget_and_shares() {
+        let accounting = Arc::new(MemoryAccounting::default());
+        accounting.set_budget(Some(
+            MemoryBudget::new(100).share(MemoryPool::WebSocket, 0.25),
+        ));
+        let ws = MemoryAccount::new(accounting.clone(), MemoryPool::WebSocket);
+        let mcap = MemoryAccount::new(accounting.clone(), MemoryPool::Mcap);
+        assert_eq!(
+            pool_usage(&accounting, MemoryPool::WebSocket).limit,
+            Some(25)
+        );
+        assert_eq!(pool_usage(&accounting, MemoryPool::Mcap).limit, Some(100));
+
+        // The WebSocket pool exceeds its share, without exceeding the budget.
+        ws.charge(30);
+        assert!(ws.exceeded());
+        assert!(!mcap.exceeded());
+
+        // Every pool is over once the budget is exceeded.
+        mcap.charge(80);
+        assert!(mcap.exceeded());
+        ws.release(30);
+        assert!(!ws.exceeded());
+        assert!(!mcap.exceeded());
+
+        ws.dropped();
+        assert_eq!(pool_usage(&accounting, MemoryPool::WebSocket).dropped, 1);
+
+        accounting.set_budget(None);
+        assert_eq!(accounting.usage().limit, None);
+        assert_eq!(pool_usage(&accounting, MemoryPool::WebSocket).limit, None);
+    }
+}
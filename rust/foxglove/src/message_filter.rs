@@ -0,0 +1,156 @@
+use std::collections::HashMap;
+use std::time::Duration;
+
+use bytes::Bytes;
+use parking_lot::Mutex;
+
+use crate::{ChannelDescriptor, ChannelId, Metadata};
+
+/// What a [`MessageFilter`] does with a message.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum FilterAction {
+    /// Log the message unchanged.
+    Keep,
+    /// Don't log the message.
+    Drop,
+    /// Log this message instead, for example a cropped or downsampled copy of the original.
+    Replace(Bytes),
+}
+
+/// A stage which runs on each message logged to a sink, before the sink receives it.
+///
+/// A filter can drop messages, for example to reduce the rate of a channel, or replace them with
+/// a transformed message, for example a cropped image. Filters are set per sink, with
+/// [`McapWriter::message_filter`][crate::McapWriter::message_filter] and
+/// [`WebSocketServer::message_filter`][crate::WebSocketServer::message_filter], so that sinks in
+/// the same context can log the same channels with different policies.
+///
+/// When several sinks share a filter, as all clients of a WebSocket server do, the filter runs
+/// once for each logged message, and its result is shared between the sinks. Filters may
+/// therefore keep state across messages, as [`RateLimitFilter`] does.
+///
+/// Filters run on the thread which logs the message, and must not block.
+pub trait MessageFilter: Send + Sync {
+    /// Returns what to do with a message logged on the channel.
+    fn filter(&self, channel: &ChannelDescriptor, msg: &[u8], metadata: &Metadata) -> FilterAction;
+}
+
+pub(crate) struct MessageFilterFn<F>(pub F)
+where
+    F: Fn(&ChannelDescriptor, &[u8], &Metadata) -> FilterAction + Send + Sync;
+
+impl<F> MessageFilter for MessageFilterFn<F>
+where
+    F: Fn(&ChannelDescriptor, &[u8], &Metadata) -> FilterAction + Send + Sync,
+{
+    fn filter(&self, channel: &ChannelDescriptor, msg: &[u8], metadata: &Metadata) -> FilterAction {
+        self.0(channel, msg, metadata)
+    }
+}
+
+/// A [`MessageFilter`] which limits the rate of messages on each channel.
+///
+/// A message is kept if its log time is at least the interval after the last message kept on the
+/// same channel, and dropped otherwise. If the log time goes backwards, as when a recording is
+/// replayed from the start, the message is kept.
+///
+/// ```
+/// use std::sync::Arc;
+///
+/// use foxglove::{RateLimitFilter, WebSocketServer};
+///
+/// // Send clients at most five messages per second on each channel.
+/// let server = WebSocketServer::new().message_filter(Arc::new(RateLimitFilter::with_rate(5.0)));
+/// ```
+#[derive(Debug)]
+pub struct RateLimitFilter {
+    interval: u64,
+    last_kept: Mutex<HashMap<ChannelId, u64>>,
+}
+
+impl RateLimitFilter {
+    /// Creates a filter which keeps at most one message per channel in each interval.
+    pub fn new(interval: Duration) -> Self {
+        Self {
+            interval: u64::try_from(interval.as_nanos()).unwrap_or(u64::MAX),
+            last_kept: Mutex::default(),
+        }
+    }
+
+    /// Creates a filter which keeps at most `hz` messages per second on each channel.
+    ///
+    /// A rate which is not positive keeps every message.
+    pub fn with_rate(hz: f64) -> Self {
+        let interval = if hz > 0.0 {
+            Duration::try_from_secs_f64(1.0 / hz).unwrap_or(Duration::MAX)
+        } else {
+            Duration::ZERO
+        };
+        Self::new(interval)
+    }
+}
+
+impl MessageFilter for RateLimitFilter {
+    fn filter(
+        &self,
+        channel: &ChannelDescriptor,
+        _msg: &[u8],
+        metadata: &Metadata,
+    ) -> FilterAction {
+        let mut last_kept = self.last_kept.lock();
+        match last_kept.get_mut(&channel.id()) {
+            Some(last)
+                if metadata.log_time >= *last && metadata.log_time - *last < self.interval =>
+            {
+                FilterAction::Drop
+            }
+            Some(last) => {
+                *last = metadata.log_time;
+                FilterAction::Keep
+            }
+            None => {
+                last_kept.insert(channel.id(), metadata.log_time);
+                FilterAction::Keep
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{ChannelBuilder, Context, RawChannel};
+
+    #[test]
+    fn test_rate_limit_filter() {
+        let ctx = Context::new();
+        let a = ChannelBuilder::new("/a")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .unwrap();
+        let b = ChannelBuilder::new("/b")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .unwrap();
+        let filter = RateLimitFilter::with_rate(5.0);
+        let keep = |filter: &RateLimitFilter, channel: &RawChannel, log_time| {
+            filter.filter(channel.descriptor(), b"", &Metadata { log_time }) == FilterAction::Keep
+        };
+
+        assert!(keep(&filter, &a, 0));
+        assert!(!keep(&filter, &a, 100_000_000));
+        // Channels are limited independently.
+        assert!(keep(&filter, &b, 100_000_000));
+        assert!(keep(&filter, &a, 200_000_000));
+        assert!(!keep(&filter, &a, 399_999_999));
+        // Time going backwards restarts the interval.
+        assert!(keep(&filter, &a, 10));
+        assert!(!keep(&filter, &a, 20));
+
+        let unlimited = RateLimitFilter::with_rate(0.0);
+        assert!(keep(&unlimited, &a, 0));
+        assert!(keep(&unlimited, &a, 0));
+    }
+}
@@ -134,6 +134,12 @@ pub enum Capability {
     /// controls in the Foxglove app. This requires the server to specify the `data_start_time`
     /// and `data_end_time` fields in its `ServerInfo` message.
     PlaybackControl,
+    /// Clients may send an `enableMessageBatches` message, after which the server may send
+    /// binary message batches, each carrying several messages.
+    MessageBatches,
+    /// Clients may send `subscribeFields` messages, to receive only the given fields of each
+    /// message.
+    FieldProjection,
 }
 
 #[cfg(test)]
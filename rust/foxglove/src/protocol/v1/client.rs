@@ -5,7 +5,9 @@ use serde::Deserialize;
 
 use crate::protocol::{BinaryPayload, ParseError};
 
+mod enable_message_batches;
 pub mod subscribe;
+pub mod subscribe_fields;
 mod unsubscribe;
 
 pub use crate::protocol::common::client::advertise;
@@ -16,7 +18,9 @@ pub use crate::protocol::common::client::{
 };
 #[doc(hidden)]
 pub use crate::protocol::common::client::{PlaybackCommand, PlaybackControlRequest};
+pub use enable_message_batches::EnableMessageBatches;
 pub use subscribe::{Subscribe, Subscription};
+pub use subscribe_fields::{FieldSubscription, SubscribeFields};
 pub use unsubscribe::Unsubscribe;
 
 /// Binary opcodes for v1 client messages.
@@ -146,6 +150,8 @@ pub enum ClientMessage<'a> {
     FetchAsset(FetchAsset),
     #[doc(hidden)]
     PlaybackControlRequest(PlaybackControlRequest),
+    EnableMessageBatches,
+    SubscribeFields(SubscribeFields),
 }
 
 impl<'a> ClientMessage<'a> {
@@ -201,6 +207,8 @@ impl<'a> ClientMessage<'a> {
             ClientMessage::UnsubscribeConnectionGraph => ClientMessage::UnsubscribeConnectionGraph,
             ClientMessage::FetchAsset(m) => ClientMessage::FetchAsset(m),
             ClientMessage::PlaybackControlRequest(m) => ClientMessage::PlaybackControlRequest(m),
+            ClientMessage::EnableMessageBatches => ClientMessage::EnableMessageBatches,
+            ClientMessage::SubscribeFields(m) => ClientMessage::SubscribeFields(m),
         }
     }
 }
@@ -220,6 +228,8 @@ enum JsonMessage<'a> {
     SubscribeConnectionGraph,
     UnsubscribeConnectionGraph,
     FetchAsset(FetchAsset),
+    EnableMessageBatches,
+    SubscribeFields(SubscribeFields),
 }
 
 impl<'a> From<JsonMessage<'a>> for ClientMessage<'a> {
@@ -236,6 +246,8 @@ impl<'a> From<JsonMessage<'a>> for ClientMessage<'a> {
             JsonMessage::SubscribeConnectionGraph => Self::SubscribeConnectionGraph,
             JsonMessage::UnsubscribeConnectionGraph => Self::UnsubscribeConnectionGraph,
             JsonMessage::FetchAsset(m) => Self::FetchAsset(m),
+            JsonMessage::EnableMessageBatches => Self::EnableMessageBatches,
+            JsonMessage::SubscribeFields(m) => Self::SubscribeFields(m),
         }
     }
 }
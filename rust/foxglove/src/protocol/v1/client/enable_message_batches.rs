@@ -0,0 +1,35 @@
+use serde::{Deserialize, Serialize};
+
+use crate::protocol::JsonMessage;
+
+/// Enable message batches message.
+///
+/// Sent by clients which can decode [`MessageBatch`][crate::protocol::v1::server::MessageBatch]
+/// messages, when the server advertises the `messageBatches` capability.
+#[derive(Debug, Default, Clone, PartialEq, Eq, Serialize, Deserialize)]
+#[serde(tag = "op", rename = "enableMessageBatches", rename_all = "camelCase")]
+pub struct EnableMessageBatches {}
+
+impl JsonMessage for EnableMessageBatches {}
+
+#[cfg(test)]
+mod tests {
+    use crate::protocol::v1::client::ClientMessage;
+
+    use super::*;
+
+    #[test]
+    fn test_encode() {
+        assert_eq!(
+            EnableMessageBatches {}.to_string(),
+            r#"{"op":"enableMessageBatches"}"#
+        );
+    }
+
+    #[test]
+    fn test_roundtrip() {
+        let buf = EnableMessageBatches {}.to_string();
+        let parsed = ClientMessage::parse_json(&buf).unwrap();
+        assert_eq!(parsed, ClientMessage::EnableMessageBatches);
+    }
+}
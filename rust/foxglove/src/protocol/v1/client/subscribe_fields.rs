@@ -0,0 +1,82 @@
+//! Subscribe fields message types.
+
+use serde::{Deserialize, Serialize};
+
+use crate::protocol::JsonMessage;
+
+/// Subscribe fields message.
+///
+/// Subscribes to channels like [`Subscribe`][super::Subscribe], but receives only the given fields
+/// of each message. Sent by clients when the server advertises the `fieldProjection` capability.
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+#[serde(tag = "op", rename = "subscribeFields", rename_all = "camelCase")]
+pub struct SubscribeFields {
+    /// Subscriptions.
+    pub subscriptions: Vec<FieldSubscription>,
+}
+
+impl SubscribeFields {
+    /// Creates a new subscribe fields message.
+    pub fn new(subscriptions: impl IntoIterator<Item = FieldSubscription>) -> Self {
+        Self {
+            subscriptions: subscriptions.into_iter().collect(),
+        }
+    }
+}
+
+impl JsonMessage for SubscribeFields {}
+
+/// A subscription for a [`SubscribeFields`] message.
+#[derive(Debug, Clone, PartialEq, Eq, Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+pub struct FieldSubscription {
+    /// Subscription ID.
+    pub id: u32,
+    /// Channel ID.
+    pub channel_id: u64,
+    /// Fields to project the channel's messages onto, as dot-separated paths such as
+    /// `pose.position`.
+    pub fields: Vec<String>,
+}
+
+impl FieldSubscription {
+    /// Creates a new subscription with the specified subscription ID, channel ID, and fields.
+    pub fn new(
+        id: u32,
+        channel_id: u64,
+        fields: impl IntoIterator<Item = impl Into<String>>,
+    ) -> Self {
+        Self {
+            id,
+            channel_id,
+            fields: fields.into_iter().map(Into::into).collect(),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::protocol::v1::client::ClientMessage;
+
+    use super::*;
+
+    fn message() -> SubscribeFields {
+        SubscribeFields::new([FieldSubscription::new(1, 10, ["pose.position", "frame_id"])])
+    }
+
+    #[test]
+    fn test_encode() {
+        assert_eq!(
+            message().to_string(),
+            r#"{"op":"subscribeFields","subscriptions":[{"id":1,"channelId":10,"fields":["pose.position","frame_id"]}]}"#
+        );
+    }
+
+    #[test]
+    fn test_roundtrip() {
+        let orig = message();
+        let buf = orig.to_string();
+        let msg = ClientMessage::parse_json(&buf).unwrap();
+        assert_eq!(msg, ClientMessage::SubscribeFields(orig));
+    }
+}
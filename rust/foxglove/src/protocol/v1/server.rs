@@ -5,6 +5,7 @@ use serde::Deserialize;
 
 use crate::protocol::{BinaryMessage, BinaryPayload, ParseError};
 
+mod message_batch;
 mod message_data;
 
 // Re-export common messages for consumers using v1
@@ -24,6 +25,7 @@ pub use crate::protocol::common::server::{
     ParameterValues, RemoveStatus, ServerInfo, ServiceCallFailure, ServiceCallResponse, Status,
     Time, Unadvertise, UnadvertiseServices,
 };
+pub use message_batch::MessageBatch;
 pub use message_data::MessageData;
 
 /// Binary opcodes for v1 server messages.
@@ -35,6 +37,7 @@ pub(crate) enum BinaryOpcode {
     FetchAssetResponse = 4,
     #[doc(hidden)]
     PlaybackState = 5,
+    MessageBatch = 6,
 }
 
 impl BinaryOpcode {
@@ -45,6 +48,7 @@ impl BinaryOpcode {
             3 => Some(Self::ServiceCallResponse),
             4 => Some(Self::FetchAssetResponse),
             5 => Some(Self::PlaybackState),
+            6 => Some(Self::MessageBatch),
             _ => None,
         }
     }
@@ -54,6 +58,10 @@ impl<'a> BinaryMessage<'a> for MessageData<'a> {
     const OPCODE: u8 = BinaryOpcode::MessageData as u8;
 }
 
+impl<'a> BinaryMessage<'a> for MessageBatch<'a> {
+    const OPCODE: u8 = BinaryOpcode::MessageBatch as u8;
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -173,6 +181,7 @@ pub enum ServerMessage<'a> {
     Advertise(Advertise<'a>),
     Unadvertise(Unadvertise),
     MessageData(MessageData<'a>),
+    MessageBatch(MessageBatch<'a>),
     Time(Time),
     ParameterValues(ParameterValues),
     AdvertiseServices(AdvertiseServices<'a>),
@@ -201,6 +210,9 @@ impl<'a> ServerMessage<'a> {
                 Some(BinaryOpcode::MessageData) => {
                     MessageData::parse_payload(data).map(ServerMessage::MessageData)
                 }
+                Some(BinaryOpcode::MessageBatch) => {
+                    MessageBatch::parse_payload(data).map(ServerMessage::MessageBatch)
+                }
                 Some(BinaryOpcode::Time) => Time::parse_payload(data).map(ServerMessage::Time),
                 Some(BinaryOpcode::ServiceCallResponse) => {
                     ServiceCallResponse::parse_payload(data).map(ServerMessage::ServiceCallResponse)
@@ -226,6 +238,7 @@ impl<'a> ServerMessage<'a> {
             ServerMessage::Advertise(m) => ServerMessage::Advertise(m.into_owned()),
             ServerMessage::Unadvertise(m) => ServerMessage::Unadvertise(m),
             ServerMessage::MessageData(m) => ServerMessage::MessageData(m.into_owned()),
+            ServerMessage::MessageBatch(m) => ServerMessage::MessageBatch(m.into_owned()),
             ServerMessage::Time(m) => ServerMessage::Time(m),
             ServerMessage::ParameterValues(m) => ServerMessage::ParameterValues(m),
             ServerMessage::AdvertiseServices(m) => ServerMessage::AdvertiseServices(m.into_owned()),
@@ -0,0 +1,133 @@
+use std::borrow::Cow;
+
+use bytes::{Buf, BufMut};
+
+use crate::protocol::{BinaryPayload, ParseError};
+
+use super::MessageData;
+
+/// Message batch message.
+///
+/// Carries several [`MessageData`] messages in one frame. It is only sent to clients which enabled
+/// message batches, when the server advertises the `messageBatches` capability.
+///
+/// Each message is encoded as its subscription ID (u32), its log time (u64), the length of its
+/// data (u32), and its data, all little-endian.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct MessageBatch<'a> {
+    /// The messages, in the order they were sent.
+    pub messages: Vec<MessageData<'a>>,
+}
+
+impl<'a> MessageBatch<'a> {
+    /// The size of the header of each message in a batch.
+    pub(crate) const ENTRY_HEADER_SIZE: usize = 4 + 8 + 4;
+
+    /// Creates a new message batch message.
+    pub fn new(messages: impl IntoIterator<Item = MessageData<'a>>) -> Self {
+        Self {
+            messages: messages.into_iter().collect(),
+        }
+    }
+
+    /// Returns an owned version of this message.
+    pub fn into_owned(self) -> MessageBatch<'static> {
+        MessageBatch {
+            messages: self
+                .messages
+                .into_iter()
+                .map(MessageData::into_owned)
+                .collect(),
+        }
+    }
+}
+
+impl<'a> BinaryPayload<'a> for MessageBatch<'a> {
+    fn parse_payload(mut data: &'a [u8]) -> Result<Self, ParseError> {
+        let mut messages = Vec::new();
+        while !data.is_empty() {
+            if data.len() < Self::ENTRY_HEADER_SIZE {
+                return Err(ParseError::BufferTooShort);
+            }
+            let subscription_id = data.get_u32_le();
+            let log_time = data.get_u64_le();
+            let len = data.get_u32_le() as usize;
+            if data.len() < len {
+                return Err(ParseError::BufferTooShort);
+            }
+            let (payload, rest) = data.split_at(len);
+            messages.push(MessageData {
+                subscription_id,
+                log_time,
+                data: Cow::Borrowed(payload),
+            });
+            data = rest;
+        }
+        Ok(Self { messages })
+    }
+
+    fn payload_size(&self) -> usize {
+        self.messages
+            .iter()
+            .map(|m| Self::ENTRY_HEADER_SIZE + m.data.len())
+            .sum()
+    }
+
+    fn write_payload(&self, buf: &mut impl BufMut) {
+        for message in &self.messages {
+            buf.put_u32_le(message.subscription_id);
+            buf.put_u64_le(message.log_time);
+            buf.put_u32_le(u32::try_from(message.data.len()).expect("message too large"));
+            buf.put_slice(&message.data);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use assert_matches::assert_matches;
+
+    use crate::protocol::v1::{BinaryMessage, server::ServerMessage};
+
+    use super::*;
+
+    fn message() -> MessageBatch<'static> {
+        MessageBatch::new([
+            MessageData::new(30, 1234, br#"{"key": "value"}"#),
+            MessageData::new(31, 1235, b""),
+        ])
+    }
+
+    #[test]
+    fn test_encode() {
+        let buf = message().to_bytes();
+        assert_eq!(buf.len(), 1 + 2 * MessageBatch::ENTRY_HEADER_SIZE + 16);
+        assert_eq!(buf[0], 6);
+        // The first message's header, then its data.
+        assert_eq!(&buf[1..5], &30u32.to_le_bytes());
+        assert_eq!(&buf[5..13], &1234u64.to_le_bytes());
+        assert_eq!(&buf[13..17], &16u32.to_le_bytes());
+        assert_eq!(&buf[17..33], br#"{"key": "value"}"#);
+    }
+
+    #[test]
+    fn test_roundtrip() {
+        let orig = message();
+        let buf = orig.to_bytes();
+        let msg = ServerMessage::parse_binary(&buf).unwrap();
+        assert_eq!(msg, ServerMessage::MessageBatch(orig));
+    }
+
+    #[test]
+    fn test_parse_truncated() {
+        let buf = message().to_bytes();
+        assert_matches!(
+            ServerMessage::parse_binary(&buf[..buf.len() - 1]),
+            Err(ParseError::BufferTooShort)
+        );
+        assert_matches!(
+            ServerMessage::parse_binary(&buf[..10]),
+            Err(ParseError::BufferTooShort)
+        );
+    }
+}
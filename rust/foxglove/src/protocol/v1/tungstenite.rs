@@ -34,6 +34,12 @@ impl From<&client::Advertise<'_>> for Message {
     }
 }
 
+impl From<&client::EnableMessageBatches> for Message {
+    fn from(value: &client::EnableMessageBatches) -> Self {
+        Message::Text(value.to_string().into())
+    }
+}
+
 impl From<&client::FetchAsset> for Message {
     fn from(value: &client::FetchAsset) -> Self {
         Message::Text(value.to_string().into())
@@ -136,6 +142,12 @@ impl From<&server::FetchAssetResponse<'_>> for Message {
     }
 }
 
+impl From<&server::MessageBatch<'_>> for Message {
+    fn from(value: &server::MessageBatch<'_>) -> Self {
+        Message::Binary(value.to_bytes().into())
+    }
+}
+
 impl From<&server::MessageData<'_>> for Message {
     fn from(value: &server::MessageData<'_>) -> Self {
         Message::Binary(value.to_bytes().into())
@@ -12,12 +12,19 @@
 //! advertised without a video track and its messages are delivered on the data plane unchanged.
 //! This is needed for image channels whose pixels must not pass through lossy video — compressed
 //! depth maps are the motivating case. See [`SuppressVideoTranscode`] for details.
+//!
+//! Channels which already carry encoded video (`foxglove.CompressedVideo`) are not transcoded:
+//! their frames are forwarded on the data plane unchanged. To let viewers start decoding promptly,
+//! the gateway asks the producer for a keyframe through [`Gateway::keyframe_request_handler`] /
+//! [`Gateway::keyframe_request_fn`]. See [`KeyframeRequestHandler`] for details.
 
 mod capability;
 mod channel_registry;
 mod client;
 mod connection;
+mod device_cache;
 mod gateway;
+mod keyframe_request;
 mod listener;
 mod parameter_subscriptions;
 mod participant;
@@ -32,16 +39,19 @@ mod watch;
 mod watch_loop;
 
 pub use crate::remote_common::{
-    AnyClient, AssetHandler, AssetResponder, ClientId, ConnectionGraph, GetParametersResponder,
-    Parameter, ParameterDecodeError, ParameterHandler, ParameterType, ParameterValue,
-    SetParametersResponder, Status, StatusLevel,
+    AnyClient, AssetHandler, AssetResponder, AssetWriter, ClientId, ConnectionGraph,
+    ConnectionGraphPatch, FileAssetHandler, GetParametersResponder, Parameter,
+    ParameterDecodeError, ParameterHandler, ParameterType, ParameterValue, SetParametersResponder,
+    Status, StatusLevel,
 };
 pub use capability::Capability;
 pub use client::Client;
 pub use connection::ConnectionStatus;
-pub use gateway::{Gateway, GatewayHandle, VideoEncoderBackend};
+pub use gateway::{Gateway, GatewayHandle, VideoEncoderBackend, VideoLimits};
+pub use keyframe_request::KeyframeRequestHandler;
 pub use listener::Listener;
-pub use qos::{QosClassifier, QosProfile, QosProfileBuilder, Reliability};
+pub use participant::MessageBacklogPolicy;
+pub use qos::{Priority, QosClassifier, QosProfile, QosProfileBuilder, Reliability};
 pub use suppress_video_transcode::SuppressVideoTranscode;
 
 use reqwest::StatusCode;
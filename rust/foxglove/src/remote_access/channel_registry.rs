@@ -513,6 +513,17 @@ impl ChannelRegistry {
         last_unsubscribed
     }
 
+    /// Returns the number of participants subscribed to a channel, and how many of them are
+    /// video subscribers.
+    pub fn subscriber_counts(&self, channel_id: &ChannelId) -> (usize, usize) {
+        let total = self.subscriptions.get(channel_id).map_or(0, |s| s.len());
+        let video = self
+            .video_subscribers
+            .get(channel_id)
+            .map_or(0, |s| s.len());
+        (total, video)
+    }
+
     /// Returns true if a channel has at least one subscriber that is not a video subscriber.
     pub fn has_data_subscribers(&self, channel_id: &ChannelId) -> bool {
         let total = self.subscriptions.get(channel_id).map_or(0, |s| s.len());
@@ -684,6 +695,27 @@ mod tests {
         assert_eq!(first.as_slice(), &[ChannelId::new(1)]);
     }
 
+    #[test]
+    fn video_track_is_shared_by_all_participants() {
+        let mut state = ChannelRegistry::new();
+        let sids = ["alice", "bob", "carol"].map(make_sid);
+        let channels = [ChannelId::new(1), ChannelId::new(2)];
+
+        // Only the first participant starts the channels' tracks; the others share them.
+        let first = state.subscribe_video(&sids[0], &channels);
+        assert_eq!(first.as_slice(), &channels);
+        for sid in &sids[1..] {
+            assert!(state.subscribe_video(sid, &channels).is_empty());
+        }
+
+        // The tracks stop once the last participant unsubscribes.
+        for sid in &sids[..2] {
+            assert!(state.unsubscribe_video(sid, &channels).is_empty());
+        }
+        let last = state.unsubscribe_video(&sids[2], &channels);
+        assert_eq!(last.as_slice(), &channels);
+    }
+
     #[test]
     fn last_video_unsubscriber_is_reported() {
         let mut state = ChannelRegistry::new();
@@ -1,10 +1,11 @@
 use std::{
     collections::HashMap,
+    path::PathBuf,
     sync::{
         Arc, OnceLock, Weak,
         atomic::{AtomicU8, Ordering},
     },
-    time::Duration,
+    time::{Duration, SystemTime},
 };
 
 use indexmap::IndexSet;
@@ -23,7 +24,10 @@ use crate::{
     library_version::get_library_identifier,
     protocol::v2::{parameter::Parameter, server::ServerInfo},
     remote_access::{
-        AssetHandler, Capability, RemoteAccessError,
+        AssetHandler, Capability, MessageBacklogPolicy, RemoteAccessError,
+        device_cache::DeviceInfoCache,
+        keyframe_request::KeyframeRequestHandler,
+        participant::BacklogOptions,
         protocol_version::{self, REMOTE_ACCESS_PROTOCOL_VERSION},
         qos::QosClassifier,
         session::{RemoteAccessSession, SessionParams},
@@ -35,7 +39,7 @@ use crate::{
         },
     },
     remote_common::{
-        connection_graph::ConnectionGraph,
+        connection_graph::{ConnectionGraph, ConnectionGraphPatch},
         parameters::ParameterHandler,
         service::{Service, ServiceId, ServiceMap},
     },
@@ -90,6 +94,7 @@ pub(super) struct ConnectionParams {
     pub(super) device_token: String,
     pub(super) foxglove_api_url: Option<String>,
     pub(super) foxglove_api_timeout: Option<Duration>,
+    pub(super) device_info_cache: Option<PathBuf>,
     pub(super) listener: Option<Arc<dyn super::Listener>>,
     pub(super) capabilities: Vec<Capability>,
     pub(super) supported_encodings: Option<IndexSet<String>>,
@@ -99,20 +104,33 @@ pub(super) struct ConnectionParams {
     pub(super) channel_filter: Option<Arc<dyn SinkChannelFilter>>,
     pub(super) qos_classifier: Option<Arc<dyn QosClassifier>>,
     pub(super) suppress_video_transcode: Option<Arc<dyn SuppressVideoTranscode>>,
+    pub(super) keyframe_request_handler: Option<Arc<dyn KeyframeRequestHandler>>,
     pub(super) server_info: Option<HashMap<String, String>>,
     pub(super) message_backlog_size: Option<usize>,
+    pub(super) message_backlog_bytes: Option<usize>,
+    pub(super) message_backlog_policy: MessageBacklogPolicy,
     pub(super) max_data_track_message_size: Option<usize>,
+    pub(super) max_fragmented_message_size: Option<usize>,
+    pub(super) pack_linger: Option<Duration>,
+    pub(super) video_limits: Option<super::VideoLimits>,
     pub(super) video_codec_override: Option<VideoCodec>,
     pub(super) video_encoder: super::gateway::VideoEncoderBackend,
+    pub(super) video_simulcast: bool,
     pub(super) context: Weak<Context>,
 }
 
-/// Pair of device metadata (fetched once via `fetch_device_info`) and the authenticated API
-/// client used for subsequent calls (watch stream, heartbeat). Initialized lazily on the first
-/// successful call to [`RemoteAccessConnection::get_or_init_device_context`].
+/// The authenticated API client used for all calls (device info, watch stream, heartbeat), and
+/// the device metadata. Initialized lazily on the first successful call to
+/// [`RemoteAccessConnection::get_or_init_device_context`].
+///
+/// The device metadata is only needed to name the gateway once a viewer wakes it, so it is
+/// fetched alongside the watch stream rather than before it.
 struct DeviceContext {
-    device: DeviceResponse,
     client: Arc<FoxgloveApiClient<DeviceToken>>,
+    /// Device metadata, fetched once via `fetch_device_info`.
+    device: OnceCell<DeviceResponse>,
+    /// Device metadata loaded from the on-disk cache, if any, used until `device` is fetched.
+    cached_device: Option<DeviceResponse>,
 }
 
 /// A `wake` from the watch stream paired with the `device_wait_for_viewer` advertised by the
@@ -130,6 +148,7 @@ pub(super) struct RemoteAccessConnection {
     device_token: String,
     foxglove_api_url: Option<String>,
     foxglove_api_timeout: Option<Duration>,
+    device_info_cache: Option<DeviceInfoCache>,
     listener: Option<Arc<dyn super::Listener>>,
     capabilities: Vec<Capability>,
     supported_encodings: Option<IndexSet<String>>,
@@ -139,11 +158,18 @@ pub(super) struct RemoteAccessConnection {
     channel_filter: Option<Arc<dyn SinkChannelFilter>>,
     qos_classifier: Option<Arc<dyn QosClassifier>>,
     suppress_video_transcode: Option<Arc<dyn SuppressVideoTranscode>>,
+    keyframe_request_handler: Option<Arc<dyn KeyframeRequestHandler>>,
     server_info: Option<HashMap<String, String>>,
     message_backlog_size: Option<usize>,
+    message_backlog_bytes: Option<usize>,
+    message_backlog_policy: MessageBacklogPolicy,
     max_data_track_message_size: Option<usize>,
+    max_fragmented_message_size: Option<usize>,
+    pack_linger: Option<Duration>,
+    video_limits: Option<super::VideoLimits>,
     video_codec_override: Option<VideoCodec>,
     video_encoder: super::gateway::VideoEncoderBackend,
+    video_simulcast: bool,
     context: Weak<Context>,
     cancellation_token: CancellationToken,
     services: Arc<parking_lot::RwLock<ServiceMap>>,
@@ -159,11 +185,19 @@ pub(super) struct RemoteAccessConnection {
 
 impl RemoteAccessConnection {
     pub fn new(params: ConnectionParams, services: Arc<parking_lot::RwLock<ServiceMap>>) -> Self {
+        let device_info_cache = params.device_info_cache.map(|path| {
+            DeviceInfoCache::new(
+                path,
+                params.foxglove_api_url.as_deref(),
+                &params.device_token,
+            )
+        });
         Self {
             name: params.name,
             device_token: params.device_token,
             foxglove_api_url: params.foxglove_api_url,
             foxglove_api_timeout: params.foxglove_api_timeout,
+            device_info_cache,
             listener: params.listener,
             capabilities: params.capabilities,
             supported_encodings: params.supported_encodings,
@@ -173,11 +207,18 @@ impl RemoteAccessConnection {
             channel_filter: params.channel_filter,
             qos_classifier: params.qos_classifier,
             suppress_video_transcode: params.suppress_video_transcode,
+            keyframe_request_handler: params.keyframe_request_handler,
             server_info: params.server_info,
             message_backlog_size: params.message_backlog_size,
+            message_backlog_bytes: params.message_backlog_bytes,
+            message_backlog_policy: params.message_backlog_policy,
             max_data_track_message_size: params.max_data_track_message_size,
+            max_fragmented_message_size: params.max_fragmented_message_size,
+            pack_linger: params.pack_linger,
+            video_limits: params.video_limits,
             video_codec_override: params.video_codec_override,
             video_encoder: params.video_encoder,
+            video_simulcast: params.video_simulcast,
             context: params.context,
             cancellation_token: CancellationToken::new(),
             services,
@@ -246,6 +287,27 @@ impl RemoteAccessConnection {
         Ok(())
     }
 
+    /// Applies a patch to the connection graph and sends updates to subscribed participants.
+    ///
+    /// Like [`Self::replace_connection_graph`], the graph is updated even if no session is
+    /// currently active.
+    pub fn update_connection_graph(
+        &self,
+        patch: ConnectionGraphPatch,
+    ) -> std::result::Result<(), FoxgloveError> {
+        if !self.has_capability(Capability::ConnectionGraph) {
+            return Err(FoxgloveError::ConnectionGraphNotSupported);
+        }
+        if let Some(session) = self.session.lock().clone() {
+            session.update_connection_graph(patch);
+        } else {
+            let mut graph = self.connection_graph.lock();
+            graph.apply(patch);
+            graph.take_update();
+        }
+        Ok(())
+    }
+
     /// Update the connection status, notifying the listener if it changed.
     fn set_status(&self, status: ConnectionStatus) {
         let prev = self.status.swap(status as u8, Ordering::Relaxed);
@@ -264,8 +326,9 @@ impl RemoteAccessConnection {
 
     /// Returns the device context, initializing it on first call.
     ///
-    /// This builds the authenticated API client and fetches device info. If the call fails,
-    /// the OnceCell remains empty and will retry on the next call.
+    /// This builds the authenticated API client and loads the cached device info, if any, without
+    /// calling the API. If building the client fails, the OnceCell remains empty and will retry on
+    /// the next call.
     async fn get_or_init_device_context(&self) -> Result<&DeviceContext> {
         self.device_context
             .get_or_try_init(|| async {
@@ -278,13 +341,42 @@ impl RemoteAccessConnection {
                     builder = builder.timeout(timeout);
                 }
                 let client = Arc::new(builder.build()?);
-                let device = client.fetch_device_info().await?;
-                info!(device_id = %device.id, device_name = %device.name, "device context initialized");
-                Ok::<_, Box<RemoteAccessError>>(DeviceContext { device, client })
+                let cached_device = self
+                    .device_info_cache
+                    .as_ref()
+                    .and_then(|cache| cache.load(SystemTime::now()));
+                if let Some(device) = &cached_device {
+                    info!(device_id = %device.id, device_name = %device.name, "using cached device info");
+                }
+                Ok::<_, Box<RemoteAccessError>>(DeviceContext {
+                    client,
+                    device: OnceCell::new(),
+                    cached_device,
+                })
             })
             .await
     }
 
+    /// Fetches the device info on first call, and stores it in the cache.
+    ///
+    /// If the fetch fails, it is retried on the next call.
+    async fn fetch_device_info(&self, device_context: &DeviceContext) {
+        let result = device_context
+            .device
+            .get_or_try_init(|| async {
+                let device = device_context.client.fetch_device_info().await?;
+                info!(device_id = %device.id, device_name = %device.name, "device info fetched");
+                if let Some(cache) = &self.device_info_cache {
+                    cache.store(&device, SystemTime::now());
+                }
+                Ok::<_, Box<RemoteAccessError>>(device)
+            })
+            .await;
+        if let Err(e) = result {
+            warn!(error = %e, "failed to fetch device info");
+        }
+    }
+
     /// Connects to LiveKit using the credentials delivered in a `wake` event. The
     /// `device_wait_for_viewer` is carried from the watch stream's `hello` event and applied
     /// as the session's idle timeout.
@@ -314,8 +406,16 @@ impl RemoteAccessConnection {
             url = wake.url.as_str(),
             "connecting to room"
         );
-        let (room, room_events) =
-            Room::connect(&wake.url, &wake.token, RoomOptions::default()).await?;
+        let connect_room = Room::connect(&wake.url, &wake.token, RoomOptions::default());
+        // The device name is only needed if no name was set. If it hasn't been fetched yet, retry
+        // while connecting to the room.
+        let device_context = self.device_context.get().filter(|ctx| {
+            self.name.is_none() && ctx.device.get().is_none() && ctx.cached_device.is_none()
+        });
+        let (room, room_events) = match device_context {
+            Some(ctx) => tokio::join!(connect_room, self.fetch_device_info(ctx)).0?,
+            None => connect_room.await?,
+        };
         info!(remote_access_session_id, "connected to room");
         let server_info = self.create_server_info(remote_access_session_id.unwrap_or(""));
         let session_params = SessionParams {
@@ -324,19 +424,28 @@ impl RemoteAccessConnection {
             channel_filter: self.channel_filter.clone(),
             qos_classifier: self.qos_classifier.clone(),
             suppress_video_transcode: self.suppress_video_transcode.clone(),
+            keyframe_request_handler: self.keyframe_request_handler.clone(),
             listener: self.listener.clone(),
             capabilities: self.capabilities.clone(),
             supported_encodings: self.supported_encodings.clone().unwrap_or_default(),
             runtime: self.runtime.clone(),
             cancellation_token: self.cancellation_token.child_token(),
-            message_backlog_size: self
-                .message_backlog_size
-                .unwrap_or(DEFAULT_MESSAGE_BACKLOG_SIZE),
+            message_backlog: BacklogOptions {
+                size: self
+                    .message_backlog_size
+                    .unwrap_or(DEFAULT_MESSAGE_BACKLOG_SIZE),
+                bytes: self.message_backlog_bytes,
+                policy: self.message_backlog_policy,
+            },
             max_data_track_message_size: self
                 .max_data_track_message_size
                 .unwrap_or(DEFAULT_MAX_DATA_TRACK_MESSAGE_SIZE),
+            max_fragmented_message_size: self.max_fragmented_message_size,
+            pack_linger: self.pack_linger,
+            video_limits: self.video_limits,
             video_codec_override: self.video_codec_override,
             video_encoder: self.video_encoder,
+            video_simulcast: self.video_simulcast,
             services: self.services.clone(),
             connection_graph: self.connection_graph.clone(),
             remote_access_session_id: remote_access_session_id.map(str::to_string),
@@ -402,6 +511,15 @@ impl RemoteAccessConnection {
 
     async fn watch_until_wake_inner(&self) -> Option<WakeSignal> {
         let device_context = self.device_context_until_ok().await?;
+        // Fetch the device info alongside the watch stream, rather than delaying it.
+        let (wake_signal, ()) = tokio::join!(
+            self.watch_until_wake_with(device_context),
+            self.fetch_device_info(device_context)
+        );
+        wake_signal
+    }
+
+    async fn watch_until_wake_with(&self, device_context: &DeviceContext) -> Option<WakeSignal> {
         let mut retry = WatchRetryState::new();
         loop {
             // Establish a watch.
@@ -589,6 +707,7 @@ impl RemoteAccessConnection {
             () = self.cancellation_token.cancelled() => (),
             _ = session.handle_room_events(room_events) => {},
             _ = session.log_periodic_stats() => {},
+            _ = session.adapt_video_to_bandwidth() => {},
         }
 
         // Normal session teardown returns to the watch loop, so keep reporting Connected: the
@@ -647,11 +766,13 @@ impl RemoteAccessConnection {
 
         // The device context is always initialized before this method is called: it must
         // succeed before any watch stream can open, which must succeed before we can receive
-        // a wake event and join LiveKit.
+        // a wake event and join LiveKit. The device info may still be missing if it could be
+        // neither fetched nor loaded from the cache.
         let name = self.name.clone().unwrap_or_else(|| {
             self.device_context
                 .get()
-                .map(|ctx| ctx.device.name.clone())
+                .and_then(|ctx| ctx.device.get().or(ctx.cached_device.as_ref()))
+                .map(|device| device.name.clone())
                 .unwrap_or_default()
         });
 
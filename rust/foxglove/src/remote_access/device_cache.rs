@@ -0,0 +1,144 @@
+//! On-disk cache of the device info fetched from the Foxglove platform.
+//!
+//! The gateway only needs the device info to name itself to viewers, so on startup it uses the
+//! cached info while it refreshes it in the background, rather than waiting on the API.
+
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::path::{Path, PathBuf};
+use std::time::{Duration, SystemTime};
+
+use serde::{Deserialize, Serialize};
+use tracing::{debug, warn};
+
+use crate::api_client::DeviceResponse;
+
+/// How long cached device info remains valid.
+const DEVICE_INFO_CACHE_TTL: Duration = Duration::from_secs(7 * 24 * 60 * 60);
+
+#[derive(Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+struct CacheEntry {
+    /// Fingerprint of the API URL and device token the info was fetched with.
+    fingerprint: u64,
+    /// When the info was fetched, in seconds since the Unix epoch.
+    fetched_at: u64,
+    device: DeviceResponse,
+}
+
+/// A cache of device info, stored in a JSON file.
+///
+/// Entries are keyed by the API URL and device token, so that changing either invalidates the
+/// cache. The token itself is not stored.
+pub(super) struct DeviceInfoCache {
+    path: PathBuf,
+    fingerprint: u64,
+}
+
+impl DeviceInfoCache {
+    pub fn new(path: PathBuf, api_url: Option<&str>, device_token: &str) -> Self {
+        let mut hasher = DefaultHasher::new();
+        api_url.hash(&mut hasher);
+        device_token.hash(&mut hasher);
+        Self {
+            path,
+            fingerprint: hasher.finish(),
+        }
+    }
+
+    /// Returns the cached device info, if it was fetched with the same credentials within
+    /// [`DEVICE_INFO_CACHE_TTL`] of `now`.
+    pub fn load(&self, now: SystemTime) -> Option<DeviceResponse> {
+        let bytes = match std::fs::read(&self.path) {
+            Ok(bytes) => bytes,
+            Err(e) => {
+                debug!(path = %self.path.display(), error = %e, "no cached device info");
+                return None;
+            }
+        };
+        let entry: CacheEntry = match serde_json::from_slice(&bytes) {
+            Ok(entry) => entry,
+            Err(e) => {
+                warn!(path = %self.path.display(), error = %e, "ignoring invalid device info cache");
+                return None;
+            }
+        };
+        let age = now
+            .duration_since(SystemTime::UNIX_EPOCH)
+            .ok()?
+            .saturating_sub(Duration::from_secs(entry.fetched_at));
+        (entry.fingerprint == self.fingerprint && age <= DEVICE_INFO_CACHE_TTL)
+            .then_some(entry.device)
+    }
+
+    /// Stores device info fetched at `now`.
+    ///
+    /// The file is replaced atomically, so that a crash while writing doesn't corrupt it.
+    pub fn store(&self, device: &DeviceResponse, now: SystemTime) {
+        let entry = CacheEntry {
+            fingerprint: self.fingerprint,
+            fetched_at: now
+                .duration_since(SystemTime::UNIX_EPOCH)
+                .map_or(0, |d| d.as_secs()),
+            device: device.clone(),
+        };
+        if let Err(e) = write_atomic(&self.path, &entry) {
+            warn!(path = %self.path.display(), error = %e, "failed to cache device info");
+        }
+    }
+}
+
+fn write_atomic(path: &Path, entry: &CacheEntry) -> std::io::Result<()> {
+    let mut tmp = path.as_os_str().to_owned();
+    tmp.push(".tmp");
+    std::fs::write(&tmp, serde_json::to_vec(entry)?)?;
+    std::fs::rename(&tmp, path)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn device(name: &str) -> DeviceResponse {
+        DeviceResponse {
+            id: "dev_1".to_string(),
+            name: name.to_string(),
+            project_id: "prj_1".to_string(),
+            retain_recordings_seconds: None,
+        }
+    }
+
+    #[test]
+    fn round_trips_until_expired() {
+        let dir = tempfile::tempdir().unwrap();
+        let cache = DeviceInfoCache::new(dir.path().join("device.json"), None, "token");
+        let now = SystemTime::now();
+        assert!(cache.load(now).is_none());
+
+        cache.store(&device("robot"), now);
+        let loaded = cache.load(now + Duration::from_secs(60)).unwrap();
+        assert_eq!(loaded.name, "robot");
+        assert!(cache.load(now + DEVICE_INFO_CACHE_TTL * 2).is_none());
+
+        cache.store(&device("renamed"), now);
+        assert_eq!(cache.load(now).unwrap().name, "renamed");
+    }
+
+    #[test]
+    fn ignores_entry_for_other_credentials() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("device.json");
+        let cache = |api_url, token| DeviceInfoCache::new(path.clone(), api_url, token);
+        let now = SystemTime::now();
+        cache(None, "token").store(&device("robot"), now);
+
+        assert!(cache(None, "other").load(now).is_none());
+        assert!(
+            cache(Some("https://example.com"), "token")
+                .load(now)
+                .is_none()
+        );
+
+        std::fs::write(&path, b"not json").unwrap();
+        assert!(cache(None, "token").load(now).is_none());
+    }
+}
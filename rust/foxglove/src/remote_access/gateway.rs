@@ -1,4 +1,6 @@
-use std::{collections::HashMap, fmt::Display, future::Future, sync::Arc, time::Duration};
+use std::{
+    collections::HashMap, fmt::Display, future::Future, path::PathBuf, sync::Arc, time::Duration,
+};
 
 use indexmap::IndexSet;
 use livekit::options::VideoCodec;
@@ -9,19 +11,20 @@ use crate::{
     ChannelDescriptor, Context, FoxgloveError, SinkChannelFilter, SinkId,
     protocol::v2::parameter::Parameter,
     remote_common::AnyClient,
-    remote_common::connection_graph::ConnectionGraph,
+    remote_common::connection_graph::{ConnectionGraph, ConnectionGraphPatch},
     remote_common::fetch_asset::{AssetHandler, AsyncAssetHandlerFn, BlockingAssetHandlerFn},
     remote_common::service::{Service, ServiceMap},
     runtime::get_runtime_handle,
     sink_channel_filter::SinkChannelFilterFn,
 };
 
+use super::keyframe_request::{KeyframeRequestHandler, KeyframeRequestHandlerFn};
 use super::qos::{QosClassifier, QosClassifierFn, QosProfile};
 use super::suppress_video_transcode::{SuppressVideoTranscode, SuppressVideoTranscodeFn};
 
 use super::connection::{ConnectionParams, ConnectionStatus, RemoteAccessConnection};
-use super::session::MIN_DATA_TRACK_MESSAGE_SIZE;
-use super::{Capability, Listener};
+use super::session::{DEFAULT_MAX_DATA_TRACK_MESSAGE_SIZE, MIN_DATA_TRACK_MESSAGE_SIZE};
+use super::{Capability, Listener, MessageBacklogPolicy};
 use crate::remote_common::parameters::ParameterHandler;
 
 /// A handle to the remote access gateway connection.
@@ -107,6 +110,20 @@ impl GatewayHandle {
         self.connection.replace_connection_graph(replacement_graph)
     }
 
+    /// Applies a [ConnectionGraphPatch] to the published connection graph, and sends the changes
+    /// to all subscribed clients.
+    ///
+    /// Requires the [`ConnectionGraph`](Capability::ConnectionGraph) capability.
+    ///
+    /// Unlike [`publish_connection_graph`](Self::publish_connection_graph), this does not require
+    /// the complete graph, and only the topics and services named in the patch are compared.
+    pub fn update_connection_graph(
+        &self,
+        patch: ConnectionGraphPatch,
+    ) -> Result<(), FoxgloveError> {
+        self.connection.update_connection_graph(patch)
+    }
+
     /// Gracefully disconnect from the remote access connection, if connected.
     ///
     /// Returns a JoinHandle that will allow waiting until the connection has been fully closed.
@@ -122,6 +139,7 @@ impl GatewayHandle {
             device_token: String::new(),
             foxglove_api_url: None,
             foxglove_api_timeout: None,
+            device_info_cache: None,
             listener: None,
             capabilities: Vec::new(),
             supported_encodings: None,
@@ -131,11 +149,18 @@ impl GatewayHandle {
             channel_filter: None,
             qos_classifier: None,
             suppress_video_transcode: None,
+            keyframe_request_handler: None,
             server_info: None,
             message_backlog_size: None,
+            message_backlog_bytes: None,
+            message_backlog_policy: MessageBacklogPolicy::Disconnect,
             max_data_track_message_size: None,
+            max_fragmented_message_size: None,
+            pack_linger: None,
+            video_limits: None,
             video_codec_override: None,
             video_encoder: VideoEncoderBackend::Auto,
+            video_simulcast: false,
             context: std::sync::Weak::new(),
         };
         let services = Arc::new(parking_lot::RwLock::new(ServiceMap::default()));
@@ -203,6 +228,38 @@ impl From<VideoEncoderBackend> for livekit::options::VideoEncoderBackend {
     }
 }
 
+/// Limits for the video tracks the gateway publishes, and for adapting them to the available
+/// bandwidth.
+///
+/// When these limits are set with [`Gateway::video_limits`], the gateway divides the bandwidth
+/// estimated by the WebRTC congestion controller between its video tracks. Each track keeps its
+/// full resolution and frame rate while its share allows, then steps down a resolution ladder
+/// (halving the width and height at each rung), and finally drops frames.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct VideoLimits {
+    /// Maximum bitrate of each video track, in bits per second. Defaults to 4 Mbps.
+    pub max_bitrate: u64,
+    /// Maximum frame rate of each video track. Frames arriving faster are dropped. Defaults to 30.
+    pub max_framerate: f64,
+    /// Lowest frame rate a track is reduced to when bandwidth is scarce. Defaults to 5.
+    pub min_framerate: f64,
+    /// Largest factor by which the width and height of frames are divided when bandwidth is
+    /// scarce. Rounded down to a power of two; 1 disables the resolution ladder. Defaults to 4, so
+    /// a 1280x720 source is sent at no less than 320x180.
+    pub max_downscale: u32,
+}
+
+impl Default for VideoLimits {
+    fn default() -> Self {
+        Self {
+            max_bitrate: 4_000_000,
+            max_framerate: 30.0,
+            min_framerate: 5.0,
+            max_downscale: 4,
+        }
+    }
+}
+
 /// Parses a codec name from the `FOXGLOVE_VIDEO_CODEC` environment variable.
 ///
 /// Accepts the livekit codec names, case-insensitively: "av1", "h264", "h265", "vp8", "vp9".
@@ -241,6 +298,7 @@ pub struct Gateway {
     device_token: Option<String>,
     foxglove_api_url: Option<String>,
     foxglove_api_timeout: Option<Duration>,
+    device_info_cache: Option<PathBuf>,
     listener: Option<Arc<dyn Listener>>,
     capabilities: Vec<Capability>,
     supported_encodings: Option<IndexSet<String>>,
@@ -251,10 +309,17 @@ pub struct Gateway {
     channel_filter: Option<Arc<dyn SinkChannelFilter>>,
     qos_classifier: Option<Arc<dyn QosClassifier>>,
     suppress_video_transcode: Option<Arc<dyn SuppressVideoTranscode>>,
+    keyframe_request_handler: Option<Arc<dyn KeyframeRequestHandler>>,
     server_info: Option<HashMap<String, String>>,
     message_backlog_size: Option<usize>,
+    message_backlog_bytes: Option<usize>,
+    message_backlog_policy: MessageBacklogPolicy,
     max_data_track_message_size: Option<usize>,
+    max_fragmented_message_size: Option<usize>,
+    pack_linger: Option<Duration>,
+    video_limits: Option<VideoLimits>,
     video_encoder: VideoEncoderBackend,
+    video_simulcast: bool,
     context: std::sync::Weak<Context>,
 }
 
@@ -265,6 +330,7 @@ impl Default for Gateway {
             device_token: None,
             foxglove_api_url: None,
             foxglove_api_timeout: None,
+            device_info_cache: None,
             listener: None,
             capabilities: Vec::new(),
             supported_encodings: None,
@@ -275,10 +341,17 @@ impl Default for Gateway {
             channel_filter: None,
             qos_classifier: None,
             suppress_video_transcode: None,
+            keyframe_request_handler: None,
             server_info: None,
             message_backlog_size: None,
+            message_backlog_bytes: None,
+            message_backlog_policy: MessageBacklogPolicy::default(),
             max_data_track_message_size: None,
+            max_fragmented_message_size: None,
+            pack_linger: None,
+            video_limits: None,
             video_encoder: VideoEncoderBackend::Auto,
+            video_simulcast: false,
             context: Arc::downgrade(&Context::get_default()),
         }
     }
@@ -291,6 +364,7 @@ impl std::fmt::Debug for Gateway {
             .field("has_device_token", &self.device_token.is_some())
             .field("foxglove_api_url", &self.foxglove_api_url)
             .field("foxglove_api_timeout", &self.foxglove_api_timeout)
+            .field("device_info_cache", &self.device_info_cache)
             .field("has_listener", &self.listener.is_some())
             .field("capabilities", &self.capabilities)
             .field("supported_encodings", &self.supported_encodings)
@@ -307,13 +381,26 @@ impl std::fmt::Debug for Gateway {
                 "has_suppress_video_transcode",
                 &self.suppress_video_transcode.is_some(),
             )
+            .field(
+                "has_keyframe_request_handler",
+                &self.keyframe_request_handler.is_some(),
+            )
             .field("server_info", &self.server_info)
             .field("message_backlog_size", &self.message_backlog_size)
+            .field("message_backlog_bytes", &self.message_backlog_bytes)
+            .field("message_backlog_policy", &self.message_backlog_policy)
             .field(
                 "max_data_track_message_size",
                 &self.max_data_track_message_size,
             )
+            .field(
+                "max_fragmented_message_size",
+                &self.max_fragmented_message_size,
+            )
+            .field("pack_linger", &self.pack_linger)
+            .field("video_limits", &self.video_limits)
             .field("video_encoder", &self.video_encoder)
+            .field("video_simulcast", &self.video_simulcast)
             .field("has_context", &(self.context.strong_count() > 0));
         dbg.finish()
     }
@@ -413,18 +500,62 @@ impl Gateway {
         self
     }
 
+    /// Sets a file in which to cache the device info fetched from the Foxglove platform.
+    ///
+    /// The gateway names itself after the device unless [`name`](Self::name) is set. With a
+    /// cache, a restarted gateway uses the cached device info while it refreshes it in the
+    /// background, so that it doesn't depend on the API call succeeding before a viewer can
+    /// connect. Cached info expires after 7 days, and is ignored if the device token or API URL
+    /// change. The device token itself is not stored.
+    ///
+    /// In any case, the device info is fetched alongside the watch stream which waits for
+    /// viewers, rather than before it.
+    pub fn device_info_cache(mut self, path: impl Into<PathBuf>) -> Self {
+        self.device_info_cache = Some(path.into());
+        self
+    }
+
     /// Set the per-participant control plane message queue size.
     ///
     /// Each participant gets an independent queue of this size. If a participant's
     /// queue fills up (because it is not reading fast enough), it will be disconnected
     /// and asked to reconnect.
     ///
-    /// By default, each participant gets a queue of 1024 messages.
+    /// By default, each participant gets a queue of 1024 messages. With a
+    /// [`message_backlog_policy`](Self::message_backlog_policy) that drops messages, this is also
+    /// the size of each participant's backlog of messages for reliable channels.
     pub fn message_backlog_size(mut self, size: usize) -> Self {
         self.message_backlog_size = Some(size);
         self
     }
 
+    /// Sets the maximum number of bytes in each participant's backlog of messages for reliable
+    /// channels.
+    ///
+    /// When the queued messages exceed this size, stale messages are dropped according to the
+    /// [`message_backlog_policy`](Self::message_backlog_policy). The most recent message is always
+    /// queued, even if it is larger than the limit. This has no effect with
+    /// [`MessageBacklogPolicy::Disconnect`].
+    ///
+    /// By default, the backlog is only limited by
+    /// [`message_backlog_size`](Self::message_backlog_size).
+    pub fn message_backlog_bytes(mut self, bytes: usize) -> Self {
+        self.message_backlog_bytes = Some(bytes);
+        self
+    }
+
+    /// Sets how a participant's backlog handles messages for reliable channels when it fills up.
+    ///
+    /// By default ([`MessageBacklogPolicy::Disconnect`]), these messages share the control plane
+    /// queue, and a participant whose queue fills up is disconnected and asked to reconnect. On
+    /// slow links, a policy that drops stale messages instead keeps the participant connected,
+    /// while bounding the memory used for its backlog. Control plane messages are never dropped,
+    /// and are sent ahead of queued channel messages.
+    pub fn message_backlog_policy(mut self, policy: MessageBacklogPolicy) -> Self {
+        self.message_backlog_policy = policy;
+        self
+    }
+
     /// Sets the maximum size in bytes of a single message published to a lossy
     /// channel's data track. Larger messages are dropped, with a throttled
     /// warning, rather than allowed to monopolize the shared data channel and
@@ -438,6 +569,51 @@ impl Gateway {
         self
     }
 
+    /// Sets the maximum size in bytes of a message published to a lossy channel's data track,
+    /// splitting messages larger than
+    /// [`max_data_track_message_size`](Self::max_data_track_message_size) into fragments.
+    ///
+    /// Each fragment is sent in its own frame of at most `max_data_track_message_size` bytes, so
+    /// that a large message doesn't monopolize the shared data channel. Fragments are not
+    /// retransmitted: a viewer discards a message if any of its fragments is lost. Messages
+    /// larger than this limit are still dropped.
+    ///
+    /// The message may be split into at most 65535 fragments. By default, messages are not
+    /// fragmented. Viewers must support fragmented data-track frames.
+    pub fn max_fragmented_message_size(mut self, size: usize) -> Self {
+        self.max_fragmented_message_size = Some(size);
+        self
+    }
+
+    /// Packs small messages published to a lossy channel's data track into shared frames.
+    ///
+    /// Messages of up to about 580 bytes are held for at most `linger` and sent together in a
+    /// frame that fits in one data-channel packet (1200 bytes), which is sent early when full.
+    /// This cuts the packet rate of channels which publish many small messages, such as logs or
+    /// joint states, at the cost of up to `linger` of added latency. A lost frame loses all of
+    /// its messages. A couple of milliseconds is usually enough.
+    ///
+    /// Each channel has its own data track, so messages are only packed with others from the
+    /// same channel. By default, messages are not packed. Viewers must support packed data-track
+    /// frames.
+    pub fn pack_small_messages(mut self, linger: Duration) -> Self {
+        self.pack_linger = Some(linger);
+        self
+    }
+
+    /// Sets limits for published video tracks, and adapts them to the available bandwidth.
+    ///
+    /// The bitrate and frame rate limits are passed to the video encoder. In addition, each
+    /// track's resolution and frame rate are reduced to fit its share of the bandwidth estimated
+    /// by the WebRTC congestion controller. See [`VideoLimits`] for details.
+    ///
+    /// By default, the encoder bitrate is left to libwebrtc, and frames are sent at the
+    /// resolution and rate they are logged at.
+    pub fn video_limits(mut self, limits: VideoLimits) -> Self {
+        self.video_limits = Some(limits);
+        self
+    }
+
     /// Sets the preferred backend for encoding published video tracks.
     ///
     /// This preference applies to every video track the gateway publishes. If the requested
@@ -451,6 +627,24 @@ impl Gateway {
         self
     }
 
+    /// Sets whether published video tracks are sent as simulcast layers.
+    ///
+    /// Each video channel is encoded once, when its first participant subscribes, and the SFU
+    /// forwards that one track to every subscribed participant, so the encoding work grows with
+    /// the number of channels rather than the number of participants. With simulcast, each track
+    /// is additionally encoded at half and a quarter of its resolution (for example 1080p, 540p
+    /// and 270p), and the SFU picks a layer for each participant according to its bandwidth and
+    /// viewport, without further work on this device.
+    ///
+    /// Simulcast is disabled by default. It roughly adds half again to the encoding cost of each
+    /// track, which only pays off when participants' links differ widely. Some hardware encoders,
+    /// such as NVENC, enforce the target bitrate aggressively, and splitting it across layers
+    /// results in visibly lower quality.
+    pub fn video_simulcast(mut self, enabled: bool) -> Self {
+        self.video_simulcast = enabled;
+        self
+    }
+
     /// Sets a channel filter. See [`SinkChannelFilter`] for more information.
     pub fn channel_filter_fn(
         mut self,
@@ -498,6 +692,23 @@ impl Gateway {
         self
     }
 
+    /// Sets a handler for keyframe requests on pre-encoded video channels.
+    ///
+    /// See [`KeyframeRequestHandler`] for more information.
+    pub fn keyframe_request_handler(mut self, handler: Arc<dyn KeyframeRequestHandler>) -> Self {
+        self.keyframe_request_handler = Some(handler);
+        self
+    }
+
+    /// Sets a keyframe request function. See [`KeyframeRequestHandler`] for more information.
+    pub fn keyframe_request_fn(
+        mut self,
+        handler: impl Fn(&ChannelDescriptor) + Sync + Send + 'static,
+    ) -> Self {
+        self.keyframe_request_handler = Some(Arc::new(KeyframeRequestHandlerFn(handler)));
+        self
+    }
+
     /// Configure the set of services to advertise to clients.
     ///
     /// Automatically adds [`Capability::Services`] to the set of advertised capabilities.
@@ -671,6 +882,28 @@ impl Gateway {
                  {MIN_DATA_TRACK_MESSAGE_SIZE} bytes (one data-channel packet)."
             )));
         }
+        if let Some(size) = self.max_fragmented_message_size {
+            let fragment_size = self
+                .max_data_track_message_size
+                .unwrap_or(DEFAULT_MAX_DATA_TRACK_MESSAGE_SIZE);
+            if size.div_ceil(fragment_size) > usize::from(u16::MAX) {
+                return Err(FoxgloveError::ConfigurationError(format!(
+                    "max_fragmented_message_size ({size} bytes) needs more than {} fragments of \
+                     max_data_track_message_size ({fragment_size} bytes).",
+                    u16::MAX
+                )));
+            }
+        }
+        if let Some(limits) = &self.video_limits
+            && (limits.max_bitrate == 0
+                || limits.max_downscale == 0
+                || !(limits.min_framerate > 0.0 && limits.min_framerate <= limits.max_framerate))
+        {
+            return Err(FoxgloveError::ConfigurationError(format!(
+                "Invalid video limits {limits:?}: the bitrate and downscale limits must be \
+                 positive, and min_framerate must be positive and at most max_framerate."
+            )));
+        }
         let runtime = self.runtime.unwrap_or_else(get_runtime_handle);
         let services = Arc::new(parking_lot::RwLock::new(ServiceMap::from_iter(
             self.services.into_values(),
@@ -680,6 +913,7 @@ impl Gateway {
             device_token,
             foxglove_api_url,
             foxglove_api_timeout,
+            device_info_cache: self.device_info_cache,
             listener: self.listener,
             capabilities: self.capabilities,
             supported_encodings: self.supported_encodings,
@@ -689,11 +923,18 @@ impl Gateway {
             channel_filter: self.channel_filter,
             qos_classifier: self.qos_classifier,
             suppress_video_transcode: self.suppress_video_transcode,
+            keyframe_request_handler: self.keyframe_request_handler,
             server_info: self.server_info,
             message_backlog_size: self.message_backlog_size,
+            message_backlog_bytes: self.message_backlog_bytes,
+            message_backlog_policy: self.message_backlog_policy,
             max_data_track_message_size: self.max_data_track_message_size,
+            max_fragmented_message_size: self.max_fragmented_message_size,
+            pack_linger: self.pack_linger,
+            video_limits: self.video_limits,
             video_codec_override,
             video_encoder,
+            video_simulcast: self.video_simulcast,
             context: self.context,
         };
         let connection = RemoteAccessConnection::new(params, services);
@@ -775,6 +1016,28 @@ mod tests {
         assert!(matches!(result, Err(FoxgloveError::ConfigurationError(_))));
     }
 
+    #[test]
+    fn max_fragmented_message_size_with_too_many_fragments_rejected() {
+        let result = Gateway::new()
+            .device_token("test-token")
+            .max_data_track_message_size(MIN_DATA_TRACK_MESSAGE_SIZE)
+            .max_fragmented_message_size(MIN_DATA_TRACK_MESSAGE_SIZE * (usize::from(u16::MAX) + 1))
+            .start();
+        assert!(matches!(result, Err(FoxgloveError::ConfigurationError(_))));
+    }
+
+    #[test]
+    fn invalid_video_limits_rejected() {
+        let result = Gateway::new()
+            .device_token("test-token")
+            .video_limits(VideoLimits {
+                min_framerate: 60.0,
+                ..VideoLimits::default()
+            })
+            .start();
+        assert!(matches!(result, Err(FoxgloveError::ConfigurationError(_))));
+    }
+
     #[test]
     fn test_parse_video_codec() {
         // All livekit codec names parse, case-insensitively.
@@ -0,0 +1,92 @@
+//! Keyframe requests for pre-encoded video channels.
+
+use crate::channel::ChannelDescriptor;
+
+/// Asks the producer of a pre-encoded video channel for a keyframe.
+///
+/// Channels carrying `foxglove.CompressedVideo` are delivered to remote participants unchanged:
+/// the gateway forwards the producer's H.264/H.265 (or other) bitstream without decoding or
+/// re-encoding it. A viewer can only start decoding such a stream at a keyframe, so the gateway
+/// invokes this callback when a viewer subscribes to a compressed video channel, and when it drops
+/// a frame of one (for example, because it exceeds the data track message size). The producer
+/// should respond by forcing its encoder to emit a keyframe, with parameter sets, as soon as
+/// possible. This plays the role of a WebRTC picture loss indication (PLI) for passthrough video.
+///
+/// Requests are throttled per channel. The callback is invoked from time-sensitive contexts and
+/// must not block. Channels whose producer cannot emit keyframes on demand may simply be ignored.
+///
+/// Configured via [`Gateway::keyframe_request_handler`] (this trait) or
+/// [`Gateway::keyframe_request_fn`] (a closure).
+///
+/// [`Gateway::keyframe_request_handler`]: crate::remote_access::Gateway::keyframe_request_handler
+/// [`Gateway::keyframe_request_fn`]: crate::remote_access::Gateway::keyframe_request_fn
+pub trait KeyframeRequestHandler: Sync + Send {
+    /// Requests a keyframe on the given channel.
+    fn request_keyframe(&self, channel: &ChannelDescriptor);
+}
+
+pub(super) struct KeyframeRequestHandlerFn<F>(pub(super) F)
+where
+    F: Fn(&ChannelDescriptor) + Sync + Send;
+
+impl<F> KeyframeRequestHandler for KeyframeRequestHandlerFn<F>
+where
+    F: Fn(&ChannelDescriptor) + Sync + Send,
+{
+    fn request_keyframe(&self, channel: &ChannelDescriptor) {
+        self.0(channel)
+    }
+}
+
+/// Returns true if the channel carries pre-encoded video frames.
+pub(super) fn is_compressed_video(channel: &ChannelDescriptor) -> bool {
+    let schema_name = channel.schema().map(|s| s.name.as_str()).unwrap_or("");
+    match channel.message_encoding() {
+        "protobuf" | "json" | "flatbuffer" => schema_name == "foxglove.CompressedVideo",
+        "cdr" => matches!(
+            schema_name,
+            "foxglove::CompressedVideo" | "foxglove_msgs/msg/CompressedVideo"
+        ),
+        "ros1" => schema_name == "foxglove_msgs/CompressedVideo",
+        _ => false,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::sync::Arc;
+
+    use super::*;
+    use crate::{ChannelBuilder, Context, RawChannel, Schema};
+
+    fn channel(encoding: &str, schema_name: &str) -> Arc<RawChannel> {
+        let ctx = Context::new();
+        ChannelBuilder::new("/camera")
+            .context(&ctx)
+            .message_encoding(encoding)
+            .schema(Schema::new(schema_name, encoding, &b""[..]))
+            .build_raw()
+            .unwrap()
+    }
+
+    #[test]
+    fn test_is_compressed_video() {
+        for (encoding, schema_name) in [
+            ("protobuf", "foxglove.CompressedVideo"),
+            ("json", "foxglove.CompressedVideo"),
+            ("cdr", "foxglove::CompressedVideo"),
+            ("cdr", "foxglove_msgs/msg/CompressedVideo"),
+            ("ros1", "foxglove_msgs/CompressedVideo"),
+        ] {
+            assert!(is_compressed_video(
+                channel(encoding, schema_name).descriptor()
+            ));
+        }
+        assert!(!is_compressed_video(
+            channel("protobuf", "foxglove.CompressedImage").descriptor()
+        ));
+        assert!(!is_compressed_video(
+            channel("cdr", "foxglove.CompressedVideo").descriptor()
+        ));
+    }
+}
@@ -12,15 +12,23 @@ use std::collections::{HashMap, HashSet};
 
 use livekit::id::ParticipantSid;
 
-/// Tracks parameter-name → set of subscribed participant SIDs.
+use crate::protocol::v2::parameter::Parameter;
+
+/// Tracks parameter-name → set of subscribed participant SIDs, and the inverse.
+///
+/// Publishing looks up only the subscribers of each published parameter, and removing a
+/// participant visits only the names it subscribed to, so neither grows with the product of
+/// parameters and participants.
 pub(super) struct ParameterSubscriptions {
     subscribers_by_name: HashMap<String, HashSet<ParticipantSid>>,
+    names_by_subscriber: HashMap<ParticipantSid, HashSet<String>>,
 }
 
 impl ParameterSubscriptions {
     pub(super) fn new() -> Self {
         Self {
             subscribers_by_name: HashMap::new(),
+            names_by_subscriber: HashMap::new(),
         }
     }
 
@@ -29,11 +37,16 @@ impl ParameterSubscriptions {
     /// Returns parameter names that are newly subscribed (i.e. had no prior subscribers).
     pub(super) fn subscribe(&mut self, sid: &ParticipantSid, names: Vec<String>) -> Vec<String> {
         let mut new_names = Vec::new();
+        let subscribed = self.names_by_subscriber.entry(sid.clone()).or_default();
         for name in names {
             let subscribers = self.subscribers_by_name.entry(name.clone()).or_default();
             if subscribers.insert(sid.clone()) && subscribers.len() == 1 {
-                new_names.push(name);
+                new_names.push(name.clone());
             }
+            subscribed.insert(name);
+        }
+        if subscribed.is_empty() {
+            self.names_by_subscriber.remove(sid);
         }
         new_names
     }
@@ -43,6 +56,14 @@ impl ParameterSubscriptions {
     /// Returns parameter names that lost their last subscriber.
     pub(super) fn unsubscribe(&mut self, sid: &ParticipantSid, names: Vec<String>) -> Vec<String> {
         let mut old_names = Vec::new();
+        if let Some(subscribed) = self.names_by_subscriber.get_mut(sid) {
+            for name in &names {
+                subscribed.remove(name);
+            }
+            if subscribed.is_empty() {
+                self.names_by_subscriber.remove(sid);
+            }
+        }
         for name in names {
             if let Some(subscribers) = self.subscribers_by_name.get_mut(&name) {
                 subscribers.remove(sid);
@@ -56,25 +77,50 @@ impl ParameterSubscriptions {
     }
 
     /// Returns the set of participant SIDs subscribed to a parameter.
+    #[cfg(test)]
     pub(super) fn subscribers(&self, name: &str) -> Option<&HashSet<ParticipantSid>> {
         self.subscribers_by_name.get(name)
     }
 
+    /// Groups published parameters by the participants subscribed to them, preserving their
+    /// order. Participants with no subscribed parameters are omitted.
+    pub(super) fn fan_out(
+        &self,
+        parameters: &[Parameter],
+    ) -> HashMap<ParticipantSid, Vec<Parameter>> {
+        let mut updates: HashMap<ParticipantSid, Vec<Parameter>> = HashMap::new();
+        for parameter in parameters {
+            let Some(subscribers) = self.subscribers_by_name.get(&parameter.name) else {
+                continue;
+            };
+            for sid in subscribers {
+                updates
+                    .entry(sid.clone())
+                    .or_default()
+                    .push(parameter.clone());
+            }
+        }
+        updates
+    }
+
     /// Sweep `sid` out of every parameter-subscription set.
     ///
     /// Returns parameter names that lost their last subscriber. No-op if `sid` was not
     /// subscribed to any parameter.
     pub(super) fn cleanup_for_removed_participant(&mut self, sid: &ParticipantSid) -> Vec<String> {
+        let Some(names) = self.names_by_subscriber.remove(sid) else {
+            return Vec::new();
+        };
         let mut last_unsubscribed = Vec::new();
-        self.subscribers_by_name.retain(|name, subscribers| {
-            subscribers.remove(sid);
-            if subscribers.is_empty() {
-                last_unsubscribed.push(name.clone());
-                false
-            } else {
-                true
+        for name in names {
+            if let Some(subscribers) = self.subscribers_by_name.get_mut(&name) {
+                subscribers.remove(sid);
+                if subscribers.is_empty() {
+                    self.subscribers_by_name.remove(&name);
+                    last_unsubscribed.push(name);
+                }
             }
-        });
+        }
         last_unsubscribed
     }
 }
@@ -195,4 +241,33 @@ mod tests {
         assert!(last.is_empty());
         assert_eq!(subs.subscribers("p1").unwrap().len(), 1);
     }
+
+    #[test]
+    fn fan_out_groups_parameters_by_subscriber() {
+        let mut subs = ParameterSubscriptions::new();
+        let sid_a = make_sid("alice");
+        let sid_b = make_sid("bob");
+
+        let _ = subs.subscribe(&sid_a, vec!["p1".into(), "p2".into()]);
+        let _ = subs.subscribe(&sid_b, vec!["p2".into()]);
+
+        let parameters: Vec<_> = ["p1", "p2", "p3"]
+            .into_iter()
+            .map(Parameter::empty)
+            .collect();
+        let updates = subs.fan_out(&parameters);
+        let names = |sid| -> Vec<&str> {
+            updates[sid]
+                .iter()
+                .map(|p: &Parameter| p.name.as_str())
+                .collect()
+        };
+        assert_eq!(updates.len(), 2);
+        assert_eq!(names(&sid_a), vec!["p1", "p2"]);
+        assert_eq!(names(&sid_b), vec!["p2"]);
+
+        let _ = subs.unsubscribe(&sid_a, vec!["p1".into(), "p2".into()]);
+        let updates = subs.fan_out(&parameters);
+        assert_eq!(updates.keys().collect::<Vec<_>>(), vec![&sid_b]);
+    }
 }
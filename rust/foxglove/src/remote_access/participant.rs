@@ -1,8 +1,11 @@
 //! Per-participant state for a remote access session.
 
+mod backlog;
 mod collection;
 mod registry;
 
+pub(super) use backlog::BacklogOptions;
+pub use backlog::MessageBacklogPolicy;
 pub(super) use registry::ParticipantRegistry;
 
 use std::collections::HashSet;
@@ -15,12 +18,17 @@ use livekit::{
 };
 use tokio_util::sync::CancellationToken;
 
+use crate::ChannelId;
+use crate::memory_budget::MemoryAccount;
 use crate::protocol::v2::server::FetchAssetResponse;
 use crate::remote_access::RemoteAccessError;
+use crate::remote_access::qos::QosProfile;
 use crate::remote_access::session::encode_binary_message;
 use crate::remote_common::ClientId;
 use crate::remote_common::semaphore::Semaphore;
 
+use backlog::DataBacklog;
+
 type Result<T> = std::result::Result<T, Box<RemoteAccessError>>;
 
 const DEFAULT_SERVICE_CALLS_PER_PARTICIPANT: usize = 32;
@@ -54,6 +62,10 @@ pub(super) struct Participant {
     /// Per-participant control plane queue. The receiving end is owned by the
     /// flush-task.
     control_tx: flume::Sender<Bytes>,
+    /// Per-participant backlog of messages for reliable channels, if the backlog policy drops
+    /// stale messages. Otherwise, these messages are queued on the control plane. The receiving
+    /// end is owned by the flush-task.
+    data_backlog: Option<Arc<DataBacklog>>,
     /// Shared set of `ParticipantSid`s pending a reset. Inserting into this
     /// set and notifying is how we signal `handle_room_events` to disconnect
     /// us. Keyed by `ParticipantSid` (unique per physical connection) rather
@@ -82,7 +94,9 @@ pub(super) struct Participant {
 impl Participant {
     /// Creates a new participant with its own control plane channel and flush-task.
     ///
-    /// The flush-task drains the bounded channel into the `writer`. It exits when
+    /// The flush-task drains the bounded channel into the `writer`, followed by the data backlog
+    /// if `backlog` calls for one. Control plane messages take priority over queued channel
+    /// messages. It exits when
     /// the per-participant cancellation token fires (queue overflow or session
     /// shutdown) or when all `control_tx` senders are dropped.
     ///
@@ -94,12 +108,15 @@ impl Participant {
         participant_sid: ParticipantSid,
         joined_at: i64,
         writer: ParticipantWriter,
-        queue_size: usize,
+        backlog: BacklogOptions,
+        memory: MemoryAccount,
         pending_resets: Arc<parking_lot::Mutex<HashSet<ParticipantSid>>>,
         reset_notify: Arc<tokio::sync::Notify>,
         session_cancel: &CancellationToken,
     ) -> (Arc<Self>, tokio::task::JoinHandle<()>) {
-        let (control_tx, control_rx) = flume::bounded::<Bytes>(queue_size);
+        let (control_tx, control_rx) = flume::bounded::<Bytes>(backlog.size);
+        let data_backlog = DataBacklog::new(backlog, memory).map(Arc::new);
+        let data_backlog_for_task = data_backlog.clone();
         let cancel = session_cancel.child_token();
         let cancel_for_task = cancel.clone();
         let client_id = ClientId::next();
@@ -117,6 +134,12 @@ impl Participant {
                         Ok(data) => data,
                         Err(_) => break,
                     },
+                    data = async {
+                        match &data_backlog_for_task {
+                            Some(backlog) => backlog.recv().await,
+                            None => std::future::pending().await,
+                        }
+                    } => data,
                 };
                 // Wrap the write in a cancel-aware select so we can break out
                 // if the participant is being torn down.
@@ -143,6 +166,7 @@ impl Participant {
             participant_sid,
             joined_at,
             control_tx,
+            data_backlog,
             pending_resets,
             reset_notify,
             cancel,
@@ -175,6 +199,7 @@ impl Participant {
             participant_sid,
             joined_at: 0,
             control_tx,
+            data_backlog: None,
             pending_resets,
             reset_notify,
             cancel,
@@ -266,6 +291,18 @@ impl Participant {
         }
     }
 
+    /// Queue an encoded message for a reliable channel.
+    ///
+    /// If the participant has a data backlog, the message is queued there and scheduled according
+    /// to the channel's QoS profile, and stale messages are dropped if the backlog is full.
+    /// Otherwise, it is queued on the control plane like [`send_control`](Self::send_control).
+    pub(super) fn send_data(&self, channel_id: ChannelId, qos: &QosProfile, data: Bytes) {
+        match &self.data_backlog {
+            Some(backlog) => backlog.push(channel_id, qos, data),
+            None => self.send_control(data),
+        }
+    }
+
     /// Send a fetch asset response to the participant via the control plane queue.
     pub(super) fn send_asset_response(&self, data: &[u8], request_id: u32) {
         self.send_control(encode_binary_message(&FetchAssetResponse::asset_data(
@@ -0,0 +1,512 @@
+//! Per-participant backlog of messages for reliable channels.
+//!
+//! By default, messages for reliable channels share the participant's control plane queue, and a
+//! participant whose queue fills up is disconnected. With a dropping [`MessageBacklogPolicy`],
+//! they are queued in a [`DataBacklog`] instead, which is bounded by message count and bytes and
+//! drops stale messages when it fills up, so that a slow participant stays connected. Control
+//! plane messages are never dropped, and are written ahead of queued channel messages.
+//!
+//! Queued messages are scheduled by the [`Priority`] of their channel's QoS profile, with a
+//! smooth weighted round-robin between priorities so that lower priorities are slowed down, not
+//! starved. When the backlog is full, messages of the lowest priority are dropped first. Messages
+//! which have waited longer than their channel's lifespan are dropped rather than sent.
+
+use std::collections::{HashMap, VecDeque};
+use std::time::{Duration, Instant};
+
+use bytes::Bytes;
+use parking_lot::Mutex;
+use tokio::sync::Notify;
+
+use crate::ChannelId;
+use crate::memory_budget::MemoryAccount;
+use crate::remote_access::qos::{Priority, QosProfile};
+use crate::throttler::Throttler;
+
+/// Number of [`Priority`] classes.
+const PRIORITY_CLASSES: usize = 3;
+
+/// Share of sends given to each priority class, indexed by [`priority_class`], when every class
+/// has queued messages.
+const PRIORITY_WEIGHTS: [i64; PRIORITY_CLASSES] = [1, 2, 4];
+
+fn priority_class(priority: Priority) -> usize {
+    match priority {
+        Priority::Low => 0,
+        Priority::Normal => 1,
+        Priority::High => 2,
+    }
+}
+
+/// How a participant's message backlog handles messages for reliable channels when it fills up.
+///
+/// See [`Gateway::message_backlog_policy`][crate::remote_access::Gateway::message_backlog_policy].
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum MessageBacklogPolicy {
+    /// Queue channel messages with control plane messages, and disconnect the participant when
+    /// the queue is full. The participant is asked to reconnect.
+    #[default]
+    Disconnect,
+    /// Queue channel messages separately, and drop the oldest queued message when the backlog is
+    /// full, whichever channel it was logged to.
+    DropOldest,
+    /// Queue channel messages separately, and drop stale messages from the busiest channels when
+    /// the backlog is full.
+    ///
+    /// The oldest message of a channel with more than one queued message is dropped, so that the
+    /// latest message of each channel is kept, and a high-rate topic cannot push the messages of
+    /// low-rate topics out of the backlog. If every channel has a single queued message, the
+    /// oldest message is dropped.
+    KeepLatestPerChannel,
+}
+
+/// Limits for a participant's message backlogs.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) struct BacklogOptions {
+    /// Maximum number of messages in each of the control plane queue and the data backlog.
+    pub size: usize,
+    /// Maximum number of bytes in the data backlog, if any.
+    pub bytes: Option<usize>,
+    pub policy: MessageBacklogPolicy,
+}
+
+impl BacklogOptions {
+    pub fn new(size: usize) -> Self {
+        Self {
+            size,
+            bytes: None,
+            policy: MessageBacklogPolicy::default(),
+        }
+    }
+}
+
+struct QueuedMessage {
+    channel_id: ChannelId,
+    data: Bytes,
+    /// When the message exceeds its channel's lifespan, if it has one.
+    expires_at: Option<Instant>,
+}
+
+#[derive(Default)]
+struct BacklogState {
+    /// Queued messages for each priority class, oldest first.
+    queues: [VecDeque<QueuedMessage>; PRIORITY_CLASSES],
+    /// Scheduling credit of each priority class, for the weighted round-robin.
+    credits: [i64; PRIORITY_CLASSES],
+    len: usize,
+    bytes: usize,
+    // Number of queued messages for each channel, maintained for `KeepLatestPerChannel`.
+    per_channel: HashMap<ChannelId, usize>,
+    dropped: u64,
+    expired: u64,
+}
+
+impl BacklogState {
+    fn remove(&mut self, class: usize, index: usize) -> Option<QueuedMessage> {
+        let message = self.queues[class].remove(index)?;
+        if self.queues[class].is_empty() {
+            self.credits[class] = 0;
+        }
+        self.len -= 1;
+        self.bytes -= message.data.len();
+        if let Some(count) = self.per_channel.get_mut(&message.channel_id) {
+            *count -= 1;
+            if *count == 0 {
+                self.per_channel.remove(&message.channel_id);
+            }
+        }
+        Some(message)
+    }
+
+    /// Picks the priority class to send from next.
+    ///
+    /// Each non-empty class earns its weight in credit, and the class with the most credit is
+    /// charged the total weight of the non-empty classes. Ties go to the higher priority.
+    fn next_class(&mut self) -> Option<usize> {
+        let mut total = 0;
+        let mut next = None;
+        for class in (0..PRIORITY_CLASSES).rev() {
+            if self.queues[class].is_empty() {
+                continue;
+            }
+            self.credits[class] += PRIORITY_WEIGHTS[class];
+            total += PRIORITY_WEIGHTS[class];
+            if next.is_none_or(|next: usize| self.credits[class] > self.credits[next]) {
+                next = Some(class);
+            }
+        }
+        let next = next?;
+        self.credits[next] -= total;
+        Some(next)
+    }
+
+    /// Picks the message to drop when the backlog is full.
+    fn victim(&self, policy: MessageBacklogPolicy) -> (usize, usize) {
+        if policy == MessageBacklogPolicy::KeepLatestPerChannel {
+            for (class, queue) in self.queues.iter().enumerate() {
+                if let Some(index) = queue.iter().position(|message| {
+                    self.per_channel
+                        .get(&message.channel_id)
+                        .is_some_and(|&n| n > 1)
+                }) {
+                    return (class, index);
+                }
+            }
+        }
+        let class = self
+            .queues
+            .iter()
+            .position(|queue| !queue.is_empty())
+            .unwrap_or_default();
+        (class, 0)
+    }
+}
+
+/// A bounded queue of encoded messages for reliable channels, which drops stale messages rather
+/// than blocking or failing when it is full.
+pub(crate) struct DataBacklog {
+    state: Mutex<BacklogState>,
+    notify: Notify,
+    max_messages: usize,
+    max_bytes: Option<usize>,
+    policy: MessageBacklogPolicy,
+    /// Charged with the queued bytes, against the context's memory budget.
+    memory: MemoryAccount,
+    throttler: Mutex<Throttler>,
+}
+
+impl DataBacklog {
+    /// Creates a backlog, or returns `None` if the policy queues channel messages on the control
+    /// plane.
+    pub fn new(options: BacklogOptions, memory: MemoryAccount) -> Option<Self> {
+        if options.policy == MessageBacklogPolicy::Disconnect {
+            return None;
+        }
+        Some(Self {
+            state: Mutex::default(),
+            notify: Notify::new(),
+            max_messages: options.size.max(1),
+            max_bytes: options.bytes,
+            policy: options.policy,
+            memory,
+            throttler: Mutex::new(Throttler::new(Duration::from_secs(30))),
+        })
+    }
+
+    /// Queues a message with its channel's QoS profile, dropping stale or lower-priority
+    /// messages if the backlog exceeds its limits or the context's memory budget.
+    ///
+    /// A message is always queued if the backlog is otherwise empty, even if it is larger than
+    /// the byte limit on its own.
+    pub fn push(&self, channel_id: ChannelId, qos: &QosProfile, data: Bytes) {
+        let expires_at = qos.lifespan.map(|lifespan| Instant::now() + lifespan);
+        let mut state = self.state.lock();
+        state.len += 1;
+        state.bytes += data.len();
+        self.memory.charge(data.len());
+        *state.per_channel.entry(channel_id).or_default() += 1;
+        state.queues[priority_class(qos.priority)].push_back(QueuedMessage {
+            channel_id,
+            data,
+            expires_at,
+        });
+
+        let mut dropped = 0;
+        while state.len > 1 {
+            let over_limits = state.len > self.max_messages
+                || self.max_bytes.is_some_and(|max| state.bytes > max);
+            if !over_limits {
+                if !self.memory.exceeded() {
+                    break;
+                }
+                self.memory.dropped();
+            }
+            let (class, index) = state.victim(self.policy);
+            if let Some(message) = state.remove(class, index) {
+                self.memory.release(message.data.len());
+            }
+            dropped += 1;
+        }
+        state.dropped += dropped;
+        let total_dropped = state.dropped;
+        drop(state);
+
+        if dropped > 0 && self.throttler.lock().try_acquire() {
+            tracing::warn!(
+                "participant message backlog full, dropped {total_dropped} messages so far"
+            );
+        }
+        self.notify.notify_one();
+    }
+
+    /// Removes the next message to send, dropping any messages which have exceeded their
+    /// lifespan along the way.
+    pub fn pop(&self) -> Option<Bytes> {
+        let now = Instant::now();
+        let mut state = self.state.lock();
+        let mut expired = 0;
+        let data = loop {
+            let Some(class) = state.next_class() else {
+                break None;
+            };
+            let message = state.remove(class, 0)?;
+            self.memory.release(message.data.len());
+            if message
+                .expires_at
+                .is_some_and(|expires_at| expires_at <= now)
+            {
+                expired += 1;
+                continue;
+            }
+            break Some(message.data);
+        };
+        state.expired += expired;
+        let total_expired = state.expired;
+        drop(state);
+
+        if expired > 0 && self.throttler.lock().try_acquire() {
+            tracing::warn!(
+                "participant message backlog congested, dropped {total_expired} messages past \
+                 their lifespan so far"
+            );
+        }
+        data
+    }
+
+    /// Waits for a message and removes it from the backlog.
+    pub async fn recv(&self) -> Bytes {
+        loop {
+            if let Some(data) = self.pop() {
+                return data;
+            }
+            // A notification sent between `pop` and here is stored, so it isn't missed.
+            self.notify.notified().await;
+        }
+    }
+
+    /// Returns the number of messages dropped so far.
+    #[cfg(test)]
+    pub fn dropped(&self) -> u64 {
+        self.state.lock().dropped
+    }
+
+    /// Returns the number of messages dropped for exceeding their lifespan so far.
+    #[cfg(test)]
+    pub fn expired(&self) -> u64 {
+        self.state.lock().expired
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::MemoryPool;
+    use crate::memory_budget::{MemoryAccounting, MemoryBudget};
+
+    fn backlog(policy: MessageBacklogPolicy, size: usize, bytes: Option<usize>) -> DataBacklog {
+        DataBacklog::new(
+            BacklogOptions {
+                size,
+                bytes,
+                policy,
+            },
+            MemoryAccount::detached(MemoryPool::RemoteAccess),
+        )
+        .expect("policy should use a data backlog")
+    }
+
+    fn drain(backlog: &DataBacklog) -> Vec<Bytes> {
+        std::iter::from_fn(|| backlog.pop()).collect()
+    }
+
+    #[test]
+    fn test_disconnect_policy_has_no_data_backlog() {
+        assert!(
+            DataBacklog::new(
+                BacklogOptions::new(4),
+                MemoryAccount::detached(MemoryPool::RemoteAccess)
+            )
+            .is_none()
+        );
+    }
+
+    #[test]
+    fn test_drop_oldest() {
+        let backlog = backlog(MessageBacklogPolicy::DropOldest, 2, None);
+        for data in [&b"a"[..], b"b", b"c"] {
+            backlog.push(
+                ChannelId::new(1),
+                &QosProfile::default(),
+                Bytes::from_static(data),
+            );
+        }
+        assert_eq!(backlog.dropped(), 1);
+        assert_eq!(drain(&backlog), vec![&b"b"[..], b"c"]);
+    }
+
+    #[test]
+    fn test_memory_budget() {
+        let accounting = std::sync::Arc::new(MemoryAccounting::default());
+        accounting.set_budget(Some(
+            MemoryBudget::new(100).share(MemoryPool::RemoteAccess, 0.05),
+        ));
+        let backlog = DataBacklog::new(
+            BacklogOptions {
+                size: 16,
+                bytes: None,
+                policy: MessageBacklogPolicy::DropOldest,
+            },
+            MemoryAccount::new(accounting.clone(), MemoryPool::RemoteAccess),
+        )
+        .expect("policy should use a data backlog");
+        for data in [&b"abc"[..], b"de", b"fgh"] {
+            backlog.push(
+                ChannelId::new(1),
+                &QosProfile::default(),
+                Bytes::from_static(data),
+            );
+        }
+        // The pool's share of 5 bytes only fits the last two messages.
+        assert_eq!(backlog.dropped(), 1);
+        assert_eq!(accounting.usage().bytes, 5);
+        assert_eq!(drain(&backlog), vec![&b"de"[..], b"fgh"]);
+        assert_eq!(accounting.usage().bytes, 0);
+    }
+
+    #[test]
+    fn test_byte_limit() {
+        let backlog = backlog(MessageBacklogPolicy::DropOldest, 16, Some(4));
+        backlog.push(
+            ChannelId::new(1),
+            &QosProfile::default(),
+            Bytes::from_static(b"abc"),
+        );
+        backlog.push(
+            ChannelId::new(1),
+            &QosProfile::default(),
+            Bytes::from_static(b"de"),
+        );
+        assert_eq!(drain(&backlog), vec![&b"de"[..]]);
+
+        // A message larger than the limit is still queued.
+        backlog.push(
+            ChannelId::new(1),
+            &QosProfile::default(),
+            Bytes::from_static(b"fghij"),
+        );
+        assert_eq!(drain(&backlog), vec![&b"fghij"[..]]);
+    }
+
+    #[test]
+    fn test_keep_latest_per_channel() {
+        let backlog = backlog(MessageBacklogPolicy::KeepLatestPerChannel, 3, None);
+        backlog.push(
+            ChannelId::new(1),
+            &QosProfile::default(),
+            Bytes::from_static(b"slow"),
+        );
+        backlog.push(
+            ChannelId::new(2),
+            &QosProfile::default(),
+            Bytes::from_static(b"fast1"),
+        );
+        backlog.push(
+            ChannelId::new(2),
+            &QosProfile::default(),
+            Bytes::from_static(b"fast2"),
+        );
+        backlog.push(
+            ChannelId::new(2),
+            &QosProfile::default(),
+            Bytes::from_static(b"fast3"),
+        );
+        assert_eq!(backlog.dropped(), 1);
+        assert_eq!(drain(&backlog), vec![&b"slow"[..], b"fast2", b"fast3"]);
+    }
+
+    fn qos(priority: Priority) -> QosProfile {
+        QosProfile::builder().priority(priority).build()
+    }
+
+    #[test]
+    fn test_weighted_priority_scheduling() {
+        let backlog = backlog(MessageBacklogPolicy::DropOldest, 64, None);
+        for _ in 0..8 {
+            backlog.push(
+                ChannelId::new(1),
+                &qos(Priority::Low),
+                Bytes::from_static(b"L"),
+            );
+            backlog.push(
+                ChannelId::new(2),
+                &qos(Priority::Normal),
+                Bytes::from_static(b"N"),
+            );
+            backlog.push(
+                ChannelId::new(3),
+                &qos(Priority::High),
+                Bytes::from_static(b"H"),
+            );
+        }
+        // High priority goes first, and every class is served in proportion to its weight.
+        let first_round: Vec<_> = std::iter::from_fn(|| backlog.pop()).take(7).collect();
+        assert_eq!(first_round[0], Bytes::from_static(b"H"));
+        let count = |data: &'static [u8]| first_round.iter().filter(|d| **d == data).count();
+        assert_eq!((count(b"H"), count(b"N"), count(b"L")), (4, 2, 1));
+    }
+
+    #[test]
+    fn test_drops_lowest_priority_first() {
+        let backlog = backlog(MessageBacklogPolicy::DropOldest, 2, None);
+        backlog.push(
+            ChannelId::new(1),
+            &qos(Priority::High),
+            Bytes::from_static(b"h1"),
+        );
+        backlog.push(
+            ChannelId::new(2),
+            &qos(Priority::Low),
+            Bytes::from_static(b"l1"),
+        );
+        backlog.push(
+            ChannelId::new(1),
+            &qos(Priority::High),
+            Bytes::from_static(b"h2"),
+        );
+        assert_eq!(backlog.dropped(), 1);
+        assert_eq!(drain(&backlog), vec![&b"h1"[..], b"h2"]);
+    }
+
+    #[test]
+    fn test_lifespan() {
+        let backlog = backlog(MessageBacklogPolicy::DropOldest, 4, None);
+        let short = QosProfile::builder()
+            .lifespan(Duration::from_millis(1))
+            .build();
+        backlog.push(ChannelId::new(1), &short, Bytes::from_static(b"stale"));
+        backlog.push(
+            ChannelId::new(2),
+            &QosProfile::default(),
+            Bytes::from_static(b"a"),
+        );
+        std::thread::sleep(Duration::from_millis(10));
+        assert_eq!(drain(&backlog), vec![&b"a"[..]]);
+        assert_eq!(backlog.expired(), 1);
+    }
+
+    #[tokio::test]
+    async fn test_recv_waits_for_message() {
+        let backlog = std::sync::Arc::new(backlog(MessageBacklogPolicy::DropOldest, 2, None));
+        let task = tokio::spawn({
+            let backlog = backlog.clone();
+            async move { backlog.recv().await }
+        });
+        tokio::task::yield_now().await;
+        backlog.push(
+            ChannelId::new(1),
+            &QosProfile::default(),
+            Bytes::from_static(b"a"),
+        );
+        assert_eq!(task.await.unwrap(), Bytes::from_static(b"a"));
+    }
+}
@@ -11,7 +11,7 @@
 //! [`SessionState`] for channel/subscription/video bookkeeping.
 
 use std::collections::HashSet;
-use std::sync::Arc;
+use std::sync::{Arc, Weak};
 
 use bytes::Bytes;
 use livekit::id::{ParticipantIdentity, ParticipantSid};
@@ -19,8 +19,11 @@ use parking_lot::{Mutex, RwLock};
 use tokio::sync::Notify;
 use tokio_util::sync::CancellationToken;
 
+use crate::memory_budget::MemoryAccount;
+use crate::{Context, MemoryPool};
+
 use super::collection::Participants;
-use super::{Participant, ParticipantWriter};
+use super::{BacklogOptions, Participant, ParticipantWriter};
 
 /// Owns the participant membership state machine: add / remove / lookup, plus
 /// the `pending_resets` channel that lets a flush-task request its own reset.
@@ -33,17 +36,20 @@ pub(crate) struct ParticipantRegistry {
     pending_resets: Arc<Mutex<HashSet<ParticipantSid>>>,
     /// Notified when a new reset is inserted into `pending_resets`.
     reset_notify: Arc<Notify>,
-    /// Size of the per-participant control-plane queue.
-    message_backlog_size: usize,
+    /// Limits of the per-participant control-plane queue and data backlog.
+    backlog: BacklogOptions,
+    /// The context whose memory budget the data backlogs are charged to.
+    context: Weak<Context>,
 }
 
 impl ParticipantRegistry {
-    pub(crate) fn new(message_backlog_size: usize) -> Self {
+    pub(crate) fn new(backlog: BacklogOptions, context: Weak<Context>) -> Self {
         Self {
             participants: RwLock::new(Participants::new()),
             pending_resets: Arc::new(Mutex::new(HashSet::new())),
             reset_notify: Arc::new(Notify::new()),
-            message_backlog_size,
+            backlog,
+            context,
         }
     }
 
@@ -117,12 +123,17 @@ impl ParticipantRegistry {
     where
         I: IntoIterator<Item = Bytes>,
     {
+        let memory = self.context.upgrade().map_or_else(
+            || MemoryAccount::detached(MemoryPool::RemoteAccess),
+            |context| context.memory_account(MemoryPool::RemoteAccess),
+        );
         let (participant, flush_handle) = Participant::spawn(
             id,
             participant_sid,
             joined_at,
             writer,
-            self.message_backlog_size,
+            self.backlog,
+            memory,
             self.pending_resets.clone(),
             self.reset_notify.clone(),
             session_cancel,
@@ -277,7 +288,7 @@ mod tests {
     use super::super::{ParticipantWriter, TestByteStreamWriter, test_sid};
 
     fn make_registry() -> ParticipantRegistry {
-        ParticipantRegistry::new(16)
+        ParticipantRegistry::new(BacklogOptions::new(16), Weak::new())
     }
 
     fn test_writer() -> ParticipantWriter {
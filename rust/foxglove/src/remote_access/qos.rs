@@ -1,3 +1,5 @@
+use std::time::Duration;
+
 use crate::channel::ChannelDescriptor;
 
 /// The reliability policy for a channel's data delivery.
@@ -17,6 +19,24 @@ pub enum Reliability {
     Reliable,
 }
 
+/// The priority of a channel's data, relative to other channels.
+///
+/// When a participant's message backlog is congested, messages for higher-priority channels are
+/// sent more often, and messages for lower-priority channels are dropped first. Priority takes
+/// effect for reliable channels when the gateway is configured with a dropping
+/// [`MessageBacklogPolicy`](super::MessageBacklogPolicy); otherwise, reliable messages are sent
+/// in the order they were logged.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash, Default)]
+pub enum Priority {
+    /// Best-effort data, such as debug visualizations.
+    Low,
+    /// The default priority.
+    #[default]
+    Normal,
+    /// Latency-sensitive data, such as teleoperation commands and transforms.
+    High,
+}
+
 /// Quality-of-service profile for a channel.
 ///
 /// Controls how data for a channel is delivered to remote participants.
@@ -24,6 +44,9 @@ pub enum Reliability {
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
 pub struct QosProfile {
     pub(super) reliability: Reliability,
+    pub(super) priority: Priority,
+    pub(super) lifespan: Option<Duration>,
+    pub(super) min_interval: Option<Duration>,
 }
 
 impl QosProfile {
@@ -36,12 +59,30 @@ impl QosProfile {
     pub fn reliability(&self) -> Reliability {
         self.reliability
     }
+
+    /// Returns the priority.
+    pub fn priority(&self) -> Priority {
+        self.priority
+    }
+
+    /// Returns how long a message may wait to be sent before it is dropped, if limited.
+    pub fn lifespan(&self) -> Option<Duration> {
+        self.lifespan
+    }
+
+    /// Returns the minimum interval between messages sent for the channel, if rate-limited.
+    pub fn min_interval(&self) -> Option<Duration> {
+        self.min_interval
+    }
 }
 
 /// Builder for [`QosProfile`].
 #[derive(Debug, Clone, Default)]
 pub struct QosProfileBuilder {
     reliability: Reliability,
+    priority: Priority,
+    lifespan: Option<Duration>,
+    min_interval: Option<Duration>,
 }
 
 impl QosProfileBuilder {
@@ -52,10 +93,42 @@ impl QosProfileBuilder {
         self
     }
 
+    /// Sets the priority.
+    #[must_use]
+    pub fn priority(mut self, priority: Priority) -> Self {
+        self.priority = priority;
+        self
+    }
+
+    /// Sets how long a message may wait in a participant's message backlog before it is dropped
+    /// rather than sent.
+    ///
+    /// Like [`Priority`], this takes effect for reliable channels when the gateway is configured
+    /// with a dropping [`MessageBacklogPolicy`](super::MessageBacklogPolicy).
+    #[must_use]
+    pub fn lifespan(mut self, lifespan: Duration) -> Self {
+        self.lifespan = Some(lifespan).filter(|d| !d.is_zero());
+        self
+    }
+
+    /// Limits the rate of messages sent for the channel, in messages per second.
+    ///
+    /// Messages logged faster than this are dropped before they are sent to any participant.
+    /// Video channels are not affected; their frame rate is adapted to the available bandwidth.
+    /// A rate that is not positive and finite removes the limit.
+    #[must_use]
+    pub fn max_rate(mut self, hz: f64) -> Self {
+        self.min_interval = (hz.is_finite() && hz > 0.0).then(|| Duration::from_secs_f64(1.0 / hz));
+        self
+    }
+
     /// Builds the [`QosProfile`].
     pub fn build(self) -> QosProfile {
         QosProfile {
             reliability: self.reliability,
+            priority: self.priority,
+            lifespan: self.lifespan,
+            min_interval: self.min_interval,
         }
     }
 }
@@ -11,7 +11,8 @@ use crate::remote_common::service::ServiceId;
 
 // Re-export service types so Gateway::services() callers can construct services.
 pub use crate::remote_common::service::{
-    CallId, Handler, Request, Responder, Service, ServiceBuilder, ServiceSchema, SyncHandler,
+    CallId, Handler, Request, Responder, Service, ServiceBuilder, ServiceExecutor, ServiceSchema,
+    SyncHandler,
 };
 
 /// Sends service call responses over the remote access control plane.
@@ -57,6 +58,10 @@ impl crate::remote_common::service::ResponseSender for ResponseSender {
         };
         participant.send_control(data);
     }
+
+    fn is_cancelled(&self) -> bool {
+        self.participant.strong_count() == 0
+    }
 }
 
 /// Creates a new [`Responder`] backed by a remote access control plane.
@@ -1,12 +1,12 @@
 use std::collections::HashMap;
 use std::sync::{Arc, Weak};
-use std::time::Duration;
+use std::time::{Duration, Instant};
 
 use bytes::Bytes;
 use futures_util::StreamExt;
 use indexmap::IndexSet;
 use libwebrtc::video_source::{RtcVideoSource, native::NativeVideoSource};
-use livekit::options::{TrackPublishOptions, VideoCodec};
+use livekit::options::{TrackPublishOptions, VideoCodec, VideoEncoding};
 use livekit::{
     ByteStreamReader, Room, StreamByteOptions,
     id::{ParticipantIdentity, ParticipantSid},
@@ -22,7 +22,7 @@ use tracing::{debug, error, info, trace, warn};
 use crate::protocol::v2::DecodeError;
 use crate::protocol::v2::parameter::Parameter;
 use crate::protocol::v2::server::ParameterValues;
-use crate::remote_common::connection_graph::ConnectionGraph;
+use crate::remote_common::connection_graph::{ConnectionGraph, ConnectionGraphPatch};
 use crate::remote_common::{
     AnyClient,
     fetch_asset::AssetResponder,
@@ -31,8 +31,8 @@ use crate::remote_common::{
 };
 use crate::time::millis_since_epoch;
 use crate::{
-    ChannelDescriptor, ChannelId, Context, FoxgloveError, Metadata, RawChannel, Schema, Sink,
-    SinkChannelFilter, SinkId,
+    ChannelDemand, ChannelDescriptor, ChannelId, Context, FoxgloveError, Metadata, RawChannel,
+    Schema, Sink, SinkChannelFilter, SinkId, SinkStats,
     protocol::v2::{
         BinaryMessage, JsonMessage,
         client::{self, ClientMessage},
@@ -41,14 +41,15 @@ use crate::{
             Status, Unadvertise, UnadvertiseServices, advertise, advertise_services,
         },
     },
-    remote_access::qos::{QosClassifier, Reliability},
+    remote_access::keyframe_request::{KeyframeRequestHandler, is_compressed_video},
+    remote_access::qos::{QosClassifier, QosProfile, Reliability},
     remote_access::suppress_video_transcode::SuppressVideoTranscode,
     remote_access::{
         AssetHandler, Capability, Listener, RemoteAccessError,
         channel_registry::ChannelRegistry,
         client::Client,
         parameter_subscriptions::ParameterSubscriptions,
-        participant::{Participant, ParticipantRegistry, ParticipantWriter},
+        participant::{BacklogOptions, Participant, ParticipantRegistry, ParticipantWriter},
         protocol_version,
         rtt_tracker::RttTracker,
     },
@@ -56,6 +57,8 @@ use crate::{
 
 mod data_track;
 pub(super) use data_track::{DataTrack, OversizedDropReport};
+mod video_rate;
+use video_rate::{VideoAdaptation, VideoBudget};
 mod video_track;
 pub(super) use video_track::{
     VideoInputSchema, VideoMetadata, VideoPublisher, resolve_video_input_schema,
@@ -108,6 +111,10 @@ pub(super) const MIN_DATA_TRACK_MESSAGE_SIZE: usize = 1200;
 // The default must satisfy the configurable minimum.
 const _: () = assert!(DEFAULT_MAX_DATA_TRACK_MESSAGE_SIZE >= MIN_DATA_TRACK_MESSAGE_SIZE);
 
+/// Minimum interval between keyframe requests for a compressed video channel, so that a burst of
+/// subscriptions or dropped frames doesn't make the producer emit a run of keyframes.
+const KEYFRAME_REQUEST_INTERVAL: Duration = Duration::from_millis(500);
+
 /// The default codec for published video tracks.
 ///
 /// We prefer H.264 so that the libwebrtc nvenc encoder (H.264-only) can be used on Linux
@@ -277,6 +284,9 @@ pub(super) struct RemoteAccessSession {
     channel_filter: Option<Arc<dyn SinkChannelFilter>>,
     qos_classifier: Option<Arc<dyn QosClassifier>>,
     suppress_video_transcode: Option<Arc<dyn SuppressVideoTranscode>>,
+    keyframe_request_handler: Option<Arc<dyn KeyframeRequestHandler>>,
+    /// When a keyframe was last requested for each compressed video channel.
+    keyframe_requests: parking_lot::Mutex<HashMap<ChannelId, Instant>>,
     listener: Option<Arc<dyn Listener>>,
     capabilities: Vec<Capability>,
     fetch_asset_handler: Option<Arc<dyn AssetHandler>>,
@@ -310,12 +320,25 @@ pub(super) struct RemoteAccessSession {
     video_codec_override: Option<VideoCodec>,
     /// Per-message size limit for lossy data-track channels; larger messages are dropped.
     max_data_track_message_size: usize,
+    /// If set, lossy messages up to this size are fragmented rather than dropped.
+    max_fragmented_message_size: Option<usize>,
+    /// If set, small lossy messages are packed into shared frames, waiting at most this long.
+    pack_linger: Option<Duration>,
     /// Active oversized-drop warnings, keyed by channel.
     active_drop_statuses: parking_lot::Mutex<HashMap<ChannelId, ActiveDropStatus>>,
     /// The preferred encoder backend applied to published video tracks.
     /// [`VideoEncoderBackend::Auto`](super::gateway::VideoEncoderBackend::Auto) leaves the
     /// choice to libwebrtc.
     video_encoder: super::gateway::VideoEncoderBackend,
+    /// Whether published video tracks are sent as simulcast layers.
+    video_simulcast: bool,
+    /// If set, limits for published video tracks, which are also adapted to the available
+    /// bandwidth.
+    video_limits: Option<super::VideoLimits>,
+    /// The bandwidth available to each video track, updated by `adapt_video_to_bandwidth`.
+    video_budget: Arc<VideoBudget>,
+    /// When the last message was sent for each channel whose QoS profile limits its rate.
+    rate_limited_sends: parking_lot::Mutex<HashMap<ChannelId, Instant>>,
 }
 
 impl Sink for RemoteAccessSession {
@@ -329,56 +352,17 @@ impl Sink for RemoteAccessSession {
         msg: &[u8],
         metadata: &Metadata,
     ) -> std::result::Result<(), FoxgloveError> {
-        let channel_id = channel.id();
-
-        // Captured under the read lock and handled after the lock is released.
-        let mut drop_report: Option<(OversizedDropReport, SmallVec<[ParticipantSid; 4]>)> = None;
-
-        // Snapshot subscriber SIDs under the channel-registry read lock and
-        // release it before resolving against the participant registry. A
-        // same-identity reconnect arrives with a *different* `ParticipantSid`,
-        // so a stale snapshotted SID resolves to `None` in the participant
-        // registry rather than the new attempt.
-        let reliable_sids = {
-            let state = self.channel_registry.read();
-
-            // Video track publisher: stays inside the state lock since the
-            // publisher handle is not cloneable out of the map.
-            if let Some(publisher) = state.get_video_publisher(&channel_id) {
-                publisher.send(Bytes::copy_from_slice(msg), metadata.log_time);
-            }
-
-            if !state.has_data_subscribers(&channel_id) {
-                SmallVec::new()
-            } else if state.qos_profile(&channel_id).reliability == Reliability::Reliable {
-                state.data_subscriber_sids(&channel_id)
-            } else {
-                // Lossy channels: send via the eagerly-published data track
-                // inline, while we still hold the state read lock.
-                if let Some(track) = state.get_subscribed_data_track(&channel_id)
-                    && let Err(report) = track.log(channel_id, msg, metadata)
-                {
-                    drop_report = Some((report, state.data_subscriber_sids(&channel_id)));
-                }
-                SmallVec::new()
-            }
-        };
-
-        // Reliable channels: send MessageData via the control bytestream.
-        // Batch-resolve SIDs so we take the registry lock once rather than
-        // per-subscriber.
-        if !reliable_sids.is_empty() {
-            let message = MessageData::new(u64::from(channel_id), metadata.log_time, msg);
-            let encoded = encode_binary_message(&message);
-            for participant in self.participant_registry.resolve_sids(reliable_sids) {
-                participant.send_control(encoded.clone());
-            }
-        }
-
-        if let Some((report, subscriber_sids)) = drop_report {
-            self.emit_drop_status(channel, report, subscriber_sids);
-        }
+        self.log_message(channel, msg, None, metadata);
+        Ok(())
+    }
 
+    fn log_shared(
+        &self,
+        channel: &RawChannel,
+        msg: &Bytes,
+        metadata: &Metadata,
+    ) -> std::result::Result<(), FoxgloveError> {
+        self.log_message(channel, msg, Some(msg), metadata);
         Ok(())
     }
 
@@ -474,6 +458,9 @@ impl Sink for RemoteAccessSession {
         let unadvertise = Unadvertise::new([u64::from(channel_id)]);
         self.broadcast_control(encode_json_message(&unadvertise));
 
+        self.rate_limited_sends.lock().remove(&channel_id);
+        self.keyframe_requests.lock().remove(&channel_id);
+
         // Clear any oversized-drop warning for the removed channel.
         self.active_drop_statuses.lock().remove(&channel_id);
         self.broadcast_control(encode_json_message(&RemoveStatus::new([drop_status_id(
@@ -496,6 +483,33 @@ impl Sink for RemoteAccessSession {
     fn auto_subscribe(&self) -> bool {
         false
     }
+
+    fn sink_stats(&self) -> Option<SinkStats> {
+        let video_tracks = self.stats().video_tracks;
+        let per_track = self.video_budget.get().unwrap_or(0);
+        Some(SinkStats {
+            kind: "remote_access",
+            video_tracks,
+            video_bitrate: per_track.saturating_mul(video_tracks as u64),
+            ..SinkStats::default()
+        })
+    }
+
+    fn demand(&self, channel: &RawChannel) -> ChannelDemand {
+        let state = self.channel_registry.read();
+        let (subscribers, video_subscribers) = state.subscriber_counts(&channel.id());
+        // Video subscribers receive every frame through the encoder. Data subscribers receive
+        // messages at most as often as the channel's QoS profile allows.
+        let max_rate = if video_subscribers > 0 {
+            None
+        } else {
+            state
+                .qos_profile(&channel.id())
+                .min_interval
+                .map(|interval| interval.as_secs_f64().recip())
+        };
+        ChannelDemand::new(subscribers, max_rate)
+    }
 }
 
 pub(super) struct SessionParams {
@@ -504,13 +518,17 @@ pub(super) struct SessionParams {
     pub(super) channel_filter: Option<Arc<dyn SinkChannelFilter>>,
     pub(super) qos_classifier: Option<Arc<dyn QosClassifier>>,
     pub(super) suppress_video_transcode: Option<Arc<dyn SuppressVideoTranscode>>,
+    pub(super) keyframe_request_handler: Option<Arc<dyn KeyframeRequestHandler>>,
     pub(super) listener: Option<Arc<dyn Listener>>,
     pub(super) capabilities: Vec<Capability>,
     pub(super) supported_encodings: IndexSet<String>,
     pub(super) runtime: Handle,
     pub(super) cancellation_token: CancellationToken,
-    pub(super) message_backlog_size: usize,
+    pub(super) message_backlog: BacklogOptions,
     pub(super) max_data_track_message_size: usize,
+    pub(super) max_fragmented_message_size: Option<usize>,
+    pub(super) pack_linger: Option<Duration>,
+    pub(super) video_limits: Option<super::VideoLimits>,
     pub(super) services: Arc<parking_lot::RwLock<ServiceMap>>,
     pub(super) connection_graph: Arc<parking_lot::Mutex<ConnectionGraph>>,
     pub(super) remote_access_session_id: Option<String>,
@@ -520,12 +538,14 @@ pub(super) struct SessionParams {
     pub(super) device_wait_for_viewer: Option<Duration>,
     pub(super) video_codec_override: Option<VideoCodec>,
     pub(super) video_encoder: super::gateway::VideoEncoderBackend,
+    pub(super) video_simulcast: bool,
 }
 
 impl RemoteAccessSession {
     pub(super) fn new(params: SessionParams) -> Arc<Self> {
         let (video_metadata_tx, video_metadata_rx) = tokio::sync::watch::channel(());
-        let participant_registry = ParticipantRegistry::new(params.message_backlog_size);
+        let participant_registry =
+            ParticipantRegistry::new(params.message_backlog, params.context.clone());
         Arc::new(Self {
             sink_id: SinkId::next(),
             room: params.room,
@@ -536,6 +556,8 @@ impl RemoteAccessSession {
             channel_filter: params.channel_filter,
             qos_classifier: params.qos_classifier,
             suppress_video_transcode: params.suppress_video_transcode,
+            keyframe_request_handler: params.keyframe_request_handler,
+            keyframe_requests: parking_lot::Mutex::default(),
             listener: params.listener,
             capabilities: params.capabilities,
             fetch_asset_handler: params.fetch_asset_handler,
@@ -555,11 +577,147 @@ impl RemoteAccessSession {
             device_wait_for_viewer: params.device_wait_for_viewer,
             video_codec_override: params.video_codec_override,
             max_data_track_message_size: params.max_data_track_message_size,
+            max_fragmented_message_size: params.max_fragmented_message_size,
+            pack_linger: params.pack_linger,
             active_drop_statuses: parking_lot::Mutex::new(HashMap::new()),
             video_encoder: params.video_encoder,
+            video_simulcast: params.video_simulcast,
+            video_limits: params.video_limits,
+            video_budget: Arc::default(),
+            rate_limited_sends: parking_lot::Mutex::default(),
         })
     }
 
+    /// Asks the producer of a compressed video channel for a keyframe, unless one was requested
+    /// recently.
+    fn request_keyframe(&self, channel: &ChannelDescriptor) {
+        let Some(handler) = &self.keyframe_request_handler else {
+            return;
+        };
+        if !is_compressed_video(channel) {
+            return;
+        }
+        let now = Instant::now();
+        {
+            let mut requests = self.keyframe_requests.lock();
+            if requests
+                .get(&channel.id())
+                .is_some_and(|&last| now.duration_since(last) < KEYFRAME_REQUEST_INTERVAL)
+            {
+                return;
+            }
+            requests.insert(channel.id(), now);
+        }
+        debug!(topic = %channel.topic(), "requesting keyframe");
+        handler.request_keyframe(channel);
+    }
+
+    /// Sends a message to the video track and subscribed participants of its channel.
+    ///
+    /// If the message is held in a shared buffer, the video track keeps a reference to it rather
+    /// than copying the frame.
+    fn log_message(
+        &self,
+        channel: &RawChannel,
+        msg: &[u8],
+        shared: Option<&Bytes>,
+        metadata: &Metadata,
+    ) {
+        let channel_id = channel.id();
+
+        // Captured under the read lock and handled after the lock is released.
+        let mut drop_report: Option<(OversizedDropReport, SmallVec<[ParticipantSid; 4]>)> = None;
+
+        // Snapshot subscriber SIDs under the channel-registry read lock and
+        // release it before resolving against the participant registry. A
+        // same-identity reconnect arrives with a *different* `ParticipantSid`,
+        // so a stale snapshotted SID resolves to `None` in the participant
+        // registry rather than the new attempt.
+        let (reliable_sids, qos) = {
+            let state = self.channel_registry.read();
+
+            // Video track publisher: stays inside the state lock since the
+            // publisher handle is not cloneable out of the map.
+            if let Some(publisher) = state.get_video_publisher(&channel_id) {
+                let frame = shared
+                    .cloned()
+                    .unwrap_or_else(|| Bytes::copy_from_slice(msg));
+                publisher.send(frame, metadata.log_time);
+            }
+
+            let qos = state.qos_profile(&channel_id);
+            let sids = if !state.has_data_subscribers(&channel_id)
+                || !self.check_rate_limit(channel_id, qos.min_interval)
+            {
+                SmallVec::new()
+            } else if qos.reliability == Reliability::Reliable {
+                state.data_subscriber_sids(&channel_id)
+            } else {
+                // Lossy channels: send via the eagerly-published data track
+                // inline, while we still hold the state read lock.
+                if let Some(track) = state.get_subscribed_data_track(&channel_id)
+                    && let Err(report) = track.log(channel_id, msg, metadata)
+                {
+                    drop_report = Some((report, state.data_subscriber_sids(&channel_id)));
+                }
+                SmallVec::new()
+            };
+            (sids, qos)
+        };
+
+        // Reliable channels: send MessageData via the control bytestream.
+        // Batch-resolve SIDs so we take the registry lock once rather than
+        // per-subscriber.
+        if !reliable_sids.is_empty() {
+            let message = MessageData::new(u64::from(channel_id), metadata.log_time, msg);
+            let encoded = encode_binary_message(&message);
+            for participant in self.participant_registry.resolve_sids(reliable_sids) {
+                participant.send_data(channel_id, &qos, encoded.clone());
+            }
+        }
+
+        if let Some((report, subscriber_sids)) = drop_report {
+            // The dropped frame breaks the decode chain of a compressed video channel.
+            self.request_keyframe(channel.descriptor());
+            self.emit_drop_status(channel, report, subscriber_sids);
+        }
+    }
+
+    /// Sends the messages retained by a latched channel to a participant which subscribed to it.
+    fn send_latched(&self, participant: &Participant, channel_id: ChannelId) {
+        let Some(channel) = self
+            .context
+            .upgrade()
+            .and_then(|context| context.get_channel(channel_id))
+        else {
+            return;
+        };
+        let qos = self.channel_registry.read().qos_profile(&channel_id);
+        for (msg, metadata) in channel.latched_messages() {
+            let message = MessageData::new(u64::from(channel_id), metadata.log_time, &msg);
+            participant.send_data(channel_id, &qos, encode_binary_message(&message));
+        }
+    }
+
+    /// Returns true if a message for a channel may be sent now, given the minimum interval
+    /// between messages from its QoS profile, and records the send.
+    fn check_rate_limit(&self, channel_id: ChannelId, min_interval: Option<Duration>) -> bool {
+        let Some(min_interval) = min_interval else {
+            return true;
+        };
+        // Allow some jitter, so that a channel logged exactly at its max rate isn't decimated.
+        let min_interval = min_interval.mul_f64(0.9);
+        let now = Instant::now();
+        let mut last_sends = self.rate_limited_sends.lock();
+        match last_sends.get(&channel_id) {
+            Some(&last) if now.duration_since(last) < min_interval => false,
+            _ => {
+                last_sends.insert(channel_id, now);
+                true
+            }
+        }
+    }
+
     /// Returns true if the given capability is enabled for this session.
     fn has_capability(&self, cap: Capability) -> bool {
         self.capabilities.contains(&cap)
@@ -960,6 +1118,17 @@ impl RemoteAccessSession {
             context.subscribe_channels(self.sink_id, &subscribe_result.first_subscribed);
         }
 
+        // The context replays the messages of latched channels when they gain their first
+        // subscriber. Later subscribers receive them here.
+        for descriptor in &subscribe_result.newly_subscribed_descriptors {
+            if descriptor.keep_last() > 0
+                && data_channel_ids.contains(&descriptor.id())
+                && !subscribe_result.first_subscribed.contains(&descriptor.id())
+            {
+                self.send_latched(participant, descriptor.id());
+            }
+        }
+
         self.start_video_tracks(&first_video_subscribed);
         self.stop_video_tracks(&last_video_unsubscribed);
 
@@ -975,6 +1144,11 @@ impl RemoteAccessSession {
             }
         }
 
+        // A new viewer of a compressed video channel can't decode until the next keyframe.
+        for descriptor in &subscribe_result.newly_subscribed_descriptors {
+            self.request_keyframe(descriptor);
+        }
+
         // Replay active drop warnings to new data subscribers. This is important to ensure that
         // users are notified of drops in a timely fashion. Otherwise, they have to wait up to the
         // throttle period, which is deliberately quite long.
@@ -1909,6 +2083,50 @@ impl RemoteAccessSession {
         }
     }
 
+    /// Periodically divides the estimated available bandwidth between the session's video
+    /// tracks, so that each one can adapt its resolution and frame rate.
+    ///
+    /// Does nothing unless video limits are configured.
+    pub(super) async fn adapt_video_to_bandwidth(&self) {
+        if self.video_limits.is_none() {
+            return std::future::pending().await;
+        }
+        let mut interval = tokio::time::interval(Duration::from_secs(1));
+        interval.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Skip);
+        loop {
+            interval.tick().await;
+            let video_tracks = self.channel_registry.read().video_track_count();
+            if video_tracks == 0 {
+                continue;
+            }
+            let stats = match self.room.get_stats().await {
+                Ok(stats) => stats,
+                Err(e) => {
+                    debug!("failed to get room stats for bandwidth estimate: {e}");
+                    continue;
+                }
+            };
+            // The congestion controller's estimate is reported on the nominated candidate pair.
+            let available = stats
+                .publisher_stats
+                .iter()
+                .filter_map(|s| match s {
+                    libwebrtc::stats::RtcStats::CandidatePair(cp)
+                        if cp.candidate_pair.nominated =>
+                    {
+                        Some(cp.candidate_pair.available_outgoing_bitrate)
+                    }
+                    _ => None,
+                })
+                .next();
+            if let Some(available) = available.filter(|&bitrate| bitrate > 0.0) {
+                let per_track = available as u64 / video_tracks as u64;
+                trace!("available video bitrate {available} bps, {per_track} bps per track");
+                self.video_budget.set(per_track.max(1));
+            }
+        }
+    }
+
     /// Returns the currently-cached channel advertisements encoded as a single
     /// framed control-plane message, or `None` if no channels are advertised.
     fn encode_channel_advertisements(&self) -> Option<Bytes> {
@@ -2226,32 +2444,23 @@ impl RemoteAccessSession {
         }
 
         // Collect the per-participant messages, then send them after the locks
-        // are released to minimize lock scope.
-        let participants = self.participant_registry.collect_participants();
-        let to_send: Vec<(Arc<Participant>, Bytes)> = {
-            let subs = self.parameter_subscriptions.read();
-            participants
-                .into_iter()
-                .filter_map(|participant| {
-                    let filtered: Vec<_> = parameters
-                        .iter()
-                        .filter(|p| {
-                            subs.subscribers(&p.name)
-                                .is_some_and(|sids| sids.contains(participant.participant_sid()))
-                        })
-                        .cloned()
-                        .collect();
-
-                    if filtered.is_empty() {
-                        return None;
-                    }
-
-                    let msg =
-                        ParameterValues::new(filtered.into_iter().filter(|p| p.value.is_some()));
-                    Some((participant, encode_json_message(&msg)))
-                })
-                .collect()
-        };
+        // are released to minimize lock scope. Only the subscribers of each
+        // published parameter are visited.
+        let mut updates = self.parameter_subscriptions.read().fan_out(&parameters);
+        if updates.is_empty() {
+            return;
+        }
+        let to_send: Vec<(Arc<Participant>, Bytes)> = self
+            .participant_registry
+            .collect_participants()
+            .into_iter()
+            .filter_map(|participant| {
+                let parameters = updates.remove(participant.participant_sid())?;
+                let msg =
+                    ParameterValues::new(parameters.into_iter().filter(|p| p.value.is_some()));
+                Some((participant, encode_json_message(&msg)))
+            })
+            .collect();
 
         for (participant, data) in to_send {
             participant.send_control(data);
@@ -2329,7 +2538,23 @@ impl RemoteAccessSession {
     /// Replaces the connection graph and sends updates to subscribed participants.
     pub(super) fn replace_connection_graph(&self, replacement_graph: ConnectionGraph) {
         let mut graph = self.connection_graph.lock();
-        let update = graph.update(replacement_graph);
+        graph.replace(replacement_graph);
+        self.send_connection_graph_changes(&mut graph);
+    }
+
+    /// Applies a patch to the connection graph and sends updates to subscribed participants.
+    pub(super) fn update_connection_graph(&self, patch: ConnectionGraphPatch) {
+        let mut graph = self.connection_graph.lock();
+        graph.apply(patch);
+        self.send_connection_graph_changes(&mut graph);
+    }
+
+    /// Sends the connection graph changes since the last update to subscribed participants.
+    fn send_connection_graph_changes(&self, graph: &mut ConnectionGraph) {
+        if !graph.has_changes() {
+            return;
+        }
+        let update = graph.take_update();
         let encoded = encode_json_message(&update);
         for participant in self.participant_registry.collect_participants() {
             if graph.is_subscriber(participant.client_id()) {
@@ -2411,10 +2636,15 @@ impl RemoteAccessSession {
 
         for (channel_id, input_schema) in to_start {
             let video_source = NativeVideoSource::default();
+            let adaptation = self.video_limits.map(|limits| VideoAdaptation {
+                limits,
+                budget: self.video_budget.clone(),
+            });
             let publisher = Arc::new(VideoPublisher::new(
                 video_source.clone(),
                 input_schema,
                 self.video_metadata_tx.clone(),
+                adaptation,
             ));
             let expected_publisher = publisher.clone();
 
@@ -2434,10 +2664,12 @@ impl RemoteAccessSession {
                 let local_track = LocalTrack::Video(track);
                 // See `DEFAULT_VIDEO_CODEC` for the rationale behind the per-OS default.
                 //
-                // Disable simulcast. We expect viewers will be mostly homogenous, and
-                // simulcast is a lot of work for the robot without much to gain.
-                // We observed that nvenc aggressively enforces the target bitrate,
-                // and combined with simulcast results in very low quality video with compression artifacts.
+                // This track is shared by every participant subscribed to the channel; the SFU
+                // forwards it, so the frames are only encoded once. Simulcast is off unless
+                // requested: we expect viewers will be mostly homogenous, and simulcast is a lot
+                // of work for the robot without much to gain. We observed that nvenc aggressively
+                // enforces the target bitrate, and combined with simulcast results in very low
+                // quality video with compression artifacts.
                 let video_codec = session.video_codec_override.unwrap_or(DEFAULT_VIDEO_CODEC);
                 let video_encoder_backend = session.video_encoder;
                 debug!(
@@ -2447,7 +2679,11 @@ impl RemoteAccessSession {
                 let publish_options = TrackPublishOptions {
                     video_codec,
                     video_encoder: video_encoder_backend.into(),
-                    simulcast: false,
+                    video_encoding: session.video_limits.map(|limits| VideoEncoding {
+                        max_bitrate: limits.max_bitrate,
+                        max_framerate: limits.max_framerate,
+                    }),
+                    simulcast: session.video_simulcast,
                     ..Default::default()
                 };
                 match local_participant
@@ -2538,6 +2774,8 @@ impl RemoteAccessSession {
                 *channel_id,
                 self.cancellation_token.clone(),
                 self.max_data_track_message_size,
+                self.max_fragmented_message_size,
+                self.pack_linger,
             );
             self.channel_registry
                 .write()
@@ -2558,6 +2796,8 @@ mod tests {
     use std::collections::HashSet;
 
     use super::*;
+    use crate::MemoryPool;
+    use crate::memory_budget::MemoryAccount;
     use crate::protocol::v2::server::FetchAssetResponse;
     use crate::remote_common::fetch_asset::{
         AssetHandler, AsyncAssetHandlerFn, BlockingAssetHandlerFn,
@@ -2799,7 +3039,8 @@ mod tests {
             test_sid("flush-test"),
             0,
             ParticipantWriter::Test(writer.clone()),
-            DEFAULT_MESSAGE_BACKLOG_SIZE,
+            BacklogOptions::new(DEFAULT_MESSAGE_BACKLOG_SIZE),
+            MemoryAccount::detached(MemoryPool::RemoteAccess),
             pending_resets,
             reset_notify,
             session_cancel,
@@ -2825,6 +3066,52 @@ mod tests {
         assert_eq!(writes[1], Bytes::from_static(b"world"));
     }
 
+    #[tokio::test]
+    async fn flush_task_sends_control_messages_before_data_backlog() {
+        use crate::remote_access::MessageBacklogPolicy;
+        use crate::remote_access::participant::{
+            ParticipantWriter, TestByteStreamWriter, test_sid,
+        };
+
+        let cancel = CancellationToken::new();
+        let writer = Arc::new(TestByteStreamWriter::default());
+        let (participant, handle) = Participant::spawn(
+            ParticipantIdentity("test".to_string()),
+            test_sid("data-backlog"),
+            0,
+            ParticipantWriter::Test(writer.clone()),
+            BacklogOptions {
+                size: 2,
+                bytes: None,
+                policy: MessageBacklogPolicy::DropOldest,
+            },
+            MemoryAccount::detached(MemoryPool::RemoteAccess),
+            Arc::new(parking_lot::Mutex::new(HashSet::new())),
+            Arc::new(tokio::sync::Notify::new()),
+            &cancel,
+        );
+
+        // The data backlog drops its oldest message rather than resetting the participant.
+        for data in [&b"data1"[..], b"data2", b"data3"] {
+            participant.send_data(
+                ChannelId::new(1),
+                &QosProfile::default(),
+                Bytes::from_static(data),
+            );
+        }
+        participant.send_control(Bytes::from_static(b"control"));
+
+        // Let the flush-task drain both queues before dropping the participant.
+        while writer.attempted_writes() < 3 {
+            tokio::task::yield_now().await;
+        }
+        drop(participant);
+        handle.await.unwrap();
+
+        assert_eq!(writer.writes(), vec![&b"control"[..], b"data2", b"data3"]);
+        assert!(!cancel.is_cancelled());
+    }
+
     #[tokio::test]
     async fn flush_task_stops_on_sender_drop() {
         let cancel = CancellationToken::new();
@@ -2897,7 +3184,8 @@ mod tests {
             sid.clone(),
             0,
             ParticipantWriter::Test(writer),
-            DEFAULT_MESSAGE_BACKLOG_SIZE,
+            BacklogOptions::new(DEFAULT_MESSAGE_BACKLOG_SIZE),
+            MemoryAccount::detached(MemoryPool::RemoteAccess),
             pending_resets.clone(),
             reset_notify.clone(),
             &cancel,
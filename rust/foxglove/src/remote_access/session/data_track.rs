@@ -12,6 +12,35 @@ use crate::{ChannelId, Metadata};
 
 const FRAME_HEADER_SIZE: usize = 8; // u16 LE flags + u16 LE data_offset + u32 LE sequence
 
+/// Set in the frame flags when the frame carries one fragment of a larger message.
+///
+/// A fragment frame extends the header with a u16 LE fragment index and a u16 LE fragment count.
+/// The fragments of a message have consecutive sequence numbers, so the sequence number of the
+/// first fragment is the frame's sequence number minus its index. A viewer reassembles a message
+/// once it has received all of its fragments, and discards it if any of them is lost.
+pub(super) const FLAG_FRAGMENT: u16 = 1;
+
+const FRAGMENT_HEADER_SIZE: usize = FRAME_HEADER_SIZE + 4; // + u16 LE index + u16 LE count
+
+/// Set in the frame flags when the frame packs several small messages.
+///
+/// The frame's data is a sequence of entries, each a u32 LE message length and a u64 LE log time
+/// followed by the message. A packed frame takes a single sequence number, and is lost whole.
+pub(super) const FLAG_PACKED: u16 = 2;
+
+const PACKED_ENTRY_HEADER_SIZE: usize = 12; // u32 LE length + u64 LE log_time
+
+/// Largest packed frame, including its header, so that it fits in one data-channel packet.
+const MAX_PACKED_FRAME_SIZE: usize = super::MIN_DATA_TRACK_MESSAGE_SIZE;
+
+/// Returns true if a message is small enough to be packed.
+///
+/// A message is packed if at least two like it fit in a packed frame; larger messages would gain
+/// little from packing, and only wait for the linger time.
+fn is_packable(len: usize) -> bool {
+    PACKED_ENTRY_HEADER_SIZE + len <= (MAX_PACKED_FRAME_SIZE - FRAME_HEADER_SIZE) / 2
+}
+
 /// Minimum interval between oversized-drop warnings for a track.
 ///
 /// Drops between warnings are counted and folded into the next report.
@@ -40,17 +69,22 @@ pub(crate) struct DataTrack {
     /// Handle to the spawned publish task.
     task: Option<JoinHandle<()>>,
     /// Per-track monotonic sequence number for packet loss detection.
-    sequence: AtomicU32,
+    sequence: Arc<AtomicU32>,
     /// Throttles debug log messages when data track messages are dropped.
     drop_throttler: parking_lot::Mutex<crate::throttler::Throttler>,
     /// Per-message size limit in bytes; messages larger than this are dropped
     /// before publish. See `DEFAULT_MAX_DATA_TRACK_MESSAGE_SIZE` for the rationale.
     max_message_size: usize,
+    /// If set, messages larger than `max_message_size` and up to this size are split into
+    /// fragments of at most `max_message_size` bytes rather than dropped.
+    max_fragmented_message_size: Option<usize>,
     /// Oversized messages dropped since the last warning was logged; reset to
     /// zero each time the throttled warning fires.
     oversized_dropped: AtomicU64,
     /// Throttles warnings emitted when oversized messages are dropped.
     oversized_throttler: parking_lot::Mutex<crate::throttler::Throttler>,
+    /// If set, packs small messages into shared frames.
+    packer: Option<Arc<Packer>>,
 }
 
 impl DataTrack {
@@ -63,17 +97,37 @@ impl DataTrack {
     /// in-flight `publish_data_track` calls during session teardown. The per-track
     /// [`close`](Self::close) token only stops retry attempts between calls, so a
     /// normal channel removal never yanks a publish out from under the SFU.
+    ///
+    /// If `pack_linger` is set, small messages are packed into shared frames, which are sent when
+    /// full or once their first message has waited for `pack_linger`.
     pub fn publish(
         runtime: &Handle,
         local_participant: LocalParticipant,
         channel_id: ChannelId,
         session_cancel: CancellationToken,
         max_message_size: usize,
+        max_fragmented_message_size: Option<usize>,
+        pack_linger: Option<Duration>,
     ) -> Self {
         let track = Arc::new(OnceLock::new());
         let track_clone = Arc::clone(&track);
         let close = CancellationToken::new();
         let close_clone = close.clone();
+        let sequence = Arc::new(AtomicU32::new(0));
+        let packer = pack_linger.map(|linger| {
+            Arc::new(Packer {
+                channel_id,
+                linger,
+                runtime: runtime.clone(),
+                track: Arc::clone(&track),
+                sequence: Arc::clone(&sequence),
+                close: close.clone(),
+                buffer: parking_lot::Mutex::default(),
+                drop_throttler: parking_lot::Mutex::new(crate::throttler::Throttler::new(
+                    Duration::from_secs(30),
+                )),
+            })
+        });
         let name = format!("data-ch-{}", u64::from(channel_id));
 
         let task = runtime.spawn(async move {
@@ -121,23 +175,34 @@ impl DataTrack {
             track,
             close,
             task: Some(task),
-            sequence: AtomicU32::new(0),
+            sequence,
             drop_throttler: parking_lot::Mutex::new(crate::throttler::Throttler::new(
                 Duration::from_secs(30),
             )),
             max_message_size,
+            max_fragmented_message_size,
             oversized_dropped: AtomicU64::new(0),
             oversized_throttler: parking_lot::Mutex::new(crate::throttler::Throttler::new(
                 OVERSIZED_WARN_INTERVAL,
             )),
+            packer,
         }
     }
 
+    /// Returns the largest message this track delivers.
+    fn size_limit(&self) -> usize {
+        self.max_fragmented_message_size
+            .map_or(self.max_message_size, |max| max.max(self.max_message_size))
+    }
+
     /// Build a sequenced frame and push it to the data track.
     ///
-    /// Drops the message (with a throttled warning) if it exceeds
-    /// [`max_message_size`](Self::max_message_size), or with a throttled debug
-    /// log if the track is not ready or full.
+    /// Messages larger than `max_message_size` are split into fragment frames
+    /// if fragmentation is enabled and the message is within
+    /// `max_fragmented_message_size`. Small messages are packed into a shared
+    /// frame if packing is enabled. Drops the message (with a throttled
+    /// warning) if it exceeds the limit, or with a throttled debug log if the
+    /// track is not ready or full.
     ///
     /// Returns `Err(OversizedDropReport)` only when an oversized-drop warning
     /// fires. All other delivered or dropped messages return `Ok(())`.
@@ -147,43 +212,50 @@ impl DataTrack {
         msg: &[u8],
         metadata: &Metadata,
     ) -> Result<(), OversizedDropReport> {
-        if msg.len() > self.max_message_size {
+        let size_limit = self.size_limit();
+        if msg.len() > size_limit {
             if self.oversized_throttler.lock().try_acquire() {
                 let dropped = 1 + self.oversized_dropped.swap(0, Ordering::Relaxed);
                 warn!(
                     "dropping {}-byte message on channel {channel_id:?}: exceeds \
                      data-track limit of {} bytes ({dropped} dropped since last warning)",
                     msg.len(),
-                    self.max_message_size
+                    size_limit
                 );
                 return Err(OversizedDropReport {
                     dropped_since_last: dropped,
-                    size_limit: self.max_message_size,
+                    size_limit,
                 });
             }
             self.oversized_dropped.fetch_add(1, Ordering::Relaxed);
             return Ok(());
         }
+        if let Some(packer) = &self.packer {
+            if is_packable(msg.len()) {
+                packer.push(msg, metadata.log_time);
+                return Ok(());
+            }
+            // Send the pending small messages first, so that messages are sent in order.
+            packer.flush();
+        }
         let Some(track) = self.track.get() else {
             if self.drop_throttler.lock().try_acquire() {
                 debug!("data track not ready, dropping message for channel {channel_id:?}");
             }
             return Ok(());
         };
-        let seq = self.sequence.fetch_add(1, Ordering::Relaxed);
-        let mut payload = Vec::with_capacity(FRAME_HEADER_SIZE + msg.len());
-        // flags is 0, it's reserved for future use
-        payload.extend_from_slice(&0u16.to_le_bytes());
-        // data_offset is always FRAME_HEADER_SIZE, but this is part of the frame
-        // so that we can more easily add fields here without breaking old clients.
-        payload.extend_from_slice(&(FRAME_HEADER_SIZE as u16).to_le_bytes()); // data_offset
-        payload.extend_from_slice(&seq.to_le_bytes());
-        payload.extend_from_slice(msg);
-        let frame = DataTrackFrame::new(payload).with_user_timestamp(metadata.log_time);
-        if let Err(e) = track.try_push(frame)
-            && self.drop_throttler.lock().try_acquire()
-        {
-            debug!("data track message dropped for channel {channel_id:?}: {e:?}");
+        let fragments = msg.len().div_ceil(self.max_message_size).max(1);
+        // Fragments take consecutive sequence numbers, so that viewers can group them.
+        let seq = self.sequence.fetch_add(fragments as u32, Ordering::Relaxed);
+        for payload in build_frames(seq, msg, self.max_message_size) {
+            let frame = DataTrackFrame::new(payload).with_user_timestamp(metadata.log_time);
+            if let Err(e) = track.try_push(frame) {
+                // The rest of the message is useless to the viewer once a fragment is dropped.
+                if self.drop_throttler.lock().try_acquire() {
+                    debug!("data track message dropped for channel {channel_id:?}: {e:?}");
+                }
+                break;
+            }
         }
         Ok(())
     }
@@ -197,6 +269,9 @@ impl DataTrack {
     /// Close the data track: stop retrying, wait for any in-flight publish to
     /// complete, then unpublish the track if it was successfully published.
     pub async fn close(&mut self) {
+        if let Some(packer) = &self.packer {
+            packer.flush();
+        }
         self.close.cancel();
         if let Some(task) = self.task.take() {
             _ = task.await;
@@ -208,6 +283,157 @@ impl DataTrack {
     }
 }
 
+/// Builds the frames for a message, starting at sequence number `seq`.
+///
+/// A message of up to `max_frame_payload` bytes is sent as a single frame. A larger message is
+/// split into fragments of at most `max_frame_payload` bytes, each in its own frame with
+/// [`FLAG_FRAGMENT`] set.
+fn build_frames(seq: u32, msg: &[u8], max_frame_payload: usize) -> Vec<Vec<u8>> {
+    if msg.len() <= max_frame_payload {
+        let mut payload = Vec::with_capacity(FRAME_HEADER_SIZE + msg.len());
+        // flags is 0 for a whole message
+        payload.extend_from_slice(&0u16.to_le_bytes());
+        // data_offset is always FRAME_HEADER_SIZE, but this is part of the frame
+        // so that we can more easily add fields here without breaking old clients.
+        payload.extend_from_slice(&(FRAME_HEADER_SIZE as u16).to_le_bytes()); // data_offset
+        payload.extend_from_slice(&seq.to_le_bytes());
+        payload.extend_from_slice(msg);
+        return vec![payload];
+    }
+    let chunks = msg.chunks(max_frame_payload);
+    let count = chunks.len();
+    debug_assert!(count <= usize::from(u16::MAX));
+    chunks
+        .enumerate()
+        .map(|(index, chunk)| {
+            let mut payload = Vec::with_capacity(FRAGMENT_HEADER_SIZE + chunk.len());
+            payload.extend_from_slice(&FLAG_FRAGMENT.to_le_bytes());
+            payload.extend_from_slice(&(FRAGMENT_HEADER_SIZE as u16).to_le_bytes());
+            payload.extend_from_slice(&seq.wrapping_add(index as u32).to_le_bytes());
+            payload.extend_from_slice(&(index as u16).to_le_bytes());
+            payload.extend_from_slice(&(count as u16).to_le_bytes());
+            payload.extend_from_slice(chunk);
+            payload
+        })
+        .collect()
+}
+
+/// Small messages waiting to be sent in a packed frame.
+#[derive(Default)]
+struct PackBuffer {
+    /// The packed frame being built, or empty if no messages are pending.
+    frame: Vec<u8>,
+    /// Log time of the first pending message, which is used as the frame's timestamp.
+    log_time: u64,
+    /// Incremented each time the frame is taken, so that a linger timer can tell whether the
+    /// messages it was started for are still pending.
+    generation: u64,
+}
+
+impl PackBuffer {
+    fn is_empty(&self) -> bool {
+        self.frame.is_empty()
+    }
+
+    /// Returns true if a message of `len` bytes fits in the pending frame.
+    fn fits(&self, len: usize) -> bool {
+        let used = self.frame.len().max(FRAME_HEADER_SIZE);
+        used + PACKED_ENTRY_HEADER_SIZE + len <= MAX_PACKED_FRAME_SIZE
+    }
+
+    /// Appends a message to the pending frame. The caller checks that it [`fits`](Self::fits).
+    fn push(&mut self, msg: &[u8], log_time: u64) {
+        if self.frame.is_empty() {
+            self.frame.reserve(MAX_PACKED_FRAME_SIZE);
+            self.frame.extend_from_slice(&FLAG_PACKED.to_le_bytes());
+            self.frame
+                .extend_from_slice(&(FRAME_HEADER_SIZE as u16).to_le_bytes());
+            // The sequence number is filled in when the frame is taken.
+            self.frame.extend_from_slice(&0u32.to_le_bytes());
+            self.log_time = log_time;
+        }
+        self.frame
+            .extend_from_slice(&(msg.len() as u32).to_le_bytes());
+        self.frame.extend_from_slice(&log_time.to_le_bytes());
+        self.frame.extend_from_slice(msg);
+    }
+
+    /// Takes the pending frame with sequence number `seq`, along with its timestamp.
+    fn take(&mut self, seq: u32) -> (Vec<u8>, u64) {
+        self.generation += 1;
+        let mut frame = std::mem::take(&mut self.frame);
+        frame[4..FRAME_HEADER_SIZE].copy_from_slice(&seq.to_le_bytes());
+        (frame, self.log_time)
+    }
+}
+
+/// Packs the small messages of a data track into shared frames.
+struct Packer {
+    channel_id: ChannelId,
+    /// How long the first message of a frame waits for others before the frame is sent.
+    linger: Duration,
+    runtime: Handle,
+    track: Arc<OnceLock<LocalDataTrack>>,
+    sequence: Arc<AtomicU32>,
+    close: CancellationToken,
+    buffer: parking_lot::Mutex<PackBuffer>,
+    drop_throttler: parking_lot::Mutex<crate::throttler::Throttler>,
+}
+
+impl Packer {
+    /// Adds a message to the pending frame, sending the frame first if the message doesn't fit.
+    ///
+    /// Starts a linger timer when the message is the first of its frame.
+    fn push(self: &Arc<Self>, msg: &[u8], log_time: u64) {
+        let mut buffer = self.buffer.lock();
+        if !buffer.fits(msg.len()) {
+            self.send(&mut buffer);
+        }
+        let first = buffer.is_empty();
+        buffer.push(msg, log_time);
+        if first {
+            let generation = buffer.generation;
+            let packer = Arc::clone(self);
+            self.runtime.spawn(async move {
+                tokio::time::sleep(packer.linger).await;
+                if packer.close.is_cancelled() {
+                    return;
+                }
+                let mut buffer = packer.buffer.lock();
+                if buffer.generation == generation {
+                    packer.send(&mut buffer);
+                }
+            });
+        }
+    }
+
+    /// Sends the pending frame, if any.
+    fn flush(&self) {
+        self.send(&mut self.buffer.lock());
+    }
+
+    fn send(&self, buffer: &mut PackBuffer) {
+        if buffer.is_empty() {
+            return;
+        }
+        let seq = self.sequence.fetch_add(1, Ordering::Relaxed);
+        let (payload, log_time) = buffer.take(seq);
+        let channel_id = self.channel_id;
+        let Some(track) = self.track.get() else {
+            if self.drop_throttler.lock().try_acquire() {
+                debug!("data track not ready, dropping messages for channel {channel_id:?}");
+            }
+            return;
+        };
+        let frame = DataTrackFrame::new(payload).with_user_timestamp(log_time);
+        if let Err(e) = track.try_push(frame) {
+            if self.drop_throttler.lock().try_acquire() {
+                debug!("packed data track messages dropped for channel {channel_id:?}: {e:?}");
+            }
+        }
+    }
+}
+
 impl Drop for DataTrack {
     fn drop(&mut self) {
         self.close.cancel();
@@ -221,27 +447,147 @@ mod tests {
     impl DataTrack {
         /// Builds a `DataTrack` with no live LiveKit track, so the size gate in
         /// [`log`](Self::log) can be exercised without a room or participant.
-        fn for_test(max_message_size: usize) -> Self {
+        fn for_test(max_message_size: usize, max_fragmented_message_size: Option<usize>) -> Self {
             Self {
                 track: Arc::new(OnceLock::new()),
                 close: CancellationToken::new(),
                 task: None,
-                sequence: AtomicU32::new(0),
+                sequence: Arc::default(),
                 drop_throttler: parking_lot::Mutex::new(crate::throttler::Throttler::new(
                     Duration::from_secs(30),
                 )),
                 max_message_size,
+                max_fragmented_message_size,
                 oversized_dropped: AtomicU64::new(0),
                 oversized_throttler: parking_lot::Mutex::new(crate::throttler::Throttler::new(
                     OVERSIZED_WARN_INTERVAL,
                 )),
+                packer: None,
             }
         }
     }
 
+    /// Reassembles messages from frames the way a viewer would, discarding messages with
+    /// missing fragments.
+    fn reassemble(frames: &[Vec<u8>]) -> Vec<Vec<u8>> {
+        let mut messages = vec![];
+        let mut pending: Option<(u32, u16, Vec<u8>)> = None;
+        for frame in frames {
+            let flags = u16::from_le_bytes([frame[0], frame[1]]);
+            let data_offset = usize::from(u16::from_le_bytes([frame[2], frame[3]]));
+            let seq = u32::from_le_bytes(frame[4..8].try_into().unwrap());
+            let mut data = &frame[data_offset..];
+            if flags & FLAG_PACKED != 0 {
+                while !data.is_empty() {
+                    let len = u32::from_le_bytes(data[..4].try_into().unwrap()) as usize;
+                    let entry = &data[PACKED_ENTRY_HEADER_SIZE..];
+                    messages.push(entry[..len].to_vec());
+                    data = &entry[len..];
+                }
+                continue;
+            }
+            if flags & FLAG_FRAGMENT == 0 {
+                messages.push(data.to_vec());
+                continue;
+            }
+            let index = u16::from_le_bytes([frame[8], frame[9]]);
+            let count = u16::from_le_bytes([frame[10], frame[11]]);
+            let first_seq = seq.wrapping_sub(u32::from(index));
+            let continues = matches!(
+                &pending,
+                Some((first, next, _)) if *first == first_seq && *next == index
+            );
+            if index == 0 {
+                pending = Some((first_seq, 0, vec![]));
+            } else if !continues {
+                pending = None;
+                continue;
+            }
+            let (_, next, buf) = pending.as_mut().unwrap();
+            *next += 1;
+            buf.extend_from_slice(data);
+            if index + 1 == count {
+                messages.extend(pending.take().map(|(_, _, buf)| buf));
+            }
+        }
+        messages
+    }
+
+    #[test]
+    fn builds_single_frame_for_small_message() {
+        let frames = build_frames(7, b"hello", 16);
+        assert_eq!(frames.len(), 1);
+        assert_eq!(&frames[0][..2], &0u16.to_le_bytes());
+        assert_eq!(&frames[0][4..8], &7u32.to_le_bytes());
+        assert_eq!(reassemble(&frames), vec![b"hello".to_vec()]);
+    }
+
+    #[test]
+    fn fragments_large_message() {
+        let msg: Vec<u8> = (0..100u8).collect();
+        let frames = build_frames(u32::MAX - 1, &msg, 16);
+        assert_eq!(frames.len(), 7);
+        assert!(frames.iter().all(|f| f.len() <= FRAGMENT_HEADER_SIZE + 16));
+        assert_eq!(reassemble(&frames), vec![msg.clone()]);
+
+        // A message with a lost fragment is discarded whole; the next message still arrives.
+        let mut frames = build_frames(0, &msg, 16);
+        frames.remove(3);
+        frames.extend(build_frames(7, b"small", 16));
+        assert_eq!(reassemble(&frames), vec![b"small".to_vec()]);
+    }
+
+    #[test]
+    fn packs_small_messages_into_one_frame() {
+        let mut buffer = PackBuffer::default();
+        let messages: Vec<Vec<u8>> = (0..40u8).map(|i| vec![i; 20]).collect();
+        let mut frames = vec![];
+        for (i, msg) in messages.iter().enumerate() {
+            assert!(is_packable(msg.len()));
+            if !buffer.fits(msg.len()) {
+                frames.push(buffer.take(frames.len() as u32).0);
+            }
+            buffer.push(msg, 100 + i as u64);
+        }
+        frames.push(buffer.take(frames.len() as u32).0);
+        assert!(buffer.is_empty());
+
+        // 37 entries of 32 bytes fit in a packet, along with the frame header.
+        assert_eq!(frames.len(), 2);
+        assert!(frames.iter().all(|f| f.len() <= MAX_PACKED_FRAME_SIZE));
+        assert_eq!(&frames[0][..2], &FLAG_PACKED.to_le_bytes());
+        assert_eq!(&frames[1][4..8], &1u32.to_le_bytes());
+        assert_eq!(&frames[1][12..20], &137u64.to_le_bytes());
+        assert_eq!(reassemble(&frames), messages);
+    }
+
+    #[test]
+    fn only_small_messages_are_packed() {
+        let max = (MAX_PACKED_FRAME_SIZE - FRAME_HEADER_SIZE) / 2 - PACKED_ENTRY_HEADER_SIZE;
+        assert!(is_packable(0));
+        assert!(is_packable(max));
+        assert!(!is_packable(max + 1));
+    }
+
+    #[test]
+    fn fragmentation_raises_size_limit() {
+        let track = DataTrack::for_test(16, Some(64));
+        let channel_id = ChannelId::new(1);
+        let metadata = Metadata::default();
+        assert_eq!(track.log(channel_id, &[0u8; 64], &metadata), Ok(()));
+        assert_eq!(track.oversized_dropped(), 0);
+        assert_eq!(
+            track.log(channel_id, &[0u8; 65], &metadata),
+            Err(OversizedDropReport {
+                dropped_since_last: 1,
+                size_limit: 64,
+            })
+        );
+    }
+
     #[test]
     fn drops_oversized_message_and_counts_it() {
-        let track = DataTrack::for_test(16);
+        let track = DataTrack::for_test(16, None);
         let channel_id = ChannelId::new(1);
         let metadata = Metadata::default();
 
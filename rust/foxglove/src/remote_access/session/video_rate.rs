@@ -0,0 +1,302 @@
+//! Adapts video tracks to the bandwidth available to the gateway.
+//!
+//! libwebrtc's congestion controller estimates the bitrate available on the publisher connection.
+//! The session periodically divides this estimate between its video tracks, and each
+//! [`VideoPublisher`](super::VideoPublisher) picks a resolution and frame rate that fit its share:
+//! it prefers to keep the full resolution and frame rate, then drops to lower rungs of the
+//! resolution ladder, and finally decimates the frame rate.
+
+use std::sync::Arc;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use crate::img2yuv::Yuv420Buffer;
+use crate::remote_access::VideoLimits;
+
+use super::video_track::MIN_VIDEO_DIMENSION;
+
+/// Bits per pixel used to estimate the bitrate needed for a resolution and frame rate.
+///
+/// This is a typical figure for H.264 and VP8 at good quality on camera footage.
+const BITS_PER_PIXEL: f64 = 0.1;
+
+/// Weight of the newest frame interval in the source frame rate estimate.
+const FRAME_RATE_SMOOTHING: f64 = 0.1;
+
+/// The bitrate available to each video track, shared between the session and its publishers.
+#[derive(Debug, Default)]
+pub(crate) struct VideoBudget {
+    /// Available bitrate per video track in bits per second, or 0 if there is no estimate yet.
+    bitrate: AtomicU64,
+}
+
+impl VideoBudget {
+    /// Records the bitrate available to each video track.
+    pub fn set(&self, bitrate: u64) {
+        self.bitrate.store(bitrate, Ordering::Relaxed);
+    }
+
+    /// Returns the bitrate available to each video track, if it has been estimated.
+    pub fn get(&self) -> Option<u64> {
+        match self.bitrate.load(Ordering::Relaxed) {
+            0 => None,
+            bitrate => Some(bitrate),
+        }
+    }
+}
+
+/// The limits and bandwidth budget applied to a video publisher.
+#[derive(Debug, Clone)]
+pub(crate) struct VideoAdaptation {
+    pub limits: VideoLimits,
+    pub budget: Arc<VideoBudget>,
+}
+
+/// The resolution and frame rate a video track should be encoded at.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub(crate) struct VideoTarget {
+    /// Factor by which each dimension of the source frames is divided.
+    pub downscale: u32,
+    /// Maximum frame rate, in frames per second.
+    pub framerate: f64,
+}
+
+/// Picks the largest resolution, then the highest frame rate, whose estimated bitrate fits in
+/// `bitrate`.
+///
+/// Downscaling stops at `limits.max_downscale`, or when a further step would shrink the frame
+/// below the minimum encoder size. The frame rate is never reduced below `limits.min_framerate`.
+pub(crate) fn select_target(
+    limits: &VideoLimits,
+    bitrate: Option<u64>,
+    (width, height): (u32, u32),
+    source_framerate: f64,
+) -> VideoTarget {
+    let max_framerate = source_framerate.min(limits.max_framerate).max(1.0);
+    let budget = bitrate
+        .map_or(limits.max_bitrate, |bitrate| {
+            bitrate.min(limits.max_bitrate)
+        })
+        .max(1) as f64;
+    let required = |downscale: u32, framerate: f64| {
+        let (width, height) = scaled_dimensions((width, height), downscale);
+        f64::from(width) * f64::from(height) * framerate * BITS_PER_PIXEL
+    };
+
+    let can_halve = |downscale: u32| {
+        let (width, height) = scaled_dimensions((width, height), downscale * 2);
+        downscale * 2 <= limits.max_downscale && width.min(height) >= MIN_VIDEO_DIMENSION
+    };
+
+    let mut downscale = 1;
+    while required(downscale, max_framerate) > budget && can_halve(downscale) {
+        downscale *= 2;
+    }
+    let framerate = (max_framerate * budget / required(downscale, max_framerate))
+        .clamp(limits.min_framerate.min(max_framerate), max_framerate);
+    VideoTarget {
+        downscale,
+        framerate,
+    }
+}
+
+/// Returns the even-aligned dimensions of a frame downscaled by `downscale`.
+pub(crate) fn scaled_dimensions((width, height): (u32, u32), downscale: u32) -> (u32, u32) {
+    ((width / downscale) & !1, (height / downscale) & !1)
+}
+
+/// Estimates the frame rate of a video source, and drops frames above a target frame rate.
+#[derive(Debug, Default)]
+pub(crate) struct FrameRateLimiter {
+    /// Timestamp of the previous source frame, in nanoseconds.
+    last_frame_ns: Option<u64>,
+    /// Timestamp of the last frame which was kept, in nanoseconds.
+    last_kept_ns: Option<u64>,
+    /// Smoothed interval between source frames, in nanoseconds.
+    interval_ns: Option<f64>,
+}
+
+impl FrameRateLimiter {
+    /// Records a source frame, returning its estimated frame rate if known.
+    pub fn observe(&mut self, timestamp_ns: u64) -> Option<f64> {
+        if let Some(last) = self.last_frame_ns
+            && timestamp_ns > last
+        {
+            let interval = (timestamp_ns - last) as f64;
+            self.interval_ns = Some(match self.interval_ns {
+                Some(smoothed) => smoothed + FRAME_RATE_SMOOTHING * (interval - smoothed),
+                None => interval,
+            });
+        }
+        self.last_frame_ns = Some(timestamp_ns);
+        self.interval_ns.map(|interval| 1e9 / interval)
+    }
+
+    /// Returns true if a frame at `timestamp_ns` should be kept to stay under `framerate`.
+    pub fn keep(&mut self, timestamp_ns: u64, framerate: f64) -> bool {
+        // Allow some jitter, so that a source running exactly at the target rate isn't decimated.
+        let min_interval = 0.9e9 / framerate;
+        let keep = self
+            .last_kept_ns
+            .is_none_or(|last| timestamp_ns < last || (timestamp_ns - last) as f64 >= min_interval);
+        if keep {
+            self.last_kept_ns = Some(timestamp_ns);
+        }
+        keep
+    }
+}
+
+/// Downscales `src` into `dst` by averaging blocks of `downscale` × `downscale` pixels.
+///
+/// `dst` must have the dimensions returned by [`scaled_dimensions`].
+pub(crate) fn downscale_yuv420(
+    src: &impl Yuv420Buffer,
+    dst: &mut impl Yuv420Buffer,
+    downscale: u32,
+) {
+    let (src_width, src_height) = src.dimensions();
+    let (dst_width, dst_height) = dst.dimensions();
+    let (src_y, src_u, src_v) = src.yuv();
+    let (src_y_stride, src_u_stride, src_v_stride) = src.yuv_strides();
+    let (dst_y_stride, dst_u_stride, dst_v_stride) = dst.yuv_strides();
+    let (dst_y, dst_u, dst_v) = dst.yuv_mut();
+    let factor = downscale as usize;
+    let plane = |stride: u32, width: u32, height: u32| Plane {
+        stride: stride as usize,
+        width: width as usize,
+        height: height as usize,
+    };
+    scale_plane(
+        src_y,
+        plane(src_y_stride, src_width, src_height),
+        dst_y,
+        plane(dst_y_stride, dst_width, dst_height),
+        factor,
+    );
+    let (src_cw, src_ch) = (src_width.div_ceil(2), src_height.div_ceil(2));
+    let (dst_cw, dst_ch) = (dst_width.div_ceil(2), dst_height.div_ceil(2));
+    scale_plane(
+        src_u,
+        plane(src_u_stride, src_cw, src_ch),
+        dst_u,
+        plane(dst_u_stride, dst_cw, dst_ch),
+        factor,
+    );
+    scale_plane(
+        src_v,
+        plane(src_v_stride, src_cw, src_ch),
+        dst_v,
+        plane(dst_v_stride, dst_cw, dst_ch),
+        factor,
+    );
+}
+
+/// The layout of one plane of a YUV buffer.
+#[derive(Clone, Copy)]
+struct Plane {
+    stride: usize,
+    width: usize,
+    height: usize,
+}
+
+fn scale_plane(src: &[u8], src_plane: Plane, dst: &mut [u8], dst_plane: Plane, factor: usize) {
+    for y in 0..dst_plane.height {
+        let rows = (y * factor)..((y + 1) * factor).min(src_plane.height);
+        let dst_row = &mut dst[y * dst_plane.stride..][..dst_plane.width];
+        for (x, out) in dst_row.iter_mut().enumerate() {
+            let cols = (x * factor)..((x + 1) * factor).min(src_plane.width);
+            let mut sum = 0u32;
+            for row in rows.clone() {
+                let src_row = &src[row * src_plane.stride..];
+                sum += src_row[cols.clone()]
+                    .iter()
+                    .map(|&p| u32::from(p))
+                    .sum::<u32>();
+            }
+            let count = (rows.len() * cols.len()).max(1) as u32;
+            *out = (sum / count) as u8;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::img2yuv::Yuv420Vec;
+
+    const HD: (u32, u32) = (1280, 720);
+
+    #[test]
+    fn test_select_target_keeps_720p30_at_3_mbps() {
+        let target = select_target(&VideoLimits::default(), Some(3_000_000), HD, 30.0);
+        assert_eq!(target.downscale, 1);
+        assert_eq!(target.framerate, 30.0);
+    }
+
+    #[test]
+    fn test_select_target_uses_resolution_ladder() {
+        let limits = VideoLimits::default();
+        let target = select_target(&limits, Some(1_000_000), HD, 30.0);
+        assert_eq!(target.downscale, 2);
+        assert_eq!(target.framerate, 30.0);
+
+        // Below the lowest rung, the frame rate is decimated down to the minimum.
+        let target = select_target(&limits, Some(100_000), HD, 30.0);
+        assert_eq!(target.downscale, 4);
+        assert!(target.framerate < 30.0);
+        let target = select_target(&limits, Some(1_000), HD, 30.0);
+        assert_eq!(target.framerate, limits.min_framerate);
+    }
+
+    #[test]
+    fn test_select_target_respects_limits() {
+        let limits = VideoLimits {
+            max_bitrate: 500_000,
+            max_framerate: 15.0,
+            max_downscale: 1,
+            ..VideoLimits::default()
+        };
+        let target = select_target(&limits, Some(10_000_000), HD, 30.0);
+        assert_eq!(target.downscale, 1);
+        assert!(target.framerate < 15.0);
+
+        // Frames are never downscaled below the minimum encoder size.
+        let target = select_target(&VideoLimits::default(), Some(1_000), (40, 40), 30.0);
+        assert_eq!(target.downscale, 2);
+    }
+
+    #[test]
+    fn test_frame_rate_limiter() {
+        let mut limiter = FrameRateLimiter::default();
+        let frame_ns = 1_000_000_000 / 30;
+        let mut kept = 0;
+        for i in 0..30 {
+            let timestamp = i * frame_ns;
+            limiter.observe(timestamp);
+            if limiter.keep(timestamp, 10.0) {
+                kept += 1;
+            }
+        }
+        assert_eq!(kept, 10);
+        let framerate = limiter.observe(30 * frame_ns).unwrap();
+        assert!((framerate - 30.0).abs() < 0.1);
+    }
+
+    #[test]
+    fn test_downscale_yuv420() {
+        let mut src = Yuv420Vec::new(4, 4);
+        let (y, u, v) = src.yuv_mut();
+        for (i, p) in y.iter_mut().enumerate() {
+            // Rows alternate between 0 and 100, so each 2x2 block averages to 50.
+            *p = if (i / 4) % 2 == 0 { 0 } else { 100 };
+        }
+        u.copy_from_slice(&[10, 20, 30, 40]);
+        v.fill(128);
+
+        let mut dst = Yuv420Vec::new(2, 2);
+        downscale_yuv420(&src, &mut dst, 2);
+        let (y, u, v) = dst.yuv();
+        assert_eq!(y, &[50, 50, 50, 50]);
+        assert_eq!(u, &[25]);
+        assert_eq!(v, &[128]);
+    }
+}
@@ -1,5 +1,5 @@
 use std::sync::Arc;
-use std::time::Duration;
+use std::time::{Duration, Instant};
 
 use arc_swap::ArcSwapOption;
 use bytes::Bytes;
@@ -9,9 +9,16 @@ use tokio::sync::watch;
 use tracing::{debug, error, warn};
 
 use crate::RawChannel;
-use crate::img2yuv::{ImageEncoding, ImageMessage, Yuv420Buffer};
+pub(crate) use crate::img2yuv::VideoInputSchema;
+use crate::img2yuv::{
+    DecodeImageError, ImageEncoding, Yuv420Buffer, decode_image_message, detect_video_schema,
+};
 use crate::throttler::Throttler;
 
+use super::video_rate::{
+    FrameRateLimiter, VideoAdaptation, downscale_yuv420, scaled_dimensions, select_target,
+};
+
 /// Minimum width and height (in pixels) that we will hand to the libwebrtc video encoder.
 ///
 /// H.264, VP8, and VP9 all encode in 16×16 macroblocks. Some encoder backends — notably
@@ -20,87 +27,13 @@ use crate::throttler::Throttler;
 /// the process. Other backends (e.g. OpenH264) reject the frame but continue running.
 /// Enforcing this minimum on our side guarantees safe behavior regardless of the codec
 /// backend selected by libwebrtc.
-const MIN_VIDEO_DIMENSION: u32 = 16;
+pub(super) const MIN_VIDEO_DIMENSION: u32 = 16;
 
 /// Interval between throttled warnings for repeatedly-too-small frames on a single track.
 const TOO_SMALL_WARN_INTERVAL: Duration = Duration::from_secs(30);
 
-/// The input schema type for a video-capable channel.
-///
-/// Each variant identifies which message format decoder to use for extracting image data.
-#[derive(Debug, Clone, Copy, PartialEq, Eq)]
-#[allow(clippy::enum_variant_names)]
-pub enum VideoInputSchema {
-    /// `foxglove.CompressedImage` with protobuf encoding.
-    FoxgloveCompressedImage,
-    /// `foxglove.RawImage` with protobuf encoding.
-    FoxgloveRawImage,
-    /// `foxglove.CompressedImage` with json encoding.
-    #[cfg(feature = "img2yuv-json")]
-    FoxgloveJsonCompressedImage,
-    /// `foxglove.RawImage` with json encoding.
-    #[cfg(feature = "img2yuv-json")]
-    FoxgloveJsonRawImage,
-    /// `foxglove.CompressedImage` with flatbuffer encoding.
-    #[cfg(feature = "img2yuv-flatbuffer")]
-    FoxgloveFlatbufferCompressedImage,
-    /// `foxglove.RawImage` with flatbuffer encoding.
-    #[cfg(feature = "img2yuv-flatbuffer")]
-    FoxgloveFlatbufferRawImage,
-    /// `foxglove::CompressedImage` (OMG IDL) with cdr encoding.
-    #[cfg(feature = "img2yuv-omgidl")]
-    FoxgloveOmgidlCompressedImage,
-    /// `foxglove::RawImage` (OMG IDL) with cdr encoding.
-    #[cfg(feature = "img2yuv-omgidl")]
-    FoxgloveOmgidlRawImage,
-    /// ROS 1 `sensor_msgs/CompressedImage` with ros1 encoding.
-    #[cfg(feature = "img2yuv-ros1")]
-    Ros1CompressedImage,
-    /// ROS 1 `sensor_msgs/Image` with ros1 encoding.
-    #[cfg(feature = "img2yuv-ros1")]
-    Ros1Image,
-    /// ROS 2 `sensor_msgs/msg/CompressedImage` with cdr encoding.
-    #[cfg(feature = "img2yuv-ros2")]
-    Ros2CompressedImage,
-    /// ROS 2 `sensor_msgs/msg/Image` with cdr encoding.
-    #[cfg(feature = "img2yuv-ros2")]
-    Ros2Image,
-}
-
-/// Detect the video input schema from an (encoding, schema_name) pair.
-///
-/// Returns `Some(InputSchema)` if the channel carries an image type we can transcode to video.
-fn detect_video_schema(encoding: &str, schema_name: &str) -> Option<VideoInputSchema> {
-    match (encoding, schema_name) {
-        ("protobuf", "foxglove.CompressedImage") => Some(VideoInputSchema::FoxgloveCompressedImage),
-        ("protobuf", "foxglove.RawImage") => Some(VideoInputSchema::FoxgloveRawImage),
-        #[cfg(feature = "img2yuv-json")]
-        ("json", "foxglove.CompressedImage") => Some(VideoInputSchema::FoxgloveJsonCompressedImage),
-        #[cfg(feature = "img2yuv-json")]
-        ("json", "foxglove.RawImage") => Some(VideoInputSchema::FoxgloveJsonRawImage),
-        #[cfg(feature = "img2yuv-flatbuffer")]
-        ("flatbuffer", "foxglove.CompressedImage") => {
-            Some(VideoInputSchema::FoxgloveFlatbufferCompressedImage)
-        }
-        #[cfg(feature = "img2yuv-flatbuffer")]
-        ("flatbuffer", "foxglove.RawImage") => Some(VideoInputSchema::FoxgloveFlatbufferRawImage),
-        #[cfg(feature = "img2yuv-omgidl")]
-        ("cdr", "foxglove::CompressedImage") => {
-            Some(VideoInputSchema::FoxgloveOmgidlCompressedImage)
-        }
-        #[cfg(feature = "img2yuv-omgidl")]
-        ("cdr", "foxglove::RawImage") => Some(VideoInputSchema::FoxgloveOmgidlRawImage),
-        #[cfg(feature = "img2yuv-ros1")]
-        ("ros1", "sensor_msgs/CompressedImage") => Some(VideoInputSchema::Ros1CompressedImage),
-        #[cfg(feature = "img2yuv-ros1")]
-        ("ros1", "sensor_msgs/Image") => Some(VideoInputSchema::Ros1Image),
-        #[cfg(feature = "img2yuv-ros2")]
-        ("cdr", "sensor_msgs/msg/CompressedImage") => Some(VideoInputSchema::Ros2CompressedImage),
-        #[cfg(feature = "img2yuv-ros2")]
-        ("cdr", "sensor_msgs/msg/Image") => Some(VideoInputSchema::Ros2Image),
-        _ => None,
-    }
-}
+/// Interval between summaries of the time spent in each transcoding stage of a track.
+const TIMING_LOG_INTERVAL: Duration = Duration::from_secs(10);
 
 /// Returns the video input schema a channel should be advertised with, or `None` when the channel
 /// is not video-capable or the gateway's `suppress_video_transcode` predicate opts it out
@@ -158,8 +91,8 @@ impl Yuv420Buffer for I420Yuv420 {
 /// Error during video encoding.
 #[derive(Debug, thiserror::Error)]
 enum VideoEncodeError {
-    #[error("failed to decode image message: {0}")]
-    Decode(String),
+    #[error(transparent)]
+    Decode(#[from] DecodeImageError),
     #[error("failed to convert image to YUV420: {0}")]
     YuvConversion(#[from] crate::img2yuv::Error),
     #[error(
@@ -168,6 +101,86 @@ enum VideoEncodeError {
     TooSmall { width: u32, height: u32 },
 }
 
+/// Time spent in each stage of transcoding a frame.
+#[derive(Debug, Default, Clone, Copy, PartialEq)]
+struct StageTimings {
+    /// Decoding the image message.
+    parse: Duration,
+    /// Decompressing the image, if compressed, and converting it to YUV 4:2:0.
+    convert: Duration,
+    /// Downscaling the frame to the resolution adapted to the available bandwidth.
+    scale: Duration,
+    /// Handing the frame to the WebRTC video source.
+    capture: Duration,
+}
+
+impl StageTimings {
+    fn total(&self) -> Duration {
+        self.parse + self.convert + self.scale + self.capture
+    }
+}
+
+/// Mean per-stage timings of the frames transcoded over a logging interval.
+#[derive(Debug, PartialEq)]
+struct TimingSummary {
+    frames: u32,
+    mean: StageTimings,
+    max_total: Duration,
+}
+
+/// Accumulates the per-stage timings of a track's frames over a logging interval.
+struct TimingStats {
+    window_start: Instant,
+    frames: u32,
+    sum: StageTimings,
+    max_total: Duration,
+}
+
+impl TimingStats {
+    fn new(now: Instant) -> Self {
+        Self {
+            window_start: now,
+            frames: 0,
+            sum: StageTimings::default(),
+            max_total: Duration::ZERO,
+        }
+    }
+
+    /// Records a frame's timings, returning a summary once the logging interval has elapsed.
+    fn record(&mut self, timings: &StageTimings, now: Instant) -> Option<TimingSummary> {
+        self.frames += 1;
+        self.sum.parse += timings.parse;
+        self.sum.convert += timings.convert;
+        self.sum.scale += timings.scale;
+        self.sum.capture += timings.capture;
+        self.max_total = self.max_total.max(timings.total());
+        if now.duration_since(self.window_start) < TIMING_LOG_INTERVAL {
+            return None;
+        }
+        let frames = self.frames;
+        let summary = TimingSummary {
+            frames,
+            mean: StageTimings {
+                parse: self.sum.parse / frames,
+                convert: self.sum.convert / frames,
+                scale: self.sum.scale / frames,
+                capture: self.sum.capture / frames,
+            },
+            max_total: self.max_total,
+        };
+        *self = Self::new(now);
+        Some(summary)
+    }
+}
+
+/// A frame which was transcoded and published to a video track.
+struct TranscodedFrame {
+    metadata: VideoMetadata,
+    /// Dimensions of the source image.
+    dimensions: (u32, u32),
+    timings: StageTimings,
+}
+
 /// Publishes video frames to a LiveKit video track.
 ///
 /// Owns a bounded channel and a background processing task. Dropping the publisher
@@ -190,10 +203,14 @@ impl VideoPublisher {
     /// When the background task observes a change in video metadata (encoding or frame_id),
     /// it updates `metadata` and signals via `video_metadata_tx` so the session's sender loop
     /// can re-advertise the channel.
+    ///
+    /// If `adaptation` is set, frames are decimated and downscaled to fit the track's share of
+    /// the available bandwidth.
     pub fn new(
         video_source: NativeVideoSource,
         input_schema: VideoInputSchema,
         video_metadata_tx: watch::Sender<()>,
+        adaptation: Option<VideoAdaptation>,
     ) -> Self {
         let (tx, rx) = flume::bounded::<(Bytes, u64)>(Self::CHANNEL_CAPACITY);
         let metadata: Arc<ArcSwapOption<VideoMetadata>> = Arc::new(ArcSwapOption::empty());
@@ -205,14 +222,49 @@ impl VideoPublisher {
             // Throttles `TooSmall` warnings so a stream of undersized frames doesn't
             // flood the log; other encode errors stay at debug level and are unthrottled.
             let mut too_small_throttler = Throttler::new(TOO_SMALL_WARN_INTERVAL);
+            let mut limiter = FrameRateLimiter::default();
+            // Dimensions of the last transcoded frame, used to pick the next frame's target.
+            let mut source_dimensions = (0, 0);
+            let mut timing_stats = TimingStats::new(Instant::now());
             while let Ok((data, log_time_ns)) = consumer_rx.recv_async().await {
+                let mut downscale = 1;
+                if let Some(adaptation) = &adaptation {
+                    let source_framerate = limiter
+                        .observe(log_time_ns)
+                        .unwrap_or(adaptation.limits.max_framerate);
+                    let target = select_target(
+                        &adaptation.limits,
+                        adaptation.budget.get(),
+                        source_dimensions,
+                        source_framerate,
+                    );
+                    if !limiter.keep(log_time_ns, target.framerate) {
+                        continue;
+                    }
+                    downscale = target.downscale;
+                }
                 let source = source.clone();
                 let result = tokio::task::spawn_blocking(move || {
-                    transcode_and_publish(input_schema, &source, &data, log_time_ns)
+                    transcode_and_publish(input_schema, &source, &data, log_time_ns, downscale)
                 })
                 .await;
                 match result {
-                    Ok(Ok(new_metadata)) => {
+                    Ok(Ok(frame)) => {
+                        source_dimensions = frame.dimensions;
+                        if let Some(summary) = timing_stats.record(&frame.timings, Instant::now()) {
+                            debug!(
+                                encoding = frame.metadata.encoding.as_str(),
+                                "transcoded {} video frames, mean per frame: parse {:?}, \
+                                 convert {:?}, scale {:?}, capture {:?}; slowest frame {:?}",
+                                summary.frames,
+                                summary.mean.parse,
+                                summary.mean.convert,
+                                summary.mean.scale,
+                                summary.mean.capture,
+                                summary.max_total,
+                            );
+                        }
+                        let new_metadata = frame.metadata;
                         if last_metadata.as_ref() != Some(&new_metadata) {
                             last_metadata = Some(new_metadata.clone());
                             task_metadata.store(Some(Arc::new(new_metadata)));
@@ -271,15 +323,26 @@ impl VideoPublisher {
 /// Transcode the image message and publish it as a video frame.
 ///
 /// Decodes the original image data, extracts metadata (encoding, frame_id),
-/// encodes it as YUV 4:2:0, and publishes it to the video track.
-/// Returns the extracted metadata on success.
+/// encodes it as YUV 4:2:0, downscales it by `downscale`, and publishes it to the video track.
+/// Returns the extracted metadata, the dimensions of the source image, and the time spent in each
+/// stage on success.
 fn transcode_and_publish(
     input_schema: VideoInputSchema,
     video_source: &NativeVideoSource,
     data: &[u8],
     log_time_ns: u64,
-) -> Result<VideoMetadata, VideoEncodeError> {
+    downscale: u32,
+) -> Result<TranscodedFrame, VideoEncodeError> {
+    let mut timings = StageTimings::default();
+    let mut stage_start = Instant::now();
+    let mut end_stage = |stage: &mut Duration| {
+        let now = Instant::now();
+        *stage = now - stage_start;
+        stage_start = now;
+    };
+
     let image_msg = decode_image_message(input_schema, data)?;
+    end_stage(&mut timings.parse);
 
     let metadata = VideoMetadata {
         encoding: image_msg.image.encoding(),
@@ -299,6 +362,16 @@ fn transcode_and_publish(
         .image
         .to_yuv420(&mut buffer)
         .map_err(VideoEncodeError::YuvConversion)?;
+    end_stage(&mut timings.convert);
+
+    // Step down the resolution ladder, unless that would make the frame too small to encode.
+    let (scaled_width, scaled_height) = scaled_dimensions((width, height), downscale);
+    if downscale > 1 && validate_frame_dimensions(scaled_width, scaled_height).is_ok() {
+        let mut scaled = I420Yuv420(I420Buffer::new(scaled_width, scaled_height));
+        downscale_yuv420(&buffer, &mut scaled, downscale);
+        buffer = scaled;
+    }
+    end_stage(&mut timings.scale);
 
     // Use the image message timestamp, if it had one, otherwise log_time.
     let timestamp_ns = match image_msg.timestamp {
@@ -314,7 +387,12 @@ fn transcode_and_publish(
         buffer: buffer.0,
     };
     video_source.capture_frame(&frame);
-    Ok(metadata)
+    end_stage(&mut timings.capture);
+    Ok(TranscodedFrame {
+        metadata,
+        dimensions: (width, height),
+        timings,
+    })
 }
 
 /// Validates and normalizes frame dimensions for video encoding.
@@ -336,180 +414,10 @@ fn validate_frame_dimensions(width: u32, height: u32) -> Result<(u32, u32), Vide
     Ok((even_width, even_height))
 }
 
-/// Decode raw message bytes into an [`ImageMessage`] based on the input schema.
-fn decode_image_message<'a>(
-    input_schema: VideoInputSchema,
-    data: &'a [u8],
-) -> Result<ImageMessage<'a>, VideoEncodeError> {
-    match input_schema {
-        VideoInputSchema::FoxgloveCompressedImage => {
-            let msg = <crate::messages::CompressedImage as crate::Decode>::decode(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))?;
-            ImageMessage::try_from(msg).map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        VideoInputSchema::FoxgloveRawImage => {
-            let msg = <crate::messages::RawImage as crate::Decode>::decode(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))?;
-            ImageMessage::try_from(msg).map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        #[cfg(feature = "img2yuv-json")]
-        VideoInputSchema::FoxgloveJsonCompressedImage => {
-            crate::img2yuv::json::decode_compressed_image(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        #[cfg(feature = "img2yuv-json")]
-        VideoInputSchema::FoxgloveJsonRawImage => crate::img2yuv::json::decode_raw_image(data)
-            .map_err(|e| VideoEncodeError::Decode(e.to_string())),
-        #[cfg(feature = "img2yuv-flatbuffer")]
-        VideoInputSchema::FoxgloveFlatbufferCompressedImage => {
-            crate::img2yuv::flatbuffer::decode_compressed_image(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        #[cfg(feature = "img2yuv-flatbuffer")]
-        VideoInputSchema::FoxgloveFlatbufferRawImage => {
-            crate::img2yuv::flatbuffer::decode_raw_image(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        #[cfg(feature = "img2yuv-omgidl")]
-        VideoInputSchema::FoxgloveOmgidlCompressedImage => {
-            let msg = crate::img2yuv::omgidl::OmgidlCompressedImage::decode(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))?;
-            ImageMessage::try_from(msg).map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        #[cfg(feature = "img2yuv-omgidl")]
-        VideoInputSchema::FoxgloveOmgidlRawImage => {
-            let msg = crate::img2yuv::omgidl::OmgidlRawImage::decode(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))?;
-            ImageMessage::try_from(msg).map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        #[cfg(feature = "img2yuv-ros1")]
-        VideoInputSchema::Ros1CompressedImage => {
-            let msg = crate::img2yuv::ros1::Ros1CompressedImage::decode(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))?;
-            ImageMessage::try_from(msg).map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        #[cfg(feature = "img2yuv-ros1")]
-        VideoInputSchema::Ros1Image => {
-            let msg = crate::img2yuv::ros1::Ros1Image::decode(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))?;
-            ImageMessage::try_from(msg).map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        #[cfg(feature = "img2yuv-ros2")]
-        VideoInputSchema::Ros2CompressedImage => {
-            let msg = crate::img2yuv::ros2::Ros2CompressedImage::decode(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))?;
-            ImageMessage::try_from(msg).map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-        #[cfg(feature = "img2yuv-ros2")]
-        VideoInputSchema::Ros2Image => {
-            let msg = crate::img2yuv::ros2::Ros2Image::decode(data)
-                .map_err(|e| VideoEncodeError::Decode(e.to_string()))?;
-            ImageMessage::try_from(msg).map_err(|e| VideoEncodeError::Decode(e.to_string()))
-        }
-    }
-}
-
 #[cfg(test)]
 mod tests {
     use super::*;
 
-    #[test]
-    fn test_foxglove_compressed_image() {
-        assert_eq!(
-            detect_video_schema("protobuf", "foxglove.CompressedImage"),
-            Some(VideoInputSchema::FoxgloveCompressedImage)
-        );
-    }
-
-    #[test]
-    fn test_foxglove_raw_image() {
-        assert_eq!(
-            detect_video_schema("protobuf", "foxglove.RawImage"),
-            Some(VideoInputSchema::FoxgloveRawImage)
-        );
-    }
-
-    #[cfg(feature = "img2yuv-ros1")]
-    #[test]
-    fn test_ros1_compressed_image() {
-        assert_eq!(
-            detect_video_schema("ros1", "sensor_msgs/CompressedImage"),
-            Some(VideoInputSchema::Ros1CompressedImage)
-        );
-    }
-
-    #[cfg(feature = "img2yuv-ros1")]
-    #[test]
-    fn test_ros1_image() {
-        assert_eq!(
-            detect_video_schema("ros1", "sensor_msgs/Image"),
-            Some(VideoInputSchema::Ros1Image)
-        );
-    }
-
-    #[cfg(feature = "img2yuv-ros2")]
-    #[test]
-    fn test_ros2_compressed_image() {
-        assert_eq!(
-            detect_video_schema("cdr", "sensor_msgs/msg/CompressedImage"),
-            Some(VideoInputSchema::Ros2CompressedImage)
-        );
-    }
-
-    #[cfg(feature = "img2yuv-ros2")]
-    #[test]
-    fn test_ros2_image() {
-        assert_eq!(
-            detect_video_schema("cdr", "sensor_msgs/msg/Image"),
-            Some(VideoInputSchema::Ros2Image)
-        );
-    }
-
-    #[cfg(feature = "img2yuv-json")]
-    #[test]
-    fn test_foxglove_json_images() {
-        assert_eq!(
-            detect_video_schema("json", "foxglove.CompressedImage"),
-            Some(VideoInputSchema::FoxgloveJsonCompressedImage)
-        );
-        assert_eq!(
-            detect_video_schema("json", "foxglove.RawImage"),
-            Some(VideoInputSchema::FoxgloveJsonRawImage)
-        );
-    }
-
-    #[cfg(feature = "img2yuv-flatbuffer")]
-    #[test]
-    fn test_foxglove_flatbuffer_images() {
-        assert_eq!(
-            detect_video_schema("flatbuffer", "foxglove.CompressedImage"),
-            Some(VideoInputSchema::FoxgloveFlatbufferCompressedImage)
-        );
-        assert_eq!(
-            detect_video_schema("flatbuffer", "foxglove.RawImage"),
-            Some(VideoInputSchema::FoxgloveFlatbufferRawImage)
-        );
-    }
-
-    #[cfg(feature = "img2yuv-omgidl")]
-    #[test]
-    fn test_foxglove_omgidl_images() {
-        assert_eq!(
-            detect_video_schema("cdr", "foxglove::CompressedImage"),
-            Some(VideoInputSchema::FoxgloveOmgidlCompressedImage)
-        );
-        assert_eq!(
-            detect_video_schema("cdr", "foxglove::RawImage"),
-            Some(VideoInputSchema::FoxgloveOmgidlRawImage)
-        );
-    }
-
-    #[test]
-    fn test_unknown_schema() {
-        assert_eq!(detect_video_schema("json", "SomeCustomType"), None);
-        assert_eq!(detect_video_schema("protobuf", "foxglove.Pose"), None);
-    }
-
     fn make_video_channel() -> Arc<RawChannel> {
         use crate::{ChannelBuilder, Context, Schema};
         let ctx = Context::new();
@@ -630,4 +538,31 @@ mod tests {
             VideoEncodeError::YuvConversion(crate::img2yuv::Error::ZeroSized)
         ));
     }
+
+    #[test]
+    fn timing_stats_summarize_each_interval() {
+        let start = Instant::now();
+        let mut stats = TimingStats::new(start);
+        let ms = Duration::from_millis;
+        let fast = StageTimings {
+            parse: ms(1),
+            convert: ms(4),
+            scale: ms(0),
+            capture: ms(1),
+        };
+        let slow = StageTimings {
+            convert: ms(10),
+            ..fast
+        };
+        assert_eq!(stats.record(&fast, start), None);
+        let summary = stats.record(&slow, start + TIMING_LOG_INTERVAL).unwrap();
+        assert_eq!(summary.frames, 2);
+        assert_eq!(summary.mean.parse, ms(1));
+        assert_eq!(summary.mean.convert, ms(7));
+        assert_eq!(summary.max_total, ms(12));
+
+        // The next interval starts afresh.
+        assert_eq!(stats.record(&fast, start + TIMING_LOG_INTERVAL), None);
+        assert_eq!(stats.frames, 1);
+    }
 }
@@ -21,9 +21,9 @@ pub mod service;
 
 #[cfg(any(feature = "websocket", feature = "remote-access"))]
 pub use any_client::AnyClient;
-pub use connection_graph::ConnectionGraph;
+pub use connection_graph::{ConnectionGraph, ConnectionGraphPatch};
 #[cfg(any(feature = "websocket", feature = "remote-access"))]
-pub use fetch_asset::{AssetHandler, AssetResponder};
+pub use fetch_asset::{AssetHandler, AssetResponder, AssetWriter, FileAssetHandler};
 #[cfg(any(feature = "websocket", feature = "remote-access"))]
 pub use parameters::{GetParametersResponder, ParameterHandler, SetParametersResponder};
 
@@ -10,6 +10,9 @@ use crate::protocol::common::server::connection_graph_update::{
 /// A HashMap where the keys are the topic or service name and the value is a set of string ids.
 type MapOfSets = HashMap<String, HashSet<String>>;
 
+/// The publisher and subscriber ids of a topic.
+type TopicIds = (Option<HashSet<String>>, Option<HashSet<String>>);
+
 /// A connection graph describing a topology of subscribers, publishers, topics, and services.
 ///
 /// Connection graph data can be published with
@@ -27,6 +30,98 @@ pub struct ConnectionGraph {
     advertised_services: MapOfSets,
     /// A set of subscribers.
     subscribers: HashSet<ClientId>,
+    /// The topics and services which have changed since the last update was taken, and their
+    /// ids as of the last update.
+    changed_topics: HashMap<String, TopicIds>,
+    changed_services: HashMap<String, Option<HashSet<String>>>,
+}
+
+/// A single change in a [`ConnectionGraphPatch`].
+#[derive(Debug, Clone)]
+enum Change {
+    PublishedTopic(String, HashSet<String>),
+    SubscribedTopic(String, HashSet<String>),
+    AdvertisedService(String, HashSet<String>),
+    RemoveTopic(String),
+    RemoveService(String),
+}
+
+/// A set of changes to a [`ConnectionGraph`].
+///
+/// A patch can be applied to the published connection graph with
+/// [update_connection_graph][crate::WebSocketServerHandle::update_connection_graph]. Unlike
+/// publishing a complete replacement graph, this only touches the topics and services named in
+/// the patch, so it stays cheap for large graphs. Subscribed clients are sent only the topics and
+/// services whose ids actually changed.
+///
+/// Changes are applied in the order they were added to the patch.
+#[derive(Debug, Default, Clone)]
+pub struct ConnectionGraphPatch {
+    changes: Vec<Change>,
+}
+
+impl ConnectionGraphPatch {
+    /// Create a new, empty patch.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Returns true if the patch contains no changes.
+    pub fn is_empty(&self) -> bool {
+        self.changes.is_empty()
+    }
+
+    /// Set a published topic and its associated publisher ids.
+    ///
+    /// Overwrites any existing publisher ids for the topic.
+    pub fn set_published_topic(
+        &mut self,
+        topic: impl Into<String>,
+        publisher_ids: impl IntoIterator<Item = impl Into<String>>,
+    ) {
+        self.changes.push(Change::PublishedTopic(
+            topic.into(),
+            publisher_ids.into_iter().map(|id| id.into()).collect(),
+        ));
+    }
+
+    /// Set a subscribed topic and its associated subscriber ids.
+    ///
+    /// Overwrites any existing subscriber ids for the topic.
+    pub fn set_subscribed_topic(
+        &mut self,
+        topic: impl Into<String>,
+        subscriber_ids: impl IntoIterator<Item = impl Into<String>>,
+    ) {
+        self.changes.push(Change::SubscribedTopic(
+            topic.into(),
+            subscriber_ids.into_iter().map(|id| id.into()).collect(),
+        ));
+    }
+
+    /// Set an advertised service and its associated provider ids.
+    ///
+    /// Overwrites any existing provider ids for the service.
+    pub fn set_advertised_service(
+        &mut self,
+        service: impl Into<String>,
+        provider_ids: impl IntoIterator<Item = impl Into<String>>,
+    ) {
+        self.changes.push(Change::AdvertisedService(
+            service.into(),
+            provider_ids.into_iter().map(|id| id.into()).collect(),
+        ));
+    }
+
+    /// Remove a topic, along with its publishers and subscribers.
+    pub fn remove_topic(&mut self, topic: impl Into<String>) {
+        self.changes.push(Change::RemoveTopic(topic.into()));
+    }
+
+    /// Remove a service, along with its providers.
+    pub fn remove_service(&mut self, service: impl Into<String>) {
+        self.changes.push(Change::RemoveService(service.into()));
+    }
 }
 
 impl ConnectionGraph {
@@ -191,11 +286,160 @@ impl ConnectionGraph {
     ///
     /// Returns a `ConnectionGraphUpdate` message describing the delta update.
     pub(crate) fn update(&mut self, new: ConnectionGraph) -> ConnectionGraphUpdate {
-        let diff = self.diff(&new);
-        self.published_topics = new.published_topics;
-        self.subscribed_topics = new.subscribed_topics;
-        self.advertised_services = new.advertised_services;
-        diff
+        self.replace(new);
+        self.take_update()
+    }
+
+    /// Replaces the connection graph content, recording the topics and services which changed.
+    ///
+    /// The set of subscribers is not modified.
+    pub(crate) fn replace(&mut self, new: ConnectionGraph) {
+        let old_published = std::mem::replace(&mut self.published_topics, new.published_topics);
+        let old_subscribed = std::mem::replace(&mut self.subscribed_topics, new.subscribed_topics);
+        let old_services =
+            std::mem::replace(&mut self.advertised_services, new.advertised_services);
+
+        let topics: HashSet<&String> = old_published
+            .keys()
+            .chain(old_subscribed.keys())
+            .chain(self.published_topics.keys())
+            .chain(self.subscribed_topics.keys())
+            .collect();
+        for name in topics {
+            let before = (old_published.get(name), old_subscribed.get(name));
+            if before
+                != (
+                    self.published_topics.get(name),
+                    self.subscribed_topics.get(name),
+                )
+            {
+                self.changed_topics
+                    .entry(name.clone())
+                    .or_insert_with(|| (before.0.cloned(), before.1.cloned()));
+            }
+        }
+
+        let services: HashSet<&String> = old_services
+            .keys()
+            .chain(self.advertised_services.keys())
+            .collect();
+        for name in services {
+            let before = old_services.get(name);
+            if before != self.advertised_services.get(name) {
+                self.changed_services
+                    .entry(name.clone())
+                    .or_insert_with(|| before.cloned());
+            }
+        }
+    }
+
+    /// Applies a patch to the connection graph, recording the topics and services which changed.
+    ///
+    /// The set of subscribers is not modified.
+    pub(crate) fn apply(&mut self, patch: ConnectionGraphPatch) {
+        for change in patch.changes {
+            match change {
+                Change::PublishedTopic(name, ids) => {
+                    self.record_topic(&name);
+                    self.published_topics.insert(name, ids);
+                }
+                Change::SubscribedTopic(name, ids) => {
+                    self.record_topic(&name);
+                    self.subscribed_topics.insert(name, ids);
+                }
+                Change::AdvertisedService(name, ids) => {
+                    self.record_service(&name);
+                    self.advertised_services.insert(name, ids);
+                }
+                Change::RemoveTopic(name) => {
+                    self.record_topic(&name);
+                    self.published_topics.remove(&name);
+                    self.subscribed_topics.remove(&name);
+                }
+                Change::RemoveService(name) => {
+                    self.record_service(&name);
+                    self.advertised_services.remove(&name);
+                }
+            }
+        }
+    }
+
+    /// Records the ids of a topic before it is first changed since the last update.
+    fn record_topic(&mut self, name: &str) {
+        if !self.changed_topics.contains_key(name) {
+            let before = (
+                self.published_topics.get(name).cloned(),
+                self.subscribed_topics.get(name).cloned(),
+            );
+            self.changed_topics.insert(name.to_string(), before);
+        }
+    }
+
+    /// Records the ids of a service before it is first changed since the last update.
+    fn record_service(&mut self, name: &str) {
+        if !self.changed_services.contains_key(name) {
+            let before = self.advertised_services.get(name).cloned();
+            self.changed_services.insert(name.to_string(), before);
+        }
+    }
+
+    /// Returns true if the graph has changed since the last update was taken.
+    pub(crate) fn has_changes(&self) -> bool {
+        !self.changed_topics.is_empty() || !self.changed_services.is_empty()
+    }
+
+    /// Returns a `ConnectionGraphUpdate` message describing the changes since the last update
+    /// was taken.
+    ///
+    /// Like [`Self::diff`], this only includes the topics and services whose ids changed. Topics
+    /// and services which were changed and then changed back are omitted.
+    pub(crate) fn take_update(&mut self) -> ConnectionGraphUpdate {
+        let mut update = ConnectionGraphUpdate::default();
+        for (name, (published_before, subscribed_before)) in
+            std::mem::take(&mut self.changed_topics)
+        {
+            let published = self.published_topics.get(&name);
+            let subscribed = self.subscribed_topics.get(&name);
+            if published.is_none() && subscribed.is_none() {
+                if published_before.is_some() || subscribed_before.is_some() {
+                    update.removed_topics.push(name);
+                }
+                continue;
+            }
+            if let Some(publisher_ids) = published
+                && Some(publisher_ids) != published_before.as_ref()
+            {
+                update.published_topics.push(PublishedTopic {
+                    name: name.clone(),
+                    publisher_ids: publisher_ids.iter().cloned().collect(),
+                });
+            }
+            if let Some(subscriber_ids) = subscribed
+                && Some(subscriber_ids) != subscribed_before.as_ref()
+            {
+                update.subscribed_topics.push(SubscribedTopic {
+                    name,
+                    subscriber_ids: subscriber_ids.iter().cloned().collect(),
+                });
+            }
+        }
+        for (name, provider_ids_before) in std::mem::take(&mut self.changed_services) {
+            match self.advertised_services.get(&name) {
+                Some(provider_ids) if Some(provider_ids) != provider_ids_before.as_ref() => {
+                    update.advertised_services.push(AdvertisedService {
+                        name,
+                        provider_ids: provider_ids.iter().cloned().collect(),
+                    });
+                }
+                Some(_) => (),
+                None => {
+                    if provider_ids_before.is_some() {
+                        update.removed_services.push(name);
+                    }
+                }
+            }
+        }
+        update
     }
 }
 
@@ -346,4 +590,66 @@ mod tests {
             }
         );
     }
+
+    #[test]
+    fn test_patch() {
+        let mut graph = ConnectionGraph::new();
+        graph.set_published_topic("topic1", ["publisher1"]);
+        graph.set_subscribed_topic("topic1", ["subscriber1"]);
+        graph.set_published_topic("topic2", ["publisher2"]);
+        graph.set_advertised_service("service1", ["provider1"]);
+        graph.take_update();
+
+        let mut patch = ConnectionGraphPatch::new();
+        // Unchanged ids are not sent.
+        patch.set_published_topic("topic1", ["publisher1"]);
+        // Only the final state of a topic which is changed several times is sent.
+        patch.set_subscribed_topic("topic2", ["subscriber1"]);
+        patch.remove_topic("topic2");
+        patch.set_subscribed_topic("topic2", ["subscriber2"]);
+        // A topic which is added and removed again is not sent.
+        patch.set_published_topic("topic3", ["publisher3"]);
+        patch.remove_topic("topic3");
+        patch.remove_service("service1");
+        patch.set_advertised_service("service2", ["provider2"]);
+        graph.apply(patch);
+        assert!(graph.has_changes());
+
+        let mut update = graph.take_update();
+        update.published_topics.sort_by(|a, b| a.name.cmp(&b.name));
+        assert_eq!(
+            update,
+            ConnectionGraphUpdate {
+                published_topics: vec![],
+                subscribed_topics: vec![SubscribedTopic::new("topic2", ["subscriber2"])],
+                advertised_services: vec![AdvertisedService::new("service2", ["provider2"])],
+                removed_topics: vec![],
+                removed_services: vec!["service1".into()],
+            }
+        );
+        assert!(!graph.has_changes());
+        assert_eq!(graph.take_update(), ConnectionGraphUpdate::default());
+    }
+
+    #[test]
+    fn test_changes_accumulate_until_taken() {
+        let mut graph = ConnectionGraph::new();
+        let mut patch = ConnectionGraphPatch::new();
+        patch.set_published_topic("topic1", ["publisher1"]);
+        graph.apply(patch);
+
+        let mut replacement = ConnectionGraph::new();
+        replacement.set_published_topic("topic1", ["publisher2"]);
+        replacement.set_advertised_service("service1", ["provider1"]);
+        graph.replace(replacement);
+
+        assert_eq!(
+            graph.take_update(),
+            ConnectionGraphUpdate {
+                published_topics: vec![PublishedTopic::new("topic1", ["publisher2"])],
+                advertised_services: vec![AdvertisedService::new("service1", ["provider1"])],
+                ..Default::default()
+            }
+        );
+    }
 }
@@ -1,12 +1,18 @@
 //! Shared asset-fetching primitives.
 
+use std::collections::{BTreeMap, HashMap};
 use std::fmt::Display;
 use std::future::Future;
 use std::sync::Arc;
 
+use bytes::Bytes;
+
 use crate::remote_common::AnyClient;
 use crate::remote_common::semaphore::SemaphoreGuard;
 
+mod file;
+pub use file::FileAssetHandler;
+
 /// Internal trait implemented by each transport's `Client` type so that [`AnyClient`] can
 /// dispatch asset responses without exposing the per-transport surface.
 pub(crate) trait SendAssetResponse {
@@ -65,6 +71,8 @@ where
 pub struct AssetResponder {
     client: AnyClient,
     inner: Option<AssetResponderInner>,
+    /// The cache which successful responses are stored in, and the URI they are stored under.
+    cache: Option<(Arc<AssetCache>, String)>,
 }
 
 impl AssetResponder {
@@ -76,6 +84,21 @@ impl AssetResponder {
                 request_id,
                 _guard: guard,
             }),
+            cache: None,
+        }
+    }
+
+    /// Stores a successful response in the cache, under the requested URI.
+    pub(crate) fn with_cache(mut self, cache: Arc<AssetCache>, uri: String) -> Self {
+        self.cache = Some((cache, uri));
+        self
+    }
+
+    /// Returns a writer which assembles the response from chunks.
+    pub fn writer(self) -> AssetWriter {
+        AssetWriter {
+            responder: self,
+            buffer: Vec::new(),
         }
     }
 
@@ -99,7 +122,21 @@ impl AssetResponder {
     /// Send response data to the client.
     pub fn respond_ok(mut self, data: impl AsRef<[u8]>) {
         if let Some(inner) = self.inner.take() {
-            inner.respond(&self.client, Ok(data.as_ref()))
+            let data = data.as_ref();
+            inner.respond(&self.client, Ok(data));
+            if let Some((cache, uri)) = self.cache.take() {
+                cache.insert(uri, Bytes::copy_from_slice(data));
+            }
+        }
+    }
+
+    /// Send response data to the client, sharing it with the cache.
+    fn respond_bytes(mut self, data: Bytes) {
+        if let Some(inner) = self.inner.take() {
+            inner.respond(&self.client, Ok(&data[..]));
+            if let Some((cache, uri)) = self.cache.take() {
+                cache.insert(uri, data);
+            }
         }
     }
 
@@ -124,6 +161,137 @@ impl Drop for AssetResponder {
     }
 }
 
+/// Assembles a fetch asset response from chunks, for assets which are read piece by piece.
+///
+/// The protocol delivers each asset to the client in a single message, so the chunks are
+/// collected into one buffer, which is sent by [`AssetWriter::finish`]. The handler need not hold
+/// a copy of the asset itself, and the buffer is shared with the server's asset cache, if it has
+/// one, without copying it.
+///
+/// Dropping the writer without finishing it sends an error response to the client.
+#[must_use]
+#[derive(Debug)]
+pub struct AssetWriter {
+    responder: AssetResponder,
+    buffer: Vec<u8>,
+}
+
+impl AssetWriter {
+    /// Reserves capacity for at least `additional` more bytes, for example the size of the file
+    /// being read.
+    pub fn reserve(&mut self, additional: usize) {
+        self.buffer.reserve(additional);
+    }
+
+    /// Appends a chunk of the asset.
+    pub fn append(&mut self, chunk: &[u8]) {
+        self.buffer.extend_from_slice(chunk);
+    }
+
+    /// Returns the number of bytes appended so far.
+    pub fn len(&self) -> usize {
+        self.buffer.len()
+    }
+
+    /// Returns true if no bytes have been appended.
+    pub fn is_empty(&self) -> bool {
+        self.buffer.is_empty()
+    }
+
+    /// Sends the assembled asset to the client.
+    pub fn finish(self) {
+        self.responder.respond_bytes(Bytes::from(self.buffer));
+    }
+
+    /// Discards the appended data, and sends an error response to the client.
+    pub fn respond_err(self, message: impl AsRef<str>) {
+        self.responder.respond_err(message);
+    }
+}
+
+impl std::io::Write for AssetWriter {
+    fn write(&mut self, buf: &[u8]) -> std::io::Result<usize> {
+        self.append(buf);
+        Ok(buf.len())
+    }
+
+    fn flush(&mut self) -> std::io::Result<()> {
+        Ok(())
+    }
+}
+
+/// A least-recently-used cache of fetched assets, keyed by URI, with a budget for their total
+/// size.
+#[derive(Debug)]
+pub(crate) struct AssetCache {
+    budget: usize,
+    state: parking_lot::Mutex<AssetCacheState>,
+}
+
+#[derive(Debug, Default)]
+struct AssetCacheState {
+    entries: HashMap<String, CachedAsset>,
+    /// The URIs of the entries, ordered by their last use.
+    lru: BTreeMap<u64, String>,
+    next_use: u64,
+    size: usize,
+}
+
+#[derive(Debug)]
+struct CachedAsset {
+    data: Bytes,
+    last_use: u64,
+}
+
+impl AssetCache {
+    /// Creates a cache which holds up to `budget` bytes of assets.
+    pub fn new(budget: usize) -> Self {
+        Self {
+            budget,
+            state: parking_lot::Mutex::default(),
+        }
+    }
+
+    /// Returns the cached asset for the URI, marking it as recently used.
+    pub fn get(&self, uri: &str) -> Option<Bytes> {
+        let mut state = self.state.lock();
+        let state = &mut *state;
+        let entry = state.entries.get_mut(uri)?;
+        state.lru.remove(&entry.last_use);
+        entry.last_use = state.next_use;
+        state.next_use += 1;
+        state.lru.insert(entry.last_use, uri.to_string());
+        Some(entry.data.clone())
+    }
+
+    /// Caches an asset, evicting the least recently used assets to stay within the budget.
+    ///
+    /// Assets larger than the budget are not cached.
+    pub fn insert(&self, uri: String, data: Bytes) {
+        if data.len() > self.budget {
+            return;
+        }
+        let mut state = self.state.lock();
+        if let Some(previous) = state.entries.remove(&uri) {
+            state.lru.remove(&previous.last_use);
+            state.size -= previous.data.len();
+        }
+        while state.size + data.len() > self.budget {
+            let Some((_, evicted)) = state.lru.pop_first() else {
+                break;
+            };
+            if let Some(evicted) = state.entries.remove(&evicted) {
+                state.size -= evicted.data.len();
+            }
+        }
+        let last_use = state.next_use;
+        state.next_use += 1;
+        state.size += data.len();
+        state.lru.insert(last_use, uri.clone());
+        state.entries.insert(uri, CachedAsset { data, last_use });
+    }
+}
+
 #[derive(Debug)]
 struct AssetResponderInner {
     request_id: u32,
@@ -136,3 +304,33 @@ impl AssetResponderInner {
         client.send_asset_response(result, self.request_id);
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_asset_cache_evicts_least_recently_used() {
+        let cache = AssetCache::new(10);
+        cache.insert("a".into(), Bytes::from_static(b"aaaa"));
+        cache.insert("b".into(), Bytes::from_static(b"bbbb"));
+        assert_eq!(cache.get("a").as_deref(), Some(&b"aaaa"[..]));
+
+        // "b" is the least recently used asset, so it is evicted to make room for "c".
+        cache.insert("c".into(), Bytes::from_static(b"cccc"));
+        assert!(cache.get("b").is_none());
+        assert_eq!(cache.get("a").as_deref(), Some(&b"aaaa"[..]));
+        assert_eq!(cache.get("c").as_deref(), Some(&b"cccc"[..]));
+
+        // Replacing an asset accounts for the size of the previous version.
+        cache.insert("a".into(), Bytes::from_static(b"aaaaaa"));
+        assert_eq!(cache.get("a").as_deref(), Some(&b"aaaaaa"[..]));
+        assert_eq!(cache.get("c").as_deref(), Some(&b"cccc"[..]));
+        assert_eq!(cache.state.lock().size, 10);
+
+        // Assets larger than the budget are not cached.
+        cache.insert("d".into(), Bytes::from_static(b"ddddddddddd"));
+        assert!(cache.get("d").is_none());
+        assert_eq!(cache.state.lock().size, 10);
+    }
+}
@@ -0,0 +1,332 @@
+//! Serving assets from files on disk.
+
+use std::collections::HashMap;
+use std::fs::{File, Metadata};
+use std::io::{self, Read};
+use std::path::{Component, Path, PathBuf};
+use std::sync::{Arc, Weak};
+use std::time::SystemTime;
+
+use bytes::Bytes;
+use parking_lot::Mutex;
+
+use super::{AssetHandler, AssetResponder};
+use crate::mapped_file::map_file;
+use crate::runtime::get_runtime_handle;
+
+/// An [`AssetHandler`] which serves files from a set of allowed directories.
+///
+/// Each root maps a URI prefix, such as `package://my_robot/` or `file:///opt/meshes/`, to a
+/// directory. A URI is resolved by replacing the longest matching prefix with its directory.
+/// Requests for URIs which match no root, or which resolve to a path outside of the root's
+/// directory, for example via `..` components or symbolic links, fail without touching the file.
+///
+/// Each file is read into memory, up to [`max_file_size`][Self::max_file_size] bytes, and
+/// concurrent requests for the same unchanged file share a single copy. Files may instead be
+/// memory-mapped with [`memory_map`][Self::memory_map].
+#[derive(Clone)]
+pub struct FileAssetHandler {
+    roots: Vec<AssetRoot>,
+    max_file_size: u64,
+    memory_map: bool,
+    loaded: Arc<Mutex<HashMap<PathBuf, Weak<LoadedAsset>>>>,
+}
+
+impl Default for FileAssetHandler {
+    fn default() -> Self {
+        Self {
+            roots: Vec::new(),
+            max_file_size: DEFAULT_MAX_FILE_SIZE,
+            memory_map: false,
+            loaded: Arc::default(),
+        }
+    }
+}
+
+/// The default for [`FileAssetHandler::max_file_size`].
+const DEFAULT_MAX_FILE_SIZE: u64 = 256 * 1024 * 1024;
+
+impl std::fmt::Debug for FileAssetHandler {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("FileAssetHandler")
+            .field("roots", &self.roots)
+            .field("max_file_size", &self.max_file_size)
+            .field("memory_map", &self.memory_map)
+            .finish()
+    }
+}
+
+#[derive(Debug, Clone)]
+struct AssetRoot {
+    uri_prefix: String,
+    directory: PathBuf,
+}
+
+/// The contents of a file, and the metadata they were loaded with.
+struct LoadedAsset {
+    data: Bytes,
+    len: u64,
+    modified: Option<SystemTime>,
+}
+
+impl LoadedAsset {
+    /// Returns true if the file has not changed since it was loaded.
+    fn is_current(&self, metadata: &Metadata) -> bool {
+        self.len == metadata.len() && self.modified == metadata.modified().ok()
+    }
+}
+
+impl FileAssetHandler {
+    /// Creates a handler with no roots, which rejects every request.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Serves the files in `directory` for URIs starting with `uri_prefix`.
+    ///
+    /// The prefix should usually end with a `/`, so that `package://robot` does not also match
+    /// `package://robot_description`.
+    #[must_use]
+    pub fn root(mut self, uri_prefix: impl Into<String>, directory: impl Into<PathBuf>) -> Self {
+        self.roots.push(AssetRoot {
+            uri_prefix: uri_prefix.into(),
+            directory: directory.into(),
+        });
+        self
+    }
+
+    /// Sets the size of the largest file which is served. Requests for larger files fail.
+    ///
+    /// Defaults to 256 MiB.
+    #[must_use]
+    pub fn max_file_size(mut self, max_file_size: u64) -> Self {
+        self.max_file_size = max_file_size;
+        self
+    }
+
+    /// Memory-maps files instead of reading them, so that the response is sent straight from the
+    /// mapped pages without copying the file into memory first.
+    ///
+    /// Only enable this if files in the roots are never truncated or rewritten in place while they
+    /// are served: reading a page of a mapped file after it has been truncated raises `SIGBUS`,
+    /// which crashes the process. Files which are replaced by renaming a new file over them are
+    /// safe.
+    ///
+    /// Defaults to false. Has no effect on platforms other than Unix, where files are always read.
+    #[must_use]
+    pub fn memory_map(mut self, memory_map: bool) -> Self {
+        self.memory_map = memory_map;
+        self
+    }
+
+    /// Resolves a URI to the canonical path of a file within one of the roots.
+    fn resolve(&self, uri: &str) -> Result<PathBuf, String> {
+        let not_allowed = || format!("Asset URI not allowed: {uri}");
+        let root = self
+            .roots
+            .iter()
+            .filter(|root| uri.starts_with(&root.uri_prefix))
+            .max_by_key(|root| root.uri_prefix.len())
+            .ok_or_else(not_allowed)?;
+        let relative =
+            urlencoding::decode(&uri[root.uri_prefix.len()..]).map_err(|_| not_allowed())?;
+        let relative = Path::new(relative.as_ref());
+        if !relative
+            .components()
+            .all(|component| matches!(component, Component::Normal(_)))
+        {
+            return Err(not_allowed());
+        }
+        let not_found = |err: io::Error| {
+            tracing::debug!("Failed to resolve asset {uri}: {err}");
+            format!("Asset not found: {uri}")
+        };
+        let directory = root.directory.canonicalize().map_err(not_found)?;
+        let path = directory.join(relative).canonicalize().map_err(not_found)?;
+        if !path.starts_with(&directory) {
+            return Err(not_allowed());
+        }
+        Ok(path)
+    }
+
+    /// Loads the file at `path`, or returns the contents held by a concurrent request.
+    fn load(&self, path: &Path) -> io::Result<Arc<LoadedAsset>> {
+        let metadata = std::fs::metadata(path)?;
+        if !metadata.is_file() {
+            return Err(io::Error::new(io::ErrorKind::InvalidInput, "not a file"));
+        }
+        if metadata.len() > self.max_file_size {
+            return Err(io::Error::new(
+                io::ErrorKind::FileTooLarge,
+                format!("file is larger than {} bytes", self.max_file_size),
+            ));
+        }
+        let mut loaded = self.loaded.lock();
+        if let Some(asset) = loaded.get(path).and_then(Weak::upgrade) {
+            if asset.is_current(&metadata) {
+                return Ok(asset);
+            }
+        }
+        loaded.retain(|_, asset| asset.strong_count() > 0);
+        let data = if self.memory_map {
+            map_file(path)?
+        } else {
+            read_file(path, metadata.len())?
+        };
+        let asset = Arc::new(LoadedAsset {
+            data,
+            len: metadata.len(),
+            modified: metadata.modified().ok(),
+        });
+        loaded.insert(path.to_path_buf(), Arc::downgrade(&asset));
+        Ok(asset)
+    }
+
+    /// Resolves, loads and sends the asset.
+    fn serve(&self, uri: &str, responder: AssetResponder) {
+        let path = match self.resolve(uri) {
+            Ok(path) => path,
+            Err(message) => {
+                responder.respond_err(message);
+                return;
+            }
+        };
+        match self.load(&path) {
+            Ok(asset) => responder.respond_bytes(asset.data.clone()),
+            Err(err) => {
+                tracing::debug!("Failed to load asset {}: {err}", path.display());
+                responder.respond_err(format!("Failed to read asset: {uri}"));
+            }
+        }
+    }
+}
+
+impl AssetHandler for FileAssetHandler {
+    fn fetch(&self, uri: String, responder: AssetResponder) {
+        // Resolving and loading the file touch the filesystem, so they must not run on the
+        // client's poll loop.
+        let handler = self.clone();
+        get_runtime_handle().spawn_blocking(move || handler.serve(&uri, responder));
+    }
+}
+
+/// Reads at most `len` bytes of the file at `path`.
+///
+/// A file which grows while it is read is cut off at `len` bytes, and a file which is truncated
+/// yields only the bytes which remain.
+fn read_file(path: &Path, len: u64) -> io::Result<Bytes> {
+    let file = File::open(path)?;
+    let mut data = Vec::with_capacity(usize::try_from(len).unwrap_or(0));
+    file.take(len).read_to_end(&mut data)?;
+    Ok(Bytes::from(data))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_resolve() {
+        let dir = tempfile::tempdir().unwrap();
+        let share = dir.path().join("share");
+        std::fs::create_dir_all(share.join("meshes")).unwrap();
+        std::fs::write(share.join("meshes/base link.stl"), b"solid").unwrap();
+        std::fs::write(dir.path().join("secret.txt"), b"secret").unwrap();
+
+        let handler = FileAssetHandler::new()
+            .root("package://robot/", &share)
+            .root("package://robot/meshes/", share.join("meshes"));
+        let canonical = share.canonicalize().unwrap().join("meshes/base link.stl");
+        assert_eq!(
+            handler.resolve("package://robot/meshes/base%20link.stl"),
+            Ok(canonical)
+        );
+
+        for uri in [
+            "package://other/meshes/base%20link.stl",
+            "package://robot/../secret.txt",
+            "package://robot/meshes/%2E%2E/%2E%2E/secret.txt",
+            "package://robot//etc/passwd",
+        ] {
+            assert_eq!(
+                handler.resolve(uri),
+                Err(format!("Asset URI not allowed: {uri}"))
+            );
+        }
+        assert_eq!(
+            handler.resolve("package://robot/missing.stl"),
+            Err("Asset not found: package://robot/missing.stl".to_string())
+        );
+    }
+
+    #[cfg(unix)]
+    #[test]
+    fn test_resolve_rejects_symlinks_out_of_root() {
+        let dir = tempfile::tempdir().unwrap();
+        let share = dir.path().join("share");
+        std::fs::create_dir(&share).unwrap();
+        std::fs::write(dir.path().join("secret.txt"), b"secret").unwrap();
+        std::os::unix::fs::symlink(dir.path().join("secret.txt"), share.join("link.txt")).unwrap();
+
+        let handler = FileAssetHandler::new().root("package://robot/", &share);
+        assert_eq!(
+            handler.resolve("package://robot/link.txt"),
+            Err("Asset URI not allowed: package://robot/link.txt".to_string())
+        );
+    }
+
+    #[test]
+    fn test_concurrent_requests_share_contents() {
+        for memory_map in [false, true] {
+            let dir = tempfile::tempdir().unwrap();
+            let path = dir.path().join("mesh.stl");
+            std::fs::write(&path, b"solid mesh").unwrap();
+
+            let handler = FileAssetHandler::new().memory_map(memory_map);
+            let first = handler.load(&path).unwrap();
+            let second = handler.load(&path).unwrap();
+            assert!(Arc::ptr_eq(&first, &second));
+            assert_eq!(first.data.as_ref(), b"solid mesh");
+
+            // Once released, the file is loaded afresh.
+            drop((first, second));
+            std::fs::write(&path, b"solid mesh v2").unwrap();
+            assert_eq!(handler.load(&path).unwrap().data.as_ref(), b"solid mesh v2");
+        }
+    }
+
+    #[test]
+    fn test_read_survives_truncation() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("mesh.stl");
+        std::fs::write(&path, vec![7u8; 64 * 1024]).unwrap();
+
+        // A file read by default is not affected by later changes to it, where touching a mapping
+        // of a truncated file would fault.
+        let handler = FileAssetHandler::new();
+        let asset = handler.load(&path).unwrap();
+        File::options()
+            .write(true)
+            .open(&path)
+            .unwrap()
+            .set_len(0)
+            .unwrap();
+        assert!(asset.data.iter().all(|&b| b == 7));
+        assert_eq!(asset.data.len(), 64 * 1024);
+    }
+
+    #[test]
+    fn test_max_file_size() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("mesh.stl");
+        std::fs::write(&path, b"solid mesh").unwrap();
+
+        let handler = FileAssetHandler::new().max_file_size(10);
+        assert_eq!(handler.load(&path).unwrap().data.as_ref(), b"solid mesh");
+        let handler = FileAssetHandler::new().max_file_size(9);
+        assert_eq!(
+            handler.load(&path).err().map(|err| err.kind()),
+            Some(io::ErrorKind::FileTooLarge)
+        );
+    }
+}
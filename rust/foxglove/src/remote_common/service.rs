@@ -5,11 +5,14 @@ use std::fmt::Display;
 use std::future::Future;
 use std::sync::Arc;
 use std::sync::atomic::{AtomicU32, Ordering};
+use std::time::Duration;
 
 use serde::{Deserialize, Serialize};
 
 pub use super::ClientId;
 
+mod cache;
+mod executor;
 mod handler;
 mod request;
 pub(crate) mod response;
@@ -17,6 +20,9 @@ mod schema;
 #[cfg(test)]
 mod tests;
 
+use cache::ResponseCache;
+use executor::Dispatcher;
+pub use executor::ServiceExecutor;
 use handler::{AsyncHandlerFn, BlockingHandlerFn, HandlerFn};
 pub use handler::{Handler, SyncHandler};
 pub use request::Request;
@@ -85,6 +91,10 @@ pub struct ServiceBuilder {
     id: ServiceId,
     name: String,
     schema: ServiceSchema,
+    executor: Option<ServiceExecutor>,
+    max_in_flight: Option<usize>,
+    queue_timeout: Option<Duration>,
+    response_cache_ttl: Option<Duration>,
 }
 impl ServiceBuilder {
     /// Creates a new builder for a service.
@@ -93,6 +103,10 @@ impl ServiceBuilder {
             id: ServiceId::next(),
             name: name.into(),
             schema,
+            executor: None,
+            max_in_flight: None,
+            queue_timeout: None,
+            response_cache_ttl: None,
         }
     }
 
@@ -103,13 +117,66 @@ impl ServiceBuilder {
         self
     }
 
+    /// Invokes the handler on the worker threads of an executor, rather than on the client's main
+    /// poll loop.
+    ///
+    /// This allows the handler to block without holding up other messages from the client.
+    pub fn executor(mut self, executor: ServiceExecutor) -> Self {
+        self.executor = Some(executor);
+        self
+    }
+
+    /// Limits the number of calls to the service which may be in flight at once, across all
+    /// clients.
+    ///
+    /// A call is in flight from when its handler is invoked until it responds. Further calls are
+    /// queued in the order they arrive, and are dispatched as in-flight calls complete. Queued
+    /// calls are invoked on the service's executor, or on a blocking thread with
+    /// [`tokio::task::spawn_blocking`] if the service has no executor. Queued calls whose client
+    /// disconnects are failed without invoking the handler.
+    ///
+    /// A limit of zero is treated as one.
+    pub fn max_in_flight(mut self, limit: usize) -> Self {
+        self.max_in_flight = Some(limit);
+        self
+    }
+
+    /// Fails calls which wait in the queue for longer than `timeout`.
+    ///
+    /// Has no effect unless [`ServiceBuilder::max_in_flight`] is set. By default, queued calls
+    /// wait indefinitely.
+    pub fn queue_timeout(mut self, timeout: Duration) -> Self {
+        self.queue_timeout = Some(timeout);
+        self
+    }
+
+    /// Caches the service's responses, for services whose calls are idempotent.
+    ///
+    /// Calls are keyed by their request encoding and payload, regardless of which client made
+    /// them. While a call is in flight, identical calls wait for its response rather than invoking
+    /// the handler again, and the response is sent to all of them. A successful response is then
+    /// sent in reply to identical calls for `ttl`, without invoking the handler. Error responses
+    /// are not cached.
+    ///
+    /// A `ttl` of zero coalesces concurrent identical calls without caching their responses.
+    pub fn response_cache(mut self, ttl: Duration) -> Self {
+        self.response_cache_ttl = Some(ttl);
+        self
+    }
+
     /// Configures a handler and returns the constructed [`Service`].
     pub fn handler<H: Handler + 'static>(self, handler: H) -> Service {
         Service {
             id: self.id,
             name: self.name,
             schema: self.schema,
-            handler: Arc::new(handler),
+            dispatcher: Dispatcher::new(
+                Arc::new(handler),
+                self.executor,
+                self.max_in_flight,
+                self.queue_timeout,
+            ),
+            cache: self.response_cache_ttl.map(ResponseCache::new),
         }
     }
 
@@ -161,7 +228,8 @@ pub struct Service {
     id: ServiceId,
     name: String,
     schema: ServiceSchema,
-    handler: Arc<dyn Handler>,
+    dispatcher: Arc<Dispatcher>,
+    cache: Option<Arc<ResponseCache>>,
 }
 
 impl std::fmt::Debug for Service {
@@ -205,9 +273,15 @@ impl Service {
         self.schema().response().map(|rs| rs.encoding.as_str())
     }
 
-    /// Invokes the service call implementation.
+    /// Invokes the service call implementation, subject to the service's response cache,
+    /// executor and concurrency limit.
     pub(crate) fn call(&self, request: Request, responder: Responder) {
-        self.handler.call(request, responder);
+        match &self.cache {
+            Some(cache) => cache.call(request, responder, |request, responder| {
+                self.dispatcher.dispatch(request, responder);
+            }),
+            None => self.dispatcher.dispatch(request, responder),
+        }
     }
 }
 
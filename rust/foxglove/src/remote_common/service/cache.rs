@@ -0,0 +1,174 @@
+//! Response caching and coalescing for idempotent services.
+
+use std::collections::HashMap;
+use std::collections::hash_map::Entry;
+use std::sync::{Arc, Weak};
+use std::time::{Duration, Instant};
+
+use bytes::Bytes;
+use parking_lot::Mutex;
+
+use super::{Request, Responder, ResponseSender};
+
+/// Identifies calls which are answered by the same response.
+#[derive(Clone, PartialEq, Eq, Hash)]
+struct CacheKey {
+    encoding: String,
+    payload: Bytes,
+}
+
+enum CacheEntry {
+    /// A call is in flight, and these responders are waiting for its response.
+    Pending(Vec<Responder>),
+    /// A successful response, which is served until it expires.
+    Ready {
+        encoding: String,
+        payload: Bytes,
+        expires: Instant,
+    },
+}
+
+/// Caches the successful responses of a service, and coalesces identical concurrent calls.
+///
+/// Calls are keyed by their request encoding and payload. While a call is in flight, identical
+/// calls wait for its response rather than invoking the handler. A successful response is then
+/// served to identical calls until `ttl` has passed. Error responses are passed to the waiting
+/// calls, but are not cached.
+pub(super) struct ResponseCache {
+    weak_self: Weak<Self>,
+    ttl: Duration,
+    entries: Mutex<HashMap<CacheKey, CacheEntry>>,
+}
+
+impl ResponseCache {
+    pub fn new(ttl: Duration) -> Arc<Self> {
+        Arc::new_cyclic(|weak_self| Self {
+            weak_self: weak_self.clone(),
+            ttl,
+            entries: Mutex::default(),
+        })
+    }
+
+    /// Answers a call from the cache, queues it behind an identical call in flight, or passes it
+    /// to `dispatch` to invoke the handler.
+    pub fn call(
+        &self,
+        request: Request,
+        mut responder: Responder,
+        dispatch: impl FnOnce(Request, Responder),
+    ) {
+        let key = CacheKey {
+            encoding: request.encoding().to_string(),
+            payload: request.clone().into_payload(),
+        };
+        let mut entries = self.entries.lock();
+        match entries.entry(key.clone()) {
+            Entry::Occupied(mut entry) => match entry.get_mut() {
+                CacheEntry::Pending(waiters) => {
+                    waiters.push(responder);
+                    return;
+                }
+                CacheEntry::Ready {
+                    encoding,
+                    payload,
+                    expires,
+                } if *expires > Instant::now() => {
+                    let (encoding, payload) = (encoding.clone(), payload.clone());
+                    drop(entries);
+                    responder.set_encoding(encoding);
+                    responder.respond_ok(payload);
+                    return;
+                }
+                CacheEntry::Ready { .. } => {
+                    entry.insert(CacheEntry::Pending(Vec::new()));
+                }
+            },
+            Entry::Vacant(entry) => {
+                entry.insert(CacheEntry::Pending(Vec::new()));
+            }
+        }
+        drop(entries);
+
+        let cache = self.weak_self.upgrade().expect("cache is alive");
+        let responder = responder.map_sender(|sender| {
+            Box::new(CoalescingSender {
+                sender,
+                cache,
+                key: Some(key),
+            })
+        });
+        dispatch(request, responder);
+    }
+
+    /// Completes an in-flight call, answering the calls waiting for it.
+    fn complete(&self, key: CacheKey, result: Result<(&str, &[u8]), String>) {
+        let now = Instant::now();
+        let waiters = {
+            let mut entries = self.entries.lock();
+            let waiters = match entries.remove(&key) {
+                Some(CacheEntry::Pending(waiters)) => waiters,
+                _ => Vec::new(),
+            };
+            entries.retain(|_, entry| match entry {
+                CacheEntry::Pending(_) => true,
+                CacheEntry::Ready { expires, .. } => *expires > now,
+            });
+            if let Ok((encoding, payload)) = &result
+                && !self.ttl.is_zero()
+            {
+                entries.insert(
+                    key,
+                    CacheEntry::Ready {
+                        encoding: encoding.to_string(),
+                        payload: Bytes::copy_from_slice(payload),
+                        expires: now + self.ttl,
+                    },
+                );
+            }
+            waiters
+        };
+        for mut responder in waiters {
+            match &result {
+                Ok((encoding, payload)) => {
+                    responder.set_encoding(*encoding);
+                    responder.respond_ok(payload);
+                }
+                Err(message) => responder.respond_err(message.clone()),
+            }
+        }
+    }
+
+    /// Returns true if every call waiting for the in-flight call has been cancelled.
+    fn waiters_cancelled(&self, key: &CacheKey) -> bool {
+        match self.entries.lock().get(key) {
+            Some(CacheEntry::Pending(waiters)) => waiters.iter().all(Responder::is_cancelled),
+            _ => true,
+        }
+    }
+}
+
+/// A response sender for an in-flight call, which also answers the identical calls waiting for
+/// it.
+struct CoalescingSender {
+    sender: Box<dyn ResponseSender>,
+    cache: Arc<ResponseCache>,
+    key: Option<CacheKey>,
+}
+
+impl ResponseSender for CoalescingSender {
+    fn send(&mut self, result: Result<(&str, &[u8]), String>) {
+        self.sender.send(result.clone());
+        if let Some(key) = self.key.take() {
+            self.cache.complete(key, result);
+        }
+    }
+
+    fn is_cancelled(&self) -> bool {
+        // The handler's work is only wasted if no waiting call needs the response either.
+        self.sender.is_cancelled()
+            && self
+                .key
+                .as_ref()
+                .is_none_or(|key| self.cache.waiters_cancelled(key))
+    }
+}
@@ -0,0 +1,355 @@
+//! Service call dispatch.
+
+use std::collections::VecDeque;
+use std::panic::AssertUnwindSafe;
+use std::sync::{Arc, Weak};
+use std::time::{Duration, Instant};
+
+use parking_lot::{Condvar, Mutex};
+use tokio::runtime::Handle;
+
+use super::{Handler, Request, Responder, ResponseSender};
+use crate::runtime::get_runtime_handle;
+
+/// The error message sent for calls which time out in a service's queue.
+const QUEUE_TIMEOUT_MESSAGE: &str = "Service call timed out waiting in queue";
+
+/// The error message sent for queued calls whose client has disconnected.
+const CANCELLED_MESSAGE: &str = "Service call cancelled";
+
+type Job = Box<dyn FnOnce() + Send>;
+
+/// A pool of worker threads for invoking service call handlers.
+///
+/// By default, a service's handler is invoked from the client's main poll loop, and must not
+/// block. A service configured with [`ServiceBuilder::executor`][super::ServiceBuilder::executor]
+/// is instead invoked on one of the executor's worker threads, so that a slow handler does not
+/// hold up the other messages from the same client. An executor may be shared by several
+/// services.
+///
+/// The worker threads exit once the executor, and every service using it, have been dropped.
+#[derive(Clone)]
+pub struct ServiceExecutor(Arc<Pool>);
+
+impl std::fmt::Debug for ServiceExecutor {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("ServiceExecutor")
+            .field("threads", &self.0.threads)
+            .finish()
+    }
+}
+
+impl ServiceExecutor {
+    /// Creates an executor with the given number of worker threads.
+    ///
+    /// At least one worker thread is always created.
+    ///
+    /// Panics if a worker thread cannot be spawned.
+    pub fn new(threads: usize) -> Self {
+        let threads = threads.max(1);
+        let queue = Arc::new(JobQueue::default());
+        for index in 0..threads {
+            let queue = queue.clone();
+            std::thread::Builder::new()
+                .name(format!("foxglove-service-{index}"))
+                .spawn(move || queue.run())
+                .expect("Failed to spawn service worker thread");
+        }
+        Self(Arc::new(Pool { queue, threads }))
+    }
+
+    /// Returns the number of worker threads.
+    pub fn threads(&self) -> usize {
+        self.0.threads
+    }
+
+    /// Queues a job for a worker thread.
+    fn spawn(&self, job: Job) {
+        self.0.queue.push(job);
+    }
+}
+
+/// The shared state of a [`ServiceExecutor`]. Closes the job queue when dropped.
+struct Pool {
+    queue: Arc<JobQueue>,
+    threads: usize,
+}
+
+impl Drop for Pool {
+    fn drop(&mut self) {
+        self.queue.close();
+    }
+}
+
+#[derive(Default)]
+struct JobQueue {
+    state: Mutex<JobQueueState>,
+    cond: Condvar,
+}
+
+#[derive(Default)]
+struct JobQueueState {
+    jobs: VecDeque<Job>,
+    closed: bool,
+}
+
+impl JobQueue {
+    fn push(&self, job: Job) {
+        self.state.lock().jobs.push_back(job);
+        self.cond.notify_one();
+    }
+
+    fn close(&self) {
+        self.state.lock().closed = true;
+        self.cond.notify_all();
+    }
+
+    /// Runs jobs until the queue is closed and drained.
+    fn run(&self) {
+        loop {
+            let job = {
+                let mut state = self.state.lock();
+                loop {
+                    if let Some(job) = state.jobs.pop_front() {
+                        break job;
+                    }
+                    if state.closed {
+                        return;
+                    }
+                    self.cond.wait(&mut state);
+                }
+            };
+            // A panicking handler drops its responder, which replies with an error. Keep the
+            // worker alive for the next call.
+            if std::panic::catch_unwind(AssertUnwindSafe(job)).is_err() {
+                tracing::error!("Service handler panicked");
+            }
+        }
+    }
+}
+
+/// Invokes a service's handler, on the service's executor and within its concurrency limit.
+pub(super) struct Dispatcher {
+    weak_self: Weak<Self>,
+    handler: Arc<dyn Handler>,
+    executor: Option<ServiceExecutor>,
+    limit: Option<Limit>,
+}
+
+/// Bounds the number of calls in flight for a service.
+struct Limit {
+    max_in_flight: usize,
+    queue_timeout: Option<Duration>,
+    state: Mutex<LimitState>,
+}
+
+#[derive(Default)]
+struct LimitState {
+    in_flight: usize,
+    queue: VecDeque<QueuedCall>,
+}
+
+/// A call waiting for one of the service's in-flight slots.
+struct QueuedCall {
+    request: Request,
+    responder: Responder,
+    /// The runtime the call arrived on, for handlers which spawn tasks.
+    runtime: Option<Handle>,
+    deadline: Option<Instant>,
+}
+
+impl QueuedCall {
+    /// Fails the call if it has been cancelled or has timed out, otherwise returns it.
+    fn check(self, now: Instant) -> Option<Self> {
+        if self.responder.is_cancelled() {
+            self.responder.respond_err(CANCELLED_MESSAGE.into());
+            None
+        } else if self.deadline.is_some_and(|deadline| deadline <= now) {
+            self.responder.respond_err(QUEUE_TIMEOUT_MESSAGE.into());
+            None
+        } else {
+            Some(self)
+        }
+    }
+
+    fn is_stale(&self, now: Instant) -> bool {
+        self.responder.is_cancelled() || self.deadline.is_some_and(|deadline| deadline <= now)
+    }
+}
+
+impl Dispatcher {
+    pub fn new(
+        handler: Arc<dyn Handler>,
+        executor: Option<ServiceExecutor>,
+        max_in_flight: Option<usize>,
+        queue_timeout: Option<Duration>,
+    ) -> Arc<Self> {
+        let limit = max_in_flight.map(|max_in_flight| Limit {
+            max_in_flight: max_in_flight.max(1),
+            queue_timeout,
+            state: Mutex::default(),
+        });
+        Arc::new_cyclic(|weak_self| Self {
+            weak_self: weak_self.clone(),
+            handler,
+            executor,
+            limit,
+        })
+    }
+
+    /// Invokes the handler for a call, or queues the call if the service is at its limit.
+    pub fn dispatch(&self, request: Request, responder: Responder) {
+        let runtime = Handle::try_current().ok();
+        let Some(limit) = &self.limit else {
+            self.invoke(request, responder, runtime);
+            return;
+        };
+
+        let mut state = limit.state.lock();
+        if state.in_flight < limit.max_in_flight {
+            state.in_flight += 1;
+            drop(state);
+            let responder = self.with_permit(responder);
+            self.invoke(request, responder, runtime);
+            return;
+        }
+        let deadline = limit.queue_timeout.map(|timeout| Instant::now() + timeout);
+        state.queue.push_back(QueuedCall {
+            request,
+            responder,
+            runtime: runtime.clone(),
+            deadline,
+        });
+        drop(state);
+
+        if let Some(timeout) = limit.queue_timeout {
+            let weak_self = self.weak_self.clone();
+            runtime
+                .unwrap_or_else(get_runtime_handle)
+                .spawn(async move {
+                    tokio::time::sleep(timeout).await;
+                    if let Some(dispatcher) = weak_self.upgrade() {
+                        dispatcher.expire();
+                    }
+                });
+        }
+    }
+
+    /// Invokes the handler on the executor, if there is one, or on the current thread.
+    fn invoke(&self, request: Request, responder: Responder, runtime: Option<Handle>) {
+        match &self.executor {
+            Some(executor) => {
+                let handler = self.handler.clone();
+                executor.spawn(Box::new(move || {
+                    let _guard = runtime.as_ref().map(Handle::enter);
+                    call(handler.as_ref(), request, responder);
+                }));
+            }
+            None => call(self.handler.as_ref(), request, responder),
+        }
+    }
+
+    /// Invokes the handler for a call taken from the queue.
+    ///
+    /// The call is released by whichever thread completed the previous call, so the handler is
+    /// invoked on the executor, or on a blocking thread if there isn't one.
+    fn resume(&self, call: QueuedCall) {
+        let responder = self.with_permit(call.responder);
+        if self.executor.is_some() {
+            self.invoke(call.request, responder, call.runtime);
+            return;
+        }
+        let handler = self.handler.clone();
+        let request = call.request;
+        call.runtime
+            .unwrap_or_else(get_runtime_handle)
+            .spawn_blocking(move || self::call(handler.as_ref(), request, responder));
+    }
+
+    /// Wraps the responder so that completing the call frees its in-flight slot.
+    fn with_permit(&self, responder: Responder) -> Responder {
+        let dispatcher = self.weak_self.upgrade().expect("dispatcher is alive");
+        responder.map_sender(|sender| {
+            Box::new(PermitSender {
+                sender,
+                _permit: Permit(dispatcher),
+            })
+        })
+    }
+
+    /// Frees an in-flight slot, passing it on to the next live call in the queue.
+    fn release(&self) {
+        let Some(limit) = &self.limit else {
+            return;
+        };
+        loop {
+            let next = {
+                let mut state = limit.state.lock();
+                let next = state.queue.pop_front();
+                if next.is_none() {
+                    state.in_flight -= 1;
+                }
+                next
+            };
+            let Some(call) = next else {
+                return;
+            };
+            if let Some(call) = call.check(Instant::now()) {
+                self.resume(call);
+                return;
+            }
+        }
+    }
+
+    /// Fails the queued calls which have timed out, or whose client has disconnected.
+    fn expire(&self) {
+        let Some(limit) = &self.limit else {
+            return;
+        };
+        let now = Instant::now();
+        let stale = {
+            let mut state = limit.state.lock();
+            let (stale, live): (VecDeque<_>, _) =
+                state.queue.drain(..).partition(|call| call.is_stale(now));
+            state.queue = live;
+            stale
+        };
+        for call in stale {
+            call.check(now);
+        }
+    }
+}
+
+/// Invokes the handler, unless the client has already disconnected.
+fn call(handler: &dyn Handler, request: Request, responder: Responder) {
+    if responder.is_cancelled() {
+        responder.respond_err(CANCELLED_MESSAGE.into());
+        return;
+    }
+    handler.call(request, responder);
+}
+
+/// Holds one of the service's in-flight slots until it is dropped.
+struct Permit(Arc<Dispatcher>);
+
+impl Drop for Permit {
+    fn drop(&mut self) {
+        self.0.release();
+    }
+}
+
+/// A response sender which frees its call's in-flight slot once the response has been sent.
+struct PermitSender {
+    sender: Box<dyn ResponseSender>,
+    _permit: Permit,
+}
+
+impl ResponseSender for PermitSender {
+    fn send(&mut self, result: Result<(&str, &[u8]), String>) {
+        self.sender.send(result);
+    }
+
+    fn is_cancelled(&self) -> bool {
+        self.sender.is_cancelled()
+    }
+}
@@ -12,7 +12,8 @@ pub trait Handler: Send + Sync {
     ///
     /// This method is invoked from the client's main poll loop and must not block. If blocking or
     /// long-running behavior is required, the implementation should use [`tokio::task::spawn`] (or
-    /// [`tokio::task::spawn_blocking`]) to handle the request asynchronously.
+    /// [`tokio::task::spawn_blocking`]) to handle the request asynchronously, or the service
+    /// should be configured with a [`ServiceExecutor`][super::ServiceExecutor].
     ///
     /// The implementation is responsible for completing the request with [`Responder::respond`],
     /// otherwise no response will be sent to the client.
@@ -34,7 +35,8 @@ pub trait SyncHandler: Send + Sync {
     /// Synchronously handles a service call request from a client and returns a result.
     ///
     /// This method is invoked from the client's main poll loop and must not block. If blocking or
-    /// long-running behavior is required, use [`Handler`] instead.
+    /// long-running behavior is required, use [`Handler`] instead, or configure the service with a
+    /// [`ServiceExecutor`][super::ServiceExecutor].
     fn call(&self, request: Request) -> Result<Self::Response, Self::Error>;
 }
 
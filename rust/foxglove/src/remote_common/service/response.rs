@@ -9,6 +9,11 @@ pub(crate) trait ResponseSender: Send {
     /// `result` is either `Ok((encoding, payload))` for a successful response,
     /// or `Err(message)` for a failure response.
     fn send(&mut self, result: Result<(&str, &[u8]), String>);
+
+    /// Returns true if the response can no longer be delivered, because the client disconnected.
+    fn is_cancelled(&self) -> bool {
+        false
+    }
 }
 
 /// A handle for completing a service call.
@@ -34,6 +39,30 @@ impl Responder {
         }))
     }
 
+    /// Replaces the responder's sender with a wrapper around it.
+    pub(crate) fn map_sender(
+        mut self,
+        f: impl FnOnce(Box<dyn ResponseSender>) -> Box<dyn ResponseSender>,
+    ) -> Self {
+        if let Some(inner) = self.0.take() {
+            self.0 = Some(Inner {
+                encoding: inner.encoding,
+                sender: f(inner.sender),
+            });
+        }
+        self
+    }
+
+    /// Returns true if the call has been cancelled, because the client disconnected.
+    ///
+    /// A long-running handler may check this to abandon work whose response would never be
+    /// delivered. It must still complete the call, but the response is discarded.
+    pub fn is_cancelled(&self) -> bool {
+        self.0
+            .as_ref()
+            .is_some_and(|inner| inner.sender.is_cancelled())
+    }
+
     /// Overrides the default response encoding.
     ///
     /// By default, the response encoding is the one declared in the
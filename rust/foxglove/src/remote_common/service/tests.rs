@@ -1,4 +1,78 @@
-use super::{Service, ServiceId, ServiceMap, ServiceSchema};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Mutex, mpsc};
+use std::time::Duration;
+
+use super::{
+    CallId, ClientId, Handler, Request, Responder, ResponseSender, Service, ServiceExecutor,
+    ServiceId, ServiceMap, ServiceSchema,
+};
+
+type Results = Arc<Mutex<Vec<Result<Vec<u8>, String>>>>;
+
+/// Records responses, and reports the call as cancelled once `cancelled` is set.
+struct RecordingSender {
+    results: Results,
+    cancelled: Arc<AtomicBool>,
+}
+
+impl ResponseSender for RecordingSender {
+    fn send(&mut self, result: Result<(&str, &[u8]), String>) {
+        let result = result.map(|(_, payload)| payload.to_vec());
+        self.results.lock().unwrap().push(result);
+    }
+
+    fn is_cancelled(&self) -> bool {
+        self.cancelled.load(Ordering::Relaxed)
+    }
+}
+
+/// Passes each call's responder to the test, so that the test decides when calls complete.
+struct DeferredHandler(Mutex<mpsc::Sender<(u32, Responder)>>);
+
+impl Handler for DeferredHandler {
+    fn call(&self, request: Request, responder: Responder) {
+        let call_id = u32::from(request.call_id());
+        self.0.lock().unwrap().send((call_id, responder)).unwrap();
+    }
+}
+
+/// Calls the service, returning the recorded responses and the cancellation flag.
+fn call_service(service: &Arc<Service>, call_id: u32) -> (Results, Arc<AtomicBool>) {
+    call_service_with_payload(service, call_id, b"")
+}
+
+/// Calls the service with a request payload, returning the recorded responses and the
+/// cancellation flag.
+fn call_service_with_payload(
+    service: &Arc<Service>,
+    call_id: u32,
+    payload: &[u8],
+) -> (Results, Arc<AtomicBool>) {
+    let results = Results::default();
+    let cancelled = Arc::new(AtomicBool::new(false));
+    let sender = Box::new(RecordingSender {
+        results: results.clone(),
+        cancelled: cancelled.clone(),
+    });
+    let request = Request::new(
+        service.clone(),
+        ClientId(1),
+        CallId::new(call_id),
+        "raw".into(),
+        payload.to_vec().into(),
+    );
+    service.call(request, Responder::new("raw", sender));
+    (results, cancelled)
+}
+
+fn make_deferred_service(
+    configure: impl FnOnce(super::ServiceBuilder) -> super::ServiceBuilder,
+) -> (Arc<Service>, mpsc::Receiver<(u32, Responder)>) {
+    let (tx, rx) = mpsc::channel();
+    let builder = Service::builder("deferred", ServiceSchema::new("schema"));
+    let service = configure(builder).handler(DeferredHandler(Mutex::new(tx)));
+    (Arc::new(service), rx)
+}
 
 fn make_service(name: &str, id: u32) -> Service {
     Service::builder(name, ServiceSchema::new("schema"))
@@ -41,3 +115,143 @@ fn test_service_map() {
     assert!(map.get_by_id(ServiceId::new(2)).is_some());
     assert!(map.get_by_id(ServiceId::new(3)).is_some());
 }
+
+#[test]
+fn test_max_in_flight_queues_calls() {
+    let (service, calls) =
+        make_deferred_service(|builder| builder.executor(ServiceExecutor::new(2)).max_in_flight(1));
+    let timeout = Duration::from_secs(5);
+
+    let (results1, _) = call_service(&service, 1);
+    let (results2, _) = call_service(&service, 2);
+    let (results3, _) = call_service(&service, 3);
+
+    // Only the first call is dispatched until it completes.
+    let (call_id, responder) = calls.recv_timeout(timeout).unwrap();
+    assert_eq!(call_id, 1);
+    assert!(calls.recv_timeout(Duration::from_millis(50)).is_err());
+    responder.respond_ok(b"one");
+    assert_eq!(*results1.lock().unwrap(), vec![Ok(b"one".to_vec())]);
+
+    // The queued calls are dispatched in order.
+    let (call_id, responder) = calls.recv_timeout(timeout).unwrap();
+    assert_eq!(call_id, 2);
+    assert!(calls.recv_timeout(Duration::from_millis(50)).is_err());
+    drop(responder);
+    assert!(results2.lock().unwrap()[0].is_err());
+
+    let (call_id, responder) = calls.recv_timeout(timeout).unwrap();
+    assert_eq!(call_id, 3);
+    responder.respond_ok(b"three");
+    assert_eq!(*results3.lock().unwrap(), vec![Ok(b"three".to_vec())]);
+}
+
+#[test]
+fn test_max_in_flight_skips_cancelled_calls() {
+    let (service, calls) =
+        make_deferred_service(|builder| builder.executor(ServiceExecutor::new(1)).max_in_flight(1));
+    let timeout = Duration::from_secs(5);
+
+    let (_, _) = call_service(&service, 1);
+    let (results2, cancelled2) = call_service(&service, 2);
+    let (_, _) = call_service(&service, 3);
+
+    let (_, responder) = calls.recv_timeout(timeout).unwrap();
+    cancelled2.store(true, Ordering::Relaxed);
+    assert!(!responder.is_cancelled());
+    responder.respond_ok(b"");
+
+    // The cancelled call is failed without invoking the handler.
+    let (call_id, responder) = calls.recv_timeout(timeout).unwrap();
+    assert_eq!(call_id, 3);
+    responder.respond_ok(b"");
+    assert_eq!(
+        *results2.lock().unwrap(),
+        vec![Err("Service call cancelled".to_string())]
+    );
+}
+
+#[tokio::test]
+async fn test_queue_timeout() {
+    let (service, calls) = make_deferred_service(|builder| {
+        builder
+            .max_in_flight(1)
+            .queue_timeout(Duration::from_millis(10))
+    });
+
+    let (_, _) = call_service(&service, 1);
+    let (results2, _) = call_service(&service, 2);
+    let (_, responder) = calls.try_recv().unwrap();
+
+    tokio::time::sleep(Duration::from_millis(100)).await;
+    assert_eq!(
+        *results2.lock().unwrap(),
+        vec![Err("Service call timed out waiting in queue".to_string())]
+    );
+
+    // The timed out call is never dispatched.
+    responder.respond_ok(b"");
+    tokio::time::sleep(Duration::from_millis(50)).await;
+    assert!(calls.try_recv().is_err());
+}
+
+#[test]
+fn test_response_cache_coalesces_and_caches_calls() {
+    let (service, calls) =
+        make_deferred_service(|builder| builder.response_cache(Duration::from_secs(60)));
+
+    // Identical concurrent calls invoke the handler once.
+    let (results1, _) = call_service_with_payload(&service, 1, b"a");
+    let (results2, _) = call_service_with_payload(&service, 2, b"a");
+    let (call_id, responder) = calls.try_recv().unwrap();
+    assert_eq!(call_id, 1);
+    assert!(calls.try_recv().is_err());
+    responder.respond_ok(b"response");
+    assert_eq!(*results1.lock().unwrap(), vec![Ok(b"response".to_vec())]);
+    assert_eq!(*results2.lock().unwrap(), vec![Ok(b"response".to_vec())]);
+
+    // Later identical calls are answered from the cache.
+    let (results3, _) = call_service_with_payload(&service, 3, b"a");
+    assert!(calls.try_recv().is_err());
+    assert_eq!(*results3.lock().unwrap(), vec![Ok(b"response".to_vec())]);
+
+    // Calls with other payloads invoke the handler.
+    let (_, _) = call_service_with_payload(&service, 4, b"b");
+    let (call_id, responder) = calls.try_recv().unwrap();
+    assert_eq!(call_id, 4);
+    responder.respond_ok(b"");
+}
+
+#[test]
+fn test_response_cache_does_not_cache_errors() {
+    let (service, calls) =
+        make_deferred_service(|builder| builder.response_cache(Duration::from_secs(60)));
+
+    let (results1, _) = call_service(&service, 1);
+    let (results2, _) = call_service(&service, 2);
+    let (_, responder) = calls.try_recv().unwrap();
+    responder.respond_err("failed".into());
+    assert_eq!(*results1.lock().unwrap(), vec![Err("failed".to_string())]);
+    assert_eq!(*results2.lock().unwrap(), vec![Err("failed".to_string())]);
+
+    let (_, _) = call_service(&service, 3);
+    let (call_id, responder) = calls.try_recv().unwrap();
+    assert_eq!(call_id, 3);
+    responder.respond_ok(b"");
+}
+
+#[test]
+fn test_response_cache_with_zero_ttl_only_coalesces() {
+    let (service, calls) = make_deferred_service(|builder| builder.response_cache(Duration::ZERO));
+
+    let (_, _) = call_service(&service, 1);
+    let (_, responder) = calls.try_recv().unwrap();
+    responder.respond_ok(b"");
+
+    // With a TTL of zero, calls are coalesced but responses are not cached.
+    let (results, _) = call_service(&service, 2);
+    let (call_id, responder) = calls.try_recv().unwrap();
+    assert_eq!(call_id, 2);
+    responder.respond_ok(b"again");
+    assert_eq!(*results.lock().unwrap(), vec![Ok(b"again".to_vec())]);
+}
@@ -0,0 +1,660 @@
+//! In-memory ring buffer sink, for capturing the moments before an incident.
+use std::collections::{HashMap, VecDeque};
+use std::fmt::Debug;
+use std::path::Path;
+use std::sync::{Arc, Weak};
+use std::thread::JoinHandle;
+use std::time::Duration;
+
+use parking_lot::Mutex;
+
+use crate::sink_channel_filter::SinkChannelFilterFn;
+use crate::{
+    ChannelBuilder, ChannelDescriptor, ChannelId, Context, FoxgloveError, McapWriteOptions,
+    McapWriter, Metadata, PartialMetadata, RawChannel, Sink, SinkChannelFilter, SinkId, SinkStats,
+};
+
+/// The default time window of the ring buffer.
+const DEFAULT_WINDOW: Duration = Duration::from_secs(60);
+
+/// The default capacity of the ring buffer, in bytes.
+const DEFAULT_MAX_BYTES: usize = 256 << 20;
+
+/// A sink which keeps the most recent messages of every channel in memory, so that they can be
+/// written to an MCAP file after the fact.
+///
+/// This is useful for incident capture: the sink holds the last minute of data, and when
+/// something goes wrong, such as a failed service call, the application calls
+/// [`RingBufferSinkHandle::snapshot`] to save the messages which led up to it.
+///
+/// The sink keeps messages logged within a time window of the newest message, up to a limit on
+/// the total size of the message data. The oldest messages are evicted first. Each channel's
+/// messages are stored back to back in a single buffer, so that buffering a message does not
+/// allocate once the buffer has grown to its working size.
+///
+/// ```no_run
+/// use std::time::Duration;
+///
+/// use foxglove::RingBufferSink;
+///
+/// let ring = RingBufferSink::new()
+///     .window(Duration::from_secs(60))
+///     .max_bytes(512 << 20)
+///     .create()?;
+///
+/// // ... later, when something goes wrong:
+/// let snapshot = ring.snapshot("incident.mcap", Duration::from_secs(30))?;
+/// snapshot.wait()?;
+/// # Ok::<(), foxglove::FoxgloveError>(())
+/// ```
+#[must_use]
+#[derive(Clone)]
+pub struct RingBufferSink {
+    window: Duration,
+    max_bytes: usize,
+    mcap_options: McapWriteOptions,
+    context: Arc<Context>,
+    channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+}
+
+impl Debug for RingBufferSink {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("RingBufferSink")
+            .field("window", &self.window)
+            .field("max_bytes", &self.max_bytes)
+            .field("mcap_options", &self.mcap_options)
+            .field("context", &self.context)
+            .finish_non_exhaustive()
+    }
+}
+
+impl Default for RingBufferSink {
+    fn default() -> Self {
+        Self {
+            window: DEFAULT_WINDOW,
+            max_bytes: DEFAULT_MAX_BYTES,
+            mcap_options: McapWriteOptions::default(),
+            context: Context::get_default(),
+            channel_filter: None,
+        }
+    }
+}
+
+impl RingBufferSink {
+    /// Instantiates a new ring buffer sink with default options.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Sets how far back, from the newest message, the sink keeps messages. The default is 60
+    /// seconds.
+    pub fn window(mut self, window: Duration) -> Self {
+        self.window = window;
+        self
+    }
+
+    /// Sets the maximum total size of the buffered message data, in bytes. The default is 256
+    /// MiB.
+    ///
+    /// Messages larger than this are not buffered.
+    pub fn max_bytes(mut self, max_bytes: usize) -> Self {
+        self.max_bytes = max_bytes;
+        self
+    }
+
+    /// Sets the options used to write snapshots. The library option is ignored.
+    pub fn mcap_options(mut self, options: McapWriteOptions) -> Self {
+        self.mcap_options = options;
+        self
+    }
+
+    /// Sets the context for this sink.
+    #[doc(hidden)]
+    pub fn context(mut self, ctx: &Arc<Context>) -> Self {
+        self.context = ctx.clone();
+        self
+    }
+
+    /// Sets a [`SinkChannelFilter`] for this sink.
+    pub fn channel_filter(mut self, filter: Arc<dyn SinkChannelFilter>) -> Self {
+        self.channel_filter = Some(filter);
+        self
+    }
+
+    /// Sets a channel filter for this sink. See [`SinkChannelFilter`] for more information.
+    pub fn channel_filter_fn(
+        mut self,
+        filter: impl Fn(&ChannelDescriptor) -> bool + Sync + Send + 'static,
+    ) -> Self {
+        self.channel_filter = Some(Arc::new(SinkChannelFilterFn(filter)));
+        self
+    }
+
+    /// Begins buffering messages logged to the context.
+    pub fn create(self) -> Result<RingBufferSinkHandle, FoxgloveError> {
+        if self.max_bytes == 0 {
+            return Err(FoxgloveError::ValueError(
+                "ring buffer capacity must be greater than zero".to_string(),
+            ));
+        }
+        let sink = Arc::new(RingSink {
+            sink_id: SinkId::next(),
+            channel_filter: self.channel_filter,
+            window: u64::try_from(self.window.as_nanos()).unwrap_or(u64::MAX),
+            max_bytes: self.max_bytes,
+            state: Mutex::new(RingState::default()),
+        });
+        self.context.add_sink(sink.clone());
+        Ok(RingBufferSinkHandle {
+            sink,
+            context: Arc::downgrade(&self.context),
+            mcap_options: self.mcap_options,
+        })
+    }
+}
+
+/// A handle to a ring buffer sink.
+///
+/// When this handle is dropped, the sink will unregister from the [`Context`] and release the
+/// buffered messages. Snapshots which are being written are not affected.
+#[must_use]
+#[derive(Debug)]
+pub struct RingBufferSinkHandle {
+    sink: Arc<RingSink>,
+    context: Weak<Context>,
+    mcap_options: McapWriteOptions,
+}
+
+impl RingBufferSinkHandle {
+    /// Writes the buffered messages logged within `window` of the newest message to a new MCAP
+    /// file at `path`.
+    ///
+    /// The messages are copied out of the ring buffer, which briefly holds the lock that logging
+    /// threads take, and written on a background thread with an [`McapWriter`]. Messages logged
+    /// after this call are not included. Use [`RingBufferSnapshot::wait`] to wait for the file to
+    /// be written.
+    ///
+    /// If the file already exists, the snapshot fails with
+    /// [`AlreadyExists`](`std::io::ErrorKind::AlreadyExists`).
+    pub fn snapshot(
+        &self,
+        path: impl AsRef<Path>,
+        window: Duration,
+    ) -> Result<RingBufferSnapshot, FoxgloveError> {
+        let window = u64::try_from(window.as_nanos()).unwrap_or(u64::MAX);
+        let channels = self.sink.state.lock().copy_window(window);
+        let path = path.as_ref().to_path_buf();
+        let options = self.mcap_options.clone();
+        let thread = std::thread::Builder::new()
+            .name("foxglove-ring-snapshot".into())
+            .spawn(move || {
+                let result = write_snapshot(&path, options, channels);
+                if let Err(e) = &result {
+                    tracing::error!("Failed to write snapshot to {}: {e}", path.display());
+                }
+                result
+            })?;
+        Ok(RingBufferSnapshot { thread })
+    }
+
+    /// Returns the number of messages currently buffered.
+    pub fn buffered_messages(&self) -> usize {
+        self.sink.state.lock().order.len()
+    }
+
+    /// Returns the total size of the message data currently buffered, in bytes.
+    pub fn buffered_bytes(&self) -> usize {
+        self.sink.state.lock().bytes
+    }
+
+    /// Stops buffering messages, and releases the buffered messages.
+    pub fn close(self) {
+        self.finish();
+    }
+
+    fn finish(&self) {
+        if let Some(context) = self.context.upgrade() {
+            context.remove_sink(self.sink.id());
+        }
+        *self.sink.state.lock() = RingState::default();
+    }
+}
+
+impl Drop for RingBufferSinkHandle {
+    fn drop(&mut self) {
+        self.finish();
+    }
+}
+
+/// A snapshot of a ring buffer sink which is being written to an MCAP file.
+///
+/// Dropping the snapshot does not stop it from being written.
+#[must_use]
+#[derive(Debug)]
+pub struct RingBufferSnapshot {
+    thread: JoinHandle<Result<(), FoxgloveError>>,
+}
+
+impl RingBufferSnapshot {
+    /// Returns true if the snapshot has been written, or failed.
+    pub fn is_finished(&self) -> bool {
+        self.thread.is_finished()
+    }
+
+    /// Waits for the snapshot to be written.
+    ///
+    /// If the snapshot is dropped without waiting, it is still written, and errors are logged.
+    pub fn wait(self) -> Result<(), FoxgloveError> {
+        self.thread.join().unwrap_or_else(|_| {
+            Err(FoxgloveError::Unspecified(
+                "snapshot writer panicked".into(),
+            ))
+        })
+    }
+}
+
+/// The buffered messages of a channel.
+struct ChannelArena {
+    channel: Arc<RawChannel>,
+    /// The data of each message, back to back.
+    data: VecDeque<u8>,
+    /// The log time and length of each message in `data`, in the order they were logged.
+    messages: VecDeque<(u64, usize)>,
+    /// Whether the channel was removed from the context. The arena is freed once its messages are
+    /// evicted.
+    removed: bool,
+}
+
+impl ChannelArena {
+    fn new(channel: Arc<RawChannel>) -> Self {
+        Self {
+            channel,
+            data: VecDeque::new(),
+            messages: VecDeque::new(),
+            removed: false,
+        }
+    }
+}
+
+#[derive(Default)]
+struct RingState {
+    arenas: HashMap<ChannelId, ChannelArena>,
+    /// The channel of each buffered message, in the order they were logged, so that the oldest
+    /// message can be evicted without searching every arena.
+    order: VecDeque<ChannelId>,
+    /// The total size of the buffered message data.
+    bytes: usize,
+    /// The newest log time of a buffered message.
+    latest_log_time: u64,
+    /// The number of messages which were too large to buffer.
+    dropped_messages: u64,
+}
+
+impl RingState {
+    fn push(
+        &mut self,
+        channel_id: ChannelId,
+        msg: &[u8],
+        metadata: &Metadata,
+        window: u64,
+        max_bytes: usize,
+    ) {
+        let Some(arena) = self.arenas.get_mut(&channel_id) else {
+            return;
+        };
+        if msg.len() > max_bytes {
+            self.dropped_messages += 1;
+            return;
+        }
+        arena.data.extend(msg);
+        arena.messages.push_back((metadata.log_time, msg.len()));
+        self.order.push_back(channel_id);
+        self.bytes += msg.len();
+        self.latest_log_time = self.latest_log_time.max(metadata.log_time);
+
+        let cutoff = self.latest_log_time.saturating_sub(window);
+        while let Some(&oldest) = self.order.front() {
+            let Some(arena) = self.arenas.get_mut(&oldest) else {
+                self.order.pop_front();
+                continue;
+            };
+            let Some(&(log_time, len)) = arena.messages.front() else {
+                self.order.pop_front();
+                continue;
+            };
+            if self.bytes <= max_bytes && log_time >= cutoff {
+                break;
+            }
+            self.order.pop_front();
+            arena.messages.pop_front();
+            arena.data.drain(..len);
+            self.bytes -= len;
+            if arena.removed && arena.messages.is_empty() {
+                self.arenas.remove(&oldest);
+            }
+        }
+    }
+
+    /// Copies the messages logged within `window` of the newest message.
+    fn copy_window(&self, window: u64) -> Vec<SnapshotChannel> {
+        let cutoff = self.latest_log_time.saturating_sub(window);
+        let mut channels = Vec::new();
+        for arena in self.arenas.values() {
+            // Skip the messages before the first one in the window. Later messages which are
+            // older than the cutoff are skipped when the snapshot is written.
+            let mut offset = 0;
+            let mut skip = 0;
+            for &(log_time, len) in &arena.messages {
+                if log_time >= cutoff {
+                    break;
+                }
+                offset += len;
+                skip += 1;
+            }
+            if skip == arena.messages.len() {
+                continue;
+            }
+            let (front, back) = arena.data.as_slices();
+            let mut data = Vec::with_capacity(arena.data.len() - offset);
+            if offset < front.len() {
+                data.extend_from_slice(&front[offset..]);
+                data.extend_from_slice(back);
+            } else {
+                data.extend_from_slice(&back[offset - front.len()..]);
+            }
+            channels.push(SnapshotChannel {
+                channel: arena.channel.clone(),
+                data,
+                messages: arena.messages.iter().skip(skip).copied().collect(),
+                cutoff,
+            });
+        }
+        channels
+    }
+}
+
+/// The messages of a channel copied out of the ring buffer for a snapshot.
+struct SnapshotChannel {
+    channel: Arc<RawChannel>,
+    data: Vec<u8>,
+    messages: Vec<(u64, usize)>,
+    cutoff: u64,
+}
+
+/// Writes a snapshot to a new MCAP file, with the messages of all channels in log time order.
+fn write_snapshot(
+    path: &Path,
+    options: McapWriteOptions,
+    channels: Vec<SnapshotChannel>,
+) -> Result<(), FoxgloveError> {
+    let context = Context::new();
+    let writer = McapWriter::with_options(options)
+        .context(&context)
+        .create_new_buffered_file(path)?;
+
+    let mut messages = Vec::new();
+    let mut raw_channels = Vec::with_capacity(channels.len());
+    for (index, snapshot) in channels.iter().enumerate() {
+        let channel = &snapshot.channel;
+        raw_channels.push(
+            ChannelBuilder::new(channel.topic())
+                .context(&context)
+                .message_encoding(channel.message_encoding())
+                .schema(channel.schema().cloned())
+                .metadata(channel.metadata().clone())
+                .build_raw()?,
+        );
+        let mut offset = 0;
+        for &(log_time, len) in &snapshot.messages {
+            if log_time >= snapshot.cutoff {
+                messages.push((log_time, index, offset..offset + len));
+            }
+            offset += len;
+        }
+    }
+    messages.sort_by_key(|(log_time, _, _)| *log_time);
+    for (log_time, index, range) in messages {
+        raw_channels[index].log_with_meta(
+            &channels[index].data[range],
+            PartialMetadata {
+                log_time: Some(log_time),
+            },
+        );
+    }
+    writer.close()?;
+    Ok(())
+}
+
+struct RingSink {
+    sink_id: SinkId,
+    channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+    window: u64,
+    max_bytes: usize,
+    state: Mutex<RingState>,
+}
+
+impl Debug for RingSink {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("RingSink")
+            .field("sink_id", &self.sink_id)
+            .finish_non_exhaustive()
+    }
+}
+
+impl Sink for RingSink {
+    fn id(&self) -> SinkId {
+        self.sink_id
+    }
+
+    fn log(
+        &self,
+        channel: &RawChannel,
+        msg: &[u8],
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        self.state
+            .lock()
+            .push(channel.id(), msg, metadata, self.window, self.max_bytes);
+        Ok(())
+    }
+
+    fn log_batch(
+        &self,
+        channel: &RawChannel,
+        msgs: &[(&[u8], Metadata)],
+    ) -> Result<(), FoxgloveError> {
+        let mut state = self.state.lock();
+        for (msg, metadata) in msgs {
+            state.push(channel.id(), msg, metadata, self.window, self.max_bytes);
+        }
+        Ok(())
+    }
+
+    fn add_channels(&self, channels: &[&Arc<RawChannel>]) -> Option<Vec<ChannelId>> {
+        let channels: Vec<_> = match &self.channel_filter {
+            Some(filter) => channels
+                .iter()
+                .copied()
+                .filter(|channel| filter.should_subscribe(channel.descriptor()))
+                .collect(),
+            None => channels.to_vec(),
+        };
+        let mut state = self.state.lock();
+        for channel in &channels {
+            state
+                .arenas
+                .entry(channel.id())
+                .or_insert_with(|| ChannelArena::new(Arc::clone(channel)));
+        }
+        self.channel_filter
+            .as_ref()
+            .map(|_| channels.iter().map(|channel| channel.id()).collect())
+    }
+
+    fn remove_channel(&self, channel: &RawChannel) {
+        let state = &mut *self.state.lock();
+        // Keep the channel's messages, which may be the ones leading up to an incident, until
+        // they are evicted.
+        if let Some(arena) = state.arenas.get_mut(&channel.id()) {
+            if arena.messages.is_empty() {
+                state.arenas.remove(&channel.id());
+            } else {
+                arena.removed = true;
+            }
+        }
+    }
+
+    fn auto_subscribe(&self) -> bool {
+        self.channel_filter.is_none()
+    }
+
+    fn sink_stats(&self) -> Option<SinkStats> {
+        let state = self.state.lock();
+        Some(SinkStats {
+            kind: "ring_buffer",
+            queued_messages: state.order.len(),
+            queued_bytes: state.bytes,
+            dropped_messages: state.dropped_messages,
+            ..SinkStats::default()
+        })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::Schema;
+
+    fn log(channel: &RawChannel, msg: &str, log_time: u64) {
+        channel.log_with_meta(
+            msg.as_bytes(),
+            PartialMetadata {
+                log_time: Some(log_time),
+            },
+        );
+    }
+
+    fn read_messages(path: &Path) -> Vec<(String, u64, String)> {
+        let contents = std::fs::read(path).expect("failed to read snapshot");
+        mcap::MessageStream::new(&contents)
+            .expect("failed to read messages")
+            .map(|message| {
+                let message = message.expect("invalid message");
+                (
+                    message.channel.topic.clone(),
+                    message.log_time,
+                    String::from_utf8(message.data.to_vec()).expect("invalid utf8"),
+                )
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_snapshot_writes_window_in_log_time_order() {
+        let ctx = Context::new();
+        let ring = RingBufferSink::new()
+            .context(&ctx)
+            .window(Duration::from_nanos(100))
+            .create()
+            .expect("failed to create sink");
+        let a = ChannelBuilder::new("/a")
+            .context(&ctx)
+            .message_encoding("json")
+            .schema(Schema::new("A", "jsonschema", b"{}".as_slice()))
+            .build_raw()
+            .unwrap();
+        let b = ChannelBuilder::new("/b")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .unwrap();
+
+        log(&a, "a0", 0);
+        log(&a, "a1", 100);
+        log(&b, "b1", 110);
+        log(&a, "a2", 150);
+        // a0 is evicted, since it is older than the window.
+        assert_eq!(ring.buffered_messages(), 3);
+        assert_eq!(ring.buffered_bytes(), 6);
+
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let path = dir.path().join("snapshot.mcap");
+        ring.snapshot(&path, Duration::from_nanos(45))
+            .expect("failed to start snapshot")
+            .wait()
+            .expect("failed to write snapshot");
+        assert_eq!(
+            read_messages(&path),
+            vec![
+                ("/b".to_string(), 110, "b1".to_string()),
+                ("/a".to_string(), 150, "a2".to_string()),
+            ]
+        );
+        let summary = crate::testutil::read_summary(&path);
+        let schema = summary
+            .channels
+            .values()
+            .find(|channel| channel.topic == "/a")
+            .and_then(|channel| channel.schema.clone())
+            .expect("missing schema");
+        assert_eq!(schema.name, "A");
+
+        // Snapshots never overwrite an existing file.
+        let result = ring
+            .snapshot(&path, Duration::from_secs(1))
+            .expect("failed to start snapshot")
+            .wait();
+        assert!(matches!(result, Err(FoxgloveError::IoError(_))));
+    }
+
+    #[test]
+    fn test_byte_limit_evicts_oldest_messages() {
+        let ctx = Context::new();
+        let ring = RingBufferSink::new()
+            .context(&ctx)
+            .max_bytes(4)
+            .create()
+            .expect("failed to create sink");
+        let a = ChannelBuilder::new("/a")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .unwrap();
+        let b = ChannelBuilder::new("/b")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .unwrap();
+
+        log(&a, "a0", 0);
+        log(&b, "b1", 1);
+        log(&a, "a2", 2);
+        log(&b, "too large", 3);
+        assert_eq!(ring.buffered_messages(), 2);
+        assert_eq!(ring.buffered_bytes(), 4);
+        assert_eq!(ctx.sink_stats().dropped_messages, 1);
+
+        // Messages of a removed channel are kept until they are evicted.
+        b.close();
+        let dir = tempfile::tempdir().expect("failed to create tempdir");
+        let path = dir.path().join("snapshot.mcap");
+        ring.snapshot(&path, Duration::from_secs(1))
+            .unwrap()
+            .wait()
+            .unwrap();
+        assert_eq!(
+            read_messages(&path),
+            vec![
+                ("/b".to_string(), 1, "b1".to_string()),
+                ("/a".to_string(), 2, "a2".to_string()),
+            ]
+        );
+        log(&a, "a3", 3);
+        log(&a, "a4", 4);
+        assert_eq!(ring.buffered_messages(), 2);
+        assert!(!ring.sink.state.lock().arenas.contains_key(&b.id()));
+
+        ring.close();
+        assert_eq!(ctx.sink_stats(), SinkStats::default());
+    }
+}
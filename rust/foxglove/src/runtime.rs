@@ -3,7 +3,168 @@
 use std::sync::OnceLock;
 
 use parking_lot::Mutex;
-use tokio::runtime::Handle;
+use tokio::runtime::{Builder, Handle};
+
+use crate::FoxgloveError;
+
+/// Options for the internal tokio runtime which the SDK creates for its servers and publishers.
+///
+/// Set them with [`set_runtime_options`], before starting anything which uses the runtime. They
+/// have no effect on tasks which run on a runtime of the application's own.
+#[derive(Debug, Clone, Default)]
+pub struct RuntimeOptions {
+    worker_threads: Option<usize>,
+    thread_name: Option<String>,
+    cpu_affinity: Option<Vec<usize>>,
+    nice: Option<i32>,
+}
+
+impl RuntimeOptions {
+    /// Creates default options.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Sets the number of worker threads. By default, there is one per CPU.
+    pub fn worker_threads(mut self, threads: usize) -> Self {
+        self.worker_threads = Some(threads);
+        self
+    }
+
+    /// Sets the name of the runtime's threads. The default is "tokio-runtime-worker".
+    pub fn thread_name(mut self, name: impl Into<String>) -> Self {
+        self.thread_name = Some(name.into());
+        self
+    }
+
+    /// Restricts the runtime's threads to the given CPUs, by index.
+    ///
+    /// This keeps the SDK off cores which are reserved for other work, such as real-time control
+    /// loops. Only supported on Linux.
+    pub fn cpu_affinity(mut self, cpus: impl IntoIterator<Item = usize>) -> Self {
+        self.cpu_affinity = Some(cpus.into_iter().collect());
+        self
+    }
+
+    /// Sets the nice value of the runtime's threads, from -20 (highest priority) to 19 (lowest).
+    ///
+    /// Raising the priority requires privileges. Only supported on Linux.
+    pub fn nice(mut self, nice: i32) -> Self {
+        self.nice = Some(nice);
+        self
+    }
+
+    fn validate(&self) -> Result<(), FoxgloveError> {
+        if self.worker_threads == Some(0) {
+            return Err(FoxgloveError::ValueError(
+                "worker_threads must be greater than zero".to_string(),
+            ));
+        }
+        if let Some(cpus) = &self.cpu_affinity {
+            if cpus.is_empty() {
+                return Err(FoxgloveError::ValueError(
+                    "cpu_affinity must contain at least one CPU".to_string(),
+                ));
+            }
+            #[cfg(target_os = "linux")]
+            if let Some(cpu) = cpus.iter().find(|cpu| **cpu >= libc::CPU_SETSIZE as usize) {
+                return Err(FoxgloveError::ValueError(format!(
+                    "CPU index {cpu} is out of range"
+                )));
+            }
+        }
+        if let Some(nice) = self.nice
+            && !(-20..=19).contains(&nice)
+        {
+            return Err(FoxgloveError::ValueError(format!(
+                "nice value {nice} is out of range"
+            )));
+        }
+        #[cfg(not(target_os = "linux"))]
+        if self.cpu_affinity.is_some() || self.nice.is_some() {
+            return Err(FoxgloveError::ConfigurationError(
+                "CPU affinity and nice values are only supported on Linux".to_string(),
+            ));
+        }
+        Ok(())
+    }
+
+    /// Configures a builder for a runtime of the SDK.
+    ///
+    /// The thread placement also applies to other runtimes the SDK creates, such as the dedicated
+    /// runtime of a WebSocket server with writer threads.
+    pub(crate) fn configure(&self, builder: &mut Builder) {
+        if self.cpu_affinity.is_some() || self.nice.is_some() {
+            let cpu_affinity = self.cpu_affinity.clone();
+            let nice = self.nice;
+            builder.on_thread_start(move || place_thread(cpu_affinity.as_deref(), nice));
+        }
+    }
+}
+
+/// Applies CPU affinity and a nice value to the calling thread.
+#[cfg(target_os = "linux")]
+fn place_thread(cpu_affinity: Option<&[usize]>, nice: Option<i32>) {
+    if let Some(cpus) = cpu_affinity {
+        // Safety: cpu_set_t is a plain bitmask, and the indices were validated.
+        let result = unsafe {
+            let mut set: libc::cpu_set_t = std::mem::zeroed();
+            for &cpu in cpus {
+                libc::CPU_SET(cpu, &mut set);
+            }
+            libc::sched_setaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), &set)
+        };
+        if result != 0 {
+            tracing::warn!(
+                "Failed to set runtime thread affinity: {}",
+                std::io::Error::last_os_error()
+            );
+        }
+    }
+    if let Some(nice) = nice {
+        // On Linux, the nice value is per thread, and applies to the thread with the given ID.
+        // Safety: gettid and setpriority have no memory safety requirements.
+        let result = unsafe {
+            let tid = libc::syscall(libc::SYS_gettid) as libc::id_t;
+            libc::setpriority(libc::PRIO_PROCESS, tid, nice)
+        };
+        if result != 0 {
+            tracing::warn!(
+                "Failed to set runtime thread nice value: {}",
+                std::io::Error::last_os_error()
+            );
+        }
+    }
+}
+
+#[cfg(not(target_os = "linux"))]
+fn place_thread(_cpu_affinity: Option<&[usize]>, _nice: Option<i32>) {}
+
+/// The options of the internal runtime, and whether it was created with them.
+static OPTIONS: Mutex<(Option<RuntimeOptions>, bool)> = Mutex::new((None, false));
+
+/// Sets the options of the SDK's internal tokio runtime.
+///
+/// This must be called before starting anything which creates the runtime, such as a WebSocket
+/// server started with `WebSocketServer::start_blocking`. Returns
+/// [`FoxgloveError::ConfigurationError`] if the runtime was already created, and
+/// [`FoxgloveError::ValueError`] if the options are invalid.
+pub fn set_runtime_options(options: RuntimeOptions) -> Result<(), FoxgloveError> {
+    options.validate()?;
+    let mut current = OPTIONS.lock();
+    if current.1 {
+        return Err(FoxgloveError::ConfigurationError(
+            "the runtime is already running".to_string(),
+        ));
+    }
+    current.0 = Some(options);
+    Ok(())
+}
+
+/// Returns the options set with [`set_runtime_options`].
+pub(crate) fn runtime_options() -> RuntimeOptions {
+    OPTIONS.lock().0.clone().unwrap_or_default()
+}
 
 struct Runtime {
     inner: Mutex<Option<tokio::runtime::Runtime>>,
@@ -12,10 +173,21 @@ struct Runtime {
 impl Runtime {
     fn new() -> Self {
         tracing::debug!("Creating tokio runtime");
-        let rt = tokio::runtime::Builder::new_multi_thread()
-            .enable_all()
-            .build()
-            .expect("Failed to create tokio runtime");
+        let options = {
+            let mut current = OPTIONS.lock();
+            current.1 = true;
+            current.0.clone().unwrap_or_default()
+        };
+        let mut builder = Builder::new_multi_thread();
+        builder.enable_all();
+        if let Some(threads) = options.worker_threads {
+            builder.worker_threads(threads);
+        }
+        if let Some(name) = &options.thread_name {
+            builder.thread_name(name);
+        }
+        options.configure(&mut builder);
+        let rt = builder.build().expect("Failed to create tokio runtime");
         let handle = rt.handle().clone();
         Self {
             inner: Mutex::new(Some(rt)),
@@ -59,3 +231,30 @@ pub fn shutdown_runtime() {
         rt.shutdown()
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_validate_runtime_options() {
+        assert!(RuntimeOptions::new().validate().is_ok());
+        assert!(RuntimeOptions::new().worker_threads(0).validate().is_err());
+        assert!(RuntimeOptions::new().nice(20).validate().is_err());
+        assert!(
+            RuntimeOptions::new()
+                .cpu_affinity(Vec::new())
+                .validate()
+                .is_err()
+        );
+        #[cfg(target_os = "linux")]
+        assert!(
+            RuntimeOptions::new()
+                .worker_threads(2)
+                .cpu_affinity([0])
+                .nice(5)
+                .validate()
+                .is_ok()
+        );
+    }
+}
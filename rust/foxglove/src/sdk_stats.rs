@@ -0,0 +1,538 @@
+//! Optional publisher that reports the SDK's internal performance counters.
+//!
+//! Build an [`SdkStatsPublisher`] and call [`SdkStatsPublisher::start`] to spawn a background
+//! task that periodically logs an SdkStats message to a channel. The default channel is
+//! `/foxglove/sdk_stats`, and the default refresh interval is 1s. The messages can be plotted
+//! live in Foxglove, to see where the SDK spends its time and bandwidth.
+//!
+//! The returned [`SdkStatsHandle`] can be `.await`ed to wait for the publisher to complete, or
+//! aborted with [`SdkStatsHandle::abort`].
+
+use std::borrow::Cow;
+use std::collections::HashMap;
+use std::future::Future;
+use std::pin::Pin;
+use std::sync::{Arc, Weak};
+use std::task::{Context as TaskContext, Poll};
+use std::time::{Duration, Instant};
+
+use bytes::BufMut;
+use serde::Serialize;
+use tokio::task::JoinHandle;
+use tokio::time::MissedTickBehavior;
+
+use crate::context::LoggedCountersReader;
+use crate::{
+    Channel, ChannelBuilder, Context, Encode, Schema, SinkStats, runtime::get_runtime_handle,
+};
+
+/// The default topic the [`SdkStatsPublisher`] publishes to.
+pub const DEFAULT_SDK_STATS_TOPIC: &str = "/foxglove/sdk_stats";
+
+/// The default refresh interval for [`SdkStatsPublisher`].
+pub const DEFAULT_SDK_STATS_REFRESH_INTERVAL: Duration = Duration::from_secs(1);
+
+/// The shortest refresh interval for [`SdkStatsPublisher`].
+const MIN_REFRESH_INTERVAL: Duration = Duration::from_millis(100);
+
+/// JSON Schema (draft 2020-12) describing SdkStats for consumers of the `/foxglove/sdk_stats`
+/// topic.
+const SDK_STATS_JSON_SCHEMA: &str = r#"{
+  "$schema": "https://json-schema.org/draft/2020-12/schema",
+  "title": "SdkStats",
+  "description": "A snapshot of the Foxglove SDK's internal performance counters. Counters are totals since the channel or sink was created, and rates are averaged over the most recent refresh interval.",
+  "type": "object",
+  "properties": {
+    "channels": {
+      "type": "array",
+      "description": "Counters for each channel of the context, ordered by channel ID.",
+      "items": {
+        "type": "object",
+        "properties": {
+          "id": { "type": "integer", "description": "The channel ID." },
+          "topic": { "type": "string", "description": "The channel topic." },
+          "logged_messages": { "type": "integer", "description": "Messages logged to the channel's sinks. Messages logged while no sink is subscribed are not counted." },
+          "logged_bytes": { "type": "integer", "description": "Total size of the messages logged to the channel's sinks, in bytes." },
+          "logged_messages_per_sec": { "type": "number", "description": "Messages logged to the channel's sinks per second." },
+          "logged_bytes_per_sec": { "type": "number", "description": "Bytes logged to the channel's sinks per second." }
+        }
+      }
+    },
+    "sinks": {
+      "type": "array",
+      "description": "Counters for each sink of the context which reports them, such as each WebSocket client, MCAP writer and remote access session, ordered by sink ID.",
+      "items": {
+        "type": "object",
+        "properties": {
+          "id": { "type": "integer", "description": "The sink ID." },
+          "kind": { "type": "string", "description": "The kind of sink: websocket_client, mcap or remote_access." },
+          "queued_messages": { "type": "integer", "description": "Messages currently queued by the sink." },
+          "queued_bytes": { "type": "integer", "description": "Bytes currently queued by the sink." },
+          "sent_messages": { "type": "integer", "description": "Messages sent to a client, or written to a file." },
+          "sent_bytes": { "type": "integer", "description": "Bytes sent to a client, or written to a file before compression." },
+          "dropped_messages": { "type": "integer", "description": "Messages dropped because the sink's queue was full." },
+          "sent_messages_per_sec": { "type": "number", "description": "Messages sent or written per second." },
+          "sent_bytes_per_sec": { "type": "number", "description": "Bytes sent or written per second, before compression." },
+          "written_bytes": { "type": "integer", "description": "Bytes written to the sink's output, after encoding and compression." },
+          "compression_ratio": { "type": "number", "description": "The ratio of written_bytes to sent_bytes, if the sink writes encoded output. Includes the file's records and indexes as well as its compressed chunks." },
+          "write_seconds": { "type": "number", "description": "Total time spent encoding, compressing and writing messages, in seconds." },
+          "write_load": { "type": "number", "description": "The fraction of the most recent refresh interval spent encoding, compressing and writing messages." },
+          "video_tracks": { "type": "integer", "description": "Video tracks published by the sink." },
+          "video_bitrate": { "type": "integer", "description": "The estimated bitrate available to all of the sink's video tracks, in bits per second, or 0 if it has not been estimated." }
+        }
+      }
+    }
+  }
+}"#;
+
+/// Counters for a channel.
+#[derive(Debug, Default, Serialize)]
+struct ChannelEntry {
+    id: u64,
+    topic: String,
+    logged_messages: u64,
+    logged_bytes: u64,
+    logged_messages_per_sec: f64,
+    logged_bytes_per_sec: f64,
+}
+
+/// Counters for a sink.
+#[derive(Debug, Default, Serialize)]
+struct SinkEntry {
+    id: u64,
+    kind: &'static str,
+    queued_messages: usize,
+    queued_bytes: usize,
+    sent_messages: u64,
+    sent_bytes: u64,
+    dropped_messages: u64,
+    sent_messages_per_sec: f64,
+    sent_bytes_per_sec: f64,
+    written_bytes: u64,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    compression_ratio: Option<f64>,
+    write_seconds: f64,
+    write_load: f64,
+    video_tracks: usize,
+    video_bitrate: u64,
+}
+
+/// A snapshot of the SDK's internal performance counters.
+#[derive(Debug, Default, Serialize)]
+struct SdkStats {
+    channels: Vec<ChannelEntry>,
+    sinks: Vec<SinkEntry>,
+}
+
+impl Encode for SdkStats {
+    type Error = serde_json::Error;
+
+    fn get_schema() -> Option<Schema> {
+        Some(Schema::new(
+            "foxglove.SdkStats".to_string(),
+            "jsonschema".to_string(),
+            Cow::Borrowed(SDK_STATS_JSON_SCHEMA.as_bytes()),
+        ))
+    }
+
+    fn get_message_encoding() -> String {
+        "json".to_string()
+    }
+
+    fn encode(&self, buf: &mut impl BufMut) -> Result<(), Self::Error> {
+        serde_json::to_writer(buf.writer(), self)
+    }
+}
+
+/// Builder for the SDK stats publisher.
+///
+/// The publisher creates a channel on the configured [`Context`] and spawns a background task
+/// that periodically logs an SdkStats message to the channel with the counters of the context's
+/// channels and sinks:
+///
+/// - For each channel, the number of messages and bytes logged to its sinks while the publisher
+///   runs.
+/// - For each WebSocket client, the messages and bytes sent to the client, queued for it, and
+///   dropped from its backlog.
+/// - For each MCAP writer, the messages and bytes written, the size of the file after
+///   compression, and the time spent encoding and compressing chunks.
+/// - For each remote access session, the number of video tracks and the bitrate estimated to
+///   be available to them.
+///
+/// Each message is a JSON object with a JSON Schema attached to the channel. Counters are totals,
+/// and each is accompanied by a rate over the most recent refresh interval. The sink counters are
+/// maintained whether or not the publisher is running; channels only count the messages they log
+/// while a publisher reads them, so that logging doesn't otherwise update shared counters.
+///
+/// ```no_run
+/// use foxglove::sdk_stats::SdkStatsPublisher;
+///
+/// # async fn run() {
+/// let handle = SdkStatsPublisher::new().start();
+/// // ... do other work ...
+/// handle.abort();
+/// # }
+/// ```
+#[must_use]
+#[derive(Debug, Default)]
+pub struct SdkStatsPublisher {
+    topic: Option<String>,
+    refresh_interval: Option<Duration>,
+    context: Option<Arc<Context>>,
+}
+
+impl SdkStatsPublisher {
+    /// Creates a new publisher builder with default settings.
+    ///
+    /// The defaults are:
+    /// - topic: [`DEFAULT_SDK_STATS_TOPIC`] (`/foxglove/sdk_stats`)
+    /// - refresh interval: [`DEFAULT_SDK_STATS_REFRESH_INTERVAL`] (1s)
+    /// - context: the global default context
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Overrides the channel topic name.
+    ///
+    /// Defaults to [`DEFAULT_SDK_STATS_TOPIC`].
+    pub fn topic(mut self, topic: impl Into<String>) -> Self {
+        self.topic = Some(topic.into());
+        self
+    }
+
+    /// Sets the refresh interval.
+    ///
+    /// The interval is clamped to a minimum of 100ms.
+    ///
+    /// Defaults to [`DEFAULT_SDK_STATS_REFRESH_INTERVAL`].
+    pub fn refresh_interval(mut self, interval: Duration) -> Self {
+        self.refresh_interval = Some(interval);
+        self
+    }
+
+    /// Sets the [`Context`] whose channels and sinks are reported, and on which the publisher
+    /// creates its channel.
+    ///
+    /// Defaults to the global default context.
+    pub fn context(mut self, ctx: &Arc<Context>) -> Self {
+        self.context = Some(ctx.clone());
+        self
+    }
+
+    /// Starts the publisher and returns an [`SdkStatsHandle`] for the background task.
+    ///
+    /// The task is intended to run until [`SdkStatsHandle::abort`] is called on the returned
+    /// handle.
+    ///
+    /// The publisher creates its channel and registers it with the context synchronously before
+    /// spawning the background task. The channel is closed when the background task exits (for
+    /// example after `abort`).
+    pub fn start(self) -> SdkStatsHandle {
+        let refresh_interval = self
+            .refresh_interval
+            .unwrap_or(DEFAULT_SDK_STATS_REFRESH_INTERVAL)
+            .max(MIN_REFRESH_INTERVAL);
+        let topic = self
+            .topic
+            .unwrap_or_else(|| DEFAULT_SDK_STATS_TOPIC.to_string());
+        let context = self.context.unwrap_or_else(Context::get_default);
+
+        // Create the channel synchronously so it's registered before start() returns.
+        let channel = ChannelBuilder::new(topic)
+            .context(&context)
+            .build::<SdkStats>();
+
+        SdkStatsHandle {
+            inner: get_runtime_handle().spawn(run_publisher(
+                channel,
+                refresh_interval,
+                Arc::downgrade(&context),
+            )),
+        }
+    }
+}
+
+/// Handle to a running [`SdkStatsPublisher`] background task.
+///
+/// Returned by [`SdkStatsPublisher::start`]. The handle can be `.await`ed to wait for the
+/// publisher to finish, or [`abort`](Self::abort)ed to stop it. Dropping the handle does not
+/// stop the publisher; it will continue running until [`abort`](Self::abort) is called.
+#[must_use = "the publisher keeps running until aborted; the handle is the only way to wait for or abort it"]
+#[derive(Debug)]
+pub struct SdkStatsHandle {
+    inner: JoinHandle<()>,
+}
+
+impl SdkStatsHandle {
+    /// Aborts the publisher's background task.
+    ///
+    /// The task is signaled to stop at the next `.await` point. After calling this, awaiting the
+    /// handle will resolve once the task has actually terminated.
+    pub fn abort(&self) {
+        self.inner.abort();
+    }
+}
+
+impl Future for SdkStatsHandle {
+    type Output = ();
+
+    fn poll(mut self: Pin<&mut Self>, cx: &mut TaskContext<'_>) -> Poll<Self::Output> {
+        // As for the system info publisher, swallow the JoinError so that this handle does not
+        // expose tokio types in its public API.
+        Pin::new(&mut self.inner).poll(cx).map(|_| ())
+    }
+}
+
+async fn run_publisher(
+    channel: Channel<SdkStats>,
+    refresh_interval: Duration,
+    context: Weak<Context>,
+) {
+    let mut sampler = Sampler::new(context);
+    let mut interval = tokio::time::interval(refresh_interval);
+    interval.set_missed_tick_behavior(MissedTickBehavior::Skip);
+    // The first tick fires immediately; consume it to align subsequent ticks to the period.
+    interval.tick().await;
+
+    loop {
+        interval.tick().await;
+        channel.log(&sampler.sample());
+    }
+}
+
+/// Reads the counters of a context's channels and sinks, and the rates since the previous
+/// sample.
+struct Sampler {
+    context: Weak<Context>,
+    /// Keeps the channels' logged counters enabled while the sampler reads them.
+    _logged_counters: Option<LoggedCountersReader>,
+    /// The logged messages and bytes of each channel at the previous sample.
+    channels: HashMap<u64, (u64, u64)>,
+    /// The counters of each sink at the previous sample.
+    sinks: HashMap<u64, SinkStats>,
+    last_sample: Instant,
+}
+
+impl Sampler {
+    /// Creates a sampler, and takes the initial sample of the counters.
+    fn new(context: Weak<Context>) -> Self {
+        let mut sampler = Self {
+            _logged_counters: context
+                .upgrade()
+                .map(|context| context.read_logged_counters()),
+            context,
+            channels: HashMap::new(),
+            sinks: HashMap::new(),
+            last_sample: Instant::now(),
+        };
+        sampler.sample();
+        sampler
+    }
+
+    fn sample(&mut self) -> SdkStats {
+        let Some(context) = self.context.upgrade() else {
+            return SdkStats::default();
+        };
+        let now = Instant::now();
+        let elapsed = now.duration_since(self.last_sample).as_secs_f64();
+        self.last_sample = now;
+        let rate = |current: u64, previous: u64| {
+            if elapsed > 0.0 {
+                current.saturating_sub(previous) as f64 / elapsed
+            } else {
+                0.0
+            }
+        };
+
+        let mut previous_channels = std::mem::take(&mut self.channels);
+        let channels = context
+            .channels()
+            .iter()
+            .map(|channel| {
+                let id = u64::from(channel.id());
+                let (messages, bytes) = channel.logged();
+                let (prev_messages, prev_bytes) = previous_channels.remove(&id).unwrap_or_default();
+                self.channels.insert(id, (messages, bytes));
+                ChannelEntry {
+                    id,
+                    topic: channel.topic().to_string(),
+                    logged_messages: messages,
+                    logged_bytes: bytes,
+                    logged_messages_per_sec: rate(messages, prev_messages),
+                    logged_bytes_per_sec: rate(bytes, prev_bytes),
+                }
+            })
+            .collect();
+
+        let mut previous_sinks = std::mem::take(&mut self.sinks);
+        let sinks = context
+            .sink_stats_by_sink()
+            .into_iter()
+            .map(|(id, stats)| {
+                let id = u64::from(id);
+                let previous = previous_sinks.remove(&id).unwrap_or_default();
+                self.sinks.insert(id, stats);
+                let write_time = stats.write_time.saturating_sub(previous.write_time);
+                SinkEntry {
+                    id,
+                    kind: stats.kind,
+                    queued_messages: stats.queued_messages,
+                    queued_bytes: stats.queued_bytes,
+                    sent_messages: stats.sent_messages,
+                    sent_bytes: stats.sent_bytes,
+                    dropped_messages: stats.dropped_messages,
+                    sent_messages_per_sec: rate(stats.sent_messages, previous.sent_messages),
+                    sent_bytes_per_sec: rate(stats.sent_bytes, previous.sent_bytes),
+                    written_bytes: stats.written_bytes,
+                    compression_ratio: (stats.written_bytes > 0 && stats.sent_bytes > 0)
+                        .then(|| stats.written_bytes as f64 / stats.sent_bytes as f64),
+                    write_seconds: stats.write_time.as_secs_f64(),
+                    write_load: if elapsed > 0.0 {
+                        write_time.as_secs_f64() / elapsed
+                    } else {
+                        0.0
+                    },
+                    video_tracks: stats.video_tracks,
+                    video_bitrate: stats.video_bitrate,
+                }
+            })
+            .collect();
+
+        SdkStats { channels, sinks }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::collections::BTreeSet;
+
+    use super::*;
+    use crate::testutil::MockSink;
+    use crate::{FoxgloveError, Metadata, PartialMetadata, RawChannel, Sink, SinkId};
+
+    fn keys(value: &serde_json::Value) -> BTreeSet<String> {
+        value
+            .as_object()
+            .expect("value is a JSON object")
+            .keys()
+            .cloned()
+            .collect()
+    }
+
+    #[test]
+    fn schema_properties_match_serialized_fields() {
+        // Guards against drift between the hand-written JSON schema and the serialized structs.
+        let stats = SdkStats {
+            channels: vec![ChannelEntry::default()],
+            sinks: vec![SinkEntry {
+                compression_ratio: Some(0.5),
+                ..SinkEntry::default()
+            }],
+        };
+        let serialized = serde_json::to_value(stats).expect("SdkStats serializes");
+        let schema: serde_json::Value =
+            serde_json::from_str(SDK_STATS_JSON_SCHEMA).expect("schema is valid JSON");
+        let properties = &schema["properties"];
+        assert_eq!(keys(properties), keys(&serialized));
+        for field in ["channels", "sinks"] {
+            assert_eq!(
+                keys(&properties[field]["items"]["properties"]),
+                keys(&serialized[field][0]),
+                "JSON schema properties must match the serialized fields of {field}"
+            );
+        }
+    }
+
+    #[test]
+    fn samples_channel_and_sink_counters() {
+        struct StatsSink(SinkId);
+        impl Sink for StatsSink {
+            fn id(&self) -> SinkId {
+                self.0
+            }
+            fn log(
+                &self,
+                _channel: &RawChannel,
+                _msg: &[u8],
+                _metadata: &Metadata,
+            ) -> Result<(), FoxgloveError> {
+                Ok(())
+            }
+            fn sink_stats(&self) -> Option<SinkStats> {
+                Some(SinkStats {
+                    kind: "test",
+                    sent_bytes: 200,
+                    written_bytes: 50,
+                    ..SinkStats::default()
+                })
+            }
+        }
+
+        let ctx = Context::new();
+        let channel = ctx
+            .channel_builder("/topic")
+            .message_encoding("raw")
+            .build_raw()
+            .unwrap();
+        let mut sampler = Sampler::new(Arc::downgrade(&ctx));
+
+        // Messages logged without sinks are not counted.
+        channel.log(b"ignored");
+        ctx.add_sink(Arc::new(StatsSink(SinkId::next())));
+        ctx.add_sink(Arc::new(MockSink::default()));
+        channel.log(b"abc");
+        channel.log_batch(&[
+            (&b"de"[..], PartialMetadata::default()),
+            (&b"f"[..], PartialMetadata::default()),
+        ]);
+
+        let stats = sampler.sample();
+        assert_eq!(stats.channels.len(), 1);
+        let entry = &stats.channels[0];
+        assert_eq!(entry.topic, "/topic");
+        assert_eq!((entry.logged_messages, entry.logged_bytes), (3, 6));
+        assert!(entry.logged_messages_per_sec > 0.0);
+
+        // Sinks which don't report stats are omitted.
+        assert_eq!(stats.sinks.len(), 1);
+        let entry = &stats.sinks[0];
+        assert_eq!(entry.kind, "test");
+        assert_eq!(entry.compression_ratio, Some(0.25));
+
+        // Rates are computed from the difference between samples.
+        let stats = sampler.sample();
+        assert_eq!(stats.channels[0].logged_messages, 3);
+        assert_eq!(stats.channels[0].logged_messages_per_sec, 0.0);
+        assert_eq!(stats.sinks[0].sent_bytes_per_sec, 0.0);
+    }
+
+    #[test]
+    fn channels_count_only_while_sampled() {
+        let ctx = Context::new();
+        let channel = ctx
+            .channel_builder("/topic")
+            .message_encoding("raw")
+            .build_raw()
+            .unwrap();
+        ctx.add_sink(Arc::new(MockSink::default()));
+
+        channel.log(b"before");
+        let mut sampler = Sampler::new(Arc::downgrade(&ctx));
+        channel.log(b"during");
+        assert_eq!(channel.logged(), (1, 6));
+        assert_eq!(sampler.sample().channels[0].logged_messages, 1);
+
+        drop(sampler);
+        channel.log(b"after");
+        assert_eq!(channel.logged(), (1, 6));
+    }
+
+    #[test]
+    fn samples_nothing_once_context_is_dropped() {
+        let ctx = Context::new();
+        let mut sampler = Sampler::new(Arc::downgrade(&ctx));
+        drop(ctx);
+        let stats = sampler.sample();
+        assert!(stats.channels.is_empty() && stats.sinks.is_empty());
+    }
+}
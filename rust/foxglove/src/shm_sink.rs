@@ -0,0 +1,603 @@
+//! Shared-memory sink, for viewers on the same host.
+use std::collections::BTreeMap;
+use std::fmt::Debug;
+use std::fs::{File, OpenOptions};
+use std::path::{Path, PathBuf};
+use std::sync::{Arc, Weak};
+
+use parking_lot::Mutex;
+
+use crate::sink_channel_filter::{SinkChannelFilter, SinkChannelFilterFn};
+use crate::websocket::ws_protocol::JsonMessage;
+use crate::websocket::ws_protocol::server::Unadvertise;
+use crate::websocket::ws_protocol::server::advertise::advertise_channels;
+use crate::{
+    ChannelDescriptor, ChannelId, Context, FoxgloveError, Metadata, RawChannel, Sink, SinkId,
+};
+
+mod ring;
+
+use ring::{RecordKind, RingReader, RingWriter};
+
+/// The default capacity of the ring buffer, in bytes.
+const DEFAULT_CAPACITY: usize = 64 << 20;
+
+/// A sink which writes messages to a ring buffer in shared memory.
+///
+/// Viewers on the same host can read messages from the ring buffer without the framing and copies
+/// of a loopback WebSocket connection. Logging a message copies it into the ring buffer once.
+/// Channels are advertised in the ring buffer as ws-protocol `advertise` messages, the same way
+/// as the [`WebSocketServer`][crate::WebSocketServer] advertises them to its clients.
+///
+/// Readers find the ring buffer from the sink's [token][SharedMemorySinkHandle::token], which a
+/// WebSocket server can hand to its clients in its server info, with
+/// [`WebSocketServer::shared_memory_sink`][crate::WebSocketServer::shared_memory_sink]. Clients
+/// which cannot open the ring buffer, such as those on other hosts, continue to use the WebSocket
+/// connection.
+///
+/// The ring buffer never blocks the logging thread. Readers which fall behind by more than the
+/// ring buffer's capacity skip to the latest messages.
+#[must_use]
+#[derive(Clone)]
+pub struct SharedMemorySink {
+    path: Option<PathBuf>,
+    capacity: usize,
+    context: Arc<Context>,
+    channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+}
+
+impl Debug for SharedMemorySink {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("SharedMemorySink")
+            .field("path", &self.path)
+            .field("capacity", &self.capacity)
+            .field("context", &self.context)
+            .finish_non_exhaustive()
+    }
+}
+
+impl Default for SharedMemorySink {
+    fn default() -> Self {
+        Self {
+            path: None,
+            capacity: DEFAULT_CAPACITY,
+            context: Context::get_default(),
+            channel_filter: None,
+        }
+    }
+}
+
+impl SharedMemorySink {
+    /// Instantiates a new shared-memory sink with default options.
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Sets the path of the file which holds the ring buffer.
+    ///
+    /// By default, a new file is created in `/dev/shm`, or in the temporary directory if
+    /// `/dev/shm` does not exist. The file is removed when the sink is closed.
+    pub fn path(mut self, path: impl Into<PathBuf>) -> Self {
+        self.path = Some(path.into());
+        self
+    }
+
+    /// Sets the capacity of the ring buffer, in bytes.
+    ///
+    /// The capacity limits the size of the largest message, and how far readers may fall behind
+    /// before they skip messages. The default is 64 MiB.
+    pub fn capacity(mut self, capacity: usize) -> Self {
+        self.capacity = capacity;
+        self
+    }
+
+    /// Sets the context for this sink.
+    #[doc(hidden)]
+    pub fn context(mut self, ctx: &Arc<Context>) -> Self {
+        self.context = ctx.clone();
+        self
+    }
+
+    /// Sets a [`SinkChannelFilter`] for this sink.
+    pub fn channel_filter(mut self, filter: Arc<dyn SinkChannelFilter>) -> Self {
+        self.channel_filter = Some(filter);
+        self
+    }
+
+    /// Sets a channel filter for this sink. See [`SinkChannelFilter`] for more information.
+    pub fn channel_filter_fn(
+        mut self,
+        filter: impl Fn(&ChannelDescriptor) -> bool + Sync + Send + 'static,
+    ) -> Self {
+        self.channel_filter = Some(Arc::new(SinkChannelFilterFn(filter)));
+        self
+    }
+
+    /// Creates the ring buffer, and begins logging events to it.
+    ///
+    /// If the file already exists, this call will fail with
+    /// [`AlreadyExists`](`std::io::ErrorKind::AlreadyExists`).
+    pub fn create(self) -> Result<SharedMemorySinkHandle, FoxgloveError> {
+        if self.capacity == 0 {
+            return Err(FoxgloveError::ValueError(
+                "shared memory capacity must be greater than zero".to_string(),
+            ));
+        }
+        let sink_id = SinkId::next();
+        let path = self.path.unwrap_or_else(|| default_path(sink_id));
+        let token = path
+            .to_str()
+            .ok_or_else(|| FoxgloveError::Utf8Error(format!("invalid path: {}", path.display())))?
+            .to_string();
+        let file = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create_new(true)
+            .open(&path)?;
+        let ring = match RingWriter::create(&file, self.capacity) {
+            Ok(ring) => ring,
+            Err(e) => {
+                std::fs::remove_file(&path).ok();
+                return Err(e.into());
+            }
+        };
+        let sink = Arc::new(ShmSink {
+            sink_id,
+            channel_filter: self.channel_filter,
+            state: Mutex::new(Some(SinkState::new(ring))),
+        });
+        self.context.add_sink(sink.clone());
+        Ok(SharedMemorySinkHandle {
+            sink,
+            context: Arc::downgrade(&self.context),
+            path,
+            token,
+        })
+    }
+}
+
+/// Returns a path for the ring buffer which is unique to this process and sink.
+fn default_path(sink_id: SinkId) -> PathBuf {
+    let dir = Path::new("/dev/shm");
+    let dir = if dir.is_dir() {
+        dir.to_path_buf()
+    } else {
+        std::env::temp_dir()
+    };
+    dir.join(format!("foxglove-{}-{sink_id}", std::process::id()))
+}
+
+/// A handle to a shared-memory sink.
+///
+/// When this handle is dropped, the sink will unregister from the [`Context`], stop logging
+/// events, and remove its file. Readers which already opened the ring buffer can finish reading
+/// it.
+#[must_use]
+#[derive(Debug)]
+pub struct SharedMemorySinkHandle {
+    sink: Arc<ShmSink>,
+    context: Weak<Context>,
+    path: PathBuf,
+    token: String,
+}
+
+impl SharedMemorySinkHandle {
+    /// Returns the token which local readers pass to [`SharedMemoryReader::open`] to open the ring
+    /// buffer.
+    pub fn token(&self) -> &str {
+        &self.token
+    }
+
+    /// Stops logging events, and removes the ring buffer's file.
+    pub fn close(self) -> Result<(), FoxgloveError> {
+        self.finish()
+    }
+
+    fn finish(&self) -> Result<(), FoxgloveError> {
+        if let Some(context) = self.context.upgrade() {
+            context.remove_sink(self.sink.id());
+        }
+        if self.sink.close() {
+            match std::fs::remove_file(&self.path) {
+                Err(e) if e.kind() != std::io::ErrorKind::NotFound => return Err(e.into()),
+                _ => (),
+            }
+        }
+        Ok(())
+    }
+}
+
+impl Drop for SharedMemorySinkHandle {
+    fn drop(&mut self) {
+        if let Err(e) = self.finish() {
+            tracing::warn!("{e}");
+        }
+    }
+}
+
+struct SinkState {
+    ring: RingWriter,
+    channels: BTreeMap<ChannelId, Arc<RawChannel>>,
+    /// An advertisement of every channel, which starts each lap of the ring.
+    advertisement: String,
+}
+
+impl SinkState {
+    fn new(ring: RingWriter) -> Self {
+        Self {
+            ring,
+            channels: BTreeMap::new(),
+            advertisement: advertise_channels([]).to_string(),
+        }
+    }
+
+    fn update_advertisement(&mut self) {
+        self.advertisement = advertise_channels(self.channels.values()).to_string();
+    }
+
+    fn write(&mut self, kind: RecordKind, parts: &[&[u8]]) -> Result<(), FoxgloveError> {
+        self.ring
+            .write(self.advertisement.as_bytes(), kind, parts)
+            .map_err(FoxgloveError::from)
+    }
+
+    fn add_channels(&mut self, channels: &[&Arc<RawChannel>]) {
+        let message = advertise_channels(channels.iter().copied());
+        if message.channels.is_empty() {
+            return;
+        }
+        for channel in channels {
+            if message
+                .channels
+                .iter()
+                .any(|c| c.id == u64::from(channel.id()))
+            {
+                self.channels.insert(channel.id(), Arc::clone(channel));
+            }
+        }
+        let json = message.to_string();
+        self.update_advertisement();
+        if let Err(e) = self.write(RecordKind::Advertise, &[json.as_bytes()]) {
+            tracing::error!("Failed to advertise channels in shared memory: {e}");
+        }
+    }
+
+    fn remove_channel(&mut self, channel_id: ChannelId) {
+        if self.channels.remove(&channel_id).is_none() {
+            return;
+        }
+        self.update_advertisement();
+        let json = Unadvertise::new([u64::from(channel_id)]).to_string();
+        if let Err(e) = self.write(RecordKind::Unadvertise, &[json.as_bytes()]) {
+            tracing::error!("Failed to unadvertise channel in shared memory: {e}");
+        }
+    }
+
+    fn log(
+        &mut self,
+        channel_id: ChannelId,
+        msg: &[u8],
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        if !self.channels.contains_key(&channel_id) {
+            return Ok(());
+        }
+        let channel_id = u64::from(channel_id).to_le_bytes();
+        let log_time = metadata.log_time.to_le_bytes();
+        self.write(RecordKind::Message, &[&channel_id, &log_time, msg])
+    }
+}
+
+struct ShmSink {
+    sink_id: SinkId,
+    channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+    /// The state is `None` once the sink is closed.
+    state: Mutex<Option<SinkState>>,
+}
+
+impl Debug for ShmSink {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("ShmSink")
+            .field("sink_id", &self.sink_id)
+            .finish_non_exhaustive()
+    }
+}
+
+impl ShmSink {
+    /// Closes the ring, returning false if it was already closed.
+    fn close(&self) -> bool {
+        let Some(state) = self.state.lock().take() else {
+            return false;
+        };
+        state.ring.close();
+        true
+    }
+}
+
+impl Sink for ShmSink {
+    fn id(&self) -> SinkId {
+        self.sink_id
+    }
+
+    fn log(
+        &self,
+        channel: &RawChannel,
+        msg: &[u8],
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        let mut guard = self.state.lock();
+        let state = guard.as_mut().ok_or(FoxgloveError::SinkClosed)?;
+        state.log(channel.id(), msg, metadata)
+    }
+
+    fn log_batch(
+        &self,
+        channel: &RawChannel,
+        msgs: &[(&[u8], Metadata)],
+    ) -> Result<(), FoxgloveError> {
+        let mut guard = self.state.lock();
+        let state = guard.as_mut().ok_or(FoxgloveError::SinkClosed)?;
+        for (msg, metadata) in msgs {
+            state.log(channel.id(), msg, metadata)?;
+        }
+        Ok(())
+    }
+
+    fn add_channels(&self, channels: &[&Arc<RawChannel>]) -> Option<Vec<ChannelId>> {
+        let channels: Vec<_> = match &self.channel_filter {
+            Some(filter) => channels
+                .iter()
+                .copied()
+                .filter(|channel| filter.should_subscribe(channel.descriptor()))
+                .collect(),
+            None => channels.to_vec(),
+        };
+        if let Some(state) = self.state.lock().as_mut() {
+            state.add_channels(&channels);
+        }
+        self.channel_filter
+            .as_ref()
+            .map(|_| channels.iter().map(|channel| channel.id()).collect())
+    }
+
+    fn remove_channel(&self, channel: &RawChannel) {
+        if let Some(state) = self.state.lock().as_mut() {
+            state.remove_channel(channel.id());
+        }
+    }
+
+    fn auto_subscribe(&self) -> bool {
+        self.channel_filter.is_none()
+    }
+}
+
+/// A record read from a shared-memory sink's ring buffer.
+#[derive(Debug, Clone, PartialEq, Eq)]
+#[non_exhaustive]
+pub enum SharedMemoryRecord {
+    /// A ws-protocol `advertise` message, in JSON.
+    ///
+    /// Channels may be advertised more than once, since the ring buffer periodically repeats the
+    /// advertisement of every channel for readers which start reading later.
+    Advertise(String),
+    /// A ws-protocol `unadvertise` message, in JSON.
+    Unadvertise(String),
+    /// A message logged to a channel.
+    Message {
+        /// The ID of the channel, as advertised.
+        channel_id: u64,
+        /// The log time of the message, in nanoseconds since the epoch.
+        log_time: u64,
+        /// The message data.
+        data: Vec<u8>,
+    },
+}
+
+/// Reads the records of a shared-memory sink on the same host.
+///
+/// The reader starts with an advertisement of every channel, followed by the most recent
+/// messages.
+pub struct SharedMemoryReader {
+    ring: RingReader,
+}
+
+impl Debug for SharedMemoryReader {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("SharedMemoryReader")
+            .field("overruns", &self.ring.overruns())
+            .finish_non_exhaustive()
+    }
+}
+
+impl SharedMemoryReader {
+    /// Opens the ring buffer of the shared-memory sink with the given token.
+    pub fn open(token: &str) -> Result<Self, FoxgloveError> {
+        let file = File::open(token)?;
+        let ring = RingReader::open(&file)?;
+        Ok(Self { ring })
+    }
+
+    /// Returns the next record, or `None` if the reader has read every record written so far.
+    ///
+    /// Records are written concurrently, so this may return a record after returning `None`.
+    pub fn next_record(&mut self) -> Option<SharedMemoryRecord> {
+        loop {
+            let record = self.ring.next_record()?;
+            let payload = record.payload;
+            let record = match record.kind {
+                RecordKind::Advertise => String::from_utf8(payload)
+                    .ok()
+                    .map(SharedMemoryRecord::Advertise),
+                RecordKind::Unadvertise => String::from_utf8(payload)
+                    .ok()
+                    .map(SharedMemoryRecord::Unadvertise),
+                RecordKind::Message if payload.len() >= 16 => {
+                    let (channel_id, rest) = payload.split_at(8);
+                    let (log_time, data) = rest.split_at(8);
+                    Some(SharedMemoryRecord::Message {
+                        channel_id: u64::from_le_bytes(channel_id.try_into().ok()?),
+                        log_time: u64::from_le_bytes(log_time.try_into().ok()?),
+                        data: data.to_vec(),
+                    })
+                }
+                RecordKind::Message | RecordKind::Wrap => None,
+            };
+            if record.is_some() {
+                return record;
+            }
+        }
+    }
+
+    /// Returns the number of times the reader fell behind the writer and skipped records.
+    pub fn overruns(&self) -> u64 {
+        self.ring.overruns()
+    }
+
+    /// Returns true if the sink has been closed, and no more records will be written.
+    pub fn is_closed(&self) -> bool {
+        self.ring.is_closed()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::collections::BTreeSet;
+
+    use super::*;
+    use crate::{ChannelBuilder, PartialMetadata, Schema};
+
+    fn records(reader: &mut SharedMemoryReader) -> Vec<SharedMemoryRecord> {
+        std::iter::from_fn(|| reader.next_record()).collect()
+    }
+
+    fn json_ids(json: &str, key: &str) -> Vec<u64> {
+        let value: serde_json::Value = serde_json::from_str(json).unwrap();
+        value[key]
+            .as_array()
+            .unwrap()
+            .iter()
+            .map(|c| c.get("id").unwrap_or(c).as_u64().unwrap())
+            .collect()
+    }
+
+    /// Replays the records, returning the advertised channels and the logged messages.
+    fn replay(records: &[SharedMemoryRecord]) -> (BTreeSet<u64>, Vec<(u64, u64, Vec<u8>)>) {
+        let mut channels = BTreeSet::new();
+        let mut messages = Vec::new();
+        for record in records {
+            match record {
+                SharedMemoryRecord::Advertise(json) => channels.extend(json_ids(json, "channels")),
+                SharedMemoryRecord::Unadvertise(json) => {
+                    for id in json_ids(json, "channelIds") {
+                        channels.remove(&id);
+                    }
+                }
+                SharedMemoryRecord::Message {
+                    channel_id,
+                    log_time,
+                    data,
+                } => {
+                    assert!(channels.contains(channel_id));
+                    messages.push((*channel_id, *log_time, data.clone()));
+                }
+            }
+        }
+        (channels, messages)
+    }
+
+    fn new_channel(ctx: &Arc<Context>, topic: &str) -> Arc<RawChannel> {
+        ChannelBuilder::new(topic)
+            .context(ctx)
+            .message_encoding("json")
+            .schema(Schema::new(
+                "schema",
+                "jsonschema",
+                br#"{"type": "object"}"#,
+            ))
+            .build_raw()
+            .unwrap()
+    }
+
+    #[test]
+    fn test_log_to_shared_memory() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("ring");
+        let ctx = Context::new();
+        let a = new_channel(&ctx, "/a");
+        let handle = SharedMemorySink::new()
+            .context(&ctx)
+            .path(&path)
+            .capacity(4096)
+            .create()
+            .unwrap();
+        assert_eq!(handle.token(), path.to_str().unwrap());
+
+        let mut reader = SharedMemoryReader::open(handle.token()).unwrap();
+        a.log_with_meta(b"{}", PartialMetadata { log_time: Some(42) });
+        let b = new_channel(&ctx, "/b");
+        b.log(b"{\"b\": 1}");
+
+        let (channels, messages) = replay(&records(&mut reader));
+        let (a_id, b_id) = (u64::from(a.id()), u64::from(b.id()));
+        assert_eq!(channels, BTreeSet::from([a_id, b_id]));
+        assert_eq!(messages[0], (a_id, 42, b"{}".to_vec()));
+        assert_eq!(messages[1].0, b_id);
+        assert_eq!(messages.len(), 2);
+
+        a.close();
+        assert_matches::assert_matches!(
+            records(&mut reader).as_slice(),
+            [SharedMemoryRecord::Unadvertise(_)]
+        );
+
+        // A new reader replays the current lap of the ring, starting with an advertisement.
+        let mut late = SharedMemoryReader::open(handle.token()).unwrap();
+        let records = records(&mut late);
+        assert_matches::assert_matches!(records.first(), Some(SharedMemoryRecord::Advertise(_)));
+        let (channels, _) = replay(&records);
+        assert_eq!(channels, BTreeSet::from([b_id]));
+
+        assert!(!reader.is_closed());
+        handle.close().unwrap();
+        assert!(reader.is_closed());
+        assert!(!path.exists());
+    }
+
+    #[test]
+    fn test_channel_filter() {
+        let dir = tempfile::tempdir().unwrap();
+        let ctx = Context::new();
+        let a = new_channel(&ctx, "/a");
+        let b = new_channel(&ctx, "/b");
+        let handle = SharedMemorySink::new()
+            .context(&ctx)
+            .path(dir.path().join("ring"))
+            .capacity(4096)
+            .channel_filter_fn(|channel| channel.topic() == "/b")
+            .create()
+            .unwrap();
+
+        let mut reader = SharedMemoryReader::open(handle.token()).unwrap();
+        a.log(b"{}");
+        b.log(b"{}");
+        let messages: Vec<_> = records(&mut reader)
+            .into_iter()
+            .filter_map(|record| match record {
+                SharedMemoryRecord::Message { channel_id, .. } => Some(channel_id),
+                _ => None,
+            })
+            .collect();
+        assert_eq!(messages, vec![u64::from(b.id())]);
+    }
+
+    #[test]
+    fn test_create_fails_if_file_exists() {
+        let file = tempfile::NamedTempFile::new().unwrap();
+        let result = SharedMemorySink::new()
+            .context(&Context::new())
+            .path(file.path())
+            .create();
+        assert!(result.is_err());
+        assert!(file.path().exists());
+    }
+}
@@ -0,0 +1,463 @@
+//! A ring buffer of records in a memory-mapped file, shared with readers in other processes.
+//!
+//! The file starts with a header of [`HEADER_LEN`] bytes:
+//!
+//! | Offset | Size | Field                                                        |
+//! |--------|------|--------------------------------------------------------------|
+//! | 0      | 8    | Magic, `FGSHMRB1`                                            |
+//! | 8      | 8    | Capacity of the ring, in bytes                               |
+//! | 16     | 8    | Write position: the end of the last complete record          |
+//! | 24     | 8    | Reserve position: the end of the record being written        |
+//! | 32     | 8    | Closed: non-zero once the writer has closed the ring         |
+//!
+//! The ring follows the header. Positions increase monotonically, and a position's offset in the
+//! ring is the position modulo the capacity. Each record starts with a 4-byte little-endian
+//! payload length and a 1-byte kind, padded to 8 bytes, and is followed by its payload, padded to
+//! a multiple of 8 bytes. Records never straddle the end of the ring: a [`RecordKind::Wrap`]
+//! record fills the rest of the ring instead, and the next record starts the following lap.
+//!
+//! The writer first writes a [`RecordKind::Advertise`] record of every channel on each lap, so
+//! that a reader which starts reading at the beginning of the current lap learns about all
+//! channels. Readers detect that they fell behind the writer from the reserve position, and
+//! resynchronize to the start of the current lap.
+use std::fs::File;
+use std::io;
+use std::ptr::NonNull;
+use std::sync::atomic::{AtomicU64, Ordering, fence};
+
+const MAGIC: [u8; 8] = *b"FGSHMRB1";
+const HEADER_LEN: usize = 64;
+const CAPACITY_OFFSET: usize = 8;
+const WRITE_POS_OFFSET: usize = 16;
+const RESERVE_POS_OFFSET: usize = 24;
+const CLOSED_OFFSET: usize = 32;
+const RECORD_HEADER_LEN: usize = 8;
+
+/// The kind of a record in the ring.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[repr(u8)]
+pub(super) enum RecordKind {
+    /// Fills the rest of the ring.
+    Wrap = 0,
+    /// A ws-protocol `advertise` message, in JSON.
+    Advertise = 1,
+    /// A ws-protocol `unadvertise` message, in JSON.
+    Unadvertise = 2,
+    /// A message: the channel ID and log time as little-endian u64s, then the message data.
+    Message = 3,
+}
+
+impl RecordKind {
+    fn from_u8(kind: u8) -> Option<Self> {
+        match kind {
+            0 => Some(Self::Wrap),
+            1 => Some(Self::Advertise),
+            2 => Some(Self::Unadvertise),
+            3 => Some(Self::Message),
+            _ => None,
+        }
+    }
+}
+
+/// Returns the size of a record with a payload of `len` bytes.
+fn record_size(len: usize) -> usize {
+    (RECORD_HEADER_LEN + len).next_multiple_of(8)
+}
+
+/// A shared mapping of a whole file.
+struct Mapping {
+    ptr: NonNull<u8>,
+    len: usize,
+}
+
+// Safety: the mapping is unmapped only when dropped. Concurrent access to the ring is coordinated
+// through the atomic positions in the header.
+unsafe impl Send for Mapping {}
+unsafe impl Sync for Mapping {}
+
+impl Mapping {
+    fn new(file: &File, len: usize, writable: bool) -> io::Result<Self> {
+        use std::os::fd::AsRawFd;
+
+        let prot = if writable {
+            libc::PROT_READ | libc::PROT_WRITE
+        } else {
+            libc::PROT_READ
+        };
+        // Safety: the arguments describe a shared mapping of `len` bytes of an open file.
+        let ptr = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                len,
+                prot,
+                libc::MAP_SHARED,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if ptr == libc::MAP_FAILED {
+            return Err(io::Error::last_os_error());
+        }
+        let ptr = NonNull::new(ptr.cast())
+            .ok_or_else(|| io::Error::other("mmap returned a null pointer"))?;
+        Ok(Self { ptr, len })
+    }
+
+    fn atomic(&self, offset: usize) -> &AtomicU64 {
+        debug_assert!(offset + 8 <= HEADER_LEN);
+        // Safety: the header is within the mapping, and its fields are 8-byte aligned since the
+        // mapping is page-aligned.
+        unsafe { AtomicU64::from_ptr(self.ptr.as_ptr().add(offset).cast()) }
+    }
+
+    /// Copies bytes out of the ring, starting at `offset` in the ring.
+    fn read(&self, offset: usize, buf: &mut [u8]) {
+        assert!(HEADER_LEN + offset + buf.len() <= self.len);
+        // Safety: the range was checked to be within the mapping.
+        unsafe {
+            std::ptr::copy_nonoverlapping(
+                self.ptr.as_ptr().add(HEADER_LEN + offset),
+                buf.as_mut_ptr(),
+                buf.len(),
+            );
+        }
+    }
+
+    /// Copies bytes into the ring, starting at `offset` in the ring.
+    ///
+    /// The mapping must be writable.
+    fn write(&self, offset: usize, data: &[u8]) {
+        assert!(HEADER_LEN + offset + data.len() <= self.len);
+        // Safety: the range was checked to be within the mapping, and only the writer writes to
+        // the ring.
+        unsafe {
+            std::ptr::copy_nonoverlapping(
+                data.as_ptr(),
+                self.ptr.as_ptr().add(HEADER_LEN + offset),
+                data.len(),
+            );
+        }
+    }
+}
+
+impl Drop for Mapping {
+    fn drop(&mut self) {
+        // Safety: the mapping was created with this address and length.
+        unsafe { libc::munmap(self.ptr.as_ptr().cast(), self.len) };
+    }
+}
+
+/// Writes records to the ring.
+pub(super) struct RingWriter {
+    map: Mapping,
+    capacity: usize,
+    pos: u64,
+}
+
+impl RingWriter {
+    /// Sizes the file to hold a ring of `capacity` bytes, and initializes its header.
+    pub fn create(file: &File, capacity: usize) -> io::Result<Self> {
+        let capacity = capacity.next_multiple_of(8);
+        let len = HEADER_LEN + capacity;
+        file.set_len(len as u64)?;
+        let map = Mapping::new(file, len, true)?;
+        // Safety: the header is within the mapping, and no reader validates it before the magic
+        // is written.
+        unsafe {
+            let header = map.ptr.as_ptr();
+            std::ptr::write_bytes(header, 0, HEADER_LEN);
+            header
+                .add(CAPACITY_OFFSET)
+                .cast::<u64>()
+                .write((capacity as u64).to_le());
+        }
+        fence(Ordering::Release);
+        // Safety: as above.
+        unsafe { std::ptr::copy_nonoverlapping(MAGIC.as_ptr(), map.ptr.as_ptr(), MAGIC.len()) };
+        Ok(Self {
+            map,
+            capacity,
+            pos: 0,
+        })
+    }
+
+    /// Returns the largest payload which fits in the ring, along with a lap header of
+    /// `lap_header_len` bytes.
+    pub fn max_payload_len(&self, lap_header_len: usize) -> usize {
+        self.capacity
+            .saturating_sub(record_size(lap_header_len) + RECORD_HEADER_LEN)
+    }
+
+    /// Appends a record, whose payload is the concatenation of `parts`.
+    ///
+    /// `lap_header` is the payload of the advertise record written at the start of each lap.
+    pub fn write(
+        &mut self,
+        lap_header: &[u8],
+        kind: RecordKind,
+        parts: &[&[u8]],
+    ) -> io::Result<()> {
+        let len: usize = parts.iter().map(|part| part.len()).sum();
+        if len > self.max_payload_len(lap_header.len()) {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidInput,
+                format!(
+                    "record of {len} bytes does not fit in a shared memory ring of {} bytes",
+                    self.capacity
+                ),
+            ));
+        }
+        let offset = self.offset();
+        if offset + record_size(len) > self.capacity {
+            self.append(RecordKind::Wrap, &[], self.capacity - offset);
+        }
+        if self.offset() == 0 {
+            self.append(
+                RecordKind::Advertise,
+                &[lap_header],
+                record_size(lap_header.len()),
+            );
+        }
+        self.append(kind, parts, record_size(len));
+        Ok(())
+    }
+
+    /// Marks the ring as closed, so that readers know no more records will be written.
+    pub fn close(&self) {
+        self.map.atomic(CLOSED_OFFSET).store(1, Ordering::Release);
+    }
+
+    fn offset(&self) -> usize {
+        (self.pos % self.capacity as u64) as usize
+    }
+
+    fn append(&mut self, kind: RecordKind, parts: &[&[u8]], size: usize) {
+        let end = self.pos + size as u64;
+        // Readers which copy a record that is being overwritten see that the reserve position is
+        // more than a lap ahead of the record, and discard it.
+        self.map
+            .atomic(RESERVE_POS_OFFSET)
+            .store(end, Ordering::Relaxed);
+        fence(Ordering::Release);
+        let len: usize = parts.iter().map(|part| part.len()).sum();
+        let mut header = [0; RECORD_HEADER_LEN];
+        header[..4].copy_from_slice(&(len as u32).to_le_bytes());
+        header[4] = kind as u8;
+        let mut offset = self.offset();
+        self.map.write(offset, &header);
+        offset += RECORD_HEADER_LEN;
+        for part in parts {
+            self.map.write(offset, part);
+            offset += part.len();
+        }
+        self.map
+            .atomic(WRITE_POS_OFFSET)
+            .store(end, Ordering::Release);
+        self.pos = end;
+    }
+}
+
+/// A record read from the ring.
+pub(super) struct Record {
+    pub kind: RecordKind,
+    pub payload: Vec<u8>,
+}
+
+/// Reads records from the ring.
+pub(super) struct RingReader {
+    map: Mapping,
+    capacity: usize,
+    pos: u64,
+    overruns: u64,
+}
+
+impl RingReader {
+    /// Maps the ring in the file, and starts reading at the beginning of the current lap.
+    pub fn open(file: &File) -> io::Result<Self> {
+        let invalid = |msg: &str| io::Error::new(io::ErrorKind::InvalidData, msg.to_string());
+        let file_len = usize::try_from(file.metadata()?.len())
+            .map_err(|e| io::Error::new(io::ErrorKind::FileTooLarge, e))?;
+        if file_len < HEADER_LEN {
+            return Err(invalid("not a shared memory ring"));
+        }
+        let map = Mapping::new(file, file_len, false)?;
+        let mut header = [0; HEADER_LEN];
+        // Safety: the header is within the mapping.
+        unsafe { std::ptr::copy_nonoverlapping(map.ptr.as_ptr(), header.as_mut_ptr(), HEADER_LEN) };
+        fence(Ordering::Acquire);
+        if header[..8] != MAGIC {
+            return Err(invalid("not a shared memory ring"));
+        }
+        let capacity = u64::from_le_bytes(
+            header[CAPACITY_OFFSET..CAPACITY_OFFSET + 8]
+                .try_into()
+                .map_err(|_| invalid("truncated header"))?,
+        );
+        let capacity = usize::try_from(capacity).map_err(|_| invalid("invalid capacity"))?;
+        if capacity == 0 || capacity % 8 != 0 || HEADER_LEN + capacity > file_len {
+            return Err(invalid("invalid capacity"));
+        }
+        let mut reader = Self {
+            map,
+            capacity,
+            pos: 0,
+            overruns: 0,
+        };
+        reader.pos = reader.lap_start();
+        Ok(reader)
+    }
+
+    /// Returns the number of times the reader fell behind the writer and skipped records.
+    pub fn overruns(&self) -> u64 {
+        self.overruns
+    }
+
+    /// Returns true if the writer has closed the ring.
+    pub fn is_closed(&self) -> bool {
+        self.map.atomic(CLOSED_OFFSET).load(Ordering::Acquire) != 0
+    }
+
+    /// Returns the next record, or `None` if the reader has caught up with the writer.
+    pub fn next_record(&mut self) -> Option<Record> {
+        loop {
+            let write_pos = self.map.atomic(WRITE_POS_OFFSET).load(Ordering::Acquire);
+            if self.pos >= write_pos {
+                return None;
+            }
+            let offset = (self.pos % self.capacity as u64) as usize;
+            let mut header = [0; RECORD_HEADER_LEN];
+            self.map.read(offset, &mut header);
+            let len = u32::from_le_bytes([header[0], header[1], header[2], header[3]]) as usize;
+            let kind = RecordKind::from_u8(header[4]);
+            let size = match kind {
+                Some(RecordKind::Wrap) => self.capacity - offset,
+                _ => record_size(len),
+            };
+            let mut payload = Vec::new();
+            if kind.is_some() && offset + size <= self.capacity {
+                payload.resize(len, 0);
+                self.map.read(offset + RECORD_HEADER_LEN, &mut payload);
+            }
+            fence(Ordering::Acquire);
+            let reserve_pos = self.map.atomic(RESERVE_POS_OFFSET).load(Ordering::Relaxed);
+            let overwritten = reserve_pos.saturating_sub(self.pos) > self.capacity as u64;
+            let Some(kind) = kind.filter(|_| !overwritten && offset + size <= self.capacity) else {
+                self.overruns += 1;
+                self.pos = self.lap_start();
+                continue;
+            };
+            self.pos += size as u64;
+            if kind != RecordKind::Wrap {
+                return Some(Record { kind, payload });
+            }
+        }
+    }
+
+    /// Returns the position of the first record of the lap which holds the writer's last record.
+    fn lap_start(&self) -> u64 {
+        let write_pos = self.map.atomic(WRITE_POS_OFFSET).load(Ordering::Acquire);
+        let capacity = self.capacity as u64;
+        write_pos.saturating_sub(1) / capacity * capacity
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn ring(capacity: usize) -> (tempfile::NamedTempFile, RingWriter) {
+        let file = tempfile::NamedTempFile::new().unwrap();
+        let writer = RingWriter::create(file.as_file(), capacity).unwrap();
+        (file, writer)
+    }
+
+    fn payloads(reader: &mut RingReader) -> Vec<(RecordKind, Vec<u8>)> {
+        std::iter::from_fn(|| reader.next_record())
+            .map(|record| (record.kind, record.payload))
+            .collect()
+    }
+
+    #[test]
+    fn test_write_and_read() {
+        let (file, mut writer) = ring(256);
+        writer
+            .write(b"lap", RecordKind::Message, &[b"hello", b" world"])
+            .unwrap();
+        let mut reader = RingReader::open(file.as_file()).unwrap();
+        assert_eq!(
+            payloads(&mut reader),
+            vec![
+                (RecordKind::Advertise, b"lap".to_vec()),
+                (RecordKind::Message, b"hello world".to_vec()),
+            ]
+        );
+        writer
+            .write(b"lap", RecordKind::Unadvertise, &[b"bye"])
+            .unwrap();
+        assert_eq!(
+            payloads(&mut reader),
+            vec![(RecordKind::Unadvertise, b"bye".to_vec())]
+        );
+        assert!(!reader.is_closed());
+        writer.close();
+        assert!(reader.is_closed());
+    }
+
+    #[test]
+    fn test_wrap_writes_lap_header() {
+        let (file, mut writer) = ring(64);
+        let mut reader = RingReader::open(file.as_file()).unwrap();
+        for i in 0..10u8 {
+            writer
+                .write(b"lap", RecordKind::Message, &[&[i; 20]])
+                .unwrap();
+            let records = payloads(&mut reader);
+            let messages: Vec<_> = records
+                .iter()
+                .filter(|(kind, _)| *kind == RecordKind::Message)
+                .collect();
+            assert_eq!(messages, vec![&(RecordKind::Message, vec![i; 20])]);
+        }
+        assert_eq!(reader.overruns(), 0);
+
+        // A late reader starts with the current lap's header.
+        let mut late = RingReader::open(file.as_file()).unwrap();
+        assert_eq!(
+            payloads(&mut late),
+            vec![
+                (RecordKind::Advertise, b"lap".to_vec()),
+                (RecordKind::Message, vec![9; 20]),
+            ]
+        );
+    }
+
+    #[test]
+    fn test_reader_overrun() {
+        let (file, mut writer) = ring(128);
+        let mut reader = RingReader::open(file.as_file()).unwrap();
+        for i in 0..20u8 {
+            writer.write(b"", RecordKind::Message, &[&[i; 16]]).unwrap();
+        }
+        let records = payloads(&mut reader);
+        assert_eq!(reader.overruns(), 1);
+        assert_eq!(records.first().map(|r| r.0), Some(RecordKind::Advertise));
+        assert_eq!(records.last(), Some(&(RecordKind::Message, vec![19; 16])));
+    }
+
+    #[test]
+    fn test_record_too_large() {
+        let (_file, mut writer) = ring(64);
+        assert!(
+            writer
+                .write(b"lap", RecordKind::Message, &[&[0; 64]])
+                .is_err()
+        );
+    }
+
+    #[test]
+    fn test_open_invalid_file() {
+        let file = tempfile::NamedTempFile::new().unwrap();
+        std::fs::write(file.path(), [0; HEADER_LEN]).unwrap();
+        assert!(RingReader::open(file.as_file()).is_err());
+    }
+}
@@ -1,11 +1,13 @@
 use std::num::NonZeroU64;
 use std::sync::Arc;
 use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::Duration;
 
+use bytes::Bytes;
 use smallvec::SmallVec;
 
 use crate::metadata::Metadata;
-use crate::{ChannelId, FoxgloveError, RawChannel};
+use crate::{ChannelDemand, ChannelId, FoxgloveError, MessageFilter, RawChannel};
 
 /// Uniquely identifies a [`Sink`] in the context of this program.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
@@ -62,6 +64,43 @@ pub trait Sink: Send + Sync {
         metadata: &Metadata,
     ) -> Result<(), FoxgloveError>;
 
+    /// Writes a message held in a shared, reference-counted buffer for the channel to the sink.
+    ///
+    /// Sinks that queue the payload beyond the duration of the call may keep a reference to `msg`
+    /// instead of copying it. The default implementation calls [`Sink::log`].
+    fn log_shared(
+        &self,
+        channel: &RawChannel,
+        msg: &Bytes,
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        self.log(channel, msg, metadata)
+    }
+
+    /// Writes a batch of messages for the channel to the sink.
+    ///
+    /// The default implementation calls [`Sink::log`] for each message, stopping at the first
+    /// error. Sinks may override this to take locks or enqueue work once for the whole batch.
+    fn log_batch(
+        &self,
+        channel: &RawChannel,
+        msgs: &[(&[u8], Metadata)],
+    ) -> Result<(), FoxgloveError> {
+        for (msg, metadata) in msgs {
+            self.log(channel, msg, metadata)?;
+        }
+        Ok(())
+    }
+
+    /// Returns the filter which runs on each message before it is logged to this sink, if any.
+    ///
+    /// Messages which the filter drops are not passed to the sink, and messages which it replaces
+    /// are passed to [`Sink::log_shared`]. See [`MessageFilter`] for details. The default
+    /// implementation returns `None`.
+    fn message_filter(&self) -> Option<&Arc<dyn MessageFilter>> {
+        None
+    }
+
     /// Called when new channels are made available within the [`Context`][ctx].
     ///
     /// Sinks can track channels seen, and do new channel-related things the first time they see a
@@ -121,6 +160,77 @@ pub trait Sink: Send + Sync {
     fn auto_subscribe(&self) -> bool {
         true
     }
+
+    /// Returns delivery counters for the messages queued by the sink, if it queues any.
+    ///
+    /// These are reported by the system info publisher when it is configured to monitor the SDK
+    /// itself, and by the SDK stats publisher. The default implementation returns `None`.
+    fn sink_stats(&self) -> Option<SinkStats> {
+        None
+    }
+
+    /// Returns the sink's demand for the messages of a channel it is subscribed to.
+    ///
+    /// This is combined across the channel's sinks by [`RawChannel::demand`]. Sinks which fan
+    /// out to several consumers, or which send messages at a limited rate, should override this.
+    /// The default implementation returns a single consumer which receives every message.
+    fn demand(&self, _channel: &RawChannel) -> ChannelDemand {
+        ChannelDemand::new(1, None)
+    }
+
+    /// Indicates whether the sink may block the logging thread rather than drop messages, for
+    /// example while it waits for a disk.
+    ///
+    /// A channel logs each message to its lossy sinks before its lossless sinks, so that a
+    /// stalled lossless sink does not delay delivery of that message to the others. This only
+    /// orders delivery: the sinks are not isolated, and a stalled lossless sink still blocks the
+    /// logging thread, delaying later messages to every sink. The default implementation returns
+    /// false.
+    fn is_lossless(&self) -> bool {
+        false
+    }
+}
+
+/// Delivery counters for the messages queued by a [`Sink`].
+#[doc(hidden)]
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+#[non_exhaustive]
+pub struct SinkStats {
+    /// A short name for the kind of sink, such as `mcap` or `websocket_client`.
+    pub kind: &'static str,
+    /// The number of messages currently queued.
+    pub queued_messages: usize,
+    /// The number of bytes currently queued.
+    pub queued_bytes: usize,
+    /// The number of messages sent or written.
+    pub sent_messages: u64,
+    /// The number of bytes sent or written.
+    pub sent_bytes: u64,
+    /// The number of messages dropped because the sink's queue was full.
+    pub dropped_messages: u64,
+    /// The number of bytes written to the sink's output, after encoding and compression.
+    pub written_bytes: u64,
+    /// The time spent encoding, compressing and writing messages.
+    pub write_time: Duration,
+    /// The number of video tracks the sink publishes.
+    pub video_tracks: usize,
+    /// The bitrate available to all of the sink's video tracks, in bits per second, or 0 if it
+    /// has not been estimated.
+    pub video_bitrate: u64,
+}
+
+impl std::ops::AddAssign for SinkStats {
+    fn add_assign(&mut self, other: Self) {
+        self.queued_messages += other.queued_messages;
+        self.queued_bytes += other.queued_bytes;
+        self.sent_messages += other.sent_messages;
+        self.sent_bytes += other.sent_bytes;
+        self.dropped_messages += other.dropped_messages;
+        self.written_bytes += other.written_bytes;
+        self.write_time += other.write_time;
+        self.video_tracks += other.video_tracks;
+        self.video_bitrate += other.video_bitrate;
+    }
 }
 
 /// A small group of sinks.
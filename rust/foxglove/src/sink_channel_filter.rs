@@ -1,4 +1,10 @@
-use crate::channel::ChannelDescriptor;
+use std::collections::HashMap;
+
+use parking_lot::RwLock;
+use regex::RegexSet;
+
+use crate::FoxgloveError;
+use crate::channel::{ChannelDescriptor, ChannelId};
 
 /// A filter for channels that can be used to subscribe to or unsubscribe from channels.
 ///
@@ -21,3 +27,216 @@ where
         self.0(channel)
     }
 }
+
+/// The number of channels whose results a [`TopicFilter`] remembers before it starts over.
+const MAX_CACHED_CHANNELS: usize = 1 << 16;
+
+/// A [`SinkChannelFilter`] which matches channel topics against globs and regular expressions.
+///
+/// A channel is subscribed to if its topic matches any of the include patterns (or there are no
+/// include patterns), and none of the exclude patterns. All patterns of a filter are compiled into
+/// a single automaton, so the cost of matching a topic barely depends on the number of patterns.
+/// Results are cached by channel ID, so re-evaluating the filter for a known channel, as happens
+/// when a sink is added to a context with many channels, is a hash lookup.
+///
+/// In globs, `*` matches any sequence of characters other than `/`, `**` matches any sequence of
+/// characters, and `?` matches any single character other than `/`. Globs match the whole topic.
+/// Regular expressions use the syntax of the [`regex`] crate, and match anywhere in the topic
+/// unless anchored with `^` and `$`.
+///
+/// ```
+/// use foxglove::TopicFilter;
+///
+/// let filter = TopicFilter::builder()
+///     .include_glob("/camera/**")
+///     .exclude_regex(r"/compressed$")
+///     .build()
+///     .unwrap();
+/// assert!(filter.matches("/camera/front/image"));
+/// assert!(!filter.matches("/camera/front/compressed"));
+/// assert!(!filter.matches("/lidar/points"));
+/// ```
+pub struct TopicFilter {
+    include: Option<RegexSet>,
+    exclude: Option<RegexSet>,
+    cache: RwLock<HashMap<ChannelId, bool>>,
+}
+
+impl std::fmt::Debug for TopicFilter {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("TopicFilter")
+            .field("include", &self.include.as_ref().map(RegexSet::patterns))
+            .field("exclude", &self.exclude.as_ref().map(RegexSet::patterns))
+            .finish_non_exhaustive()
+    }
+}
+
+impl TopicFilter {
+    /// Returns a builder for a topic filter.
+    pub fn builder() -> TopicFilterBuilder {
+        TopicFilterBuilder::default()
+    }
+
+    /// Returns true if a channel with the given topic passes the filter.
+    pub fn matches(&self, topic: &str) -> bool {
+        self.include.as_ref().is_none_or(|set| set.is_match(topic))
+            && !self.exclude.as_ref().is_some_and(|set| set.is_match(topic))
+    }
+}
+
+impl SinkChannelFilter for TopicFilter {
+    fn should_subscribe(&self, channel: &ChannelDescriptor) -> bool {
+        let id = channel.id();
+        if let Some(&result) = self.cache.read().get(&id) {
+            return result;
+        }
+        let result = self.matches(channel.topic());
+        let mut cache = self.cache.write();
+        if cache.len() >= MAX_CACHED_CHANNELS {
+            cache.clear();
+        }
+        cache.insert(id, result);
+        result
+    }
+}
+
+/// A builder for a [`TopicFilter`].
+#[derive(Debug, Clone, Default)]
+#[must_use]
+pub struct TopicFilterBuilder {
+    include: Vec<String>,
+    exclude: Vec<String>,
+}
+
+impl TopicFilterBuilder {
+    /// Subscribes to channels whose topic matches the glob.
+    pub fn include_glob(mut self, glob: &str) -> Self {
+        self.include.push(glob_to_regex(glob));
+        self
+    }
+
+    /// Subscribes to channels whose topic matches the regular expression.
+    pub fn include_regex(mut self, regex: impl Into<String>) -> Self {
+        self.include.push(regex.into());
+        self
+    }
+
+    /// Excludes channels whose topic matches the glob.
+    pub fn exclude_glob(mut self, glob: &str) -> Self {
+        self.exclude.push(glob_to_regex(glob));
+        self
+    }
+
+    /// Excludes channels whose topic matches the regular expression.
+    pub fn exclude_regex(mut self, regex: impl Into<String>) -> Self {
+        self.exclude.push(regex.into());
+        self
+    }
+
+    /// Compiles the patterns into a filter.
+    ///
+    /// Returns [`FoxgloveError::ValueError`] if a regular expression is invalid.
+    pub fn build(self) -> Result<TopicFilter, FoxgloveError> {
+        let compile = |patterns: Vec<String>| -> Result<Option<RegexSet>, FoxgloveError> {
+            if patterns.is_empty() {
+                return Ok(None);
+            }
+            RegexSet::new(patterns)
+                .map(Some)
+                .map_err(|e| FoxgloveError::ValueError(format!("invalid topic pattern: {e}")))
+        };
+        Ok(TopicFilter {
+            include: compile(self.include)?,
+            exclude: compile(self.exclude)?,
+            cache: RwLock::default(),
+        })
+    }
+}
+
+/// Translates a glob into an anchored regular expression.
+fn glob_to_regex(glob: &str) -> String {
+    let mut regex = String::with_capacity(glob.len() + 8);
+    regex.push('^');
+    let mut chars = glob.chars().peekable();
+    let mut buf = [0; 4];
+    while let Some(c) = chars.next() {
+        match c {
+            '*' if chars.peek() == Some(&'*') => {
+                chars.next();
+                regex.push_str(".*");
+            }
+            '*' => regex.push_str("[^/]*"),
+            '?' => regex.push_str("[^/]"),
+            c => regex.push_str(&regex::escape(c.encode_utf8(&mut buf))),
+        }
+    }
+    regex.push('$');
+    regex
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ChannelBuilder;
+    use crate::Context;
+
+    #[test]
+    fn test_glob_to_regex() {
+        assert_eq!(glob_to_regex("/a/*"), "^/a/[^/]*$");
+        assert_eq!(glob_to_regex("/a/**"), "^/a/.*$");
+        assert_eq!(glob_to_regex("/a.b?"), r"^/a\.b[^/]$");
+    }
+
+    #[test]
+    fn test_topic_filter_matches() {
+        let filter = TopicFilter::builder()
+            .include_glob("/camera/*/image")
+            .include_regex("^/tf")
+            .exclude_glob("/camera/rear/**")
+            .build()
+            .unwrap();
+        assert!(filter.matches("/camera/front/image"));
+        assert!(filter.matches("/tf_static"));
+        assert!(!filter.matches("/camera/front/left/image"));
+        assert!(!filter.matches("/camera/rear/image"));
+        assert!(!filter.matches("/lidar"));
+
+        let exclude_only = TopicFilter::builder()
+            .exclude_glob("/debug/**")
+            .build()
+            .unwrap();
+        assert!(exclude_only.matches("/lidar"));
+        assert!(!exclude_only.matches("/debug/a/b"));
+
+        assert!(TopicFilter::builder().build().unwrap().matches("/anything"));
+    }
+
+    #[test]
+    fn test_topic_filter_invalid_regex() {
+        let err = TopicFilter::builder()
+            .include_regex("(")
+            .build()
+            .unwrap_err();
+        assert!(matches!(err, FoxgloveError::ValueError(_)));
+    }
+
+    #[test]
+    fn test_topic_filter_caches_by_channel() {
+        let ctx = Context::new();
+        let filter = TopicFilter::builder().include_glob("/a").build().unwrap();
+        let a = ChannelBuilder::new("/a")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .unwrap();
+        let b = ChannelBuilder::new("/b")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .unwrap();
+        assert!(filter.should_subscribe(a.descriptor()));
+        assert!(!filter.should_subscribe(b.descriptor()));
+        assert!(filter.should_subscribe(a.descriptor()));
+        assert_eq!(filter.cache.read().len(), 2);
+    }
+}
@@ -3,22 +3,26 @@
 //! Build a [`SystemInfoPublisher`] and call [`SystemInfoPublisher::start`]
 //! to spawn a background task that periodically logs a SystemInfo
 //! message to a channel. The default channel is `/sysinfo`, and the default
-//! refresh interval is 500ms.
+//! refresh interval is 500ms. The metrics which are collected can be selected with
+//! [`SystemInfoPublisher::metrics`], so that only the statistics which are needed are read on
+//! each refresh.
 //!
 //! The returned [`SystemInfoHandle`] can be `.await`ed to wait for the
 //! publisher to complete, or aborted with [`SystemInfoHandle::abort`].
 
 use std::borrow::Cow;
+use std::collections::{BTreeMap, HashSet};
 use std::future::Future;
 use std::pin::Pin;
-use std::sync::Arc;
+use std::sync::{Arc, Weak};
 use std::task::{Context as TaskContext, Poll};
-use std::time::Duration;
+use std::time::{Duration, Instant};
 
 use bytes::BufMut;
 use serde::Serialize;
 use sysinfo::{
-    CpuRefreshKind, MINIMUM_CPU_UPDATE_INTERVAL, Pid, ProcessRefreshKind, ProcessesToUpdate, System,
+    CpuRefreshKind, DiskRefreshKind, Disks, MINIMUM_CPU_UPDATE_INTERVAL, Networks, Pid,
+    ProcessRefreshKind, ProcessesToUpdate, System,
 };
 use tokio::task::JoinHandle;
 use tokio::time::MissedTickBehavior;
@@ -31,11 +35,45 @@ pub const DEFAULT_SYSINFO_TOPIC: &str = "/sysinfo";
 /// The default refresh interval for [`SystemInfoPublisher`].
 pub const DEFAULT_SYSINFO_REFRESH_INTERVAL: Duration = Duration::from_millis(500);
 
+/// A group of statistics which the [`SystemInfoPublisher`] can collect.
+///
+/// Each metric corresponds to a set of fields in the published message. Fields for metrics which
+/// are not selected are omitted.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+#[non_exhaustive]
+pub enum SystemInfoMetric {
+    /// Memory and CPU usage of the SDK process: the `process_*` fields.
+    Process,
+    /// Total CPU usage of the system: `total_cpu_percent` and `total_cpu_cores`.
+    Cpu,
+    /// CPU usage of each logical CPU: `cpu_percent_per_core`.
+    CpuPerCore,
+    /// Physical memory and swap usage of the system: `total_memory`, `used_memory`,
+    /// `total_swap` and `used_swap`.
+    Memory,
+    /// Network throughput, summed over all interfaces: the `network_*` fields.
+    Network,
+    /// Disk I/O throughput, summed over all disks: the `disk_*` fields.
+    Disk,
+    /// The SDK's own delivery queues and threads: the `sdk_*` fields.
+    ///
+    /// Queue and delivery counters are summed over the sinks registered with the publisher's
+    /// context. Per-thread CPU usage is only available on Linux, and excludes the main thread.
+    Sdk,
+}
+
+/// The metrics collected by default by [`SystemInfoPublisher`].
+pub const DEFAULT_SYSINFO_METRICS: [SystemInfoMetric; 3] = [
+    SystemInfoMetric::Process,
+    SystemInfoMetric::Cpu,
+    SystemInfoMetric::Memory,
+];
+
 /// JSON Schema (draft 2020-12) describing SystemInfo for consumers of the `/sysinfo` topic.
 const SYSINFO_JSON_SCHEMA: &str = r#"{
   "$schema": "https://json-schema.org/draft/2020-12/schema",
   "title": "SystemInfo",
-  "description": "A snapshot of process and system statistics published on the /sysinfo topic.",
+  "description": "A snapshot of process and system statistics published on the /sysinfo topic. Fields for metrics which the publisher does not collect are omitted.",
   "type": "object",
   "properties": {
     "process_memory": {
@@ -62,6 +100,11 @@ const SYSINFO_JSON_SCHEMA: &str = r#"{
       "type": "number",
       "description": "Total CPU usage across the system, expressed in core-equivalents (0.0 to num_cpus). 1.0 means one logical CPU's worth of work is being done."
     },
+    "cpu_percent_per_core": {
+      "type": "array",
+      "items": { "type": "number" },
+      "description": "CPU usage of each logical CPU, as a percent (0.0 to 100.0)."
+    },
     "num_cpus": {
       "type": "integer",
       "minimum": 0,
@@ -83,6 +126,59 @@ const SYSINFO_JSON_SCHEMA: &str = r#"{
       "type": "number",
       "description": "Used swap space on the system, in bytes."
     },
+    "network_received_bytes_per_sec": {
+      "type": "number",
+      "description": "Bytes received per second, summed over all network interfaces."
+    },
+    "network_transmitted_bytes_per_sec": {
+      "type": "number",
+      "description": "Bytes transmitted per second, summed over all network interfaces."
+    },
+    "disk_read_bytes_per_sec": {
+      "type": "number",
+      "description": "Bytes read per second, summed over all disks."
+    },
+    "disk_written_bytes_per_sec": {
+      "type": "number",
+      "description": "Bytes written per second, summed over all disks."
+    },
+    "sdk_queued_messages": {
+      "type": "integer",
+      "minimum": 0,
+      "description": "Messages currently queued by the SDK's sinks."
+    },
+    "sdk_queued_bytes": {
+      "type": "integer",
+      "minimum": 0,
+      "description": "Bytes currently queued by the SDK's sinks."
+    },
+    "sdk_sent_messages": {
+      "type": "integer",
+      "minimum": 0,
+      "description": "Messages sent by the SDK's sinks since they were created."
+    },
+    "sdk_sent_bytes": {
+      "type": "integer",
+      "minimum": 0,
+      "description": "Bytes sent by the SDK's sinks since they were created."
+    },
+    "sdk_dropped_messages": {
+      "type": "integer",
+      "minimum": 0,
+      "description": "Messages dropped by the SDK's sinks since they were created, because a queue was full."
+    },
+    "sdk_threads": {
+      "type": "array",
+      "description": "CPU usage of the process's threads, grouped by thread name. Empty on platforms other than Linux.",
+      "items": {
+        "type": "object",
+        "properties": {
+          "name": { "type": "string", "description": "Thread name." },
+          "count": { "type": "integer", "minimum": 0, "description": "Number of threads with this name." },
+          "cpu_cores": { "type": "number", "description": "CPU usage of the threads, expressed in core-equivalents." }
+        }
+      }
+    },
     "kernel_version": {
       "type": "string",
       "description": "Kernel version string, or empty if unavailable on this platform."
@@ -96,9 +192,36 @@ const SYSINFO_JSON_SCHEMA: &str = r#"{
 
 /// A snapshot of process and system statistics published by [`SystemInfoPublisher`].
 ///
-/// Encoded as JSON on the wire, with a JSON Schema attached to the channel.
-#[derive(Clone, Debug, Serialize)]
+/// Encoded as JSON on the wire, with a JSON Schema attached to the channel. The fields of each
+/// metric which is not collected are omitted.
+#[derive(Clone, Debug, Default, Serialize)]
 pub(crate) struct SystemInfo {
+    #[serde(flatten)]
+    pub process: Option<ProcessInfo>,
+    #[serde(flatten)]
+    pub cpu: Option<CpuInfo>,
+    /// CPU usage of each logical CPU, as a percent (0.0 to 100.0).
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub cpu_percent_per_core: Option<Vec<f64>>,
+    /// Number of logical CPUs on the system.
+    pub num_cpus: u32,
+    #[serde(flatten)]
+    pub memory: Option<MemoryInfo>,
+    #[serde(flatten)]
+    pub network: Option<NetworkInfo>,
+    #[serde(flatten)]
+    pub disk: Option<DiskInfo>,
+    #[serde(flatten)]
+    pub sdk: Option<SdkInfo>,
+    /// Kernel version string, or empty if unavailable on this platform.
+    pub kernel_version: String,
+    /// OS version string, or empty if unavailable on this platform.
+    pub os_version: String,
+}
+
+/// Statistics for [`SystemInfoMetric::Process`].
+#[derive(Clone, Debug, Default, Serialize)]
+pub(crate) struct ProcessInfo {
     /// Resident memory used by the SDK process, in bytes.
     pub process_memory: f64,
     /// Virtual memory used by the SDK process, in bytes.
@@ -113,6 +236,11 @@ pub(crate) struct SystemInfo {
     ///
     /// 1.0 means a single logical CPU is fully utilized.
     pub process_cpu_cores: f64,
+}
+
+/// Statistics for [`SystemInfoMetric::Cpu`].
+#[derive(Clone, Debug, Default, Serialize)]
+pub(crate) struct CpuInfo {
     /// Total CPU usage across all logical CPUs on the system, as a percent (0.0 to 100.0).
     pub total_cpu_percent: f64,
     /// Total CPU usage across the system, expressed in core-equivalents
@@ -120,8 +248,11 @@ pub(crate) struct SystemInfo {
     ///
     /// 1.0 means one logical CPU's worth of work is being done.
     pub total_cpu_cores: f64,
-    /// Number of logical CPUs on the system.
-    pub num_cpus: u32,
+}
+
+/// Statistics for [`SystemInfoMetric::Memory`].
+#[derive(Clone, Debug, Default, Serialize)]
+pub(crate) struct MemoryInfo {
     /// Total physical memory on the system, in bytes.
     pub total_memory: f64,
     /// Used physical memory on the system, in bytes.
@@ -130,10 +261,52 @@ pub(crate) struct SystemInfo {
     pub total_swap: f64,
     /// Used swap space on the system, in bytes.
     pub used_swap: f64,
-    /// Kernel version string, or empty if unavailable on this platform.
-    pub kernel_version: String,
-    /// OS version string, or empty if unavailable on this platform.
-    pub os_version: String,
+}
+
+/// Statistics for [`SystemInfoMetric::Network`].
+#[derive(Clone, Debug, Default, Serialize)]
+pub(crate) struct NetworkInfo {
+    /// Bytes received per second, summed over all network interfaces.
+    pub network_received_bytes_per_sec: f64,
+    /// Bytes transmitted per second, summed over all network interfaces.
+    pub network_transmitted_bytes_per_sec: f64,
+}
+
+/// Statistics for [`SystemInfoMetric::Disk`].
+#[derive(Clone, Debug, Default, Serialize)]
+pub(crate) struct DiskInfo {
+    /// Bytes read per second, summed over all disks.
+    pub disk_read_bytes_per_sec: f64,
+    /// Bytes written per second, summed over all disks.
+    pub disk_written_bytes_per_sec: f64,
+}
+
+/// Statistics for [`SystemInfoMetric::Sdk`].
+#[derive(Clone, Debug, Default, Serialize)]
+pub(crate) struct SdkInfo {
+    /// Messages currently queued by the SDK's sinks.
+    pub sdk_queued_messages: u64,
+    /// Bytes currently queued by the SDK's sinks.
+    pub sdk_queued_bytes: u64,
+    /// Messages sent by the SDK's sinks since they were created.
+    pub sdk_sent_messages: u64,
+    /// Bytes sent by the SDK's sinks since they were created.
+    pub sdk_sent_bytes: u64,
+    /// Messages dropped by the SDK's sinks since they were created.
+    pub sdk_dropped_messages: u64,
+    /// CPU usage of the process's threads, grouped by thread name.
+    pub sdk_threads: Vec<ThreadInfo>,
+}
+
+/// CPU usage of the threads with the same name.
+#[derive(Clone, Debug, Default, Serialize)]
+pub(crate) struct ThreadInfo {
+    /// Thread name.
+    pub name: String,
+    /// Number of threads with this name.
+    pub count: u32,
+    /// CPU usage of the threads, expressed in core-equivalents.
+    pub cpu_cores: f64,
 }
 
 impl Encode for SystemInfo {
@@ -165,7 +338,8 @@ impl Encode for SystemInfo {
 /// # Published metrics
 ///
 /// Each message is a JSON object with a JSON Schema attached to the channel.
-/// The following fields are published:
+/// Which fields are published depends on the [metrics](Self::metrics) selected. By default,
+/// the following fields are published:
 ///
 /// | Field | Type | Description |
 /// | --- | --- | --- |
@@ -183,6 +357,22 @@ impl Encode for SystemInfo {
 /// | `kernel_version` | string | Kernel version string, or empty if unknown. |
 /// | `os_version` | string | OS version string, or empty if unknown. |
 ///
+/// The other metrics add the following fields:
+///
+/// | Metric | Field | Type | Description |
+/// | --- | --- | --- | --- |
+/// | [`CpuPerCore`](SystemInfoMetric::CpuPerCore) | `cpu_percent_per_core` | number[] | CPU usage of each logical CPU, as a percent (0.0 to 100.0). |
+/// | [`Network`](SystemInfoMetric::Network) | `network_received_bytes_per_sec` | number | Bytes received per second, summed over all interfaces. |
+/// | [`Network`](SystemInfoMetric::Network) | `network_transmitted_bytes_per_sec` | number | Bytes transmitted per second, summed over all interfaces. |
+/// | [`Disk`](SystemInfoMetric::Disk) | `disk_read_bytes_per_sec` | number | Bytes read per second, summed over all disks. |
+/// | [`Disk`](SystemInfoMetric::Disk) | `disk_written_bytes_per_sec` | number | Bytes written per second, summed over all disks. |
+/// | [`Sdk`](SystemInfoMetric::Sdk) | `sdk_queued_messages` | integer | Messages currently queued by the context's sinks. |
+/// | [`Sdk`](SystemInfoMetric::Sdk) | `sdk_queued_bytes` | integer | Bytes currently queued by the context's sinks. |
+/// | [`Sdk`](SystemInfoMetric::Sdk) | `sdk_sent_messages` | integer | Messages sent by the context's sinks. |
+/// | [`Sdk`](SystemInfoMetric::Sdk) | `sdk_sent_bytes` | integer | Bytes sent by the context's sinks. |
+/// | [`Sdk`](SystemInfoMetric::Sdk) | `sdk_dropped_messages` | integer | Messages dropped by the context's sinks. |
+/// | [`Sdk`](SystemInfoMetric::Sdk) | `sdk_threads` | object[] | `name`, `count` and `cpu_cores` of the process's threads, grouped by name (Linux only). |
+///
 /// CPU usage values are computed from the difference between consecutive
 /// samples, so they reflect activity over the most recent refresh interval.
 ///
@@ -206,6 +396,7 @@ pub struct SystemInfoPublisher {
     topic: Option<String>,
     refresh_interval: Option<Duration>,
     context: Option<Arc<Context>>,
+    metrics: Option<HashSet<SystemInfoMetric>>,
 }
 
 impl SystemInfoPublisher {
@@ -215,6 +406,7 @@ impl SystemInfoPublisher {
     /// - topic: [`DEFAULT_SYSINFO_TOPIC`] (`/sysinfo`)
     /// - refresh interval: [`DEFAULT_SYSINFO_REFRESH_INTERVAL`] (500ms)
     /// - context: the global default context
+    /// - metrics: [`DEFAULT_SYSINFO_METRICS`]
     pub fn new() -> Self {
         Self::default()
     }
@@ -246,6 +438,18 @@ impl SystemInfoPublisher {
         self
     }
 
+    /// Selects the metrics to collect.
+    ///
+    /// Only the statistics needed for the selected metrics are read on each refresh, which keeps
+    /// the cost of the publisher down on constrained devices. The OS version, kernel version and
+    /// number of CPUs are always published.
+    ///
+    /// Defaults to [`DEFAULT_SYSINFO_METRICS`].
+    pub fn metrics(mut self, metrics: impl IntoIterator<Item = SystemInfoMetric>) -> Self {
+        self.metrics = Some(metrics.into_iter().collect());
+        self
+    }
+
     /// Starts the publisher and returns a [`SystemInfoHandle`] for the background task.
     ///
     /// The task is intended to run until [`SystemInfoHandle::abort`] is called on the
@@ -278,6 +482,9 @@ impl SystemInfoPublisher {
             .topic
             .unwrap_or_else(|| DEFAULT_SYSINFO_TOPIC.to_string());
         let context = self.context.unwrap_or_else(Context::get_default);
+        let metrics = self
+            .metrics
+            .unwrap_or_else(|| DEFAULT_SYSINFO_METRICS.into_iter().collect());
 
         // Create the channel synchronously so it's registered before start() returns.
         let channel = ChannelBuilder::new(topic)
@@ -285,7 +492,12 @@ impl SystemInfoPublisher {
             .build::<SystemInfo>();
 
         SystemInfoHandle {
-            inner: get_runtime_handle().spawn(run_publisher(channel, refresh_interval)),
+            inner: get_runtime_handle().spawn(run_publisher(
+                channel,
+                refresh_interval,
+                metrics,
+                Arc::downgrade(&context),
+            )),
         }
     }
 }
@@ -324,24 +536,13 @@ impl Future for SystemInfoHandle {
     }
 }
 
-async fn run_publisher(channel: Channel<SystemInfo>, refresh_interval: Duration) {
-    let pid = Pid::from_u32(std::process::id());
-    let kernel_version = System::kernel_version().unwrap_or_default();
-    let os_version = System::os_version().unwrap_or_default();
-
-    let mut system = System::new();
-    // Populate the CPU list once so that cpus().len() returns the correct count.
-    // New CPUs being added at runtime is vanishingly rare, so we don't refresh this.
-    let cpu_refresh = CpuRefreshKind::nothing().with_cpu_usage();
-    system.refresh_cpu_list(cpu_refresh);
-    let num_cpus = u32::try_from(system.cpus().len()).unwrap_or(u32::MAX);
-
-    let process_refresh = ProcessRefreshKind::nothing().with_cpu().with_memory();
-    // Prime the per-process and global CPU usage; the first reading is always 0
-    // since it relies on diffs between consecutive samples.
-    system.refresh_processes_specifics(ProcessesToUpdate::Some(&[pid]), false, process_refresh);
-    system.refresh_cpu_specifics(cpu_refresh);
-
+async fn run_publisher(
+    channel: Channel<SystemInfo>,
+    refresh_interval: Duration,
+    metrics: HashSet<SystemInfoMetric>,
+    context: Weak<Context>,
+) {
+    let mut sampler = Sampler::new(metrics, context);
     let mut interval = tokio::time::interval(refresh_interval);
     interval.set_missed_tick_behavior(MissedTickBehavior::Skip);
     // The first tick fires immediately; consume it to align subsequent ticks to the period.
@@ -349,50 +550,253 @@ async fn run_publisher(channel: Channel<SystemInfo>, refresh_interval: Duration)
 
     loop {
         interval.tick().await;
+        channel.log(&sampler.sample());
+    }
+}
 
-        system.refresh_memory();
-        system.refresh_processes_specifics(ProcessesToUpdate::Some(&[pid]), false, process_refresh);
-        system.refresh_cpu_specifics(cpu_refresh);
-
-        let (process_memory, process_virtual_memory, process_cpu_per_core_percent) = system
-            .process(pid)
-            .map(|p| (p.memory(), p.virtual_memory(), p.cpu_usage()))
-            .unwrap_or_default();
-
-        // sysinfo reports per-process CPU usage normalized per logical CPU
-        // (100.0 == one CPU fully utilized, max == 100.0 * num_cpus), and global
-        // CPU usage as a 0-100 percent of total capacity. Convert both to a
-        // common pair of representations: a percent of total system capacity
-        // and an equivalent number of busy cores.
-        let process_cpu_cores = f64::from(process_cpu_per_core_percent) / 100.0;
-        let process_cpu_percent = if num_cpus > 0 {
-            f64::from(process_cpu_per_core_percent) / f64::from(num_cpus)
+/// Collects the statistics for a set of metrics.
+struct Sampler {
+    metrics: HashSet<SystemInfoMetric>,
+    context: Weak<Context>,
+    pid: Pid,
+    num_cpus: u32,
+    kernel_version: String,
+    os_version: String,
+    system: System,
+    networks: Option<Networks>,
+    disks: Option<Disks>,
+    /// The time of the previous sample, for converting byte counts to rates.
+    last_sample: Instant,
+}
+
+impl Sampler {
+    /// Creates a sampler, and takes the initial sample of the statistics which are computed from
+    /// the difference between consecutive samples.
+    fn new(metrics: HashSet<SystemInfoMetric>, context: Weak<Context>) -> Self {
+        let mut system = System::new();
+        // Populate the CPU list once so that cpus().len() returns the correct count.
+        // New CPUs being added at runtime is vanishingly rare, so we don't refresh this.
+        system.refresh_cpu_list(CpuRefreshKind::nothing().with_cpu_usage());
+        let num_cpus = u32::try_from(system.cpus().len()).unwrap_or(u32::MAX);
+        let networks = metrics
+            .contains(&SystemInfoMetric::Network)
+            .then(Networks::new_with_refreshed_list);
+        let disks = metrics.contains(&SystemInfoMetric::Disk).then(|| {
+            Disks::new_with_refreshed_list_specifics(DiskRefreshKind::nothing().with_io_usage())
+        });
+        let mut sampler = Self {
+            metrics,
+            context,
+            pid: Pid::from_u32(std::process::id()),
+            num_cpus,
+            kernel_version: System::kernel_version().unwrap_or_default(),
+            os_version: System::os_version().unwrap_or_default(),
+            system,
+            networks,
+            disks,
+            last_sample: Instant::now(),
+        };
+        // Prime the CPU usage; the first reading is always 0 since it relies on diffs between
+        // consecutive samples.
+        sampler.refresh_processes();
+        sampler.refresh_cpu();
+        sampler
+    }
+
+    fn has(&self, metric: SystemInfoMetric) -> bool {
+        self.metrics.contains(&metric)
+    }
+
+    /// Refreshes the process, and its threads if SDK metrics are collected.
+    fn refresh_processes(&mut self) -> Vec<Pid> {
+        let mut pids = Vec::new();
+        if self.has(SystemInfoMetric::Process) {
+            pids.push(self.pid);
+        }
+        // The main thread's id is the process id, whose statistics cover the whole process, so
+        // it is not reported as a thread.
+        let threads: Vec<_> = if self.has(SystemInfoMetric::Sdk) {
+            thread_ids()
+                .into_iter()
+                .filter(|&tid| tid != self.pid)
+                .collect()
         } else {
-            0.0
+            Vec::new()
+        };
+        pids.extend_from_slice(&threads);
+        if !pids.is_empty() {
+            // Exited threads are only removed if all refreshed processes are listed together.
+            self.system.refresh_processes_specifics(
+                ProcessesToUpdate::Some(&pids),
+                true,
+                ProcessRefreshKind::nothing().with_cpu().with_memory(),
+            );
+        }
+        threads
+    }
+
+    fn refresh_cpu(&mut self) {
+        if self.has(SystemInfoMetric::Process)
+            || self.has(SystemInfoMetric::Cpu)
+            || self.has(SystemInfoMetric::CpuPerCore)
+            || self.has(SystemInfoMetric::Sdk)
+        {
+            self.system
+                .refresh_cpu_specifics(CpuRefreshKind::nothing().with_cpu_usage());
+        }
+    }
+
+    fn sample(&mut self) -> SystemInfo {
+        let now = Instant::now();
+        let elapsed = now.duration_since(self.last_sample).as_secs_f64();
+        self.last_sample = now;
+        let per_sec = |bytes: u64| {
+            if elapsed > 0.0 {
+                bytes as f64 / elapsed
+            } else {
+                0.0
+            }
         };
-        let total_cpu_percent = f64::from(system.global_cpu_usage());
-        let total_cpu_cores = total_cpu_percent * f64::from(num_cpus) / 100.0;
-
-        let info = SystemInfo {
-            process_memory: process_memory as f64,
-            process_virtual_memory: process_virtual_memory as f64,
-            process_cpu_percent,
-            process_cpu_cores,
-            total_cpu_percent,
-            total_cpu_cores,
+
+        let threads = self.refresh_processes();
+        self.refresh_cpu();
+        let num_cpus = self.num_cpus;
+        let mut info = SystemInfo {
             num_cpus,
-            total_memory: system.total_memory() as f64,
-            used_memory: system.used_memory() as f64,
-            total_swap: system.total_swap() as f64,
-            used_swap: system.used_swap() as f64,
-            kernel_version: kernel_version.clone(),
-            os_version: os_version.clone(),
+            kernel_version: self.kernel_version.clone(),
+            os_version: self.os_version.clone(),
+            ..SystemInfo::default()
         };
 
-        channel.log(&info);
+        if self.has(SystemInfoMetric::Process) {
+            let (memory, virtual_memory, cpu_per_core_percent) = self
+                .system
+                .process(self.pid)
+                .map(|p| (p.memory(), p.virtual_memory(), p.cpu_usage()))
+                .unwrap_or_default();
+            // sysinfo reports per-process CPU usage normalized per logical CPU
+            // (100.0 == one CPU fully utilized, max == 100.0 * num_cpus), and global
+            // CPU usage as a 0-100 percent of total capacity. Convert both to a
+            // common pair of representations: a percent of total system capacity
+            // and an equivalent number of busy cores.
+            info.process = Some(ProcessInfo {
+                process_memory: memory as f64,
+                process_virtual_memory: virtual_memory as f64,
+                process_cpu_percent: if num_cpus > 0 {
+                    f64::from(cpu_per_core_percent) / f64::from(num_cpus)
+                } else {
+                    0.0
+                },
+                process_cpu_cores: f64::from(cpu_per_core_percent) / 100.0,
+            });
+        }
+
+        if self.has(SystemInfoMetric::Cpu) {
+            let total_cpu_percent = f64::from(self.system.global_cpu_usage());
+            info.cpu = Some(CpuInfo {
+                total_cpu_percent,
+                total_cpu_cores: total_cpu_percent * f64::from(num_cpus) / 100.0,
+            });
+        }
+
+        if self.has(SystemInfoMetric::CpuPerCore) {
+            info.cpu_percent_per_core = Some(
+                self.system
+                    .cpus()
+                    .iter()
+                    .map(|cpu| f64::from(cpu.cpu_usage()))
+                    .collect(),
+            );
+        }
+
+        if self.has(SystemInfoMetric::Memory) {
+            self.system.refresh_memory();
+            info.memory = Some(MemoryInfo {
+                total_memory: self.system.total_memory() as f64,
+                used_memory: self.system.used_memory() as f64,
+                total_swap: self.system.total_swap() as f64,
+                used_swap: self.system.used_swap() as f64,
+            });
+        }
+
+        if let Some(networks) = &mut self.networks {
+            networks.refresh(true);
+            let (received, transmitted) = networks.values().fold((0, 0), |(rx, tx), data| {
+                (rx + data.received(), tx + data.transmitted())
+            });
+            info.network = Some(NetworkInfo {
+                network_received_bytes_per_sec: per_sec(received),
+                network_transmitted_bytes_per_sec: per_sec(transmitted),
+            });
+        }
+
+        if let Some(disks) = &mut self.disks {
+            disks.refresh_specifics(true, DiskRefreshKind::nothing().with_io_usage());
+            let (read, written) = disks.list().iter().fold((0, 0), |(read, written), disk| {
+                let usage = disk.usage();
+                (read + usage.read_bytes, written + usage.written_bytes)
+            });
+            info.disk = Some(DiskInfo {
+                disk_read_bytes_per_sec: per_sec(read),
+                disk_written_bytes_per_sec: per_sec(written),
+            });
+        }
+
+        if self.has(SystemInfoMetric::Sdk) {
+            let stats = self
+                .context
+                .upgrade()
+                .map(|context| context.sink_stats())
+                .unwrap_or_default();
+            info.sdk = Some(SdkInfo {
+                sdk_queued_messages: stats.queued_messages as u64,
+                sdk_queued_bytes: stats.queued_bytes as u64,
+                sdk_sent_messages: stats.sent_messages,
+                sdk_sent_bytes: stats.sent_bytes,
+                sdk_dropped_messages: stats.dropped_messages,
+                sdk_threads: group_threads(threads.iter().filter_map(|tid| {
+                    let thread = self.system.process(*tid)?;
+                    Some((thread.name().to_string_lossy(), thread.cpu_usage()))
+                })),
+            });
+        }
+
+        info
     }
 }
 
+/// Groups the CPU usage of threads, given as a percent of one CPU, by thread name.
+fn group_threads<'a>(threads: impl Iterator<Item = (Cow<'a, str>, f32)>) -> Vec<ThreadInfo> {
+    let mut groups: BTreeMap<Cow<'a, str>, ThreadInfo> = BTreeMap::new();
+    for (name, cpu_usage) in threads {
+        let group = groups.entry(name).or_insert_with_key(|name| ThreadInfo {
+            name: name.to_string(),
+            ..ThreadInfo::default()
+        });
+        group.count += 1;
+        group.cpu_cores += f64::from(cpu_usage) / 100.0;
+    }
+    groups.into_values().collect()
+}
+
+/// Returns the ids of the process's threads.
+#[cfg(target_os = "linux")]
+fn thread_ids() -> Vec<Pid> {
+    let Ok(entries) = std::fs::read_dir("/proc/self/task") else {
+        return Vec::new();
+    };
+    entries
+        .filter_map(|entry| entry.ok()?.file_name().to_str()?.parse::<u32>().ok())
+        .map(Pid::from_u32)
+        .collect()
+}
+
+/// Returns the ids of the process's threads.
+#[cfg(not(target_os = "linux"))]
+fn thread_ids() -> Vec<Pid> {
+    Vec::new()
+}
+
 #[cfg(test)]
 mod tests {
     use crate::{Context, Encode};
@@ -410,28 +814,45 @@ mod tests {
         assert!(parsed["properties"]["process_memory"].is_object());
     }
 
+    /// Returns a message with every metric present.
+    fn full_info() -> SystemInfo {
+        SystemInfo {
+            process: Some(ProcessInfo {
+                process_memory: 1.0,
+                process_virtual_memory: 2.0,
+                process_cpu_percent: 3.0,
+                process_cpu_cores: 3.5,
+            }),
+            cpu: Some(CpuInfo {
+                total_cpu_percent: 4.0,
+                total_cpu_cores: 4.5,
+            }),
+            cpu_percent_per_core: Some(vec![10.0, 20.0]),
+            num_cpus: 5,
+            memory: Some(MemoryInfo {
+                total_memory: 6.0,
+                used_memory: 7.0,
+                total_swap: 8.0,
+                used_swap: 9.0,
+            }),
+            network: Some(NetworkInfo::default()),
+            disk: Some(DiskInfo::default()),
+            sdk: Some(SdkInfo {
+                sdk_threads: vec![ThreadInfo::default()],
+                ..SdkInfo::default()
+            }),
+            kernel_version: "k".to_string(),
+            os_version: "o".to_string(),
+        }
+    }
+
     #[test]
     fn schema_properties_match_serialized_fields() {
         // Guards against drift between the hand-written JSON schema and the
         // SystemInfo struct: any field added/renamed/removed must be reflected
         // in both places, otherwise this test fails.
-        let info = SystemInfo {
-            process_memory: 0.0,
-            process_virtual_memory: 0.0,
-            process_cpu_percent: 0.0,
-            process_cpu_cores: 0.0,
-            total_cpu_percent: 0.0,
-            total_cpu_cores: 0.0,
-            num_cpus: 0,
-            total_memory: 0.0,
-            used_memory: 0.0,
-            total_swap: 0.0,
-            used_swap: 0.0,
-            kernel_version: String::new(),
-            os_version: String::new(),
-        };
         let serialized: serde_json::Value =
-            serde_json::to_value(&info).expect("SystemInfo serializes");
+            serde_json::to_value(full_info()).expect("SystemInfo serializes");
         let serialized_keys: std::collections::BTreeSet<String> = serialized
             .as_object()
             .expect("SystemInfo serializes as a JSON object")
@@ -456,27 +877,62 @@ mod tests {
 
     #[test]
     fn encodes_as_json() {
-        let info = SystemInfo {
-            process_memory: 1.0,
-            process_virtual_memory: 2.0,
-            process_cpu_percent: 3.0,
-            process_cpu_cores: 3.5,
-            total_cpu_percent: 4.0,
-            total_cpu_cores: 4.5,
-            num_cpus: 5,
-            total_memory: 6.0,
-            used_memory: 7.0,
-            total_swap: 8.0,
-            used_swap: 9.0,
-            kernel_version: "k".to_string(),
-            os_version: "o".to_string(),
-        };
+        let info = full_info();
         let mut buf = Vec::new();
         info.encode(&mut buf).expect("encode");
         let parsed: serde_json::Value = serde_json::from_slice(&buf).expect("valid JSON");
         assert_eq!(parsed["num_cpus"], 5);
         assert_eq!(parsed["kernel_version"], "k");
         assert_eq!(parsed["os_version"], "o");
+        assert_eq!(parsed["process_cpu_cores"], 3.5);
+        assert_eq!(
+            parsed["cpu_percent_per_core"],
+            serde_json::json!([10.0, 20.0])
+        );
+    }
+
+    #[test]
+    fn omits_fields_of_unselected_metrics() {
+        let mut sampler = Sampler::new(
+            [SystemInfoMetric::CpuPerCore, SystemInfoMetric::Sdk]
+                .into_iter()
+                .collect(),
+            Weak::new(),
+        );
+        let parsed = serde_json::to_value(sampler.sample()).expect("SystemInfo serializes");
+        let keys: Vec<_> = parsed.as_object().unwrap().keys().cloned().collect();
+        for key in &keys {
+            assert!(
+                key.starts_with("sdk_")
+                    || [
+                        "cpu_percent_per_core",
+                        "num_cpus",
+                        "kernel_version",
+                        "os_version"
+                    ]
+                    .contains(&key.as_str()),
+                "unexpected field {key}"
+            );
+        }
+        assert_eq!(
+            parsed["cpu_percent_per_core"].as_array().unwrap().len(),
+            sampler.num_cpus as usize
+        );
+        assert_eq!(parsed["sdk_queued_messages"], 0);
+    }
+
+    #[test]
+    fn groups_threads_by_name() {
+        let threads = group_threads(
+            [("worker", 50.0), ("main", 10.0), ("worker", 25.0)]
+                .into_iter()
+                .map(|(name, usage)| (Cow::Borrowed(name), usage)),
+        );
+        assert_eq!(threads.len(), 2);
+        assert_eq!(threads[0].name, "main");
+        assert_eq!(threads[1].name, "worker");
+        assert_eq!(threads[1].count, 2);
+        assert_eq!(threads[1].cpu_cores, 0.75);
     }
 
     #[tokio::test(flavor = "current_thread")]
@@ -503,6 +959,7 @@ mod tests {
         assert!(publisher.topic.is_none());
         assert!(publisher.refresh_interval.is_none());
         assert!(publisher.context.is_none());
+        assert!(publisher.metrics.is_none());
     }
 
     #[test]
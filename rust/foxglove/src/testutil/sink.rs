@@ -1,6 +1,7 @@
 use std::sync::Arc;
 
-use crate::{ChannelId, FoxgloveError, Metadata, RawChannel, Sink, SinkId};
+use crate::{ChannelId, FoxgloveError, MessageFilter, Metadata, RawChannel, Sink, SinkId};
+use bytes::Bytes;
 use parking_lot::Mutex;
 
 pub struct MockSink(SinkId);
@@ -29,6 +30,8 @@ pub struct LogCall {
     pub channel_id: ChannelId,
     pub msg: Vec<u8>,
     pub metadata: Metadata,
+    /// The shared buffer the message was logged from, if it was logged with `log_shared`.
+    pub shared: Option<Bytes>,
 }
 
 type AddChannelFn = Box<dyn Fn(&[&Arc<RawChannel>]) -> Option<Vec<ChannelId>> + Send + Sync>;
@@ -36,7 +39,9 @@ type AddChannelFn = Box<dyn Fn(&[&Arc<RawChannel>]) -> Option<Vec<ChannelId>> +
 pub struct RecordingSink {
     id: SinkId,
     auto_subscribe: bool,
+    lossless: bool,
     add_channels_func: Option<AddChannelFn>,
+    message_filter: Option<Arc<dyn MessageFilter>>,
     recorded: Mutex<Vec<LogCall>>,
 }
 
@@ -45,7 +50,9 @@ impl RecordingSink {
         Self {
             id: SinkId::next(),
             auto_subscribe: true,
+            lossless: false,
             add_channels_func: None,
+            message_filter: None,
             recorded: Mutex::new(Vec::new()),
         }
     }
@@ -63,6 +70,16 @@ impl RecordingSink {
         self
     }
 
+    pub fn lossless(mut self, value: bool) -> Self {
+        self.lossless = value;
+        self
+    }
+
+    pub fn message_filter(mut self, filter: Arc<dyn MessageFilter>) -> Self {
+        self.message_filter = Some(filter);
+        self
+    }
+
     pub fn take_messages(&self) -> Vec<LogCall> {
         std::mem::take(&mut *self.recorded.lock())
     }
@@ -77,6 +94,14 @@ impl Sink for RecordingSink {
         self.auto_subscribe
     }
 
+    fn message_filter(&self) -> Option<&Arc<dyn MessageFilter>> {
+        self.message_filter.as_ref()
+    }
+
+    fn is_lossless(&self) -> bool {
+        self.lossless
+    }
+
     fn add_channels(&self, channels: &[&Arc<RawChannel>]) -> Option<Vec<ChannelId>> {
         if let Some(func) = self.add_channels_func.as_ref() {
             func(channels)
@@ -96,6 +121,23 @@ impl Sink for RecordingSink {
             channel_id: channel.id(),
             msg: msg.to_vec(),
             metadata: *metadata,
+            shared: None,
+        });
+        Ok(())
+    }
+
+    fn log_shared(
+        &self,
+        channel: &RawChannel,
+        msg: &Bytes,
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        let mut recorded = self.recorded.lock();
+        recorded.push(LogCall {
+            channel_id: channel.id(),
+            msg: msg.to_vec(),
+            metadata: *metadata,
+            shared: Some(msg.clone()),
         });
         Ok(())
     }
@@ -5,7 +5,7 @@ use parking_lot::Mutex;
 
 use crate::ChannelId;
 use crate::websocket::{
-    AnyClient, ChannelView, Client, ClientChannel, ClientChannelId, ClientId,
+    AnyClient, ChannelView, Client, ClientChannel, ClientChannelId, ClientId, ClientStats,
     GetParametersResponder, Parameter, ParameterHandler, ServerListener, SetParametersResponder,
 };
 
@@ -72,6 +72,7 @@ pub(crate) struct RecordingServerListener {
     parameters_get_result: Mutex<Vec<Parameter>>,
     connection_graph_subscribe: AtomicUsize,
     connection_graph_unsubscribe: AtomicUsize,
+    backpressure: Mutex<Vec<(ClientId, ClientStats)>>,
 }
 
 impl RecordingServerListener {
@@ -89,6 +90,7 @@ impl RecordingServerListener {
             parameters_get_result: Mutex::default(),
             connection_graph_subscribe: AtomicUsize::default(),
             connection_graph_unsubscribe: AtomicUsize::default(),
+            backpressure: Mutex::default(),
         }
     }
 
@@ -169,6 +171,10 @@ impl RecordingServerListener {
     pub fn take_connection_graph_unsubscribe(&self) -> usize {
         self.connection_graph_unsubscribe.swap(0, Ordering::AcqRel)
     }
+
+    pub fn take_backpressure(&self) -> Vec<(ClientId, ClientStats)> {
+        std::mem::take(&mut self.backpressure.lock())
+    }
 }
 
 impl ServerListener for RecordingServerListener {
@@ -248,6 +254,10 @@ impl ServerListener for RecordingServerListener {
     fn on_connection_graph_unsubscribe(&self) {
         self.inc_connection_graph_unsubscribe();
     }
+
+    fn on_backpressure(&self, client: Client, stats: &ClientStats) {
+        self.backpressure.lock().push((client.id(), stats.clone()));
+    }
 }
 
 /// Behavior for the `RecordingParameterHandler` set callback: how should `set` respond?
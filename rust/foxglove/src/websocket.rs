@@ -1,36 +1,49 @@
 //! WebSocket functionality
 
 mod advertise;
+mod backlog;
+mod broadcast_limiter;
 mod capability;
 mod channel_view;
 mod client;
 mod client_channel;
 mod connected_client;
 mod cow_vec;
+mod deflate;
 pub(crate) mod handshake;
+mod parameter_store;
+mod projection;
 mod server;
 mod server_listener;
 pub mod service;
+mod stats;
 mod streams;
 mod subscription;
 #[cfg(test)]
 mod tests;
+#[cfg(feature = "websocket-video")]
+mod video;
 #[doc(hidden)]
 pub mod ws_protocol;
 
 pub(crate) use crate::remote_common::fetch_asset::{AsyncAssetHandlerFn, BlockingAssetHandlerFn};
 pub use crate::remote_common::{
-    AnyClient, AssetHandler, AssetResponder, ClientId, ConnectionGraph, GetParametersResponder,
-    Parameter, ParameterDecodeError, ParameterHandler, ParameterType, ParameterValue,
-    SetParametersResponder, Status, StatusLevel,
+    AnyClient, AssetHandler, AssetResponder, AssetWriter, ClientId, ConnectionGraph,
+    ConnectionGraphPatch, FileAssetHandler, GetParametersResponder, Parameter,
+    ParameterDecodeError, ParameterHandler, ParameterType, ParameterValue, SetParametersResponder,
+    Status, StatusLevel,
 };
+pub use backlog::{BacklogDropPolicy, SubscriptionOptions};
 pub use capability::Capability;
 pub use channel_view::ChannelView;
 pub use client::Client;
 pub use client_channel::{ClientChannel, ClientChannelId};
-pub use server::ShutdownHandle;
+pub use server::{SHARED_MEMORY_SERVER_INFO_KEY, ShutdownHandle};
 pub(crate) use server::{Server, ServerOptions, create_server};
 pub use server_listener::ServerListener;
+pub use stats::{BACKPRESSURE_INTERVAL, ChannelStats, ClientStats};
 pub use streams::TlsIdentity;
+#[cfg(feature = "websocket-video")]
+pub use video::{VideoEncoder, VideoEncoderError, VideoEncoderFactory, VideoFrame};
 pub use ws_protocol::client::{PlaybackCommand, PlaybackControlRequest};
 pub use ws_protocol::server::playback_state::{PlaybackState, PlaybackStatus};
@@ -0,0 +1,762 @@
+//! Per-client backlog of data plane messages.
+
+use std::collections::{BTreeMap, HashMap, VecDeque};
+use std::net::SocketAddr;
+use std::time::Duration;
+
+use parking_lot::Mutex;
+use tokio::sync::Notify;
+use tokio::time::Instant;
+use tokio_tungstenite::tungstenite::Message;
+
+use crate::ChannelId;
+use crate::latency::Trace;
+use crate::memory_budget::MemoryAccount;
+use crate::remote_common::ClientId;
+use crate::throttler::Throttler;
+
+use super::stats::{ChannelStats, ClientStats};
+
+static THROTTLER: Mutex<Throttler> = Mutex::new(Throttler::new(Duration::from_secs(30)));
+
+/// How a client's message backlog makes room when it exceeds its limits.
+///
+/// See [`WebSocketServer::message_backlog_size`][crate::WebSocketServer::message_backlog_size]
+/// and [`WebSocketServer::message_backlog_bytes`][crate::WebSocketServer::message_backlog_bytes].
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum BacklogDropPolicy {
+    /// Drop the oldest queued messages, whichever channel they were logged to.
+    #[default]
+    DropOldest,
+    /// Drop stale messages from the busiest channels, keeping the latest message of each channel.
+    ///
+    /// When the backlog has too many messages, the oldest message of the channel with the most
+    /// queued messages is dropped. When it has too many bytes, the oldest message of the channel
+    /// with the most queued bytes is dropped. Messages which are the only queued message of their
+    /// channel are only dropped if every channel has a single queued message. This keeps a
+    /// high-rate or high-bandwidth topic from pushing the messages of low-rate topics out of the
+    /// backlog.
+    KeepLatestPerChannel,
+}
+
+/// Options for delivering the messages of each of a client's subscriptions.
+///
+/// See [`WebSocketServer::subscription_options`][crate::WebSocketServer::subscription_options].
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct SubscriptionOptions {
+    /// The maximum rate at which messages are sent for each subscription, in messages per second.
+    ///
+    /// Rate-limited subscriptions are conflated: a message logged before the previous message of
+    /// the channel could be sent replaces it, so that the client receives the latest message at
+    /// most this often. Unlimited if `None`, or if the rate is not positive.
+    pub max_rate: Option<f64>,
+    /// Whether to conflate the messages of each subscription.
+    ///
+    /// At most one message per subscription is queued for the client. A message logged while the
+    /// previous message of its channel is still queued replaces it, keeping its place in the
+    /// queue. The rate of each subscription then adapts to how fast the client drains its queue:
+    /// a client on a fast link receives every message, while a client on a slow link receives the
+    /// latest message of each channel as bandwidth frees up, instead of a backlog of stale ones.
+    pub conflate: bool,
+}
+
+/// Limits on the data plane messages queued for a client.
+#[derive(Debug, Clone, Copy)]
+pub(crate) struct BacklogLimits {
+    /// The maximum number of queued messages.
+    pub messages: usize,
+    /// The maximum number of queued bytes, if limited.
+    pub bytes: Option<usize>,
+    /// The maximum number of queued bytes per channel, if limited.
+    pub channel_bytes: Option<usize>,
+    /// How to make room when a limit is exceeded.
+    pub policy: BacklogDropPolicy,
+    /// How messages logged to a channel are delivered.
+    pub subscription: SubscriptionOptions,
+}
+
+/// Limits on the data plane messages gathered into a message batch, for clients which enabled
+/// message batches.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) struct BatchLimits {
+    /// How long to wait for more messages after the first message of a batch.
+    ///
+    /// With no linger, a batch only gathers the messages which are already queued.
+    pub linger: Duration,
+    /// The maximum size of a batch, in bytes.
+    pub bytes: usize,
+}
+
+impl Default for BatchLimits {
+    fn default() -> Self {
+        Self {
+            linger: Duration::ZERO,
+            bytes: 64 * 1024,
+        }
+    }
+}
+
+/// A queue of data plane messages for a client, which drops messages to stay within its limits.
+///
+/// Messages are sent in the order they were queued.
+pub(super) struct DataPlane {
+    addr: SocketAddr,
+    queue: Mutex<Queue>,
+    notify: Notify,
+}
+
+impl DataPlane {
+    pub fn new(addr: SocketAddr, limits: BacklogLimits, memory: MemoryAccount) -> Self {
+        Self {
+            addr,
+            queue: Mutex::new(Queue::new(limits, memory)),
+            notify: Notify::new(),
+        }
+    }
+
+    /// Queues a message logged to a channel, or to no channel, dropping older messages to stay
+    /// within the limits and the context's memory budget.
+    ///
+    /// The new message is never dropped, so a message larger than the byte limits is sent once the
+    /// messages queued before it have been dropped. Returns the number of messages dropped.
+    pub fn push(
+        &self,
+        channel_id: Option<ChannelId>,
+        message: Message,
+        trace: Option<Trace>,
+    ) -> usize {
+        let dropped = self.queue.lock().push(channel_id, message, trace);
+        self.notify.notify_one();
+        if dropped > 0 && THROTTLER.lock().try_acquire() {
+            tracing::info!("outbox for client {} full", self.addr);
+        }
+        dropped
+    }
+
+    /// Forgets the state of channels which are no longer subscribed.
+    ///
+    /// Messages which are already queued for the channels are still sent.
+    pub fn remove_channels(&self, channel_ids: &[ChannelId]) {
+        self.queue.lock().remove_channels(channel_ids);
+    }
+
+    /// Returns the delivery counters of the queue.
+    pub fn stats(&self, client_id: ClientId) -> ClientStats {
+        self.queue.lock().stats(client_id)
+    }
+
+    /// Waits for the next message which may be sent, and returns it with its channel and its
+    /// latency trace, if it was sampled.
+    ///
+    /// This is cancel safe: if the future is dropped, no message is lost.
+    pub async fn pop(&self) -> (Option<ChannelId>, Message, Option<Trace>) {
+        loop {
+            let next = self.queue.lock().pop(Instant::now());
+            match next {
+                Next::Message(channel_id, message, mut trace) => {
+                    if let Some(trace) = &mut trace {
+                        trace.dequeue();
+                    }
+                    return (channel_id, message, trace);
+                }
+                Next::Wait(deadline) => {
+                    tokio::select! {
+                        () = self.notify.notified() => (),
+                        () = tokio::time::sleep_until(deadline) => (),
+                    }
+                }
+                Next::Empty => self.notify.notified().await,
+            }
+        }
+    }
+}
+
+struct Queued {
+    channel_id: Option<ChannelId>,
+    message: Message,
+    size: usize,
+    trace: Option<Trace>,
+}
+
+/// The messages queued for one channel.
+#[derive(Default)]
+struct ChannelQueue {
+    /// Sequence numbers of the channel's messages, oldest first.
+    seqs: VecDeque<u64>,
+    bytes: usize,
+}
+
+/// The result of [`Queue::pop`].
+#[derive(Debug)]
+enum Next {
+    Message(Option<ChannelId>, Message, Option<Trace>),
+    /// The queued messages are rate limited until the deadline.
+    Wait(Instant),
+    Empty,
+}
+
+struct Queue {
+    limits: BacklogLimits,
+    /// Charged with the queued bytes, against the context's memory budget.
+    memory: MemoryAccount,
+    /// Whether a channel's queued message is replaced by the channel's next message.
+    conflate: bool,
+    /// The minimum interval between the messages sent for a channel, if rate limited.
+    min_interval: Option<Duration>,
+    /// The time the last message of each rate-limited channel was sent.
+    sent: HashMap<ChannelId, Instant>,
+    next_seq: u64,
+    /// The queued messages by sequence number.
+    messages: BTreeMap<u64, Queued>,
+    bytes: usize,
+    channels: HashMap<Option<ChannelId>, ChannelQueue>,
+    /// Delivery counters of the channels which have queued messages since they were subscribed.
+    stats: HashMap<ChannelId, ChannelStats>,
+    sent_count: u64,
+    sent_bytes: u64,
+    dropped: u64,
+    max_messages: usize,
+    max_bytes: usize,
+}
+
+impl Queue {
+    fn new(limits: BacklogLimits, memory: MemoryAccount) -> Self {
+        let min_interval = limits
+            .subscription
+            .max_rate
+            .filter(|rate| *rate > 0.0)
+            .and_then(|rate| Duration::try_from_secs_f64(rate.recip()).ok());
+        Self {
+            limits,
+            memory,
+            conflate: limits.subscription.conflate || min_interval.is_some(),
+            min_interval,
+            sent: HashMap::new(),
+            next_seq: 0,
+            messages: BTreeMap::new(),
+            bytes: 0,
+            channels: HashMap::new(),
+            stats: HashMap::new(),
+            sent_count: 0,
+            sent_bytes: 0,
+            dropped: 0,
+            max_messages: 0,
+            max_bytes: 0,
+        }
+    }
+
+    fn push(
+        &mut self,
+        channel_id: Option<ChannelId>,
+        message: Message,
+        trace: Option<Trace>,
+    ) -> usize {
+        let size = message.len();
+        let mut dropped = 0;
+        let channel = self.channels.entry(channel_id).or_default();
+        if self.conflate
+            && channel_id.is_some()
+            && let Some(queued) = channel
+                .seqs
+                .front()
+                .and_then(|seq| self.messages.get_mut(seq))
+        {
+            // Replace the channel's queued message, keeping its place in the queue.
+            channel.bytes = channel.bytes - queued.size + size;
+            self.bytes = self.bytes - queued.size + size;
+            self.memory.release(queued.size);
+            self.memory.charge(size);
+            queued.message = message;
+            queued.size = size;
+            queued.trace = trace;
+            if let Some(stats) = channel_id.and_then(|id| self.stats.get_mut(&id)) {
+                stats.conflated += 1;
+            }
+        } else {
+            let seq = self.next_seq;
+            self.next_seq += 1;
+            channel.seqs.push_back(seq);
+            channel.bytes += size;
+            self.bytes += size;
+            self.memory.charge(size);
+            self.messages.insert(
+                seq,
+                Queued {
+                    channel_id,
+                    message,
+                    size,
+                    trace,
+                },
+            );
+        }
+        if let Some(id) = channel_id {
+            self.stats
+                .entry(id)
+                .or_insert_with(|| ChannelStats::new(id))
+                .sequence += 1;
+        }
+
+        if let Some(limit) = self.limits.channel_bytes {
+            while let Some(channel) = self.channels.get(&channel_id)
+                && channel.bytes > limit
+                && channel.seqs.len() > 1
+            {
+                self.drop_oldest(channel_id);
+                dropped += 1;
+            }
+        }
+        while self.messages.len() > 1 {
+            let victim = if self.messages.len() > self.limits.messages.max(1) {
+                self.victim(|channel| channel.seqs.len())
+            } else if self.limits.bytes.is_some_and(|limit| self.bytes > limit) {
+                self.victim(|channel| channel.bytes)
+            } else if self.memory.exceeded() {
+                self.memory.dropped();
+                self.victim(|channel| channel.bytes)
+            } else {
+                break;
+            };
+            self.drop_oldest(victim);
+            dropped += 1;
+        }
+
+        self.max_messages = self.max_messages.max(self.messages.len());
+        self.max_bytes = self.max_bytes.max(self.bytes);
+        if let Some(id) = channel_id
+            && let Some(channel) = self.channels.get(&channel_id)
+            && let Some(stats) = self.stats.get_mut(&id)
+        {
+            stats.max_queued_messages = stats.max_queued_messages.max(channel.seqs.len());
+            stats.max_queued_bytes = stats.max_queued_bytes.max(channel.bytes);
+        }
+        dropped
+    }
+
+    /// Returns the key of the channel whose oldest message should be dropped, ranking channels by
+    /// `load` under [`BacklogDropPolicy::KeepLatestPerChannel`].
+    fn victim(&self, load: impl Fn(&ChannelQueue) -> usize) -> Option<ChannelId> {
+        let oldest = || {
+            self.messages
+                .first_key_value()
+                .and_then(|(_, queued)| queued.channel_id)
+        };
+        match self.limits.policy {
+            BacklogDropPolicy::DropOldest => oldest(),
+            BacklogDropPolicy::KeepLatestPerChannel => self
+                .channels
+                .iter()
+                .filter(|(_, channel)| channel.seqs.len() > 1)
+                .max_by_key(|(_, channel)| load(channel))
+                .map_or_else(oldest, |(&channel_id, _)| channel_id),
+        }
+    }
+
+    /// Drops the oldest message queued for the channel.
+    fn drop_oldest(&mut self, channel_id: Option<ChannelId>) {
+        if let Some(&seq) = self
+            .channels
+            .get(&channel_id)
+            .and_then(|channel| channel.seqs.front())
+        {
+            self.remove(seq);
+            self.dropped += 1;
+            if let Some(stats) = channel_id.and_then(|id| self.stats.get_mut(&id)) {
+                stats.dropped += 1;
+            }
+        }
+    }
+
+    /// Removes a message, which must be the oldest message queued for its channel.
+    fn remove(&mut self, seq: u64) -> Option<Queued> {
+        let queued = self.messages.remove(&seq)?;
+        self.bytes -= queued.size;
+        self.memory.release(queued.size);
+        if let Some(channel) = self.channels.get_mut(&queued.channel_id) {
+            channel.seqs.pop_front();
+            channel.bytes -= queued.size;
+            if channel.seqs.is_empty() {
+                self.channels.remove(&queued.channel_id);
+            }
+        }
+        Some(queued)
+    }
+
+    /// Returns the time at which the next message of the channel may be sent, if it is rate
+    /// limited.
+    fn next_send(&self, channel_id: Option<ChannelId>) -> Option<Instant> {
+        let interval = self.min_interval?;
+        let sent = self.sent.get(&channel_id?)?;
+        Some(*sent + interval)
+    }
+
+    /// Removes the oldest message which may be sent at `now`.
+    ///
+    /// Messages of rate-limited channels are skipped until their channel's interval has passed.
+    /// Since rate-limited channels are conflated, at most one message per channel is skipped.
+    fn pop(&mut self, now: Instant) -> Next {
+        let mut deadline: Option<Instant> = None;
+        let mut ready = None;
+        for (&seq, queued) in &self.messages {
+            match self.next_send(queued.channel_id) {
+                Some(next_send) if next_send > now => {
+                    deadline = Some(deadline.map_or(next_send, |d| d.min(next_send)));
+                }
+                _ => {
+                    ready = Some(seq);
+                    break;
+                }
+            }
+        }
+        let Some(queued) = ready.and_then(|seq| self.remove(seq)) else {
+            return deadline.map_or(Next::Empty, Next::Wait);
+        };
+        if self.min_interval.is_some()
+            && let Some(channel_id) = queued.channel_id
+        {
+            self.sent.insert(channel_id, now);
+        }
+        self.sent_count += 1;
+        self.sent_bytes += queued.size as u64;
+        if let Some(stats) = queued.channel_id.and_then(|id| self.stats.get_mut(&id)) {
+            stats.sent += 1;
+        }
+        Next::Message(queued.channel_id, queued.message, queued.trace)
+    }
+
+    fn remove_channels(&mut self, channel_ids: &[ChannelId]) {
+        for channel_id in channel_ids {
+            self.sent.remove(channel_id);
+            self.stats.remove(channel_id);
+        }
+    }
+
+    fn stats(&self, client_id: ClientId) -> ClientStats {
+        let mut channels: Vec<_> = self
+            .stats
+            .values()
+            .map(|stats| {
+                let queue = self.channels.get(&Some(stats.channel_id));
+                ChannelStats {
+                    queued_messages: queue.map_or(0, |queue| queue.seqs.len()),
+                    queued_bytes: queue.map_or(0, |queue| queue.bytes),
+                    ..*stats
+                }
+            })
+            .collect();
+        channels.sort_by_key(|stats| u64::from(stats.channel_id));
+        ClientStats {
+            client_id,
+            sent: self.sent_count,
+            sent_bytes: self.sent_bytes,
+            dropped: self.dropped,
+            queued_messages: self.messages.len(),
+            queued_bytes: self.bytes,
+            max_queued_messages: self.max_messages,
+            max_queued_bytes: self.max_bytes,
+            channels,
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use assert_matches::assert_matches;
+
+    use super::*;
+    use crate::memory_budget::{MemoryAccounting, MemoryBudget, MemoryPool};
+
+    fn new_queue(limits: BacklogLimits) -> Queue {
+        Queue::new(limits, MemoryAccount::detached(MemoryPool::WebSocket))
+    }
+
+    fn limits(messages: usize, bytes: Option<usize>, policy: BacklogDropPolicy) -> BacklogLimits {
+        BacklogLimits {
+            messages,
+            bytes,
+            channel_bytes: None,
+            policy,
+            subscription: SubscriptionOptions::default(),
+        }
+    }
+
+    fn message(data: &str) -> Message {
+        Message::Text(data.into())
+    }
+
+    fn text(message: Message) -> String {
+        message.into_text().expect("text message").to_string()
+    }
+
+    fn drain(queue: &mut Queue) -> Vec<String> {
+        std::iter::from_fn(|| match queue.pop(Instant::now()) {
+            Next::Message(_, message, _) => Some(text(message)),
+            Next::Wait(_) | Next::Empty => None,
+        })
+        .collect()
+    }
+
+    #[test]
+    fn test_drop_oldest_by_count() {
+        let mut queue = new_queue(limits(3, None, BacklogDropPolicy::DropOldest));
+        for i in 0..5 {
+            queue.push(Some(ChannelId::new(1)), message(&i.to_string()), None);
+        }
+        assert_eq!(drain(&mut queue), ["2", "3", "4"]);
+        assert!(queue.channels.is_empty());
+        assert_eq!(queue.bytes, 0);
+    }
+
+    #[test]
+    fn test_drop_oldest_by_bytes() {
+        let mut queue = new_queue(limits(100, Some(10), BacklogDropPolicy::DropOldest));
+        assert_eq!(queue.push(None, message("aaaa"), None), 0);
+        assert_eq!(queue.push(None, message("bbbb"), None), 0);
+        assert_eq!(queue.push(None, message("cccc"), None), 1);
+        assert_eq!(queue.bytes, 8);
+        // A message larger than the budget replaces everything before it.
+        assert_eq!(queue.push(None, message("dddddddddddd"), None), 2);
+        assert_eq!(drain(&mut queue), ["dddddddddddd"]);
+    }
+
+    /// Logs a low-rate channel interleaved with a high-bandwidth channel.
+    fn push_interleaved(queue: &mut Queue) {
+        let log = Some(ChannelId::new(1));
+        let image = Some(ChannelId::new(2));
+        queue.push(log, message("log0"), None);
+        for i in 0..5 {
+            queue.push(image, message(&format!("image{i}{}", "-".repeat(14))), None);
+            queue.push(log, message(&format!("log{}", i + 1)), None);
+        }
+    }
+
+    #[test]
+    fn test_keep_latest_per_channel() {
+        let mut queue = new_queue(limits(
+            100,
+            Some(60),
+            BacklogDropPolicy::KeepLatestPerChannel,
+        ));
+        push_interleaved(&mut queue);
+        // Stale images are dropped to make room, but every log message and the latest image are
+        // kept.
+        assert_eq!(
+            drain(&mut queue),
+            [
+                "log0",
+                "log1",
+                "log2",
+                "log3",
+                "log4",
+                "image4--------------",
+                "log5"
+            ]
+        );
+
+        let mut queue = new_queue(limits(100, Some(60), BacklogDropPolicy::DropOldest));
+        push_interleaved(&mut queue);
+        assert_eq!(
+            drain(&mut queue),
+            [
+                "log3",
+                "image3--------------",
+                "log4",
+                "image4--------------",
+                "log5"
+            ]
+        );
+    }
+
+    #[test]
+    fn test_channel_byte_limit() {
+        let mut queue = new_queue(BacklogLimits {
+            channel_bytes: Some(8),
+            ..limits(100, None, BacklogDropPolicy::DropOldest)
+        });
+        let a = Some(ChannelId::new(1));
+        let b = Some(ChannelId::new(2));
+        queue.push(a, message("a000"), None);
+        queue.push(b, message("b000"), None);
+        queue.push(a, message("a001"), None);
+        assert_eq!(queue.push(a, message("a002"), None), 1);
+        assert_eq!(queue.push(b, message("b001"), None), 0);
+        assert_eq!(drain(&mut queue), ["b000", "a001", "a002", "b001"]);
+    }
+
+    #[test]
+    fn test_conflate() {
+        let mut queue = new_queue(BacklogLimits {
+            subscription: SubscriptionOptions {
+                max_rate: None,
+                conflate: true,
+            },
+            ..limits(100, None, BacklogDropPolicy::DropOldest)
+        });
+        let a = Some(ChannelId::new(1));
+        let b = Some(ChannelId::new(2));
+        queue.push(a, message("a0"), None);
+        queue.push(b, message("b0"), None);
+        queue.push(None, message("status0"), None);
+        assert_eq!(queue.push(a, message("a1-longer"), None), 0);
+        queue.push(None, message("status1"), None);
+        assert_eq!(queue.bytes, 25);
+        // The latest message of each channel is sent in place of the first, while messages with no
+        // channel are never conflated.
+        assert_eq!(drain(&mut queue), ["a1-longer", "b0", "status0", "status1"]);
+        assert_eq!(queue.bytes, 0);
+    }
+
+    #[test]
+    fn test_stats() {
+        let mut queue = new_queue(limits(3, None, BacklogDropPolicy::DropOldest));
+        let a = ChannelId::new(1);
+        let b = ChannelId::new(2);
+        for i in 0..5 {
+            queue.push(Some(a), message(&i.to_string()), None);
+        }
+        queue.push(Some(b), message("b0"), None);
+        assert_matches!(queue.pop(Instant::now()), Next::Message(Some(id), _, _) if id == a);
+
+        let stats = queue.stats(ClientId(7));
+        assert_eq!(stats.client_id, ClientId(7));
+        assert_eq!(stats.sent, 1);
+        assert_eq!(stats.dropped, 3);
+        assert_eq!(stats.queued_messages, 2);
+        assert_eq!(stats.queued_bytes, 3);
+        assert_eq!(stats.max_queued_messages, 3);
+        assert_eq!(stats.max_queued_bytes, 4);
+        assert_eq!(stats.channels.len(), 2);
+        let a_stats = stats.channels[0];
+        assert_eq!(a_stats.channel_id, a);
+        assert_eq!(a_stats.sequence, 5);
+        assert_eq!(a_stats.sent, 1);
+        assert_eq!(a_stats.dropped, 3);
+        assert_eq!(a_stats.queued_messages, 1);
+        assert_eq!(a_stats.max_queued_messages, 3);
+        assert_eq!(a_stats.max_queued_bytes, 3);
+        let b_stats = stats.channels[1];
+        assert_eq!(b_stats.channel_id, b);
+        assert_eq!(b_stats.sequence, 1);
+        assert_eq!(b_stats.dropped, 0);
+        assert_eq!(b_stats.queued_bytes, 2);
+
+        queue.remove_channels(&[a]);
+        let channels = queue.stats(ClientId(7)).channels;
+        assert_eq!(channels.len(), 1);
+        assert_eq!(channels[0].channel_id, b);
+    }
+
+    #[test]
+    fn test_conflated_stats() {
+        let mut queue = new_queue(BacklogLimits {
+            subscription: SubscriptionOptions {
+                max_rate: None,
+                conflate: true,
+            },
+            ..limits(100, None, BacklogDropPolicy::DropOldest)
+        });
+        let a = ChannelId::new(1);
+        for i in 0..3 {
+            assert_eq!(queue.push(Some(a), message(&i.to_string()), None), 0);
+        }
+        assert_eq!(drain(&mut queue), ["2"]);
+        let stats = queue.stats(ClientId(1));
+        assert_eq!(stats.dropped, 0);
+        let a_stats = stats.channels[0];
+        assert_eq!(a_stats.sequence, 3);
+        assert_eq!(a_stats.conflated, 2);
+        assert_eq!(a_stats.sent, 1);
+        assert_eq!(a_stats.queued_messages, 0);
+    }
+
+    #[test]
+    fn test_max_rate() {
+        let mut queue = new_queue(BacklogLimits {
+            subscription: SubscriptionOptions {
+                max_rate: Some(10.0),
+                conflate: false,
+            },
+            ..limits(100, None, BacklogDropPolicy::DropOldest)
+        });
+        let a = Some(ChannelId::new(1));
+        let start = Instant::now();
+        queue.push(a, message("a0"), None);
+        assert_matches!(queue.pop(start), Next::Message(_, m, _) if m.to_text().ok() == Some("a0"));
+
+        queue.push(a, message("a1"), None);
+        queue.push(a, message("a2"), None);
+        queue.push(None, message("status"), None);
+        let now = start + Duration::from_millis(10);
+        assert_matches!(queue.pop(now), Next::Message(_, m, _) if m.to_text().ok() == Some("status"));
+        let deadline = start + Duration::from_millis(100);
+        assert_matches!(queue.pop(now), Next::Wait(d) if d == deadline);
+        assert_matches!(queue.pop(deadline), Next::Message(_, m, _) if m.to_text().ok() == Some("a2"));
+        assert_matches!(queue.pop(deadline), Next::Empty);
+
+        // A channel is not rate limited after it is removed.
+        queue.push(a, message("a3"), None);
+        queue.remove_channels(&[ChannelId::new(1)]);
+        assert_matches!(queue.pop(deadline), Next::Message(_, m, _) if m.to_text().ok() == Some("a3"));
+    }
+
+    #[test]
+    fn test_drop_for_memory_budget() {
+        let accounting = std::sync::Arc::new(MemoryAccounting::default());
+        accounting.set_budget(Some(MemoryBudget::new(4)));
+        let memory = MemoryAccount::new(accounting.clone(), MemoryPool::WebSocket);
+        let mut queue = Queue::new(limits(100, None, BacklogDropPolicy::DropOldest), memory);
+        for data in ["aa", "bb", "cc"] {
+            queue.push(Some(ChannelId::new(1)), message(data), None);
+        }
+        assert_eq!(accounting.usage().bytes, 4);
+        assert_eq!(accounting.usage().pools[0].dropped, 1);
+
+        // A message larger than the budget is still queued on its own.
+        queue.push(Some(ChannelId::new(1)), message("dddddd"), None);
+        assert_eq!(accounting.usage().bytes, 6);
+        assert_eq!(drain(&mut queue), ["dddddd"]);
+        assert_eq!(accounting.usage().bytes, 0);
+        assert_eq!(accounting.usage().peak_bytes, 10);
+    }
+
+    #[tokio::test]
+    async fn test_pop_waits_for_rate_limit() {
+        let addr = SocketAddr::new("127.0.0.1".parse().expect("valid address"), 1234);
+        let data_plane = DataPlane::new(
+            addr,
+            BacklogLimits {
+                subscription: SubscriptionOptions {
+                    max_rate: Some(20.0),
+                    conflate: false,
+                },
+                ..limits(4, None, BacklogDropPolicy::DropOldest)
+            },
+            MemoryAccount::detached(MemoryPool::WebSocket),
+        );
+        let a = Some(ChannelId::new(1));
+        let start = Instant::now();
+        data_plane.push(a, message("a0"), None);
+        assert_eq!(text(data_plane.pop().await.1), "a0");
+        data_plane.push(a, message("a1"), None);
+        assert_eq!(text(data_plane.pop().await.1), "a1");
+        assert!(start.elapsed() >= Duration::from_millis(50));
+    }
+
+    #[tokio::test]
+    async fn test_pop_waits_for_push() {
+        let addr = SocketAddr::new("127.0.0.1".parse().expect("valid address"), 1234);
+        let data_plane = std::sync::Arc::new(DataPlane::new(
+            addr,
+            limits(4, None, BacklogDropPolicy::DropOldest),
+            MemoryAccount::detached(MemoryPool::WebSocket),
+        ));
+        let pop = tokio::spawn({
+            let data_plane = data_plane.clone();
+            async move { data_plane.pop().await }
+        });
+        tokio::task::yield_now().await;
+        data_plane.push(None, message("hello"), None);
+        let (channel_id, message, _) = pop.await.expect("pop task panicked");
+        assert_eq!(channel_id, None);
+        assert_eq!(text(message), "hello");
+    }
+}
@@ -0,0 +1,97 @@
+//! Rate limiting for broadcasts of which only the latest value matters.
+
+use std::time::Duration;
+
+use tokio::time::Instant;
+
+/// What to do with a value offered to a [`BroadcastLimiter`].
+#[derive(Debug, PartialEq, Eq)]
+pub(crate) enum Offer<T> {
+    /// Send the value now.
+    Send(T),
+    /// The value is pending. Call [`BroadcastLimiter::take`] at the given deadline, and send the
+    /// value it returns.
+    Schedule(Instant),
+    /// The value replaced a pending value, which is already scheduled.
+    Pending,
+}
+
+/// Limits a broadcast to one value per interval, always delivering the latest value.
+///
+/// The first value after a quiet interval is sent immediately. Values offered within the interval
+/// replace one another, and the latest is sent at the end of the interval.
+#[derive(Debug)]
+pub(crate) struct BroadcastLimiter<T> {
+    interval: Duration,
+    last_sent: Option<Instant>,
+    pending: Option<T>,
+    scheduled: bool,
+}
+
+impl<T> BroadcastLimiter<T> {
+    pub fn new(interval: Duration) -> Self {
+        Self {
+            interval,
+            last_sent: None,
+            pending: None,
+            scheduled: false,
+        }
+    }
+
+    /// Offers the latest value.
+    pub fn offer(&mut self, value: T, now: Instant) -> Offer<T> {
+        if self.scheduled {
+            self.pending = Some(value);
+            return Offer::Pending;
+        }
+        match self.last_sent {
+            Some(last_sent) if now < last_sent + self.interval => {
+                self.pending = Some(value);
+                self.scheduled = true;
+                Offer::Schedule(last_sent + self.interval)
+            }
+            _ => {
+                self.last_sent = Some(now);
+                Offer::Send(value)
+            }
+        }
+    }
+
+    /// Takes the pending value when its deadline is reached.
+    pub fn take(&mut self, now: Instant) -> Option<T> {
+        self.scheduled = false;
+        let value = self.pending.take()?;
+        self.last_sent = Some(now);
+        Some(value)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_sends_latest_value_once_per_interval() {
+        let interval = Duration::from_millis(10);
+        let start = Instant::now();
+        let mut limiter = BroadcastLimiter::new(interval);
+
+        assert_eq!(limiter.offer(1, start), Offer::Send(1));
+        let deadline = start + interval;
+        assert_eq!(limiter.offer(2, start), Offer::Schedule(deadline));
+        assert_eq!(limiter.offer(3, start), Offer::Pending);
+        assert_eq!(limiter.take(deadline), Some(3));
+
+        // The next value is held until an interval after the scheduled send.
+        assert_eq!(
+            limiter.offer(4, deadline + Duration::from_millis(1)),
+            Offer::Schedule(deadline + interval)
+        );
+        assert_eq!(limiter.take(deadline + interval), Some(4));
+        assert_eq!(limiter.take(deadline + interval), None);
+
+        // After a quiet interval, values are sent immediately.
+        let later = deadline + 2 * interval;
+        assert_eq!(limiter.offer(5, later), Offer::Send(5));
+    }
+}
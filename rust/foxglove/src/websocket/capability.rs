@@ -24,6 +24,18 @@ pub enum Capability {
     /// controls in the Foxglove app. This requires the server to specify the `data_start_time`
     /// and `data_end_time` fields in its `ServerInfo` message.
     PlaybackControl,
+    /// Allow clients to receive several messages in each binary frame.
+    ///
+    /// Clients which enable message batches receive the messages queued for them, up to the batch
+    /// limits, in a single frame. This reduces per-frame overhead for clients subscribed to many
+    /// high-rate channels of small messages. Other clients receive one message per frame.
+    MessageBatches,
+    /// Allow clients to subscribe to a subset of the fields of a channel's messages.
+    ///
+    /// Each message is projected once for every distinct set of fields requested on its channel,
+    /// and the projection is shared by the clients which requested it. Projection is supported
+    /// for channels with `json` messages, and `protobuf` messages with a protobuf schema.
+    FieldProjection,
 }
 
 impl Capability {
@@ -39,6 +51,8 @@ impl Capability {
             Self::Assets => &[server_info::Capability::Assets],
             Self::ConnectionGraph => &[server_info::Capability::ConnectionGraph],
             Self::PlaybackControl => &[server_info::Capability::PlaybackControl],
+            Self::MessageBatches => &[server_info::Capability::MessageBatches],
+            Self::FieldProjection => &[server_info::Capability::FieldProjection],
         }
     }
 }
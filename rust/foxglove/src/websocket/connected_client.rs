@@ -1,31 +1,47 @@
+use std::borrow::Cow;
 use std::collections::HashSet;
 use std::collections::hash_map::Entry;
 use std::sync::Weak;
+use std::sync::atomic::{AtomicBool, Ordering};
 use std::{collections::HashMap, net::SocketAddr, sync::Arc};
 
+use arc_swap::ArcSwap;
 use bimap::BiHashMap;
+use bytes::Bytes;
 use flume::TrySendError;
-use send_lossy::SendLossyResult;
 use tokio::net::TcpStream;
 use tokio::sync::oneshot;
 use tokio_tungstenite::WebSocketStream;
 use tokio_tungstenite::tungstenite::Message;
 
+use crate::latency::{self, Trace};
+use crate::log_sink_set::shared_encoding;
+use crate::memory_budget::MemoryAccount;
 use crate::sink_channel_filter::SinkChannelFilter;
+use crate::throttler::Throttler;
 use crate::websocket::PlaybackControlRequest;
 use crate::websocket::streams::ServerStream;
-use crate::{ChannelId, Context, FoxgloveError, Metadata, RawChannel, Sink, SinkId};
+use crate::{
+    ChannelDemand, ChannelId, Context, FoxgloveError, MemoryPool, MessageFilter, Metadata,
+    RawChannel, Sink, SinkId, SinkStats,
+};
 
 use self::ws_protocol::server::{
     FetchAssetResponse, ParameterValues, ServiceCallFailure, Unadvertise,
 };
 
+use super::backlog::{BacklogLimits, BatchLimits, DataPlane};
+use super::deflate::{DeflateParams, DeflateStream, Deflater};
+use super::projection::Projection;
 use super::server::Server;
 use super::service::{self, CallId, ServiceId};
+use super::stats::{BACKPRESSURE_INTERVAL, ClientStats};
 use super::subscription::{Subscription, SubscriptionId};
+#[cfg(feature = "websocket-video")]
+use super::video::VideoChannel;
 use super::ws_protocol::client::ClientMessage;
 use super::ws_protocol::server::MessageData;
-use super::ws_protocol::{self, ParseError};
+use super::ws_protocol::{self, BinaryMessage, ParseError};
 use super::{
     AnyClient, AssetResponder, Capability, Client, ClientChannel, ClientChannelId, ClientId,
     GetParametersResponder, Parameter, SetParametersResponder, Status, StatusLevel, advertise,
@@ -33,16 +49,62 @@ use super::{
 use crate::remote_common::semaphore::Semaphore;
 
 mod poller;
-mod send_lossy;
 
 use poller::Poller;
 
-const MAX_SEND_RETRIES: usize = 10;
 const ADVERTISE_CHANNEL_BATCH_SIZE: usize = 100;
 const DEFAULT_SERVICE_CALLS_PER_CLIENT: usize = 32;
 const DEFAULT_FETCH_ASSET_CALLS_PER_CLIENT: usize = 32;
 const DEFAULT_PARAMETER_CALLS_PER_CLIENT: usize = 32;
 
+/// A subscription, as read by the logging path.
+struct LoggedSubscription {
+    id: SubscriptionId,
+    /// The projection of the channel's messages sent to the subscription, if it requested one.
+    projection: Option<Arc<Projection>>,
+}
+
+/// Returns a `MessageData` frame for a message logged to a subscription.
+///
+/// Every client subscribed to a channel receives the same message, so the frame is serialized
+/// once per subscription id and shared between the queues of the clients which use that id.
+/// Likewise, a projected message is projected once and shared between the clients which use the
+/// projection. A message which can't be projected is sent whole.
+fn message_data(subscription: &LoggedSubscription, log_time: u64, msg: &[u8]) -> Message {
+    let projected;
+    let msg = match &subscription.projection {
+        Some(projection) => {
+            projected = shared_encoding(
+                "websocket-projection",
+                projection.id(),
+                msg,
+                log_time,
+                || {
+                    projection.project(msg).unwrap_or_else(|err| {
+                        tracing::debug!("Failed to project message: {err}");
+                        Bytes::copy_from_slice(msg)
+                    })
+                },
+            );
+            &projected[..]
+        }
+        None => msg,
+    };
+    let subscription_id = u32::from(subscription.id);
+    let frame = shared_encoding(
+        "websocket-message-data",
+        subscription_id.into(),
+        msg,
+        log_time,
+        || {
+            MessageData::new(subscription_id, log_time, msg)
+                .to_bytes()
+                .into()
+        },
+    );
+    Message::Binary(frame)
+}
+
 /// A reason for shutting down a client connection.
 #[derive(Debug, Clone, Copy)]
 pub(super) enum ShutdownReason {
@@ -61,12 +123,23 @@ pub(super) struct ConnectedClient {
     weak_self: Weak<Self>,
     sink_id: SinkId,
     channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+    message_filter: Option<Arc<dyn MessageFilter>>,
     context: Weak<Context>,
     poller: parking_lot::Mutex<Option<Poller>>,
     /// A cache of channels for `on_subscribe` and `on_unsubscribe` callbacks.
     channels: parking_lot::RwLock<HashMap<ChannelId, Arc<RawChannel>>>,
-    data_plane_tx: flume::Sender<Message>,
-    data_plane_rx: flume::Receiver<Message>,
+    data_plane: DataPlane,
+    /// The maximum rate at which messages are sent for each subscription, if limited.
+    max_rate: Option<f64>,
+    /// Throttles calls to the listener's `on_backpressure` callback.
+    backpressure: parking_lot::Mutex<Throttler>,
+    /// Whether the client negotiated permessage-deflate.
+    compression: bool,
+    /// Subscribed channels whose messages are sent uncompressed, when compression is negotiated.
+    uncompressed_channels: parking_lot::Mutex<HashSet<ChannelId>>,
+    /// Whether the client enabled message batches.
+    message_batches: AtomicBool,
+    batch_limits: BatchLimits,
     control_plane_tx: flume::Sender<Message>,
     service_call_sem: Semaphore,
     fetch_asset_sem: Semaphore,
@@ -75,10 +148,24 @@ pub(super) struct ConnectedClient {
     parameter_sem: Semaphore,
     /// Subscriptions from this client
     subscriptions: parking_lot::Mutex<BiHashMap<ChannelId, SubscriptionId>>,
+    /// Projections requested by subscriptions from this client. Locked after `subscriptions`.
+    projections: parking_lot::Mutex<HashMap<ChannelId, Arc<Projection>>>,
+    /// A snapshot of `subscriptions` and `projections`, which is read without locking when
+    /// logging messages.
+    ///
+    /// The snapshot is replaced while holding the `subscriptions` lock, whenever the client
+    /// subscribes or unsubscribes.
+    logged_subscriptions: ArcSwap<HashMap<ChannelId, LoggedSubscription>>,
+    /// Video channels derived from the image channels advertised to this client, by the ID of the
+    /// derived channel.
+    #[cfg(feature = "websocket-video")]
+    video_channels: parking_lot::Mutex<HashMap<ChannelId, Arc<VideoChannel>>>,
     /// Channels advertised by this client
     advertised_channels: parking_lot::Mutex<HashMap<ClientChannelId, Arc<ClientChannel>>>,
     server: Weak<Server>,
     shutdown_tx: parking_lot::Mutex<Option<oneshot::Sender<ShutdownReason>>>,
+    /// Set once the server has dropped the connection.
+    disconnected: AtomicBool,
 }
 
 impl std::fmt::Debug for ConnectedClient {
@@ -101,16 +188,44 @@ impl Sink for ConnectedClient {
         msg: &[u8],
         metadata: &Metadata,
     ) -> Result<(), FoxgloveError> {
-        let subscriptions = self.subscriptions.lock();
-        let Some(subscription_id) = subscriptions.get_by_left(&channel.id()).copied() else {
+        let subscriptions = self.logged_subscriptions.load();
+        let Some(subscription) = subscriptions.get(&channel.id()) else {
             return Ok(());
         };
 
-        let message = MessageData::new(subscription_id.into(), metadata.log_time, msg);
-        self.send_data_lossy(&message, MAX_SEND_RETRIES);
+        let message = message_data(subscription, metadata.log_time, msg);
+        self.send_data(Some(channel.id()), message, latency::enqueue());
         Ok(())
     }
 
+    fn log_batch(
+        &self,
+        channel: &RawChannel,
+        msgs: &[(&[u8], Metadata)],
+    ) -> Result<(), FoxgloveError> {
+        let subscriptions = self.logged_subscriptions.load();
+        let Some(subscription) = subscriptions.get(&channel.id()) else {
+            return Ok(());
+        };
+
+        for (msg, metadata) in msgs {
+            self.send_data(
+                Some(channel.id()),
+                message_data(subscription, metadata.log_time, msg),
+                None,
+            );
+        }
+        Ok(())
+    }
+
+    fn message_filter(&self) -> Option<&Arc<dyn MessageFilter>> {
+        self.message_filter.as_ref()
+    }
+
+    fn demand(&self, _channel: &RawChannel) -> ChannelDemand {
+        ChannelDemand::new(1, self.max_rate)
+    }
+
     fn add_channels(&self, channels: &[&Arc<RawChannel>]) -> Option<Vec<ChannelId>> {
         let filtered_channels = channels
             .iter()
@@ -123,6 +238,15 @@ impl Sink for ConnectedClient {
             .copied()
             .collect::<Vec<_>>();
 
+        // Derived video channels are advertised alongside their image channels.
+        #[cfg(feature = "websocket-video")]
+        let video_channels = self.add_video_channels(&filtered_channels);
+        #[cfg(feature = "websocket-video")]
+        let filtered_channels = filtered_channels
+            .into_iter()
+            .chain(video_channels.iter().map(|video| video.channel()))
+            .collect::<Vec<_>>();
+
         for channels in filtered_channels.chunks(ADVERTISE_CHANNEL_BATCH_SIZE) {
             self.advertise_channels(channels);
         }
@@ -131,39 +255,52 @@ impl Sink for ConnectedClient {
     }
 
     fn remove_channel(&self, channel: &RawChannel) {
-        let had_subscription = self
-            .subscriptions
-            .lock()
-            .remove_by_left(&channel.id())
-            .is_some();
-        self.unadvertise_channel(channel.id());
-        // Fire on_unsubscribe after the channel has been unadvertised.
-        if had_subscription {
-            let server = self.server.upgrade();
-            if let Some(handler) = server.as_ref().and_then(|s| s.listener()) {
-                handler.on_unsubscribe(Client::new(self), channel.into());
+        #[cfg(feature = "websocket-video")]
+        for video in self.remove_video_channels(channel.id()) {
+            if self.remove_advertised_channel(video.channel()) {
+                video.unsubscribe(self.weak());
             }
         }
+        self.remove_advertised_channel(channel);
     }
 
     fn auto_subscribe(&self) -> bool {
         // Clients maintain subscriptions dynamically.
         false
     }
+
+    fn sink_stats(&self) -> Option<SinkStats> {
+        let stats = self.stats();
+        Some(SinkStats {
+            kind: "websocket_client",
+            queued_messages: stats.queued_messages,
+            queued_bytes: stats.queued_bytes,
+            sent_messages: stats.sent,
+            sent_bytes: stats.sent_bytes,
+            dropped_messages: stats.dropped,
+            ..SinkStats::default()
+        })
+    }
 }
 
 impl ConnectedClient {
     pub fn new(
         context: &Weak<Context>,
         server: &Weak<Server>,
-        websocket: WebSocketStream<ServerStream<TcpStream>>,
+        websocket: WebSocketStream<DeflateStream<ServerStream<TcpStream>>>,
         addr: SocketAddr,
-        message_backlog_size: usize,
+        backlog: BacklogLimits,
+        batch_limits: BatchLimits,
+        deflate: Option<DeflateParams>,
         channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+        message_filter: Option<Arc<dyn MessageFilter>>,
     ) -> Arc<Self> {
-        let (data_plane_tx, data_plane_rx) = flume::bounded(message_backlog_size);
-        let (control_plane_tx, control_plane_rx) = flume::bounded(message_backlog_size);
+        let (control_plane_tx, control_plane_rx) = flume::bounded(backlog.messages);
         let (shutdown_tx, shutdown_rx) = oneshot::channel();
+        let memory = context.upgrade().map_or_else(
+            || MemoryAccount::detached(MemoryPool::WebSocket),
+            |context| context.memory_account(MemoryPool::WebSocket),
+        );
         Arc::new_cyclic(|weak_self| Self {
             id: ClientId::next(),
             addr,
@@ -171,23 +308,34 @@ impl ConnectedClient {
             sink_id: SinkId::next(),
             context: context.clone(),
             channel_filter,
+            message_filter,
             poller: parking_lot::Mutex::new(Some(Poller::new(
                 websocket,
-                data_plane_rx.clone(),
                 control_plane_rx,
                 shutdown_rx,
+                deflate.map(Deflater::new),
             ))),
             channels: parking_lot::RwLock::default(),
-            data_plane_tx,
-            data_plane_rx,
+            data_plane: DataPlane::new(addr, backlog, memory),
+            max_rate: backlog.subscription.max_rate,
+            backpressure: parking_lot::Mutex::new(Throttler::new(BACKPRESSURE_INTERVAL)),
+            compression: deflate.is_some(),
+            uncompressed_channels: parking_lot::Mutex::default(),
+            message_batches: AtomicBool::new(false),
+            batch_limits,
             control_plane_tx,
             service_call_sem: Semaphore::new(DEFAULT_SERVICE_CALLS_PER_CLIENT),
             fetch_asset_sem: Semaphore::new(DEFAULT_FETCH_ASSET_CALLS_PER_CLIENT),
             parameter_sem: Semaphore::new(DEFAULT_PARAMETER_CALLS_PER_CLIENT),
             subscriptions: parking_lot::Mutex::default(),
+            projections: parking_lot::Mutex::default(),
+            logged_subscriptions: ArcSwap::default(),
+            #[cfg(feature = "websocket-video")]
+            video_channels: parking_lot::Mutex::default(),
             advertised_channels: parking_lot::Mutex::default(),
             server: server.clone(),
             shutdown_tx: parking_lot::Mutex::new(Some(shutdown_tx)),
+            disconnected: AtomicBool::new(false),
         })
     }
 
@@ -258,11 +406,18 @@ impl ConnectedClient {
         };
 
         match msg {
-            ClientMessage::Subscribe(msg) => self.on_subscribe(server, msg),
+            ClientMessage::Subscribe(msg) => {
+                let subscriptions = msg.subscriptions.into_iter().map(Subscription::from);
+                self.on_subscribe(server, subscriptions.collect());
+            }
+            ClientMessage::SubscribeFields(msg) => {
+                let subscriptions = msg.subscriptions.into_iter().map(Subscription::from);
+                self.on_subscribe(server, subscriptions.collect());
+            }
             ClientMessage::Unsubscribe(msg) => self.on_unsubscribe(msg),
             ClientMessage::Advertise(msg) => self.on_advertise(server, msg),
             ClientMessage::Unadvertise(msg) => self.on_unadvertise(server, msg),
-            ClientMessage::MessageData(msg) => self.on_message_data(server, msg),
+            ClientMessage::MessageData(msg) => self.on_message_data(server, &message, msg),
             ClientMessage::GetParameters(msg) => {
                 self.on_get_parameters(server, msg.parameter_names, msg.id)
             }
@@ -284,18 +439,52 @@ impl ConnectedClient {
             ClientMessage::PlaybackControlRequest(msg) => {
                 self.on_playback_control_request(server, msg)
             }
+            ClientMessage::EnableMessageBatches => self.on_enable_message_batches(server),
+        }
+    }
+
+    /// Send the message on the data plane, dropping older messages to stay within the backlog
+    /// limits, if necessary.
+    ///
+    /// Messages which were not logged to a channel are passed `None` as their channel. If the
+    /// message is sampled for latency tracing, its trace is finished once it has been sent.
+    fn send_data(
+        &self,
+        channel_id: Option<ChannelId>,
+        message: impl Into<Message>,
+        trace: Option<Trace>,
+    ) {
+        if self.data_plane.push(channel_id, message.into(), trace) == 0 {
+            return;
+        }
+        let Some(server) = self.server.upgrade() else {
+            return;
+        };
+        if let Some(handler) = server.listener()
+            && self.backpressure.lock().try_acquire()
+        {
+            handler.on_backpressure(Client::new(self), &self.stats());
         }
     }
 
-    /// Send the message on the data plane, dropping up to retries older messages to make room, if necessary.
-    fn send_data_lossy(&self, message: impl Into<Message>, retries: usize) -> SendLossyResult {
-        send_lossy::send_lossy(
-            &self.addr,
-            &self.data_plane_tx,
-            &self.data_plane_rx,
-            message.into(),
-            retries,
-        )
+    /// Returns the delivery counters of the client's data plane.
+    pub fn stats(&self) -> ClientStats {
+        self.data_plane.stats(self.id)
+    }
+
+    /// Returns true if messages sent on the channel should be compressed.
+    ///
+    /// Messages which were not logged to a channel are compressed.
+    fn compresses(&self, channel_id: Option<ChannelId>) -> bool {
+        self.compression
+            && channel_id.is_none_or(|id| !self.uncompressed_channels.lock().contains(&id))
+    }
+
+    /// Returns the limits on the message batches sent to the client, if it enabled them.
+    fn batch_limits(&self) -> Option<BatchLimits> {
+        self.message_batches
+            .load(Ordering::Relaxed)
+            .then_some(self.batch_limits)
     }
 
     /// Send the message on the control plane, disconnecting the client if the channel is full.
@@ -308,8 +497,14 @@ impl ConnectedClient {
         }
     }
 
+    /// Returns true if the server has dropped the connection.
+    pub fn is_disconnected(&self) -> bool {
+        self.disconnected.load(Ordering::Acquire)
+    }
+
     /// Called when the server finally drops the connection.
     pub fn on_disconnect(&self) {
+        self.disconnected.store(true, Ordering::Release);
         let channel_ids = self.subscriptions.lock().left_values().copied().collect();
         self.unsubscribe_channel_ids(channel_ids);
 
@@ -334,9 +529,13 @@ impl ConnectedClient {
         }
     }
 
-    fn on_message_data(&self, server: Arc<Server>, message: ws_protocol::client::MessageData) {
+    fn on_message_data(
+        &self,
+        server: Arc<Server>,
+        frame: &Message,
+        message: ws_protocol::client::MessageData,
+    ) {
         let channel_id = ClientChannelId::new(message.channel_id);
-        let payload = message.data;
         let client_channel = {
             let advertised_channels = self.advertised_channels.lock();
             let Some(channel) = advertised_channels.get(&channel_id) else {
@@ -349,7 +548,12 @@ impl ConnectedClient {
         };
         // Call the handler after releasing the advertised_channels lock
         if let Some(handler) = server.listener() {
-            handler.on_message_data(Client::new(self), &client_channel, &payload);
+            // Share the received frame's buffer with the listener, rather than copying the payload.
+            let payload = match (frame, message.data) {
+                (Message::Binary(frame), Cow::Borrowed(data)) => frame.slice_ref(data),
+                (_, data) => Bytes::from(data.into_owned()),
+            };
+            handler.on_message_data_shared(Client::new(self), &client_channel, payload);
         }
     }
 
@@ -441,21 +645,19 @@ impl ConnectedClient {
             let mut subscriptions = self.subscriptions.lock();
             for subscription_id in subscription_ids {
                 if let Some((channel_id, _)) = subscriptions.remove_by_right(&subscription_id) {
+                    self.projections.lock().remove(&channel_id);
                     unsubscribed_channel_ids.push(channel_id);
                 }
             }
+            if !unsubscribed_channel_ids.is_empty() {
+                self.publish_subscriptions(&subscriptions);
+            }
         }
 
         self.unsubscribe_channel_ids(unsubscribed_channel_ids);
     }
 
-    fn on_subscribe(&self, server: Arc<Server>, message: ws_protocol::client::Subscribe) {
-        let mut subscriptions: Vec<_> = message
-            .subscriptions
-            .into_iter()
-            .map(Subscription::from)
-            .collect();
-
+    fn on_subscribe(&self, server: Arc<Server>, mut subscriptions: Vec<Subscription>) {
         // First prune out any subscriptions for channels not in the channel map,
         // limiting how long we need to hold the lock.
         let mut subscribed_channels = Vec::with_capacity(subscriptions.len());
@@ -475,16 +677,40 @@ impl ConnectedClient {
                     subscriptions.swap_remove(i);
                     continue;
                 };
-                subscribed_channels.push(channel.clone());
+                let projection = match &subscription.fields {
+                    None => None,
+                    Some(_) if !server.has_capability(Capability::FieldProjection) => {
+                        self.send_error(
+                            "Server does not support field projection capability".to_string(),
+                        );
+                        subscriptions.swap_remove(i);
+                        continue;
+                    }
+                    Some(fields) => match server.projection(channel, fields) {
+                        Ok(projection) => Some(projection),
+                        Err(err) => {
+                            self.send_error(format!(
+                                "Cannot project channel {}: {err}; ignoring subscription",
+                                subscription.channel_id
+                            ));
+                            subscriptions.swap_remove(i);
+                            continue;
+                        }
+                    },
+                };
+                subscribed_channels.push((channel.clone(), projection));
                 i += 1
             }
         }
 
-        let mut channel_ids = Vec::with_capacity(subscribed_channels.len());
-        for (subscription, channel) in subscriptions.into_iter().zip(subscribed_channels) {
-            // Using a limited scope here to avoid holding the lock on subscriptions while calling on_subscribe
-            {
-                let mut subscriptions = self.subscriptions.lock();
+        // Record all of the subscriptions and publish a single snapshot for the logging path,
+        // before subscribing the client to the channels in the context. Using a limited scope
+        // here to avoid holding the lock on subscriptions while calling on_subscribe.
+        let mut accepted = Vec::with_capacity(subscribed_channels.len());
+        let requested = subscriptions.into_iter().zip(subscribed_channels);
+        {
+            let mut subscriptions = self.subscriptions.lock();
+            for (subscription, (channel, projection)) in requested {
                 if subscriptions
                     .insert_no_overwrite(subscription.channel_id, subscription.id)
                     .is_err()
@@ -503,8 +729,20 @@ impl ConnectedClient {
                     }
                     continue;
                 }
+                if let Some(projection) = projection {
+                    self.projections
+                        .lock()
+                        .insert(subscription.channel_id, projection);
+                }
+                accepted.push((subscription, channel));
             }
+            if !accepted.is_empty() {
+                self.publish_subscriptions(&subscriptions);
+            }
+        }
 
+        let mut channel_ids = Vec::with_capacity(accepted.len());
+        for (subscription, channel) in accepted {
             tracing::debug!(
                 "Client {} subscribed to channel {} with subscription id {}",
                 self.addr,
@@ -512,8 +750,19 @@ impl ConnectedClient {
                 subscription.id
             );
             channel_ids.push(channel.id());
+            if self.compression && !server.compresses_channel(channel.descriptor()) {
+                self.uncompressed_channels.lock().insert(channel.id());
+            }
 
-            // Propagate client subscription requests to the context.
+            // Propagate client subscription requests to the context. Derived video channels
+            // aren't in the context, and subscribe to their image channels instead.
+            #[cfg(feature = "websocket-video")]
+            if let Some(video) = self.video_channel(channel.id()) {
+                video.subscribe(self.weak());
+            } else if let Some(context) = self.context.upgrade() {
+                context.subscribe_channels(self.sink_id, &[channel.id()]);
+            }
+            #[cfg(not(feature = "websocket-video"))]
             if let Some(context) = self.context.upgrade() {
                 context.subscribe_channels(self.sink_id, &[channel.id()]);
             }
@@ -694,17 +943,26 @@ impl ConnectedClient {
             return;
         }
 
+        let cache = server.asset_cache();
+        if let Some(asset) = cache.and_then(|cache| cache.get(&uri)) {
+            self.send_asset_response(&asset, request_id);
+            return;
+        }
+
         let Some(guard) = self.fetch_asset_sem.try_acquire() else {
             self.send_asset_error("Too many concurrent fetch asset requests", request_id);
             return;
         };
 
         if let Some(handler) = server.fetch_asset_handler() {
-            let asset_responder = AssetResponder::new(
+            let mut asset_responder = AssetResponder::new(
                 AnyClient::from_websocket(Client::new(self)),
                 request_id,
                 guard,
             );
+            if let Some(cache) = cache {
+                asset_responder = asset_responder.with_cache(cache.clone(), uri.clone());
+            }
             handler.fetch(uri, asset_responder);
         } else {
             tracing::error!("Server advertised the Assets capability without providing a handler");
@@ -742,6 +1000,14 @@ impl ConnectedClient {
         }
     }
 
+    fn on_enable_message_batches(&self, server: Arc<Server>) {
+        if !server.has_capability(Capability::MessageBatches) {
+            self.send_error("Server does not support message batches capability".to_string());
+            return;
+        }
+        self.message_batches.store(true, Ordering::Relaxed);
+    }
+
     fn on_playback_control_request(&self, server: Arc<Server>, msg: PlaybackControlRequest) {
         if !server.has_capability(Capability::PlaybackControl) {
             self.send_error("Server does not support playback control capability".to_string());
@@ -792,7 +1058,7 @@ impl ConnectedClient {
     pub fn send_status(&self, status: Status) {
         match status.level {
             StatusLevel::Info => {
-                self.send_data_lossy(&status, MAX_SEND_RETRIES);
+                self.send_data(None, &status, None);
             }
             _ => {
                 self.send_control_msg(&status);
@@ -810,6 +1076,86 @@ impl ConnectedClient {
         self.send_control_msg(&FetchAssetResponse::asset_data(request_id, response));
     }
 
+    /// Unsubscribes from and unadvertises a channel which has been removed.
+    ///
+    /// Returns true if the client was subscribed to the channel.
+    fn remove_advertised_channel(&self, channel: &RawChannel) -> bool {
+        let had_subscription = {
+            let mut subscriptions = self.subscriptions.lock();
+            let removed = subscriptions.remove_by_left(&channel.id()).is_some();
+            if removed {
+                self.projections.lock().remove(&channel.id());
+                self.publish_subscriptions(&subscriptions);
+            }
+            removed
+        };
+        if had_subscription {
+            self.data_plane.remove_channels(&[channel.id()]);
+            self.uncompressed_channels.lock().remove(&channel.id());
+        }
+        self.unadvertise_channel(channel.id());
+        // Fire on_unsubscribe after the channel has been unadvertised.
+        if had_subscription {
+            let server = self.server.upgrade();
+            if let Some(handler) = server.as_ref().and_then(|s| s.listener()) {
+                handler.on_unsubscribe(Client::new(self), channel.into());
+            }
+        }
+        had_subscription
+    }
+
+    /// Returns the video channels derived from newly added channels, and records them as
+    /// advertised to this client.
+    #[cfg(feature = "websocket-video")]
+    fn add_video_channels(&self, channels: &[&Arc<RawChannel>]) -> Vec<Arc<VideoChannel>> {
+        let Some(server) = self.server.upgrade() else {
+            return Vec::new();
+        };
+        let video_channels: Vec<_> = channels
+            .iter()
+            .filter_map(|channel| server.video_channel(channel))
+            .collect();
+        if !video_channels.is_empty() {
+            let mut client_video_channels = self.video_channels.lock();
+            for video in &video_channels {
+                client_video_channels.insert(video.channel().id(), video.clone());
+            }
+        }
+        video_channels
+    }
+
+    /// Removes and returns the video channels derived from a removed channel.
+    #[cfg(feature = "websocket-video")]
+    fn remove_video_channels(&self, source_id: ChannelId) -> Vec<Arc<VideoChannel>> {
+        let mut video_channels = self.video_channels.lock();
+        let derived_ids: Vec<_> = video_channels
+            .values()
+            .filter(|video| video.source_id() == source_id)
+            .map(|video| video.channel().id())
+            .collect();
+        derived_ids
+            .iter()
+            .filter_map(|id| video_channels.remove(id))
+            .collect()
+    }
+
+    /// Returns the derived video channel with the given ID, if any.
+    #[cfg(feature = "websocket-video")]
+    fn video_channel(&self, channel_id: ChannelId) -> Option<Arc<VideoChannel>> {
+        self.video_channels.lock().get(&channel_id).cloned()
+    }
+
+    /// Sends a frame of a derived video channel to the client, if it is subscribed to the channel.
+    #[cfg(feature = "websocket-video")]
+    pub(super) fn send_video_frame(&self, channel_id: ChannelId, log_time: u64, payload: &[u8]) {
+        let subscriptions = self.logged_subscriptions.load();
+        let Some(subscription) = subscriptions.get(&channel_id) else {
+            return;
+        };
+        let message = message_data(subscription, log_time, payload);
+        self.send_data(Some(channel_id), message, None);
+    }
+
     /// Advertises a channel to the client.
     fn advertise_channels(&self, channels: &[&Arc<RawChannel>]) {
         let message = advertise::advertise_channels(channels.iter().copied());
@@ -859,10 +1205,49 @@ impl ConnectedClient {
 
     /// Unsubscribes from a list of channel IDs.
     /// Takes a read lock on the channels map.
+    /// Replaces the snapshot of subscriptions read by the logging path.
+    ///
+    /// Must be called while holding the `subscriptions` lock, so that snapshots are published in
+    /// the same order as the changes they reflect.
+    fn publish_subscriptions(&self, subscriptions: &BiHashMap<ChannelId, SubscriptionId>) {
+        let projections = self.projections.lock();
+        let snapshot = subscriptions
+            .iter()
+            .map(|(&channel_id, &id)| {
+                let projection = projections.get(&channel_id).cloned();
+                (channel_id, LoggedSubscription { id, projection })
+            })
+            .collect();
+        self.logged_subscriptions.store(Arc::new(snapshot));
+    }
+
     fn unsubscribe_channel_ids(&self, unsubscribed_channel_ids: Vec<ChannelId>) {
-        // Propagate client unsubscriptions to the context.
+        self.data_plane.remove_channels(&unsubscribed_channel_ids);
+        if self.compression {
+            let mut uncompressed_channels = self.uncompressed_channels.lock();
+            for channel_id in &unsubscribed_channel_ids {
+                uncompressed_channels.remove(channel_id);
+            }
+        }
+
+        // Propagate client unsubscriptions to the context. Derived video channels aren't in the
+        // context, and stop transcoding with their last subscription instead.
+        #[cfg(feature = "websocket-video")]
+        let context_channel_ids = &unsubscribed_channel_ids
+            .iter()
+            .copied()
+            .filter(|&channel_id| match self.video_channel(channel_id) {
+                Some(video) => {
+                    video.unsubscribe(self.weak());
+                    false
+                }
+                None => true,
+            })
+            .collect::<Vec<_>>();
+        #[cfg(not(feature = "websocket-video"))]
+        let context_channel_ids = &unsubscribed_channel_ids;
         if let Some(context) = self.context.upgrade() {
-            context.unsubscribe_channels(self.sink_id, &unsubscribed_channel_ids);
+            context.unsubscribe_channels(self.sink_id, context_channel_ids);
         }
 
         // If we don't have a ServerListener, we're done.
@@ -1,14 +1,105 @@
+use bytes::Bytes;
 use futures_util::{SinkExt, StreamExt};
 use tokio::net::TcpStream;
 use tokio::sync::oneshot;
+use tokio::time::Instant;
 use tokio_tungstenite::WebSocketStream;
 use tokio_tungstenite::tungstenite::Message;
 
+use crate::ChannelId;
+use crate::latency::Trace;
+use crate::protocol::common::BinaryPayload;
 use crate::websocket::Status;
+use crate::websocket::deflate::{DeflateStream, Deflater};
 use crate::websocket::streams::ServerStream;
+use crate::websocket::ws_protocol::BinaryMessage;
+use crate::websocket::ws_protocol::server::{MessageBatch, MessageData};
 
 use super::{ConnectedClient, ShutdownReason};
 
+/// A message popped from one of the client's queues, with its channel and latency trace.
+type Queued = (Option<ChannelId>, Message, Option<Trace>);
+
+/// A frame ready to be sent, with the traces of the messages it carries.
+struct Outgoing {
+    /// The channel of the frame's messages, which decides whether the frame is compressed.
+    channel_id: Option<ChannelId>,
+    message: Message,
+    traces: Vec<(ChannelId, Trace)>,
+}
+
+impl Outgoing {
+    fn single((channel_id, message, trace): Queued) -> Self {
+        Self {
+            channel_id,
+            message,
+            traces: channel_id.zip(trace).into_iter().collect(),
+        }
+    }
+}
+
+/// Gathers the data messages queued after `first` into a message batch, if the client enabled
+/// message batches.
+///
+/// Messages are gathered until the batch limits are reached, or until a message which can't join
+/// the batch is popped, in which case that message is returned to be sent after the batch. All
+/// messages in a batch are compressed alike, so that the client's compression filter still
+/// applies.
+async fn gather_batch(client: &ConnectedClient, first: Queued) -> (Outgoing, Option<Queued>) {
+    let Some(limits) = client.batch_limits() else {
+        return (Outgoing::single(first), None);
+    };
+    let (Some(channel_id), Message::Binary(frame), trace) = first else {
+        return (Outgoing::single(first), None);
+    };
+    let compress = client.compresses(Some(channel_id));
+    let deadline = Instant::now() + limits.linger;
+    let mut size = frame.len();
+    let mut frames = vec![frame];
+    let mut traces: Vec<_> = trace.map(|t| (channel_id, t)).into_iter().collect();
+    let mut next = None;
+    while size < limits.bytes {
+        // Popping is cancel safe, and the timeout polls the pop before its deadline, so a batch
+        // without linger still gathers the messages which are already queued.
+        let Ok(queued) = tokio::time::timeout_at(deadline, client.data_plane.pop()).await else {
+            break;
+        };
+        match queued {
+            (Some(id), Message::Binary(frame), trace)
+                if size + frame.len() <= limits.bytes
+                    && client.compresses(Some(id)) == compress =>
+            {
+                size += frame.len();
+                frames.push(frame);
+                traces.extend(trace.map(|t| (id, t)));
+            }
+            queued => {
+                next = Some(queued);
+                break;
+            }
+        }
+    }
+    let message = if frames.len() == 1 {
+        Message::Binary(frames.remove(0))
+    } else {
+        Message::Binary(encode_batch(&frames))
+    };
+    let outgoing = Outgoing {
+        channel_id: Some(channel_id),
+        message,
+        traces,
+    };
+    (outgoing, next)
+}
+
+/// Encodes queued `MessageData` frames as a single `MessageBatch` frame.
+fn encode_batch(frames: &[Bytes]) -> Bytes {
+    let batch = MessageBatch::new(frames.iter().map(|frame| {
+        MessageData::parse_payload(&frame[1..]).expect("queued frames are message data")
+    }));
+    batch.to_bytes().into()
+}
+
 /// A poller for a connected client.
 ///
 /// The poller is responsible for:
@@ -16,31 +107,33 @@ use super::{ConnectedClient, ShutdownReason};
 /// - Receiving messages from the WebSocket and invoking [`ConnectedClient::handle_message`].
 /// - Waiting for a shutdown signal, and closing the WebSocket.
 pub(super) struct Poller {
-    websocket: WebSocketStream<ServerStream<TcpStream>>,
-    data_plane_rx: flume::Receiver<Message>,
+    websocket: WebSocketStream<DeflateStream<ServerStream<TcpStream>>>,
     control_plane_rx: flume::Receiver<Message>,
     shutdown_rx: oneshot::Receiver<ShutdownReason>,
+    /// Compresses outgoing messages, if the client negotiated permessage-deflate.
+    deflater: Option<Deflater>,
 }
 
 impl Poller {
     /// Creates a new poller.
     pub fn new(
-        websocket: WebSocketStream<ServerStream<TcpStream>>,
-        data_plane_rx: flume::Receiver<Message>,
+        websocket: WebSocketStream<DeflateStream<ServerStream<TcpStream>>>,
         control_plane_rx: flume::Receiver<Message>,
         shutdown_rx: oneshot::Receiver<ShutdownReason>,
+        deflater: Option<Deflater>,
     ) -> Self {
         Self {
             websocket,
-            data_plane_rx,
             control_plane_rx,
             shutdown_rx,
+            deflater,
         }
     }
 
     /// Runs the main poll loop for a WebSocket connection.
-    pub async fn run(self, client: &ConnectedClient) {
+    pub async fn run(mut self, client: &ConnectedClient) {
         let addr = client.addr();
+        let mut deflater = self.deflater.take();
         let (mut ws_tx, mut ws_rx) = self.websocket.split();
 
         // Handle messages received from the WebSocket.
@@ -58,12 +151,32 @@ impl Poller {
 
         // Send messages from queues to the WebSocket.
         let ws_tx_loop = async {
-            while let Ok(msg) = tokio::select! {
-                msg = self.control_plane_rx.recv_async() => msg,
-                msg = self.data_plane_rx.recv_async() => msg,
-            } {
-                if let Err(err) = ws_tx.send(msg).await {
+            // A data message popped while gathering a batch, which is sent next.
+            let mut pending = None;
+            loop {
+                let queued = match pending.take() {
+                    Some(queued) => queued,
+                    None => match tokio::select! {
+                        msg = self.control_plane_rx.recv_async() => msg.map(|m| (None, m, None)),
+                        msg = client.data_plane.pop() => Ok(msg),
+                    } {
+                        Ok(queued) => queued,
+                        Err(_) => break,
+                    },
+                };
+                let (mut outgoing, next) = gather_batch(client, queued).await;
+                pending = next;
+                if let Some(deflater) = deflater.as_mut()
+                    && client.compresses(outgoing.channel_id)
+                {
+                    outgoing.message = deflater.encode(outgoing.message);
+                }
+                if let Err(err) = ws_tx.send(outgoing.message).await {
                     tracing::error!("Error sending message to client {addr}: {err}");
+                } else {
+                    for (channel_id, trace) in outgoing.traces {
+                        trace.finish(client.sink_id(), channel_id);
+                    }
                 }
             }
             unreachable!("ConnectedClient holds queues");
@@ -0,0 +1,598 @@
+//! Support for the permessage-deflate WebSocket extension, described in [RFC 7692].
+//!
+//! tungstenite does not implement the extension, so it is implemented around it. Messages sent to
+//! the client are compressed by a [`Deflater`] and written as raw frames with the RSV1 bit set.
+//! Compressed frames received from the client are decompressed by a [`DeflateStream`] below
+//! tungstenite, which passes them on as uncompressed frames.
+//!
+//! [RFC 7692]: https://www.rfc-editor.org/rfc/rfc7692
+
+use std::io;
+use std::pin::Pin;
+use std::task::{Context, Poll, ready};
+
+use flate2::{Compress, CompressError, Compression, Decompress, FlushCompress, FlushDecompress};
+use tokio::io::{AsyncRead, AsyncWrite, ReadBuf};
+use tokio_tungstenite::tungstenite::Message;
+use tokio_tungstenite::tungstenite::protocol::frame::Frame;
+use tokio_tungstenite::tungstenite::protocol::frame::coding::{Data, OpCode};
+
+/// The name of the extension in the `Sec-WebSocket-Extensions` header.
+const EXTENSION_NAME: &str = "permessage-deflate";
+
+/// The bytes which end a block compressed with a sync flush, which are omitted from messages.
+const TRAILER: [u8; 4] = [0x00, 0x00, 0xff, 0xff];
+
+/// Messages smaller than this are sent uncompressed.
+const MIN_COMPRESSED_SIZE: usize = 128;
+
+/// The maximum size of a message received from a client, which matches tungstenite's default.
+const MAX_MESSAGE_SIZE: usize = 64 << 20;
+
+const FIN: u8 = 0x80;
+const RSV1: u8 = 0x40;
+const OPCODE: u8 = 0x0f;
+const CONTINUATION: u8 = 0x0;
+const CONTROL: u8 = 0x8;
+const MASK: u8 = 0x80;
+
+/// The parameters of a negotiated permessage-deflate extension.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub(crate) struct DeflateParams {
+    /// The server resets its compression context after each message.
+    server_no_context_takeover: bool,
+    /// The client resets its compression context after each message.
+    client_no_context_takeover: bool,
+    /// The client asked the server to limit its window size.
+    server_max_window_bits: bool,
+}
+
+impl DeflateParams {
+    /// Returns the parameters of the first permessage-deflate offer in the client's
+    /// `Sec-WebSocket-Extensions` headers which the server accepts.
+    pub fn negotiate<'a>(headers: impl IntoIterator<Item = &'a str>) -> Option<Self> {
+        headers
+            .into_iter()
+            .flat_map(|header| header.split(','))
+            .find_map(Self::parse_offer)
+    }
+
+    /// Parses an extension offer, returning `None` if it cannot be accepted.
+    fn parse_offer(offer: &str) -> Option<Self> {
+        let mut params = offer.split(';').map(str::trim);
+        if !params.next()?.eq_ignore_ascii_case(EXTENSION_NAME) {
+            return None;
+        }
+        let mut result = Self::default();
+        for param in params {
+            let (name, value) = match param.split_once('=') {
+                Some((name, value)) => (name.trim(), Some(value.trim().trim_matches('"'))),
+                None => (param, None),
+            };
+            match (name, value) {
+                ("server_no_context_takeover", None) => result.server_no_context_takeover = true,
+                ("client_no_context_takeover", None) => result.client_no_context_takeover = true,
+                // The compressor always uses the largest window, so smaller windows are declined.
+                ("server_max_window_bits", Some("15")) => result.server_max_window_bits = true,
+                // The decompressor accepts any window size.
+                ("client_max_window_bits", None) => (),
+                ("client_max_window_bits", Some(bits)) if valid_window_bits(bits) => (),
+                _ => return None,
+            }
+        }
+        Some(result)
+    }
+
+    /// Returns the `Sec-WebSocket-Extensions` header value which accepts the offer.
+    pub fn response(&self) -> String {
+        let mut response = EXTENSION_NAME.to_string();
+        if self.server_no_context_takeover {
+            response.push_str("; server_no_context_takeover");
+        }
+        if self.client_no_context_takeover {
+            response.push_str("; client_no_context_takeover");
+        }
+        if self.server_max_window_bits {
+            response.push_str("; server_max_window_bits=15");
+        }
+        response
+    }
+}
+
+/// Returns true if the window size parameter is valid.
+fn valid_window_bits(bits: &str) -> bool {
+    bits.parse().is_ok_and(|bits: u8| (8..=15).contains(&bits))
+}
+
+/// Compresses the messages sent to a client.
+pub(crate) struct Deflater {
+    compress: Compress,
+    no_context_takeover: bool,
+}
+
+impl Deflater {
+    pub fn new(params: DeflateParams) -> Self {
+        Self {
+            compress: Compress::new(Compression::fast(), false),
+            no_context_takeover: params.server_no_context_takeover,
+        }
+    }
+
+    /// Compresses a text or binary message into a frame with the RSV1 bit set.
+    ///
+    /// Messages smaller than [`MIN_COMPRESSED_SIZE`] and control messages are returned unchanged.
+    pub fn encode(&mut self, message: Message) -> Message {
+        let (data, opcode) = match &message {
+            Message::Text(text) => (text.as_str().as_bytes(), Data::Text),
+            Message::Binary(data) => (data.as_ref(), Data::Binary),
+            _ => return message,
+        };
+        if data.len() < MIN_COMPRESSED_SIZE {
+            return message;
+        }
+        match self.compress(data) {
+            Ok(compressed) => {
+                let mut frame = Frame::message(compressed, OpCode::Data(opcode), true);
+                frame.header_mut().rsv1 = true;
+                Message::Frame(frame)
+            }
+            Err(err) => {
+                tracing::warn!("Failed to compress message: {err}");
+                // Later messages must not refer to data the client did not receive.
+                self.compress.reset();
+                message
+            }
+        }
+    }
+
+    fn compress(&mut self, data: &[u8]) -> Result<Vec<u8>, CompressError> {
+        let mut output = Vec::with_capacity(data.len() / 2 + 64);
+        let start = self.compress.total_in();
+        loop {
+            if output.len() == output.capacity() {
+                output.reserve(output.capacity());
+            }
+            let consumed = (self.compress.total_in() - start) as usize;
+            self.compress
+                .compress_vec(&data[consumed..], &mut output, FlushCompress::Sync)?;
+            // The flush is complete once all input is consumed, without filling the output.
+            let consumed = (self.compress.total_in() - start) as usize;
+            if consumed == data.len() && output.len() < output.capacity() {
+                break;
+            }
+        }
+        if output.ends_with(&TRAILER) {
+            output.truncate(output.len() - TRAILER.len());
+        }
+        if self.no_context_takeover {
+            self.compress.reset();
+        }
+        Ok(output)
+    }
+}
+
+/// Decompresses the messages received from a client.
+struct Inflater {
+    decompress: Decompress,
+}
+
+impl Inflater {
+    fn new() -> Self {
+        Self {
+            decompress: Decompress::new(false),
+        }
+    }
+
+    /// Decompresses the payload of a message.
+    fn inflate(&mut self, mut payload: Vec<u8>) -> io::Result<Vec<u8>> {
+        payload.extend_from_slice(&TRAILER);
+        let mut output = Vec::with_capacity(payload.len() * 4);
+        let start = self.decompress.total_in();
+        loop {
+            if output.len() == output.capacity() {
+                if output.len() >= MAX_MESSAGE_SIZE {
+                    return Err(invalid_data("decompressed message is too large"));
+                }
+                output.reserve(output.capacity());
+            }
+            let consumed = (self.decompress.total_in() - start) as usize;
+            let status = self
+                .decompress
+                .decompress_vec(&payload[consumed..], &mut output, FlushDecompress::Sync)
+                .map_err(|err| invalid_data(&err.to_string()))?;
+            if status == flate2::Status::StreamEnd {
+                // The client ended the deflate stream, and starts a new one with its next message.
+                self.decompress.reset(false);
+                break;
+            }
+            let consumed = (self.decompress.total_in() - start) as usize;
+            if consumed == payload.len() && output.len() < output.capacity() {
+                break;
+            }
+        }
+        Ok(output)
+    }
+}
+
+fn invalid_data(message: &str) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, message.to_string())
+}
+
+/// The header of a frame received from a client.
+struct FrameHeader {
+    /// The first byte of the frame, which holds the FIN and RSV bits and the opcode.
+    first: u8,
+    mask: Option<[u8; 4]>,
+    len: usize,
+    payload_len: usize,
+}
+
+impl FrameHeader {
+    /// Parses a frame header, returning `None` if more data is needed.
+    fn parse(data: &[u8]) -> io::Result<Option<Self>> {
+        let [first, second, ..] = *data else {
+            return Ok(None);
+        };
+        let (payload_len, mut len) = match second & !MASK {
+            126 => {
+                let Some(&[a, b]) = data.get(2..4) else {
+                    return Ok(None);
+                };
+                (u64::from(u16::from_be_bytes([a, b])), 4)
+            }
+            127 => {
+                let Some(bytes) = data.get(2..10) else {
+                    return Ok(None);
+                };
+                let mut be = [0; 8];
+                be.copy_from_slice(bytes);
+                (u64::from_be_bytes(be), 10)
+            }
+            payload_len => (u64::from(payload_len), 2),
+        };
+        if payload_len > MAX_MESSAGE_SIZE as u64 {
+            return Err(invalid_data("frame is too large"));
+        }
+        let mask = if second & MASK != 0 {
+            let Some(&[a, b, c, d]) = data.get(len..len + 4) else {
+                return Ok(None);
+            };
+            len += 4;
+            Some([a, b, c, d])
+        } else {
+            None
+        };
+        Ok(Some(Self {
+            first,
+            mask,
+            len,
+            payload_len: payload_len as usize,
+        }))
+    }
+}
+
+/// Rewrites the compressed frames received from a client as uncompressed frames.
+struct Inflate {
+    inflater: Inflater,
+    /// Data read from the stream which does not hold a complete frame yet.
+    input: Vec<u8>,
+    /// Rewritten frames, which have not been read yet.
+    output: Vec<u8>,
+    /// The number of bytes of `output` which have been read.
+    read: usize,
+    /// The opcode and payload of a compressed message whose last frame has not been received.
+    fragmented: Option<(u8, Vec<u8>)>,
+}
+
+impl Inflate {
+    fn new() -> Self {
+        Self {
+            inflater: Inflater::new(),
+            input: Vec::new(),
+            output: Vec::new(),
+            read: 0,
+            fragmented: None,
+        }
+    }
+
+    /// Rewrites the complete frames in the input to the output.
+    fn process(&mut self) -> io::Result<()> {
+        let input = std::mem::take(&mut self.input);
+        let mut pos = 0;
+        let result = loop {
+            let header = match FrameHeader::parse(&input[pos..]) {
+                Ok(Some(header)) => header,
+                Ok(None) => break Ok(()),
+                Err(err) => break Err(err),
+            };
+            let end = pos + header.len + header.payload_len;
+            let Some(frame) = input.get(pos..end) else {
+                break Ok(());
+            };
+            if let Err(err) = self.rewrite(&header, frame) {
+                break Err(err);
+            }
+            pos = end;
+        };
+        self.input = input;
+        self.input.drain(..pos);
+        result
+    }
+
+    fn rewrite(&mut self, header: &FrameHeader, frame: &[u8]) -> io::Result<()> {
+        let opcode = header.first & OPCODE;
+        let compressed = header.first & RSV1 != 0;
+        if opcode & CONTROL != 0 || (!compressed && self.fragmented.is_none()) {
+            self.output.extend_from_slice(frame);
+            return Ok(());
+        }
+        let Some(mask) = header.mask else {
+            return Err(invalid_data("received an unmasked frame"));
+        };
+        let mut payload = frame[header.len..].to_vec();
+        for (i, byte) in payload.iter_mut().enumerate() {
+            *byte ^= mask[i % 4];
+        }
+        let (opcode, payload) = match (opcode, self.fragmented.take()) {
+            (CONTINUATION, Some((opcode, mut data))) if !compressed => {
+                if data.len() + payload.len() > MAX_MESSAGE_SIZE {
+                    return Err(invalid_data("message is too large"));
+                }
+                data.extend_from_slice(&payload);
+                (opcode, data)
+            }
+            (CONTINUATION, _) => return Err(invalid_data("unexpected continuation frame")),
+            (_, Some(_)) => return Err(invalid_data("expected a continuation frame")),
+            (opcode, None) => (opcode, payload),
+        };
+        if header.first & FIN == 0 {
+            self.fragmented = Some((opcode, payload));
+            return Ok(());
+        }
+        let payload = self.inflater.inflate(payload)?;
+        self.write_frame(opcode, &payload);
+        Ok(())
+    }
+
+    /// Writes an unfragmented, uncompressed frame, masked with a zero key.
+    fn write_frame(&mut self, opcode: u8, payload: &[u8]) {
+        self.output.push(FIN | opcode);
+        match payload.len() {
+            len @ 0..=125 => self.output.push(MASK | len as u8),
+            len @ 126..=0xffff => {
+                self.output.push(MASK | 126);
+                self.output.extend_from_slice(&(len as u16).to_be_bytes());
+            }
+            len => {
+                self.output.push(MASK | 127);
+                self.output.extend_from_slice(&(len as u64).to_be_bytes());
+            }
+        }
+        self.output.extend_from_slice(&[0; 4]);
+        self.output.extend_from_slice(payload);
+    }
+}
+
+/// A stream which decompresses the frames received from a client once permessage-deflate has been
+/// negotiated, and otherwise passes data through unchanged.
+pub(crate) struct DeflateStream<S> {
+    inner: S,
+    inflate: Option<Box<Inflate>>,
+}
+
+impl<S> DeflateStream<S> {
+    pub fn new(inner: S) -> Self {
+        Self {
+            inner,
+            inflate: None,
+        }
+    }
+
+    /// Starts decompressing the frames received from the client.
+    ///
+    /// This must be called when the handshake completes, before any frames are read.
+    pub fn enable(&mut self) {
+        self.inflate = Some(Box::new(Inflate::new()));
+    }
+}
+
+impl<S: AsyncRead + Unpin> AsyncRead for DeflateStream<S> {
+    fn poll_read(
+        self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
+        buf: &mut ReadBuf<'_>,
+    ) -> Poll<io::Result<()>> {
+        let this = self.get_mut();
+        let Some(inflate) = this.inflate.as_mut() else {
+            return Pin::new(&mut this.inner).poll_read(cx, buf);
+        };
+        loop {
+            if inflate.read < inflate.output.len() {
+                let len = buf.remaining().min(inflate.output.len() - inflate.read);
+                buf.put_slice(&inflate.output[inflate.read..inflate.read + len]);
+                inflate.read += len;
+                if inflate.read == inflate.output.len() {
+                    inflate.output.clear();
+                    inflate.read = 0;
+                }
+                return Poll::Ready(Ok(()));
+            }
+            let mut chunk = [0; 8192];
+            let mut chunk = ReadBuf::new(&mut chunk);
+            ready!(Pin::new(&mut this.inner).poll_read(cx, &mut chunk))?;
+            if chunk.filled().is_empty() {
+                return Poll::Ready(Ok(()));
+            }
+            inflate.input.extend_from_slice(chunk.filled());
+            inflate.process()?;
+        }
+    }
+}
+
+impl<S: AsyncWrite + Unpin> AsyncWrite for DeflateStream<S> {
+    fn poll_write(
+        self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
+        buf: &[u8],
+    ) -> Poll<io::Result<usize>> {
+        Pin::new(&mut self.get_mut().inner).poll_write(cx, buf)
+    }
+
+    fn poll_write_vectored(
+        self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
+        bufs: &[io::IoSlice<'_>],
+    ) -> Poll<io::Result<usize>> {
+        Pin::new(&mut self.get_mut().inner).poll_write_vectored(cx, bufs)
+    }
+
+    fn is_write_vectored(&self) -> bool {
+        self.inner.is_write_vectored()
+    }
+
+    fn poll_flush(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        Pin::new(&mut self.get_mut().inner).poll_flush(cx)
+    }
+
+    fn poll_shutdown(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        Pin::new(&mut self.get_mut().inner).poll_shutdown(cx)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use tokio::io::AsyncReadExt;
+
+    use super::*;
+
+    #[test]
+    fn test_negotiate() {
+        assert_eq!(DeflateParams::negotiate(["x-webkit-deflate-frame"]), None);
+        let params = DeflateParams::negotiate(["permessage-deflate; client_max_window_bits"])
+            .expect("offer is accepted");
+        assert_eq!(params.response(), "permessage-deflate");
+
+        // Offers which limit the server's window are declined in favor of later offers.
+        let offers = "permessage-deflate; server_max_window_bits=10, \
+            permessage-deflate; server_no_context_takeover; server_max_window_bits=15";
+        let params = DeflateParams::negotiate([offers]).expect("offer is accepted");
+        assert_eq!(
+            params.response(),
+            "permessage-deflate; server_no_context_takeover; server_max_window_bits=15"
+        );
+        assert_eq!(
+            DeflateParams::negotiate(["permessage-deflate; unknown_param"]),
+            None
+        );
+    }
+
+    /// Encodes a client frame, masked with a non-zero key.
+    fn client_frame(first: u8, payload: &[u8]) -> Vec<u8> {
+        let mask = [0x12, 0x34, 0x56, 0x78];
+        let mut frame = vec![first];
+        match payload.len() {
+            len @ 0..=125 => frame.push(MASK | len as u8),
+            len => {
+                frame.push(MASK | 126);
+                frame.extend_from_slice(&(len as u16).to_be_bytes());
+            }
+        }
+        frame.extend_from_slice(&mask);
+        frame.extend(payload.iter().enumerate().map(|(i, b)| b ^ mask[i % 4]));
+        frame
+    }
+
+    /// Compresses a message, as a client would.
+    fn compress(deflater: &mut Deflater, data: &[u8]) -> Vec<u8> {
+        deflater.compress(data).expect("failed to compress")
+    }
+
+    /// Reads a frame, returning its first byte, its unmasked payload, and its length.
+    fn read_frame(data: &[u8]) -> (u8, Vec<u8>, usize) {
+        let header = FrameHeader::parse(data)
+            .expect("valid frame")
+            .expect("complete frame");
+        let mask = header.mask.expect("masked frame");
+        let end = header.len + header.payload_len;
+        let payload = data[header.len..end]
+            .iter()
+            .enumerate()
+            .map(|(i, b)| b ^ mask[i % 4])
+            .collect();
+        (header.first, payload, end)
+    }
+
+    #[tokio::test]
+    async fn test_stream_inflates_client_frames() {
+        let text = "hello, compressed world! ".repeat(20);
+        let mut deflater = Deflater::new(DeflateParams::default());
+        let first = compress(&mut deflater, text.as_bytes());
+        let second = compress(&mut deflater, text.as_bytes());
+        // The second message refers back to the first.
+        assert!(second.len() < first.len());
+
+        let mut input = client_frame(FIN | RSV1 | 0x1, &first);
+        input.extend(client_frame(FIN | 0x9, b"ping"));
+        // A compressed message in two fragments, with a control frame between them.
+        input.extend(client_frame(RSV1 | 0x2, &second[..3]));
+        input.extend(client_frame(FIN | 0xa, b"pong"));
+        input.extend(client_frame(FIN, &second[3..]));
+        input.extend(client_frame(FIN | 0x1, b"uncompressed"));
+
+        let mut stream = DeflateStream::new(&input[..]);
+        stream.enable();
+        let mut output = Vec::new();
+        stream
+            .read_to_end(&mut output)
+            .await
+            .expect("failed to read");
+
+        let mut frames = Vec::new();
+        let mut pos = 0;
+        while pos < output.len() {
+            let (first, payload, len) = read_frame(&output[pos..]);
+            frames.push((first, payload));
+            pos += len;
+        }
+        assert_eq!(frames.len(), 5);
+        assert_eq!(frames[0], (FIN | 0x1, text.as_bytes().to_vec()));
+        assert_eq!(frames[1], (FIN | 0x9, b"ping".to_vec()));
+        assert_eq!(frames[2], (FIN | 0xa, b"pong".to_vec()));
+        assert_eq!(frames[3], (FIN | 0x2, text.as_bytes().to_vec()));
+        assert_eq!(frames[4].1, b"uncompressed");
+    }
+
+    #[tokio::test]
+    async fn test_stream_passes_data_through_until_enabled() {
+        let input = client_frame(FIN | RSV1 | 0x1, b"not deflate data");
+        let mut stream = DeflateStream::new(&input[..]);
+        let mut output = Vec::new();
+        stream
+            .read_to_end(&mut output)
+            .await
+            .expect("failed to read");
+        assert_eq!(output, input);
+    }
+
+    #[test]
+    fn test_encode() {
+        let mut deflater = Deflater::new(DeflateParams {
+            server_no_context_takeover: true,
+            ..DeflateParams::default()
+        });
+        let small = Message::Text("small".into());
+        assert_eq!(deflater.encode(small.clone()), small);
+
+        let text = "{\"data\": 12345}".repeat(20);
+        let Message::Frame(frame) = deflater.encode(Message::Text(text.clone().into())) else {
+            panic!("expected a compressed frame");
+        };
+        assert!(frame.header().rsv1);
+        assert!(frame.payload().len() < text.len());
+        let mut inflater = Inflater::new();
+        let payload = inflater
+            .inflate(frame.payload().to_vec())
+            .expect("failed to inflate");
+        assert_eq!(payload, text.as_bytes());
+    }
+}
@@ -3,15 +3,22 @@ use tokio_tungstenite::tungstenite::handshake::server;
 use tokio_tungstenite::tungstenite::http::HeaderValue;
 use tokio_tungstenite::{WebSocketStream, tungstenite};
 
+use super::deflate::{DeflateParams, DeflateStream};
+
 pub(crate) const SUBPROTOCOL: &str = "foxglove.sdk.v1";
 
 /// Add the subprotocol header to the response if the client requested it. If the client requests
 /// subprotocols which don't contain ours, or does not include the expected header, return a 400.
+///
+/// If `compression` is true and the client offers the permessage-deflate extension, the extension
+/// is accepted, and its parameters are returned with the stream.
 pub(crate) async fn do_handshake<S: AsyncRead + AsyncWrite + Unpin>(
     stream: S,
-) -> Result<WebSocketStream<S>, tungstenite::Error> {
-    tokio_tungstenite::accept_hdr_async(
-        stream,
+    compression: bool,
+) -> Result<(WebSocketStream<DeflateStream<S>>, Option<DeflateParams>), tungstenite::Error> {
+    let mut deflate = None;
+    let mut ws_stream = tokio_tungstenite::accept_hdr_async(
+        DeflateStream::new(stream),
         #[allow(clippy::result_large_err)]
         |req: &server::Request, mut res: server::Response| {
             let protocol_headers = req.headers().get_all("sec-websocket-protocol");
@@ -26,6 +33,9 @@ pub(crate) async fn do_handshake<S: AsyncRead + AsyncWrite + Unpin>(
                         "sec-websocket-protocol",
                         HeaderValue::from_static(SUBPROTOCOL),
                     );
+                    if compression {
+                        deflate = negotiate_deflate(req, &mut res);
+                    }
                     return Ok(res);
                 }
             }
@@ -38,5 +48,18 @@ pub(crate) async fn do_handshake<S: AsyncRead + AsyncWrite + Unpin>(
                 .unwrap())
         },
     )
-    .await
+    .await?;
+    if deflate.is_some() {
+        ws_stream.get_mut().enable();
+    }
+    Ok((ws_stream, deflate))
+}
+
+/// Accepts the client's permessage-deflate offer, if it made one that the server supports.
+fn negotiate_deflate(req: &server::Request, res: &mut server::Response) -> Option<DeflateParams> {
+    let offers = req.headers().get_all("sec-websocket-extensions");
+    let params = DeflateParams::negotiate(offers.iter().filter_map(|v| v.to_str().ok()))?;
+    let value = HeaderValue::from_str(&params.response()).ok()?;
+    res.headers_mut().insert("sec-websocket-extensions", value);
+    Some(params)
 }
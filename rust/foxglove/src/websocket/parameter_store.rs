@@ -0,0 +1,169 @@
+//! Tracks published parameter values, so that clients are only sent values which have changed.
+
+use std::collections::{HashMap, HashSet};
+
+use indexmap::IndexSet;
+
+use super::{ClientId, Parameter};
+
+/// A published parameter value, and the version it was assigned when it last changed.
+#[derive(Debug)]
+struct Versioned {
+    parameter: Parameter,
+    version: u64,
+}
+
+/// The latest published value of each parameter, and the version of each parameter last sent to
+/// each client.
+#[derive(Debug, Default)]
+pub(super) struct ParameterStore {
+    values: HashMap<String, Versioned>,
+    /// Parameters which have been published since the last flush, in the order they were first
+    /// published.
+    pending: IndexSet<String>,
+    /// The version of each parameter last sent to each client.
+    delivered: HashMap<ClientId, HashMap<String, u64>>,
+    next_version: u64,
+    /// Whether a flush is scheduled for the end of the current coalescing window.
+    pub flush_scheduled: bool,
+}
+
+impl ParameterStore {
+    /// Records published parameter values.
+    ///
+    /// A parameter's version changes only if its value does, so that a republished value is only
+    /// sent to subscribers which have not already been sent it.
+    pub fn update(&mut self, parameters: Vec<Parameter>) {
+        for parameter in parameters {
+            self.pending.insert(parameter.name.clone());
+            if self
+                .values
+                .get(&parameter.name)
+                .is_some_and(|current| current.parameter == parameter)
+            {
+                continue;
+            }
+            self.next_version += 1;
+            self.values.insert(
+                parameter.name.clone(),
+                Versioned {
+                    parameter,
+                    version: self.next_version,
+                },
+            );
+        }
+    }
+
+    /// Takes the parameters which have been published since the last flush, and returns the
+    /// values to send to each subscribed client which has not already been sent them.
+    pub fn flush(
+        &mut self,
+        subscriptions: &HashMap<String, HashSet<ClientId>>,
+    ) -> HashMap<ClientId, Vec<Parameter>> {
+        let mut updates: HashMap<ClientId, Vec<Parameter>> = HashMap::new();
+        for name in std::mem::take(&mut self.pending) {
+            let (Some(current), Some(subscribers)) =
+                (self.values.get(&name), subscriptions.get(&name))
+            else {
+                continue;
+            };
+            for &client_id in subscribers {
+                let delivered = self
+                    .delivered
+                    .entry(client_id)
+                    .or_default()
+                    .entry(name.clone())
+                    .or_default();
+                if *delivered < current.version {
+                    *delivered = current.version;
+                    updates
+                        .entry(client_id)
+                        .or_default()
+                        .push(current.parameter.clone());
+                }
+            }
+        }
+        updates
+    }
+
+    /// Forgets which values of the named parameters were sent to the client, so that it is sent
+    /// the next published value if it subscribes again.
+    pub fn unsubscribe(&mut self, client_id: ClientId, names: &[String]) {
+        if let Some(delivered) = self.delivered.get_mut(&client_id) {
+            for name in names {
+                delivered.remove(name);
+            }
+        }
+    }
+
+    /// Forgets the client.
+    pub fn remove_client(&mut self, client_id: ClientId) {
+        self.delivered.remove(&client_id);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn subscriptions(entries: &[(&str, &[ClientId])]) -> HashMap<String, HashSet<ClientId>> {
+        entries
+            .iter()
+            .map(|(name, ids)| (name.to_string(), ids.iter().copied().collect()))
+            .collect()
+    }
+
+    #[test]
+    fn test_sends_only_changed_values() {
+        let a = ClientId(1);
+        let b = ClientId(2);
+        let subs = subscriptions(&[("x", &[a, b]), ("y", &[a])]);
+        let mut store = ParameterStore::default();
+
+        store.update(vec![
+            Parameter::float64("x", 1.0),
+            Parameter::string("y", "one"),
+            Parameter::string("z", "unsubscribed"),
+        ]);
+        let updates = store.flush(&subs);
+        assert_eq!(
+            updates[&a],
+            vec![Parameter::float64("x", 1.0), Parameter::string("y", "one")]
+        );
+        assert_eq!(updates[&b], vec![Parameter::float64("x", 1.0)]);
+
+        // Republishing the same values sends nothing.
+        store.update(vec![
+            Parameter::float64("x", 1.0),
+            Parameter::string("y", "one"),
+        ]);
+        assert!(store.flush(&subs).is_empty());
+
+        // Only the latest of several updates between flushes is sent.
+        store.update(vec![Parameter::string("y", "two")]);
+        store.update(vec![Parameter::string("y", "three")]);
+        let updates = store.flush(&subs);
+        assert_eq!(updates.len(), 1);
+        assert_eq!(updates[&a], vec![Parameter::string("y", "three")]);
+    }
+
+    #[test]
+    fn test_new_subscriber_is_sent_republished_value() {
+        let a = ClientId(1);
+        let b = ClientId(2);
+        let mut store = ParameterStore::default();
+
+        store.update(vec![Parameter::bool("x", true)]);
+        store.flush(&subscriptions(&[("x", &[a])]));
+
+        // A client which resubscribes, or subscribes for the first time, is sent a republished
+        // value which it has not been sent since subscribing.
+        store.unsubscribe(a, &["x".to_string()]);
+        store.update(vec![Parameter::bool("x", true)]);
+        let updates = store.flush(&subscriptions(&[("x", &[a, b])]));
+        assert_eq!(updates.len(), 2);
+
+        store.remove_client(b);
+        assert!(!store.delivered.contains_key(&b));
+    }
+}
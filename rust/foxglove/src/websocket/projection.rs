@@ -0,0 +1,504 @@
+//! Field projections for client subscriptions.
+//!
+//! A client which subscribes with a list of fields receives only those fields of each message.
+//! Projections are compiled once per channel and set of fields, and shared by the clients which
+//! request them, so that each message is projected once no matter how many clients receive it.
+
+use std::collections::{BTreeMap, HashMap};
+use std::sync::{Arc, Weak};
+
+use bytes::Bytes;
+use prost::Message as _;
+use prost::encoding::{decode_varint, encode_varint};
+use prost_types::field_descriptor_proto::Type as FieldType;
+use prost_types::{DescriptorProto, FileDescriptorSet};
+
+use crate::{ChannelId, RawChannel};
+
+/// An error that occurs while compiling or applying a field projection.
+#[derive(Debug, thiserror::Error)]
+pub(crate) enum ProjectionError {
+    /// The field list is empty, or contains an empty path or path segment.
+    #[error("Invalid field path: {0:?}")]
+    InvalidPath(String),
+    /// Projection isn't supported for the channel's message encoding.
+    #[error("Field projection is not supported for {0:?} messages")]
+    UnsupportedEncoding(String),
+    /// The channel's schema can't be used to project its messages.
+    #[error("Invalid schema: {0}")]
+    InvalidSchema(String),
+    /// A field path names a field which isn't in the message.
+    #[error("Unknown field {field:?} in message {message}")]
+    UnknownField { message: String, field: String },
+    /// A field path selects a subfield of a field which isn't a message.
+    #[error("Field {0:?} is not a message")]
+    NotAMessage(String),
+    /// A message could not be decoded.
+    #[error("Invalid message: {0}")]
+    InvalidMessage(String),
+}
+
+/// The fields selected by a projection, as a tree of field names.
+///
+/// A field with no subtree is selected whole.
+#[derive(Debug, Default, Clone, PartialEq, Eq, Hash)]
+struct FieldTree(BTreeMap<String, Option<FieldTree>>);
+
+impl FieldTree {
+    /// Parses a list of dot-separated field paths.
+    fn parse(paths: &[String]) -> Result<Self, ProjectionError> {
+        let mut tree = Self::default();
+        if paths.is_empty() {
+            return Err(ProjectionError::InvalidPath(String::new()));
+        }
+        for path in paths {
+            let segments: Vec<_> = path.split('.').collect();
+            if segments.iter().any(|s| s.is_empty()) {
+                return Err(ProjectionError::InvalidPath(path.clone()));
+            }
+            tree.insert(&segments);
+        }
+        Ok(tree)
+    }
+
+    fn insert(&mut self, path: &[&str]) {
+        let Some((&name, rest)) = path.split_first() else {
+            return;
+        };
+        if rest.is_empty() {
+            // Selecting a field whole supersedes any of its subfields.
+            self.0.insert(name.to_string(), None);
+            return;
+        }
+        if let Some(subtree) = self
+            .0
+            .entry(name.to_string())
+            .or_insert_with(|| Some(Self::default()))
+        {
+            subtree.insert(rest);
+        }
+    }
+}
+
+/// The fields selected by a protobuf projection, by field number.
+#[derive(Debug, Default)]
+struct ProtobufFields(HashMap<u64, Option<ProtobufFields>>);
+
+#[derive(Debug)]
+enum Fields {
+    Json(FieldTree),
+    Protobuf(ProtobufFields),
+}
+
+/// A projection of a channel's messages onto a set of fields.
+#[derive(Debug)]
+pub(crate) struct Projection {
+    fields: Fields,
+}
+
+impl Projection {
+    fn new(channel: &RawChannel, tree: FieldTree) -> Result<Self, ProjectionError> {
+        let fields = match channel.message_encoding() {
+            "json" => Fields::Json(tree),
+            "protobuf" => {
+                let schema = channel
+                    .schema()
+                    .filter(|schema| schema.encoding == "protobuf")
+                    .ok_or_else(|| {
+                        ProjectionError::InvalidSchema("expected a protobuf schema".into())
+                    })?;
+                let descriptors = FileDescriptorSet::decode(&*schema.data)
+                    .map_err(|err| ProjectionError::InvalidSchema(err.to_string()))?;
+                let mut messages = HashMap::new();
+                for file in &descriptors.file {
+                    let package = match file.package() {
+                        "" => String::new(),
+                        package => format!(".{package}"),
+                    };
+                    index_messages(&package, &file.message_type, &mut messages);
+                }
+                let name = format!(".{}", schema.name.trim_start_matches('.'));
+                let message = messages.get(&name).ok_or_else(|| {
+                    ProjectionError::InvalidSchema(format!("no message named {}", schema.name))
+                })?;
+                Fields::Protobuf(compile_protobuf(message, &tree, &messages)?)
+            }
+            encoding => return Err(ProjectionError::UnsupportedEncoding(encoding.to_string())),
+        };
+        Ok(Self { fields })
+    }
+
+    /// Returns an identifier for the projection, which is unique while it is alive.
+    pub fn id(self: &Arc<Self>) -> u64 {
+        Arc::as_ptr(self) as usize as u64
+    }
+
+    /// Projects a message onto the selected fields.
+    pub fn project(&self, msg: &[u8]) -> Result<Bytes, ProjectionError> {
+        match &self.fields {
+            Fields::Json(tree) => {
+                let value = serde_json::from_slice(msg)
+                    .map_err(|err| ProjectionError::InvalidMessage(err.to_string()))?;
+                let projected = project_json(tree, value);
+                Ok(serde_json::to_vec(&projected)
+                    .expect("JSON values are serializable")
+                    .into())
+            }
+            Fields::Protobuf(fields) => {
+                let mut projected = Vec::with_capacity(msg.len());
+                project_protobuf(fields, msg, &mut projected)?;
+                Ok(projected.into())
+            }
+        }
+    }
+}
+
+/// The projections in use by the clients of a server.
+///
+/// Clients which request the same fields of a channel share a projection, so that each message
+/// is projected once for all of them.
+#[derive(Default)]
+pub(crate) struct Projections(
+    parking_lot::Mutex<HashMap<(ChannelId, FieldTree), Weak<Projection>>>,
+);
+
+impl Projections {
+    /// Returns the projection of the channel's messages onto the given field paths.
+    pub fn get(
+        &self,
+        channel: &RawChannel,
+        paths: &[String],
+    ) -> Result<Arc<Projection>, ProjectionError> {
+        let tree = FieldTree::parse(paths)?;
+        let mut projections = self.0.lock();
+        projections.retain(|_, projection| projection.strong_count() > 0);
+        let key = (channel.id(), tree);
+        if let Some(projection) = projections.get(&key).and_then(Weak::upgrade) {
+            return Ok(projection);
+        }
+        let projection = Arc::new(Projection::new(channel, key.1.clone())?);
+        projections.insert(key, Arc::downgrade(&projection));
+        Ok(projection)
+    }
+}
+
+fn project_json(tree: &FieldTree, value: serde_json::Value) -> serde_json::Value {
+    use serde_json::Value;
+    match value {
+        Value::Object(mut object) => Value::Object(
+            tree.0
+                .iter()
+                .filter_map(|(name, subtree)| {
+                    let value = object.remove(name)?;
+                    let value = match subtree {
+                        Some(subtree) => project_json(subtree, value),
+                        None => value,
+                    };
+                    Some((name.clone(), value))
+                })
+                .collect(),
+        ),
+        // The fields of each element of an array are selected.
+        Value::Array(values) => Value::Array(
+            values
+                .into_iter()
+                .map(|value| project_json(tree, value))
+                .collect(),
+        ),
+        value => value,
+    }
+}
+
+/// Indexes the messages of a file by their fully-qualified name, such as `.foxglove.Pose`.
+fn index_messages<'a>(
+    prefix: &str,
+    messages: &'a [DescriptorProto],
+    index: &mut HashMap<String, &'a DescriptorProto>,
+) {
+    for message in messages {
+        let name = format!("{prefix}.{}", message.name());
+        index_messages(&name, &message.nested_type, index);
+        index.insert(name, message);
+    }
+}
+
+fn compile_protobuf(
+    message: &DescriptorProto,
+    tree: &FieldTree,
+    messages: &HashMap<String, &DescriptorProto>,
+) -> Result<ProtobufFields, ProjectionError> {
+    let mut fields = ProtobufFields::default();
+    for (name, subtree) in &tree.0 {
+        let field = message
+            .field
+            .iter()
+            .find(|field| field.name() == name)
+            .ok_or_else(|| ProjectionError::UnknownField {
+                message: message.name().to_string(),
+                field: name.clone(),
+            })?;
+        let subfields = match subtree {
+            None => None,
+            Some(subtree) => {
+                if field.r#type() != FieldType::Message {
+                    return Err(ProjectionError::NotAMessage(name.clone()));
+                }
+                let nested = messages.get(field.type_name()).ok_or_else(|| {
+                    ProjectionError::InvalidSchema(format!(
+                        "no message named {}",
+                        field.type_name()
+                    ))
+                })?;
+                Some(compile_protobuf(nested, subtree, messages)?)
+            }
+        };
+        let number = u64::try_from(field.number())
+            .map_err(|_| ProjectionError::InvalidSchema(format!("invalid field number {name}")))?;
+        fields.0.insert(number, subfields);
+    }
+    Ok(fields)
+}
+
+const WIRE_TYPE_VARINT: u64 = 0;
+const WIRE_TYPE_FIXED64: u64 = 1;
+const WIRE_TYPE_LENGTH_DELIMITED: u64 = 2;
+const WIRE_TYPE_FIXED32: u64 = 5;
+
+/// Copies the selected fields of an encoded protobuf message to `out`.
+///
+/// The message is not decoded: selected fields are copied as they are, and selected subfields of
+/// nested messages are projected in turn. Repeated fields are copied in full, with the selected
+/// subfields of each element.
+fn project_protobuf(
+    fields: &ProtobufFields,
+    mut msg: &[u8],
+    out: &mut Vec<u8>,
+) -> Result<(), ProjectionError> {
+    let invalid = |err: &dyn std::fmt::Display| ProjectionError::InvalidMessage(err.to_string());
+    let skip = |msg: &mut &[u8], len: usize| {
+        if msg.len() < len {
+            return Err(ProjectionError::InvalidMessage("truncated field".into()));
+        }
+        *msg = &msg[len..];
+        Ok(())
+    };
+    while !msg.is_empty() {
+        let field = msg;
+        let key = decode_varint(&mut msg).map_err(|err| invalid(&err))?;
+        let selected = fields.0.get(&(key >> 3));
+        match key & 0x7 {
+            WIRE_TYPE_VARINT => {
+                decode_varint(&mut msg).map_err(|err| invalid(&err))?;
+            }
+            WIRE_TYPE_FIXED64 => skip(&mut msg, 8)?,
+            WIRE_TYPE_FIXED32 => skip(&mut msg, 4)?,
+            WIRE_TYPE_LENGTH_DELIMITED => {
+                let len = decode_varint(&mut msg).map_err(|err| invalid(&err))?;
+                let len = usize::try_from(len).map_err(|err| invalid(&err))?;
+                if let Some(Some(subfields)) = selected {
+                    let nested = msg
+                        .get(..len)
+                        .ok_or_else(|| ProjectionError::InvalidMessage("truncated field".into()))?;
+                    let mut projected = Vec::with_capacity(nested.len());
+                    project_protobuf(subfields, nested, &mut projected)?;
+                    encode_varint(key, out);
+                    encode_varint(projected.len() as u64, out);
+                    out.extend_from_slice(&projected);
+                    msg = &msg[len..];
+                    continue;
+                }
+                skip(&mut msg, len)?;
+            }
+            wire_type => {
+                return Err(ProjectionError::InvalidMessage(format!(
+                    "unsupported wire type {wire_type}"
+                )));
+            }
+        }
+        if selected.is_some() {
+            out.extend_from_slice(&field[..field.len() - msg.len()]);
+        }
+    }
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use assert_matches::assert_matches;
+
+    use crate::messages::{PoseInFrame, Quaternion, SceneEntity, SceneUpdate, Timestamp, Vector3};
+    use crate::{ChannelBuilder, Context, Encode, Schema};
+
+    use super::*;
+
+    fn paths(paths: &[&str]) -> Vec<String> {
+        paths.iter().map(|p| p.to_string()).collect()
+    }
+
+    fn channel<T: Encode>(ctx: &Arc<Context>) -> Arc<RawChannel> {
+        ChannelBuilder::new("/test")
+            .context(ctx)
+            .message_encoding(T::get_message_encoding())
+            .schema(T::get_schema())
+            .build_raw()
+            .unwrap()
+    }
+
+    fn encode<T: Encode>(msg: &T) -> Vec<u8> {
+        let mut buf = Vec::new();
+        msg.encode(&mut buf).unwrap();
+        buf
+    }
+
+    fn pose() -> PoseInFrame {
+        PoseInFrame {
+            timestamp: Some(Timestamp::new(10, 20)),
+            frame_id: "map".into(),
+            pose: Some(crate::messages::Pose {
+                position: Some(Vector3 {
+                    x: 1.0,
+                    y: 2.0,
+                    z: 3.0,
+                }),
+                orientation: Some(Quaternion {
+                    x: 0.0,
+                    y: 0.0,
+                    z: 0.0,
+                    w: 1.0,
+                }),
+            }),
+        }
+    }
+
+    #[test]
+    fn test_parse_field_tree() {
+        let tree = FieldTree::parse(&paths(&["a.b", "a.c", "d", "d.e"])).unwrap();
+        let a = tree.0["a"].as_ref().unwrap();
+        assert_eq!(a.0.keys().collect::<Vec<_>>(), ["b", "c"]);
+        // A field selected whole ignores its subfields.
+        assert_eq!(tree.0["d"], None);
+
+        assert_matches!(FieldTree::parse(&[]), Err(ProjectionError::InvalidPath(_)));
+        assert_matches!(
+            FieldTree::parse(&paths(&["a..b"])),
+            Err(ProjectionError::InvalidPath(_))
+        );
+    }
+
+    #[test]
+    fn test_project_protobuf() {
+        let ctx = Context::new();
+        let channel = channel::<PoseInFrame>(&ctx);
+        let projections = Projections::default();
+        let projection = projections
+            .get(&channel, &paths(&["frame_id", "pose.position"]))
+            .unwrap();
+
+        let projected = projection.project(&encode(&pose())).unwrap();
+        let decoded = PoseInFrame::decode(projected).unwrap();
+        let expected = PoseInFrame {
+            timestamp: None,
+            frame_id: "map".into(),
+            pose: Some(crate::messages::Pose {
+                position: pose().pose.unwrap().position,
+                orientation: None,
+            }),
+        };
+        assert_eq!(decoded, expected);
+
+        // The same fields share a projection.
+        let again = projections
+            .get(&channel, &paths(&["pose.position", "frame_id"]))
+            .unwrap();
+        assert!(Arc::ptr_eq(&projection, &again));
+        let other = projections.get(&channel, &paths(&["frame_id"])).unwrap();
+        assert!(!Arc::ptr_eq(&projection, &other));
+    }
+
+    #[test]
+    fn test_project_protobuf_repeated() {
+        let ctx = Context::new();
+        let channel = channel::<SceneUpdate>(&ctx);
+        let projection = Projections::default()
+            .get(&channel, &paths(&["entities.id"]))
+            .unwrap();
+
+        let entity = |id: &str| SceneEntity {
+            id: id.into(),
+            frame_id: "map".into(),
+            ..Default::default()
+        };
+        let update = SceneUpdate {
+            entities: vec![entity("a"), entity("b")],
+            ..Default::default()
+        };
+        let decoded = SceneUpdate::decode(projection.project(&encode(&update)).unwrap()).unwrap();
+        let ids: Vec<_> = decoded.entities.iter().map(|e| e.id.as_str()).collect();
+        assert_eq!(ids, ["a", "b"]);
+        assert!(decoded.entities.iter().all(|e| e.frame_id.is_empty()));
+    }
+
+    #[test]
+    fn test_project_protobuf_errors() {
+        let ctx = Context::new();
+        let channel = channel::<PoseInFrame>(&ctx);
+        let projections = Projections::default();
+        assert_matches!(
+            projections.get(&channel, &paths(&["missing"])),
+            Err(ProjectionError::UnknownField { .. })
+        );
+        assert_matches!(
+            projections.get(&channel, &paths(&["frame_id.x"])),
+            Err(ProjectionError::NotAMessage(_))
+        );
+
+        let projection = projections.get(&channel, &paths(&["frame_id"])).unwrap();
+        let msg = encode(&pose());
+        assert_matches!(
+            projection.project(&msg[..msg.len() - 1]),
+            Err(ProjectionError::InvalidMessage(_))
+        );
+    }
+
+    #[test]
+    fn test_project_json() {
+        let ctx = Context::new();
+        let channel = ChannelBuilder::new("/json")
+            .context(&ctx)
+            .message_encoding("json")
+            .build_raw()
+            .unwrap();
+        let projection = Projections::default()
+            .get(&channel, &paths(&["pose.position", "points.x", "missing"]))
+            .unwrap();
+        let msg = br#"{
+            "timestamp": 1,
+            "pose": {"position": {"x": 1, "y": 2}, "orientation": {"w": 1}},
+            "points": [{"x": 1, "y": 2}, {"x": 3, "y": 4}]
+        }"#;
+        let projected: serde_json::Value =
+            serde_json::from_slice(&projection.project(msg).unwrap()).unwrap();
+        assert_eq!(
+            projected,
+            serde_json::json!({
+                "pose": {"position": {"x": 1, "y": 2}},
+                "points": [{"x": 1}, {"x": 3}]
+            })
+        );
+    }
+
+    #[test]
+    fn test_unsupported_encoding() {
+        let ctx = Context::new();
+        let channel = ChannelBuilder::new("/ros")
+            .context(&ctx)
+            .message_encoding("ros1")
+            .schema(Schema::new("std_msgs/String", "ros1msg", b"string data"))
+            .build_raw()
+            .unwrap();
+        assert_matches!(
+            Projections::default().get(&channel, &paths(&["data"])),
+            Err(ProjectionError::UnsupportedEncoding(_))
+        );
+    }
+}
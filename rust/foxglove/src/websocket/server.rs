@@ -1,6 +1,7 @@
 use std::collections::HashSet;
 use std::collections::hash_map::Entry;
 use std::sync::Weak;
+use std::sync::atomic::{AtomicBool, Ordering};
 use std::time::{Duration, SystemTime, UNIX_EPOCH};
 use std::{collections::HashMap, net::SocketAddr, sync::Arc};
 
@@ -10,48 +11,88 @@ use futures_util::SinkExt;
 use tokio::net::{TcpListener, TcpStream};
 use tokio::runtime::Handle;
 use tokio::task::{JoinError, JoinSet};
-use tokio::time::MissedTickBehavior;
+use tokio::time::{Instant, MissedTickBehavior};
 use tokio_tungstenite::tungstenite::Message;
 use tokio_util::sync::CancellationToken;
 
 use crate::library_version::get_library_identifier;
+use crate::remote_common::fetch_asset::AssetCache;
 use crate::sink_channel_filter::SinkChannelFilter;
 use crate::websocket::connected_client::ShutdownReason;
 use crate::websocket::streams::{Acceptor, StreamConfiguration, TlsIdentity};
-use crate::{Context, FoxgloveError};
+use crate::{ChannelDescriptor, Context, FoxgloveError, MessageFilter, RawChannel};
 
+use super::backlog::{BacklogLimits, BatchLimits};
+use super::broadcast_limiter::{BroadcastLimiter, Offer};
 use super::connected_client::ConnectedClient;
 use super::cow_vec::CowVec;
+use super::parameter_store::ParameterStore;
+use super::projection::{Projection, ProjectionError, Projections};
 use super::service::{Service, ServiceId, ServiceMap};
-use super::ws_protocol::server::PlaybackState;
+#[cfg(feature = "websocket-video")]
+use super::video::{VideoChannel, VideoChannels, VideoEncoderFactory};
 use super::ws_protocol::server::{
-    AdvertiseServices, RemoveStatus, ServerInfo, UnadvertiseServices,
+    AdvertiseServices, PlaybackState, RemoveStatus, ServerInfo, Time, UnadvertiseServices,
 };
 use super::{
-    AssetHandler, Capability, ClientId, ConnectionGraph, Parameter, ParameterHandler,
-    ServerListener, Status, advertise, handshake,
+    AssetHandler, BacklogDropPolicy, Capability, ClientId, ClientStats, ConnectionGraph,
+    ConnectionGraphPatch, Parameter, ParameterHandler, ServerListener, Status, SubscriptionOptions,
+    advertise, handshake,
 };
 
 // Queue up to 1024 messages per connected client before dropping messages
 // Can be overridden by ServerOptions::message_backlog_size.
 const DEFAULT_MESSAGE_BACKLOG_SIZE: usize = 1024;
 
+/// The server info metadata key under which the server hands the token of a
+/// [`SharedMemorySink`][crate::SharedMemorySink] to its clients.
+pub const SHARED_MEMORY_SERVER_INFO_KEY: &str = "fg-shm";
+
+// Schemas of messages which are already compressed, and are not compressed again by default.
+const PRECOMPRESSED_SCHEMAS: &[&str] = &[
+    "foxglove.CompressedImage",
+    "foxglove.CompressedVideo",
+    "sensor_msgs/msg/CompressedImage",
+    "sensor_msgs/CompressedImage",
+];
+
 #[derive(Default)]
 pub(crate) struct ServerOptions {
     pub session_id: Option<String>,
     pub name: Option<String>,
     pub message_backlog_size: Option<usize>,
+    pub message_backlog_bytes: Option<usize>,
+    pub channel_backlog_bytes: Option<usize>,
+    pub backlog_drop_policy: BacklogDropPolicy,
+    pub subscription_options: SubscriptionOptions,
     pub listener: Option<Arc<dyn ServerListener>>,
     pub capabilities: Option<IndexSet<Capability>>,
     pub services: HashMap<String, Service>,
     pub supported_encodings: Option<IndexSet<String>>,
     pub runtime: Option<Handle>,
     pub fetch_asset_handler: Option<Arc<dyn AssetHandler>>,
+    pub fetch_asset_cache_bytes: Option<usize>,
+    pub parameter_coalesce_window: Option<Duration>,
+    pub connection_graph_coalesce_window: Option<Duration>,
+    pub broadcast_coalesce_window: Option<Duration>,
     pub parameter_handler: Option<Arc<dyn ParameterHandler>>,
     pub tls_identity: Option<TlsIdentity>,
+    pub kernel_tls: bool,
     pub channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+    pub message_filter: Option<Arc<dyn MessageFilter>>,
+    pub compression: bool,
+    pub compression_filter: Option<Arc<dyn SinkChannelFilter>>,
+    pub message_batch_linger: Option<Duration>,
+    pub message_batch_bytes: Option<usize>,
+    #[cfg(feature = "websocket-video")]
+    pub video_encoder_factory: Option<Arc<dyn VideoEncoderFactory>>,
+    #[cfg(feature = "websocket-video")]
+    pub video_transcode_filter: Option<Arc<dyn SinkChannelFilter>>,
     pub server_info: Option<HashMap<String, String>>,
+    pub shared_memory_token: Option<String>,
     pub playback_time_range: Option<(u64, u64)>,
+    pub writer_threads: Option<usize>,
+    pub reuse_port: bool,
 }
 
 impl std::fmt::Debug for ServerOptions {
@@ -60,14 +101,67 @@ impl std::fmt::Debug for ServerOptions {
             .field("session_id", &self.session_id)
             .field("name", &self.name)
             .field("message_backlog_size", &self.message_backlog_size)
+            .field("message_backlog_bytes", &self.message_backlog_bytes)
+            .field("channel_backlog_bytes", &self.channel_backlog_bytes)
+            .field("backlog_drop_policy", &self.backlog_drop_policy)
+            .field("subscription_options", &self.subscription_options)
+            .field("compression", &self.compression)
+            .field("message_batch_linger", &self.message_batch_linger)
+            .field("message_batch_bytes", &self.message_batch_bytes)
             .field("services", &self.services)
             .field("capabilities", &self.capabilities)
             .field("supported_encodings", &self.supported_encodings)
             .field("server_info", &self.server_info)
+            .field("writer_threads", &self.writer_threads)
+            .field("reuse_port", &self.reuse_port)
+            .field("fetch_asset_cache_bytes", &self.fetch_asset_cache_bytes)
+            .field("parameter_coalesce_window", &self.parameter_coalesce_window)
+            .field(
+                "connection_graph_coalesce_window",
+                &self.connection_graph_coalesce_window,
+            )
+            .field("broadcast_coalesce_window", &self.broadcast_coalesce_window)
             .finish()
     }
 }
 
+/// Binds a listener which shares its address with other listeners bound with `SO_REUSEPORT`.
+///
+/// The kernel distributes incoming connections across the listeners.
+async fn bind_reuse_port(addr: &str) -> std::io::Result<TcpListener> {
+    #[cfg(unix)]
+    {
+        let mut last_err = None;
+        for addr in tokio::net::lookup_host(addr).await? {
+            let socket = if addr.is_ipv4() {
+                tokio::net::TcpSocket::new_v4()?
+            } else {
+                tokio::net::TcpSocket::new_v6()?
+            };
+            socket.set_reuseaddr(true)?;
+            socket.set_reuseport(true)?;
+            match socket.bind(addr) {
+                Ok(()) => return socket.listen(1024),
+                Err(err) => last_err = Some(err),
+            }
+        }
+        Err(last_err.unwrap_or_else(|| {
+            std::io::Error::new(
+                std::io::ErrorKind::InvalidInput,
+                "could not resolve to any address",
+            )
+        }))
+    }
+    #[cfg(not(unix))]
+    {
+        let _ = addr;
+        Err(std::io::Error::new(
+            std::io::ErrorKind::Unsupported,
+            "SO_REUSEPORT is not supported on this platform",
+        ))
+    }
+}
+
 /// Processes a task result, warning about panics.
 fn process_task_result(result: Result<(), JoinError>) {
     match result {
@@ -145,13 +239,49 @@ pub(crate) fn create_server(
     }
 
     // TLS configuration is fallible, so build it prior to allocating the Arc with the weak ref
-    let stream_config = StreamConfiguration::new(opts.tls_identity.as_ref())?;
+    let stream_config = StreamConfiguration::new(opts.tls_identity.as_ref(), opts.kernel_tls)?;
+    let writer_runtime = opts.writer_threads.map(WriterRuntime::new).transpose()?;
 
     Ok(Arc::new_cyclic(|weak_self| {
-        Server::new(weak_self.clone(), ctx, opts, stream_config)
+        Server::new(weak_self.clone(), ctx, opts, stream_config, writer_runtime)
     }))
 }
 
+/// A dedicated runtime for client connections, created when
+/// [`ServerOptions::writer_threads`] is set.
+///
+/// Each client's connection is a task which serializes and writes its queued messages, so with
+/// many clients the writes proceed in parallel across the runtime's threads. The server also
+/// accepts connections on this runtime.
+struct WriterRuntime(Option<tokio::runtime::Runtime>);
+
+impl WriterRuntime {
+    fn new(threads: usize) -> Result<Self, FoxgloveError> {
+        let mut builder = tokio::runtime::Builder::new_multi_thread();
+        builder
+            .worker_threads(threads)
+            .thread_name("foxglove-ws-writer")
+            .enable_all();
+        crate::runtime::runtime_options().configure(&mut builder);
+        let runtime = builder.build()?;
+        Ok(Self(Some(runtime)))
+    }
+
+    fn handle(&self) -> Option<&Handle> {
+        self.0.as_ref().map(|runtime| runtime.handle())
+    }
+}
+
+impl Drop for WriterRuntime {
+    fn drop(&mut self) {
+        // The server may be dropped from an async context, where a runtime cannot be dropped
+        // while blocking on its tasks.
+        if let Some(runtime) = self.0.take() {
+            runtime.shutdown_background();
+        }
+    }
+}
+
 /// A WebSocket server that implements the Foxglove WebSocket Protocol
 pub(crate) struct Server {
     /// A weak reference to the Arc holding the server.
@@ -161,7 +291,10 @@ pub(crate) struct Server {
     /// It's analogous to the mixin shared_from_this in C++.
     weak_self: Weak<Self>,
     context: Weak<Context>,
-    message_backlog_size: u32,
+    /// Limits on the data plane backlog of each client.
+    backlog_limits: BacklogLimits,
+    /// Limits on the message batches sent to clients which enabled them.
+    batch_limits: BatchLimits,
     runtime: Handle,
     /// May be provided by the caller
     session_id: parking_lot::RwLock<String>,
@@ -169,32 +302,66 @@ pub(crate) struct Server {
     clients: CowVec<Arc<ConnectedClient>>,
     /// Channel subscription filter
     channel_filter: Option<Arc<dyn SinkChannelFilter>>,
+    /// Filter for messages logged to clients, shared by all clients.
+    message_filter: Option<Arc<dyn MessageFilter>>,
+    /// Whether to negotiate the permessage-deflate extension with clients.
+    compression: bool,
+    /// Selects the channels whose messages are compressed.
+    compression_filter: Option<Arc<dyn SinkChannelFilter>>,
     /// Callbacks for handling client messages, etc.
     listener: Option<Arc<dyn ServerListener>>,
     /// Capabilities advertised to clients
     capabilities: IndexSet<Capability>,
+    /// Field projections requested by clients, unused unless the "fieldProjection" capability is
+    /// set.
+    projections: Projections,
+    /// Video channels derived from image channels, if video transcoding is enabled.
+    #[cfg(feature = "websocket-video")]
+    video_channels: Option<VideoChannels>,
     /// Parameters subscribed to by clients
     subscribed_parameters: parking_lot::RwLock<HashMap<String, HashSet<ClientId>>>,
+    /// Published parameter values, and the values sent to each client. Locked before
+    /// `subscribed_parameters`.
+    parameter_store: parking_lot::Mutex<ParameterStore>,
+    /// How long to collect published parameter values before sending them, if at all.
+    parameter_coalesce_window: Option<Duration>,
     /// Encodings server can accept from clients. Ignored unless the "clientPublish" capability is set.
     supported_encodings: IndexSet<String>,
     /// The current connection graph, unused unless the "connectionGraph" capability is set.
     connection_graph: parking_lot::Mutex<ConnectionGraph>,
+    /// How long to collect connection graph changes before sending them, if at all.
+    connection_graph_coalesce_window: Option<Duration>,
+    /// Whether a connection graph update is scheduled. Only accessed with `connection_graph`
+    /// locked.
+    connection_graph_flush_scheduled: AtomicBool,
+    /// Limits time broadcasts to one per coalescing window, if configured.
+    time_limiter: Option<parking_lot::Mutex<BroadcastLimiter<Time>>>,
+    /// Limits playback state broadcasts to one per coalescing window, if configured.
+    playback_state_limiter: Option<parking_lot::Mutex<BroadcastLimiter<PlaybackState>>>,
     /// Token for cancelling all tasks
     cancellation_token: CancellationToken,
     /// Registered services.
     services: parking_lot::RwLock<ServiceMap>,
     /// Handler for fetch asset requests
     fetch_asset_handler: Option<Arc<dyn AssetHandler>>,
+    /// Cache of successful fetch asset responses, if configured.
+    asset_cache: Option<Arc<AssetCache>>,
     /// Handler for client parameter operations. When set, takes precedence over the deprecated
     /// parameter callbacks on [`ServerListener`].
     parameter_handler: Option<Arc<dyn ParameterHandler>>,
     /// Client tasks.
     tasks: parking_lot::Mutex<Option<JoinSet<()>>>,
+    /// Dedicated runtime for client tasks, if configured.
+    writer_runtime: Option<WriterRuntime>,
+    /// Whether the listener is bound with `SO_REUSEPORT`.
+    reuse_port: bool,
     /// Configuration to support TLS streams when enabled.
     stream_config: StreamConfiguration,
     /// Information about the server, which is shared with clients.
     /// Keys prefixed with "fg-" are reserved for internal use.
     server_info: HashMap<String, String>,
+    /// Token of a shared-memory sink which local clients may read from.
+    shared_memory_token: Option<String>,
     /// Time range of data being played back, in absolute nanoseconds.
     /// Implies the [`PlaybackControl`](crate::websocket::Capability::PlaybackControl) capability if set.
     playback_time_range: Option<(u64, u64)>,
@@ -215,6 +382,7 @@ impl Server {
         ctx: &Arc<Context>,
         opts: ServerOptions,
         stream_config: StreamConfiguration,
+        writer_runtime: Option<WriterRuntime>,
     ) -> Self {
         let mut capabilities = opts.capabilities.unwrap_or_default();
         let mut supported_encodings = opts.supported_encodings.unwrap_or_default();
@@ -254,13 +422,28 @@ impl Server {
         Server {
             weak_self,
             context: Arc::downgrade(ctx),
-            message_backlog_size: opts
-                .message_backlog_size
-                .unwrap_or(DEFAULT_MESSAGE_BACKLOG_SIZE) as u32,
+            backlog_limits: BacklogLimits {
+                messages: opts
+                    .message_backlog_size
+                    .unwrap_or(DEFAULT_MESSAGE_BACKLOG_SIZE),
+                bytes: opts.message_backlog_bytes,
+                channel_bytes: opts.channel_backlog_bytes,
+                policy: opts.backlog_drop_policy,
+                subscription: opts.subscription_options,
+            },
+            batch_limits: BatchLimits {
+                linger: opts.message_batch_linger.unwrap_or_default(),
+                bytes: opts
+                    .message_batch_bytes
+                    .unwrap_or_else(|| BatchLimits::default().bytes),
+            },
             runtime: opts
                 .runtime
                 .unwrap_or_else(crate::runtime::get_runtime_handle),
             channel_filter: opts.channel_filter.clone(),
+            message_filter: opts.message_filter,
+            compression: opts.compression,
+            compression_filter: opts.compression_filter,
             listener: opts.listener,
             session_id: parking_lot::RwLock::new(
                 opts.session_id.unwrap_or_else(Self::generate_session_id),
@@ -268,16 +451,37 @@ impl Server {
             name: opts.name.unwrap_or_default(),
             clients: CowVec::new(),
             subscribed_parameters: parking_lot::RwLock::default(),
+            parameter_store: parking_lot::Mutex::default(),
+            parameter_coalesce_window: opts.parameter_coalesce_window,
             capabilities,
+            projections: Projections::default(),
+            #[cfg(feature = "websocket-video")]
+            video_channels: opts
+                .video_encoder_factory
+                .map(|factory| VideoChannels::new(factory, opts.video_transcode_filter)),
             supported_encodings,
             connection_graph: parking_lot::Mutex::default(),
+            connection_graph_coalesce_window: opts.connection_graph_coalesce_window,
+            connection_graph_flush_scheduled: AtomicBool::new(false),
+            time_limiter: opts
+                .broadcast_coalesce_window
+                .map(|window| parking_lot::Mutex::new(BroadcastLimiter::new(window))),
+            playback_state_limiter: opts
+                .broadcast_coalesce_window
+                .map(|window| parking_lot::Mutex::new(BroadcastLimiter::new(window))),
             cancellation_token: CancellationToken::new(),
             services: parking_lot::RwLock::new(ServiceMap::from_iter(opts.services.into_values())),
             fetch_asset_handler: opts.fetch_asset_handler,
+            asset_cache: opts
+                .fetch_asset_cache_bytes
+                .map(|budget| Arc::new(AssetCache::new(budget))),
             parameter_handler: opts.parameter_handler,
             tasks: parking_lot::Mutex::default(),
+            writer_runtime,
+            reuse_port: opts.reuse_port,
             stream_config,
             server_info: opts.server_info.unwrap_or_default(),
+            shared_memory_token: opts.shared_memory_token,
             playback_time_range: opts.playback_time_range,
         }
     }
@@ -293,6 +497,40 @@ impl Server {
         self.capabilities.contains(&cap)
     }
 
+    /// Returns the projection of the channel's messages onto the given fields, shared with other
+    /// clients which requested the same fields.
+    pub(super) fn projection(
+        &self,
+        channel: &RawChannel,
+        fields: &[String],
+    ) -> Result<Arc<Projection>, ProjectionError> {
+        self.projections.get(channel, fields)
+    }
+
+    /// Returns the video channel derived from the image channel, shared with other clients.
+    ///
+    /// Returns None if video transcoding is disabled, or if the channel is not transcoded.
+    #[cfg(feature = "websocket-video")]
+    pub(super) fn video_channel(&self, channel: &Arc<RawChannel>) -> Option<Arc<VideoChannel>> {
+        let video_channels = self.video_channels.as_ref()?;
+        let context = self.context.upgrade()?;
+        video_channels.get(channel, &context, &self.runtime)
+    }
+
+    /// Returns true if messages logged to the channel are compressed, for clients which negotiated
+    /// compression.
+    ///
+    /// Without a compression filter, channels with schemas for data which is already compressed,
+    /// such as video, are not compressed.
+    pub(super) fn compresses_channel(&self, channel: &ChannelDescriptor) -> bool {
+        match &self.compression_filter {
+            Some(filter) => filter.should_subscribe(channel),
+            None => !channel
+                .schema()
+                .is_some_and(|schema| PRECOMPRESSED_SCHEMAS.contains(&schema.name.as_str())),
+        }
+    }
+
     /// Returns true if the server supports the encoding.
     pub(super) fn supports_encoding(&self, encoding: impl AsRef<str>) -> bool {
         self.supported_encodings.contains(encoding.as_ref())
@@ -303,6 +541,11 @@ impl Server {
         self.fetch_asset_handler.as_deref()
     }
 
+    /// Returns the cache of fetched assets, if configured.
+    pub(super) fn asset_cache(&self) -> Option<&Arc<AssetCache>> {
+        self.asset_cache.as_ref()
+    }
+
     /// Returns a reference to the parameter handler, if registered.
     pub(super) fn parameter_handler(&self) -> Option<&dyn ParameterHandler> {
         self.parameter_handler.as_deref()
@@ -324,14 +567,23 @@ impl Server {
         }
 
         let addr = format!("{host}:{port}");
-        let listener = TcpListener::bind(&addr)
-            .await
-            .map_err(FoxgloveError::Bind)?;
+        let listener = if self.reuse_port {
+            bind_reuse_port(&addr).await
+        } else {
+            TcpListener::bind(&addr).await
+        }
+        .map_err(FoxgloveError::Bind)?;
         let local_addr = listener.local_addr().map_err(FoxgloveError::Bind)?;
 
+        // With a dedicated runtime, connections are accepted there too, so that all of the
+        // server's network I/O stays off the shared runtime.
+        let runtime = match self.writer_runtime.as_ref().and_then(WriterRuntime::handle) {
+            Some(handle) => handle.clone(),
+            None => self.runtime.clone(),
+        };
         let cancellation_token = self.cancellation_token.clone();
         let server = self.arc();
-        self.runtime.spawn(async move {
+        runtime.spawn(async move {
             tokio::select! {
                 () = server.clone().accept_connections(listener) => (),
                 () = server.clone().reap_completed_tasks() => (),
@@ -353,7 +605,11 @@ impl Server {
     async fn accept_connections(self: Arc<Self>, listener: TcpListener) {
         while let Ok((stream, addr)) = listener.accept().await {
             if let Some(tasks) = self.tasks.lock().as_mut() {
-                tasks.spawn(self.clone().handle_connection(stream, addr));
+                let task = self.clone().handle_connection(stream, addr);
+                match self.writer_runtime.as_ref().and_then(WriterRuntime::handle) {
+                    Some(handle) => tasks.spawn_on(task, handle),
+                    None => tasks.spawn(task),
+                };
             } else {
                 break;
             }
@@ -400,20 +656,23 @@ impl Server {
         self.clients.get().len()
     }
 
+    /// Returns the delivery counters of each connected client.
+    pub fn stats(&self) -> Vec<ClientStats> {
+        self.clients
+            .get()
+            .iter()
+            .map(|client| client.stats())
+            .collect()
+    }
+
     /// Publish the current timestamp to all clients.
     pub fn broadcast_time(&self, timestamp: u64) {
-        use super::ws_protocol::server::Time;
-
         if !self.has_capability(Capability::Time) {
             tracing::error!("Server does not support time capability");
             return;
         }
 
-        let message = Time::new(timestamp);
-        let clients = self.clients.get();
-        for client in clients.iter() {
-            client.send_control_msg(&message);
-        }
+        self.broadcast_latest(|server| server.time_limiter.as_ref(), Time::new(timestamp));
     }
 
     /// Publish the current playback state to all clients.
@@ -423,8 +682,56 @@ impl Server {
             return;
         }
 
+        self.broadcast_latest(
+            |server| server.playback_state_limiter.as_ref(),
+            playback_state,
+        );
+    }
+
+    /// Sends a control message to all clients, or, if the server has a broadcast coalescing
+    /// window, at most once per window.
+    ///
+    /// Messages within the window replace one another, and the latest is sent at the end of the
+    /// window, from the server's runtime.
+    fn broadcast_latest<T>(
+        &self,
+        limiter: fn(&Self) -> Option<&parking_lot::Mutex<BroadcastLimiter<T>>>,
+        message: T,
+    ) where
+        T: Send + 'static,
+        for<'a> &'a T: Into<Message>,
+    {
+        let Some(state) = limiter(self) else {
+            self.broadcast_control_msg(&message);
+            return;
+        };
+        let deadline = match state.lock().offer(message, Instant::now()) {
+            Offer::Send(message) => {
+                self.broadcast_control_msg(&message);
+                return;
+            }
+            Offer::Schedule(deadline) => deadline,
+            Offer::Pending => return,
+        };
+        let server = self.weak_self.clone();
+        self.runtime.spawn(async move {
+            tokio::time::sleep_until(deadline).await;
+            let Some(server) = server.upgrade() else {
+                return;
+            };
+            let message = limiter(&server).and_then(|state| state.lock().take(Instant::now()));
+            if let Some(message) = message {
+                server.broadcast_control_msg(&message);
+            }
+        });
+    }
+
+    fn broadcast_control_msg<T>(&self, message: &T)
+    where
+        for<'a> &'a T: Into<Message>,
+    {
         for client in self.clients.get().iter() {
-            client.send_control_msg(&playback_state);
+            client.send_control_msg(message);
         }
     }
 
@@ -455,6 +762,7 @@ impl Server {
 
     /// Removes client parameter subscriptions by parameter name.
     pub(super) fn unsubscribe_parameters(&self, client_id: ClientId, names: Vec<String>) {
+        self.parameter_store.lock().unsubscribe(client_id, &names);
         let mut subs = self.subscribed_parameters.write();
 
         // Update subscriptions, keeping track of params that now have no subscribers.
@@ -478,6 +786,7 @@ impl Server {
 
     /// Removes all client parameter subscriptions.
     fn unsubscribe_all_parameters(&self, client_id: ClientId) {
+        self.parameter_store.lock().remove_client(client_id);
         let mut subs = self.subscribed_parameters.write();
 
         // Update subscriptions, keeping track of params that now have no subscribers.
@@ -538,30 +847,46 @@ impl Server {
     }
 
     /// Publish parameter values to all subscribed clients.
+    ///
+    /// Each client is only sent the values which it has not already been sent. If a coalescing
+    /// window is configured, values are collected until the end of the window, and only the
+    /// latest value of each parameter is sent.
     pub fn publish_parameter_values(&self, parameters: Vec<Parameter>) {
         if !self.has_capability(Capability::Parameters) {
             tracing::error!("Server does not support parameters capability");
             return;
         }
 
-        let clients = self.clients.get();
-        for client in clients.iter() {
-            // Filter parameters by subscriptions.
-            let filtered: Vec<_> = {
-                let subs = self.subscribed_parameters.read();
-                parameters
-                    .iter()
-                    .filter(|p| {
-                        subs.get(&p.name)
-                            .is_some_and(|ids| ids.contains(&client.id()))
-                    })
-                    .cloned()
-                    .collect()
-            };
+        let mut store = self.parameter_store.lock();
+        store.update(parameters);
+        let Some(window) = self.parameter_coalesce_window else {
+            self.flush_parameters(&mut store);
+            return;
+        };
+        if store.flush_scheduled {
+            return;
+        }
+        store.flush_scheduled = true;
+        let server = self.weak_self.clone();
+        self.runtime.spawn(async move {
+            tokio::time::sleep(window).await;
+            if let Some(server) = server.upgrade() {
+                let mut store = server.parameter_store.lock();
+                store.flush_scheduled = false;
+                server.flush_parameters(&mut store);
+            }
+        });
+    }
 
-            // Notify client.
-            if !filtered.is_empty() {
-                client.update_parameters(filtered, None);
+    /// Sends the parameter values published since the last flush to subscribed clients.
+    fn flush_parameters(&self, store: &mut ParameterStore) {
+        let mut updates = store.flush(&self.subscribed_parameters.read());
+        if updates.is_empty() {
+            return;
+        }
+        for client in self.clients.get().iter() {
+            if let Some(parameters) = updates.remove(&client.id()) {
+                client.update_parameters(parameters, None);
             }
         }
     }
@@ -590,6 +915,9 @@ impl Server {
             tracing::warn!("Overwriting reserved server_info key 'fg-library'");
         }
         metadata.insert("fg-library".into(), get_library_identifier());
+        if let Some(token) = &self.shared_memory_token {
+            metadata.insert(SHARED_MEMORY_SERVER_INFO_KEY.into(), token.clone());
+        }
 
         ServerInfo::new(&self.name)
             .with_capabilities(
@@ -632,7 +960,8 @@ impl Server {
             }
         };
 
-        let Ok(mut ws_stream) = handshake::do_handshake(stream).await else {
+        let Ok((mut ws_stream, deflate)) = handshake::do_handshake(stream, self.compression).await
+        else {
             tracing::error!("Dropping client {addr}: handshake failed");
             return;
         };
@@ -649,8 +978,11 @@ impl Server {
             &self.weak_self,
             ws_stream,
             addr,
-            self.message_backlog_size as usize,
+            self.backlog_limits,
+            self.batch_limits,
+            deflate,
             self.channel_filter.clone(),
+            self.message_filter.clone(),
         );
         self.register_client_and_advertise(&client);
         client.run().await;
@@ -845,15 +1177,68 @@ impl Server {
             return Err(FoxgloveError::ConnectionGraphNotSupported);
         }
 
-        // Hold the lock while sending to synchronize with subscribe and unsubscribe.
         let mut graph = self.connection_graph.lock();
-        let msg = graph.update(replacement_graph);
+        graph.replace(replacement_graph);
+        self.publish_connection_graph_changes(&mut graph);
+        Ok(())
+    }
+
+    /// Applies a patch to the connection graph, and sends the changes to all clients.
+    pub fn update_connection_graph(
+        &self,
+        patch: ConnectionGraphPatch,
+    ) -> Result<(), FoxgloveError> {
+        if !self.has_capability(Capability::ConnectionGraph) {
+            return Err(FoxgloveError::ConnectionGraphNotSupported);
+        }
+
+        let mut graph = self.connection_graph.lock();
+        graph.apply(patch);
+        self.publish_connection_graph_changes(&mut graph);
+        Ok(())
+    }
+
+    /// Sends the connection graph changes to subscribed clients, now or at the end of the
+    /// coalescing window.
+    fn publish_connection_graph_changes(&self, graph: &mut ConnectionGraph) {
+        let Some(window) = self.connection_graph_coalesce_window else {
+            self.flush_connection_graph(graph);
+            return;
+        };
+        if !graph.has_changes()
+            || self
+                .connection_graph_flush_scheduled
+                .swap(true, Ordering::Relaxed)
+        {
+            return;
+        }
+        let server = self.weak_self.clone();
+        self.runtime.spawn(async move {
+            tokio::time::sleep(window).await;
+            if let Some(server) = server.upgrade() {
+                let mut graph = server.connection_graph.lock();
+                server
+                    .connection_graph_flush_scheduled
+                    .store(false, Ordering::Relaxed);
+                server.flush_connection_graph(&mut graph);
+            }
+        });
+    }
+
+    /// Sends the connection graph changes since the last update to subscribed clients.
+    ///
+    /// The caller holds the graph's lock while sending, to synchronize with subscribe and
+    /// unsubscribe.
+    fn flush_connection_graph(&self, graph: &mut ConnectionGraph) {
+        if !graph.has_changes() {
+            return;
+        }
+        let msg = graph.take_update();
         for client in self.clients.get().iter() {
             if graph.is_subscriber(client.id()) {
                 client.send_control_msg(&msg);
             }
         }
-        Ok(())
     }
 
     pub(crate) fn is_tls_configured(&self) -> bool {
@@ -1,4 +1,6 @@
-use super::{ChannelView, Client, ClientChannel, Parameter};
+use bytes::Bytes;
+
+use super::{ChannelView, Client, ClientChannel, ClientStats, Parameter};
 use crate::websocket::PlaybackControlRequest;
 use crate::websocket::PlaybackState;
 
@@ -15,6 +17,20 @@ use crate::websocket::PlaybackState;
 pub trait ServerListener: Send + Sync {
     /// Callback invoked when a client message is received.
     fn on_message_data(&self, _client: Client, _client_channel: &ClientChannel, _payload: &[u8]) {}
+    /// Callback invoked when a client message is received, with a reference-counted payload.
+    ///
+    /// The payload shares the buffer the message was received into, so a listener can retain it
+    /// (for example, to hand it to another thread) without copying it.
+    ///
+    /// The default implementation calls [`Self::on_message_data`].
+    fn on_message_data_shared(
+        &self,
+        client: Client,
+        client_channel: &ClientChannel,
+        payload: Bytes,
+    ) {
+        self.on_message_data(client, client_channel, &payload);
+    }
     /// Callback invoked when a client subscribes to a channel.
     /// Only invoked if the channel is associated with the server and isn't already subscribed to by the client.
     fn on_subscribe(&self, _client: Client, _channel: ChannelView) {}
@@ -87,6 +103,16 @@ pub trait ServerListener: Send + Sync {
     fn on_client_connect(&self) {}
     /// Callback invoked when a client disconnects from the server.
     fn on_client_disconnect(&self) {}
+    /// Callback invoked when messages are dropped from a client's backlog because the client
+    /// can't keep up with the rate at which messages are logged.
+    ///
+    /// `stats` holds the client's delivery counters at the time of the call. The callback is
+    /// invoked at most once per [`BACKPRESSURE_INTERVAL`][super::BACKPRESSURE_INTERVAL] for each
+    /// client, so the counters may include drops since the previous call.
+    ///
+    /// Unlike the other callbacks, this is invoked from the thread which logged the message that
+    /// overflowed the backlog.
+    fn on_backpressure(&self, _client: Client, _stats: &ClientStats) {}
 
     /// Callback invoked when a client sends a playback control request.
     /// Requires [`Capability::PlaybackControl`][super::Capability::PlaybackControl].
@@ -11,8 +11,8 @@ use crate::websocket::ws_protocol::server::{ServiceCallFailure, ServiceCallRespo
 
 // Re-export all public types from the common service module.
 pub use crate::remote_common::service::{
-    CallId, ClientId, Handler, Request, Responder, Service, ServiceBuilder, ServiceSchema,
-    SyncHandler,
+    CallId, ClientId, Handler, Request, Responder, Service, ServiceBuilder, ServiceExecutor,
+    ServiceSchema, SyncHandler,
 };
 pub(crate) use crate::remote_common::service::{ServiceId, ServiceMap};
 
@@ -43,6 +43,10 @@ impl crate::remote_common::service::ResponseSender for ResponseSender {
         // Callee logs errors.
         let _ = self.client.send_control_msg(message);
     }
+
+    fn is_cancelled(&self) -> bool {
+        self.client.is_disconnected()
+    }
 }
 
 /// Creates a new [`Responder`] backed by a WebSocket connection.
@@ -0,0 +1,83 @@
+//! Delivery statistics for the clients of a WebSocket server.
+
+use std::time::Duration;
+
+use crate::ChannelId;
+use crate::remote_common::ClientId;
+
+/// The minimum interval between calls to
+/// [`ServerListener::on_backpressure`][super::ServerListener::on_backpressure] for a client.
+pub const BACKPRESSURE_INTERVAL: Duration = Duration::from_millis(100);
+
+/// Delivery counters for the messages logged to one of a client's subscribed channels.
+///
+/// Counters start when the client subscribes to the channel, and are reset if it unsubscribes.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[non_exhaustive]
+pub struct ChannelStats {
+    /// The channel ID.
+    pub channel_id: ChannelId,
+    /// The number of messages logged to the channel for the client.
+    ///
+    /// This is the sequence number of the latest message. Every message is either sent, dropped,
+    /// conflated, or still queued.
+    pub sequence: u64,
+    /// The number of messages sent to the client.
+    pub sent: u64,
+    /// The number of messages dropped to keep the client's backlog within its limits.
+    pub dropped: u64,
+    /// The number of queued messages which were replaced by a newer message of the channel,
+    /// because the subscription is conflated.
+    pub conflated: u64,
+    /// The number of messages currently queued.
+    pub queued_messages: usize,
+    /// The number of bytes currently queued.
+    pub queued_bytes: usize,
+    /// The largest number of messages queued at once.
+    pub max_queued_messages: usize,
+    /// The largest number of bytes queued at once.
+    pub max_queued_bytes: usize,
+}
+
+impl ChannelStats {
+    pub(super) fn new(channel_id: ChannelId) -> Self {
+        Self {
+            channel_id,
+            sequence: 0,
+            sent: 0,
+            dropped: 0,
+            conflated: 0,
+            queued_messages: 0,
+            queued_bytes: 0,
+            max_queued_messages: 0,
+            max_queued_bytes: 0,
+        }
+    }
+}
+
+/// Delivery counters for the data plane messages queued for a client.
+///
+/// See [`WebSocketServerHandle::stats`][crate::WebSocketServerHandle::stats].
+#[derive(Debug, Clone, PartialEq, Eq)]
+#[non_exhaustive]
+pub struct ClientStats {
+    /// The client ID.
+    pub client_id: ClientId,
+    /// The number of messages sent to the client, including messages which were not logged to a
+    /// channel.
+    pub sent: u64,
+    /// The number of bytes sent to the client.
+    pub sent_bytes: u64,
+    /// The number of messages dropped to keep the client's backlog within its limits.
+    pub dropped: u64,
+    /// The number of messages currently queued.
+    pub queued_messages: usize,
+    /// The number of bytes currently queued.
+    pub queued_bytes: usize,
+    /// The largest number of messages queued at once.
+    pub max_queued_messages: usize,
+    /// The largest number of bytes queued at once.
+    pub max_queued_bytes: usize,
+    /// Counters for each subscribed channel, ordered by channel ID.
+    pub channels: Vec<ChannelStats>,
+}
@@ -0,0 +1,449 @@
+//! Kernel TLS offload, on Linux.
+//!
+//! Once rustls has completed the handshake, the session's traffic secrets are handed to the
+//! kernel, which then encrypts and decrypts TLS records itself. Frames are written to the socket
+//! as they are, without being copied into a userspace TLS buffer, and the kernel may use crypto
+//! hardware where the platform provides it.
+
+use std::io;
+use std::mem::MaybeUninit;
+use std::os::fd::{AsRawFd, RawFd};
+use std::pin::Pin;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::task::{Context, Poll, ready};
+
+use tokio::io::{AsyncRead, AsyncWrite, Interest, ReadBuf};
+use tokio::net::TcpStream;
+use tokio_rustls::rustls::{ConnectionTrafficSecrets, ProtocolVersion};
+use tokio_util::either::Either;
+
+const TLS_HEADER_LEN: usize = 5;
+const CONTENT_TYPE_ALERT: u8 = 21;
+const CONTENT_TYPE_APPLICATION_DATA: u8 = 23;
+const ALERT_CLOSE_NOTIFY: [u8; 2] = [1, 0];
+
+/// A stream which, while corked, reads no further than the end of the current TLS record.
+///
+/// This keeps rustls from reading the application data which follows the handshake, which would
+/// be lost when the session is handed to the kernel.
+pub(crate) struct CorkStream<S> {
+    inner: S,
+    corked: bool,
+    /// The header of the current record, while it is being read.
+    header: [u8; TLS_HEADER_LEN],
+    header_len: usize,
+    /// The number of bytes left in the body of the current record.
+    body_remaining: usize,
+}
+
+impl<S> CorkStream<S> {
+    pub fn new(inner: S, corked: bool) -> Self {
+        Self {
+            inner,
+            corked,
+            header: [0; TLS_HEADER_LEN],
+            header_len: 0,
+            body_remaining: 0,
+        }
+    }
+
+    /// Reads without limit from now on.
+    pub fn uncork(&mut self) {
+        self.corked = false;
+    }
+
+    fn at_record_boundary(&self) -> bool {
+        self.header_len == 0 && self.body_remaining == 0
+    }
+}
+
+impl<S: AsyncRead + Unpin> AsyncRead for CorkStream<S> {
+    fn poll_read(
+        self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
+        buf: &mut ReadBuf<'_>,
+    ) -> Poll<io::Result<()>> {
+        let this = self.get_mut();
+        if !this.corked {
+            return Pin::new(&mut this.inner).poll_read(cx, buf);
+        }
+        let limit = if this.body_remaining > 0 {
+            this.body_remaining
+        } else {
+            TLS_HEADER_LEN - this.header_len
+        };
+        let mut limited = buf.take(limit);
+        ready!(Pin::new(&mut this.inner).poll_read(cx, &mut limited))?;
+        let read = limited.filled();
+        let n = read.len();
+        if this.body_remaining > 0 {
+            this.body_remaining -= n;
+        } else {
+            this.header[this.header_len..this.header_len + n].copy_from_slice(read);
+            this.header_len += n;
+            if this.header_len == TLS_HEADER_LEN {
+                this.header_len = 0;
+                this.body_remaining =
+                    usize::from(u16::from_be_bytes([this.header[3], this.header[4]]));
+            }
+        }
+        // SAFETY: The inner stream initialized `n` bytes of the unfilled part of `buf`.
+        unsafe { buf.assume_init(n) };
+        buf.advance(n);
+        Poll::Ready(Ok(()))
+    }
+}
+
+impl<S: AsyncWrite + Unpin> AsyncWrite for CorkStream<S> {
+    fn poll_write(
+        self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
+        buf: &[u8],
+    ) -> Poll<io::Result<usize>> {
+        Pin::new(&mut self.get_mut().inner).poll_write(cx, buf)
+    }
+
+    fn poll_flush(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        Pin::new(&mut self.get_mut().inner).poll_flush(cx)
+    }
+
+    fn poll_shutdown(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        Pin::new(&mut self.get_mut().inner).poll_shutdown(cx)
+    }
+}
+
+/// A TCP stream whose TLS session is handled by the kernel.
+///
+/// Writes are encrypted by the kernel. Reads return the application data of the records received;
+/// a `close_notify` alert ends the stream, and any other record is an error, since the session
+/// can no longer be updated once it has been handed to the kernel.
+pub(crate) struct KtlsStream {
+    inner: TcpStream,
+    /// Set once the peer has sent `close_notify`.
+    closed: bool,
+    /// Set once `close_notify` has been sent to the peer.
+    close_notify_sent: bool,
+}
+
+impl AsyncRead for KtlsStream {
+    fn poll_read(
+        self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
+        buf: &mut ReadBuf<'_>,
+    ) -> Poll<io::Result<()>> {
+        let this = self.get_mut();
+        while !this.closed {
+            ready!(this.inner.poll_read_ready(cx))?;
+            let fd = this.inner.as_raw_fd();
+            // SAFETY: `recv_record` only writes to the buffer.
+            let unfilled = unsafe { buf.unfilled_mut() };
+            match this
+                .inner
+                .try_io(Interest::READABLE, || recv_record(fd, unfilled))
+            {
+                Ok((n, CONTENT_TYPE_APPLICATION_DATA)) => {
+                    // SAFETY: `recvmsg` initialized `n` bytes of the unfilled part of `buf`.
+                    unsafe { buf.assume_init(n) };
+                    buf.advance(n);
+                    return Poll::Ready(Ok(()));
+                }
+                Ok((n, CONTENT_TYPE_ALERT)) => {
+                    // SAFETY: `recvmsg` initialized `n` bytes of the unfilled part of `buf`.
+                    let alert = (n == ALERT_CLOSE_NOTIFY.len())
+                        .then(|| unsafe { [unfilled[0].assume_init(), unfilled[1].assume_init()] });
+                    if alert != Some(ALERT_CLOSE_NOTIFY) {
+                        return Poll::Ready(Err(io::Error::new(
+                            io::ErrorKind::ConnectionAborted,
+                            format!("received TLS alert {alert:?}"),
+                        )));
+                    }
+                    this.closed = true;
+                }
+                Ok((_, record_type)) => {
+                    return Poll::Ready(Err(io::Error::new(
+                        io::ErrorKind::InvalidData,
+                        format!("unexpected TLS record of type {record_type} after kernel offload"),
+                    )));
+                }
+                Err(err) if err.kind() == io::ErrorKind::WouldBlock => (),
+                Err(err) => return Poll::Ready(Err(err)),
+            }
+        }
+        Poll::Ready(Ok(()))
+    }
+}
+
+impl AsyncWrite for KtlsStream {
+    fn poll_write(
+        self: Pin<&mut Self>,
+        cx: &mut Context<'_>,
+        buf: &[u8],
+    ) -> Poll<io::Result<usize>> {
+        Pin::new(&mut self.get_mut().inner).poll_write(cx, buf)
+    }
+
+    fn poll_flush(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        Pin::new(&mut self.get_mut().inner).poll_flush(cx)
+    }
+
+    fn poll_shutdown(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        let this = self.get_mut();
+        while !this.close_notify_sent {
+            ready!(this.inner.poll_write_ready(cx))?;
+            let fd = this.inner.as_raw_fd();
+            match this.inner.try_io(Interest::WRITABLE, || {
+                send_record(fd, CONTENT_TYPE_ALERT, &ALERT_CLOSE_NOTIFY)
+            }) {
+                Ok(()) => this.close_notify_sent = true,
+                Err(err) if err.kind() == io::ErrorKind::WouldBlock => (),
+                Err(err) => return Poll::Ready(Err(err)),
+            }
+        }
+        Pin::new(&mut this.inner).poll_shutdown(cx)
+    }
+}
+
+/// Hands the TLS session of a stream to the kernel, once its handshake is complete.
+///
+/// The stream is returned unchanged, and uncorked, if the session can't be handed over without
+/// losing data, or if the kernel doesn't support TLS offload. In the latter case, `enabled` is
+/// cleared, so that later connections don't try again. Fails if the session was extracted but the
+/// kernel rejected it, in which case the connection can't be used.
+pub(crate) fn offload(
+    mut stream: tokio_rustls::server::TlsStream<CorkStream<TcpStream>>,
+    enabled: &AtomicBool,
+) -> io::Result<Either<tokio_rustls::server::TlsStream<CorkStream<TcpStream>>, KtlsStream>> {
+    let (io, conn) = stream.get_ref();
+    let fd = io.inner.as_raw_fd();
+    let ready = io.at_record_boundary() && !conn.is_handshaking() && !conn.wants_write();
+    if !ready || !enabled.load(Ordering::Relaxed) {
+        stream.get_mut().0.uncork();
+        return Ok(Either::Left(stream));
+    }
+    if let Err(err) = setsockopt(fd, libc::SOL_TCP, libc::TCP_ULP, b"tls") {
+        if enabled.swap(false, Ordering::Relaxed) {
+            tracing::warn!("Kernel TLS offload is unavailable, encrypting in userspace: {err}");
+        }
+        stream.get_mut().0.uncork();
+        return Ok(Either::Left(stream));
+    }
+
+    let (io, conn) = stream.into_inner();
+    let version = match conn.protocol_version() {
+        Some(ProtocolVersion::TLSv1_2) => libc::TLS_1_2_VERSION,
+        Some(ProtocolVersion::TLSv1_3) => libc::TLS_1_3_VERSION,
+        version => {
+            return Err(io::Error::new(
+                io::ErrorKind::Unsupported,
+                format!("unsupported TLS version {version:?}"),
+            ));
+        }
+    };
+    let secrets = conn.dangerous_extract_secrets().map_err(io::Error::other)?;
+    set_crypto_info(fd, libc::TLS_TX, version, secrets.tx)
+        .and_then(|()| set_crypto_info(fd, libc::TLS_RX, version, secrets.rx))
+        .inspect_err(|err| {
+            if enabled.swap(false, Ordering::Relaxed) {
+                tracing::warn!("Kernel TLS offload failed, encrypting in userspace: {err}");
+            }
+        })?;
+    Ok(Either::Right(KtlsStream {
+        inner: io.inner,
+        closed: false,
+        close_notify_sent: false,
+    }))
+}
+
+/// Configures the kernel's encryption or decryption of the session's records.
+fn set_crypto_info(
+    fd: RawFd,
+    direction: libc::c_int,
+    version: u16,
+    (seq, secrets): (u64, ConnectionTrafficSecrets),
+) -> io::Result<()> {
+    let rec_seq = seq.to_be_bytes();
+    match secrets {
+        ConnectionTrafficSecrets::Aes128Gcm { key, iv } => {
+            let (salt, iv) = iv.as_ref().split_at(4);
+            let info = libc::tls12_crypto_info_aes_gcm_128 {
+                info: libc::tls_crypto_info {
+                    version,
+                    cipher_type: libc::TLS_CIPHER_AES_GCM_128,
+                },
+                iv: array(iv)?,
+                key: array(key.as_ref())?,
+                salt: array(salt)?,
+                rec_seq,
+            };
+            setsockopt(fd, libc::SOL_TLS, direction, &info)
+        }
+        ConnectionTrafficSecrets::Aes256Gcm { key, iv } => {
+            let (salt, iv) = iv.as_ref().split_at(4);
+            let info = libc::tls12_crypto_info_aes_gcm_256 {
+                info: libc::tls_crypto_info {
+                    version,
+                    cipher_type: libc::TLS_CIPHER_AES_GCM_256,
+                },
+                iv: array(iv)?,
+                key: array(key.as_ref())?,
+                salt: array(salt)?,
+                rec_seq,
+            };
+            setsockopt(fd, libc::SOL_TLS, direction, &info)
+        }
+        ConnectionTrafficSecrets::Chacha20Poly1305 { key, iv } => {
+            let info = libc::tls12_crypto_info_chacha20_poly1305 {
+                info: libc::tls_crypto_info {
+                    version,
+                    cipher_type: libc::TLS_CIPHER_CHACHA20_POLY1305,
+                },
+                iv: array(iv.as_ref())?,
+                key: array(key.as_ref())?,
+                salt: [],
+                rec_seq,
+            };
+            setsockopt(fd, libc::SOL_TLS, direction, &info)
+        }
+        _ => Err(io::Error::new(
+            io::ErrorKind::Unsupported,
+            "unsupported TLS cipher suite",
+        )),
+    }
+}
+
+fn array<const N: usize>(bytes: &[u8]) -> io::Result<[u8; N]> {
+    bytes
+        .try_into()
+        .map_err(|_| io::Error::new(io::ErrorKind::InvalidData, "invalid TLS secret length"))
+}
+
+fn setsockopt<T>(fd: RawFd, level: libc::c_int, name: libc::c_int, value: &T) -> io::Result<()> {
+    // SAFETY: `value` is valid for reads of its size.
+    let ret = unsafe {
+        libc::setsockopt(
+            fd,
+            level,
+            name,
+            (value as *const T).cast(),
+            size_of::<T>() as libc::socklen_t,
+        )
+    };
+    if ret < 0 {
+        Err(io::Error::last_os_error())
+    } else {
+        Ok(())
+    }
+}
+
+/// A buffer for a control message carrying a TLS record type, aligned for `cmsghdr`.
+#[repr(C)]
+struct RecordTypeControl {
+    _align: [libc::cmsghdr; 0],
+    buf: [u8; 32],
+}
+
+impl RecordTypeControl {
+    fn new() -> Self {
+        // SAFETY: CMSG_SPACE has no preconditions.
+        debug_assert!(unsafe { libc::CMSG_SPACE(1) } as usize <= 32);
+        Self {
+            _align: [],
+            buf: [0; 32],
+        }
+    }
+}
+
+/// Receives data from a single TLS record, returning its length and the type of the record.
+fn recv_record(fd: RawFd, buf: &mut [MaybeUninit<u8>]) -> io::Result<(usize, u8)> {
+    let mut iov = libc::iovec {
+        iov_base: buf.as_mut_ptr().cast(),
+        iov_len: buf.len(),
+    };
+    let mut control = RecordTypeControl::new();
+    // SAFETY: An all-zero msghdr is valid.
+    let mut msg: libc::msghdr = unsafe { std::mem::zeroed() };
+    msg.msg_iov = &mut iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf.as_mut_ptr().cast();
+    msg.msg_controllen = control.buf.len() as _;
+    // SAFETY: The message points to buffers which outlive the call.
+    let n = unsafe { libc::recvmsg(fd, &mut msg, 0) };
+    if n < 0 {
+        return Err(io::Error::last_os_error());
+    }
+    // Records without a control message carry application data.
+    let mut record_type = CONTENT_TYPE_APPLICATION_DATA;
+    // SAFETY: The control messages were written by the kernel to the buffer in `msg`.
+    unsafe {
+        let mut cmsg = libc::CMSG_FIRSTHDR(&msg);
+        while !cmsg.is_null() {
+            if (*cmsg).cmsg_level == libc::SOL_TLS && (*cmsg).cmsg_type == libc::TLS_GET_RECORD_TYPE
+            {
+                record_type = *libc::CMSG_DATA(cmsg);
+            }
+            cmsg = libc::CMSG_NXTHDR(&msg, cmsg);
+        }
+    }
+    Ok((n as usize, record_type))
+}
+
+/// Sends data in a single TLS record of the given type.
+fn send_record(fd: RawFd, record_type: u8, data: &[u8]) -> io::Result<()> {
+    let mut iov = libc::iovec {
+        iov_base: data.as_ptr().cast_mut().cast(),
+        iov_len: data.len(),
+    };
+    let mut control = RecordTypeControl::new();
+    // SAFETY: An all-zero msghdr is valid.
+    let mut msg: libc::msghdr = unsafe { std::mem::zeroed() };
+    msg.msg_iov = &mut iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf.as_mut_ptr().cast();
+    // SAFETY: CMSG_SPACE has no preconditions.
+    msg.msg_controllen = unsafe { libc::CMSG_SPACE(1) } as _;
+    // SAFETY: The control buffer holds one control message with a byte of data, and the message
+    // points to buffers which outlive the call.
+    let n = unsafe {
+        let cmsg = libc::CMSG_FIRSTHDR(&msg);
+        (*cmsg).cmsg_level = libc::SOL_TLS;
+        (*cmsg).cmsg_type = libc::TLS_SET_RECORD_TYPE;
+        (*cmsg).cmsg_len = libc::CMSG_LEN(1) as _;
+        *libc::CMSG_DATA(cmsg) = record_type;
+        libc::sendmsg(fd, &msg, 0)
+    };
+    if n < 0 {
+        Err(io::Error::last_os_error())
+    } else {
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use tokio::io::{AsyncReadExt, AsyncWriteExt};
+
+    use super::*;
+
+    #[tokio::test]
+    async fn test_cork_stream_reads_one_record_at_a_time() {
+        let (mut tx, rx) = tokio::io::duplex(1024);
+        // Two records, with bodies of 3 and 0 bytes, followed by data which isn't read while
+        // corked.
+        tx.write_all(&[22, 3, 3, 0, 3, b'a', b'b', b'c', 23, 3, 3, 0, 0, b'x'])
+            .await
+            .unwrap();
+        let mut stream = CorkStream::new(rx, true);
+        let mut buf = [0; 64];
+        let mut read = Vec::new();
+        while read.len() < 13 {
+            let n = stream.read(&mut buf).await.unwrap();
+            read.extend_from_slice(&buf[..n]);
+            assert!(read.len() <= 13, "read past the end of a record");
+        }
+        assert!(stream.at_record_boundary());
+
+        stream.uncork();
+        let n = stream.read(&mut buf).await.unwrap();
+        assert_eq!(&buf[..n], b"x");
+    }
+}
@@ -6,6 +6,8 @@ mod no_tls;
 #[cfg(not(feature = "websocket-tls"))]
 pub(crate) use no_tls::{StreamConfiguration, TlsStream};
 
+#[cfg(all(feature = "websocket-tls", target_os = "linux"))]
+mod ktls;
 #[cfg(feature = "websocket-tls")]
 mod rust_tls;
 #[cfg(feature = "websocket-tls")]
@@ -12,7 +12,7 @@ pub struct StreamConfiguration {}
 
 impl StreamConfiguration {
     /// Returns an error if a TlsIdentity is provided.
-    pub fn new(identity: Option<&TlsIdentity>) -> Result<Self, FoxgloveError> {
+    pub fn new(identity: Option<&TlsIdentity>, _kernel_tls: bool) -> Result<Self, FoxgloveError> {
         if identity.is_some() {
             return Err(FoxgloveError::ConfigurationError(
                 "TLS is not enabled".to_string(),
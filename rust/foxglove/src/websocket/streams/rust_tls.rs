@@ -1,6 +1,8 @@
 //! Provides TLS support using rustls
 
 use std::sync::Arc;
+#[cfg(target_os = "linux")]
+use std::sync::atomic::AtomicBool;
 
 use tokio::net::TcpStream;
 use tokio_rustls::{
@@ -17,13 +19,26 @@ use crate::{
     websocket::streams::{Acceptor, ServerStream, TlsIdentity},
 };
 
+#[cfg(target_os = "linux")]
+use super::ktls::{self, CorkStream, KtlsStream};
+
+#[cfg(not(target_os = "linux"))]
 pub(crate) type TlsStream<S> = tokio_rustls::server::TlsStream<S>;
+/// A TLS stream, encrypted by rustls, or by the kernel once the handshake is complete.
+#[cfg(target_os = "linux")]
+pub(crate) type TlsStream<S> = Either<tokio_rustls::server::TlsStream<CorkStream<S>>, KtlsStream>;
 
 pub struct StreamConfiguration {
     tls_acceptor: Option<TlsAcceptor>,
+    /// Whether to hand TLS sessions to the kernel. Cleared if the kernel doesn't support it.
+    #[cfg(target_os = "linux")]
+    kernel_tls: AtomicBool,
 }
 
-fn build_tls_acceptor(tls_identity: &TlsIdentity) -> Result<TlsAcceptor, FoxgloveError> {
+fn build_tls_acceptor(
+    tls_identity: &TlsIdentity,
+    kernel_tls: bool,
+) -> Result<TlsAcceptor, FoxgloveError> {
     crate::crypto::install_default_crypto_provider();
 
     let cert = CertificateDer::from_pem_slice(&tls_identity.cert)
@@ -32,23 +47,34 @@ fn build_tls_acceptor(tls_identity: &TlsIdentity) -> Result<TlsAcceptor, Foxglov
     let key = PrivateKeyDer::from_pem_slice(&tls_identity.key)
         .map_err(|e| FoxgloveError::ConfigurationError(format!("TLS configuration: {e}")))?;
 
-    let config = rustls::ServerConfig::builder()
+    let mut config = rustls::ServerConfig::builder()
         .with_no_client_auth()
         .with_single_cert(vec![cert], key)
         .map_err(|e| FoxgloveError::ConfigurationError(format!("TLS configuration: {e}")))?;
+    // Issue session tickets, so that reconnecting clients can resume their session without a full
+    // handshake. Sessions are also cached by ID, for TLS 1.2 clients without ticket support.
+    config.ticketer = crate::crypto::ticketer()
+        .map_err(|e| FoxgloveError::ConfigurationError(format!("TLS configuration: {e}")))?;
+    config.enable_secret_extraction = kernel_tls;
 
     Ok(TlsAcceptor::from(Arc::new(config)))
 }
 
 impl StreamConfiguration {
-    pub fn new(identity: Option<&TlsIdentity>) -> Result<Self, FoxgloveError> {
+    /// Kernel TLS offload is only supported on Linux, and is ignored on other platforms.
+    pub fn new(identity: Option<&TlsIdentity>, kernel_tls: bool) -> Result<Self, FoxgloveError> {
+        let kernel_tls = kernel_tls && cfg!(target_os = "linux");
         let tls_acceptor = if let Some(identity) = identity {
-            let acceptor = build_tls_acceptor(identity)?;
+            let acceptor = build_tls_acceptor(identity, kernel_tls)?;
             Some(acceptor)
         } else {
             None
         };
-        Ok(Self { tls_acceptor })
+        Ok(Self {
+            tls_acceptor,
+            #[cfg(target_os = "linux")]
+            kernel_tls: AtomicBool::new(kernel_tls),
+        })
     }
 }
 
@@ -57,13 +83,18 @@ impl Acceptor for StreamConfiguration {
         &self,
         stream: TcpStream,
     ) -> Result<ServerStream<TcpStream>, crate::FoxgloveError> {
-        let stream = if let Some(tls_acceptor) = &self.tls_acceptor {
-            let stream = tls_acceptor.accept(stream).await?;
-            Either::Right(stream)
-        } else {
-            Either::Left(stream)
+        let Some(tls_acceptor) = &self.tls_acceptor else {
+            return Ok(Either::Left(stream));
+        };
+        #[cfg(target_os = "linux")]
+        let stream = {
+            let corked = self.kernel_tls.load(std::sync::atomic::Ordering::Relaxed);
+            let stream = tls_acceptor.accept(CorkStream::new(stream, corked)).await?;
+            ktls::offload(stream, &self.kernel_tls)?
         };
-        Ok(stream)
+        #[cfg(not(target_os = "linux"))]
+        let stream = tls_acceptor.accept(stream).await?;
+        Ok(Either::Right(stream))
     }
 
     fn accepts_tls(&self) -> bool {
@@ -1,4 +1,4 @@
-use super::ws_protocol::client::subscribe;
+use super::ws_protocol::client::{subscribe, subscribe_fields};
 use crate::ChannelId;
 
 /// A subscription ID.
@@ -28,12 +28,24 @@ impl std::fmt::Display for SubscriptionId {
 pub(crate) struct Subscription {
     pub id: SubscriptionId,
     pub channel_id: ChannelId,
+    /// Fields to project the channel's messages onto, if requested.
+    pub fields: Option<Vec<String>>,
 }
 impl From<subscribe::Subscription> for Subscription {
     fn from(value: subscribe::Subscription) -> Self {
         Self {
             id: SubscriptionId::new(value.id),
             channel_id: ChannelId::new(value.channel_id),
+            fields: None,
+        }
+    }
+}
+impl From<subscribe_fields::FieldSubscription> for Subscription {
+    fn from(value: subscribe_fields::FieldSubscription) -> Self {
+        Self {
+            id: SubscriptionId::new(value.id),
+            channel_id: ChannelId::new(value.channel_id),
+            fields: Some(value.fields),
         }
     }
 }
@@ -17,8 +17,9 @@ use tungstenite::client::IntoClientRequest;
 
 use super::ws_protocol::client::subscribe::Subscription;
 use super::ws_protocol::client::{
-    self, Advertise, FetchAsset, GetParameters, ServiceCallRequest, SetParameters, Subscribe,
-    SubscribeConnectionGraph, SubscribeParameterUpdates, Unsubscribe, UnsubscribeConnectionGraph,
+    self, Advertise, EnableMessageBatches, FetchAsset, FieldSubscription, GetParameters,
+    ServiceCallRequest, SetParameters, Subscribe, SubscribeConnectionGraph, SubscribeFields,
+    SubscribeParameterUpdates, Unsubscribe, UnsubscribeConnectionGraph,
     UnsubscribeParameterUpdates,
 };
 use super::ws_protocol::server::connection_graph_update::{
@@ -28,8 +29,8 @@ use super::ws_protocol::server::server_info::{
     Capability as ServerInfoCapability, SerializedTimestamp,
 };
 use super::ws_protocol::server::{
-    ConnectionGraphUpdate, FetchAssetResponse, ParameterValues, ServerInfo, ServerMessage,
-    ServiceCallFailure, ServiceCallResponse, Status, advertise_services,
+    ConnectionGraphUpdate, FetchAssetResponse, MessageData, ParameterValues, ServerInfo,
+    ServerMessage, ServiceCallFailure, ServiceCallResponse, Status, advertise_services,
 };
 use crate::library_version::get_library_identifier;
 use crate::testutil::{
@@ -40,17 +41,20 @@ use crate::testutil::{WebSocketClient, WebSocketClientError};
 #[cfg(feature = "websocket-tls")]
 use crate::websocket::TlsIdentity;
 use crate::websocket::handshake::SUBPROTOCOL;
-use crate::websocket::server::{ServerOptions, create_server as do_create_server};
+use crate::websocket::server::{
+    SHARED_MEMORY_SERVER_INFO_KEY, ServerOptions, create_server as do_create_server,
+};
 use crate::websocket::service::{CallId, Service, ServiceSchema};
 use crate::websocket::{
-    BlockingAssetHandlerFn, Capability, ClientChannelId, ConnectionGraph, Parameter, Server,
+    AssetHandler, AssetResponder, BlockingAssetHandlerFn, Capability, Client, ClientChannel,
+    ClientChannelId, ConnectionGraph, ConnectionGraphPatch, Parameter, Server, SubscriptionOptions,
 };
 use crate::websocket::{
     PlaybackCommand, PlaybackControlRequest, PlaybackState, PlaybackStatus, ServerListener,
 };
 use crate::{
-    ChannelBuilder, ChannelDescriptor, Context, FoxgloveError, PartialMetadata, RawChannel, Schema,
-    SinkChannelFilter,
+    ChannelBuilder, ChannelDemand, ChannelDescriptor, Context, FoxgloveError, PartialMetadata,
+    RawChannel, Schema, SinkChannelFilter,
 };
 
 macro_rules! expect_recv {
@@ -123,11 +127,9 @@ async fn test_client_connect() {
     let _ = server.stop();
 }
 
-#[traced_test]
-#[tokio::test]
+/// Returns a CA certificate, and an identity for `host` signed by it.
 #[cfg(feature = "websocket-tls")]
-async fn test_secure_client_connect() {
-    let ctx = Context::new();
+fn test_tls_identity(host: &str) -> (rcgen::Certificate, TlsIdentity) {
     let ca_params = CertificateParams::default();
     let ca_key = KeyPair::generate().expect("default keygen will succeed");
     let ca_cert = ca_params
@@ -135,22 +137,32 @@ async fn test_secure_client_connect() {
         .expect("failed to sign CA cert");
     let issuer = Issuer::new(ca_params, ca_key);
 
-    let host = "127.0.0.1";
     let params = CertificateParams::new(vec![host.to_string()]).expect("SAN is valid");
 
     let key = KeyPair::generate().expect("default keygen will succeed");
     let cert = params
         .signed_by(&key, &issuer)
         .expect("failed to sign cert");
+    let identity = TlsIdentity {
+        cert: cert.pem().as_bytes().to_vec(),
+        key: key.serialize_pem().as_bytes().to_vec(),
+    };
+    (ca_cert, identity)
+}
+
+#[traced_test]
+#[tokio::test]
+#[cfg(feature = "websocket-tls")]
+async fn test_secure_client_connect() {
+    let ctx = Context::new();
+    let host = "127.0.0.1";
+    let (ca_cert, identity) = test_tls_identity(host);
 
     let server = create_server(
         &ctx,
         ServerOptions {
             session_id: Some("tls_sess_id".to_string()),
-            tls_identity: Some(TlsIdentity {
-                cert: cert.pem().as_bytes().to_vec(),
-                key: key.serialize_pem().as_bytes().to_vec(),
-            }),
+            tls_identity: Some(identity),
             ..Default::default()
         },
     );
@@ -166,6 +178,33 @@ async fn test_secure_client_connect() {
     let _ = server.stop();
 }
 
+#[traced_test]
+#[tokio::test]
+#[cfg(feature = "websocket-tls")]
+async fn test_secure_client_connect_with_kernel_tls() {
+    let ctx = Context::new();
+    let host = "127.0.0.1";
+    let (ca_cert, identity) = test_tls_identity(host);
+
+    // Whether or not the kernel supports TLS offload, clients must be served.
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            tls_identity: Some(identity),
+            kernel_tls: true,
+            ..Default::default()
+        },
+    );
+    let addr = server.start(host, 0).await.expect("Failed to start server");
+
+    let mut client = WebSocketClient::connect_secure(addr.to_string(), ca_cert)
+        .await
+        .expect("Failed to connect");
+    expect_recv!(client, ServerMessage::ServerInfo);
+
+    let _ = server.stop();
+}
+
 #[cfg(feature = "websocket-tls")]
 #[traced_test]
 #[tokio::test]
@@ -299,6 +338,56 @@ async fn test_handshake_with_multiple_subprotocols() {
     let _ = server.stop();
 }
 
+#[traced_test]
+#[tokio::test]
+async fn test_handshake_negotiates_permessage_deflate() {
+    for compression in [false, true] {
+        let ctx = Context::new();
+        let server = create_server(
+            &ctx,
+            ServerOptions {
+                compression,
+                ..Default::default()
+            },
+        );
+        let addr = server
+            .start("127.0.0.1", 0)
+            .await
+            .expect("Failed to start server");
+
+        let mut request = format!("ws://{addr}/")
+            .into_client_request()
+            .expect("Failed to build request");
+        request.headers_mut().insert(
+            "sec-websocket-protocol",
+            HeaderValue::from_static(SUBPROTOCOL),
+        );
+        request.headers_mut().insert(
+            "sec-websocket-extensions",
+            HeaderValue::from_static("permessage-deflate; client_max_window_bits"),
+        );
+
+        let (_, response) = tokio_tungstenite::connect_async(request)
+            .await
+            .expect("Failed to connect");
+
+        let extensions = response.headers().get("sec-websocket-extensions");
+        if compression {
+            let extensions = extensions.expect("extension accepted");
+            assert!(
+                extensions
+                    .to_str()
+                    .unwrap()
+                    .starts_with("permessage-deflate")
+            );
+        } else {
+            assert_eq!(extensions, None);
+        }
+
+        let _ = server.stop();
+    }
+}
+
 #[traced_test]
 #[tokio::test]
 async fn test_advertise_to_client() {
@@ -564,6 +653,104 @@ async fn test_log_only_to_subscribers() {
     let _ = server.stop();
 }
 
+#[tokio::test]
+async fn test_channel_demand_counts_subscribed_clients() {
+    let ctx = Context::new();
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            subscription_options: SubscriptionOptions {
+                max_rate: Some(20.0),
+                ..Default::default()
+            },
+            ..Default::default()
+        },
+    );
+    let ch = new_channel("/foo", &ctx);
+    assert_eq!(ch.demand(), ChannelDemand::NONE);
+
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+    let mut clients = vec![];
+    for subscription_id in 1..=2 {
+        let mut client = WebSocketClient::connect(format!("{addr}"))
+            .await
+            .expect("Failed to connect");
+        expect_recv!(client, ServerMessage::ServerInfo);
+        expect_recv!(client, ServerMessage::Advertise);
+        client
+            .send(&Subscribe::new([Subscription::new(
+                subscription_id,
+                ch.id().into(),
+            )]))
+            .await
+            .expect("Failed to send");
+        clients.push(client);
+    }
+
+    assert_eventually(|| ch.demand().consumers() == 2).await;
+    assert!(ch.demand().is_subscribed());
+    assert_eq!(ch.demand().max_rate(), Some(20.0));
+
+    let _ = server.stop();
+}
+
+#[cfg(unix)]
+#[traced_test]
+#[tokio::test]
+async fn test_servers_share_port_and_context() {
+    let ctx = Context::new();
+    let options = || ServerOptions {
+        reuse_port: true,
+        writer_threads: Some(1),
+        ..Default::default()
+    };
+    let server1 = create_server(&ctx, options());
+    let server2 = create_server(&ctx, options());
+    let ch = new_channel("/foo", &ctx);
+
+    let addr = server1
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+    let addr2 = server2
+        .start("127.0.0.1", addr.port())
+        .await
+        .expect("Failed to start second server on the same port");
+    assert_eq!(addr, addr2);
+
+    // Whichever server accepts each client, both receive the context's channels.
+    let mut clients = vec![];
+    for subscription_id in 1..=4 {
+        let mut client = WebSocketClient::connect(format!("{addr}"))
+            .await
+            .expect("Failed to connect");
+        expect_recv!(client, ServerMessage::ServerInfo);
+        expect_recv!(client, ServerMessage::Advertise);
+        client
+            .send(&Subscribe::new([Subscription::new(
+                subscription_id,
+                ch.id().into(),
+            )]))
+            .await
+            .expect("Failed to send");
+        clients.push(client);
+    }
+    assert_eventually(|| server1.client_count() + server2.client_count() == 4).await;
+    assert_eventually(|| ch.demand().consumers() == 4).await;
+
+    ch.log(b"hello");
+    for client in &mut clients {
+        let msg = expect_recv!(client, ServerMessage::MessageData);
+        assert_eq!(msg.data, Cow::Borrowed(b"hello"));
+    }
+
+    let _ = server1.stop();
+    let _ = server2.stop();
+}
+
 #[traced_test]
 #[tokio::test]
 async fn test_server_transmits_empty_message() {
@@ -606,6 +793,68 @@ async fn test_server_transmits_empty_message() {
     let _ = server.stop();
 }
 
+#[traced_test]
+#[tokio::test]
+async fn test_fan_out_with_writer_threads() {
+    let ctx = Context::new();
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            writer_threads: Some(2),
+            ..Default::default()
+        },
+    );
+    let ch = new_channel("/fan-out", &ctx);
+
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+
+    // Two clients share a subscription id, and so share a serialized frame. The third uses a
+    // different id, and gets its own frame.
+    let mut clients = Vec::new();
+    for subscription_id in [5, 5, 9] {
+        let mut client = WebSocketClient::connect(format!("{addr}"))
+            .await
+            .expect("Failed to connect");
+        expect_recv!(client, ServerMessage::ServerInfo);
+        expect_recv!(client, ServerMessage::Advertise);
+        client
+            .send(&Subscribe::new([Subscription::new(
+                subscription_id,
+                ch.id().into(),
+            )]))
+            .await
+            .expect("Failed to subscribe");
+        clients.push((subscription_id, client));
+    }
+
+    assert_eventually(|| ch.num_sinks() == 3).await;
+
+    ch.log_with_meta(b"single", PartialMetadata::with_log_time(10));
+    ch.log_batch(&[
+        (&b"first"[..], PartialMetadata::with_log_time(11)),
+        (&b"second"[..], PartialMetadata::with_log_time(12)),
+    ]);
+
+    for (subscription_id, client) in &mut clients {
+        let expected = [
+            (10, &b"single"[..]),
+            (11, &b"first"[..]),
+            (12, &b"second"[..]),
+        ];
+        for (log_time, data) in expected {
+            let msg = expect_recv!(client, ServerMessage::MessageData);
+            assert_eq!(msg.subscription_id, *subscription_id);
+            assert_eq!(msg.log_time, log_time);
+            assert_eq!(msg.data, Cow::Borrowed(data));
+        }
+    }
+
+    let _ = server.stop();
+}
+
 #[tokio::test]
 async fn test_on_unsubscribe_called_after_disconnect() {
     let recording_listener = Arc::new(RecordingServerListener::new());
@@ -1105,6 +1354,73 @@ async fn test_client_advertising() {
     let _ = server.stop();
 }
 
+/// Records payloads received through [`ServerListener::on_message_data_shared`].
+#[derive(Default)]
+struct SharedPayloadListener {
+    shared: Mutex<Vec<Bytes>>,
+    borrowed: Mutex<usize>,
+}
+
+impl ServerListener for SharedPayloadListener {
+    fn on_message_data(&self, _client: Client, _channel: &ClientChannel, _payload: &[u8]) {
+        *self.borrowed.lock().unwrap() += 1;
+    }
+
+    fn on_message_data_shared(&self, _client: Client, _channel: &ClientChannel, payload: Bytes) {
+        self.shared.lock().unwrap().push(payload);
+    }
+}
+
+#[traced_test]
+#[tokio::test]
+async fn test_client_message_data_shared() {
+    let listener = Arc::new(SharedPayloadListener::default());
+
+    let ctx = Context::new();
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            capabilities: Some(IndexSet::from([Capability::ClientPublish])),
+            supported_encodings: Some(IndexSet::from(["json".to_string()])),
+            listener: Some(listener.clone()),
+            ..Default::default()
+        },
+    );
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+
+    let mut client = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    expect_recv!(client, ServerMessage::ServerInfo);
+
+    let channel_id = 1;
+    client
+        .send(&client::Advertise::new([
+            client::advertise::Channel::builder(channel_id, "/test", "json")
+                .build()
+                .unwrap(),
+        ]))
+        .await
+        .expect("Failed to send advertisement");
+    client
+        .send(&client::MessageData::new(channel_id, b"{\"a\":1}"))
+        .await
+        .expect("Failed to send message");
+
+    assert_eventually(|| listener.shared.lock().unwrap().len() == 1).await;
+    // Payloads are only delivered to the shared callback, and outlive the received frame.
+    assert_eq!(
+        listener.shared.lock().unwrap()[0],
+        Bytes::from_static(b"{\"a\":1}")
+    );
+    assert_eq!(*listener.borrowed.lock().unwrap(), 0);
+
+    let _ = server.stop();
+}
+
 #[traced_test]
 #[tokio::test]
 async fn test_parameter_values_with_empty_values() {
@@ -1195,6 +1511,64 @@ async fn test_parameter_values() {
     let _ = server.stop();
 }
 
+#[traced_test]
+#[tokio::test]
+async fn test_parameter_values_coalesced() {
+    let ctx = Context::new();
+    let recording_listener = Arc::new(RecordingServerListener::new());
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            capabilities: Some(IndexSet::from([Capability::Parameters])),
+            listener: Some(recording_listener.clone()),
+            parameter_coalesce_window: Some(std::time::Duration::from_millis(50)),
+            ..Default::default()
+        },
+    );
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+
+    let mut client = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    client
+        .send(&SubscribeParameterUpdates::new(["x", "y"]))
+        .await
+        .expect("Failed to send subscribe parameter updates");
+    expect_recv!(client, ServerMessage::ServerInfo);
+    assert_eventually(|| recording_listener.parameters_subscribe_len() == 1).await;
+
+    // A burst of updates results in one message, with the latest value of each parameter.
+    for i in 0..100 {
+        server.publish_parameter_values(vec![
+            Parameter::integer("x", i),
+            Parameter::string("y", "unchanged"),
+        ]);
+    }
+    let msg = expect_recv!(client, ServerMessage::ParameterValues);
+    assert_eq!(
+        msg,
+        ParameterValues::new([
+            Parameter::integer("x", 99),
+            Parameter::string("y", "unchanged")
+        ])
+    );
+
+    // Values which the client has already been sent are not sent again.
+    server.publish_parameter_values(vec![Parameter::string("y", "unchanged")]);
+    tokio::time::sleep(std::time::Duration::from_millis(100)).await;
+    server.publish_parameter_values(vec![
+        Parameter::integer("x", 100),
+        Parameter::string("y", "unchanged"),
+    ]);
+    let msg = expect_recv!(client, ServerMessage::ParameterValues);
+    assert_eq!(msg, ParameterValues::new([Parameter::integer("x", 100)]));
+
+    let _ = server.stop();
+}
+
 #[traced_test]
 #[tokio::test]
 async fn test_parameter_unsubscribe_no_updates() {
@@ -1595,6 +1969,72 @@ async fn test_fetch_asset() {
     }
 }
 
+#[tokio::test]
+async fn test_fetch_asset_cache() {
+    /// Writes the URI as the asset in two chunks, and counts its calls.
+    #[derive(Default)]
+    struct CountingHandler(std::sync::atomic::AtomicUsize);
+    impl AssetHandler for CountingHandler {
+        fn fetch(&self, uri: String, responder: AssetResponder) {
+            self.0.fetch_add(1, std::sync::atomic::Ordering::Relaxed);
+            if uri.ends_with("error") {
+                responder.respond_err("test error");
+                return;
+            }
+            let mut writer = responder.writer();
+            let (head, tail) = uri.as_bytes().split_at(uri.len() / 2);
+            writer.append(head);
+            writer.append(tail);
+            writer.finish();
+        }
+    }
+
+    let ctx = Context::new();
+    let handler = Arc::new(CountingHandler::default());
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            capabilities: Some(IndexSet::from([Capability::Assets])),
+            fetch_asset_handler: Some(handler.clone()),
+            fetch_asset_cache_bytes: Some(1024),
+            ..Default::default()
+        },
+    );
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+
+    let mut client = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("failed to connect");
+    expect_recv!(client, ServerMessage::ServerInfo);
+
+    let uri = "package://robot/mesh.stl";
+    let cases = [
+        (uri, Ok(uri.as_bytes()), 1),
+        // Served from the cache, without invoking the handler.
+        (uri, Ok(uri.as_bytes()), 1),
+        // Errors are not cached.
+        ("package://robot/error", Err("test error"), 2),
+        ("package://robot/error", Err("test error"), 3),
+    ];
+    for (request_id, (uri, expect, calls)) in cases.into_iter().enumerate() {
+        let request_id = request_id as u32;
+        client
+            .send(&FetchAsset::new(request_id, uri))
+            .await
+            .unwrap();
+
+        let msg = expect_recv!(client, ServerMessage::FetchAssetResponse);
+        match expect {
+            Ok(data) => assert_eq!(msg, FetchAssetResponse::asset_data(request_id, data)),
+            Err(err) => assert_eq!(msg, FetchAssetResponse::error_message(request_id, err)),
+        }
+        assert_eq!(handler.0.load(std::sync::atomic::Ordering::Relaxed), calls);
+    }
+}
+
 #[traced_test]
 #[tokio::test]
 async fn test_update_connection_graph() {
@@ -1709,12 +2149,13 @@ async fn test_update_connection_graph() {
 
 #[traced_test]
 #[tokio::test]
-async fn test_slow_client() {
+async fn test_connection_graph_patches_coalesced() {
     let ctx = Context::new();
     let server = create_server(
         &ctx,
         ServerOptions {
-            message_backlog_size: Some(1),
+            capabilities: Some(IndexSet::from([Capability::ConnectionGraph])),
+            connection_graph_coalesce_window: Some(Duration::from_millis(50)),
             ..Default::default()
         },
     );
@@ -1723,11 +2164,87 @@ async fn test_slow_client() {
         .await
         .expect("Failed to start server");
 
+    let mut graph = ConnectionGraph::new();
+    graph.set_published_topic("topic1", ["publisher1"]);
+    graph.set_advertised_service("service1", ["provider1"]);
+    server
+        .replace_connection_graph(graph)
+        .expect("failed to update connection graph");
+    // Let the coalescing window for the initial graph elapse.
+    tokio::time::sleep(Duration::from_millis(100)).await;
+
     let mut client = WebSocketClient::connect(format!("{addr}"))
         .await
         .expect("failed to connect");
+    client.send(&SubscribeConnectionGraph {}).await.unwrap();
+    expect_recv!(client, ServerMessage::ServerInfo);
+    let msg = expect_recv!(client, ServerMessage::ConnectionGraphUpdate);
+    assert_eq!(msg.published_topics.len(), 1);
+
+    // A burst of patches results in a single update, containing only the changes.
+    for i in 0..100 {
+        let mut patch = ConnectionGraphPatch::new();
+        patch.set_subscribed_topic("topic1", [format!("subscriber{i}")]);
+        patch.set_published_topic("topic1", ["publisher1"]);
+        server
+            .update_connection_graph(patch)
+            .expect("failed to update connection graph");
+    }
+    let mut patch = ConnectionGraphPatch::new();
+    patch.remove_service("service1");
+    server
+        .update_connection_graph(patch)
+        .expect("failed to update connection graph");
 
-    // Publish more status messages than the client can handle
+    let msg = expect_recv!(client, ServerMessage::ConnectionGraphUpdate);
+    assert_eq!(
+        msg,
+        ConnectionGraphUpdate {
+            subscribed_topics: vec![SubscribedTopic::new("topic1", ["subscriber99"])],
+            removed_services: vec!["service1".to_string()],
+            ..Default::default()
+        }
+    );
+
+    // A patch which changes nothing sends nothing.
+    let mut patch = ConnectionGraphPatch::new();
+    patch.set_published_topic("topic1", ["publisher1"]);
+    server
+        .update_connection_graph(patch)
+        .expect("failed to update connection graph");
+    tokio::time::sleep(Duration::from_millis(100)).await;
+    let mut patch = ConnectionGraphPatch::new();
+    patch.remove_topic("topic1");
+    server
+        .update_connection_graph(patch)
+        .expect("failed to update connection graph");
+    let msg = expect_recv!(client, ServerMessage::ConnectionGraphUpdate);
+    assert_eq!(msg.removed_topics, vec!["topic1".to_string()]);
+
+    let _ = server.stop();
+}
+
+#[traced_test]
+#[tokio::test]
+async fn test_slow_client() {
+    let ctx = Context::new();
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            message_backlog_size: Some(1),
+            ..Default::default()
+        },
+    );
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+
+    let mut client = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("failed to connect");
+
+    // Publish more status messages than the client can handle
     for i in 0..50 {
         let status = Status::error(format!("msg{i}"));
         server.publish_status(status);
@@ -1753,6 +2270,65 @@ async fn test_slow_client() {
     let _ = server.stop();
 }
 
+#[tokio::test]
+async fn test_backpressure_stats() {
+    let recording_listener = Arc::new(RecordingServerListener::new());
+    let ctx = Context::new();
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            listener: Some(recording_listener.clone()),
+            message_backlog_size: Some(4),
+            ..Default::default()
+        },
+    );
+    let ch = new_channel("/foo", &ctx);
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+
+    let mut client = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    expect_recv!(client, ServerMessage::ServerInfo);
+    expect_recv!(client, ServerMessage::Advertise);
+    client
+        .send(&Subscribe::new([Subscription::new(1, ch.id().into())]))
+        .await
+        .expect("Failed to send");
+    assert_eventually(|| ch.num_sinks() == 1).await;
+
+    // Log more messages than the backlog holds without yielding to the client's poller.
+    for i in 0..20u8 {
+        ch.log(&[i]);
+    }
+
+    // The listener is notified once, since the callback is throttled.
+    let backpressure = recording_listener.take_backpressure();
+    assert_eq!(backpressure.len(), 1);
+    let (client_id, stats) = &backpressure[0];
+    assert_eq!(*client_id, stats.client_id);
+    assert!(stats.dropped > 0);
+
+    let stats = server.stats();
+    assert_eq!(stats.len(), 1);
+    let channel = stats[0].channels[0];
+    assert_eq!(channel.channel_id, ch.id());
+    assert_eq!(channel.sequence, 20);
+    assert_eq!(channel.dropped, 16);
+    assert_eq!(channel.max_queued_messages, 4);
+
+    // The latest messages are delivered.
+    for i in 16..20u8 {
+        let msg = expect_recv!(client, ServerMessage::MessageData);
+        assert_eq!(msg.data, Cow::Borrowed(&[i]));
+    }
+    assert_eventually(|| server.stats()[0].channels[0].sent == 4).await;
+
+    let _ = server.stop();
+}
+
 #[tokio::test]
 async fn test_broadcast_time() {
     let ctx = Context::new();
@@ -1778,6 +2354,44 @@ async fn test_broadcast_time() {
     assert_eq!(msg.timestamp, 42);
 }
 
+#[tokio::test]
+async fn test_broadcast_time_coalesced() {
+    let ctx = Context::new();
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            capabilities: Some(IndexSet::from([Capability::Time])),
+            broadcast_coalesce_window: Some(Duration::from_millis(50)),
+            ..Default::default()
+        },
+    );
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+
+    let mut client = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("failed to connect");
+    expect_recv!(client, ServerMessage::ServerInfo);
+
+    // The first broadcast is sent immediately, and the rest of the burst is sent as one message
+    // with the latest time.
+    for timestamp in 1..=100 {
+        server.broadcast_time(timestamp);
+    }
+    let msg = expect_recv!(client, ServerMessage::Time);
+    assert_eq!(msg.timestamp, 1);
+    let msg = expect_recv!(client, ServerMessage::Time);
+    assert_eq!(msg.timestamp, 100);
+
+    server.broadcast_time(101);
+    let msg = expect_recv!(client, ServerMessage::Time);
+    assert_eq!(msg.timestamp, 101);
+
+    let _ = server.stop();
+}
+
 struct RecordingPlaybackControlListener {
     playback_request: Mutex<Option<PlaybackControlRequest>>,
 }
@@ -1966,6 +2580,7 @@ async fn test_server_info_metadata_sent_to_client() {
                 "key1".into() => "val1".into(),
                 "key2".into() => "val2".into(),
             }),
+            shared_memory_token: Some("/dev/shm/foxglove-test".into()),
             ..Default::default()
         },
     );
@@ -1986,6 +2601,7 @@ async fn test_server_info_metadata_sent_to_client() {
             "fg-library".into() => get_library_identifier(),
             "key1".into() => "val1".into(),
             "key2".into() => "val2".into(),
+            SHARED_MEMORY_SERVER_INFO_KEY.into() => "/dev/shm/foxglove-test".into(),
         }
     );
 
@@ -2342,3 +2958,344 @@ async fn test_parameter_handler_takes_precedence_over_listener() {
 
     let _ = server.stop();
 }
+
+#[tokio::test]
+async fn test_message_batches() {
+    let ctx = Context::new();
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            capabilities: Some(IndexSet::from([Capability::MessageBatches])),
+            // Each message data frame is 15 bytes, so a batch is full after three messages, long
+            // before the linger has passed.
+            message_batch_linger: Some(Duration::from_secs(10)),
+            message_batch_bytes: Some(45),
+            ..Default::default()
+        },
+    );
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+    let ch = new_channel("/foo", &ctx);
+
+    let mut batched = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    let info = expect_recv!(batched, ServerMessage::ServerInfo);
+    assert!(
+        info.capabilities
+            .contains(&ServerInfoCapability::MessageBatches)
+    );
+    expect_recv!(batched, ServerMessage::Advertise);
+    let mut single = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    expect_recv!(single, ServerMessage::ServerInfo);
+    expect_recv!(single, ServerMessage::Advertise);
+
+    // Client messages are handled in order, so batches are enabled once the client is subscribed.
+    batched
+        .send(&EnableMessageBatches {})
+        .await
+        .expect("Failed to enable message batches");
+    let subscribe = Subscribe::new([Subscription {
+        id: 1,
+        channel_id: ch.id().into(),
+    }]);
+    batched.send(&subscribe).await.expect("Failed to subscribe");
+    single.send(&subscribe).await.expect("Failed to subscribe");
+    assert_eventually(|| dbg!(ch.num_sinks()) == 2).await;
+
+    for i in 0..3u8 {
+        ch.log_with_meta(
+            &[b'a' + i, b'!'],
+            PartialMetadata::with_log_time(u64::from(i)),
+        );
+    }
+
+    // The client which enabled batches receives the messages in one batch.
+    let batch = expect_recv!(batched, ServerMessage::MessageBatch);
+    assert_eq!(
+        batch.messages,
+        vec![
+            MessageData::new(1, 0, b"a!"),
+            MessageData::new(1, 1, b"b!"),
+            MessageData::new(1, 2, b"c!"),
+        ]
+    );
+
+    // The other client receives one message per frame.
+    for i in 0..3u8 {
+        let msg = expect_recv!(single, ServerMessage::MessageData);
+        assert_eq!(msg.log_time, u64::from(i));
+    }
+
+    let _ = server.stop();
+}
+
+#[tokio::test]
+async fn test_message_batches_require_capability() {
+    let ctx = Context::new();
+    let server = create_server(&ctx, ServerOptions::default());
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+
+    let mut client = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    expect_recv!(client, ServerMessage::ServerInfo);
+    client
+        .send(&EnableMessageBatches {})
+        .await
+        .expect("Failed to enable message batches");
+    assert_eq!(
+        expect_recv!(client, ServerMessage::Status),
+        Status::error("Server does not support message batches capability")
+    );
+
+    let _ = server.stop();
+}
+
+#[tokio::test]
+async fn test_field_projection() {
+    use crate::Encode;
+    use crate::messages::{Pose, PoseInFrame, Quaternion, Vector3};
+    use prost::Message as _;
+
+    let ctx = Context::new();
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            capabilities: Some(IndexSet::from([Capability::FieldProjection])),
+            ..Default::default()
+        },
+    );
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+    let ch = ChannelBuilder::new("/pose")
+        .context(&ctx)
+        .message_encoding(PoseInFrame::get_message_encoding())
+        .schema(PoseInFrame::get_schema())
+        .build_raw()
+        .expect("Failed to create channel");
+
+    let mut projected = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    let info = expect_recv!(projected, ServerMessage::ServerInfo);
+    assert!(
+        info.capabilities
+            .contains(&ServerInfoCapability::FieldProjection)
+    );
+    expect_recv!(projected, ServerMessage::Advertise);
+    let mut full = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    expect_recv!(full, ServerMessage::ServerInfo);
+    expect_recv!(full, ServerMessage::Advertise);
+
+    // Fields which aren't in the schema are rejected.
+    projected
+        .send(&SubscribeFields::new([FieldSubscription::new(
+            1,
+            ch.id().into(),
+            ["missing"],
+        )]))
+        .await
+        .expect("Failed to subscribe");
+    let status = expect_recv!(projected, ServerMessage::Status);
+    assert!(status.message.starts_with("Cannot project channel"));
+
+    projected
+        .send(&SubscribeFields::new([FieldSubscription::new(
+            1,
+            ch.id().into(),
+            ["frame_id", "pose.position"],
+        )]))
+        .await
+        .expect("Failed to subscribe");
+    full.send(&Subscribe::new([Subscription::new(1, ch.id().into())]))
+        .await
+        .expect("Failed to subscribe");
+    assert_eventually(|| dbg!(ch.num_sinks()) == 2).await;
+
+    let pose = PoseInFrame {
+        timestamp: None,
+        frame_id: "map".into(),
+        pose: Some(Pose {
+            position: Some(Vector3 {
+                x: 1.0,
+                y: 2.0,
+                z: 3.0,
+            }),
+            orientation: Some(Quaternion {
+                x: 0.0,
+                y: 0.0,
+                z: 0.0,
+                w: 1.0,
+            }),
+        }),
+    };
+    let mut buf = Vec::new();
+    Encode::encode(&pose, &mut buf).expect("Failed to encode");
+    ch.log(&buf);
+
+    // The projected client receives only the requested fields.
+    let msg = expect_recv!(projected, ServerMessage::MessageData);
+    let decoded = PoseInFrame::decode(&msg.data[..]).expect("Failed to decode");
+    assert_eq!(decoded.frame_id, "map");
+    assert_eq!(
+        decoded.pose.as_ref().unwrap().position,
+        pose.pose.unwrap().position
+    );
+    assert_eq!(decoded.pose.unwrap().orientation, None);
+
+    // The other client receives the whole message.
+    let msg = expect_recv!(full, ServerMessage::MessageData);
+    assert_eq!(msg.data, buf);
+
+    let _ = server.stop();
+}
+
+#[tokio::test]
+async fn test_field_projection_requires_capability() {
+    let ctx = Context::new();
+    let server = create_server(&ctx, ServerOptions::default());
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+    let ch = new_channel("/foo", &ctx);
+
+    let mut client = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    expect_recv!(client, ServerMessage::ServerInfo);
+    expect_recv!(client, ServerMessage::Advertise);
+    client
+        .send(&SubscribeFields::new([FieldSubscription::new(
+            1,
+            ch.id().into(),
+            ["a"],
+        )]))
+        .await
+        .expect("Failed to subscribe");
+    assert_eq!(
+        expect_recv!(client, ServerMessage::Status),
+        Status::error("Server does not support field projection capability")
+    );
+
+    let _ = server.stop();
+}
+
+#[cfg(feature = "websocket-video")]
+#[tokio::test]
+async fn test_video_transcode() {
+    use crate::Encode;
+    use crate::messages::{CompressedVideo, RawImage};
+    use crate::websocket::{VideoEncoder, VideoEncoderError, VideoEncoderFactory, VideoFrame};
+    use prost::Message as _;
+
+    /// An encoder which "encodes" a frame as its luma plane, prefixed with a keyframe flag.
+    struct LumaEncoder;
+
+    impl VideoEncoder for LumaEncoder {
+        fn encode(&mut self, frame: &VideoFrame<'_>) -> Result<Option<Bytes>, VideoEncoderError> {
+            let mut data = vec![u8::from(frame.keyframe)];
+            data.extend_from_slice(frame.y);
+            Ok(Some(data.into()))
+        }
+    }
+
+    struct LumaEncoderFactory;
+
+    impl VideoEncoderFactory for LumaEncoderFactory {
+        fn format(&self) -> &str {
+            "h264"
+        }
+
+        fn create_encoder(
+            &self,
+            _width: u32,
+            _height: u32,
+        ) -> Result<Box<dyn VideoEncoder>, VideoEncoderError> {
+            Ok(Box::new(LumaEncoder))
+        }
+    }
+
+    let ctx = Context::new();
+    let server = create_server(
+        &ctx,
+        ServerOptions {
+            video_encoder_factory: Some(Arc::new(LumaEncoderFactory)),
+            ..Default::default()
+        },
+    );
+    let addr = server
+        .start("127.0.0.1", 0)
+        .await
+        .expect("Failed to start server");
+    let ch = ChannelBuilder::new("/camera")
+        .context(&ctx)
+        .message_encoding(RawImage::get_message_encoding())
+        .schema(RawImage::get_schema())
+        .build_raw()
+        .expect("Failed to create channel");
+
+    let mut client = WebSocketClient::connect(format!("{addr}"))
+        .await
+        .expect("Failed to connect");
+    expect_recv!(client, ServerMessage::ServerInfo);
+
+    // The derived video channel is advertised with the image channel.
+    let msg = expect_recv!(client, ServerMessage::Advertise);
+    assert_eq!(msg.channels.len(), 2);
+    let video = msg
+        .channels
+        .iter()
+        .find(|c| c.topic == "/camera/video")
+        .expect("Video channel was not advertised");
+    assert_eq!(video.schema_name, "foxglove.CompressedVideo");
+
+    // Subscribing to the video subscribes a transcoding sink to the image channel.
+    client
+        .send(&Subscribe::new([Subscription::new(1, video.id)]))
+        .await
+        .expect("Failed to subscribe");
+    assert_eventually(|| dbg!(ch.num_sinks()) == 1).await;
+
+    let image = RawImage {
+        frame_id: "camera".to_string(),
+        width: 4,
+        height: 2,
+        encoding: "mono8".to_string(),
+        step: 4,
+        data: vec![7; 8].into(),
+        ..Default::default()
+    };
+    let mut buf = Vec::new();
+    Encode::encode(&image, &mut buf).expect("Failed to encode");
+    ch.log(&buf);
+
+    // The first frame is a keyframe.
+    let msg = expect_recv!(client, ServerMessage::MessageData);
+    assert_eq!(msg.subscription_id, 1);
+    let frame = CompressedVideo::decode(&msg.data[..]).expect("Failed to decode");
+    assert_eq!(frame.format, "h264");
+    assert_eq!(frame.frame_id, "camera");
+    assert_eq!(&frame.data[..], &[1, 7, 7, 7, 7, 7, 7, 7, 7]);
+
+    // Transcoding stops with the last subscription.
+    client
+        .send(&Unsubscribe::new([1]))
+        .await
+        .expect("Failed to unsubscribe");
+    assert_eventually(|| dbg!(ch.num_sinks()) == 0).await;
+
+    let _ = server.stop();
+}
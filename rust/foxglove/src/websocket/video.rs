@@ -0,0 +1,593 @@
+//! Video transcoding of image channels for WebSocket clients.
+//!
+//! When the server is configured with a [`VideoEncoderFactory`], each image channel which can be
+//! transcoded is advertised to clients together with a derived `foxglove.CompressedVideo`
+//! channel. The derived channel is encoded once, by a single encoder shared by all of the clients
+//! which subscribe to it, and only while at least one client is subscribed. Clients on slow links
+//! can subscribe to the video instead of the full frames.
+//!
+//! Only the encoder traits are provided. The caller supplies the encoder backend, and the feature
+//! isn't exposed by the C and C++ bindings.
+
+use std::collections::{BTreeMap, HashMap};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Weak};
+use std::time::Duration;
+
+use bytes::Bytes;
+use prost::Message as _;
+use tokio::runtime::Handle;
+
+use crate::img2yuv::{
+    VideoInputSchema, Yuv420Buffer, Yuv420Vec, decode_image_message, detect_video_schema,
+};
+use crate::messages::CompressedVideo;
+use crate::sink_channel_filter::SinkChannelFilter;
+use crate::throttler::Throttler;
+use crate::{ChannelId, Context, Encode, FoxgloveError, Metadata, RawChannel, Sink, SinkId};
+
+use super::connected_client::ConnectedClient;
+
+/// Suffix appended to the topic of an image channel to name its derived video channel.
+const VIDEO_TOPIC_SUFFIX: &str = "/video";
+
+/// Interval between throttled warnings for frames which fail to transcode.
+const ERROR_WARN_INTERVAL: Duration = Duration::from_secs(30);
+
+/// An error returned by a [`VideoEncoder`] or [`VideoEncoderFactory`].
+pub type VideoEncoderError = Box<dyn std::error::Error + Send + Sync>;
+
+/// An uncompressed video frame, in planar YUV 4:2:0 (I420).
+#[derive(Debug)]
+pub struct VideoFrame<'a> {
+    /// The width of the frame, in pixels. Always even.
+    pub width: u32,
+    /// The height of the frame, in pixels. Always even.
+    pub height: u32,
+    /// The luma plane, `y_stride * height` bytes.
+    pub y: &'a [u8],
+    /// The blue-difference chroma plane, `uv_stride * height / 2` bytes.
+    pub u: &'a [u8],
+    /// The red-difference chroma plane, `uv_stride * height / 2` bytes.
+    pub v: &'a [u8],
+    /// The number of bytes in each row of the luma plane.
+    pub y_stride: u32,
+    /// The number of bytes in each row of the chroma planes.
+    pub uv_stride: u32,
+    /// The timestamp of the frame, in nanoseconds since the epoch.
+    pub timestamp: u64,
+    /// Whether the encoder must encode this frame as a keyframe, because a client has just
+    /// subscribed to the video.
+    pub keyframe: bool,
+}
+
+/// Encodes the frames of one video stream.
+///
+/// An encoder is created for each derived video channel while clients are subscribed to it, and
+/// is called with its frames in order. It is recreated when the frame dimensions change.
+pub trait VideoEncoder: Send {
+    /// Encodes a frame.
+    ///
+    /// Returns the compressed data for exactly one frame, in the format of the
+    /// [factory](VideoEncoderFactory::format), as described by `foxglove.CompressedVideo`. Returns
+    /// `None` if the encoder dropped the frame, for example to stay within its bitrate.
+    ///
+    /// The encoder must not produce B-frames.
+    fn encode(&mut self, frame: &VideoFrame<'_>) -> Result<Option<Bytes>, VideoEncoderError>;
+}
+
+/// Creates the [`VideoEncoder`]s which transcode image channels for WebSocket clients.
+///
+/// This is where the encoder backend is chosen, for example a hardware encoder such as NVENC or
+/// VAAPI, with a fallback to software. The SDK doesn't include an encoder: implementations wrap
+/// an encoding library of the caller's choice.
+pub trait VideoEncoderFactory: Send + Sync {
+    /// Returns the format of the encoded video: `h264`, `h265`, `vp9` or `av1`.
+    fn format(&self) -> &str;
+
+    /// Creates an encoder for frames of the given dimensions.
+    fn create_encoder(
+        &self,
+        width: u32,
+        height: u32,
+    ) -> Result<Box<dyn VideoEncoder>, VideoEncoderError>;
+}
+
+/// The subscribers of a derived video channel, and the sink which feeds it while it has any.
+#[derive(Default)]
+struct VideoState {
+    subscribers: Vec<Weak<ConnectedClient>>,
+    sink: Option<Arc<VideoSink>>,
+}
+
+/// A derived `foxglove.CompressedVideo` channel of an image channel.
+pub(crate) struct VideoChannel {
+    /// The image channel which is transcoded.
+    source: Weak<RawChannel>,
+    source_id: ChannelId,
+    /// The derived channel advertised to clients. It isn't registered with the context.
+    channel: Arc<RawChannel>,
+    input_schema: VideoInputSchema,
+    factory: Arc<dyn VideoEncoderFactory>,
+    context: Weak<Context>,
+    runtime: Handle,
+    state: parking_lot::Mutex<VideoState>,
+}
+
+impl VideoChannel {
+    fn new(
+        source: &Arc<RawChannel>,
+        input_schema: VideoInputSchema,
+        factory: Arc<dyn VideoEncoderFactory>,
+        context: &Arc<Context>,
+        runtime: Handle,
+    ) -> Self {
+        // The channel is created without a ChannelBuilder, which would intern its schema in the
+        // context. This is called from Sink::add_channels, with the context locked.
+        let channel = RawChannel::new(
+            context,
+            format!("{}{VIDEO_TOPIC_SUFFIX}", source.topic()),
+            CompressedVideo::get_message_encoding(),
+            CompressedVideo::get_schema().map(Arc::new),
+            BTreeMap::new(),
+            0,
+        );
+        Self {
+            source: Arc::downgrade(source),
+            source_id: source.id(),
+            channel,
+            input_schema,
+            factory,
+            context: Arc::downgrade(context),
+            runtime,
+            state: parking_lot::Mutex::default(),
+        }
+    }
+
+    /// Returns the derived channel.
+    pub fn channel(&self) -> &Arc<RawChannel> {
+        &self.channel
+    }
+
+    /// Returns the ID of the image channel which is transcoded.
+    pub fn source_id(&self) -> ChannelId {
+        self.source_id
+    }
+
+    /// Adds a client subscription.
+    ///
+    /// The first subscription starts transcoding the source channel. Every new subscription
+    /// requests a keyframe, so that the client can start decoding right away.
+    pub fn subscribe(self: &Arc<Self>, client: &Weak<ConnectedClient>) {
+        let (Some(context), Some(source)) = (self.context.upgrade(), self.source.upgrade()) else {
+            return;
+        };
+        // The context is called without holding the state lock, which is taken by context
+        // callbacks when the source channel is removed.
+        let sink = {
+            let mut state = self.state.lock();
+            state.subscribers.push(client.clone());
+            if let Some(sink) = &state.sink {
+                sink.keyframe.store(true, Ordering::Relaxed);
+                return;
+            }
+            let sink = VideoSink::start(self, &self.runtime);
+            state.sink = Some(sink.clone());
+            sink
+        };
+        context.add_sink(sink.clone());
+        context.subscribe_channels(sink.id, &[source.id()]);
+
+        // The last subscriber may have unsubscribed in the meantime, before the sink was added.
+        let replaced = self
+            .state
+            .lock()
+            .sink
+            .as_ref()
+            .is_none_or(|current| !Arc::ptr_eq(current, &sink));
+        if replaced {
+            context.remove_sink(sink.id);
+        }
+    }
+
+    /// Removes a client's subscription. Transcoding stops with the last subscription.
+    ///
+    /// This may be called from a [`Sink::remove_channel`] callback, so the sink is removed from
+    /// the context asynchronously.
+    pub fn unsubscribe(&self, client: &Weak<ConnectedClient>) {
+        let mut state = self.state.lock();
+        state
+            .subscribers
+            .retain(|s| !s.ptr_eq(client) && s.strong_count() > 0);
+        if !state.subscribers.is_empty() {
+            return;
+        }
+        let Some(sink) = state.sink.take() else {
+            return;
+        };
+        let context = self.context.clone();
+        self.runtime.spawn(async move {
+            if let Some(context) = context.upgrade() {
+                context.remove_sink(sink.id);
+            }
+        });
+    }
+
+    /// Sends a frame encoded from the messages of a sink to the subscribed clients, unless the
+    /// sink has since been replaced.
+    fn send(&self, sink_id: SinkId, log_time: u64, payload: &[u8]) {
+        let subscribers: Vec<_> = {
+            let state = self.state.lock();
+            if state.sink.as_ref().is_none_or(|sink| sink.id != sink_id) {
+                return;
+            }
+            state.subscribers.iter().filter_map(Weak::upgrade).collect()
+        };
+        for client in subscribers {
+            client.send_video_frame(self.channel.id(), log_time, payload);
+        }
+    }
+}
+
+/// Feeds the messages of a source channel to its video transcoding task.
+///
+/// Frames are queued for the task with a bounded channel. When the encoder falls behind, the
+/// oldest frame is dropped, which keeps the latency of live video low.
+struct VideoSink {
+    id: SinkId,
+    tx: flume::Sender<(Bytes, u64)>,
+    rx: flume::Receiver<(Bytes, u64)>,
+    /// Set when a client subscribes, to encode the next frame as a keyframe.
+    keyframe: Arc<AtomicBool>,
+}
+
+impl VideoSink {
+    /// The bounded channel capacity for frame back-pressure.
+    const CHANNEL_CAPACITY: usize = 2;
+
+    /// Creates a sink and spawns its transcoding task, which ends when the sink is dropped.
+    fn start(video: &Arc<VideoChannel>, runtime: &Handle) -> Arc<Self> {
+        let id = SinkId::next();
+        let (tx, rx) = flume::bounded(Self::CHANNEL_CAPACITY);
+        let keyframe = Arc::new(AtomicBool::new(false));
+        let task = Transcoder {
+            video: Arc::downgrade(video),
+            input_schema: video.input_schema,
+            factory: video.factory.clone(),
+            keyframe: keyframe.clone(),
+            encoder: None,
+        };
+        let task_rx = rx.clone();
+        runtime.spawn(async move {
+            let mut task = task;
+            let mut error_throttler = Throttler::new(ERROR_WARN_INTERVAL);
+            while let Ok((data, log_time)) = task_rx.recv_async().await {
+                let result = tokio::task::spawn_blocking(move || {
+                    let result = task.transcode(&data, log_time);
+                    (task, result)
+                })
+                .await;
+                let result = match result {
+                    Ok((returned, result)) => {
+                        task = returned;
+                        result
+                    }
+                    Err(err) => {
+                        tracing::error!("video transcoding task panicked: {err}");
+                        return;
+                    }
+                };
+                match result {
+                    Ok(Some(payload)) => {
+                        let Some(video) = task.video.upgrade() else {
+                            return;
+                        };
+                        video.send(id, log_time, &payload);
+                    }
+                    Ok(None) => (),
+                    Err(err) => {
+                        if error_throttler.try_acquire() {
+                            tracing::warn!("Failed to transcode video frame: {err}");
+                        }
+                    }
+                }
+            }
+        });
+        Arc::new(Self {
+            id,
+            tx,
+            rx,
+            keyframe,
+        })
+    }
+}
+
+impl Sink for VideoSink {
+    fn id(&self) -> SinkId {
+        self.id
+    }
+
+    fn log(
+        &self,
+        channel: &RawChannel,
+        msg: &[u8],
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        self.log_shared(channel, &Bytes::copy_from_slice(msg), metadata)
+    }
+
+    fn log_shared(
+        &self,
+        _channel: &RawChannel,
+        msg: &Bytes,
+        metadata: &Metadata,
+    ) -> Result<(), FoxgloveError> {
+        let frame = (msg.clone(), metadata.log_time);
+        if let Err(flume::TrySendError::Full(frame)) = self.tx.try_send(frame) {
+            let _ = self.rx.try_recv();
+            let _ = self.tx.try_send(frame);
+        }
+        Ok(())
+    }
+
+    fn auto_subscribe(&self) -> bool {
+        // The sink subscribes to its source channel when it is started.
+        false
+    }
+}
+
+/// The state of a video transcoding task.
+struct Transcoder {
+    video: Weak<VideoChannel>,
+    input_schema: VideoInputSchema,
+    factory: Arc<dyn VideoEncoderFactory>,
+    keyframe: Arc<AtomicBool>,
+    /// The encoder, and the frame dimensions it was created for.
+    encoder: Option<(Box<dyn VideoEncoder>, (u32, u32))>,
+}
+
+impl Transcoder {
+    /// Decodes an image message, converts it to YUV 4:2:0 and encodes it, returning an encoded
+    /// `foxglove.CompressedVideo` message, or `None` if the encoder dropped the frame.
+    fn transcode(
+        &mut self,
+        data: &[u8],
+        log_time: u64,
+    ) -> Result<Option<Bytes>, VideoEncoderError> {
+        let image_msg = decode_image_message(self.input_schema, data)?;
+        let (width, height) = image_msg.image.probe_dimensions()?;
+        // YUV 4:2:0 requires even dimensions.
+        let (width, height) = (width & !1, height & !1);
+        if width == 0 || height == 0 {
+            return Err(crate::img2yuv::Error::ZeroSized.into());
+        }
+        let mut buffer = Yuv420Vec::new(width, height);
+        image_msg.image.to_yuv420(&mut buffer)?;
+
+        let mut keyframe = self.keyframe.swap(false, Ordering::Relaxed);
+        if self
+            .encoder
+            .as_ref()
+            .is_none_or(|(_, dimensions)| *dimensions != (width, height))
+        {
+            self.encoder = None;
+            let encoder = self.factory.create_encoder(width, height)?;
+            self.encoder = Some((encoder, (width, height)));
+            keyframe = true;
+        }
+        let (encoder, _) = self.encoder.as_mut().expect("encoder was created");
+
+        // Use the image message timestamp, if it had one, otherwise log_time.
+        let timestamp = image_msg
+            .timestamp
+            .map(|ts| ts.total_nanos())
+            .unwrap_or(log_time);
+        let (y, u, v) = buffer.yuv();
+        let (y_stride, uv_stride, _) = buffer.yuv_strides();
+        let frame = VideoFrame {
+            width,
+            height,
+            y,
+            u,
+            v,
+            y_stride,
+            uv_stride,
+            timestamp,
+            keyframe,
+        };
+        let Some(data) = encoder.encode(&frame)? else {
+            return Ok(None);
+        };
+        let msg = CompressedVideo {
+            timestamp: image_msg.timestamp,
+            frame_id: image_msg.frame_id,
+            data,
+            format: self.factory.format().to_string(),
+        };
+        Ok(Some(msg.encode_to_vec().into()))
+    }
+}
+
+/// The derived video channels in use by the clients of a server.
+///
+/// Clients which are advertised the same image channel share its video channel, so that its
+/// frames are encoded once for all of them.
+pub(crate) struct VideoChannels {
+    factory: Arc<dyn VideoEncoderFactory>,
+    /// Selects the image channels which are transcoded. All of them, if unset.
+    filter: Option<Arc<dyn SinkChannelFilter>>,
+    channels: parking_lot::Mutex<HashMap<ChannelId, Weak<VideoChannel>>>,
+}
+
+impl VideoChannels {
+    pub fn new(
+        factory: Arc<dyn VideoEncoderFactory>,
+        filter: Option<Arc<dyn SinkChannelFilter>>,
+    ) -> Self {
+        Self {
+            factory,
+            filter,
+            channels: parking_lot::Mutex::default(),
+        }
+    }
+
+    /// Returns the video channel derived from an image channel, or `None` if the channel can't be
+    /// transcoded, or is opted out by the filter.
+    pub fn get(
+        &self,
+        source: &Arc<RawChannel>,
+        context: &Arc<Context>,
+        runtime: &Handle,
+    ) -> Option<Arc<VideoChannel>> {
+        let schema_name = source.schema().map(|s| s.name.as_str()).unwrap_or("");
+        let input_schema = detect_video_schema(source.message_encoding(), schema_name)?;
+        if let Some(filter) = &self.filter
+            && !filter.should_subscribe(source.descriptor())
+        {
+            return None;
+        }
+        let mut channels = self.channels.lock();
+        channels.retain(|_, video| video.strong_count() > 0);
+        if let Some(video) = channels.get(&source.id()).and_then(Weak::upgrade) {
+            return Some(video);
+        }
+        let video = Arc::new(VideoChannel::new(
+            source,
+            input_schema,
+            self.factory.clone(),
+            context,
+            runtime.clone(),
+        ));
+        channels.insert(source.id(), Arc::downgrade(&video));
+        Some(video)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::messages::RawImage;
+    use crate::sink_channel_filter::SinkChannelFilterFn;
+    use crate::{ChannelBuilder, Schema};
+
+    /// An encoder which "encodes" a frame as its luma plane, prefixed with a keyframe flag.
+    struct LumaEncoder;
+
+    impl VideoEncoder for LumaEncoder {
+        fn encode(&mut self, frame: &VideoFrame<'_>) -> Result<Option<Bytes>, VideoEncoderError> {
+            let mut data = vec![u8::from(frame.keyframe)];
+            data.extend_from_slice(frame.y);
+            Ok(Some(data.into()))
+        }
+    }
+
+    struct LumaEncoderFactory;
+
+    impl VideoEncoderFactory for LumaEncoderFactory {
+        fn format(&self) -> &str {
+            "h264"
+        }
+
+        fn create_encoder(
+            &self,
+            _width: u32,
+            _height: u32,
+        ) -> Result<Box<dyn VideoEncoder>, VideoEncoderError> {
+            Ok(Box::new(LumaEncoder))
+        }
+    }
+
+    fn raw_image(width: u32, height: u32) -> Vec<u8> {
+        let msg = RawImage {
+            frame_id: "camera".to_string(),
+            width,
+            height,
+            encoding: "mono8".to_string(),
+            step: width,
+            data: vec![7; (width * height) as usize].into(),
+            ..Default::default()
+        };
+        msg.encode_to_vec()
+    }
+
+    fn transcoder() -> Transcoder {
+        Transcoder {
+            video: Weak::new(),
+            input_schema: VideoInputSchema::FoxgloveRawImage,
+            factory: Arc::new(LumaEncoderFactory),
+            keyframe: Arc::default(),
+            encoder: None,
+        }
+    }
+
+    #[test]
+    fn test_transcode_raw_image() {
+        let mut transcoder = transcoder();
+        let encoded = transcoder.transcode(&raw_image(4, 2), 42).unwrap().unwrap();
+        let msg = CompressedVideo::decode(encoded).unwrap();
+        assert_eq!(msg.format, "h264");
+        assert_eq!(msg.frame_id, "camera");
+        // The first frame is a keyframe.
+        assert_eq!(&msg.data[..], &[1, 7, 7, 7, 7, 7, 7, 7, 7]);
+
+        let encoded = transcoder.transcode(&raw_image(4, 2), 43).unwrap().unwrap();
+        let msg = CompressedVideo::decode(encoded).unwrap();
+        assert_eq!(msg.data[0], 0);
+
+        // A keyframe is encoded on request, and when the dimensions change.
+        transcoder.keyframe.store(true, Ordering::Relaxed);
+        let encoded = transcoder.transcode(&raw_image(4, 2), 44).unwrap().unwrap();
+        assert_eq!(CompressedVideo::decode(encoded).unwrap().data[0], 1);
+        let encoded = transcoder.transcode(&raw_image(2, 2), 45).unwrap().unwrap();
+        assert_eq!(CompressedVideo::decode(encoded).unwrap().data[0], 1);
+    }
+
+    #[test]
+    fn test_transcode_invalid_message() {
+        assert!(transcoder().transcode(b"not an image", 0).is_err());
+    }
+
+    #[tokio::test]
+    async fn test_video_channels() {
+        let ctx = Context::new();
+        let runtime = Handle::current();
+        let image = ChannelBuilder::new("/camera")
+            .context(&ctx)
+            .message_encoding("protobuf")
+            .schema(Schema::new("foxglove.RawImage", "protobuf", &b""[..]))
+            .build_raw()
+            .unwrap();
+        let other = ChannelBuilder::new("/depth")
+            .context(&ctx)
+            .message_encoding("protobuf")
+            .schema(Schema::new("foxglove.RawImage", "protobuf", &b""[..]))
+            .build_raw()
+            .unwrap();
+        let pose = ChannelBuilder::new("/pose")
+            .context(&ctx)
+            .message_encoding("protobuf")
+            .schema(Schema::new("foxglove.Pose", "protobuf", &b""[..]))
+            .build_raw()
+            .unwrap();
+        let channels = VideoChannels::new(
+            Arc::new(LumaEncoderFactory),
+            Some(Arc::new(SinkChannelFilterFn(
+                |channel: &crate::ChannelDescriptor| channel.topic() != "/depth",
+            ))),
+        );
+
+        let video = channels.get(&image, &ctx, &runtime).unwrap();
+        assert_eq!(video.channel().topic(), "/camera/video");
+        assert_eq!(
+            video.channel().schema().map(|s| s.name.as_str()),
+            Some("foxglove.CompressedVideo")
+        );
+        assert!(ctx.get_channel_by_topic("/camera/video").is_none());
+        // The video channel is shared while it's in use.
+        let again = channels.get(&image, &ctx, &runtime).unwrap();
+        assert!(Arc::ptr_eq(&video, &again));
+        drop((video, again));
+        assert!(channels.get(&other, &ctx, &runtime).is_none());
+        assert!(channels.get(&pose, &ctx, &runtime).is_none());
+    }
+}
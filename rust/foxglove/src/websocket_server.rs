@@ -5,18 +5,27 @@ use std::fmt::{Debug, Display};
 use std::future::Future;
 use std::net::SocketAddr;
 use std::sync::Arc;
+use std::time::Duration;
 
+#[cfg(unix)]
+use crate::SharedMemorySinkHandle;
+use crate::message_filter::MessageFilterFn;
 use crate::sink_channel_filter::{SinkChannelFilter, SinkChannelFilterFn};
 use crate::websocket::PlaybackState;
 #[cfg(feature = "websocket-tls")]
 use crate::websocket::TlsIdentity;
+#[cfg(feature = "websocket-video")]
+use crate::websocket::VideoEncoderFactory;
 use crate::websocket::service::Service;
 use crate::websocket::{
-    AnyClient, AssetHandler, AsyncAssetHandlerFn, BlockingAssetHandlerFn, Capability,
-    ConnectionGraph, Parameter, ParameterHandler, Server, ServerOptions, ShutdownHandle, Status,
-    create_server,
+    AnyClient, AssetHandler, AsyncAssetHandlerFn, BacklogDropPolicy, BlockingAssetHandlerFn,
+    Capability, ClientStats, ConnectionGraph, ConnectionGraphPatch, Parameter, ParameterHandler,
+    Server, ServerOptions, ShutdownHandle, Status, SubscriptionOptions, create_server,
+};
+use crate::{
+    AppUrl, ChannelDescriptor, Context, FilterAction, FoxgloveError, MessageFilter, Metadata,
+    runtime::get_runtime_handle,
 };
-use crate::{AppUrl, ChannelDescriptor, Context, FoxgloveError, runtime::get_runtime_handle};
 
 /// A WebSocket server for live visualization in Foxglove.
 ///
@@ -27,7 +36,11 @@ use crate::{AppUrl, ChannelDescriptor, Context, FoxgloveError, runtime::get_runt
 /// Logged messages are queued in a channel for each client and delivered in a background task. If a
 /// queue fills, perhaps because of a slow client, then the oldest messages will be dropped. The
 /// queue size is configurable with [`WebSocketServer::message_backlog_size`] when creating the
-/// server.
+/// server. The queue can also be limited by its size in bytes, in total with
+/// [`WebSocketServer::message_backlog_bytes`] and for each channel with
+/// [`WebSocketServer::channel_backlog_bytes`], and
+/// [`WebSocketServer::backlog_drop_policy`] selects which messages are dropped. The queues of all
+/// clients also count towards the [memory budget][crate::MemoryBudget] of the server's context.
 ///
 /// Other protocol messages, including status updates, are delivered from a separate "control"
 /// queue, using the same configured queue size. If the control queue fills, then the slow client is
@@ -101,6 +114,26 @@ impl WebSocketServer {
         self
     }
 
+    /// Sets a [`MessageFilter`] which runs on each message before it is sent to clients.
+    ///
+    /// The filter runs once for each logged message, and its result is shared by all clients,
+    /// however many there are. This lets clients receive channels with a different policy than
+    /// other sinks in the same context, for example at a lower rate with a
+    /// [`RateLimitFilter`][crate::RateLimitFilter], while an MCAP file records them in full.
+    pub fn message_filter(mut self, filter: Arc<dyn MessageFilter>) -> Self {
+        self.options.message_filter = Some(filter);
+        self
+    }
+
+    /// Sets a message filter for connected clients. See [`MessageFilter`] for more information.
+    pub fn message_filter_fn(
+        mut self,
+        filter: impl Fn(&ChannelDescriptor, &[u8], &Metadata) -> FilterAction + Sync + Send + 'static,
+    ) -> Self {
+        self.options.message_filter = Some(Arc::new(MessageFilterFn(filter)));
+        self
+    }
+
     /// Configure TLS with a PEM-formatted x509 certificate chain and pkcs8 private key.
     /// If enabled, the server will only accept connections using wss://.
     /// If TLS configuration fails, starting the server will result in an error.
@@ -111,6 +144,20 @@ impl WebSocketServer {
         self
     }
 
+    /// Hand TLS sessions to the kernel once their handshake is complete, on Linux.
+    ///
+    /// With kernel TLS offload, messages are encrypted by the kernel as they are written to the
+    /// socket, instead of being copied and encrypted in userspace, which reduces the CPU cost of
+    /// serving high-bandwidth clients. It requires the `tls` kernel module. If the kernel doesn't
+    /// support it, the server logs a warning and encrypts in userspace. Ignored on other platforms,
+    /// or without [TLS][Self::tls].
+    #[doc(hidden)]
+    #[cfg(feature = "websocket-tls")]
+    pub fn kernel_tls(mut self, enabled: bool) -> Self {
+        self.options.kernel_tls = enabled;
+        self
+    }
+
     /// Sets the server capabilities to advertise to the client.
     ///
     /// By default, the server does not advertise any capabilities.
@@ -126,6 +173,18 @@ impl WebSocketServer {
         self
     }
 
+    /// Hands the token of a [`SharedMemorySink`][crate::SharedMemorySink] to clients.
+    ///
+    /// The token is sent in the server info metadata, under the
+    /// [`SHARED_MEMORY_SERVER_INFO_KEY`][crate::websocket::SHARED_MEMORY_SERVER_INFO_KEY] key.
+    /// Clients on the same host may read messages from the sink's ring buffer instead of the
+    /// WebSocket connection.
+    #[cfg(unix)]
+    pub fn shared_memory_sink(mut self, sink: &SharedMemorySinkHandle) -> Self {
+        self.options.shared_memory_token = Some(sink.token().to_string());
+        self
+    }
+
     /// Declare the time range for playback, in absolute nanoseconds. This applies if the server is playing back a fixed time range of data.
     /// This will add the PlaybackControl capability to the server.
     pub fn playback_time_range(mut self, start_time: u64, end_time: u64) -> Self {
@@ -171,6 +230,57 @@ impl WebSocketServer {
         self
     }
 
+    /// Cache successful fetch asset responses in memory, keyed by URI, up to a total of `bytes`.
+    ///
+    /// Requests for a cached URI are answered from the cache without invoking the fetch asset
+    /// handler, so that clients which reconnect don't cause assets to be read again. When the
+    /// cache is full, the least recently used assets are evicted. Assets larger than the budget
+    /// are not cached. A value of zero disables the cache, which is the default.
+    ///
+    /// Cached assets are not refreshed, so this should only be enabled if the asset for a URI
+    /// does not change while the server runs, and does not depend on which client requested it.
+    pub fn fetch_asset_cache(mut self, bytes: usize) -> Self {
+        self.options.fetch_asset_cache_bytes = (bytes > 0).then_some(bytes);
+        self
+    }
+
+    /// Collect published parameter values for `window` before sending them to clients.
+    ///
+    /// Bursts of calls to [`WebSocketServerHandle::publish_parameter_values`], such as when a
+    /// configuration is reloaded, then result in a single message to each client, containing the
+    /// latest value of each parameter. By default, values are sent immediately.
+    ///
+    /// In either case, each client is only sent the values it has not already been sent.
+    pub fn parameter_coalesce_window(mut self, window: Duration) -> Self {
+        self.options.parameter_coalesce_window = (!window.is_zero()).then_some(window);
+        self
+    }
+
+    /// Collect connection graph changes for `window` before sending them to clients.
+    ///
+    /// Graph changes tend to arrive in bursts, such as when a node starts and advertises all of
+    /// its topics. With a window, a burst of calls to
+    /// [`WebSocketServerHandle::publish_connection_graph`] or
+    /// [`WebSocketServerHandle::update_connection_graph`] results in a single update to each
+    /// client, sent at most once per window. By default, changes are sent immediately.
+    pub fn connection_graph_coalesce_window(mut self, window: Duration) -> Self {
+        self.options.connection_graph_coalesce_window = (!window.is_zero()).then_some(window);
+        self
+    }
+
+    /// Send time and playback state broadcasts to clients at most once per `window`.
+    ///
+    /// With a window, [`WebSocketServerHandle::broadcast_time`] and
+    /// [`WebSocketServerHandle::broadcast_playback_state`] can be called at a high rate, such as
+    /// on every tick of a simulation. The first broadcast after a quiet window is sent
+    /// immediately; later broadcasts within the window replace one another, and the latest is
+    /// sent at the end of the window from the server's runtime. By default, every broadcast is
+    /// sent immediately.
+    pub fn broadcast_coalesce_window(mut self, window: Duration) -> Self {
+        self.options.broadcast_coalesce_window = (!window.is_zero()).then_some(window);
+        self
+    }
+
     /// Configure the handler for client-initiated parameter operations.
     ///
     /// When set, the handler takes precedence over the deprecated parameter callbacks on
@@ -192,6 +302,178 @@ impl WebSocketServer {
         self
     }
 
+    /// Set the maximum number of bytes queued for each client.
+    ///
+    /// When the messages queued for a client exceed this size, messages are dropped according to
+    /// the [`backlog drop policy`][Self::backlog_drop_policy], as when the message backlog size is
+    /// exceeded. A budget in bytes bounds the memory used by a slow client whatever the size of the
+    /// logged messages, and limits the latency of a client on a slow link to roughly the budget
+    /// divided by its bandwidth. The most recent message is always queued, even if it is larger
+    /// than the budget.
+    ///
+    /// By default, or if set to zero, the backlog is only limited by its number of messages.
+    pub fn message_backlog_bytes(mut self, bytes: usize) -> Self {
+        self.options.message_backlog_bytes = (bytes > 0).then_some(bytes);
+        self
+    }
+
+    /// Set the maximum number of bytes queued for each channel of each client.
+    ///
+    /// When the messages queued for a client on one channel exceed this size, the oldest messages
+    /// of that channel are dropped, so that a high-bandwidth channel cannot take up the whole
+    /// backlog. The most recent message of the channel is always queued.
+    ///
+    /// By default, or if set to zero, channels are not limited individually.
+    pub fn channel_backlog_bytes(mut self, bytes: usize) -> Self {
+        self.options.channel_backlog_bytes = (bytes > 0).then_some(bytes);
+        self
+    }
+
+    /// Set how messages are dropped when a client's backlog exceeds its limits.
+    ///
+    /// By default, the oldest messages are dropped. With
+    /// [`BacklogDropPolicy::KeepLatestPerChannel`], stale messages on high-rate channels are
+    /// dropped first, so that slow clients keep receiving the messages of low-rate channels.
+    pub fn backlog_drop_policy(mut self, policy: BacklogDropPolicy) -> Self {
+        self.options.backlog_drop_policy = policy;
+        self
+    }
+
+    /// Set how the messages of each client subscription are delivered.
+    ///
+    /// By default, every message logged to a subscribed channel is queued for the client, and the
+    /// backlog limits decide which messages are dropped when a client falls behind. A maximum rate
+    /// downsamples each subscription, and conflation keeps only the latest message of each
+    /// subscription queued, so that its rate adapts to how fast the client drains its queue. This
+    /// is useful for clients on slow links, such as remote operators watching camera topics.
+    pub fn subscription_options(mut self, options: SubscriptionOptions) -> Self {
+        self.options.subscription_options = options;
+        self
+    }
+
+    /// Enable the permessage-deflate WebSocket extension.
+    ///
+    /// Clients which offer the extension during the handshake, such as web browsers, receive
+    /// compressed messages, which reduces bandwidth on slow links at the cost of CPU time on the
+    /// server. Other clients are unaffected. Small messages are always sent uncompressed.
+    ///
+    /// By default, compression is disabled.
+    pub fn compression(mut self, enabled: bool) -> Self {
+        self.options.compression = enabled;
+        self
+    }
+
+    /// Sets a [`SinkChannelFilter`] which selects the channels whose messages are compressed, when
+    /// [compression][Self::compression] is enabled.
+    ///
+    /// By default, all channels are compressed except those with schemas for data which is already
+    /// compressed, such as `foxglove.CompressedImage` and `foxglove.CompressedVideo`, which gain
+    /// little from compression.
+    pub fn compression_filter(mut self, filter: Arc<dyn SinkChannelFilter>) -> Self {
+        self.options.compression_filter = Some(filter);
+        self
+    }
+
+    /// Sets a compression filter. See [`compression_filter`][Self::compression_filter] for more
+    /// information.
+    pub fn compression_filter_fn(
+        mut self,
+        filter: impl Fn(&ChannelDescriptor) -> bool + Sync + Send + 'static,
+    ) -> Self {
+        self.options.compression_filter = Some(Arc::new(SinkChannelFilterFn(filter)));
+        self
+    }
+
+    /// Transcode image channels to video for clients, with encoders created by the factory.
+    ///
+    /// For each channel of raw or compressed images, the server advertises a derived
+    /// `foxglove.CompressedVideo` channel, with the topic of the image channel suffixed with
+    /// `/video`. Clients on slow links can subscribe to the video instead of the images. Each
+    /// image is transcoded once, however many clients are subscribed, and only while at least one
+    /// client is subscribed. A new subscriber starts with a keyframe.
+    ///
+    /// The SDK doesn't include a video encoder: the factory wraps one provided by the caller, for
+    /// example a hardware encoder with a fallback to software. Transcoding is only available from
+    /// Rust. By default, image channels are not transcoded.
+    #[cfg(feature = "websocket-video")]
+    pub fn video_transcode(mut self, factory: Arc<dyn VideoEncoderFactory>) -> Self {
+        self.options.video_encoder_factory = Some(factory);
+        self
+    }
+
+    /// Sets a [`SinkChannelFilter`] which selects the image channels which are transcoded to
+    /// video, when [video transcoding][Self::video_transcode] is enabled.
+    ///
+    /// By default, all image channels are transcoded.
+    #[cfg(feature = "websocket-video")]
+    pub fn video_transcode_filter(mut self, filter: Arc<dyn SinkChannelFilter>) -> Self {
+        self.options.video_transcode_filter = Some(filter);
+        self
+    }
+
+    /// Sets a video transcoding filter. See [`video_transcode_filter`][Self::video_transcode_filter]
+    /// for more information.
+    #[cfg(feature = "websocket-video")]
+    pub fn video_transcode_filter_fn(
+        mut self,
+        filter: impl Fn(&ChannelDescriptor) -> bool + Sync + Send + 'static,
+    ) -> Self {
+        self.options.video_transcode_filter = Some(Arc::new(SinkChannelFilterFn(filter)));
+        self
+    }
+
+    /// Set how long the server waits for more messages to batch with a client's next message.
+    ///
+    /// Clients which enable message batches, when the server advertises
+    /// [`Capability::MessageBatches`], receive several messages in each binary frame. By default,
+    /// a batch only gathers the messages already queued for the client, so batching adds no
+    /// latency. A linger delays the first message of each batch by up to this long, trading
+    /// latency for fewer, larger frames. The linger should be kept small, since the client's other
+    /// messages also wait while a batch is gathered.
+    pub fn message_batch_linger(mut self, linger: Duration) -> Self {
+        self.options.message_batch_linger = Some(linger);
+        self
+    }
+
+    /// Set the maximum size of a message batch, in bytes. See
+    /// [`message_batch_linger`][Self::message_batch_linger].
+    ///
+    /// Larger messages are sent in their own frames. The default is 64 KiB.
+    pub fn message_batch_bytes(mut self, bytes: usize) -> Self {
+        self.options.message_batch_bytes = Some(bytes);
+        self
+    }
+
+    /// Set the number of threads used to send messages to clients.
+    ///
+    /// Each client's connection runs as a task which writes its queued messages to the socket.
+    /// By default, client tasks run on the server's tokio runtime. If set, the server creates a
+    /// dedicated runtime with this many threads for its client tasks, so that writes to many
+    /// clients proceed in parallel, without competing with other tasks on the runtime. A value of
+    /// zero uses the default.
+    ///
+    /// Messages are serialized once, and the frame is shared by the queues of all clients with
+    /// the same subscription id, so logging cost does not grow with the number of clients.
+    pub fn writer_threads(mut self, threads: usize) -> Self {
+        self.options.writer_threads = (threads > 0).then_some(threads);
+        self
+    }
+
+    /// Bind the server's listener with `SO_REUSEPORT`.
+    ///
+    /// Several servers sharing a context can then listen on the same address and port, and the
+    /// kernel distributes incoming connections across them. Together with
+    /// [`writer_threads`][Self::writer_threads], this shards the network I/O of many clients
+    /// across servers with their own runtimes. Each server is a separate sink, so logged
+    /// messages are serialized once per server.
+    ///
+    /// Every server sharing the port must set this option. It is only supported on Unix
+    /// platforms; elsewhere, starting the server fails.
+    pub fn reuse_port(mut self, reuse_port: bool) -> Self {
+        self.options.reuse_port = reuse_port;
+        self
+    }
+
     /// Configure the set of services to advertise to clients.
     ///
     /// Automatically adds [`Capability::Services`] to the set of advertised capabilities.
@@ -303,6 +585,15 @@ impl WebSocketServerHandle {
         self.0.client_count()
     }
 
+    /// Returns the delivery counters of each connected client.
+    ///
+    /// The counters include the number of messages sent and dropped for each subscribed channel,
+    /// and the high-water marks of each client's backlog. See also
+    /// [`ServerListener::on_backpressure`][crate::websocket::ServerListener::on_backpressure].
+    pub fn stats(&self) -> Vec<ClientStats> {
+        self.0.stats()
+    }
+
     /// Returns an app URL to open the WebSocket connection as a data source.
     pub fn app_url(&self) -> AppUrl {
         let protocol = if self.0.is_tls_configured() {
@@ -337,7 +628,8 @@ impl WebSocketServerHandle {
 
     /// Publishes the current server timestamp to all clients.
     ///
-    /// Requires the [`Time`](crate::websocket::Capability::Time) capability.
+    /// Requires the [`Time`](crate::websocket::Capability::Time) capability. See
+    /// [`WebSocketServer::broadcast_coalesce_window`] to limit the rate of broadcasts.
     pub fn broadcast_time(&self, timestamp_nanos: u64) {
         self.0.broadcast_time(timestamp_nanos);
     }
@@ -345,6 +637,7 @@ impl WebSocketServerHandle {
     /// Publish the current playback state to all clients.
     ///
     /// Requires the [`PlaybackControl`](crate::websocket::Capability::PlaybackControl) capability.
+    /// See [`WebSocketServer::broadcast_coalesce_window`] to limit the rate of broadcasts.
     pub fn broadcast_playback_state(&self, playback_state: PlaybackState) {
         self.0.broadcast_playback_state(playback_state);
     }
@@ -356,6 +649,9 @@ impl WebSocketServerHandle {
     }
 
     /// Publishes parameter values to all subscribed clients.
+    ///
+    /// Each client is only sent the values it has not already been sent. See
+    /// [`WebSocketServer::parameter_coalesce_window`] to combine bursts of updates.
     pub fn publish_parameter_values(&self, parameters: Vec<Parameter>) {
         self.0.publish_parameter_values(parameters);
     }
@@ -386,6 +682,20 @@ impl WebSocketServerHandle {
         self.0.replace_connection_graph(replacement_graph)
     }
 
+    /// Applies a [ConnectionGraphPatch] to the published connection graph, and sends the changes
+    /// to all subscribed clients.
+    ///
+    /// Requires the [`ConnectionGraph`](crate::websocket::Capability::ConnectionGraph) capability.
+    ///
+    /// Unlike [`publish_connection_graph`](Self::publish_connection_graph), this does not require
+    /// the complete graph, and only the topics and services named in the patch are compared.
+    pub fn update_connection_graph(
+        &self,
+        patch: ConnectionGraphPatch,
+    ) -> Result<(), FoxgloveError> {
+        self.0.update_connection_graph(patch)
+    }
+
     /// Gracefully shut down the WebSocket server.
     ///
     /// Returns a handle that can be used to wait for the graceful shutdown to complete. If the
@@ -150,6 +150,20 @@ macro_rules! export {
                         .get_backfill(args)
                         .map_err(|err| err.to_string())
                 }
+
+                fn build_index(&self) -> Result<Vec<loader::IndexEntry>, String> {
+                    self.loader.borrow_mut()
+                        .build_index()
+                        .map_err(|err| err.to_string())
+                }
+
+                fn load_index(&self, index: Vec<loader::IndexEntry>) {
+                    self.loader.borrow_mut().load_index(index)
+                }
+
+                fn supports_concurrent_iterators(&self) -> bool {
+                    self.loader.borrow().supports_concurrent_iterators()
+                }
             }
 
             struct MessageIteratorWrapper {
@@ -162,6 +176,36 @@ macro_rules! export {
                         .next()
                         .map(|r| r.map_err(|err| err.to_string()))
                 }
+
+                fn next_batch(
+                    &self,
+                    max_messages: u32,
+                    max_bytes: u64,
+                ) -> Vec<Result<loader::Message, String>> {
+                    self.message_iterator.borrow_mut()
+                        .next_batch(
+                            max_messages as usize,
+                            usize::try_from(max_bytes).unwrap_or(usize::MAX),
+                        )
+                        .into_iter()
+                        .map(|r| r.map_err(|err| err.to_string()))
+                        .collect()
+                }
+
+                fn next_batch_refs(
+                    &self,
+                    max_messages: u32,
+                    max_bytes: u64,
+                ) -> Vec<Result<loader::MessageRef, String>> {
+                    self.message_iterator.borrow_mut()
+                        .next_batch_refs(
+                            max_messages as usize,
+                            usize::try_from(max_bytes).unwrap_or(usize::MAX),
+                        )
+                        .into_iter()
+                        .map(|r| r.map_err(|err| err.to_string()))
+                        .collect()
+                }
             }
         }
     }
@@ -173,12 +217,12 @@ use std::{cell::RefCell, rc::Rc};
 
 #[doc(inline)]
 pub use __generated::exports::foxglove::loader::loader::{
-    BackfillArgs, Channel, ChannelId, DataLoaderArgs, Message, MessageIteratorArgs, Schema,
-    SchemaId, Severity, TimeRange,
+    BackfillArgs, Channel, ChannelId, DataLoaderArgs, FileRange, IndexEntry, Message, MessageData,
+    MessageIteratorArgs, MessageRef, Schema, SchemaId, Severity, TimeRange,
 };
 
 #[doc(inline)]
-pub use __generated::foxglove::loader::{console, reader};
+pub use __generated::foxglove::loader::{codec, console, reader};
 
 // This is used by the export macro but shouldn't be accessed directly.
 #[doc(hidden)]
@@ -213,6 +257,46 @@ impl std::io::Seek for reader::Reader {
     }
 }
 
+impl reader::Reader {
+    /// Read several ranges of the file in a single call to the host.
+    ///
+    /// Each `(offset, buffer)` pair fills `buffer` with the file's data starting at `offset`.
+    /// Returns the number of bytes read into each buffer, which is less than the buffer's length
+    /// if the range extends past the end of the file. The position of the reader is unchanged.
+    ///
+    /// The host may coalesce adjacent ranges and fetch them in parallel, which is much faster than
+    /// seeking and reading each range in turn, particularly for remote files.
+    pub fn read_ranges_into(&self, ranges: &mut [(u64, &mut [u8])]) -> Vec<usize> {
+        let ranges: Vec<reader::ReadRange> = ranges
+            .iter_mut()
+            .map(|(offset, buf)| reader::ReadRange {
+                offset: *offset,
+                ptr: buf.as_mut_ptr() as _,
+                len: buf.len() as _,
+            })
+            .collect();
+        reader::Reader::read_ranges(self, &ranges)
+            .into_iter()
+            .map(|len| len as usize)
+            .collect()
+    }
+}
+
+impl codec::Compression {
+    /// Decompress `data` into a new buffer, using the host's implementation of the codec.
+    ///
+    /// `uncompressed_len` is the size of the decompressed data, which formats such as MCAP record
+    /// alongside the compressed data. Returns an error if the data is invalid or its decompressed
+    /// size exceeds `uncompressed_len`.
+    pub fn decompress(self, data: &[u8], uncompressed_len: usize) -> Result<Vec<u8>, String> {
+        let mut buf = Vec::with_capacity(uncompressed_len);
+        let len = codec::decompress(self, data, buf.as_mut_ptr() as _, uncompressed_len as _)?;
+        // SAFETY: The host wrote `len` bytes into the buffer's spare capacity.
+        unsafe { buf.set_len((len as usize).min(uncompressed_len)) };
+        Ok(buf)
+    }
+}
+
 /// Problems can be used to display info in the "problems" panel during playback.
 ///
 /// They are for non-fatal issues that the user should be aware of.
@@ -713,12 +797,121 @@ pub trait DataLoader: 'static + Sized {
     ) -> Result<Vec<loader::Message>, Self::Error> {
         Ok(Vec::new())
     }
+
+    /// Build a seek index over the input files, so that iterators can start near their start time
+    /// (see [`find_index_offset`]) instead of reading the files from the beginning. This is called
+    /// once after [`initialize`](Self::initialize).
+    ///
+    /// The host caches the index per file, keyed by size and modification time, and passes it to
+    /// [`load_index`](Self::load_index) instead of calling this method when the same files are
+    /// loaded again.
+    ///
+    /// This trait has a default implementation that returns an empty index. Implement this method
+    /// to speed up seeking within formats that have no index of their own.
+    fn build_index(&mut self) -> Result<Vec<IndexEntry>, Self::Error> {
+        Ok(Vec::new())
+    }
+
+    /// Receive an index returned by an earlier [`build_index`](Self::build_index) call on the same
+    /// files. The default implementation ignores it.
+    fn load_index(&mut self, _index: Vec<IndexEntry>) {}
+
+    /// Return true to allow the host to drive several iterators concurrently, e.g. one per file or
+    /// time slice, and merge their messages by log time. Only do so if iterators share no mutable
+    /// state with each other or with [`get_backfill`](Self::get_backfill).
+    ///
+    /// This trait has a default implementation that returns false.
+    fn supports_concurrent_iterators(&self) -> bool {
+        false
+    }
+}
+
+/// Returns the offset from which to read the messages in `file` logged at or after `time`.
+///
+/// This is the offset of the latest entry for `file` with a log time at or before `time`, or
+/// `None` if there is no such entry, in which case the file must be read from the beginning.
+pub fn find_index_offset(index: &[IndexEntry], file: u32, time: u64) -> Option<u64> {
+    index
+        .iter()
+        .filter(|entry| entry.file == file && entry.log_time <= time)
+        .max_by_key(|entry| entry.log_time)
+        .map(|entry| entry.offset)
+}
+
+impl MessageData {
+    /// Returns the length of the message data in bytes.
+    pub fn len(&self) -> u64 {
+        match self {
+            MessageData::Bytes(data) => data.len() as u64,
+            MessageData::FileRange(range) => range.len,
+        }
+    }
+
+    /// Returns true if the message data is empty.
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+}
+
+impl From<Message> for MessageRef {
+    fn from(message: Message) -> Self {
+        MessageRef {
+            channel_id: message.channel_id,
+            log_time: message.log_time,
+            publish_time: message.publish_time,
+            data: MessageData::Bytes(message.data),
+        }
+    }
 }
 
 /// Implement [`MessageIterator`] for your loader iterator.
 pub trait MessageIterator: 'static + Sized {
     type Error: Into<Box<dyn std::error::Error>>;
     fn next(&mut self) -> Option<Result<Message, Self::Error>>;
+
+    /// Return up to `max_messages` results, stopping early once the data of the returned messages
+    /// reaches `max_bytes`. An empty batch indicates that no more messages can be read.
+    ///
+    /// The host fetches messages in batches to reduce the number of calls into the data loader,
+    /// which dominate load time for files with many small messages. The default implementation
+    /// calls [`next`](Self::next) until the batch is full.
+    fn next_batch(
+        &mut self,
+        max_messages: usize,
+        max_bytes: usize,
+    ) -> Vec<Result<Message, Self::Error>> {
+        let mut batch = Vec::new();
+        let mut bytes = 0;
+        while batch.len() < max_messages && bytes < max_bytes {
+            let Some(result) = self.next() else {
+                break;
+            };
+            if let Ok(message) = &result {
+                bytes += message.data.len();
+            }
+            batch.push(result);
+        }
+        batch
+    }
+
+    /// Like [`next_batch`](Self::next_batch), but the data of a message which is stored verbatim
+    /// in an input file may be returned as its [`FileRange`] with [`MessageData::FileRange`]. The
+    /// host then reads the data from the file itself, rather than copying it out of the data
+    /// loader's memory, which saves a copy of every payload for formats with large messages such
+    /// as images. `max_bytes` counts the data of messages of both kinds.
+    ///
+    /// The default implementation returns the messages of [`next_batch`](Self::next_batch), with
+    /// their data as [`MessageData::Bytes`].
+    fn next_batch_refs(
+        &mut self,
+        max_messages: usize,
+        max_bytes: usize,
+    ) -> Vec<Result<MessageRef, Self::Error>> {
+        self.next_batch(max_messages, max_bytes)
+            .into_iter()
+            .map(|result| result.map(MessageRef::from))
+            .collect()
+    }
 }
 
 #[doc(hidden)]
@@ -219,3 +219,79 @@ fn test_set_time_range() {
     assert_eq!(init.time_range.start_time, 50);
     assert_eq!(init.time_range.end_time, 60);
 }
+
+struct CountingIterator {
+    remaining: usize,
+}
+
+impl MessageIterator for CountingIterator {
+    type Error = String;
+
+    fn next(&mut self) -> Option<Result<Message, Self::Error>> {
+        if self.remaining == 0 {
+            return None;
+        }
+        self.remaining -= 1;
+        Some(Ok(Message {
+            channel_id: 1,
+            log_time: 0,
+            publish_time: 0,
+            data: vec![0; 10],
+        }))
+    }
+}
+
+#[test]
+fn test_next_batch_respects_limits() {
+    let mut iter = CountingIterator { remaining: 10 };
+
+    assert_eq!(iter.next_batch(4, usize::MAX).len(), 4);
+    // The message which reaches the byte limit is still included.
+    assert_eq!(iter.next_batch(usize::MAX, 15).len(), 2);
+    assert_eq!(iter.next_batch(usize::MAX, usize::MAX).len(), 4);
+    assert!(iter.next_batch(usize::MAX, usize::MAX).is_empty());
+}
+
+#[test]
+fn test_next_batch_refs_defaults_to_bytes() {
+    let mut iter = CountingIterator { remaining: 3 };
+
+    let batch = iter.next_batch_refs(usize::MAX, usize::MAX);
+    assert_eq!(batch.len(), 3);
+    for result in batch {
+        let message = result.unwrap();
+        assert_eq!(message.channel_id, 1);
+        assert!(matches!(&message.data, MessageData::Bytes(data) if data.len() == 10));
+        assert_eq!(message.data.len(), 10);
+    }
+    assert!(iter.next_batch_refs(usize::MAX, usize::MAX).is_empty());
+
+    let range = MessageData::FileRange(FileRange {
+        file: 0,
+        offset: 100,
+        len: 42,
+    });
+    assert_eq!(range.len(), 42);
+}
+
+#[test]
+fn test_find_index_offset() {
+    let entry = |file, log_time, offset| IndexEntry {
+        file,
+        log_time,
+        offset,
+    };
+    let index = [
+        entry(0, 100, 0),
+        entry(0, 200, 1000),
+        entry(1, 150, 50),
+        entry(0, 300, 2000),
+    ];
+
+    assert_eq!(find_index_offset(&index, 0, 50), None);
+    assert_eq!(find_index_offset(&index, 0, 200), Some(1000));
+    assert_eq!(find_index_offset(&index, 0, 250), Some(1000));
+    assert_eq!(find_index_offset(&index, 0, u64::MAX), Some(2000));
+    assert_eq!(find_index_offset(&index, 1, 200), Some(50));
+    assert_eq!(find_index_offset(&index, 2, 200), None);
+}
@@ -42,6 +42,37 @@ function protoImportPath(schema: FoxgloveMessageSchema): string {
   return `foxglove/${schema.name}`;
 }
 
+type NumberedField = FoxgloveMessageField & { protobufFieldNumber: number };
+
+/**
+ * Assign a protobuf field number to each field of `schema`: fields with an explicit
+ * `protobufFieldNumber` keep it, and the rest are numbered in order, skipping the explicit numbers.
+ */
+export function numberProtobufFields(schema: FoxgloveMessageSchema): NumberedField[] {
+  const explicitFieldNumbers = new Set<number>();
+  for (const field of schema.fields) {
+    if (field.protobufFieldNumber != undefined) {
+      if (explicitFieldNumbers.has(field.protobufFieldNumber)) {
+        throw new Error(
+          `More than one field with protobufFieldNumber ${field.protobufFieldNumber}`,
+        );
+      }
+      explicitFieldNumbers.add(field.protobufFieldNumber);
+    }
+  }
+
+  let nextFieldNumber = 1;
+  return schema.fields.map((field): NumberedField => {
+    if (field.protobufFieldNumber != undefined) {
+      return { ...field, protobufFieldNumber: field.protobufFieldNumber };
+    }
+    while (explicitFieldNumbers.has(nextFieldNumber)) {
+      ++nextFieldNumber;
+    }
+    return { ...field, protobufFieldNumber: nextFieldNumber++ };
+  });
+}
+
 export function generateProto(
   schema: FoxgloveMessageSchema,
   nestedEnums: FoxgloveEnumSchema[],
@@ -62,30 +93,7 @@ export function generateProto(
     );
   }
 
-  const explicitFieldNumbers = new Set<number>();
-  for (const field of schema.fields) {
-    if (field.protobufFieldNumber != undefined) {
-      if (explicitFieldNumbers.has(field.protobufFieldNumber)) {
-        throw new Error(
-          `More than one field with protobufFieldNumber ${field.protobufFieldNumber}`,
-        );
-      }
-      explicitFieldNumbers.add(field.protobufFieldNumber);
-    }
-  }
-
-  let nextFieldNumber = 1;
-  const numberedFields = schema.fields.map(
-    (field): FoxgloveMessageField & { protobufFieldNumber: number } => {
-      if (field.protobufFieldNumber != undefined) {
-        return { ...field, protobufFieldNumber: field.protobufFieldNumber };
-      }
-      while (explicitFieldNumbers.has(nextFieldNumber)) {
-        ++nextFieldNumber;
-      }
-      return { ...field, protobufFieldNumber: nextFieldNumber++ };
-    },
-  );
+  const numberedFields = numberProtobufFields(schema);
 
   const imports = new Set<string>();
   const fields = numberedFields.map((field) => {
@@ -1,6 +1,10 @@
-import assert from "assert";
-
-import { FoxgloveEnumSchema, FoxgloveMessageSchema, FoxglovePrimitive } from "./types";
+import { numberProtobufFields } from "./generateProto";
+import {
+  FoxgloveEnumSchema,
+  FoxgloveMessageField,
+  FoxgloveMessageSchema,
+  FoxglovePrimitive,
+} from "./types";
 
 function primitiveToCpp(type: FoxglovePrimitive) {
   switch (type) {
@@ -52,10 +56,6 @@ function formatComment(comment: string, indent: number) {
     .join("\n");
 }
 
-function toCamelCase(name: string) {
-  return name.substring(0, 1).toLowerCase() + name.substring(1);
-}
-
 function toSnakeCase(name: string) {
   const snakeName = name
     .replace("JSON", "Json")
@@ -64,16 +64,6 @@ function toSnakeCase(name: string) {
   return snakeName.startsWith("_") ? snakeName.substring(1) : snakeName;
 }
 
-function isSameAsCType(schema: FoxgloveMessageSchema): boolean {
-  return schema.fields.every(
-    (field) =>
-      field.type.type === "primitive" &&
-      field.type.name !== "bytes" &&
-      field.type.name !== "string" &&
-      !field.optional,
-  );
-}
-
 /**
  * Yield `schemas` in an order such that dependencies come before dependents, so structs don't end
  * up referencing [incomplete types](https://en.cppreference.com/w/cpp/language/incomplete_type).
@@ -104,6 +94,91 @@ function shouldGenerateChannel(schema: FoxgloveMessageSchema): boolean {
   return schema.name !== "Timestamp" && schema.name !== "Duration";
 }
 
+/**
+ * Message types with a top-level `bytes` payload also get a borrowed `View` struct, which lets
+ * callers log data they already own without first copying it into a `std::vector`.
+ */
+function shouldGenerateView(schema: FoxgloveMessageSchema): boolean {
+  return (
+    shouldGenerateChannel(schema) &&
+    schema.fields.some(
+      (field) =>
+        field.type.type === "primitive" && field.type.name === "bytes" && field.array == undefined,
+    )
+  );
+}
+
+function fieldTypeAndDefault(field: FoxgloveMessageField): {
+  fieldType: string;
+  defaultStr: string;
+} {
+  let fieldType;
+  let defaultStr = "";
+  switch (field.type.type) {
+    case "enum":
+      fieldType = field.type.enum.name;
+      defaultStr = "{}";
+      break;
+    case "nested":
+      fieldType = field.type.schema.name;
+      break;
+    case "primitive": {
+      const defaultValue =
+        field.array != undefined ? undefined : primitiveDefaultValue(field.type.name);
+      defaultStr = defaultValue != undefined ? ` = ${defaultValue.toString()}` : "";
+      fieldType = primitiveToCpp(field.type.name);
+      break;
+    }
+  }
+  if (typeof field.array === "number") {
+    fieldType = `std::array<${fieldType}, ${field.array}>`;
+    // std::array has no user-provided default constructor; explicit
+    // init required for clang-tidy cppcoreguidelines-pro-type-member-init.
+    defaultStr = " = {}";
+  } else if (field.array) {
+    fieldType = `std::vector<${fieldType}>`;
+  } else if (field.optional || field.type.type === "nested") {
+    fieldType = `std::optional<${fieldType}>`;
+    // Override any inner-type default (e.g. uint32_t's `= 0`) so the
+    // optional defaults to disengaged rather than engaged-with-default.
+    if (defaultStr !== "") {
+      defaultStr = " = std::nullopt";
+    }
+  }
+  return { fieldType, defaultStr };
+}
+
+function generateViewStruct(schema: FoxgloveMessageSchema): string {
+  const fields = schema.fields.map((field) => {
+    const name = toSnakeCase(field.name);
+    const comment = `  /// @brief See ${schema.name}::${name}.`;
+    if (field.type.type === "primitive" && field.array == undefined) {
+      if (field.type.name === "bytes") {
+        return [
+          comment,
+          `  const std::byte* ${name} = nullptr;`,
+          "",
+          `  /// @brief Length of ${name}, in bytes.`,
+          `  size_t ${name}_len = 0;`,
+        ].join("\n");
+      } else if (field.type.name === "string") {
+        return `${comment}\n  std::string_view ${name};`;
+      }
+    }
+    const { fieldType, defaultStr } = fieldTypeAndDefault(field);
+    return `${comment}\n  ${fieldType} ${name}${defaultStr};`;
+  });
+  return [
+    `/// @brief A borrowed view of a ${schema.name}, for logging without copying the payload.`,
+    "///",
+    "/// String and byte fields reference memory owned by the caller, which must remain valid for the",
+    `/// duration of the log call. All other fields have the same types as in ${schema.name}.`,
+    `struct ${schema.name}View {`,
+    fields.join("\n\n"),
+    "};",
+  ].join("\n");
+}
+
 export function generateHppSchemas(
   schemas: readonly FoxgloveMessageSchema[],
   enums: readonly FoxgloveEnumSchema[],
@@ -147,39 +222,7 @@ export function generateHppSchemas(
       ...enumDef,
       schema.fields
         .map((field) => {
-          let fieldType;
-          let defaultStr = "";
-          switch (field.type.type) {
-            case "enum":
-              fieldType = field.type.enum.name;
-              defaultStr = "{}";
-              break;
-            case "nested":
-              fieldType = field.type.schema.name;
-              break;
-            case "primitive": {
-              const defaultValue =
-                field.array != undefined ? undefined : primitiveDefaultValue(field.type.name);
-              defaultStr = defaultValue != undefined ? ` = ${defaultValue.toString()}` : "";
-              fieldType = primitiveToCpp(field.type.name);
-              break;
-            }
-          }
-          if (typeof field.array === "number") {
-            fieldType = `std::array<${fieldType}, ${field.array}>`;
-            // std::array has no user-provided default constructor; explicit
-            // init required for clang-tidy cppcoreguidelines-pro-type-member-init.
-            defaultStr = " = {}";
-          } else if (field.array) {
-            fieldType = `std::vector<${fieldType}>`;
-          } else if (field.optional || field.type.type === "nested") {
-            fieldType = `std::optional<${fieldType}>`;
-            // Override any inner-type default (e.g. uint32_t's `= 0`) so the
-            // optional defaults to disengaged rather than engaged-with-default.
-            if (defaultStr !== "") {
-              defaultStr = " = std::nullopt";
-            }
-          }
+          const { fieldType, defaultStr } = fieldTypeAndDefault(field);
           return `${formatComment(field.description, 2)}\n  ${fieldType} ${toSnakeCase(field.name)}${defaultStr};`;
         })
         .join("\n\n"),
@@ -191,13 +234,28 @@ export function generateHppSchemas(
       /// On success, writes the serialized length to *encoded_len.
       /// If the provided buffer has insufficient capacity, writes the required capacity to *encoded_len
       /// and returns FoxgloveError::BufferTooShort.
-      /// If the message cannot be encoded, writes the reason to stderr and returns
-      /// FoxgloveError::EncodeError.
+      /// If the message cannot be encoded, returns the reason, such as FoxgloveError::Utf8Error
+      /// for a string which is not valid UTF-8.
       ///
       /// @param ptr the destination buffer. must point to at least len valid bytes.
       /// @param len the length of the destination buffer.
       /// @param encoded_len where the serialized length or required capacity will be written to.
-      FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len);`,
+      FoxgloveError encode(uint8_t* ptr, size_t len, size_t* encoded_len) const;
+
+      /// @brief Encode the ${schema.name} as protobuf, appending it to the provided buffer.
+      ///
+      /// The buffer is grown to fit the message. Reusing the same buffer across calls (after
+      /// clearing it) avoids reallocating once it has reached its working size. On failure, the
+      /// buffer is left unchanged.
+      ///
+      /// @param buf the buffer to append the serialized message to.
+      FoxgloveError encode(std::vector<uint8_t>& buf) const;
+
+      /// @brief Get the length of the ${schema.name}'s protobuf encoding, in bytes.
+      ///
+      /// This computes the length without serializing the message. If the message cannot be
+      /// encoded, returns the reason, as encode does.
+      [[nodiscard]] FoxgloveResult<size_t> encodedSize() const;`,
             `
       /// @brief Get the ${schema.name} schema.
       ///
@@ -207,6 +265,7 @@ export function generateHppSchemas(
           ]
         : []),
       `};`,
+      ...(shouldGenerateView(schema) ? ["", generateViewStruct(schema)] : []),
     ].join("\n");
   });
 
@@ -223,7 +282,9 @@ export function generateHppSchemas(
         /// compatibility with the Foxglove app.
         /// @param context The context which associates logs to a sink. If omitted, the default context is
         /// used.
-        static FoxgloveResult<${schema.name}Channel> create(const std::string_view& topic, const Context& context = Context());
+        /// @param keep_last The number of most recent messages the channel retains for sinks that
+        /// subscribe later. See RawChannel::create.
+        static FoxgloveResult<${schema.name}Channel> create(const std::string_view& topic, const Context& context = Context(), size_t keep_last = 0);
 
         /// @brief Log a message to the channel.
         ///
@@ -231,6 +292,28 @@ export function generateHppSchemas(
         /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the current time is used.
         /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
         FoxgloveError log(const ${schema.name}& msg, std::optional<uint64_t> log_time = std::nullopt, std::optional<uint64_t> sink_id = std::nullopt) noexcept;
+${
+  shouldGenerateView(schema)
+    ? `
+        /// @brief Log a borrowed view of a message to the channel, without copying its payload.
+        ///
+        /// @param msg The ${schema.name}View message to log.
+        /// @param log_time The timestamp of the message, as nanoseconds since epoch. If omitted, the current time is used.
+        /// @param sink_id The ID of the sink to log to. If omitted, the message is logged to all sinks.
+        FoxgloveError log(const ${schema.name}View& msg, std::optional<uint64_t> log_time = std::nullopt, std::optional<uint64_t> sink_id = std::nullopt) noexcept;
+`
+    : ""
+}
+        /// @brief Log a batch of messages to the channel.
+        ///
+        /// The messages are encoded and handed to each sink in a single call, which is cheaper than
+        /// calling log() once per message when logging many small messages at high rates.
+        ///
+        /// @param msgs The ${schema.name} messages to log. May be null when \`count == 0\`.
+        /// @param count The number of messages.
+        /// @param log_times If non-null, must point to \`count\` timestamps, as nanoseconds since epoch. If null, the current time is used.
+        /// @param sink_id The ID of the sink to log to. If omitted, the messages are logged to all sinks.
+        FoxgloveError logBatch(const ${schema.name}* msgs, size_t count, const uint64_t* log_times = nullptr, std::optional<uint64_t> sink_id = std::nullopt) noexcept;
 
         /// @brief Close the channel.
         ///
@@ -245,9 +328,13 @@ export function generateHppSchemas(
         /// @return The ID of the channel.
         [[nodiscard]] uint64_t id() const noexcept;
 
-        /// @brief Find out if any sinks have been added to the channel.
+        /// @brief Find out if any sinks are subscribed to the channel.
+        ///
+        /// This reflects live subscriptions: sinks that subscribe dynamically, such as the
+        /// WebSocketServer, only count while a client is subscribed to this channel. It is cheap
+        /// enough to call before every log, to skip building messages that no sink would receive.
         ///
-        /// @return True if sinks have been added to the channel, false otherwise.
+        /// @return True if sinks are subscribed to the channel, false otherwise.
         [[nodiscard]] bool hasSinks() const noexcept;
 
         /// @deprecated Use hasSinks() instead.
@@ -278,6 +365,7 @@ export function generateHppSchemas(
     "#include <array>",
     "#include <cstdint>",
     "#include <string>",
+    "#include <string_view>",
     "#include <type_traits>",
     "#include <vector>",
     "#include <optional>",
@@ -321,57 +409,60 @@ export function generateHppSchemas(
   return outputSections.join("\n\n") + "\n";
 }
 
-function cppToC(schema: FoxgloveMessageSchema, copyTypes: Set<string>): string[] {
-  return schema.fields.map((field) => {
-    const srcName = toSnakeCase(field.name);
-    const dstName = srcName;
+/**
+ * Generate the calls which encode each field of a message as protobuf, using the encoder in
+ * cpp/foxglove/src/protobuf_encoder.hpp. Like prost, fields are encoded in field number order, so
+ * the encoding matches the Rust SDK's byte for byte.
+ */
+function cppProtobufFields(schema: FoxgloveMessageSchema, isView = false): string[] {
+  const fields = numberProtobufFields(schema).sort(
+    (a, b) => a.protobufFieldNumber - b.protobufFieldNumber,
+  );
+  return fields.map((field) => {
+    const name = toSnakeCase(field.name);
+    const num = field.protobufFieldNumber;
     if (field.array != undefined) {
-      if (typeof field.array === "number") {
-        if (field.type.type === "primitive" && field.type.name === "string") {
-          return `for (size_t i = 0; i < src.${srcName}.size(); i++) {\n      dest.${dstName}[i] = {src.${srcName}[i].data(), src.${srcName}[i].size()};\n    }`;
-        }
-        return `::memcpy(dest.${dstName}, src.${srcName}.data(), src.${srcName}.size() * sizeof(*src.${srcName}.data()));`;
-      } else {
-        if (field.type.type === "nested") {
-          if (copyTypes.has(field.type.schema.name)) {
-            return `dest.${dstName} = reinterpret_cast<const foxglove_${toSnakeCase(field.type.schema.name)}*>(src.${srcName}.data());\n    dest.${dstName}_count = src.${srcName}.size();`;
-          } else {
-            return `dest.${dstName} = arena.map<foxglove_${toSnakeCase(field.type.schema.name)}>(src.${srcName}, ${toCamelCase(field.type.schema.name)}ToC);
-    dest.${dstName}_count = src.${srcName}.size();`;
-          }
-        } else if (field.type.type === "primitive") {
-          assert(field.type.name !== "bytes");
-          if (field.type.name === "string") {
-            return `dest.${dstName} = arena.map<foxglove_string>(src.${srcName}, [](foxglove_string& dest, const std::string& src, Arena&) {\n      dest = {src.data(), src.size()};\n    });\n    dest.${dstName}_count = src.${srcName}.size();`;
+      switch (field.type.type) {
+        case "nested":
+          return `enc.messages(${num}, msg.${name});`;
+        case "primitive":
+          if (field.type.name === "float64") {
+            return `enc.packedFloat64(${num}, msg.${name});`;
+          } else if (field.type.name === "uint32") {
+            return `enc.packedFixed32(${num}, msg.${name});`;
           }
-          return `dest.${dstName} = src.${srcName}.data();\n    dest.${dstName}_count = src.${srcName}.size();`;
-        } else {
+          throw Error(`unsupported array type: ${field.type.name}`);
+        case "enum":
           throw Error(`unsupported array type: ${field.type.type}`);
-        }
       }
     }
     switch (field.type.type) {
-      case "primitive":
-        if (field.type.name === "string") {
-          return `dest.${dstName} = {src.${srcName}.data(), src.${srcName}.size()};`;
-        } else if (field.type.name === "bytes") {
-          return `dest.${dstName} = reinterpret_cast<const unsigned char *>(src.${srcName}.data());\n    dest.${dstName}_len = src.${srcName}.size();`;
-        }
-        if (field.optional) {
-          return `dest.${dstName} = src.${dstName} ? &*src.${dstName} : nullptr;`;
-        }
-        return `dest.${dstName} = src.${srcName};`;
       case "enum":
-        return `dest.${dstName} = static_cast<foxglove_${toSnakeCase(field.type.enum.name)}>(src.${srcName});`;
+        return `enc.enumeration(${num}, msg.${name});`;
       case "nested":
         if (field.type.schema.name === "Timestamp") {
-          return `dest.${dstName} = src.${srcName} ? reinterpret_cast<const foxglove_timestamp*>(&*src.${srcName}) : nullptr;`;
+          return `enc.timestamp(${num}, msg.${name});`;
         } else if (field.type.schema.name === "Duration") {
-          return `dest.${dstName} = src.${srcName} ? reinterpret_cast<const foxglove_duration*>(&*src.${srcName}) : nullptr;`;
-        } else if (copyTypes.has(field.type.schema.name)) {
-          return `dest.${dstName} = src.${srcName} ? reinterpret_cast<const foxglove_${toSnakeCase(field.type.schema.name)}*>(&*src.${srcName}) : nullptr;`;
-        } else {
-          return `dest.${dstName} = src.${srcName} ? arena.mapOne<foxglove_${toSnakeCase(field.type.schema.name)}>(src.${srcName}.value(), ${toCamelCase(field.type.schema.name)}ToC) : nullptr;`;
+          return `enc.duration(${num}, msg.${name});`;
+        }
+        return `enc.message(${num}, msg.${name});`;
+      case "primitive":
+        switch (field.type.name) {
+          case "bytes":
+            if (isView) {
+              return `enc.bytes(${num}, msg.${name}, msg.${name}_len);`;
+            }
+            return `enc.bytes(${num}, msg.${name}.data(), msg.${name}.size());`;
+          case "string":
+            return `enc.string(${num}, msg.${name});`;
+          case "boolean":
+            return `enc.boolean(${num}, msg.${name});`;
+          case "float64":
+            return `enc.float64(${num}, msg.${name});`;
+          case "uint32":
+            return `enc.fixed32(${num}, msg.${name});`;
+          case "int32":
+            return `enc.sfixed32(${num}, msg.${name});`;
         }
     }
   });
@@ -381,51 +472,45 @@ export function generateCppSchemas(schemas: FoxgloveMessageSchema[]): string {
   // Sort by name
   schemas.sort((a, b) => a.name.localeCompare(b.name));
 
-  const copyTypes = new Set(
-    schemas
-      .map((schema) => {
-        return isSameAsCType(schema) ? schema.name : "";
-      })
-      .filter((name) => name.length > 0),
-  );
+  // Timestamp and Duration are encoded by the encoder itself, which normalizes them.
+  const encodedTypeNames = [
+    ...schemas.filter(shouldGenerateChannel).map((schema) => schema.name),
+    ...schemas.filter(shouldGenerateView).map((schema) => `${schema.name}View`),
+  ].sort((a, b) => a.localeCompare(b));
 
-  const conversionFuncDecls = schemas.flatMap((schema) => {
-    if (isSameAsCType(schema)) {
-      return [];
-    }
-    return [
-      `void ${toCamelCase(schema.name)}ToC(foxglove_${toSnakeCase(schema.name)}& dest, const ${schema.name}& src, Arena& arena);`,
-    ];
+  const protobufFieldsDecls = encodedTypeNames.map((name) => {
+    return `template<typename Encoder>\nstatic void protobufFields(Encoder& enc, const ${name}& msg);`;
   });
 
   const traitSpecializations = schemas.filter(shouldGenerateChannel).flatMap((schema) => {
     const snakeName = toSnakeCase(schema.name);
-    let conversionCode;
-    if (isSameAsCType(schema)) {
-      conversionCode = [
-        `    return FoxgloveError(foxglove_channel_log_${snakeName}(impl_.get(), reinterpret_cast<const foxglove_${snakeName}*>(&msg), log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0));`,
-      ];
-    } else {
-      conversionCode = [
-        "    Arena arena;",
-        `    foxglove_${snakeName} c_msg;`,
-        `    ${toCamelCase(schema.name)}ToC(c_msg, msg, arena);`,
-        `    return FoxgloveError(foxglove_channel_log_${snakeName}(impl_.get(), &c_msg, log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0));`,
-      ];
-    }
-
     return [
-      `FoxgloveResult<${schema.name}Channel> ${schema.name}Channel::create(const std::string_view& topic, const Context& context) {`,
+      `FoxgloveResult<${schema.name}Channel> ${schema.name}Channel::create(const std::string_view& topic, const Context& context, size_t keep_last) {`,
       "    const foxglove_channel* channel = nullptr;",
-      `    foxglove_error error = foxglove_channel_create_${snakeName}({topic.data(), topic.size()}, context.getInner(), &channel);`,
+      "    foxglove_error error;",
+      "    if (keep_last == 0) {",
+      `      error = foxglove_channel_create_${snakeName}({topic.data(), topic.size()}, context.getInner(), &channel);`,
+      "    } else {",
+      `      error = createLatchedChannel(topic, foxglove_${snakeName}_schema(), context, keep_last, &channel);`,
+      "    }",
       "    if (error != foxglove_error::FOXGLOVE_ERROR_OK || channel == nullptr) {",
       "      return tl::unexpected(FoxgloveError(error));",
       "    }",
       `    return ${schema.name}Channel(ChannelUniquePtr(channel));`,
       "}\n",
       `FoxgloveError ${schema.name}Channel::log(const ${schema.name}& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id) noexcept {`,
-      ...conversionCode,
+      "    return logEncoded(impl_.get(), msg, log_time, sink_id);",
+      "}\n",
+      `FoxgloveError ${schema.name}Channel::logBatch(const ${schema.name}* msgs, size_t count, const uint64_t* log_times, std::optional<uint64_t> sink_id) noexcept {`,
+      "    return logEncodedBatch(impl_.get(), msgs, count, log_times, sink_id);",
       "}\n",
+      ...(shouldGenerateView(schema)
+        ? [
+            `FoxgloveError ${schema.name}Channel::log(const ${schema.name}View& msg, std::optional<uint64_t> log_time, std::optional<uint64_t> sink_id) noexcept {`,
+            "    return logEncoded(impl_.get(), msg, log_time, sink_id);",
+            "}\n",
+          ]
+        : []),
       `void ${schema.name}Channel::close() noexcept {
         foxglove_channel_close(impl_.get());
       }
@@ -440,36 +525,77 @@ export function generateCppSchemas(schemas: FoxgloveMessageSchema[]): string {
     ];
   });
 
-  const conversionFuncs = schemas.flatMap((schema) => {
-    if (isSameAsCType(schema)) {
-      return [];
-    }
-    return [
-      `void ${toCamelCase(schema.name)}ToC(foxglove_${toSnakeCase(schema.name)}& dest, const ${schema.name}& src, [[maybe_unused]] Arena& arena) {`,
-      `    ${cppToC(schema, copyTypes).join("\n    ")}`,
+  const protobufFieldsFuncs = [
+    ...schemas.filter(shouldGenerateChannel).map((schema) => ({ schema, isView: false })),
+    ...schemas.filter(shouldGenerateView).map((schema) => ({ schema, isView: true })),
+  ]
+    .sort((a, b) =>
+      `${a.schema.name}${a.isView ? "View" : ""}`.localeCompare(
+        `${b.schema.name}${b.isView ? "View" : ""}`,
+      ),
+    )
+    .flatMap(({ schema, isView }) => [
+      "template<typename Encoder>",
+      `static void protobufFields(Encoder& enc, const ${schema.name}${isView ? "View" : ""}& msg) {`,
+      `    ${cppProtobufFields(schema, isView).join("\n    ")}`,
       "}\n",
-    ];
-  });
-
-  const encodeImpls = schemas.filter(shouldGenerateChannel).flatMap((schema) => {
-    const snakeName = toSnakeCase(schema.name);
-    if (isSameAsCType(schema)) {
-      return [
-        `FoxgloveError ${schema.name}::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {`,
-        `    return FoxgloveError(foxglove_${snakeName}_encode(reinterpret_cast<const foxglove_${snakeName}*>(this), ptr, len, encoded_len));`,
-        "}\n",
-      ];
-    } else {
-      return [
-        `FoxgloveError ${schema.name}::encode(uint8_t* ptr, size_t len, size_t* encoded_len) {`,
-        "    Arena arena;",
-        `    foxglove_${snakeName} c_msg;`,
-        `    ${toCamelCase(schema.name)}ToC(c_msg, *this, arena);`,
-        `    return FoxgloveError(foxglove_${snakeName}_encode(&c_msg, ptr, len, encoded_len));`,
-        "}\n",
-      ];
-    }
-  });
+    ]);
+
+  const encodeImpls = schemas.filter(shouldGenerateChannel).flatMap((schema) => [
+    `FoxgloveError ${schema.name}::encode(uint8_t* ptr, size_t len, size_t* encoded_len) const {`,
+    "    return encodeToBuffer(*this, ptr, len, encoded_len);",
+    "}\n",
+    `FoxgloveError ${schema.name}::encode(std::vector<uint8_t>& buf) const {`,
+    "    return encodeAppend(*this, buf);",
+    "}\n",
+    `FoxgloveResult<size_t> ${schema.name}::encodedSize() const {`,
+    "    return encodedSizeOf(*this);",
+    "}\n",
+  ]);
+
+  const encodeHelpers = [
+    "/// Encodes msg into the buffer at ptr, with the same contract as the C API's encode functions:",
+    "/// if ptr is null or len is too short, writes the required length to *encoded_len and returns",
+    "/// FoxgloveError::BufferTooShort.",
+    "template<typename T>",
+    "static FoxgloveError encodeToBuffer(const T& msg, uint8_t* ptr, size_t len, size_t* encoded_len) {",
+    "  ProtobufEncoding encoding(msg);",
+    "  if (encoding.error() != FoxgloveError::Ok) {",
+    "    return encoding.error();",
+    "  }",
+    "  if (encoded_len != nullptr) {",
+    "    *encoded_len = encoding.size();",
+    "  }",
+    "  if (ptr == nullptr || len < encoding.size()) {",
+    "    return FoxgloveError::BufferTooShort;",
+    "  }",
+    "  encoding.write(ptr);",
+    "  return FoxgloveError::Ok;",
+    "}",
+    "",
+    "/// Appends msg to buf, growing the buffer exactly once. On failure, buf is left unchanged.",
+    "template<typename T>",
+    "static FoxgloveError encodeAppend(const T& msg, std::vector<uint8_t>& buf) {",
+    "  ProtobufEncoding encoding(msg);",
+    "  if (encoding.error() != FoxgloveError::Ok) {",
+    "    return encoding.error();",
+    "  }",
+    "  size_t offset = buf.size();",
+    "  buf.resize(offset + encoding.size());",
+    "  encoding.write(buf.data() + offset);",
+    "  return FoxgloveError::Ok;",
+    "}",
+    "",
+    "/// Returns the length of msg's encoding, or the reason it cannot be encoded.",
+    "template<typename T>",
+    "static FoxgloveResult<size_t> encodedSizeOf(const T& msg) {",
+    "  ProtobufEncoding encoding(msg);",
+    "  if (encoding.error() != FoxgloveError::Ok) {",
+    "    return tl::unexpected(encoding.error());",
+    "  }",
+    "  return encoding.size();",
+    "}",
+  ];
 
   const getSchemaImpls = schemas.filter(shouldGenerateChannel).flatMap((schema) => {
     const snakeName = toSnakeCase(schema.name);
@@ -492,18 +618,98 @@ export function generateCppSchemas(schemas: FoxgloveMessageSchema[]): string {
     "};",
   ];
 
-  const systemIncludes = ["#include <optional>", "#include <cstring>"];
+  const logHelpers = [
+    "/// Creates a protobuf channel with the given schema, which retains its last keep_last messages.",
+    "static foxglove_error createLatchedChannel(",
+    "  const std::string_view& topic, const foxglove_schema& schema, const Context& context,",
+    "  size_t keep_last, const foxglove_channel** channel",
+    ") {",
+    "  static constexpr std::string_view kEncoding = \"protobuf\";",
+    "  foxglove_channel_spec spec = {};",
+    "  spec.topic = {topic.data(), topic.size()};",
+    "  spec.message_encoding = {kEncoding.data(), kEncoding.size()};",
+    "  spec.schema = &schema;",
+    "  spec.keep_last = keep_last;",
+    "  return foxglove_raw_channels_create(&spec, 1, context.getInner(), channel);",
+    "}",
+    "",
+    "/// Encodes the message into the calling thread's reusable buffer, then logs its bytes.",
+    "template<typename T>",
+    "static FoxgloveError logEncoded(",
+    "  const foxglove_channel* channel, const T& msg, std::optional<uint64_t> log_time,",
+    "  std::optional<uint64_t> sink_id",
+    ") noexcept {",
+    "  // Skip encoding the message if no sink would receive it.",
+    "  if (!foxglove_channel_should_log(channel)) {",
+    "    return FoxgloveError::Ok;",
+    "  }",
+    "  ScopedEncodeBuffer scoped_buffer;",
+    "  std::vector<uint8_t>& buffer = scoped_buffer.get();",
+    "  FoxgloveError error = encodeAppend(msg, buffer);",
+    "  if (error != FoxgloveError::Ok) {",
+    "    return error;",
+    "  }",
+    "  return FoxgloveError(foxglove_channel_log(",
+    "    channel, buffer.data(), buffer.size(), log_time ? &*log_time : nullptr, sink_id ? *sink_id : 0",
+    "  ));",
+    "}",
+    "",
+    "/// Encodes each message into one shared buffer, then logs them as a single batch.",
+    "template<typename T>",
+    "static FoxgloveError logEncodedBatch(",
+    "  const foxglove_channel* channel, const T* msgs, size_t count, const uint64_t* log_times,",
+    "  std::optional<uint64_t> sink_id",
+    ") noexcept {",
+    "  if (count == 0) {",
+    "    return FoxgloveError::Ok;",
+    "  }",
+    "  if (msgs == nullptr) {",
+    "    return FoxgloveError::ValueError;",
+    "  }",
+    "  if (!foxglove_channel_should_log(channel)) {",
+    "    return FoxgloveError::Ok;",
+    "  }",
+    "  ScopedEncodeBuffer scoped_buffer;",
+    "  std::vector<uint8_t>& buffer = scoped_buffer.get();",
+    "  std::vector<size_t> offsets;",
+    "  offsets.reserve(count + 1);",
+    "  for (size_t i = 0; i < count; ++i) {",
+    "    offsets.push_back(buffer.size());",
+    "    FoxgloveError error = msgs[i].encode(buffer);",
+    "    if (error != FoxgloveError::Ok) {",
+    "      return error;",
+    "    }",
+    "  }",
+    "  offsets.push_back(buffer.size());",
+    "",
+    "  std::vector<foxglove_log_item> items(count);",
+    "  for (size_t i = 0; i < count; ++i) {",
+    "    items[i].data = buffer.data() + offsets[i];",
+    "    items[i].data_len = offsets[i + 1] - offsets[i];",
+    "    items[i].log_time = log_times != nullptr ? &log_times[i] : nullptr;",
+    "  }",
+    "  return FoxgloveError(",
+    "    foxglove_channel_log_batch(channel, items.data(), count, sink_id ? *sink_id : 0)",
+    "  );",
+    "}",
+  ];
+
+  const systemIncludes = [
+    "#include <optional>",
+    "#include <vector>",
+  ];
 
   const includes = [
     "#include <foxglove/error.hpp>",
     "#include <foxglove/messages.hpp>",
-    "#include <foxglove/arena.hpp>",
     "#include <foxglove/schema.hpp>",
     "#ifndef __wasm32__",
     "#include <foxglove/context.hpp>",
     "#endif",
   ];
 
+  const localIncludes = ['#include "protobuf_encoder.hpp"'];
+
   const outputSections = [
     "// Generated by https://github.com/foxglove/foxglove-sdk",
 
@@ -513,13 +719,17 @@ export function generateCppSchemas(schemas: FoxgloveMessageSchema[]): string {
 
     systemIncludes.join("\n"),
 
+    localIncludes.join("\n"),
+
     "namespace foxglove::messages {",
-    conversionFuncDecls.join("\n"),
+    protobufFieldsDecls.join("\n"),
+    encodeHelpers.join("\n"),
     "#ifndef __wasm32__",
     channelUniquePtr.join("\n"),
+    logHelpers.join("\n"),
     traitSpecializations.join("\n"),
     "#endif",
-    conversionFuncs.join("\n"),
+    protobufFieldsFuncs.join("\n"),
 
     encodeImpls.join("\n"),
 
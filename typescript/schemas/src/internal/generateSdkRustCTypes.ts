@@ -253,6 +253,10 @@ impl BorrowToNative for ${name} {
 #[cfg(not(target_family = "wasm"))]
 #[unsafe(no_mangle)]
 pub extern "C" fn foxglove_channel_log_${snakeName}(channel: Option<&FoxgloveChannel>, msg: Option<&${name}>, log_time: Option<&u64>, sink_id: FoxgloveSinkId) -> FoxgloveError {
+  // Skip converting the message if no sink would receive it.
+  if !foxglove_channel_should_log(channel) {
+    return FoxgloveError::Ok;
+  }
   let mut arena = pin!(Arena::new());
   let arena_pin = arena.as_mut();
   // Safety: we're borrowing from the msg, but discard the borrowed message before returning
@@ -347,7 +351,7 @@ pub unsafe extern "C" fn foxglove_${snakeName}_encode(
     "",
     "use crate::{FoxgloveSchema, FoxgloveString, FoxgloveError, FoxgloveTimestamp, FoxgloveDuration};",
     `#[cfg(not(target_family = "wasm"))]`,
-    "use crate::{FoxgloveChannel, FoxgloveContext, log_msg_to_channel, result_to_c, do_foxglove_channel_create, FoxgloveSinkId};",
+    "use crate::{FoxgloveChannel, FoxgloveContext, log_msg_to_channel, result_to_c, do_foxglove_channel_create, FoxgloveSinkId, foxglove_channel_should_log};",
     "use crate::arena::{Arena, BorrowToNative};",
     "use crate::util::{bytes_from_raw, string_from_raw, vec_from_raw};",
   ];